@@ -34,6 +34,12 @@ extern "C"
  * The default allocator uses malloc(), free(), calloc(), and realloc().
  * It can be obtained using rcutils_get_default_allocator().
  *
+ * The aligned_allocate and aligned_deallocate pair is optional, and may be left
+ * `NULL`, in which case rcutils_allocator_aligned_allocate() aligns the memory
+ * given by allocate instead.
+ * Allocators made by copying the default allocator and replacing its other
+ * functions should set or clear this pair too.
+ *
  * The allocator should be trivially copyable.
  * Meaning that the struct should continue to work after being assignment
  * copied into a new struct.
@@ -74,6 +80,16 @@ typedef struct rcutils_allocator_t
    * allocator objects.
    */
   void * state;
+  /// Allocate memory aligned to a power of two, given an alignment, a size and the `state`.
+  /**
+   * Optional, may be `NULL` if aligned_deallocate is `NULL` too.
+   * An error should be indicated by returning `NULL`.
+   * Use rcutils_allocator_aligned_allocate() rather than calling it directly.
+   */
+  void * (*aligned_allocate)(size_t alignment, size_t size, void * state);
+  /// Deallocate memory allocated by aligned_allocate, also taking the `state` pointer.
+  /** Optional, may be `NULL` if aligned_allocate is `NULL` too. */
+  void (* aligned_deallocate)(void * pointer, void * state);
 } rcutils_allocator_t;
 
 /// Return a zero initialized allocator.
@@ -94,6 +110,8 @@ rcutils_get_zero_initialized_allocator(void);
  * - reallocate = wraps realloc()
  * - zero_allocate = wraps calloc()
  * - state = `NULL`
+ * - aligned_allocate = wraps aligned_alloc(), or _aligned_malloc() on Windows
+ * - aligned_deallocate = wraps free(), or _aligned_free() on Windows
  *
  * <hr>
  * Attribute          | Adherence
@@ -144,6 +162,47 @@ RCUTILS_WARN_UNUSED
 void *
 rcutils_reallocf(void * pointer, size_t size, rcutils_allocator_t * allocator);
 
+/// Allocate memory aligned to a power of two with an allocator.
+/**
+ * If the allocator has an aligned_allocate and aligned_deallocate pair, the
+ * memory is allocated with it, otherwise it is allocated with allocate, with
+ * `alignment - 1` bytes and a pointer more, so that it can be aligned.
+ * The memory must be deallocated with rcutils_allocator_aligned_deallocate(),
+ * with the same allocator.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | Yes, if the allocator is
+ * Uses Atomics       | No
+ * Lock-Free          | Yes, if the allocator is
+ *
+ * \param[in] allocator the valid allocator to allocate the memory with
+ * \param[in] alignment the alignment of the memory in bytes, a power of two
+ * \param[in] size the size of the memory in bytes
+ * \return a pointer to the aligned memory, or
+ * \return `NULL` if the arguments are invalid or the allocation fails.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+void *
+rcutils_allocator_aligned_allocate(
+  const rcutils_allocator_t * allocator,
+  size_t alignment,
+  size_t size);
+
+/// Deallocate memory allocated by rcutils_allocator_aligned_allocate().
+/**
+ * Passing `NULL` as the pointer does nothing.
+ *
+ * \param[in] allocator the allocator the memory was allocated with
+ * \param[in] pointer the memory to deallocate
+ */
+RCUTILS_PUBLIC
+void
+rcutils_allocator_aligned_deallocate(const rcutils_allocator_t * allocator, void * pointer);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,182 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// @file
+
+#ifndef RCUTILS__ARENA_ALLOCATOR_H_
+#define RCUTILS__ARENA_ALLOCATOR_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+
+#include "rcutils/allocator.h"
+#include "rcutils/macros.h"
+#include "rcutils/types/rcutils_ret.h"
+#include "rcutils/visibility_control.h"
+
+/// The alignment of the memory allocated by an arena allocator.
+#define RCUTILS_ARENA_ALLOCATOR_ALIGNMENT ((size_t)16)
+
+/// The size of the first block of an arena allocator when none is given.
+#define RCUTILS_ARENA_ALLOCATOR_DEFAULT_BLOCK_SIZE ((size_t)4096)
+
+struct rcutils_arena_allocator_impl_s;
+
+/// A linear allocator, whose memory is all deallocated at once.
+/**
+ * The arena allocates blocks with another allocator and hands out their memory in order,
+ * each block being twice as large as the previous one.
+ * Allocating only moves an offset in the current block, and deallocating does nothing except
+ * for the last allocation, which can also be reallocated in place.
+ * All the memory is deallocated at once with rcutils_arena_allocator_reset() or
+ * rcutils_arena_allocator_fini().
+ *
+ * This is meant for short lived and request scoped work, like parsing arguments or formatting
+ * a batch of log messages, through the rcutils_allocator_t of
+ * rcutils_arena_allocator_get_allocator().
+ */
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_arena_allocator_t
+{
+  /// A pointer to the PIMPL implementation type.
+  struct rcutils_arena_allocator_impl_s * impl;
+} rcutils_arena_allocator_t;
+
+/// Return an empty arena allocator struct.
+/**
+ * This function returns an empty and zero initialized arena allocator struct.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \return an empty and zero initialized arena allocator struct
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_arena_allocator_t
+rcutils_get_zero_initialized_arena_allocator(void);
+
+/// Initialize an arena allocator.
+/**
+ * No block is allocated until memory is allocated from the arena.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * Example:
+ *
+ * ```c
+ * rcutils_allocator_t default_allocator = rcutils_get_default_allocator();
+ * rcutils_arena_allocator_t arena = rcutils_get_zero_initialized_arena_allocator();
+ * rcutils_ret_t ret = rcutils_arena_allocator_init(&arena, 0, &default_allocator);
+ * rcutils_allocator_t allocator = rcutils_arena_allocator_get_allocator(&arena);
+ * rcutils_string_array_t tokens = rcutils_get_zero_initialized_string_array();
+ * ret = rcutils_split("/ns/node", '/', allocator, &tokens);
+ * // ... use the tokens, without finalizing them
+ * ret = rcutils_arena_allocator_reset(&arena);
+ * // ... more work, then
+ * ret = rcutils_arena_allocator_fini(&arena);
+ * ```
+ *
+ * \param[inout] arena the zero initialized arena allocator to initialize
+ * \param[in] block_size the size of the first block, or 0 for the default size
+ * \param[in] allocator to be used to allocate and deallocate the blocks
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_arena_allocator_init(
+  rcutils_arena_allocator_t * arena,
+  size_t block_size,
+  const rcutils_allocator_t * allocator);
+
+/// Finalize an arena allocator, deallocating all the memory allocated from it.
+/**
+ * Calling this on a zero initialized arena does nothing.
+ *
+ * \param[inout] arena the arena allocator to finalize
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_arena_allocator_fini(rcutils_arena_allocator_t * arena);
+
+/// Deallocate all the memory allocated from an arena allocator, keeping its last block.
+/**
+ * The last block is the largest one, so an arena reset after each cycle of the same work
+ * stops allocating blocks once it's large enough for a cycle.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] arena the initialized arena allocator
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_INITIALIZED if the arena is not initialized.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_arena_allocator_reset(rcutils_arena_allocator_t * arena);
+
+/// Return an allocator allocating from an arena allocator.
+/**
+ * The allocator is valid until the arena is finalized, and isn't thread-safe.
+ * Its memory is aligned to #RCUTILS_ARENA_ALLOCATOR_ALIGNMENT bytes.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] arena the initialized arena allocator
+ * \return the allocator allocating from the arena, or
+ * \return a zero initialized allocator if the arena is NULL or not initialized.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_allocator_t
+rcutils_arena_allocator_get_allocator(const rcutils_arena_allocator_t * arena);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCUTILS__ARENA_ALLOCATOR_H_
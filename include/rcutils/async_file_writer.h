@@ -0,0 +1,231 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// @file
+
+#ifndef RCUTILS__ASYNC_FILE_WRITER_H_
+#define RCUTILS__ASYNC_FILE_WRITER_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rcutils/allocator.h"
+#include "rcutils/macros.h"
+#include "rcutils/types/rcutils_ret.h"
+#include "rcutils/visibility_control.h"
+
+/// The default size of the buffers appended bytes are copied into.
+#define RCUTILS_ASYNC_FILE_WRITER_DEFAULT_BUFFER_SIZE (64u * 1024u)
+/// The default number of buffers, the ones being written and the one being filled.
+#define RCUTILS_ASYNC_FILE_WRITER_DEFAULT_BUFFER_COUNT 4u
+
+/// The ways the buffers of an asynchronous file writer can be written.
+typedef enum rcutils_async_file_writer_backend_t
+{
+  /// io_uring where the system supports it, a thread otherwise
+  RCUTILS_ASYNC_FILE_WRITER_BACKEND_AUTO = 0,
+  /// io_uring on Linux, with the buffers registered with the kernel
+  RCUTILS_ASYNC_FILE_WRITER_BACKEND_IO_URING,
+  /// A thread writing the buffers with blocking writes
+  RCUTILS_ASYNC_FILE_WRITER_BACKEND_THREAD,
+} rcutils_async_file_writer_backend_t;
+
+/// The options of an asynchronous file writer.
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_async_file_writer_options_t
+{
+  /// The size of each buffer, a write is issued when one is full.
+  size_t buffer_size;
+  /// The number of buffers, at least 2.
+  /**
+   * When all of them are being written, appending waits for the oldest one, which bounds
+   * the bytes in flight to `buffer_count * buffer_size`.
+   */
+  size_t buffer_count;
+  /// How the buffers are written.
+  rcutils_async_file_writer_backend_t backend;
+} rcutils_async_file_writer_options_t;
+
+struct rcutils_async_file_writer_impl_t;
+
+/// A writer appending bytes to a file without waiting for the disk.
+/**
+ * The bytes are copied into a buffer, which is written asynchronously once it's full, while
+ * the next one is filled.
+ * Appending only blocks when all the other buffers are still being written, so that a slow
+ * disk slows the writer down instead of using more and more memory.
+ *
+ * Buffers are reused in the order they were written, and the number of bytes reported by
+ * rcutils_async_file_writer_get_written_size() only covers writes which completed along
+ * with all the earlier ones, so that the file never has a hole up to that size.
+ *
+ * A writer may only be used by one thread at a time.
+ */
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_async_file_writer_t
+{
+  /// A pointer to the PIMPL implementation type.
+  struct rcutils_async_file_writer_impl_t * impl;
+} rcutils_async_file_writer_t;
+
+/// Return a zero initialized asynchronous file writer.
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_async_file_writer_t
+rcutils_get_zero_initialized_async_file_writer(void);
+
+/// Return the default options of an asynchronous file writer.
+/**
+ * The defaults are #RCUTILS_ASYNC_FILE_WRITER_DEFAULT_BUFFER_COUNT buffers of
+ * #RCUTILS_ASYNC_FILE_WRITER_DEFAULT_BUFFER_SIZE bytes, written with io_uring where
+ * available.
+ *
+ * \return The default options.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_async_file_writer_options_t
+rcutils_async_file_writer_get_default_options(void);
+
+/// Open a file to append bytes to, creating it if needed.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] writer The zero initialized writer.
+ * \param[in] path The path of the file.
+ * \param[in] options The options of the writer, or NULL for the default ones.
+ * \param[in] allocator The allocator used for the writer and its buffers.
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails, or
+ * \return #RCUTILS_RET_ERROR if the file can't be opened, or if io_uring was requested and
+ *   isn't available.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_async_file_writer_open(
+  rcutils_async_file_writer_t * writer,
+  const char * path,
+  const rcutils_async_file_writer_options_t * options,
+  const rcutils_allocator_t * allocator);
+
+/// Append bytes to the file.
+/**
+ * The bytes are copied, so they may be reused as soon as this returns.
+ * This only waits when the buffers being written are needed to copy the bytes.
+ *
+ * \param[inout] writer The open writer.
+ * \param[in] data The bytes to append, may be NULL if size is 0.
+ * \param[in] size The number of bytes to append.
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_INITIALIZED if the writer isn't open, or
+ * \return #RCUTILS_RET_ERROR if a write failed, now or earlier, in which case the writer
+ *   keeps failing.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_async_file_writer_append(
+  rcutils_async_file_writer_t * writer, const void * data, size_t size);
+
+/// Write the bytes appended so far, and wait until they're written.
+/**
+ * The bytes are handed to the system, like with `write()`, but not necessarily stored on
+ * the disk, see rcutils_async_file_writer_sync().
+ *
+ * \param[inout] writer The open writer.
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_INITIALIZED if the writer isn't open, or
+ * \return #RCUTILS_RET_ERROR if a write failed.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_async_file_writer_flush(rcutils_async_file_writer_t * writer);
+
+/// Write the bytes appended so far, and wait until they're stored on the disk.
+/**
+ * This flushes the writer, then synchronizes the file with `fsync()`.
+ *
+ * \param[inout] writer The open writer.
+ * \return see rcutils_async_file_writer_flush()
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_async_file_writer_sync(rcutils_async_file_writer_t * writer);
+
+/// Get the number of bytes of the file written without a hole, see rcutils_async_file_writer_t.
+/**
+ * It includes the size the file had when it was opened.
+ *
+ * \param[in] writer The open writer.
+ * \param[out] size The size.
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_INITIALIZED if the writer isn't open.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_async_file_writer_get_written_size(
+  const rcutils_async_file_writer_t * writer, uint64_t * size);
+
+/// Get the way the buffers of a writer are written.
+/**
+ * \param[in] writer The open writer.
+ * \param[out] backend #RCUTILS_ASYNC_FILE_WRITER_BACKEND_IO_URING or
+ *   #RCUTILS_ASYNC_FILE_WRITER_BACKEND_THREAD.
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_INITIALIZED if the writer isn't open.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_async_file_writer_get_backend(
+  const rcutils_async_file_writer_t * writer, rcutils_async_file_writer_backend_t * backend);
+
+/// Flush the writer, close the file and free the writer.
+/**
+ * The writer is closed even if flushing fails.
+ * Closing a zero initialized writer does nothing.
+ *
+ * \param[inout] writer The writer, zero initialized again.
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_ERROR if a write failed.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_async_file_writer_close(rcutils_async_file_writer_t * writer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCUTILS__ASYNC_FILE_WRITER_H_
@@ -23,7 +23,11 @@ extern "C"
 #endif
 
 #include <stdbool.h>
+#include <stddef.h>
 
+#include "rcutils/allocator.h"
+#include "rcutils/macros.h"
+#include "rcutils/types/rcutils_ret.h"
 #include "rcutils/visibility_control.h"
 
 /// Return `true` if the option is defined in the command line arguments or `false` otherwise.
@@ -50,6 +54,98 @@ RCUTILS_PUBLIC
 char *
 rcutils_cli_get_option(char ** begin, char ** end, const char * option);
 
+struct rcutils_cli_index_impl_t;
+
+/// An index of the command line arguments, to look options up without scanning them.
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_cli_index_t
+{
+  /// A pointer to the PIMPL implementation type.
+  struct rcutils_cli_index_impl_t * impl;
+} rcutils_cli_index_t;
+
+/// Return an empty index struct.
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_cli_index_t
+rcutils_get_zero_initialized_cli_index(void);
+
+/// Index the command line arguments, to look options up in constant time.
+/**
+ * The arguments are scanned once, and each distinct argument is hashed along with the
+ * positions where it occurs, so that looking up an option doesn't compare it with every
+ * argument, as rcutils_cli_option_exist() and rcutils_cli_get_option() do.
+ * This is worthwhile when many options are looked up in long argument vectors.
+ *
+ * Unlike rcutils_cli_get_option(), options are matched exactly, not as prefixes of the
+ * arguments.
+ * `NULL` arguments are skipped.
+ * The arguments aren't copied, so they must outlive the index.
+ *
+ * \param[inout] index zero initialized index to initialize
+ * \param[in] begin first element of the array of arguments
+ * \param[in] end element after the last one of the array of arguments
+ * \param[in] allocator the allocator of the index
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_BAD_ALLOC if allocating memory failed, or
+ * \return #RCUTILS_RET_ERROR if an unknown error occurs.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_cli_index_init(
+  rcutils_cli_index_t * index,
+  char ** begin,
+  char ** end,
+  rcutils_allocator_t allocator);
+
+/// Deallocate the index, after which it is zero initialized again.
+/**
+ * \param[inout] index the index to finalize, may be zero initialized
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if index is NULL.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_cli_index_fini(rcutils_cli_index_t * index);
+
+/// Return the positions where an option occurs in the indexed arguments.
+/**
+ * \param[in] index the initialized index
+ * \param[in] option the argument to find
+ * \param[out] count the number of times the option occurs
+ * \return the increasing positions of the option from `begin`, valid until the index is
+ *   finalized, or
+ * \return `NULL` if the option doesn't occur or an argument is invalid.
+ */
+RCUTILS_PUBLIC
+const size_t *
+rcutils_cli_index_get_positions(
+  const rcutils_cli_index_t * index, const char * option, size_t * count);
+
+/// Return `true` if the option is one of the indexed arguments or `false` otherwise.
+/**
+ * \param[in] index the initialized index
+ * \param[in] option the argument to find
+ * \return `true` if the option exists, or
+ * \return `false` otherwise.
+ */
+RCUTILS_PUBLIC
+bool
+rcutils_cli_index_option_exist(const rcutils_cli_index_t * index, const char * option);
+
+/// Return the argument following the first occurrence of an option in the indexed arguments.
+/**
+ * \param[in] index the initialized index
+ * \param[in] option the argument to find
+ * \return the argument following the option, or
+ * \return `NULL` if the option doesn't exist or is the last argument.
+ */
+RCUTILS_PUBLIC
+char *
+rcutils_cli_index_get_option(const rcutils_cli_index_t * index, const char * option);
+
 #ifdef __cplusplus
 }
 #endif
@@ -24,7 +24,9 @@ extern "C"
 
 #include <stdbool.h>
 
+#include "rcutils/allocator.h"
 #include "rcutils/macros.h"
+#include "rcutils/types/rcutils_ret.h"
 #include "rcutils/visibility_control.h"
 
 /// Set or un-set a process-scoped environment variable.
@@ -115,6 +117,68 @@ RCUTILS_WARN_UNUSED
 const char *
 rcutils_get_home_dir(void);
 
+/// Take a snapshot of the environment variables, through which they are looked up from then on.
+/**
+ * The environment variables of the process are copied into a hash table, so that
+ * rcutils_get_env() and rcutils_env_snapshot_get() find a variable without scanning them all,
+ * as `getenv()` does.
+ * This is worthwhile in processes with large environments which look up the same variables
+ * many times, for instance while creating many nodes.
+ *
+ * The snapshot is rebuilt by rcutils_set_env(), but it doesn't see the changes made to the
+ * environment by other means, such as `setenv()` or `putenv()`, until it is taken again.
+ * Calling this function again replaces the snapshot with a new one.
+ *
+ * \par Thread Safety:
+ * This function is not thread-safe, like rcutils_set_env().
+ *
+ * \param[in] allocator the allocator of the snapshot
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if the allocator is invalid, or
+ * \return #RCUTILS_RET_BAD_ALLOC if allocating memory failed, or
+ * \return #RCUTILS_RET_ERROR if an unknown error occurs.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_env_snapshot_init(rcutils_allocator_t allocator);
+
+/// Discard the snapshot of the environment variables, looking them up with `getenv()` again.
+/**
+ * The values returned from the snapshot are invalid afterwards.
+ * Nothing is done if there is no snapshot.
+ *
+ * \par Thread Safety:
+ * This function is not thread-safe, like rcutils_set_env().
+ */
+RCUTILS_PUBLIC
+void
+rcutils_env_snapshot_fini(void);
+
+/// Return whether the environment variables are looked up in a snapshot.
+RCUTILS_PUBLIC
+bool
+rcutils_env_snapshot_is_enabled(void);
+
+/// Look up an environment variable, in the snapshot if there is one.
+/**
+ * This function finds the variable in the snapshot taken by rcutils_env_snapshot_init(), or
+ * with `getenv()` if there is none.
+ * The returned value is valid until the snapshot is rebuilt or discarded, or until the
+ * environment is modified without a snapshot.
+ *
+ * Multiple concurrent calls to this function are thread safe, but it cannot be called
+ * concurrently with rcutils_set_env() or the functions taking and discarding the snapshot.
+ *
+ * \param[in] env_name the name of the environment variable
+ * \return The value of the variable, or
+ * \return `NULL` if it is not set or env_name is NULL.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+const char *
+rcutils_env_snapshot_get(const char * env_name);
+
 #ifdef __cplusplus
 }
 #endif
@@ -101,6 +101,14 @@ extern "C"
     RCUTILS_ERROR_FORMATTING_CHARACTERS - \
     1)
 
+#ifndef RCUTILS_ERROR_HISTORY_SIZE
+/// The number of overwritten errors kept per thread when the error history is enabled.
+#define RCUTILS_ERROR_HISTORY_SIZE 4
+#endif
+
+/// The maximum length of the messages and file names kept in the error history.
+#define RCUTILS_ERROR_HISTORY_STRING_MAX_LENGTH 128
+
 /// Struct wrapping a fixed-size c string used for returning the formatted error string.
 typedef struct rcutils_error_string_t
 {
@@ -193,6 +201,51 @@ RCUTILS_PUBLIC
 void
 rcutils_set_error_state(const char * error_string, const char * file, size_t line_number);
 
+/// Set the error message, file and line by reference, deferring their copy and formatting.
+/**
+ * This is not meant to be used directly, but instead via the
+ * RCUTILS_SET_ERROR_MSG_STATIC(msg) macro.
+ *
+ * Unlike rcutils_set_error_state(), only the pointers and the line number are
+ * recorded, and the message and file are copied into the error state only if
+ * rcutils_get_error_state() or rcutils_get_error_string() is called, which
+ * makes setting errors cheap on failure paths which are expected to be hot,
+ * like when polling.
+ * Overwriting an error with this function is not reported to stderr.
+ *
+ * The error_msg and file parameters must be null terminated and stay valid
+ * until the error is reset or overwritten, ideally they are string literals.
+ *
+ * \param[in] error_string The error message to set.
+ * \param[in] file The path to the file in which the error occurred.
+ * \param[in] line_number The line number on which the error occurred.
+ */
+RCUTILS_PUBLIC
+void
+rcutils_set_error_state_static(const char * error_string, const char * file, size_t line_number);
+
+/// Set the error code along with the message, file and line by reference.
+/**
+ * This is not meant to be used directly, but instead via the
+ * RCUTILS_SET_ERROR_CODE(code, msg) macro.
+ *
+ * This behaves like rcutils_set_error_state_static(), and also records the
+ * code, which rcutils_get_error_code() returns, so that callers can tell
+ * errors apart without comparing or even formatting their messages.
+ *
+ * \param[in] code The code of the error, like #RCUTILS_RET_NOT_ENOUGH_SPACE.
+ * \param[in] error_string The error message to set.
+ * \param[in] file The path to the file in which the error occurred.
+ * \param[in] line_number The line number on which the error occurred.
+ */
+RCUTILS_PUBLIC
+void
+rcutils_set_error_code_static(
+  rcutils_ret_t code,
+  const char * error_string,
+  const char * file,
+  size_t line_number);
+
 /// Check an argument for a null value.
 /**
  * If the argument's value is `NULL`, set the error message saying so and
@@ -236,11 +289,53 @@ rcutils_set_error_state(const char * error_string, const char * file, size_t lin
 #define RCUTILS_SET_ERROR_MSG(msg) \
   do {rcutils_set_error_state(msg, __FILE__, __LINE__);} while (0)
 
+/// Set the error message from a string literal, deferring its copy and formatting.
+/**
+ * This behaves like RCUTILS_SET_ERROR_MSG(), but with
+ * rcutils_set_error_state_static(), so the message must be a string literal.
+ *
+ * \param[in] msg The string literal of the error message to be set.
+ */
+#define RCUTILS_SET_ERROR_MSG_STATIC(msg) \
+  do {rcutils_set_error_state_static("" msg, __FILE__, __LINE__);} while (0)
+
+/// Set the error code and the error message from a string literal, without copying them.
+/**
+ * This behaves like RCUTILS_SET_ERROR_MSG_STATIC(), and also records the code,
+ * see rcutils_set_error_code_static().
+ *
+ * \param[in] code The code of the error, like #RCUTILS_RET_NOT_ENOUGH_SPACE.
+ * \param[in] msg The string literal of the error message to be set.
+ */
+#define RCUTILS_SET_ERROR_CODE(code, msg) \
+  do {rcutils_set_error_code_static(code, "" msg, __FILE__, __LINE__);} while (0)
+
+#ifdef RCUTILS_DISABLE_FORMATTED_ERRORS
+/// Set the error message to the format string, without formatting the arguments.
+/**
+ * When built with RCUTILS_DISABLE_FORMATTED_ERRORS defined, for instance with the
+ * `RCUTILS_DISABLE_FORMATTED_ERRORS` CMake option, the formatting is compiled out, and
+ * the format string itself is set by reference with rcutils_set_error_state_static(), so
+ * it must stay valid until the error is reset or overwritten.
+ * The arguments are not evaluated, only referred to in dead code to keep them used.
+ *
+ * \param[in] format_string The string to be used as the format of the error message.
+ * \param[in] ... Arguments for the format string, ignored.
+ */
+#define RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(format_string, ...) \
+  do { \
+    if (0) { \
+      (void)rcutils_snprintf(NULL, 0, format_string, __VA_ARGS__); \
+    } \
+    rcutils_set_error_state_static(format_string, __FILE__, __LINE__); \
+  } while (0)
+#else
 /// Set the error message using a format string and format arguments.
 /**
  * This function sets the error message using the given format string.
  * The resulting formatted string is silently truncated at
  * RCUTILS_ERROR_MESSAGE_MAX_LENGTH.
+ * See RCUTILS_DISABLE_FORMATTED_ERRORS to compile the formatting out.
  *
  * \param[in] format_string The string to be used as the format of the error message.
  * \param[in] ... Arguments for the format string.
@@ -255,6 +350,7 @@ rcutils_set_error_state(const char * error_string, const char * file, size_t lin
       RCUTILS_SET_ERROR_MSG(output_msg); \
     } \
   } while (0)
+#endif
 
 /// Indicate that the function intends to set an error message and return an error value.
 /**
@@ -280,6 +376,18 @@ RCUTILS_WARN_UNUSED
 bool
 rcutils_error_is_set(void);
 
+/// Return the code of the error if set, else #RCUTILS_RET_OK.
+/**
+ * The code is the one given to rcutils_set_error_code_static(), or #RCUTILS_RET_ERROR if
+ * the error was set without a code.
+ *
+ * \return The code of the current error, or #RCUTILS_RET_OK if not set.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_get_error_code(void);
+
 /// Return an rcutils_error_state_t which was set with rcutils_set_error_state().
 /**
  * The returned pointer will be NULL if no error has been set in this thread.
@@ -314,6 +422,64 @@ RCUTILS_PUBLIC
 void
 rcutils_reset_error(void);
 
+/// Enable or disable the error history of all threads.
+/**
+ * By default, and when built with RCUTILS_REPORT_ERROR_HANDLING_ERRORS, setting an
+ * error while another one is set prints both of them to stderr.
+ * With the error history enabled, the overwritten error is instead recorded in a
+ * ring of the last #RCUTILS_ERROR_HISTORY_SIZE overwritten errors of the thread,
+ * which doesn't allocate, and can be read with rcutils_get_error_history() or printed
+ * with rcutils_print_error_history() when diagnosing a failure.
+ * Overwriting an error with the same message doesn't record it again.
+ *
+ * The messages and file names are truncated to
+ * #RCUTILS_ERROR_HISTORY_STRING_MAX_LENGTH characters, except for the errors set with
+ * rcutils_set_error_state_static(), which are recorded by reference.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[in] enabled Whether to record the overwritten errors rather than printing them.
+ */
+RCUTILS_PUBLIC
+void
+rcutils_set_error_history_enabled(bool enabled);
+
+/// Return `true` if the error history is enabled, otherwise `false`.
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+bool
+rcutils_error_history_is_enabled(void);
+
+/// Copy the error history of the calling thread, the most recently overwritten error first.
+/**
+ * The errors are formatted like rcutils_get_error_string() does.
+ * The history is kept when the error is reset, see rcutils_clear_error_history().
+ *
+ * \param[out] history The array to copy the errors to.
+ * \param[in] history_size The number of errors the array can hold.
+ * \return The number of errors copied, up to #RCUTILS_ERROR_HISTORY_SIZE.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+size_t
+rcutils_get_error_history(rcutils_error_string_t * history, size_t history_size);
+
+/// Print the error history of the calling thread to stderr, the most recent error first.
+RCUTILS_PUBLIC
+void
+rcutils_print_error_history(void);
+
+/// Clear the error history of the calling thread.
+RCUTILS_PUBLIC
+void
+rcutils_clear_error_history(void);
+
 #ifdef __cplusplus
 }
 #endif
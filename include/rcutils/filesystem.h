@@ -28,6 +28,8 @@ extern "C"
 
 #include "rcutils/allocator.h"
 #include "rcutils/macros.h"
+#include "rcutils/time.h"
+#include "rcutils/types/char_array.h"
 #include "rcutils/visibility_control.h"
 
 /// Return current working directory.
@@ -43,6 +45,59 @@ RCUTILS_WARN_UNUSED
 bool
 rcutils_get_cwd(char * buffer, size_t max_length);
 
+/// The types of the entries of a file system, see ::rcutils_path_stat and ::rcutils_dir_iter_t
+typedef enum rcutils_dir_entry_type_t
+{
+  /// The type of the entry couldn't be determined, e.g. because it was removed meanwhile
+  RCUTILS_DIR_ENTRY_TYPE_UNKNOWN = 0,
+  /// A regular file
+  RCUTILS_DIR_ENTRY_TYPE_FILE,
+  /// A directory
+  RCUTILS_DIR_ENTRY_TYPE_DIRECTORY,
+  /// A symbolic link, or a reparse point on Windows, which is not followed
+  RCUTILS_DIR_ENTRY_TYPE_SYMLINK,
+  /// Any other type of entry, e.g. a named pipe or a device
+  RCUTILS_DIR_ENTRY_TYPE_OTHER,
+} rcutils_dir_entry_type_t;
+
+/// The status of a path, see ::rcutils_path_stat
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_path_status_t
+{
+  /// Whether the path exists, the other members are zero if it doesn't
+  bool exists;
+  /// The type of the entry, symbolic links being followed
+  rcutils_dir_entry_type_t type;
+  /// The size in bytes of the entry
+  uint64_t size;
+  /// The permission bits of the entry, e.g. `0640`
+  /**
+   * On Windows, only the bits of the owner are set, `0400` for readable and `0200` for
+   * writable.
+   */
+  uint32_t permissions;
+  /// The time of the last modification of the entry
+  rcutils_time_point_value_t mtime;
+  /// The time of the last access to the entry
+  rcutils_time_point_value_t atime;
+} rcutils_path_status_t;
+
+/// Get the status of a path.
+/**
+ * The status is obtained with a single `stat`, so querying it once is cheaper than
+ * checking the path with several of the functions below, which use it.
+ * Timestamps have a resolution of a second on Windows.
+ *
+ * \param[in] path Path to get the status of.
+ * \param[out] status The status of the path, with `exists` set to `false` if the path
+ *   doesn't exist or can't be accessed.
+ * \return #RCUTILS_RET_OK if successful, even if the path doesn't exist, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_path_stat(const char * path, rcutils_path_status_t * status);
+
 /// Check if the provided path points to a directory.
 /**
  * \param[in] abs_path Absolute path to check.
@@ -165,6 +220,110 @@ RCUTILS_PUBLIC
 char *
 rcutils_expand_user(const char * path, rcutils_allocator_t allocator);
 
+/// Write the arguments separated by the delimiter of the platform into a buffer.
+/**
+ * This is the variant of rcutils_join_path() which doesn't allocate memory.
+ * The buffer may be `left_hand_path` itself, to append to it in place.
+ *
+ * \param[in] left_hand_path
+ * \param[in] right_hand_path
+ * \param[out] buffer the buffer the null-terminated path is written into
+ * \param[in] buffer_size the size of the buffer, including room for the null terminator
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_ENOUGH_SPACE if the path doesn't fit in the buffer.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_join_path_to_buffer(
+  const char * left_hand_path,
+  const char * right_hand_path,
+  char * buffer,
+  size_t buffer_size);
+
+/// Replace all the "/" of the path by the platform specific separator, in place.
+/**
+ * This is the variant of rcutils_to_native_path() which doesn't allocate memory.
+ * The separator is a single character, so the length of the path doesn't change.
+ *
+ * \param[inout] path the null-terminated path to convert
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_to_native_path_in_place(char * path);
+
+/// Expand user directory in path, into a buffer.
+/**
+ * This is the variant of rcutils_expand_user() which doesn't allocate memory.
+ * The buffer may be `path` itself, to expand it in place.
+ *
+ * \param[in] path A null-terminated C string representing a path.
+ * \param[out] buffer the buffer the null-terminated expanded path is written into
+ * \param[in] buffer_size the size of the buffer, including room for the null terminator
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_ENOUGH_SPACE if the path doesn't fit in the buffer, or
+ * \return #RCUTILS_RET_ERROR if the home directory is unknown.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_expand_user_to_buffer(const char * path, char * buffer, size_t buffer_size);
+
+/// Append a component to a path held in a char array, with the delimiter of the platform.
+/**
+ * Together with rcutils_path_pop(), this builds the paths of the entries of a directory walk
+ * in a single buffer, which grows as needed but isn't reallocated for each entry.
+ * With a char array declared with #RCUTILS_CHAR_ARRAY_WITH_STACK, short paths don't
+ * allocate memory at all.
+ *
+ * No delimiter is added to an empty path, or to a path already ending with one, like the
+ * root directory.
+ * If the char array fails to grow, the path is left unchanged.
+ *
+ * ```c
+ * RCUTILS_CHAR_ARRAY_WITH_STACK(path, 256, rcutils_get_default_allocator());
+ * rcutils_ret_t ret = rcutils_char_array_strcpy(&path, directory);
+ * // for each entry of the directory
+ * ret = rcutils_path_push(&path, entry_name);
+ * // use path.buffer
+ * ret = rcutils_path_pop(&path);
+ * // ...
+ * ret = rcutils_char_array_fini(&path);
+ * ```
+ *
+ * \param[inout] path the char array holding the path, may be empty
+ * \param[in] component the null-terminated component to append
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails, or
+ * \return #RCUTILS_RET_ERROR if an unknown error occurs.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_path_push(rcutils_char_array_t * path, const char * component);
+
+/// Remove the last component of a path held in a char array, in place.
+/**
+ * The delimiters before the component are removed as well, except the one of the root
+ * directory, so that popping what rcutils_path_push() appended restores the path, unless it
+ * ended with a delimiter.
+ * Popping the root directory, or an empty path, leaves it unchanged.
+ *
+ * \param[inout] path the char array holding the path
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_path_pop(rcutils_char_array_t * path);
+
 /// Create the specified directory.
 /**
  * This function creates an absolutely-specified directory.
@@ -236,6 +395,62 @@ rcutils_calculate_directory_size_with_recursion(
   uint64_t * size,
   rcutils_allocator_t allocator);
 
+/// The options of rcutils_calculate_directory_size_with_options().
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_directory_size_options_t
+{
+  /// The maximum depth of subdirectory, see rcutils_calculate_directory_size_with_recursion().
+  /**
+   * 0 means no limitation.
+   */
+  size_t max_depth;
+  /// The number of threads calculating the sizes of the subdirectories in parallel.
+  /**
+   * Each subdirectory of the directory is processed by one thread, the calling thread
+   * being one of them, so this only helps directories with several large subdirectories.
+   * 0 or 1 process them on the calling thread only.
+   */
+  size_t threads;
+} rcutils_directory_size_options_t;
+
+/// Return the default options of rcutils_calculate_directory_size_with_options().
+/**
+ * The defaults are no depth limitation and a single thread.
+ *
+ * \return The default options.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_directory_size_options_t
+rcutils_directory_size_get_default_options(void);
+
+/// Calculate the size of the specified directory with options.
+/**
+ * Calculates the size of a directory and its subdirectories like
+ * rcutils_calculate_directory_size_with_recursion(), optionally in parallel.
+ *
+ * On POSIX systems the entries are enumerated relative to their directory, without
+ * composing their paths, and their types are taken from `readdir()` where the file system
+ * reports them, so that only the files are `stat`ed, once each.
+ * Threads are only used on POSIX systems.
+ *
+ * \note This API does not follow symlinks to files or directories.
+ * \param[in] directory_path The directory path to calculate the size of.
+ * \param[in] options The options of the calculation.
+ * \param[out] size The size of the directory in bytes on success.
+ * \param[in] allocator Allocator being used for internal allocations.
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails
+ * \return #RCUTILS_RET_ERROR if other error occurs
+ */
+RCUTILS_PUBLIC
+rcutils_ret_t
+rcutils_calculate_directory_size_with_options(
+  const char * directory_path,
+  const rcutils_directory_size_options_t * options,
+  uint64_t * size,
+  rcutils_allocator_t allocator);
+
 /// Calculate the size of the specifed file.
 /**
  * \param[in] file_path The path of the file to obtain its size of.
@@ -245,6 +460,17 @@ RCUTILS_PUBLIC
 size_t
 rcutils_get_file_size(const char * file_path);
 
+/// The options of a directory iterator, see ::rcutils_dir_iter_start_with_options
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_dir_iter_options_t
+{
+  /// Whether to set the `entry_size` and `entry_mtime` of the enumerated entries.
+  /**
+   * On Windows they come with the enumeration, on other systems each entry is `stat`ed
+   * relative to the directory, without composing its path.
+   */
+  bool stat_entries;
+} rcutils_dir_iter_options_t;
+
 /// An iterator used for enumerating directory contents
 typedef struct rcutils_dir_iter_t
 {
@@ -254,6 +480,17 @@ typedef struct rcutils_dir_iter_t
   rcutils_allocator_t allocator;
   /// The platform-specific iteration state
   void * state;
+  /// The type of the enumerated entry
+  /**
+   * It is reported along with the names by the file system where supported, so that it
+   * doesn't cost an additional `stat`.
+   */
+  rcutils_dir_entry_type_t entry_type;
+  /// The size in bytes of the enumerated entry, if its iterator stats the entries
+  uint64_t entry_size;
+  /// The time of the last modification of the enumerated entry, if its iterator stats the
+  /// entries
+  rcutils_time_point_value_t entry_mtime;
 } rcutils_dir_iter_t;
 
 /// Begin iterating over the contents of the specified directory.
@@ -275,6 +512,37 @@ RCUTILS_PUBLIC
 rcutils_dir_iter_t *
 rcutils_dir_iter_start(const char * directory_path, const rcutils_allocator_t allocator);
 
+/// Return the default options of a directory iterator.
+/**
+ * The default is not to stat the entries.
+ *
+ * \return The default options.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_dir_iter_options_t
+rcutils_dir_iter_get_default_options(void);
+
+/// Begin iterating over the contents of the specified directory with options.
+/**
+ * The iterator is the same as the one of ::rcutils_dir_iter_start, which sets the
+ * `entry_type` of the enumerated entries as well.
+ * With `stat_entries`, it also sets their `entry_size` and `entry_mtime`.
+ * Symbolic links are not followed, their size is the one of the link.
+ *
+ * \param[in] directory_path The directory path to iterate over the contents of.
+ * \param[in] options The options of the iterator.
+ * \param[in] allocator Allocator used to create the returned structure.
+ * \return An iterator object used to continue iterating directory contents
+ * \return NULL if an error occurred
+ */
+RCUTILS_PUBLIC
+rcutils_dir_iter_t *
+rcutils_dir_iter_start_with_options(
+  const char * directory_path,
+  const rcutils_dir_iter_options_t * options,
+  const rcutils_allocator_t allocator);
+
 /// Continue iterating over the contents of a directory.
 /**
  * \param[in] iter An iterator created by ::rcutils_dir_iter_start.
@@ -293,6 +561,331 @@ RCUTILS_PUBLIC
 void
 rcutils_dir_iter_end(rcutils_dir_iter_t * iter);
 
+/// An entry visited by ::rcutils_dir_walk
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_dir_walk_entry_t
+{
+  /// The path of the entry, the walked directory joined with the names down to the entry
+  /**
+   * It is only valid during the callback it is passed to.
+   */
+  const char * path;
+  /// The name of the entry, the last component of its path
+  const char * name;
+  /// The depth of the entry, 1 for the entries of the walked directory
+  size_t depth;
+  /// The type of the entry, as set by a directory iterator, see ::rcutils_dir_iter_t
+  rcutils_dir_entry_type_t type;
+  /// The size in bytes of the entry, if the walk stats the entries
+  uint64_t size;
+  /// The time of the last modification of the entry, if the walk stats the entries
+  rcutils_time_point_value_t mtime;
+} rcutils_dir_walk_entry_t;
+
+/// What ::rcutils_dir_walk does after visiting an entry, as returned by its callback
+typedef enum rcutils_dir_walk_action_t
+{
+  /// Continue, descending into the entry if it's a directory
+  RCUTILS_DIR_WALK_CONTINUE = 0,
+  /// Continue, but don't descend into the entry
+  RCUTILS_DIR_WALK_PRUNE,
+  /// Stop the walk, no more entries are visited
+  RCUTILS_DIR_WALK_STOP,
+} rcutils_dir_walk_action_t;
+
+/// The function called for each entry visited by ::rcutils_dir_walk
+typedef rcutils_dir_walk_action_t (* rcutils_dir_walk_callback_t)(
+  const rcutils_dir_walk_entry_t * entry, void * user_data);
+
+/// The options of ::rcutils_dir_walk
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_dir_walk_options_t
+{
+  /// The maximum depth of the entries visited, 0 means no limitation.
+  /**
+   * 1 only visits the entries of the walked directory, like the `max_depth` of
+   * rcutils_calculate_directory_size_with_recursion().
+   */
+  size_t max_depth;
+  /// The pattern the names of the entries passed to the callback match, or `NULL` for all.
+  /**
+   * The directories whose names don't match are still descended into.
+   * In the patterns, `*` matches any characters, `?` any one character, and `[...]` one of
+   * the characters of the set, which may hold ranges like `a-z` and be negated with a
+   * leading `!`.
+   * The names are matched as a whole and case sensitively, and `*` matches a leading `.`.
+   */
+  const char * include_pattern;
+  /// The pattern the names of the entries skipped match, or `NULL` for none.
+  /**
+   * The entries skipped are neither passed to the callback nor descended into, so that
+   * directories like `.git` are pruned without visiting them.
+   */
+  const char * exclude_pattern;
+  /// Whether to set the `size` and `mtime` of the entries, see ::rcutils_dir_iter_options_t
+  bool stat_entries;
+  /// The number of threads walking the subdirectories in parallel.
+  /**
+   * With more than 1, the subdirectories are walked by a pool of that many threads, see
+   * ::rcutils_thread_pool_t, the calling thread being one of them.
+   * The callback is then called concurrently from the threads, in no particular order.
+   * 0 or 1 walk the directory depth first on the calling thread only.
+   */
+  size_t threads;
+} rcutils_dir_walk_options_t;
+
+/// Return the default options of ::rcutils_dir_walk
+/**
+ * The defaults are no depth limitation, no filters, no `stat` of the entries and a single
+ * thread.
+ *
+ * \return The default options.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_dir_walk_options_t
+rcutils_dir_walk_get_default_options(void);
+
+/// Visit the entries of a directory and of its subdirectories, like `nftw()`.
+/**
+ * It replaces nested ::rcutils_dir_iter_start loops with a `stat` of each path.
+ * Each directory is enumerated once, and the types of the entries are taken from the
+ * enumeration where the file system reports them, so that the entries are only `stat`ed with
+ * `stat_entries`, relative to their directory.
+ * On POSIX systems the subdirectories are opened relative to their parent as well, except
+ * those handed to another thread, which are opened by path once.
+ * The paths passed to the callback are built in a single buffer per thread.
+ *
+ * The walked directory itself isn't visited, and the "." and ".." entries are skipped.
+ * Symbolic links are visited, but not followed.
+ * A subdirectory which can't be opened fails the walk.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | No
+ *
+ * \param[in] directory_path The path of the directory to walk.
+ * \param[in] options The options of the walk, or `NULL` for the default ones.
+ * \param[in] callback The function called for each entry visited.
+ * \param[in] user_data Passed to the callback.
+ * \param[in] allocator Allocator being used for internal allocations.
+ * \return #RCUTILS_RET_OK if successful, including when the callback stops the walk, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails, or
+ * \return #RCUTILS_RET_ERROR if a directory can't be opened or enumerated.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_dir_walk(
+  const char * directory_path,
+  const rcutils_dir_walk_options_t * options,
+  rcutils_dir_walk_callback_t callback,
+  void * user_data,
+  rcutils_allocator_t allocator);
+
+/// The types of the changes reported by a file watcher, see ::rcutils_file_watcher_add_watch
+/**
+ * They are bit flags, so that a watch can be added for several of them.
+ */
+typedef enum rcutils_file_watch_event_type_t
+{
+  /// An entry was created in a watched directory
+  RCUTILS_FILE_WATCH_CREATED = 1 << 0,
+  /// An entry of a watched directory, or a watched file or directory, was deleted
+  RCUTILS_FILE_WATCH_DELETED = 1 << 1,
+  /// The contents of a watched file, or of an entry of a watched directory, were modified
+  RCUTILS_FILE_WATCH_MODIFIED = 1 << 2,
+  /// An entry was renamed or moved out of a watched directory, or a watched path was moved
+  RCUTILS_FILE_WATCH_MOVED_FROM = 1 << 3,
+  /// An entry was renamed or moved into a watched directory
+  RCUTILS_FILE_WATCH_MOVED_TO = 1 << 4,
+  /// Events were lost because the system ran out of room for them, always reported
+  RCUTILS_FILE_WATCH_OVERFLOW = 1 << 5,
+} rcutils_file_watch_event_type_t;
+
+/// All the types of changes a watch can be added for
+#define RCUTILS_FILE_WATCH_ALL \
+  (RCUTILS_FILE_WATCH_CREATED | RCUTILS_FILE_WATCH_DELETED | RCUTILS_FILE_WATCH_MODIFIED | \
+  RCUTILS_FILE_WATCH_MOVED_FROM | RCUTILS_FILE_WATCH_MOVED_TO)
+
+/// A change reported by a file watcher, see ::rcutils_file_watcher_read
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_file_watch_event_t
+{
+  /// The id of the watch the change was reported for, or -1 for #RCUTILS_FILE_WATCH_OVERFLOW
+  int32_t watch_id;
+  /// The type of the change
+  rcutils_file_watch_event_type_t type;
+  /// The name of the changed entry of the watched directory, or "" for the watched path itself
+  /**
+   * It is only valid during the callback it is passed to.
+   */
+  const char * name;
+} rcutils_file_watch_event_t;
+
+/// The function called for each change read by ::rcutils_file_watcher_read
+typedef void (* rcutils_file_watch_callback_t)(
+  const rcutils_file_watch_event_t * event, void * user_data);
+
+struct rcutils_file_watcher_impl_t;
+
+/// A set of watched files and directories whose changes are reported by the system.
+/**
+ * It replaces polling ::rcutils_exists or ::rcutils_get_file_size in a loop: the system
+ * queues the changes, which are read in batches with ::rcutils_file_watcher_read, either
+ * waiting for them or when the descriptor of ::rcutils_file_watcher_get_fd is readable.
+ *
+ * It uses inotify on Linux, kqueue on macOS and BSD, and `ReadDirectoryChangesW()` on
+ * Windows.
+ * kqueue doesn't report which entries of a watched directory changed, so any change of
+ * them is reported as #RCUTILS_FILE_WATCH_MODIFIED of the directory itself, with an empty
+ * name.
+ * Changes in subdirectories aren't reported, they have to be watched as well.
+ */
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_file_watcher_t
+{
+  /// A pointer to the PIMPL implementation type.
+  struct rcutils_file_watcher_impl_t * impl;
+} rcutils_file_watcher_t;
+
+/// Return a zero initialized file watcher.
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_file_watcher_t
+rcutils_get_zero_initialized_file_watcher(void);
+
+/// Initialize a zero initialized file watcher.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] watcher The zero initialized file watcher.
+ * \param[in] allocator The allocator used for the watcher and its watches.
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails, or
+ * \return #RCUTILS_RET_ERROR if the system refuses to watch files, or on systems where
+ *   watching files isn't supported.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_file_watcher_init(rcutils_file_watcher_t * watcher, const rcutils_allocator_t * allocator);
+
+/// Remove all the watches of a file watcher and free it.
+/**
+ * Finalizing a zero initialized file watcher does nothing.
+ *
+ * \param[inout] watcher The file watcher, zero initialized again.
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_file_watcher_fini(rcutils_file_watcher_t * watcher);
+
+/// Start reporting changes of a file or directory.
+/**
+ * A path should be watched once, Linux merges the watches of a path into one.
+ * Windows only reports changes of directories, so a file is watched through the changes of
+ * its directory, and at most 64 paths can be watched by a file watcher.
+ *
+ * \param[inout] watcher The initialized file watcher.
+ * \param[in] path The path of the file or directory to watch.
+ * \param[in] events The types of changes to report, a combination of
+ *   ::rcutils_file_watch_event_type_t flags.
+ * \param[out] watch_id The id of the watch, set in the events of the changes.
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_INITIALIZED if the watcher isn't initialized, or
+ * \return #RCUTILS_RET_NOT_FOUND if the path doesn't exist, or
+ * \return #RCUTILS_RET_NOT_ENOUGH_SPACE if the system refuses more watches, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails, or
+ * \return #RCUTILS_RET_ERROR if an unspecified error occurs.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_file_watcher_add_watch(
+  rcutils_file_watcher_t * watcher,
+  const char * path,
+  uint32_t events,
+  int32_t * watch_id);
+
+/// Stop reporting changes of a watched file or directory.
+/**
+ * Changes which were already queued may still be read.
+ *
+ * \param[inout] watcher The initialized file watcher.
+ * \param[in] watch_id The id set by ::rcutils_file_watcher_add_watch.
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_INITIALIZED if the watcher isn't initialized, or
+ * \return #RCUTILS_RET_NOT_FOUND if there is no such watch.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_file_watcher_remove_watch(rcutils_file_watcher_t * watcher, int32_t watch_id);
+
+/// Get a descriptor which is readable when changes can be read, for `poll()` or `epoll`.
+/**
+ * \param[in] watcher The initialized file watcher.
+ * \param[out] fd The descriptor, owned by the watcher, or -1 on Windows where there is none.
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_INITIALIZED if the watcher isn't initialized.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_file_watcher_get_fd(const rcutils_file_watcher_t * watcher, int * fd);
+
+/// Wait for changes of the watched paths, and pass each of them to a callback.
+/**
+ * This returns as soon as changes are queued, after passing all those queued to the
+ * callback, or when the timeout expires without any change.
+ * A timeout of 0 reads the queued changes without waiting, e.g. when the descriptor of
+ * ::rcutils_file_watcher_get_fd is readable.
+ * The callback must not add or remove watches.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] watcher The initialized file watcher.
+ * \param[in] timeout The maximum time to wait for changes in nanoseconds, negative to wait
+ *   until there are.
+ * \param[in] callback The function called for each change.
+ * \param[in] user_data The pointer passed to the callback.
+ * \param[out] event_count The number of changes passed to the callback, may be NULL.
+ * \return #RCUTILS_RET_OK if successful, even when the timeout expired, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_INITIALIZED if the watcher isn't initialized, or
+ * \return #RCUTILS_RET_ERROR if an unspecified error occurs.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_file_watcher_read(
+  rcutils_file_watcher_t * watcher,
+  rcutils_duration_value_t timeout,
+  rcutils_file_watch_callback_t callback,
+  void * user_data,
+  size_t * event_count);
+
 #ifdef __cplusplus
 }
 #endif
@@ -22,9 +22,24 @@ extern "C"
 {
 #endif
 
+#include <stdint.h>
+
+#include "rcutils/macros.h"
 #include "rcutils/types.h"
 #include "rcutils/visibility_control.h"
 
+/// A set of characters, to search for any of them at once.
+/**
+ * The set is a table with a bit for each of the 256 values of a character, so that each
+ * character of the string searched is checked against the whole set with a single lookup.
+ * Initialize it once with rcutils_char_set_init() and reuse it for every search.
+ */
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_char_set_t
+{
+  /// The bit of each character of the set.
+  uint64_t bits[4];
+} rcutils_char_set_t;
+
 /// Return the first index of a character in a string.
 /**
  * Search in a string for the first occurence of a delimiter.
@@ -85,6 +100,77 @@ RCUTILS_PUBLIC
 size_t
 rcutils_find_lastn(const char * str, char delimiter, size_t string_length);
 
+/// Initialize a set with the characters of a string.
+/**
+ * \param[out] set the set to initialize
+ * \param[in] chars null terminated c string of the characters of the set
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_char_set_init(rcutils_char_set_t * set, const char * chars);
+
+/// Return the first index of any of several characters in a string.
+/**
+ * Search in a string for the first occurence of any of the delimiters, in a single pass.
+ *
+ * \param[in] str null terminated c string to search
+ * \param[in] delimiters null terminated c string of the characters to search for
+ * \return the index of the first occurence of a delimiter if found, or
+ * \return `SIZE_MAX` for invalid arguments, or
+ * \return `SIZE_MAX` if no delimiter is found.
+ */
+RCUTILS_PUBLIC
+size_t
+rcutils_find_any(const char * str, const char * delimiters);
+
+/// Return the first index of any of the characters of a set in a string of specified length.
+/**
+ * Like rcutils_find_any() but without relying on the string to be a null terminated c string,
+ * and with a set initialized once with rcutils_char_set_init().
+ *
+ * \param[in] str string to search
+ * \param[in] delimiters the set of characters to search for
+ * \param[in] string_length length of the string to search
+ * \return the index of the first occurence of a delimiter if found, or
+ * \return `SIZE_MAX` for invalid arguments, or
+ * \return `SIZE_MAX` if no delimiter is found.
+ */
+RCUTILS_PUBLIC
+size_t
+rcutils_find_anyn(
+  const char * str, const rcutils_char_set_t * delimiters, size_t string_length);
+
+/// Return the first index of a substring in a string.
+/**
+ * \param[in] str null terminated c string to search
+ * \param[in] substring null terminated c string to search for
+ * \return the index of the first occurence of the substring if found, or
+ * \return `SIZE_MAX` for invalid arguments, or
+ * \return `SIZE_MAX` if the substring is empty or not found.
+ */
+RCUTILS_PUBLIC
+size_t
+rcutils_find_str(const char * str, const char * substring);
+
+/// Return the first index of a substring in a string of specified length.
+/**
+ * Identical to rcutils_find_str() but without relying on the string to be a
+ * null terminated c string.
+ *
+ * \param[in] str string to search
+ * \param[in] substring null terminated c string to search for
+ * \param[in] string_length length of the string to search
+ * \return the index of the first occurence of the substring if found, or
+ * \return `SIZE_MAX` for invalid arguments, or
+ * \return `SIZE_MAX` if the substring is empty or not found.
+ */
+RCUTILS_PUBLIC
+size_t
+rcutils_find_strn(const char * str, const char * substring, size_t string_length);
+
 #ifdef __cplusplus
 }
 #endif
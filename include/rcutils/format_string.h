@@ -20,10 +20,13 @@ extern "C"
 {
 #endif
 
+#include <stdarg.h>
 #include <string.h>
 
 #include "rcutils/allocator.h"
 #include "rcutils/macros.h"
+#include "rcutils/types/char_array.h"
+#include "rcutils/types/rcutils_ret.h"
 #include "rcutils/visibility_control.h"
 
 /// Return a newly allocated string, created with a format string.
@@ -37,9 +40,11 @@ extern "C"
 
 /// Return a newly allocated string, created with a format string up to a limit.
 /**
- * This function uses snprintf_s to determine the length of the resulting
- * string and allocates storage for the resulting string, formats it, and
- * then returns the result.
+ * This function formats the string into a small buffer on the stack, allocates
+ * storage for the resulting string and copies it there, and then returns the
+ * result.
+ * Only strings too long for the stack buffer are formatted a second time, into
+ * the allocated storage.
  *
  * This function can fail and therefore return null if the format_string is
  * null or if memory allocation fails or if snprintf_s fails.
@@ -76,6 +81,61 @@ RCUTILS_ATTRIBUTE_PRINTF_FORMAT(3, 4)
 /// @endcond
 ;
 
+/// Return a newly allocated string, created with a format string and a `va_list` up to a limit.
+/**
+ * This function is equivalent to rcutils_format_string_limit(), except that it takes the
+ * arguments as a `va_list`, which is cloned before being used, so that a user can safely use
+ * it again after calling this function.
+ *
+ * \param[in] allocator the allocator to use for allocation
+ * \param[in] limit maximum length of the output string
+ * \param[in] format_string format of the output, must be null terminated
+ * \param[in] args the arguments of the format string
+ * \return The newly allocated and format output string, or
+ * \return `NULL` if there was an error.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+char *
+rcutils_vformat_string_limit(
+  rcutils_allocator_t allocator,
+  size_t limit,
+  const char * format_string,
+  va_list args);
+
+/// Format a string into a char array up to a limit, reusing its buffer.
+/**
+ * This function replaces the string in the char array with the one formatted as by
+ * rcutils_format_string_limit(), so that the same char array can be reused for several
+ * strings without allocating memory once its buffer is large enough.
+ * The string is formatted a single time if it fits in the capacity of the buffer, otherwise
+ * the buffer is expanded, up to the limit, and the string is formatted again.
+ *
+ * Output strings that would be longer than the given limit are truncated, and `buffer_length`
+ * counts the terminating null character, as for rcutils_char_array_vsprintf().
+ *
+ * \param[inout] char_array the char array to format the string into
+ * \param[in] limit maximum length of the output string, including the null character
+ * \param[in] format_string format of the output, must be null terminated
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation failed, or
+ * \return #RCUTILS_RET_NOT_ENOUGH_SPACE if the buffer would exceed `max_capacity`, or
+ * \return #RCUTILS_RET_ERROR if formatting fails.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_format_string_limit_char_array(
+  rcutils_char_array_t * char_array,
+  size_t limit,
+  const char * format_string,
+  ...)
+/// @cond Doxygen_Suppress
+RCUTILS_ATTRIBUTE_PRINTF_FORMAT(3, 4)
+/// @endcond
+;
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,184 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// @file
+
+#ifndef RCUTILS__INTERN_H_
+#define RCUTILS__INTERN_H_
+
+#include <stddef.h>
+
+#include "rcutils/macros.h"
+#include "rcutils/types/rcutils_ret.h"
+#include "rcutils/visibility_control.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/// The id which no interned string has.
+#define RCUTILS_INTERN_INVALID_ID ((size_t)0)
+
+/// Intern a string, returning the copy shared by every string equal to it.
+/**
+ * The process wide interning table keeps a single null terminated copy of every distinct
+ * string interned, so that interned strings may be compared by pointer or by id.
+ * The ids are assigned consecutively starting from 1, in the order the strings are first
+ * interned.
+ * The interned strings and their ids remain valid until rcutils_intern_shutdown() is called.
+ *
+ * The string only needs to be length characters long, it doesn't need to be null terminated,
+ * but it may not contain null characters.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes, the first time a string is interned
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | No
+ *
+ * \param[in] str the characters of the string, may be NULL if length is 0
+ * \param[in] length the number of characters of the string
+ * \param[out] interned the interned copy of the string, may be NULL
+ * \param[out] id the id of the interned string, may be NULL
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_intern_stringn(const char * str, size_t length, const char ** interned, size_t * id);
+
+/// Intern a null terminated string.
+/**
+ * This function is equivalent to rcutils_intern_stringn() called with `strlen(str)`.
+ *
+ * \param[in] str the null terminated string to intern
+ * \param[out] interned the interned copy of the string, may be NULL
+ * \param[out] id the id of the interned string, may be NULL
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_intern_string(const char * str, const char ** interned, size_t * id);
+
+/// Look up a string in the interning table without interning it.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | No
+ *
+ * \param[in] str the characters of the string, may be NULL if length is 0
+ * \param[in] length the number of characters of the string
+ * \param[out] interned the interned copy of the string, may be NULL
+ * \param[out] id the id of the interned string, may be NULL
+ * \return #RCUTILS_RET_OK if the string is interned, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_FOUND if the string isn't interned.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_intern_findn(const char * str, size_t length, const char ** interned, size_t * id);
+
+/// Get the interned string with the given id.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[in] id the id returned when interning the string
+ * \return the interned string, or
+ * \return `NULL` if no string has the id.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+const char *
+rcutils_intern_get_string(size_t id);
+
+/// Get the number of strings in the interning table.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \return the number of distinct strings interned, which is also the largest id.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+size_t
+rcutils_intern_get_count(void);
+
+/// Deallocate the interning table, invalidating every interned string and id.
+/**
+ * This function is meant to be called when the process terminates, or between tests.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ */
+RCUTILS_PUBLIC
+void
+rcutils_intern_shutdown(void);
+
+/// Hash an interned string key of a rcutils_hash_map_t by its address.
+/**
+ * The keys of the map are interned `const char *`, so that hashing and comparing them
+ * doesn't need to read their characters.
+ *
+ * \param[in] key a pointer to the `const char *` key
+ * \return the hash of the key
+ */
+RCUTILS_PUBLIC
+size_t
+rcutils_intern_hash_func(const void * key);
+
+/// Compare two interned string keys of a rcutils_hash_map_t by their address.
+/**
+ * \param[in] val1 a pointer to the first `const char *` key
+ * \param[in] val2 a pointer to the second `const char *` key
+ * \return 0 if the keys are the same interned string, or
+ * \return a nonzero value otherwise.
+ */
+RCUTILS_PUBLIC
+int
+rcutils_intern_cmp_func(const void * val1, const void * val2);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCUTILS__INTERN_H_
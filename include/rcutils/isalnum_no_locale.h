@@ -22,26 +22,69 @@ extern "C"
 {
 #endif
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rcutils/macros.h"
+#include "rcutils/visibility_control.h"
+
+/// The digits, '0' to '9'.
+#define RCUTILS_CHAR_CLASS_DIGIT 0x01u
+/// The upper case ASCII letters, 'A' to 'Z'.
+#define RCUTILS_CHAR_CLASS_UPPER 0x02u
+/// The lower case ASCII letters, 'a' to 'z'.
+#define RCUTILS_CHAR_CLASS_LOWER 0x04u
+/// The underscore, '_'.
+#define RCUTILS_CHAR_CLASS_UNDERSCORE 0x08u
+/// The forward slash, '/', separating the tokens of a name.
+#define RCUTILS_CHAR_CLASS_SLASH 0x10u
+/// The tilde, '~', expanded to the node's namespace.
+#define RCUTILS_CHAR_CLASS_TILDE 0x20u
+/// The curly braces, '{' and '}', around substitutions.
+#define RCUTILS_CHAR_CLASS_BRACE 0x40u
+/// The ASCII letters and digits, as matched by rcutils_isalnum_no_locale().
+#define RCUTILS_CHAR_CLASS_ALNUM \
+  (RCUTILS_CHAR_CLASS_DIGIT | RCUTILS_CHAR_CLASS_UPPER | RCUTILS_CHAR_CLASS_LOWER)
+
+/// The classes of each character, indexed by its value as an unsigned char.
+/**
+ * Each entry is a combination of the `RCUTILS_CHAR_CLASS_*` flags, or 0 for the
+ * characters which are in none of them, including all those of 0x80 and above.
+ */
+RCUTILS_PUBLIC
+extern const uint8_t rcutils_char_class_table[256];
+
 /// Custom isalnum() which is not affected by locale.
 static inline
 bool
 rcutils_isalnum_no_locale(char c)
 {
-  // if in '0', ..., '9', then ok
-  if (c >= 0x30 /*0*/ && c <= 0x39 /*9*/) {
-    return true;
-  }
-  // if in 'A', ..., 'Z', then ok
-  if (c >= 0x41 /*A*/ && c <= 0x5a /*Z*/) {
-    return true;
-  }
-  // if in 'a', ..., 'z', then ok
-  if (c >= 0x61 /*a*/ && c <= 0x7a /*z*/) {
-    return true;
-  }
-  return false;
+  return 0u != (rcutils_char_class_table[(unsigned char)c] & RCUTILS_CHAR_CLASS_ALNUM);
 }
 
+/// Find the first character of a string which isn't in the given classes.
+/**
+ * This is the bulk version of checking each character against rcutils_char_class_table,
+ * used to validate names: 16 characters are checked at a time with SSE2 or NEON
+ * instructions where available.
+ * The string doesn't need to be null terminated, and null characters are invalid.
+ *
+ * For example, the characters of a fully qualified name can be checked with
+ * `RCUTILS_CHAR_CLASS_ALNUM | RCUTILS_CHAR_CLASS_UNDERSCORE | RCUTILS_CHAR_CLASS_SLASH`.
+ *
+ * \param[in] str The characters to check.
+ * \param[in] len The number of characters to check.
+ * \param[in] class_mask The combination of `RCUTILS_CHAR_CLASS_*` flags which are valid.
+ * \return The index of the first character in none of the classes, or
+ * \return len if all the characters are valid, or
+ * \return 0 if str is NULL.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+size_t
+rcutils_validate_chars(const char * str, size_t len, uint32_t class_mask);
+
 #ifdef __cplusplus
 }
 #endif
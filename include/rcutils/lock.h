@@ -0,0 +1,277 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// @file
+
+#ifndef RCUTILS__LOCK_H_
+#define RCUTILS__LOCK_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rcutils/macros.h"
+#include "rcutils/visibility_control.h"
+
+// The states of the locks are only accessed atomically, with the operations of
+// stdatomic_helper.h, which can't be used in this header as it must compile as C++.
+
+/// A lock which waits by spinning, for critical sections shorter than putting a thread to sleep.
+/**
+ * Waiting threads spin with a pause hint, backing off exponentially, and yield their processor
+ * once the backoff is at its longest.
+ * Locking and unlocking a lock which isn't contended are a single atomic operation each.
+ * The lock isn't fair nor recursive.
+ *
+ * A zero initialized lock is unlocked, and needs no finalization.
+ */
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_spinlock_t
+{
+  /// Whether the lock is held.
+  uint32_t locked;
+} rcutils_spinlock_t;
+
+/// A spinning lock granting the lock to the threads in the order they ask for it.
+/**
+ * Each thread takes a ticket, and waits as rcutils_spinlock_t does until the ticket is served.
+ * This prevents starving a thread, at the cost of handing the lock over to a thread which
+ * may not be running, so it's best used with no more threads than processors.
+ *
+ * A zero initialized lock is unlocked, and needs no finalization.
+ */
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_ticket_lock_t
+{
+  /// The ticket of the next thread to lock.
+  uint32_t next_ticket;
+  /// The ticket of the thread holding the lock, or of the next one if none does.
+  uint32_t serving_ticket;
+} rcutils_ticket_lock_t;
+
+/// A mutex putting waiting threads to sleep, with a fast path when it isn't contended.
+/**
+ * Locking and unlocking a mutex which isn't contended are a single atomic operation each,
+ * without calling into the kernel.
+ * Contended threads spin briefly, then sleep with futex() on Linux, WaitOnAddress() on
+ * Windows, and yield their processor elsewhere.
+ * The mutex isn't fair nor recursive.
+ *
+ * A zero initialized mutex is unlocked, and needs no finalization.
+ */
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_mutex_t
+{
+  /// 0 if unlocked, 1 if locked, 2 if locked and threads may be waiting.
+  uint32_t state;
+} rcutils_mutex_t;
+
+/// A lock for data which is read often and written rarely, without blocking the readers.
+/**
+ * A writer makes the sequence odd while it writes, and even again once it's done.
+ * Readers copy the data without writing to the lock, and copy it again if the sequence was
+ * odd or changed meanwhile, so they never block writers nor each other, and don't share a
+ * written cache line when there are no writes.
+ * The data must be plain old data, as readers may copy it while it's half written, only to
+ * throw that copy away, and small, so that copying it again is cheap.
+ * rcutils_seqlock_read() and rcutils_seqlock_write() copy it with relaxed atomic loads and
+ * stores, so that these copies don't race; data read or written between the other functions
+ * must be accessed atomically as well.
+ * Writers exclude each other, spinning as rcutils_spinlock_t does.
+ *
+ * A zero initialized lock is unlocked, and needs no finalization.
+ */
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_seqlock_t
+{
+  /// The number of writes started and finished, odd while a write is in progress.
+  uint32_t sequence;
+} rcutils_seqlock_t;
+
+/// Return a zero initialized, so unlocked, spinlock.
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_spinlock_t
+rcutils_get_zero_initialized_spinlock(void);
+
+/// Lock the spinlock, waiting until it's unlocked.
+/**
+ * \param[inout] lock the lock, which must not be NULL
+ */
+RCUTILS_PUBLIC
+void
+rcutils_spinlock_lock(rcutils_spinlock_t * lock);
+
+/// Lock the spinlock if it's unlocked, without waiting.
+/**
+ * \param[inout] lock the lock, which must not be NULL
+ * \return `true` if the lock is now held by the caller, or
+ * \return `false` if it's held by another thread.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+bool
+rcutils_spinlock_try_lock(rcutils_spinlock_t * lock);
+
+/// Unlock the spinlock held by the caller.
+/**
+ * \param[inout] lock the lock, which must not be NULL
+ */
+RCUTILS_PUBLIC
+void
+rcutils_spinlock_unlock(rcutils_spinlock_t * lock);
+
+/// Return a zero initialized, so unlocked, ticket lock.
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ticket_lock_t
+rcutils_get_zero_initialized_ticket_lock(void);
+
+/// Lock the ticket lock, waiting for the threads which asked for it before.
+/**
+ * \param[inout] lock the lock, which must not be NULL
+ */
+RCUTILS_PUBLIC
+void
+rcutils_ticket_lock_lock(rcutils_ticket_lock_t * lock);
+
+/// Lock the ticket lock if it's unlocked and no thread is waiting for it, without waiting.
+/**
+ * \param[inout] lock the lock, which must not be NULL
+ * \return `true` if the lock is now held by the caller, or
+ * \return `false` otherwise.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+bool
+rcutils_ticket_lock_try_lock(rcutils_ticket_lock_t * lock);
+
+/// Unlock the ticket lock held by the caller, handing it over to the next waiting thread.
+/**
+ * \param[inout] lock the lock, which must not be NULL
+ */
+RCUTILS_PUBLIC
+void
+rcutils_ticket_lock_unlock(rcutils_ticket_lock_t * lock);
+
+/// Return a zero initialized, so unlocked, mutex.
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_mutex_t
+rcutils_get_zero_initialized_mutex(void);
+
+/// Lock the mutex, sleeping until it's unlocked.
+/**
+ * \param[inout] mutex the mutex, which must not be NULL
+ */
+RCUTILS_PUBLIC
+void
+rcutils_mutex_lock(rcutils_mutex_t * mutex);
+
+/// Lock the mutex if it's unlocked, without waiting.
+/**
+ * \param[inout] mutex the mutex, which must not be NULL
+ * \return `true` if the mutex is now held by the caller, or
+ * \return `false` if it's held by another thread.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+bool
+rcutils_mutex_try_lock(rcutils_mutex_t * mutex);
+
+/// Unlock the mutex held by the caller, waking a waiting thread if there is one.
+/**
+ * \param[inout] mutex the mutex, which must not be NULL
+ */
+RCUTILS_PUBLIC
+void
+rcutils_mutex_unlock(rcutils_mutex_t * mutex);
+
+/// Return a zero initialized, so unlocked, seqlock.
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_seqlock_t
+rcutils_get_zero_initialized_seqlock(void);
+
+/// Start reading the data protected by the seqlock, waiting for a write in progress to end.
+/**
+ * The data read until rcutils_seqlock_read_retry() must only be used if that returns
+ * `false`, and must be read again from here otherwise.
+ *
+ * \param[in] lock the lock, which must not be NULL
+ * \return the sequence to pass to rcutils_seqlock_read_retry().
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+uint32_t
+rcutils_seqlock_read_begin(const rcutils_seqlock_t * lock);
+
+/// Check whether the data read since rcutils_seqlock_read_begin() may be inconsistent.
+/**
+ * \param[in] lock the lock, which must not be NULL
+ * \param[in] sequence the sequence returned by rcutils_seqlock_read_begin()
+ * \return `true` if the data was written meanwhile, and must be read again, or
+ * \return `false` if the data read is consistent.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+bool
+rcutils_seqlock_read_retry(const rcutils_seqlock_t * lock, uint32_t sequence);
+
+/// Lock the seqlock for writing, waiting for another writer to finish.
+/**
+ * \param[inout] lock the lock, which must not be NULL
+ */
+RCUTILS_PUBLIC
+void
+rcutils_seqlock_write_lock(rcutils_seqlock_t * lock);
+
+/// Unlock the seqlock locked for writing by the caller, publishing the data written.
+/**
+ * \param[inout] lock the lock, which must not be NULL
+ */
+RCUTILS_PUBLIC
+void
+rcutils_seqlock_write_unlock(rcutils_seqlock_t * lock);
+
+/// Copy the data protected by the seqlock, retrying until the copy is consistent.
+/**
+ * \param[in] lock the lock, which must not be NULL
+ * \param[out] destination where the data is copied, which must not be NULL
+ * \param[in] source the data protected by the lock, which must not be NULL
+ * \param[in] size the size of the data, in bytes
+ */
+RCUTILS_PUBLIC
+void
+rcutils_seqlock_read(
+  const rcutils_seqlock_t * lock, void * destination, const void * source, size_t size);
+
+/// Write the data protected by the seqlock, from a copy of it.
+/**
+ * \param[inout] lock the lock, which must not be NULL
+ * \param[out] destination the data protected by the lock, which must not be NULL
+ * \param[in] source the data to copy, which must not be NULL
+ * \param[in] size the size of the data, in bytes
+ */
+RCUTILS_PUBLIC
+void
+rcutils_seqlock_write(
+  rcutils_seqlock_t * lock, void * destination, const void * source, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCUTILS__LOCK_H_
@@ -20,6 +20,9 @@
 #include <stdarg.h>
 #include <stdbool.h>
 #include <stdio.h>
+#if defined(_MSC_VER)
+# include <intrin.h>
+#endif
 
 #include "rcutils/allocator.h"
 #include "rcutils/error_handling.h"
@@ -68,8 +71,16 @@ extern bool g_rcutils_logging_initialized;
  *   - `message`, the message string after it has been formatted
  *   - `name`, the full logger name
  *   - `severity`, the name of the severity level, e.g. `INFO`
+ *   - `thread_id`, the id of the thread logging, see rcutils_thread_get_id()
+ *   - `thread_name`, the name of the thread logging, see rcutils_thread_get_cached_name()
  *   - `time`, the timestamp of log message in floating point seconds
  *   - `time_as_nanoseconds`, the timestamp of log message in integer nanoseconds
+ *   - `time_ms`, the timestamp of log message in floating point seconds, truncated to
+ *     milliseconds
+ *   - `time_us`, the timestamp of log message in floating point seconds, truncated to
+ *     microseconds
+ *   - `time_iso8601`, the timestamp of log message as ISO 8601 local date and time,
+ *     e.g. `2020-08-04T17:22:05.123456789`
  *
  * The `RCUTILS_COLORIZED_OUTPUT` environment variable allows configuring if colours
  * are used or not. Available values are:
@@ -78,6 +89,26 @@ extern bool g_rcutils_logging_initialized;
  * If it is unset, colours are used depending if the target stream is a terminal or not.
  * See `isatty` documentation.
  *
+ * The `RCUTILS_LOGGING_STREAM_BUFFER_SIZE` environment variable allows gathering the
+ * messages logged to the console in a fully buffered stream of the given size in bytes,
+ * instead of writing each of them separately.
+ * The stream is then written when the buffer is full, when a message of severity `WARN` or
+ * higher is logged, and when a message is logged at least
+ * `RCUTILS_LOGGING_STREAM_FLUSH_PERIOD_MS` milliseconds (100 by default) after the last
+ * time the stream was written, so a message may stay in the buffer until the next one is
+ * logged or the logging system is shut down.
+ * It takes precedence over `RCUTILS_LOGGING_BUFFERED_STREAM`, and `0` leaves the stream as
+ * configured by the latter.
+ *
+ * The `RCUTILS_LOGGING_COARSE_TIMESTAMPS` environment variable set to `1` timestamps the
+ * records with rcutils_coarse_system_time_now() rather than rcutils_system_time_now(),
+ * which is cheaper but only has the resolution of rcutils_coarse_time_resolution(),
+ * typically a few milliseconds.
+ *
+ * The `RCUTILS_LOGGING_FAST_FORMAT` environment variable set to `1` formats the messages
+ * with rcutils_fast_vsnprintf(), which handles the common conversions without the locale
+ * aware formatting of the C library.
+ *
  * The format string can use these tokens by referencing them in curly brackets,
  * e.g. `"[{severity}] [{name}]: {message} ({function_name}() at {file_name}:{line_number})"`.
  * Any number of tokens can be used.
@@ -184,9 +215,12 @@ extern const char * const g_rcutils_log_severity_names[RCUTILS_LOG_SEVERITY_FATA
  * `g_rcutils_log_severity_names`, but is not case-sensitive.
  * Examples: UNSET, DEBUG, INFO, WARN, Error, fatal.
  *
+ * This is rcutils_logging_severity_level_from_stringn() with the length of the string, which
+ * doesn't allocate memory.
+ *
  * \param[in] severity_string String representation of the severity, must be a
  *   null terminated c string
- * \param[in] allocator rcutils_allocator_t to be used
+ * \param[in] allocator rcutils_allocator_t, only checked for validity for compatibility
  * \param[in,out] severity The severity level as a represented by the
  *   `RCUTILS_LOG_SEVERITY` enum
  * \return #RCUTILS_RET_OK if successful, or
@@ -201,6 +235,37 @@ rcutils_ret_t
 rcutils_logging_severity_level_from_string(
   const char * severity_string, rcutils_allocator_t allocator, int * severity);
 
+/// Get a severity value from the first characters of a string (e.g. DEBUG).
+/**
+ * Like rcutils_logging_severity_level_from_string(), the string must match one of the values
+ * in `g_rcutils_log_severity_names`, ignoring the case of the ASCII letters, whatever the
+ * locale.
+ * The string doesn't need to be null terminated, e.g. a part of a larger string, and is
+ * parsed without allocating memory.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] severity_string String representation of the severity
+ * \param[in] length The number of characters of severity_string to parse
+ * \param[out] severity The severity level as a represented by the
+ *   `RCUTILS_LOG_SEVERITY` enum
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT on invalid arguments, or
+ * \return #RCUTILS_RET_LOGGING_SEVERITY_STRING_INVALID if unable to match
+ *   string.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_logging_severity_level_from_stringn(
+  const char * severity_string, size_t length, int * severity);
+
 /// The function signature to log messages.
 /**
  * \param[in] location The location information about where the log came from
@@ -289,18 +354,61 @@ rcutils_ret_t rcutils_logging_format_message(
  * calls where the effective level of the logger name is unspecified.
  *
  * \see rcutils_logging_get_logger_effective_level()
+ *
+ * It's read by logging threads while it's set, so the logging system only accesses it with
+ * RCUTILS_LOGGING_LOAD_LEVEL() and RCUTILS_LOGGING_STORE_LEVEL().
  */
 RCUTILS_PUBLIC
 extern int g_rcutils_logging_default_logger_level;
 
+/**
+ * \def RCUTILS_LOGGING_LOAD_LEVEL
+ * Load a severity level global of the logging system atomically, with relaxed ordering.
+ *
+ * The globals are declared as `int` so that C and C++ share their declaration, and are only
+ * accessed atomically, with this and RCUTILS_LOGGING_STORE_LEVEL().
+ */
+/**
+ * \def RCUTILS_LOGGING_STORE_LEVEL
+ * Store a severity level global of the logging system atomically, with relaxed ordering.
+ */
+#if defined(_MSC_VER)
+# define RCUTILS_LOGGING_LOAD_LEVEL(level) \
+  ((int)__iso_volatile_load32((const volatile __int32 *)&(level)))
+# define RCUTILS_LOGGING_STORE_LEVEL(level, value) \
+  __iso_volatile_store32((volatile __int32 *)&(level), (__int32)(value))
+#else
+# define RCUTILS_LOGGING_LOAD_LEVEL(level) __atomic_load_n(&(level), __ATOMIC_RELAXED)
+# define RCUTILS_LOGGING_STORE_LEVEL(level, value) \
+  __atomic_store_n(&(level), (value), __ATOMIC_RELAXED)
+#endif
+
+/// The lowest severity level any logger is enabled for.
+/**
+ * This is the lowest of the default level, the levels set for loggers and the severity of the
+ * started flight recorder, see rcutils_logging_flight_recorder_start(), kept up to date
+ * whenever they change, so that the logging macros skip messages of lower severities inline,
+ * without any function call.
+ * It is 0, enabling everything, while the logging system isn't initialized and while the
+ * logging statistics are enabled, so that the filtered messages are counted.
+ *
+ * It's only written by the logging system, with RCUTILS_LOGGING_STORE_LEVEL(), and is read
+ * with RCUTILS_LOGGING_LOAD_LEVEL().
+ * Writing g_rcutils_logging_default_logger_level directly, rather than with
+ * rcutils_logging_set_default_logger_level(), doesn't update it, so the logging macros only
+ * skip the messages below both of them.
+ */
+RCUTILS_PUBLIC
+extern int g_rcutils_logging_lowest_enabled_severity;
+
 /// Get the default level for loggers.
 /**
  * <hr>
  * Attribute          | Adherence
  * ------------------ | -------------
  * Allocates Memory   | No, provided logging system is already initialized
- * Thread-Safe        | No
- * Uses Atomics       | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
  * Lock-Free          | Yes
  *
  * \return The level.
@@ -319,9 +427,9 @@ int rcutils_logging_get_default_logger_level();
  * Attribute          | Adherence
  * ------------------ | -------------
  * Allocates Memory   | No, provided logging system is already initialized
- * Thread-Safe        | No
- * Uses Atomics       | No
- * Lock-Free          | Yes
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | No
  *
  * \param[in] level The level to be used.
  */
@@ -338,8 +446,8 @@ void rcutils_logging_set_default_logger_level(int level);
  * Attribute          | Adherence
  * ------------------ | -------------
  * Allocates Memory   | No, provided logging system is already initialized
- * Thread-Safe        | No
- * Uses Atomics       | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
  * Lock-Free          | Yes
  *
  * \param[in] name The name of the logger, must be null terminated c string
@@ -362,8 +470,8 @@ int rcutils_logging_get_logger_level(const char * name);
  * Attribute          | Adherence
  * ------------------ | -------------
  * Allocates Memory   | No, provided logging system is already initialized
- * Thread-Safe        | No
- * Uses Atomics       | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
  * Lock-Free          | Yes
  *
  * \param[in] name The name of the logger
@@ -383,12 +491,18 @@ int rcutils_logging_get_logger_leveln(const char * name, size_t name_length);
  * If an empty string is specified as the name, the
  * `g_rcutils_logging_default_logger_level` will be set.
  *
+ * The levels of the loggers are published as an immutable snapshot, so that
+ * other threads can look them up concurrently without locking.
+ * Setting a level copies the snapshot and publishes the copy; the replaced
+ * snapshot is only freed by rcutils_logging_shutdown(), as readers may still
+ * be using it.
+ *
  * <hr>
  * Attribute          | Adherence
  * ------------------ | -------------
  * Allocates Memory   | Yes
- * Thread-Safe        | No
- * Uses Atomics       | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
  * Lock-Free          | Yes
  *
  * \param[in] name The name of the logger, must be null terminated c string.
@@ -402,14 +516,74 @@ RCUTILS_PUBLIC
 RCUTILS_WARN_UNUSED
 rcutils_ret_t rcutils_logging_set_logger_level(const char * name, int level);
 
+/// Limit the rate of the messages logged with a logger.
+/**
+ * rcutils_log() drops the messages of the logger exceeding a token bucket which allows
+ * `rate` messages per second on average and up to `burst` messages at once, before
+ * formatting them.
+ * The next message which passes is preceded by one of the same severity telling how many
+ * messages were suppressed.
+ * The limit applies to the logger with this exact name, not to its descendants.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[in] name The name of the logger, must be null terminated c string.
+ * \param[in] rate The average number of messages per second, or 0 to remove the limit.
+ * \param[in] burst The number of messages which may be logged at once, at least 1.
+ * \return `RCUTILS_RET_OK` if successful, or
+ * \return `RCUTILS_RET_INVALID_ARGUMENT` on invalid arguments, or
+ * \return `RCUTILS_RET_LOGGING_SEVERITY_MAP_INVALID` if severity map invalid, or
+ * \return `RCUTILS_RET_BAD_ALLOC` if allocating memory failed, or
+ * \return `RCUTILS_RET_ERROR` if an unspecified error occured
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t rcutils_logging_set_logger_rate_limit(const char * name, size_t rate, size_t burst);
+
+/// Log only one in every n messages of a logger.
+/**
+ * rcutils_log() drops the other messages before formatting them.
+ * Sampling applies before the rate limit, see rcutils_logging_set_logger_rate_limit(), and the
+ * dropped messages are reported the same way.
+ * The sampling applies to the logger with this exact name, not to its descendants.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[in] name The name of the logger, must be null terminated c string.
+ * \param[in] n The sampling period, 0 or 1 to log all the messages.
+ * \return `RCUTILS_RET_OK` if successful, or
+ * \return `RCUTILS_RET_INVALID_ARGUMENT` on invalid arguments, or
+ * \return `RCUTILS_RET_LOGGING_SEVERITY_MAP_INVALID` if severity map invalid, or
+ * \return `RCUTILS_RET_BAD_ALLOC` if allocating memory failed, or
+ * \return `RCUTILS_RET_ERROR` if an unspecified error occured
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t rcutils_logging_set_logger_sampling(const char * name, size_t n);
+
 /// Determine if a logger is enabled for a severity level.
 /**
+ * The logger is enabled for the severities the started flight recorder records as well,
+ * see rcutils_logging_flight_recorder_start().
+ *
  * <hr>
  * Attribute          | Adherence
  * ------------------ | -------------
- * Allocates Memory   | No, provided logging system is already initialized
- * Thread-Safe        | No
- * Uses Atomics       | No
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
  * Lock-Free          | Yes
  *
  * \param[in] name The name of the logger, must be null terminated c string or NULL.
@@ -433,12 +607,16 @@ bool rcutils_logging_logger_is_enabled_for(const char * name, int severity);
  * If the level has not been set for the logger nor any of its
  * ancestors, the default level is used.
  *
+ * The ancestors are looked up in a single pass over the logger name.
+ * Use a logger handle, see rcutils_logging_get_logger(), to avoid processing
+ * the name again for each call.
+ *
  * <hr>
  * Attribute          | Adherence
  * ------------------ | -------------
- * Allocates Memory   | No, provided logging system is already initialized
- * Thread-Safe        | No
- * Uses Atomics       | No
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
  * Lock-Free          | Yes
  *
  * \param[in] name The name of the logger, must be null terminated c string.
@@ -451,6 +629,164 @@ RCUTILS_PUBLIC
 RCUTILS_WARN_UNUSED
 int rcutils_logging_get_logger_effective_level(const char * name);
 
+/// A handle to a named logger which keeps its resolved severity level.
+/**
+ * Checking if a logger is enabled through a handle avoids processing the
+ * logger name, as long as no logger level has changed since the level of the
+ * logger was last resolved.
+ * Changes of the default logger level are always honored.
+ *
+ * A handle must be zero initialized with rcutils_get_zero_initialized_logger()
+ * and obtained with rcutils_logging_get_logger().
+ * A handle may be used by several threads at once, e.g. the one of a logging
+ * macro call site.
+ */
+typedef struct rcutils_logger_t
+{
+  /// The name of the logger, not owned by the handle.
+  const char * name;
+  /// The resolved level of the logger in the low 32 bits and the state of the logger levels
+  /// it was resolved from in the high 32 bits, or 0 if not resolved yet.
+  /**
+   * The level is the one of the logger or of its closest ancestor with a level set, or
+   * `RCUTILS_LOG_SEVERITY_UNSET` if the default logger level applies.
+   * Both are kept in a single word so that threads can share a handle.
+   */
+  uint64_t resolved;
+} rcutils_logger_t;
+
+/// Return a zero initialized logger handle.
+/**
+ * A zero initialized logger handle behaves as a nameless logger.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \return A zero initialized logger handle.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_logger_t rcutils_get_zero_initialized_logger(void);
+
+/// Get a handle to a logger.
+/**
+ * The name is not copied, it must remain valid and unchanged for as long as
+ * the handle is used, e.g. a string literal.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[in] name The name of the logger, must be null terminated c string.
+ * \param[out] logger The handle to the logger.
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT on invalid arguments, or
+ * \return #RCUTILS_RET_ERROR if an error occurred.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t rcutils_logging_get_logger(const char * name, rcutils_logger_t * logger);
+
+/// Determine if the logger of a handle is enabled for a severity level.
+/**
+ * Equivalent to rcutils_logging_logger_is_enabled_for() with the name of the
+ * logger, but the name is only processed again if any logger level has been
+ * set since the handle was last used.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[in,out] logger The handle to the logger, its resolved level is
+ *   updated if needed.
+ * \param[in] severity The severity level.
+ * \return `true` if the logger is enabled for the level, or
+ * \return `false` otherwise.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+bool rcutils_logging_logger_handle_is_enabled_for(rcutils_logger_t * logger, int severity);
+
+/// Determine if a logger is enabled for a severity level through a handle bound on first use.
+/**
+ * The first call binds the zero initialized handle to the name, later calls with the
+ * same name are equivalent to rcutils_logging_logger_handle_is_enabled_for().
+ * Names are compared by address, calls with another name than the bound one are
+ * equivalent to rcutils_logging_logger_is_enabled_for().
+ * This is what the logging macros use with the handle of their call site.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[in,out] logger The handle to the logger, zero initialized before the first call.
+ * \param[in] name The name of the logger, must be null terminated c string or NULL, and must
+ *   remain valid and unchanged for as long as the handle is used.
+ * \param[in] severity The severity level.
+ * \return `true` if the logger is enabled for the level, or
+ * \return `false` otherwise.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+bool rcutils_logging_cached_logger_is_enabled_for(
+  rcutils_logger_t * logger, const char * name, int severity);
+
+/// The state of a throttled logging call site.
+/**
+ * Must be zero initialized and only be used through rcutils_logging_throttle_check().
+ */
+typedef struct rcutils_logging_throttle_t
+{
+  /// The coarse steady time of the last accepted call, or 0 if there was none.
+  /// It is only accessed atomically.
+  uint64_t last_logged;
+} rcutils_logging_throttle_t;
+
+/// Determine if a throttled call may log, and if so record it as the last one.
+/**
+ * A call is accepted if no call was accepted within the given duration before it,
+ * measured with rcutils_coarse_steady_time_now().
+ * Of several threads racing for the same interval, only one is accepted.
+ *
+ * Rejecting a call costs a read of the coarse clock and an atomic load, which
+ * makes this suitable for throttled logging calls in high frequency loops.
+ * The resolution of the clock limits the precision of the duration.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[in,out] throttle The state of the call site.
+ * \param[in] duration The minimum duration between accepted calls in nanoseconds.
+ * \return `true` if the call is accepted, or if the time couldn't be read, or
+ * \return `false` otherwise.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+bool rcutils_logging_throttle_check(
+  rcutils_logging_throttle_t * throttle, rcutils_duration_value_t duration);
+
 /// Log a message.
 /**
  * The attributes of this function are also being influenced by the currently
@@ -493,6 +829,10 @@ RCUTILS_ATTRIBUTE_PRINTF_FORMAT(4, 5)
  * rcutils_logging_initialize_with_allocator() for details.
  * For configuring if using colours or not, `RCUTILS_COLORIZED_OUTPUT` can be used:
  * see rcutils_logging_initialize_with_allocator() for details.
+ * Except on Windows, when the stream writes each record right away anyway, i.e. when it is
+ * unbuffered or line buffered, the record is written with a single `writev()` of the output
+ * before the message, the message and the output after it, bypassing the buffer of the
+ * stream, so that the message is never copied.
  *
  * <hr>
  * Attribute          | Adherence
@@ -0,0 +1,242 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// @file
+
+#ifndef RCUTILS__LOGGING_ASYNC_H_
+#define RCUTILS__LOGGING_ASYNC_H_
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rcutils/allocator.h"
+#include "rcutils/logging.h"
+#include "rcutils/macros.h"
+#include "rcutils/thread.h"
+#include "rcutils/time.h"
+#include "rcutils/types/rcutils_ret.h"
+#include "rcutils/visibility_control.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/// The default number of records the queue of the asynchronous output handler can hold.
+#define RCUTILS_LOGGING_ASYNC_DEFAULT_QUEUE_CAPACITY (1024u)
+
+/// The default maximum size in bytes of a record, including the trailing newline.
+#define RCUTILS_LOGGING_ASYNC_DEFAULT_MAX_RECORD_SIZE (512u)
+
+/// What the asynchronous output handler does with a record when its queue is full.
+typedef enum rcutils_logging_async_overflow_policy_t
+{
+  /// Discard the record being logged.
+  RCUTILS_LOGGING_ASYNC_OVERFLOW_DROP_NEWEST = 0,
+  /// Discard the oldest record still in the queue to make room for the one being logged.
+  RCUTILS_LOGGING_ASYNC_OVERFLOW_DROP_OLDEST = 1,
+  /// Wait until the writer thread made room for the record being logged.
+  RCUTILS_LOGGING_ASYNC_OVERFLOW_BLOCK = 2,
+} rcutils_logging_async_overflow_policy_t;
+
+/// The options of the asynchronous output handler.
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_logging_async_options_t
+{
+  /// The number of records the queue can hold, rounded up to a power of two.
+  size_t queue_capacity;
+  /// The maximum size in bytes of a record including the trailing newline.
+  /// Longer records are truncated.
+  size_t max_record_size;
+  /// What to do with a record when the queue is full.
+  rcutils_logging_async_overflow_policy_t overflow_policy;
+  /// Whether to queue the arguments of the log calls and format the records on the writer
+  /// thread, see rcutils_logging_async_output_handler().
+  bool defer_formatting;
+  /// The attributes the writer thread sets before it writes any record, or `NULL`.
+  /// They're set before rcutils_logging_async_start() returns, which fails if they can't be.
+  const rcutils_thread_attributes_t * writer_thread_attributes;
+} rcutils_logging_async_options_t;
+
+/// The counters of the asynchronous output handler.
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_logging_async_statistics_t
+{
+  /// The number of records put into the queue.
+  uint64_t enqueued;
+  /// The number of records written to the output stream by the writer thread.
+  uint64_t written;
+  /// The number of records discarded because the queue was full.
+  uint64_t dropped;
+  /// The number of records which didn't fit in max_record_size and were truncated.
+  uint64_t truncated;
+} rcutils_logging_async_statistics_t;
+
+/// Return the default options of the asynchronous output handler.
+/**
+ * The defaults are a queue of #RCUTILS_LOGGING_ASYNC_DEFAULT_QUEUE_CAPACITY records of up to
+ * #RCUTILS_LOGGING_ASYNC_DEFAULT_MAX_RECORD_SIZE bytes each, dropping the newest record when
+ * the queue is full, and formatting the records on the calling thread.
+ *
+ * \return The default options.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_logging_async_options_t
+rcutils_logging_async_get_default_options(void);
+
+/// Start the writer thread of the asynchronous output handler.
+/**
+ * Allocates the queue and starts the thread writing the queued records to the stream
+ * rcutils_logging_console_output_handler() writes to.
+ * The logging system must be initialized, as the records are formatted as configured through
+ * `RCUTILS_CONSOLE_OUTPUT_FORMAT` and `RCUTILS_COLORIZED_OUTPUT`.
+ *
+ * Starting doesn't install the output handler, use rcutils_logging_set_output_handler() with
+ * rcutils_logging_async_output_handler() to do so.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[in] options The options, or NULL to use the default ones
+ * \param[in] allocator The allocator used for the queue
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if the options or the allocator are invalid, or
+ * \return #RCUTILS_RET_NOT_INITIALIZED if the logging system is not initialized, or
+ * \return #RCUTILS_RET_BAD_ALLOC if allocating memory failed, or
+ * \return #RCUTILS_RET_ERROR if the writer thread is already running or couldn't be started,
+ *   or if its attributes couldn't be set.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_logging_async_start(
+  const rcutils_logging_async_options_t * options,
+  rcutils_allocator_t allocator);
+
+/// Write all the queued records, stop the writer thread and free the queue.
+/**
+ * Records logged through rcutils_logging_async_output_handler() after this call are written
+ * synchronously by rcutils_logging_console_output_handler().
+ * This should be called before rcutils_logging_shutdown().
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | No
+ *
+ * \return #RCUTILS_RET_OK if successful or if the writer thread wasn't running, or
+ * \return #RCUTILS_RET_ERROR if joining the writer thread failed.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_logging_async_stop(void);
+
+/// Wait until all the records queued so far have been written.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | No
+ *
+ * \return #RCUTILS_RET_OK if successful or if the writer thread isn't running.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_logging_async_flush(void);
+
+/// Get the counters of the asynchronous output handler.
+/**
+ * The counters are reset when the writer thread is started.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[out] statistics The counters
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if statistics is NULL.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_logging_async_get_statistics(rcutils_logging_async_statistics_t * statistics);
+
+/// The output handler queueing log messages for the writer thread.
+/**
+ * The record is formatted on the calling thread like rcutils_logging_console_output_handler()
+ * does, and put into the queue, so the caller never waits on the output stream.
+ * The writer thread writes the queued records in batches.
+ * When the queue is full, the overflow policy given to rcutils_logging_async_start() applies.
+ *
+ * With the `defer_formatting` option, the record is queued instead as a copy of the location,
+ * the format pointer, the timestamp, the severity, a copy of the logger name and the raw bytes
+ * of the arguments, copying the strings given for `%s`.
+ * The writer thread formats the message from these, so the function and file names of the
+ * location and the format string must stay valid until then, as they do for the logging
+ * macros which use string literals.
+ * The location struct itself may be on the stack of the caller.
+ * Records using wide characters, `%n` or positional arguments, and those which need more than
+ * `max_record_size` or 1024 bytes to be queued this way, are still formatted on the calling
+ * thread, as are all the records if the output format uses `{thread_id}` or `{thread_name}`.
+ *
+ * If the writer thread isn't running, the message is passed to
+ * rcutils_logging_console_output_handler().
+ *
+ * On Windows the records are never colorized, as the console color can't be changed
+ * asynchronously.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No, unless the formatted record needs more than 1024 bytes
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes, unless the overflow policy is to block
+ *
+ * \param[in] location The pointer to the location struct or NULL
+ * \param[in] severity The severity level
+ * \param[in] name The name of the logger, must be null terminated c string
+ * \param[in] timestamp The timestamp for when the log message was made
+ * \param[in] format The format string
+ * \param[in] args The `va_list` used by the logger
+ */
+RCUTILS_PUBLIC
+void rcutils_logging_async_output_handler(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * format, va_list * args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCUTILS__LOGGING_ASYNC_H_
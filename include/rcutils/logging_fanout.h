@@ -0,0 +1,169 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// @file
+
+#ifndef RCUTILS__LOGGING_FANOUT_H_
+#define RCUTILS__LOGGING_FANOUT_H_
+
+#include <stdarg.h>
+#include <stddef.h>
+
+#include "rcutils/logging.h"
+#include "rcutils/macros.h"
+#include "rcutils/time.h"
+#include "rcutils/types/rcutils_ret.h"
+#include "rcutils/visibility_control.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/// The maximum number of sinks the fan-out output handler delivers messages to.
+#define RCUTILS_LOGGING_FANOUT_MAX_SINKS (8u)
+
+/// The signature of a sink receiving the messages of the fan-out output handler.
+/**
+ * \param[in] location The pointer to the location struct or NULL
+ * \param[in] severity The severity level
+ * \param[in] name The name of the logger
+ * \param[in] timestamp The timestamp for when the log message was made
+ * \param[in] message The formatted message, null terminated, valid only during the call
+ * \param[in] length The length of the message, excluding the terminating null byte
+ * \param[in] context The context given when adding the sink
+ */
+typedef void (* rcutils_logging_sink_t)(
+  const rcutils_log_location_t *,  // location
+  int,  // severity
+  const char *,  // name
+  rcutils_time_point_value_t,  // timestamp
+  const char *,  // message
+  size_t,  // length
+  void *  // context
+);
+
+/// Add a sink to the fan-out output handler.
+/**
+ * The sink receives the messages of the given severity or higher.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] sink The sink
+ * \param[in] severity The minimum severity of the messages delivered to the sink
+ * \param[in] context The context passed to the sink, may be NULL
+ * \param[out] sink_id The identifier of the sink, used to change its severity or remove it
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if sink or sink_id is NULL or the severity is invalid,
+ *   or
+ * \return #RCUTILS_RET_ERROR if #RCUTILS_LOGGING_FANOUT_MAX_SINKS sinks are already added.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_logging_fanout_add_sink(
+  rcutils_logging_sink_t sink, int severity, void * context, size_t * sink_id);
+
+/// Change the minimum severity of the messages delivered to a sink.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] sink_id The identifier of the sink
+ * \param[in] severity The minimum severity of the messages delivered to the sink
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if there is no such sink or the severity is invalid.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_logging_fanout_set_sink_severity(size_t sink_id, int severity);
+
+/// Remove a sink from the fan-out output handler.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] sink_id The identifier of the sink
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if there is no such sink.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_logging_fanout_remove_sink(size_t sink_id);
+
+/// The output handler formatting log messages once and delivering them to the sinks.
+/**
+ * The message is formatted only if a sink accepts its severity, and then passed to each of
+ * them which does, in the order they were added.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No, unless the formatted message needs more than 1024 bytes
+ * Thread-Safe        | Yes, if the sinks are
+ * Uses Atomics       | No
+ * Lock-Free          | Yes, if the sinks are
+ *
+ * \param[in] location The pointer to the location struct or NULL
+ * \param[in] severity The severity level
+ * \param[in] name The name of the logger, must be null terminated c string
+ * \param[in] timestamp The timestamp for when the log message was made
+ * \param[in] format The format string
+ * \param[in] args The `va_list` used by the logger
+ */
+RCUTILS_PUBLIC
+void rcutils_logging_fanout_output_handler(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * format, va_list * args);
+
+/// The sink writing messages like rcutils_logging_console_output_handler().
+/**
+ * \param[in] location The pointer to the location struct or NULL
+ * \param[in] severity The severity level
+ * \param[in] name The name of the logger
+ * \param[in] timestamp The timestamp for when the log message was made
+ * \param[in] message The formatted message
+ * \param[in] length The length of the message
+ * \param[in] context Unused
+ */
+RCUTILS_PUBLIC
+void rcutils_logging_console_sink(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * message, size_t length, void * context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCUTILS__LOGGING_FANOUT_H_
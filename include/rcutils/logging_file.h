@@ -0,0 +1,219 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// @file
+
+#ifndef RCUTILS__LOGGING_FILE_H_
+#define RCUTILS__LOGGING_FILE_H_
+
+#include <stdarg.h>
+#include <stddef.h>
+
+#include "rcutils/allocator.h"
+#include "rcutils/logging.h"
+#include "rcutils/macros.h"
+#include "rcutils/time.h"
+#include "rcutils/types/rcutils_ret.h"
+#include "rcutils/visibility_control.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/// The default size in bytes at which the log file is rotated.
+#define RCUTILS_LOGGING_FILE_DEFAULT_MAX_FILE_SIZE (16u * 1024u * 1024u)
+
+/// The default number of rotated log files which are kept.
+#define RCUTILS_LOGGING_FILE_DEFAULT_MAX_ROTATED_FILES (4u)
+
+/// The options of the file output handler.
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_logging_file_options_t
+{
+  /// The path of the log file, must be set.
+  const char * file_path;
+  /// The size in bytes the log file is created and mapped with, and rotated at.
+  /// Records longer than this are truncated.
+  size_t max_file_size;
+  /// The number of rotated log files to keep, named `<file_path>.1` for the most recent one
+  /// up to `<file_path>.<max_rotated_files>`.
+  size_t max_rotated_files;
+} rcutils_logging_file_options_t;
+
+/// Return the default options of the file output handler.
+/**
+ * The defaults are files of #RCUTILS_LOGGING_FILE_DEFAULT_MAX_FILE_SIZE bytes, keeping
+ * #RCUTILS_LOGGING_FILE_DEFAULT_MAX_ROTATED_FILES rotated files.
+ * The file path is NULL and must be set.
+ *
+ * \return The default options.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_logging_file_options_t
+rcutils_logging_file_get_default_options(void);
+
+/// Open the log file the file output handler writes to.
+/**
+ * The file is created with a size of `max_file_size` bytes and mapped into memory, so
+ * records are appended with a copy into the mapping rather than a system call each.
+ * Once a record doesn't fit into the remaining space, the file is truncated to the size of its
+ * records, the rotated files are renamed one index up, dropping the oldest one, the file is
+ * renamed to `<file_path>.1` and a new file is started.
+ * If `max_rotated_files` is 0 the full file is replaced by the new one instead.
+ * A file already existing at `file_path` is rotated the same way when opening.
+ *
+ * The records are formatted as configured through `RCUTILS_CONSOLE_OUTPUT_FORMAT`, without
+ * colors, so the logging system must be initialized.
+ *
+ * Opening doesn't install the output handler, use rcutils_logging_set_output_handler() with
+ * rcutils_logging_file_output_handler() to do so.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[in] options The options
+ * \param[in] allocator The allocator used for the file names
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if the options or the allocator are invalid, or
+ * \return #RCUTILS_RET_NOT_INITIALIZED if the logging system is not initialized, or
+ * \return #RCUTILS_RET_BAD_ALLOC if allocating memory failed, or
+ * \return #RCUTILS_RET_ERROR if a log file is already open or the file couldn't be created
+ *   or mapped.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_logging_file_open(
+  const rcutils_logging_file_options_t * options,
+  rcutils_allocator_t allocator);
+
+/// Unmap the log file, truncate it to the size of its records and close it.
+/**
+ * Records logged through rcutils_logging_file_output_handler() after this call are written
+ * by rcutils_logging_console_output_handler().
+ * This should be called before rcutils_logging_shutdown().
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | No
+ *
+ * \return #RCUTILS_RET_OK if successful or if no log file was open, or
+ * \return #RCUTILS_RET_ERROR if the log file couldn't be truncated or closed.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_logging_file_close(void);
+
+/// Start writing the records appended to the mapped log file back to the file.
+/**
+ * Returns without waiting for the data to reach the storage.
+ * The records are visible to other processes reading the file even without this call.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | No
+ *
+ * \return #RCUTILS_RET_OK if successful or if no log file is open, or
+ * \return #RCUTILS_RET_ERROR if the mapping couldn't be flushed.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_logging_file_flush(void);
+
+/// Write the records appended to the mapped log file to the storage and wait for it.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | No
+ *
+ * \return #RCUTILS_RET_OK if successful or if no log file is open, or
+ * \return #RCUTILS_RET_ERROR if the mapping or the file couldn't be synchronized.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_logging_file_sync(void);
+
+/// The output handler appending log messages to the mapped log file.
+/**
+ * The record is formatted on the calling thread and copied into the mapping of the log file,
+ * rotating it when full.
+ *
+ * If no log file is open, the message is passed to rcutils_logging_console_output_handler().
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No, unless the formatted record needs more than 1024 bytes
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | No
+ *
+ * \param[in] location The pointer to the location struct or NULL
+ * \param[in] severity The severity level
+ * \param[in] name The name of the logger, must be null terminated c string
+ * \param[in] timestamp The timestamp for when the log message was made
+ * \param[in] format The format string
+ * \param[in] args The `va_list` used by the logger
+ */
+RCUTILS_PUBLIC
+void rcutils_logging_file_output_handler(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * format, va_list * args);
+
+/// The sink of the fan-out output handler appending messages to the mapped log file.
+/**
+ * See rcutils_logging_fanout_add_sink().
+ * The message is written like rcutils_logging_file_output_handler() does.
+ *
+ * \param[in] location The pointer to the location struct or NULL
+ * \param[in] severity The severity level
+ * \param[in] name The name of the logger
+ * \param[in] timestamp The timestamp for when the log message was made
+ * \param[in] message The formatted message
+ * \param[in] length The length of the message
+ * \param[in] context Unused
+ */
+RCUTILS_PUBLIC
+void rcutils_logging_file_sink(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * message, size_t length, void * context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCUTILS__LOGGING_FILE_H_
@@ -0,0 +1,238 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// @file
+
+#ifndef RCUTILS__LOGGING_FLIGHT_RECORDER_H_
+#define RCUTILS__LOGGING_FLIGHT_RECORDER_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rcutils/allocator.h"
+#include "rcutils/macros.h"
+#include "rcutils/types/rcutils_ret.h"
+#include "rcutils/visibility_control.h"
+
+/// The bytes the file of a flight recorder begins with, including the terminating null byte.
+#define RCUTILS_LOGGING_FLIGHT_RECORDER_MAGIC "rcutflr"
+
+/// The version of the layout of the file of a flight recorder.
+#define RCUTILS_LOGGING_FLIGHT_RECORDER_VERSION 1u
+
+/// The size of the logger names of the records, including the terminating null byte.
+#define RCUTILS_LOGGING_FLIGHT_RECORDER_NAME_SIZE 48u
+
+/// The size of the messages of the records, including the terminating null byte.
+#define RCUTILS_LOGGING_FLIGHT_RECORDER_MESSAGE_SIZE 176u
+
+/// The beginning of the file of a flight recorder.
+/**
+ * The file is a header followed by `capacity` records, of 256 bytes each, in the byte order
+ * of the process.
+ * Record `i`, counting from 0 since the recorder was created, is in slot `i % capacity`, so
+ * the last `capacity` records are kept, from `next - capacity`, or 0, to `next - 1`.
+ */
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_logging_flight_recorder_header_t
+{
+  /// #RCUTILS_LOGGING_FLIGHT_RECORDER_MAGIC.
+  char magic[8];
+  /// #RCUTILS_LOGGING_FLIGHT_RECORDER_VERSION.
+  uint32_t version;
+  /// The size in bytes of a record.
+  uint32_t record_size;
+  /// The number of records the file has room for.
+  uint32_t capacity;
+  /// Zero, for future versions.
+  uint32_t reserved0;
+  /// The number of records written since the recorder was created, accessed atomically.
+  uint64_t next;
+  /// The ID of the process recording, as returned by rcutils_get_pid().
+  uint64_t pid;
+  /// Zeros, for future versions.
+  uint64_t reserved[3];
+} rcutils_logging_flight_recorder_header_t;
+
+/// A record of a flight recorder.
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_logging_flight_recorder_record_t
+{
+  /// The index of the record plus 1 once it's written, 0 if it never was, or `UINT64_MAX`
+  /// while it's being written, accessed atomically.
+  uint64_t sequence;
+  /// The time the message was logged at, in nanoseconds since the epoch.
+  int64_t timestamp;
+  /// The ID of the thread which logged the message, as returned by rcutils_thread_get_id().
+  uint64_t thread_id;
+  /// The severity of the message.
+  int32_t severity;
+  /// The length of the message, which is truncated if it doesn't fit.
+  uint32_t message_length;
+  /// The name of the logger, truncated if it doesn't fit, null terminated.
+  char name[RCUTILS_LOGGING_FLIGHT_RECORDER_NAME_SIZE];
+  /// The formatted message, null terminated.
+  char message[RCUTILS_LOGGING_FLIGHT_RECORDER_MESSAGE_SIZE];
+} rcutils_logging_flight_recorder_record_t;
+
+/// A ring of the last log records, in a memory-mapped file which outlives a crash.
+/**
+ * While a flight recorder is started, every message logged with rcutils_log() at or above its
+ * severity is written into the ring, whatever the level of its logger, so that e.g. the debug
+ * messages of the last seconds before a crash can be dumped from the file afterwards, with
+ * rcutils_logging_flight_recorder_read(), without being written to the console all along.
+ * Messages below the level of their logger only go to the flight recorder, skipping the
+ * output handler entirely.
+ *
+ * Writing a record formats the message into the ring and costs a few atomic operations, with
+ * no lock, no allocation and no system call.
+ */
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_logging_flight_recorder_t
+{
+  /// A pointer to the PIMPL implementation type.
+  struct rcutils_logging_flight_recorder_impl_t * impl;
+} rcutils_logging_flight_recorder_t;
+
+/// The signature of the function receiving the records read from a flight recorder file.
+/**
+ * \param[in] record The record, valid only during the call
+ * \param[in] context The context given to rcutils_logging_flight_recorder_read()
+ */
+typedef void (* rcutils_logging_flight_recorder_reader_t)(
+  const rcutils_logging_flight_recorder_record_t *,  // record
+  void *  // context
+);
+
+/// Return a zero initialized flight recorder struct.
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_logging_flight_recorder_t
+rcutils_get_zero_initialized_logging_flight_recorder(void);
+
+/// Create the file of a flight recorder and map it into memory.
+/**
+ * The file is created, or truncated if it exists, and has room for `capacity` records.
+ * On Linux, it is typically in `/dev/shm`, so that it lives in memory, is never written to a
+ * disk and survives the process until it's removed, e.g. `/dev/shm/my_node.flight`.
+ * The file is removed by rcutils_logging_flight_recorder_fini(), so it's only left behind if
+ * the process exits without finalizing the recorder, e.g. when it crashes.
+ * Nothing is recorded until rcutils_logging_flight_recorder_start() is called.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] recorder the zero initialized flight recorder
+ * \param[in] path the path of the file
+ * \param[in] capacity the number of records kept, more than 0
+ * \param[in] allocator the allocator of the implementation
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails, or
+ * \return #RCUTILS_RET_ERROR if the file cannot be created or mapped.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_logging_flight_recorder_init(
+  rcutils_logging_flight_recorder_t * recorder,
+  const char * path,
+  size_t capacity,
+  const rcutils_allocator_t * allocator);
+
+/// Stop a flight recorder if it's started, then unmap and remove its file.
+/**
+ * No thread may be logging while the recorder is finalized.
+ * Finalizing a zero initialized flight recorder does nothing.
+ *
+ * \param[inout] recorder the flight recorder, zero initialized again
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_ERROR if the file cannot be unmapped or removed.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_logging_flight_recorder_fini(rcutils_logging_flight_recorder_t * recorder);
+
+/// Record the messages logged at or above a severity in a flight recorder.
+/**
+ * The messages are recorded in at most one flight recorder at a time, the last one started.
+ * The lowest severity enabled by the logging macros is lowered to the severity of the
+ * recorder, see #g_rcutils_logging_lowest_enabled_severity, and
+ * rcutils_logging_logger_is_enabled_for() returns `true` for the messages it records.
+ *
+ * \param[inout] recorder the initialized flight recorder
+ * \param[in] severity the lowest severity of the messages recorded, e.g.
+ *   #RCUTILS_LOG_SEVERITY_DEBUG
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_logging_flight_recorder_start(
+  rcutils_logging_flight_recorder_t * recorder, int severity);
+
+/// Stop recording messages in a flight recorder, doing nothing if it isn't started.
+/**
+ * \param[inout] recorder the initialized flight recorder
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_logging_flight_recorder_stop(rcutils_logging_flight_recorder_t * recorder);
+
+/// Read the records of a flight recorder file, from the oldest to the newest.
+/**
+ * The file may be left behind by a crashed process, or be recorded into by a live one, in
+ * which case the records overwritten or being written while they're read are skipped.
+ * Records which were being written when the process crashed are skipped as well.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[in] path the path of the file
+ * \param[in] reader the function called with each record
+ * \param[in] context the context passed to the reader, may be NULL
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_ERROR if the file cannot be mapped or isn't a flight recorder file of
+ *   this version.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_logging_flight_recorder_read(
+  const char * path, rcutils_logging_flight_recorder_reader_t reader, void * context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCUTILS__LOGGING_FLIGHT_RECORDER_H_
@@ -0,0 +1,226 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// @file
+
+#ifndef RCUTILS__LOGGING_NETWORK_H_
+#define RCUTILS__LOGGING_NETWORK_H_
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rcutils/allocator.h"
+#include "rcutils/logging.h"
+#include "rcutils/macros.h"
+#include "rcutils/time.h"
+#include "rcutils/types/rcutils_ret.h"
+#include "rcutils/visibility_control.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/// The default number of records the queue of the network output handler can hold.
+#define RCUTILS_LOGGING_NETWORK_DEFAULT_QUEUE_CAPACITY (1024u)
+
+/// The default maximum size in bytes of a record, i.e. of a datagram.
+#define RCUTILS_LOGGING_NETWORK_DEFAULT_MAX_RECORD_SIZE (512u)
+
+/// The default maximum number of datagrams sent at once.
+#define RCUTILS_LOGGING_NETWORK_DEFAULT_BATCH_SIZE (64u)
+
+/// The default time in milliseconds a record waits for a batch to fill up before it's sent.
+#define RCUTILS_LOGGING_NETWORK_DEFAULT_MAX_LATENCY_MS (10u)
+
+/// The largest batch size, the number of datagrams the kernel accepts in one call.
+#define RCUTILS_LOGGING_NETWORK_MAX_BATCH_SIZE (1024u)
+
+/// The largest record size, the payload of a UDP datagram over IPv4.
+#define RCUTILS_LOGGING_NETWORK_MAX_RECORD_SIZE (65507u)
+
+/// The options of the network output handler.
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_logging_network_options_t
+{
+  /// The host name or numeric IPv4 or IPv6 address of the collector receiving the records.
+  const char * host;
+  /// The UDP port of the collector.
+  uint16_t port;
+  /// The number of records the queue can hold, rounded up to a power of two.
+  size_t queue_capacity;
+  /// The maximum size in bytes of a record, up to #RCUTILS_LOGGING_NETWORK_MAX_RECORD_SIZE.
+  /// Longer records are truncated.
+  size_t max_record_size;
+  /// The maximum number of records sent at once, up to #RCUTILS_LOGGING_NETWORK_MAX_BATCH_SIZE.
+  size_t batch_size;
+  /// The time in milliseconds after which the queued records are sent even though they don't
+  /// fill a batch.
+  uint32_t max_latency_ms;
+} rcutils_logging_network_options_t;
+
+/// The counters of the network output handler.
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_logging_network_statistics_t
+{
+  /// The number of records put into the queue.
+  uint64_t enqueued;
+  /// The number of records sent.
+  uint64_t sent;
+  /// The number of records discarded because the queue was full.
+  uint64_t dropped;
+  /// The number of records which didn't fit in max_record_size and were truncated.
+  uint64_t truncated;
+  /// The number of records the socket failed to send.
+  uint64_t failed;
+  /// The number of batches sent.
+  uint64_t batches;
+} rcutils_logging_network_statistics_t;
+
+/// Return the default options of the network output handler.
+/**
+ * The defaults are a queue of #RCUTILS_LOGGING_NETWORK_DEFAULT_QUEUE_CAPACITY records of up to
+ * #RCUTILS_LOGGING_NETWORK_DEFAULT_MAX_RECORD_SIZE bytes each, sent in batches of up to
+ * #RCUTILS_LOGGING_NETWORK_DEFAULT_BATCH_SIZE records at least every
+ * #RCUTILS_LOGGING_NETWORK_DEFAULT_MAX_LATENCY_MS milliseconds.
+ * The host is `NULL` and the port 0, they must be set.
+ * \return The default options.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_logging_network_options_t
+rcutils_logging_network_get_default_options(void);
+
+/// Start the sender thread of the network output handler.
+/**
+ * Resolves the host, connects a UDP socket to the collector, allocates the queue and starts
+ * the thread sending the queued records.
+ * The logging system must be initialized, as the records are formatted as configured through
+ * `RCUTILS_CONSOLE_OUTPUT_FORMAT`.
+ * Starting doesn't install the output handler, use rcutils_logging_set_output_handler() with
+ * rcutils_logging_network_output_handler() to do so.
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ * \param[in] options The options
+ * \param[in] allocator The allocator used for the queue
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if the options or the allocator are invalid, or
+ * \return #RCUTILS_RET_NOT_INITIALIZED if the logging system is not initialized, or
+ * \return #RCUTILS_RET_BAD_ALLOC if allocating memory failed, or
+ * \return #RCUTILS_RET_ERROR if the sender thread is already running or couldn't be started,
+ *   or if the host couldn't be resolved or connected to.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_logging_network_start(
+  const rcutils_logging_network_options_t * options,
+  rcutils_allocator_t allocator);
+
+/// Send all the queued records, stop the sender thread, close the socket and free the queue.
+/**
+ * Records logged through rcutils_logging_network_output_handler() after this call are written
+ * by rcutils_logging_console_output_handler() instead.
+ * This should be called before rcutils_logging_shutdown().
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | No
+ * \return #RCUTILS_RET_OK if successful or if the sender thread wasn't running, or
+ * \return #RCUTILS_RET_ERROR if joining the sender thread failed.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_logging_network_stop(void);
+
+/// Wait until all the records queued so far have been sent, without waiting for the latency.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | No
+ * \return #RCUTILS_RET_OK if successful or if the sender thread isn't running.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_logging_network_flush(void);
+
+/// Get the counters of the network output handler.
+/**
+ * The counters are reset when the sender thread is started.
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ * \param[out] statistics The counters
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if statistics is NULL.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_logging_network_get_statistics(rcutils_logging_network_statistics_t * statistics);
+
+/// The output handler sending log messages as UDP datagrams to a collector.
+/**
+ * The record is formatted on the calling thread like rcutils_logging_console_output_handler()
+ * does, but never colorized and without the trailing newline, and put into the queue, so the
+ * caller never waits on the network.
+ * The sender thread sends a datagram per record, in batches of up to `batch_size` records at
+ * once, with a single `sendmmsg()` system call on Linux and a `send()` call per datagram on
+ * other platforms.
+ * It waits up to `max_latency_ms` for a batch to fill up.
+ * When the queue is full, the record is dropped.
+ * If the sender thread isn't running, the message is passed to
+ * rcutils_logging_console_output_handler().
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No, unless the formatted record or max_record_size exceed 1024 bytes
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ * \param[in] location The pointer to the location struct or NULL
+ * \param[in] severity The severity level
+ * \param[in] name The name of the logger, must be null terminated c string
+ * \param[in] timestamp The timestamp for when the log message was made
+ * \param[in] format The format string
+ * \param[in] args The `va_list` used by the logger
+ */
+RCUTILS_PUBLIC
+void rcutils_logging_network_output_handler(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * format, va_list * args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCUTILS__LOGGING_NETWORK_H_
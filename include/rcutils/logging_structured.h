@@ -0,0 +1,269 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// @file
+
+#ifndef RCUTILS__LOGGING_STRUCTURED_H_
+#define RCUTILS__LOGGING_STRUCTURED_H_
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rcutils/logging.h"
+#include "rcutils/macros.h"
+#include "rcutils/time.h"
+#include "rcutils/types/char_array.h"
+#include "rcutils/types/rcutils_ret.h"
+#include "rcutils/visibility_control.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/// The type of the value of a structured log field.
+typedef enum rcutils_log_field_type_t
+{
+  /// A signed integer, see rcutils_log_field_t::int64_value.
+  RCUTILS_LOG_FIELD_TYPE_INT64 = 0,
+  /// A floating point number, see rcutils_log_field_t::double_value.
+  RCUTILS_LOG_FIELD_TYPE_DOUBLE = 1,
+  /// A string which doesn't need to be null terminated, see rcutils_log_field_t::string_value.
+  RCUTILS_LOG_FIELD_TYPE_STRING = 2,
+} rcutils_log_field_type_t;
+
+/// A key and a typed value logged along with a message by rcutils_log_kv().
+/**
+ * Neither the key nor a string value are copied, they only need to remain valid during the
+ * call to rcutils_log_kv().
+ */
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_log_field_t
+{
+  /// The key of the field, must be a null terminated c string.
+  const char * key;
+  /// The type of the value.
+  rcutils_log_field_type_t type;
+  /// The value, the member matching the type is set.
+  union
+  {
+    /// The value of a #RCUTILS_LOG_FIELD_TYPE_INT64 field.
+    int64_t int64_value;
+    /// The value of a #RCUTILS_LOG_FIELD_TYPE_DOUBLE field.
+    double double_value;
+    /// The value of a #RCUTILS_LOG_FIELD_TYPE_STRING field.
+    struct
+    {
+      /// The characters of the string.
+      const char * data;
+      /// The number of characters of the string.
+      size_t length;
+    } string_value;
+  } value;
+} rcutils_log_field_t;
+
+/// Return a field with a signed integer value.
+static inline rcutils_log_field_t
+rcutils_log_field_int64(const char * key, int64_t value)
+{
+  rcutils_log_field_t field;
+  field.key = key;
+  field.type = RCUTILS_LOG_FIELD_TYPE_INT64;
+  field.value.int64_value = value;
+  return field;
+}
+
+/// Return a field with a floating point value.
+static inline rcutils_log_field_t
+rcutils_log_field_double(const char * key, double value)
+{
+  rcutils_log_field_t field;
+  field.key = key;
+  field.type = RCUTILS_LOG_FIELD_TYPE_DOUBLE;
+  field.value.double_value = value;
+  return field;
+}
+
+/// Return a field with a string value of the given length, referring to the characters.
+static inline rcutils_log_field_t
+rcutils_log_field_string(const char * key, const char * data, size_t length)
+{
+  rcutils_log_field_t field;
+  field.key = key;
+  field.type = RCUTILS_LOG_FIELD_TYPE_STRING;
+  field.value.string_value.data = data;
+  field.value.string_value.length = length;
+  return field;
+}
+
+/// The function signature to receive the messages of rcutils_log_kv() with their fields.
+/**
+ * \param[in] location The pointer to the location struct or NULL
+ * \param[in] severity The severity level
+ * \param[in] name The name of the logger
+ * \param[in] timestamp The timestamp for when the log message was made
+ * \param[in] fields The fields of the message, valid only during the call
+ * \param[in] fields_count The number of fields
+ * \param[in] format The format string of the message
+ * \param[in] args The `va_list` of the message
+ */
+typedef void (* rcutils_logging_structured_output_handler_t)(
+  const rcutils_log_location_t *,  // location
+  int,  // severity
+  const char *,  // name
+  rcutils_time_point_value_t,  // timestamp
+  const rcutils_log_field_t *,  // fields
+  size_t,  // fields_count
+  const char *,  // format
+  va_list *  // args
+);
+
+/// Get the current structured output handler.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \return The function pointer of the current structured output handler, or NULL if
+ *   rcutils_log_kv() renders the fields for the output handler.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_logging_structured_output_handler_t rcutils_logging_get_structured_output_handler(void);
+
+/// Set the structured output handler, which receives the messages of rcutils_log_kv().
+/**
+ * There is no structured output handler by default.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] function The function pointer of the structured output handler to be used, or
+ *   NULL to let rcutils_log_kv() render the fields for the output handler.
+ */
+RCUTILS_PUBLIC
+void rcutils_logging_set_structured_output_handler(
+  rcutils_logging_structured_output_handler_t function);
+
+/// Log a message with structured fields.
+/**
+ * The message is filtered and rate limited like the ones of rcutils_log().
+ *
+ * If a structured output handler is set, it receives the fields and the format string
+ * unrendered.
+ * Otherwise the message is formatted, followed by a space and the fields rendered by
+ * rcutils_logging_format_fields(), and passed to the output handler.
+ * Either way nothing is formatted if the logger isn't enabled for the severity.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No, for rendered outputs <= 1023 characters
+ *                    | Yes, for rendered outputs >= 1024 characters
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] location The pointer to the location struct or NULL
+ * \param[in] severity The severity level
+ * \param[in] name The name of the logger, must be null terminated c string or NULL
+ * \param[in] fields The fields, may be NULL if fields_count is 0
+ * \param[in] fields_count The number of fields
+ * \param[in] format The format string
+ * \param[in] ... The variable arguments
+ */
+RCUTILS_PUBLIC
+void rcutils_log_kv(
+  const rcutils_log_location_t * location,
+  int severity,
+  const char * name,
+  const rcutils_log_field_t * fields,
+  size_t fields_count,
+  const char * format,
+  ...)
+/// @cond Doxygen_Suppress
+RCUTILS_ATTRIBUTE_PRINTF_FORMAT(6, 7)
+/// @endcond
+;
+
+/// Render fields as space separated `key=value` pairs.
+/**
+ * Integers are rendered in decimal, floating point numbers with `%g` and strings in double
+ * quotes, escaping double quotes, backslashes and control characters as in JSON.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes, if the output array needs to grow
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] fields The fields, may be NULL if fields_count is 0
+ * \param[in] fields_count The number of fields
+ * \param[in,out] output_array The initialized array the fields are appended to
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if an argument is invalid, or
+ * \return #RCUTILS_RET_BAD_ALLOC if allocating memory failed.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t rcutils_logging_format_fields(
+  const rcutils_log_field_t * fields, size_t fields_count,
+  rcutils_char_array_t * output_array);
+
+/// The structured output handler writing each message as a line of JSON.
+/**
+ * The object has the members `time` (in seconds), `severity`, `name`, `message` and
+ * `fields`, an object of the fields of the message, and is written to the stream of
+ * rcutils_logging_console_output_handler().
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No, unless the line needs more than 1024 bytes
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] location The pointer to the location struct or NULL
+ * \param[in] severity The severity level
+ * \param[in] name The name of the logger, must be null terminated c string
+ * \param[in] timestamp The timestamp for when the log message was made
+ * \param[in] fields The fields of the message
+ * \param[in] fields_count The number of fields
+ * \param[in] format The format string
+ * \param[in] args The `va_list` used by the logger
+ */
+RCUTILS_PUBLIC
+void rcutils_logging_json_output_handler(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const rcutils_log_field_t * fields, size_t fields_count,
+  const char * format, va_list * args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCUTILS__LOGGING_STRUCTURED_H_
@@ -0,0 +1,164 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// @file
+
+#ifndef RCUTILS__MAPPED_FILE_H_
+#define RCUTILS__MAPPED_FILE_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rcutils/macros.h"
+#include "rcutils/types/rcutils_ret.h"
+#include "rcutils/visibility_control.h"
+
+/// A file mapped read-only into memory.
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_mapped_file_t
+{
+  /// The contents of the file, or `NULL` if the file is empty or not open.
+  const uint8_t * data;
+  /// The size in bytes of the contents of the file.
+  size_t size;
+} rcutils_mapped_file_t;
+
+/// The ways the contents of a mapped file are going to be accessed.
+typedef enum rcutils_mapped_file_advice_t
+{
+  /// No particular access pattern, the default of the operating system.
+  RCUTILS_MAPPED_FILE_ADVICE_NORMAL = 0,
+  /// In order, so that more is read ahead and the pages read may be dropped early.
+  RCUTILS_MAPPED_FILE_ADVICE_SEQUENTIAL = 1,
+  /// In no particular order, so that nothing is read ahead.
+  RCUTILS_MAPPED_FILE_ADVICE_RANDOM = 2,
+  /// Soon, so that it is read in the background right away.
+  RCUTILS_MAPPED_FILE_ADVICE_WILLNEED = 3,
+} rcutils_mapped_file_advice_t;
+
+/// Return a zero initialized mapped file.
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_mapped_file_t
+rcutils_get_zero_initialized_mapped_file(void);
+
+/// Map a file read-only into memory.
+/**
+ * The whole file is mapped with mmap(), or with CreateFileMapping() and MapViewOfFile() on
+ * Windows, so its contents are accessed through `data` without being copied, and are read
+ * from the disk as they are first accessed.
+ * No file descriptor or handle is kept open, the mapping alone keeps the file alive until
+ * rcutils_mapped_file_close().
+ * If the file is modified while it is mapped, the changes may or may not be visible, and
+ * accessing the contents beyond the end of a truncated file may crash on POSIX systems.
+ *
+ * An empty file is open with a `NULL` `data` and no mapping, because empty mappings are
+ * invalid on every platform.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] file a zero initialized mapped file
+ * \param[in] path the path of the file to map
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_ERROR if the file cannot be open or mapped.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_mapped_file_open(rcutils_mapped_file_t * file, const char * path);
+
+/// Return the size in bytes of a mapped file.
+/**
+ * \param[in] file the mapped file
+ * \return the size in bytes of the contents of the file, or
+ * \return `0` if the file is `NULL`, empty or not open.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+size_t
+rcutils_mapped_file_get_size(const rcutils_mapped_file_t * file);
+
+/// Hint at how a range of the contents of a mapped file is going to be accessed.
+/**
+ * The hint is given with madvise() on POSIX systems.
+ * On Windows, only #RCUTILS_MAPPED_FILE_ADVICE_WILLNEED has an effect, with
+ * PrefetchVirtualMemory() where available, the other hints are accepted and ignored.
+ * The hints only change the performance of the accesses, never their results.
+ *
+ * The range is clamped to the contents of the file, and a `length` of `0` extends it to
+ * the end of the file.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] file the mapped file
+ * \param[in] offset the offset in bytes of the start of the range
+ * \param[in] length the length in bytes of the range, or `0` for the rest of the file
+ * \param[in] advice how the range is going to be accessed
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_ERROR if the operating system rejects the hint.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_mapped_file_advise(
+  const rcutils_mapped_file_t * file,
+  size_t offset,
+  size_t length,
+  rcutils_mapped_file_advice_t advice);
+
+/// Unmap a mapped file.
+/**
+ * The file is zero initialized again, and closing a zero initialized file does nothing.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] file the mapped file
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_ERROR if the file cannot be unmapped.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_mapped_file_close(rcutils_mapped_file_t * file);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCUTILS__MAPPED_FILE_H_
@@ -0,0 +1,165 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// @file
+
+#ifndef RCUTILS__NUMA_ALLOCATOR_H_
+#define RCUTILS__NUMA_ALLOCATOR_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "rcutils/allocator.h"
+#include "rcutils/macros.h"
+#include "rcutils/types/rcutils_ret.h"
+#include "rcutils/visibility_control.h"
+
+/// The node standing for the NUMA node of the thread allocating.
+#define RCUTILS_NUMA_NODE_LOCAL (-1)
+
+/// The number of NUMA nodes a NUMA allocator can allocate on.
+#define RCUTILS_NUMA_ALLOCATOR_MAX_NODE_COUNT 64
+
+/// The number of bytes before each allocation of a NUMA allocator, also its default alignment.
+#define RCUTILS_NUMA_ALLOCATOR_HEADER_SIZE 64u
+
+/// Information about the memory of an allocation of a NUMA allocator.
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_numa_allocator_memory_info_t
+{
+  /// The size in bytes of the memory mapped for the allocation, its header included.
+  size_t mapping_size;
+  /// The node the memory was allocated on, or #RCUTILS_NUMA_NODE_LOCAL if it's unknown.
+  int node;
+  /// Whether the memory is bound to the node, rather than allocated wherever it's touched.
+  bool bound;
+} rcutils_numa_allocator_memory_info_t;
+
+/// Get the number of NUMA nodes of the system.
+/**
+ * The count is 1 on the systems without NUMA support, and the largest node number plus one
+ * otherwise, even if some nodes below it are offline.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[out] count the number of nodes
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_numa_get_node_count(size_t * count);
+
+/// Get the NUMA node of the processor the calling thread runs on.
+/**
+ * Unless the thread is pinned to the processors of a node, the node may have changed by the
+ * time this returns.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[out] node the node, 0 on the systems without NUMA support
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_numa_get_current_node(int * node);
+
+/// Return an allocator mapping each allocation on a NUMA node.
+/**
+ * Like with the allocator of rcutils_get_page_allocator(), each allocation is mapped
+ * directly from the operating system and unmapped when it is deallocated, so the allocator is
+ * meant for large and long-lived buffers, or as the allocator of the slabs of a pool
+ * allocator, see rcutils_pool_allocator_init(), for the small allocations.
+ *
+ * On Linux, the mapping is bound to the node with mbind() and the preferred policy, so that
+ * its pages are allocated on the node whichever thread touches them first, and on another
+ * node if it runs out of memory.
+ * On Windows, the memory is allocated with VirtualAllocExNuma().
+ * Where NUMA isn't supported, or if the node doesn't exist, the memory is left to the
+ * default policy of the system, allocating the pages on the node of the thread touching them
+ * first.
+ * Use rcutils_numa_allocator_get_memory_info() to find out whether an allocation fell back.
+ *
+ * With #RCUTILS_NUMA_NODE_LOCAL, each allocation is bound to the node of the thread
+ * allocating it, see rcutils_numa_get_current_node(), so that the buffers of an executor
+ * whose threads are pinned to a node are local to them.
+ *
+ * The memory is zero initialized, and aligned to #RCUTILS_NUMA_ALLOCATOR_HEADER_SIZE bytes,
+ * or up to the page size with rcutils_allocator_aligned_allocate().
+ * The allocator has no state to finalize and is thread-safe.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] node the node to allocate on, or #RCUTILS_NUMA_NODE_LOCAL
+ * \return the NUMA allocator, or
+ * \return a zero initialized allocator if the node is negative, but not
+ *   #RCUTILS_NUMA_NODE_LOCAL, or at least #RCUTILS_NUMA_ALLOCATOR_MAX_NODE_COUNT.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_allocator_t
+rcutils_get_numa_allocator(int node);
+
+/// Get information about the memory of an allocation of a NUMA allocator.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] pointer the memory allocated with a NUMA allocator
+ * \param[out] info the information about the memory
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_numa_allocator_get_memory_info(
+  const void * pointer,
+  rcutils_numa_allocator_memory_info_t * info);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCUTILS__NUMA_ALLOCATOR_H_
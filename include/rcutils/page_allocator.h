@@ -0,0 +1,134 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// @file
+
+#ifndef RCUTILS__PAGE_ALLOCATOR_H_
+#define RCUTILS__PAGE_ALLOCATOR_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "rcutils/allocator.h"
+#include "rcutils/macros.h"
+#include "rcutils/types/rcutils_ret.h"
+#include "rcutils/visibility_control.h"
+
+/// The size of the huge pages a page allocator maps allocations at least as large with.
+#define RCUTILS_PAGE_ALLOCATOR_HUGE_PAGE_SIZE (2u * 1024u * 1024u)
+
+/// The number of bytes before each allocation of a page allocator, also its default alignment.
+#define RCUTILS_PAGE_ALLOCATOR_HEADER_SIZE 64u
+
+/// The options of a page allocator.
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_page_allocator_options_t
+{
+  /// Whether to back the allocations of at least #RCUTILS_PAGE_ALLOCATOR_HUGE_PAGE_SIZE bytes
+  /// with huge pages.
+  bool huge_pages;
+  /// Whether to lock the allocations into memory, so that they never page fault.
+  bool lock_memory;
+} rcutils_page_allocator_options_t;
+
+/// Information about the memory of an allocation of a page allocator.
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_page_allocator_memory_info_t
+{
+  /// The size in bytes of the memory mapped for the allocation, its header included.
+  size_t mapping_size;
+  /// Whether the memory was mapped with explicit huge pages, rather than only hinted at them.
+  bool huge_pages;
+  /// Whether the memory is locked.
+  bool locked;
+} rcutils_page_allocator_memory_info_t;
+
+/// Return the default options of a page allocator.
+/**
+ * The defaults are huge pages, without locking the memory.
+ *
+ * \return The default options.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_page_allocator_options_t
+rcutils_page_allocator_get_default_options(void);
+
+/// Return an allocator mapping each allocation directly from the operating system.
+/**
+ * Each allocation is mapped with mmap(), or VirtualAlloc() on Windows, and unmapped when it
+ * is deallocated, so the allocator is meant for large and long-lived buffers, like the ones
+ * preallocated by latency-sensitive applications, rather than for small allocations.
+ *
+ * With `huge_pages`, the allocations of at least #RCUTILS_PAGE_ALLOCATOR_HUGE_PAGE_SIZE
+ * bytes are mapped with explicit huge pages, `MAP_HUGETLB` or `MEM_LARGE_PAGES`, to reduce
+ * the TLB misses.
+ * If none are available, they are mapped with regular pages, hinted with
+ * `MADV_HUGEPAGE` to be backed by transparent huge pages where supported.
+ * With `lock_memory`, the allocations are locked with mlock(), or VirtualLock() on Windows,
+ * so that they are resident and never page fault.
+ * If the limit of locked memory is reached, they are left unlocked.
+ * Use rcutils_page_allocator_get_memory_info() to find out whether an allocation fell back.
+ *
+ * The memory is zero initialized, and aligned to #RCUTILS_PAGE_ALLOCATOR_HEADER_SIZE bytes,
+ * or up to the page size with rcutils_allocator_aligned_allocate().
+ * The allocator has no state to finalize and is thread-safe.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] options the options of the allocator
+ * \return the page allocator, or
+ * \return a zero initialized allocator if the options are NULL.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_allocator_t
+rcutils_get_page_allocator(const rcutils_page_allocator_options_t * options);
+
+/// Get information about the memory of an allocation of a page allocator.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] pointer the memory allocated with a page allocator
+ * \param[out] info the information about the memory
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_page_allocator_get_memory_info(
+  const void * pointer,
+  rcutils_page_allocator_memory_info_t * info);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCUTILS__PAGE_ALLOCATOR_H_
@@ -0,0 +1,166 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// @file
+
+#ifndef RCUTILS__POOL_ALLOCATOR_H_
+#define RCUTILS__POOL_ALLOCATOR_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+
+#include "rcutils/allocator.h"
+#include "rcutils/macros.h"
+#include "rcutils/types/rcutils_ret.h"
+#include "rcutils/visibility_control.h"
+
+/// The alignment of the memory allocated by a pool allocator.
+#define RCUTILS_POOL_ALLOCATOR_ALIGNMENT ((size_t)16)
+
+/// The size of the largest block of a pool allocator, larger allocations aren't pooled.
+#define RCUTILS_POOL_ALLOCATOR_MAX_BLOCK_SIZE ((size_t)1024)
+
+/// The size of the slabs of a pool allocator when none is given.
+#define RCUTILS_POOL_ALLOCATOR_DEFAULT_SLAB_SIZE ((size_t)16384)
+
+struct rcutils_pool_allocator_impl_s;
+
+/// An allocator of fixed size blocks, pooled by size class.
+/**
+ * Allocations are rounded up to a size class, up to #RCUTILS_POOL_ALLOCATOR_MAX_BLOCK_SIZE
+ * bytes, and each size class has a free list of blocks carved out of slabs allocated with
+ * another allocator.
+ * Allocating and deallocating a block only pops or pushes it on the free list of its class,
+ * so containers allocating many nodes of the same size, like the entries of a
+ * rcutils_hash_map_t, don't fragment the memory and keep their nodes close to each other.
+ * Larger allocations are forwarded to the other allocator.
+ *
+ * The slabs are only deallocated when the pool is finalized, and all the blocks with them.
+ */
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_pool_allocator_t
+{
+  /// A pointer to the PIMPL implementation type.
+  struct rcutils_pool_allocator_impl_s * impl;
+} rcutils_pool_allocator_t;
+
+/// Return an empty pool allocator struct.
+/**
+ * This function returns an empty and zero initialized pool allocator struct.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \return an empty and zero initialized pool allocator struct
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_pool_allocator_t
+rcutils_get_zero_initialized_pool_allocator(void);
+
+/// Initialize a pool allocator.
+/**
+ * No slab is allocated until memory is allocated from the pool.
+ * A slab always holds at least one block, whatever the slab size.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * Example:
+ *
+ * ```c
+ * rcutils_allocator_t default_allocator = rcutils_get_default_allocator();
+ * rcutils_pool_allocator_t pool = rcutils_get_zero_initialized_pool_allocator();
+ * rcutils_ret_t ret = rcutils_pool_allocator_init(&pool, 0, &default_allocator);
+ * rcutils_allocator_t allocator = rcutils_pool_allocator_get_allocator(&pool);
+ * rcutils_hash_map_t map = rcutils_get_zero_initialized_hash_map();
+ * ret = rcutils_hash_map_init(
+ *   &map, 64, sizeof(uint32_t), sizeof(uint32_t), rcutils_hash_map_uint32_hash_func,
+ *   rcutils_hash_map_uint32_cmp_func, &allocator);
+ * // ... use the map, then
+ * ret = rcutils_hash_map_fini(&map);
+ * ret = rcutils_pool_allocator_fini(&pool);
+ * ```
+ *
+ * \param[inout] pool the zero initialized pool allocator to initialize
+ * \param[in] slab_size the size of the slabs, or 0 for the default size
+ * \param[in] allocator to be used to allocate and deallocate the slabs and the large
+ *   allocations
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_pool_allocator_init(
+  rcutils_pool_allocator_t * pool,
+  size_t slab_size,
+  const rcutils_allocator_t * allocator);
+
+/// Finalize a pool allocator, deallocating its slabs.
+/**
+ * The blocks allocated from the pool are deallocated with the slabs, but the allocations
+ * larger than #RCUTILS_POOL_ALLOCATOR_MAX_BLOCK_SIZE must be deallocated before.
+ * Calling this on a zero initialized pool does nothing.
+ *
+ * \param[inout] pool the pool allocator to finalize
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_pool_allocator_fini(rcutils_pool_allocator_t * pool);
+
+/// Return an allocator allocating from a pool allocator.
+/**
+ * The allocator is valid until the pool is finalized, and isn't thread-safe.
+ * Its memory is aligned to #RCUTILS_POOL_ALLOCATOR_ALIGNMENT bytes.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] pool the initialized pool allocator
+ * \return the allocator allocating from the pool, or
+ * \return a zero initialized allocator if the pool is NULL or not initialized.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_allocator_t
+rcutils_pool_allocator_get_allocator(const rcutils_pool_allocator_t * pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCUTILS__POOL_ALLOCATOR_H_
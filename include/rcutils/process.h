@@ -54,6 +54,41 @@ RCUTILS_PUBLIC
 RCUTILS_WARN_UNUSED
 char * rcutils_get_executable_name(rcutils_allocator_t allocator);
 
+/// Information about the current process, computed once.
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_process_info_t
+{
+  /// The process ID, as returned by rcutils_get_pid().
+  int pid;
+  /// The executable name, as returned by rcutils_get_executable_name().
+  const char * executable_name;
+  /// The path of the executable, absolute where the platform tells it.
+  /**
+   * Otherwise it is the path the program was started with.
+   */
+  const char * executable_path;
+  /// The name of the host, or "" if it is unknown.
+  const char * hostname;
+} rcutils_process_info_t;
+
+/// Retrieve information about the current process, without allocating after the first call.
+/**
+ * The information is computed and allocated once, by the first call, and every following
+ * call returns the same pointer, so that callers needing the executable name or the host name
+ * repeatedly avoid the allocations and system calls of rcutils_get_executable_name().
+ * The information and its strings are borrowed and must not be modified nor freed, they are
+ * valid until the process exits.
+ * In the child of a `fork()`, the process ID is updated.
+ *
+ * This function is thread-safe.
+ *
+ * \return The information about the process on success, or
+ * \return `NULL` if allocating memory failed on the first call.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+const rcutils_process_info_t *
+rcutils_get_process_info(void);
+
 #ifdef __cplusplus
 }
 #endif
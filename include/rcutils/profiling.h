@@ -0,0 +1,311 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// @file
+
+#ifndef RCUTILS__PROFILING_H_
+#define RCUTILS__PROFILING_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rcutils/macros.h"
+#include "rcutils/time.h"
+#include "rcutils/types/rcutils_ret.h"
+#include "rcutils/visibility_control.h"
+
+/// The number of buckets each power of two is divided into by the histograms of the probes.
+#define RCUTILS_PROFILING_HISTOGRAM_SUB_BUCKETS 4u
+
+/// The number of buckets of the histograms of the probes.
+/**
+ * Values below #RCUTILS_PROFILING_HISTOGRAM_SUB_BUCKETS have a bucket each, and each power
+ * of two above is divided into #RCUTILS_PROFILING_HISTOGRAM_SUB_BUCKETS buckets of equal
+ * width, so that a bucket is at most 25% wider than its lower bound.
+ * Values of 2^41 nanoseconds, about 36 minutes, or more are counted in the last bucket.
+ */
+#define RCUTILS_PROFILING_HISTOGRAM_BUCKETS 160u
+
+/// A named probe accumulating durations, which is opaque.
+typedef struct rcutils_profiling_probe_s rcutils_profiling_probe_t;
+
+/// The durations recorded by a probe, in nanoseconds.
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_profiling_statistics_t
+{
+  /// The number of durations.
+  uint64_t count;
+  /// The sum of the durations.
+  uint64_t sum;
+  /// The shortest duration, or 0 if there are none.
+  uint64_t min;
+  /// The longest duration, or 0 if there are none.
+  uint64_t max;
+  /// The number of durations in each bucket, see rcutils_profiling_histogram_bucket().
+  uint64_t histogram[RCUTILS_PROFILING_HISTOGRAM_BUCKETS];
+} rcutils_profiling_statistics_t;
+
+/// The cache of the probe of a call site, see rcutils_profiling_get_cached_probe().
+/**
+ * A zero initialized cache is empty, and needs no finalization.
+ */
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_profiling_probe_cache_t
+{
+  /// The probe, accessed atomically, or 0 if it isn't looked up yet.
+  uintptr_t probe;
+} rcutils_profiling_probe_cache_t;
+
+/// A scope being timed, see rcutils_profiling_scope_begin().
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_profiling_scope_t
+{
+  /// The probe the duration of the scope is recorded to, or NULL to not record it.
+  rcutils_profiling_probe_t * probe;
+  /// The time of the steady clock the scope began at.
+  rcutils_time_point_value_t start;
+} rcutils_profiling_scope_t;
+
+/// Return the probe with the given name, registering it if there is none.
+/**
+ * The probes live until the process exits, and are shared by all the callers asking for the
+ * same name.
+ * Looking a probe up takes a lock, so callers recording often should keep the probe, or use
+ * rcutils_profiling_get_cached_probe().
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes, once per name
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | No
+ *
+ * \param[in] name the name of the probe, copied
+ * \return the probe, or
+ * \return `NULL` for invalid arguments, or
+ * \return `NULL` if memory allocation fails.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_profiling_probe_t *
+rcutils_profiling_get_probe(const char * name);
+
+/// Return the probe with the given name, looking it up once for the cache.
+/**
+ * This is rcutils_profiling_get_probe(), once, after which the probe is loaded from the
+ * cache, which is typically a static variable of the call site, without taking a lock.
+ * If the lookup fails, the error is reset and `NULL` is returned, so the call site is
+ * looked up again the next time.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes, once per name
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes, once the probe is cached
+ *
+ * \param[in] name the name of the probe
+ * \param[inout] cache the cache of the probe for this name
+ * \return the probe, or
+ * \return `NULL` if it couldn't be looked up.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_profiling_probe_t *
+rcutils_profiling_get_cached_probe(const char * name, rcutils_profiling_probe_cache_t * cache);
+
+/// Return the name of a probe.
+/**
+ * \param[in] probe the probe
+ * \return the name of the probe, or
+ * \return `NULL` if probe is NULL.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+const char *
+rcutils_profiling_probe_get_name(const rcutils_profiling_probe_t * probe);
+
+/// Record a duration to a probe.
+/**
+ * Each probe has counters for several threads, and each thread uses its own as long as there
+ * are fewer threads recording than counters, so that recording doesn't contend on a cache
+ * line.
+ * The counters are updated with relaxed atomic operations, without any lock.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[in] probe the probe, nothing is recorded if it's NULL
+ * \param[in] duration the duration in nanoseconds
+ */
+RCUTILS_PUBLIC
+void
+rcutils_profiling_probe_record(rcutils_profiling_probe_t * probe, uint64_t duration);
+
+/// Merge the counters of a probe, and optionally reset them.
+/**
+ * Each counter is read, or read and reset, atomically, but not all of them at once, so a
+ * duration recorded meanwhile may be counted in the count but not yet in the histogram.
+ * Resetting doesn't lose any duration: those recorded while resetting are part of either
+ * these statistics or the next ones.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[in] probe the probe
+ * \param[in] reset whether to reset the counters, to get the statistics of intervals
+ * \param[out] statistics the statistics of the durations recorded since the last reset
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_profiling_probe_get_statistics(
+  rcutils_profiling_probe_t * probe, bool reset, rcutils_profiling_statistics_t * statistics);
+
+/// The function called with the statistics of each probe by rcutils_profiling_snapshot().
+typedef void (* rcutils_profiling_snapshot_callback_t)(
+  const char * name, const rcutils_profiling_statistics_t * statistics, void * context);
+
+/// Call a function with the statistics of each probe, in the order they were registered.
+/**
+ * This is meant to be called periodically, for instance by a timer, to report or aggregate
+ * the statistics of all probes, resetting them to report intervals.
+ * The registration of probes is blocked while the function is called, so it must not call
+ * rcutils_profiling_get_probe(), nor look up probes which aren't cached yet.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | No
+ *
+ * \param[in] callback the function called for each probe
+ * \param[in] reset whether to reset the counters of the probes
+ * \param[in] context the context passed to the function
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_profiling_snapshot(
+  rcutils_profiling_snapshot_callback_t callback, bool reset, void * context);
+
+/// Return the index of the histogram bucket a duration is counted in.
+/**
+ * \param[in] duration the duration in nanoseconds
+ * \return the index of its bucket, less than #RCUTILS_PROFILING_HISTOGRAM_BUCKETS.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+size_t
+rcutils_profiling_histogram_bucket(uint64_t duration);
+
+/// Return the shortest duration counted in a histogram bucket.
+/**
+ * \param[in] bucket the index of the bucket
+ * \return the shortest duration of the bucket in nanoseconds, or
+ * \return `UINT64_MAX` if bucket isn't less than #RCUTILS_PROFILING_HISTOGRAM_BUCKETS.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+uint64_t
+rcutils_profiling_histogram_bucket_lower_bound(size_t bucket);
+
+/// Estimate a percentile of the durations from their histogram.
+/**
+ * The estimate is the lower bound of the bucket the percentile falls in, clamped between the
+ * shortest and the longest durations, so it's at most 25% below the exact percentile, except
+ * for the 100th percentile, which is the longest duration.
+ *
+ * \param[in] statistics the statistics of the durations
+ * \param[in] percentile the percentile, between 0 and 100
+ * \return the estimated percentile in nanoseconds, or
+ * \return 0 if there are no durations or for invalid arguments.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+uint64_t
+rcutils_profiling_statistics_percentile(
+  const rcutils_profiling_statistics_t * statistics, double percentile);
+
+/// Begin timing a scope, reading the steady clock.
+/**
+ * \param[in] probe the probe the duration of the scope is recorded to, or NULL to not record
+ *   it
+ * \return the scope to pass to rcutils_profiling_scope_end().
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_profiling_scope_t
+rcutils_profiling_scope_begin(rcutils_profiling_probe_t * probe);
+
+/// End timing a scope, recording its duration to its probe.
+/**
+ * \param[in] scope the scope returned by rcutils_profiling_scope_begin()
+ */
+RCUTILS_PUBLIC
+void
+rcutils_profiling_scope_end(const rcutils_profiling_scope_t * scope);
+
+/// Begin a block whose duration is recorded to the probe with the given name.
+/**
+ * The block is closed by RCUTILS_PROFILING_SCOPE_END(), in the same function:
+ *
+ * ```c
+ * RCUTILS_PROFILING_SCOPE_BEGIN("my_package.process");
+ * process(data);
+ * RCUTILS_PROFILING_SCOPE_END();
+ * ```
+ *
+ * The probe is looked up once per call site, see rcutils_profiling_get_cached_probe().
+ * Leaving the block otherwise, with `return`, `break` or `goto`, doesn't record its duration.
+ *
+ * \param[in] name the name of the probe
+ */
+#define RCUTILS_PROFILING_SCOPE_BEGIN(name) \
+  { \
+    static rcutils_profiling_probe_cache_t rcutils_profiling_probe_cache; \
+    const rcutils_profiling_scope_t rcutils_profiling_scope = rcutils_profiling_scope_begin( \
+      rcutils_profiling_get_cached_probe(name, &rcutils_profiling_probe_cache));
+
+/// End the block begun by RCUTILS_PROFILING_SCOPE_BEGIN(), recording its duration.
+#define RCUTILS_PROFILING_SCOPE_END() \
+    rcutils_profiling_scope_end(&rcutils_profiling_scope); \
+  }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCUTILS__PROFILING_H_
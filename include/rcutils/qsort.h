@@ -22,16 +22,34 @@ extern "C"
 {
 #endif
 
+#include <stddef.h>
+
+#include "rcutils/allocator.h"
 #include "rcutils/macros.h"
 #include "rcutils/types/rcutils_ret.h"
 #include "rcutils/visibility_control.h"
 
-/// Interface to qsort with rcutils-style argument validation.
+/// Sort an array, with rcutils-style argument validation.
 /**
  * This function changes the order of the elements in the array so that they
  * are in ascending order according to the given comparison function.
  *
- * This function is thread-safe.
+ * The array is sorted in place with a pattern-defeating quicksort, rather than with the
+ * `qsort` of the C library, which some implement as a merge sort allocating memory.
+ * It runs in O(n log n) time in the worst case, O(n) for sorted, reverse sorted or
+ * constant input, and in O(log n) stack space, without allocating memory, so that it can be
+ * used in real-time code.
+ * The sort is not stable.
+ * Elements of 4, 8 or 16 bytes are swapped through registers, and the strings of a string
+ * array sorted with rcutils_string_array_sort_compare() are compared without calling it.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
  *
  * \param[inout] ptr object whose elements should be sorted.
  * \param[in] count number of elements present in the object.
@@ -46,6 +64,74 @@ RCUTILS_WARN_UNUSED
 rcutils_ret_t
 rcutils_qsort(void * ptr, size_t count, size_t size, int (* comp)(const void *, const void *));
 
+/// The number of elements below which rcutils_qsort_parallel() sorts with a single thread.
+#define RCUTILS_QSORT_PARALLEL_DEFAULT_SEQUENTIAL_THRESHOLD ((size_t)65536)
+/// The smallest number of elements rcutils_qsort_parallel() sorts with a single thread.
+#define RCUTILS_QSORT_PARALLEL_MIN_SEQUENTIAL_THRESHOLD ((size_t)1024)
+
+/// The options of rcutils_qsort_parallel().
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_qsort_parallel_options_t
+{
+  /// The number of threads sorting, including the calling one, or `0` for one per processor.
+  size_t thread_count;
+  /// The number of elements up to which a range is sorted by a single thread.
+  /**
+   * Thresholds below #RCUTILS_QSORT_PARALLEL_MIN_SEQUENTIAL_THRESHOLD are raised to it.
+   */
+  size_t sequential_threshold;
+} rcutils_qsort_parallel_options_t;
+
+/// Return the default options of rcutils_qsort_parallel().
+/**
+ * They use a thread per processor, and the threshold
+ * #RCUTILS_QSORT_PARALLEL_DEFAULT_SEQUENTIAL_THRESHOLD.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_qsort_parallel_options_t
+rcutils_qsort_parallel_get_default_options(void);
+
+/// Sort an array with several threads.
+/**
+ * This function sorts like rcutils_qsort(), with the same comparison function, but splits
+ * the array with the partitions of the quicksort into ranges which are sorted in parallel.
+ * The threads are started for the call, and joined before it returns.
+ * Each range of up to `sequential_threshold` elements is sorted by a single thread, and
+ * arrays of up to `sequential_threshold` elements, or sorted with a single thread, are
+ * sorted with rcutils_qsort() without allocating memory.
+ * The sort is not stable, and the comparison function is called concurrently from several
+ * threads, so it must be thread-safe.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | No
+ *
+ * \param[inout] ptr object whose elements should be sorted.
+ * \param[in] count number of elements present in the object.
+ * \param[in] size size of each element, in bytes.
+ * \param[in] comp function used to compare two elements.
+ * \param[in] options the number of threads and the threshold of the sort.
+ * \param[in] allocator the allocator of the threads and of their queue.
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_BAD_ALLOC if allocating memory fails, or
+ * \return #RCUTILS_RET_ERROR if an unknown error occurs.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_qsort_parallel(
+  void * ptr,
+  size_t count,
+  size_t size,
+  int (* comp)(const void *, const void *),
+  const rcutils_qsort_parallel_options_t * options,
+  rcutils_allocator_t allocator);
+
 #ifdef __cplusplus
 }
 #endif
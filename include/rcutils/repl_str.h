@@ -33,10 +33,23 @@ extern "C"
 {
 #endif
 
+#include <stddef.h>
+
 #include "rcutils/allocator.h"
 #include "rcutils/macros.h"
+#include "rcutils/types/char_array.h"
+#include "rcutils/types/rcutils_ret.h"
 #include "rcutils/visibility_control.h"
 
+/// A string to replace and its replacement, for rcutils_repl_str_multi().
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_repl_str_pair_t
+{
+  /// The string to match for replacement, which must not be empty.
+  const char * from;
+  /// The string to replace the matches with.
+  const char * to;
+} rcutils_repl_str_pair_t;
+
 /// Replace all the occurrences of one string for another in the given string.
 /**
  * Documentation copied from the source with minor tweaks:
@@ -135,6 +148,45 @@ rcutils_repl_str(
 
 // Implementation copied from above mentioned source continues in repl_str.c.
 
+/// Replace all the occurrences of several strings in the given string, into a char array.
+/**
+ * The string is scanned once, and at each position the first pair whose `from` string
+ * matches there is replaced with its `to` string, so the pairs are tried in order and the
+ * replacements are never scanned again.
+ * The result is appended to the string in `output`, as with rcutils_char_array_append_n(),
+ * so the output is written in a single pass without caching the positions of the matches,
+ * and reusing the same output for several strings allocates only when it has to grow.
+ *
+ * The candidate positions are found with a table of the first characters of the `from`
+ * strings, so the cost is linear in the length of the string for a handful of pairs.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] str string to have substrings found and replaced within
+ * \param[in] pairs the strings to replace and their replacements
+ * \param[in] pair_count the number of pairs
+ * \param[inout] output the char array to append the result to
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation failed, or
+ * \return #RCUTILS_RET_NOT_ENOUGH_SPACE if the output would exceed its `max_capacity`, or
+ * \return #RCUTILS_RET_ERROR if an unexpected error occurs.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_repl_str_multi(
+  const char * str,
+  const rcutils_repl_str_pair_t * pairs,
+  size_t pair_count,
+  rcutils_char_array_t * output);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,235 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// @file
+
+#ifndef RCUTILS__SHARED_COUNTERS_H_
+#define RCUTILS__SHARED_COUNTERS_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rcutils/allocator.h"
+#include "rcutils/macros.h"
+#include "rcutils/types/rcutils_ret.h"
+#include "rcutils/visibility_control.h"
+
+/// The bytes the file of shared counters begins with, including the terminating null byte.
+#define RCUTILS_SHARED_COUNTERS_MAGIC "rcutcnt"
+
+/// The version of the layout of the file of shared counters.
+#define RCUTILS_SHARED_COUNTERS_VERSION 1u
+
+/// The size of the names of the shared counters, including the terminating null byte.
+#define RCUTILS_SHARED_COUNTERS_NAME_SIZE 48u
+
+/// The meaning of the value of a shared counter.
+typedef enum rcutils_shared_counter_kind_t
+{
+  /// A count which only grows, e.g. of messages, which monitors turn into rates.
+  RCUTILS_SHARED_COUNTER_KIND_COUNTER = 1,
+  /// A level which goes up and down, e.g. the depth of a queue.
+  RCUTILS_SHARED_COUNTER_KIND_GAUGE = 2,
+} rcutils_shared_counter_kind_t;
+
+/// The beginning of the file of shared counters.
+/**
+ * The file is a header followed by `capacity` entries, of 64 bytes each, in the byte order
+ * of the process.
+ * A monitor maps the file read-only, checks the magic and the version, then loads `count`
+ * with acquire ordering: the first `count` entries are complete, and their values are
+ * loaded with relaxed atomic operations.
+ * Entries are never removed nor moved, so a monitor only needs to look at the entries
+ * added since its last look to find new counters.
+ */
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_shared_counters_header_t
+{
+  /// #RCUTILS_SHARED_COUNTERS_MAGIC.
+  char magic[8];
+  /// #RCUTILS_SHARED_COUNTERS_VERSION.
+  uint32_t version;
+  /// The size in bytes of an entry.
+  uint32_t entry_size;
+  /// The number of entries the file has room for.
+  uint32_t capacity;
+  /// The number of entries in use, accessed atomically.
+  uint32_t count;
+  /// The ID of the process updating the counters, as returned by rcutils_get_pid().
+  uint64_t pid;
+  /// Zeros, for future versions.
+  uint64_t reserved[4];
+} rcutils_shared_counters_header_t;
+
+/// A shared counter, of the size of a cache line so that updating it doesn't contend with
+/// updating its neighbours.
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_shared_counters_entry_t
+{
+  /// The value of the counter, accessed atomically.
+  uint64_t value;
+  /// The #rcutils_shared_counter_kind_t of the counter.
+  uint32_t kind;
+  /// Zero, for future versions.
+  uint32_t reserved;
+  /// The name of the counter, null terminated.
+  char name[RCUTILS_SHARED_COUNTERS_NAME_SIZE];
+} rcutils_shared_counters_entry_t;
+
+/// Counters in a memory-mapped file, for monitoring a process from the outside.
+/**
+ * Monitors read the counters directly from the file, see rcutils_shared_counters_header_t,
+ * without any action of the process, so that updating a counter costs a relaxed atomic
+ * operation and nothing else, however often it's read.
+ */
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_shared_counters_t
+{
+  /// A pointer to the PIMPL implementation type.
+  struct rcutils_shared_counters_impl_t * impl;
+} rcutils_shared_counters_t;
+
+/// Return a zero initialized shared counters struct.
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_shared_counters_t
+rcutils_get_zero_initialized_shared_counters(void);
+
+/// Create the file of the shared counters and map it into memory.
+/**
+ * The file is created, or truncated if it exists, and has room for `capacity` counters.
+ * On Linux, it is typically in `/dev/shm`, so that it lives in memory and is never written
+ * to a disk, e.g. `/dev/shm/my_node.counters`.
+ * The file is removed by rcutils_shared_counters_fini().
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[inout] counters the zero initialized shared counters
+ * \param[in] path the path of the file
+ * \param[in] capacity the largest number of counters, more than 0
+ * \param[in] allocator the allocator of the implementation
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails, or
+ * \return #RCUTILS_RET_ERROR if the file cannot be created or mapped.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_shared_counters_init(
+  rcutils_shared_counters_t * counters,
+  const char * path,
+  size_t capacity,
+  const rcutils_allocator_t * allocator);
+
+/// Unmap and remove the file of the shared counters.
+/**
+ * The pointers to the values of the counters become invalid, so no thread may update them,
+ * nor log if the logging statistics are exported to these counters.
+ * Finalizing zero initialized shared counters does nothing.
+ *
+ * \param[inout] counters the shared counters, zero initialized again
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_ERROR if the file cannot be unmapped or removed.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_shared_counters_fini(rcutils_shared_counters_t * counters);
+
+/// Get the value of the counter with the given name, adding it if there is none.
+/**
+ * Adding a counter takes a lock, so callers should keep the returned pointer, and update
+ * it with rcutils_shared_counter_add() or rcutils_shared_counter_set().
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | No
+ *
+ * \param[inout] counters the initialized shared counters
+ * \param[in] name the name of the counter, shorter than #RCUTILS_SHARED_COUNTERS_NAME_SIZE
+ * \param[in] kind the kind of the counter, which must be the same as when it was added
+ * \param[out] value the value of the counter, valid until the counters are finalized
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_ENOUGH_SPACE if all the entries are in use.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_shared_counters_get(
+  rcutils_shared_counters_t * counters,
+  const char * name,
+  rcutils_shared_counter_kind_t kind,
+  uint64_t ** value);
+
+/// Add to the value of a shared counter, with a relaxed atomic operation.
+/**
+ * \param[inout] value the value returned by rcutils_shared_counters_get(), nothing is done
+ *   if it's NULL
+ * \param[in] delta the amount to add, wrapping around on overflow
+ */
+RCUTILS_PUBLIC
+void
+rcutils_shared_counter_add(uint64_t * value, uint64_t delta);
+
+/// Set the value of a shared counter, typically a gauge, with a relaxed atomic operation.
+/**
+ * \param[inout] value the value returned by rcutils_shared_counters_get(), nothing is done
+ *   if it's NULL
+ * \param[in] new_value the new value
+ */
+RCUTILS_PUBLIC
+void
+rcutils_shared_counter_set(uint64_t * value, uint64_t new_value);
+
+/// Mirror the logging statistics of the process in shared counters.
+/**
+ * The counters of rcutils_logging_statistics_t are added, named after their fields and
+ * the severities, e.g. `rcutils.logging.emitted.info` or `rcutils.logging.bytes_written`,
+ * and updated along with the logging statistics from then on.
+ * They are only updated while the logging statistics are enabled, see
+ * rcutils_logging_set_statistics_enabled(), and aren't reset by
+ * rcutils_logging_reset_statistics(), so they only grow, as monitors expect of counters.
+ * The statistics are mirrored in at most one set of shared counters at a time, the last
+ * one passed to this function, until it's finalized.
+ *
+ * \param[inout] counters the initialized shared counters
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_ENOUGH_SPACE if the counters have no room for the statistics.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_shared_counters_export_logging_statistics(rcutils_shared_counters_t * counters);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCUTILS__SHARED_COUNTERS_H_
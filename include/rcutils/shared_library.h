@@ -29,6 +29,8 @@ extern "C"
 #include "rcutils/macros.h"
 #include "rcutils/visibility_control.h"
 
+struct rcutils_shared_library_symbol_cache_t;
+
 /// Handle to a loaded shared library.
 typedef struct RCUTILS_PUBLIC_TYPE rcutils_shared_library_t
 {
@@ -38,6 +40,8 @@ typedef struct RCUTILS_PUBLIC_TYPE rcutils_shared_library_t
   char * library_path;
   /// allocator
   rcutils_allocator_t allocator;
+  /// The symbols found in the shared library so far, so that they're looked up only once
+  struct rcutils_shared_library_symbol_cache_t * symbol_cache;
 } rcutils_shared_library_t;
 
 /// Return an empty shared library struct.
@@ -90,8 +94,157 @@ rcutils_load_shared_library(
   const char * library_path,
   rcutils_allocator_t allocator);
 
+/// The options of rcutils_load_shared_library_with_options().
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_shared_library_load_options_t
+{
+  /// Whether to resolve all the symbols of the library as it's loaded, as `RTLD_NOW` does.
+  /**
+   * Otherwise they're resolved when first used, as `RTLD_LAZY` does, which makes loading
+   * faster but the first calls into the library slower.
+   * Libraries are always loaded this way on Windows.
+   */
+  bool resolve_now;
+  /// Whether the symbols of the library resolve those of the libraries loaded later.
+  /**
+   * This is `RTLD_GLOBAL` rather than `RTLD_LOCAL`, and is ignored on Windows.
+   */
+  bool global;
+  /// Whether to keep the library loaded once unloaded, as `RTLD_NODELETE` does.
+  /**
+   * The library is pinned with `GetModuleHandleEx()` on Windows.
+   */
+  bool no_delete;
+} rcutils_shared_library_load_options_t;
+
+/// Return the default options of rcutils_load_shared_library_with_options().
+/**
+ * They resolve the symbols lazily, keep them local, and allow unloading the library, as
+ * rcutils_load_shared_library() does.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_shared_library_load_options_t
+rcutils_shared_library_get_default_load_options(void);
+
+/// Return shared library pointer, loading the library with the given options.
+/**
+ * \param[inout] lib struct with the shared library pointer and shared library path name
+ * \param[in] library_path string with the path of the library
+ * \param[in] options the options of the loading, or `NULL` for the default ones
+ * \param[in] allocator to be used to allocate and deallocate memory
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails, or
+ * \return #RCUTILS_RET_ERROR if an unknown error occurs, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_load_shared_library_with_options(
+  rcutils_shared_library_t * lib,
+  const char * library_path,
+  const rcutils_shared_library_load_options_t * options,
+  rcutils_allocator_t allocator);
+
+struct rcutils_shared_library_preload_impl_t;
+
+/// The loading of a list of shared libraries in the background.
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_shared_library_preload_t
+{
+  /// A pointer to the PIMPL implementation type.
+  struct rcutils_shared_library_preload_impl_t * impl;
+} rcutils_shared_library_preload_t;
+
+/// Return an empty preload struct.
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_shared_library_preload_t
+rcutils_get_zero_initialized_shared_library_preload(void);
+
+/// Start loading a list of shared libraries on background threads.
+/**
+ * Each library is loaded as with rcutils_load_shared_library_with_options(), on one of
+ * `thread_count` threads started for the preload, so that the libraries of a process with
+ * many plugins load while it does something else.
+ * The libraries and the paths must not be used until rcutils_shared_library_preload_wait()
+ * returns.
+ * If the threads can't be started, the libraries are loaded by
+ * rcutils_shared_library_preload_wait().
+ *
+ * \param[inout] preload zero initialized preload to start
+ * \param[inout] libs the `count` zero initialized libraries to load
+ * \param[in] library_paths the `count` paths of the libraries
+ * \param[in] count the number of libraries to load
+ * \param[in] options the options of the loading, or `NULL` for the default ones
+ * \param[in] thread_count the number of threads loading, or `0` for one per processor
+ * \param[in] allocator to be used to allocate and deallocate memory, also by the libraries
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_shared_library_preload_start(
+  rcutils_shared_library_preload_t * preload,
+  rcutils_shared_library_t * libs,
+  const char * const * library_paths,
+  size_t count,
+  const rcutils_shared_library_load_options_t * options,
+  size_t thread_count,
+  rcutils_allocator_t allocator);
+
+/// Wait for the libraries of a preload to be loaded, after which it's zero initialized again.
+/**
+ * The calling thread loads the libraries which are still waiting to be loaded.
+ * The libraries which fail to load are left zero initialized, the others are loaded even if
+ * some fail, and are unloaded with rcutils_unload_shared_library().
+ *
+ * \param[inout] preload the started preload
+ * \return #RCUTILS_RET_OK if all the libraries are loaded, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return the error of the first library which failed to load, as returned by
+ *   rcutils_load_shared_library_with_options().
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_shared_library_preload_wait(rcutils_shared_library_preload_t * preload);
+
+/// Load a list of shared libraries with several threads.
+/**
+ * This is rcutils_shared_library_preload_start() followed by
+ * rcutils_shared_library_preload_wait().
+ *
+ * \param[inout] libs the `count` zero initialized libraries to load
+ * \param[in] library_paths the `count` paths of the libraries
+ * \param[in] count the number of libraries to load
+ * \param[in] options the options of the loading, or `NULL` for the default ones
+ * \param[in] thread_count the number of threads loading, including the calling one, or `0`
+ *   for one per processor
+ * \param[in] allocator to be used to allocate and deallocate memory, also by the libraries
+ * \return #RCUTILS_RET_OK if all the libraries are loaded, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return the error of the first library which failed to load.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_load_shared_libraries(
+  rcutils_shared_library_t * libs,
+  const char * const * library_paths,
+  size_t count,
+  const rcutils_shared_library_load_options_t * options,
+  size_t thread_count,
+  rcutils_allocator_t allocator);
+
 /// Return shared library symbol pointer.
 /**
+ * The symbols found are cached in the library handle, so that looking the same symbol up
+ * again doesn't go through the dynamic linker.
+ * This function is thread-safe.
+ *
  * \param[in] lib struct with the shared library pointer and shared library path name
  * \param[in] symbol_name name of the symbol inside the shared library
  * \return shared library symbol pointer, or
@@ -102,8 +255,35 @@ RCUTILS_WARN_UNUSED
 void *
 rcutils_get_symbol(const rcutils_shared_library_t * lib, const char * symbol_name);
 
+/// Look a list of symbols up in the shared library at once.
+/**
+ * This is equivalent to calling rcutils_get_symbol() for each symbol, but the symbol cache
+ * of the library is only locked once to find the cached symbols, and once to cache the
+ * others.
+ * All the symbols are looked up even if some don't exist, their pointers being `NULL`.
+ * This function is thread-safe.
+ *
+ * \param[in] lib struct with the shared library pointer and shared library path name
+ * \param[in] symbol_names names of the symbols inside the shared library
+ * \param[in] count number of symbols to look up
+ * \param[out] symbols the array of count pointers in which to store the symbol pointers
+ * \return #RCUTILS_RET_OK if all the symbols exist, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_ERROR if a symbol doesn't exist.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_get_symbols(
+  const rcutils_shared_library_t * lib,
+  const char * const * symbol_names,
+  size_t count,
+  void ** symbols);
+
 /// Return true if the shared library contains a specific symbol name otherwise returns false.
 /**
+ * The symbols found are cached as in rcutils_get_symbol().
+ *
  * \param[in] lib struct with the shared library pointer and shared library path name
  * \param[in] symbol_name name of the symbol inside the shared library
  * \return `true` if the symbol exists, or
@@ -140,6 +320,26 @@ RCUTILS_WARN_UNUSED
 bool
 rcutils_is_shared_library_loaded(rcutils_shared_library_t * lib);
 
+/// Check if a library was loaded with a path and is still loaded.
+/**
+ * The libraries loaded by rcutils_load_shared_library() are registered, by the path they're
+ * loaded with and by their resolved path, until all their handles are unloaded, so that this
+ * is a hash lookup rather than a call into the dynamic linker.
+ * Loading a library which is already loaded also uses the registry to find its resolved path.
+ *
+ * Libraries loaded otherwise, or kept loaded with
+ * rcutils_shared_library_load_options_t::no_delete once unloaded, aren't considered loaded.
+ * This function is thread-safe.
+ *
+ * \param[in] library_path the path the library was loaded with, or its resolved path
+ * \return `true` if a library loaded with this path is loaded, or
+ * \return `false` otherwise.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+bool
+rcutils_is_shared_library_path_loaded(const char * library_path);
+
 /// Get the library name for the compiled platform
 /**
  * \param[in] library_name library base name (without prefix and extension)
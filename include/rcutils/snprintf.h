@@ -68,6 +68,42 @@ RCUTILS_WARN_UNUSED
 int
 rcutils_vsnprintf(char * buffer, size_t buffer_size, const char * format, va_list args);
 
+/// Format a string without going through the C library for the common conversions.
+/**
+ * This function behaves like rcutils_snprintf(), but formats the common conversions itself,
+ * which is much cheaper than the locale aware snprintf() of the C library:
+ *  - `%d`, `%i`, `%u`, `%x`, `%X` and `%o`, with the `hh`, `h`, `l`, `ll`, `j`, `z` and
+ *    `t` length modifiers,
+ *  - `%s`, `%c`, `%p` and `%%`,
+ *  - with the `-`, `+`, space, `#` and `0` flags, a width and a precision, either of which may
+ *    be given by `*`.
+ *
+ * The floating point conversions, `%f`, `%F`, `%e`, `%E`, `%g` and `%G`, are formatted
+ * one at a time by snprintf() for the correct rounding, and a format with any other
+ * conversion is entirely formatted by rcutils_vsnprintf().
+ *
+ * Unlike snprintf(), `%p` is always formatted as `0x` followed by lower case hexadecimal
+ * digits, or `(nil)` for a null pointer, and a null string is formatted as `(null)`.
+ *
+ * \see rcutils_snprintf()
+ * \return the number of bytes that would have been written given enough space, or
+ * \return a negative number if there is an error.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+int
+rcutils_fast_snprintf(char * buffer, size_t buffer_size, const char * format, ...)
+/// @cond Doxygen_Suppress
+RCUTILS_ATTRIBUTE_PRINTF_FORMAT(3, 4)
+/// @endcond
+;
+
+/// Format a string with va_list for arguments, see rcutils_fast_snprintf().
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+int
+rcutils_fast_vsnprintf(char * buffer, size_t buffer_size, const char * format, va_list args);
+
 #ifdef __cplusplus
 }
 #endif
@@ -24,6 +24,7 @@ extern "C"
 
 #include "rcutils/allocator.h"
 #include "rcutils/types.h"
+#include "rcutils/types/string_view.h"
 #include "rcutils/visibility_control.h"
 
 /// Split a given string with the specified delimiter
@@ -62,6 +63,110 @@ rcutils_split_last(
   rcutils_allocator_t allocator,
   rcutils_string_array_t * string_array);
 
+/// Split a given string with the specified delimiter into a single allocation
+/**
+ * The tokens are the same as those of rcutils_split(), empty tokens being skipped, but they
+ * are copied into one block of memory allocated with the allocator, which holds both the
+ * array of pointers to the tokens and the tokens, so that a split is a single allocation.
+ * The array is terminated by a NULL pointer, and the whole block is deallocated at once:
+ *
+ * ```c
+ * char ** tokens = NULL;
+ * size_t count = 0;
+ * if (RCUTILS_RET_OK == rcutils_split_contiguous("/ns/node", '/', allocator, &tokens, &count)) {
+ *   // use tokens[0] to tokens[count - 1]
+ *   allocator.deallocate(tokens, allocator.state);
+ * }
+ * ```
+ *
+ * If there are no tokens, nothing is allocated and the array is set to NULL.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] str string to split, may be NULL for no tokens
+ * \param[in] delimiter on where to split
+ * \param[in] allocator for allocating the block of the tokens
+ * \param[out] tokens the NULL terminated array of the tokens
+ * \param[out] count the number of tokens
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_split_contiguous(
+  const char * str,
+  char delimiter,
+  rcutils_allocator_t allocator,
+  char *** tokens,
+  size_t * count);
+
+/// Split a given string with the specified delimiter into views of its tokens
+/**
+ * The tokens are the same as those of rcutils_split(), empty tokens being skipped, but they
+ * aren't copied: each view refers to the characters of the token in str.
+ * The number of tokens is always set, so that a first call with a capacity of 0 can size the
+ * array of views.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] str string to split, may be NULL for no tokens
+ * \param[in] delimiter on where to split
+ * \param[out] views the array the views of the tokens are stored to, may be NULL if capacity
+ *   is 0
+ * \param[in] capacity the number of views the array can hold
+ * \param[out] count the number of tokens of the string
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_ENOUGH_SPACE if there are more tokens than capacity, the first
+ *   capacity of them being stored.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_split_views(
+  const char * str,
+  char delimiter,
+  rcutils_string_view_t * views,
+  size_t capacity,
+  size_t * count);
+
+/// Get a view of the next token of a string split with the specified delimiter
+/**
+ * This iterates over the tokens of rcutils_split_views() without storing them: the token
+ * given is the previous one, or a zero initialized view to get the first token.
+ *
+ * ```c
+ * rcutils_string_view_t token = rcutils_get_zero_initialized_string_view();
+ * while (rcutils_split_next_view("/ns/node", '/', &token)) {
+ *   printf("%.*s\n", (int)token.length, token.data);
+ * }
+ * ```
+ *
+ * \param[in] str string to split, may be NULL for no tokens
+ * \param[in] delimiter on where to split
+ * \param[inout] token the previous token, set to the next one
+ * \return `true` if there is a next token, or
+ * \return `false` if there are no more tokens, the token being zero initialized, or
+ * \return `false` if token is NULL.
+ */
+RCUTILS_PUBLIC
+bool
+rcutils_split_next_view(const char * str, char delimiter, rcutils_string_view_t * token);
+
 #ifdef __cplusplus
 }
 #endif
@@ -66,6 +66,50 @@
 
 #define rcutils_atomic_fetch_add(object, out, arg) (out) = atomic_fetch_add(object, arg)
 
+#define rcutils_atomic_fetch_sub(object, out, arg) (out) = atomic_fetch_sub(object, arg)
+
+#define rcutils_atomic_fetch_and(object, out, arg) (out) = atomic_fetch_and(object, arg)
+
+#define rcutils_atomic_fetch_or(object, out, arg) (out) = atomic_fetch_or(object, arg)
+
+#define rcutils_atomic_compare_exchange_weak(object, out, expected, desired) \
+  (out) = atomic_compare_exchange_weak(object, expected, desired)
+
+// The variants with explicit memory orders, which are memory_order_relaxed, memory_order_acquire,
+// memory_order_release, memory_order_acq_rel or memory_order_seq_cst.
+
+#define rcutils_atomic_load_explicit(object, out, order) (out) = atomic_load_explicit(object, order)
+
+#define rcutils_atomic_store_explicit(object, desired, order) \
+  atomic_store_explicit(object, desired, order)
+
+#define rcutils_atomic_exchange_explicit(object, out, desired, order) \
+  (out) = atomic_exchange_explicit(object, desired, order)
+
+#define rcutils_atomic_compare_exchange_strong_explicit( \
+    object, out, expected, desired, success, failure) \
+  (out) = atomic_compare_exchange_strong_explicit(object, expected, desired, success, failure)
+
+#define rcutils_atomic_compare_exchange_weak_explicit( \
+    object, out, expected, desired, success, failure) \
+  (out) = atomic_compare_exchange_weak_explicit(object, expected, desired, success, failure)
+
+#define rcutils_atomic_fetch_add_explicit(object, out, arg, order) \
+  (out) = atomic_fetch_add_explicit(object, arg, order)
+
+#define rcutils_atomic_fetch_sub_explicit(object, out, arg, order) \
+  (out) = atomic_fetch_sub_explicit(object, arg, order)
+
+#define rcutils_atomic_fetch_and_explicit(object, out, arg, order) \
+  (out) = atomic_fetch_and_explicit(object, arg, order)
+
+#define rcutils_atomic_fetch_or_explicit(object, out, arg, order) \
+  (out) = atomic_fetch_or_explicit(object, arg, order)
+
+#define rcutils_atomic_thread_fence(order) atomic_thread_fence(order)
+
+#define rcutils_atomic_signal_fence(order) atomic_signal_fence(order)
+
 #else  // !defined(_WIN32)
 
 #include "./stdatomic_helper/win32/stdatomic.h"
@@ -73,7 +117,7 @@
 #define rcutils_atomic_load(object, out) rcutils_win32_atomic_load(object, out)
 
 #define rcutils_atomic_compare_exchange_strong(object, out, expected, desired) \
-  rcutils_win32_atomic_compare_exchange_strong(object, out, expected, desired)
+  rcutils_win32_atomic_compare_exchange(object, out, expected, desired)
 
 #define rcutils_atomic_exchange(object, out, desired) \
   rcutils_win32_atomic_exchange(object, out, desired)
@@ -82,6 +126,76 @@
 
 #define rcutils_atomic_fetch_add(object, out, arg) rcutils_win32_atomic_fetch_add(object, out, arg)
 
+#define rcutils_atomic_fetch_sub(object, out, arg) rcutils_win32_atomic_fetch_sub(object, out, arg)
+
+#define rcutils_atomic_fetch_and(object, out, arg) rcutils_win32_atomic_fetch_and(object, out, arg)
+
+#define rcutils_atomic_fetch_or(object, out, arg) rcutils_win32_atomic_fetch_or(object, out, arg)
+
+#define rcutils_atomic_compare_exchange_weak(object, out, expected, desired) \
+  rcutils_win32_atomic_compare_exchange(object, out, expected, desired)
+
+// The Interlocked functions are full barriers, so the memory orders are only evaluated.
+
+#define rcutils_atomic_load_explicit(object, out, order) \
+  do { \
+    (void)(order); \
+    rcutils_win32_atomic_load(object, out); \
+  } while (0)
+
+#define rcutils_atomic_store_explicit(object, desired, order) \
+  do { \
+    (void)(order); \
+    rcutils_win32_atomic_store(object, desired); \
+  } while (0)
+
+#define rcutils_atomic_exchange_explicit(object, out, desired, order) \
+  do { \
+    (void)(order); \
+    rcutils_win32_atomic_exchange(object, out, desired); \
+  } while (0)
+
+#define rcutils_atomic_compare_exchange_strong_explicit( \
+    object, out, expected, desired, success, failure) \
+  do { \
+    (void)(success); \
+    (void)(failure); \
+    rcutils_win32_atomic_compare_exchange(object, out, expected, desired); \
+  } while (0)
+
+#define rcutils_atomic_compare_exchange_weak_explicit( \
+    object, out, expected, desired, success, failure) \
+  rcutils_atomic_compare_exchange_strong_explicit( \
+    object, out, expected, desired, success, failure)
+
+#define rcutils_atomic_fetch_add_explicit(object, out, arg, order) \
+  do { \
+    (void)(order); \
+    rcutils_win32_atomic_fetch_add(object, out, arg); \
+  } while (0)
+
+#define rcutils_atomic_fetch_sub_explicit(object, out, arg, order) \
+  do { \
+    (void)(order); \
+    rcutils_win32_atomic_fetch_sub(object, out, arg); \
+  } while (0)
+
+#define rcutils_atomic_fetch_and_explicit(object, out, arg, order) \
+  do { \
+    (void)(order); \
+    rcutils_win32_atomic_fetch_and(object, out, arg); \
+  } while (0)
+
+#define rcutils_atomic_fetch_or_explicit(object, out, arg, order) \
+  do { \
+    (void)(order); \
+    rcutils_win32_atomic_fetch_or(object, out, arg); \
+  } while (0)
+
+#define rcutils_atomic_thread_fence(order) atomic_thread_fence(order)
+
+#define rcutils_atomic_signal_fence(order) atomic_signal_fence(order)
+
 #endif  // !defined(_WIN32)
 
 static inline bool
@@ -133,6 +247,23 @@ rcutils_atomic_compare_exchange_strong_uint_least64_t(
   return result;
 }
 
+static inline bool
+rcutils_atomic_compare_exchange_strong_uintptr_t(
+  atomic_uintptr_t * a_uintptr_t, uintptr_t * expected, uintptr_t desired)
+{
+  bool result;
+#if defined(__clang__)
+# pragma clang diagnostic push
+  // we know it's a gnu feature, but clang supports it, so suppress pedantic warning
+# pragma clang diagnostic ignored "-Wgnu-statement-expression"
+#endif
+  rcutils_atomic_compare_exchange_strong(a_uintptr_t, result, expected, desired);
+#if defined(__clang__)
+# pragma clang diagnostic pop
+#endif
+  return result;
+}
+
 static inline bool
 rcutils_atomic_exchange_bool(atomic_bool * a_bool, bool desired)
 {
@@ -173,6 +304,64 @@ rcutils_atomic_fetch_add_uint64_t(atomic_uint_least64_t * a_uint64_t, uint64_t a
   return result;
 }
 
+static inline uint64_t
+rcutils_atomic_fetch_sub_uint64_t(atomic_uint_least64_t * a_uint64_t, uint64_t arg)
+{
+  uint64_t result;
+  rcutils_atomic_fetch_sub(a_uint64_t, result, arg);
+  return result;
+}
+
+static inline uint64_t
+rcutils_atomic_fetch_and_uint64_t(atomic_uint_least64_t * a_uint64_t, uint64_t arg)
+{
+  uint64_t result;
+  rcutils_atomic_fetch_and(a_uint64_t, result, arg);
+  return result;
+}
+
+static inline uint64_t
+rcutils_atomic_fetch_or_uint64_t(atomic_uint_least64_t * a_uint64_t, uint64_t arg)
+{
+  uint64_t result;
+  rcutils_atomic_fetch_or(a_uint64_t, result, arg);
+  return result;
+}
+
+static inline bool
+rcutils_atomic_compare_exchange_weak_uint_least64_t(
+  atomic_uint_least64_t * a_uint_least64_t, uint64_t * expected, uint64_t desired)
+{
+  bool result;
+#if defined(__clang__)
+# pragma clang diagnostic push
+  // we know it's a gnu feature, but clang supports it, so suppress pedantic warning
+# pragma clang diagnostic ignored "-Wgnu-statement-expression"
+#endif
+  rcutils_atomic_compare_exchange_weak(a_uint_least64_t, result, expected, desired);
+#if defined(__clang__)
+# pragma clang diagnostic pop
+#endif
+  return result;
+}
+
+static inline bool
+rcutils_atomic_compare_exchange_weak_uintptr_t(
+  atomic_uintptr_t * a_uintptr_t, uintptr_t * expected, uintptr_t desired)
+{
+  bool result;
+#if defined(__clang__)
+# pragma clang diagnostic push
+  // we know it's a gnu feature, but clang supports it, so suppress pedantic warning
+# pragma clang diagnostic ignored "-Wgnu-statement-expression"
+#endif
+  rcutils_atomic_compare_exchange_weak(a_uintptr_t, result, expected, desired);
+#if defined(__clang__)
+# pragma clang diagnostic pop
+#endif
+  return result;
+}
+
 #if !defined(_WIN32)
 # pragma GCC diagnostic pop
 #endif
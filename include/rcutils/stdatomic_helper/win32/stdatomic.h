@@ -243,6 +243,53 @@ typedef _Atomic (uintmax_t) atomic_uintmax_t;
 #define rcutils_win32_atomic_compare_exchange_weak(object, out, expected, desired) \
   rcutils_win32_atomic_compare_exchange_strong(object, out, expected, desired)
 
+// Unlike rcutils_win32_atomic_compare_exchange_strong(), which stores the previous value in out,
+// this stores whether the exchange happened in out, and the previous value in expected, as
+// atomic_compare_exchange_strong() does.
+#define rcutils_win32_atomic_compare_exchange(object, out, expected, desired) \
+  __pragma(warning(push)) \
+  __pragma(warning(disable: 4244)) \
+  __pragma(warning(disable: 4047)) \
+  __pragma(warning(disable: 4024)) \
+  do { \
+    switch (sizeof((object)->__val)) { \
+      case sizeof(uint64_t): { \
+        LONGLONG previous = InterlockedCompareExchange64( \
+          (LONGLONG *) object, (LONGLONG) desired, *(LONGLONG *) expected); \
+        out = previous == *(LONGLONG *) expected; \
+        *(LONGLONG *) expected = previous; \
+        break; \
+      } \
+      case sizeof(uint32_t): { \
+        LONG previous = _InterlockedCompareExchange( \
+          (LONG *) object, (LONG) desired, *(LONG *) expected); \
+        out = previous == *(LONG *) expected; \
+        *(LONG *) expected = previous; \
+        break; \
+      } \
+      case sizeof(uint16_t): { \
+        SHORT previous = _InterlockedCompareExchange16( \
+          (SHORT *) object, (SHORT) desired, *(SHORT *) expected); \
+        out = previous == *(SHORT *) expected; \
+        *(SHORT *) expected = previous; \
+        break; \
+      } \
+      case sizeof(uint8_t): { \
+        char previous = _InterlockedCompareExchange8( \
+          (char *) object, (char) desired, *(char *) expected); \
+        out = previous == *(char *) expected; \
+        *(char *) expected = previous; \
+        break; \
+      } \
+      default: \
+        RCUTILS_LOG_ERROR_NAMED( \
+          _RCUTILS_PACKAGE_NAME, "Unsupported integer type in atomic_compare_exchange"); \
+        exit(-1); \
+        break; \
+    } \
+  } while (0); \
+  __pragma(warning(pop))
+
 #define rcutils_win32_atomic_exchange(object, out, desired) \
   __pragma(warning(push)) \
   __pragma(warning(disable: 4244)) \
@@ -22,6 +22,8 @@ extern "C"
 {
 #endif
 
+#include <stddef.h>
+
 #include "rcutils/macros.h"
 #include "rcutils/visibility_control.h"
 
@@ -30,6 +32,8 @@ extern "C"
  * This function compares two strings ignoring case in a portable way.
  * This performs a byte-by-byte comparison of the strings s1 and s2,
  * ignoring the case of the characters.
+ * Only the ASCII letters are folded, whatever the locale, and 16 bytes are compared
+ * at a time with SSE2 or NEON instructions where available.
  *
  * \param[in] s1 Null terminated string to compare.
  * \param[in] s2 Null terminated string to compare.
@@ -53,6 +57,7 @@ rcutils_strcasecmp(
  * This function compares two strings ignoring case in a portable way.
  * This performs a byte-by-byte comparison of the strings s1 and s2 up to count
  * characters of s1 and s2, ignoring the case of the characters.
+ * Like rcutils_strcasecmp(), only the ASCII letters are folded, whatever the locale.
  *
  * \param[in] s1 First string to compare.
  * \param[in] s2 Second string to compare.
@@ -73,6 +78,37 @@ rcutils_strncasecmp(
   size_t n,
   int * value);
 
+/// Hash a string ignoring case.
+/**
+ * The ASCII letters are folded to lower case 8 bytes at a time before being hashed, so that
+ * strings which rcutils_strcasecmp() finds equal have the same hash.
+ * The hash of the same string may differ between platforms and releases.
+ *
+ * \param[in] str Null terminated string to hash, may be NULL.
+ * \return The hash of the string, or 0 if str is NULL.
+ */
+RCUTILS_PUBLIC
+size_t
+rcutils_strcasecmp_hash(const char * str);
+
+/// A case insensitive hashing function for a null terminated c string.
+/**
+ * The counterpart of rcutils_hash_map_string_hash_func() which ignores case, to be used
+ * with rcutils_strcasecmp_cmp_func() when your key is just a pointer to a c-string.
+ */
+RCUTILS_PUBLIC
+size_t
+rcutils_strcasecmp_hash_func(const void * key_str);
+
+/// A case insensitive comparison function for a null terminated c string.
+/**
+ * The counterpart of rcutils_hash_map_string_cmp_func() which ignores case, see
+ * rcutils_strcasecmp_hash_func().
+ */
+RCUTILS_PUBLIC
+int
+rcutils_strcasecmp_cmp_func(const void * val1, const void * val2);
+
 #ifdef __cplusplus
 }
 #endif
@@ -72,6 +72,44 @@ RCUTILS_WARN_UNUSED
 int_least64_t
 rcutils_fault_injection_get_count(void);
 
+/**
+ * \brief Set the fault injection counter of the calling thread.
+ *
+ * While the counter of a thread isn't negative, the fault injection macros reached by that
+ * thread decrement it instead of the global counter, without any synchronization, and fail when
+ * it reaches 0 like they do with the global counter.
+ * This allows injecting faults into a single thread of a program running under load, while the
+ * other threads only pay a plain load of the global counter at each injection point.
+ *
+ * \param count The count to set the counter of the calling thread to, or
+ * RCUTILS_FAULT_INJECTION_NEVER_FAIL, its initial value, to use the global counter again.
+ */
+RCUTILS_PUBLIC
+void
+rcutils_fault_injection_set_thread_count(int_least64_t count);
+
+/**
+ * \brief Get the fault injection counter of the calling thread.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+int_least64_t
+rcutils_fault_injection_get_thread_count(void);
+
+/**
+ * \brief Restrict fault injection to the sites whose location contains `site`.
+ *
+ * The location of a site is its file name and line number, as in `"src/allocator.c:38"`, so
+ * that faults may be injected into the functions of a single file, or at a single line.
+ * The sites which don't match neither decrement the counters nor fail.
+ *
+ * \param site The string the locations of the sites to count must contain, which must stay
+ * valid until it's replaced, or `NULL` to count all the sites, the initial setting.
+ */
+RCUTILS_PUBLIC
+void
+rcutils_fault_injection_set_site(const char * site);
+
 /**
  * \brief Implementation of fault injection decrementer
  *
@@ -83,6 +121,71 @@ RCUTILS_WARN_UNUSED
 int_least64_t
 _rcutils_fault_injection_maybe_fail(void);
 
+/**
+ * \brief Implementation of fault injection decrementer for the site at the given location
+ *
+ * This is included inside of macros, so it needs to be exported as a public function, but it
+ * should not be used directly.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+int_least64_t
+_rcutils_fault_injection_maybe_fail_at(const char * site);
+
+/// The function reporting an injected fault, see rcutils_fault_injection_set_reporter().
+/**
+ * \param site The location of the site, see rcutils_fault_injection_set_site().
+ * \param action What the site does instead, as in `"returning NULL"`.
+ * \param context The context given to rcutils_fault_injection_set_reporter().
+ */
+typedef void (* rcutils_fault_injection_reporter_t)(
+  const char * site, const char * action, void * context);
+
+/**
+ * \brief The default reporter, which prints the site and the action to the standard output.
+ */
+RCUTILS_PUBLIC
+void
+rcutils_fault_injection_print_reporter(const char * site, const char * action, void * context);
+
+/**
+ * \brief Set the function reporting the faults injected.
+ *
+ * Printing every fault injected dominates the time of the sweeps of
+ * `RCUTILS_FAULT_INJECTION_TEST` over large code paths, which a `NULL` reporter avoids.
+ * Either way, the faults injected are counted, see rcutils_fault_injection_get_injected_count().
+ *
+ * This function isn't thread-safe, it must not be called while faults may be injected.
+ *
+ * \param reporter The function called for each fault injected, which is
+ * rcutils_fault_injection_print_reporter() by default, or `NULL` to report nothing.
+ * \param context Passed to the reporter.
+ */
+RCUTILS_PUBLIC
+void
+rcutils_fault_injection_set_reporter(rcutils_fault_injection_reporter_t reporter, void * context);
+
+/**
+ * \brief Get the number of faults injected since the program started, by all the threads.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+uint_least64_t
+rcutils_fault_injection_get_injected_count(void);
+
+/**
+ * \brief Count and report a fault injected
+ *
+ * This is included inside of macros, so it needs to be exported as a public function, but it
+ * should not be used directly.
+ */
+RCUTILS_PUBLIC
+void
+_rcutils_fault_injection_report(const char * site, const char * action);
+
+/// The location of a fault injection site, see rcutils_fault_injection_set_site().
+#define RCUTILS_FAULT_INJECTION_SITE __FILE__ ":" RCUTILS_STRINGIFY(__LINE__)
+
 /**
  * \def RCUTILS_FAULT_INJECTION_MAYBE_RETURN_ERROR
  * \brief This macro checks and decrements a static global variable atomic counter and returns
@@ -100,9 +203,12 @@ _rcutils_fault_injection_maybe_fail(void);
  * \param return_value_on_error the value to return in the case of fault injected failure.
  */
 #define RCUTILS_FAULT_INJECTION_MAYBE_RETURN_ERROR(return_value_on_error) \
-  if (RCUTILS_FAULT_INJECTION_FAIL_NOW == _rcutils_fault_injection_maybe_fail()) { \
-    printf( \
-      "%s:%d Injecting fault and returning " #return_value_on_error "\n", __FILE__, __LINE__); \
+  if ( \
+    RCUTILS_FAULT_INJECTION_FAIL_NOW == \
+    _rcutils_fault_injection_maybe_fail_at(RCUTILS_FAULT_INJECTION_SITE)) \
+  { \
+    _rcutils_fault_injection_report( \
+      RCUTILS_FAULT_INJECTION_SITE, "returning " #return_value_on_error); \
     return return_value_on_error; \
   }
 
@@ -124,9 +230,11 @@ _rcutils_fault_injection_maybe_fail(void);
  * \param failure_code the code to execute in the case of fault injected failure.
  */
 #define RCUTILS_FAULT_INJECTION_MAYBE_FAIL(failure_code) \
-  if (RCUTILS_FAULT_INJECTION_FAIL_NOW == _rcutils_fault_injection_maybe_fail()) { \
-    printf( \
-      "%s:%d Injecting fault and executing " #failure_code "\n", __FILE__, __LINE__); \
+  if ( \
+    RCUTILS_FAULT_INJECTION_FAIL_NOW == \
+    _rcutils_fault_injection_maybe_fail_at(RCUTILS_FAULT_INJECTION_SITE)) \
+  { \
+    _rcutils_fault_injection_report(RCUTILS_FAULT_INJECTION_SITE, "executing " #failure_code); \
     failure_code; \
   }
 
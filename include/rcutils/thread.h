@@ -0,0 +1,273 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// @file
+
+#ifndef RCUTILS__THREAD_H_
+#define RCUTILS__THREAD_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rcutils/macros.h"
+#include "rcutils/types/rcutils_ret.h"
+#include "rcutils/visibility_control.h"
+
+/// The number of processors a #rcutils_thread_cpu_set_t can hold.
+#define RCUTILS_THREAD_MAX_CPUS 1024u
+
+/// The maximum length of the name of a thread, including the terminating null character.
+/**
+ * Names are truncated to 16 characters, including it, on Linux.
+ */
+#define RCUTILS_THREAD_MAX_NAME_LENGTH 64u
+
+/// A set of processors, to which a thread may be bound.
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_thread_cpu_set_t
+{
+  /// Processor i is in the set if bit `i % 64` of `bits[i / 64]` is set.
+  uint64_t bits[RCUTILS_THREAD_MAX_CPUS / 64u];
+} rcutils_thread_cpu_set_t;
+
+/// The scheduling policies of threads.
+typedef enum rcutils_thread_scheduling_policy_t
+{
+  /// Leave the policy and the priority of the thread as they are.
+  RCUTILS_THREAD_SCHEDULING_POLICY_UNCHANGED = 0,
+  /// Time sharing, the default policy of threads, `SCHED_OTHER`.
+  RCUTILS_THREAD_SCHEDULING_POLICY_OTHER = 1,
+  /// Real-time first in first out, `SCHED_FIFO`.
+  RCUTILS_THREAD_SCHEDULING_POLICY_FIFO = 2,
+  /// Real-time round robin, `SCHED_RR`.
+  RCUTILS_THREAD_SCHEDULING_POLICY_ROUND_ROBIN = 3,
+} rcutils_thread_scheduling_policy_t;
+
+/// The attributes to set on a thread, see rcutils_thread_set_attributes().
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_thread_attributes_t
+{
+  /// The processors the thread may run on, or `NULL` to leave them as they are.
+  const rcutils_thread_cpu_set_t * cpus;
+  /// The scheduling policy of the thread.
+  rcutils_thread_scheduling_policy_t policy;
+  /// The real-time priority of the thread, ignored unless the policy is real-time.
+  int priority;
+  /// The name of the thread, or `NULL` to leave it as it is.
+  const char * name;
+} rcutils_thread_attributes_t;
+
+/// Return an empty set of processors.
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_thread_cpu_set_t
+rcutils_get_zero_initialized_thread_cpu_set(void);
+
+/// Add a processor to a set.
+/**
+ * \param[inout] cpus the set
+ * \param[in] cpu the index of the processor, less than #RCUTILS_THREAD_MAX_CPUS
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_thread_cpu_set_add(rcutils_thread_cpu_set_t * cpus, size_t cpu);
+
+/// Return `true` if the processor is in the set, `false` otherwise or if `cpus` is `NULL`.
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+bool
+rcutils_thread_cpu_set_contains(const rcutils_thread_cpu_set_t * cpus, size_t cpu);
+
+/// Return the number of processors in the set, 0 if `cpus` is `NULL`.
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+size_t
+rcutils_thread_cpu_set_count(const rcutils_thread_cpu_set_t * cpus);
+
+/// Bind the calling thread to a set of processors.
+/**
+ * This is supported on Linux, and on Windows for the processors of the first group, that
+ * is the first 64.
+ * macOS has no binding of threads to processors.
+ *
+ * \param[in] cpus the processors the thread may run on, which must not be empty
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_ERROR if the binding failed or isn't supported.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_thread_set_affinity(const rcutils_thread_cpu_set_t * cpus);
+
+/// Retrieve the set of processors the calling thread may run on.
+/**
+ * Where the binding isn't supported, these are all the processors online.
+ *
+ * \param[out] cpus the processors the thread may run on
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_ERROR if an unknown error occurs.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_thread_get_affinity(rcutils_thread_cpu_set_t * cpus);
+
+/// Set the scheduling policy and the priority of the calling thread.
+/**
+ * On Linux and macOS the real-time priority is passed to `pthread_setschedparam()`, and
+ * must be between `sched_get_priority_min()` and `sched_get_priority_max()` of the policy,
+ * which is 1 to 99 on Linux.
+ * Real-time policies usually need privileges, such as `CAP_SYS_NICE` on Linux.
+ * On Windows both real-time policies raise the priority of the thread, to
+ * `THREAD_PRIORITY_ABOVE_NORMAL` for priorities below 33, `THREAD_PRIORITY_HIGHEST` for
+ * priorities below 66, and `THREAD_PRIORITY_TIME_CRITICAL` otherwise, and the time sharing
+ * one sets it back to `THREAD_PRIORITY_NORMAL`.
+ *
+ * \param[in] policy the scheduling policy
+ * \param[in] priority the real-time priority, ignored for the time sharing policy
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_ERROR if the thread isn't allowed the policy or priority.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_thread_set_scheduling(rcutils_thread_scheduling_policy_t policy, int priority);
+
+/// Retrieve the scheduling policy and the priority of the calling thread.
+/**
+ * Policies without an equivalent are reported as the time sharing one.
+ * On Windows, the real-time policy reported is round robin, with a priority of 1, 50 or 99
+ * for the priorities set by rcutils_thread_set_scheduling().
+ *
+ * \param[out] policy the scheduling policy
+ * \param[out] priority the real-time priority, or 0 for the time sharing policy
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_ERROR if an unknown error occurs.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_thread_get_scheduling(rcutils_thread_scheduling_policy_t * policy, int * priority);
+
+/// Set the name of the calling thread, as shown by debuggers and system tools.
+/**
+ * Names longer than the platform allows are truncated.
+ *
+ * \param[in] name the name of the thread
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_ERROR if naming failed or isn't supported.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_thread_set_name(const char * name);
+
+/// Retrieve the name of the calling thread.
+/**
+ * \param[out] name where the name is copied, truncated and null terminated
+ * \param[in] size the size of `name`, in bytes
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_ERROR if naming isn't supported.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_thread_get_name(char * name, size_t size);
+
+/// Return the id of the calling thread, as shown by debuggers and system tools.
+/**
+ * This is the kernel id of the thread on Linux, as `gettid()` returns, the id returned by
+ * `pthread_threadid_np()` on macOS and by `GetCurrentThreadId()` on Windows.
+ * It's fetched the first time it's asked for by each thread, and cached after, so it's cheap
+ * enough to be called for every log record.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \return the id of the calling thread, never 0
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+uint64_t
+rcutils_thread_get_id(void);
+
+/// Return the name of the calling thread, cached like the one of rcutils_thread_get_id().
+/**
+ * The name is fetched again after the thread is named with rcutils_thread_set_name(), but
+ * not after it's named some other way.
+ * No error is set if the name can't be fetched, in which case it's empty.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \return the name of the calling thread, which is valid until the thread is named again or
+ *   exits
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+const char *
+rcutils_thread_get_cached_name(void);
+
+/// Return the attributes which leave a thread as it is.
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_thread_attributes_t
+rcutils_thread_get_default_attributes(void);
+
+/// Set the attributes of the calling thread.
+/**
+ * This sets the processors, the scheduling and the name of the thread which aren't left
+ * unchanged, as rcutils_thread_set_affinity(), rcutils_thread_set_scheduling() and
+ * rcutils_thread_set_name() do, so that threads started by rcutils can be placed with the
+ * attributes given in their options.
+ * It stops at the first attribute which can't be set, and returns its error.
+ *
+ * \param[in] attributes the attributes of the thread
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_ERROR if an attribute couldn't be set.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_thread_set_attributes(const rcutils_thread_attributes_t * attributes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCUTILS__THREAD_H_
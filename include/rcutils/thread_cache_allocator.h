@@ -0,0 +1,188 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// @file
+
+#ifndef RCUTILS__THREAD_CACHE_ALLOCATOR_H_
+#define RCUTILS__THREAD_CACHE_ALLOCATOR_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+
+#include "rcutils/allocator.h"
+#include "rcutils/macros.h"
+#include "rcutils/types/rcutils_ret.h"
+#include "rcutils/visibility_control.h"
+
+/// The size of the largest allocation cached by a thread cache allocator.
+#define RCUTILS_THREAD_CACHE_ALLOCATOR_MAX_BLOCK_SIZE ((size_t)256)
+
+/// The number of blocks of a size class a thread caches before giving some back.
+#define RCUTILS_THREAD_CACHE_ALLOCATOR_MAX_CACHED_BLOCKS ((size_t)64)
+
+/// The number of thread cache allocators a thread can have a cache for at the same time.
+#define RCUTILS_THREAD_CACHE_ALLOCATOR_MAX_PER_THREAD 4
+
+struct rcutils_thread_cache_allocator_impl_s;
+
+/// A wrapper of an allocator caching the small blocks deallocated by each thread.
+/**
+ * The allocations up to #RCUTILS_THREAD_CACHE_ALLOCATOR_MAX_BLOCK_SIZE bytes are rounded up to
+ * a size class, and each thread keeps the blocks it deallocates in free lists of its own, so
+ * that it allocates them again without calling the other allocator or synchronizing with the
+ * other threads.
+ * When a free list holds more than #RCUTILS_THREAD_CACHE_ALLOCATOR_MAX_CACHED_BLOCKS blocks,
+ * half of them are deallocated with the other allocator at once.
+ * Larger allocations are forwarded to the other allocator, which must be thread-safe.
+ *
+ * A block can be deallocated by another thread than the one which allocated it, it's then
+ * cached by that thread.
+ * The cache of a thread is created on its first allocation, and is only deallocated with the
+ * thread cache allocator, so a thread exiting should call
+ * rcutils_thread_cache_allocator_flush() to give its cached blocks back.
+ * A thread uses the other allocator directly for the thread cache allocators beyond the first
+ * #RCUTILS_THREAD_CACHE_ALLOCATOR_MAX_PER_THREAD it used.
+ */
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_thread_cache_allocator_t
+{
+  /// A pointer to the PIMPL implementation type.
+  struct rcutils_thread_cache_allocator_impl_s * impl;
+} rcutils_thread_cache_allocator_t;
+
+/// Return an empty thread cache allocator struct.
+/**
+ * This function returns an empty and zero initialized thread cache allocator struct.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \return an empty and zero initialized thread cache allocator struct
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_thread_cache_allocator_t
+rcutils_get_zero_initialized_thread_cache_allocator(void);
+
+/// Initialize a thread cache allocator.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * Example:
+ *
+ * ```c
+ * rcutils_allocator_t default_allocator = rcutils_get_default_allocator();
+ * rcutils_thread_cache_allocator_t cache = rcutils_get_zero_initialized_thread_cache_allocator();
+ * rcutils_ret_t ret = rcutils_thread_cache_allocator_init(&cache, &default_allocator);
+ * rcutils_allocator_t allocator = rcutils_thread_cache_allocator_get_allocator(&cache);
+ * // ... share the allocator between threads, then once they are done
+ * ret = rcutils_thread_cache_allocator_fini(&cache);
+ * ```
+ *
+ * \param[inout] cache the zero initialized thread cache allocator to initialize
+ * \param[in] allocator the thread-safe allocator to cache the blocks of
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_thread_cache_allocator_init(
+  rcutils_thread_cache_allocator_t * cache,
+  const rcutils_allocator_t * allocator);
+
+/// Finalize a thread cache allocator, deallocating the caches of all the threads.
+/**
+ * The allocator must not be used by any thread anymore.
+ * Calling this on a zero initialized thread cache allocator does nothing.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[inout] cache the thread cache allocator to finalize
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_thread_cache_allocator_fini(rcutils_thread_cache_allocator_t * cache);
+
+/// Deallocate the blocks cached by the calling thread with the other allocator.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] cache the initialized thread cache allocator
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_INITIALIZED if the thread cache allocator is not initialized.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_thread_cache_allocator_flush(const rcutils_thread_cache_allocator_t * cache);
+
+/// Return an allocator allocating through a thread cache allocator.
+/**
+ * The allocator is valid until the thread cache allocator is finalized, and is thread-safe.
+ * Its memory has the alignment of the memory of the other allocator, up to 16 bytes.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] cache the initialized thread cache allocator
+ * \return the allocator allocating through the thread cache allocator, or
+ * \return a zero initialized allocator if it's NULL or not initialized.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_allocator_t
+rcutils_thread_cache_allocator_get_allocator(const rcutils_thread_cache_allocator_t * cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCUTILS__THREAD_CACHE_ALLOCATOR_H_
@@ -0,0 +1,199 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// @file
+
+#ifndef RCUTILS__THREAD_POOL_H_
+#define RCUTILS__THREAD_POOL_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+
+#include "rcutils/allocator.h"
+#include "rcutils/macros.h"
+#include "rcutils/thread.h"
+#include "rcutils/types/rcutils_ret.h"
+#include "rcutils/visibility_control.h"
+
+/// The number of items which may be queued by default, by each thread and from outside.
+#define RCUTILS_THREAD_POOL_DEFAULT_CAPACITY 256u
+
+struct rcutils_thread_pool_impl_t;
+
+/// A pool of threads processing the items pushed into it, which may push more items.
+/**
+ * Each thread of the pool queues the items it pushes at the bottom of its own deque, and
+ * processes them last in first out, while the threads which run out of items steal from the
+ * top of the deques of the others, as in the deque of Chase and Lev.
+ * This keeps the threads busy with few synchronizations, and the items a thread splits
+ * into on the processor which split them.
+ * Items pushed from outside of the pool go into a shared queue guarded by a mutex.
+ * The threads which find no item sleep until one is pushed.
+ */
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_thread_pool_t
+{
+  /// A pointer to the PIMPL implementation type.
+  struct rcutils_thread_pool_impl_t * impl;
+} rcutils_thread_pool_t;
+
+/// The function processing an item of a pool.
+/**
+ * \param[in] pool the pool processing the item, to push more items into
+ * \param[in] context the context passed to rcutils_thread_pool_init()
+ * \param[in] item a copy of the item pushed, which is only valid during the call
+ */
+typedef void (* rcutils_thread_pool_function_t)(
+  rcutils_thread_pool_t * pool, void * context, void * item);
+
+/// The options of rcutils_thread_pool_init().
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_thread_pool_options_t
+{
+  /// The number of threads processing the items, including the one calling
+  /// rcutils_thread_pool_wait(), or `0` for one per processor.
+  size_t thread_count;
+  /// The number of items each thread may queue, as well as the threads outside of the pool,
+  /// or `0` for #RCUTILS_THREAD_POOL_DEFAULT_CAPACITY.
+  size_t capacity;
+  /// The processors to which the threads started by the pool are bound, or `NULL`.
+  /**
+   * The i-th thread started is bound to the processor `cpu_affinity[i % cpu_affinity_count]`.
+   * The threads are bound on Linux and Windows only, and the thread calling
+   * rcutils_thread_pool_wait() is never bound.
+   */
+  const size_t * cpu_affinity;
+  /// The number of processors of `cpu_affinity`.
+  size_t cpu_affinity_count;
+  /// The attributes set by the threads started by the pool when they start, or `NULL`.
+  /**
+   * They are copied by rcutils_thread_pool_init().
+   * Setting them is best effort: a thread which fails to runs without them.
+   * Processors given both here and in `cpu_affinity` are bound to as given here.
+   */
+  const rcutils_thread_attributes_t * thread_attributes;
+} rcutils_thread_pool_options_t;
+
+/// Return a zero initialized thread pool.
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_thread_pool_t
+rcutils_get_zero_initialized_thread_pool(void);
+
+/// Return the default options of rcutils_thread_pool_init().
+/**
+ * They use a thread per processor, #RCUTILS_THREAD_POOL_DEFAULT_CAPACITY, no affinity and
+ * leave the attributes of the threads as they are.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_thread_pool_options_t
+rcutils_thread_pool_get_default_options(void);
+
+/// Return the number of processors online, at least 1.
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+size_t
+rcutils_thread_pool_get_processor_count(void);
+
+/// Initialize a pool, and start its threads.
+/**
+ * The threads start processing the items as soon as they are pushed.
+ * The threads which fail to start are done without, so that fewer may run, down to the one
+ * calling rcutils_thread_pool_wait() only.
+ *
+ * \param[inout] pool zero initialized pool
+ * \param[in] function the function processing the items
+ * \param[in] context passed to the function
+ * \param[in] item_size the size of the items, in bytes
+ * \param[in] options the options of the pool, or `NULL` for the default ones
+ * \param[in] allocator to be used to allocate and deallocate memory
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_ERROR if an unknown error occurs.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_thread_pool_init(
+  rcutils_thread_pool_t * pool,
+  rcutils_thread_pool_function_t function,
+  void * context,
+  size_t item_size,
+  const rcutils_thread_pool_options_t * options,
+  rcutils_allocator_t allocator);
+
+/// Copy an item into the pool, for one of its threads to process.
+/**
+ * From a thread of the pool the item is queued by that thread, otherwise it's queued in the
+ * shared queue.
+ * A full queue isn't an error, so no error message is set: the caller may process the item
+ * itself instead.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes, from the threads of the pool
+ *
+ * \param[inout] pool the initialized pool
+ * \param[in] item the item, of the size given to rcutils_thread_pool_init()
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_NOT_ENOUGH_SPACE if the queue is full, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_thread_pool_push(rcutils_thread_pool_t * pool, const void * item);
+
+/// Process items along with the threads of the pool, until all the items pushed are processed.
+/**
+ * Only one thread may wait for a pool at a time, and it must not be one of its threads.
+ * The pool may be used again once this returns.
+ *
+ * \param[inout] pool the initialized pool
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_thread_pool_wait(rcutils_thread_pool_t * pool);
+
+/// Stop and join the threads of the pool, after which it's zero initialized again.
+/**
+ * The items which are still queued are dropped, so rcutils_thread_pool_wait() is usually
+ * called before.
+ * Finalizing a zero initialized pool does nothing.
+ *
+ * \param[inout] pool the pool
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_thread_pool_fini(rcutils_thread_pool_t * pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCUTILS__THREAD_POOL_H_
@@ -22,6 +22,7 @@ extern "C"
 {
 #endif
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include "rcutils/macros.h"
@@ -104,6 +105,289 @@ RCUTILS_WARN_UNUSED
 rcutils_ret_t
 rcutils_steady_time_now(rcutils_time_point_value_t * now);
 
+/// Retrieve the current time of a coarse monotonically increasing clock.
+/**
+ * This function returns the time from a monotonically increasing clock which is
+ * cheaper to read than the one of rcutils_steady_time_now(), at the cost of its
+ * resolution, typically in the order of milliseconds.
+ * On Linux this is `CLOCK_MONOTONIC_COARSE`, on Windows `GetTickCount64()`, elsewhere
+ * it is the clock of rcutils_steady_time_now().
+ *
+ * The clock may have a different epoch than the one of rcutils_steady_time_now(), so
+ * the time points of both must not be compared.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[out] now a struct in which the current time is stored
+ * \return #RCUTILS_RET_OK if the current time was successfully obtained, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCUTILS_RET_ERROR if an unspecified error occur.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_coarse_steady_time_now(rcutils_time_point_value_t * now);
+
+/// Retrieve the current time of a coarse system clock.
+/**
+ * This function returns the time from the clock of rcutils_system_time_now(), read
+ * more cheaply at the cost of its resolution, typically in the order of milliseconds,
+ * which is enough for throttling or log timestamps.
+ * On Linux this is `CLOCK_REALTIME_COARSE`, on Windows `GetSystemTimeAsFileTime()`,
+ * elsewhere it is rcutils_system_time_now().
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[out] now a struct in which the current time is stored
+ * \return #RCUTILS_RET_OK if the current time was successfully obtained, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCUTILS_RET_ERROR if an unspecified error occur.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_coarse_system_time_now(rcutils_time_point_value_t * now);
+
+/// Retrieve the resolution of the coarse clocks.
+/**
+ * This is the duration between two changes of the time points of
+ * rcutils_coarse_steady_time_now() and rcutils_coarse_system_time_now(), at most.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[out] resolution a duration in which the resolution is stored
+ * \return #RCUTILS_RET_OK if the resolution was successfully obtained, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCUTILS_RET_ERROR if an unspecified error occur.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_coarse_time_resolution(rcutils_duration_value_t * resolution);
+
+/// Calibrate the clock of rcutils_tsc_steady_time_now() against the steady clock.
+/**
+ * The time stamp counter of the CPU, `rdtsc` on x86 or `cntvct_el0` on 64-bit ARM,
+ * is used only if it is reliable: on x86 it must be invariant, according to `cpuid`,
+ * and on Linux it must also be the current clocksource of the kernel, which switches
+ * away from it when it finds it unstable, for instance on some virtual machines.
+ * Its frequency is then measured against rcutils_steady_time_now() for about 20
+ * milliseconds, and it is not used if two successive measurements disagree.
+ *
+ * Otherwise, and on other architectures, rcutils_tsc_steady_time_now() falls back to
+ * rcutils_steady_time_now().
+ * Calling this again calibrates the clock again, even while other threads read it.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \return #RCUTILS_RET_OK if successful, even if the clock falls back, or
+ * \return #RCUTILS_RET_ERROR if the steady clock can't be read.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_tsc_steady_time_init(void);
+
+/// Return `true` if rcutils_tsc_steady_time_now() reads the time stamp counter.
+/**
+ * \return `true` if the time stamp counter is calibrated and reliable, otherwise `false`.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+bool
+rcutils_tsc_steady_time_is_enabled(void);
+
+/// Retrieve the current time of the steady clock, from the time stamp counter if possible.
+/**
+ * After rcutils_tsc_steady_time_init(), if the time stamp counter is reliable, this
+ * converts it to the time of rcutils_steady_time_now() without a system call, so that
+ * both time points can be compared, up to the drift between the clocks since the
+ * calibration, which is typically in the order of microseconds per second.
+ * Otherwise this is rcutils_steady_time_now().
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[out] now a struct in which the current time is stored
+ * \return #RCUTILS_RET_OK if the current time was successfully obtained, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCUTILS_RET_ERROR if an unspecified error occur.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_tsc_steady_time_now(rcutils_time_point_value_t * now);
+
+/// The default number of samples of rcutils_time_correlate_clocks().
+#define RCUTILS_TIME_CORRELATION_DEFAULT_SAMPLES 8u
+
+/// A correlation between the system clock and the steady clock.
+typedef struct rcutils_time_correlation_t
+{
+  /// The time point of the system clock which was sampled.
+  rcutils_time_point_value_t system_time;
+  /// The estimated time point of the steady clock at which the system clock was sampled.
+  rcutils_time_point_value_t steady_time;
+  /// The difference of the system clock to the steady clock, `system_time - steady_time`.
+  rcutils_duration_value_t offset;
+  /// The duration between the two reads of the steady clock surrounding the sample.
+  /**
+   * The estimated steady time is halfway through it, so the error of the offset is at most
+   * half of it.
+   */
+  rcutils_duration_value_t uncertainty;
+} rcutils_time_correlation_t;
+
+/// Sample the system clock and the steady clock back to back.
+/**
+ * Each sample reads the system clock between two reads of the steady clock, and the
+ * sample with the shortest interval between the reads of the steady clock is kept, as it
+ * is the one least likely to have been preempted.
+ * The steady time of the system time is estimated to be halfway through that interval.
+ *
+ * The offset of the correlation converts steady time points to system time points, see
+ * rcutils_time_correlation_steady_to_system(), which stays accurate as long as the system
+ * clock isn't adjusted.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] samples the number of samples to take, e.g.
+ *   #RCUTILS_TIME_CORRELATION_DEFAULT_SAMPLES
+ * \param[out] correlation the correlation of the clocks
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCUTILS_RET_ERROR if an unspecified error occur.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_time_correlate_clocks(size_t samples, rcutils_time_correlation_t * correlation);
+
+/// Convert time points of the steady clock to the system clock with a correlation.
+/**
+ * The time points are converted by adding the offset of the correlation, without reading
+ * any clock, and can be converted in place, with `system_times` equal to `steady_times`.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] correlation the correlation from rcutils_time_correlate_clocks()
+ * \param[in] steady_times the time points of the steady clock
+ * \param[out] system_times the corresponding time points of the system clock
+ * \param[in] count the number of time points
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if any arguments are invalid.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_time_correlation_steady_to_system(
+  const rcutils_time_correlation_t * correlation,
+  const rcutils_time_point_value_t * steady_times,
+  rcutils_time_point_value_t * system_times,
+  size_t count);
+
+/// The default margin before the deadline to spin for in rcutils_sleep_spin_until_steady().
+#define RCUTILS_SLEEP_DEFAULT_SPIN_MARGIN RCUTILS_US_TO_NS(200)
+
+/// Sleep until a time point of the steady clock.
+/**
+ * The calling thread sleeps until rcutils_steady_time_now() reaches the deadline, and
+ * returns immediately if it already has.
+ * On Linux this is an absolute `clock_nanosleep()`, which doesn't accumulate the overshoot
+ * of relative sleeps when resumed after a signal; on Windows a high resolution waitable
+ * timer where available; elsewhere `nanosleep()`.
+ * The sleep never ends before the deadline, but may end after it by the wakeup latency
+ * of the scheduler, typically tens of microseconds, see rcutils_sleep_spin_until_steady()
+ * to lower it.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] deadline the time point of the steady clock to sleep until
+ * \return #RCUTILS_RET_OK if the deadline was reached, or
+ * \return #RCUTILS_RET_ERROR if an unspecified error occur.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_sleep_until_steady(rcutils_time_point_value_t deadline);
+
+/// Sleep until shortly before a time point of the steady clock, then spin until it.
+/**
+ * The calling thread sleeps with rcutils_sleep_until_steady() until `spin_margin`
+ * nanoseconds before the deadline, then reads rcutils_steady_time_now() in a busy loop
+ * until the deadline, so that it wakes up within microseconds of it, at the cost of
+ * keeping a CPU busy during the margin.
+ * The margin should exceed the wakeup latency of the scheduler, and
+ * #RCUTILS_SLEEP_DEFAULT_SPIN_MARGIN is a reasonable default.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] deadline the time point of the steady clock to wait until
+ * \param[in] spin_margin the duration before the deadline to spin for
+ * \return #RCUTILS_RET_OK if the deadline was reached, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if the margin is negative, or
+ * \return #RCUTILS_RET_ERROR if an unspecified error occur.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_sleep_spin_until_steady(
+  rcutils_time_point_value_t deadline,
+  rcutils_duration_value_t spin_margin);
+
 /// Return a time point as nanoseconds in a string.
 /**
  * The number is always fixed width, with left padding zeros up to the maximum
@@ -117,16 +401,16 @@ rcutils_steady_time_now(rcutils_time_point_value_t * now);
  * large for both positive and negative values.
  * If the given string is not large enough, the result will be truncated.
  * If you need a string with variable width, using `snprintf()` directly is
- * recommended.
+ * recommended, and rcutils_time_point_value_format_nanoseconds() is faster if the
+ * string is large enough.
  *
  * <hr>
  * Attribute          | Adherence
  * ------------------ | -------------
- * Allocates Memory   | No [1]
+ * Allocates Memory   | No
  * Thread-Safe        | Yes
  * Uses Atomics       | No
  * Lock-Free          | Yes
- * <i>[1] if `snprintf()` does not allocate additional memory internally</i>
  *
  * \param[in] time_point the time to be made into a string
  * \param[out] str the output string in which it is stored
@@ -161,11 +445,10 @@ rcutils_time_point_value_as_nanoseconds_string(
  * <hr>
  * Attribute          | Adherence
  * ------------------ | -------------
- * Allocates Memory   | No [1]
+ * Allocates Memory   | No
  * Thread-Safe        | Yes
  * Uses Atomics       | No
  * Lock-Free          | Yes
- * <i>[1] if `snprintf()` does not allocate additional memory internally</i>
  *
  * \param[in] time_point the time to be made into a string
  * \param[out] str the output string in which it is stored
@@ -182,6 +465,82 @@ rcutils_time_point_value_as_seconds_string(
   char * str,
   size_t str_size);
 
+/// The size of a string large enough for any time point formatted with the format functions.
+/**
+ * That is the sign, 19 digits, the decimal separator and the null terminator, rounded up.
+ */
+#define RCUTILS_TIME_POINT_FORMAT_STRING_SIZE 32
+
+/// The number of fractional digits of the seconds formatted with
+/// rcutils_time_point_value_format_seconds().
+typedef enum rcutils_time_point_precision_t
+{
+  /// Milliseconds, e.g. `0000000012.345`.
+  RCUTILS_TIME_POINT_PRECISION_MILLISECONDS = 3,
+  /// Microseconds, e.g. `0000000012.345678`.
+  RCUTILS_TIME_POINT_PRECISION_MICROSECONDS = 6,
+  /// Nanoseconds, e.g. `0000000012.345678901`, like
+  /// rcutils_time_point_value_as_seconds_string().
+  RCUTILS_TIME_POINT_PRECISION_NANOSECONDS = 9,
+} rcutils_time_point_precision_t;
+
+/// Format a time point as nanoseconds, returning the length of the string.
+/**
+ * The string is the same as the one of rcutils_time_point_value_as_nanoseconds_string(),
+ * 19 zero padded digits with a leading `-` for negative values, rendered two digits at a
+ * time without going through `snprintf()`.
+ * The returned length lets callers append to the string without calling `strlen()`.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] time_point the time to be formatted
+ * \param[out] str the null terminated string, of at least
+ *   #RCUTILS_TIME_POINT_FORMAT_STRING_SIZE characters
+ * \return the number of characters written, not counting the null terminator, or
+ * \return `0` if `str` is `NULL`.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+size_t
+rcutils_time_point_value_format_nanoseconds(rcutils_time_point_value_t time_point, char * str);
+
+/// Format a time point as seconds, returning the length of the string.
+/**
+ * The seconds are rendered as in rcutils_time_point_value_as_seconds_string(), 10 zero
+ * padded digits with a leading `-` for negative values, followed by the number of
+ * fractional digits of the precision, which are truncated rather than rounded.
+ * The digits are rendered two at a time without going through `snprintf()`, and the
+ * returned length lets callers append to the string without calling `strlen()`.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] time_point the time to be formatted
+ * \param[in] precision the number of fractional digits
+ * \param[out] str the null terminated string, of at least
+ *   #RCUTILS_TIME_POINT_FORMAT_STRING_SIZE characters
+ * \return the number of characters written, not counting the null terminator, or
+ * \return `0` if `str` is `NULL` or the precision is invalid.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+size_t
+rcutils_time_point_value_format_seconds(
+  rcutils_time_point_value_t time_point,
+  rcutils_time_point_precision_t precision,
+  char * str);
+
 #ifdef __cplusplus
 }
 #endif
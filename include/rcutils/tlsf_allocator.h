@@ -0,0 +1,172 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// @file
+
+#ifndef RCUTILS__TLSF_ALLOCATOR_H_
+#define RCUTILS__TLSF_ALLOCATOR_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+
+#include "rcutils/allocator.h"
+#include "rcutils/macros.h"
+#include "rcutils/types/rcutils_ret.h"
+#include "rcutils/visibility_control.h"
+
+/// The alignment of the memory allocated by a TLSF allocator.
+#define RCUTILS_TLSF_ALLOCATOR_ALIGNMENT ((size_t)16)
+
+struct rcutils_tlsf_allocator_impl_s;
+
+/// A two-level segregated fit allocator over a memory region given by the caller.
+/**
+ * The free blocks of the region are kept in lists indexed by the power of two of their size
+ * and a linear subdivision of it, with bitmaps of the non-empty lists, so that allocating
+ * finds a large enough block with two bit scans, and deallocating merges the block with its
+ * free neighbours, both in bounded time whatever the state of the region.
+ *
+ * The allocator never allocates memory besides the region given at initialization, and its
+ * bookkeeping is stored at the start of that region.
+ * When the region has no large enough block, an allocation fails instead of growing the region,
+ * so this allocator can be used on real-time paths, for instance with
+ * rcutils_logging_initialize_with_allocator() or the init functions of the containers.
+ */
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_tlsf_allocator_t
+{
+  /// A pointer to the PIMPL implementation type, stored in the region.
+  struct rcutils_tlsf_allocator_impl_s * impl;
+} rcutils_tlsf_allocator_t;
+
+/// Return an empty TLSF allocator struct.
+/**
+ * This function returns an empty and zero initialized TLSF allocator struct.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \return an empty and zero initialized TLSF allocator struct
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_tlsf_allocator_t
+rcutils_get_zero_initialized_tlsf_allocator(void);
+
+/// Initialize a TLSF allocator over a memory region.
+/**
+ * The region must stay valid until the allocator is finalized, and can't be used for anything
+ * else in the meantime.
+ * A few kilobytes of the region are used for the bookkeeping of the allocator, and at most
+ * 1 GiB of the region is used on 32-bit targets, 4 GiB otherwise.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * Example:
+ *
+ * ```c
+ * static uint8_t memory[1024 * 1024];
+ * rcutils_tlsf_allocator_t tlsf = rcutils_get_zero_initialized_tlsf_allocator();
+ * rcutils_ret_t ret = rcutils_tlsf_allocator_init(&tlsf, memory, sizeof(memory));
+ * rcutils_allocator_t allocator = rcutils_tlsf_allocator_get_allocator(&tlsf);
+ * char * str = allocator.allocate(64, allocator.state);
+ * if (NULL == str) {
+ *   // ... the region is exhausted
+ * }
+ * allocator.deallocate(str, allocator.state);
+ * ret = rcutils_tlsf_allocator_fini(&tlsf);
+ * ```
+ *
+ * \param[inout] tlsf the zero initialized TLSF allocator to initialize
+ * \param[in] memory the region to allocate from
+ * \param[in] size the size of the region in bytes
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if the region is too small for the bookkeeping.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_tlsf_allocator_init(rcutils_tlsf_allocator_t * tlsf, void * memory, size_t size);
+
+/// Finalize a TLSF allocator.
+/**
+ * The memory allocated from the allocator becomes invalid, and the region can be reused.
+ * Calling this on a zero initialized TLSF allocator does nothing.
+ *
+ * \param[inout] tlsf the TLSF allocator to finalize
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_tlsf_allocator_fini(rcutils_tlsf_allocator_t * tlsf);
+
+/// Return the number of bytes of the free blocks of a TLSF allocator.
+/**
+ * The block headers are included, so the largest possible allocation is smaller, even when
+ * the free memory isn't fragmented.
+ *
+ * \param[in] tlsf the initialized TLSF allocator
+ * \return the number of free bytes, or
+ * \return 0 if the TLSF allocator is NULL or not initialized.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+size_t
+rcutils_tlsf_allocator_get_free_size(const rcutils_tlsf_allocator_t * tlsf);
+
+/// Return an allocator allocating from a TLSF allocator.
+/**
+ * The allocator is valid until the TLSF allocator is finalized, and isn't thread-safe.
+ * Its memory is aligned to #RCUTILS_TLSF_ALLOCATOR_ALIGNMENT bytes, and its functions return
+ * NULL when the region has no large enough free block.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] tlsf the initialized TLSF allocator
+ * \return the allocator allocating from the region, or
+ * \return a zero initialized allocator if the TLSF allocator is NULL or not initialized.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_allocator_t
+rcutils_tlsf_allocator_get_allocator(const rcutils_tlsf_allocator_t * tlsf);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCUTILS__TLSF_ALLOCATOR_H_
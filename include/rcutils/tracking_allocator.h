@@ -0,0 +1,227 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// @file
+
+#ifndef RCUTILS__TRACKING_ALLOCATOR_H_
+#define RCUTILS__TRACKING_ALLOCATOR_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rcutils/allocator.h"
+#include "rcutils/macros.h"
+#include "rcutils/types/rcutils_ret.h"
+#include "rcutils/visibility_control.h"
+
+/// The number of buckets of the size histogram of a tracking allocator.
+/**
+ * The bucket `i` counts the requested sizes up to `16 << i` bytes which aren't counted by the
+ * previous buckets, and the last bucket counts all the larger sizes.
+ */
+#define RCUTILS_TRACKING_ALLOCATOR_HISTOGRAM_SIZE 16
+
+/// The statistics recorded by a tracking allocator.
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_tracking_allocator_statistics_s
+{
+  /// The number of successful allocations, reallocations of NULL included.
+  uint64_t allocation_count;
+  /// The number of deallocations, of pointers which aren't NULL.
+  uint64_t deallocation_count;
+  /// The number of successful reallocations, of pointers which aren't NULL.
+  uint64_t reallocation_count;
+  /// The number of allocations and reallocations which failed.
+  uint64_t failure_count;
+  /// The sum of the sizes requested by the successful allocations and reallocations.
+  uint64_t total_bytes;
+  /// The number of bytes currently allocated.
+  uint64_t current_bytes;
+  /// The largest number of bytes allocated at once.
+  uint64_t peak_bytes;
+  /// The number of allocations which aren't deallocated yet.
+  uint64_t current_allocation_count;
+  /// The sizes requested by the allocations and reallocations, if the histogram is enabled.
+  uint64_t size_histogram[RCUTILS_TRACKING_ALLOCATOR_HISTOGRAM_SIZE];
+} rcutils_tracking_allocator_statistics_t;
+
+struct rcutils_tracking_allocator_impl_s;
+
+/// A wrapper of an allocator recording statistics about the memory allocated with it.
+/**
+ * The statistics are updated with atomics, so the wrapper is thread-safe if the other
+ * allocator is, and can be used to find the allocations of a code path, or to check that a
+ * code path doesn't allocate, for instance in tests and benchmarks:
+ *
+ * ```c
+ * rcutils_allocator_t default_allocator = rcutils_get_default_allocator();
+ * rcutils_tracking_allocator_t tracking = rcutils_get_zero_initialized_tracking_allocator();
+ * rcutils_ret_t ret = rcutils_tracking_allocator_init(&tracking, &default_allocator, true);
+ * rcutils_allocator_t allocator = rcutils_tracking_allocator_get_allocator(&tracking);
+ * // ... initialize a container with the allocator and warm it up
+ * ret = rcutils_tracking_allocator_reset(&tracking);
+ * // ... run the hot path
+ * rcutils_tracking_allocator_statistics_t statistics;
+ * ret = rcutils_tracking_allocator_get_statistics(&tracking, &statistics);
+ * assert(0 == statistics.allocation_count);
+ * ```
+ *
+ * Each allocation is preceded by a 16 bytes header holding its size, so that deallocating it
+ * updates the statistics.
+ */
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_tracking_allocator_t
+{
+  /// A pointer to the PIMPL implementation type.
+  struct rcutils_tracking_allocator_impl_s * impl;
+} rcutils_tracking_allocator_t;
+
+/// Return an empty tracking allocator struct.
+/**
+ * This function returns an empty and zero initialized tracking allocator struct.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \return an empty and zero initialized tracking allocator struct
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_tracking_allocator_t
+rcutils_get_zero_initialized_tracking_allocator(void);
+
+/// Initialize a tracking allocator.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[inout] tracking the zero initialized tracking allocator to initialize
+ * \param[in] allocator the allocator to record the allocations of
+ * \param[in] size_histogram whether to record the histogram of the requested sizes
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_tracking_allocator_init(
+  rcutils_tracking_allocator_t * tracking,
+  const rcutils_allocator_t * allocator,
+  bool size_histogram);
+
+/// Finalize a tracking allocator.
+/**
+ * The memory allocated with the tracking allocator must be deallocated before.
+ * Calling this on a zero initialized tracking allocator does nothing.
+ *
+ * \param[inout] tracking the tracking allocator to finalize
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_tracking_allocator_fini(rcutils_tracking_allocator_t * tracking);
+
+/// Get the statistics recorded by a tracking allocator.
+/**
+ * The statistics are read one by one, so they may not be consistent with each other while
+ * other threads allocate.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[in] tracking the initialized tracking allocator
+ * \param[out] statistics the recorded statistics
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_INITIALIZED if the tracking allocator is not initialized.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_tracking_allocator_get_statistics(
+  const rcutils_tracking_allocator_t * tracking,
+  rcutils_tracking_allocator_statistics_t * statistics);
+
+/// Reset the statistics recorded by a tracking allocator.
+/**
+ * The counts, the total bytes and the histogram are reset to 0, and the peak bytes to the
+ * current bytes, which are kept along with the current allocation count.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[in] tracking the initialized tracking allocator
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_INITIALIZED if the tracking allocator is not initialized.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_tracking_allocator_reset(const rcutils_tracking_allocator_t * tracking);
+
+/// Return an allocator recording its allocations in a tracking allocator.
+/**
+ * The allocator is valid until the tracking allocator is finalized.
+ * Its memory has the alignment of the memory of the other allocator, up to 16 bytes.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] tracking the initialized tracking allocator
+ * \return the allocator recording its allocations, or
+ * \return a zero initialized allocator if the tracking allocator is NULL or not initialized.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_allocator_t
+rcutils_tracking_allocator_get_allocator(const rcutils_tracking_allocator_t * tracking);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCUTILS__TRACKING_ALLOCATOR_H_
@@ -21,12 +21,23 @@ extern "C"
 #endif
 
 #include "rcutils/types/array_list.h"
+#include "rcutils/types/bitset.h"
 #include "rcutils/types/char_array.h"
+#include "rcutils/types/concurrent_hash_map.h"
+#include "rcutils/types/concurrent_queue.h"
+#include "rcutils/types/frozen_map.h"
 #include "rcutils/types/hash_map.h"
+#include "rcutils/types/histogram.h"
+#include "rcutils/types/iovec_array.h"
+#include "rcutils/types/priority_queue.h"
 #include "rcutils/types/string_array.h"
 #include "rcutils/types/string_map.h"
+#include "rcutils/types/string_view.h"
 #include "rcutils/types/rcutils_ret.h"
+#include "rcutils/types/typed_array_list.h"
+#include "rcutils/types/typed_hash_map.h"
 #include "rcutils/types/uint8_array.h"
+#include "rcutils/types/uint8_ring.h"
 
 #ifdef __cplusplus
 }
@@ -180,6 +180,83 @@ RCUTILS_WARN_UNUSED
 rcutils_ret_t
 rcutils_array_list_add(rcutils_array_list_t * array_list, const void * data);
 
+/// Adds several entries to the list
+/**
+ * This function adds count entries, stored contiguously at data, to the end of the list,
+ * growing the list at most once.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] array_list to add the data to
+ * \param[in] data a pointer to the count entries to add to the list
+ * \param[in] count the number of entries to add, data may be NULL if it is 0
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails, or
+ * \return #RCUTILS_RET_ERROR if an unknown error occurs.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_array_list_add_n(rcutils_array_list_t * array_list, const void * data, size_t count);
+
+/// Adds an uninitialized entry to the list and returns a pointer to it
+/**
+ * This function adds an entry to the end of the list without copying anything into it,
+ * so that the caller can construct the entry in place.
+ * The pointer is valid until the capacity of the list changes.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] array_list to add the entry to
+ * \param[out] data the pointer to the new entry
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails, or
+ * \return #RCUTILS_RET_ERROR if an unknown error occurs.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_array_list_emplace(rcutils_array_list_t * array_list, void ** data);
+
+/// Reserves space for at least the given number of entries in the list
+/**
+ * This function grows the capacity of the list to the given capacity, so that adding
+ * entries up to it doesn't allocate memory. The capacity is never decreased.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] array_list to reserve space in
+ * \param[in] capacity the number of entries the list should be able to hold
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails, or
+ * \return #RCUTILS_RET_ERROR if an unknown error occurs.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_array_list_reserve(rcutils_array_list_t * array_list, size_t capacity);
+
 /// Sets an entry in the list to the provided data
 /**
  * This function sets the provided data at the specified index in the list.
@@ -232,6 +309,32 @@ RCUTILS_WARN_UNUSED
 rcutils_ret_t
 rcutils_array_list_remove(rcutils_array_list_t * array_list, size_t index);
 
+/// Removes an entry in the list by replacing it with the last entry
+/**
+ * This function removes data from the list at the specified index in constant time,
+ * moving the last entry of the list to the index, so it doesn't preserve the order
+ * of the entries. The capacity of the list will never decrease when entries are removed.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] array_list to remove the data from
+ * \param[in] index the index of the item to remove from the list
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if index out of bounds, or
+ * \return #RCUTILS_RET_ERROR if an unknown error occurs.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_array_list_swap_remove(rcutils_array_list_t * array_list, size_t index);
+
 /// Retrieves an entry in the list at the provided index
 /**
  * This function retrieves a copy of the data stored in the list at the provided index.
@@ -257,6 +360,32 @@ RCUTILS_WARN_UNUSED
 rcutils_ret_t
 rcutils_array_list_get(const rcutils_array_list_t * array_list, size_t index, void * data);
 
+/// Retrieves a pointer to an entry in the list at the provided index
+/**
+ * This function retrieves a pointer to the data stored in the list at the provided index,
+ * without copying it. The pointer is valid until the capacity of the list changes or the
+ * entry is removed.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] array_list to get the data from
+ * \param[in] index the index at which to get the data
+ * \param[out] data the pointer to the data stored in the list
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_ERROR if an unknown error occurs.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_array_list_get_ptr(const rcutils_array_list_t * array_list, size_t index, void ** data);
+
 /// Retrieves the size of the provided array_list
 /**
  * This function retrieves the number of items in the provided array list
@@ -281,6 +410,55 @@ RCUTILS_WARN_UNUSED
 rcutils_ret_t
 rcutils_array_list_get_size(const rcutils_array_list_t * array_list, size_t * size);
 
+/// Retrieves the number of bytes the provided array_list allocated
+/**
+ * This function retrieves the number of bytes requested from the allocator of the list,
+ * which includes the unused capacity of the list.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] array_list list to get the memory usage of
+ * \param[out] bytes the number of bytes allocated for the list
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_ERROR if an unknown error occurs.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_array_list_get_memory_usage(const rcutils_array_list_t * array_list, size_t * bytes);
+
+/// Reduces the capacity of the list to its size
+/**
+ * This function releases the unused capacity of the list, for instance after many entries
+ * were removed from it, keeping a capacity of at least 1 entry.
+ * If reallocating fails the list is left unchanged.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] array_list to shrink
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails, or
+ * \return #RCUTILS_RET_ERROR if an unknown error occurs.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_array_list_shrink_to_fit(rcutils_array_list_t * array_list);
+
 #ifdef __cplusplus
 }
 #endif
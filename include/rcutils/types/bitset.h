@@ -0,0 +1,217 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// @file
+
+#ifndef RCUTILS__TYPES__BITSET_H_
+#define RCUTILS__TYPES__BITSET_H_
+
+#if __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "rcutils/allocator.h"
+#include "rcutils/macros.h"
+#include "rcutils/types/rcutils_ret.h"
+#include "rcutils/visibility_control.h"
+
+/// The number of bits in each word of a bitset.
+#define RCUTILS_BITSET_WORD_BITS 64
+
+/// The structure holding the metadata for a bitset.
+/**
+ * The bits are packed in 64 bit words, bit i being bit i % 64 of word i / 64, so that
+ * counting and searching the bits handle 64 of them at once.
+ * The bits of the last word beyond the size are always clear.
+ */
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_bitset_t
+{
+  /// The words holding the bits.
+  uint64_t * words;
+
+  /// The number of bits in the bitset.
+  size_t size;
+
+  /// The number of allocated words.
+  size_t word_capacity;
+
+  /// The allocator used to allocate and free memory for the bitset.
+  rcutils_allocator_t allocator;
+} rcutils_bitset_t;
+
+/// Return a zero initialized bitset struct.
+/**
+ * \return rcutils_bitset_t a zero initialized bitset struct
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_bitset_t
+rcutils_get_zero_initialized_bitset(void);
+
+/// Initialize a zero initialized bitset struct with all its bits clear.
+/**
+ * This function may leak if the bitset struct is already initialized.
+ * If the size is 0, no memory is allocated and the words are NULL.
+ *
+ * \param[inout] bitset a pointer to the to be initialized bitset struct
+ * \param[in] size the number of bits of the bitset
+ * \param[in] allocator the allocator to use for the memory allocation
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCUTILS_RET_BAD_ALLOC if no memory could be allocated correctly
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_bitset_init(
+  rcutils_bitset_t * bitset,
+  size_t size,
+  const rcutils_allocator_t * allocator);
+
+/// Finalize a bitset struct.
+/**
+ * Cleans up and deallocates any resources used in a rcutils_bitset_t.
+ *
+ * \param[inout] bitset pointer to the rcutils_bitset_t to be cleaned up
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if the bitset argument is invalid
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_bitset_fini(rcutils_bitset_t * bitset);
+
+/// Change the number of bits of a bitset.
+/**
+ * The bits added are clear, and the memory is reallocated only when the bitset grows beyond
+ * its word capacity, which then at least doubles.
+ *
+ * \param[inout] bitset pointer to the initialized bitset
+ * \param[in] new_size the new number of bits
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCUTILS_RET_BAD_ALLOC if no memory could be allocated correctly
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_bitset_resize(rcutils_bitset_t * bitset, size_t new_size);
+
+/// Set a bit of a bitset.
+/**
+ * \param[inout] bitset pointer to the initialized bitset
+ * \param[in] index the index of the bit, less than the size
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if any arguments are invalid
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_bitset_set(rcutils_bitset_t * bitset, size_t index);
+
+/// Clear a bit of a bitset.
+/**
+ * \param[inout] bitset pointer to the initialized bitset
+ * \param[in] index the index of the bit, less than the size
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if any arguments are invalid
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_bitset_clear(rcutils_bitset_t * bitset, size_t index);
+
+/// Get whether a bit of a bitset is set.
+/**
+ * \param[in] bitset pointer to the initialized bitset
+ * \param[in] index the index of the bit
+ * \return `true` if the bit is set, or
+ * \return `false` if it's clear, the index isn't less than the size or bitset is NULL.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+bool
+rcutils_bitset_test(const rcutils_bitset_t * bitset, size_t index);
+
+/// Set or clear all the bits of a bitset.
+/**
+ * \param[inout] bitset pointer to the initialized bitset
+ * \param[in] value `true` to set the bits, `false` to clear them
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if any arguments are invalid
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_bitset_assign_all(rcutils_bitset_t * bitset, bool value);
+
+/// Count the bits set in a bitset.
+/**
+ * \param[in] bitset pointer to the initialized bitset
+ * \param[out] count the number of bits set
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if any arguments are invalid
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_bitset_count(const rcutils_bitset_t * bitset, size_t * count);
+
+/// Find the first bit set in a bitset at or after an index.
+/**
+ * The bits set are iterated by starting from 0 and continuing from the index found plus one:
+ *
+ * ```c
+ * size_t index = 0;
+ * while (RCUTILS_RET_OK == rcutils_bitset_find_next_set(&bitset, index, &index)) {
+ *   // ... use index
+ *   ++index;
+ * }
+ * ```
+ *
+ * \param[in] bitset pointer to the initialized bitset
+ * \param[in] start the index to start searching from, may be more than the size
+ * \param[out] index the index of the bit found
+ * \return #RCUTILS_RET_OK if a bit was found, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCUTILS_RET_NOT_FOUND if no bit is set at or after start.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_bitset_find_next_set(const rcutils_bitset_t * bitset, size_t start, size_t * index);
+
+/// Find the first clear bit in a bitset at or after an index.
+/**
+ * \param[in] bitset pointer to the initialized bitset
+ * \param[in] start the index to start searching from, may be more than the size
+ * \param[out] index the index of the bit found
+ * \return #RCUTILS_RET_OK if a bit was found, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCUTILS_RET_NOT_FOUND if no bit is clear at or after start.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_bitset_find_next_clear(const rcutils_bitset_t * bitset, size_t start, size_t * index);
+
+#if __cplusplus
+}
+#endif
+
+#endif  // RCUTILS__TYPES__BITSET_H_
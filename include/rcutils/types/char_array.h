@@ -23,6 +23,7 @@ extern "C"
 #endif
 
 #include <stdarg.h>
+#include <stdint.h>
 
 #include "rcutils/allocator.h"
 #include "rcutils/types/rcutils_ret.h"
@@ -49,8 +50,40 @@ typedef struct RCUTILS_PUBLIC_TYPE rcutils_char_array_t
 
   /// The allocator used to allocate and free the data in the pointer.
   rcutils_allocator_t allocator;
+
+  /// The capacity the buffer may grow up to when expanding as needed, or 0 for no limit.
+  /**
+   * It is set to 0 by rcutils_char_array_init() and may be changed by the user afterwards.
+   */
+  size_t max_capacity;
 } rcutils_char_array_t;
 
+/// Declare a char array named `name` whose buffer of `capacity` characters is on the stack.
+/**
+ * The char array holds an empty string and doesn't own its buffer, so that short strings are
+ * written into it without allocating memory.
+ * When it has to grow, a buffer is allocated with `allocator` and the content is copied into
+ * it, and from then on the char array owns its buffer.
+ * rcutils_char_array_fini() must be called before leaving the scope, in case it did grow.
+ * Only the first character of the stack buffer is initialized.
+ *
+ * ```c
+ * RCUTILS_CHAR_ARRAY_WITH_STACK(message, 256, rcutils_get_default_allocator());
+ * rcutils_ret_t ret = rcutils_char_array_strcat(&message, "hello");
+ * // ...
+ * ret = rcutils_char_array_fini(&message);
+ * ```
+ *
+ * \param name the name of the rcutils_char_array_t variable to declare
+ * \param capacity the capacity of the buffer on the stack, must be a constant at least 1
+ * \param allocator the allocator used if the buffer grows
+ */
+#define RCUTILS_CHAR_ARRAY_WITH_STACK(name, capacity, allocator) \
+  char name ## _stack_buffer[capacity]; \
+  rcutils_char_array_t name = { \
+    (name ## _stack_buffer[0] = '\0', name ## _stack_buffer), false, 1u, \
+    sizeof(name ## _stack_buffer), allocator, 0u}
+
 /// Return a zero initialized char array struct.
 /**
  * \return rcutils_char_array_t a zero initialized char array struct
@@ -114,7 +147,8 @@ rcutils_char_array_fini(rcutils_char_array_t * char_array);
  * content is copied over.
  * Note that if the array doesn't own the current buffer the function just
  * allocates a new block of memory and copies the contents of the old buffer
- * instead of resizing the existing buffer.
+ * instead of resizing the existing buffer, after which the array owns its buffer,
+ * see RCUTILS_CHAR_ARRAY_WITH_STACK().
  *
  * \param[in] char_array pointer to the instance of rcutils_char_array_t which is being resized
  * \param[in] new_size the new size of the internal buffer
@@ -134,11 +168,15 @@ rcutils_char_array_resize(rcutils_char_array_t * char_array, size_t new_size);
  * the internal buffer only when it is not big enough.
  * If the buffer is already big enough for `new_size`, it returns `RCUTILS_RET_OK` without
  * doing anything.
+ * Otherwise the capacity is at least doubled, without exceeding `max_capacity` if it is set,
+ * so that appending to the array repeatedly reallocates the buffer a logarithmic number of
+ * times.
  *
  * \param[inout] char_array pointer to the instance of rcutils_char_array_t which is being resized
- * \param[in] new_size the new size of the internal buffer
+ * \param[in] new_size the minimum size of the internal buffer
  * \return #RCUTILS_RET_OK if successful, or
  * \return #RCUTILS_RET_BAD_ALLOC if memory allocation failed, or
+ * \return #RCUTILS_RET_NOT_ENOUGH_SPACE if new_size exceeds `max_capacity`, or
  * \return #RCUTILS_RET_ERROR if an unexpected error occurs.
  */
 RCUTILS_PUBLIC
@@ -146,6 +184,24 @@ RCUTILS_WARN_UNUSED
 rcutils_ret_t
 rcutils_char_array_expand_as_needed(rcutils_char_array_t * char_array, size_t new_size);
 
+/// Reserve memory for at least the given capacity in the internal buffer of the char array.
+/**
+ * This function expands the internal buffer to exactly `capacity` if it is smaller, so that
+ * writing up to `capacity` characters into the array doesn't allocate memory.
+ * The buffer is never shrunk.
+ *
+ * \param[inout] char_array pointer to the instance of rcutils_char_array_t which is being resized
+ * \param[in] capacity the minimum capacity of the internal buffer
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation failed, or
+ * \return #RCUTILS_RET_NOT_ENOUGH_SPACE if capacity exceeds `max_capacity`, or
+ * \return #RCUTILS_RET_ERROR if an unexpected error occurs.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_char_array_reserve(rcutils_char_array_t * char_array, size_t capacity);
+
 /// Produce output according to format and args.
 /**
  * This function is equivalent to `vsprintf(char_array->buffer, format, args)`
@@ -167,6 +223,46 @@ RCUTILS_WARN_UNUSED
 rcutils_ret_t
 rcutils_char_array_vsprintf(rcutils_char_array_t * char_array, const char * format, va_list args);
 
+/// Append output produced according to format and args to the string in buffer.
+/**
+ * This function is equivalent to rcutils_char_array_vsprintf(), except that the output is
+ * written after the string in buffer instead of replacing it, so that a prefix and a formatted
+ * message can be composed in the same array.
+ * As for rcutils_char_array_append_n(), the length of the string in buffer is taken from
+ * `buffer_length`, and only the tail of the buffer is formatted again if it has to grow.
+ *
+ * \param[inout] char_array pointer to the instance of rcutils_char_array_t which is being
+ * appended to
+ * \param[in] format the format string used by the underlying `vsnprintf`
+ * \param[in] args the `va_list` used by the underlying `vsnprintf`
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation failed, or
+ * \return #RCUTILS_RET_NOT_ENOUGH_SPACE if the buffer would exceed `max_capacity`, or
+ * \return #RCUTILS_RET_ERROR if an unexpected error occurs.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_char_array_vsprintf_append(
+  rcutils_char_array_t * char_array, const char * format, va_list args);
+
+/// Append output produced according to format and args, formatted by rcutils_fast_vsnprintf().
+/**
+ * This function is equivalent to rcutils_char_array_vsprintf_append(), except that the
+ * common conversions are formatted without the C library, see rcutils_fast_vsnprintf().
+ *
+ * \param[inout] char_array pointer to the instance of rcutils_char_array_t which is being
+ * appended to
+ * \param[in] format the format string used by rcutils_fast_vsnprintf()
+ * \param[in] args the `va_list` used by rcutils_fast_vsnprintf()
+ * \return see rcutils_char_array_vsprintf_append()
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_char_array_fast_vsprintf_append(
+  rcutils_char_array_t * char_array, const char * format, va_list args);
+
 /// Append a string (or part of it) to the string in buffer.
 /**
  * This function treats the internal buffer as a string and appends the src string to it.
@@ -239,6 +335,105 @@ RCUTILS_WARN_UNUSED
 rcutils_ret_t
 rcutils_char_array_strcpy(rcutils_char_array_t * char_array, const char * src);
 
+/// Append characters to the string in buffer, knowing its length.
+/**
+ * This function appends the first n characters of src to the string in buffer, followed by
+ * a null byte, growing the buffer as needed.
+ * Unlike rcutils_char_array_strncat(), the length of the string in buffer isn't computed again,
+ * it is taken from `buffer_length`, which includes the terminating null byte, or is 0 for an
+ * empty string.
+ * Together with the other append functions, this allows to build a string in linear time.
+ *
+ * \param[inout] char_array pointer to the instance of rcutils_char_array_t which is being
+ * appended to
+ * \param[in] src the characters to append, which don't need to be null terminated
+ * \param[in] n the number of characters to append
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation failed, or
+ * \return #RCUTILS_RET_NOT_ENOUGH_SPACE if the buffer would exceed `max_capacity`, or
+ * \return #RCUTILS_RET_ERROR if an unexpected error occurs.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_char_array_append_n(rcutils_char_array_t * char_array, const char * src, size_t n);
+
+/// Append a character to the string in buffer.
+/**
+ * This function is equivalent to rcutils_char_array_append_n() with a single character.
+ *
+ * \param[inout] char_array pointer to the instance of rcutils_char_array_t which is being
+ * appended to
+ * \param[in] c the character to append
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation failed, or
+ * \return #RCUTILS_RET_NOT_ENOUGH_SPACE if the buffer would exceed `max_capacity`, or
+ * \return #RCUTILS_RET_ERROR if an unexpected error occurs.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_char_array_append_char(rcutils_char_array_t * char_array, char c);
+
+/// Append the decimal representation of an unsigned integer to the string in buffer.
+/**
+ * The integer is rendered like `"%" PRIu64` without calling `printf`, and appended like
+ * rcutils_char_array_append_n().
+ *
+ * \param[inout] char_array pointer to the instance of rcutils_char_array_t which is being
+ * appended to
+ * \param[in] value the integer to append
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation failed, or
+ * \return #RCUTILS_RET_NOT_ENOUGH_SPACE if the buffer would exceed `max_capacity`, or
+ * \return #RCUTILS_RET_ERROR if an unexpected error occurs.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_char_array_append_u64(rcutils_char_array_t * char_array, uint64_t value);
+
+/// Append the decimal representation of a signed integer to the string in buffer.
+/**
+ * The integer is rendered like `"%" PRId64` without calling `printf`, and appended like
+ * rcutils_char_array_append_n().
+ *
+ * \param[inout] char_array pointer to the instance of rcutils_char_array_t which is being
+ * appended to
+ * \param[in] value the integer to append
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation failed, or
+ * \return #RCUTILS_RET_NOT_ENOUGH_SPACE if the buffer would exceed `max_capacity`, or
+ * \return #RCUTILS_RET_ERROR if an unexpected error occurs.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_char_array_append_i64(rcutils_char_array_t * char_array, int64_t value);
+
+/// Append the fixed point representation of a floating point number to the string in buffer.
+/**
+ * The number is rendered like `"%.*f"` with the given precision, but rounding halfway cases
+ * away from zero, and appended like rcutils_char_array_append_n().
+ * Numbers whose digits don't fit in 64 bits are formatted with `snprintf()` instead, and
+ * infinities and NaNs are rendered as `inf`, `-inf` and `nan`.
+ *
+ * \param[inout] char_array pointer to the instance of rcutils_char_array_t which is being
+ * appended to
+ * \param[in] value the number to append
+ * \param[in] precision the number of digits after the decimal point, at most 9
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if precision is larger than 9, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation failed, or
+ * \return #RCUTILS_RET_NOT_ENOUGH_SPACE if the buffer would exceed `max_capacity`, or
+ * \return #RCUTILS_RET_ERROR if an unexpected error occurs.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_char_array_append_double(
+  rcutils_char_array_t * char_array, double value, unsigned int precision);
+
 #if __cplusplus
 }
 #endif
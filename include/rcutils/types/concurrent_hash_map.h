@@ -0,0 +1,241 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// @file
+
+#ifndef RCUTILS__TYPES__CONCURRENT_HASH_MAP_H_
+#define RCUTILS__TYPES__CONCURRENT_HASH_MAP_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "rcutils/allocator.h"
+#include "rcutils/macros.h"
+#include "rcutils/types/hash_map.h"
+#include "rcutils/types/rcutils_ret.h"
+#include "rcutils/visibility_control.h"
+
+struct rcutils_concurrent_hash_map_impl_s;
+
+/// A hash map which may be read and written by several threads at once.
+/**
+ * The map is meant for entries which are read far more often than they are written.
+ * Reading it never waits for a lock: the entries are copied into slots which aren't modified
+ * once they're visible to readers, so a key is set by adding a new slot and then removing the
+ * slot with the previous value.
+ * The keys are spread over shards by their hash, the writers of each shard being serialized
+ * by a lock, and a shard replacing its slots when growing keeps the old ones until no reader
+ * is left in it.
+ */
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_concurrent_hash_map_t
+{
+  /// A pointer to the PIMPL implementation type.
+  struct rcutils_concurrent_hash_map_impl_s * impl;
+} rcutils_concurrent_hash_map_t;
+
+/// Return an empty concurrent hash map struct.
+/**
+ * This function returns an empty and zero initialized concurrent hash map struct.
+ *
+ * \return an empty and zero initialized concurrent hash map struct
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_concurrent_hash_map_t
+rcutils_get_zero_initialized_concurrent_hash_map(void);
+
+/// Initialize a concurrent hash map, allocating space for the given capacity.
+/**
+ * The arguments are the same as those of rcutils_hash_map_init(), the keys and values
+ * being copied into the map.
+ * The key comparison function is only called with keys which were completely copied.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[inout] hash_map the zero initialized map to initialize
+ * \param[in] initial_capacity the number of entries the map can hold before growing
+ * \param[in] key_size the size (in bytes) of the key used to index the data
+ * \param[in] data_size the size (in bytes) of the data being stored
+ * \param[in] key_hashing_func a function that returns a hashed value for a key
+ * \param[in] key_cmp_func a function used to compare keys
+ * \param[in] allocator the allocator to use through out the lifetime of the map
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_concurrent_hash_map_init(
+  rcutils_concurrent_hash_map_t * hash_map,
+  size_t initial_capacity,
+  size_t key_size,
+  size_t data_size,
+  rcutils_hash_map_key_hasher_t key_hashing_func,
+  rcutils_hash_map_key_cmp_t key_cmp_func,
+  const rcutils_allocator_t * allocator);
+
+/// Finalize a concurrent hash map, deallocating all of its memory.
+/**
+ * No other thread may access the map while, or after, it's finalized.
+ * Calling this on a zero initialized map does nothing.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[inout] hash_map the map to finalize
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_concurrent_hash_map_fini(rcutils_concurrent_hash_map_t * hash_map);
+
+/// Get the number of entries in the concurrent hash map.
+/**
+ * The size may be outdated as soon as it's returned when the map is written concurrently.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[in] hash_map the initialized map
+ * \param[out] size the number of entries in the map
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_INITIALIZED if the map is not initialized.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_concurrent_hash_map_get_size(
+  const rcutils_concurrent_hash_map_t * hash_map, size_t * size);
+
+/// Set a key value pair in the concurrent hash map, replacing the value of an existing key.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes, when the shard of the key grows
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | No
+ *
+ * \param[inout] hash_map the initialized map
+ * \param[in] key the key_size bytes of the key
+ * \param[in] value the data_size bytes of the value
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_INITIALIZED if the map is not initialized, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_concurrent_hash_map_set(
+  rcutils_concurrent_hash_map_t * hash_map, const void * key, const void * value);
+
+/// Unset a key value pair in the concurrent hash map.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | No
+ *
+ * \param[inout] hash_map the initialized map
+ * \param[in] key the key_size bytes of the key
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_INITIALIZED if the map is not initialized, or
+ * \return #RCUTILS_RET_STRING_KEY_NOT_FOUND if the key is not found in the map.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_concurrent_hash_map_unset(rcutils_concurrent_hash_map_t * hash_map, const void * key);
+
+/// Get whether or not a key exists in the concurrent hash map.
+/**
+ * Returns false, without setting an error message, for invalid arguments.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[in] hash_map the initialized map
+ * \param[in] key the key_size bytes of the key
+ * \return `true` if key is in the map, or
+ * \return `false` otherwise.
+ */
+RCUTILS_PUBLIC
+bool
+rcutils_concurrent_hash_map_key_exists(
+  const rcutils_concurrent_hash_map_t * hash_map, const void * key);
+
+/// Copy the value of a key out of the concurrent hash map.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[in] hash_map the initialized map
+ * \param[in] key the key_size bytes of the key
+ * \param[out] data the data_size bytes to copy the value to
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_INITIALIZED if the map is not initialized, or
+ * \return #RCUTILS_RET_NOT_FOUND if the key doesn't exist in the map.
+ */
+RCUTILS_PUBLIC
+rcutils_ret_t
+rcutils_concurrent_hash_map_get(
+  const rcutils_concurrent_hash_map_t * hash_map, const void * key, void * data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCUTILS__TYPES__CONCURRENT_HASH_MAP_H_
@@ -0,0 +1,335 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// @file
+
+#ifndef RCUTILS__TYPES__CONCURRENT_QUEUE_H_
+#define RCUTILS__TYPES__CONCURRENT_QUEUE_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+
+#include "rcutils/allocator.h"
+#include "rcutils/macros.h"
+#include "rcutils/types/rcutils_ret.h"
+#include "rcutils/visibility_control.h"
+
+struct rcutils_spsc_queue_impl_s;
+
+/// A bounded queue handing elements from a single producer thread to a single consumer thread.
+/**
+ * The elements all have the same size and are copied into preallocated slots, so pushing and
+ * popping never allocate memory.
+ * The indexes of the producer and of the consumer are on different cache lines.
+ */
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_spsc_queue_t
+{
+  /// A pointer to the PIMPL implementation type.
+  struct rcutils_spsc_queue_impl_s * impl;
+} rcutils_spsc_queue_t;
+
+struct rcutils_mpsc_queue_impl_s;
+
+/// A bounded queue handing elements from any number of producer threads to a single consumer.
+/**
+ * The elements all have the same size and are copied into preallocated slots, so pushing and
+ * popping never allocate memory.
+ * The producers reserve slots with a compare and swap on a shared index, and each slot has a
+ * sequence number telling the consumer when its element is complete.
+ */
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_mpsc_queue_t
+{
+  /// A pointer to the PIMPL implementation type.
+  struct rcutils_mpsc_queue_impl_s * impl;
+} rcutils_mpsc_queue_t;
+
+/// Return an empty spsc queue struct.
+/**
+ * This function returns an empty and zero initialized spsc queue struct.
+ *
+ * \return an empty and zero initialized spsc queue struct
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_spsc_queue_t
+rcutils_get_zero_initialized_spsc_queue(void);
+
+/// Initialize a spsc queue, allocating its slots.
+/**
+ * The capacity is rounded up to a power of two.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[inout] queue the zero initialized queue to initialize
+ * \param[in] capacity the minimum number of elements the queue can hold, must be more than 0
+ * \param[in] element_size the size of each element in bytes, must be more than 0
+ * \param[in] allocator the allocator to use for the slots and the implementation
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_spsc_queue_init(
+  rcutils_spsc_queue_t * queue,
+  size_t capacity,
+  size_t element_size,
+  const rcutils_allocator_t * allocator);
+
+/// Finalize a spsc queue, dropping its elements and deallocating its slots.
+/**
+ * Calling this on a zero initialized queue does nothing.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] queue the queue to finalize
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_spsc_queue_fini(rcutils_spsc_queue_t * queue);
+
+/// Copy an element to the back of the spsc queue, if it isn't full.
+/**
+ * Only one thread at a time may push to the queue.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes, with a single producer
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[inout] queue the initialized queue
+ * \param[in] element the element_size bytes to copy into the queue
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_ENOUGH_SPACE if the queue is full.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_spsc_queue_try_push(rcutils_spsc_queue_t * queue, const void * element);
+
+/// Copy the element at the front of the spsc queue out of it, if it isn't empty.
+/**
+ * Only one thread at a time may pop from the queue.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes, with a single consumer
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[inout] queue the initialized queue
+ * \param[out] element the element_size bytes to copy the element to
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_QUEUE_EMPTY if the queue is empty.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_spsc_queue_try_pop(rcutils_spsc_queue_t * queue, void * element);
+
+/// Get the number of elements in the spsc queue.
+/**
+ * The size may be outdated as soon as it's returned when the producer or the consumer run
+ * concurrently.
+ *
+ * \param[in] queue the initialized queue
+ * \param[out] size the number of elements in the queue
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_spsc_queue_get_size(const rcutils_spsc_queue_t * queue, size_t * size);
+
+/// Get the number of elements the spsc queue can hold.
+/**
+ * \param[in] queue the initialized queue
+ * \param[out] capacity the capacity of the queue, a power of two
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_spsc_queue_get_capacity(const rcutils_spsc_queue_t * queue, size_t * capacity);
+
+/// Return an empty mpsc queue struct.
+/**
+ * This function returns an empty and zero initialized mpsc queue struct.
+ *
+ * \return an empty and zero initialized mpsc queue struct
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_mpsc_queue_t
+rcutils_get_zero_initialized_mpsc_queue(void);
+
+/// Initialize a mpsc queue, allocating its slots.
+/**
+ * The capacity is rounded up to a power of two.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[inout] queue the zero initialized queue to initialize
+ * \param[in] capacity the minimum number of elements the queue can hold, must be more than 0
+ * \param[in] element_size the size of each element in bytes, must be more than 0
+ * \param[in] allocator the allocator to use for the slots and the implementation
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_mpsc_queue_init(
+  rcutils_mpsc_queue_t * queue,
+  size_t capacity,
+  size_t element_size,
+  const rcutils_allocator_t * allocator);
+
+/// Finalize a mpsc queue, dropping its elements and deallocating its slots.
+/**
+ * Calling this on a zero initialized queue does nothing.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] queue the queue to finalize
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_mpsc_queue_fini(rcutils_mpsc_queue_t * queue);
+
+/// Copy an element to the back of the mpsc queue, if it isn't full.
+/**
+ * Any number of threads may push to the queue concurrently.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[inout] queue the initialized queue
+ * \param[in] element the element_size bytes to copy into the queue
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_ENOUGH_SPACE if the queue is full.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_mpsc_queue_try_push(rcutils_mpsc_queue_t * queue, const void * element);
+
+/// Copy the element at the front of the mpsc queue out of it, if it's complete.
+/**
+ * Only one thread at a time may pop from the queue.
+ * The queue is reported as empty while the producer which reserved the front slot is still
+ * copying its element.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes, with a single consumer
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[inout] queue the initialized queue
+ * \param[out] element the element_size bytes to copy the element to
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_QUEUE_EMPTY if the queue is empty.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_mpsc_queue_try_pop(rcutils_mpsc_queue_t * queue, void * element);
+
+/// Get the number of elements in the mpsc queue, including those still being pushed.
+/**
+ * The size may be outdated as soon as it's returned when the producers or the consumer run
+ * concurrently.
+ *
+ * \param[in] queue the initialized queue
+ * \param[out] size the number of elements in the queue
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_mpsc_queue_get_size(const rcutils_mpsc_queue_t * queue, size_t * size);
+
+/// Get the number of elements the mpsc queue can hold.
+/**
+ * \param[in] queue the initialized queue
+ * \param[out] capacity the capacity of the queue, a power of two
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_mpsc_queue_get_capacity(const rcutils_mpsc_queue_t * queue, size_t * capacity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCUTILS__TYPES__CONCURRENT_QUEUE_H_
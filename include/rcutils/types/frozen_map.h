@@ -0,0 +1,139 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// @file
+
+#ifndef RCUTILS__TYPES__FROZEN_MAP_H_
+#define RCUTILS__TYPES__FROZEN_MAP_H_
+
+#if __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rcutils/allocator.h"
+#include "rcutils/macros.h"
+#include "rcutils/types/rcutils_ret.h"
+#include "rcutils/visibility_control.h"
+
+/// The structure holding the metadata for a frozen map.
+/**
+ * A frozen map finds the index of a string in a fixed set of keys, e.g. the names of the
+ * entries of a static table, with a single probe.
+ * When it's initialized, a seed of the hash function is searched for which gives each key a
+ * slot of its own, in a table of a power of two slots with at least twice as many slots as
+ * keys, so that finding a string hashes it once and compares it with at most one key.
+ * The map doesn't copy the keys, which must outlive it, and can't be changed once built.
+ */
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_frozen_map_t
+{
+  /// The keys, not owned by the map.
+  const char * const * keys;
+
+  /// The number of keys.
+  size_t key_count;
+
+  /// For each slot, the index of its key plus one, or 0 if it has no key.
+  uint32_t * slots;
+
+  /// The number of slots, a power of two.
+  size_t slot_count;
+
+  /// The seed of the hash function which gives each key its own slot.
+  uint32_t seed;
+
+  /// The allocator used to allocate and free memory for the frozen map.
+  rcutils_allocator_t allocator;
+} rcutils_frozen_map_t;
+
+/// Return a zero initialized frozen map struct.
+/**
+ * \return rcutils_frozen_map_t a zero initialized frozen map struct
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_frozen_map_t
+rcutils_get_zero_initialized_frozen_map(void);
+
+/// Build a frozen map of a set of keys.
+/**
+ * This function may leak if the frozen map struct is already initialized.
+ * Building the map costs a few passes over the keys for each seed tried, which for the
+ * tens of keys of typical tables is a handful of microseconds, so it's meant to be done once,
+ * e.g. at initialization, and the map used for many lookups.
+ *
+ * \param[inout] map a pointer to the zero initialized frozen map struct
+ * \param[in] keys the keys, which must be different and outlive the map
+ * \param[in] key_count the number of keys, more than 0
+ * \param[in] allocator the allocator to use for the memory allocation
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if any arguments are invalid, or a key is repeated, or
+ * \return #RCUTILS_RET_BAD_ALLOC if no memory could be allocated correctly, or
+ * \return #RCUTILS_RET_ERROR if no seed giving each key its own slot was found.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_frozen_map_init(
+  rcutils_frozen_map_t * map,
+  const char * const * keys,
+  size_t key_count,
+  const rcutils_allocator_t * allocator);
+
+/// Finalize a frozen map struct.
+/**
+ * \param[inout] map pointer to the rcutils_frozen_map_t to be cleaned up
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if the map argument is invalid
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_frozen_map_fini(rcutils_frozen_map_t * map);
+
+/// Find the index of a string, which needn't be null terminated, in the keys of a frozen map.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] map pointer to the initialized frozen map
+ * \param[in] str the string to find
+ * \param[in] length the number of characters of the string
+ * \param[out] index the index of the key equal to the string
+ * \return #RCUTILS_RET_OK if the string was found, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCUTILS_RET_NOT_FOUND if the string isn't one of the keys.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_frozen_map_findn(
+  const rcutils_frozen_map_t * map,
+  const char * str,
+  size_t length,
+  size_t * index);
+
+#if __cplusplus
+}
+#endif
+
+#endif  // RCUTILS__TYPES__FROZEN_MAP_H_
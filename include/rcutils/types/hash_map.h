@@ -40,6 +40,9 @@ typedef struct RCUTILS_PUBLIC_TYPE rcutils_hash_map_t
 
 /// The function signature for a key hashing function.
 /**
+ * The hash map selects the bucket of a key with the lowest bits of its hash, so these bits
+ * should depend on every part of the key, as with the hashing functions provided below.
+ *
  * \param[in] key The key that needs to be hashed
  * \return A hash value for the provided string
  */
@@ -60,6 +63,69 @@ typedef int (* rcutils_hash_map_key_cmp_t)(
   const void *  // val2
 );
 
+/// The ways a hash map can store its entries, see rcutils_hash_map_options_t.
+typedef enum rcutils_hash_map_backend_t
+{
+  /// Buckets of separately allocated entries, the backend used by rcutils_hash_map_init().
+  RCUTILS_HASH_MAP_BACKEND_CHAINING = 0,
+  /// A single array of slots storing the hash, the key and the value of each entry inline.
+  /**
+   * Each slot also has a control byte holding 7 bits of the hash of its key, and lookups
+   * match the control bytes of 16 slots at once, with SSE2 or NEON instructions where
+   * available.
+   * Setting a new key doesn't allocate memory unless the hash map grows.
+   * The capacity is the number of slots, which is a power of two and at least 16.
+   */
+  RCUTILS_HASH_MAP_BACKEND_OPEN_ADDRESSING = 1,
+} rcutils_hash_map_backend_t;
+
+/// The options of a hash map, see rcutils_hash_map_init_with_options().
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_hash_map_options_t
+{
+  /// The way the hash map stores its entries.
+  rcutils_hash_map_backend_t backend;
+  /// The ratio of the size to the capacity at which the hash map grows.
+  /**
+   * It must be more than 0, and less than 1 with #RCUTILS_HASH_MAP_BACKEND_OPEN_ADDRESSING.
+   */
+  double max_load_factor;
+  /// The factor the capacity is multiplied by when the hash map grows, must be more than 1.
+  /**
+   * With #RCUTILS_HASH_MAP_BACKEND_OPEN_ADDRESSING the capacity is then rounded up to a
+   * power of two.
+   */
+  double growth_factor;
+  /// The number of buckets moved per operation while the hash map grows, or 0.
+  /**
+   * If 0, growing rehashes every entry at once, in the call to rcutils_hash_map_set() which
+   * exceeds the load factor.
+   * Otherwise the old buckets are kept along with the new ones, and each following call to
+   * rcutils_hash_map_set() or rcutils_hash_map_unset() moves the entries of this many old
+   * buckets, bounding the time a single call takes.
+   * Only #RCUTILS_HASH_MAP_BACKEND_CHAINING rehashes incrementally, this must be 0 with
+   * #RCUTILS_HASH_MAP_BACKEND_OPEN_ADDRESSING.
+   */
+  size_t rehash_buckets_per_operation;
+  /// The ratio of the size to the capacity below which removing an entry shrinks the hash map.
+  /**
+   * If 0, the hash map never shrinks by itself, see rcutils_hash_map_shrink_to_fit().
+   * Otherwise it must be less than half of max_load_factor, so that the shrunk hash map isn't
+   * below it, and rcutils_hash_map_unset() shrinks the hash map to the capacity it would have
+   * if it was reserved for its size, incrementally like growing if rehash_buckets_per_operation
+   * isn't 0.
+   */
+  double min_load_factor;
+} rcutils_hash_map_options_t;
+
+/// A position in a hash map, see rcutils_hash_map_iterate().
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_hash_map_iterator_t
+{
+  /// The index of the bucket or slot to continue from, private.
+  size_t map_index;
+  /// The index of the entry to continue from in its bucket, private.
+  size_t bucket_index;
+} rcutils_hash_map_iterator_t;
+
 /**
  * Validates that an rcutils_hash_map_t* points to a valid hash map.
  * \param[in] map A pointer to an rcutils_hash_map_t
@@ -77,11 +143,63 @@ typedef int (* rcutils_hash_map_key_cmp_t)(
 /**
  * A hashing function for a null terminated c string.
  * Should be used when your key is just a pointer to a c-string
+ *
+ * This is the djb2 hash, which hashes a character at a time.
+ * rcutils_hash_map_fast_string_hash_func() is faster and spreads the keys better.
  */
 RCUTILS_PUBLIC
 size_t
 rcutils_hash_map_string_hash_func(const void * key_str);
 
+/// Hash an array of bytes.
+/**
+ * This is a fast hash reading 8 bytes at a time and mixing them with 64 bit multiplications,
+ * similar to wyhash.
+ * The hash of the same bytes may differ between platforms and releases.
+ *
+ * \param[in] data The bytes to hash, may be NULL if size is 0
+ * \param[in] size The number of bytes
+ * \return The hash of the bytes.
+ */
+RCUTILS_PUBLIC
+size_t
+rcutils_hash_map_bytes_hash(const void * data, size_t size);
+
+/// A fast hashing function for a null terminated c string.
+/**
+ * A hashing function for a null terminated c string, hashing its characters with
+ * rcutils_hash_map_bytes_hash().
+ * Should be used with rcutils_hash_map_string_cmp_func() when your key is just a pointer to a
+ * c-string.
+ */
+RCUTILS_PUBLIC
+size_t
+rcutils_hash_map_fast_string_hash_func(const void * key_str);
+
+/// A hashing function for a uint64_t key.
+/**
+ * The key is multiplied by a constant and both halves of the 128 bit product are folded
+ * together, so that every bit of the hash depends on every bit of the key.
+ */
+RCUTILS_PUBLIC
+size_t
+rcutils_hash_map_uint64_hash_func(const void * key);
+
+/// A comparison function for a uint64_t key.
+RCUTILS_PUBLIC
+int
+rcutils_hash_map_uint64_cmp_func(const void * val1, const void * val2);
+
+/// A hashing function for a uint32_t key, see rcutils_hash_map_uint64_hash_func().
+RCUTILS_PUBLIC
+size_t
+rcutils_hash_map_uint32_hash_func(const void * key);
+
+/// A comparison function for a uint32_t key.
+RCUTILS_PUBLIC
+int
+rcutils_hash_map_uint32_cmp_func(const void * val1, const void * val2);
+
 /// A comparison function for a null terminated c string.
 /**
  * A comparison function for a null terminated c string.
@@ -125,6 +243,8 @@ rcutils_get_zero_initialized_hash_map();
 /**
  * This function initializes the rcutils_hash_map_t with a given initial
  * capacity for entries.
+ * The capacity is rounded up to a power of two, so that buckets are selected by masking
+ * the hash of a key.
  * Note this does not allocate space for keys or values in the hash_map, just the
  * arrays of pointers to the keys and values.
  * rcutils_hash_map_set() should still be used when assigning values.
@@ -180,6 +300,67 @@ rcutils_hash_map_init(
   rcutils_hash_map_key_cmp_t key_cmp_func,
   const rcutils_allocator_t * allocator);
 
+/// Return the options used by rcutils_hash_map_init().
+/**
+ * These are #RCUTILS_HASH_MAP_BACKEND_CHAINING, a max_load_factor of 0.75, a
+ * growth_factor of 2 and no incremental rehashing.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \return The default options of a hash map.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_hash_map_options_t
+rcutils_hash_map_get_default_options(void);
+
+/// Initialize a rcutils_hash_map_t with the given options.
+/**
+ * This function behaves like rcutils_hash_map_init(), which uses the options returned by
+ * rcutils_hash_map_get_default_options(), but lets the hash_map store its entries with
+ * another backend and grow at another load factor or by another factor.
+ * The other functions work the same with every backend.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] hash_map rcutils_hash_map_t to be initialized
+ * \param[in] initial_capacity the amount of initial capacity for the hash_map
+ * \param[in] key_size the size (in bytes) of the key used to index the data
+ * \param[in] data_size the size (in bytes) of the data being stored
+ * \param[in] key_hashing_func a function that returns a hashed value for a key
+ * \param[in] key_cmp_func a function used to compare keys
+ * \param[in] options the options of the hash_map
+ * \param[in] allocator the allocator to use through out the lifetime of the hash_map
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails, or
+ * \return #RCUTILS_RET_ERROR if an unknown error occurs.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_hash_map_init_with_options(
+  rcutils_hash_map_t * hash_map,
+  size_t initial_capacity,
+  size_t key_size,
+  size_t data_size,
+  rcutils_hash_map_key_hasher_t key_hashing_func,
+  rcutils_hash_map_key_cmp_t key_cmp_func,
+  const rcutils_hash_map_options_t * options,
+  const rcutils_allocator_t * allocator);
+
 /// Finalize the previously initialized hash_map struct.
 /**
  * This function will free any resources which were created when initializing
@@ -210,7 +391,8 @@ rcutils_hash_map_fini(rcutils_hash_map_t * hash_map);
  * The capacity does not indicate how many key value pairs are stored in the
  * hash_map, the rcutils_hash_map_get_size() function can provide that, nor the
  * maximum number that can be stored without increasing the capacity.
- * The capacity can be set initially with rcutils_hash_map_init().
+ * The capacity can be set initially with rcutils_hash_map_init(), and is rounded up to a
+ * power of two.
  *
  * <hr>
  * Attribute          | Adherence
@@ -258,6 +440,90 @@ RCUTILS_WARN_UNUSED
 rcutils_ret_t
 rcutils_hash_map_get_size(const rcutils_hash_map_t * hash_map, size_t * size);
 
+/// Increase the capacity of the hash_map so that it holds the given number of entries.
+/**
+ * Setting keys doesn't grow the hash_map until its size exceeds the given size, so that
+ * a hash_map which is filled with a known number of entries is only resized once.
+ * The capacity is never decreased.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] hash_map rcutils_hash_map_t to be resized
+ * \param[in] size the number of entries the hash_map must hold without growing
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_INITIALIZED if the hash_map is invalid, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails, or
+ * \return #RCUTILS_RET_ERROR if an unknown error occurs.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_hash_map_reserve(rcutils_hash_map_t * hash_map, size_t size);
+
+/// Decrease the capacity of the hash_map to the one it needs for its entries.
+/**
+ * The capacity becomes the one rcutils_hash_map_reserve() would give an empty hash_map for
+ * its size, if it's less than the current one, so that a hash_map which was filled and then
+ * mostly emptied returns the memory of its buckets or slots.
+ * With #RCUTILS_HASH_MAP_BACKEND_CHAINING, the unused capacity of the buckets is also
+ * released, and with #RCUTILS_HASH_MAP_BACKEND_OPEN_ADDRESSING, the slots of the removed
+ * entries are also freed for the next entries.
+ * An incremental rehash in progress is completed first.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] hash_map rcutils_hash_map_t to be shrunk
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_INITIALIZED if the hash_map is invalid, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails, or
+ * \return #RCUTILS_RET_ERROR if an unknown error occurs.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_hash_map_shrink_to_fit(rcutils_hash_map_t * hash_map);
+
+/// Get the number of bytes the hash_map allocated.
+/**
+ * This is the number of bytes requested from the allocator of the hash_map, including the
+ * unused capacity, and with #RCUTILS_HASH_MAP_BACKEND_CHAINING the buckets and the separately
+ * allocated keys and values of the entries.
+ * It doesn't include the overhead of the allocator itself.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] hash_map rcutils_hash_map_t to be queried
+ * \param[out] bytes the number of bytes allocated for the hash_map
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_INITIALIZED if the hash_map is invalid, or
+ * \return #RCUTILS_RET_ERROR if an unknown error occurs.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_hash_map_get_memory_usage(const rcutils_hash_map_t * hash_map, size_t * bytes);
+
 /// Set a key value pair in the hash_map, increasing capacity if necessary.
 /**
  * If the key already exists in the map then the value is updated to the new value
@@ -289,13 +555,14 @@ rcutils_hash_map_set(rcutils_hash_map_t * hash_map, const void * key, const void
 /// Unset a key value pair in the hash_map.
 /**
  * Unsets the key value pair in the hash_map and frees any internal resources allocated
- * for the entry. This function will never decrease the capacity when removing keys.
+ * for the entry. This function doesn't decrease the capacity when removing keys, unless
+ * the size drops below the min_load_factor of rcutils_hash_map_options_t.
  * If the given key is not found, RCUTILS_RET_STRING_KEY_NOT_FOUND is returned.
  *
  * <hr>
  * Attribute          | Adherence
  * ------------------ | -------------
- * Allocates Memory   | No
+ * Allocates Memory   | Yes
  * Thread-Safe        | No
  * Uses Atomics       | No
  * Lock-Free          | Yes
@@ -365,6 +632,49 @@ RCUTILS_PUBLIC
 rcutils_ret_t
 rcutils_hash_map_get(const rcutils_hash_map_t * hash_map, const void * key, void * data);
 
+/// Get whether or not a key exists, given its characters and their length.
+/**
+ * Identical to rcutils_hash_map_key_exists() but without relying on the key to be a null
+ * terminated c string, so that a rcutils_string_view_t can be looked up without copying it.
+ * The keys of the hash_map must be pointers to c strings, hashed with
+ * rcutils_hash_map_string_hash_func() or rcutils_hash_map_fast_string_hash_func() and compared
+ * with rcutils_hash_map_string_cmp_func(), otherwise `false` is returned.
+ * In all cases no error message is set.
+ *
+ * \param[in] hash_map rcutils_hash_map_t to be searched
+ * \param[in] key the characters of the key, may be NULL if key_length is 0
+ * \param[in] key_length the number of characters of the key
+ * eturn `true` if key is in the hash_map, or
+ * eturn `false` if key is not in the hash_map, or
+ * eturn `false` for invalid arguments, or
+ * eturn `false` if the hash_map is invalid.
+ */
+RCUTILS_PUBLIC
+bool
+rcutils_hash_map_key_existsn(
+  const rcutils_hash_map_t * hash_map, const char * key, size_t key_length);
+
+/// Get value given the characters of a key and their length.
+/**
+ * Identical to rcutils_hash_map_get() but without relying on the key to be a null terminated
+ * c string, with the same requirements on the keys of the hash_map as
+ * rcutils_hash_map_key_existsn().
+ *
+ * \param[in] hash_map rcutils_hash_map_t to be searched
+ * \param[in] key the characters of the key, may be NULL if key_length is 0
+ * \param[in] key_length the number of characters of the key
+ * \param[out] data A copy of the data stored in the map
+ * eturn #RCUTILS_RET_OK if successful, or
+ * eturn #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or if the keys of the hash_map
+ *   aren't c strings, or
+ * eturn #RCUTILS_RET_NOT_INITIALIZED if the hash_map is invalid, or
+ * eturn #RCUTILS_RET_NOT_FOUND if the key doesn't exist in the map.
+ */
+RCUTILS_PUBLIC
+rcutils_ret_t
+rcutils_hash_map_getn(
+  const rcutils_hash_map_t * hash_map, const char * key, size_t key_length, void * data);
+
 /// Get the next key in the hash_map, unless NULL is given, then get the first key.
 /**
  * This function allows you to iteratively get each key/value pair in the hash_map.
@@ -418,6 +728,72 @@ rcutils_hash_map_get_next_key_and_data(
   void * key,
   void * data);
 
+/// Return an iterator at the first entry of any hash_map.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \return An iterator to be given to rcutils_hash_map_iterate().
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_hash_map_iterator_t
+rcutils_hash_map_get_zero_initialized_iterator(void);
+
+/// Get the key and data of the entry at the iterator and advance it to the next entry.
+/**
+ * This function visits each key/value pair in the hash_map like
+ * rcutils_hash_map_get_next_key_and_data(), but the iterator keeps the position in the
+ * hash_map, so the previous key doesn't need to be looked up again and iterating the
+ * whole hash_map is a single sweep over its buckets or slots.
+ *
+ * The order of the keys in the hash_map is arbitrary and if the hash_map is modified
+ * while iterating the behavior is undefined.
+ * If the hash_map is modified then iteration should begin again with an iterator returned by
+ * rcutils_hash_map_get_zero_initialized_iterator().
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * Example:
+ * ```c
+ * printf("entries in the hash_map:\n");
+ * int key = 0, data = 0;
+ * rcutils_hash_map_iterator_t iterator = rcutils_hash_map_get_zero_initialized_iterator();
+ * while (RCUTILS_RET_OK == rcutils_hash_map_iterate(&hash_map, &iterator, &key, &data)) {
+ *   printf("%i: %i\n", key, data);
+ * }
+ * ```
+ *
+ * \param[in] hash_map rcutils_hash_map_t to be queried
+ * \param[inout] iterator The position in the hash_map, advanced past the returned entry
+ * \param[out] key A copy of the key of the entry
+ * \param[out] data A copy of the data of the entry
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_INITIALIZED if the hash_map is invalid, or
+ * \return #RCUTILS_RET_HASH_MAP_NO_MORE_ENTRIES if there is no more data after the iterator, or
+ * \return #RCUTILS_RET_ERROR if an unknown error occurs.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_hash_map_iterate(
+  const rcutils_hash_map_t * hash_map,
+  rcutils_hash_map_iterator_t * iterator,
+  void * key,
+  void * data);
+
 
 #ifdef __cplusplus
 }
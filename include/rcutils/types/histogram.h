@@ -0,0 +1,247 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// @file
+
+#ifndef RCUTILS__TYPES__HISTOGRAM_H_
+#define RCUTILS__TYPES__HISTOGRAM_H_
+
+#if __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rcutils/allocator.h"
+#include "rcutils/macros.h"
+#include "rcutils/types/rcutils_ret.h"
+#include "rcutils/visibility_control.h"
+
+/// The largest number of precision bits of a histogram.
+#define RCUTILS_HISTOGRAM_MAX_PRECISION_BITS 16u
+
+/// The structure holding the metadata for a log-linear histogram of values.
+/**
+ * The values below 2^precision_bits have a bucket each, and each power of two above is
+ * divided into 2^precision_bits buckets of equal width, so that the width of a bucket is at
+ * most 2^-precision_bits of its values, like HdrHistogram.
+ * For instance, 7 precision bits keep the values within 1%, and latencies up to a minute in
+ * nanoseconds take 3808 buckets, 30 KiB.
+ *
+ * The buckets are allocated once, by rcutils_histogram_init(), and the counters are updated
+ * with atomic operations, so that several threads may record values and merge histograms
+ * concurrently without locks.
+ */
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_histogram_t
+{
+  /// The number of values in each bucket, accessed atomically.
+  uint64_t * buckets;
+
+  /// The number of buckets.
+  size_t bucket_count;
+
+  /// The base 2 logarithm of the number of buckets each power of two is divided into.
+  uint32_t precision_bits;
+
+  /// The number of values recorded, accessed atomically.
+  uint64_t count;
+
+  /// The sum of the values recorded, wrapping around on overflow, accessed atomically.
+  uint64_t sum;
+
+  /// The smallest value recorded, or `UINT64_MAX` if there are none, accessed atomically.
+  uint64_t min;
+
+  /// The largest value recorded, or 0 if there are none, accessed atomically.
+  uint64_t max;
+
+  /// The allocator used to allocate and free memory for the histogram.
+  rcutils_allocator_t allocator;
+} rcutils_histogram_t;
+
+/// Return a zero initialized histogram struct.
+/**
+ * \return rcutils_histogram_t a zero initialized histogram struct
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_histogram_t
+rcutils_get_zero_initialized_histogram(void);
+
+/// Initialize a zero initialized histogram struct, with no values.
+/**
+ * This function may leak if the histogram struct is already initialized.
+ * Values larger than the highest trackable value are counted in the last bucket, which is
+ * reported as their largest value.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] histogram a pointer to the to be initialized histogram struct
+ * \param[in] highest_trackable_value the largest value counted in a bucket of its own
+ * \param[in] precision_bits the base 2 logarithm of the number of buckets each power of two
+ *   is divided into, between 1 and #RCUTILS_HISTOGRAM_MAX_PRECISION_BITS
+ * \param[in] allocator the allocator to use for the memory allocation
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCUTILS_RET_BAD_ALLOC if no memory could be allocated correctly
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_histogram_init(
+  rcutils_histogram_t * histogram,
+  uint64_t highest_trackable_value,
+  uint32_t precision_bits,
+  const rcutils_allocator_t * allocator);
+
+/// Finalize a histogram struct.
+/**
+ * Cleans up and deallocates any resources used in a rcutils_histogram_t.
+ *
+ * \param[inout] histogram pointer to the rcutils_histogram_t to be cleaned up
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if the histogram argument is invalid
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_histogram_fini(rcutils_histogram_t * histogram);
+
+/// Record a value in a histogram.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[inout] histogram pointer to the initialized histogram
+ * \param[in] value the value to record
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if any arguments are invalid
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_histogram_record(rcutils_histogram_t * histogram, uint64_t value);
+
+/// Add the values of a histogram to another one with the same buckets.
+/**
+ * The source histogram may be recorded to concurrently, in which case values recorded
+ * meanwhile may be only partly merged, for instance counted but not in their bucket yet.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[inout] histogram pointer to the initialized histogram the values are added to
+ * \param[in] other pointer to the initialized histogram the values are added from, with the
+ *   same number of buckets and precision
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if any arguments are invalid
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_histogram_merge(rcutils_histogram_t * histogram, const rcutils_histogram_t * other);
+
+/// Remove all the values of a histogram.
+/**
+ * Values recorded while the histogram is reset may be partly removed.
+ *
+ * \param[inout] histogram pointer to the initialized histogram
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if any arguments are invalid
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_histogram_reset(rcutils_histogram_t * histogram);
+
+/// Get the value at a percentile of the values of a histogram.
+/**
+ * The value is the largest one of the bucket the percentile falls in, clamped between the
+ * smallest and the largest values recorded, so it's never below the exact percentile and at
+ * most 2^-precision_bits above it.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | Yes
+ * Lock-Free          | Yes
+ *
+ * \param[in] histogram pointer to the initialized histogram
+ * \param[in] percentile the percentile, between 0 and 100, e.g. 99.9
+ * \param[out] value the value at the percentile, or 0 if there are no values
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if any arguments are invalid
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_histogram_get_percentile(
+  const rcutils_histogram_t * histogram, double percentile, uint64_t * value);
+
+/// Get the index of the bucket a value is counted in.
+/**
+ * \param[in] histogram pointer to the initialized histogram
+ * \param[in] value the value
+ * \param[out] index the index of the bucket, less than the number of buckets
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if any arguments are invalid
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_histogram_get_bucket_index(
+  const rcutils_histogram_t * histogram, uint64_t value, size_t * index);
+
+/// Get the smallest value counted in a bucket.
+/**
+ * The bucket counts the values from its lower bound to the lower bound of the next one
+ * excluded, or all the larger values for the last one.
+ *
+ * \param[in] histogram pointer to the initialized histogram
+ * \param[in] index the index of the bucket, less than the number of buckets
+ * \param[out] lower_bound the smallest value of the bucket
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if any arguments are invalid
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_histogram_get_bucket_lower_bound(
+  const rcutils_histogram_t * histogram, size_t index, uint64_t * lower_bound);
+
+#if __cplusplus
+}
+#endif
+
+#endif  // RCUTILS__TYPES__HISTOGRAM_H_
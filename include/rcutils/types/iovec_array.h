@@ -0,0 +1,237 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// @file
+
+#ifndef RCUTILS__TYPES__IOVEC_ARRAY_H_
+#define RCUTILS__TYPES__IOVEC_ARRAY_H_
+
+#if __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rcutils/allocator.h"
+#include "rcutils/macros.h"
+#include "rcutils/types/rcutils_ret.h"
+#include "rcutils/types/uint8_array.h"
+#include "rcutils/visibility_control.h"
+
+/// A segment of bytes of an iovec array.
+/**
+ * It has the layout of `struct iovec`, so that the segments of an array can be passed as they
+ * are to `writev()` or `sendmsg()` on POSIX systems.
+ */
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_iovec_t
+{
+  /// The first byte of the segment.
+  const uint8_t * data;
+  /// The number of bytes of the segment.
+  size_t length;
+} rcutils_iovec_t;
+
+/// A sequence of bytes made of segments which aren't contiguous in memory.
+/**
+ * Unlike rcutils_uint8_array_t, the bytes are gathered as a list of segments, each either a
+ * reference to memory the array borrows, or a copy it owns, so that e.g. a serializer can put
+ * a small header in front of a large payload without copying the payload, and a transport
+ * supporting scatter-gather I/O can send the segments as they are.
+ * rcutils_iovec_array_flatten() copies the bytes into a contiguous buffer for the others.
+ *
+ * The segments are in `segments[0]` to `segments[segment_count - 1]`, and may be read
+ * directly.
+ */
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_iovec_array_t
+{
+  /// The segments, in order.
+  rcutils_iovec_t * segments;
+  /// Whether each segment is a copy owned by the array, rather than a reference.
+  bool * owned;
+  /// The number of segments.
+  size_t segment_count;
+  /// The number of segments there is room for before the arrays are reallocated.
+  size_t segment_capacity;
+  /// The sum of the lengths of the segments.
+  size_t total_length;
+  /// The allocator used for the arrays and the owned segments.
+  rcutils_allocator_t allocator;
+} rcutils_iovec_array_t;
+
+/// Return a zero initialized iovec array struct.
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_iovec_array_t
+rcutils_get_zero_initialized_iovec_array(void);
+
+/// Initialize a zero initialized iovec array struct.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] iovec_array the zero initialized iovec array
+ * \param[in] segment_capacity the number of segments to allocate room for, at least 1
+ * \param[in] allocator the allocator for the segments and the copies
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_iovec_array_init(
+  rcutils_iovec_array_t * iovec_array,
+  size_t segment_capacity,
+  const rcutils_allocator_t * allocator);
+
+/// Free the copies owned by the array and its segments.
+/**
+ * The memory referenced by the segments isn't touched.
+ * Finalizing a zero initialized iovec array does nothing.
+ *
+ * \param[inout] iovec_array the iovec array, zero initialized again
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_iovec_array_fini(rcutils_iovec_array_t * iovec_array);
+
+/// Remove all the segments, freeing the copies but keeping the room for segments.
+/**
+ * \param[inout] iovec_array the initialized iovec array
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_INITIALIZED if the array isn't initialized.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_iovec_array_clear(rcutils_iovec_array_t * iovec_array);
+
+/// Add a reference to bytes after the last segment, without copying them.
+/**
+ * The bytes must stay valid and unchanged as long as they're part of the array.
+ * Adding 0 bytes does nothing.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes, when the room for segments is doubled
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] iovec_array the initialized iovec array
+ * \param[in] data the bytes, may be NULL if length is 0
+ * \param[in] length the number of bytes
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or if the total length would
+ *   overflow, or
+ * \return #RCUTILS_RET_NOT_INITIALIZED if the array isn't initialized, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_iovec_array_append_reference(
+  rcutils_iovec_array_t * iovec_array, const void * data, size_t length);
+
+/// Add a reference to bytes before the first segment, without copying them.
+/**
+ * This behaves like rcutils_iovec_array_append_reference(), but moves the other segments,
+ * so its cost grows with their number.
+ *
+ * \param[inout] iovec_array the initialized iovec array
+ * \param[in] data the bytes, may be NULL if length is 0
+ * \param[in] length the number of bytes
+ * \return see rcutils_iovec_array_append_reference()
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_iovec_array_prepend_reference(
+  rcutils_iovec_array_t * iovec_array, const void * data, size_t length);
+
+/// Add a copy of bytes after the last segment, e.g. of a small header built on the stack.
+/**
+ * The copy is owned by the array, and freed when it's cleared or finalized.
+ *
+ * \param[inout] iovec_array the initialized iovec array
+ * \param[in] data the bytes, may be NULL if length is 0
+ * \param[in] length the number of bytes
+ * \return see rcutils_iovec_array_append_reference()
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_iovec_array_append_copy(
+  rcutils_iovec_array_t * iovec_array, const void * data, size_t length);
+
+/// Add a copy of bytes before the first segment.
+/**
+ * This behaves like rcutils_iovec_array_append_copy(), but moves the other segments like
+ * rcutils_iovec_array_prepend_reference().
+ *
+ * \param[inout] iovec_array the initialized iovec array
+ * \param[in] data the bytes, may be NULL if length is 0
+ * \param[in] length the number of bytes
+ * \return see rcutils_iovec_array_append_reference()
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_iovec_array_prepend_copy(
+  rcutils_iovec_array_t * iovec_array, const void * data, size_t length);
+
+/// Copy the bytes of all the segments into a contiguous uint8 array.
+/**
+ * The uint8 array is resized if its capacity is less than the total length of the iovec
+ * array, and its buffer_length is set to that total length.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes, if the uint8 array is too small
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[in] iovec_array the initialized iovec array
+ * \param[inout] uint8_array the initialized uint8 array the bytes are copied to
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_INITIALIZED if the iovec array isn't initialized, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_iovec_array_flatten(
+  const rcutils_iovec_array_t * iovec_array, rcutils_uint8_array_t * uint8_array);
+
+#if __cplusplus
+}
+#endif
+
+#endif  // RCUTILS__TYPES__IOVEC_ARRAY_H_
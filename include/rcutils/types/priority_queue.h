@@ -0,0 +1,244 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// @file
+
+#ifndef RCUTILS__TYPES__PRIORITY_QUEUE_H_
+#define RCUTILS__TYPES__PRIORITY_QUEUE_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+
+#include "rcutils/allocator.h"
+#include "rcutils/macros.h"
+#include "rcutils/types/rcutils_ret.h"
+#include "rcutils/visibility_control.h"
+
+struct rcutils_priority_queue_impl_s;
+
+/// The structure holding the metadata for a priority queue.
+/**
+ * The priority queue is a 4-ary min-heap of elements of a fixed size, the front element being
+ * the smallest according to the comparison function, as with rcutils_qsort().
+ * Pushing and popping take O(log n) comparisons, peeking is O(1).
+ *
+ * Each element pushed is given a handle, which identifies it until it's popped or removed,
+ * so that it can be updated or removed wherever it is in the heap in O(log n).
+ */
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_priority_queue_t
+{
+  /// A pointer to the PIMPL implementation type.
+  struct rcutils_priority_queue_impl_s * impl;
+} rcutils_priority_queue_t;
+
+/// The handle of an element in a priority queue.
+typedef size_t rcutils_priority_queue_handle_t;
+
+/// Return an empty priority queue struct.
+/**
+ * This function returns an empty and zero initialized priority queue struct.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \return an empty and zero initialized priority queue struct
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_priority_queue_t
+rcutils_get_zero_initialized_priority_queue(void);
+
+/// Initialize a priority queue with a given initial capacity.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * Example:
+ *
+ * ```c
+ * int compare(const void * a, const void * b) {
+ *   int64_t lhs = *(const int64_t *)a, rhs = *(const int64_t *)b;
+ *   return lhs < rhs ? -1 : lhs > rhs;
+ * }
+ *
+ * rcutils_allocator_t allocator = rcutils_get_default_allocator();
+ * rcutils_priority_queue_t queue = rcutils_get_zero_initialized_priority_queue();
+ * rcutils_ret_t ret = rcutils_priority_queue_init(
+ *   &queue, 16, sizeof(int64_t), compare, &allocator);
+ * int64_t deadline = 42;
+ * rcutils_priority_queue_handle_t handle;
+ * ret = rcutils_priority_queue_push(&queue, &deadline, &handle);
+ * // ... the deadline is postponed
+ * deadline = 84;
+ * ret = rcutils_priority_queue_update(&queue, handle, &deadline);
+ * ret = rcutils_priority_queue_pop(&queue, &deadline);
+ * ret = rcutils_priority_queue_fini(&queue);
+ * ```
+ *
+ * \param[inout] queue the zero initialized queue to initialize
+ * \param[in] initial_capacity the number of elements to allocate space for, may be 0
+ * \param[in] element_size the size (in bytes) of the elements, must be more than 0
+ * \param[in] comp the function used to compare two elements
+ * \param[in] allocator to be used to allocate and deallocate memory
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_priority_queue_init(
+  rcutils_priority_queue_t * queue,
+  size_t initial_capacity,
+  size_t element_size,
+  int (* comp)(const void *, const void *),
+  const rcutils_allocator_t * allocator);
+
+/// Finalize a priority queue, deallocating its elements.
+/**
+ * Calling this on a zero initialized queue does nothing.
+ *
+ * \param[inout] queue the queue to finalize
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_priority_queue_fini(rcutils_priority_queue_t * queue);
+
+/// Copy an element into a priority queue.
+/**
+ * The capacity doubles when the queue is full.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes, when the queue is full
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] queue the initialized queue
+ * \param[in] data the element_size bytes of the element
+ * \param[out] handle the handle of the element, may be NULL
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_INITIALIZED if the queue is not initialized, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_priority_queue_push(
+  rcutils_priority_queue_t * queue, const void * data, rcutils_priority_queue_handle_t * handle);
+
+/// Copy the smallest element of a priority queue, without removing it.
+/**
+ * \param[in] queue the initialized queue
+ * \param[out] data the element_size bytes to copy the element to
+ * \param[out] handle the handle of the element, may be NULL
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_INITIALIZED if the queue is not initialized, or
+ * \return #RCUTILS_RET_QUEUE_EMPTY if the queue is empty.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_priority_queue_peek(
+  const rcutils_priority_queue_t * queue, void * data, rcutils_priority_queue_handle_t * handle);
+
+/// Remove the smallest element of a priority queue.
+/**
+ * \param[inout] queue the initialized queue
+ * \param[out] data the element_size bytes to copy the element to, may be NULL
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_INITIALIZED if the queue is not initialized, or
+ * \return #RCUTILS_RET_QUEUE_EMPTY if the queue is empty.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_priority_queue_pop(rcutils_priority_queue_t * queue, void * data);
+
+/// Replace an element of a priority queue, moving it to its new place.
+/**
+ * The new value may compare either less or greater than the previous one, so this implements
+ * both decrease-key and increase-key.
+ * The handle stays the same.
+ *
+ * \param[inout] queue the initialized queue
+ * \param[in] handle the handle of the element, as returned by rcutils_priority_queue_push()
+ * \param[in] data the element_size bytes of the new value
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_INITIALIZED if the queue is not initialized, or
+ * \return #RCUTILS_RET_NOT_FOUND if no element has the handle.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_priority_queue_update(
+  rcutils_priority_queue_t * queue, rcutils_priority_queue_handle_t handle, const void * data);
+
+/// Remove an element of a priority queue, wherever it is.
+/**
+ * \param[inout] queue the initialized queue
+ * \param[in] handle the handle of the element, as returned by rcutils_priority_queue_push()
+ * \param[out] data the element_size bytes to copy the element to, may be NULL
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_INITIALIZED if the queue is not initialized, or
+ * \return #RCUTILS_RET_NOT_FOUND if no element has the handle.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_priority_queue_remove(
+  rcutils_priority_queue_t * queue, rcutils_priority_queue_handle_t handle, void * data);
+
+/// Get the number of elements in a priority queue.
+/**
+ * \param[in] queue the initialized queue
+ * \param[out] size the number of elements
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_INITIALIZED if the queue is not initialized.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_priority_queue_get_size(const rcutils_priority_queue_t * queue, size_t * size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCUTILS__TYPES__PRIORITY_QUEUE_H_
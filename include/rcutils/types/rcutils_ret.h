@@ -58,6 +58,9 @@ typedef int rcutils_ret_t;
 /// There are no more entires beyond the last one in the map
 #define RCUTILS_RET_HASH_MAP_NO_MORE_ENTRIES 50
 
+/// There is no element to pop from the queue
+#define RCUTILS_RET_QUEUE_EMPTY 60
+
 
 #ifdef __cplusplus
 }
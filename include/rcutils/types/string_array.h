@@ -31,6 +31,8 @@ extern "C"
 #include "rcutils/types/rcutils_ret.h"
 #include "rcutils/visibility_control.h"
 
+struct rcutils_string_arena_t;
+
 /// The structure holding the metadata for a string array.
 typedef struct RCUTILS_PUBLIC_TYPE rcutils_string_array_t
 {
@@ -42,6 +44,12 @@ typedef struct RCUTILS_PUBLIC_TYPE rcutils_string_array_t
 
   /// The allocator used to allocate and free memory for the string array.
   rcutils_allocator_t allocator;
+
+  /// Private storage for the strings set by rcutils_string_array_set(), or NULL.
+  /**
+   * It is only set by rcutils_string_array_init_with_arena() and must not be modified.
+   */
+  struct rcutils_string_arena_t * arena;
 } rcutils_string_array_t;
 
 /// Return an empty string array struct.
@@ -103,6 +111,56 @@ rcutils_string_array_init(
   size_t size,
   const rcutils_allocator_t * allocator);
 
+/// Initialize a string array which copies the strings set in it into an arena.
+/**
+ * This function behaves like rcutils_string_array_init(), but the strings set with
+ * rcutils_string_array_set() are copied into chunks of arena_chunk_size bytes owned by the
+ * array, instead of being allocated one by one.
+ * The chunks are deallocated all at once by rcutils_string_array_fini(), so replacing a
+ * string doesn't reclaim the memory of the previous one.
+ * Strings allocated with the allocator may still be put into the array directly.
+ *
+ * \param[inout] string_array object to be initialized
+ * \param[in] size the size the array should be
+ * \param[in] allocator to be used to allocate and deallocate memory
+ * \param[in] arena_chunk_size the size of the chunks of the arena in bytes, or 0 for 4096,
+ *   larger strings get a chunk of their own
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails, or
+ * \return #RCUTILS_RET_ERROR if an unknown error occurs.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_string_array_init_with_arena(
+  rcutils_string_array_t * string_array,
+  size_t size,
+  const rcutils_allocator_t * allocator,
+  size_t arena_chunk_size);
+
+/// Set an entry of a string array to a copy of a string.
+/**
+ * The string is copied into the arena of the array if it was initialized with
+ * rcutils_string_array_init_with_arena(), or else duplicated with its allocator.
+ * The previous string of the entry is deallocated, unless it is in the arena.
+ *
+ * \param[inout] string_array the initialized string array
+ * \param[in] index the index of the entry, must be less than the size of the array
+ * \param[in] str the null terminated string to copy
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails, in which case the entry is
+ *   left unchanged.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_string_array_set(
+  rcutils_string_array_t * string_array,
+  size_t index,
+  const char * str);
+
 /// Finalize a string array, reclaiming all resources.
 /**
  * This function reclaims any memory owned by the string array, including the
@@ -214,6 +272,35 @@ rcutils_string_array_sort(rcutils_string_array_t * string_array)
     rcutils_string_array_sort_compare);
 }
 
+/// Sort a string array according to lexicographical order, character by character.
+/**
+ * This function sorts the entries of a string array like rcutils_string_array_sort(), but
+ * with a multikey quicksort, which partitions the strings on one character at a time, so
+ * that the characters of a prefix shared by many strings are compared once per partition
+ * rather than once per comparison.
+ * This is faster for large arrays of strings with long common prefixes, like fully qualified
+ * names, e.g. `/robot/sensors/...`.
+ *
+ * Empty entries are placed at the end of the array.
+ * The sort doesn't allocate memory, and uses O(log n) stack space.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] string_array object whose elements should be sorted.
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_string_array_sort_multikey(rcutils_string_array_t * string_array);
+
 #ifdef __cplusplus
 }
 #endif
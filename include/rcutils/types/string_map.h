@@ -32,6 +32,10 @@ extern "C"
 struct rcutils_string_map_impl_t;
 
 /// The structure holding the metadata for a string map.
+/**
+ * The keys are looked up through a hash index, so getting, setting and unsetting a key
+ * takes constant time on average, whatever the size of the map.
+ */
 typedef struct RCUTILS_PUBLIC_TYPE rcutils_string_map_t
 {
   /// A pointer to the PIMPL implementation type.
@@ -102,6 +106,36 @@ rcutils_string_map_init(
   size_t initial_capacity,
   rcutils_allocator_t allocator);
 
+/// Initialize a rcutils_string_map_t which copies its keys and values into an arena.
+/**
+ * This function behaves like rcutils_string_map_init(), but the keys and values set in the
+ * map are copied into chunks of arena_chunk_size bytes owned by the map, instead of being
+ * allocated one by one.
+ * The chunks are only deallocated by rcutils_string_map_clear(), which keeps one of them,
+ * and rcutils_string_map_fini(), so unsetting a key or setting a new value for it doesn't
+ * reclaim the memory of the previous strings.
+ * This suits maps which are filled at once, such as parsed arguments or parameters.
+ *
+ * \param[inout] string_map rcutils_string_map_t to be initialized
+ * \param[in] initial_capacity the amount of initial capacity for the string map
+ * \param[in] allocator the allocator to use through out the lifetime of the map
+ * \param[in] arena_chunk_size the size of the chunks of the arena in bytes, or 0 for 4096,
+ *   larger strings get a chunk of their own
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails, or
+ * \return #RCUTILS_RET_STRING_MAP_ALREADY_INIT if already initialized, or
+ * \return #RCUTILS_RET_ERROR if an unknown error occurs.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_string_map_init_with_arena(
+  rcutils_string_map_t * string_map,
+  size_t initial_capacity,
+  rcutils_allocator_t allocator,
+  size_t arena_chunk_size);
+
 /// Finalize the previously initialized string map struct.
 /**
  * This function will free any resources which were created when initializing
@@ -185,6 +219,45 @@ RCUTILS_WARN_UNUSED
 rcutils_ret_t
 rcutils_string_map_reserve(rcutils_string_map_t * string_map, size_t capacity);
 
+/// Reduce the memory of the map to what its key value pairs need.
+/**
+ * Shrinks the capacity of the map to its size, like rcutils_string_map_reserve() with a
+ * capacity of 0 would without removing the key value pairs.
+ * If the map was initialized with rcutils_string_map_init_with_arena(), the keys and values
+ * are also copied into a new arena, so that the memory of the strings of the keys which were
+ * unset, or of the values which were replaced, is reclaimed.
+ *
+ * \param[inout] string_map rcutils_string_map_t to be shrunk
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails, or
+ * \return #RCUTILS_RET_STRING_MAP_INVALID if the string map is invalid, or
+ * \return #RCUTILS_RET_ERROR if an unknown error occurs.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_string_map_shrink_to_fit(rcutils_string_map_t * string_map);
+
+/// Get the number of bytes the string map allocated.
+/**
+ * This is the number of bytes requested from the allocator of the map, for its capacity
+ * and for the copies of the keys and values, including the unused space of its arena if it
+ * has one.
+ * It doesn't include the overhead of the allocator itself.
+ *
+ * \param[in] string_map rcutils_string_map_t to be queried
+ * \param[out] bytes the number of bytes allocated for the string map
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_STRING_MAP_INVALID if the string map is invalid, or
+ * \return #RCUTILS_RET_ERROR if an unknown error occurs.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_string_map_get_memory_usage(const rcutils_string_map_t * string_map, size_t * bytes);
+
 /// Remove all key value pairs from the map.
 /**
  * This function will remove all key value pairs from the map, and it will
@@ -0,0 +1,92 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// @file
+
+#ifndef RCUTILS__TYPES__STRING_VIEW_H_
+#define RCUTILS__TYPES__STRING_VIEW_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "rcutils/macros.h"
+#include "rcutils/visibility_control.h"
+
+/// A range of characters of a string, which isn't owned by the view.
+/**
+ * The characters aren't null terminated, so they must be used with their length, for instance
+ * with the `%.*s` format or the `n` variants of the lookup functions of the maps.
+ * The view is only valid as long as the string it refers to.
+ */
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_string_view_s
+{
+  /// The first character of the view, may be NULL if the length is 0.
+  const char * data;
+  /// The number of characters of the view.
+  size_t length;
+} rcutils_string_view_t;
+
+/// Return an empty string view struct.
+/**
+ * This function returns an empty and zero initialized string view struct.
+ *
+ * \return an empty and zero initialized string view struct
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_string_view_t
+rcutils_get_zero_initialized_string_view(void);
+
+/// Return a view of all the characters of a null terminated string.
+/**
+ * \param[in] str the null terminated string, may be NULL for an empty view
+ * \return a view of the characters of the string before the null terminator
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_string_view_t
+rcutils_string_view_from_cstring(const char * str);
+
+/// Return whether two string views have the same characters.
+/**
+ * \param[in] lhs the first view
+ * \param[in] rhs the second view
+ * \return `true` if the views have the same length and characters, or
+ * \return `false` otherwise.
+ */
+RCUTILS_PUBLIC
+bool
+rcutils_string_view_equal(rcutils_string_view_t lhs, rcutils_string_view_t rhs);
+
+/// Return whether a string view has the same characters as a null terminated string.
+/**
+ * \param[in] view the view
+ * \param[in] str the null terminated string, may be NULL for an empty string
+ * \return `true` if the view and the string have the same characters, or
+ * \return `false` otherwise.
+ */
+RCUTILS_PUBLIC
+bool
+rcutils_string_view_equal_cstring(rcutils_string_view_t view, const char * str);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCUTILS__TYPES__STRING_VIEW_H_
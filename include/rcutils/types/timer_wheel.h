@@ -0,0 +1,307 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// @file
+
+#ifndef RCUTILS__TYPES__TIMER_WHEEL_H_
+#define RCUTILS__TYPES__TIMER_WHEEL_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rcutils/allocator.h"
+#include "rcutils/macros.h"
+#include "rcutils/time.h"
+#include "rcutils/types/rcutils_ret.h"
+#include "rcutils/visibility_control.h"
+
+struct rcutils_timer_wheel_impl_s;
+
+/// The structure holding the metadata for a timer wheel.
+/**
+ * The timer wheel is a hierarchy of 6 wheels of 64 slots, each slot of a wheel spanning all
+ * the slots of the wheel below it, so that timers up to 2^36 ticks away are kept without
+ * sorting them.
+ * Scheduling and cancelling a timer take O(1), advancing the wheel moves the timers down the
+ * hierarchy as their deadline gets closer and calls the callbacks of all those which expired.
+ *
+ * The timers are stored in the rcutils_timer_wheel_timer_t structs given by the caller, so
+ * that the wheel doesn't allocate memory after it's initialized.
+ */
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_timer_wheel_t
+{
+  /// A pointer to the PIMPL implementation type.
+  struct rcutils_timer_wheel_impl_s * impl;
+} rcutils_timer_wheel_t;
+
+struct rcutils_timer_wheel_timer_s;
+
+/// The function called when a timer expires.
+/**
+ * The timer isn't scheduled anymore when its callback is called, so the callback may schedule
+ * it again, as well as schedule or cancel other timers of the wheel.
+ * It must not advance or finalize the wheel.
+ */
+typedef void (* rcutils_timer_wheel_callback_t)(
+  struct rcutils_timer_wheel_timer_s * timer, void * data);
+
+/// A timer which can be scheduled in a timer wheel.
+/**
+ * The members are private to the timer wheel, and the struct must stay at the same address
+ * while the timer is scheduled.
+ */
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_timer_wheel_timer_s
+{
+  /// The next timer in the same slot.
+  struct rcutils_timer_wheel_timer_s * next;
+  /// The previous timer in the same slot, or NULL for the first one.
+  struct rcutils_timer_wheel_timer_s * prev;
+  /// The tick at which the timer expires.
+  uint64_t expiry;
+  /// The index of the slot plus one, or 0 when the timer isn't scheduled.
+  size_t slot;
+  /// The function called when the timer expires.
+  rcutils_timer_wheel_callback_t callback;
+  /// The data given to the callback.
+  void * data;
+} rcutils_timer_wheel_timer_t;
+
+/// Return an empty timer wheel struct.
+/**
+ * This function returns an empty and zero initialized timer wheel struct.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \return an empty and zero initialized timer wheel struct
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_timer_wheel_t
+rcutils_get_zero_initialized_timer_wheel(void);
+
+/// Return a timer struct which isn't scheduled.
+/**
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | Yes
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \return a zero initialized timer struct
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_timer_wheel_timer_t
+rcutils_get_zero_initialized_timer_wheel_timer(void);
+
+/// Initialize a timer wheel.
+/**
+ * The wheel counts the ticks elapsed since start_time, times being those of
+ * rcutils_steady_time_now() unless the caller consistently uses another clock.
+ * A timer expires on the first tick at or after its deadline, so the tick duration bounds
+ * how late it may be reported.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | Yes
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * Example:
+ *
+ * ```c
+ * void on_timeout(rcutils_timer_wheel_timer_t * timer, void * data) {
+ *   // ... handle the timeout of data
+ * }
+ *
+ * rcutils_allocator_t allocator = rcutils_get_default_allocator();
+ * rcutils_timer_wheel_t wheel = rcutils_get_zero_initialized_timer_wheel();
+ * rcutils_time_point_value_t now;
+ * rcutils_ret_t ret = rcutils_steady_time_now(&now);
+ * ret = rcutils_timer_wheel_init(&wheel, RCUTILS_MS_TO_NS(1), now, &allocator);
+ * rcutils_timer_wheel_timer_t timer = rcutils_get_zero_initialized_timer_wheel_timer();
+ * ret = rcutils_timer_wheel_schedule(&wheel, &timer, now + RCUTILS_S_TO_NS(1), on_timeout, NULL);
+ * // ... periodically
+ * size_t expired_count;
+ * ret = rcutils_timer_wheel_poll(&wheel, &expired_count);
+ * // ...
+ * ret = rcutils_timer_wheel_fini(&wheel);
+ * ```
+ *
+ * \param[inout] wheel the zero initialized timer wheel to initialize
+ * \param[in] tick_duration the duration of a tick in nanoseconds, must be more than 0
+ * \param[in] start_time the time of the tick 0
+ * \param[in] allocator to be used to allocate and deallocate memory
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_BAD_ALLOC if memory allocation fails.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_timer_wheel_init(
+  rcutils_timer_wheel_t * wheel,
+  rcutils_duration_value_t tick_duration,
+  rcutils_time_point_value_t start_time,
+  const rcutils_allocator_t * allocator);
+
+/// Finalize a timer wheel.
+/**
+ * The timers still scheduled are unscheduled without calling their callbacks.
+ * Calling this on a zero initialized wheel does nothing.
+ *
+ * \param[inout] wheel the timer wheel to finalize
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_timer_wheel_fini(rcutils_timer_wheel_t * wheel);
+
+/// Schedule a timer to expire at a deadline.
+/**
+ * A deadline which already passed expires on the next advance of the wheel.
+ * Deadlines beyond the range of the wheel are kept in its last wheel until they're in range.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] wheel the initialized timer wheel
+ * \param[inout] timer the timer to schedule, which must not be scheduled already
+ * \param[in] deadline the time at which the timer expires
+ * \param[in] callback the function called when the timer expires
+ * \param[in] data the data given to the callback, may be NULL
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_INITIALIZED if the wheel is not initialized.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_timer_wheel_schedule(
+  rcutils_timer_wheel_t * wheel,
+  rcutils_timer_wheel_timer_t * timer,
+  rcutils_time_point_value_t deadline,
+  rcutils_timer_wheel_callback_t callback,
+  void * data);
+
+/// Cancel a scheduled timer, without calling its callback.
+/**
+ * \param[inout] wheel the initialized timer wheel the timer was scheduled in
+ * \param[inout] timer the timer to cancel
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_INITIALIZED if the wheel is not initialized, or
+ * \return #RCUTILS_RET_NOT_FOUND if the timer isn't scheduled.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_timer_wheel_cancel(rcutils_timer_wheel_t * wheel, rcutils_timer_wheel_timer_t * timer);
+
+/// Return whether a timer is scheduled.
+/**
+ * \param[in] timer the timer
+ * \return true if the timer is scheduled, or
+ * \return false if it isn't or the timer is NULL.
+ */
+RCUTILS_PUBLIC
+bool
+rcutils_timer_wheel_timer_is_scheduled(const rcutils_timer_wheel_timer_t * timer);
+
+/// Advance a timer wheel to a time, calling the callbacks of the timers which expired.
+/**
+ * The callbacks are called once the wheel reached the time, in the order of the ticks at
+ * which the timers expired.
+ * The wheel jumps from a slot which isn't empty to the next one, so the time taken doesn't
+ * depend on the number of ticks without timers.
+ * Times before the current one of the wheel don't move it back.
+ *
+ * <hr>
+ * Attribute          | Adherence
+ * ------------------ | -------------
+ * Allocates Memory   | No
+ * Thread-Safe        | No
+ * Uses Atomics       | No
+ * Lock-Free          | Yes
+ *
+ * \param[inout] wheel the initialized timer wheel
+ * \param[in] now the time to advance the wheel to
+ * \param[out] expired_count the number of timers which expired, may be NULL
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_INITIALIZED if the wheel is not initialized.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_timer_wheel_advance(
+  rcutils_timer_wheel_t * wheel, rcutils_time_point_value_t now, size_t * expired_count);
+
+/// Advance a timer wheel to the current time of rcutils_steady_time_now().
+/**
+ * \see rcutils_timer_wheel_advance()
+ *
+ * \param[inout] wheel the initialized timer wheel
+ * \param[out] expired_count the number of timers which expired, may be NULL
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_INITIALIZED if the wheel is not initialized, or
+ * \return #RCUTILS_RET_ERROR if the current time can't be read.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_timer_wheel_poll(rcutils_timer_wheel_t * wheel, size_t * expired_count);
+
+/// Get the number of timers scheduled in a timer wheel.
+/**
+ * \param[in] wheel the initialized timer wheel
+ * \param[out] size the number of timers scheduled
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT for invalid arguments, or
+ * \return #RCUTILS_RET_NOT_INITIALIZED if the wheel is not initialized.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_timer_wheel_get_size(const rcutils_timer_wheel_t * wheel, size_t * size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // RCUTILS__TYPES__TIMER_WHEEL_H_
@@ -0,0 +1,174 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// @file
+
+#ifndef RCUTILS__TYPES__TYPED_ARRAY_LIST_H_
+#define RCUTILS__TYPES__TYPED_ARRAY_LIST_H_
+
+#include <stddef.h>
+#include <string.h>
+
+#include "rcutils/allocator.h"
+#include "rcutils/error_handling.h"
+#include "rcutils/types/rcutils_ret.h"
+
+/// Define an array list of values of a given type.
+/**
+ * Unlike rcutils_array_list_t, which copies values of a size known at runtime through
+ * `void *`, the list defined is a struct `name ## _t` with a `value_t * data` array, and its
+ * functions are `static inline` and copy values by assignment, so that they compile to the
+ * same code as a hand written array of that type.
+ * The values are in `data[0]` to `data[size - 1]`, which may be read and written directly.
+ *
+ * The macro is used once, at file scope, e.g. in the source file using the list:
+ *
+ * ```c
+ * RCUTILS_DEFINE_ARRAY_LIST(handle_list, rcutils_handle_t)
+ *
+ * handle_list_t list = handle_list_get_zero_initialized();
+ * rcutils_ret_t ret = handle_list_init(&list, 16, &allocator);
+ * ret = handle_list_add(&list, handle);
+ * for (size_t i = 0; i < list.size; ++i) {
+ *   // ... use list.data[i]
+ * }
+ * ret = handle_list_fini(&list);
+ * ```
+ *
+ * The functions defined are, returning the same codes as the ones of rcutils_array_list_t:
+ * - `name ## _t name ## _get_zero_initialized(void)`
+ * - `rcutils_ret_t name ## _init(name ## _t * list, size_t initial_capacity,
+ *   const rcutils_allocator_t * allocator)`, with an initial capacity of at least 1
+ * - `rcutils_ret_t name ## _fini(name ## _t * list)`
+ * - `rcutils_ret_t name ## _reserve(name ## _t * list, size_t capacity)`
+ * - `rcutils_ret_t name ## _add(name ## _t * list, value_t value)`, doubling the capacity
+ *   when the list is full
+ * - `value_t * name ## _get_ptr(const name ## _t * list, size_t index)`, NULL if the index is
+ *   out of bounds
+ * - `rcutils_ret_t name ## _remove(name ## _t * list, size_t index)`, keeping the order
+ * - `rcutils_ret_t name ## _swap_remove(name ## _t * list, size_t index)`, moving the last
+ *   value in place of the removed one
+ *
+ * \param name the prefix of the names of the struct and its functions
+ * \param value_t the type of the values, which must be copyable by assignment
+ */
+#define RCUTILS_DEFINE_ARRAY_LIST(name, value_t) \
+  typedef struct name ## _t \
+  { \
+    value_t * data; \
+    size_t size; \
+    size_t capacity; \
+    rcutils_allocator_t allocator; \
+  } name ## _t; \
+ \
+  static inline name ## _t name ## _get_zero_initialized(void) \
+  { \
+    name ## _t list; \
+    list.data = NULL; \
+    list.size = 0u; \
+    list.capacity = 0u; \
+    list.allocator = rcutils_get_zero_initialized_allocator(); \
+    return list; \
+  } \
+ \
+  static inline rcutils_ret_t name ## _init( \
+    name ## _t * list, size_t initial_capacity, const rcutils_allocator_t * allocator) \
+  { \
+    RCUTILS_CHECK_ARGUMENT_FOR_NULL(list, RCUTILS_RET_INVALID_ARGUMENT); \
+    RCUTILS_CHECK_ALLOCATOR(allocator, return RCUTILS_RET_INVALID_ARGUMENT); \
+    if (1u > initial_capacity) { \
+      RCUTILS_SET_ERROR_MSG("initial_capacity cannot be less than 1"); \
+      return RCUTILS_RET_INVALID_ARGUMENT; \
+    } \
+    list->data = (value_t *)allocator->allocate( \
+      initial_capacity * sizeof(value_t), allocator->state); \
+    RCUTILS_CHECK_FOR_NULL_WITH_MSG( \
+      list->data, "failed to allocate memory for array list", return RCUTILS_RET_BAD_ALLOC); \
+    list->size = 0u; \
+    list->capacity = initial_capacity; \
+    list->allocator = *allocator; \
+    return RCUTILS_RET_OK; \
+  } \
+ \
+  static inline rcutils_ret_t name ## _fini(name ## _t * list) \
+  { \
+    RCUTILS_CHECK_ARGUMENT_FOR_NULL(list, RCUTILS_RET_INVALID_ARGUMENT); \
+    if (NULL != list->data) { \
+      list->allocator.deallocate(list->data, list->allocator.state); \
+    } \
+    *list = name ## _get_zero_initialized(); \
+    return RCUTILS_RET_OK; \
+  } \
+ \
+  static inline rcutils_ret_t name ## _reserve(name ## _t * list, size_t capacity) \
+  { \
+    RCUTILS_CHECK_ARGUMENT_FOR_NULL(list, RCUTILS_RET_INVALID_ARGUMENT); \
+    RCUTILS_CHECK_FOR_NULL_WITH_MSG( \
+      list->data, "array list is not initialized", return RCUTILS_RET_NOT_INITIALIZED); \
+    if (capacity <= list->capacity) { \
+      return RCUTILS_RET_OK; \
+    } \
+    value_t * data = (value_t *)list->allocator.reallocate( \
+      list->data, capacity * sizeof(value_t), list->allocator.state); \
+    RCUTILS_CHECK_FOR_NULL_WITH_MSG( \
+      data, "failed to allocate memory for array list", return RCUTILS_RET_BAD_ALLOC); \
+    list->data = data; \
+    list->capacity = capacity; \
+    return RCUTILS_RET_OK; \
+  } \
+ \
+  static inline rcutils_ret_t name ## _add(name ## _t * list, value_t value) \
+  { \
+    RCUTILS_CHECK_ARGUMENT_FOR_NULL(list, RCUTILS_RET_INVALID_ARGUMENT); \
+    if (list->size == list->capacity) { \
+      rcutils_ret_t reserve_ret = name ## _reserve(list, list->capacity * 2u); \
+      if (RCUTILS_RET_OK != reserve_ret) { \
+        return reserve_ret; \
+      } \
+    } \
+    list->data[list->size++] = value; \
+    return RCUTILS_RET_OK; \
+  } \
+ \
+  static inline value_t * name ## _get_ptr(const name ## _t * list, size_t index) \
+  { \
+    return (NULL != list && index < list->size) ? &list->data[index] : NULL; \
+  } \
+ \
+  static inline rcutils_ret_t name ## _remove(name ## _t * list, size_t index) \
+  { \
+    RCUTILS_CHECK_ARGUMENT_FOR_NULL(list, RCUTILS_RET_INVALID_ARGUMENT); \
+    if (index >= list->size) { \
+      RCUTILS_SET_ERROR_MSG("index is out of bounds of the list"); \
+      return RCUTILS_RET_INVALID_ARGUMENT; \
+    } \
+    memmove( \
+      &list->data[index], &list->data[index + 1u], \
+      (list->size - index - 1u) * sizeof(value_t)); \
+    --list->size; \
+    return RCUTILS_RET_OK; \
+  } \
+ \
+  static inline rcutils_ret_t name ## _swap_remove(name ## _t * list, size_t index) \
+  { \
+    RCUTILS_CHECK_ARGUMENT_FOR_NULL(list, RCUTILS_RET_INVALID_ARGUMENT); \
+    if (index >= list->size) { \
+      RCUTILS_SET_ERROR_MSG("index is out of bounds of the list"); \
+      return RCUTILS_RET_INVALID_ARGUMENT; \
+    } \
+    list->data[index] = list->data[--list->size]; \
+    return RCUTILS_RET_OK; \
+  }
+
+#endif  // RCUTILS__TYPES__TYPED_ARRAY_LIST_H_
@@ -0,0 +1,292 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// @file
+
+#ifndef RCUTILS__TYPES__TYPED_HASH_MAP_H_
+#define RCUTILS__TYPES__TYPED_HASH_MAP_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "rcutils/allocator.h"
+#include "rcutils/error_handling.h"
+#include "rcutils/types/rcutils_ret.h"
+
+/// The smallest number of slots of a typed hash map.
+#define RCUTILS_TYPED_HASH_MAP_MIN_CAPACITY 8u
+
+/// Hash an integer key of a typed hash map, mixing all its bits into the low ones.
+/**
+ * This is the finalizer of MurmurHash3, suitable for integers, handles and pointers
+ * converted to integers, whose low bits are often all zero or sequential.
+ */
+static inline size_t
+rcutils_typed_hash_map_hash_uint64(uint64_t key)
+{
+  key ^= key >> 33;
+  key *= 0xff51afd7ed558ccdull;
+  key ^= key >> 33;
+  key *= 0xc4ceb9fe1a85ec53ull;
+  key ^= key >> 33;
+  return (size_t)key;
+}
+
+/// Hash a pointer key of a typed hash map, see rcutils_typed_hash_map_hash_uint64().
+static inline size_t
+rcutils_typed_hash_map_hash_pointer(const void * key)
+{
+  return rcutils_typed_hash_map_hash_uint64((uint64_t)(uintptr_t)key);
+}
+
+/// Compare keys of a typed hash map with `==`, for integers, enums and pointers.
+#define RCUTILS_TYPED_HASH_MAP_EQUAL(key1, key2) ((key1) == (key2))
+
+/// Define a hash map from keys of a given type to values of a given type.
+/**
+ * Unlike rcutils_hash_map_t, which copies keys and values of sizes known at runtime through
+ * `void *` and calls the hashing and comparison functions through pointers, the map defined
+ * is a struct `name ## _t` and its functions are `static inline`, copy keys and values by
+ * assignment and call `hash` and `eq` directly, so that they're inlined, e.g. for registries
+ * keyed by integers or handles on hot paths.
+ *
+ * The map is an open addressing table of a power of two slots, probed linearly and at most
+ * three quarters full.
+ * Removing a key shifts the following keys of its probe sequence back, so that there are no
+ * tombstones and lookups of absent keys stop at the first empty slot.
+ *
+ * The macro is used once, at file scope, e.g. in the source file using the map:
+ *
+ * ```c
+ * RCUTILS_DEFINE_HASH_MAP(
+ *   handle_map, uint64_t, my_entity_t *,
+ *   rcutils_typed_hash_map_hash_uint64, RCUTILS_TYPED_HASH_MAP_EQUAL)
+ *
+ * handle_map_t map = handle_map_get_zero_initialized();
+ * rcutils_ret_t ret = handle_map_init(&map, 64, &allocator);
+ * ret = handle_map_set(&map, handle, entity);
+ * my_entity_t ** found = handle_map_get_ptr(&map, handle);
+ * ret = handle_map_fini(&map);
+ * ```
+ *
+ * The functions defined are, returning the same codes as the ones of rcutils_hash_map_t:
+ * - `name ## _t name ## _get_zero_initialized(void)`
+ * - `rcutils_ret_t name ## _init(name ## _t * map, size_t initial_capacity,
+ *   const rcutils_allocator_t * allocator)`, rounding the capacity up to a power of two of at
+ *   least #RCUTILS_TYPED_HASH_MAP_MIN_CAPACITY
+ * - `rcutils_ret_t name ## _fini(name ## _t * map)`
+ * - `rcutils_ret_t name ## _reserve(name ## _t * map, size_t size)`, growing the map so that
+ *   `size` keys fit without growing again
+ * - `rcutils_ret_t name ## _set(name ## _t * map, key_t key, value_t value)`
+ * - `value_t * name ## _get_ptr(const name ## _t * map, key_t key)`, NULL if the key isn't in
+ *   the map, valid until the map is changed
+ * - `rcutils_ret_t name ## _get(const name ## _t * map, key_t key, value_t * value)`, returning
+ *   #RCUTILS_RET_NOT_FOUND if the key isn't in the map
+ * - `rcutils_ret_t name ## _unset(name ## _t * map, key_t key)`, returning
+ *   #RCUTILS_RET_NOT_FOUND if the key isn't in the map
+ *
+ * The entries are iterated by looking at the `capacity` slots of `entries` for which `used`
+ * is not 0.
+ *
+ * \param name the prefix of the names of the structs and their functions
+ * \param key_t the type of the keys, which must be copyable by assignment
+ * \param value_t the type of the values, which must be copyable by assignment
+ * \param hash a function or macro taking a key and returning its `size_t` hash
+ * \param eq a function or macro taking two keys and returning whether they're equal
+ */
+#define RCUTILS_DEFINE_HASH_MAP(name, key_t, value_t, hash, eq) \
+  typedef struct name ## _entry_t \
+  { \
+    key_t key; \
+    value_t value; \
+  } name ## _entry_t; \
+ \
+  typedef struct name ## _t \
+  { \
+    name ## _entry_t * entries; \
+    uint8_t * used; \
+    size_t capacity; \
+    size_t size; \
+    rcutils_allocator_t allocator; \
+  } name ## _t; \
+ \
+  static inline name ## _t name ## _get_zero_initialized(void) \
+  { \
+    name ## _t map; \
+    map.entries = NULL; \
+    map.used = NULL; \
+    map.capacity = 0u; \
+    map.size = 0u; \
+    map.allocator = rcutils_get_zero_initialized_allocator(); \
+    return map; \
+  } \
+ \
+  /* Returns the index of the slot of the key, or of the empty slot ending its probe sequence */ \
+  static inline size_t name ## _find_slot(const name ## _t * map, key_t key) \
+  { \
+    size_t mask = map->capacity - 1u; \
+    size_t slot = (size_t)(hash(key)) & mask; \
+    while (map->used[slot] && !(eq(map->entries[slot].key, key))) { \
+      slot = (slot + 1u) & mask; \
+    } \
+    return slot; \
+  } \
+ \
+  /* Allocates the slots, all unused, the entries and the used flags sharing an allocation */ \
+  static inline rcutils_ret_t name ## _allocate_slots( \
+    name ## _t * map, size_t capacity, const rcutils_allocator_t * allocator) \
+  { \
+    name ## _entry_t * entries = (name ## _entry_t *)allocator->allocate( \
+      capacity * (sizeof(name ## _entry_t) + 1u), allocator->state); \
+    RCUTILS_CHECK_FOR_NULL_WITH_MSG( \
+      entries, "failed to allocate memory for hash map", return RCUTILS_RET_BAD_ALLOC); \
+    map->entries = entries; \
+    map->used = (uint8_t *)(entries + capacity); \
+    memset(map->used, 0, capacity); \
+    map->capacity = capacity; \
+    return RCUTILS_RET_OK; \
+  } \
+ \
+  static inline rcutils_ret_t name ## _init( \
+    name ## _t * map, size_t initial_capacity, const rcutils_allocator_t * allocator) \
+  { \
+    RCUTILS_CHECK_ARGUMENT_FOR_NULL(map, RCUTILS_RET_INVALID_ARGUMENT); \
+    RCUTILS_CHECK_ALLOCATOR(allocator, return RCUTILS_RET_INVALID_ARGUMENT); \
+    size_t capacity = RCUTILS_TYPED_HASH_MAP_MIN_CAPACITY; \
+    while (capacity < initial_capacity) { \
+      capacity <<= 1u; \
+    } \
+    rcutils_ret_t allocate_ret = name ## _allocate_slots(map, capacity, allocator); \
+    if (RCUTILS_RET_OK != allocate_ret) { \
+      return allocate_ret; \
+    } \
+    map->size = 0u; \
+    map->allocator = *allocator; \
+    return RCUTILS_RET_OK; \
+  } \
+ \
+  static inline rcutils_ret_t name ## _fini(name ## _t * map) \
+  { \
+    RCUTILS_CHECK_ARGUMENT_FOR_NULL(map, RCUTILS_RET_INVALID_ARGUMENT); \
+    if (NULL != map->entries) { \
+      map->allocator.deallocate(map->entries, map->allocator.state); \
+    } \
+    *map = name ## _get_zero_initialized(); \
+    return RCUTILS_RET_OK; \
+  } \
+ \
+  static inline rcutils_ret_t name ## _reserve(name ## _t * map, size_t size) \
+  { \
+    RCUTILS_CHECK_ARGUMENT_FOR_NULL(map, RCUTILS_RET_INVALID_ARGUMENT); \
+    RCUTILS_CHECK_FOR_NULL_WITH_MSG( \
+      map->entries, "hash map is not initialized", return RCUTILS_RET_NOT_INITIALIZED); \
+    size_t capacity = map->capacity; \
+    while (size * 4u > capacity * 3u) { \
+      capacity <<= 1u; \
+    } \
+    if (capacity == map->capacity) { \
+      return RCUTILS_RET_OK; \
+    } \
+    name ## _t old_map = *map; \
+    rcutils_ret_t allocate_ret = name ## _allocate_slots(map, capacity, &map->allocator); \
+    if (RCUTILS_RET_OK != allocate_ret) { \
+      return allocate_ret; \
+    } \
+    for (size_t i = 0u; i < old_map.capacity; ++i) { \
+      if (old_map.used[i]) { \
+        size_t slot = name ## _find_slot(map, old_map.entries[i].key); \
+        map->entries[slot] = old_map.entries[i]; \
+        map->used[slot] = 1u; \
+      } \
+    } \
+    map->allocator.deallocate(old_map.entries, map->allocator.state); \
+    return RCUTILS_RET_OK; \
+  } \
+ \
+  static inline rcutils_ret_t name ## _set(name ## _t * map, key_t key, value_t value) \
+  { \
+    RCUTILS_CHECK_ARGUMENT_FOR_NULL(map, RCUTILS_RET_INVALID_ARGUMENT); \
+    RCUTILS_CHECK_FOR_NULL_WITH_MSG( \
+      map->entries, "hash map is not initialized", return RCUTILS_RET_NOT_INITIALIZED); \
+    size_t slot = name ## _find_slot(map, key); \
+    if (!map->used[slot]) { \
+      if ((map->size + 1u) * 4u > map->capacity * 3u) { \
+        rcutils_ret_t reserve_ret = name ## _reserve(map, map->size + 1u); \
+        if (RCUTILS_RET_OK != reserve_ret) { \
+          return reserve_ret; \
+        } \
+        slot = name ## _find_slot(map, key); \
+      } \
+      map->entries[slot].key = key; \
+      map->used[slot] = 1u; \
+      ++map->size; \
+    } \
+    map->entries[slot].value = value; \
+    return RCUTILS_RET_OK; \
+  } \
+ \
+  static inline value_t * name ## _get_ptr(const name ## _t * map, key_t key) \
+  { \
+    if (NULL == map || NULL == map->entries) { \
+      return NULL; \
+    } \
+    size_t slot = name ## _find_slot(map, key); \
+    return map->used[slot] ? &map->entries[slot].value : NULL; \
+  } \
+ \
+  static inline rcutils_ret_t name ## _get(const name ## _t * map, key_t key, value_t * value) \
+  { \
+    RCUTILS_CHECK_ARGUMENT_FOR_NULL(map, RCUTILS_RET_INVALID_ARGUMENT); \
+    RCUTILS_CHECK_ARGUMENT_FOR_NULL(value, RCUTILS_RET_INVALID_ARGUMENT); \
+    RCUTILS_CHECK_FOR_NULL_WITH_MSG( \
+      map->entries, "hash map is not initialized", return RCUTILS_RET_NOT_INITIALIZED); \
+    value_t * found = name ## _get_ptr(map, key); \
+    if (NULL == found) { \
+      return RCUTILS_RET_NOT_FOUND; \
+    } \
+    *value = *found; \
+    return RCUTILS_RET_OK; \
+  } \
+ \
+  static inline rcutils_ret_t name ## _unset(name ## _t * map, key_t key) \
+  { \
+    RCUTILS_CHECK_ARGUMENT_FOR_NULL(map, RCUTILS_RET_INVALID_ARGUMENT); \
+    RCUTILS_CHECK_FOR_NULL_WITH_MSG( \
+      map->entries, "hash map is not initialized", return RCUTILS_RET_NOT_INITIALIZED); \
+    size_t mask = map->capacity - 1u; \
+    size_t hole = name ## _find_slot(map, key); \
+    if (!map->used[hole]) { \
+      return RCUTILS_RET_NOT_FOUND; \
+    } \
+    /* Move back the following entries which may not be after the hole in their sequence */ \
+    size_t slot = hole; \
+    for (;;) { \
+      slot = (slot + 1u) & mask; \
+      if (!map->used[slot]) { \
+        break; \
+      } \
+      size_t home = (size_t)(hash(map->entries[slot].key)) & mask; \
+      if (((slot - home) & mask) >= ((slot - hole) & mask)) { \
+        map->entries[hole] = map->entries[slot]; \
+        hole = slot; \
+      } \
+    } \
+    map->used[hole] = 0u; \
+    --map->size; \
+    return RCUTILS_RET_OK; \
+  }
+
+#endif  // RCUTILS__TYPES__TYPED_HASH_MAP_H_
@@ -42,6 +42,9 @@ typedef struct RCUTILS_PUBLIC_TYPE rcutils_uint8_array_t
 
   /// The allocator used to allocate and free memory for the uint8 array.
   rcutils_allocator_t allocator;
+
+  /// The alignment of the buffer in bytes, or 0 if it is allocated without alignment.
+  size_t buffer_alignment;
 } rcutils_uint8_array_t;
 
 /// Return a zero initialized uint8 array struct.
@@ -75,11 +78,36 @@ rcutils_uint8_array_init(
   size_t buffer_capacity,
   const rcutils_allocator_t * allocator);
 
+/// Initialize a zero initialized uint8 array struct with an aligned buffer.
+/**
+ * This behaves like rcutils_uint8_array_init(), but the buffer is allocated with
+ * rcutils_allocator_aligned_allocate(), and stays aligned when it is resized
+ * with rcutils_uint8_array_resize(), for instance to serialize or copy large
+ * messages with SIMD instructions, or to share them with devices.
+ *
+ * \param[inout] uint8_array a pointer to the to be initialized uint8 array struct
+ * \param[in] buffer_capacity the size of the memory to allocate for the byte stream
+ * \param[in] buffer_alignment the alignment of the buffer in bytes, a power of two
+ * \param[in] allocator the allocator to use for the memory allocation
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCUTILS_RET_BAD_ALLOC if no memory could be allocated correctly
+ * \return #RCUTILS_RET_ERROR if an unexpected error occurs.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_uint8_array_init_aligned(
+  rcutils_uint8_array_t * uint8_array,
+  size_t buffer_capacity,
+  size_t buffer_alignment,
+  const rcutils_allocator_t * allocator);
+
 /// Finalize a uint8 array struct.
 /**
  * Cleans up and deallocates any resources used in a rcutils_uint8_array_t.
  * The array passed to this function needs to have been initialized by
- * rcutils_uint8_array_init().
+ * rcutils_uint8_array_init() or rcutils_uint8_array_init_aligned().
  * Passing an uninitialized instance to this function leads to undefined
  * behavior.
  *
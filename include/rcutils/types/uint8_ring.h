@@ -0,0 +1,194 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// @file
+
+#ifndef RCUTILS__TYPES__UINT8_RING_H_
+#define RCUTILS__TYPES__UINT8_RING_H_
+
+#if __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+
+#include "rcutils/allocator.h"
+#include "rcutils/types/rcutils_ret.h"
+#include "rcutils/visibility_control.h"
+
+/// The structure holding the metadata for a fixed capacity ring of bytes.
+/**
+ * The bytes are written at the end of the ring and read from its start, wrapping around the
+ * end of the buffer, so that neither writing nor reading moves the bytes which are stored.
+ * The ring isn't thread-safe.
+ */
+typedef struct RCUTILS_PUBLIC_TYPE rcutils_uint8_ring_t
+{
+  /// The allocated memory for the ring.
+  uint8_t * buffer;
+
+  /// The number of bytes the ring can hold.
+  size_t buffer_capacity;
+
+  /// The offset in the buffer of the first byte to read.
+  size_t read_offset;
+
+  /// The number of bytes stored in the ring.
+  size_t buffer_length;
+
+  /// The allocator used to allocate and free memory for the ring.
+  rcutils_allocator_t allocator;
+} rcutils_uint8_ring_t;
+
+/// Return a zero initialized uint8 ring struct.
+/**
+ * \return rcutils_uint8_ring_t a zero initialized uint8 ring struct
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_uint8_ring_t
+rcutils_get_zero_initialized_uint8_ring(void);
+
+/// Initialize a zero initialized uint8 ring struct.
+/**
+ * This function may leak if the uint8 ring struct is already initialized.
+ *
+ * \param[inout] uint8_ring a pointer to the to be initialized uint8 ring struct
+ * \param[in] buffer_capacity the number of bytes the ring can hold, must be greater than zero
+ * \param[in] allocator the allocator to use for the memory allocation
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCUTILS_RET_BAD_ALLOC if no memory could be allocated correctly
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_uint8_ring_init(
+  rcutils_uint8_ring_t * uint8_ring,
+  size_t buffer_capacity,
+  const rcutils_allocator_t * allocator);
+
+/// Finalize a uint8 ring struct.
+/**
+ * Cleans up and deallocates any resources used in a rcutils_uint8_ring_t.
+ *
+ * \param[in] uint8_ring pointer to the rcutils_uint8_ring_t to be cleaned up
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if the uint8_ring argument is invalid
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_uint8_ring_fini(rcutils_uint8_ring_t * uint8_ring);
+
+/// Copy bytes to the end of the ring.
+/**
+ * Either all the bytes are written, or none if there isn't enough free space for them.
+ *
+ * \param[inout] uint8_ring pointer to the initialized ring
+ * \param[in] data the bytes to write, may be NULL if size is 0
+ * \param[in] size the number of bytes to write
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if any arguments are invalid, or
+ * \return #RCUTILS_RET_NOT_ENOUGH_SPACE if the free space of the ring is less than size.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_uint8_ring_write(rcutils_uint8_ring_t * uint8_ring, const uint8_t * data, size_t size);
+
+/// Copy bytes from the start of the ring, removing them from it.
+/**
+ * \param[inout] uint8_ring pointer to the initialized ring
+ * \param[out] data the buffer to copy the bytes to, may be NULL if size is 0
+ * \param[in] size the maximum number of bytes to read
+ * \param[out] read_size the number of bytes read, which is less than size if the ring held
+ *   fewer bytes
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if any arguments are invalid.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_uint8_ring_read(
+  rcutils_uint8_ring_t * uint8_ring, uint8_t * data, size_t size, size_t * read_size);
+
+/// Get the contiguous free space at the end of the ring, to write bytes in place.
+/**
+ * The span is the free space up to the end of the buffer or the start of the stored bytes,
+ * so it may be smaller than the free space of the ring when it wraps around.
+ * The bytes written into the span are added to the ring by rcutils_uint8_ring_commit_write().
+ *
+ * \param[in] uint8_ring pointer to the initialized ring
+ * \param[out] span the start of the free space
+ * \param[out] size the number of bytes which can be written at span, 0 if the ring is full
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if any arguments are invalid.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_uint8_ring_get_write_span(
+  const rcutils_uint8_ring_t * uint8_ring, uint8_t ** span, size_t * size);
+
+/// Add bytes written into the span of rcutils_uint8_ring_get_write_span() to the ring.
+/**
+ * \param[inout] uint8_ring pointer to the initialized ring
+ * \param[in] size the number of bytes written, at most the size of the span
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if any arguments are invalid or size is larger
+ *   than the span.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_uint8_ring_commit_write(rcutils_uint8_ring_t * uint8_ring, size_t size);
+
+/// Get the contiguous bytes at the start of the ring, to read them in place.
+/**
+ * The span ends at the end of the buffer or of the stored bytes, so it may hold fewer bytes
+ * than the ring when they wrap around.
+ * The bytes are removed from the ring by rcutils_uint8_ring_consume().
+ *
+ * \param[in] uint8_ring pointer to the initialized ring
+ * \param[out] span the first byte to read
+ * \param[out] size the number of bytes which can be read at span, 0 if the ring is empty
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if any arguments are invalid.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_uint8_ring_get_read_span(
+  const rcutils_uint8_ring_t * uint8_ring, const uint8_t ** span, size_t * size);
+
+/// Remove bytes from the start of the ring without copying them.
+/**
+ * \param[inout] uint8_ring pointer to the initialized ring
+ * \param[in] size the number of bytes to remove, at most the number of bytes in the ring
+ * \return #RCUTILS_RET_OK if successful, or
+ * \return #RCUTILS_RET_INVALID_ARGUMENT if any arguments are invalid or size is larger
+ *   than the number of bytes in the ring.
+ */
+RCUTILS_PUBLIC
+RCUTILS_WARN_UNUSED
+rcutils_ret_t
+rcutils_uint8_ring_consume(rcutils_uint8_ring_t * uint8_ring, size_t size);
+
+#if __cplusplus
+}
+#endif
+
+#endif  // RCUTILS__TYPES__UINT8_RING_H_
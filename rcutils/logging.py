@@ -27,6 +27,8 @@ name_params = OrderedDict((
 ))
 name_args = {'name': 'name'}
 name_doc_lines = []
+cached_doc_lines = [
+    'The logger is looked up once per call site, so the name must not change between calls.']
 once_args = {
     'condition_before': 'RCUTILS_LOG_CONDITION_ONCE_BEFORE',
     'condition_after': 'RCUTILS_LOG_CONDITION_ONCE_AFTER'}
@@ -65,6 +67,18 @@ throttle_doc_lines = [
     'Log calls are being ignored if the last logged message is not longer ago than the specified '
     'duration.']
 
+coarse_throttle_params = OrderedDict((
+    ('duration', 'The duration of the throttle interval in milliseconds'),
+))
+coarse_throttle_args = {
+    'condition_before': 'RCUTILS_LOG_CONDITION_COARSE_THROTTLE_BEFORE(duration)',
+    'condition_after': 'RCUTILS_LOG_CONDITION_COARSE_THROTTLE_AFTER'}
+coarse_throttle_doc_lines = [
+    'Log calls are being ignored if the last logged message is not longer ago than the specified '
+    'duration, measured with the coarse steady clock.',
+    'The check is thread-safe and cheap when ignoring calls, but the duration is only as precise '
+    'as the resolution of the clock.']
+
 
 def get_suffix_from_features(features):
     # Build up the suffix in a particular order
@@ -77,8 +91,12 @@ def get_suffix_from_features(features):
         suffix += '_SKIPFIRST'
     if 'throttle' in features:
         suffix += '_THROTTLE'
+    if 'coarse_throttle' in features:
+        suffix += '_COARSE_THROTTLE'
     if 'once' in features:
         suffix += '_ONCE'
+    if 'cached' in features:
+        suffix += '_CACHED'
     if 'named' in features:
         suffix += '_NAMED'
 
@@ -169,9 +187,55 @@ feature_combinations = OrderedDict((
             }, **name_args
         },
         doc_lines=skipfirst_doc_lines + throttle_doc_lines + name_doc_lines)),
+    (('coarse_throttle', ), Feature(
+        params=coarse_throttle_params,
+        args=coarse_throttle_args,
+        doc_lines=coarse_throttle_doc_lines)),
+    (('skip_first', 'coarse_throttle'), Feature(
+        params=coarse_throttle_params,
+        args={
+            'condition_before': ' '.join([
+                coarse_throttle_args['condition_before'],
+                skipfirst_args['condition_before']]),
+            'condition_after': ' '.join([
+                coarse_throttle_args['condition_after'], skipfirst_args['condition_after']]),
+        },
+        doc_lines=skipfirst_doc_lines + coarse_throttle_doc_lines)),
+    (('coarse_throttle', 'named'), Feature(
+        params=OrderedDict((*coarse_throttle_params.items(), *name_params.items())),
+        args={**coarse_throttle_args, **name_args},
+        doc_lines=coarse_throttle_doc_lines + name_doc_lines)),
+    (('skip_first', 'coarse_throttle', 'named'), Feature(
+        params=OrderedDict((*coarse_throttle_params.items(), *name_params.items())),
+        args={
+            **{
+                'condition_before': ' '.join([
+                    coarse_throttle_args['condition_before'],
+                    skipfirst_args['condition_before']]),
+                'condition_after': ' '.join([
+                    coarse_throttle_args['condition_after'],
+                    skipfirst_args['condition_after']]),
+            }, **name_args
+        },
+        doc_lines=skipfirst_doc_lines + coarse_throttle_doc_lines + name_doc_lines)),
 ))
 
 
+# Every named feature combination has a cached variant keeping a handle to the logger.
+for _features, _feature in list(feature_combinations.items()):
+    if 'named' in _features:
+        feature_combinations[_features[:-1] + ('cached', 'named')] = Feature(
+            params=_feature.params,
+            args=_feature.args,
+            doc_lines=_feature.doc_lines + cached_doc_lines)
+
+
+def get_macro_name(feature_combination):
+    if 'cached' in feature_combination:
+        return 'RCUTILS_LOG_COND_CACHED_NAMED'
+    return 'RCUTILS_LOG_COND_NAMED'
+
+
 def get_macro_parameters(feature_combination):
     return feature_combinations[feature_combination].params
 
@@ -23,6 +23,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #ifdef __cplusplus
 extern "C"
@@ -47,7 +48,60 @@ extern "C"
 #define RCUTILS_LOG_MIN_SEVERITY RCUTILS_LOG_MIN_SEVERITY_DEBUG
 #endif
 
-// TODO(dhood): optimise severity check via notifyLoggerLevelsChanged concept or similar.
+/**
+ * \def RCUTILS_LOG_LOCAL_MIN_SEVERITY
+ * Define RCUTILS_LOG_LOCAL_MIN_SEVERITY=RCUTILS_LOG_MIN_SEVERITY_[DEBUG|INFO|WARN|ERROR|FATAL|NONE]
+ * in the build options of a package, or before including this header in a translation unit,
+ * to compile out anything below that severity there instead of RCUTILS_LOG_MIN_SEVERITY.
+ * This allows e.g. keeping the DEBUG messages of a package in a release build which strips
+ * them from all others with RCUTILS_LOG_MIN_SEVERITY.
+ */
+#ifndef RCUTILS_LOG_LOCAL_MIN_SEVERITY
+#define RCUTILS_LOG_LOCAL_MIN_SEVERITY RCUTILS_LOG_MIN_SEVERITY
+#endif
+
+/**
+ * \def RCUTILS_LOG_NAME_PREFIX
+ * \def RCUTILS_LOG_NAME_PREFIX_MIN_SEVERITY
+ * Define RCUTILS_LOG_NAME_PREFIX="prefix" together with
+ * RCUTILS_LOG_NAME_PREFIX_MIN_SEVERITY=RCUTILS_LOG_MIN_SEVERITY_[DEBUG|INFO|WARN|ERROR|FATAL|NONE]
+ * to compile out anything below that severity logged by named loggers whose name starts with
+ * the prefix, e.g. "third_party.".
+ *
+ * The name is compared with the prefix in the condition of the logging macro, which the
+ * compiler evaluates at compile time for string literal names when optimizing, removing the
+ * call and its format string.
+ * Other names are compared when the macro is executed, in which case the name expression is
+ * evaluated once more.
+ */
+#if defined(RCUTILS_LOG_NAME_PREFIX) && defined(RCUTILS_LOG_NAME_PREFIX_MIN_SEVERITY)
+/// Whether a logger name starts with RCUTILS_LOG_NAME_PREFIX, false for nameless loggers.
+static inline bool rcutils_log_name_has_prefix(const char * name)
+{
+  return NULL != name &&
+         0 == strncmp(name, RCUTILS_LOG_NAME_PREFIX, sizeof(RCUTILS_LOG_NAME_PREFIX) - 1u);
+}
+// The severity levels are 10 for DEBUG up to 50 for FATAL, the minimum severities 0 to 4.
+# define RCUTILS_LOG_NAME_PREFIX_IS_ENABLED(severity, name) \
+  ((severity) / 10 - 1 >= RCUTILS_LOG_NAME_PREFIX_MIN_SEVERITY || \
+  !rcutils_log_name_has_prefix(name))
+#else
+# define RCUTILS_LOG_NAME_PREFIX_IS_ENABLED(severity, name) 1
+#endif
+
+/**
+ * \def RCUTILS_LOG_SEVERITY_MAY_BE_ENABLED
+ * Whether any logger may be enabled for the severity, checked inline before the logger.
+ *
+ * Messages below the level of every logger, e.g. DEBUG ones in production, are skipped with
+ * a load and a branch, see g_rcutils_logging_lowest_enabled_severity.
+ * The default level is checked as well before skipping, as it may have been written directly.
+ */
+#define RCUTILS_LOG_SEVERITY_MAY_BE_ENABLED(severity) \
+  (!RCUTILS_UNLIKELY( \
+    (severity) < RCUTILS_LOGGING_LOAD_LEVEL(g_rcutils_logging_lowest_enabled_severity) && \
+    (severity) < RCUTILS_LOGGING_LOAD_LEVEL(g_rcutils_logging_default_logger_level)))
+
 // The RCUTILS_LOG_COND_NAMED macro is surrounded by do { .. } while (0) to implement
 // the standard C macro idiom to make the macro safe in all contexts; see
 // http://c-faq.com/cpp/multistmt.html for more information.
@@ -67,7 +121,43 @@ extern "C"
   do { \
     RCUTILS_LOGGING_AUTOINIT; \
     static rcutils_log_location_t __rcutils_logging_location = {__func__, __FILE__, __LINE__}; \
-    if (rcutils_logging_logger_is_enabled_for(name, severity)) { \
+    if (RCUTILS_LOG_SEVERITY_MAY_BE_ENABLED(severity) && \
+      RCUTILS_LOG_NAME_PREFIX_IS_ENABLED(severity, name) && \
+      rcutils_logging_logger_is_enabled_for(name, severity)) \
+    { \
+      condition_before \
+      rcutils_log(&__rcutils_logging_location, severity, name, __VA_ARGS__); \
+      condition_after \
+    } \
+  } while (0)
+
+/**
+ * \def RCUTILS_LOG_COND_CACHED_NAMED
+ * The logging macro all cached logging macros call directly or indirectly.
+ *
+ * Unlike RCUTILS_LOG_COND_NAMED(), the logger is looked up only once per call
+ * site and kept in a static handle shared by the threads logging there, see
+ * rcutils_logging_cached_logger_is_enabled_for().
+ * The name should not change between calls (e.g. a string literal), other names
+ * than the first one are looked up for each call.
+ *
+ * \note The condition will only be evaluated if this logging statement is enabled.
+ *
+ * \param[in] severity The severity level
+ * \param[in] condition_before The condition macro(s) inserted before the log call
+ * \param[in] condition_after The condition macro(s) inserted after the log call
+ * \param[in] name The name of the logger
+ * \param[in] ... The format string, followed by the variable arguments for the format string
+ */
+#define RCUTILS_LOG_COND_CACHED_NAMED(severity, condition_before, condition_after, name, ...) \
+  do { \
+    RCUTILS_LOGGING_AUTOINIT; \
+    static rcutils_log_location_t __rcutils_logging_location = {__func__, __FILE__, __LINE__}; \
+    static rcutils_logger_t __rcutils_logging_logger = {NULL, 0u}; \
+    if (RCUTILS_LOG_SEVERITY_MAY_BE_ENABLED(severity) && \
+      RCUTILS_LOG_NAME_PREFIX_IS_ENABLED(severity, name) && \
+      rcutils_logging_cached_logger_is_enabled_for(&__rcutils_logging_logger, name, severity)) \
+    { \
       condition_before \
       rcutils_log(&__rcutils_logging_location, severity, name, __VA_ARGS__); \
       condition_after \
@@ -198,11 +288,34 @@ typedef bool (* RclLogFilter)();
 }
 ///@@}
 
+/** @@name Macros for the `coarse_throttle` condition which ignores log calls if
+ * the last logged message is not longer ago than the specified duration, measured
+ * with rcutils_coarse_steady_time_now().
+ */
+///@@{
+/**
+ * \def RCUTILS_LOG_CONDITION_COARSE_THROTTLE_BEFORE
+ * A macro initializing and checking the `coarse_throttle` condition.
+ */
+#define RCUTILS_LOG_CONDITION_COARSE_THROTTLE_BEFORE(duration) { \
+    static rcutils_logging_throttle_t __rcutils_logging_throttle = {0u}; \
+    if (rcutils_logging_throttle_check( \
+        &__rcutils_logging_throttle, RCUTILS_MS_TO_NS((rcutils_duration_value_t)duration))) {
+
+/**
+ * \def RCUTILS_LOG_CONDITION_COARSE_THROTTLE_AFTER
+ * A macro finalizing the `coarse_throttle` condition.
+ */
+#define RCUTILS_LOG_CONDITION_COARSE_THROTTLE_AFTER } \
+}
+///@@}
+
 @{
 import sys
 sys.path.insert(0, rcutils_module_path)
 from rcutils.logging import feature_combinations
 from rcutils.logging import get_macro_arguments
+from rcutils.logging import get_macro_name
 from rcutils.logging import get_macro_parameters
 from rcutils.logging import get_suffix_from_features
 from rcutils.logging import severities
@@ -211,11 +324,11 @@ from rcutils.logging import severities
 /** @@name Logging macros for severity @(severity).
  */
 ///@@{
-#if (RCUTILS_LOG_MIN_SEVERITY > RCUTILS_LOG_MIN_SEVERITY_@(severity))
+#if (RCUTILS_LOG_LOCAL_MIN_SEVERITY > RCUTILS_LOG_MIN_SEVERITY_@(severity))
 // empty logging macros for severity @(severity) when being disabled at compile time
 @[ for feature_combination in feature_combinations]@
 @{suffix = get_suffix_from_features(feature_combination)}@
-/// Empty logging macro due to the preprocessor definition of RCUTILS_LOG_MIN_SEVERITY.
+/// Empty logging macro due to the preprocessor definition of RCUTILS_LOG_LOCAL_MIN_SEVERITY.
 # define RCUTILS_LOG_@(severity)@(suffix)(@(''.join([p + ', ' for p in get_macro_parameters(feature_combination).keys()]))format, ...)
 @[ end for]@
 
@@ -242,7 +355,7 @@ from rcutils.logging import severities
  * \param[in] ... The format string, followed by the variable arguments for the format string
  */
 # define RCUTILS_LOG_@(severity)@(suffix)(@(''.join([p + ', ' for p in get_macro_parameters(feature_combination).keys()]))...) \
-  RCUTILS_LOG_COND_NAMED( \
+  @(get_macro_name(feature_combination))( \
     RCUTILS_LOG_SEVERITY_@(severity), \
     @(''.join([str(a) + ', ' for a in get_macro_arguments(feature_combination)]))\
     __VA_ARGS__)
@@ -12,8 +12,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
 
 #include "rcutils/allocator.h"
 
@@ -62,6 +66,38 @@ __default_zero_allocate(size_t number_of_elements, size_t size_of_element, void
   return calloc(number_of_elements, size_of_element);
 }
 
+static void *
+__default_aligned_allocate(size_t alignment, size_t size, void * state)
+{
+  RCUTILS_CAN_RETURN_WITH_ERROR_OF(NULL);
+
+  RCUTILS_UNUSED(state);
+  if (alignment < sizeof(void *)) {
+    alignment = sizeof(void *);
+  }
+  if (size > SIZE_MAX - alignment) {
+    return NULL;
+  }
+  // aligned_alloc() wants a size which is a non zero multiple of the alignment
+  size = 0u == size ? alignment : (size + alignment - 1) & ~(alignment - 1);
+#ifdef _WIN32
+  return _aligned_malloc(size, alignment);
+#else
+  return aligned_alloc(alignment, size);
+#endif
+}
+
+static void
+__default_aligned_deallocate(void * pointer, void * state)
+{
+  RCUTILS_UNUSED(state);
+#ifdef _WIN32
+  _aligned_free(pointer);
+#else
+  free(pointer);
+#endif
+}
+
 rcutils_allocator_t
 rcutils_get_zero_initialized_allocator(void)
 {
@@ -71,6 +107,8 @@ rcutils_get_zero_initialized_allocator(void)
     .reallocate = NULL,
     .zero_allocate = NULL,
     .state = NULL,
+    .aligned_allocate = NULL,
+    .aligned_deallocate = NULL,
   };
   return zero_allocator;
 }
@@ -84,6 +122,8 @@ rcutils_get_default_allocator()
     .reallocate = __default_reallocate,
     .zero_allocate = __default_zero_allocate,
     .state = NULL,
+    .aligned_allocate = __default_aligned_allocate,
+    .aligned_deallocate = __default_aligned_deallocate,
   };
   return default_allocator;
 }
@@ -121,3 +161,53 @@ rcutils_reallocf(void * pointer, size_t size, rcutils_allocator_t * allocator)
   }
   return new_pointer;
 }
+
+static bool
+__has_aligned_functions(const rcutils_allocator_t * allocator)
+{
+  return NULL != allocator->aligned_allocate && NULL != allocator->aligned_deallocate;
+}
+
+void *
+rcutils_allocator_aligned_allocate(
+  const rcutils_allocator_t * allocator,
+  size_t alignment,
+  size_t size)
+{
+  RCUTILS_CHECK_ALLOCATOR_WITH_MSG(allocator, "invalid allocator", return NULL);
+  if (0u == alignment || 0u != (alignment & (alignment - 1u))) {
+    RCUTILS_SET_ERROR_MSG("alignment must be a power of two");
+    return NULL;
+  }
+  if (__has_aligned_functions(allocator)) {
+    return allocator->aligned_allocate(alignment, size, allocator->state);
+  }
+  // over-allocate, and store the pointer to deallocate right before the aligned memory
+  if (alignment < sizeof(void *)) {
+    alignment = sizeof(void *);
+  }
+  size_t padding = alignment - 1u + sizeof(void *);
+  if (size > SIZE_MAX - padding) {
+    return NULL;
+  }
+  void * raw = allocator->allocate(size + padding, allocator->state);
+  if (NULL == raw) {
+    return NULL;
+  }
+  uintptr_t address = ((uintptr_t)raw + padding) & ~((uintptr_t)alignment - 1u);
+  ((void **)address)[-1] = raw;
+  return (void *)address;
+}
+
+void
+rcutils_allocator_aligned_deallocate(const rcutils_allocator_t * allocator, void * pointer)
+{
+  if (NULL == pointer || !rcutils_allocator_is_valid(allocator)) {
+    return;
+  }
+  if (__has_aligned_functions(allocator)) {
+    allocator->aligned_deallocate(pointer, allocator->state);
+    return;
+  }
+  allocator->deallocate(((void **)pointer)[-1], allocator->state);
+}
@@ -0,0 +1,279 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <string.h>
+
+#include "rcutils/arena_allocator.h"
+#include "rcutils/error_handling.h"
+
+typedef struct rcutils_arena_block_s
+{
+  // The block allocated before this one.
+  struct rcutils_arena_block_s * next;
+  // The number of bytes after the header, and how many of them were handed out.
+  size_t size;
+  size_t used;
+} rcutils_arena_block_t;
+
+typedef struct rcutils_arena_allocator_impl_s
+{
+  // The block memory is allocated from, followed by the previous ones.
+  rcutils_arena_block_t * blocks;
+  // The last allocation of the current block, which can be reallocated in place, or NULL.
+  uint8_t * last;
+  // The size of the next block.
+  size_t block_size;
+  rcutils_allocator_t allocator;
+} rcutils_arena_allocator_impl_t;
+
+static uint8_t *
+_block_data(rcutils_arena_block_t * block)
+{
+  return (uint8_t *)(block + 1);
+}
+
+// Returns the first aligned address after the used bytes of the block.
+static uint8_t *
+_block_aligned_end(rcutils_arena_block_t * block)
+{
+  uintptr_t end = (uintptr_t)(_block_data(block) + block->used);
+  uintptr_t misalignment = end % RCUTILS_ARENA_ALLOCATOR_ALIGNMENT;
+  if (0u != misalignment) {
+    end += RCUTILS_ARENA_ALLOCATOR_ALIGNMENT - misalignment;
+  }
+  return (uint8_t *)end;
+}
+
+static void *
+_arena_allocate(size_t size, void * state)
+{
+  rcutils_arena_allocator_impl_t * impl = state;
+  // Each allocation gets its own address
+  if (0u == size) {
+    size = 1u;
+  }
+  rcutils_arena_block_t * block = impl->blocks;
+  if (NULL != block) {
+    uint8_t * pointer = _block_aligned_end(block);
+    size_t offset = (size_t)(pointer - _block_data(block));
+    if (offset <= block->size && size <= block->size - offset) {
+      block->used = offset + size;
+      impl->last = pointer;
+      return pointer;
+    }
+  }
+
+  // Room for the allocation wherever the block data starts
+  size_t padding = RCUTILS_ARENA_ALLOCATOR_ALIGNMENT - 1u;
+  if (size > SIZE_MAX - sizeof(rcutils_arena_block_t) - padding) {
+    return NULL;
+  }
+  size_t block_size = impl->block_size;
+  if (block_size < size + padding) {
+    block_size = size + padding;
+  }
+  if (block_size > SIZE_MAX - sizeof(rcutils_arena_block_t)) {
+    return NULL;
+  }
+  block = impl->allocator.allocate(
+    sizeof(rcutils_arena_block_t) + block_size, impl->allocator.state);
+  if (NULL == block) {
+    return NULL;
+  }
+  block->next = impl->blocks;
+  block->size = block_size;
+  block->used = 0u;
+  impl->blocks = block;
+  if (impl->block_size <= (SIZE_MAX - sizeof(rcutils_arena_block_t)) / 2u) {
+    impl->block_size *= 2u;
+  }
+
+  uint8_t * pointer = _block_aligned_end(block);
+  block->used = (size_t)(pointer - _block_data(block)) + size;
+  impl->last = pointer;
+  return pointer;
+}
+
+static void
+_arena_deallocate(void * pointer, void * state)
+{
+  rcutils_arena_allocator_impl_t * impl = state;
+  // Only the last allocation can be given back, the others stay until the arena is reset
+  if (NULL != pointer && pointer == impl->last) {
+    impl->blocks->used = (size_t)(impl->last - _block_data(impl->blocks));
+    impl->last = NULL;
+  }
+}
+
+static void *
+_arena_reallocate(void * pointer, size_t size, void * state)
+{
+  rcutils_arena_allocator_impl_t * impl = state;
+  if (NULL == pointer) {
+    return _arena_allocate(size, state);
+  }
+  if (0u == size) {
+    size = 1u;
+  }
+  if (pointer == impl->last) {
+    rcutils_arena_block_t * block = impl->blocks;
+    size_t offset = (size_t)(impl->last - _block_data(block));
+    if (size <= block->size - offset) {
+      block->used = offset + size;
+      return pointer;
+    }
+  }
+
+  // The size of the allocation isn't stored, but the bytes until the end of the used part of
+  // its block belong to the arena, and hold the allocation and the ones after it
+  size_t available = 0u;
+  rcutils_arena_block_t * block = impl->blocks;
+  for (; NULL != block; block = block->next) {
+    uint8_t * data = _block_data(block);
+    if ((uintptr_t)pointer >= (uintptr_t)data &&
+      (uintptr_t)pointer < (uintptr_t)(data + block->used))
+    {
+      available = (size_t)(data + block->used - (uint8_t *)pointer);
+      break;
+    }
+  }
+  if (NULL == block) {
+    // The pointer wasn't allocated from this arena
+    return NULL;
+  }
+  void * new_pointer = _arena_allocate(size, state);
+  if (NULL == new_pointer) {
+    return NULL;
+  }
+  memcpy(new_pointer, pointer, size < available ? size : available);
+  return new_pointer;
+}
+
+static void *
+_arena_zero_allocate(size_t number_of_elements, size_t size_of_element, void * state)
+{
+  if (0u != size_of_element && number_of_elements > SIZE_MAX / size_of_element) {
+    return NULL;
+  }
+  size_t size = number_of_elements * size_of_element;
+  void * pointer = _arena_allocate(size, state);
+  if (NULL != pointer) {
+    memset(pointer, 0, size);
+  }
+  return pointer;
+}
+
+rcutils_arena_allocator_t
+rcutils_get_zero_initialized_arena_allocator(void)
+{
+  static rcutils_arena_allocator_t zero_initialized_arena_allocator = {NULL};
+  return zero_initialized_arena_allocator;
+}
+
+rcutils_ret_t
+rcutils_arena_allocator_init(
+  rcutils_arena_allocator_t * arena,
+  size_t block_size,
+  const rcutils_allocator_t * allocator)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(arena, RCUTILS_RET_INVALID_ARGUMENT);
+  if (NULL != arena->impl) {
+    RCUTILS_SET_ERROR_MSG("arena allocator is already initialized");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  RCUTILS_CHECK_ALLOCATOR_WITH_MSG(
+    allocator, "invalid allocator", return RCUTILS_RET_INVALID_ARGUMENT);
+
+  rcutils_arena_allocator_impl_t * impl = allocator->allocate(
+    sizeof(rcutils_arena_allocator_impl_t), allocator->state);
+  if (NULL == impl) {
+    RCUTILS_SET_ERROR_MSG("failed to allocate memory for arena allocator");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  impl->blocks = NULL;
+  impl->last = NULL;
+  impl->block_size = 0u == block_size ? RCUTILS_ARENA_ALLOCATOR_DEFAULT_BLOCK_SIZE : block_size;
+  impl->allocator = *allocator;
+  arena->impl = impl;
+  return RCUTILS_RET_OK;
+}
+
+// Deallocates the block and the ones after it
+static void
+_deallocate_blocks(rcutils_arena_allocator_impl_t * impl, rcutils_arena_block_t * block)
+{
+  while (NULL != block) {
+    rcutils_arena_block_t * next = block->next;
+    impl->allocator.deallocate(block, impl->allocator.state);
+    block = next;
+  }
+}
+
+rcutils_ret_t
+rcutils_arena_allocator_fini(rcutils_arena_allocator_t * arena)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(arena, RCUTILS_RET_INVALID_ARGUMENT);
+  rcutils_arena_allocator_impl_t * impl = arena->impl;
+  if (NULL == impl) {
+    return RCUTILS_RET_OK;
+  }
+  _deallocate_blocks(impl, impl->blocks);
+  impl->allocator.deallocate(impl, impl->allocator.state);
+  arena->impl = NULL;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_arena_allocator_reset(rcutils_arena_allocator_t * arena)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(arena, RCUTILS_RET_INVALID_ARGUMENT);
+  rcutils_arena_allocator_impl_t * impl = arena->impl;
+  if (NULL == impl) {
+    RCUTILS_SET_ERROR_MSG("arena allocator is not initialized");
+    return RCUTILS_RET_NOT_INITIALIZED;
+  }
+  if (NULL != impl->blocks) {
+    _deallocate_blocks(impl, impl->blocks->next);
+    impl->blocks->next = NULL;
+    impl->blocks->used = 0u;
+  }
+  impl->last = NULL;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_allocator_t
+rcutils_arena_allocator_get_allocator(const rcutils_arena_allocator_t * arena)
+{
+  if (NULL == arena || NULL == arena->impl) {
+    return rcutils_get_zero_initialized_allocator();
+  }
+  rcutils_allocator_t allocator = {
+    .allocate = _arena_allocate,
+    .deallocate = _arena_deallocate,
+    .reallocate = _arena_reallocate,
+    .zero_allocate = _arena_zero_allocate,
+    .state = arena->impl,
+  };
+  return allocator;
+}
+
+#ifdef __cplusplus
+}
+#endif
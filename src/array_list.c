@@ -17,6 +17,7 @@ extern "C"
 {
 #endif
 
+#include <stdint.h>
 #include <string.h>
 
 #include "rcutils/allocator.h"
@@ -101,9 +102,18 @@ rcutils_array_list_fini(rcutils_array_list_t * array_list)
   return RCUTILS_RET_OK;
 }
 
-static rcutils_ret_t rcutils_array_list_increase_capacity(rcutils_array_list_t * array_list)
+// Grows the capacity geometrically until it holds at least min_capacity entries
+static rcutils_ret_t rcutils_array_list_increase_capacity(
+  rcutils_array_list_t * array_list, size_t min_capacity)
 {
-  size_t new_capacity = 2 * array_list->impl->capacity;
+  size_t max_capacity = SIZE_MAX / array_list->impl->data_size;
+  if (min_capacity > max_capacity) {
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  size_t new_capacity = array_list->impl->capacity;
+  while (new_capacity < min_capacity) {
+    new_capacity = new_capacity > max_capacity / 2 ? max_capacity : 2 * new_capacity;
+  }
   size_t new_size = array_list->impl->data_size * new_capacity;
   void * new_list = array_list->impl->allocator.reallocate(
     array_list->impl->list,
@@ -134,7 +144,7 @@ rcutils_array_list_add(rcutils_array_list_t * array_list, const void * data)
   rcutils_ret_t ret = RCUTILS_RET_OK;
 
   if (array_list->impl->size + 1 > array_list->impl->capacity) {
-    ret = rcutils_array_list_increase_capacity(array_list);
+    ret = rcutils_array_list_increase_capacity(array_list, array_list->impl->size + 1);
     if (RCUTILS_RET_OK != ret) {
       return ret;
     }
@@ -148,6 +158,79 @@ rcutils_array_list_add(rcutils_array_list_t * array_list, const void * data)
   return ret;
 }
 
+rcutils_ret_t
+rcutils_array_list_add_n(rcutils_array_list_t * array_list, const void * data, size_t count)
+{
+  ARRAY_LIST_VALIDATE_ARRAY_LIST(array_list);
+  if (0 == count) {
+    return RCUTILS_RET_OK;
+  }
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(data, RCUTILS_RET_INVALID_ARGUMENT);
+
+  if (count > SIZE_MAX - array_list->impl->size) {
+    RCUTILS_SET_ERROR_MSG("too many entries to add to the list");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  if (array_list->impl->size + count > array_list->impl->capacity) {
+    rcutils_ret_t ret =
+      rcutils_array_list_increase_capacity(array_list, array_list->impl->size + count);
+    if (RCUTILS_RET_OK != ret) {
+      return ret;
+    }
+  }
+
+  uint8_t * index_ptr =
+    rcutils_array_list_get_pointer_for_index(array_list, array_list->impl->size);
+  memcpy(index_ptr, data, array_list->impl->data_size * count);
+
+  array_list->impl->size += count;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_array_list_emplace(rcutils_array_list_t * array_list, void ** data)
+{
+  ARRAY_LIST_VALIDATE_ARRAY_LIST(array_list);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(data, RCUTILS_RET_INVALID_ARGUMENT);
+
+  if (array_list->impl->size + 1 > array_list->impl->capacity) {
+    rcutils_ret_t ret =
+      rcutils_array_list_increase_capacity(array_list, array_list->impl->size + 1);
+    if (RCUTILS_RET_OK != ret) {
+      return ret;
+    }
+  }
+
+  *data = rcutils_array_list_get_pointer_for_index(array_list, array_list->impl->size);
+  array_list->impl->size++;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_array_list_reserve(rcutils_array_list_t * array_list, size_t capacity)
+{
+  ARRAY_LIST_VALIDATE_ARRAY_LIST(array_list);
+  if (capacity <= array_list->impl->capacity) {
+    return RCUTILS_RET_OK;
+  }
+  size_t max_capacity = SIZE_MAX / array_list->impl->data_size;
+  if (capacity > max_capacity) {
+    RCUTILS_SET_ERROR_MSG("capacity is too large for the list");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  void * new_list = array_list->impl->allocator.reallocate(
+    array_list->impl->list,
+    array_list->impl->data_size * capacity,
+    array_list->impl->allocator.state);
+  if (NULL == new_list) {
+    RCUTILS_SET_ERROR_MSG("failed to allocate memory for array list data");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  array_list->impl->list = new_list;
+  array_list->impl->capacity = capacity;
+  return RCUTILS_RET_OK;
+}
+
 rcutils_ret_t
 rcutils_array_list_set(rcutils_array_list_t * array_list, size_t index, const void * data)
 {
@@ -172,7 +255,25 @@ rcutils_array_list_remove(rcutils_array_list_t * array_list, size_t index)
   if (copy_count > 0) {
     uint8_t * dst_ptr = rcutils_array_list_get_pointer_for_index(array_list, index);
     uint8_t * src_ptr = rcutils_array_list_get_pointer_for_index(array_list, index + 1);
-    memcpy(dst_ptr, src_ptr, array_list->impl->data_size * copy_count);
+    memmove(dst_ptr, src_ptr, array_list->impl->data_size * copy_count);
+  }
+
+  array_list->impl->size--;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_array_list_swap_remove(rcutils_array_list_t * array_list, size_t index)
+{
+  ARRAY_LIST_VALIDATE_ARRAY_LIST(array_list);
+  ARRAY_LIST_VALIDATE_INDEX_IN_BOUNDS(array_list, index);
+
+  // Move the last entry into the place of the removed one
+  size_t last = array_list->impl->size - 1;
+  if (index != last) {
+    uint8_t * dst_ptr = rcutils_array_list_get_pointer_for_index(array_list, index);
+    uint8_t * src_ptr = rcutils_array_list_get_pointer_for_index(array_list, last);
+    memcpy(dst_ptr, src_ptr, array_list->impl->data_size);
   }
 
   array_list->impl->size--;
@@ -192,6 +293,18 @@ rcutils_array_list_get(const rcutils_array_list_t * array_list, size_t index, vo
   return RCUTILS_RET_OK;
 }
 
+rcutils_ret_t
+rcutils_array_list_get_ptr(const rcutils_array_list_t * array_list, size_t index, void ** data)
+{
+  ARRAY_LIST_VALIDATE_ARRAY_LIST(array_list);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(data, RCUTILS_RET_INVALID_ARGUMENT);
+  ARRAY_LIST_VALIDATE_INDEX_IN_BOUNDS(array_list, index);
+
+  *data = rcutils_array_list_get_pointer_for_index(array_list, index);
+
+  return RCUTILS_RET_OK;
+}
+
 rcutils_ret_t
 rcutils_array_list_get_size(const rcutils_array_list_t * array_list, size_t * size)
 {
@@ -201,6 +314,38 @@ rcutils_array_list_get_size(const rcutils_array_list_t * array_list, size_t * si
   return RCUTILS_RET_OK;
 }
 
+rcutils_ret_t
+rcutils_array_list_get_memory_usage(const rcutils_array_list_t * array_list, size_t * bytes)
+{
+  ARRAY_LIST_VALIDATE_ARRAY_LIST(array_list);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(bytes, RCUTILS_RET_INVALID_ARGUMENT);
+  *bytes = sizeof(rcutils_array_list_impl_t) +
+    array_list->impl->capacity * array_list->impl->data_size;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_array_list_shrink_to_fit(rcutils_array_list_t * array_list)
+{
+  ARRAY_LIST_VALIDATE_ARRAY_LIST(array_list);
+  // The capacity is doubled when growing, so it's kept at least 1
+  size_t capacity = array_list->impl->size > 0 ? array_list->impl->size : 1;
+  if (capacity >= array_list->impl->capacity) {
+    return RCUTILS_RET_OK;
+  }
+  void * new_list = array_list->impl->allocator.reallocate(
+    array_list->impl->list,
+    array_list->impl->data_size * capacity,
+    array_list->impl->allocator.state);
+  if (NULL == new_list) {
+    RCUTILS_SET_ERROR_MSG("failed to reallocate memory for array list data");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  array_list->impl->list = new_list;
+  array_list->impl->capacity = capacity;
+  return RCUTILS_RET_OK;
+}
+
 #ifdef __cplusplus
 }
 #endif
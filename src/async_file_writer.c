@@ -0,0 +1,896 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <errno.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef _WIN32
+// See the comment in logging.c about warning C5105.
+# pragma warning(push)
+# pragma warning(disable : 5105)
+# include <windows.h>
+# pragma warning(pop)
+# include <fcntl.h>
+# include <io.h>
+# include <sys/stat.h>
+#else
+# include <fcntl.h>
+# include <pthread.h>
+# include <sys/stat.h>
+# include <unistd.h>
+# if defined(__linux__) && defined(__has_include)
+#  if __has_include(<linux/io_uring.h>)
+#   include <linux/io_uring.h>
+#   include <stdatomic.h>
+#   include <sys/mman.h>
+#   include <sys/syscall.h>
+#   include <sys/uio.h>
+#   if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) && \
+  defined(__NR_io_uring_register)
+#    define ASYNC_FILE_WRITER_HAS_IO_URING
+#   endif
+#  endif
+# endif
+#endif
+
+#include "rcutils/async_file_writer.h"
+#include "rcutils/error_handling.h"
+
+#ifdef _WIN32
+typedef CRITICAL_SECTION _mutex_t;
+typedef CONDITION_VARIABLE _condition_t;
+typedef HANDLE _thread_t;
+#else
+typedef pthread_mutex_t _mutex_t;
+typedef pthread_cond_t _condition_t;
+typedef pthread_t _thread_t;
+#endif
+
+// The user data of the completion of a fsync, the other ones being indexes of buffers.
+#define ASYNC_FILE_WRITER_SYNC UINT64_MAX
+
+typedef struct _buffer_t
+{
+  uint8_t * data;
+  // The number of bytes appended to the buffer.
+  size_t length;
+  // The number of bytes of the buffer written, io_uring may write part of them at once.
+  size_t written;
+  // The offset in the file of the first byte of the buffer.
+  uint64_t offset;
+  // Whether the buffer is being written, it's set by the writer and cleared on completion.
+  bool in_flight;
+} _buffer_t;
+
+#ifdef ASYNC_FILE_WRITER_HAS_IO_URING
+typedef struct _ring_t
+{
+  int fd;
+  void * sq_ring;
+  size_t sq_ring_size;
+  void * cq_ring;
+  size_t cq_ring_size;
+  struct io_uring_sqe * sqes;
+  size_t sqes_size;
+  unsigned * sq_tail;
+  unsigned * sq_array;
+  unsigned sq_mask;
+  unsigned * cq_head;
+  unsigned * cq_tail;
+  unsigned cq_mask;
+  struct io_uring_cqe * cqes;
+  // Whether a fsync was submitted and didn't complete yet.
+  bool sync_pending;
+} _ring_t;
+#endif
+
+typedef struct rcutils_async_file_writer_impl_t
+{
+  rcutils_allocator_t allocator;
+  rcutils_async_file_writer_backend_t backend;
+  int fd;
+  _buffer_t * buffers;
+  size_t buffer_count;
+  size_t buffer_size;
+  // The buffer being filled, the ones before it in the ring being the ones written.
+  size_t current;
+  // The number of buffers written which aren't retired yet, in flight or not.
+  size_t submitted;
+  // The offset in the file of the next byte appended.
+  uint64_t offset;
+  // The offset up to which the writes completed, along with all the earlier ones.
+  uint64_t written_size;
+  // The error code of the first write or sync which failed, 0 if none did.
+  int error;
+#ifdef ASYNC_FILE_WRITER_HAS_IO_URING
+  _ring_t ring;
+#endif
+  // The state of the thread backend, guarded by the mutex.
+  _mutex_t mutex;
+  _condition_t condition;
+  _thread_t thread;
+  bool thread_started;
+  bool exit;
+  // The buffer the thread writes next.
+  size_t next_write;
+  bool sync_requested;
+} rcutils_async_file_writer_impl_t;
+
+static size_t
+_oldest(const rcutils_async_file_writer_impl_t * impl)
+{
+  return (impl->current + impl->buffer_count - impl->submitted) % impl->buffer_count;
+}
+
+// Retire the written buffers, from the oldest one to the first one still in flight.
+static void
+_retire(rcutils_async_file_writer_impl_t * impl)
+{
+  while (impl->submitted > 0u) {
+    _buffer_t * buffer = &impl->buffers[_oldest(impl)];
+    if (buffer->in_flight) {
+      break;
+    }
+    if (0 == impl->error) {
+      impl->written_size = buffer->offset + buffer->length;
+    }
+    buffer->length = 0u;
+    --impl->submitted;
+  }
+}
+
+static int
+_write_all(int fd, const uint8_t * data, size_t length)
+{
+  while (length > 0u) {
+#ifdef _WIN32
+    unsigned int chunk = length > INT_MAX ? INT_MAX : (unsigned int)length;
+    int written = _write(fd, data, chunk);
+#else
+    ssize_t written = write(fd, data, length);
+#endif
+    if (written < 0) {
+      if (EINTR == errno) {
+        continue;
+      }
+      return errno;
+    }
+    if (0 == written) {
+      return EIO;
+    }
+    data += written;
+    length -= (size_t)written;
+  }
+  return 0;
+}
+
+static int
+_sync_file(int fd)
+{
+#ifdef _WIN32
+  return 0 == _commit(fd) ? 0 : errno;
+#else
+  return 0 == fsync(fd) ? 0 : errno;
+#endif
+}
+
+// The thread backend.
+
+static void
+_lock(rcutils_async_file_writer_impl_t * impl)
+{
+#ifdef _WIN32
+  EnterCriticalSection(&impl->mutex);
+#else
+  pthread_mutex_lock(&impl->mutex);
+#endif
+}
+
+static void
+_unlock(rcutils_async_file_writer_impl_t * impl)
+{
+#ifdef _WIN32
+  LeaveCriticalSection(&impl->mutex);
+#else
+  pthread_mutex_unlock(&impl->mutex);
+#endif
+}
+
+static void
+_wait(rcutils_async_file_writer_impl_t * impl)
+{
+#ifdef _WIN32
+  SleepConditionVariableCS(&impl->condition, &impl->mutex, INFINITE);
+#else
+  pthread_cond_wait(&impl->condition, &impl->mutex);
+#endif
+}
+
+static void
+_wake(rcutils_async_file_writer_impl_t * impl)
+{
+#ifdef _WIN32
+  WakeAllConditionVariable(&impl->condition);
+#else
+  pthread_cond_broadcast(&impl->condition);
+#endif
+}
+
+#ifdef _WIN32
+static DWORD WINAPI
+_thread_main(LPVOID arg)
+#else
+static void *
+_thread_main(void * arg)
+#endif
+{
+  rcutils_async_file_writer_impl_t * impl = (rcutils_async_file_writer_impl_t *)arg;
+  _lock(impl);
+  for (;;) {
+    _buffer_t * buffer = &impl->buffers[impl->next_write];
+    if (buffer->in_flight) {
+      // The buffer isn't modified by the writer while it's in flight.
+      _unlock(impl);
+      int error = _write_all(impl->fd, buffer->data, buffer->length);
+      _lock(impl);
+      if (0 != error && 0 == impl->error) {
+        impl->error = error;
+      }
+      buffer->in_flight = false;
+      impl->next_write = (impl->next_write + 1u) % impl->buffer_count;
+      _wake(impl);
+    } else if (impl->sync_requested) {
+      _unlock(impl);
+      int error = _sync_file(impl->fd);
+      _lock(impl);
+      if (0 != error && 0 == impl->error) {
+        impl->error = error;
+      }
+      impl->sync_requested = false;
+      _wake(impl);
+    } else if (impl->exit) {
+      break;
+    } else {
+      _wait(impl);
+    }
+  }
+  _unlock(impl);
+#ifdef _WIN32
+  return 0;
+#else
+  return NULL;
+#endif
+}
+
+static rcutils_ret_t
+_thread_start(rcutils_async_file_writer_impl_t * impl)
+{
+#ifdef _WIN32
+  InitializeCriticalSection(&impl->mutex);
+  InitializeConditionVariable(&impl->condition);
+  impl->thread = CreateThread(NULL, 0, _thread_main, impl, 0, NULL);
+  if (NULL == impl->thread) {
+    DeleteCriticalSection(&impl->mutex);
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "failed to create the file writer thread: %lu", GetLastError());
+    return RCUTILS_RET_ERROR;
+  }
+#else
+  pthread_mutex_init(&impl->mutex, NULL);
+  pthread_cond_init(&impl->condition, NULL);
+  int thread_ret = pthread_create(&impl->thread, NULL, _thread_main, impl);
+  if (0 != thread_ret) {
+    pthread_cond_destroy(&impl->condition);
+    pthread_mutex_destroy(&impl->mutex);
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "failed to create the file writer thread: %d", thread_ret);
+    return RCUTILS_RET_ERROR;
+  }
+#endif
+  impl->thread_started = true;
+  return RCUTILS_RET_OK;
+}
+
+static void
+_thread_stop(rcutils_async_file_writer_impl_t * impl)
+{
+  if (!impl->thread_started) {
+    return;
+  }
+  _lock(impl);
+  impl->exit = true;
+  _wake(impl);
+  _unlock(impl);
+#ifdef _WIN32
+  WaitForSingleObject(impl->thread, INFINITE);
+  CloseHandle(impl->thread);
+  DeleteCriticalSection(&impl->mutex);
+#else
+  pthread_join(impl->thread, NULL);
+  pthread_cond_destroy(&impl->condition);
+  pthread_mutex_destroy(&impl->mutex);
+#endif
+  impl->thread_started = false;
+}
+
+// The io_uring backend.
+
+#ifdef ASYNC_FILE_WRITER_HAS_IO_URING
+static int
+_ring_enter(_ring_t * ring, unsigned to_submit, unsigned min_complete, unsigned flags)
+{
+  for (;;) {
+    long ret = syscall(  // NOLINT(runtime/int)
+      __NR_io_uring_enter, ring->fd, to_submit, min_complete, flags, NULL, 0);
+    if (ret >= 0) {
+      return 0;
+    }
+    if (EINTR != errno) {
+      return errno;
+    }
+  }
+}
+
+static void
+_ring_close(_ring_t * ring)
+{
+  if (NULL != ring->sqes) {
+    munmap(ring->sqes, ring->sqes_size);
+  }
+  if (NULL != ring->cq_ring && ring->cq_ring != ring->sq_ring) {
+    munmap(ring->cq_ring, ring->cq_ring_size);
+  }
+  if (NULL != ring->sq_ring) {
+    munmap(ring->sq_ring, ring->sq_ring_size);
+  }
+  // Closing the ring unregisters the buffers.
+  if (-1 != ring->fd) {
+    close(ring->fd);
+  }
+  memset(ring, 0, sizeof(*ring));
+  ring->fd = -1;
+}
+
+// Set up a ring with room for a write of each buffer and a fsync, and register the buffers.
+static int
+_ring_open(rcutils_async_file_writer_impl_t * impl)
+{
+  _ring_t * ring = &impl->ring;
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  ring->fd = (int)syscall(__NR_io_uring_setup, (unsigned)impl->buffer_count + 1u, &params);
+  if (ring->fd < 0) {
+    ring->fd = -1;
+    return errno;
+  }
+  ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  bool single_mmap = 0u != (params.features & IORING_FEAT_SINGLE_MMAP);
+  if (single_mmap && ring->cq_ring_size > ring->sq_ring_size) {
+    ring->sq_ring_size = ring->cq_ring_size;
+  }
+  void * sq_ring = mmap(
+    NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+    IORING_OFF_SQ_RING);
+  if (MAP_FAILED == sq_ring) {
+    int error = errno;
+    _ring_close(ring);
+    return error;
+  }
+  ring->sq_ring = sq_ring;
+  void * cq_ring = sq_ring;
+  if (!single_mmap) {
+    cq_ring = mmap(
+      NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+      IORING_OFF_CQ_RING);
+    if (MAP_FAILED == cq_ring) {
+      int error = errno;
+      _ring_close(ring);
+      return error;
+    }
+  }
+  ring->cq_ring = cq_ring;
+  ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+  void * sqes = mmap(
+    NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+    IORING_OFF_SQES);
+  if (MAP_FAILED == sqes) {
+    int error = errno;
+    _ring_close(ring);
+    return error;
+  }
+  ring->sqes = (struct io_uring_sqe *)sqes;
+  ring->sq_tail = (unsigned *)((uint8_t *)sq_ring + params.sq_off.tail);
+  ring->sq_array = (unsigned *)((uint8_t *)sq_ring + params.sq_off.array);
+  ring->sq_mask = *(unsigned *)((uint8_t *)sq_ring + params.sq_off.ring_mask);
+  ring->cq_head = (unsigned *)((uint8_t *)cq_ring + params.cq_off.head);
+  ring->cq_tail = (unsigned *)((uint8_t *)cq_ring + params.cq_off.tail);
+  ring->cq_mask = *(unsigned *)((uint8_t *)cq_ring + params.cq_off.ring_mask);
+  ring->cqes = (struct io_uring_cqe *)((uint8_t *)cq_ring + params.cq_off.cqes);
+
+  // Registered buffers are mapped by the kernel once, instead of at each write.
+  struct iovec * iovecs = impl->allocator.allocate(
+    impl->buffer_count * sizeof(struct iovec), impl->allocator.state);
+  if (NULL == iovecs) {
+    _ring_close(ring);
+    return ENOMEM;
+  }
+  for (size_t i = 0u; i < impl->buffer_count; ++i) {
+    iovecs[i].iov_base = impl->buffers[i].data;
+    iovecs[i].iov_len = impl->buffer_size;
+  }
+  long ret = syscall(  // NOLINT(runtime/int)
+    __NR_io_uring_register, ring->fd, IORING_REGISTER_BUFFERS, iovecs,
+    (unsigned)impl->buffer_count);
+  int error = ret < 0 ? errno : 0;
+  impl->allocator.deallocate(iovecs, impl->allocator.state);
+  if (0 != error) {
+    _ring_close(ring);
+  }
+  return error;
+}
+
+static void
+_ring_push(
+  rcutils_async_file_writer_impl_t * impl, uint8_t opcode, uint64_t user_data,
+  const uint8_t * data, size_t length, uint64_t offset)
+{
+  _ring_t * ring = &impl->ring;
+  // Only this thread produces submissions, and there is room for all of them.
+  unsigned tail = *ring->sq_tail;
+  unsigned index = tail & ring->sq_mask;
+  struct io_uring_sqe * sqe = &ring->sqes[index];
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode = opcode;
+  sqe->fd = impl->fd;
+  sqe->off = offset;
+  sqe->addr = (uint64_t)(uintptr_t)data;
+  sqe->len = (uint32_t)length;
+  if (ASYNC_FILE_WRITER_SYNC != user_data) {
+    sqe->buf_index = (uint16_t)user_data;
+  }
+  sqe->user_data = user_data;
+  ring->sq_array[index] = index;
+  atomic_store_explicit((_Atomic unsigned *)ring->sq_tail, tail + 1u, memory_order_release);
+  int error = _ring_enter(ring, 1u, 0u, 0u);
+  if (0 != error && 0 == impl->error) {
+    impl->error = error;
+  }
+}
+
+static void
+_ring_push_write(rcutils_async_file_writer_impl_t * impl, size_t index)
+{
+  _buffer_t * buffer = &impl->buffers[index];
+  _ring_push(
+    impl, IORING_OP_WRITE_FIXED, (uint64_t)index, buffer->data + buffer->written,
+    buffer->length - buffer->written, buffer->offset + buffer->written);
+}
+
+// Process the completions queued, resubmitting the rest of the buffers partially written.
+static void
+_ring_reap(rcutils_async_file_writer_impl_t * impl)
+{
+  _ring_t * ring = &impl->ring;
+  unsigned head = *ring->cq_head;
+  unsigned tail = atomic_load_explicit((_Atomic unsigned *)ring->cq_tail, memory_order_acquire);
+  for (; head != tail; ++head) {
+    const struct io_uring_cqe * cqe = &ring->cqes[head & ring->cq_mask];
+    int error = cqe->res < 0 ? -cqe->res : 0;
+    if (ASYNC_FILE_WRITER_SYNC == cqe->user_data) {
+      ring->sync_pending = false;
+    } else {
+      _buffer_t * buffer = &impl->buffers[cqe->user_data];
+      if (cqe->res > 0) {
+        buffer->written += (size_t)cqe->res;
+      } else if (0 == cqe->res) {
+        error = EIO;
+      }
+      if (0 == error && buffer->written < buffer->length) {
+        _ring_push_write(impl, (size_t)cqe->user_data);
+      } else if (EINTR == error || EAGAIN == error) {
+        error = 0;
+        _ring_push_write(impl, (size_t)cqe->user_data);
+      } else {
+        buffer->in_flight = false;
+      }
+    }
+    if (0 != error && 0 == impl->error) {
+      impl->error = error;
+    }
+  }
+  atomic_store_explicit((_Atomic unsigned *)ring->cq_head, head, memory_order_release);
+}
+
+// Wait for a completion and process the ones queued, return false if waiting failed.
+static bool
+_ring_wait(rcutils_async_file_writer_impl_t * impl)
+{
+  int error = _ring_enter(&impl->ring, 0u, 1u, IORING_ENTER_GETEVENTS);
+  if (0 != error && 0 == impl->error) {
+    impl->error = error;
+  }
+  _ring_reap(impl);
+  return 0 == error;
+}
+#endif  // ASYNC_FILE_WRITER_HAS_IO_URING
+
+// The operations of both backends.
+
+static bool
+_uses_io_uring(const rcutils_async_file_writer_impl_t * impl)
+{
+  return RCUTILS_ASYNC_FILE_WRITER_BACKEND_IO_URING == impl->backend;
+}
+
+static void
+_submit(rcutils_async_file_writer_impl_t * impl)
+{
+  _buffer_t * buffer = &impl->buffers[impl->current];
+  buffer->written = 0u;
+  buffer->offset = impl->offset - buffer->length;
+  ++impl->submitted;
+  impl->current = (impl->current + 1u) % impl->buffer_count;
+#ifdef ASYNC_FILE_WRITER_HAS_IO_URING
+  if (_uses_io_uring(impl)) {
+    buffer->in_flight = true;
+    _ring_push_write(impl, (size_t)(buffer - impl->buffers));
+    return;
+  }
+#endif
+  _lock(impl);
+  buffer->in_flight = true;
+  _wake(impl);
+  _unlock(impl);
+}
+
+// Wait until the oldest buffer written is written, if all buffers are written, or until all
+// the buffers are written, and retire them.
+static void
+_wait_written(rcutils_async_file_writer_impl_t * impl, bool all)
+{
+  const size_t limit = all ? 0u : impl->buffer_count - 1u;
+#ifdef ASYNC_FILE_WRITER_HAS_IO_URING
+  if (_uses_io_uring(impl)) {
+    _ring_reap(impl);
+    _retire(impl);
+    while (impl->submitted > limit && _ring_wait(impl)) {
+      _retire(impl);
+    }
+    return;
+  }
+#endif
+  _lock(impl);
+  _retire(impl);
+  while (impl->submitted > limit) {
+    _wait(impl);
+    _retire(impl);
+  }
+  _unlock(impl);
+}
+
+static rcutils_ret_t
+_check_error(rcutils_async_file_writer_impl_t * impl)
+{
+  int error = impl->error;
+  if (!_uses_io_uring(impl)) {
+    _lock(impl);
+    error = impl->error;
+    _unlock(impl);
+  }
+  if (0 != error) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("failed to write the file, error code: %d", error);
+    return RCUTILS_RET_ERROR;
+  }
+  return RCUTILS_RET_OK;
+}
+
+static rcutils_ret_t
+_flush(rcutils_async_file_writer_impl_t * impl)
+{
+  if (impl->buffers[impl->current].length > 0u) {
+    _submit(impl);
+  }
+  _wait_written(impl, true);
+  return _check_error(impl);
+}
+
+static void
+_free(rcutils_async_file_writer_impl_t * impl)
+{
+  _thread_stop(impl);
+#ifdef ASYNC_FILE_WRITER_HAS_IO_URING
+  _ring_close(&impl->ring);
+#endif
+  if (-1 != impl->fd) {
+#ifdef _WIN32
+    _close(impl->fd);
+#else
+    close(impl->fd);
+#endif
+  }
+  rcutils_allocator_t allocator = impl->allocator;
+  if (NULL != impl->buffers) {
+    for (size_t i = 0u; i < impl->buffer_count; ++i) {
+      allocator.deallocate(impl->buffers[i].data, allocator.state);
+    }
+    allocator.deallocate(impl->buffers, allocator.state);
+  }
+  allocator.deallocate(impl, allocator.state);
+}
+
+rcutils_async_file_writer_t
+rcutils_get_zero_initialized_async_file_writer(void)
+{
+  static rcutils_async_file_writer_t zero_initialized_writer = {NULL};
+  return zero_initialized_writer;
+}
+
+rcutils_async_file_writer_options_t
+rcutils_async_file_writer_get_default_options(void)
+{
+  rcutils_async_file_writer_options_t options;
+  options.buffer_size = RCUTILS_ASYNC_FILE_WRITER_DEFAULT_BUFFER_SIZE;
+  options.buffer_count = RCUTILS_ASYNC_FILE_WRITER_DEFAULT_BUFFER_COUNT;
+  options.backend = RCUTILS_ASYNC_FILE_WRITER_BACKEND_AUTO;
+  return options;
+}
+
+rcutils_ret_t
+rcutils_async_file_writer_open(
+  rcutils_async_file_writer_t * writer,
+  const char * path,
+  const rcutils_async_file_writer_options_t * options,
+  const rcutils_allocator_t * allocator)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(writer, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(path, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ALLOCATOR(allocator, return RCUTILS_RET_INVALID_ARGUMENT);
+  if (NULL != writer->impl) {
+    RCUTILS_SET_ERROR_MSG("writer is already open");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  rcutils_async_file_writer_options_t actual_options =
+    NULL != options ? *options : rcutils_async_file_writer_get_default_options();
+  // The buffers are indexed by 16 bits in io_uring submissions.
+  if (0u == actual_options.buffer_size || actual_options.buffer_size > UINT32_MAX ||
+    actual_options.buffer_count < 2u || actual_options.buffer_count > UINT16_MAX)
+  {
+    RCUTILS_SET_ERROR_MSG("buffer size or count is out of range");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  if (actual_options.backend > RCUTILS_ASYNC_FILE_WRITER_BACKEND_THREAD) {
+    RCUTILS_SET_ERROR_MSG("invalid backend");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+#ifndef ASYNC_FILE_WRITER_HAS_IO_URING
+  if (RCUTILS_ASYNC_FILE_WRITER_BACKEND_IO_URING == actual_options.backend) {
+    RCUTILS_SET_ERROR_MSG("io_uring is not supported on this system");
+    return RCUTILS_RET_ERROR;
+  }
+#endif
+
+  rcutils_async_file_writer_impl_t * impl = allocator->zero_allocate(
+    1u, sizeof(rcutils_async_file_writer_impl_t), allocator->state);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    impl, "failed to allocate memory for the writer", return RCUTILS_RET_BAD_ALLOC);
+  impl->allocator = *allocator;
+  impl->fd = -1;
+#ifdef ASYNC_FILE_WRITER_HAS_IO_URING
+  impl->ring.fd = -1;
+#endif
+  impl->buffer_count = actual_options.buffer_count;
+  impl->buffer_size = actual_options.buffer_size;
+  impl->buffers = allocator->zero_allocate(
+    impl->buffer_count, sizeof(_buffer_t), allocator->state);
+  if (NULL == impl->buffers) {
+    _free(impl);
+    RCUTILS_SET_ERROR_MSG("failed to allocate memory for the writer");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  for (size_t i = 0u; i < impl->buffer_count; ++i) {
+    impl->buffers[i].data = allocator->allocate(impl->buffer_size, allocator->state);
+    if (NULL == impl->buffers[i].data) {
+      _free(impl);
+      RCUTILS_SET_ERROR_MSG("failed to allocate memory for the writer buffers");
+      return RCUTILS_RET_BAD_ALLOC;
+    }
+  }
+
+  // The bytes are written at the end of the file, which io_uring needs the offset of.
+#ifdef _WIN32
+  impl->fd = _open(path, _O_WRONLY | _O_CREAT | _O_BINARY, _S_IREAD | _S_IWRITE);
+  int64_t end = -1 == impl->fd ? -1 : _lseeki64(impl->fd, 0, SEEK_END);
+#else
+  impl->fd = open(path, O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+  int64_t end = -1 == impl->fd ? -1 : (int64_t)lseek(impl->fd, 0, SEEK_END);
+#endif
+  if (end < 0) {
+    int error = errno;
+    _free(impl);
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "failed to open '%s', error code: %d", path, error);
+    return RCUTILS_RET_ERROR;
+  }
+  impl->offset = (uint64_t)end;
+  impl->written_size = (uint64_t)end;
+
+  impl->backend = RCUTILS_ASYNC_FILE_WRITER_BACKEND_THREAD;
+#ifdef ASYNC_FILE_WRITER_HAS_IO_URING
+  if (RCUTILS_ASYNC_FILE_WRITER_BACKEND_THREAD != actual_options.backend) {
+    int error = _ring_open(impl);
+    if (0 == error) {
+      impl->backend = RCUTILS_ASYNC_FILE_WRITER_BACKEND_IO_URING;
+    } else if (RCUTILS_ASYNC_FILE_WRITER_BACKEND_IO_URING == actual_options.backend) {
+      _free(impl);
+      RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+        "failed to set up io_uring, error code: %d", error);
+      return RCUTILS_RET_ERROR;
+    }
+  }
+#endif
+  if (!_uses_io_uring(impl)) {
+    rcutils_ret_t ret = _thread_start(impl);
+    if (RCUTILS_RET_OK != ret) {
+      _free(impl);
+      return ret;
+    }
+  }
+  writer->impl = impl;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_async_file_writer_append(
+  rcutils_async_file_writer_t * writer, const void * data, size_t size)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(writer, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    writer->impl, "writer is not open", return RCUTILS_RET_NOT_INITIALIZED);
+  if (NULL == data && size > 0u) {
+    RCUTILS_SET_ERROR_MSG("data is NULL");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  rcutils_async_file_writer_impl_t * impl = writer->impl;
+  rcutils_ret_t ret = _check_error(impl);
+  if (RCUTILS_RET_OK != ret) {
+    return ret;
+  }
+  const uint8_t * bytes = (const uint8_t *)data;
+  while (size > 0u) {
+    _buffer_t * buffer = &impl->buffers[impl->current];
+    size_t length = impl->buffer_size - buffer->length;
+    if (length > size) {
+      length = size;
+    }
+    memcpy(buffer->data + buffer->length, bytes, length);
+    buffer->length += length;
+    impl->offset += length;
+    bytes += length;
+    size -= length;
+    if (buffer->length == impl->buffer_size) {
+      _submit(impl);
+      // The next buffer is free once it's not written anymore.
+      _wait_written(impl, false);
+      ret = _check_error(impl);
+      if (RCUTILS_RET_OK != ret) {
+        return ret;
+      }
+    }
+  }
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_async_file_writer_flush(rcutils_async_file_writer_t * writer)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(writer, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    writer->impl, "writer is not open", return RCUTILS_RET_NOT_INITIALIZED);
+  return _flush(writer->impl);
+}
+
+rcutils_ret_t
+rcutils_async_file_writer_sync(rcutils_async_file_writer_t * writer)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(writer, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    writer->impl, "writer is not open", return RCUTILS_RET_NOT_INITIALIZED);
+  rcutils_async_file_writer_impl_t * impl = writer->impl;
+  // The fsync is only issued once all the writes completed, so that it covers them.
+  rcutils_ret_t ret = _flush(impl);
+  if (RCUTILS_RET_OK != ret) {
+    return ret;
+  }
+#ifdef ASYNC_FILE_WRITER_HAS_IO_URING
+  if (_uses_io_uring(impl)) {
+    impl->ring.sync_pending = true;
+    _ring_push(impl, IORING_OP_FSYNC, ASYNC_FILE_WRITER_SYNC, NULL, 0u, 0u);
+    // Waiting sets the error if it fails.
+    while (impl->ring.sync_pending && 0 == impl->error) {
+      _ring_wait(impl);
+    }
+    return _check_error(impl);
+  }
+#endif
+  _lock(impl);
+  impl->sync_requested = true;
+  _wake(impl);
+  while (impl->sync_requested) {
+    _wait(impl);
+  }
+  _unlock(impl);
+  return _check_error(impl);
+}
+
+rcutils_ret_t
+rcutils_async_file_writer_get_written_size(
+  const rcutils_async_file_writer_t * writer, uint64_t * size)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(writer, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(size, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    writer->impl, "writer is not open", return RCUTILS_RET_NOT_INITIALIZED);
+  rcutils_async_file_writer_impl_t * impl = writer->impl;
+#ifdef ASYNC_FILE_WRITER_HAS_IO_URING
+  if (_uses_io_uring(impl)) {
+    _ring_reap(impl);
+    _retire(impl);
+    *size = impl->written_size;
+    return RCUTILS_RET_OK;
+  }
+#endif
+  _lock(impl);
+  _retire(impl);
+  *size = impl->written_size;
+  _unlock(impl);
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_async_file_writer_get_backend(
+  const rcutils_async_file_writer_t * writer, rcutils_async_file_writer_backend_t * backend)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(writer, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(backend, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    writer->impl, "writer is not open", return RCUTILS_RET_NOT_INITIALIZED);
+  *backend = writer->impl->backend;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_async_file_writer_close(rcutils_async_file_writer_t * writer)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(writer, RCUTILS_RET_INVALID_ARGUMENT);
+  if (NULL == writer->impl) {
+    return RCUTILS_RET_OK;
+  }
+  rcutils_ret_t ret = _flush(writer->impl);
+  _free(writer->impl);
+  writer->impl = NULL;
+  return ret;
+}
+
+#ifdef __cplusplus
+}
+#endif
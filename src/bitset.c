@@ -0,0 +1,263 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(_MSC_VER)
+# include <intrin.h>
+#endif
+
+#include "rcutils/error_handling.h"
+#include "rcutils/types/bitset.h"
+
+#define WORD_COUNT(bits) \
+  ((bits) / RCUTILS_BITSET_WORD_BITS + (0 != (bits) % RCUTILS_BITSET_WORD_BITS))
+
+// Returns the number of bits set in a word
+static inline size_t bitset_popcount(uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return (size_t)__builtin_popcountll(word);
+#elif defined(_MSC_VER) && defined(_M_X64)
+  return (size_t)__popcnt64(word);
+#else
+  word = word - ((word >> 1) & 0x5555555555555555ull);
+  word = (word & 0x3333333333333333ull) + ((word >> 2) & 0x3333333333333333ull);
+  word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+  return (size_t)((word * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+// Returns the index of the lowest bit set in a word which isn't 0
+static inline size_t bitset_lowest_bit(uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return (size_t)__builtin_ctzll(word);
+#elif defined(_MSC_VER) && defined(_M_X64)
+  unsigned long index = 0;
+  _BitScanForward64(&index, word);
+  return (size_t)index;
+#else
+  size_t index = 0;
+  while (0 == (word & 1)) {
+    word >>= 1;
+    ++index;
+  }
+  return index;
+#endif
+}
+
+// Clears the bits of the last word beyond the size
+static void bitset_clear_tail(rcutils_bitset_t * bitset)
+{
+  size_t tail_bits = bitset->size % RCUTILS_BITSET_WORD_BITS;
+  if (0 != tail_bits) {
+    bitset->words[bitset->size / RCUTILS_BITSET_WORD_BITS] &= ((uint64_t)1 << tail_bits) - 1;
+  }
+}
+
+// Finds the first bit at or after start which is set in the words xored with flip
+static rcutils_ret_t bitset_find_next(
+  const rcutils_bitset_t * bitset, size_t start, uint64_t flip, size_t * index)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(bitset, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(index, RCUTILS_RET_INVALID_ARGUMENT);
+  if (start >= bitset->size) {
+    return RCUTILS_RET_NOT_FOUND;
+  }
+  size_t word_index = start / RCUTILS_BITSET_WORD_BITS;
+  // Ignore the bits before start in its word
+  uint64_t word = (bitset->words[word_index] ^ flip) &
+    (~(uint64_t)0 << (start % RCUTILS_BITSET_WORD_BITS));
+  size_t word_count = WORD_COUNT(bitset->size);
+  while (0 == word) {
+    if (++word_index == word_count) {
+      return RCUTILS_RET_NOT_FOUND;
+    }
+    word = bitset->words[word_index] ^ flip;
+  }
+  size_t found = word_index * RCUTILS_BITSET_WORD_BITS + bitset_lowest_bit(word);
+  // When looking for clear bits, those of the last word beyond the size are found too
+  if (found >= bitset->size) {
+    return RCUTILS_RET_NOT_FOUND;
+  }
+  *index = found;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_bitset_t
+rcutils_get_zero_initialized_bitset(void)
+{
+  static rcutils_bitset_t bitset = {
+    .words = NULL,
+    .size = 0lu,
+    .word_capacity = 0lu
+  };
+  bitset.allocator = rcutils_get_zero_initialized_allocator();
+  return bitset;
+}
+
+rcutils_ret_t
+rcutils_bitset_init(
+  rcutils_bitset_t * bitset,
+  size_t size,
+  const rcutils_allocator_t * allocator)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(bitset, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ALLOCATOR(allocator, return RCUTILS_RET_INVALID_ARGUMENT);
+
+  bitset->words = NULL;
+  bitset->size = 0lu;
+  bitset->word_capacity = 0lu;
+  bitset->allocator = *allocator;
+  if (0lu != size) {
+    size_t word_count = WORD_COUNT(size);
+    bitset->words = allocator->zero_allocate(word_count, sizeof(uint64_t), allocator->state);
+    RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+      bitset->words,
+      "failed to allocate memory for bitset",
+      return RCUTILS_RET_BAD_ALLOC);
+    bitset->size = size;
+    bitset->word_capacity = word_count;
+  }
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_bitset_fini(rcutils_bitset_t * bitset)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(bitset, RCUTILS_RET_INVALID_ARGUMENT);
+
+  rcutils_allocator_t * allocator = &bitset->allocator;
+  RCUTILS_CHECK_ALLOCATOR(allocator, return RCUTILS_RET_INVALID_ARGUMENT);
+
+  allocator->deallocate(bitset->words, allocator->state);
+  bitset->words = NULL;
+  bitset->size = 0lu;
+  bitset->word_capacity = 0lu;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_bitset_resize(rcutils_bitset_t * bitset, size_t new_size)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(bitset, RCUTILS_RET_INVALID_ARGUMENT);
+  rcutils_allocator_t * allocator = &bitset->allocator;
+  RCUTILS_CHECK_ALLOCATOR(allocator, return RCUTILS_RET_INVALID_ARGUMENT);
+
+  size_t word_count = WORD_COUNT(new_size);
+  if (word_count > bitset->word_capacity) {
+    size_t new_capacity = bitset->word_capacity * 2;
+    if (new_capacity < word_count || new_capacity > SIZE_MAX / sizeof(uint64_t)) {
+      new_capacity = word_count;
+    }
+    if (new_capacity > SIZE_MAX / sizeof(uint64_t)) {
+      RCUTILS_SET_ERROR_MSG("new_size of bitset is too large");
+      return RCUTILS_RET_INVALID_ARGUMENT;
+    }
+    uint64_t * words = allocator->reallocate(
+      bitset->words, new_capacity * sizeof(uint64_t), allocator->state);
+    RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+      words,
+      "failed to reallocate memory for bitset",
+      return RCUTILS_RET_BAD_ALLOC);
+    bitset->words = words;
+    bitset->word_capacity = new_capacity;
+  }
+  // The bits beyond the old size are already clear in its last word, not in the next ones
+  size_t old_word_count = WORD_COUNT(bitset->size);
+  if (word_count > old_word_count) {
+    memset(
+      bitset->words + old_word_count, 0, (word_count - old_word_count) * sizeof(uint64_t));
+  }
+  // When shrinking, clear the bits beyond the new size in its last word
+  bitset->size = new_size;
+  bitset_clear_tail(bitset);
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_bitset_set(rcutils_bitset_t * bitset, size_t index)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(bitset, RCUTILS_RET_INVALID_ARGUMENT);
+  if (index >= bitset->size) {
+    RCUTILS_SET_ERROR_MSG("index is out of the bitset");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  bitset->words[index / RCUTILS_BITSET_WORD_BITS] |=
+    (uint64_t)1 << (index % RCUTILS_BITSET_WORD_BITS);
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_bitset_clear(rcutils_bitset_t * bitset, size_t index)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(bitset, RCUTILS_RET_INVALID_ARGUMENT);
+  if (index >= bitset->size) {
+    RCUTILS_SET_ERROR_MSG("index is out of the bitset");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  bitset->words[index / RCUTILS_BITSET_WORD_BITS] &=
+    ~((uint64_t)1 << (index % RCUTILS_BITSET_WORD_BITS));
+  return RCUTILS_RET_OK;
+}
+
+bool
+rcutils_bitset_test(const rcutils_bitset_t * bitset, size_t index)
+{
+  if (NULL == bitset || index >= bitset->size) {
+    return false;
+  }
+  return 0 != (bitset->words[index / RCUTILS_BITSET_WORD_BITS] &
+         ((uint64_t)1 << (index % RCUTILS_BITSET_WORD_BITS)));
+}
+
+rcutils_ret_t
+rcutils_bitset_assign_all(rcutils_bitset_t * bitset, bool value)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(bitset, RCUTILS_RET_INVALID_ARGUMENT);
+  if (0lu == bitset->size) {
+    return RCUTILS_RET_OK;
+  }
+  memset(bitset->words, value ? 0xFF : 0, WORD_COUNT(bitset->size) * sizeof(uint64_t));
+  bitset_clear_tail(bitset);
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_bitset_count(const rcutils_bitset_t * bitset, size_t * count)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(bitset, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(count, RCUTILS_RET_INVALID_ARGUMENT);
+  size_t total = 0lu;
+  size_t word_count = WORD_COUNT(bitset->size);
+  for (size_t i = 0; i < word_count; ++i) {
+    total += bitset_popcount(bitset->words[i]);
+  }
+  *count = total;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_bitset_find_next_set(const rcutils_bitset_t * bitset, size_t start, size_t * index)
+{
+  return bitset_find_next(bitset, start, 0, index);
+}
+
+rcutils_ret_t
+rcutils_bitset_find_next_clear(const rcutils_bitset_t * bitset, size_t start, size_t * index)
+{
+  return bitset_find_next(bitset, start, ~(uint64_t)0, index);
+}
@@ -12,8 +12,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <math.h>
 #include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
 #include "rcutils/error_handling.h"
+#include "rcutils/snprintf.h"
 #include "rcutils/types/char_array.h"
 
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
@@ -25,7 +29,8 @@ rcutils_get_zero_initialized_char_array(void)
     .buffer = NULL,
     .owns_buffer = true,
     .buffer_length = 0u,
-    .buffer_capacity = 0u
+    .buffer_capacity = 0u,
+    .max_capacity = 0u
   };
   char_array.allocator = rcutils_get_zero_initialized_allocator();
   return char_array;
@@ -46,6 +51,7 @@ rcutils_char_array_init(
   char_array->buffer_length = 0lu;
   char_array->buffer_capacity = buffer_capacity;
   char_array->allocator = *allocator;
+  char_array->max_capacity = 0lu;
 
   if (buffer_capacity > 0lu) {
     char_array->buffer =
@@ -115,13 +121,20 @@ rcutils_char_array_resize(rcutils_char_array_t * char_array, size_t new_size)
       return RCUTILS_RET_BAD_ALLOC);
     char_array->buffer = new_buf;
   } else {  // we don't realloc memory we don't own. instead, we alloc some new space
-    rcutils_ret_t ret = rcutils_char_array_init(char_array, new_size, allocator);
-    if (ret != RCUTILS_RET_OK) {
-      return ret;
-    }
+    char * new_buf = (char *)allocator->allocate(new_size * sizeof(char), allocator->state);
+    RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+      new_buf,
+      "failed to allocate memory for char array",
+      return RCUTILS_RET_BAD_ALLOC);
     size_t n = MIN(new_size, old_size);
-    memcpy(char_array->buffer, old_buf, n);
-    char_array->buffer[n - 1] = '\0';  // always have an ending
+    if (n > 0lu) {
+      memcpy(new_buf, old_buf, n);
+      if (new_size < old_size) {
+        new_buf[n - 1] = '\0';  // always have an ending
+      }
+    }
+    char_array->buffer = new_buf;
+    char_array->owns_buffer = true;
   }
 
   char_array->buffer_capacity = new_size;
@@ -138,8 +151,35 @@ rcutils_char_array_expand_as_needed(rcutils_char_array_t * char_array, size_t ne
   if (new_size <= char_array->buffer_capacity) {
     return RCUTILS_RET_OK;
   }
+  size_t max_capacity = 0lu == char_array->max_capacity ? SIZE_MAX : char_array->max_capacity;
+  if (new_size > max_capacity) {
+    RCUTILS_SET_ERROR_MSG("new size of char_array exceeds its max capacity");
+    return RCUTILS_RET_NOT_ENOUGH_SPACE;
+  }
 
-  return rcutils_char_array_resize(char_array, new_size);
+  // grow geometrically, so that appending repeatedly takes amortized linear time
+  size_t new_capacity = char_array->buffer_capacity > max_capacity / 2 ?
+    max_capacity : 2 * char_array->buffer_capacity;
+  if (new_capacity < new_size) {
+    new_capacity = new_size;
+  }
+  return rcutils_char_array_resize(char_array, new_capacity);
+}
+
+rcutils_ret_t
+rcutils_char_array_reserve(rcutils_char_array_t * char_array, size_t capacity)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(char_array, RCUTILS_RET_ERROR);
+
+  if (capacity <= char_array->buffer_capacity) {
+    return RCUTILS_RET_OK;
+  }
+  if (0lu != char_array->max_capacity && capacity > char_array->max_capacity) {
+    RCUTILS_SET_ERROR_MSG("capacity of char_array exceeds its max capacity");
+    return RCUTILS_RET_NOT_ENOUGH_SPACE;
+  }
+
+  return rcutils_char_array_resize(char_array, capacity);
 }
 
 static int
@@ -191,6 +231,74 @@ rcutils_char_array_vsprintf(rcutils_char_array_t * char_array, const char * form
   return RCUTILS_RET_OK;
 }
 
+// A function formatting like vsnprintf()
+typedef int (* _rcutils_char_array_formatter_t)(char *, size_t, const char *, va_list);
+
+// Format at the given offset of the buffer, into the capacity left after it
+static int
+_rcutils_char_array_vsprintf_at(
+  rcutils_char_array_t * char_array, size_t offset, _rcutils_char_array_formatter_t formatter,
+  const char * format, va_list args)
+{
+  va_list args_clone;
+  va_copy(args_clone, args);
+  char * buffer = NULL == char_array->buffer ? NULL : char_array->buffer + offset;
+  int size = formatter(buffer, char_array->buffer_capacity - offset, format, args_clone);
+  va_end(args_clone);
+  return size;
+}
+
+static rcutils_ret_t
+_rcutils_char_array_vsprintf_append(
+  rcutils_char_array_t * char_array, _rcutils_char_array_formatter_t formatter,
+  const char * format, va_list args)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(char_array, RCUTILS_RET_ERROR);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(format, RCUTILS_RET_ERROR);
+
+  size_t length = 0lu == char_array->buffer_length ? 0lu : char_array->buffer_length - 1;
+  int size = _rcutils_char_array_vsprintf_at(char_array, length, formatter, format, args);
+  if (size < 0) {
+    RCUTILS_SET_ERROR_MSG("vsprintf on char array failed");
+    return RCUTILS_RET_ERROR;
+  }
+
+  size_t new_length = length + (size_t)size + 1;  // with the terminating null byte
+  if (new_length > char_array->buffer_capacity) {
+    rcutils_ret_t ret = rcutils_char_array_expand_as_needed(char_array, new_length);
+    if (ret != RCUTILS_RET_OK) {
+      if (NULL != char_array->buffer && length < char_array->buffer_capacity) {
+        // drop the truncated output
+        char_array->buffer[length] = '\0';
+      }
+      RCUTILS_SET_ERROR_MSG("char array failed to expand");
+      return ret;
+    }
+    if (_rcutils_char_array_vsprintf_at(char_array, length, formatter, format, args) != size) {
+      char_array->buffer[length] = '\0';
+      RCUTILS_SET_ERROR_MSG("vsprintf on resized char array failed");
+      return RCUTILS_RET_ERROR;
+    }
+  }
+  char_array->buffer_length = new_length;
+
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_char_array_vsprintf_append(
+  rcutils_char_array_t * char_array, const char * format, va_list args)
+{
+  return _rcutils_char_array_vsprintf_append(char_array, vsnprintf, format, args);
+}
+
+rcutils_ret_t
+rcutils_char_array_fast_vsprintf_append(
+  rcutils_char_array_t * char_array, const char * format, va_list args)
+{
+  return _rcutils_char_array_vsprintf_append(char_array, rcutils_fast_vsnprintf, format, args);
+}
+
 rcutils_ret_t
 rcutils_char_array_memcpy(rcutils_char_array_t * char_array, const char * src, size_t n)
 {
@@ -238,3 +346,135 @@ rcutils_char_array_strcat(rcutils_char_array_t * char_array, const char * src)
 {
   return rcutils_char_array_strncat(char_array, src, strlen(src));
 }
+
+rcutils_ret_t
+rcutils_char_array_append_n(rcutils_char_array_t * char_array, const char * src, size_t n)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(char_array, RCUTILS_RET_ERROR);
+  if (0lu != n) {
+    RCUTILS_CHECK_ARGUMENT_FOR_NULL(src, RCUTILS_RET_ERROR);
+  }
+
+  size_t length = 0lu == char_array->buffer_length ? 0lu : char_array->buffer_length - 1;
+  if (n >= SIZE_MAX - length) {
+    RCUTILS_SET_ERROR_MSG("char array would overflow");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  rcutils_ret_t ret = rcutils_char_array_expand_as_needed(char_array, length + n + 1);
+  if (ret != RCUTILS_RET_OK) {
+    RCUTILS_SET_ERROR_MSG("char array failed to expand");
+    return ret;
+  }
+  if (0lu != n) {
+    memcpy(char_array->buffer + length, src, n);
+  }
+  char_array->buffer[length + n] = '\0';
+  char_array->buffer_length = length + n + 1;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_char_array_append_char(rcutils_char_array_t * char_array, char c)
+{
+  return rcutils_char_array_append_n(char_array, &c, 1lu);
+}
+
+// Render value in decimal at the end of str, which must have room for 20 characters,
+// returning the first character.
+static char *
+_rcutils_char_array_format_u64(uint64_t value, char * end)
+{
+  do {
+    *--end = (char)('0' + value % 10u);
+    value /= 10u;
+  } while (value > 0u);
+  return end;
+}
+
+rcutils_ret_t
+rcutils_char_array_append_u64(rcutils_char_array_t * char_array, uint64_t value)
+{
+  char digits[20];
+  char * end = digits + sizeof(digits);
+  char * start = _rcutils_char_array_format_u64(value, end);
+  return rcutils_char_array_append_n(char_array, start, (size_t)(end - start));
+}
+
+rcutils_ret_t
+rcutils_char_array_append_i64(rcutils_char_array_t * char_array, int64_t value)
+{
+  char digits[21];
+  char * end = digits + sizeof(digits);
+  // The magnitude of INT64_MIN doesn't fit in an int64_t, so negate after converting
+  uint64_t magnitude = value < 0 ? 0u - (uint64_t)value : (uint64_t)value;
+  char * start = _rcutils_char_array_format_u64(magnitude, end);
+  if (value < 0) {
+    *--start = '-';
+  }
+  return rcutils_char_array_append_n(char_array, start, (size_t)(end - start));
+}
+
+rcutils_ret_t
+rcutils_char_array_append_double(
+  rcutils_char_array_t * char_array, double value, unsigned int precision)
+{
+  static const uint64_t powers_of_ten[] = {
+    1u, 10u, 100u, 1000u, 10000u, 100000u, 1000000u, 10000000u, 100000000u, 1000000000u
+  };
+  if (precision >= sizeof(powers_of_ten) / sizeof(powers_of_ten[0])) {
+    RCUTILS_SET_ERROR_MSG("precision has to be at most 9");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  if (isnan(value)) {
+    return rcutils_char_array_append_n(char_array, "nan", 3lu);
+  }
+  if (isinf(value)) {
+    return value < 0 ?
+           rcutils_char_array_append_n(char_array, "-inf", 4lu) :
+           rcutils_char_array_append_n(char_array, "inf", 3lu);
+  }
+
+  // 2^63, so that the scaled magnitude is exactly representable as an uint64_t
+  const double limit = 9223372036854775808.0;
+  bool negative = signbit(value) != 0;
+  double scaled = (negative ? -value : value) * (double)powers_of_ten[precision] + 0.5;
+  char digits[32];
+  if (scaled >= limit) {
+    int written = snprintf(digits, sizeof(digits), "%.*f", (int)precision, value);
+    if (written < 0) {
+      RCUTILS_SET_ERROR_MSG("failed to format the number");
+      return RCUTILS_RET_ERROR;
+    }
+    if ((size_t)written < sizeof(digits)) {
+      return rcutils_char_array_append_n(char_array, digits, (size_t)written);
+    }
+    // Too long for the stack buffer, format into the array itself
+    size_t length = 0lu == char_array->buffer_length ? 0lu : char_array->buffer_length - 1;
+    rcutils_ret_t ret =
+      rcutils_char_array_expand_as_needed(char_array, length + (size_t)written + 1);
+    if (ret != RCUTILS_RET_OK) {
+      RCUTILS_SET_ERROR_MSG("char array failed to expand");
+      return ret;
+    }
+    snprintf(char_array->buffer + length, (size_t)written + 1, "%.*f", (int)precision, value);
+    char_array->buffer_length = length + (size_t)written + 1;
+    return RCUTILS_RET_OK;
+  }
+
+  uint64_t fixed = (uint64_t)scaled;
+  char * end = digits + sizeof(digits);
+  char * start = end;
+  if (precision > 0) {
+    uint64_t fraction = fixed % powers_of_ten[precision];
+    for (unsigned int i = 0; i < precision; ++i) {
+      *--start = (char)('0' + fraction % 10u);
+      fraction /= 10u;
+    }
+    *--start = '.';
+  }
+  start = _rcutils_char_array_format_u64(fixed / powers_of_ten[precision], start);
+  if (negative) {
+    *--start = '-';
+  }
+  return rcutils_char_array_append_n(char_array, start, (size_t)(end - start));
+}
@@ -12,9 +12,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <stdint.h>
 #include <string.h>
 
 #include "rcutils/cmdline_parser.h"
+#include "rcutils/error_handling.h"
+#include "rcutils/types/hash_map.h"
 
 bool rcutils_cli_option_exist(char ** begin, char ** end, const char * option)
 {
@@ -31,8 +34,9 @@ char * rcutils_cli_get_option(char ** begin, char ** end, const char * option)
 {
   size_t idx = 0;
   size_t end_idx = (size_t)(end - begin);
+  size_t option_length = strlen(option);
   for (; idx < end_idx; ++idx) {
-    if (strncmp(begin[idx], option, strlen(option)) == 0) {
+    if (strncmp(begin[idx], option, option_length) == 0) {
       break;
     }
   }
@@ -43,3 +47,165 @@ char * rcutils_cli_get_option(char ** begin, char ** end, const char * option)
 
   return NULL;
 }
+
+// The distinct arguments, with the positions where they occur
+typedef struct cli_index_slot_s
+{
+  // The first position of the argument, valid if count isn't 0
+  size_t first;
+  size_t count;
+  // The offset of the positions of the argument in the positions array
+  size_t offset;
+} cli_index_slot_t;
+
+// Allocated as a single block, with the slots and positions after it.
+typedef struct rcutils_cli_index_impl_t
+{
+  rcutils_allocator_t allocator;
+  char ** args;
+  size_t args_count;
+  // Open addressing hash table of the distinct arguments
+  cli_index_slot_t * slots;
+  size_t slots_mask;
+  size_t * positions;
+} rcutils_cli_index_impl_t;
+
+static cli_index_slot_t *
+cli_index_find_slot(const rcutils_cli_index_impl_t * impl, const char * option)
+{
+  size_t slot = rcutils_hash_map_bytes_hash(option, strlen(option)) & impl->slots_mask;
+  while (
+    0u != impl->slots[slot].count && 0 != strcmp(impl->args[impl->slots[slot].first], option))
+  {
+    slot = (slot + 1) & impl->slots_mask;
+  }
+  return &impl->slots[slot];
+}
+
+rcutils_cli_index_t
+rcutils_get_zero_initialized_cli_index(void)
+{
+  static rcutils_cli_index_t zero_initialized_cli_index = {NULL};
+  return zero_initialized_cli_index;
+}
+
+rcutils_ret_t
+rcutils_cli_index_init(
+  rcutils_cli_index_t * index,
+  char ** begin,
+  char ** end,
+  rcutils_allocator_t allocator)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(index, RCUTILS_RET_INVALID_ARGUMENT);
+  if (NULL != index->impl) {
+    RCUTILS_SET_ERROR_MSG("index is already initialized");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  if (begin > end || (NULL == begin && begin != end)) {
+    RCUTILS_SET_ERROR_MSG("invalid range of arguments");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  RCUTILS_CHECK_ALLOCATOR_WITH_MSG(
+    &allocator, "invalid allocator", return RCUTILS_RET_INVALID_ARGUMENT);
+
+  size_t args_count = (size_t)(end - begin);
+  // At most half of the slots are used, so that probing stays short
+  size_t slots_count = 16u;
+  while (slots_count < 2u * args_count) {
+    slots_count *= 2u;
+  }
+  size_t slots_offset = sizeof(rcutils_cli_index_impl_t);
+  size_t positions_offset = slots_offset + slots_count * sizeof(cli_index_slot_t);
+  uint8_t * block = allocator.zero_allocate(
+    1u, positions_offset + args_count * sizeof(size_t), allocator.state);
+  if (NULL == block) {
+    RCUTILS_SET_ERROR_MSG("failed to allocate the command line index");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  rcutils_cli_index_impl_t * impl = (rcutils_cli_index_impl_t *)block;
+  impl->allocator = allocator;
+  impl->args = begin;
+  impl->args_count = args_count;
+  impl->slots = (cli_index_slot_t *)(block + slots_offset);
+  impl->slots_mask = slots_count - 1u;
+  impl->positions = (size_t *)(block + positions_offset);
+
+  // Count the occurrences of each argument, then lay their positions out one after the other
+  for (size_t i = 0; i < args_count; ++i) {
+    if (NULL == begin[i]) {
+      continue;
+    }
+    cli_index_slot_t * slot = cli_index_find_slot(impl, begin[i]);
+    if (0u == slot->count) {
+      slot->first = i;
+    }
+    ++slot->count;
+  }
+  size_t offset = 0u;
+  for (size_t i = 0; i < slots_count; ++i) {
+    impl->slots[i].offset = offset;
+    offset += impl->slots[i].count;
+  }
+  for (size_t i = 0; i < args_count; ++i) {
+    if (NULL != begin[i]) {
+      cli_index_slot_t * slot = cli_index_find_slot(impl, begin[i]);
+      impl->positions[slot->offset++] = i;
+    }
+  }
+  // Move the offsets back to the first positions
+  for (size_t i = 0; i < slots_count; ++i) {
+    impl->slots[i].offset -= impl->slots[i].count;
+  }
+
+  index->impl = impl;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_cli_index_fini(rcutils_cli_index_t * index)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(index, RCUTILS_RET_INVALID_ARGUMENT);
+  if (NULL != index->impl) {
+    rcutils_allocator_t allocator = index->impl->allocator;
+    allocator.deallocate(index->impl, allocator.state);
+    index->impl = NULL;
+  }
+  return RCUTILS_RET_OK;
+}
+
+const size_t *
+rcutils_cli_index_get_positions(
+  const rcutils_cli_index_t * index, const char * option, size_t * count)
+{
+  if (NULL != count) {
+    *count = 0u;
+  }
+  if (NULL == index || NULL == index->impl || NULL == option || NULL == count) {
+    return NULL;
+  }
+  const cli_index_slot_t * slot = cli_index_find_slot(index->impl, option);
+  if (0u == slot->count) {
+    return NULL;
+  }
+  *count = slot->count;
+  return &index->impl->positions[slot->offset];
+}
+
+bool
+rcutils_cli_index_option_exist(const rcutils_cli_index_t * index, const char * option)
+{
+  size_t count;
+  return NULL != rcutils_cli_index_get_positions(index, option, &count);
+}
+
+char *
+rcutils_cli_index_get_option(const rcutils_cli_index_t * index, const char * option)
+{
+  size_t count;
+  const size_t * positions = rcutils_cli_index_get_positions(index, option, &count);
+  // The positions are increasing, so the first one is where the option first occurs
+  if (NULL == positions || positions[0] + 1u == index->impl->args_count) {
+    return NULL;
+  }
+  return index->impl->args[positions[0] + 1u];
+}
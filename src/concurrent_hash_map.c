@@ -0,0 +1,483 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef _WIN32
+// See the comment in logging.c about warning C5105.
+# pragma warning(push)
+# pragma warning(disable : 5105)
+# include <windows.h>
+# pragma warning(pop)
+#else
+# include <sched.h>
+#endif
+
+#include "rcutils/error_handling.h"
+#include "rcutils/stdatomic_helper.h"
+#include "rcutils/types/concurrent_hash_map.h"
+
+#define RCUTILS_CONCURRENT_HASH_MAP_SHARD_BITS 4
+#define RCUTILS_CONCURRENT_HASH_MAP_SHARDS (1 << RCUTILS_CONCURRENT_HASH_MAP_SHARD_BITS)
+#define RCUTILS_CONCURRENT_HASH_MAP_MIN_SLOTS 8
+#define RCUTILS_CONCURRENT_HASH_MAP_CACHE_LINE_SIZE 64
+
+// The states of a slot, a slot never goes back to empty in the same table.
+#define SLOT_EMPTY 0
+#define SLOT_FULL 1
+#define SLOT_REMOVED 2
+
+typedef struct rcutils_concurrent_hash_map_slot_t
+{
+  // One of the SLOT_ constants, the other fields are written before it becomes SLOT_FULL.
+  atomic_uint_least64_t state;
+  size_t hash;
+  // Followed by the key and the value, each padded to a multiple of 8 bytes.
+} rcutils_concurrent_hash_map_slot_t;
+
+typedef struct rcutils_concurrent_hash_map_table_t
+{
+  size_t mask;
+  // The number of slots which aren't empty, only accessed by the writers.
+  size_t used;
+  // The next table retired by the same shard.
+  struct rcutils_concurrent_hash_map_table_t * next_retired;
+  // Followed by the slots.
+} rcutils_concurrent_hash_map_table_t;
+
+typedef struct rcutils_concurrent_hash_map_shard_t
+{
+  // The current table, read by everyone and written by the writers with the lock held.
+  atomic_uintptr_t table;
+  atomic_uint_least64_t size;
+  char padding0[RCUTILS_CONCURRENT_HASH_MAP_CACHE_LINE_SIZE];
+  // The number of readers currently in the shard.
+  atomic_uint_least64_t readers;
+  char padding1[RCUTILS_CONCURRENT_HASH_MAP_CACHE_LINE_SIZE];
+  atomic_bool lock;
+  // The tables replaced while readers were in the shard, freed once there are none.
+  rcutils_concurrent_hash_map_table_t * retired;
+  char padding2[RCUTILS_CONCURRENT_HASH_MAP_CACHE_LINE_SIZE];
+} rcutils_concurrent_hash_map_shard_t;
+
+typedef struct rcutils_concurrent_hash_map_impl_s
+{
+  size_t key_size;
+  size_t data_size;
+  // The offsets of the key, the value and the next slot from the start of a slot.
+  size_t key_offset;
+  size_t value_offset;
+  size_t slot_size;
+  rcutils_hash_map_key_hasher_t key_hashing_func;
+  rcutils_hash_map_key_cmp_t key_cmp_func;
+  rcutils_allocator_t allocator;
+  rcutils_concurrent_hash_map_shard_t shards[RCUTILS_CONCURRENT_HASH_MAP_SHARDS];
+} rcutils_concurrent_hash_map_impl_t;
+
+static size_t
+_round_up_to_8(size_t size)
+{
+  return (size + 7) & ~(size_t)7;
+}
+
+static rcutils_concurrent_hash_map_slot_t *
+_get_slot(
+  const rcutils_concurrent_hash_map_impl_t * impl,
+  const rcutils_concurrent_hash_map_table_t * table,
+  size_t index)
+{
+  return (rcutils_concurrent_hash_map_slot_t *)((uint8_t *)table +
+         _round_up_to_8(sizeof(rcutils_concurrent_hash_map_table_t)) + index * impl->slot_size);
+}
+
+static rcutils_concurrent_hash_map_shard_t *
+_get_shard(rcutils_concurrent_hash_map_impl_t * impl, size_t hash)
+{
+  // The slots are selected by the low bits of the hash, so mix it to select the shard.
+  uint64_t mixed = (uint64_t)hash * 0x9E3779B97F4A7C15ull;
+  return &impl->shards[mixed >> (64 - RCUTILS_CONCURRENT_HASH_MAP_SHARD_BITS)];
+}
+
+static void
+_lock_shard(rcutils_concurrent_hash_map_shard_t * shard)
+{
+  while (rcutils_atomic_exchange_bool(&shard->lock, true)) {
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+  }
+}
+
+static void
+_unlock_shard(rcutils_concurrent_hash_map_shard_t * shard)
+{
+  rcutils_atomic_store(&shard->lock, false);
+}
+
+static rcutils_concurrent_hash_map_table_t *
+_allocate_table(const rcutils_concurrent_hash_map_impl_t * impl, size_t slot_count)
+{
+  size_t header_size = _round_up_to_8(sizeof(rcutils_concurrent_hash_map_table_t));
+  if (slot_count > (SIZE_MAX - header_size) / impl->slot_size) {
+    return NULL;
+  }
+  rcutils_concurrent_hash_map_table_t * table = impl->allocator.zero_allocate(
+    1, header_size + slot_count * impl->slot_size, impl->allocator.state);
+  if (NULL == table) {
+    return NULL;
+  }
+  table->mask = slot_count - 1;
+  table->used = 0;
+  table->next_retired = NULL;
+  for (size_t i = 0; i < slot_count; ++i) {
+    rcutils_atomic_store(&_get_slot(impl, table, i)->state, (uint64_t)SLOT_EMPTY);
+  }
+  return table;
+}
+
+// Returns the number of slots for a table holding count entries at most half full.
+static size_t
+_get_slot_count(size_t count)
+{
+  size_t slot_count = RCUTILS_CONCURRENT_HASH_MAP_MIN_SLOTS;
+  while (slot_count / 2 < count && slot_count <= SIZE_MAX / 4) {
+    slot_count *= 2;
+  }
+  return slot_count;
+}
+
+// Look up the key in the table, returning its slot or NULL.
+static rcutils_concurrent_hash_map_slot_t *
+_find_slot(
+  const rcutils_concurrent_hash_map_impl_t * impl,
+  const rcutils_concurrent_hash_map_table_t * table,
+  const void * key,
+  size_t hash)
+{
+  for (size_t i = 0, index = hash & table->mask; i <= table->mask;
+    ++i, index = (index + 1) & table->mask)
+  {
+    rcutils_concurrent_hash_map_slot_t * slot = _get_slot(impl, table, index);
+    uint64_t state = rcutils_atomic_load_uint64_t(&slot->state);
+    if (SLOT_EMPTY == state) {
+      break;
+    }
+    if (SLOT_FULL == state && slot->hash == hash &&
+      0 == impl->key_cmp_func((uint8_t *)slot + impl->key_offset, key))
+    {
+      return slot;
+    }
+  }
+  return NULL;
+}
+
+// Returns the first empty slot of the probe sequence of the hash, there's always one.
+static rcutils_concurrent_hash_map_slot_t *
+_find_empty_slot(
+  const rcutils_concurrent_hash_map_impl_t * impl,
+  const rcutils_concurrent_hash_map_table_t * table,
+  size_t hash)
+{
+  size_t index = hash & table->mask;
+  for (;;) {
+    rcutils_concurrent_hash_map_slot_t * slot = _get_slot(impl, table, index);
+    if (SLOT_EMPTY == rcutils_atomic_load_uint64_t(&slot->state)) {
+      return slot;
+    }
+    index = (index + 1) & table->mask;
+  }
+}
+
+// Free the retired tables of the shard if no reader can still be using them.
+static void
+_reclaim_retired_tables(
+  rcutils_concurrent_hash_map_impl_t * impl, rcutils_concurrent_hash_map_shard_t * shard)
+{
+  // The new table was published before loading the count, so a reader counted after this
+  // only sees the new table.
+  if (NULL == shard->retired || 0 != rcutils_atomic_load_uint64_t(&shard->readers)) {
+    return;
+  }
+  while (NULL != shard->retired) {
+    rcutils_concurrent_hash_map_table_t * next = shard->retired->next_retired;
+    impl->allocator.deallocate(shard->retired, impl->allocator.state);
+    shard->retired = next;
+  }
+}
+
+// Replace the table of the shard by one with room for one more entry, without removed slots.
+static rcutils_ret_t
+_grow_shard(
+  rcutils_concurrent_hash_map_impl_t * impl, rcutils_concurrent_hash_map_shard_t * shard)
+{
+  rcutils_concurrent_hash_map_table_t * table =
+    (rcutils_concurrent_hash_map_table_t *)rcutils_atomic_load_uintptr_t(&shard->table);
+  size_t size = (size_t)rcutils_atomic_load_uint64_t(&shard->size);
+  rcutils_concurrent_hash_map_table_t * new_table = _allocate_table(
+    impl, _get_slot_count(size + 1));
+  if (NULL == new_table) {
+    RCUTILS_SET_ERROR_MSG("failed to allocate memory for concurrent hash map slots");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  for (size_t i = 0; i <= table->mask; ++i) {
+    rcutils_concurrent_hash_map_slot_t * slot = _get_slot(impl, table, i);
+    if (SLOT_FULL != rcutils_atomic_load_uint64_t(&slot->state)) {
+      continue;
+    }
+    rcutils_concurrent_hash_map_slot_t * new_slot = _find_empty_slot(impl, new_table, slot->hash);
+    memcpy(new_slot, slot, impl->slot_size);
+    ++new_table->used;
+  }
+  rcutils_atomic_store(&shard->table, (uintptr_t)new_table);
+  table->next_retired = shard->retired;
+  shard->retired = table;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_concurrent_hash_map_t
+rcutils_get_zero_initialized_concurrent_hash_map(void)
+{
+  static rcutils_concurrent_hash_map_t zero_initialized_concurrent_hash_map = {NULL};
+  return zero_initialized_concurrent_hash_map;
+}
+
+rcutils_ret_t
+rcutils_concurrent_hash_map_init(
+  rcutils_concurrent_hash_map_t * hash_map,
+  size_t initial_capacity,
+  size_t key_size,
+  size_t data_size,
+  rcutils_hash_map_key_hasher_t key_hashing_func,
+  rcutils_hash_map_key_cmp_t key_cmp_func,
+  const rcutils_allocator_t * allocator)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(hash_map, RCUTILS_RET_INVALID_ARGUMENT);
+  if (NULL != hash_map->impl) {
+    RCUTILS_SET_ERROR_MSG("concurrent hash map is already initialized");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  if (0 == key_size || 0 == data_size) {
+    RCUTILS_SET_ERROR_MSG("key_size and data_size must be more than 0");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  if (key_size > SIZE_MAX / 4 || data_size > SIZE_MAX / 4) {
+    RCUTILS_SET_ERROR_MSG("key_size and data_size are too large");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(key_hashing_func, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(key_cmp_func, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ALLOCATOR_WITH_MSG(
+    allocator, "invalid allocator", return RCUTILS_RET_INVALID_ARGUMENT);
+
+  rcutils_concurrent_hash_map_impl_t * impl = allocator->allocate(
+    sizeof(rcutils_concurrent_hash_map_impl_t), allocator->state);
+  if (NULL == impl) {
+    RCUTILS_SET_ERROR_MSG("failed to allocate memory for concurrent hash map");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  impl->key_size = key_size;
+  impl->data_size = data_size;
+  impl->key_offset = _round_up_to_8(sizeof(rcutils_concurrent_hash_map_slot_t));
+  impl->value_offset = impl->key_offset + _round_up_to_8(key_size);
+  impl->slot_size = impl->value_offset + _round_up_to_8(data_size);
+  impl->key_hashing_func = key_hashing_func;
+  impl->key_cmp_func = key_cmp_func;
+  impl->allocator = *allocator;
+
+  // Spread the initial capacity over the shards, the keys being evenly distributed
+  size_t shard_capacity = initial_capacity / RCUTILS_CONCURRENT_HASH_MAP_SHARDS + 1;
+  for (size_t i = 0; i < RCUTILS_CONCURRENT_HASH_MAP_SHARDS; ++i) {
+    rcutils_concurrent_hash_map_shard_t * shard = &impl->shards[i];
+    rcutils_concurrent_hash_map_table_t * table = _allocate_table(
+      impl, _get_slot_count(shard_capacity));
+    if (NULL == table) {
+      for (size_t j = 0; j < i; ++j) {
+        allocator->deallocate(
+          (void *)rcutils_atomic_load_uintptr_t(&impl->shards[j].table), allocator->state);
+      }
+      allocator->deallocate(impl, allocator->state);
+      RCUTILS_SET_ERROR_MSG("failed to allocate memory for concurrent hash map slots");
+      return RCUTILS_RET_BAD_ALLOC;
+    }
+    rcutils_atomic_store(&shard->table, (uintptr_t)table);
+    rcutils_atomic_store(&shard->size, (uint64_t)0);
+    rcutils_atomic_store(&shard->readers, (uint64_t)0);
+    rcutils_atomic_store(&shard->lock, false);
+    shard->retired = NULL;
+  }
+
+  hash_map->impl = impl;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_concurrent_hash_map_fini(rcutils_concurrent_hash_map_t * hash_map)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(hash_map, RCUTILS_RET_INVALID_ARGUMENT);
+  rcutils_concurrent_hash_map_impl_t * impl = hash_map->impl;
+  if (NULL == impl) {
+    return RCUTILS_RET_OK;
+  }
+  for (size_t i = 0; i < RCUTILS_CONCURRENT_HASH_MAP_SHARDS; ++i) {
+    rcutils_concurrent_hash_map_shard_t * shard = &impl->shards[i];
+    while (NULL != shard->retired) {
+      rcutils_concurrent_hash_map_table_t * next = shard->retired->next_retired;
+      impl->allocator.deallocate(shard->retired, impl->allocator.state);
+      shard->retired = next;
+    }
+    impl->allocator.deallocate(
+      (void *)rcutils_atomic_load_uintptr_t(&shard->table), impl->allocator.state);
+  }
+  rcutils_allocator_t allocator = impl->allocator;
+  allocator.deallocate(impl, allocator.state);
+  hash_map->impl = NULL;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_concurrent_hash_map_get_size(
+  const rcutils_concurrent_hash_map_t * hash_map, size_t * size)
+{
+  HASH_MAP_VALIDATE_HASH_MAP(hash_map);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(size, RCUTILS_RET_INVALID_ARGUMENT);
+  *size = 0;
+  for (size_t i = 0; i < RCUTILS_CONCURRENT_HASH_MAP_SHARDS; ++i) {
+    *size += (size_t)rcutils_atomic_load_uint64_t(&hash_map->impl->shards[i].size);
+  }
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_concurrent_hash_map_set(
+  rcutils_concurrent_hash_map_t * hash_map, const void * key, const void * value)
+{
+  HASH_MAP_VALIDATE_HASH_MAP(hash_map);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(key, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(value, RCUTILS_RET_INVALID_ARGUMENT);
+  rcutils_concurrent_hash_map_impl_t * impl = hash_map->impl;
+  size_t hash = impl->key_hashing_func(key);
+  rcutils_concurrent_hash_map_shard_t * shard = _get_shard(impl, hash);
+
+  _lock_shard(shard);
+  rcutils_concurrent_hash_map_table_t * table =
+    (rcutils_concurrent_hash_map_table_t *)rcutils_atomic_load_uintptr_t(&shard->table);
+  // Keep the table at most three quarters used, so that lookups stop early enough
+  if (4 * (table->used + 1) > 3 * (table->mask + 1)) {
+    rcutils_ret_t ret = _grow_shard(impl, shard);
+    if (RCUTILS_RET_OK != ret) {
+      _unlock_shard(shard);
+      // error message already set
+      return ret;
+    }
+    table =
+      (rcutils_concurrent_hash_map_table_t *)rcutils_atomic_load_uintptr_t(&shard->table);
+  }
+  rcutils_concurrent_hash_map_slot_t * previous = _find_slot(impl, table, key, hash);
+  // Readers find the previous slot first until it's removed, which makes the new value visible
+  rcutils_concurrent_hash_map_slot_t * slot = _find_empty_slot(impl, table, hash);
+  slot->hash = hash;
+  memcpy((uint8_t *)slot + impl->key_offset, key, impl->key_size);
+  memcpy((uint8_t *)slot + impl->value_offset, value, impl->data_size);
+  rcutils_atomic_store(&slot->state, (uint64_t)SLOT_FULL);
+  ++table->used;
+  if (NULL != previous) {
+    rcutils_atomic_store(&previous->state, (uint64_t)SLOT_REMOVED);
+  } else {
+    rcutils_atomic_fetch_add_uint64_t(&shard->size, 1);
+  }
+  _reclaim_retired_tables(impl, shard);
+  _unlock_shard(shard);
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_concurrent_hash_map_unset(rcutils_concurrent_hash_map_t * hash_map, const void * key)
+{
+  HASH_MAP_VALIDATE_HASH_MAP(hash_map);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(key, RCUTILS_RET_INVALID_ARGUMENT);
+  rcutils_concurrent_hash_map_impl_t * impl = hash_map->impl;
+  size_t hash = impl->key_hashing_func(key);
+  rcutils_concurrent_hash_map_shard_t * shard = _get_shard(impl, hash);
+
+  _lock_shard(shard);
+  rcutils_concurrent_hash_map_table_t * table =
+    (rcutils_concurrent_hash_map_table_t *)rcutils_atomic_load_uintptr_t(&shard->table);
+  rcutils_concurrent_hash_map_slot_t * slot = _find_slot(impl, table, key, hash);
+  if (NULL == slot) {
+    _unlock_shard(shard);
+    RCUTILS_SET_ERROR_MSG("key not found in concurrent hash map");
+    return RCUTILS_RET_STRING_KEY_NOT_FOUND;
+  }
+  rcutils_atomic_store(&slot->state, (uint64_t)SLOT_REMOVED);
+  rcutils_atomic_fetch_add_uint64_t(&shard->size, (uint64_t)-1);
+  _reclaim_retired_tables(impl, shard);
+  _unlock_shard(shard);
+  return RCUTILS_RET_OK;
+}
+
+// Look up the key without any lock, copying its value to data if it's not NULL.
+static bool
+_concurrent_hash_map_read(
+  rcutils_concurrent_hash_map_impl_t * impl, const void * key, void * data)
+{
+  size_t hash = impl->key_hashing_func(key);
+  rcutils_concurrent_hash_map_shard_t * shard = _get_shard(impl, hash);
+
+  // Being counted before loading the table keeps it from being freed until done with it
+  rcutils_atomic_fetch_add_uint64_t(&shard->readers, 1);
+  rcutils_concurrent_hash_map_table_t * table =
+    (rcutils_concurrent_hash_map_table_t *)rcutils_atomic_load_uintptr_t(&shard->table);
+  rcutils_concurrent_hash_map_slot_t * slot = _find_slot(impl, table, key, hash);
+  if (NULL != slot && NULL != data) {
+    memcpy(data, (uint8_t *)slot + impl->value_offset, impl->data_size);
+  }
+  rcutils_atomic_fetch_add_uint64_t(&shard->readers, (uint64_t)-1);
+  return NULL != slot;
+}
+
+bool
+rcutils_concurrent_hash_map_key_exists(
+  const rcutils_concurrent_hash_map_t * hash_map, const void * key)
+{
+  if (NULL == hash_map || NULL == hash_map->impl || NULL == key) {
+    return false;
+  }
+  return _concurrent_hash_map_read(hash_map->impl, key, NULL);
+}
+
+rcutils_ret_t
+rcutils_concurrent_hash_map_get(
+  const rcutils_concurrent_hash_map_t * hash_map, const void * key, void * data)
+{
+  HASH_MAP_VALIDATE_HASH_MAP(hash_map);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(key, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(data, RCUTILS_RET_INVALID_ARGUMENT);
+  if (!_concurrent_hash_map_read(hash_map->impl, key, data)) {
+    return RCUTILS_RET_NOT_FOUND;
+  }
+  return RCUTILS_RET_OK;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,393 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <string.h>
+
+#include "rcutils/error_handling.h"
+#include "rcutils/stdatomic_helper.h"
+#include "rcutils/types/concurrent_queue.h"
+
+// The fields written by different threads are separated by this many bytes, so that they
+// don't share a cache line.
+#define RCUTILS_QUEUE_CACHE_LINE_SIZE 64
+
+typedef struct rcutils_spsc_queue_impl_s
+{
+  // Read only after initialization
+  uint8_t * slots;
+  uint64_t mask;
+  size_t element_size;
+  rcutils_allocator_t allocator;
+  char padding0[RCUTILS_QUEUE_CACHE_LINE_SIZE];
+  // Written by the consumer, the number of elements popped
+  atomic_uint_least64_t head;
+  // The tail as last seen by the consumer
+  uint64_t cached_tail;
+  char padding1[RCUTILS_QUEUE_CACHE_LINE_SIZE];
+  // Written by the producer, the number of elements pushed
+  atomic_uint_least64_t tail;
+  // The head as last seen by the producer
+  uint64_t cached_head;
+  char padding2[RCUTILS_QUEUE_CACHE_LINE_SIZE];
+} rcutils_spsc_queue_impl_t;
+
+typedef struct rcutils_mpsc_queue_impl_s
+{
+  // Read only after initialization, each slot being a sequence number followed by an element
+  uint8_t * slots;
+  uint64_t mask;
+  size_t element_size;
+  size_t slot_size;
+  rcutils_allocator_t allocator;
+  char padding0[RCUTILS_QUEUE_CACHE_LINE_SIZE];
+  // Written by the consumer, the number of elements popped
+  atomic_uint_least64_t head;
+  char padding1[RCUTILS_QUEUE_CACHE_LINE_SIZE];
+  // Written by the producers, the number of slots reserved
+  atomic_uint_least64_t tail;
+  char padding2[RCUTILS_QUEUE_CACHE_LINE_SIZE];
+} rcutils_mpsc_queue_impl_t;
+
+// Checks the arguments of an init function and rounds the capacity up to a power of two.
+static rcutils_ret_t
+_rcutils_queue_check_init(
+  const void * impl, size_t * capacity, size_t element_size, const rcutils_allocator_t * allocator)
+{
+  if (NULL != impl) {
+    RCUTILS_SET_ERROR_MSG("queue is already initialized");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  RCUTILS_CHECK_ALLOCATOR_WITH_MSG(
+    allocator, "invalid allocator", return RCUTILS_RET_INVALID_ARGUMENT);
+  if (0 == *capacity || 0 == element_size) {
+    RCUTILS_SET_ERROR_MSG("capacity and element_size must be more than 0");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  size_t rounded = 1;
+  while (rounded < *capacity) {
+    if (rounded > SIZE_MAX / 2) {
+      RCUTILS_SET_ERROR_MSG("capacity is too large");
+      return RCUTILS_RET_INVALID_ARGUMENT;
+    }
+    rounded *= 2;
+  }
+  *capacity = rounded;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_spsc_queue_t
+rcutils_get_zero_initialized_spsc_queue(void)
+{
+  static rcutils_spsc_queue_t zero_initialized_spsc_queue = {NULL};
+  return zero_initialized_spsc_queue;
+}
+
+rcutils_ret_t
+rcutils_spsc_queue_init(
+  rcutils_spsc_queue_t * queue,
+  size_t capacity,
+  size_t element_size,
+  const rcutils_allocator_t * allocator)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(queue, RCUTILS_RET_INVALID_ARGUMENT);
+  rcutils_ret_t ret = _rcutils_queue_check_init(queue->impl, &capacity, element_size, allocator);
+  if (RCUTILS_RET_OK != ret) {
+    // error message already set
+    return ret;
+  }
+  if (element_size > SIZE_MAX / capacity) {
+    RCUTILS_SET_ERROR_MSG("capacity and element_size are too large");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+
+  rcutils_spsc_queue_impl_t * impl = allocator->allocate(
+    sizeof(rcutils_spsc_queue_impl_t), allocator->state);
+  if (NULL == impl) {
+    RCUTILS_SET_ERROR_MSG("failed to allocate memory for spsc queue");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  impl->slots = allocator->allocate(capacity * element_size, allocator->state);
+  if (NULL == impl->slots) {
+    allocator->deallocate(impl, allocator->state);
+    RCUTILS_SET_ERROR_MSG("failed to allocate memory for spsc queue slots");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  impl->mask = (uint64_t)capacity - 1;
+  impl->element_size = element_size;
+  impl->allocator = *allocator;
+  rcutils_atomic_store(&impl->head, (uint64_t)0);
+  impl->cached_tail = 0;
+  rcutils_atomic_store(&impl->tail, (uint64_t)0);
+  impl->cached_head = 0;
+
+  queue->impl = impl;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_spsc_queue_fini(rcutils_spsc_queue_t * queue)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(queue, RCUTILS_RET_INVALID_ARGUMENT);
+  if (NULL == queue->impl) {
+    return RCUTILS_RET_OK;
+  }
+  rcutils_allocator_t allocator = queue->impl->allocator;
+  allocator.deallocate(queue->impl->slots, allocator.state);
+  allocator.deallocate(queue->impl, allocator.state);
+  queue->impl = NULL;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_spsc_queue_try_push(rcutils_spsc_queue_t * queue, const void * element)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(queue, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    queue->impl, "queue is not initialized", return RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(element, RCUTILS_RET_INVALID_ARGUMENT);
+  rcutils_spsc_queue_impl_t * impl = queue->impl;
+
+  uint64_t tail = rcutils_atomic_load_uint64_t(&impl->tail);
+  if (tail - impl->cached_head > impl->mask) {
+    // Only read the head of the consumer when the queue looks full
+    impl->cached_head = rcutils_atomic_load_uint64_t(&impl->head);
+    if (tail - impl->cached_head > impl->mask) {
+      return RCUTILS_RET_NOT_ENOUGH_SPACE;
+    }
+  }
+  memcpy(impl->slots + (size_t)(tail & impl->mask) * impl->element_size, element,
+    impl->element_size);
+  rcutils_atomic_store(&impl->tail, tail + 1);
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_spsc_queue_try_pop(rcutils_spsc_queue_t * queue, void * element)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(queue, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    queue->impl, "queue is not initialized", return RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(element, RCUTILS_RET_INVALID_ARGUMENT);
+  rcutils_spsc_queue_impl_t * impl = queue->impl;
+
+  uint64_t head = rcutils_atomic_load_uint64_t(&impl->head);
+  if (head == impl->cached_tail) {
+    // Only read the tail of the producer when the queue looks empty
+    impl->cached_tail = rcutils_atomic_load_uint64_t(&impl->tail);
+    if (head == impl->cached_tail) {
+      return RCUTILS_RET_QUEUE_EMPTY;
+    }
+  }
+  memcpy(element, impl->slots + (size_t)(head & impl->mask) * impl->element_size,
+    impl->element_size);
+  rcutils_atomic_store(&impl->head, head + 1);
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_spsc_queue_get_size(const rcutils_spsc_queue_t * queue, size_t * size)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(queue, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    queue->impl, "queue is not initialized", return RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(size, RCUTILS_RET_INVALID_ARGUMENT);
+  // Load the head first, so that the tail is never behind it
+  uint64_t head = rcutils_atomic_load_uint64_t(&queue->impl->head);
+  uint64_t tail = rcutils_atomic_load_uint64_t(&queue->impl->tail);
+  *size = (size_t)(tail - head);
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_spsc_queue_get_capacity(const rcutils_spsc_queue_t * queue, size_t * capacity)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(queue, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    queue->impl, "queue is not initialized", return RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(capacity, RCUTILS_RET_INVALID_ARGUMENT);
+  *capacity = (size_t)queue->impl->mask + 1;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_mpsc_queue_t
+rcutils_get_zero_initialized_mpsc_queue(void)
+{
+  static rcutils_mpsc_queue_t zero_initialized_mpsc_queue = {NULL};
+  return zero_initialized_mpsc_queue;
+}
+
+static atomic_uint_least64_t *
+_rcutils_mpsc_queue_get_sequence(const rcutils_mpsc_queue_impl_t * impl, uint64_t position)
+{
+  return (atomic_uint_least64_t *)(impl->slots + (size_t)(position & impl->mask) *
+         impl->slot_size);
+}
+
+rcutils_ret_t
+rcutils_mpsc_queue_init(
+  rcutils_mpsc_queue_t * queue,
+  size_t capacity,
+  size_t element_size,
+  const rcutils_allocator_t * allocator)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(queue, RCUTILS_RET_INVALID_ARGUMENT);
+  rcutils_ret_t ret = _rcutils_queue_check_init(queue->impl, &capacity, element_size, allocator);
+  if (RCUTILS_RET_OK != ret) {
+    // error message already set
+    return ret;
+  }
+  // Keep the sequence number of every slot aligned
+  const size_t sequence_size = sizeof(atomic_uint_least64_t);
+  if (element_size > SIZE_MAX - 2 * sequence_size) {
+    RCUTILS_SET_ERROR_MSG("element_size is too large");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  size_t slot_size = sequence_size +
+    (element_size + sequence_size - 1) / sequence_size * sequence_size;
+  if (slot_size > SIZE_MAX / capacity) {
+    RCUTILS_SET_ERROR_MSG("capacity and element_size are too large");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+
+  rcutils_mpsc_queue_impl_t * impl = allocator->allocate(
+    sizeof(rcutils_mpsc_queue_impl_t), allocator->state);
+  if (NULL == impl) {
+    RCUTILS_SET_ERROR_MSG("failed to allocate memory for mpsc queue");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  impl->slots = allocator->allocate(capacity * slot_size, allocator->state);
+  if (NULL == impl->slots) {
+    allocator->deallocate(impl, allocator->state);
+    RCUTILS_SET_ERROR_MSG("failed to allocate memory for mpsc queue slots");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  impl->mask = (uint64_t)capacity - 1;
+  impl->element_size = element_size;
+  impl->slot_size = slot_size;
+  impl->allocator = *allocator;
+  // The slot at position p is free for the producer reserving p when its sequence is p
+  for (uint64_t position = 0; position < (uint64_t)capacity; ++position) {
+    rcutils_atomic_store(_rcutils_mpsc_queue_get_sequence(impl, position), position);
+  }
+  rcutils_atomic_store(&impl->head, (uint64_t)0);
+  rcutils_atomic_store(&impl->tail, (uint64_t)0);
+
+  queue->impl = impl;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_mpsc_queue_fini(rcutils_mpsc_queue_t * queue)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(queue, RCUTILS_RET_INVALID_ARGUMENT);
+  if (NULL == queue->impl) {
+    return RCUTILS_RET_OK;
+  }
+  rcutils_allocator_t allocator = queue->impl->allocator;
+  allocator.deallocate(queue->impl->slots, allocator.state);
+  allocator.deallocate(queue->impl, allocator.state);
+  queue->impl = NULL;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_mpsc_queue_try_push(rcutils_mpsc_queue_t * queue, const void * element)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(queue, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    queue->impl, "queue is not initialized", return RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(element, RCUTILS_RET_INVALID_ARGUMENT);
+  rcutils_mpsc_queue_impl_t * impl = queue->impl;
+
+  uint64_t position = rcutils_atomic_load_uint64_t(&impl->tail);
+  atomic_uint_least64_t * sequence;
+  for (;;) {
+    sequence = _rcutils_mpsc_queue_get_sequence(impl, position);
+    int64_t difference = (int64_t)(rcutils_atomic_load_uint64_t(sequence) - position);
+    if (0 == difference) {
+      // The slot is free, try to reserve it
+      uint64_t expected = position;
+      if (rcutils_atomic_compare_exchange_strong_uint_least64_t(
+          &impl->tail, &expected, position + 1))
+      {
+        break;
+      }
+    } else if (difference < 0) {
+      // The slot still holds the element pushed a lap ago
+      return RCUTILS_RET_NOT_ENOUGH_SPACE;
+    }
+    // Another producer reserved the slot first
+    position = rcutils_atomic_load_uint64_t(&impl->tail);
+  }
+  memcpy((uint8_t *)sequence + sizeof(atomic_uint_least64_t), element, impl->element_size);
+  // Publish the element to the consumer
+  rcutils_atomic_store(sequence, position + 1);
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_mpsc_queue_try_pop(rcutils_mpsc_queue_t * queue, void * element)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(queue, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    queue->impl, "queue is not initialized", return RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(element, RCUTILS_RET_INVALID_ARGUMENT);
+  rcutils_mpsc_queue_impl_t * impl = queue->impl;
+
+  uint64_t position = rcutils_atomic_load_uint64_t(&impl->head);
+  atomic_uint_least64_t * sequence = _rcutils_mpsc_queue_get_sequence(impl, position);
+  if (rcutils_atomic_load_uint64_t(sequence) != position + 1) {
+    return RCUTILS_RET_QUEUE_EMPTY;
+  }
+  memcpy(element, (uint8_t *)sequence + sizeof(atomic_uint_least64_t), impl->element_size);
+  // Free the slot for the producer reserving it on the next lap
+  rcutils_atomic_store(sequence, position + impl->mask + 1);
+  rcutils_atomic_store(&impl->head, position + 1);
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_mpsc_queue_get_size(const rcutils_mpsc_queue_t * queue, size_t * size)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(queue, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    queue->impl, "queue is not initialized", return RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(size, RCUTILS_RET_INVALID_ARGUMENT);
+  // Load the head first, so that the tail is never behind it
+  uint64_t head = rcutils_atomic_load_uint64_t(&queue->impl->head);
+  uint64_t tail = rcutils_atomic_load_uint64_t(&queue->impl->tail);
+  *size = (size_t)(tail - head);
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_mpsc_queue_get_capacity(const rcutils_mpsc_queue_t * queue, size_t * capacity)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(queue, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    queue->impl, "queue is not initialized", return RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(capacity, RCUTILS_RET_INVALID_ARGUMENT);
+  *capacity = (size_t)queue->impl->mask + 1;
+  return RCUTILS_RET_OK;
+}
+
+#ifdef __cplusplus
+}
+#endif
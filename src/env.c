@@ -18,11 +18,165 @@ extern "C"
 #endif
 
 #include <errno.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#if defined(__APPLE__)
+# include <crt_externs.h>
+#elif !defined(_WIN32)
+extern char ** environ;
+#endif
 
 #include "rcutils/env.h"
 #include "rcutils/error_handling.h"
+#include "rcutils/strcasecmp.h"
+
+typedef struct env_snapshot_entry_s
+{
+  const char * name;
+  size_t name_length;
+  const char * value;
+} env_snapshot_entry_t;
+
+// The snapshot of the environment, allocated as a single block.
+typedef struct env_snapshot_s
+{
+  rcutils_allocator_t allocator;
+  // Open addressing hash table of 1 + the index of the entries, or 0 for empty slots
+  size_t * slots;
+  size_t slots_mask;
+  env_snapshot_entry_t * entries;
+} env_snapshot_t;
+
+static env_snapshot_t * g_rcutils_env_snapshot = NULL;
+
+static char **
+env_snapshot_get_environ(void)
+{
+#if defined(__APPLE__)
+  return *_NSGetEnviron();
+#elif defined(_WIN32)
+# pragma warning(push)
+# pragma warning(disable : 4996)
+  return _environ;
+# pragma warning(pop)
+#else
+  return environ;
+#endif
+}
+
+// Hashes the name with FNV-1a, ignoring case on Windows where names are case insensitive
+static size_t
+env_snapshot_hash(const char * name, size_t name_length)
+{
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (size_t i = 0; i < name_length; ++i) {
+    unsigned char c = (unsigned char)name[i];
+#ifdef _WIN32
+    if ((unsigned char)(c - 'A') < 26u) {
+      c |= 0x20;
+    }
+#endif
+    hash = (hash ^ c) * 0x100000001b3ull;
+  }
+  return (size_t)(hash ^ (hash >> 32));
+}
+
+static bool
+env_snapshot_name_equal(const env_snapshot_entry_t * entry, const char * name, size_t name_length)
+{
+  if (entry->name_length != name_length) {
+    return false;
+  }
+#ifdef _WIN32
+  int value = 0;
+  return 0 == rcutils_strncasecmp(entry->name, name, name_length, &value) && 0 == value;
+#else
+  return 0 == memcmp(entry->name, name, name_length);
+#endif
+}
+
+static const env_snapshot_entry_t *
+env_snapshot_find(const env_snapshot_t * snapshot, const char * name, size_t name_length)
+{
+  size_t slot = env_snapshot_hash(name, name_length) & snapshot->slots_mask;
+  while (0 != snapshot->slots[slot]) {
+    const env_snapshot_entry_t * entry = &snapshot->entries[snapshot->slots[slot] - 1];
+    if (env_snapshot_name_equal(entry, name, name_length)) {
+      return entry;
+    }
+    slot = (slot + 1) & snapshot->slots_mask;
+  }
+  return NULL;
+}
+
+static env_snapshot_t *
+env_snapshot_create(const rcutils_allocator_t * allocator)
+{
+  char ** env = env_snapshot_get_environ();
+  size_t count = 0;
+  size_t strings_size = 0;
+  for (size_t i = 0; NULL != env && NULL != env[i]; ++i) {
+    ++count;
+    strings_size += strlen(env[i]) + 1;
+  }
+  // At most half of the slots are used, so that probing stays short
+  size_t slots_count = 16;
+  while (slots_count < 2 * count) {
+    slots_count *= 2;
+  }
+  size_t entries_offset = sizeof(env_snapshot_t) + slots_count * sizeof(size_t);
+  size_t strings_offset = entries_offset + count * sizeof(env_snapshot_entry_t);
+  uint8_t * block = allocator->zero_allocate(
+    1, strings_offset + strings_size, allocator->state);
+  if (NULL == block) {
+    return NULL;
+  }
+  env_snapshot_t * snapshot = (env_snapshot_t *)block;
+  snapshot->allocator = *allocator;
+  snapshot->slots = (size_t *)(block + sizeof(env_snapshot_t));
+  snapshot->slots_mask = slots_count - 1;
+  snapshot->entries = (env_snapshot_entry_t *)(block + entries_offset);
+  char * strings = (char *)(block + strings_offset);
+
+  size_t entries_count = 0;
+  for (size_t i = 0; i < count; ++i) {
+    size_t length = strlen(env[i]);
+    const char * separator = strchr(env[i], '=');
+    // Entries without a name, such as "=C:" on Windows, can't be looked up
+    if (NULL == separator || separator == env[i]) {
+      continue;
+    }
+    size_t name_length = (size_t)(separator - env[i]);
+    // The first of several entries of the same name is the one getenv() finds
+    if (NULL != env_snapshot_find(snapshot, env[i], name_length)) {
+      continue;
+    }
+    memcpy(strings, env[i], length + 1);
+    env_snapshot_entry_t * entry = &snapshot->entries[entries_count];
+    entry->name = strings;
+    entry->name_length = name_length;
+    entry->value = strings + name_length + 1;
+    strings += length + 1;
+    size_t slot = env_snapshot_hash(entry->name, name_length) & snapshot->slots_mask;
+    while (0 != snapshot->slots[slot]) {
+      slot = (slot + 1) & snapshot->slots_mask;
+    }
+    snapshot->slots[slot] = ++entries_count;
+  }
+  return snapshot;
+}
+
+static void
+env_snapshot_destroy(env_snapshot_t * snapshot)
+{
+  if (NULL != snapshot) {
+    rcutils_allocator_t allocator = snapshot->allocator;
+    allocator.deallocate(snapshot, allocator.state);
+  }
+}
 
 bool
 rcutils_set_env(const char * env_name, const char * env_value)
@@ -54,6 +208,13 @@ rcutils_set_env(const char * env_name, const char * env_value)
   }
 #endif
 
+  if (NULL != g_rcutils_env_snapshot) {
+    // If the snapshot can't be rebuilt, the variables are looked up with getenv() again
+    env_snapshot_t * snapshot = env_snapshot_create(&g_rcutils_env_snapshot->allocator);
+    env_snapshot_destroy(g_rcutils_env_snapshot);
+    g_rcutils_env_snapshot = snapshot;
+  }
+
   return true;
 }
 
@@ -74,8 +235,7 @@ rcutils_get_env(const char * env_name, const char ** env_value)
     return "argument env_value is null";
   }
 
-  // TODO(Suyash458): getenv is deprecated on Windows; consider using getenv_s instead
-  *env_value = getenv(env_name);
+  *env_value = rcutils_env_snapshot_get(env_name);
 
   if (NULL == *env_value) {
     *env_value = "";
@@ -83,10 +243,56 @@ rcutils_get_env(const char * env_name, const char ** env_value)
   return NULL;
 }
 
+const char *
+rcutils_env_snapshot_get(const char * env_name)
+{
+  if (NULL == env_name) {
+    return NULL;
+  }
+  if (NULL != g_rcutils_env_snapshot) {
+    const env_snapshot_entry_t * entry =
+      env_snapshot_find(g_rcutils_env_snapshot, env_name, strlen(env_name));
+    return NULL == entry ? NULL : entry->value;
+  }
+  // TODO(Suyash458): getenv is deprecated on Windows; consider using getenv_s instead
+  return getenv(env_name);
+}
+
 #ifdef _WIN32
 #pragma warning(pop)
 #endif
 
+rcutils_ret_t
+rcutils_env_snapshot_init(rcutils_allocator_t allocator)
+{
+  RCUTILS_CAN_RETURN_WITH_ERROR_OF(RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CAN_RETURN_WITH_ERROR_OF(RCUTILS_RET_BAD_ALLOC);
+
+  RCUTILS_CHECK_ALLOCATOR_WITH_MSG(
+    &allocator, "invalid allocator", return RCUTILS_RET_INVALID_ARGUMENT);
+  env_snapshot_t * snapshot = env_snapshot_create(&allocator);
+  if (NULL == snapshot) {
+    RCUTILS_SET_ERROR_MSG("failed to allocate the snapshot of the environment");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  env_snapshot_destroy(g_rcutils_env_snapshot);
+  g_rcutils_env_snapshot = snapshot;
+  return RCUTILS_RET_OK;
+}
+
+void
+rcutils_env_snapshot_fini(void)
+{
+  env_snapshot_destroy(g_rcutils_env_snapshot);
+  g_rcutils_env_snapshot = NULL;
+}
+
+bool
+rcutils_env_snapshot_is_enabled(void)
+{
+  return NULL != g_rcutils_env_snapshot;
+}
+
 const char *
 rcutils_get_home_dir(void)
 {
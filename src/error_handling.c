@@ -29,6 +29,7 @@ extern "C"
 
 #include <rcutils/allocator.h>
 #include <rcutils/macros.h>
+#include <rcutils/stdatomic_helper.h>
 #include <rcutils/strdup.h>
 
 // RCUTILS_REPORT_ERROR_HANDLING_ERRORS and RCUTILS_WARN_ON_TRUNCATION are set in the header below
@@ -41,6 +42,91 @@ RCUTILS_THREAD_LOCAL bool gtls_rcutils_error_string_is_formatted = false;
 RCUTILS_THREAD_LOCAL rcutils_error_string_t gtls_rcutils_error_string;
 RCUTILS_THREAD_LOCAL bool gtls_rcutils_error_is_set = false;
 
+// Set by rcutils_set_error_state_static(), and copied into the error state only when asked.
+RCUTILS_THREAD_LOCAL bool gtls_rcutils_error_state_is_deferred = false;
+RCUTILS_THREAD_LOCAL const char * gtls_rcutils_deferred_error_message = NULL;
+RCUTILS_THREAD_LOCAL const char * gtls_rcutils_deferred_error_file = NULL;
+RCUTILS_THREAD_LOCAL size_t gtls_rcutils_deferred_error_line_number = 0;
+RCUTILS_THREAD_LOCAL rcutils_ret_t gtls_rcutils_error_code = RCUTILS_RET_OK;
+
+// An overwritten error, whose message and file are copied into the entry unless it was deferred.
+typedef struct rcutils_error_history_entry_s
+{
+  const char * deferred_message;
+  const char * deferred_file;
+  uint64_t line_number;
+  char message[RCUTILS_ERROR_HISTORY_STRING_MAX_LENGTH];
+  char file[RCUTILS_ERROR_HISTORY_STRING_MAX_LENGTH];
+} rcutils_error_history_entry_t;
+
+static atomic_bool g_rcutils_error_history_enabled = ATOMIC_VAR_INIT(false);
+RCUTILS_THREAD_LOCAL rcutils_error_history_entry_t
+  gtls_rcutils_error_history[RCUTILS_ERROR_HISTORY_SIZE];
+// The number of errors recorded into the ring since the history was cleared.
+RCUTILS_THREAD_LOCAL size_t gtls_rcutils_error_history_count = 0;
+
+static
+void
+__copy_deferred_error_state(void)
+{
+  if (!gtls_rcutils_error_state_is_deferred) {
+    return;
+  }
+  __rcutils_copy_string(
+    gtls_rcutils_error_state.message, sizeof(gtls_rcutils_error_state.message),
+    gtls_rcutils_deferred_error_message);
+  __rcutils_copy_string(
+    gtls_rcutils_error_state.file, sizeof(gtls_rcutils_error_state.file),
+    gtls_rcutils_deferred_error_file);
+  gtls_rcutils_error_state.line_number = gtls_rcutils_deferred_error_line_number;
+  gtls_rcutils_error_state_is_deferred = false;
+}
+
+// Copies, silently truncating, unlike __rcutils_copy_string() which reports the truncation.
+static
+void
+__copy_truncated_string(char * dst, size_t dst_size, const char * src)
+{
+  size_t length = strnlen(src, dst_size - 1);
+  memcpy(dst, src, length);
+  dst[length] = '\0';
+}
+
+static
+bool
+__error_history_is_enabled(void)
+{
+  return rcutils_atomic_load_bool(&g_rcutils_error_history_enabled);
+}
+
+// Records the current error in the history, unless it has the same message as the new error.
+static
+void
+__record_overwritten_error(const char * new_error_string)
+{
+  const char * message = gtls_rcutils_error_state_is_deferred ?
+    gtls_rcutils_deferred_error_message : gtls_rcutils_error_state.message;
+  if (message == new_error_string ||
+    0 == strncmp(message, new_error_string, RCUTILS_ERROR_STATE_MESSAGE_MAX_LENGTH))
+  {
+    return;
+  }
+  rcutils_error_history_entry_t * entry =
+    &gtls_rcutils_error_history[gtls_rcutils_error_history_count % RCUTILS_ERROR_HISTORY_SIZE];
+  ++gtls_rcutils_error_history_count;
+  if (gtls_rcutils_error_state_is_deferred) {
+    entry->deferred_message = gtls_rcutils_deferred_error_message;
+    entry->deferred_file = gtls_rcutils_deferred_error_file;
+    entry->line_number = gtls_rcutils_deferred_error_line_number;
+    return;
+  }
+  entry->deferred_message = NULL;
+  entry->deferred_file = NULL;
+  entry->line_number = gtls_rcutils_error_state.line_number;
+  __copy_truncated_string(entry->message, sizeof(entry->message), message);
+  __copy_truncated_string(entry->file, sizeof(entry->file), gtls_rcutils_error_state.file);
+}
+
 rcutils_ret_t
 rcutils_initialize_error_handling_thread_local_storage(rcutils_allocator_t allocator)
 {
@@ -196,7 +282,12 @@ rcutils_set_error_state(
   __rcutils_copy_string(error_state.message, sizeof(error_state.message), error_string);
   __rcutils_copy_string(error_state.file, sizeof(error_state.file), file);
   error_state.line_number = line_number;
+  if (gtls_rcutils_error_is_set && __error_history_is_enabled()) {
+    __record_overwritten_error(error_string);
+  }
 #if RCUTILS_REPORT_ERROR_HANDLING_ERRORS
+  // compare with the error set by rcutils_set_error_state_static() too
+  __copy_deferred_error_state();
   // Only warn of overwritting if the new error is different from the old ones.
   size_t characters_to_compare = strnlen(error_string, RCUTILS_ERROR_MESSAGE_MAX_LENGTH);
   // assumption is that message length is <= max error string length
@@ -205,6 +296,7 @@ rcutils_set_error_state(
     "expected error state's max message length to be less than or equal to error string max");
   if (
     gtls_rcutils_error_is_set &&
+    !__error_history_is_enabled() &&
     !__same_string(error_string, gtls_rcutils_error_string.str, characters_to_compare) &&
     !__same_string(error_string, gtls_rcutils_error_state.message, characters_to_compare))
   {
@@ -214,6 +306,8 @@ rcutils_set_error_state(
   }
 #endif
   gtls_rcutils_error_state = error_state;
+  gtls_rcutils_error_state_is_deferred = false;
+  gtls_rcutils_error_code = RCUTILS_RET_ERROR;
   gtls_rcutils_error_string_is_formatted = false;
   gtls_rcutils_error_string = (const rcutils_error_string_t) {
     .str = "\0"
@@ -221,15 +315,56 @@ rcutils_set_error_state(
   gtls_rcutils_error_is_set = true;
 }
 
+void
+rcutils_set_error_state_static(
+  const char * error_string,
+  const char * file,
+  size_t line_number)
+{
+  rcutils_set_error_code_static(RCUTILS_RET_ERROR, error_string, file, line_number);
+}
+
+void
+rcutils_set_error_code_static(
+  rcutils_ret_t code,
+  const char * error_string,
+  const char * file,
+  size_t line_number)
+{
+  if (NULL == error_string || NULL == file) {
+    // report it the usual way
+    rcutils_set_error_state(error_string, file, line_number);
+    return;
+  }
+  if (gtls_rcutils_error_is_set && __error_history_is_enabled()) {
+    __record_overwritten_error(error_string);
+  }
+  gtls_rcutils_error_code = code;
+  gtls_rcutils_deferred_error_message = error_string;
+  gtls_rcutils_deferred_error_file = file;
+  gtls_rcutils_deferred_error_line_number = line_number;
+  gtls_rcutils_error_state_is_deferred = true;
+  gtls_rcutils_error_string_is_formatted = false;
+  gtls_rcutils_error_string.str[0] = '\0';
+  gtls_rcutils_error_is_set = true;
+}
+
 bool
 rcutils_error_is_set(void)
 {
   return gtls_rcutils_error_is_set;
 }
 
+rcutils_ret_t
+rcutils_get_error_code(void)
+{
+  return gtls_rcutils_error_is_set ? gtls_rcutils_error_code : RCUTILS_RET_OK;
+}
+
 const rcutils_error_state_t *
 rcutils_get_error_state(void)
 {
+  __copy_deferred_error_state();
   return &gtls_rcutils_error_state;
 }
 
@@ -240,6 +375,7 @@ rcutils_get_error_string(void)
     return (rcutils_error_string_t) {"error not set"};  // NOLINT(readability/braces)
   }
   if (!gtls_rcutils_error_string_is_formatted) {
+    __copy_deferred_error_state();
     __rcutils_format_error_string(&gtls_rcutils_error_string, &gtls_rcutils_error_state);
     gtls_rcutils_error_string_is_formatted = true;
   }
@@ -256,9 +392,67 @@ rcutils_reset_error(void)
   gtls_rcutils_error_string = (const rcutils_error_string_t) {
     .str = "\0"
   };
+  gtls_rcutils_error_state_is_deferred = false;
   gtls_rcutils_error_is_set = false;
 }
 
+void
+rcutils_set_error_history_enabled(bool enabled)
+{
+  rcutils_atomic_store(&g_rcutils_error_history_enabled, enabled);
+}
+
+bool
+rcutils_error_history_is_enabled(void)
+{
+  return __error_history_is_enabled();
+}
+
+size_t
+rcutils_get_error_history(rcutils_error_string_t * history, size_t history_size)
+{
+  if (NULL == history) {
+    return 0;
+  }
+  size_t count = gtls_rcutils_error_history_count < RCUTILS_ERROR_HISTORY_SIZE ?
+    gtls_rcutils_error_history_count : RCUTILS_ERROR_HISTORY_SIZE;
+  if (count > history_size) {
+    count = history_size;
+  }
+  rcutils_error_state_t error_state;
+  for (size_t i = 0; i < count; ++i) {
+    const rcutils_error_history_entry_t * entry = &gtls_rcutils_error_history[
+      (gtls_rcutils_error_history_count - 1 - i) % RCUTILS_ERROR_HISTORY_SIZE];
+    const char * message = entry->deferred_message ? entry->deferred_message : entry->message;
+    const char * file = entry->deferred_file ? entry->deferred_file : entry->file;
+    __copy_truncated_string(error_state.message, sizeof(error_state.message), message);
+    __copy_truncated_string(error_state.file, sizeof(error_state.file), file);
+    error_state.line_number = entry->line_number;
+    __rcutils_format_error_string(&history[i], &error_state);
+  }
+  return count;
+}
+
+void
+rcutils_print_error_history(void)
+{
+  rcutils_error_string_t history[RCUTILS_ERROR_HISTORY_SIZE];
+  size_t count = rcutils_get_error_history(history, RCUTILS_ERROR_HISTORY_SIZE);
+  RCUTILS_SAFE_FWRITE_TO_STDERR(
+    "[rcutils|error_handling.c] rcutils_print_error_history(), most recent first:\n");
+  for (size_t i = 0; i < count; ++i) {
+    RCUTILS_SAFE_FWRITE_TO_STDERR("  '");
+    RCUTILS_SAFE_FWRITE_TO_STDERR(history[i].str);
+    RCUTILS_SAFE_FWRITE_TO_STDERR("'\n");
+  }
+}
+
+void
+rcutils_clear_error_history(void)
+{
+  gtls_rcutils_error_history_count = 0;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -19,13 +19,25 @@ extern "C"
 #include "rcutils/filesystem.h"
 
 #include <errno.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
 #ifndef _WIN32
 #include <dirent.h>
+#include <fcntl.h>
+#include <pthread.h>
 #include <unistd.h>
+# if defined(__linux__)
+#  include <poll.h>
+#  include <sys/inotify.h>
+#  define RCUTILS_FILE_WATCH_INOTIFY
+# elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__NetBSD__) || defined(__OpenBSD__)
+#  include <sys/event.h>
+#  include <sys/types.h>
+#  define RCUTILS_FILE_WATCH_KQUEUE
+# endif
 #else
 // When building with MSVC 19.28.29333.0 on Windows 10 (as of 2020-11-11),
 // there appears to be a problem with winbase.h (which is included by
@@ -44,9 +56,9 @@ extern "C"
 
 #include "rcutils/env.h"
 #include "rcutils/error_handling.h"
-#include "rcutils/format_string.h"
-#include "rcutils/repl_str.h"
+#include "rcutils/stdatomic_helper.h"
 #include "rcutils/strdup.h"
+#include "rcutils/thread_pool.h"
 
 #ifdef _WIN32
 # define RCUTILS_PATH_DELIMITER "\\"
@@ -62,6 +74,7 @@ typedef struct rcutils_dir_iter_state_t
 #else
   DIR * dir;
 #endif
+  bool stat_entries;
 } rcutils_dir_iter_state_t;
 
 bool
@@ -82,95 +95,120 @@ rcutils_get_cwd(char * buffer, size_t max_length)
   return true;
 }
 
-bool
-rcutils_is_directory(const char * abs_path)
+#ifndef _WIN32
+static rcutils_dir_entry_type_t get_dir_entry_type_from_mode(mode_t mode)
+{
+  if (S_ISREG(mode)) {
+    return RCUTILS_DIR_ENTRY_TYPE_FILE;
+  }
+  if (S_ISDIR(mode)) {
+    return RCUTILS_DIR_ENTRY_TYPE_DIRECTORY;
+  }
+  if (S_ISLNK(mode)) {
+    return RCUTILS_DIR_ENTRY_TYPE_SYMLINK;
+  }
+  return RCUTILS_DIR_ENTRY_TYPE_OTHER;
+}
+#endif  // _WIN32
+
+// Set the status of the path, with a single stat.
+static void stat_path(const char * path, rcutils_path_status_t * status)
 {
+  memset(status, 0, sizeof(*status));
   struct stat buf;
-  if (stat(abs_path, &buf) < 0) {
-    return false;
+  if (stat(path, &buf) < 0) {
+    return;
   }
+  status->exists = true;
 #ifdef _WIN32
-  return (buf.st_mode & S_IFDIR) == S_IFDIR;
+  if ((buf.st_mode & S_IFREG) == S_IFREG) {
+    status->type = RCUTILS_DIR_ENTRY_TYPE_FILE;
+  } else if ((buf.st_mode & S_IFDIR) == S_IFDIR) {
+    status->type = RCUTILS_DIR_ENTRY_TYPE_DIRECTORY;
+  } else {
+    status->type = RCUTILS_DIR_ENTRY_TYPE_OTHER;
+  }
+  // _S_IREAD and _S_IWRITE have the values of the read and write bits of the owner.
+  status->permissions = (uint32_t)(buf.st_mode & (_S_IREAD | _S_IWRITE));
+  status->mtime = RCUTILS_S_TO_NS((rcutils_time_point_value_t)buf.st_mtime);
+  status->atime = RCUTILS_S_TO_NS((rcutils_time_point_value_t)buf.st_atime);
 #else
-  return S_ISDIR(buf.st_mode);
+  status->type = get_dir_entry_type_from_mode(buf.st_mode);
+  status->permissions = (uint32_t)(buf.st_mode & 07777);
+# ifdef __APPLE__
+  const struct timespec * mtime = &buf.st_mtimespec;
+  const struct timespec * atime = &buf.st_atimespec;
+# else
+  const struct timespec * mtime = &buf.st_mtim;
+  const struct timespec * atime = &buf.st_atim;
+# endif
+  status->mtime = RCUTILS_S_TO_NS((rcutils_time_point_value_t)mtime->tv_sec) + mtime->tv_nsec;
+  status->atime = RCUTILS_S_TO_NS((rcutils_time_point_value_t)atime->tv_sec) + atime->tv_nsec;
 #endif  // _WIN32
+  status->size = (uint64_t)buf.st_size;
+}
+
+rcutils_ret_t
+rcutils_path_stat(const char * path, rcutils_path_status_t * status)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(path, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(status, RCUTILS_RET_INVALID_ARGUMENT);
+  stat_path(path, status);
+  return RCUTILS_RET_OK;
+}
+
+// Get the status of the path, or the one of a path which doesn't exist if it is NULL.
+static rcutils_path_status_t get_path_status(const char * abs_path)
+{
+  rcutils_path_status_t status = {0};
+  if (NULL != abs_path) {
+    stat_path(abs_path, &status);
+  }
+  return status;
+}
+
+bool
+rcutils_is_directory(const char * abs_path)
+{
+  return RCUTILS_DIR_ENTRY_TYPE_DIRECTORY == get_path_status(abs_path).type;
 }
 
 bool
 rcutils_is_file(const char * abs_path)
 {
-  struct stat buf;
-  if (stat(abs_path, &buf) < 0) {
-    return false;
-  }
-#ifdef _WIN32
-  return (buf.st_mode & S_IFREG) == S_IFREG;
-#else
-  return S_ISREG(buf.st_mode);
-#endif  // _WIN32
+  return RCUTILS_DIR_ENTRY_TYPE_FILE == get_path_status(abs_path).type;
 }
 
 bool
 rcutils_exists(const char * abs_path)
 {
-  struct stat buf;
-  if (stat(abs_path, &buf) < 0) {
-    return false;
-  }
-  return true;
+  return get_path_status(abs_path).exists;
 }
 
+// The read and write permission bits of the owner, _S_IREAD and _S_IWRITE on Windows.
+#define PERMISSION_OWNER_READ 0400u
+#define PERMISSION_OWNER_WRITE 0200u
+
 bool
 rcutils_is_readable(const char * abs_path)
 {
-  struct stat buf;
-  if (stat(abs_path, &buf) < 0) {
-    return false;
-  }
-#ifdef _WIN32
-  if (!(buf.st_mode & _S_IREAD)) {
-#else
-  if (!(buf.st_mode & S_IRUSR)) {
-#endif  // _WIN32
-    return false;
-  }
-  return true;
+  return 0u != (get_path_status(abs_path).permissions & PERMISSION_OWNER_READ);
 }
 
 bool
 rcutils_is_writable(const char * abs_path)
 {
-  struct stat buf;
-  if (stat(abs_path, &buf) < 0) {
-    return false;
-  }
-#ifdef _WIN32
-  if (!(buf.st_mode & _S_IWRITE)) {
-#else
-  if (!(buf.st_mode & S_IWUSR)) {
-#endif  // _WIN32
-    return false;
-  }
-  return true;
+  return 0u != (get_path_status(abs_path).permissions & PERMISSION_OWNER_WRITE);
 }
 
 bool
 rcutils_is_readable_and_writable(const char * abs_path)
 {
-  struct stat buf;
-  if (stat(abs_path, &buf) < 0) {
-    return false;
-  }
-#ifdef _WIN32
   // NOTE(marguedas) on windows all writable files are readable
   // hence the following check is equivalent to "& _S_IWRITE"
-  if (!((buf.st_mode & _S_IWRITE) && (buf.st_mode & _S_IREAD))) {
-#else
-  if (!((buf.st_mode & S_IWUSR) && (buf.st_mode & S_IRUSR))) {
-#endif  // _WIN32
-    return false;
-  }
-  return true;
+  uint32_t permissions = get_path_status(abs_path).permissions;
+  return 0u != (permissions & PERMISSION_OWNER_READ) &&
+         0u != (permissions & PERMISSION_OWNER_WRITE);
 }
 
 char *
@@ -186,10 +224,18 @@ rcutils_join_path(
     return NULL;
   }
 
-  return rcutils_format_string(
-    allocator,
-    "%s%s%s",
-    left_hand_path, RCUTILS_PATH_DELIMITER, right_hand_path);
+  size_t buffer_size = strlen(left_hand_path) + strlen(right_hand_path) + 2u;
+  char * buffer = allocator.allocate(buffer_size, allocator.state);
+  if (NULL == buffer) {
+    return NULL;
+  }
+  if (RCUTILS_RET_OK !=
+    rcutils_join_path_to_buffer(left_hand_path, right_hand_path, buffer, buffer_size))
+  {
+    allocator.deallocate(buffer, allocator.state);
+    return NULL;
+  }
+  return buffer;
 }
 
 char *
@@ -201,7 +247,12 @@ rcutils_to_native_path(
     return NULL;
   }
 
-  return rcutils_repl_str(path, "/", RCUTILS_PATH_DELIMITER, &allocator);
+  char * native_path = rcutils_strdup(path, allocator);
+  if (NULL != native_path && RCUTILS_RET_OK != rcutils_to_native_path_in_place(native_path)) {
+    allocator.deallocate(native_path, allocator.state);
+    return NULL;
+  }
+  return native_path;
 }
 
 char *
@@ -219,12 +270,150 @@ rcutils_expand_user(const char * path, rcutils_allocator_t allocator)
   if (NULL == homedir) {
     return NULL;
   }
-  return rcutils_format_string_limit(
-    allocator,
-    strlen(homedir) + strlen(path),
-    "%s%s",
-    homedir,
-    path + 1);
+  size_t buffer_size = strlen(homedir) + strlen(path);
+  char * buffer = allocator.allocate(buffer_size, allocator.state);
+  if (NULL == buffer) {
+    return NULL;
+  }
+  memcpy(buffer, homedir, strlen(homedir));
+  memcpy(buffer + strlen(homedir), path + 1, strlen(path));
+  return buffer;
+}
+
+rcutils_ret_t
+rcutils_join_path_to_buffer(
+  const char * left_hand_path,
+  const char * right_hand_path,
+  char * buffer,
+  size_t buffer_size)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(left_hand_path, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(right_hand_path, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(buffer, RCUTILS_RET_INVALID_ARGUMENT);
+
+  size_t left_length = strlen(left_hand_path);
+  size_t right_length = strlen(right_hand_path);
+  if (left_length + right_length + 2u > buffer_size) {
+    RCUTILS_SET_ERROR_MSG("joined path doesn't fit in the buffer");
+    return RCUTILS_RET_NOT_ENOUGH_SPACE;
+  }
+  // The right hand path may follow the left one in the buffer, so it's moved first
+  memmove(buffer + left_length + 1u, right_hand_path, right_length + 1u);
+  memmove(buffer, left_hand_path, left_length);
+  buffer[left_length] = RCUTILS_PATH_DELIMITER[0];
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_to_native_path_in_place(char * path)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(path, RCUTILS_RET_INVALID_ARGUMENT);
+
+#ifdef _WIN32
+  for (char * c = strchr(path, '/'); NULL != c; c = strchr(c + 1, '/')) {
+    *c = RCUTILS_PATH_DELIMITER[0];
+  }
+#endif
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_expand_user_to_buffer(const char * path, char * buffer, size_t buffer_size)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(path, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(buffer, RCUTILS_RET_INVALID_ARGUMENT);
+
+  size_t path_length = strlen(path);
+  if ('~' != path[0]) {
+    if (path_length + 1u > buffer_size) {
+      RCUTILS_SET_ERROR_MSG("expanded path doesn't fit in the buffer");
+      return RCUTILS_RET_NOT_ENOUGH_SPACE;
+    }
+    memmove(buffer, path, path_length + 1u);
+    return RCUTILS_RET_OK;
+  }
+
+  const char * homedir = rcutils_get_home_dir();
+  if (NULL == homedir) {
+    RCUTILS_SET_ERROR_MSG("home directory is unknown");
+    return RCUTILS_RET_ERROR;
+  }
+  size_t homedir_length = strlen(homedir);
+  if (homedir_length + path_length > buffer_size) {
+    RCUTILS_SET_ERROR_MSG("expanded path doesn't fit in the buffer");
+    return RCUTILS_RET_NOT_ENOUGH_SPACE;
+  }
+  // The path may be in the buffer, so its tail is moved before the home directory is copied
+  memmove(buffer + homedir_length, path + 1, path_length);
+  memcpy(buffer, homedir, homedir_length);
+  return RCUTILS_RET_OK;
+}
+
+static bool
+is_path_delimiter(char c)
+{
+#ifdef _WIN32
+  return '\\' == c || '/' == c;
+#else
+  return '/' == c;
+#endif
+}
+
+// The length of the root directory at the start of the path, which rcutils_path_pop() keeps.
+static size_t
+path_root_length(const char * path, size_t length)
+{
+#ifdef _WIN32
+  if (length >= 3u && ':' == path[1] && is_path_delimiter(path[2])) {
+    return 3u;
+  }
+#endif
+  return length >= 1u && is_path_delimiter(path[0]) ? 1u : 0u;
+}
+
+rcutils_ret_t
+rcutils_path_push(rcutils_char_array_t * path, const char * component)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(path, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(component, RCUTILS_RET_INVALID_ARGUMENT);
+
+  size_t length = path->buffer_length > 0u ? strlen(path->buffer) : 0u;
+  size_t component_length = strlen(component);
+  bool add_delimiter = length > 0u && !is_path_delimiter(path->buffer[length - 1u]);
+  size_t new_length = length + (add_delimiter ? 1u : 0u) + component_length;
+  if (new_length + 1u > path->buffer_capacity) {
+    rcutils_ret_t ret = rcutils_char_array_expand_as_needed(path, new_length + 1u);
+    if (RCUTILS_RET_OK != ret) {
+      return ret;
+    }
+  }
+  if (add_delimiter) {
+    path->buffer[length++] = RCUTILS_PATH_DELIMITER[0];
+  }
+  memcpy(path->buffer + length, component, component_length + 1u);
+  path->buffer_length = new_length + 1u;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_path_pop(rcutils_char_array_t * path)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(path, RCUTILS_RET_INVALID_ARGUMENT);
+
+  if (0u == path->buffer_length) {
+    return RCUTILS_RET_OK;
+  }
+  size_t length = strlen(path->buffer);
+  size_t root_length = path_root_length(path->buffer, length);
+  while (length > root_length && !is_path_delimiter(path->buffer[length - 1u])) {
+    --length;
+  }
+  while (length > root_length && is_path_delimiter(path->buffer[length - 1u])) {
+    --length;
+  }
+  path->buffer[length] = '\0';
+  path->buffer_length = length + 1u;
+  return RCUTILS_RET_OK;
 }
 
 bool
@@ -268,6 +457,7 @@ rcutils_calculate_directory_size(
   return rcutils_calculate_directory_size_with_recursion(directory_path, 1, size, allocator);
 }
 
+#ifdef _WIN32
 typedef struct dir_list_t
 {
   char * path;
@@ -294,11 +484,14 @@ static void remove_first_dir_from_list(dir_list_t ** dir_list, rcutils_allocator
   *dir_list = next_dir;
 }
 
+// The path of the directory at the head of dir_list is in file_path, the entries are pushed
+// onto it in turn, and only the subdirectories queued get a path of their own.
 static rcutils_ret_t check_and_calculate_size(
   const char * filename,
   uint64_t * dir_size,
   const size_t max_depth,
   dir_list_t * dir_list,
+  rcutils_char_array_t * file_path,
   rcutils_allocator_t allocator)
 {
   // Skip over local folder handle (`.`) and parent folder (`..`)
@@ -306,40 +499,40 @@ static rcutils_ret_t check_and_calculate_size(
     return RCUTILS_RET_OK;
   }
 
-  char * file_path = rcutils_join_path(dir_list->path, filename, allocator);
-  if (NULL == file_path) {
-    RCUTILS_SAFE_FWRITE_TO_STDERR("rcutils_join_path return NULL !\n");
-    return RCUTILS_RET_BAD_ALLOC;
+  rcutils_ret_t ret = rcutils_path_push(file_path, filename);
+  if (RCUTILS_RET_OK != ret) {
+    RCUTILS_SAFE_FWRITE_TO_STDERR("rcutils_path_push failed !\n");
+    return ret;
   }
 
-  if (rcutils_is_directory(file_path)) {
+  rcutils_path_status_t status = get_path_status(file_path->buffer);
+  if (RCUTILS_DIR_ENTRY_TYPE_DIRECTORY == status.type) {
     if ((max_depth == 0) || ((dir_list->depth + 1) <= max_depth)) {
       // Add new directory to dir_list
       dir_list_t * found_new_dir =
         allocator.allocate(sizeof(dir_list_t), allocator.state);
-      if (NULL == found_new_dir) {
+      char * found_new_path = rcutils_strdup(file_path->buffer, allocator);
+      if (NULL == found_new_dir || NULL == found_new_path) {
         RCUTILS_SAFE_FWRITE_TO_STDERR_WITH_FORMAT_STRING(
-          "Failed to allocate memory for path %s !\n", file_path);
-        allocator.deallocate(file_path, allocator.state);
+          "Failed to allocate memory for path %s !\n", file_path->buffer);
+        allocator.deallocate(found_new_dir, allocator.state);
+        allocator.deallocate(found_new_path, allocator.state);
         return RCUTILS_RET_BAD_ALLOC;
       }
-      found_new_dir->path = file_path;
+      found_new_dir->path = found_new_path;
       found_new_dir->depth = dir_list->depth + 1;
       found_new_dir->next = dir_list->next;
       dir_list->next = found_new_dir;
-      return RCUTILS_RET_OK;
     }
-  } else {
-    *dir_size += rcutils_get_file_size(file_path);
+  } else if (RCUTILS_DIR_ENTRY_TYPE_FILE == status.type) {
+    *dir_size += status.size;
   }
 
-  allocator.deallocate(file_path, allocator.state);
-
-  return RCUTILS_RET_OK;
+  return rcutils_path_pop(file_path);
 }
 
-rcutils_ret_t
-rcutils_calculate_directory_size_with_recursion(
+static rcutils_ret_t
+calculate_directory_size_with_list(
   const char * directory_path,
   const size_t max_depth,
   uint64_t * size,
@@ -348,22 +541,7 @@ rcutils_calculate_directory_size_with_recursion(
   dir_list_t * dir_list = NULL;
   rcutils_ret_t ret = RCUTILS_RET_OK;
   rcutils_dir_iter_t * iter = NULL;
-
-  if (NULL == directory_path) {
-    RCUTILS_SAFE_FWRITE_TO_STDERR("directory_path is NULL !");
-    return RCUTILS_RET_INVALID_ARGUMENT;
-  }
-
-  if (NULL == size) {
-    RCUTILS_SAFE_FWRITE_TO_STDERR("size pointer is NULL !");
-    return RCUTILS_RET_INVALID_ARGUMENT;
-  }
-
-  if (!rcutils_is_directory(directory_path)) {
-    RCUTILS_SAFE_FWRITE_TO_STDERR_WITH_FORMAT_STRING(
-      "Path is not a directory: %s\n", directory_path);
-    return RCUTILS_RET_ERROR;
-  }
+  RCUTILS_CHAR_ARRAY_WITH_STACK(file_path, MAX_PATH, allocator);
 
   dir_list = allocator.zero_allocate(1, sizeof(dir_list_t), allocator.state);
   if (NULL == dir_list) {
@@ -383,6 +561,11 @@ rcutils_calculate_directory_size_with_recursion(
   *size = 0;
 
   do {
+    ret = rcutils_char_array_strcpy(&file_path, dir_list->path);
+    if (RCUTILS_RET_OK != ret) {
+      goto fail;
+    }
+
     iter = rcutils_dir_iter_start(dir_list->path, allocator);
     if (NULL == iter) {
       ret = RCUTILS_RET_ERROR;
@@ -390,121 +573,539 @@ rcutils_calculate_directory_size_with_recursion(
     }
 
     do {
-      ret = check_and_calculate_size(iter->entry_name, size, max_depth, dir_list, allocator);
+      ret = check_and_calculate_size(
+        iter->entry_name, size, max_depth, dir_list, &file_path, allocator);
       if (RCUTILS_RET_OK != ret) {
         goto fail;
       }
     } while (rcutils_dir_iter_next(iter));
 
     rcutils_dir_iter_end(iter);
+    iter = NULL;
 
     remove_first_dir_from_list(&dir_list, allocator);
   } while (dir_list);
 
-  return ret;
+  return rcutils_char_array_fini(&file_path);
 
 fail:
   rcutils_dir_iter_end(iter);
   free_dir_list(dir_list, allocator);
+  rcutils_ret_t fini_ret = rcutils_char_array_fini(&file_path);
+  RCUTILS_UNUSED(fini_ret);
   return ret;
 }
 
-rcutils_dir_iter_t *
-rcutils_dir_iter_start(const char * directory_path, const rcutils_allocator_t allocator)
+#else
+// The kinds of the entries of a directory, symbolic links are neither files nor directories.
+typedef enum dir_entry_kind_t
 {
-  RCUTILS_CHECK_ARGUMENT_FOR_NULL(directory_path, NULL);
-  RCUTILS_CHECK_ALLOCATOR_WITH_MSG(
-    &allocator, "allocator is invalid", return NULL);
-
-  rcutils_dir_iter_t * iter = (rcutils_dir_iter_t *)allocator.zero_allocate(
-    1, sizeof(rcutils_dir_iter_t), allocator.state);
-  if (NULL == iter) {
-    return NULL;
+  DIR_ENTRY_OTHER,
+  DIR_ENTRY_FILE,
+  DIR_ENTRY_DIRECTORY,
+} dir_entry_kind_t;
+
+// Classify an entry of the directory dir_fd, from the type readdir() reports if the file
+// system supports it, and set the size of files.
+static dir_entry_kind_t get_dir_entry_kind(
+  int dir_fd,
+  const struct dirent * entry,
+  uint64_t * file_size)
+{
+  // Skip over local folder handle (`.`) and parent folder (`..`)
+  if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+    return DIR_ENTRY_OTHER;
   }
-  iter->allocator = allocator;
-
-  rcutils_dir_iter_state_t * state = (rcutils_dir_iter_state_t *)allocator.zero_allocate(
-    1, sizeof(rcutils_dir_iter_state_t), allocator.state);
-  if (NULL == state) {
-    RCUTILS_SET_ERROR_MSG(
-      "Failed to allocate memory.\n");
-    goto rcutils_dir_iter_start_fail;
+#ifdef DT_DIR
+  if (DT_DIR == entry->d_type) {
+    return DIR_ENTRY_DIRECTORY;
   }
-  iter->state = (void *)state;
-
-#ifdef _WIN32
-  char * search_path = rcutils_join_path(directory_path, "*", allocator);
-  if (NULL == search_path) {
-    goto rcutils_dir_iter_start_fail;
+  if (DT_UNKNOWN != entry->d_type && DT_REG != entry->d_type) {
+    return DIR_ENTRY_OTHER;
   }
-  state->handle = FindFirstFile(search_path, &state->data);
-  allocator.deallocate(search_path, allocator.state);
-  if (INVALID_HANDLE_VALUE == state->handle) {
-    DWORD error = GetLastError();
-    if (ERROR_FILE_NOT_FOUND != error || !rcutils_is_directory(directory_path)) {
-      RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
-        "Can't open directory %s. Error code: %d\n", directory_path, error);
-      goto rcutils_dir_iter_start_fail;
-    }
-  } else {
-    iter->entry_name = state->data.cFileName;
+#endif
+  struct stat stat_buffer;
+  if (fstatat(dir_fd, entry->d_name, &stat_buffer, AT_SYMLINK_NOFOLLOW) != 0) {
+    // The entry was removed meanwhile.
+    return DIR_ENTRY_OTHER;
   }
-#else
-  state->dir = opendir(directory_path);
-  if (NULL == state->dir) {
-    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
-      "Can't open directory %s. Error code: %d\n", directory_path, errno);
-    goto rcutils_dir_iter_start_fail;
+  if (S_ISDIR(stat_buffer.st_mode)) {
+    return DIR_ENTRY_DIRECTORY;
+  }
+  if (!S_ISREG(stat_buffer.st_mode)) {
+    return DIR_ENTRY_OTHER;
   }
+  *file_size = (uint64_t)stat_buffer.st_size;
+  return DIR_ENTRY_FILE;
+}
 
-  errno = 0;
-  struct dirent * entry = readdir(state->dir);
-  if (NULL != entry) {
-    iter->entry_name = entry->d_name;
-  } else if (0 != errno) {
+static DIR * open_subdirectory(int dir_fd, const char * name)
+{
+  int fd = openat(dir_fd, name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+  DIR * dir = fd < 0 ? NULL : fdopendir(fd);
+  if (NULL == dir) {
     RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
-      "Can't iterate directory %s. Error code: %d\n", directory_path, errno);
-    goto rcutils_dir_iter_start_fail;
+      "Can't open directory %s. Error code: %d\n", name, errno);
+    if (fd >= 0) {
+      close(fd);
+    }
   }
-#endif
-
-  return iter;
-
-rcutils_dir_iter_start_fail:
-  rcutils_dir_iter_end(iter);
-  return NULL;
+  return dir;
 }
 
-bool
-rcutils_dir_iter_next(rcutils_dir_iter_t * iter)
+// Add the size of the directory at the given depth to size, and close it.
+static rcutils_ret_t calculate_directory_size_at(
+  DIR * dir,
+  const size_t depth,
+  const size_t max_depth,
+  uint64_t * size)
 {
-  RCUTILS_CHECK_ARGUMENT_FOR_NULL(iter, false);
-  rcutils_dir_iter_state_t * state = (rcutils_dir_iter_state_t *)iter->state;
-  RCUTILS_CHECK_FOR_NULL_WITH_MSG(state, "iter is invalid", false);
-
-#ifdef _WIN32
-  if (FindNextFile(state->handle, &state->data)) {
-    iter->entry_name = state->data.cFileName;
-    return true;
+  rcutils_ret_t ret = RCUTILS_RET_OK;
+  int dir_fd = dirfd(dir);
+  struct dirent * entry;
+  errno = 0;
+  while (NULL != (entry = readdir(dir))) {
+    uint64_t file_size = 0;
+    dir_entry_kind_t kind = get_dir_entry_kind(dir_fd, entry, &file_size);
+    if (DIR_ENTRY_FILE == kind) {
+      *size += file_size;
+    } else if (DIR_ENTRY_DIRECTORY == kind && ((max_depth == 0) || (depth + 1 <= max_depth))) {
+      DIR * subdir = open_subdirectory(dir_fd, entry->d_name);
+      if (NULL == subdir) {
+        ret = RCUTILS_RET_ERROR;
+        break;
+      }
+      ret = calculate_directory_size_at(subdir, depth + 1, max_depth, size);
+      if (RCUTILS_RET_OK != ret) {
+        break;
+      }
+    }
+    errno = 0;
   }
-  FindClose(state->handle);
-#else
-  struct dirent * entry = readdir(state->dir);
-  if (NULL != entry) {
-    iter->entry_name = entry->d_name;
-    return true;
+  if (RCUTILS_RET_OK == ret && 0 != errno) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("Can't iterate directory. Error code: %d\n", errno);
+    ret = RCUTILS_RET_ERROR;
   }
-#endif
-
-  iter->entry_name = NULL;
-  return false;
+  closedir(dir);
+  return ret;
 }
 
-void
-rcutils_dir_iter_end(rcutils_dir_iter_t * iter)
+// The subdirectories of a directory shared by the threads calculating their sizes.
+typedef struct dir_size_work_t
 {
-  if (NULL == iter) {
-    return;
+  int dir_fd;
+  char ** names;
+  size_t count;
+  size_t max_depth;
+  atomic_uint_least64_t next;
+  atomic_uint_least64_t size;
+  atomic_bool failed;
+} dir_size_work_t;
+
+static void * calculate_subdirectory_sizes(void * arg)
+{
+  dir_size_work_t * work = (dir_size_work_t *)arg;
+  uint64_t size = 0;
+  while (!rcutils_atomic_load_bool(&work->failed)) {
+    uint64_t index = rcutils_atomic_fetch_add_uint64_t(&work->next, 1u);
+    if (index >= work->count) {
+      break;
+    }
+    DIR * subdir = open_subdirectory(work->dir_fd, work->names[index]);
+    if (
+      NULL == subdir ||
+      RCUTILS_RET_OK != calculate_directory_size_at(subdir, 2, work->max_depth, &size))
+    {
+      rcutils_atomic_store(&work->failed, true);
+    }
+  }
+  rcutils_atomic_fetch_add_uint64_t(&work->size, size);
+  return NULL;
+}
+
+// Add the sizes of the files of the directory to size, calculate the sizes of its
+// subdirectories on up to the given number of threads, and close it.
+static rcutils_ret_t calculate_directory_size_in_parallel(
+  DIR * dir,
+  const rcutils_directory_size_options_t * options,
+  uint64_t * size,
+  rcutils_allocator_t allocator)
+{
+  rcutils_ret_t ret = RCUTILS_RET_OK;
+  dir_size_work_t work;
+  work.dir_fd = dirfd(dir);
+  work.names = NULL;
+  work.count = 0;
+  work.max_depth = options->max_depth;
+  size_t capacity = 0;
+  pthread_t * threads = NULL;
+  size_t threads_count = 0;
+
+  struct dirent * entry;
+  errno = 0;
+  while (NULL != (entry = readdir(dir))) {
+    uint64_t file_size = 0;
+    dir_entry_kind_t kind = get_dir_entry_kind(work.dir_fd, entry, &file_size);
+    if (DIR_ENTRY_FILE == kind) {
+      *size += file_size;
+    } else if (DIR_ENTRY_DIRECTORY == kind) {
+      if (work.count == capacity) {
+        size_t new_capacity = 0 == capacity ? 16 : 2 * capacity;
+        char ** names = allocator.reallocate(
+          work.names, new_capacity * sizeof(char *), allocator.state);
+        if (NULL == names) {
+          ret = RCUTILS_RET_BAD_ALLOC;
+          goto cleanup;
+        }
+        work.names = names;
+        capacity = new_capacity;
+      }
+      work.names[work.count] = rcutils_strdup(entry->d_name, allocator);
+      if (NULL == work.names[work.count]) {
+        ret = RCUTILS_RET_BAD_ALLOC;
+        goto cleanup;
+      }
+      ++work.count;
+    }
+    errno = 0;
+  }
+  if (0 != errno) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("Can't iterate directory. Error code: %d\n", errno);
+    ret = RCUTILS_RET_ERROR;
+    goto cleanup;
+  }
+
+  rcutils_atomic_store(&work.next, (uint64_t)0u);
+  rcutils_atomic_store(&work.size, (uint64_t)0u);
+  rcutils_atomic_store(&work.failed, false);
+  // The calling thread is one of the threads.
+  size_t extra_threads = (options->threads < work.count ? options->threads : work.count);
+  extra_threads = extra_threads > 0 ? extra_threads - 1 : 0;
+  if (extra_threads > 0) {
+    threads = allocator.allocate(extra_threads * sizeof(pthread_t), allocator.state);
+  }
+  if (NULL != threads) {
+    // Fewer threads process the subdirectories if creating one fails.
+    while (threads_count < extra_threads &&
+      0 == pthread_create(&threads[threads_count], NULL, calculate_subdirectory_sizes, &work))
+    {
+      ++threads_count;
+    }
+  }
+  calculate_subdirectory_sizes(&work);
+  for (size_t i = 0; i < threads_count; ++i) {
+    pthread_join(threads[i], NULL);
+  }
+  *size += rcutils_atomic_load_uint64_t(&work.size);
+  if (rcutils_atomic_load_bool(&work.failed)) {
+    if (!rcutils_error_is_set()) {
+      // The error was set on the thread which failed.
+      RCUTILS_SET_ERROR_MSG("Failed to calculate the size of a subdirectory");
+    }
+    ret = RCUTILS_RET_ERROR;
+  }
+
+cleanup:
+  allocator.deallocate(threads, allocator.state);
+  for (size_t i = 0; i < work.count; ++i) {
+    allocator.deallocate(work.names[i], allocator.state);
+  }
+  allocator.deallocate(work.names, allocator.state);
+  closedir(dir);
+  return ret;
+}
+#endif  // _WIN32
+
+rcutils_directory_size_options_t
+rcutils_directory_size_get_default_options(void)
+{
+  static rcutils_directory_size_options_t default_options = {
+    .max_depth = 0,
+    .threads = 1,
+  };
+  return default_options;
+}
+
+rcutils_ret_t
+rcutils_calculate_directory_size_with_recursion(
+  const char * directory_path,
+  const size_t max_depth,
+  uint64_t * size,
+  rcutils_allocator_t allocator)
+{
+  rcutils_directory_size_options_t options = rcutils_directory_size_get_default_options();
+  options.max_depth = max_depth;
+  return rcutils_calculate_directory_size_with_options(directory_path, &options, size, allocator);
+}
+
+rcutils_ret_t
+rcutils_calculate_directory_size_with_options(
+  const char * directory_path,
+  const rcutils_directory_size_options_t * options,
+  uint64_t * size,
+  rcutils_allocator_t allocator)
+{
+  if (NULL == directory_path) {
+    RCUTILS_SAFE_FWRITE_TO_STDERR("directory_path is NULL !");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+
+  if (NULL == options) {
+    RCUTILS_SAFE_FWRITE_TO_STDERR("options pointer is NULL !");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+
+  if (NULL == size) {
+    RCUTILS_SAFE_FWRITE_TO_STDERR("size pointer is NULL !");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+
+  if (!rcutils_is_directory(directory_path)) {
+    RCUTILS_SAFE_FWRITE_TO_STDERR_WITH_FORMAT_STRING(
+      "Path is not a directory: %s\n", directory_path);
+    return RCUTILS_RET_ERROR;
+  }
+
+#ifdef _WIN32
+  return calculate_directory_size_with_list(directory_path, options->max_depth, size, allocator);
+#else
+  DIR * dir = opendir(directory_path);
+  if (NULL == dir) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "Can't open directory %s. Error code: %d\n", directory_path, errno);
+    return RCUTILS_RET_ERROR;
+  }
+  *size = 0;
+  if (options->threads > 1 && (options->max_depth == 0 || options->max_depth > 1)) {
+    return calculate_directory_size_in_parallel(dir, options, size, allocator);
+  }
+  return calculate_directory_size_at(dir, 1, options->max_depth, size);
+#endif  // _WIN32
+}
+
+// Set the name, type, and if requested size and modification time of the enumerated entry.
+#ifdef _WIN32
+static void set_dir_iter_entry(rcutils_dir_iter_t * iter, rcutils_dir_iter_state_t * state)
+{
+  // The attributes, size and times are found along with the name.
+  const WIN32_FIND_DATA * data = &state->data;
+  iter->entry_name = data->cFileName;
+  if (data->dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) {
+    iter->entry_type = RCUTILS_DIR_ENTRY_TYPE_SYMLINK;
+  } else if (data->dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+    iter->entry_type = RCUTILS_DIR_ENTRY_TYPE_DIRECTORY;
+  } else if (data->dwFileAttributes & FILE_ATTRIBUTE_DEVICE) {
+    iter->entry_type = RCUTILS_DIR_ENTRY_TYPE_OTHER;
+  } else {
+    iter->entry_type = RCUTILS_DIR_ENTRY_TYPE_FILE;
+  }
+  iter->entry_size = 0;
+  iter->entry_mtime = 0;
+  if (state->stat_entries) {
+    iter->entry_size = ((uint64_t)data->nFileSizeHigh << 32) | data->nFileSizeLow;
+    ULARGE_INTEGER mtime;
+    mtime.LowPart = data->ftLastWriteTime.dwLowDateTime;
+    mtime.HighPart = data->ftLastWriteTime.dwHighDateTime;
+    // Adjust for January 1st, 1970, and convert from 100's of nanoseconds.
+    iter->entry_mtime = ((rcutils_time_point_value_t)mtime.QuadPart - 116444736000000000) * 100;
+  }
+}
+#else
+static void set_dir_iter_entry(
+  rcutils_dir_iter_t * iter,
+  rcutils_dir_iter_state_t * state,
+  const struct dirent * entry)
+{
+  iter->entry_name = entry->d_name;
+  iter->entry_type = RCUTILS_DIR_ENTRY_TYPE_UNKNOWN;
+  iter->entry_size = 0;
+  iter->entry_mtime = 0;
+#ifdef DT_DIR
+  switch (entry->d_type) {
+    case DT_REG:
+      iter->entry_type = RCUTILS_DIR_ENTRY_TYPE_FILE;
+      break;
+    case DT_DIR:
+      iter->entry_type = RCUTILS_DIR_ENTRY_TYPE_DIRECTORY;
+      break;
+    case DT_LNK:
+      iter->entry_type = RCUTILS_DIR_ENTRY_TYPE_SYMLINK;
+      break;
+    case DT_UNKNOWN:
+      break;
+    default:
+      iter->entry_type = RCUTILS_DIR_ENTRY_TYPE_OTHER;
+      break;
+  }
+#endif
+  if (!state->stat_entries && RCUTILS_DIR_ENTRY_TYPE_UNKNOWN != iter->entry_type) {
+    return;
+  }
+  struct stat stat_buffer;
+  if (fstatat(dirfd(state->dir), entry->d_name, &stat_buffer, AT_SYMLINK_NOFOLLOW) != 0) {
+    // The entry was removed meanwhile.
+    return;
+  }
+  iter->entry_type = get_dir_entry_type_from_mode(stat_buffer.st_mode);
+  if (state->stat_entries) {
+    iter->entry_size = (uint64_t)stat_buffer.st_size;
+#ifdef __APPLE__
+    const struct timespec * mtime = &stat_buffer.st_mtimespec;
+#else
+    const struct timespec * mtime = &stat_buffer.st_mtim;
+#endif
+    iter->entry_mtime = RCUTILS_S_TO_NS((rcutils_time_point_value_t)mtime->tv_sec) +
+      mtime->tv_nsec;
+  }
+}
+#endif
+
+rcutils_dir_iter_options_t
+rcutils_dir_iter_get_default_options(void)
+{
+  static rcutils_dir_iter_options_t default_options = {
+    .stat_entries = false,
+  };
+  return default_options;
+}
+
+rcutils_dir_iter_t *
+rcutils_dir_iter_start(const char * directory_path, const rcutils_allocator_t allocator)
+{
+  rcutils_dir_iter_options_t options = rcutils_dir_iter_get_default_options();
+  return rcutils_dir_iter_start_with_options(directory_path, &options, allocator);
+}
+
+// Start iterating over the directory at directory_path, which is the entry name of the
+// directory of parent if it isn't NULL.
+// On POSIX systems such a subdirectory is opened relative to its parent, without resolving its
+// path again, and only if it isn't a symbolic link.
+static rcutils_dir_iter_t *
+dir_iter_start_at(
+  const rcutils_dir_iter_t * parent,
+  const char * name,
+  const char * directory_path,
+  const rcutils_dir_iter_options_t * options,
+  const rcutils_allocator_t allocator)
+{
+  rcutils_dir_iter_t * iter = (rcutils_dir_iter_t *)allocator.zero_allocate(
+    1, sizeof(rcutils_dir_iter_t), allocator.state);
+  if (NULL == iter) {
+    return NULL;
+  }
+  iter->allocator = allocator;
+
+  rcutils_dir_iter_state_t * state = (rcutils_dir_iter_state_t *)allocator.zero_allocate(
+    1, sizeof(rcutils_dir_iter_state_t), allocator.state);
+  if (NULL == state) {
+    RCUTILS_SET_ERROR_MSG(
+      "Failed to allocate memory.\n");
+    goto rcutils_dir_iter_start_fail;
+  }
+  iter->state = (void *)state;
+  state->stat_entries = options->stat_entries;
+
+#ifdef _WIN32
+  RCUTILS_UNUSED(parent);
+  RCUTILS_UNUSED(name);
+  char * search_path = rcutils_join_path(directory_path, "*", allocator);
+  if (NULL == search_path) {
+    goto rcutils_dir_iter_start_fail;
+  }
+  state->handle = FindFirstFile(search_path, &state->data);
+  allocator.deallocate(search_path, allocator.state);
+  if (INVALID_HANDLE_VALUE == state->handle) {
+    DWORD error = GetLastError();
+    if (ERROR_FILE_NOT_FOUND != error || !rcutils_is_directory(directory_path)) {
+      RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+        "Can't open directory %s. Error code: %d\n", directory_path, error);
+      goto rcutils_dir_iter_start_fail;
+    }
+  } else {
+    set_dir_iter_entry(iter, state);
+  }
+#else
+  if (NULL != parent) {
+    const rcutils_dir_iter_state_t * parent_state = (rcutils_dir_iter_state_t *)parent->state;
+    int fd = openat(
+      dirfd(parent_state->dir), name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    state->dir = fd < 0 ? NULL : fdopendir(fd);
+    if (NULL == state->dir && fd >= 0) {
+      int error = errno;
+      close(fd);
+      errno = error;
+    }
+  } else {
+    state->dir = opendir(directory_path);
+  }
+  if (NULL == state->dir) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "Can't open directory %s. Error code: %d\n", directory_path, errno);
+    goto rcutils_dir_iter_start_fail;
+  }
+
+  errno = 0;
+  struct dirent * entry = readdir(state->dir);
+  if (NULL != entry) {
+    set_dir_iter_entry(iter, state, entry);
+  } else if (0 != errno) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "Can't iterate directory %s. Error code: %d\n", directory_path, errno);
+    goto rcutils_dir_iter_start_fail;
+  }
+#endif
+
+  return iter;
+
+rcutils_dir_iter_start_fail:
+  rcutils_dir_iter_end(iter);
+  return NULL;
+}
+
+rcutils_dir_iter_t *
+rcutils_dir_iter_start_with_options(
+  const char * directory_path,
+  const rcutils_dir_iter_options_t * options,
+  const rcutils_allocator_t allocator)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(directory_path, NULL);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(options, NULL);
+  RCUTILS_CHECK_ALLOCATOR_WITH_MSG(
+    &allocator, "allocator is invalid", return NULL);
+
+  return dir_iter_start_at(NULL, NULL, directory_path, options, allocator);
+}
+
+bool
+rcutils_dir_iter_next(rcutils_dir_iter_t * iter)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(iter, false);
+  rcutils_dir_iter_state_t * state = (rcutils_dir_iter_state_t *)iter->state;
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(state, "iter is invalid", false);
+
+#ifdef _WIN32
+  if (FindNextFile(state->handle, &state->data)) {
+    set_dir_iter_entry(iter, state);
+    return true;
+  }
+  FindClose(state->handle);
+#else
+  struct dirent * entry = readdir(state->dir);
+  if (NULL != entry) {
+    set_dir_iter_entry(iter, state, entry);
+    return true;
+  }
+#endif
+
+  iter->entry_name = NULL;
+  return false;
+}
+
+void
+rcutils_dir_iter_end(rcutils_dir_iter_t * iter)
+{
+  if (NULL == iter) {
+    return;
   }
 
   rcutils_allocator_t allocator = iter->allocator;
@@ -524,18 +1125,1080 @@ rcutils_dir_iter_end(rcutils_dir_iter_t * iter)
   allocator.deallocate(iter, allocator.state);
 }
 
-size_t
-rcutils_get_file_size(const char * file_path)
+// Match the character against the set of a pattern past its '[', and return the pattern past
+// the set, or NULL if the character doesn't match.
+static const char * dir_walk_match_set(const char * pattern, char c)
 {
-  if (!rcutils_is_file(file_path)) {
-    RCUTILS_SAFE_FWRITE_TO_STDERR_WITH_FORMAT_STRING(
-      "Path is not a file: %s\n", file_path);
-    return 0;
+  bool negated = '!' == *pattern;
+  if (negated) {
+    ++pattern;
   }
+  bool matched = false;
+  // A ']' first is part of the set.
+  do {
+    if ('\0' == *pattern) {
+      return NULL;
+    }
+    unsigned char low = (unsigned char)pattern[0];
+    unsigned char high = low;
+    if ('-' == pattern[1] && ']' != pattern[2] && '\0' != pattern[2]) {
+      high = (unsigned char)pattern[2];
+      pattern += 2;
+    }
+    if (low <= (unsigned char)c && (unsigned char)c <= high) {
+      matched = true;
+    }
+    ++pattern;
+  } while (']' != *pattern);
+  return matched != negated ? pattern + 1 : NULL;
+}
 
-  struct stat stat_buffer;
-  int rc = stat(file_path, &stat_buffer);
-  return rc == 0 ? (size_t)(stat_buffer.st_size) : 0;
+// Match the name against the pattern, see rcutils_dir_walk_options_t.
+static bool dir_walk_match(const char * pattern, const char * name)
+{
+  // Where to resume when the last '*' matches one more character.
+  const char * star_pattern = NULL;
+  const char * star_name = NULL;
+  while ('\0' != *name) {
+    if ('*' == *pattern) {
+      star_pattern = ++pattern;
+      star_name = name;
+      continue;
+    }
+    const char * next_pattern = NULL;
+    if ('?' == *pattern) {
+      next_pattern = pattern + 1;
+    } else if ('[' == *pattern) {
+      next_pattern = dir_walk_match_set(pattern + 1, *name);
+    } else if (*pattern == *name) {
+      next_pattern = pattern + 1;
+    }
+    if (NULL != next_pattern) {
+      pattern = next_pattern;
+      ++name;
+    } else if (NULL != star_pattern) {
+      pattern = star_pattern;
+      name = ++star_name;
+    } else {
+      return false;
+    }
+  }
+  while ('*' == *pattern) {
+    ++pattern;
+  }
+  return '\0' == *pattern;
+}
+
+// The state of a walk, shared by the threads of its pool.
+typedef struct dir_walk_t
+{
+  rcutils_dir_walk_options_t options;
+  rcutils_dir_iter_options_t iter_options;
+  rcutils_dir_walk_callback_t callback;
+  void * user_data;
+  rcutils_allocator_t allocator;
+  // NULL when the walk runs on the calling thread only.
+  rcutils_thread_pool_t * pool;
+  atomic_bool stopped;
+  // The first error, which stops the walk as well.
+  atomic_uint_least64_t ret;
+} dir_walk_t;
+
+// A directory handed to the pool, with the depth of its entries.
+typedef struct dir_walk_item_t
+{
+  char * path;
+  size_t depth;
+} dir_walk_item_t;
+
+static void dir_walk_fail(dir_walk_t * walk, rcutils_ret_t ret)
+{
+  uint64_t expected = RCUTILS_RET_OK;
+  (void)rcutils_atomic_compare_exchange_strong_uint_least64_t(
+    &walk->ret, &expected, (uint64_t)ret);
+  rcutils_atomic_store(&walk->stopped, true);
+}
+
+static rcutils_ret_t dir_walk_directory(
+  dir_walk_t * walk,
+  rcutils_dir_iter_t * iter,
+  rcutils_char_array_t * path,
+  size_t depth);
+
+// Walk the subdirectory name of the directory of iter, whose path is in path, or hand it to
+// the pool if there is one with room for it.
+static rcutils_ret_t dir_walk_subdirectory(
+  dir_walk_t * walk,
+  const rcutils_dir_iter_t * iter,
+  const char * name,
+  rcutils_char_array_t * path,
+  size_t depth)
+{
+  if (NULL != walk->pool) {
+    dir_walk_item_t item = {rcutils_strdup(path->buffer, walk->allocator), depth};
+    if (NULL == item.path) {
+      RCUTILS_SET_ERROR_MSG("Failed to allocate memory for the path of a directory");
+      return RCUTILS_RET_BAD_ALLOC;
+    }
+    if (RCUTILS_RET_OK == rcutils_thread_pool_push(walk->pool, &item)) {
+      return RCUTILS_RET_OK;
+    }
+    // The queue is full, so this thread walks the subdirectory itself.
+    walk->allocator.deallocate(item.path, walk->allocator.state);
+  }
+  rcutils_dir_iter_t * subiter =
+    dir_iter_start_at(iter, name, path->buffer, &walk->iter_options, walk->allocator);
+  if (NULL == subiter) {
+    return RCUTILS_RET_ERROR;
+  }
+  rcutils_ret_t ret = dir_walk_directory(walk, subiter, path, depth);
+  rcutils_dir_iter_end(subiter);
+  return ret;
+}
+
+// Visit the entries of the directory of iter, at the given depth, whose path is in path.
+static rcutils_ret_t dir_walk_directory(
+  dir_walk_t * walk,
+  rcutils_dir_iter_t * iter,
+  rcutils_char_array_t * path,
+  size_t depth)
+{
+  const rcutils_dir_walk_options_t * options = &walk->options;
+  rcutils_ret_t ret = RCUTILS_RET_OK;
+  for (bool found = NULL != iter->entry_name;
+    found && !rcutils_atomic_load_bool(&walk->stopped);
+    found = rcutils_dir_iter_next(iter))
+  {
+    const char * name = iter->entry_name;
+    // Skip over local folder handle (`.`) and parent folder (`..`)
+    if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0) {
+      continue;
+    }
+    if (NULL != options->exclude_pattern && dir_walk_match(options->exclude_pattern, name)) {
+      continue;
+    }
+    ret = rcutils_path_push(path, name);
+    if (RCUTILS_RET_OK != ret) {
+      break;
+    }
+    rcutils_dir_walk_action_t action = RCUTILS_DIR_WALK_CONTINUE;
+    if (NULL == options->include_pattern || dir_walk_match(options->include_pattern, name)) {
+      rcutils_dir_walk_entry_t entry = {
+        path->buffer, name, depth, iter->entry_type, iter->entry_size, iter->entry_mtime};
+      action = walk->callback(&entry, walk->user_data);
+    }
+    if (RCUTILS_DIR_WALK_STOP == action) {
+      rcutils_atomic_store(&walk->stopped, true);
+    } else if (
+      RCUTILS_DIR_WALK_PRUNE != action &&
+      RCUTILS_DIR_ENTRY_TYPE_DIRECTORY == iter->entry_type &&
+      (0 == options->max_depth || depth < options->max_depth))
+    {
+      ret = dir_walk_subdirectory(walk, iter, name, path, depth + 1);
+      if (RCUTILS_RET_OK != ret) {
+        break;
+      }
+    }
+    ret = rcutils_path_pop(path);
+    if (RCUTILS_RET_OK != ret) {
+      break;
+    }
+  }
+  return ret;
+}
+
+// The function of the pool, walking a directory handed to it.
+static void dir_walk_item(rcutils_thread_pool_t * pool, void * context, void * item)
+{
+  RCUTILS_UNUSED(pool);
+  dir_walk_t * walk = (dir_walk_t *)context;
+  dir_walk_item_t * walk_item = (dir_walk_item_t *)item;
+  if (!rcutils_atomic_load_bool(&walk->stopped)) {
+    RCUTILS_CHAR_ARRAY_WITH_STACK(path, 256, walk->allocator);
+    rcutils_ret_t ret = rcutils_char_array_strcpy(&path, walk_item->path);
+    if (RCUTILS_RET_OK == ret) {
+      rcutils_dir_iter_t * iter = dir_iter_start_at(
+        NULL, NULL, walk_item->path, &walk->iter_options, walk->allocator);
+      ret = NULL == iter ? RCUTILS_RET_ERROR :
+        dir_walk_directory(walk, iter, &path, walk_item->depth);
+      rcutils_dir_iter_end(iter);
+    }
+    rcutils_ret_t fini_ret = rcutils_char_array_fini(&path);
+    RCUTILS_UNUSED(fini_ret);
+    if (RCUTILS_RET_OK != ret) {
+      dir_walk_fail(walk, ret);
+    }
+  }
+  walk->allocator.deallocate(walk_item->path, walk->allocator.state);
+}
+
+rcutils_dir_walk_options_t
+rcutils_dir_walk_get_default_options(void)
+{
+  static rcutils_dir_walk_options_t default_options = {
+    .max_depth = 0,
+    .include_pattern = NULL,
+    .exclude_pattern = NULL,
+    .stat_entries = false,
+    .threads = 1,
+  };
+  return default_options;
+}
+
+rcutils_ret_t
+rcutils_dir_walk(
+  const char * directory_path,
+  const rcutils_dir_walk_options_t * options,
+  rcutils_dir_walk_callback_t callback,
+  void * user_data,
+  rcutils_allocator_t allocator)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(directory_path, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(callback, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ALLOCATOR_WITH_MSG(
+    &allocator, "allocator is invalid", return RCUTILS_RET_INVALID_ARGUMENT);
+
+  dir_walk_t walk;
+  walk.options = NULL == options ? rcutils_dir_walk_get_default_options() : *options;
+  walk.iter_options = rcutils_dir_iter_get_default_options();
+  walk.iter_options.stat_entries = walk.options.stat_entries;
+  walk.callback = callback;
+  walk.user_data = user_data;
+  walk.allocator = allocator;
+  walk.pool = NULL;
+  rcutils_atomic_store(&walk.stopped, false);
+  rcutils_atomic_store(&walk.ret, (uint64_t)RCUTILS_RET_OK);
+
+  rcutils_dir_iter_t * iter =
+    rcutils_dir_iter_start_with_options(directory_path, &walk.iter_options, allocator);
+  if (NULL == iter) {
+    return RCUTILS_RET_ERROR;
+  }
+  rcutils_thread_pool_t pool = rcutils_get_zero_initialized_thread_pool();
+  if (walk.options.threads > 1 && 1 != walk.options.max_depth) {
+    rcutils_thread_pool_options_t pool_options = rcutils_thread_pool_get_default_options();
+    pool_options.thread_count = walk.options.threads;
+    rcutils_ret_t ret = rcutils_thread_pool_init(
+      &pool, dir_walk_item, &walk, sizeof(dir_walk_item_t), &pool_options, allocator);
+    if (RCUTILS_RET_OK != ret) {
+      rcutils_dir_iter_end(iter);
+      return ret;
+    }
+    walk.pool = &pool;
+  }
+
+  // The walked directory is walked on the calling thread, which then helps the pool.
+  RCUTILS_CHAR_ARRAY_WITH_STACK(path, 256, allocator);
+  rcutils_ret_t ret = rcutils_char_array_strcpy(&path, directory_path);
+  if (RCUTILS_RET_OK == ret) {
+    ret = dir_walk_directory(&walk, iter, &path, 1);
+  }
+  rcutils_dir_iter_end(iter);
+  rcutils_ret_t fini_ret = rcutils_char_array_fini(&path);
+  RCUTILS_UNUSED(fini_ret);
+  if (RCUTILS_RET_OK != ret) {
+    dir_walk_fail(&walk, ret);
+  }
+  if (NULL != walk.pool) {
+    // The remaining directories are skipped once stopped, but their paths are freed.
+    ret = rcutils_thread_pool_wait(&pool);
+    RCUTILS_UNUSED(ret);
+    ret = rcutils_thread_pool_fini(&pool);
+    RCUTILS_UNUSED(ret);
+  }
+
+  ret = (rcutils_ret_t)rcutils_atomic_load_uint64_t(&walk.ret);
+  if (RCUTILS_RET_OK != ret && !rcutils_error_is_set()) {
+    // The error was set on the thread which failed.
+    RCUTILS_SET_ERROR_MSG("Failed to walk a subdirectory");
+  }
+  return ret;
+}
+
+size_t
+rcutils_get_file_size(const char * file_path)
+{
+  rcutils_path_status_t status = get_path_status(file_path);
+  if (RCUTILS_DIR_ENTRY_TYPE_FILE != status.type) {
+    RCUTILS_SAFE_FWRITE_TO_STDERR_WITH_FORMAT_STRING(
+      "Path is not a file: %s\n", file_path);
+    return 0;
+  }
+  return (size_t)status.size;
+}
+
+#if defined(_WIN32)
+// WaitForMultipleObjects() waits for at most this many events, one per watch.
+# define RCUTILS_FILE_WATCH_MAX_WATCHES MAXIMUM_WAIT_OBJECTS
+// The size of the buffer each watched directory reports its changes in.
+# define RCUTILS_FILE_WATCH_BUFFER_SIZE 16384
+
+typedef struct rcutils_file_watch_t
+{
+  // The watched directory, or the directory of the watched file, NULL if the slot is free.
+  HANDLE directory;
+  HANDLE event;
+  OVERLAPPED overlapped;
+  DWORD filter;
+  uint32_t events;
+  // Whether changes are being read, it stops when the directory can't be read anymore.
+  bool active;
+  DWORD * buffer;
+  // The name of the watched file, empty if a directory is watched.
+  WCHAR file_name[MAX_PATH];
+  size_t file_name_length;
+} rcutils_file_watch_t;
+#elif defined(RCUTILS_FILE_WATCH_KQUEUE)
+typedef struct rcutils_file_watch_t
+{
+  // The descriptor of the watched path, which is the id of the watch as well.
+  int fd;
+} rcutils_file_watch_t;
+#endif
+
+typedef struct rcutils_file_watcher_impl_t
+{
+  rcutils_allocator_t allocator;
+#if defined(_WIN32)
+  rcutils_file_watch_t watches[RCUTILS_FILE_WATCH_MAX_WATCHES];
+  // The UTF-8 name of the changed entry being reported.
+  char name[MAX_PATH * 3 + 1];
+#else
+  int fd;
+# if defined(RCUTILS_FILE_WATCH_INOTIFY)
+  // The events read at once, aligned for them, with room for at least one with a long name.
+  _Alignas(struct inotify_event) char buffer[4096];
+# elif defined(RCUTILS_FILE_WATCH_KQUEUE)
+  rcutils_file_watch_t * watches;
+  size_t watch_count;
+  size_t watch_capacity;
+# endif
+#endif
+} rcutils_file_watcher_impl_t;
+
+#if defined(RCUTILS_FILE_WATCH_INOTIFY) || defined(_WIN32)
+// Convert a timeout in nanoseconds to milliseconds, rounded up, or -1 to wait indefinitely.
+static int file_watch_timeout_ms(rcutils_duration_value_t timeout)
+{
+  if (timeout < 0) {
+    return -1;
+  }
+  rcutils_duration_value_t timeout_ms = RCUTILS_NS_TO_MS(timeout + RCUTILS_MS_TO_NS(1) - 1);
+  return timeout_ms > INT_MAX ? INT_MAX : (int)timeout_ms;
+}
+#endif  // defined(RCUTILS_FILE_WATCH_INOTIFY) || defined(_WIN32)
+
+#if defined(RCUTILS_FILE_WATCH_INOTIFY) || defined(RCUTILS_FILE_WATCH_KQUEUE)
+static rcutils_ret_t file_watch_error_from_errno(const char * path, int error)
+{
+  RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+    "Can't watch %s. Error code: %d\n", path, error);
+  switch (error) {
+    case ENOENT:
+    case ENOTDIR:
+      return RCUTILS_RET_NOT_FOUND;
+    case ENOSPC:
+    case EMFILE:
+    case ENFILE:
+      return RCUTILS_RET_NOT_ENOUGH_SPACE;
+    case ENOMEM:
+      return RCUTILS_RET_BAD_ALLOC;
+    default:
+      return RCUTILS_RET_ERROR;
+  }
+}
+#endif  // defined(RCUTILS_FILE_WATCH_INOTIFY) || defined(RCUTILS_FILE_WATCH_KQUEUE)
+
+#if defined(RCUTILS_FILE_WATCH_INOTIFY)
+static rcutils_ret_t file_watcher_open(rcutils_file_watcher_impl_t * impl)
+{
+  impl->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (-1 == impl->fd) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "Can't initialize inotify. Error code: %d\n", errno);
+    return RCUTILS_RET_ERROR;
+  }
+  return RCUTILS_RET_OK;
+}
+
+static void file_watcher_close(rcutils_file_watcher_impl_t * impl)
+{
+  close(impl->fd);
+}
+
+static rcutils_ret_t file_watcher_add(
+  rcutils_file_watcher_impl_t * impl, const char * path, uint32_t events, int32_t * watch_id)
+{
+  uint32_t mask = 0u;
+  if (events & RCUTILS_FILE_WATCH_CREATED) {
+    mask |= IN_CREATE;
+  }
+  if (events & RCUTILS_FILE_WATCH_DELETED) {
+    mask |= IN_DELETE | IN_DELETE_SELF;
+  }
+  if (events & RCUTILS_FILE_WATCH_MODIFIED) {
+    mask |= IN_MODIFY;
+  }
+  if (events & RCUTILS_FILE_WATCH_MOVED_FROM) {
+    mask |= IN_MOVED_FROM | IN_MOVE_SELF;
+  }
+  if (events & RCUTILS_FILE_WATCH_MOVED_TO) {
+    mask |= IN_MOVED_TO;
+  }
+  int wd = inotify_add_watch(impl->fd, path, mask);
+  if (-1 == wd) {
+    return file_watch_error_from_errno(path, errno);
+  }
+  *watch_id = wd;
+  return RCUTILS_RET_OK;
+}
+
+static rcutils_ret_t file_watcher_remove(rcutils_file_watcher_impl_t * impl, int32_t watch_id)
+{
+  if (0 != inotify_rm_watch(impl->fd, watch_id)) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("No watch with id %d\n", watch_id);
+    return RCUTILS_RET_NOT_FOUND;
+  }
+  return RCUTILS_RET_OK;
+}
+
+static uint32_t file_watch_type_from_mask(uint32_t mask)
+{
+  if (mask & IN_Q_OVERFLOW) {
+    return RCUTILS_FILE_WATCH_OVERFLOW;
+  }
+  if (mask & IN_CREATE) {
+    return RCUTILS_FILE_WATCH_CREATED;
+  }
+  if (mask & (IN_DELETE | IN_DELETE_SELF)) {
+    return RCUTILS_FILE_WATCH_DELETED;
+  }
+  if (mask & IN_MODIFY) {
+    return RCUTILS_FILE_WATCH_MODIFIED;
+  }
+  if (mask & (IN_MOVED_FROM | IN_MOVE_SELF)) {
+    return RCUTILS_FILE_WATCH_MOVED_FROM;
+  }
+  if (mask & IN_MOVED_TO) {
+    return RCUTILS_FILE_WATCH_MOVED_TO;
+  }
+  // E.g. IN_IGNORED when a watch is removed.
+  return 0u;
+}
+
+static rcutils_ret_t file_watcher_read(
+  rcutils_file_watcher_impl_t * impl,
+  rcutils_duration_value_t timeout,
+  rcutils_file_watch_callback_t callback,
+  void * user_data,
+  size_t * event_count)
+{
+  struct pollfd poll_fd = {.fd = impl->fd, .events = POLLIN, .revents = 0};
+  int ready = poll(&poll_fd, 1, file_watch_timeout_ms(timeout));
+  if (ready < 0 && EINTR != errno) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("Can't wait for changes. Error code: %d\n", errno);
+    return RCUTILS_RET_ERROR;
+  }
+  if (ready <= 0) {
+    return RCUTILS_RET_OK;
+  }
+  // Drain the queue, the descriptor is non-blocking.
+  for (;;) {
+    ssize_t length = read(impl->fd, impl->buffer, sizeof(impl->buffer));
+    if (length < 0) {
+      if (EINTR == errno) {
+        continue;
+      }
+      if (EAGAIN == errno || EWOULDBLOCK == errno) {
+        return RCUTILS_RET_OK;
+      }
+      RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("Can't read changes. Error code: %d\n", errno);
+      return RCUTILS_RET_ERROR;
+    }
+    const char * end = impl->buffer + length;
+    for (const char * p = impl->buffer; p < end; ) {
+      const struct inotify_event * inotify_event = (const struct inotify_event *)p;
+      p += sizeof(struct inotify_event) + inotify_event->len;
+      rcutils_file_watch_event_t event;
+      event.type = (rcutils_file_watch_event_type_t)file_watch_type_from_mask(inotify_event->mask);
+      if (0u == (uint32_t)event.type) {
+        continue;
+      }
+      event.watch_id = inotify_event->wd;
+      event.name = inotify_event->len > 0u ? inotify_event->name : "";
+      callback(&event, user_data);
+      ++*event_count;
+    }
+  }
+}
+
+static int file_watcher_fd(const rcutils_file_watcher_impl_t * impl)
+{
+  return impl->fd;
+}
+#elif defined(RCUTILS_FILE_WATCH_KQUEUE)
+static rcutils_ret_t file_watcher_open(rcutils_file_watcher_impl_t * impl)
+{
+  impl->fd = kqueue();
+  if (-1 == impl->fd) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "Can't initialize kqueue. Error code: %d\n", errno);
+    return RCUTILS_RET_ERROR;
+  }
+  (void)fcntl(impl->fd, F_SETFD, FD_CLOEXEC);
+  return RCUTILS_RET_OK;
+}
+
+static void file_watcher_close(rcutils_file_watcher_impl_t * impl)
+{
+  // Closing the watched descriptors removes their events from the queue.
+  for (size_t i = 0u; i < impl->watch_count; ++i) {
+    close(impl->watches[i].fd);
+  }
+  impl->allocator.deallocate(impl->watches, impl->allocator.state);
+  close(impl->fd);
+}
+
+static rcutils_ret_t file_watcher_add(
+  rcutils_file_watcher_impl_t * impl, const char * path, uint32_t events, int32_t * watch_id)
+{
+  if (impl->watch_count == impl->watch_capacity) {
+    size_t capacity = impl->watch_capacity > 0u ? impl->watch_capacity * 2u : 8u;
+    rcutils_file_watch_t * watches = impl->allocator.reallocate(
+      impl->watches, capacity * sizeof(rcutils_file_watch_t), impl->allocator.state);
+    RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+      watches, "Failed to allocate memory.\n", return RCUTILS_RET_BAD_ALLOC);
+    impl->watches = watches;
+    impl->watch_capacity = capacity;
+  }
+# ifdef O_EVTONLY
+  int fd = open(path, O_EVTONLY | O_CLOEXEC);
+# else
+  int fd = open(path, O_RDONLY | O_CLOEXEC);
+# endif
+  struct stat buf;
+  if (-1 == fd || 0 != fstat(fd, &buf)) {
+    int error = errno;
+    if (-1 != fd) {
+      close(fd);
+    }
+    return file_watch_error_from_errno(path, error);
+  }
+  // The entries of a directory changing is all kqueue reports about them.
+  unsigned int fflags = 0u;
+  if (S_ISDIR(buf.st_mode)) {
+    if (events & RCUTILS_FILE_WATCH_ALL) {
+      fflags |= NOTE_WRITE;
+    }
+  } else if (events & RCUTILS_FILE_WATCH_MODIFIED) {
+    fflags |= NOTE_WRITE | NOTE_EXTEND;
+  }
+  if (events & RCUTILS_FILE_WATCH_DELETED) {
+    fflags |= NOTE_DELETE;
+  }
+  if (events & RCUTILS_FILE_WATCH_MOVED_FROM) {
+    fflags |= NOTE_RENAME;
+  }
+  struct kevent change;
+  EV_SET(&change, (uintptr_t)fd, EVFILT_VNODE, EV_ADD | EV_CLEAR, fflags, 0, NULL);
+  if (-1 == kevent(impl->fd, &change, 1, NULL, 0, NULL)) {
+    int error = errno;
+    close(fd);
+    return file_watch_error_from_errno(path, error);
+  }
+  impl->watches[impl->watch_count++].fd = fd;
+  *watch_id = fd;
+  return RCUTILS_RET_OK;
+}
+
+static rcutils_ret_t file_watcher_remove(rcutils_file_watcher_impl_t * impl, int32_t watch_id)
+{
+  for (size_t i = 0u; i < impl->watch_count; ++i) {
+    if (impl->watches[i].fd == watch_id) {
+      close(watch_id);
+      impl->watches[i] = impl->watches[--impl->watch_count];
+      return RCUTILS_RET_OK;
+    }
+  }
+  RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("No watch with id %d\n", watch_id);
+  return RCUTILS_RET_NOT_FOUND;
+}
+
+static rcutils_ret_t file_watcher_read(
+  rcutils_file_watcher_impl_t * impl,
+  rcutils_duration_value_t timeout,
+  rcutils_file_watch_callback_t callback,
+  void * user_data,
+  size_t * event_count)
+{
+  struct timespec wait_time = {0, 0};
+  if (timeout > 0) {
+    wait_time.tv_sec = (time_t)(timeout / RCUTILS_S_TO_NS(1));
+    wait_time.tv_nsec = (long)(timeout % RCUTILS_S_TO_NS(1));  // NOLINT(runtime/int)
+  }
+  struct kevent changes[32];
+  const int max_changes = (int)(sizeof(changes) / sizeof(changes[0]));
+  int count = kevent(impl->fd, NULL, 0, changes, max_changes, timeout < 0 ? NULL : &wait_time);
+  while (count > 0) {
+    for (int i = 0; i < count; ++i) {
+      if (changes[i].flags & EV_ERROR) {
+        continue;
+      }
+      rcutils_file_watch_event_t event;
+      event.watch_id = (int32_t)changes[i].ident;
+      event.name = "";
+      const unsigned int fflags = changes[i].fflags;
+      if (fflags & (NOTE_WRITE | NOTE_EXTEND)) {
+        event.type = RCUTILS_FILE_WATCH_MODIFIED;
+        callback(&event, user_data);
+        ++*event_count;
+      }
+      if (fflags & NOTE_RENAME) {
+        event.type = RCUTILS_FILE_WATCH_MOVED_FROM;
+        callback(&event, user_data);
+        ++*event_count;
+      }
+      if (fflags & NOTE_DELETE) {
+        event.type = RCUTILS_FILE_WATCH_DELETED;
+        callback(&event, user_data);
+        ++*event_count;
+      }
+    }
+    if (count < max_changes) {
+      return RCUTILS_RET_OK;
+    }
+    // There may be more changes queued, read them without waiting.
+    wait_time.tv_sec = 0;
+    wait_time.tv_nsec = 0;
+    count = kevent(impl->fd, NULL, 0, changes, max_changes, &wait_time);
+  }
+  if (count < 0 && EINTR != errno) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("Can't read changes. Error code: %d\n", errno);
+    return RCUTILS_RET_ERROR;
+  }
+  return RCUTILS_RET_OK;
+}
+
+static int file_watcher_fd(const rcutils_file_watcher_impl_t * impl)
+{
+  return impl->fd;
+}
+#elif defined(_WIN32)
+static rcutils_ret_t file_watcher_open(rcutils_file_watcher_impl_t * impl)
+{
+  (void)impl;
+  return RCUTILS_RET_OK;
+}
+
+static bool file_watch_start_read(rcutils_file_watch_t * watch)
+{
+  ResetEvent(watch->event);
+  memset(&watch->overlapped, 0, sizeof(watch->overlapped));
+  watch->overlapped.hEvent = watch->event;
+  watch->active = ReadDirectoryChangesW(
+    watch->directory, watch->buffer, RCUTILS_FILE_WATCH_BUFFER_SIZE, FALSE, watch->filter,
+    NULL, &watch->overlapped, NULL);
+  return watch->active;
+}
+
+static void file_watch_close(rcutils_file_watch_t * watch, rcutils_allocator_t * allocator)
+{
+  if (NULL != watch->directory && INVALID_HANDLE_VALUE != watch->directory) {
+    if (watch->active) {
+      DWORD bytes = 0;
+      CancelIoEx(watch->directory, &watch->overlapped);
+      GetOverlappedResult(watch->directory, &watch->overlapped, &bytes, TRUE);
+    }
+    CloseHandle(watch->directory);
+  }
+  if (NULL != watch->event) {
+    CloseHandle(watch->event);
+  }
+  allocator->deallocate(watch->buffer, allocator->state);
+  memset(watch, 0, sizeof(*watch));
+}
+
+static void file_watcher_close(rcutils_file_watcher_impl_t * impl)
+{
+  for (size_t i = 0u; i < RCUTILS_FILE_WATCH_MAX_WATCHES; ++i) {
+    if (NULL != impl->watches[i].directory) {
+      file_watch_close(&impl->watches[i], &impl->allocator);
+    }
+  }
+}
+
+static rcutils_ret_t file_watcher_add(
+  rcutils_file_watcher_impl_t * impl, const char * path, uint32_t events, int32_t * watch_id)
+{
+  rcutils_file_watch_t * watch = NULL;
+  int32_t index = 0;
+  for (; index < RCUTILS_FILE_WATCH_MAX_WATCHES; ++index) {
+    if (NULL == impl->watches[index].directory) {
+      watch = &impl->watches[index];
+      break;
+    }
+  }
+  if (NULL == watch) {
+    RCUTILS_SET_ERROR_MSG("Too many watched paths\n");
+    return RCUTILS_RET_NOT_ENOUGH_SPACE;
+  }
+  DWORD attributes = GetFileAttributesA(path);
+  if (INVALID_FILE_ATTRIBUTES == attributes) {
+    DWORD error = GetLastError();
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("Can't watch %s. Error code: %d\n", path, error);
+    return ERROR_FILE_NOT_FOUND == error || ERROR_PATH_NOT_FOUND == error ?
+           RCUTILS_RET_NOT_FOUND : RCUTILS_RET_ERROR;
+  }
+  // Only directories report changes, a file is watched through the changes of its directory.
+  char directory[MAX_PATH] = ".";
+  const char * directory_path = path;
+  if (0u == (attributes & FILE_ATTRIBUTE_DIRECTORY)) {
+    const char * file_name = path;
+    for (const char * p = path; '\0' != *p; ++p) {
+      if ('\\' == *p || '/' == *p) {
+        file_name = p + 1;
+      }
+    }
+    size_t directory_length = (size_t)(file_name - path);
+    if (directory_length >= sizeof(directory)) {
+      RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("Path is too long: %s\n", path);
+      return RCUTILS_RET_INVALID_ARGUMENT;
+    }
+    if (directory_length > 0u) {
+      // The separator is kept, so that the directory of "C:\file" is "C:\".
+      memcpy(directory, path, directory_length);
+      directory[directory_length] = '\0';
+    }
+    directory_path = directory;
+    int length = MultiByteToWideChar(CP_ACP, 0, file_name, -1, watch->file_name, MAX_PATH);
+    if (length <= 1) {
+      RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("Invalid file name: %s\n", path);
+      return RCUTILS_RET_INVALID_ARGUMENT;
+    }
+    watch->file_name_length = (size_t)length - 1u;
+  }
+  watch->filter = 0u;
+  if (events & (RCUTILS_FILE_WATCH_CREATED | RCUTILS_FILE_WATCH_DELETED |
+    RCUTILS_FILE_WATCH_MOVED_FROM | RCUTILS_FILE_WATCH_MOVED_TO))
+  {
+    watch->filter |= FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME;
+  }
+  if (events & RCUTILS_FILE_WATCH_MODIFIED) {
+    watch->filter |= FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE;
+  }
+  watch->events = events;
+  watch->directory = CreateFileA(
+    directory_path, FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+    NULL, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, NULL);
+  watch->event = CreateEvent(NULL, TRUE, FALSE, NULL);
+  watch->buffer = impl->allocator.allocate(RCUTILS_FILE_WATCH_BUFFER_SIZE, impl->allocator.state);
+  if (INVALID_HANDLE_VALUE == watch->directory || NULL == watch->event ||
+    NULL == watch->buffer || !file_watch_start_read(watch))
+  {
+    DWORD error = GetLastError();
+    bool bad_alloc = NULL == watch->buffer;
+    file_watch_close(watch, &impl->allocator);
+    if (bad_alloc) {
+      RCUTILS_SET_ERROR_MSG("Failed to allocate memory.\n");
+      return RCUTILS_RET_BAD_ALLOC;
+    }
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("Can't watch %s. Error code: %d\n", path, error);
+    return RCUTILS_RET_ERROR;
+  }
+  *watch_id = index;
+  return RCUTILS_RET_OK;
+}
+
+static rcutils_ret_t file_watcher_remove(rcutils_file_watcher_impl_t * impl, int32_t watch_id)
+{
+  if (watch_id < 0 || watch_id >= RCUTILS_FILE_WATCH_MAX_WATCHES ||
+    NULL == impl->watches[watch_id].directory)
+  {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("No watch with id %d\n", watch_id);
+    return RCUTILS_RET_NOT_FOUND;
+  }
+  file_watch_close(&impl->watches[watch_id], &impl->allocator);
+  return RCUTILS_RET_OK;
+}
+
+static void file_watch_report(
+  rcutils_file_watcher_impl_t * impl,
+  int32_t watch_id,
+  rcutils_file_watch_callback_t callback,
+  void * user_data,
+  size_t * event_count)
+{
+  rcutils_file_watch_t * watch = &impl->watches[watch_id];
+  const FILE_NOTIFY_INFORMATION * info = (const FILE_NOTIFY_INFORMATION *)watch->buffer;
+  for (;; info = (const FILE_NOTIFY_INFORMATION *)((const char *)info + info->NextEntryOffset)) {
+    rcutils_file_watch_event_t event;
+    event.watch_id = watch_id;
+    switch (info->Action) {
+      case FILE_ACTION_ADDED:
+        event.type = RCUTILS_FILE_WATCH_CREATED;
+        break;
+      case FILE_ACTION_REMOVED:
+        event.type = RCUTILS_FILE_WATCH_DELETED;
+        break;
+      case FILE_ACTION_MODIFIED:
+        event.type = RCUTILS_FILE_WATCH_MODIFIED;
+        break;
+      case FILE_ACTION_RENAMED_OLD_NAME:
+        event.type = RCUTILS_FILE_WATCH_MOVED_FROM;
+        break;
+      case FILE_ACTION_RENAMED_NEW_NAME:
+        event.type = RCUTILS_FILE_WATCH_MOVED_TO;
+        break;
+      default:
+        event.type = 0;
+        break;
+    }
+    const size_t name_length = info->FileNameLength / sizeof(WCHAR);
+    if (0u != ((uint32_t)event.type & watch->events)) {
+      if (watch->file_name_length > 0u) {
+        // Only the changes of the watched file are reported.
+        if (name_length == watch->file_name_length &&
+          0 == _wcsnicmp(info->FileName, watch->file_name, name_length))
+        {
+          event.name = "";
+          callback(&event, user_data);
+          ++*event_count;
+        }
+      } else {
+        int length = WideCharToMultiByte(
+          CP_UTF8, 0, info->FileName, (int)name_length, impl->name, (int)sizeof(impl->name) - 1,
+          NULL, NULL);
+        impl->name[length > 0 ? length : 0] = '\0';
+        event.name = impl->name;
+        callback(&event, user_data);
+        ++*event_count;
+      }
+    }
+    if (0u == info->NextEntryOffset) {
+      break;
+    }
+  }
+}
+
+static rcutils_ret_t file_watcher_read(
+  rcutils_file_watcher_impl_t * impl,
+  rcutils_duration_value_t timeout,
+  rcutils_file_watch_callback_t callback,
+  void * user_data,
+  size_t * event_count)
+{
+  HANDLE handles[RCUTILS_FILE_WATCH_MAX_WATCHES];
+  DWORD handle_count = 0u;
+  for (size_t i = 0u; i < RCUTILS_FILE_WATCH_MAX_WATCHES; ++i) {
+    if (impl->watches[i].active) {
+      handles[handle_count++] = impl->watches[i].event;
+    }
+  }
+  const int timeout_ms = file_watch_timeout_ms(timeout);
+  if (0u == handle_count) {
+    if (timeout_ms > 0) {
+      Sleep((DWORD)timeout_ms);
+    }
+    return RCUTILS_RET_OK;
+  }
+  DWORD result = WaitForMultipleObjects(
+    handle_count, handles, FALSE, timeout_ms < 0 ? INFINITE : (DWORD)timeout_ms);
+  if (WAIT_FAILED == result) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "Can't wait for changes. Error code: %d\n", GetLastError());
+    return RCUTILS_RET_ERROR;
+  }
+  if (WAIT_TIMEOUT == result) {
+    return RCUTILS_RET_OK;
+  }
+  // Report the changes of all the directories which have some, not only the first one.
+  for (int32_t i = 0; i < RCUTILS_FILE_WATCH_MAX_WATCHES; ++i) {
+    rcutils_file_watch_t * watch = &impl->watches[i];
+    if (!watch->active || !HasOverlappedIoCompleted(&watch->overlapped)) {
+      continue;
+    }
+    DWORD bytes = 0u;
+    if (!GetOverlappedResult(watch->directory, &watch->overlapped, &bytes, FALSE)) {
+      // The directory can't be read anymore, e.g. because it was deleted.
+      watch->active = false;
+      if (watch->events & RCUTILS_FILE_WATCH_DELETED) {
+        rcutils_file_watch_event_t event = {i, RCUTILS_FILE_WATCH_DELETED, ""};
+        callback(&event, user_data);
+        ++*event_count;
+      }
+      continue;
+    }
+    if (0u == bytes) {
+      rcutils_file_watch_event_t event = {-1, RCUTILS_FILE_WATCH_OVERFLOW, ""};
+      callback(&event, user_data);
+      ++*event_count;
+    } else {
+      file_watch_report(impl, i, callback, user_data, event_count);
+    }
+    file_watch_start_read(watch);
+  }
+  return RCUTILS_RET_OK;
+}
+
+static int file_watcher_fd(const rcutils_file_watcher_impl_t * impl)
+{
+  (void)impl;
+  return -1;
+}
+#else
+static rcutils_ret_t file_watcher_open(rcutils_file_watcher_impl_t * impl)
+{
+  (void)impl;
+  RCUTILS_SET_ERROR_MSG("Watching files is not supported on this system\n");
+  return RCUTILS_RET_ERROR;
+}
+
+static void file_watcher_close(rcutils_file_watcher_impl_t * impl)
+{
+  (void)impl;
+}
+
+static rcutils_ret_t file_watcher_add(
+  rcutils_file_watcher_impl_t * impl, const char * path, uint32_t events, int32_t * watch_id)
+{
+  (void)impl;
+  (void)path;
+  (void)events;
+  (void)watch_id;
+  return RCUTILS_RET_ERROR;
+}
+
+static rcutils_ret_t file_watcher_remove(rcutils_file_watcher_impl_t * impl, int32_t watch_id)
+{
+  (void)impl;
+  (void)watch_id;
+  return RCUTILS_RET_NOT_FOUND;
+}
+
+static rcutils_ret_t file_watcher_read(
+  rcutils_file_watcher_impl_t * impl,
+  rcutils_duration_value_t timeout,
+  rcutils_file_watch_callback_t callback,
+  void * user_data,
+  size_t * event_count)
+{
+  (void)impl;
+  (void)timeout;
+  (void)callback;
+  (void)user_data;
+  (void)event_count;
+  return RCUTILS_RET_ERROR;
+}
+
+static int file_watcher_fd(const rcutils_file_watcher_impl_t * impl)
+{
+  (void)impl;
+  return -1;
+}
+#endif
+
+rcutils_file_watcher_t
+rcutils_get_zero_initialized_file_watcher(void)
+{
+  static rcutils_file_watcher_t zero_initialized_file_watcher = {NULL};
+  return zero_initialized_file_watcher;
+}
+
+rcutils_ret_t
+rcutils_file_watcher_init(rcutils_file_watcher_t * watcher, const rcutils_allocator_t * allocator)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(watcher, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ALLOCATOR(allocator, return RCUTILS_RET_INVALID_ARGUMENT);
+  if (NULL != watcher->impl) {
+    RCUTILS_SET_ERROR_MSG("File watcher is already initialized\n");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  rcutils_file_watcher_impl_t * impl = allocator->zero_allocate(
+    1, sizeof(rcutils_file_watcher_impl_t), allocator->state);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    impl, "Failed to allocate memory.\n", return RCUTILS_RET_BAD_ALLOC);
+  impl->allocator = *allocator;
+  rcutils_ret_t ret = file_watcher_open(impl);
+  if (RCUTILS_RET_OK != ret) {
+    allocator->deallocate(impl, allocator->state);
+    return ret;
+  }
+  watcher->impl = impl;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_file_watcher_fini(rcutils_file_watcher_t * watcher)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(watcher, RCUTILS_RET_INVALID_ARGUMENT);
+  rcutils_file_watcher_impl_t * impl = watcher->impl;
+  if (NULL == impl) {
+    return RCUTILS_RET_OK;
+  }
+  file_watcher_close(impl);
+  rcutils_allocator_t allocator = impl->allocator;
+  allocator.deallocate(impl, allocator.state);
+  watcher->impl = NULL;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_file_watcher_add_watch(
+  rcutils_file_watcher_t * watcher,
+  const char * path,
+  uint32_t events,
+  int32_t * watch_id)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(watcher, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(path, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(watch_id, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    watcher->impl, "File watcher is not initialized\n", return RCUTILS_RET_NOT_INITIALIZED);
+  if (0u == (events & RCUTILS_FILE_WATCH_ALL) || 0u != (events & ~RCUTILS_FILE_WATCH_ALL)) {
+    RCUTILS_SET_ERROR_MSG("Invalid types of changes to watch\n");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  return file_watcher_add(watcher->impl, path, events, watch_id);
+}
+
+rcutils_ret_t
+rcutils_file_watcher_remove_watch(rcutils_file_watcher_t * watcher, int32_t watch_id)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(watcher, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    watcher->impl, "File watcher is not initialized\n", return RCUTILS_RET_NOT_INITIALIZED);
+  return file_watcher_remove(watcher->impl, watch_id);
+}
+
+rcutils_ret_t
+rcutils_file_watcher_get_fd(const rcutils_file_watcher_t * watcher, int * fd)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(watcher, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(fd, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    watcher->impl, "File watcher is not initialized\n", return RCUTILS_RET_NOT_INITIALIZED);
+  *fd = file_watcher_fd(watcher->impl);
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_file_watcher_read(
+  rcutils_file_watcher_t * watcher,
+  rcutils_duration_value_t timeout,
+  rcutils_file_watch_callback_t callback,
+  void * user_data,
+  size_t * event_count)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(watcher, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(callback, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    watcher->impl, "File watcher is not initialized\n", return RCUTILS_RET_NOT_INITIALIZED);
+  size_t count = 0u;
+  rcutils_ret_t ret = file_watcher_read(watcher->impl, timeout, callback, user_data, &count);
+  if (NULL != event_count) {
+    *event_count = count;
+  }
+  return ret;
 }
 
 #ifdef __cplusplus
@@ -22,16 +22,48 @@ extern "C"
 #include <stdlib.h>
 #include <string.h>
 
+#include "rcutils/error_handling.h"
 #include "rcutils/find.h"
 #include "rcutils/types.h"
 
+#if !defined(_GNU_SOURCE) || defined(__QNXNTO__)
+// Searches a word at a time, as memrchr() does where it is available.
+static const char *
+_find_last_in_memory(const char * str, char delimiter, size_t length)
+{
+  const uintptr_t ones = (uintptr_t)-1 / 0xFFu;
+  const uintptr_t pattern = ones * (unsigned char)delimiter;
+  size_t i = length;
+  while (i >= sizeof(uintptr_t)) {
+    uintptr_t word;
+    memcpy(&word, str + i - sizeof(uintptr_t), sizeof(word));
+    word ^= pattern;
+    // Nonzero if any of the bytes of the word is zero, that is equal to the delimiter
+    if (0u != ((word - ones) & ~word & (ones << 7))) {
+      break;
+    }
+    i -= sizeof(uintptr_t);
+  }
+  while (i > 0u) {
+    --i;
+    if (str[i] == delimiter) {
+      return str + i;
+    }
+  }
+  return NULL;
+}
+#endif
+
 size_t
 rcutils_find(const char * str, char delimiter)
 {
-  if (NULL == str || 0 == strlen(str)) {
+  // Looking for the terminator would find it, but it is not part of the string
+  if (NULL == str || '\0' == delimiter) {
     return SIZE_MAX;
   }
-  return rcutils_findn(str, delimiter, strlen(str));
+  // A single pass for both the length and the delimiter
+  const char * found = strchr(str, delimiter);
+  return NULL == found ? SIZE_MAX : (size_t)(found - str);
 }
 
 size_t
@@ -40,9 +72,67 @@ rcutils_findn(const char * str, char delimiter, size_t string_length)
   if (NULL == str || 0 == string_length) {
     return SIZE_MAX;
   }
+  const char * found = memchr(str, (unsigned char)delimiter, string_length);
+  return NULL == found ? SIZE_MAX : (size_t)(found - str);
+}
+
+size_t
+rcutils_find_last(const char * str, char delimiter)
+{
+  if (NULL == str || '\0' == delimiter) {
+    return SIZE_MAX;
+  }
+  const char * found = strrchr(str, delimiter);
+  return NULL == found ? SIZE_MAX : (size_t)(found - str);
+}
+
+size_t
+rcutils_find_lastn(const char * str, char delimiter, size_t string_length)
+{
+  if (NULL == str || 0 == string_length) {
+    return SIZE_MAX;
+  }
+#if defined(_GNU_SOURCE) && !defined(__QNXNTO__)
+  const char * found = memrchr(str, (unsigned char)delimiter, string_length);
+#else
+  const char * found = _find_last_in_memory(str, delimiter, string_length);
+#endif
+  return NULL == found ? SIZE_MAX : (size_t)(found - str);
+}
 
+rcutils_ret_t
+rcutils_char_set_init(rcutils_char_set_t * set, const char * chars)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(set, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(chars, RCUTILS_RET_INVALID_ARGUMENT);
+  memset(set->bits, 0, sizeof(set->bits));
+  for (const unsigned char * c = (const unsigned char *)chars; '\0' != *c; ++c) {
+    set->bits[*c >> 6] |= (uint64_t)1u << (*c & 63u);
+  }
+  return RCUTILS_RET_OK;
+}
+
+size_t
+rcutils_find_any(const char * str, const char * delimiters)
+{
+  if (NULL == str || NULL == delimiters) {
+    return SIZE_MAX;
+  }
+  // A single pass, stopping at the terminator, which strcspn() does with its own table
+  size_t i = strcspn(str, delimiters);
+  return '\0' == str[i] ? SIZE_MAX : i;
+}
+
+size_t
+rcutils_find_anyn(
+  const char * str, const rcutils_char_set_t * delimiters, size_t string_length)
+{
+  if (NULL == str || NULL == delimiters) {
+    return SIZE_MAX;
+  }
+  const unsigned char * bytes = (const unsigned char *)str;
   for (size_t i = 0; i < string_length; ++i) {
-    if (str[i] == delimiter) {
+    if (0u != (delimiters->bits[bytes[i] >> 6] & ((uint64_t)1u << (bytes[i] & 63u)))) {
       return i;
     }
   }
@@ -50,27 +140,49 @@ rcutils_findn(const char * str, char delimiter, size_t string_length)
 }
 
 size_t
-rcutils_find_last(const char * str, char delimiter)
+rcutils_find_str(const char * str, const char * substring)
 {
-  if (NULL == str || 0 == strlen(str)) {
+  if (NULL == str || NULL == substring || '\0' == substring[0]) {
     return SIZE_MAX;
   }
-  return rcutils_find_lastn(str, delimiter, strlen(str));
+  const char * found = strstr(str, substring);
+  return NULL == found ? SIZE_MAX : (size_t)(found - str);
 }
 
 size_t
-rcutils_find_lastn(const char * str, char delimiter, size_t string_length)
+rcutils_find_strn(const char * str, const char * substring, size_t string_length)
 {
-  if (NULL == str || 0 == string_length) {
+  if (NULL == str || NULL == substring || '\0' == substring[0]) {
     return SIZE_MAX;
   }
-
-  for (size_t i = string_length - 1; i > 0; --i) {
-    if (str[i] == delimiter) {
+  size_t substring_length = strlen(substring);
+  if (substring_length > string_length) {
+    return SIZE_MAX;
+  }
+#if defined(_GNU_SOURCE) && !defined(__QNXNTO__)
+  const char * found = memmem(str, string_length, substring, substring_length);
+  return NULL == found ? SIZE_MAX : (size_t)(found - str);
+#else
+  // Only compare where both the first and the last characters match
+  const char last = substring[substring_length - 1];
+  size_t i = 0;
+  size_t candidates = string_length - substring_length + 1;
+  while (i < candidates) {
+    const char * first = memchr(str + i, (unsigned char)substring[0], candidates - i);
+    if (NULL == first) {
+      break;
+    }
+    i = (size_t)(first - str);
+    if (
+      first[substring_length - 1] == last &&
+      0 == memcmp(first + 1, substring + 1, substring_length - 1))
+    {
       return i;
     }
+    ++i;
   }
-  return str[0] == delimiter ? 0 : SIZE_MAX;
+  return SIZE_MAX;
+#endif
 }
 
 #ifdef __cplusplus
@@ -26,8 +26,12 @@ extern "C"
 #endif
 #include <string.h>
 
+#include "rcutils/error_handling.h"
 #include "rcutils/snprintf.h"
 
+// The size of the buffer on the stack into which strings are formatted first
+#define FORMAT_STRING_STACK_BUFFER_SIZE 256
+
 char *
 rcutils_format_string_limit(
   rcutils_allocator_t allocator,
@@ -35,43 +39,124 @@ rcutils_format_string_limit(
   const char * format_string,
   ...)
 {
-  if (NULL == format_string) {
+  va_list args;
+  va_start(args, format_string);
+  char * output_string = rcutils_vformat_string_limit(allocator, limit, format_string, args);
+  va_end(args);
+  return output_string;
+}
+
+char *
+rcutils_vformat_string_limit(
+  rcutils_allocator_t allocator,
+  size_t limit,
+  const char * format_string,
+  va_list args)
+{
+  if (NULL == format_string || 0 == limit) {
     return NULL;
   }
   RCUTILS_CHECK_ALLOCATOR(&allocator, return NULL);
-  // extract the variadic arguments twice, once for length calculatio and once for formatting.
-  va_list args1;
-  va_start(args1, format_string);
-  va_list args2;
-  va_copy(args2, args1);
-  // first calculate the output string
-  size_t bytes_to_be_written = (size_t)rcutils_vsnprintf(NULL, 0, format_string, args1);
-  va_end(args1);
-  if (bytes_to_be_written == (size_t)-1) {
-    va_end(args2);
+  // format into the stack buffer, which also gives the length of the output string
+  char stack_buffer[FORMAT_STRING_STACK_BUFFER_SIZE];
+  va_list args_clone;
+  va_copy(args_clone, args);
+  int ret = rcutils_vsnprintf(stack_buffer, sizeof(stack_buffer), format_string, args_clone);
+  va_end(args_clone);
+  if (0 > ret) {
     return NULL;
   }
-  // allocate space for the return string
+  size_t bytes_to_be_written = (size_t)ret;
   if (bytes_to_be_written + 1 > limit) {
     bytes_to_be_written = limit - 1;
   }
+  // allocate space for the return string
   char * output_string = allocator.allocate(bytes_to_be_written + 1, allocator.state);
   if (NULL == output_string) {
-    va_end(args2);
     return NULL;
   }
-  // format the string
-  int ret = rcutils_vsnprintf(output_string, bytes_to_be_written + 1, format_string, args2);
-  if (0 > ret) {
-    allocator.deallocate(output_string, allocator.state);
-    va_end(args2);
-    return NULL;
+  if (bytes_to_be_written < sizeof(stack_buffer)) {
+    memcpy(output_string, stack_buffer, bytes_to_be_written);
+  } else {
+    // the stack buffer was too small, format the string again
+    va_copy(args_clone, args);
+    ret = rcutils_vsnprintf(output_string, bytes_to_be_written + 1, format_string, args_clone);
+    va_end(args_clone);
+    if (0 > ret) {
+      allocator.deallocate(output_string, allocator.state);
+      return NULL;
+    }
   }
   output_string[bytes_to_be_written] = '\0';
-  va_end(args2);
   return output_string;
 }
 
+// Format into the capacity of the char array, up to the limit
+static int
+_format_string_char_array(
+  rcutils_char_array_t * char_array, size_t limit, const char * format_string, va_list args)
+{
+  size_t buffer_size = char_array->buffer_capacity < limit ? char_array->buffer_capacity : limit;
+  char * buffer = 0 == buffer_size ? NULL : char_array->buffer;
+  va_list args_clone;
+  va_copy(args_clone, args);
+  int ret = rcutils_vsnprintf(buffer, buffer_size, format_string, args_clone);
+  va_end(args_clone);
+  return ret;
+}
+
+rcutils_ret_t
+rcutils_format_string_limit_char_array(
+  rcutils_char_array_t * char_array,
+  size_t limit,
+  const char * format_string,
+  ...)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(char_array, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(format_string, RCUTILS_RET_INVALID_ARGUMENT);
+  if (0 == limit) {
+    RCUTILS_SET_ERROR_MSG("limit must be at least 1");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  va_list args;
+  va_start(args, format_string);
+  int ret = _format_string_char_array(char_array, limit, format_string, args);
+  if (0 > ret) {
+    va_end(args);
+    RCUTILS_SET_ERROR_MSG("vsnprintf on char array failed");
+    return RCUTILS_RET_ERROR;
+  }
+  size_t bytes_to_be_written = (size_t)ret;
+  if (bytes_to_be_written + 1 > limit) {
+    bytes_to_be_written = limit - 1;
+  }
+  if (bytes_to_be_written + 1 > char_array->buffer_capacity) {
+    rcutils_ret_t expand_ret =
+      rcutils_char_array_expand_as_needed(char_array, bytes_to_be_written + 1);
+    if (RCUTILS_RET_OK != expand_ret) {
+      va_end(args);
+      if (NULL != char_array->buffer) {
+        // drop the truncated output
+        char_array->buffer[0] = '\0';
+        char_array->buffer_length = 1;
+      }
+      return expand_ret;
+    }
+    // the buffer was too small, format the string again
+    if (0 > _format_string_char_array(char_array, limit, format_string, args)) {
+      va_end(args);
+      char_array->buffer[0] = '\0';
+      char_array->buffer_length = 1;
+      RCUTILS_SET_ERROR_MSG("vsnprintf on resized char array failed");
+      return RCUTILS_RET_ERROR;
+    }
+  }
+  va_end(args);
+  char_array->buffer[bytes_to_be_written] = '\0';
+  char_array->buffer_length = bytes_to_be_written + 1;
+  return RCUTILS_RET_OK;
+}
+
 #ifdef __cplusplus
 }
 #endif
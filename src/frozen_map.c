@@ -0,0 +1,169 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "rcutils/error_handling.h"
+#include "rcutils/types/frozen_map.h"
+
+// The number of seeds tried for a number of slots before doubling it
+#define FROZEN_MAP_SEEDS_PER_SIZE 1024u
+// How many times the number of slots may be doubled beyond twice the number of keys
+#define FROZEN_MAP_MAX_DOUBLINGS 3u
+
+// FNV-1a, seeded, with the high bits folded into the low ones which select the slot
+static inline uint32_t frozen_map_hash(uint32_t seed, const char * str, size_t length)
+{
+  uint32_t hash = 2166136261u ^ seed;
+  for (size_t i = 0; i < length; ++i) {
+    hash ^= (uint8_t)str[i];
+    hash *= 16777619u;
+  }
+  hash ^= hash >> 16;
+  hash *= 0x85ebca6bu;
+  hash ^= hash >> 13;
+  return hash;
+}
+
+// Fills the slots with the keys, returning false if two of them collide
+static bool frozen_map_try_seed(
+  uint32_t * slots, size_t slot_count, const char * const * keys, size_t key_count,
+  uint32_t seed)
+{
+  memset(slots, 0, slot_count * sizeof(uint32_t));
+  for (size_t i = 0; i < key_count; ++i) {
+    size_t slot = frozen_map_hash(seed, keys[i], strlen(keys[i])) & (slot_count - 1u);
+    if (0u != slots[slot]) {
+      return false;
+    }
+    slots[slot] = (uint32_t)(i + 1u);
+  }
+  return true;
+}
+
+rcutils_frozen_map_t
+rcutils_get_zero_initialized_frozen_map(void)
+{
+  static rcutils_frozen_map_t map = {
+    .keys = NULL,
+    .key_count = 0u,
+    .slots = NULL,
+    .slot_count = 0u,
+    .seed = 0u,
+  };
+  map.allocator = rcutils_get_zero_initialized_allocator();
+  return map;
+}
+
+rcutils_ret_t
+rcutils_frozen_map_init(
+  rcutils_frozen_map_t * map,
+  const char * const * keys,
+  size_t key_count,
+  const rcutils_allocator_t * allocator)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(map, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(keys, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ALLOCATOR(allocator, return RCUTILS_RET_INVALID_ARGUMENT);
+  if (0u == key_count || key_count > UINT32_MAX / 4u) {
+    RCUTILS_SET_ERROR_MSG("key_count must be more than 0 and fit the slots");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  // Repeated keys would collide whatever the seed, so they're rejected before searching one
+  for (size_t i = 0; i < key_count; ++i) {
+    RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+      keys[i], "keys must not be NULL", return RCUTILS_RET_INVALID_ARGUMENT);
+    for (size_t j = 0; j < i; ++j) {
+      if (0 == strcmp(keys[i], keys[j])) {
+        RCUTILS_SET_ERROR_MSG("keys must be different");
+        return RCUTILS_RET_INVALID_ARGUMENT;
+      }
+    }
+  }
+
+  size_t slot_count = 1u;
+  while (slot_count < key_count * 2u) {
+    slot_count <<= 1u;
+  }
+  for (uint32_t doubling = 0u; doubling <= FROZEN_MAP_MAX_DOUBLINGS; ++doubling) {
+    uint32_t * slots = allocator->allocate(slot_count * sizeof(uint32_t), allocator->state);
+    RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+      slots, "failed to allocate memory for frozen map", return RCUTILS_RET_BAD_ALLOC);
+    for (uint32_t seed = 0u; seed < FROZEN_MAP_SEEDS_PER_SIZE; ++seed) {
+      if (frozen_map_try_seed(slots, slot_count, keys, key_count, seed)) {
+        map->keys = keys;
+        map->key_count = key_count;
+        map->slots = slots;
+        map->slot_count = slot_count;
+        map->seed = seed;
+        map->allocator = *allocator;
+        return RCUTILS_RET_OK;
+      }
+    }
+    allocator->deallocate(slots, allocator->state);
+    slot_count <<= 1u;
+  }
+  RCUTILS_SET_ERROR_MSG("failed to find a hash giving each key its own slot");
+  return RCUTILS_RET_ERROR;
+}
+
+rcutils_ret_t
+rcutils_frozen_map_fini(rcutils_frozen_map_t * map)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(map, RCUTILS_RET_INVALID_ARGUMENT);
+  if (NULL != map->slots) {
+    RCUTILS_CHECK_ALLOCATOR(&map->allocator, return RCUTILS_RET_INVALID_ARGUMENT);
+    map->allocator.deallocate(map->slots, map->allocator.state);
+  }
+  *map = rcutils_get_zero_initialized_frozen_map();
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_frozen_map_findn(
+  const rcutils_frozen_map_t * map,
+  const char * str,
+  size_t length,
+  size_t * index)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(map, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    map->slots, "frozen map is not initialized", return RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(str, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(index, RCUTILS_RET_INVALID_ARGUMENT);
+
+  size_t slot = frozen_map_hash(map->seed, str, length) & (map->slot_count - 1u);
+  uint32_t entry = map->slots[slot];
+  if (0u == entry) {
+    return RCUTILS_RET_NOT_FOUND;
+  }
+  const char * key = map->keys[entry - 1u];
+  if (strlen(key) != length || 0 != memcmp(key, str, length)) {
+    return RCUTILS_RET_NOT_FOUND;
+  }
+  *index = entry - 1u;
+  return RCUTILS_RET_OK;
+}
+
+#ifdef __cplusplus
+}
+#endif
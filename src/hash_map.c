@@ -17,21 +17,40 @@ extern "C"
 {
 #endif
 
+#include <stdint.h>
 #include <string.h>
 #include <stdio.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# include <emmintrin.h>
+# define HASH_MAP_GROUP_SSE2
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+# include <arm_neon.h>
+# define HASH_MAP_GROUP_NEON
+#endif
+#if defined(_MSC_VER)
+# include <intrin.h>
+#endif
+
 #include "rcutils/allocator.h"
 #include "rcutils/error_handling.h"
 #include "rcutils/logging_macros.h"
 #include "rcutils/types/array_list.h"
 #include "rcutils/types/hash_map.h"
 #include "rcutils/types/rcutils_ret.h"
+#include "rcutils/types/string_view.h"
 #include "rcutils/macros.h"
 #include "rcutils/visibility_control.h"
 
-#define LOAD_FACTOR         (0.75)
+#include "./tracepoints.h"
+
+#define DEFAULT_LOAD_FACTOR   (0.75)
+#define DEFAULT_GROWTH_FACTOR (2.0)
 #define BUCKET_INITIAL_CAP  ((size_t)2)
 
+// The capacity is a power of two, so the bucket of a hash is selected by masking it
+#define BUCKET_INDEX(hashed_key, capacity) ((hashed_key) & ((capacity) - 1))
+
 typedef struct rcutils_hash_map_entry_t
 {
   size_t hashed_key;
@@ -39,10 +58,58 @@ typedef struct rcutils_hash_map_entry_t
   void * value;
 } rcutils_hash_map_entry_t;
 
+// The header of a slot of the open addressing backend, which the key and the value follow.
+typedef struct hash_map_slot_t
+{
+  size_t hashed_key;
+} hash_map_slot_t;
+
+// The key and the value in a slot are aligned for any type, since the key comparison and
+// hashing functions are passed pointers to the keys in the slots.
+typedef union hash_map_slot_alignment_t
+{
+  void * pointer;
+  long double floating_point;
+  int64_t integer;
+  size_t size;
+} hash_map_slot_alignment_t;
+
+#define SLOT_ALIGNMENT  (sizeof(hash_map_slot_alignment_t))
+#define SLOT_ALIGN(size) (((size) + SLOT_ALIGNMENT - 1) / SLOT_ALIGNMENT * SLOT_ALIGNMENT)
+#define SLOT_KEY_OFFSET SLOT_ALIGN(sizeof(hash_map_slot_t))
+
+// Each slot of the open addressing backend has a control byte: the 7 low bits of the hash of
+// its key if the slot is full, or one of these values with the high bit set.
+#define CONTROL_EMPTY   ((uint8_t)0x80)
+#define CONTROL_DELETED ((uint8_t)0xFE)
+#define CONTROL_HASH(hashed_key) ((uint8_t)((hashed_key) & 0x7F))
+#define CONTROL_IS_FULL(control) (0 == ((control) & 0x80))
+// The control bytes are matched a group at a time. The first group is repeated after the
+// control bytes of the slots, so that a group can start at any slot.
+#define GROUP_WIDTH ((size_t)16)
+
 typedef struct rcutils_hash_map_impl_t
 {
-  // This is the array of buckets that will store the keypairs
+  rcutils_hash_map_backend_t backend;
+  // This is the array of buckets that will store the keypairs, with the chaining backend
   rcutils_array_list_t * map;
+  // While the chaining backend rehashes incrementally, the previous array of buckets, of which
+  // the ones before rehash_index were already moved into map
+  rcutils_array_list_t * old_map;
+  size_t old_capacity;
+  size_t rehash_index;
+  size_t rehash_buckets_per_operation;
+  // This is the array of slots storing the entries, with the open addressing backend,
+  // followed in the same allocation by their control bytes
+  uint8_t * slots;
+  uint8_t * control;
+  // The number of slots marked deleted, which still end probing like full slots
+  size_t deleted;
+  size_t slot_size;
+  size_t value_offset;
+  double max_load_factor;
+  double growth_factor;
+  double min_load_factor;
   size_t capacity;
   size_t size;
   size_t key_size;
@@ -74,6 +141,129 @@ int rcutils_hash_map_string_cmp_func(const void * val1, const void * val2)
   return strcmp(*cval1, *cval2);
 }
 
+// The constants of wyhash
+static const uint64_t HASH_SECRET[4] = {
+  0xa0761d6478bd642full, 0xe7037ed1a0b428dbull, 0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull
+};
+
+// Sets a and b to the low and high halves of their 128 bit product
+static inline void hash_multiply(uint64_t * a, uint64_t * b)
+{
+#if defined(__SIZEOF_INT128__)
+  __uint128_t product = (__uint128_t)*a * *b;
+  *a = (uint64_t)product;
+  *b = (uint64_t)(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+  *a = _umul128(*a, *b, b);
+#else
+  uint64_t a_high = *a >> 32, a_low = (uint32_t)*a, b_high = *b >> 32, b_low = (uint32_t)*b;
+  uint64_t high_low = a_high * b_low;
+  uint64_t cross = ((a_low * b_low) >> 32) + (uint32_t)high_low + a_low * b_high;
+  *a = (cross << 32) | (uint32_t)(a_low * b_low);
+  *b = (high_low >> 32) + (cross >> 32) + a_high * b_high;
+#endif
+}
+
+// Folds the 128 bit product of a and b into 64 bits
+static inline uint64_t hash_mix(uint64_t a, uint64_t b)
+{
+  hash_multiply(&a, &b);
+  return a ^ b;
+}
+
+static inline uint64_t hash_read64(const uint8_t * p)
+{
+  uint64_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+static inline uint64_t hash_read32(const uint8_t * p)
+{
+  uint32_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+// wyhash, reading whole words of the input wherever possible
+size_t rcutils_hash_map_bytes_hash(const void * data, size_t size)
+{
+  const uint8_t * p = (const uint8_t *)data;
+  uint64_t seed = hash_mix(HASH_SECRET[0], HASH_SECRET[1]);
+  uint64_t a = 0, b = 0;
+  if (size <= 16) {
+    if (size >= 4) {
+      // Two overlapping pairs of 4 bytes cover inputs of 4 to 16 bytes
+      size_t offset = (size >> 3) << 2;
+      a = (hash_read32(p) << 32) | hash_read32(p + offset);
+      b = (hash_read32(p + size - 4) << 32) | hash_read32(p + size - 4 - offset);
+    } else if (size > 0) {
+      a = ((uint64_t)p[0] << 16) | ((uint64_t)p[size >> 1] << 8) | p[size - 1];
+    }
+  } else {
+    size_t remaining = size;
+    if (remaining > 48) {
+      uint64_t seed1 = seed, seed2 = seed;
+      do {
+        seed = hash_mix(hash_read64(p) ^ HASH_SECRET[1], hash_read64(p + 8) ^ seed);
+        seed1 = hash_mix(hash_read64(p + 16) ^ HASH_SECRET[2], hash_read64(p + 24) ^ seed1);
+        seed2 = hash_mix(hash_read64(p + 32) ^ HASH_SECRET[3], hash_read64(p + 40) ^ seed2);
+        p += 48;
+        remaining -= 48;
+      } while (remaining > 48);
+      seed ^= seed1 ^ seed2;
+    }
+    while (remaining > 16) {
+      seed = hash_mix(hash_read64(p) ^ HASH_SECRET[1], hash_read64(p + 8) ^ seed);
+      p += 16;
+      remaining -= 16;
+    }
+    // The last 16 bytes, overlapping the ones already hashed
+    a = hash_read64(p + remaining - 16);
+    b = hash_read64(p + remaining - 8);
+  }
+  a ^= HASH_SECRET[1];
+  b ^= seed;
+  hash_multiply(&a, &b);
+  return (size_t)hash_mix(a ^ HASH_SECRET[0] ^ (uint64_t)size, b ^ HASH_SECRET[1]);
+}
+
+size_t rcutils_hash_map_fast_string_hash_func(const void * key_str)
+{
+  const char * ckey_str = *(const char **)key_str;
+  return rcutils_hash_map_bytes_hash(ckey_str, strlen(ckey_str));
+}
+
+size_t rcutils_hash_map_uint64_hash_func(const void * key)
+{
+  uint64_t value;
+  memcpy(&value, key, sizeof(value));
+  return (size_t)hash_mix(value ^ HASH_SECRET[0], HASH_SECRET[1]);
+}
+
+int rcutils_hash_map_uint64_cmp_func(const void * val1, const void * val2)
+{
+  uint64_t cval1, cval2;
+  memcpy(&cval1, val1, sizeof(cval1));
+  memcpy(&cval2, val2, sizeof(cval2));
+  return cval1 < cval2 ? -1 : cval1 > cval2;
+}
+
+size_t rcutils_hash_map_uint32_hash_func(const void * key)
+{
+  uint32_t value;
+  memcpy(&value, key, sizeof(value));
+  return (size_t)hash_mix(value ^ HASH_SECRET[0], HASH_SECRET[1]);
+}
+
+int rcutils_hash_map_uint32_cmp_func(const void * val1, const void * val2)
+{
+  uint32_t cval1, cval2;
+  memcpy(&cval1, val1, sizeof(cval1));
+  memcpy(&cval2, val2, sizeof(cval2));
+  return cval1 < cval2 ? -1 : cval1 > cval2;
+}
+
 rcutils_hash_map_t
 rcutils_get_zero_initialized_hash_map()
 {
@@ -86,7 +276,7 @@ static rcutils_ret_t hash_map_allocate_new_map(
   rcutils_array_list_t ** map, size_t capacity,
   const rcutils_allocator_t * allocator)
 {
-  *map = allocator->allocate(capacity * sizeof(rcutils_hash_map_impl_t), allocator->state);
+  *map = allocator->allocate(capacity * sizeof(rcutils_array_list_t), allocator->state);
   if (NULL == *map) {
     return RCUTILS_RET_BAD_ALLOC;
   }
@@ -173,63 +363,227 @@ static rcutils_ret_t hash_map_insert_entry(
   return ret;
 }
 
-// Checks if map is already past its load factor and grows it if so
-static rcutils_ret_t hash_map_check_and_grow_map(rcutils_hash_map_t * hash_map)
+// Returns the capacity of at least minimum_capacity the map can have, or 0 if it's too large.
+// Buckets and slots are indexed by masking the hash, so there's a power of two of them, and
+// at least a group of slots.
+static size_t hash_map_round_capacity(const rcutils_hash_map_impl_t * impl, size_t minimum_capacity)
+{
+  size_t capacity = RCUTILS_HASH_MAP_BACKEND_OPEN_ADDRESSING == impl->backend ? GROUP_WIDTH : 1;
+  while (capacity < minimum_capacity) {
+    if (capacity > SIZE_MAX / 2) {
+      return 0;
+    }
+    capacity *= 2;
+  }
+  return capacity;
+}
+
+// Returns the capacity of the map once grown by its growth factor, or 0 if it can't grow
+static size_t hash_map_grown_capacity(const rcutils_hash_map_impl_t * impl)
+{
+  double grown_capacity = (double)impl->capacity * impl->growth_factor;
+  if (grown_capacity >= (double)(SIZE_MAX / 2)) {
+    return 0;
+  }
+  size_t new_capacity = (size_t)grown_capacity;
+  return hash_map_round_capacity(
+    impl, new_capacity > impl->capacity ? new_capacity : impl->capacity + 1);
+}
+
+// Returns the capacity the map needs for size entries not to exceed its load factor,
+// or 0 if it's too large
+static size_t hash_map_capacity_for_size(const rcutils_hash_map_impl_t * impl, size_t size)
+{
+  double capacity = ((double)size + 1.0) / impl->max_load_factor + 1.0;
+  if (capacity >= (double)(SIZE_MAX / 2)) {
+    return 0;
+  }
+  return hash_map_round_capacity(impl, (size_t)capacity);
+}
+
+// Moves the entries into a new array of buckets with the given capacity
+static rcutils_ret_t hash_map_resize_map(rcutils_hash_map_t * hash_map, size_t new_capacity)
 {
   rcutils_ret_t ret = RCUTILS_RET_OK;
-  if (hash_map->impl->size >= (size_t)(LOAD_FACTOR * (double)hash_map->impl->capacity)) {
-    size_t new_capacity = 2 * hash_map->impl->capacity;
-    rcutils_array_list_t * new_map = NULL;
+  rcutils_array_list_t * new_map = NULL;
 
-    ret = hash_map_allocate_new_map(&new_map, new_capacity, &hash_map->impl->allocator);
-    if (RCUTILS_RET_OK != ret) {
-      return ret;
-    }
+  ret = hash_map_allocate_new_map(&new_map, new_capacity, &hash_map->impl->allocator);
+  if (RCUTILS_RET_OK != ret) {
+    return ret;
+  }
 
-    for (size_t map_index = 0;
-      map_index < hash_map->impl->capacity && RCUTILS_RET_OK == ret;
-      ++map_index)
-    {
-      rcutils_array_list_t * bucket = &(hash_map->impl->map[map_index]);
-      // Is this a valid bucket with entries
-      if (NULL != bucket->impl) {
-        size_t bucket_size = 0;
-        ret = rcutils_array_list_get_size(bucket, &bucket_size);
-        if (RCUTILS_RET_OK != ret) {
-          return ret;
-        }
+  for (size_t map_index = 0;
+    map_index < hash_map->impl->capacity && RCUTILS_RET_OK == ret;
+    ++map_index)
+  {
+    rcutils_array_list_t * bucket = &(hash_map->impl->map[map_index]);
+    // Is this a valid bucket with entries
+    if (NULL != bucket->impl) {
+      size_t bucket_size = 0;
+      ret = rcutils_array_list_get_size(bucket, &bucket_size);
+      if (RCUTILS_RET_OK != ret) {
+        return ret;
+      }
 
-        for (size_t bucket_index = 0;
-          bucket_index < bucket_size && RCUTILS_RET_OK == ret;
-          ++bucket_index)
-        {
-          rcutils_hash_map_entry_t * entry = NULL;
-          ret = rcutils_array_list_get(bucket, bucket_index, &entry);
-          if (RCUTILS_RET_OK == ret) {
-            size_t new_index = entry->hashed_key % new_capacity;
-            ret = hash_map_insert_entry(new_map, new_index, entry, &hash_map->impl->allocator);
-          }
+      for (size_t bucket_index = 0;
+        bucket_index < bucket_size && RCUTILS_RET_OK == ret;
+        ++bucket_index)
+      {
+        rcutils_hash_map_entry_t * entry = NULL;
+        ret = rcutils_array_list_get(bucket, bucket_index, &entry);
+        if (RCUTILS_RET_OK == ret) {
+          size_t new_index = BUCKET_INDEX(entry->hashed_key, new_capacity);
+          ret = hash_map_insert_entry(new_map, new_index, entry, &hash_map->impl->allocator);
         }
       }
     }
+  }
 
-    // Something went wrong above after we allocated the new map. Try to clean it up
-    if (RCUTILS_RET_OK != ret) {
-      hash_map_deallocate_map(new_map, new_capacity, &hash_map->impl->allocator, false);
-      return ret;
+  // Something went wrong above after we allocated the new map. Try to clean it up
+  if (RCUTILS_RET_OK != ret) {
+    hash_map_deallocate_map(new_map, new_capacity, &hash_map->impl->allocator, false);
+    return ret;
+  }
+
+  // Cleanup the old map and swap in the new one
+  ret = hash_map_deallocate_map(
+    hash_map->impl->map, hash_map->impl->capacity, &hash_map->impl->allocator, false);
+  // everything worked up to this point, so if we fail to dealloc the old map still set the new
+  hash_map->impl->map = new_map;
+  hash_map->impl->capacity = new_capacity;
+
+  return ret;
+}
+
+// Moves the entries of up to bucket_count old buckets into the new ones, while rehashing
+// incrementally, and deallocates the old buckets once they are all moved
+static rcutils_ret_t hash_map_rehash_buckets(rcutils_hash_map_impl_t * impl, size_t bucket_count)
+{
+  rcutils_ret_t ret = RCUTILS_RET_OK;
+  for (; bucket_count > 0 && impl->rehash_index < impl->old_capacity; --bucket_count) {
+    rcutils_array_list_t * bucket = &(impl->old_map[impl->rehash_index]);
+    if (NULL != bucket->impl) {
+      size_t bucket_size = 0;
+      ret = rcutils_array_list_get_size(bucket, &bucket_size);
+      // Move the entries from the back, so that the buckets are consistent if inserting fails
+      while (RCUTILS_RET_OK == ret && bucket_size > 0) {
+        rcutils_hash_map_entry_t * entry = NULL;
+        ret = rcutils_array_list_get(bucket, bucket_size - 1, &entry);
+        if (RCUTILS_RET_OK == ret) {
+          ret = hash_map_insert_entry(
+            impl->map, BUCKET_INDEX(entry->hashed_key, impl->capacity), entry, &impl->allocator);
+        }
+        if (RCUTILS_RET_OK == ret) {
+          ret = rcutils_array_list_remove(bucket, --bucket_size);
+        }
+      }
+      if (RCUTILS_RET_OK == ret) {
+        ret = rcutils_array_list_fini(bucket);
+      }
+      if (RCUTILS_RET_OK != ret) {
+        return ret;
+      }
     }
+    impl->rehash_index++;
+  }
 
-    // Cleanup the old map and swap in the new one
-    ret = hash_map_deallocate_map(
-      hash_map->impl->map, hash_map->impl->capacity, &hash_map->impl->allocator, false);
-    // everything worked up to this point, so if we fail to dealloc the old map still set the new
-    hash_map->impl->map = new_map;
-    hash_map->impl->capacity = new_capacity;
+  if (NULL != impl->old_map && impl->rehash_index == impl->old_capacity) {
+    ret = hash_map_deallocate_map(impl->old_map, impl->old_capacity, &impl->allocator, false);
+    impl->old_map = NULL;
+    impl->old_capacity = 0;
+    impl->rehash_index = 0;
   }
+  return ret;
+}
 
+// Returns the bucket with the given index, the old buckets which are still being moved while
+// rehashing incrementally coming before the new ones
+static rcutils_array_list_t * hash_map_bucket(
+  const rcutils_hash_map_impl_t * impl, size_t map_index)
+{
+  if (map_index < impl->old_capacity) {
+    return &(impl->old_map[map_index]);
+  }
+  return &(impl->map[map_index - impl->old_capacity]);
+}
+
+// Moves the entries into new buckets with the given capacity incrementally, the first ones
+// right away
+static rcutils_ret_t hash_map_start_rehash(rcutils_hash_map_impl_t * impl, size_t new_capacity)
+{
+  // The map grew past its load factor again before the previous rehash was done
+  rcutils_ret_t ret = hash_map_rehash_buckets(impl, impl->old_capacity);
+  if (RCUTILS_RET_OK != ret) {
+    return ret;
+  }
+  rcutils_array_list_t * new_map = NULL;
+  ret = hash_map_allocate_new_map(&new_map, new_capacity, &impl->allocator);
+  if (RCUTILS_RET_OK != ret) {
+    return ret;
+  }
+  impl->old_map = impl->map;
+  impl->old_capacity = impl->capacity;
+  impl->rehash_index = 0;
+  impl->map = new_map;
+  impl->capacity = new_capacity;
+  return hash_map_rehash_buckets(impl, impl->rehash_buckets_per_operation);
+}
+
+// Checks if map is already past its load factor and grows it if so, or moves more entries if
+// it's rehashing incrementally
+static rcutils_ret_t hash_map_check_and_grow_map(rcutils_hash_map_t * hash_map)
+{
+  rcutils_hash_map_impl_t * impl = hash_map->impl;
+  rcutils_ret_t ret = RCUTILS_RET_OK;
+  if (NULL != impl->old_map) {
+    ret = hash_map_rehash_buckets(impl, impl->rehash_buckets_per_operation);
+  }
+  if (RCUTILS_RET_OK != ret ||
+    impl->size < (size_t)(impl->max_load_factor * (double)impl->capacity))
+  {
+    return ret;
+  }
+
+  size_t new_capacity = hash_map_grown_capacity(impl);
+  if (0 == new_capacity) {
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  RCUTILS_TRACEPOINT(hash_map_resize_start, impl, impl->capacity, new_capacity);
+  ret = 0 == impl->rehash_buckets_per_operation ?
+    hash_map_resize_map(hash_map, new_capacity) : hash_map_start_rehash(impl, new_capacity);
+  RCUTILS_TRACEPOINT(hash_map_resize_end, impl, ret);
   return ret;
 }
 
+// Allocates the slots of the open addressing backend and their control bytes, all empty
+static rcutils_ret_t hash_map_allocate_slots(
+  const rcutils_hash_map_impl_t * impl, uint8_t ** slots, uint8_t ** control, size_t capacity)
+{
+  if (capacity > (SIZE_MAX - GROUP_WIDTH) / (impl->slot_size + 1)) {
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  *slots = impl->allocator.allocate(
+    capacity * (impl->slot_size + 1) + GROUP_WIDTH, impl->allocator.state);
+  if (NULL == *slots) {
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  *control = *slots + capacity * impl->slot_size;
+  memset(*control, CONTROL_EMPTY, capacity + GROUP_WIDTH);
+  return RCUTILS_RET_OK;
+}
+
+rcutils_hash_map_options_t
+rcutils_hash_map_get_default_options(void)
+{
+  rcutils_hash_map_options_t options;
+  options.backend = RCUTILS_HASH_MAP_BACKEND_CHAINING;
+  options.max_load_factor = DEFAULT_LOAD_FACTOR;
+  options.growth_factor = DEFAULT_GROWTH_FACTOR;
+  options.rehash_buckets_per_operation = 0;
+  options.min_load_factor = 0.0;
+  return options;
+}
+
 rcutils_ret_t
 rcutils_hash_map_init(
   rcutils_hash_map_t * hash_map,
@@ -239,11 +593,30 @@ rcutils_hash_map_init(
   rcutils_hash_map_key_hasher_t key_hashing_func,
   rcutils_hash_map_key_cmp_t key_cmp_func,
   const rcutils_allocator_t * allocator)
+{
+  rcutils_hash_map_options_t options = rcutils_hash_map_get_default_options();
+  return rcutils_hash_map_init_with_options(
+    hash_map, initial_capacity, key_size, data_size, key_hashing_func, key_cmp_func,
+    &options, allocator);
+}
+
+rcutils_ret_t
+rcutils_hash_map_init_with_options(
+  rcutils_hash_map_t * hash_map,
+  size_t initial_capacity,
+  size_t key_size,
+  size_t data_size,
+  rcutils_hash_map_key_hasher_t key_hashing_func,
+  rcutils_hash_map_key_cmp_t key_cmp_func,
+  const rcutils_hash_map_options_t * options,
+  const rcutils_allocator_t * allocator)
 {
   RCUTILS_CHECK_ARGUMENT_FOR_NULL(hash_map, RCUTILS_RET_INVALID_ARGUMENT);
   RCUTILS_CHECK_ARGUMENT_FOR_NULL(key_hashing_func, RCUTILS_RET_INVALID_ARGUMENT);
   RCUTILS_CHECK_ARGUMENT_FOR_NULL(key_cmp_func, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(options, RCUTILS_RET_INVALID_ARGUMENT);
   RCUTILS_CHECK_ALLOCATOR(allocator, return RCUTILS_RET_INVALID_ARGUMENT);
+  rcutils_hash_map_backend_t backend = options->backend;
   if (1 > initial_capacity) {
     RCUTILS_SET_ERROR_MSG("initial_capacity cannot be less than 1");
     return RCUTILS_RET_INVALID_ARGUMENT;
@@ -253,6 +626,29 @@ rcutils_hash_map_init(
   } else if (1 > data_size) {
     RCUTILS_SET_ERROR_MSG("data_size cannot be less than 1");
     return RCUTILS_RET_INVALID_ARGUMENT;
+  } else if (RCUTILS_HASH_MAP_BACKEND_CHAINING != backend &&
+    RCUTILS_HASH_MAP_BACKEND_OPEN_ADDRESSING != backend)
+  {
+    RCUTILS_SET_ERROR_MSG("unknown hash map backend");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  } else if (!(options->max_load_factor > 0.0) ||
+    (RCUTILS_HASH_MAP_BACKEND_OPEN_ADDRESSING == backend && !(options->max_load_factor < 1.0)))
+  {
+    RCUTILS_SET_ERROR_MSG("max_load_factor is out of range");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  } else if (!(options->growth_factor > 1.0)) {
+    RCUTILS_SET_ERROR_MSG("growth_factor must be more than 1");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  } else if (!(options->min_load_factor >= 0.0) ||
+    !(options->min_load_factor < options->max_load_factor / 2))
+  {
+    RCUTILS_SET_ERROR_MSG("min_load_factor is out of range");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  } else if (RCUTILS_HASH_MAP_BACKEND_OPEN_ADDRESSING == backend &&
+    0 != options->rehash_buckets_per_operation)
+  {
+    RCUTILS_SET_ERROR_MSG("the open addressing backend can't rehash incrementally");
+    return RCUTILS_RET_INVALID_ARGUMENT;
   }
 
   hash_map->impl = allocator->allocate(sizeof(rcutils_hash_map_impl_t), allocator->state);
@@ -261,14 +657,45 @@ rcutils_hash_map_init(
     return RCUTILS_RET_BAD_ALLOC;
   }
 
+  hash_map->impl->backend = backend;
+  hash_map->impl->map = NULL;
+  hash_map->impl->old_map = NULL;
+  hash_map->impl->old_capacity = 0;
+  hash_map->impl->rehash_index = 0;
+  hash_map->impl->rehash_buckets_per_operation = options->rehash_buckets_per_operation;
+  hash_map->impl->slots = NULL;
+  hash_map->impl->control = NULL;
+  hash_map->impl->deleted = 0;
+  hash_map->impl->slot_size = 0;
+  hash_map->impl->value_offset = 0;
+  hash_map->impl->max_load_factor = options->max_load_factor;
+  hash_map->impl->growth_factor = options->growth_factor;
+  hash_map->impl->min_load_factor = options->min_load_factor;
   hash_map->impl->capacity = initial_capacity;
   hash_map->impl->size = 0;
   hash_map->impl->key_size = key_size;
   hash_map->impl->data_size = data_size;
   hash_map->impl->key_hashing_func = key_hashing_func;
   hash_map->impl->key_cmp_func = key_cmp_func;
+  hash_map->impl->allocator = *allocator;
 
-  rcutils_ret_t ret = hash_map_allocate_new_map(&hash_map->impl->map, initial_capacity, allocator);
+  rcutils_ret_t ret = RCUTILS_RET_OK;
+  size_t capacity = hash_map_round_capacity(hash_map->impl, initial_capacity);
+  hash_map->impl->capacity = capacity;
+  if (0 == capacity) {
+    ret = RCUTILS_RET_BAD_ALLOC;
+  } else if (RCUTILS_HASH_MAP_BACKEND_OPEN_ADDRESSING == backend) {
+    if (key_size > SIZE_MAX / 4 || data_size > SIZE_MAX / 4) {
+      ret = RCUTILS_RET_BAD_ALLOC;
+    } else {
+      hash_map->impl->value_offset = SLOT_KEY_OFFSET + SLOT_ALIGN(key_size);
+      hash_map->impl->slot_size = hash_map->impl->value_offset + SLOT_ALIGN(data_size);
+      ret = hash_map_allocate_slots(
+        hash_map->impl, &hash_map->impl->slots, &hash_map->impl->control, capacity);
+    }
+  } else {
+    ret = hash_map_allocate_new_map(&hash_map->impl->map, capacity, allocator);
+  }
   if (RCUTILS_RET_OK != ret) {
     // Cleanup allocated memory before we return failure
     allocator->deallocate(hash_map->impl, allocator->state);
@@ -277,8 +704,6 @@ rcutils_hash_map_init(
     return ret;
   }
 
-  hash_map->impl->allocator = *allocator;
-
   return RCUTILS_RET_OK;
 }
 
@@ -286,8 +711,23 @@ rcutils_ret_t
 rcutils_hash_map_fini(rcutils_hash_map_t * hash_map)
 {
   HASH_MAP_VALIDATE_HASH_MAP(hash_map);
-  rcutils_ret_t ret = hash_map_deallocate_map(
-    hash_map->impl->map, hash_map->impl->capacity, &hash_map->impl->allocator, true);
+  rcutils_ret_t ret = RCUTILS_RET_OK;
+  if (RCUTILS_HASH_MAP_BACKEND_OPEN_ADDRESSING == hash_map->impl->backend) {
+    hash_map->impl->allocator.deallocate(hash_map->impl->slots, hash_map->impl->allocator.state);
+  } else {
+    if (NULL != hash_map->impl->old_map) {
+      ret = hash_map_deallocate_map(
+        hash_map->impl->old_map, hash_map->impl->old_capacity, &hash_map->impl->allocator, true);
+      if (RCUTILS_RET_OK == ret) {
+        hash_map->impl->old_map = NULL;
+        hash_map->impl->old_capacity = 0;
+      }
+    }
+    if (RCUTILS_RET_OK == ret) {
+      ret = hash_map_deallocate_map(
+        hash_map->impl->map, hash_map->impl->capacity, &hash_map->impl->allocator, true);
+    }
+  }
 
   if (RCUTILS_RET_OK == ret) {
     hash_map->impl->allocator.deallocate(hash_map->impl, hash_map->impl->allocator.state);
@@ -315,37 +755,34 @@ rcutils_hash_map_get_size(const rcutils_hash_map_t * hash_map, size_t * size)
   return RCUTILS_RET_OK;
 }
 
-/// Returns true if found or false if it doesn't exist.
-/// key_hash and map_index will always be set correctly
-static bool hash_map_find(
-  const rcutils_hash_map_t * hash_map,   // [in] The hash_map to look up in
-  const void * key,   // [in] The key to lookup
-  size_t * key_hash,   // [out] The key's hashed value
-  size_t * map_index,   // [out] The index into the array of buckets
-  size_t * bucket_index,   // [out] The index of the entry in its bucket
-  rcutils_hash_map_entry_t ** entry)   // [out] Will be set to a pointer to the entry's data
+// Returns true if the bucket holds the entry of the key, setting bucket_index and entry
+static bool hash_map_find_in_bucket(
+  const rcutils_array_list_t * bucket,
+  const void * key,
+  size_t key_hash,
+  rcutils_hash_map_key_cmp_t key_cmp_func,
+  size_t * bucket_index,
+  rcutils_hash_map_entry_t ** entry)
 {
   size_t bucket_size = 0;
-  rcutils_hash_map_entry_t * bucket_entry = NULL;
+  void * bucket_entries = NULL;
 
-  *key_hash = hash_map->impl->key_hashing_func(key);
-  *map_index = (*key_hash) % hash_map->impl->capacity;
-
-  // Find the bucket the entry should be in check that it's valid
-  rcutils_array_list_t * bucket = &(hash_map->impl->map[*map_index]);
+  // Check that the bucket is valid
   if (NULL == bucket->impl) {
     return false;
   }
-  if (RCUTILS_RET_OK != rcutils_array_list_get_size(bucket, &bucket_size)) {
+  if (RCUTILS_RET_OK != rcutils_array_list_get_size(bucket, &bucket_size) || 0 == bucket_size) {
+    return false;
+  }
+  // The entries of a bucket are contiguous, so they are read in place
+  if (RCUTILS_RET_OK != rcutils_array_list_get_ptr(bucket, 0, &bucket_entries)) {
     return false;
   }
   for (size_t i = 0; i < bucket_size; ++i) {
-    if (RCUTILS_RET_OK != rcutils_array_list_get(bucket, i, &bucket_entry)) {
-      return false;
-    }
+    rcutils_hash_map_entry_t * bucket_entry = ((rcutils_hash_map_entry_t **)bucket_entries)[i];
     // Check that the hashes match first as that will be the quicker comparison to quick fail on
-    if (bucket_entry->hashed_key == *key_hash &&
-      (0 == hash_map->impl->key_cmp_func(bucket_entry->key, key)))
+    if (bucket_entry->hashed_key == key_hash &&
+      (0 == key_cmp_func(bucket_entry->key, key)))
     {
       *bucket_index = i;
       *entry = bucket_entry;
@@ -356,6 +793,409 @@ static bool hash_map_find(
   return false;
 }
 
+/// Returns true if found or false if it doesn't exist, comparing the keys with key_cmp_func.
+/// map_index will always be set correctly
+static bool hash_map_find_hashed(
+  const rcutils_hash_map_t * hash_map,   // [in] The hash_map to look up in
+  const void * key,   // [in] The key to lookup
+  size_t key_hash,   // [in] The key's hashed value
+  rcutils_hash_map_key_cmp_t key_cmp_func,   // [in] The function comparing the keys to key
+  size_t * map_index,   // [out] The index of the bucket, see hash_map_bucket()
+  size_t * bucket_index,   // [out] The index of the entry in its bucket
+  rcutils_hash_map_entry_t ** entry)   // [out] Will be set to a pointer to the entry's data
+{
+  const rcutils_hash_map_impl_t * impl = hash_map->impl;
+
+  // While rehashing incrementally, the entry is in the old buckets until its bucket was moved
+  if (NULL != impl->old_map &&
+    BUCKET_INDEX(key_hash, impl->old_capacity) >= impl->rehash_index)
+  {
+    *map_index = BUCKET_INDEX(key_hash, impl->old_capacity);
+    if (hash_map_find_in_bucket(
+        hash_map_bucket(impl, *map_index), key, key_hash, key_cmp_func, bucket_index, entry))
+    {
+      return true;
+    }
+    // Some of its entries may have been moved already if moving the bucket failed
+  }
+
+  *map_index = BUCKET_INDEX(key_hash, impl->capacity) + impl->old_capacity;
+  return hash_map_find_in_bucket(
+    hash_map_bucket(impl, *map_index), key, key_hash, key_cmp_func, bucket_index, entry);
+}
+
+/// Returns true if found or false if it doesn't exist.
+/// key_hash and map_index will always be set correctly
+static bool hash_map_find(
+  const rcutils_hash_map_t * hash_map,   // [in] The hash_map to look up in
+  const void * key,   // [in] The key to lookup
+  size_t * key_hash,   // [out] The key's hashed value
+  size_t * map_index,   // [out] The index of the bucket, see hash_map_bucket()
+  size_t * bucket_index,   // [out] The index of the entry in its bucket
+  rcutils_hash_map_entry_t ** entry)   // [out] Will be set to a pointer to the entry's data
+{
+  *key_hash = hash_map->impl->key_hashing_func(key);
+  return hash_map_find_hashed(
+    hash_map, key, *key_hash, hash_map->impl->key_cmp_func, map_index, bucket_index, entry);
+}
+
+// Returns a mask with the bit i set if control byte i of the group matches the value
+static inline uint32_t hash_map_group_match(const uint8_t * group, uint8_t value)
+{
+#if defined(HASH_MAP_GROUP_SSE2)
+  __m128i control = _mm_loadu_si128((const __m128i *)group);
+  return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(control, _mm_set1_epi8((char)value)));
+#elif defined(HASH_MAP_GROUP_NEON)
+  static const uint8_t bits[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+  uint8x16_t matches = vandq_u8(vceqq_u8(vld1q_u8(group), vdupq_n_u8(value)), vld1q_u8(bits));
+  return (uint32_t)vaddv_u8(vget_low_u8(matches)) |
+         ((uint32_t)vaddv_u8(vget_high_u8(matches)) << 8);
+#else
+  uint32_t mask = 0;
+  for (size_t i = 0; i < GROUP_WIDTH; ++i) {
+    if (group[i] == value) {
+      mask |= (uint32_t)1 << i;
+    }
+  }
+  return mask;
+#endif
+}
+
+// Returns a mask with the bit i set if slot i of the group is empty or deleted
+static inline uint32_t hash_map_group_match_free(const uint8_t * group)
+{
+#if defined(HASH_MAP_GROUP_SSE2)
+  return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)group));
+#elif defined(HASH_MAP_GROUP_NEON)
+  static const uint8_t bits[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+  uint8x16_t matches = vandq_u8(vtstq_u8(vld1q_u8(group), vdupq_n_u8(0x80)), vld1q_u8(bits));
+  return (uint32_t)vaddv_u8(vget_low_u8(matches)) |
+         ((uint32_t)vaddv_u8(vget_high_u8(matches)) << 8);
+#else
+  uint32_t mask = 0;
+  for (size_t i = 0; i < GROUP_WIDTH; ++i) {
+    if (!CONTROL_IS_FULL(group[i])) {
+      mask |= (uint32_t)1 << i;
+    }
+  }
+  return mask;
+#endif
+}
+
+// Returns the index of the lowest bit set in a mask which isn't 0
+static inline size_t hash_map_lowest_bit(uint32_t mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return (size_t)__builtin_ctz(mask);
+#elif defined(_MSC_VER)
+  unsigned long index = 0;
+  _BitScanForward(&index, mask);
+  return (size_t)index;
+#else
+  size_t index = 0;
+  while (0 == (mask & 1)) {
+    mask >>= 1;
+    ++index;
+  }
+  return index;
+#endif
+}
+
+// Returns the slot at index of the open addressing backend
+static hash_map_slot_t * hash_map_slot(
+  const rcutils_hash_map_impl_t * impl, uint8_t * slots, size_t index)
+{
+  return (hash_map_slot_t *)(slots + index * impl->slot_size);
+}
+
+static void * hash_map_slot_key(hash_map_slot_t * slot)
+{
+  return (uint8_t *)slot + SLOT_KEY_OFFSET;
+}
+
+static void * hash_map_slot_value(const rcutils_hash_map_impl_t * impl, hash_map_slot_t * slot)
+{
+  return (uint8_t *)slot + impl->value_offset;
+}
+
+// Sets the control byte of the slot at index, and its copy after the slots for the first group
+static void hash_map_set_control(
+  uint8_t * control, size_t capacity, size_t index, uint8_t value)
+{
+  control[index] = value;
+  if (index < GROUP_WIDTH) {
+    control[capacity + index] = value;
+  }
+}
+
+// The probe sequence of a hash starts at the group of the bits above its control byte, and
+// then jumps over 1, 2, 3, ... groups, which visits every group for a power of two of slots.
+#define PROBE_START(hashed_key, mask) (((hashed_key) >> 7) & (mask))
+
+/// Returns the slot of the key or NULL if it doesn't exist, with the open addressing backend,
+/// comparing the keys with key_cmp_func.
+/// slot_index will be set to the index of the slot if found
+static hash_map_slot_t * hash_map_find_slot_with(
+  const rcutils_hash_map_impl_t * impl,   // [in] The hash_map to look up in
+  const void * key,   // [in] The key to lookup
+  size_t key_hash,   // [in] The key's hashed value
+  rcutils_hash_map_key_cmp_t key_cmp_func,   // [in] The function comparing the keys to key
+  size_t * slot_index)   // [out] The index of the slot
+{
+  size_t mask = impl->capacity - 1;
+  size_t position = PROBE_START(key_hash, mask);
+  uint8_t control_hash = CONTROL_HASH(key_hash);
+  for (size_t probes = 0; probes * GROUP_WIDTH < impl->capacity; ++probes) {
+    const uint8_t * group = impl->control + position;
+    for (uint32_t matches = hash_map_group_match(group, control_hash);
+      0 != matches; matches &= matches - 1)
+    {
+      size_t index = (position + hash_map_lowest_bit(matches)) & mask;
+      hash_map_slot_t * slot = hash_map_slot(impl, impl->slots, index);
+      if (slot->hashed_key == key_hash &&
+        (0 == key_cmp_func(hash_map_slot_key(slot), key)))
+      {
+        *slot_index = index;
+        return slot;
+      }
+    }
+    // The key would have been inserted before an empty slot of its probe sequence
+    if (0 != hash_map_group_match(group, CONTROL_EMPTY)) {
+      return NULL;
+    }
+    position = (position + (probes + 1) * GROUP_WIDTH) & mask;
+  }
+  return NULL;
+}
+
+/// Returns the slot of the key or NULL if it doesn't exist, with the open addressing backend.
+/// slot_index will be set to the index of the slot if found
+static hash_map_slot_t * hash_map_find_slot(
+  const rcutils_hash_map_impl_t * impl,   // [in] The hash_map to look up in
+  const void * key,   // [in] The key to lookup
+  size_t key_hash,   // [in] The key's hashed value
+  size_t * slot_index)   // [out] The index of the slot
+{
+  return hash_map_find_slot_with(impl, key, key_hash, impl->key_cmp_func, slot_index);
+}
+
+// Returns the index of the first empty or deleted slot of the probe sequence of the hash,
+// there must be one
+static size_t hash_map_find_free_slot(
+  const uint8_t * control, size_t capacity, size_t key_hash)
+{
+  size_t mask = capacity - 1;
+  size_t position = PROBE_START(key_hash, mask);
+  for (size_t probes = 0; ; ++probes) {
+    uint32_t free_slots = hash_map_group_match_free(control + position);
+    if (0 != free_slots) {
+      return (position + hash_map_lowest_bit(free_slots)) & mask;
+    }
+    position = (position + (probes + 1) * GROUP_WIDTH) & mask;
+  }
+}
+
+// Moves the entries into new slots with the given capacity, dropping the deleted slots
+static rcutils_ret_t hash_map_resize_slots(rcutils_hash_map_impl_t * impl, size_t new_capacity)
+{
+  uint8_t * new_slots = NULL;
+  uint8_t * new_control = NULL;
+  rcutils_ret_t ret = hash_map_allocate_slots(impl, &new_slots, &new_control, new_capacity);
+  if (RCUTILS_RET_OK != ret) {
+    return ret;
+  }
+
+  for (size_t index = 0; index < impl->capacity; ++index) {
+    if (CONTROL_IS_FULL(impl->control[index])) {
+      hash_map_slot_t * slot = hash_map_slot(impl, impl->slots, index);
+      size_t new_index = hash_map_find_free_slot(new_control, new_capacity, slot->hashed_key);
+      memcpy(hash_map_slot(impl, new_slots, new_index), slot, impl->slot_size);
+      hash_map_set_control(
+        new_control, new_capacity, new_index, CONTROL_HASH(slot->hashed_key));
+    }
+  }
+
+  impl->allocator.deallocate(impl->slots, impl->allocator.state);
+  impl->slots = new_slots;
+  impl->control = new_control;
+  impl->capacity = new_capacity;
+  impl->deleted = 0;
+  return RCUTILS_RET_OK;
+}
+
+// Checks if the map is below its minimum load factor and shrinks it if so
+static rcutils_ret_t hash_map_check_and_shrink_map(rcutils_hash_map_t * hash_map)
+{
+  rcutils_hash_map_impl_t * impl = hash_map->impl;
+  // The map isn't shrunk while it's still rehashing incrementally
+  if (NULL != impl->old_map ||
+    impl->size >= (size_t)(impl->min_load_factor * (double)impl->capacity))
+  {
+    return RCUTILS_RET_OK;
+  }
+
+  size_t new_capacity = hash_map_capacity_for_size(impl, impl->size);
+  if (0 == new_capacity || new_capacity >= impl->capacity) {
+    return RCUTILS_RET_OK;
+  }
+  rcutils_ret_t ret = RCUTILS_RET_OK;
+  RCUTILS_TRACEPOINT(hash_map_resize_start, impl, impl->capacity, new_capacity);
+  if (RCUTILS_HASH_MAP_BACKEND_OPEN_ADDRESSING == impl->backend) {
+    ret = hash_map_resize_slots(impl, new_capacity);
+  } else {
+    ret = 0 == impl->rehash_buckets_per_operation ?
+      hash_map_resize_map(hash_map, new_capacity) : hash_map_start_rehash(impl, new_capacity);
+  }
+  RCUTILS_TRACEPOINT(hash_map_resize_end, impl, ret);
+  return ret;
+}
+
+static rcutils_ret_t hash_map_set_slot(
+  rcutils_hash_map_impl_t * impl, const void * key, const void * value)
+{
+  size_t key_hash = impl->key_hashing_func(key);
+  size_t slot_index = 0;
+  hash_map_slot_t * slot = hash_map_find_slot(impl, key, key_hash, &slot_index);
+  if (NULL != slot) {
+    // Just update the existing value to match the new value
+    memcpy(hash_map_slot_value(impl, slot), value, impl->data_size);
+    return RCUTILS_RET_OK;
+  }
+
+  // Resize before inserting, probing needs empty slots. If it's mostly deleted slots which
+  // fill the map, they are dropped without growing it.
+  if ((impl->size + impl->deleted + 1) > (size_t)(impl->max_load_factor * (double)impl->capacity)) {
+    rcutils_ret_t ret = RCUTILS_RET_BAD_ALLOC;
+    size_t new_capacity = impl->capacity;
+    if ((impl->size + 1) > (size_t)(impl->max_load_factor / 2 * (double)impl->capacity)) {
+      new_capacity = hash_map_grown_capacity(impl);
+    }
+    if (0 != new_capacity) {
+      RCUTILS_TRACEPOINT(hash_map_resize_start, impl, impl->capacity, new_capacity);
+      ret = hash_map_resize_slots(impl, new_capacity);
+      RCUTILS_TRACEPOINT(hash_map_resize_end, impl, ret);
+    }
+    if (RCUTILS_RET_OK != ret) {
+      if (impl->size + impl->deleted + 1 >= impl->capacity) {
+        RCUTILS_SET_ERROR_MSG("failed to grow the full hash_map");
+        return ret;
+      }
+      // The map can continue to operate with degraded performance
+      RCUTILS_LOG_ERROR("Failed to grow hash_map. Reason: %d", ret);
+    }
+  }
+
+  slot_index = hash_map_find_free_slot(impl->control, impl->capacity, key_hash);
+  if (CONTROL_DELETED == impl->control[slot_index]) {
+    impl->deleted--;
+  }
+  slot = hash_map_slot(impl, impl->slots, slot_index);
+  slot->hashed_key = key_hash;
+  memcpy(hash_map_slot_key(slot), key, impl->key_size);
+  memcpy(hash_map_slot_value(impl, slot), value, impl->data_size);
+  hash_map_set_control(impl->control, impl->capacity, slot_index, CONTROL_HASH(key_hash));
+  impl->size++;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_hash_map_reserve(rcutils_hash_map_t * hash_map, size_t size)
+{
+  HASH_MAP_VALIDATE_HASH_MAP(hash_map);
+  rcutils_hash_map_impl_t * impl = hash_map->impl;
+  size_t capacity = hash_map_capacity_for_size(impl, size);
+  if (0 == capacity) {
+    RCUTILS_SET_ERROR_MSG("failed to reserve the capacity for too many entries");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  if (capacity <= impl->capacity) {
+    return RCUTILS_RET_OK;
+  }
+
+  // Finish growing before growing again
+  rcutils_ret_t ret = hash_map_rehash_buckets(impl, impl->old_capacity);
+  if (RCUTILS_RET_OK == ret) {
+    RCUTILS_TRACEPOINT(hash_map_resize_start, impl, impl->capacity, capacity);
+    ret = RCUTILS_HASH_MAP_BACKEND_OPEN_ADDRESSING == impl->backend ?
+      hash_map_resize_slots(impl, capacity) : hash_map_resize_map(hash_map, capacity);
+    RCUTILS_TRACEPOINT(hash_map_resize_end, impl, ret);
+  }
+  if (RCUTILS_RET_OK != ret) {
+    RCUTILS_SET_ERROR_MSG("failed to allocate memory for map data");
+  }
+  return ret;
+}
+
+rcutils_ret_t
+rcutils_hash_map_shrink_to_fit(rcutils_hash_map_t * hash_map)
+{
+  HASH_MAP_VALIDATE_HASH_MAP(hash_map);
+  rcutils_hash_map_impl_t * impl = hash_map->impl;
+  size_t capacity = hash_map_capacity_for_size(impl, impl->size);
+  if (0 == capacity || capacity > impl->capacity) {
+    capacity = impl->capacity;
+  }
+
+  // Finish growing before shrinking
+  rcutils_ret_t ret = hash_map_rehash_buckets(impl, impl->old_capacity);
+  // Resizing the slots to the same capacity frees the deleted ones
+  if (RCUTILS_RET_OK == ret && (capacity < impl->capacity || impl->deleted > 0)) {
+    RCUTILS_TRACEPOINT(hash_map_resize_start, impl, impl->capacity, capacity);
+    ret = RCUTILS_HASH_MAP_BACKEND_OPEN_ADDRESSING == impl->backend ?
+      hash_map_resize_slots(impl, capacity) : hash_map_resize_map(hash_map, capacity);
+    RCUTILS_TRACEPOINT(hash_map_resize_end, impl, ret);
+  }
+
+  // Release the unused capacity of the buckets, and the empty buckets
+  if (RCUTILS_HASH_MAP_BACKEND_CHAINING == impl->backend) {
+    for (size_t map_index = 0; map_index < impl->capacity && RCUTILS_RET_OK == ret; ++map_index) {
+      rcutils_array_list_t * bucket = &(impl->map[map_index]);
+      if (NULL != bucket->impl) {
+        size_t bucket_size = 0;
+        ret = rcutils_array_list_get_size(bucket, &bucket_size);
+        if (RCUTILS_RET_OK == ret) {
+          ret = 0 == bucket_size ?
+            rcutils_array_list_fini(bucket) : rcutils_array_list_shrink_to_fit(bucket);
+        }
+      }
+    }
+  }
+  if (RCUTILS_RET_OK != ret) {
+    RCUTILS_SET_ERROR_MSG("failed to allocate memory for map data");
+  }
+  return ret;
+}
+
+rcutils_ret_t
+rcutils_hash_map_get_memory_usage(const rcutils_hash_map_t * hash_map, size_t * bytes)
+{
+  HASH_MAP_VALIDATE_HASH_MAP(hash_map);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(bytes, RCUTILS_RET_INVALID_ARGUMENT);
+  const rcutils_hash_map_impl_t * impl = hash_map->impl;
+  size_t total = sizeof(rcutils_hash_map_impl_t);
+  if (RCUTILS_HASH_MAP_BACKEND_OPEN_ADDRESSING == impl->backend) {
+    total += impl->capacity * (impl->slot_size + 1) + GROUP_WIDTH;
+  } else {
+    // Each entry, its key and its value are allocated separately
+    total += impl->size * (sizeof(rcutils_hash_map_entry_t) + impl->key_size + impl->data_size);
+    size_t bucket_count = impl->old_capacity + impl->capacity;
+    total += bucket_count * sizeof(rcutils_array_list_t);
+    for (size_t map_index = 0; map_index < bucket_count; ++map_index) {
+      const rcutils_array_list_t * bucket = hash_map_bucket(impl, map_index);
+      if (NULL != bucket->impl) {
+        size_t bucket_bytes = 0;
+        rcutils_ret_t ret = rcutils_array_list_get_memory_usage(bucket, &bucket_bytes);
+        if (RCUTILS_RET_OK != ret) {
+          return ret;
+        }
+        total += bucket_bytes;
+      }
+    }
+  }
+  *bytes = total;
+  return RCUTILS_RET_OK;
+}
+
 rcutils_ret_t
 rcutils_hash_map_set(rcutils_hash_map_t * hash_map, const void * key, const void * value)
 {
@@ -363,6 +1203,10 @@ rcutils_hash_map_set(rcutils_hash_map_t * hash_map, const void * key, const void
   RCUTILS_CHECK_ARGUMENT_FOR_NULL(key, RCUTILS_RET_INVALID_ARGUMENT);
   RCUTILS_CHECK_ARGUMENT_FOR_NULL(value, RCUTILS_RET_INVALID_ARGUMENT);
 
+  if (RCUTILS_HASH_MAP_BACKEND_OPEN_ADDRESSING == hash_map->impl->backend) {
+    return hash_map_set_slot(hash_map->impl, key, value);
+  }
+
   size_t key_hash = 0, map_index = 0, bucket_index = 0;
   bool already_exists = false;
   rcutils_hash_map_entry_t * entry = NULL;
@@ -394,7 +1238,7 @@ rcutils_hash_map_set(rcutils_hash_map_t * hash_map, const void * key, const void
       memcpy(entry->value, value, hash_map->impl->data_size);
       memcpy(entry->key, key, hash_map->impl->key_size);
 
-      bucket_index = key_hash % hash_map->impl->capacity;
+      bucket_index = BUCKET_INDEX(key_hash, hash_map->impl->capacity);
       ret = hash_map_insert_entry(hash_map->impl->map, bucket_index, entry, allocator);
     }
 
@@ -420,6 +1264,24 @@ rcutils_hash_map_unset(rcutils_hash_map_t * hash_map, const void * key)
   HASH_MAP_VALIDATE_HASH_MAP(hash_map);
   RCUTILS_CHECK_ARGUMENT_FOR_NULL(key, RCUTILS_RET_INVALID_ARGUMENT);
 
+  if (RCUTILS_HASH_MAP_BACKEND_OPEN_ADDRESSING == hash_map->impl->backend) {
+    size_t slot_index = 0;
+    if (NULL != hash_map_find_slot(
+        hash_map->impl, key, hash_map->impl->key_hashing_func(key), &slot_index))
+    {
+      // The slot stays in the probe sequences going through it until the map is resized
+      hash_map_set_control(
+        hash_map->impl->control, hash_map->impl->capacity, slot_index, CONTROL_DELETED);
+      hash_map->impl->deleted++;
+      hash_map->impl->size--;
+      rcutils_ret_t ret = hash_map_check_and_shrink_map(hash_map);
+      // Just log on this failure because the map can continue to operate with more memory
+      RCUTILS_LOG_ERROR_EXPRESSION(
+        RCUTILS_RET_OK != ret, "Failed to shrink hash_map. Reason: %d", ret);
+    }
+    return RCUTILS_RET_OK;
+  }
+
   size_t key_hash = 0, map_index = 0, bucket_index = 0;
   bool already_exists = false;
   rcutils_hash_map_entry_t * entry = NULL;
@@ -432,12 +1294,25 @@ rcutils_hash_map_unset(rcutils_hash_map_t * hash_map, const void * key)
   }
 
   // Remove the entry from its bucket and deallocate it
-  rcutils_array_list_t * bucket = &(hash_map->impl->map[map_index]);
-  if (RCUTILS_RET_OK == rcutils_array_list_remove(bucket, bucket_index)) {
+  rcutils_array_list_t * bucket = hash_map_bucket(hash_map->impl, map_index);
+  // The order of the entries of a bucket doesn't matter
+  if (RCUTILS_RET_OK == rcutils_array_list_swap_remove(bucket, bucket_index)) {
     hash_map->impl->size--;
     hash_map_deallocate_entry(&hash_map->impl->allocator, entry);
   }
 
+  if (NULL != hash_map->impl->old_map) {
+    rcutils_ret_t ret = hash_map_rehash_buckets(
+      hash_map->impl, hash_map->impl->rehash_buckets_per_operation);
+    // Just log on this failure because the map can continue to operate with degraded performance
+    RCUTILS_LOG_ERROR_EXPRESSION(
+      RCUTILS_RET_OK != ret, "Failed to rehash hash_map. Reason: %d", ret);
+  }
+
+  rcutils_ret_t ret = hash_map_check_and_shrink_map(hash_map);
+  // Just log on this failure because the map can continue to operate with more memory
+  RCUTILS_LOG_ERROR_EXPRESSION(RCUTILS_RET_OK != ret, "Failed to shrink hash_map. Reason: %d", ret);
+
   return RCUTILS_RET_OK;
 }
 
@@ -453,6 +1328,12 @@ rcutils_hash_map_key_exists(const rcutils_hash_map_t * hash_map, const void * ke
     return false;
   }
 
+  if (RCUTILS_HASH_MAP_BACKEND_OPEN_ADDRESSING == hash_map->impl->backend) {
+    size_t slot_index = 0;
+    return NULL != hash_map_find_slot(
+      hash_map->impl, key, hash_map->impl->key_hashing_func(key), &slot_index);
+  }
+
   size_t key_hash = 0, map_index = 0, bucket_index = 0;
   bool already_exists = false;
   rcutils_hash_map_entry_t * entry = NULL;
@@ -469,6 +1350,17 @@ rcutils_hash_map_get(const rcutils_hash_map_t * hash_map, const void * key, void
   RCUTILS_CHECK_ARGUMENT_FOR_NULL(key, RCUTILS_RET_INVALID_ARGUMENT);
   RCUTILS_CHECK_ARGUMENT_FOR_NULL(data, RCUTILS_RET_INVALID_ARGUMENT);
 
+  if (RCUTILS_HASH_MAP_BACKEND_OPEN_ADDRESSING == hash_map->impl->backend) {
+    size_t slot_index = 0;
+    hash_map_slot_t * slot = hash_map_find_slot(
+      hash_map->impl, key, hash_map->impl->key_hashing_func(key), &slot_index);
+    if (NULL == slot) {
+      return RCUTILS_RET_NOT_FOUND;
+    }
+    memcpy(data, hash_map_slot_value(hash_map->impl, slot), hash_map->impl->data_size);
+    return RCUTILS_RET_OK;
+  }
+
   size_t key_hash = 0, map_index = 0, bucket_index = 0;
   bool already_exists = false;
   rcutils_hash_map_entry_t * entry = NULL;
@@ -483,58 +1375,209 @@ rcutils_hash_map_get(const rcutils_hash_map_t * hash_map, const void * key, void
   return RCUTILS_RET_NOT_FOUND;
 }
 
+// Compares a key which is a pointer to a c string to a string view
+static int hash_map_string_view_cmp(const void * key, const void * view)
+{
+  return rcutils_string_view_equal_cstring(
+    *(const rcutils_string_view_t *)view, *(const char * const *)key) ? 0 : 1;
+}
+
+// Returns the value of the key given as a view, or NULL if it doesn't exist,
+// the keys of the map being pointers to c strings hashed by one of the string hash functions
+static void * hash_map_find_string_view(
+  const rcutils_hash_map_t * hash_map, rcutils_string_view_t view)
+{
+  const rcutils_hash_map_impl_t * impl = hash_map->impl;
+  size_t key_hash = 0;
+  if (rcutils_hash_map_fast_string_hash_func == impl->key_hashing_func) {
+    key_hash = rcutils_hash_map_bytes_hash(view.data, view.length);
+  } else {
+    // The djb2 hash of rcutils_hash_map_string_hash_func()
+    key_hash = 5381;
+    for (size_t i = 0; i < view.length; ++i) {
+      key_hash = ((key_hash << 5) + key_hash) + (size_t)view.data[i];
+    }
+  }
+
+  if (RCUTILS_HASH_MAP_BACKEND_OPEN_ADDRESSING == impl->backend) {
+    size_t slot_index = 0;
+    hash_map_slot_t * slot = hash_map_find_slot_with(
+      impl, &view, key_hash, hash_map_string_view_cmp, &slot_index);
+    return NULL == slot ? NULL : hash_map_slot_value(impl, slot);
+  }
+
+  size_t map_index = 0, bucket_index = 0;
+  rcutils_hash_map_entry_t * entry = NULL;
+  if (hash_map_find_hashed(
+      hash_map, &view, key_hash, hash_map_string_view_cmp, &map_index, &bucket_index, &entry))
+  {
+    return entry->value;
+  }
+  return NULL;
+}
+
+// Returns true if the keys of the map are pointers to c strings, so they can be found by view
+static bool hash_map_has_string_keys(const rcutils_hash_map_impl_t * impl)
+{
+  return (rcutils_hash_map_string_hash_func == impl->key_hashing_func ||
+         rcutils_hash_map_fast_string_hash_func == impl->key_hashing_func) &&
+         rcutils_hash_map_string_cmp_func == impl->key_cmp_func;
+}
+
+bool
+rcutils_hash_map_key_existsn(
+  const rcutils_hash_map_t * hash_map, const char * key, size_t key_length)
+{
+  if (NULL == hash_map || NULL == hash_map->impl || (NULL == key && 0 != key_length)) {
+    return false;
+  }
+  if (!hash_map_has_string_keys(hash_map->impl)) {
+    return false;
+  }
+  rcutils_string_view_t view = {key, key_length};
+  return NULL != hash_map_find_string_view(hash_map, view);
+}
+
 rcutils_ret_t
-rcutils_hash_map_get_next_key_and_data(
-  const rcutils_hash_map_t * hash_map,
-  const void * previous_key,
-  void * key,
-  void * data)
+rcutils_hash_map_getn(
+  const rcutils_hash_map_t * hash_map, const char * key, size_t key_length, void * data)
 {
   HASH_MAP_VALIDATE_HASH_MAP(hash_map);
-  RCUTILS_CHECK_ARGUMENT_FOR_NULL(key, RCUTILS_RET_INVALID_ARGUMENT);
+  if (NULL == key && 0 != key_length) {
+    RCUTILS_SET_ERROR_MSG("key is null");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
   RCUTILS_CHECK_ARGUMENT_FOR_NULL(data, RCUTILS_RET_INVALID_ARGUMENT);
+  if (!hash_map_has_string_keys(hash_map->impl)) {
+    RCUTILS_SET_ERROR_MSG("hash_map keys aren't hashed and compared as c strings");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
 
-  size_t key_hash = 0, map_index = 0, bucket_index = 0;
-  bool already_exists = false;
-  rcutils_hash_map_entry_t * entry = NULL;
-  rcutils_ret_t ret = RCUTILS_RET_OK;
+  rcutils_string_view_t view = {key, key_length};
+  const void * value = hash_map_find_string_view(hash_map, view);
+  if (NULL == value) {
+    return RCUTILS_RET_NOT_FOUND;
+  }
+  memcpy(data, value, hash_map->impl->data_size);
+  return RCUTILS_RET_OK;
+}
 
-  if (NULL != previous_key) {
-    already_exists = hash_map_find(hash_map, key, &key_hash, &map_index, &bucket_index, &entry);
-    if (!already_exists) {
-      return RCUTILS_RET_NOT_FOUND;
+// Copies the key and data of the first entry at or after the bucket map_index and the index
+// bucket_index in it, or slot map_index, and sets the indices to that entry
+static rcutils_ret_t hash_map_get_entry_from(
+  const rcutils_hash_map_impl_t * impl,
+  size_t * map_index,
+  size_t * bucket_index,
+  void * key,
+  void * data)
+{
+  if (RCUTILS_HASH_MAP_BACKEND_OPEN_ADDRESSING == impl->backend) {
+    for (; *map_index < impl->capacity; ++(*map_index)) {
+      if (CONTROL_IS_FULL(impl->control[*map_index])) {
+        hash_map_slot_t * slot = hash_map_slot(impl, impl->slots, *map_index);
+        memcpy(key, hash_map_slot_key(slot), impl->key_size);
+        memcpy(data, hash_map_slot_value(impl, slot), impl->data_size);
+        return RCUTILS_RET_OK;
+      }
     }
-    bucket_index++;  // We want to start our search from the next object
+    return RCUTILS_RET_HASH_MAP_NO_MORE_ENTRIES;
   }
 
-  for (; map_index < hash_map->impl->capacity; ++map_index) {
-    rcutils_array_list_t * bucket = &(hash_map->impl->map[map_index]);
+  for (; *map_index < impl->old_capacity + impl->capacity; ++(*map_index)) {
+    rcutils_array_list_t * bucket = hash_map_bucket(impl, *map_index);
     if (NULL != bucket->impl) {
       size_t bucket_size = 0;
-      ret = rcutils_array_list_get_size(bucket, &bucket_size);
+      rcutils_ret_t ret = rcutils_array_list_get_size(bucket, &bucket_size);
       if (RCUTILS_RET_OK != ret) {
         return ret;
       }
 
       // Check if the next index in this bucket is valid and if so we've found the next item
-      if (bucket_index < bucket_size) {
+      if (*bucket_index < bucket_size) {
         rcutils_hash_map_entry_t * bucket_entry = NULL;
-        ret = rcutils_array_list_get(bucket, bucket_index, &bucket_entry);
+        ret = rcutils_array_list_get(bucket, *bucket_index, &bucket_entry);
         if (RCUTILS_RET_OK == ret) {
-          memcpy(key, bucket_entry->key, hash_map->impl->key_size);
-          memcpy(data, bucket_entry->value, hash_map->impl->data_size);
+          memcpy(key, bucket_entry->key, impl->key_size);
+          memcpy(data, bucket_entry->value, impl->data_size);
         }
 
         return ret;
       }
     }
     // After the first bucket the next entry must be at the start of the next bucket with entries
-    bucket_index = 0;
+    *bucket_index = 0;
   }
 
   return RCUTILS_RET_HASH_MAP_NO_MORE_ENTRIES;
 }
 
+rcutils_ret_t
+rcutils_hash_map_get_next_key_and_data(
+  const rcutils_hash_map_t * hash_map,
+  const void * previous_key,
+  void * key,
+  void * data)
+{
+  HASH_MAP_VALIDATE_HASH_MAP(hash_map);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(key, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(data, RCUTILS_RET_INVALID_ARGUMENT);
+
+  size_t key_hash = 0, map_index = 0, bucket_index = 0;
+  bool already_exists = false;
+  rcutils_hash_map_entry_t * entry = NULL;
+
+  if (RCUTILS_HASH_MAP_BACKEND_OPEN_ADDRESSING == hash_map->impl->backend) {
+    if (NULL != previous_key) {
+      if (NULL == hash_map_find_slot(
+          hash_map->impl, previous_key, hash_map->impl->key_hashing_func(previous_key),
+          &map_index))
+      {
+        return RCUTILS_RET_NOT_FOUND;
+      }
+      map_index++;  // We want to start our search from the next slot
+    }
+  } else if (NULL != previous_key) {
+    already_exists = hash_map_find(hash_map, key, &key_hash, &map_index, &bucket_index, &entry);
+    if (!already_exists) {
+      return RCUTILS_RET_NOT_FOUND;
+    }
+    bucket_index++;  // We want to start our search from the next object
+  }
+
+  return hash_map_get_entry_from(hash_map->impl, &map_index, &bucket_index, key, data);
+}
+
+rcutils_hash_map_iterator_t
+rcutils_hash_map_get_zero_initialized_iterator(void)
+{
+  static rcutils_hash_map_iterator_t zero_initialized_iterator = {0, 0};
+  return zero_initialized_iterator;
+}
+
+rcutils_ret_t
+rcutils_hash_map_iterate(
+  const rcutils_hash_map_t * hash_map,
+  rcutils_hash_map_iterator_t * iterator,
+  void * key,
+  void * data)
+{
+  HASH_MAP_VALIDATE_HASH_MAP(hash_map);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(iterator, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(key, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(data, RCUTILS_RET_INVALID_ARGUMENT);
+
+  rcutils_ret_t ret = hash_map_get_entry_from(
+    hash_map->impl, &iterator->map_index, &iterator->bucket_index, key, data);
+  if (RCUTILS_RET_OK == ret) {
+    // Continue after the entry
+    if (RCUTILS_HASH_MAP_BACKEND_OPEN_ADDRESSING == hash_map->impl->backend) {
+      iterator->map_index++;
+    } else {
+      iterator->bucket_index++;
+    }
+  }
+  return ret;
+}
 
 #ifdef __cplusplus
 }
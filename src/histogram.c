@@ -0,0 +1,298 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_MSC_VER)
+# include <intrin.h>
+#endif
+
+#include "rcutils/error_handling.h"
+#include "rcutils/stdatomic_helper.h"
+#include "rcutils/types/histogram.h"
+
+// The atomic type has the size and alignment of the counters of the histogram.
+#define HISTOGRAM_ATOMIC(counter) ((atomic_uint_least64_t *)(counter))
+
+#define HISTOGRAM_VALIDATE(histogram) \
+  do { \
+    RCUTILS_CHECK_ARGUMENT_FOR_NULL(histogram, RCUTILS_RET_INVALID_ARGUMENT); \
+    RCUTILS_CHECK_FOR_NULL_WITH_MSG( \
+      histogram->buckets, "histogram is not initialized", \
+      return RCUTILS_RET_INVALID_ARGUMENT); \
+  } while (0)
+
+// Returns the index of the highest bit set in a value which isn't 0
+static inline uint32_t histogram_highest_bit(uint64_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return 63u - (uint32_t)__builtin_clzll(value);
+#elif defined(_MSC_VER) && defined(_M_X64)
+  unsigned long index = 0;
+  _BitScanReverse64(&index, value);
+  return (uint32_t)index;
+#else
+  uint32_t index = 0;
+  while (0 != (value >>= 1)) {
+    ++index;
+  }
+  return index;
+#endif
+}
+
+// Returns the index of the bucket of a value, which may be beyond the last bucket
+static inline size_t histogram_bucket_index(uint32_t precision_bits, uint64_t value)
+{
+  uint64_t sub_bucket_count = (uint64_t)1 << precision_bits;
+  if (value < sub_bucket_count) {
+    return (size_t)value;
+  }
+  uint32_t exponent = histogram_highest_bit(value);
+  uint64_t sub_bucket = (value >> (exponent - precision_bits)) & (sub_bucket_count - 1u);
+  return (size_t)((exponent - precision_bits + 1u) * sub_bucket_count + sub_bucket);
+}
+
+static inline uint64_t histogram_bucket_lower_bound(uint32_t precision_bits, size_t index)
+{
+  uint64_t sub_bucket_count = (uint64_t)1 << precision_bits;
+  if (index < sub_bucket_count) {
+    return (uint64_t)index;
+  }
+  uint64_t exponent = index / sub_bucket_count + precision_bits - 1u;
+  uint64_t sub_bucket = index % sub_bucket_count;
+  return (sub_bucket_count + sub_bucket) << (exponent - precision_bits);
+}
+
+static inline uint64_t histogram_load(const uint64_t * counter)
+{
+  uint64_t value;
+  rcutils_atomic_load_explicit(HISTOGRAM_ATOMIC(counter), value, memory_order_relaxed);
+  return value;
+}
+
+static inline void histogram_add(uint64_t * counter, uint64_t value)
+{
+  uint64_t previous;
+  rcutils_atomic_fetch_add_explicit(
+    HISTOGRAM_ATOMIC(counter), previous, value, memory_order_relaxed);
+  RCUTILS_UNUSED(previous);
+}
+
+// Lowers the counter to the value, or raises it if lower is false
+static inline void histogram_bound(uint64_t * counter, uint64_t value, bool lower)
+{
+  bool exchanged = false;
+  uint64_t current = histogram_load(counter);
+  while ((lower ? value < current : value > current) && !exchanged) {
+    rcutils_atomic_compare_exchange_weak_explicit(
+      HISTOGRAM_ATOMIC(counter), exchanged, &current, value,
+      memory_order_relaxed, memory_order_relaxed);
+  }
+}
+
+rcutils_histogram_t
+rcutils_get_zero_initialized_histogram(void)
+{
+  static rcutils_histogram_t histogram = {
+    .buckets = NULL,
+    .bucket_count = 0lu,
+    .precision_bits = 0u,
+    .count = 0u,
+    .sum = 0u,
+    .min = UINT64_MAX,
+    .max = 0u
+  };
+  histogram.allocator = rcutils_get_zero_initialized_allocator();
+  return histogram;
+}
+
+rcutils_ret_t
+rcutils_histogram_init(
+  rcutils_histogram_t * histogram,
+  uint64_t highest_trackable_value,
+  uint32_t precision_bits,
+  const rcutils_allocator_t * allocator)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(histogram, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ALLOCATOR(allocator, return RCUTILS_RET_INVALID_ARGUMENT);
+  if (0u == precision_bits || precision_bits > RCUTILS_HISTOGRAM_MAX_PRECISION_BITS) {
+    RCUTILS_SET_ERROR_MSG("precision_bits must be between 1 and 16");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+
+  size_t bucket_count = histogram_bucket_index(precision_bits, highest_trackable_value) + 1u;
+  histogram->buckets = allocator->zero_allocate(bucket_count, sizeof(uint64_t), allocator->state);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    histogram->buckets,
+    "failed to allocate memory for histogram",
+    return RCUTILS_RET_BAD_ALLOC);
+  histogram->bucket_count = bucket_count;
+  histogram->precision_bits = precision_bits;
+  histogram->count = 0u;
+  histogram->sum = 0u;
+  histogram->min = UINT64_MAX;
+  histogram->max = 0u;
+  histogram->allocator = *allocator;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_histogram_fini(rcutils_histogram_t * histogram)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(histogram, RCUTILS_RET_INVALID_ARGUMENT);
+  if (NULL != histogram->buckets) {
+    RCUTILS_CHECK_ALLOCATOR(&histogram->allocator, return RCUTILS_RET_INVALID_ARGUMENT);
+    histogram->allocator.deallocate(histogram->buckets, histogram->allocator.state);
+  }
+  *histogram = rcutils_get_zero_initialized_histogram();
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_histogram_record(rcutils_histogram_t * histogram, uint64_t value)
+{
+  HISTOGRAM_VALIDATE(histogram);
+
+  size_t index = histogram_bucket_index(histogram->precision_bits, value);
+  if (index >= histogram->bucket_count) {
+    index = histogram->bucket_count - 1u;
+  }
+  histogram_add(&histogram->buckets[index], 1u);
+  histogram_add(&histogram->count, 1u);
+  histogram_add(&histogram->sum, value);
+  histogram_bound(&histogram->min, value, true);
+  histogram_bound(&histogram->max, value, false);
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_histogram_merge(rcutils_histogram_t * histogram, const rcutils_histogram_t * other)
+{
+  HISTOGRAM_VALIDATE(histogram);
+  HISTOGRAM_VALIDATE(other);
+  if (histogram->bucket_count != other->bucket_count ||
+    histogram->precision_bits != other->precision_bits)
+  {
+    RCUTILS_SET_ERROR_MSG("histograms have different buckets");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+
+  for (size_t i = 0u; i < other->bucket_count; ++i) {
+    uint64_t count = histogram_load(&other->buckets[i]);
+    if (0u != count) {
+      histogram_add(&histogram->buckets[i], count);
+    }
+  }
+  histogram_add(&histogram->count, histogram_load(&other->count));
+  histogram_add(&histogram->sum, histogram_load(&other->sum));
+  histogram_bound(&histogram->min, histogram_load(&other->min), true);
+  histogram_bound(&histogram->max, histogram_load(&other->max), false);
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_histogram_reset(rcutils_histogram_t * histogram)
+{
+  HISTOGRAM_VALIDATE(histogram);
+
+  for (size_t i = 0u; i < histogram->bucket_count; ++i) {
+    rcutils_atomic_store(HISTOGRAM_ATOMIC(&histogram->buckets[i]), (uint64_t)0u);
+  }
+  rcutils_atomic_store(HISTOGRAM_ATOMIC(&histogram->count), (uint64_t)0u);
+  rcutils_atomic_store(HISTOGRAM_ATOMIC(&histogram->sum), (uint64_t)0u);
+  rcutils_atomic_store(HISTOGRAM_ATOMIC(&histogram->min), UINT64_MAX);
+  rcutils_atomic_store(HISTOGRAM_ATOMIC(&histogram->max), (uint64_t)0u);
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_histogram_get_percentile(
+  const rcutils_histogram_t * histogram, double percentile, uint64_t * value)
+{
+  HISTOGRAM_VALIDATE(histogram);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(value, RCUTILS_RET_INVALID_ARGUMENT);
+  if (!(percentile >= 0.0 && percentile <= 100.0)) {
+    RCUTILS_SET_ERROR_MSG("percentile must be between 0 and 100");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+
+  *value = 0u;
+  // The buckets are summed rather than reading the count, so that values being recorded
+  // concurrently are consistently in or out
+  uint64_t count = 0u;
+  for (size_t i = 0u; i < histogram->bucket_count; ++i) {
+    count += histogram_load(&histogram->buckets[i]);
+  }
+  if (0u == count) {
+    return RCUTILS_RET_OK;
+  }
+  // The rank of the value at the percentile, from 1 to count
+  uint64_t rank = (uint64_t)(percentile / 100.0 * (double)count + 0.5);
+  rank = rank < 1u ? 1u : (rank > count ? count : rank);
+
+  uint64_t min = histogram_load(&histogram->min);
+  uint64_t max = histogram_load(&histogram->max);
+  uint64_t seen = 0u;
+  size_t index = 0u;
+  for (; index < histogram->bucket_count; ++index) {
+    seen += histogram_load(&histogram->buckets[index]);
+    if (seen >= rank) {
+      break;
+    }
+  }
+  uint64_t highest = max;
+  if (index + 1u < histogram->bucket_count) {
+    highest = histogram_bucket_lower_bound(histogram->precision_bits, index + 1u) - 1u;
+  }
+  *value = highest > max ? max : (highest < min ? min : highest);
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_histogram_get_bucket_index(
+  const rcutils_histogram_t * histogram, uint64_t value, size_t * index)
+{
+  HISTOGRAM_VALIDATE(histogram);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(index, RCUTILS_RET_INVALID_ARGUMENT);
+
+  size_t found = histogram_bucket_index(histogram->precision_bits, value);
+  *index = found < histogram->bucket_count ? found : histogram->bucket_count - 1u;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_histogram_get_bucket_lower_bound(
+  const rcutils_histogram_t * histogram, size_t index, uint64_t * lower_bound)
+{
+  HISTOGRAM_VALIDATE(histogram);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(lower_bound, RCUTILS_RET_INVALID_ARGUMENT);
+  if (index >= histogram->bucket_count) {
+    RCUTILS_SET_ERROR_MSG("index is out of bounds");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+
+  *lower_bound = histogram_bucket_lower_bound(histogram->precision_bits, index);
+  return RCUTILS_RET_OK;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,310 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef _WIN32
+// See the comment in logging.c about warning C5105.
+# pragma warning(push)
+# pragma warning(disable : 5105)
+# include <windows.h>
+# pragma warning(pop)
+#else
+# include <sched.h>
+#endif
+
+#include "rcutils/allocator.h"
+#include "rcutils/error_handling.h"
+#include "rcutils/intern.h"
+#include "rcutils/stdatomic_helper.h"
+#include "rcutils/types/hash_map.h"
+
+#include "./string_arena.h"
+
+// The entries are stored in segments which never move, segment s holding
+// 2^(s + RCUTILS_INTERN_FIRST_SEGMENT_BITS) of them, so that they can be read without the lock.
+#define RCUTILS_INTERN_FIRST_SEGMENT_BITS 8
+#define RCUTILS_INTERN_SEGMENTS (sizeof(size_t) * 8 - RCUTILS_INTERN_FIRST_SEGMENT_BITS)
+
+typedef struct rcutils_intern_entry_t
+{
+  const char * string;
+  size_t length;
+  size_t hash;
+} rcutils_intern_entry_t;
+
+typedef struct rcutils_intern_table_t
+{
+  // The copies of the strings.
+  rcutils_string_arena_t * arena;
+  // Linear probing index of the ids of the entries, 0 marking an empty slot.
+  size_t * index;
+  // The size of the index minus one, the size being a power of two.
+  size_t index_mask;
+  rcutils_allocator_t allocator;
+} rcutils_intern_table_t;
+
+// Only accessed with the lock held.
+static rcutils_intern_table_t g_rcutils_intern_table;
+// The segments of entries, each published before the count includes one of its entries.
+static atomic_uintptr_t g_rcutils_intern_segments[RCUTILS_INTERN_SEGMENTS];
+// The number of entries, incremented once an entry is complete.
+static atomic_uint_least64_t g_rcutils_intern_count = ATOMIC_VAR_INIT(0);
+static atomic_bool g_rcutils_intern_lock = ATOMIC_VAR_INIT(false);
+
+static void rcutils_intern_lock(void)
+{
+  while (rcutils_atomic_exchange_bool(&g_rcutils_intern_lock, true)) {
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+  }
+}
+
+static void rcutils_intern_unlock(void)
+{
+  rcutils_atomic_store(&g_rcutils_intern_lock, false);
+}
+
+// Returns the entry with the given id, which must be valid.
+static rcutils_intern_entry_t * rcutils_intern_get_entry(size_t id)
+{
+  // Ids start at 1, offset them so the first segment starts at 2^FIRST_SEGMENT_BITS
+  size_t position = id - 1 + ((size_t)1 << RCUTILS_INTERN_FIRST_SEGMENT_BITS);
+  size_t bits = 0;
+  while ((position >> bits) > 1) {
+    ++bits;
+  }
+  size_t segment = bits - RCUTILS_INTERN_FIRST_SEGMENT_BITS;
+  rcutils_intern_entry_t * entries = (rcutils_intern_entry_t *)rcutils_atomic_load_uintptr_t(
+    &g_rcutils_intern_segments[segment]);
+  return &entries[position - ((size_t)1 << bits)];
+}
+
+// Finds the slot of the index holding the string, or the empty slot where it belongs.
+static size_t rcutils_intern_find_slot(const char * str, size_t length, size_t hash)
+{
+  const rcutils_intern_table_t * table = &g_rcutils_intern_table;
+  size_t slot = hash & table->index_mask;
+  while (RCUTILS_INTERN_INVALID_ID != table->index[slot]) {
+    const rcutils_intern_entry_t * entry = rcutils_intern_get_entry(table->index[slot]);
+    if (entry->hash == hash && entry->length == length &&
+      (0 == length || 0 == memcmp(entry->string, str, length)))
+    {
+      break;
+    }
+    slot = (slot + 1) & table->index_mask;
+  }
+  return slot;
+}
+
+// Makes room for one more entry, doubling the index as it becomes half full.
+static rcutils_ret_t rcutils_intern_reserve(size_t count)
+{
+  rcutils_intern_table_t * table = &g_rcutils_intern_table;
+  if (NULL == table->arena) {
+    table->allocator = rcutils_get_default_allocator();
+    table->arena = rcutils_string_arena_create(0, &table->allocator);
+    if (NULL == table->arena) {
+      RCUTILS_SET_ERROR_MSG("failed to allocate memory for the interned strings");
+      return RCUTILS_RET_BAD_ALLOC;
+    }
+  }
+  if (NULL == table->index || 2 * (count + 1) > table->index_mask + 1) {
+    size_t index_size = NULL == table->index ? 64 : 2 * (table->index_mask + 1);
+    size_t * index = table->allocator.zero_allocate(
+      index_size, sizeof(size_t), table->allocator.state);
+    if (NULL == index) {
+      RCUTILS_SET_ERROR_MSG("failed to allocate memory for the interning index");
+      return RCUTILS_RET_BAD_ALLOC;
+    }
+    table->allocator.deallocate(table->index, table->allocator.state);
+    table->index = index;
+    table->index_mask = index_size - 1;
+    for (size_t id = 1; id <= count; ++id) {
+      rcutils_intern_entry_t * entry = rcutils_intern_get_entry(id);
+      size_t slot = entry->hash & table->index_mask;
+      while (RCUTILS_INTERN_INVALID_ID != index[slot]) {
+        slot = (slot + 1) & table->index_mask;
+      }
+      index[slot] = id;
+    }
+  }
+  // Allocate the segment of the next entry when it's the first one of its segment
+  size_t position = count + ((size_t)1 << RCUTILS_INTERN_FIRST_SEGMENT_BITS);
+  if (0 == (position & (position - 1))) {
+    size_t segment = 0;
+    while (((size_t)1 << (segment + RCUTILS_INTERN_FIRST_SEGMENT_BITS)) < position) {
+      ++segment;
+    }
+    if (segment >= RCUTILS_INTERN_SEGMENTS) {
+      RCUTILS_SET_ERROR_MSG("too many interned strings");
+      return RCUTILS_RET_BAD_ALLOC;
+    }
+    if (0 == rcutils_atomic_load_uintptr_t(&g_rcutils_intern_segments[segment])) {
+      void * entries = table->allocator.allocate(
+        position * sizeof(rcutils_intern_entry_t), table->allocator.state);
+      if (NULL == entries) {
+        RCUTILS_SET_ERROR_MSG("failed to allocate memory for the interned strings");
+        return RCUTILS_RET_BAD_ALLOC;
+      }
+      rcutils_atomic_store(&g_rcutils_intern_segments[segment], (uintptr_t)entries);
+    }
+  }
+  return RCUTILS_RET_OK;
+}
+
+static rcutils_ret_t rcutils_intern_lookup(
+  const char * str, size_t length, bool insert, const char ** interned, size_t * id)
+{
+  if (NULL == str && 0 != length) {
+    RCUTILS_SET_ERROR_MSG("str is null");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  if (0 != length && NULL != memchr(str, '\0', length)) {
+    RCUTILS_SET_ERROR_MSG("str contains a null character");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  if (NULL == str) {
+    str = "";
+  }
+  size_t hash = rcutils_hash_map_bytes_hash(str, length);
+
+  rcutils_intern_lock();
+  size_t count = (size_t)rcutils_atomic_load_uint64_t(&g_rcutils_intern_count);
+  size_t found = RCUTILS_INTERN_INVALID_ID;
+  if (NULL != g_rcutils_intern_table.index) {
+    found = g_rcutils_intern_table.index[rcutils_intern_find_slot(str, length, hash)];
+  }
+  if (RCUTILS_INTERN_INVALID_ID == found && insert) {
+    rcutils_ret_t ret = rcutils_intern_reserve(count);
+    if (RCUTILS_RET_OK != ret) {
+      rcutils_intern_unlock();
+      // error message already set
+      return ret;
+    }
+    char * copy = rcutils_string_arena_strndup(g_rcutils_intern_table.arena, str, length);
+    if (NULL == copy) {
+      rcutils_intern_unlock();
+      RCUTILS_SET_ERROR_MSG("failed to allocate memory for the interned string");
+      return RCUTILS_RET_BAD_ALLOC;
+    }
+    found = count + 1;
+    rcutils_intern_entry_t * entry = rcutils_intern_get_entry(found);
+    entry->string = copy;
+    entry->length = length;
+    entry->hash = hash;
+    g_rcutils_intern_table.index[rcutils_intern_find_slot(str, length, hash)] = found;
+    rcutils_atomic_store(&g_rcutils_intern_count, (uint64_t)found);
+  }
+  rcutils_intern_unlock();
+
+  if (RCUTILS_INTERN_INVALID_ID == found) {
+    return RCUTILS_RET_NOT_FOUND;
+  }
+  if (NULL != interned) {
+    *interned = rcutils_intern_get_entry(found)->string;
+  }
+  if (NULL != id) {
+    *id = found;
+  }
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_intern_stringn(const char * str, size_t length, const char ** interned, size_t * id)
+{
+  return rcutils_intern_lookup(str, length, true, interned, id);
+}
+
+rcutils_ret_t
+rcutils_intern_string(const char * str, const char ** interned, size_t * id)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(str, RCUTILS_RET_INVALID_ARGUMENT);
+  return rcutils_intern_lookup(str, strlen(str), true, interned, id);
+}
+
+rcutils_ret_t
+rcutils_intern_findn(const char * str, size_t length, const char ** interned, size_t * id)
+{
+  return rcutils_intern_lookup(str, length, false, interned, id);
+}
+
+const char *
+rcutils_intern_get_string(size_t id)
+{
+  if (RCUTILS_INTERN_INVALID_ID == id ||
+    id > (size_t)rcutils_atomic_load_uint64_t(&g_rcutils_intern_count))
+  {
+    return NULL;
+  }
+  return rcutils_intern_get_entry(id)->string;
+}
+
+size_t
+rcutils_intern_get_count(void)
+{
+  return (size_t)rcutils_atomic_load_uint64_t(&g_rcutils_intern_count);
+}
+
+void
+rcutils_intern_shutdown(void)
+{
+  rcutils_intern_table_t * table = &g_rcutils_intern_table;
+  if (NULL == table->arena) {
+    return;
+  }
+  rcutils_atomic_store(&g_rcutils_intern_count, (uint64_t)0);
+  for (size_t segment = 0; segment < RCUTILS_INTERN_SEGMENTS; ++segment) {
+    void * entries = (void *)rcutils_atomic_exchange_uintptr_t(
+      &g_rcutils_intern_segments[segment], (uintptr_t)0);
+    table->allocator.deallocate(entries, table->allocator.state);
+  }
+  table->allocator.deallocate(table->index, table->allocator.state);
+  table->index = NULL;
+  table->index_mask = 0;
+  rcutils_string_arena_destroy(table->arena);
+  table->arena = NULL;
+}
+
+size_t
+rcutils_intern_hash_func(const void * key)
+{
+  uintptr_t address;
+  memcpy(&address, key, sizeof(address));
+  uint64_t value = (uint64_t)address;
+  return rcutils_hash_map_uint64_hash_func(&value);
+}
+
+int
+rcutils_intern_cmp_func(const void * val1, const void * val2)
+{
+  const char * cval1, * cval2;
+  memcpy(&cval1, val1, sizeof(cval1));
+  memcpy(&cval2, val2, sizeof(cval2));
+  return cval1 != cval2;
+}
+
+#ifdef __cplusplus
+}
+#endif
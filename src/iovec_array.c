@@ -0,0 +1,244 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdint.h>
+#include <string.h>
+
+#include "rcutils/error_handling.h"
+#include "rcutils/types/iovec_array.h"
+
+rcutils_iovec_array_t
+rcutils_get_zero_initialized_iovec_array(void)
+{
+  static rcutils_iovec_array_t iovec_array = {
+    .segments = NULL,
+    .owned = NULL,
+    .segment_count = 0u,
+    .segment_capacity = 0u,
+    .total_length = 0u,
+  };
+  iovec_array.allocator = rcutils_get_zero_initialized_allocator();
+  return iovec_array;
+}
+
+rcutils_ret_t
+rcutils_iovec_array_init(
+  rcutils_iovec_array_t * iovec_array,
+  size_t segment_capacity,
+  const rcutils_allocator_t * allocator)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(iovec_array, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ALLOCATOR(allocator, return RCUTILS_RET_INVALID_ARGUMENT);
+  if (0u == segment_capacity || segment_capacity > SIZE_MAX / sizeof(rcutils_iovec_t)) {
+    RCUTILS_SET_ERROR_MSG("segment capacity is out of range");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  if (NULL != iovec_array->segments) {
+    RCUTILS_SET_ERROR_MSG("iovec array is already initialized");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  iovec_array->segments = allocator->allocate(
+    segment_capacity * sizeof(rcutils_iovec_t), allocator->state);
+  iovec_array->owned = allocator->allocate(segment_capacity * sizeof(bool), allocator->state);
+  if (NULL == iovec_array->segments || NULL == iovec_array->owned) {
+    allocator->deallocate(iovec_array->segments, allocator->state);
+    allocator->deallocate(iovec_array->owned, allocator->state);
+    *iovec_array = rcutils_get_zero_initialized_iovec_array();
+    RCUTILS_SET_ERROR_MSG("failed to allocate memory for iovec array");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  iovec_array->segment_count = 0u;
+  iovec_array->segment_capacity = segment_capacity;
+  iovec_array->total_length = 0u;
+  iovec_array->allocator = *allocator;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_iovec_array_clear(rcutils_iovec_array_t * iovec_array)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(iovec_array, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    iovec_array->segments, "iovec array is not initialized", return RCUTILS_RET_NOT_INITIALIZED);
+  rcutils_allocator_t * allocator = &iovec_array->allocator;
+  for (size_t i = 0u; i < iovec_array->segment_count; ++i) {
+    if (iovec_array->owned[i]) {
+      allocator->deallocate((void *)iovec_array->segments[i].data, allocator->state);
+    }
+  }
+  iovec_array->segment_count = 0u;
+  iovec_array->total_length = 0u;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_iovec_array_fini(rcutils_iovec_array_t * iovec_array)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(iovec_array, RCUTILS_RET_INVALID_ARGUMENT);
+  if (NULL == iovec_array->segments) {
+    return RCUTILS_RET_OK;
+  }
+  rcutils_ret_t ret = rcutils_iovec_array_clear(iovec_array);
+  if (RCUTILS_RET_OK != ret) {
+    return ret;
+  }
+  rcutils_allocator_t * allocator = &iovec_array->allocator;
+  allocator->deallocate(iovec_array->segments, allocator->state);
+  allocator->deallocate(iovec_array->owned, allocator->state);
+  *iovec_array = rcutils_get_zero_initialized_iovec_array();
+  return RCUTILS_RET_OK;
+}
+
+// Check the arguments of the functions adding a segment, and make room for it.
+static rcutils_ret_t
+rcutils_iovec_array_reserve_segment(
+  rcutils_iovec_array_t * iovec_array, const void * data, size_t length)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(iovec_array, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    iovec_array->segments, "iovec array is not initialized", return RCUTILS_RET_NOT_INITIALIZED);
+  if (NULL == data && length > 0u) {
+    RCUTILS_SET_ERROR_MSG("data is NULL");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  if (length > SIZE_MAX - iovec_array->total_length) {
+    RCUTILS_SET_ERROR_MSG("total length of iovec array would overflow");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  if (iovec_array->segment_count < iovec_array->segment_capacity) {
+    return RCUTILS_RET_OK;
+  }
+  if (iovec_array->segment_capacity > SIZE_MAX / 2u / sizeof(rcutils_iovec_t)) {
+    RCUTILS_SET_ERROR_MSG("too many segments in iovec array");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  size_t capacity = iovec_array->segment_capacity * 2u;
+  rcutils_allocator_t * allocator = &iovec_array->allocator;
+  // If only the first reallocation succeeds, the segments just have more room than needed.
+  rcutils_iovec_t * segments = allocator->reallocate(
+    iovec_array->segments, capacity * sizeof(rcutils_iovec_t), allocator->state);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    segments, "failed to allocate memory for iovec array", return RCUTILS_RET_BAD_ALLOC);
+  iovec_array->segments = segments;
+  bool * owned = allocator->reallocate(
+    iovec_array->owned, capacity * sizeof(bool), allocator->state);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    owned, "failed to allocate memory for iovec array", return RCUTILS_RET_BAD_ALLOC);
+  iovec_array->owned = owned;
+  iovec_array->segment_capacity = capacity;
+  return RCUTILS_RET_OK;
+}
+
+// Add a segment whose room was reserved, at the front or at the back.
+static void
+rcutils_iovec_array_insert_segment(
+  rcutils_iovec_array_t * iovec_array, const uint8_t * data, size_t length, bool owned,
+  bool front)
+{
+  size_t index = iovec_array->segment_count;
+  if (front) {
+    memmove(
+      &iovec_array->segments[1], &iovec_array->segments[0],
+      iovec_array->segment_count * sizeof(rcutils_iovec_t));
+    memmove(
+      &iovec_array->owned[1], &iovec_array->owned[0], iovec_array->segment_count * sizeof(bool));
+    index = 0u;
+  }
+  iovec_array->segments[index].data = data;
+  iovec_array->segments[index].length = length;
+  iovec_array->owned[index] = owned;
+  ++iovec_array->segment_count;
+  iovec_array->total_length += length;
+}
+
+static rcutils_ret_t
+rcutils_iovec_array_add_reference(
+  rcutils_iovec_array_t * iovec_array, const void * data, size_t length, bool front)
+{
+  rcutils_ret_t ret = rcutils_iovec_array_reserve_segment(iovec_array, data, length);
+  if (RCUTILS_RET_OK != ret || 0u == length) {
+    return ret;
+  }
+  rcutils_iovec_array_insert_segment(iovec_array, data, length, false, front);
+  return RCUTILS_RET_OK;
+}
+
+static rcutils_ret_t
+rcutils_iovec_array_add_copy(
+  rcutils_iovec_array_t * iovec_array, const void * data, size_t length, bool front)
+{
+  rcutils_ret_t ret = rcutils_iovec_array_reserve_segment(iovec_array, data, length);
+  if (RCUTILS_RET_OK != ret || 0u == length) {
+    return ret;
+  }
+  rcutils_allocator_t * allocator = &iovec_array->allocator;
+  uint8_t * copy = allocator->allocate(length, allocator->state);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    copy, "failed to allocate memory for iovec array segment", return RCUTILS_RET_BAD_ALLOC);
+  memcpy(copy, data, length);
+  rcutils_iovec_array_insert_segment(iovec_array, copy, length, true, front);
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_iovec_array_append_reference(
+  rcutils_iovec_array_t * iovec_array, const void * data, size_t length)
+{
+  return rcutils_iovec_array_add_reference(iovec_array, data, length, false);
+}
+
+rcutils_ret_t
+rcutils_iovec_array_prepend_reference(
+  rcutils_iovec_array_t * iovec_array, const void * data, size_t length)
+{
+  return rcutils_iovec_array_add_reference(iovec_array, data, length, true);
+}
+
+rcutils_ret_t
+rcutils_iovec_array_append_copy(
+  rcutils_iovec_array_t * iovec_array, const void * data, size_t length)
+{
+  return rcutils_iovec_array_add_copy(iovec_array, data, length, false);
+}
+
+rcutils_ret_t
+rcutils_iovec_array_prepend_copy(
+  rcutils_iovec_array_t * iovec_array, const void * data, size_t length)
+{
+  return rcutils_iovec_array_add_copy(iovec_array, data, length, true);
+}
+
+rcutils_ret_t
+rcutils_iovec_array_flatten(
+  const rcutils_iovec_array_t * iovec_array, rcutils_uint8_array_t * uint8_array)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(iovec_array, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    iovec_array->segments, "iovec array is not initialized", return RCUTILS_RET_NOT_INITIALIZED);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(uint8_array, RCUTILS_RET_INVALID_ARGUMENT);
+  if (iovec_array->total_length > uint8_array->buffer_capacity) {
+    rcutils_ret_t ret = rcutils_uint8_array_resize(uint8_array, iovec_array->total_length);
+    if (RCUTILS_RET_OK != ret) {
+      return ret;
+    }
+  }
+  size_t offset = 0u;
+  for (size_t i = 0u; i < iovec_array->segment_count; ++i) {
+    const rcutils_iovec_t * segment = &iovec_array->segments[i];
+    memcpy(uint8_array->buffer + offset, segment->data, segment->length);
+    offset += segment->length;
+  }
+  uint8_array->buffer_length = offset;
+  return RCUTILS_RET_OK;
+}
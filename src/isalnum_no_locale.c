@@ -0,0 +1,167 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# include <emmintrin.h>
+# define VALIDATE_CHARS_SSE2
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+# include <arm_neon.h>
+# define VALIDATE_CHARS_NEON
+#endif
+
+#include "rcutils/isalnum_no_locale.h"
+
+#define DI RCUTILS_CHAR_CLASS_DIGIT
+#define UP RCUTILS_CHAR_CLASS_UPPER
+#define LO RCUTILS_CHAR_CLASS_LOWER
+#define US RCUTILS_CHAR_CLASS_UNDERSCORE
+#define SL RCUTILS_CHAR_CLASS_SLASH
+#define TI RCUTILS_CHAR_CLASS_TILDE
+#define BR RCUTILS_CHAR_CLASS_BRACE
+
+// The control characters below 0x20 and the bytes of 0x80 and above are in no class
+const uint8_t rcutils_char_class_table[256] = {
+  // ' ' to '/'
+  [0x20] = 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, SL,
+  // '0' to '?'
+  DI, DI, DI, DI, DI, DI, DI, DI, DI, DI, 0, 0, 0, 0, 0, 0,
+  // '@' to 'O'
+  0, UP, UP, UP, UP, UP, UP, UP, UP, UP, UP, UP, UP, UP, UP, UP,
+  // 'P' to '_'
+  UP, UP, UP, UP, UP, UP, UP, UP, UP, UP, UP, 0, 0, 0, 0, US,
+  // '`' to 'o'
+  0, LO, LO, LO, LO, LO, LO, LO, LO, LO, LO, LO, LO, LO, LO, LO,
+  // 'p' to DEL
+  LO, LO, LO, LO, LO, LO, LO, LO, LO, LO, LO, BR, 0, BR, TI, 0,
+};
+
+#undef DI
+#undef UP
+#undef LO
+#undef US
+#undef SL
+#undef TI
+#undef BR
+
+#if defined(VALIDATE_CHARS_SSE2) || defined(VALIDATE_CHARS_NEON)
+# define VALIDATE_CHARS_BLOCK 16u
+// The most ranges of characters a class mask can make: one per class, two for the braces
+# define VALIDATE_CHARS_MAX_RANGES 8u
+
+typedef struct _char_range_t
+{
+  uint8_t first;
+  uint8_t last;
+} _char_range_t;
+
+// Fills ranges with the ranges of characters of the classes in class_mask, returns their count
+static size_t
+_get_ranges(uint32_t class_mask, _char_range_t * ranges)
+{
+  static const struct
+  {
+    uint32_t char_class;
+    _char_range_t range;
+  } class_ranges[VALIDATE_CHARS_MAX_RANGES] = {
+    {RCUTILS_CHAR_CLASS_DIGIT, {'0', '9'}},
+    {RCUTILS_CHAR_CLASS_UPPER, {'A', 'Z'}},
+    {RCUTILS_CHAR_CLASS_LOWER, {'a', 'z'}},
+    {RCUTILS_CHAR_CLASS_UNDERSCORE, {'_', '_'}},
+    {RCUTILS_CHAR_CLASS_SLASH, {'/', '/'}},
+    {RCUTILS_CHAR_CLASS_TILDE, {'~', '~'}},
+    {RCUTILS_CHAR_CLASS_BRACE, {'{', '{'}},
+    {RCUTILS_CHAR_CLASS_BRACE, {'}', '}'}},
+  };
+  size_t count = 0u;
+  for (size_t i = 0u; i < VALIDATE_CHARS_MAX_RANGES; ++i) {
+    if (0u != (class_mask & class_ranges[i].char_class)) {
+      ranges[count++] = class_ranges[i].range;
+    }
+  }
+  return count;
+}
+#endif
+
+size_t
+rcutils_validate_chars(const char * str, size_t len, uint32_t class_mask)
+{
+  if (NULL == str) {
+    return 0u;
+  }
+  size_t i = 0u;
+#if defined(VALIDATE_CHARS_SSE2) || defined(VALIDATE_CHARS_NEON)
+  if (len >= VALIDATE_CHARS_BLOCK) {
+    _char_range_t ranges[VALIDATE_CHARS_MAX_RANGES];
+    size_t range_count = _get_ranges(class_mask, ranges);
+# if defined(VALIDATE_CHARS_SSE2)
+    // All the ranges are ASCII, so signed comparisons work and bytes of 0x80 and above,
+    // which are negative, are never in one
+    __m128i before_first[VALIDATE_CHARS_MAX_RANGES];
+    __m128i after_last[VALIDATE_CHARS_MAX_RANGES];
+    for (size_t r = 0u; r < range_count; ++r) {
+      before_first[r] = _mm_set1_epi8((char)(ranges[r].first - 1));
+      after_last[r] = _mm_set1_epi8((char)(ranges[r].last + 1));
+    }
+    for (; len - i >= VALIDATE_CHARS_BLOCK; i += VALIDATE_CHARS_BLOCK) {
+      __m128i c = _mm_loadu_si128((const __m128i *)(str + i));
+      __m128i valid = _mm_setzero_si128();
+      for (size_t r = 0u; r < range_count; ++r) {
+        valid = _mm_or_si128(
+          valid,
+          _mm_and_si128(_mm_cmpgt_epi8(c, before_first[r]), _mm_cmplt_epi8(c, after_last[r])));
+      }
+      if (0xffff != _mm_movemask_epi8(valid)) {
+        break;
+      }
+    }
+# else
+    uint8x16_t first[VALIDATE_CHARS_MAX_RANGES];
+    uint8x16_t last[VALIDATE_CHARS_MAX_RANGES];
+    for (size_t r = 0u; r < range_count; ++r) {
+      first[r] = vdupq_n_u8(ranges[r].first);
+      last[r] = vdupq_n_u8(ranges[r].last);
+    }
+    for (; len - i >= VALIDATE_CHARS_BLOCK; i += VALIDATE_CHARS_BLOCK) {
+      uint8x16_t c = vld1q_u8((const uint8_t *)(str + i));
+      uint8x16_t valid = vdupq_n_u8(0);
+      for (size_t r = 0u; r < range_count; ++r) {
+        valid = vorrq_u8(valid, vandq_u8(vcgeq_u8(c, first[r]), vcleq_u8(c, last[r])));
+      }
+      if (0xff != vminvq_u8(valid)) {
+        break;
+      }
+    }
+# endif
+  }
+#endif
+  // The remaining characters, or the block with the first invalid one
+  for (; i < len; ++i) {
+    if (0u == (rcutils_char_class_table[(unsigned char)str[i]] & class_mask)) {
+      return i;
+    }
+  }
+  return len;
+}
+
+#ifdef __cplusplus
+}
+#endif
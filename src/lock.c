@@ -0,0 +1,388 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef _WIN32
+// See the comment in logging.c about warning C5105.
+# pragma warning(push)
+# pragma warning(disable : 5105)
+# include <windows.h>
+# pragma warning(pop)
+#else
+# include <sched.h>
+# if defined(__linux__)
+#  include <linux/futex.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+# endif
+#endif
+
+#include "rcutils/lock.h"
+#include "rcutils/stdatomic_helper.h"
+
+// The atomic types have the size and alignment of the integers of the states of the locks.
+#define LOCK_ATOMIC(state) ((atomic_uint_least32_t *)(state))
+
+// The number of pause hints after which a waiting thread yields its processor.
+#define LOCK_MAX_BACKOFF 64u
+// The number of times a contended mutex is polled before its thread sleeps.
+#define MUTEX_SPIN_COUNT 100u
+
+// Hints the processor that the thread is spinning.
+static inline void
+_pause(void)
+{
+#if defined(_MSC_VER)
+  YieldProcessor();
+#elif defined(__i386__) || defined(__x86_64__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__) || (defined(__ARM_ARCH) && __ARM_ARCH >= 7)
+  __asm__ __volatile__ ("yield");
+#endif
+}
+
+static inline void
+_yield(void)
+{
+#ifdef _WIN32
+  SwitchToThread();
+#else
+  sched_yield();
+#endif
+}
+
+// Waits a little longer each time, pausing up to LOCK_MAX_BACKOFF times, then yielding.
+static inline void
+_backoff(uint32_t * backoff)
+{
+  if (*backoff < LOCK_MAX_BACKOFF) {
+    for (uint32_t i = 0; i < *backoff; ++i) {
+      _pause();
+    }
+    *backoff *= 2u;
+  } else {
+    _yield();
+  }
+}
+
+rcutils_spinlock_t
+rcutils_get_zero_initialized_spinlock(void)
+{
+  static rcutils_spinlock_t zero_initialized_spinlock = {0u};
+  return zero_initialized_spinlock;
+}
+
+void
+rcutils_spinlock_lock(rcutils_spinlock_t * lock)
+{
+  uint32_t backoff = 1u;
+  for (;;) {
+    uint32_t was_locked;
+    rcutils_atomic_exchange_explicit(
+      LOCK_ATOMIC(&lock->locked), was_locked, 1u, memory_order_acquire);
+    if (0u == was_locked) {
+      return;
+    }
+    // Wait for the lock to be released without writing, so its cache line stays shared
+    do {
+      _backoff(&backoff);
+      rcutils_atomic_load_explicit(LOCK_ATOMIC(&lock->locked), was_locked, memory_order_relaxed);
+    } while (0u != was_locked);
+  }
+}
+
+bool
+rcutils_spinlock_try_lock(rcutils_spinlock_t * lock)
+{
+  uint32_t was_locked;
+  rcutils_atomic_exchange_explicit(
+    LOCK_ATOMIC(&lock->locked), was_locked, 1u, memory_order_acquire);
+  return 0u == was_locked;
+}
+
+void
+rcutils_spinlock_unlock(rcutils_spinlock_t * lock)
+{
+  rcutils_atomic_store_explicit(LOCK_ATOMIC(&lock->locked), 0u, memory_order_release);
+}
+
+rcutils_ticket_lock_t
+rcutils_get_zero_initialized_ticket_lock(void)
+{
+  static rcutils_ticket_lock_t zero_initialized_ticket_lock = {0u, 0u};
+  return zero_initialized_ticket_lock;
+}
+
+void
+rcutils_ticket_lock_lock(rcutils_ticket_lock_t * lock)
+{
+  uint32_t ticket;
+  rcutils_atomic_fetch_add_explicit(
+    LOCK_ATOMIC(&lock->next_ticket), ticket, 1u, memory_order_relaxed);
+  uint32_t backoff = 1u;
+  for (;;) {
+    uint32_t serving_ticket;
+    rcutils_atomic_load_explicit(
+      LOCK_ATOMIC(&lock->serving_ticket), serving_ticket, memory_order_acquire);
+    if (serving_ticket == ticket) {
+      return;
+    }
+    _backoff(&backoff);
+  }
+}
+
+bool
+rcutils_ticket_lock_try_lock(rcutils_ticket_lock_t * lock)
+{
+  uint32_t serving_ticket;
+  rcutils_atomic_load_explicit(
+    LOCK_ATOMIC(&lock->serving_ticket), serving_ticket, memory_order_acquire);
+  // Taking the ticket being served only succeeds if no thread holds or waits for the lock
+  uint32_t expected = serving_ticket;
+  bool locked;
+  rcutils_atomic_compare_exchange_strong_explicit(
+    LOCK_ATOMIC(&lock->next_ticket), locked, &expected, serving_ticket + 1u,
+    memory_order_acquire, memory_order_relaxed);
+  return locked;
+}
+
+void
+rcutils_ticket_lock_unlock(rcutils_ticket_lock_t * lock)
+{
+  // Only the thread holding the lock writes the ticket being served
+  uint32_t serving_ticket;
+  rcutils_atomic_load_explicit(
+    LOCK_ATOMIC(&lock->serving_ticket), serving_ticket, memory_order_relaxed);
+  rcutils_atomic_store_explicit(
+    LOCK_ATOMIC(&lock->serving_ticket), serving_ticket + 1u, memory_order_release);
+}
+
+// The states of a mutex.
+#define MUTEX_UNLOCKED 0u
+#define MUTEX_LOCKED 1u
+#define MUTEX_LOCKED_WAITING 2u
+
+// Sleeps while the state is MUTEX_LOCKED_WAITING, or may return spuriously.
+static void
+_mutex_wait(rcutils_mutex_t * mutex)
+{
+#if defined(_WIN32)
+  uint32_t compare = MUTEX_LOCKED_WAITING;
+  WaitOnAddress(&mutex->state, &compare, sizeof(compare), INFINITE);
+#elif defined(__linux__)
+  syscall(SYS_futex, &mutex->state, FUTEX_WAIT_PRIVATE, MUTEX_LOCKED_WAITING, NULL, NULL, 0);
+#else
+  (void)mutex;
+  _yield();
+#endif
+}
+
+// Wakes a thread sleeping in _mutex_wait(), if there is one.
+static void
+_mutex_wake_one(rcutils_mutex_t * mutex)
+{
+#if defined(_WIN32)
+  WakeByAddressSingle(&mutex->state);
+#elif defined(__linux__)
+  syscall(SYS_futex, &mutex->state, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+#else
+  (void)mutex;
+#endif
+}
+
+rcutils_mutex_t
+rcutils_get_zero_initialized_mutex(void)
+{
+  static rcutils_mutex_t zero_initialized_mutex = {MUTEX_UNLOCKED};
+  return zero_initialized_mutex;
+}
+
+static void
+_mutex_lock_contended(rcutils_mutex_t * mutex)
+{
+  // The holder may be about to unlock, which is cheaper to poll for than to sleep
+  uint32_t state;
+  for (uint32_t i = 0; i < MUTEX_SPIN_COUNT; ++i) {
+    _pause();
+    rcutils_atomic_load_explicit(LOCK_ATOMIC(&mutex->state), state, memory_order_relaxed);
+    if (MUTEX_UNLOCKED == state && rcutils_mutex_try_lock(mutex)) {
+      return;
+    }
+  }
+  // Mark the mutex as waited for, so that unlocking it wakes a thread, and sleep until it's
+  // unlocked; locking it this way keeps the mark, as other threads may still be waiting
+  rcutils_atomic_exchange_explicit(
+    LOCK_ATOMIC(&mutex->state), state, MUTEX_LOCKED_WAITING, memory_order_acquire);
+  while (MUTEX_UNLOCKED != state) {
+    _mutex_wait(mutex);
+    rcutils_atomic_exchange_explicit(
+      LOCK_ATOMIC(&mutex->state), state, MUTEX_LOCKED_WAITING, memory_order_acquire);
+  }
+}
+
+void
+rcutils_mutex_lock(rcutils_mutex_t * mutex)
+{
+  if (!rcutils_mutex_try_lock(mutex)) {
+    _mutex_lock_contended(mutex);
+  }
+}
+
+bool
+rcutils_mutex_try_lock(rcutils_mutex_t * mutex)
+{
+  uint32_t expected = MUTEX_UNLOCKED;
+  bool locked;
+  rcutils_atomic_compare_exchange_strong_explicit(
+    LOCK_ATOMIC(&mutex->state), locked, &expected, MUTEX_LOCKED,
+    memory_order_acquire, memory_order_relaxed);
+  return locked;
+}
+
+void
+rcutils_mutex_unlock(rcutils_mutex_t * mutex)
+{
+  uint32_t state;
+  rcutils_atomic_exchange_explicit(
+    LOCK_ATOMIC(&mutex->state), state, MUTEX_UNLOCKED, memory_order_release);
+  if (MUTEX_LOCKED_WAITING == state) {
+    _mutex_wake_one(mutex);
+  }
+}
+
+rcutils_seqlock_t
+rcutils_get_zero_initialized_seqlock(void)
+{
+  static rcutils_seqlock_t zero_initialized_seqlock = {0u};
+  return zero_initialized_seqlock;
+}
+
+uint32_t
+rcutils_seqlock_read_begin(const rcutils_seqlock_t * lock)
+{
+  uint32_t backoff = 1u;
+  for (;;) {
+    uint32_t sequence;
+    rcutils_atomic_load_explicit(LOCK_ATOMIC(&lock->sequence), sequence, memory_order_acquire);
+    if (0u == (sequence & 1u)) {
+      return sequence;
+    }
+    _backoff(&backoff);
+  }
+}
+
+bool
+rcutils_seqlock_read_retry(const rcutils_seqlock_t * lock, uint32_t sequence)
+{
+  // Keep the reads of the data before the read of the sequence
+  rcutils_atomic_thread_fence(memory_order_acquire);
+  uint32_t current;
+  rcutils_atomic_load_explicit(LOCK_ATOMIC(&lock->sequence), current, memory_order_relaxed);
+  return current != sequence;
+}
+
+void
+rcutils_seqlock_write_lock(rcutils_seqlock_t * lock)
+{
+  uint32_t backoff = 1u;
+  uint32_t sequence;
+  rcutils_atomic_load_explicit(LOCK_ATOMIC(&lock->sequence), sequence, memory_order_relaxed);
+  for (;;) {
+    if (0u == (sequence & 1u)) {
+      bool locked;
+      rcutils_atomic_compare_exchange_weak_explicit(
+        LOCK_ATOMIC(&lock->sequence), locked, &sequence, sequence + 1u,
+        memory_order_acquire, memory_order_relaxed);
+      if (locked) {
+        break;
+      }
+    } else {
+      _backoff(&backoff);
+      rcutils_atomic_load_explicit(LOCK_ATOMIC(&lock->sequence), sequence, memory_order_relaxed);
+    }
+  }
+  // Keep the writes of the data after the sequence is odd
+  rcutils_atomic_thread_fence(memory_order_release);
+}
+
+void
+rcutils_seqlock_write_unlock(rcutils_seqlock_t * lock)
+{
+  // Only the writer holding the lock writes the sequence
+  uint32_t sequence;
+  rcutils_atomic_load_explicit(LOCK_ATOMIC(&lock->sequence), sequence, memory_order_relaxed);
+  rcutils_atomic_store_explicit(
+    LOCK_ATOMIC(&lock->sequence), sequence + 1u, memory_order_release);
+}
+
+// Copy the data protected by a seqlock, which readers copy while it's written, with relaxed
+// atomic loads and stores, so that a copy racing with a write is only torn, and thrown away.
+// Words are copied when the data is aligned the same way at both ends, bytes otherwise.
+static void
+_seqlock_copy(void * destination, const void * source, size_t size)
+{
+  unsigned char * dst = (unsigned char *)destination;
+  const unsigned char * src = (const unsigned char *)source;
+  if (0u == ((uintptr_t)dst - (uintptr_t)src) % sizeof(uint32_t)) {
+    for (; 0u != (uintptr_t)src % sizeof(uint32_t) && size > 0u; ++dst, ++src, --size) {
+      unsigned char byte;
+      rcutils_atomic_load_explicit((atomic_uchar *)src, byte, memory_order_relaxed);
+      rcutils_atomic_store_explicit((atomic_uchar *)dst, byte, memory_order_relaxed);
+    }
+    for (; size >= sizeof(uint32_t); dst += sizeof(uint32_t), src += sizeof(uint32_t),
+      size -= sizeof(uint32_t))
+    {
+      uint32_t word;
+      rcutils_atomic_load_explicit(LOCK_ATOMIC(src), word, memory_order_relaxed);
+      rcutils_atomic_store_explicit(LOCK_ATOMIC(dst), word, memory_order_relaxed);
+    }
+  }
+  for (; size > 0u; ++dst, ++src, --size) {
+    unsigned char byte;
+    rcutils_atomic_load_explicit((atomic_uchar *)src, byte, memory_order_relaxed);
+    rcutils_atomic_store_explicit((atomic_uchar *)dst, byte, memory_order_relaxed);
+  }
+}
+
+void
+rcutils_seqlock_read(
+  const rcutils_seqlock_t * lock, void * destination, const void * source, size_t size)
+{
+  uint32_t sequence;
+  do {
+    sequence = rcutils_seqlock_read_begin(lock);
+    _seqlock_copy(destination, source, size);
+  } while (rcutils_seqlock_read_retry(lock, sequence));
+}
+
+void
+rcutils_seqlock_write(
+  rcutils_seqlock_t * lock, void * destination, const void * source, size_t size)
+{
+  rcutils_seqlock_write_lock(lock);
+  _seqlock_copy(destination, source, size);
+  rcutils_seqlock_write_unlock(lock);
+}
+
+#ifdef __cplusplus
+}
+#endif
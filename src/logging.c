@@ -17,12 +17,14 @@ extern "C"
 {
 #endif
 
+#include <assert.h>
 #include <ctype.h>
 #include <errno.h>
 #include <inttypes.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 
 #ifdef _WIN32
 # include <io.h>
@@ -39,6 +41,7 @@ extern "C"
 # include <windows.h>
 # pragma warning(pop)
 #else
+# include <sys/uio.h>
 # include <unistd.h>
 #endif
 
@@ -47,12 +50,19 @@ extern "C"
 #include "rcutils/error_handling.h"
 #include "rcutils/find.h"
 #include "rcutils/format_string.h"
+#include "rcutils/lock.h"
 #include "rcutils/logging.h"
-#include "rcutils/snprintf.h"
+#include "rcutils/logging_file.h"
+#include "rcutils/logging_statistics.h"
+#include "rcutils/stdatomic_helper.h"
 #include "rcutils/strdup.h"
 #include "rcutils/strerror.h"
+#include "rcutils/thread.h"
 #include "rcutils/time.h"
-#include "rcutils/types/string_map.h"
+#include "rcutils/types/frozen_map.h"
+
+#include "./logging_internal.h"
+#include "./tracepoints.h"
 
 
 #define RCUTILS_LOGGING_SEPARATOR_CHAR '.'
@@ -70,6 +80,9 @@ extern "C"
 #define RCUTILS_LOGGING_STREAM_BUFFER_SIZE (0)
 #endif
 
+// With RCUTILS_LOGGING_STREAM_BUFFER_SIZE set, flush the stream at least this often by default.
+#define RCUTILS_LOGGING_DEFAULT_STREAM_FLUSH_PERIOD_MS (100)
+
 const char * const g_rcutils_log_severity_names[] = {
   [RCUTILS_LOG_SEVERITY_UNSET] = "UNSET",
   [RCUTILS_LOG_SEVERITY_DEBUG] = "DEBUG",
@@ -94,18 +107,451 @@ static const char * g_rcutils_logging_default_output_format =
 
 static rcutils_allocator_t g_rcutils_logging_allocator;
 
+// Parse g_rcutils_logging_output_format_string, so that formatting messages doesn't have to.
+static void rcutils_logging_compile_output_format(void);
+
 rcutils_logging_output_handler_t g_rcutils_logging_output_handler = NULL;
-static rcutils_string_map_t g_rcutils_logging_severities_map;
 
-// If this is false, attempts to use the severities map will be skipped.
-// This can happen if allocation of the map fails at initialization.
+// If this is false, there is no snapshot of the logger levels and they can't be set.
+// This can happen if allocation of the snapshot fails at initialization.
 bool g_rcutils_logging_severities_map_valid = false;
 
 int g_rcutils_logging_default_logger_level = 0;
+int g_rcutils_logging_lowest_enabled_severity = RCUTILS_LOG_SEVERITY_UNSET;
 
 static FILE * g_output_stream = NULL;
 
+// Whether the records are gathered in the buffer of the output stream, see
+// RCUTILS_LOGGING_STREAM_BUFFER_SIZE.
+static bool g_rcutils_logging_stream_batched = false;
+static rcutils_duration_value_t g_rcutils_logging_stream_flush_period = 0;
+// The timestamp of the record after which the output stream was last flushed.
+static atomic_int_least64_t g_rcutils_logging_stream_last_flush = ATOMIC_VAR_INIT(0);
+// Whether the console records are written with writev(), bypassing the output stream, because
+// it would write each of them right away anyway.
+static bool g_rcutils_logging_stream_writev = false;
+
+// Whether the records are timestamped with the coarse system clock, see
+// RCUTILS_LOGGING_COARSE_TIMESTAMPS.
+static bool g_rcutils_logging_coarse_timestamps = false;
+
+// Whether the messages are formatted with rcutils_fast_vsnprintf(), see
+// RCUTILS_LOGGING_FAST_FORMAT.
+static bool g_rcutils_logging_fast_format = false;
+
 enum rcutils_colorized_output g_colorized_output = RCUTILS_COLORIZED_OUTPUT_AUTO;
+// Whether the console records are colorized, resolved from g_colorized_output and the output
+// stream when they are set at initialization, so that logging doesn't query the terminal.
+static bool g_rcutils_logging_output_colorized = false;
+
+// Resolve g_rcutils_logging_output_colorized for the current output stream.
+static bool rcutils_logging_is_output_colorized(void);
+
+// Rate limit and sampling of the messages of a logger, see
+// rcutils_logging_set_logger_rate_limit() and rcutils_logging_set_logger_sampling().
+// Only the counters change once a limiter is published, changing the limits replaces it.
+// Replaced limiters are retired like the snapshots of the logger levels.
+typedef struct rcutils_logging_limiter_t
+{
+  // The time between two messages at the limited rate in nanoseconds, 0 if the rate isn't
+  // limited.
+  int64_t emission_interval;
+  // How far the next arrival time may be ahead of the current time, (burst - 1) times the
+  // emission interval.
+  int64_t tolerance;
+  // The time at which the next message is expected at the limited rate, according to the
+  // generic cell rate algorithm, on the steady clock.
+  atomic_uint_least64_t next_arrival;
+  // Only one in this number of messages is logged, if greater than 1.
+  uint64_t sampling;
+  atomic_uint_least64_t sampling_counter;
+  // The number of messages dropped since the last one which was logged.
+  atomic_uint_least64_t suppressed;
+  // The next retired limiter.
+  struct rcutils_logging_limiter_t * next_retired;
+} rcutils_logging_limiter_t;
+
+// A logger whose level or limits were set.
+typedef struct rcutils_logging_level_entry_t
+{
+  // The name of the logger, or NULL if the entry is free.
+  // The names are owned by the logging system and shared between the snapshots, they are
+  // freed on shutdown.
+  const char * name;
+  size_t name_length;
+  size_t hash;
+  // The severity level set for the logger, or RCUTILS_LOG_SEVERITY_UNSET.
+  int level;
+  // The rate limit and sampling of the logger, or NULL if none is set.
+  rcutils_logging_limiter_t * limiter;
+} rcutils_logging_level_entry_t;
+
+// An immutable snapshot of the logger levels.
+// Readers load the current snapshot from g_rcutils_logging_levels and use it without locking.
+// Writers copy it, change the copy and publish it, starting over if another writer published
+// a snapshot meanwhile.
+// The replaced snapshots are retired rather than freed, as readers may still be using them.
+// Readers hold a snapshot between rcutils_logging_levels_acquire() and
+// rcutils_logging_levels_release(), so the retired ones are freed once no reader holds any,
+// and the remaining ones on shutdown.
+typedef struct rcutils_logging_levels_t
+{
+  // Incremented with each published snapshot, invalidating the levels resolved by logger
+  // handles.
+  // Changing the default logger level doesn't require invalidation, as the resolved levels
+  // don't include it.
+  size_t generation;
+  // The number of used entries.
+  size_t count;
+  // The number of entries with a limiter, so rcutils_log() only looks them up if there are any.
+  size_t limiters_count;
+  // The number of entries, a power of two, at least twice the number of used entries.
+  size_t capacity;
+  // The next retired snapshot.
+  struct rcutils_logging_levels_t * next_retired;
+  // Open addressing hash table with linear probing.
+  rcutils_logging_level_entry_t entries[];
+} rcutils_logging_levels_t;
+
+// The current snapshot of the logger levels (rcutils_logging_levels_t *), or 0 if the logging
+// system isn't initialized or the snapshot couldn't be allocated.
+static atomic_uintptr_t g_rcutils_logging_levels = ATOMIC_VAR_INIT(0);
+// The lists of retired snapshots and limiters, guarded by g_rcutils_logging_retired_mutex.
+static rcutils_logging_levels_t * g_rcutils_logging_retired_levels = NULL;
+static rcutils_logging_limiter_t * g_rcutils_logging_retired_limiters = NULL;
+static rcutils_mutex_t g_rcutils_logging_retired_mutex;
+
+// The number of readers holding a snapshot of the logger levels, spread over cache lines by
+// thread, so that readers of different threads don't contend.
+typedef struct rcutils_logging_levels_readers_t
+{
+  atomic_uint_least64_t count;
+  // Keeps the counts of neighbouring threads on distinct cache lines.
+  uint8_t padding[64 - sizeof(atomic_uint_least64_t)];
+} rcutils_logging_levels_readers_t;
+
+#define RCUTILS_LOGGING_LEVELS_READERS_SIZE (16u)
+static rcutils_logging_levels_readers_t
+  g_rcutils_logging_levels_readers[RCUTILS_LOGGING_LEVELS_READERS_SIZE];
+// The generation of the last snapshot, kept across a shutdown so logger handles don't keep
+// the levels set before it.
+static size_t g_rcutils_logging_levels_generation = 1;
+
+#define RCUTILS_LOGGING_LEVELS_INITIAL_CAPACITY (16u)
+
+// djb2 hash function over the logger name, see rcutils_hash_map_string_hash_func().
+// Hashing continues from the hash of a prefix, starting from 5381.
+static size_t rcutils_logging_level_hash(size_t hash, const char * name, size_t name_length)
+{
+  for (size_t i = 0; i < name_length; ++i) {
+    hash = ((hash << 5) + hash) + (size_t)name[i]; /* hash * 33 + c */
+  }
+  return hash;
+}
+
+// Start reading the current snapshot of the logger levels, or NULL if there is none.
+// The snapshot, and the limiters it refers to, aren't freed until the reader passes the
+// returned index to rcutils_logging_levels_release().
+static rcutils_logging_levels_t * rcutils_logging_levels_acquire(size_t * readers_index)
+{
+  *readers_index = (size_t)(rcutils_thread_get_id() % RCUTILS_LOGGING_LEVELS_READERS_SIZE);
+  // The count is incremented before the snapshot is loaded, so a writer which finds it at 0
+  // after replacing a snapshot knows that no reader can still load the replaced one.
+  rcutils_atomic_fetch_add_uint64_t(&g_rcutils_logging_levels_readers[*readers_index].count, 1u);
+  return (rcutils_logging_levels_t *)rcutils_atomic_load_uintptr_t(&g_rcutils_logging_levels);
+}
+
+static void rcutils_logging_levels_release(size_t readers_index)
+{
+  rcutils_atomic_fetch_sub_uint64_t(&g_rcutils_logging_levels_readers[readers_index].count, 1u);
+}
+
+// Whether no reader holds a snapshot of the logger levels.
+static bool rcutils_logging_levels_unread(void)
+{
+  for (size_t i = 0; i < RCUTILS_LOGGING_LEVELS_READERS_SIZE; ++i) {
+    if (0u != rcutils_atomic_load_uint64_t(&g_rcutils_logging_levels_readers[i].count)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static rcutils_logging_levels_t * rcutils_logging_levels_allocate(size_t capacity)
+{
+  rcutils_allocator_t * allocator = &g_rcutils_logging_allocator;
+  rcutils_logging_levels_t * levels = allocator->zero_allocate(
+    1, sizeof(rcutils_logging_levels_t) + capacity * sizeof(rcutils_logging_level_entry_t),
+    allocator->state);
+  if (NULL != levels) {
+    levels->capacity = capacity;
+  }
+  return levels;
+}
+
+// Find the entry of a logger, or the free entry it would be stored in.
+static rcutils_logging_level_entry_t * rcutils_logging_levels_find(
+  const rcutils_logging_levels_t * levels, const char * name, size_t name_length, size_t hash)
+{
+  const size_t mask = levels->capacity - 1u;
+  for (size_t i = hash & mask;; i = (i + 1u) & mask) {
+    const rcutils_logging_level_entry_t * entry = &levels->entries[i];
+    if (NULL == entry->name ||
+      (entry->hash == hash && entry->name_length == name_length &&
+      0 == memcmp(entry->name, name, name_length)))
+    {
+      return (rcutils_logging_level_entry_t *)entry;
+    }
+  }
+}
+
+// Copy a snapshot into a new one of the next generation, with room for one more entry.
+static rcutils_logging_levels_t * rcutils_logging_levels_copy(
+  const rcutils_logging_levels_t * levels)
+{
+  size_t capacity = levels->capacity;
+  if (2u * (levels->count + 1u) > capacity) {
+    capacity *= 2u;
+  }
+  rcutils_logging_levels_t * copy = rcutils_logging_levels_allocate(capacity);
+  if (NULL == copy) {
+    return NULL;
+  }
+  copy->generation = levels->generation + 1u;
+  copy->count = levels->count;
+  copy->limiters_count = levels->limiters_count;
+  for (size_t i = 0; i < levels->capacity; ++i) {
+    const rcutils_logging_level_entry_t * entry = &levels->entries[i];
+    if (NULL != entry->name) {
+      *rcutils_logging_levels_find(copy, entry->name, entry->name_length, entry->hash) = *entry;
+    }
+  }
+  return copy;
+}
+
+// A change of the settings of a logger, see rcutils_logging_levels_update().
+typedef struct rcutils_logging_level_update_t
+{
+  bool set_level;
+  int level;
+  bool set_rate_limit;
+  int64_t emission_interval;
+  int64_t tolerance;
+  bool set_sampling;
+  uint64_t sampling;
+} rcutils_logging_level_update_t;
+
+// Create the limiter replacing the given one, or a new one if NULL, with the update applied.
+static rcutils_logging_limiter_t * rcutils_logging_limiter_update(
+  const rcutils_logging_limiter_t * limiter, const rcutils_logging_level_update_t * update)
+{
+  rcutils_allocator_t * allocator = &g_rcutils_logging_allocator;
+  rcutils_logging_limiter_t * updated =
+    allocator->zero_allocate(1, sizeof(rcutils_logging_limiter_t), allocator->state);
+  if (NULL == updated) {
+    return NULL;
+  }
+  uint64_t next_arrival = 0;
+  uint64_t sampling_counter = 0;
+  uint64_t suppressed = 0;
+  if (NULL != limiter) {
+    updated->emission_interval = limiter->emission_interval;
+    updated->tolerance = limiter->tolerance;
+    updated->sampling = limiter->sampling;
+    // The counters aren't changed through the old limiter after this, except by readers
+    // still using it, whose updates are lost.
+    next_arrival =
+      rcutils_atomic_load_uint64_t((atomic_uint_least64_t *)&limiter->next_arrival);
+    sampling_counter =
+      rcutils_atomic_load_uint64_t((atomic_uint_least64_t *)&limiter->sampling_counter);
+    suppressed = rcutils_atomic_load_uint64_t((atomic_uint_least64_t *)&limiter->suppressed);
+  }
+  if (update->set_rate_limit) {
+    updated->emission_interval = update->emission_interval;
+    updated->tolerance = update->tolerance;
+    next_arrival = 0;
+  }
+  if (update->set_sampling) {
+    updated->sampling = update->sampling;
+    sampling_counter = 0;
+  }
+  rcutils_atomic_store(&updated->next_arrival, next_arrival);
+  rcutils_atomic_store(&updated->sampling_counter, sampling_counter);
+  rcutils_atomic_store(&updated->suppressed, suppressed);
+  return updated;
+}
+
+// Retire a replaced snapshot, and the limiter replaced with it if any, and free all the retired
+// ones if no reader holds a snapshot anymore.
+// The caller must not hold a snapshot, and must have published the one replacing them.
+static void rcutils_logging_retire(
+  rcutils_logging_levels_t * levels, rcutils_logging_limiter_t * limiter)
+{
+  rcutils_allocator_t * allocator = &g_rcutils_logging_allocator;
+  rcutils_mutex_lock(&g_rcutils_logging_retired_mutex);
+  levels->next_retired = g_rcutils_logging_retired_levels;
+  g_rcutils_logging_retired_levels = levels;
+  if (NULL != limiter) {
+    limiter->next_retired = g_rcutils_logging_retired_limiters;
+    g_rcutils_logging_retired_limiters = limiter;
+  }
+  // The retired snapshots were all replaced before the counts are read, so readers starting
+  // later load a current one; if readers are counted, they're kept until a later retirement.
+  rcutils_logging_levels_t * unused_levels = NULL;
+  rcutils_logging_limiter_t * unused_limiters = NULL;
+  if (rcutils_logging_levels_unread()) {
+    unused_levels = g_rcutils_logging_retired_levels;
+    g_rcutils_logging_retired_levels = NULL;
+    unused_limiters = g_rcutils_logging_retired_limiters;
+    g_rcutils_logging_retired_limiters = NULL;
+  }
+  rcutils_mutex_unlock(&g_rcutils_logging_retired_mutex);
+  while (NULL != unused_levels) {
+    rcutils_logging_levels_t * next = unused_levels->next_retired;
+    allocator->deallocate(unused_levels, allocator->state);
+    unused_levels = next;
+  }
+  while (NULL != unused_limiters) {
+    rcutils_logging_limiter_t * next = unused_limiters->next_retired;
+    allocator->deallocate(unused_limiters, allocator->state);
+    unused_limiters = next;
+  }
+}
+
+// Publish a snapshot of the logger levels in which the settings of a logger are updated.
+static rcutils_ret_t rcutils_logging_levels_update(
+  const char * name, size_t name_length, const rcutils_logging_level_update_t * update)
+{
+  rcutils_allocator_t * allocator = &g_rcutils_logging_allocator;
+  const size_t hash = rcutils_logging_level_hash(5381, name, name_length);
+  // The copy of the name, if the logger isn't in the snapshots yet.
+  char * name_copy = NULL;
+  rcutils_ret_t ret = RCUTILS_RET_BAD_ALLOC;
+  // The snapshots copied are held like readers do, as other writers may retire them.
+  size_t readers_index;
+  uintptr_t current = (uintptr_t)rcutils_logging_levels_acquire(&readers_index);
+  for (;;) {
+    const rcutils_logging_levels_t * levels = (const rcutils_logging_levels_t *)current;
+    if (NULL == levels) {
+      RCUTILS_SET_ERROR_MSG("Logger severity level map is invalid");
+      ret = RCUTILS_RET_LOGGING_SEVERITY_MAP_INVALID;
+      break;
+    }
+    rcutils_logging_levels_t * updated = rcutils_logging_levels_copy(levels);
+    if (NULL == updated) {
+      RCUTILS_SET_ERROR_MSG("Failed to allocate memory for logger levels");
+      break;
+    }
+    rcutils_logging_level_entry_t * entry =
+      rcutils_logging_levels_find(updated, name, name_length, hash);
+    if (NULL == entry->name) {
+      if (NULL == name_copy) {
+        name_copy = rcutils_strndup(name, name_length, *allocator);
+        if (NULL == name_copy) {
+          RCUTILS_SET_ERROR_MSG("Failed to allocate memory for logger name");
+          allocator->deallocate(updated, allocator->state);
+          break;
+        }
+      }
+      entry->name = name_copy;
+      entry->name_length = name_length;
+      entry->hash = hash;
+      entry->level = RCUTILS_LOG_SEVERITY_UNSET;
+      entry->limiter = NULL;
+      ++updated->count;
+    }
+    rcutils_logging_limiter_t * limiter = entry->limiter;
+    if (update->set_level) {
+      entry->level = update->level;
+    }
+    if (update->set_rate_limit || update->set_sampling) {
+      entry->limiter = rcutils_logging_limiter_update(limiter, update);
+      if (NULL == entry->limiter) {
+        RCUTILS_SET_ERROR_MSG("Failed to allocate memory for logger limiter");
+        allocator->deallocate(updated, allocator->state);
+        break;
+      }
+      if (NULL == limiter) {
+        ++updated->limiters_count;
+      }
+    }
+
+    // On failure, current is updated to the snapshot another writer published.
+    if (rcutils_atomic_compare_exchange_strong_uintptr_t(
+        &g_rcutils_logging_levels, &current, (uintptr_t)updated))
+    {
+      // The published snapshot may be retired by another writer once released.
+      bool name_copied = entry->name == name_copy;
+      rcutils_logging_limiter_t * replaced_limiter = entry->limiter != limiter ? limiter : NULL;
+      rcutils_logging_levels_release(readers_index);
+      rcutils_logging_retire((rcutils_logging_levels_t *)levels, replaced_limiter);
+      if (NULL != name_copy && !name_copied) {
+        // Another writer added the logger meanwhile.
+        allocator->deallocate(name_copy, allocator->state);
+      }
+      if (update->set_level) {
+        rcutils_logging_update_lowest_enabled_severity();
+      }
+      return RCUTILS_RET_OK;
+    }
+    if (entry->limiter != limiter) {
+      allocator->deallocate(entry->limiter, allocator->state);
+    }
+    allocator->deallocate(updated, allocator->state);
+  }
+  rcutils_logging_levels_release(readers_index);
+  if (NULL != name_copy) {
+    allocator->deallocate(name_copy, allocator->state);
+  }
+  return ret;
+}
+
+void rcutils_logging_update_lowest_enabled_severity(void)
+{
+  // Serializes the updates, so that the last one sees the levels set before all of them.
+  static rcutils_mutex_t mutex;
+  rcutils_mutex_lock(&mutex);
+  int lowest = RCUTILS_LOGGING_LOAD_LEVEL(g_rcutils_logging_default_logger_level);
+  size_t readers_index;
+  const rcutils_logging_levels_t * levels = rcutils_logging_levels_acquire(&readers_index);
+  if (!g_rcutils_logging_initialized || g_rcutils_logging_statistics_enabled) {
+    lowest = RCUTILS_LOG_SEVERITY_UNSET;
+  } else if (NULL != levels) {
+    for (size_t i = 0; i < levels->capacity; ++i) {
+      const rcutils_logging_level_entry_t * entry = &levels->entries[i];
+      if (NULL != entry->name && RCUTILS_LOG_SEVERITY_UNSET != entry->level &&
+        entry->level < lowest)
+      {
+        lowest = entry->level;
+      }
+    }
+  }
+  if (g_rcutils_logging_flight_recorder_severity < lowest) {
+    lowest = g_rcutils_logging_flight_recorder_severity;
+  }
+  rcutils_logging_levels_release(readers_index);
+  RCUTILS_LOGGING_STORE_LEVEL(g_rcutils_logging_lowest_enabled_severity, lowest);
+  rcutils_mutex_unlock(&mutex);
+}
+
+// Free a snapshot, and if it is the current one the names and limiters it refers to; those of
+// the retired snapshots are either referred to by the current one or retired themselves.
+static void rcutils_logging_levels_fini(rcutils_logging_levels_t * levels, bool owns_names)
+{
+  rcutils_allocator_t * allocator = &g_rcutils_logging_allocator;
+  if (owns_names) {
+    for (size_t i = 0; i < levels->capacity; ++i) {
+      rcutils_logging_level_entry_t * entry = &levels->entries[i];
+      if (NULL != entry->name) {
+        allocator->deallocate((char *)entry->name, allocator->state);
+        if (NULL != entry->limiter) {
+          allocator->deallocate(entry->limiter, allocator->state);
+        }
+      }
+    }
+  }
+  allocator->deallocate(levels, allocator->state);
+}
 
 rcutils_ret_t rcutils_logging_initialize(void)
 {
@@ -157,6 +603,41 @@ static enum rcutils_get_env_retval rcutils_get_env_var_zero_or_one(
   return RCUTILS_GET_ENV_ERROR;
 }
 
+// A utility function to get a non-negative integer from an environment variable.
+// Returns RCUTILS_RET_INVALID_ARGUMENT if we failed to get the environment variable or if it
+// isn't a number, otherwise is_set tells whether the environment variable is set and not empty.
+static rcutils_ret_t rcutils_get_env_var_size(const char * name, size_t * value, bool * is_set)
+{
+  const char * env_var_value = NULL;
+  const char * ret_str = rcutils_get_env(name, &env_var_value);
+  if (NULL != ret_str) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "Error getting environment variable %s: %s", name,
+      ret_str);
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+
+  *is_set = strcmp(env_var_value, "") != 0;
+  if (!*is_set) {
+    return RCUTILS_RET_OK;
+  }
+
+  char * end = NULL;
+  errno = 0;
+  unsigned long long parsed = strtoull(env_var_value, &end, 10);  // NOLINT(runtime/int)
+  if (!isdigit((unsigned char)env_var_value[0]) || '\0' != *end || 0 != errno ||
+    parsed > SIZE_MAX)
+  {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "Warning: unexpected value [%s] specified for %s. "
+      "Valid values are non-negative integers.",
+      env_var_value, name);
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  *value = (size_t)parsed;
+  return RCUTILS_RET_OK;
+}
+
 rcutils_ret_t rcutils_logging_initialize_with_allocator(rcutils_allocator_t allocator)
 {
   rcutils_ret_t ret = RCUTILS_RET_OK;
@@ -168,7 +649,8 @@ rcutils_ret_t rcutils_logging_initialize_with_allocator(rcutils_allocator_t allo
     g_rcutils_logging_allocator = allocator;
 
     g_rcutils_logging_output_handler = &rcutils_logging_console_output_handler;
-    g_rcutils_logging_default_logger_level = RCUTILS_DEFAULT_LOGGER_DEFAULT_LEVEL;
+    RCUTILS_LOGGING_STORE_LEVEL(
+      g_rcutils_logging_default_logger_level, RCUTILS_DEFAULT_LOGGER_DEFAULT_LEVEL);
 
     const char * line_buffered = NULL;
     const char * ret_str = rcutils_get_env("RCUTILS_CONSOLE_STDOUT_LINE_BUFFERED", &line_buffered);
@@ -217,6 +699,8 @@ rcutils_ret_t rcutils_logging_initialize_with_allocator(rcutils_allocator_t allo
     if (RCUTILS_GET_ENV_ERROR == retval) {
       return RCUTILS_RET_INVALID_ARGUMENT;
     }
+    // By default, stderr is unbuffered and stdout is line buffered on a terminal.
+    bool stream_writes_each_record = RCUTILS_GET_ENV_EMPTY != retval || g_output_stream == stderr;
     if (RCUTILS_GET_ENV_ZERO == retval || RCUTILS_GET_ENV_ONE == retval) {
       int mode = retval == RCUTILS_GET_ENV_ZERO ? _IONBF : _IOLBF;
       size_t buffer_size = (mode == _IOLBF) ? RCUTILS_LOGGING_STREAM_BUFFER_SIZE : 0;
@@ -235,6 +719,61 @@ rcutils_ret_t rcutils_logging_initialize_with_allocator(rcutils_allocator_t allo
       return RCUTILS_RET_ERROR;
     }
 
+    // Allow the user to gather records in a larger buffer, written when it is full, when a
+    // record of severity WARN or higher is logged, or when a record is logged more than
+    // RCUTILS_LOGGING_STREAM_FLUSH_PERIOD_MS after the last time the stream was flushed.
+    size_t stream_buffer_size = 0;
+    bool stream_buffer_size_is_set = false;
+    if (rcutils_get_env_var_size(
+        "RCUTILS_LOGGING_STREAM_BUFFER_SIZE", &stream_buffer_size,
+        &stream_buffer_size_is_set) != RCUTILS_RET_OK)
+    {
+      return RCUTILS_RET_INVALID_ARGUMENT;
+    }
+    size_t flush_period_ms = RCUTILS_LOGGING_DEFAULT_STREAM_FLUSH_PERIOD_MS;
+    bool flush_period_is_set = false;
+    if (rcutils_get_env_var_size(
+        "RCUTILS_LOGGING_STREAM_FLUSH_PERIOD_MS", &flush_period_ms,
+        &flush_period_is_set) != RCUTILS_RET_OK)
+    {
+      return RCUTILS_RET_INVALID_ARGUMENT;
+    }
+    g_rcutils_logging_stream_batched = false;
+    if (stream_buffer_size_is_set && stream_buffer_size > 0) {
+      if (setvbuf(g_output_stream, NULL, _IOFBF, stream_buffer_size) != 0) {
+        char error_string[1024];
+        rcutils_strerror(error_string, sizeof(error_string));
+        RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+          "Error setting stream buffer size: %s", error_string);
+        return RCUTILS_RET_ERROR;
+      }
+      g_rcutils_logging_stream_batched = true;
+      g_rcutils_logging_stream_flush_period = RCUTILS_MS_TO_NS((int64_t)flush_period_ms);
+      rcutils_atomic_store(&g_rcutils_logging_stream_last_flush, (int64_t)0);
+    }
+#ifndef _WIN32
+    g_rcutils_logging_stream_writev = !g_rcutils_logging_stream_batched &&
+      (stream_writes_each_record || isatty(fileno(g_output_stream)));
+#else
+    (void)stream_writes_each_record;
+#endif
+
+    // Allow the user to trade the resolution of the timestamps for cheaper ones.
+    retval = rcutils_get_env_var_zero_or_one(
+      "RCUTILS_LOGGING_COARSE_TIMESTAMPS", "precise timestamps", "coarse timestamps");
+    if (RCUTILS_GET_ENV_ERROR == retval) {
+      return RCUTILS_RET_INVALID_ARGUMENT;
+    }
+    g_rcutils_logging_coarse_timestamps = RCUTILS_GET_ENV_ONE == retval;
+
+    // Allow the user to format the messages without the C library for the common conversions.
+    retval = rcutils_get_env_var_zero_or_one(
+      "RCUTILS_LOGGING_FAST_FORMAT", "C library formatting", "fast formatting");
+    if (RCUTILS_GET_ENV_ERROR == retval) {
+      return RCUTILS_RET_INVALID_ARGUMENT;
+    }
+    g_rcutils_logging_fast_format = RCUTILS_GET_ENV_ONE == retval;
+
     retval = rcutils_get_env_var_zero_or_one(
       "RCUTILS_COLORIZED_OUTPUT", "force color",
       "force no color");
@@ -255,6 +794,7 @@ rcutils_ret_t rcutils_logging_initialize_with_allocator(rcutils_allocator_t allo
           "Invalid return from environment fetch");
         return RCUTILS_RET_ERROR;
     }
+    g_rcutils_logging_output_colorized = rcutils_logging_is_output_colorized();
 
     // Check for the environment variable for custom output formatting
     const char * output_format;
@@ -277,22 +817,23 @@ rcutils_ret_t rcutils_logging_initialize_with_allocator(rcutils_allocator_t allo
         g_rcutils_logging_output_format_string, g_rcutils_logging_default_output_format,
         strlen(g_rcutils_logging_default_output_format) + 1);
     }
+    rcutils_logging_compile_output_format();
 
-    g_rcutils_logging_severities_map = rcutils_get_zero_initialized_string_map();
-    rcutils_ret_t string_map_ret = rcutils_string_map_init(
-      &g_rcutils_logging_severities_map, 0, g_rcutils_logging_allocator);
-    if (string_map_ret != RCUTILS_RET_OK) {
-      // If an error message was set it will have been overwritten by rcutils_string_map_init.
-      RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
-        "Failed to initialize map for logger severities [%s]. Severities will not be configurable.",
-        rcutils_get_error_string().str);
+    rcutils_logging_levels_t * levels =
+      rcutils_logging_levels_allocate(RCUTILS_LOGGING_LEVELS_INITIAL_CAPACITY);
+    if (NULL == levels) {
+      RCUTILS_SET_ERROR_MSG(
+        "Failed to allocate memory for logger severities. Severities will not be configurable.");
       g_rcutils_logging_severities_map_valid = false;
-      ret = RCUTILS_RET_STRING_MAP_INVALID;
+      ret = RCUTILS_RET_LOGGING_SEVERITY_MAP_INVALID;
     } else {
+      levels->generation = ++g_rcutils_logging_levels_generation;
+      rcutils_atomic_store(&g_rcutils_logging_levels, (uintptr_t)levels);
       g_rcutils_logging_severities_map_valid = true;
     }
 
     g_rcutils_logging_initialized = true;
+    rcutils_logging_update_lowest_enabled_severity();
   }
   return ret;
 }
@@ -304,19 +845,46 @@ rcutils_ret_t rcutils_logging_shutdown(void)
   }
   rcutils_ret_t ret = RCUTILS_RET_OK;
   if (g_rcutils_logging_severities_map_valid) {
-    rcutils_ret_t string_map_ret = rcutils_string_map_fini(&g_rcutils_logging_severities_map);
-    if (string_map_ret != RCUTILS_RET_OK) {
-      RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
-        "Failed to finalize map for logger severities: %s",
-        rcutils_get_error_string().str);
-      ret = RCUTILS_RET_LOGGING_SEVERITY_MAP_INVALID;
+    rcutils_logging_levels_t * levels = (rcutils_logging_levels_t *)
+      rcutils_atomic_exchange_uintptr_t(&g_rcutils_logging_levels, (uintptr_t)0);
+    g_rcutils_logging_levels_generation = levels->generation;
+    rcutils_logging_levels_fini(levels, true);
+    rcutils_mutex_lock(&g_rcutils_logging_retired_mutex);
+    levels = g_rcutils_logging_retired_levels;
+    g_rcutils_logging_retired_levels = NULL;
+    rcutils_logging_limiter_t * limiter = g_rcutils_logging_retired_limiters;
+    g_rcutils_logging_retired_limiters = NULL;
+    rcutils_mutex_unlock(&g_rcutils_logging_retired_mutex);
+    while (NULL != levels) {
+      rcutils_logging_levels_t * next = levels->next_retired;
+      rcutils_logging_levels_fini(levels, false);
+      levels = next;
+    }
+    rcutils_allocator_t * allocator = &g_rcutils_logging_allocator;
+    while (NULL != limiter) {
+      rcutils_logging_limiter_t * next = limiter->next_retired;
+      allocator->deallocate(limiter, allocator->state);
+      limiter = next;
     }
     g_rcutils_logging_severities_map_valid = false;
   }
+  if (g_rcutils_logging_stream_batched) {
+    fflush(g_output_stream);
+    g_rcutils_logging_stream_batched = false;
+  }
+  // Logger handles must not keep the levels set before the shutdown.
+  ++g_rcutils_logging_levels_generation;
   g_rcutils_logging_initialized = false;
+  rcutils_logging_update_lowest_enabled_severity();
   return ret;
 }
 
+// Fold an ASCII letter to upper case, whatever the locale.
+static inline char rcutils_logging_ascii_upper(char c)
+{
+  return c >= 'a' && c <= 'z' ? (char)(c - 'a' + 'A') : c;
+}
+
 rcutils_ret_t
 rcutils_logging_severity_level_from_string(
   const char * severity_string, rcutils_allocator_t allocator, int * severity)
@@ -324,34 +892,60 @@ rcutils_logging_severity_level_from_string(
   RCUTILS_CHECK_ALLOCATOR_WITH_MSG(
     &allocator, "invalid allocator", return RCUTILS_RET_INVALID_ARGUMENT);
   RCUTILS_CHECK_ARGUMENT_FOR_NULL(severity_string, RCUTILS_RET_INVALID_ARGUMENT);
-  RCUTILS_CHECK_ARGUMENT_FOR_NULL(severity, RCUTILS_RET_INVALID_ARGUMENT);
 
-  rcutils_ret_t ret = RCUTILS_RET_LOGGING_SEVERITY_STRING_INVALID;
+  return rcutils_logging_severity_level_from_stringn(
+    severity_string, strlen(severity_string), severity);
+}
+
+rcutils_ret_t
+rcutils_logging_severity_level_from_stringn(
+  const char * severity_string, size_t length, int * severity)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(severity_string, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(severity, RCUTILS_RET_INVALID_ARGUMENT);
 
-  // Convert the input string to upper case (for case insensitivity).
-  char * severity_string_upper = rcutils_strdup(severity_string, allocator);
-  if (NULL == severity_string_upper) {
-    RCUTILS_SET_ERROR_MSG("failed to allocate memory for uppercase string");
-    return RCUTILS_RET_BAD_ALLOC;
+  // The names differ by their length and first letter, which select the only candidate.
+  int candidate = -1;
+  if (4u == length) {
+    switch (rcutils_logging_ascii_upper(severity_string[0])) {
+      case 'I':
+        candidate = RCUTILS_LOG_SEVERITY_INFO;
+        break;
+      case 'W':
+        candidate = RCUTILS_LOG_SEVERITY_WARN;
+        break;
+      default:
+        break;
+    }
+  } else if (5u == length) {
+    switch (rcutils_logging_ascii_upper(severity_string[0])) {
+      case 'U':
+        candidate = RCUTILS_LOG_SEVERITY_UNSET;
+        break;
+      case 'D':
+        candidate = RCUTILS_LOG_SEVERITY_DEBUG;
+        break;
+      case 'E':
+        candidate = RCUTILS_LOG_SEVERITY_ERROR;
+        break;
+      case 'F':
+        candidate = RCUTILS_LOG_SEVERITY_FATAL;
+        break;
+      default:
+        break;
+    }
   }
-  for (int i = 0; severity_string_upper[i]; ++i) {
-    severity_string_upper[i] = (char)toupper(severity_string_upper[i]);
+  if (-1 == candidate) {
+    return RCUTILS_RET_LOGGING_SEVERITY_STRING_INVALID;
   }
-
-  // Determine the severity value matching the severity name.
-  for (size_t i = 0;
-    i < sizeof(g_rcutils_log_severity_names) / sizeof(g_rcutils_log_severity_names[0]);
-    ++i)
-  {
-    const char * severity_string_i = g_rcutils_log_severity_names[i];
-    if (severity_string_i && strcmp(severity_string_i, severity_string_upper) == 0) {
-      *severity = (enum RCUTILS_LOG_SEVERITY)i;
-      ret = RCUTILS_RET_OK;
-      break;
+  const char * name = g_rcutils_log_severity_names[candidate];
+  for (size_t i = 1u; i < length; ++i) {
+    if (rcutils_logging_ascii_upper(severity_string[i]) != name[i]) {
+      return RCUTILS_RET_LOGGING_SEVERITY_STRING_INVALID;
     }
   }
-  allocator.deallocate(severity_string_upper, allocator.state);
-  return ret;
+  *severity = candidate;
+  return RCUTILS_RET_OK;
 }
 
 rcutils_logging_output_handler_t rcutils_logging_get_output_handler(void)
@@ -369,7 +963,7 @@ void rcutils_logging_set_output_handler(rcutils_logging_output_handler_t functio
 int rcutils_logging_get_default_logger_level(void)
 {
   RCUTILS_LOGGING_AUTOINIT;
-  return g_rcutils_logging_default_logger_level;
+  return RCUTILS_LOGGING_LOAD_LEVEL(g_rcutils_logging_default_logger_level);
 }
 
 void rcutils_logging_set_default_logger_level(int level)
@@ -379,7 +973,8 @@ void rcutils_logging_set_default_logger_level(int level)
     // Restore the default
     level = RCUTILS_DEFAULT_LOGGER_DEFAULT_LEVEL;
   }
-  g_rcutils_logging_default_logger_level = level;
+  RCUTILS_LOGGING_STORE_LEVEL(g_rcutils_logging_default_logger_level, level);
+  rcutils_logging_update_lowest_enabled_severity();
 }
 
 int rcutils_logging_get_logger_level(const char * name)
@@ -398,35 +993,105 @@ int rcutils_logging_get_logger_leveln(const char * name, size_t name_length)
     return -1;
   }
 
-  // Skip the map lookup if the default was requested,
-  // as it can still be used even if the severity map is invalid.
+  // Skip the lookup if the default was requested,
+  // as it can still be used even if there are no logger levels.
   if (0 == name_length) {
-    return g_rcutils_logging_default_logger_level;
+    return RCUTILS_LOGGING_LOAD_LEVEL(g_rcutils_logging_default_logger_level);
   }
-  if (!g_rcutils_logging_severities_map_valid) {
-    return RCUTILS_LOG_SEVERITY_UNSET;
+  size_t readers_index;
+  const rcutils_logging_levels_t * levels = rcutils_logging_levels_acquire(&readers_index);
+  int level = RCUTILS_LOG_SEVERITY_UNSET;
+  if (NULL != levels) {
+    const rcutils_logging_level_entry_t * entry = rcutils_logging_levels_find(
+      levels, name, name_length, rcutils_logging_level_hash(5381, name, name_length));
+    if (NULL != entry->name) {
+      level = entry->level;
+    }
   }
+  rcutils_logging_levels_release(readers_index);
+  return level;
+}
 
-  // TODO(dhood): replace string map with int map.
-  const char * severity_string = rcutils_string_map_getn(
-    &g_rcutils_logging_severities_map, name, name_length);
-  if (NULL == severity_string) {
-    if (rcutils_string_map_key_existsn(&g_rcutils_logging_severities_map, name, name_length)) {
-      // The level has been specified but couldn't be retrieved.
-      return -1;
+// Resolve the level of a logger from its own level or the level of its closest ancestor.
+// Returns RCUTILS_LOG_SEVERITY_UNSET if neither has a level set.
+static int rcutils_logging_resolve_logger_level(
+  const rcutils_logging_levels_t * levels, const char * name)
+{
+  int resolved_level = RCUTILS_LOG_SEVERITY_UNSET;
+  if (NULL == levels || 0 == levels->count) {
+    return resolved_level;
+  }
+  // The hash of each ancestor is the one of a prefix of the name, so a single pass over the
+  // name looks them all up, the closest ancestor with a level set being the last one found.
+  // An empty prefix refers to the default logger level, which isn't part of the resolved level.
+  size_t hash = 5381;
+  size_t prefix_length = 0;
+  for (;;) {
+    size_t length = prefix_length;
+    while ('\0' != name[length] && RCUTILS_LOGGING_SEPARATOR_CHAR != name[length]) {
+      ++length;
     }
-    return RCUTILS_LOG_SEVERITY_UNSET;
+    hash = rcutils_logging_level_hash(hash, name + prefix_length, length - prefix_length);
+    if (0 != length) {
+      const rcutils_logging_level_entry_t * entry =
+        rcutils_logging_levels_find(levels, name, length, hash);
+      if (NULL != entry->name && RCUTILS_LOG_SEVERITY_UNSET != entry->level) {
+        resolved_level = entry->level;
+      }
+    }
+    if ('\0' == name[length]) {
+      return resolved_level;
+    }
+    // Continue with the descendant, including the separator.
+    hash = rcutils_logging_level_hash(hash, name + length, 1u);
+    prefix_length = length + 1u;
   }
+}
 
-  int severity;
-  rcutils_ret_t ret = rcutils_logging_severity_level_from_string(
-    severity_string, g_rcutils_logging_allocator, &severity);
-  if (RCUTILS_RET_OK != ret) {
-    RCUTILS_SAFE_FWRITE_TO_STDERR_WITH_FORMAT_STRING(
-      "Logger has an invalid severity level: %s\n", severity_string);
-    return -1;
+// Each thread remembers the levels it resolved last, with the generation of the snapshot they
+// were resolved from, so that resolving the level of the same logger again only costs comparing
+// its name, rather than looking up each of its ancestors.
+// The entries are chosen by the address of the name, and the name is copied, as the address
+// may be reused for another name.
+#define RCUTILS_LOGGING_RESOLVED_LEVELS_SIZE (8u)
+
+typedef struct rcutils_logging_resolved_level_t
+{
+  // The generation of the snapshot the level was resolved from, 0 if the entry is unused.
+  size_t generation;
+  const char * name_address;
+  int resolved_level;
+  // The name, only names shorter than this are remembered.
+  char name[64];
+} rcutils_logging_resolved_level_t;
+
+static RCUTILS_THREAD_LOCAL rcutils_logging_resolved_level_t
+  gtls_rcutils_logging_resolved_levels[RCUTILS_LOGGING_RESOLVED_LEVELS_SIZE];
+
+// Resolve the level of a logger like rcutils_logging_resolve_logger_level(), from the levels
+// this thread remembers if it resolved it from the same snapshot.
+static int rcutils_logging_resolve_cached_logger_level(
+  const rcutils_logging_levels_t * levels, const char * name)
+{
+  if (NULL == levels || 0 == levels->count) {
+    return RCUTILS_LOG_SEVERITY_UNSET;
+  }
+  rcutils_logging_resolved_level_t * cached = &gtls_rcutils_logging_resolved_levels[
+    ((uintptr_t)name >> 3) % RCUTILS_LOGGING_RESOLVED_LEVELS_SIZE];
+  if (cached->generation == levels->generation && cached->name_address == name &&
+    0 == strcmp(cached->name, name))
+  {
+    return cached->resolved_level;
   }
-  return severity;
+  int resolved_level = rcutils_logging_resolve_logger_level(levels, name);
+  size_t name_length = strlen(name);
+  if (name_length < sizeof(cached->name)) {
+    memcpy(cached->name, name, name_length + 1u);
+    cached->name_address = name;
+    cached->resolved_level = resolved_level;
+    cached->generation = levels->generation;
+  }
+  return resolved_level;
 }
 
 int rcutils_logging_get_logger_effective_level(const char * name)
@@ -435,30 +1100,137 @@ int rcutils_logging_get_logger_effective_level(const char * name)
   if (NULL == name) {
     return -1;
   }
-  size_t substring_length = strlen(name);
-  while (true) {
-    int severity = rcutils_logging_get_logger_leveln(name, substring_length);
-    if (-1 == severity) {
-      RCUTILS_SAFE_FWRITE_TO_STDERR_WITH_FORMAT_STRING(
-        "Error getting effective level of logger '%s'\n", name);
-      return -1;
-    }
-    if (severity != RCUTILS_LOG_SEVERITY_UNSET) {
-      return severity;
-    }
-    // Determine the next ancestor's FQN by removing the child's name.
-    size_t index_last_separator = rcutils_find_lastn(
-      name, RCUTILS_LOGGING_SEPARATOR_CHAR, substring_length);
-    if (SIZE_MAX == index_last_separator) {
-      // There are no more separators in the substring.
-      // The name we just checked was the last that we needed to, and it was unset.
-      break;
+  size_t readers_index;
+  const rcutils_logging_levels_t * levels = rcutils_logging_levels_acquire(&readers_index);
+  int resolved_level = rcutils_logging_resolve_cached_logger_level(levels, name);
+  rcutils_logging_levels_release(readers_index);
+  if (RCUTILS_LOG_SEVERITY_UNSET == resolved_level) {
+    // Neither the logger nor its ancestors have had their level specified.
+    return RCUTILS_LOGGING_LOAD_LEVEL(g_rcutils_logging_default_logger_level);
+  }
+  return resolved_level;
+}
+
+rcutils_logger_t rcutils_get_zero_initialized_logger(void)
+{
+  static rcutils_logger_t zero_initialized_logger = {NULL, 0u};
+  return zero_initialized_logger;
+}
+
+// The fields of a logger handle are only accessed atomically, as the handle of a logging macro
+// call site is shared by the threads logging there, so they are treated as the atomic types.
+static_assert(
+  sizeof(atomic_uint_least64_t) == sizeof(uint64_t) &&
+  sizeof(atomic_uintptr_t) == sizeof(const char *),
+  "expected the atomic logger handle fields to have the size of the plain ones");
+
+#define RCUTILS_LOGGING_LOGGER_NAME(logger) ((atomic_uintptr_t *)&(logger)->name)
+#define RCUTILS_LOGGING_LOGGER_RESOLVED(logger) ((atomic_uint_least64_t *)&(logger)->resolved)
+
+// The generation of a snapshot of the logger levels, as kept in the high bits of a handle.
+static uint64_t rcutils_logging_levels_handle_generation(const rcutils_logging_levels_t * levels)
+{
+  size_t generation = NULL == levels ? g_rcutils_logging_levels_generation : levels->generation;
+  return (uint64_t)(uint32_t)generation << 32;
+}
+
+// Resolve the level of the logger of a handle from a snapshot of the logger levels.
+// Returns the resolved level, which is also stored in the handle.
+static int rcutils_logging_resolve_logger_handle(
+  const rcutils_logging_levels_t * levels, const char * name, rcutils_logger_t * logger)
+{
+  int resolved_level = rcutils_logging_resolve_logger_level(levels, name);
+  rcutils_atomic_store(
+    RCUTILS_LOGGING_LOGGER_RESOLVED(logger),
+    rcutils_logging_levels_handle_generation(levels) | (uint32_t)resolved_level);
+  return resolved_level;
+}
+
+rcutils_ret_t rcutils_logging_get_logger(const char * name, rcutils_logger_t * logger)
+{
+  RCUTILS_LOGGING_AUTOINIT;
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(name, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(logger, RCUTILS_RET_INVALID_ARGUMENT);
+
+  rcutils_atomic_store(RCUTILS_LOGGING_LOGGER_NAME(logger), (uintptr_t)name);
+  size_t readers_index;
+  rcutils_logging_resolve_logger_handle(
+    rcutils_logging_levels_acquire(&readers_index), name, logger);
+  rcutils_logging_levels_release(readers_index);
+  return RCUTILS_RET_OK;
+}
+
+// Compare a severity with the level of its logger, counting the filtered messages.
+// Messages below the level are enabled too if the flight recorder records them.
+static bool rcutils_logging_severity_is_enabled(int severity, int logger_level)
+{
+  if (severity < logger_level) {
+    if (RCUTILS_UNLIKELY(severity >= g_rcutils_logging_flight_recorder_severity)) {
+      return true;
+    }
+    if (g_rcutils_logging_statistics_enabled) {
+      rcutils_logging_statistics_count(RCUTILS_LOGGING_STATISTICS_FILTERED, severity);
+    }
+    return false;
+  }
+  return true;
+}
+
+// Determine if the logger of a handle is enabled, the handle referring to the given logger.
+static bool rcutils_logging_logger_handle_is_enabled_for_name(
+  rcutils_logger_t * logger, const char * name, int severity)
+{
+  int logger_level = RCUTILS_LOGGING_LOAD_LEVEL(g_rcutils_logging_default_logger_level);
+  size_t readers_index;
+  const rcutils_logging_levels_t * levels = rcutils_logging_levels_acquire(&readers_index);
+  uint64_t resolved = rcutils_atomic_load_uint64_t(RCUTILS_LOGGING_LOGGER_RESOLVED(logger));
+  int resolved_level = (int)(uint32_t)resolved;
+  if (RCUTILS_UNLIKELY(
+      (resolved & ~(uint64_t)UINT32_MAX) != rcutils_logging_levels_handle_generation(levels)))
+  {
+    // A logger level changed since the level of this logger was resolved.
+    resolved_level = rcutils_logging_resolve_logger_handle(levels, name, logger);
+  }
+  rcutils_logging_levels_release(readers_index);
+  if (RCUTILS_LOG_SEVERITY_UNSET != resolved_level) {
+    logger_level = resolved_level;
+  }
+  return rcutils_logging_severity_is_enabled(severity, logger_level);
+}
+
+bool rcutils_logging_logger_handle_is_enabled_for(rcutils_logger_t * logger, int severity)
+{
+  RCUTILS_LOGGING_AUTOINIT;
+  const char * name = NULL == logger ? NULL :
+    (const char *)rcutils_atomic_load_uintptr_t(RCUTILS_LOGGING_LOGGER_NAME(logger));
+  if (NULL == name) {
+    return rcutils_logging_severity_is_enabled(
+      severity, RCUTILS_LOGGING_LOAD_LEVEL(g_rcutils_logging_default_logger_level));
+  }
+  return rcutils_logging_logger_handle_is_enabled_for_name(logger, name, severity);
+}
+
+bool rcutils_logging_cached_logger_is_enabled_for(
+  rcutils_logger_t * logger, const char * name, int severity)
+{
+  RCUTILS_LOGGING_AUTOINIT;
+  if (NULL == logger || NULL == name) {
+    return rcutils_logging_logger_is_enabled_for(name, severity);
+  }
+  uintptr_t bound_name = rcutils_atomic_load_uintptr_t(RCUTILS_LOGGING_LOGGER_NAME(logger));
+  if (RCUTILS_UNLIKELY(0u == bound_name)) {
+    // The first use binds the handle, of racing threads the first one to do so wins.
+    if (rcutils_atomic_compare_exchange_strong_uintptr_t(
+        RCUTILS_LOGGING_LOGGER_NAME(logger), &bound_name, (uintptr_t)name))
+    {
+      bound_name = (uintptr_t)name;
     }
-    // Shorten the substring to be the name of the ancestor (excluding the separator).
-    substring_length = index_last_separator;
   }
-  // Neither the logger nor its ancestors have had their level specified.
-  return g_rcutils_logging_default_logger_level;
+  if (RCUTILS_UNLIKELY((uintptr_t)name != bound_name)) {
+    // The handle is bound to another name, e.g. at a call site logging with several names.
+    return rcutils_logging_logger_is_enabled_for(name, severity);
+  }
+  return rcutils_logging_logger_handle_is_enabled_for_name(logger, name, severity);
 }
 
 rcutils_ret_t rcutils_logging_set_logger_level(const char * name, int level)
@@ -469,7 +1241,8 @@ rcutils_ret_t rcutils_logging_set_logger_level(const char * name, int level)
     return RCUTILS_RET_INVALID_ARGUMENT;
   }
   if (strlen(name) == 0) {
-    g_rcutils_logging_default_logger_level = level;
+    RCUTILS_LOGGING_STORE_LEVEL(g_rcutils_logging_default_logger_level, level);
+    rcutils_logging_update_lowest_enabled_severity();
     return RCUTILS_RET_OK;
   }
   if (!g_rcutils_logging_severities_map_valid) {
@@ -477,8 +1250,6 @@ rcutils_ret_t rcutils_logging_set_logger_level(const char * name, int level)
     return RCUTILS_RET_LOGGING_SEVERITY_MAP_INVALID;
   }
 
-  // Convert the severity value into a string for storage.
-  // TODO(dhood): replace string map with int map.
   if (level < 0 ||
     level >=
     (int)(sizeof(g_rcutils_log_severity_names) / sizeof(g_rcutils_log_severity_names[0])))
@@ -486,14 +1257,16 @@ rcutils_ret_t rcutils_logging_set_logger_level(const char * name, int level)
     RCUTILS_SET_ERROR_MSG("Invalid severity level specified for logger");
     return RCUTILS_RET_INVALID_ARGUMENT;
   }
-  const char * severity_string = g_rcutils_log_severity_names[level];
-  if (NULL == severity_string) {
+  if (NULL == g_rcutils_log_severity_names[level]) {
     RCUTILS_SET_ERROR_MSG("Unable to determine severity_string for severity");
     return RCUTILS_RET_INVALID_ARGUMENT;
   }
-  rcutils_ret_t string_map_ret = rcutils_string_map_set(
-    &g_rcutils_logging_severities_map, name, severity_string);
-  if (string_map_ret != RCUTILS_RET_OK) {
+
+  rcutils_logging_level_update_t update = {0};
+  update.set_level = true;
+  update.level = level;
+  rcutils_ret_t ret = rcutils_logging_levels_update(name, strlen(name), &update);
+  if (ret != RCUTILS_RET_OK) {
     RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
       "Error setting severity level for logger named '%s': %s",
       name, rcutils_get_error_string().str);
@@ -505,66 +1278,281 @@ rcutils_ret_t rcutils_logging_set_logger_level(const char * name, int level)
 bool rcutils_logging_logger_is_enabled_for(const char * name, int severity)
 {
   RCUTILS_LOGGING_AUTOINIT;
-  int logger_level = g_rcutils_logging_default_logger_level;
+  int logger_level = RCUTILS_LOGGING_LOAD_LEVEL(g_rcutils_logging_default_logger_level);
   if (name) {
     logger_level = rcutils_logging_get_logger_effective_level(name);
-    if (-1 == logger_level) {
-      RCUTILS_SAFE_FWRITE_TO_STDERR_WITH_FORMAT_STRING(
-        "Error determining if logger '%s' is enabled for severity '%d'\n",
-        name, severity);
-      return false;
-    }
   }
-  return severity >= logger_level;
+  return rcutils_logging_severity_is_enabled(severity, logger_level);
 }
-#define SAFE_FWRITE_TO_STDERR_AND(action) \
-  RCUTILS_SAFE_FWRITE_TO_STDERR(rcutils_get_error_string().str); \
-  rcutils_reset_error(); \
-  RCUTILS_SAFE_FWRITE_TO_STDERR("\n"); \
-  action;
 
-#define OK_OR_RETURN_NULL(op) \
-  if (op != RCUTILS_RET_OK) { \
-    SAFE_FWRITE_TO_STDERR_AND(return NULL); \
+// Update the limiter of a logger, adding it if it has none yet.
+static rcutils_ret_t rcutils_logging_update_limiter(
+  const char * name, const rcutils_logging_level_update_t * update)
+{
+  if (NULL == name || strlen(name) == 0) {
+    RCUTILS_SET_ERROR_MSG("Invalid logger name");
+    return RCUTILS_RET_INVALID_ARGUMENT;
   }
-
-#define OK_OR_RETURN_EARLY(op) \
-  if (op != RCUTILS_RET_OK) { \
-    return op; \
+  if (!g_rcutils_logging_severities_map_valid) {
+    RCUTILS_SET_ERROR_MSG("Logger severity level map is invalid");
+    return RCUTILS_RET_LOGGING_SEVERITY_MAP_INVALID;
+  }
+  return rcutils_logging_levels_update(name, strlen(name), update);
+}
+
+rcutils_ret_t rcutils_logging_set_logger_rate_limit(const char * name, size_t rate, size_t burst)
+{
+  RCUTILS_LOGGING_AUTOINIT;
+  if (0 == burst) {
+    RCUTILS_SET_ERROR_MSG("Burst of the rate limit must be at least 1");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  rcutils_logging_level_update_t update = {0};
+  update.set_rate_limit = true;
+  if (0 != rate) {
+    int64_t emission_interval =
+      RCUTILS_S_TO_NS(1) / (int64_t)(rate < INT64_MAX ? rate : INT64_MAX);
+    if (0 == emission_interval) {
+      emission_interval = 1;
+    }
+    uint64_t max_burst = (uint64_t)(INT64_MAX / emission_interval);
+    update.emission_interval = emission_interval;
+    update.tolerance = (int64_t)((burst - 1) < max_burst ? (burst - 1) : max_burst) *
+      emission_interval;
+  }
+  return rcutils_logging_update_limiter(name, &update);
+}
+
+rcutils_ret_t rcutils_logging_set_logger_sampling(const char * name, size_t n)
+{
+  RCUTILS_LOGGING_AUTOINIT;
+  rcutils_logging_level_update_t update = {0};
+  update.set_sampling = true;
+  update.sampling = n;
+  return rcutils_logging_update_limiter(name, &update);
+}
+
+bool rcutils_logging_throttle_check(
+  rcutils_logging_throttle_t * throttle, rcutils_duration_value_t duration)
+{
+  static_assert(
+    sizeof(atomic_uint_least64_t) == sizeof(uint64_t),
+    "expected the atomic throttle state to have the size of the plain one");
+  rcutils_time_point_value_t now = 0;
+  if (RCUTILS_RET_OK != rcutils_coarse_steady_time_now(&now)) {
+    rcutils_reset_error();
+    return true;
+  }
+  // The state is only accessed atomically, so it is treated as the atomic type.
+  atomic_uint_least64_t * last_logged = (atomic_uint_least64_t *)&throttle->last_logged;
+  uint64_t last = rcutils_atomic_load_uint64_t(last_logged);
+  // Only one of the threads seeing the same last call wins the interval.
+  if ((0u != last && now - (int64_t)last < duration) ||
+    !rcutils_atomic_compare_exchange_strong_uint_least64_t(last_logged, &last, (uint64_t)now))
+  {
+    if (g_rcutils_logging_statistics_enabled) {
+      rcutils_logging_statistics_count_throttled();
+    }
+    return false;
+  }
+  return true;
+}
+
+// Whether the limiter of the logger, if any, lets the message pass.
+// If so, suppressed is set to the number of messages dropped since the last one which passed.
+static bool rcutils_logging_limiter_allows(
+  const rcutils_logging_levels_t * levels, const char * name, uint64_t * suppressed)
+{
+  *suppressed = 0;
+  const size_t name_length = strlen(name);
+  const rcutils_logging_level_entry_t * entry = rcutils_logging_levels_find(
+    levels, name, name_length, rcutils_logging_level_hash(5381, name, name_length));
+  rcutils_logging_limiter_t * limiter = entry->limiter;
+  if (NULL == entry->name || NULL == limiter) {
+    return true;
+  }
+
+  bool allowed = true;
+  if (limiter->sampling > 1) {
+    uint64_t count = rcutils_atomic_fetch_add_uint64_t(&limiter->sampling_counter, 1);
+    allowed = 0 == count % limiter->sampling;
+  }
+  if (allowed && limiter->emission_interval > 0) {
+    rcutils_time_point_value_t now = 0;
+    if (RCUTILS_RET_OK == rcutils_steady_time_now(&now)) {
+      uint64_t next_arrival = rcutils_atomic_load_uint64_t(&limiter->next_arrival);
+      for (;;) {
+        int64_t arrival = (int64_t)next_arrival > now ? (int64_t)next_arrival : now;
+        if (arrival - now > limiter->tolerance) {
+          allowed = false;
+          break;
+        }
+        // On failure, next_arrival is updated to the value set by another thread.
+        if (rcutils_atomic_compare_exchange_strong_uint_least64_t(
+            &limiter->next_arrival, &next_arrival,
+            (uint64_t)(arrival + limiter->emission_interval)))
+        {
+          break;
+        }
+      }
+    }
+  }
+
+  if (!allowed) {
+    rcutils_atomic_fetch_add_uint64_t(&limiter->suppressed, 1);
+    return false;
+  }
+  if (rcutils_atomic_load_uint64_t(&limiter->suppressed) > 0) {
+    *suppressed = rcutils_atomic_exchange_uint64_t(&limiter->suppressed, 0);
+  }
+  return true;
+}
+
+#define SAFE_FWRITE_TO_STDERR_AND(action) \
+  RCUTILS_SAFE_FWRITE_TO_STDERR(rcutils_get_error_string().str); \
+  rcutils_reset_error(); \
+  RCUTILS_SAFE_FWRITE_TO_STDERR("\n"); \
+  action;
+
+#define OK_OR_RETURN_NULL(op) \
+  if (op != RCUTILS_RET_OK) { \
+    SAFE_FWRITE_TO_STDERR_AND(return NULL); \
+  }
+
+#define OK_OR_RETURN_EARLY(op) \
+  if (op != RCUTILS_RET_OK) { \
+    return op; \
   }
 
 #define APPEND_AND_RETURN_LOG_OUTPUT(s) \
-  OK_OR_RETURN_NULL(rcutils_char_array_strcat(logging_output, s)); \
+  OK_OR_RETURN_NULL(rcutils_logging_append_output(logging_output, s, strlen(s))); \
   return logging_output->buffer;
 
+// Append n characters to the output, which is updated in place when formatting a record.
+// Unlike rcutils_char_array_strncat(), the length of the output isn't computed again on every
+// call, but taken from buffer_length (including the terminating null byte).
+rcutils_ret_t rcutils_logging_append_output(
+  rcutils_char_array_t * logging_output, const char * src, size_t n)
+{
+  return rcutils_char_array_append_n(logging_output, src, n);
+}
+
+// Print the formatted message directly at the end of the output.
+rcutils_ret_t rcutils_logging_append_output_vsprintf(
+  rcutils_char_array_t * logging_output, const char * format, va_list * args)
+{
+  if (g_rcutils_logging_fast_format) {
+    return rcutils_char_array_fast_vsprintf_append(logging_output, format, *args);
+  }
+  return rcutils_char_array_vsprintf_append(logging_output, format, *args);
+}
+
+
+static void rcutils_logging_call_output_handler(
+  rcutils_logging_output_handler_t output_handler, const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  (*output_handler)(location, severity, name, timestamp, format, &args);
+  va_end(args);
+}
+
+bool rcutils_logging_admit_message(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_logging_output_handler_t output_handler,
+  rcutils_time_point_value_t * timestamp)
+{
+  RCUTILS_LOGGING_AUTOINIT;
+  int logger_level = RCUTILS_LOGGING_LOAD_LEVEL(g_rcutils_logging_default_logger_level);
+  if (name) {
+    logger_level = rcutils_logging_get_logger_effective_level(name);
+  }
+  if (severity < logger_level) {
+    // Filtered, including the messages only the flight recorder records.
+    if (g_rcutils_logging_statistics_enabled) {
+      rcutils_logging_statistics_count(RCUTILS_LOGGING_STATISTICS_FILTERED, severity);
+    }
+    return false;
+  }
+  uint64_t suppressed = 0;
+  size_t readers_index;
+  const rcutils_logging_levels_t * levels = rcutils_logging_levels_acquire(&readers_index);
+  bool allowed = NULL == levels || 0 == levels->limiters_count || NULL == name ||
+    rcutils_logging_limiter_allows(levels, name, &suppressed);
+  rcutils_logging_levels_release(readers_index);
+  if (!allowed) {
+    if (g_rcutils_logging_statistics_enabled) {
+      rcutils_logging_statistics_count(RCUTILS_LOGGING_STATISTICS_DROPPED, severity);
+    }
+    return false;
+  }
+  *timestamp = 0;
+  if (NULL == output_handler || rcutils_logging_output_handler_needs_timestamp(output_handler)) {
+    rcutils_ret_t ret = g_rcutils_logging_coarse_timestamps ?
+      rcutils_coarse_system_time_now(timestamp) : rcutils_system_time_now(timestamp);
+    if (ret != RCUTILS_RET_OK) {
+      RCUTILS_SAFE_FWRITE_TO_STDERR("Failed to get timestamp while doing a console logging.\n");
+      return false;
+    }
+  }
+  rcutils_logging_output_handler_t suppressed_output_handler = g_rcutils_logging_output_handler;
+  if (suppressed > 0 && suppressed_output_handler != NULL) {
+    rcutils_logging_call_output_handler(
+      suppressed_output_handler, location, severity, name, *timestamp,
+      "suppressed %" PRIu64 " messages", suppressed);
+  }
+  return true;
+}
 
 void rcutils_log(
   const rcutils_log_location_t * location,
   int severity, const char * name, const char * format, ...)
 {
-  if (!rcutils_logging_logger_is_enabled_for(name, severity)) {
-    return;
-  }
+  RCUTILS_TRACEPOINT(log_start, name, severity);
+  rcutils_logging_output_handler_t output_handler = g_rcutils_logging_output_handler;
   rcutils_time_point_value_t now;
-  rcutils_ret_t ret = rcutils_system_time_now(&now);
-  if (ret != RCUTILS_RET_OK) {
-    RCUTILS_SAFE_FWRITE_TO_STDERR("Failed to get timestamp while doing a console logging.\n");
-    return;
+  if (RCUTILS_UNLIKELY(severity >= g_rcutils_logging_flight_recorder_severity)) {
+    rcutils_time_point_value_t recorded_at = 0;
+    rcutils_ret_t ret = g_rcutils_logging_coarse_timestamps ?
+      rcutils_coarse_system_time_now(&recorded_at) : rcutils_system_time_now(&recorded_at);
+    RCUTILS_UNUSED(ret);
+    va_list args;
+    va_start(args, format);
+    rcutils_logging_flight_recorder_vrecord(severity, name, recorded_at, format, &args);
+    va_end(args);
   }
-  rcutils_logging_output_handler_t output_handler = g_rcutils_logging_output_handler;
-  if (output_handler != NULL) {
+  if (
+    rcutils_logging_admit_message(location, severity, name, output_handler, &now) &&
+    output_handler != NULL)
+  {
+    rcutils_time_point_value_t start = 0;
+    if (g_rcutils_logging_statistics_enabled) {
+      rcutils_logging_statistics_count(RCUTILS_LOGGING_STATISTICS_EMITTED, severity);
+      start = rcutils_logging_statistics_start_timer();
+    }
+    RCUTILS_TRACEPOINT(output_handler_start, output_handler, severity);
     va_list args;
     va_start(args, format);
     (*output_handler)(location, severity, name ? name : "", now, format, &args);
     va_end(args);
+    RCUTILS_TRACEPOINT(output_handler_end, output_handler);
+    if (g_rcutils_logging_statistics_enabled) {
+      rcutils_logging_statistics_add_output_time(start);
+    }
   }
+  RCUTILS_TRACEPOINT(log_end, name, severity);
 }
 
 typedef struct logging_input
 {
   const char * name;
   const rcutils_log_location_t * location;
+  // The message, or NULL if it is to be formatted from format and args.
   const char * msg;
+  const char * format;
+  va_list * args;
   int severity;
   rcutils_time_point_value_t timestamp;
 } logging_input;
@@ -577,60 +1565,177 @@ typedef struct token_map_entry
 {
   const char * token;
   token_handler handler;
+  // The rcutils_logging_output_format_need_t flags of what the token expands.
+  unsigned int needs;
 } token_map_entry;
 
-const char * expand_time(
-  const logging_input * logging_input, rcutils_char_array_t * logging_output,
-  rcutils_ret_t (* time_func)(const rcutils_time_point_value_t *, char *, size_t))
+// Render value in decimal, zero padded to at least min_digits, returning the number of
+// characters written to str (which must have room for 20 characters, or min_digits if more).
+// This is the equivalent of "%.<min_digits>" PRIu64 without going through snprintf.
+static size_t rcutils_logging_format_decimal(uint64_t value, size_t min_digits, char * str)
 {
-  // Temporary, local storage for integer/float conversion to string
-  // Note:
-  //   32 characters enough, because the most it can be is 20 characters
-  //   for the 19 possible digits in a signed 64-bit number plus the optional
-  //   decimal point in the floating point seconds version
-  char numeric_storage[32];
-  OK_OR_RETURN_NULL(time_func(&logging_input->timestamp, numeric_storage, sizeof(numeric_storage)));
-  APPEND_AND_RETURN_LOG_OUTPUT(numeric_storage);
+  char digits[20];
+  size_t count = 0;
+  do {
+    digits[count++] = (char)('0' + value % 10u);
+    value /= 10u;
+  } while (value > 0u);
+  size_t length = 0;
+  while (count + length < min_digits) {
+    str[length++] = '0';
+  }
+  while (count > 0) {
+    str[length++] = digits[--count];
+  }
+  return length;
+}
+
+// The absolute value of the time point, which also works for INT64_MIN.
+static uint64_t rcutils_logging_abs_time_point(rcutils_time_point_value_t time_point)
+{
+  return time_point >= 0 ? (uint64_t)time_point : (uint64_t)(-(time_point + 1)) + 1u;
 }
 
+// Each thread keeps the rendering of the last second it formatted a timestamp for, so that only
+// the nanoseconds have to be rendered for the following messages within the same second.
+typedef struct rcutils_logging_time_cache_t
+{
+  bool valid;
+  bool negative;
+  uint64_t seconds;
+  // The rendered seconds, including the sign and the decimal separator.
+  char prefix[32];
+  size_t prefix_length;
+} rcutils_logging_time_cache_t;
+
+static RCUTILS_THREAD_LOCAL rcutils_logging_time_cache_t gtls_rcutils_logging_time_cache;
+static RCUTILS_THREAD_LOCAL rcutils_logging_time_cache_t gtls_rcutils_logging_iso8601_cache;
+
 const char * expand_time_as_seconds(
   const logging_input * logging_input,
   rcutils_char_array_t * logging_output)
 {
-  return expand_time(logging_input, logging_output, rcutils_time_point_value_as_seconds_string);
+  // Renders like rcutils_time_point_value_as_seconds_string().
+  rcutils_logging_time_cache_t * cache = &gtls_rcutils_logging_time_cache;
+  bool negative = logging_input->timestamp < 0;
+  uint64_t abs_time_point = rcutils_logging_abs_time_point(logging_input->timestamp);
+  uint64_t seconds = abs_time_point / (1000u * 1000u * 1000u);
+  uint64_t nanoseconds = abs_time_point % (1000u * 1000u * 1000u);
+
+  if (!cache->valid || cache->seconds != seconds || cache->negative != negative) {
+    size_t length = 0;
+    if (negative) {
+      cache->prefix[length++] = '-';
+    }
+    length += rcutils_logging_format_decimal(seconds, 10u, cache->prefix + length);
+    cache->prefix[length++] = '.';
+    cache->prefix_length = length;
+    cache->seconds = seconds;
+    cache->negative = negative;
+    cache->valid = true;
+  }
+
+  char numeric_storage[48];
+  memcpy(numeric_storage, cache->prefix, cache->prefix_length);
+  size_t length = cache->prefix_length;
+  length += rcutils_logging_format_decimal(nanoseconds, 9u, numeric_storage + length);
+  OK_OR_RETURN_NULL(rcutils_logging_append_output(logging_output, numeric_storage, length));
+  return logging_output->buffer;
 }
 
 const char * expand_time_as_nanoseconds(
   const logging_input * logging_input,
   rcutils_char_array_t * logging_output)
 {
-  return expand_time(logging_input, logging_output, rcutils_time_point_value_as_nanoseconds_string);
+  char numeric_storage[RCUTILS_TIME_POINT_FORMAT_STRING_SIZE];
+  size_t length = rcutils_time_point_value_format_nanoseconds(
+    logging_input->timestamp, numeric_storage);
+  OK_OR_RETURN_NULL(rcutils_logging_append_output(logging_output, numeric_storage, length));
+  return logging_output->buffer;
 }
 
-const char * expand_line_number(
+const char * expand_time_as_milliseconds(
   const logging_input * logging_input,
   rcutils_char_array_t * logging_output)
 {
-  // Allow 9 digits for the expansion of the line number (otherwise, truncate).
-  char line_number_expansion[10];
+  char numeric_storage[RCUTILS_TIME_POINT_FORMAT_STRING_SIZE];
+  size_t length = rcutils_time_point_value_format_seconds(
+    logging_input->timestamp, RCUTILS_TIME_POINT_PRECISION_MILLISECONDS, numeric_storage);
+  OK_OR_RETURN_NULL(rcutils_logging_append_output(logging_output, numeric_storage, length));
+  return logging_output->buffer;
+}
 
-  const rcutils_log_location_t * location = logging_input->location;
+const char * expand_time_as_microseconds(
+  const logging_input * logging_input,
+  rcutils_char_array_t * logging_output)
+{
+  char numeric_storage[RCUTILS_TIME_POINT_FORMAT_STRING_SIZE];
+  size_t length = rcutils_time_point_value_format_seconds(
+    logging_input->timestamp, RCUTILS_TIME_POINT_PRECISION_MICROSECONDS, numeric_storage);
+  OK_OR_RETURN_NULL(rcutils_logging_append_output(logging_output, numeric_storage, length));
+  return logging_output->buffer;
+}
 
-  if (!location) {
-    OK_OR_RETURN_NULL(rcutils_char_array_strcpy(logging_output, "0"));
-    return logging_output->buffer;
+const char * expand_time_iso8601(
+  const logging_input * logging_input,
+  rcutils_char_array_t * logging_output)
+{
+  // The local time, e.g. 2020-08-04T17:22:05.123456789, with the seconds rendered only once
+  // per thread and second as the call to localtime is expensive.
+  rcutils_logging_time_cache_t * cache = &gtls_rcutils_logging_iso8601_cache;
+  const int64_t nanoseconds_per_second = 1000 * 1000 * 1000;
+  int64_t seconds = logging_input->timestamp / nanoseconds_per_second;
+  int64_t nanoseconds = logging_input->timestamp % nanoseconds_per_second;
+  if (nanoseconds < 0) {
+    // Round towards negative infinity, so that the nanoseconds are positive.
+    seconds -= 1;
+    nanoseconds += nanoseconds_per_second;
   }
 
-  // Even in the case of truncation the result will still be null-terminated.
-  int written = rcutils_snprintf(
-    line_number_expansion, sizeof(line_number_expansion), "%zu", location->line_number);
-  if (written < 0) {
-    RCUTILS_SAFE_FWRITE_TO_STDERR_WITH_FORMAT_STRING(
-      "failed to format line number: '%zu'\n", location->line_number);
-    return NULL;
+  if (!cache->valid || cache->seconds != (uint64_t)seconds) {
+    time_t time_seconds = (time_t)seconds;
+    struct tm local_time;
+#ifdef _WIN32
+    bool converted = localtime_s(&local_time, &time_seconds) == 0;
+#else
+    bool converted = localtime_r(&time_seconds, &local_time) != NULL;
+#endif
+    if (!converted) {
+      RCUTILS_SAFE_FWRITE_TO_STDERR("failed to convert the timestamp to local time\n");
+      return NULL;
+    }
+    size_t length = strftime(
+      cache->prefix, sizeof(cache->prefix), "%Y-%m-%dT%H:%M:%S.", &local_time);
+    if (0 == length) {
+      RCUTILS_SAFE_FWRITE_TO_STDERR("failed to format the local time\n");
+      return NULL;
+    }
+    cache->prefix_length = length;
+    cache->seconds = (uint64_t)seconds;
+    cache->valid = true;
   }
 
-  APPEND_AND_RETURN_LOG_OUTPUT(line_number_expansion);
+  char time_storage[48];
+  memcpy(time_storage, cache->prefix, cache->prefix_length);
+  size_t length = cache->prefix_length;
+  length += rcutils_logging_format_decimal((uint64_t)nanoseconds, 9u, time_storage + length);
+  OK_OR_RETURN_NULL(rcutils_logging_append_output(logging_output, time_storage, length));
+  return logging_output->buffer;
+}
+
+const char * expand_line_number(
+  const logging_input * logging_input,
+  rcutils_char_array_t * logging_output)
+{
+  const rcutils_log_location_t * location = logging_input->location;
+
+  if (!location) {
+    APPEND_AND_RETURN_LOG_OUTPUT("0");
+  }
+
+  OK_OR_RETURN_NULL(
+    rcutils_char_array_append_u64(logging_output, (uint64_t)location->line_number));
+  return logging_output->buffer;
 }
 
 const char * expand_severity(
@@ -653,8 +1758,13 @@ const char * expand_message(
   const logging_input * logging_input,
   rcutils_char_array_t * logging_output)
 {
-  OK_OR_RETURN_NULL(rcutils_char_array_strcat(logging_output, logging_input->msg));
-  return logging_output->buffer;
+  if (NULL == logging_input->msg) {
+    OK_OR_RETURN_NULL(
+      rcutils_logging_append_output_vsprintf(
+        logging_output, logging_input->format, logging_input->args));
+    return logging_output->buffer;
+  }
+  APPEND_AND_RETURN_LOG_OUTPUT(logging_input->msg);
 }
 
 const char * expand_function_name(
@@ -677,107 +1787,276 @@ const char * expand_file_name(
   return logging_output->buffer;
 }
 
+const char * expand_thread_id(
+  const logging_input * logging_input,
+  rcutils_char_array_t * logging_output)
+{
+  (void)logging_input;
+  OK_OR_RETURN_NULL(rcutils_char_array_append_u64(logging_output, rcutils_thread_get_id()));
+  return logging_output->buffer;
+}
+
+const char * expand_thread_name(
+  const logging_input * logging_input,
+  rcutils_char_array_t * logging_output)
+{
+  (void)logging_input;
+  const char * thread_name = rcutils_thread_get_cached_name();
+  APPEND_AND_RETURN_LOG_OUTPUT(thread_name);
+}
+
 static const token_map_entry tokens[] = {
-  {.token = "severity", .handler = expand_severity},
-  {.token = "name", .handler = expand_name},
-  {.token = "message", .handler = expand_message},
-  {.token = "function_name", .handler = expand_function_name},
-  {.token = "file_name", .handler = expand_file_name},
-  {.token = "time", .handler = expand_time_as_seconds},
-  {.token = "time_as_nanoseconds", .handler = expand_time_as_nanoseconds},
-  {.token = "line_number", .handler = expand_line_number},
+  {.token = "severity", .handler = expand_severity, .needs = 0u},
+  {.token = "name", .handler = expand_name, .needs = RCUTILS_LOGGING_OUTPUT_FORMAT_NEEDS_NAME},
+  {.token = "message", .handler = expand_message, .needs = 0u},
+  {
+    .token = "function_name", .handler = expand_function_name,
+    .needs = RCUTILS_LOGGING_OUTPUT_FORMAT_NEEDS_LOCATION
+  },
+  {
+    .token = "file_name", .handler = expand_file_name,
+    .needs = RCUTILS_LOGGING_OUTPUT_FORMAT_NEEDS_LOCATION
+  },
+  {
+    .token = "time", .handler = expand_time_as_seconds,
+    .needs = RCUTILS_LOGGING_OUTPUT_FORMAT_NEEDS_TIME
+  },
+  {
+    .token = "time_as_nanoseconds", .handler = expand_time_as_nanoseconds,
+    .needs = RCUTILS_LOGGING_OUTPUT_FORMAT_NEEDS_TIME
+  },
+  {
+    .token = "time_ms", .handler = expand_time_as_milliseconds,
+    .needs = RCUTILS_LOGGING_OUTPUT_FORMAT_NEEDS_TIME
+  },
+  {
+    .token = "time_us", .handler = expand_time_as_microseconds,
+    .needs = RCUTILS_LOGGING_OUTPUT_FORMAT_NEEDS_TIME
+  },
+  {
+    .token = "time_iso8601", .handler = expand_time_iso8601,
+    .needs = RCUTILS_LOGGING_OUTPUT_FORMAT_NEEDS_TIME
+  },
+  {
+    .token = "line_number", .handler = expand_line_number,
+    .needs = RCUTILS_LOGGING_OUTPUT_FORMAT_NEEDS_LOCATION
+  },
+  {
+    .token = "thread_id", .handler = expand_thread_id,
+    .needs = RCUTILS_LOGGING_OUTPUT_FORMAT_NEEDS_THREAD
+  },
+  {
+    .token = "thread_name", .handler = expand_thread_name,
+    .needs = RCUTILS_LOGGING_OUTPUT_FORMAT_NEEDS_THREAD
+  },
 };
 
-token_handler find_token_handler(const char * token)
+#define TOKEN_COUNT (sizeof(tokens) / sizeof(tokens[0]))
+
+// Finds a token with a single probe of the frozen map of the token names, or by comparing it with
+// each of them if the map couldn't be built.
+static const token_map_entry * find_token(
+  const rcutils_frozen_map_t * token_map, const char * token, size_t token_len)
 {
-  int token_number = sizeof(tokens) / sizeof(tokens[0]);
-  for (int token_index = 0; token_index < token_number; token_index++) {
-    if (strcmp(token, tokens[token_index].token) == 0) {
-      return tokens[token_index].handler;
+  size_t token_index = 0;
+  if (NULL != token_map->slots) {
+    if (RCUTILS_RET_OK == rcutils_frozen_map_findn(token_map, token, token_len, &token_index)) {
+      return &tokens[token_index];
+    }
+    return NULL;
+  }
+  for (; token_index < TOKEN_COUNT; token_index++) {
+    if (strncmp(token, tokens[token_index].token, token_len) == 0 &&
+      tokens[token_index].token[token_len] == '\0')
+    {
+      return &tokens[token_index];
     }
   }
   return NULL;
 }
 
-rcutils_ret_t rcutils_logging_format_message(
-  const rcutils_log_location_t * location,
-  int severity, const char * name, rcutils_time_point_value_t timestamp,
-  const char * msg, rcutils_char_array_t * logging_output)
+// An operation of the compiled output format: either a token handler or, if handler is NULL,
+// a span of literal text of the output format string.
+typedef struct output_format_op
+{
+  token_handler handler;
+  size_t start;
+  size_t length;
+} output_format_op;
+
+// Tokens take at least 3 characters ('{', '}' and the name) and adjacent literal text is
+// merged into a single span, so there can't be more than one operation per 2 characters.
+#define RCUTILS_LOGGING_MAX_OUTPUT_FORMAT_OPS (RCUTILS_LOGGING_MAX_OUTPUT_FORMAT_LEN / 2 + 2)
+
+static output_format_op g_rcutils_logging_output_format_ops[RCUTILS_LOGGING_MAX_OUTPUT_FORMAT_OPS];
+static size_t g_rcutils_logging_output_format_ops_count = 0;
+// The rcutils_logging_output_format_need_t flags of the tokens of the compiled output format.
+static unsigned int g_rcutils_logging_output_format_needs = 0u;
+
+static void rcutils_logging_add_literal_op(size_t start, size_t end)
+{
+  if (end > start) {
+    output_format_op * op =
+      &g_rcutils_logging_output_format_ops[g_rcutils_logging_output_format_ops_count++];
+    op->handler = NULL;
+    op->start = start;
+    op->length = end - start;
+  }
+}
+
+static void rcutils_logging_compile_output_format(void)
 {
-  rcutils_ret_t status = RCUTILS_RET_OK;
   // Process the format string looking for known tokens.
   const char token_start_delimiter = '{';
-  const char token_end_delimiter = '}';
+  rcutils_char_set_t delimiters;
+  // This cannot fail with valid arguments
+  rcutils_ret_t ret = rcutils_char_set_init(&delimiters, "{}");
+  RCUTILS_UNUSED(ret);
 
   const char * str = g_rcutils_logging_output_format_string;
   size_t size = strlen(g_rcutils_logging_output_format_string);
 
-  const logging_input logging_input = {
-    .location = location,
-    .severity = severity,
-    .name = name,
-    .timestamp = timestamp,
-    .msg = msg
-  };
+  const char * token_names[TOKEN_COUNT];
+  for (size_t token_index = 0; token_index < TOKEN_COUNT; token_index++) {
+    token_names[token_index] = tokens[token_index].token;
+  }
+  // The format is only compiled once, by rcutils_logging_initialize_with_allocator(), and the
+  // messages are formatted from the compiled operations, so no hot path uses this map.
+  // If the map can't be built, the tokens are compared one by one. It isn't built while an
+  // error of the initialization is set, so that the error isn't overwritten.
+  rcutils_frozen_map_t token_map = rcutils_get_zero_initialized_frozen_map();
+  if (!rcutils_error_is_set() &&
+    RCUTILS_RET_OK != rcutils_frozen_map_init(
+      &token_map, token_names, TOKEN_COUNT, &g_rcutils_logging_allocator))
+  {
+    rcutils_reset_error();
+  }
+
+  g_rcutils_logging_output_format_ops_count = 0;
+  g_rcutils_logging_output_format_needs = 0u;
 
-  // Walk through the format string and expand tokens when they're encountered.
+  // Walk through the format string and add an operation for each recognized token, and for the
+  // text in between them.
+  size_t literal_start = 0;
   size_t i = 0;
   while (i < size) {
-    // Print everything up to the next token start delimiter.
-    size_t chars_to_start_delim = rcutils_find(str + i, token_start_delimiter);
-    size_t remaining_chars = size - i;
-
-    if (chars_to_start_delim > 0) {  // there are stuff before a token start delimiter
-      size_t chars_to_copy = chars_to_start_delim >
-        remaining_chars ? remaining_chars : chars_to_start_delim;
-      status = rcutils_char_array_strncat(logging_output, str + i, chars_to_copy);
-      OK_OR_RETURN_EARLY(status);
-      i += chars_to_copy;
-      if (i >= size) {  // perhaps no start delimiter was found
-        break;
-      }
+    // Skip everything up to the next token start delimiter.
+    size_t chars_to_start_delim = rcutils_findn(str + i, token_start_delimiter, size - i);
+    if (SIZE_MAX == chars_to_start_delim) {  // no start delimiter was found
+      break;
     }
+    i += chars_to_start_delim;
 
     // We are at a token start delimiter: determine if there's a known token or not.
-    // Potential tokens can't possibly be longer than the format string itself.
-    char token[RCUTILS_LOGGING_MAX_OUTPUT_FORMAT_LEN];
-
-    // Look for a token end delimiter.
-    size_t chars_to_end_delim = rcutils_find(str + i, token_end_delimiter);
-    remaining_chars = size - i;
-
-    if (chars_to_end_delim > remaining_chars) {
-      // No end delimiters found in the remainder of the format string;
+    // Look for a token end delimiter, or for another start delimiter which comes first, since
+    // no token contains one.
+    size_t chars_to_end_delim = rcutils_find_anyn(str + i + 1, &delimiters, size - i - 1);
+    if (SIZE_MAX == chars_to_end_delim) {
+      // No delimiters found in the remainder of the format string;
       // there won't be any more tokens so shortcut the rest of the checking.
-      status = rcutils_char_array_strncat(logging_output, str + i, remaining_chars);
-      OK_OR_RETURN_EARLY(status);
       break;
     }
+    chars_to_end_delim += 1;
+    if (token_start_delimiter == str[i + chars_to_end_delim]) {
+      // This wasn't a token; keep the start delimiter as text and continue from the next one.
+      i += chars_to_end_delim;
+      continue;
+    }
 
     // Found what looks like a token; determine if it's recognized.
     size_t token_len = chars_to_end_delim - 1;  // Not including delimiters.
-    memcpy(token, str + i + 1, token_len);  // Skip the start delimiter.
-    token[token_len] = '\0';
-
-    token_handler expand_token = find_token_handler(token);
+    const token_map_entry * token = find_token(&token_map, str + i + 1, token_len);
 
-    if (!expand_token) {
-      // This wasn't a token; print the start delimiter and continue the search as usual
+    if (!token) {
+      // This wasn't a token; keep the start delimiter as text and continue the search as usual
       // (the substring might contain more start delimiters).
-      status = rcutils_char_array_strncat(logging_output, str + i, 1);
-      OK_OR_RETURN_EARLY(status);
       i++;
       continue;
     }
 
-    if (!expand_token(&logging_input, logging_output)) {
-      return RCUTILS_RET_ERROR;
-    }
+    rcutils_logging_add_literal_op(literal_start, i);
+    output_format_op * op =
+      &g_rcutils_logging_output_format_ops[g_rcutils_logging_output_format_ops_count++];
+    op->handler = token->handler;
+    op->start = i;
+    op->length = token_len + 2;
+    g_rcutils_logging_output_format_needs |= token->needs;
     // Skip ahead to avoid re-processing the token characters (including the 2 delimiters).
     i += token_len + 2;
+    literal_start = i;
   }
+  rcutils_logging_add_literal_op(literal_start, size);
+  ret = rcutils_frozen_map_fini(&token_map);
+  RCUTILS_UNUSED(ret);
+}
 
-  return status;
+bool rcutils_logging_output_format_needs(unsigned int needs)
+{
+  return 0u != (g_rcutils_logging_output_format_needs & needs);
+}
+
+bool rcutils_logging_output_handler_needs_timestamp(
+  rcutils_logging_output_handler_t output_handler)
+{
+  // These handlers only use the timestamp for the output format, except for flushing a batched
+  // console stream periodically.
+  if (output_handler == rcutils_logging_console_output_handler ||
+    output_handler == rcutils_logging_file_output_handler)
+  {
+    return g_rcutils_logging_stream_batched ||
+           rcutils_logging_output_format_needs(RCUTILS_LOGGING_OUTPUT_FORMAT_NEEDS_TIME);
+  }
+  return true;
+}
+
+// Append the record to the output, expanding the tokens of the compiled output format.
+// If message isn't NULL, the first {message} token of a record given with a format string is
+// expanded into it instead, and message_offset is set to the length of the output before it,
+// so that the record can be written as spans without copying the message into the output.
+// message_offset is left as it is if the output format has no {message} token.
+static rcutils_ret_t rcutils_logging_format_record(
+  const logging_input * logging_input, rcutils_char_array_t * logging_output,
+  rcutils_char_array_t * message, size_t * message_offset)
+{
+  // Whatever is already in the output is kept, e.g. a color escape sequence.
+  logging_output->buffer_length = strlen(logging_output->buffer) + 1;
+
+  // Execute the output format compiled by rcutils_logging_initialize_with_allocator().
+  for (size_t i = 0; i < g_rcutils_logging_output_format_ops_count; ++i) {
+    const output_format_op * op = &g_rcutils_logging_output_format_ops[i];
+    if (NULL != message && expand_message == op->handler && NULL == logging_input->msg) {
+      *message_offset = logging_output->buffer_length - 1u;
+      rcutils_ret_t status = rcutils_logging_append_output_vsprintf(
+        message, logging_input->format, logging_input->args);
+      OK_OR_RETURN_EARLY(status);
+      message = NULL;
+    } else if (NULL == op->handler) {
+      rcutils_ret_t status = rcutils_logging_append_output(
+        logging_output, g_rcutils_logging_output_format_string + op->start, op->length);
+      OK_OR_RETURN_EARLY(status);
+    } else if (!op->handler(logging_input, logging_output)) {
+      return RCUTILS_RET_ERROR;
+    }
+  }
+
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t rcutils_logging_format_message(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * msg, rcutils_char_array_t * logging_output)
+{
+  const logging_input logging_input = {
+    .location = location,
+    .severity = severity,
+    .name = name,
+    .timestamp = timestamp,
+    .msg = msg,
+    .format = NULL,
+    .args = NULL
+  };
+  return rcutils_logging_format_record(&logging_input, logging_output, NULL, NULL);
 }
 
 #ifdef _WIN32
@@ -794,17 +2073,18 @@ rcutils_ret_t rcutils_logging_format_message(
 # define IS_STREAM_A_TTY(stream) (isatty(fileno(stream)) != 0)
 #endif
 
-#define IS_OUTPUT_COLORIZED(is_colorized) \
-  { \
-    if (g_colorized_output == RCUTILS_COLORIZED_OUTPUT_FORCE_ENABLE) { \
-      is_colorized = true; \
-    } else if (g_colorized_output == RCUTILS_COLORIZED_OUTPUT_FORCE_DISABLE) { \
-      is_colorized = false; \
-    } else { \
-      is_colorized = IS_STREAM_A_TTY(g_output_stream); \
-    } \
+static bool rcutils_logging_is_output_colorized(void)
+{
+  if (g_colorized_output == RCUTILS_COLORIZED_OUTPUT_FORCE_ENABLE) {
+    return true;
+  } else if (g_colorized_output == RCUTILS_COLORIZED_OUTPUT_FORCE_DISABLE) {
+    return false;
   }
-#define SET_COLOR_WITH_SEVERITY(status, severity, color) \
+  return IS_STREAM_A_TTY(g_output_stream);
+}
+
+#ifdef _WIN32
+# define SET_COLOR_WITH_SEVERITY(status, severity, color) \
   { \
     switch (severity) { \
       case RCUTILS_LOG_SEVERITY_DEBUG: \
@@ -826,7 +2106,6 @@ rcutils_ret_t rcutils_logging_format_message(
         status = RCUTILS_RET_INVALID_ARGUMENT; \
     } \
   }
-#ifdef _WIN32
 # define SET_OUTPUT_COLOR_WITH_COLOR(status, color, handle) \
   { \
     if (RCUTILS_RET_OK == status) { \
@@ -872,32 +2151,233 @@ rcutils_ret_t rcutils_logging_format_message(
   }
 # define SET_STANDARD_COLOR_IN_BUFFER(is_colorized, status, output_array)
 #else
+// An escape sequence and its length, so that it is appended without measuring it.
+typedef struct rcutils_logging_color_span
+{
+  const char * sequence;
+  size_t length;
+} rcutils_logging_color_span;
+
+# define RCUTILS_LOGGING_COLOR_SPAN(color) {color, sizeof(color) - 1u}
+
+// The escape sequences preceding the records of each valid severity.
+static const rcutils_logging_color_span g_rcutils_logging_severity_colors[] = {
+  [RCUTILS_LOG_SEVERITY_DEBUG] = RCUTILS_LOGGING_COLOR_SPAN(COLOR_GREEN),
+  [RCUTILS_LOG_SEVERITY_INFO] = RCUTILS_LOGGING_COLOR_SPAN(COLOR_NORMAL),
+  [RCUTILS_LOG_SEVERITY_WARN] = RCUTILS_LOGGING_COLOR_SPAN(COLOR_YELLOW),
+  [RCUTILS_LOG_SEVERITY_ERROR] = RCUTILS_LOGGING_COLOR_SPAN(COLOR_RED),
+  [RCUTILS_LOG_SEVERITY_FATAL] = RCUTILS_LOGGING_COLOR_SPAN(COLOR_RED),
+};
+static const rcutils_logging_color_span g_rcutils_logging_standard_color =
+  RCUTILS_LOGGING_COLOR_SPAN(COLOR_NORMAL);
+
 # define SET_OUTPUT_COLOR_WITH_COLOR(status, color, output_array) \
   { \
     if (RCUTILS_RET_OK == status) { \
-      status = rcutils_char_array_strncat(&output_array, color, strlen(color)); \
+      status = rcutils_logging_append_output(&output_array, (color).sequence, (color).length); \
       if (RCUTILS_RET_OK != status) { \
         RCUTILS_SAFE_FWRITE_TO_STDERR_WITH_FORMAT_STRING( \
-          "Error: rcutils_char_array_strncat failed with: %d\n", \
+          "Error: rcutils_logging_append_output failed with: %d\n", \
           status); \
       } \
     } \
   }
+// The severity must have been checked with rcutils_logging_is_valid_severity().
 # define SET_OUTPUT_COLOR_WITH_SEVERITY(status, severity, output_array) \
-  { \
-    const char * color = NULL; \
-    SET_COLOR_WITH_SEVERITY(status, severity, color) \
-    SET_OUTPUT_COLOR_WITH_COLOR(status, color, output_array) \
-  }
+  SET_OUTPUT_COLOR_WITH_COLOR(status, g_rcutils_logging_severity_colors[severity], output_array)
 # define SET_STANDARD_COLOR_IN_BUFFER(is_colorized, status, output_array) \
   { \
     if (is_colorized) { \
-      SET_OUTPUT_COLOR_WITH_COLOR(status, COLOR_NORMAL, output_array) \
+      SET_OUTPUT_COLOR_WITH_COLOR(status, g_rcutils_logging_standard_color, output_array) \
     } \
   }
 # define SET_STANDARD_COLOR_IN_STREAM(is_colorized, status)
 #endif
 
+// Format the message directly into the log record, appending it to what's already in
+// output_array, or into message if it isn't NULL, see rcutils_logging_format_record().
+static rcutils_ret_t rcutils_logging_format_console_message(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * format, va_list * args, rcutils_char_array_t * output_array,
+  rcutils_char_array_t * message, size_t * message_offset)
+{
+  const logging_input logging_input = {
+    .location = location,
+    .severity = severity,
+    .name = name,
+    .timestamp = timestamp,
+    .msg = NULL,
+    .format = format,
+    .args = args
+  };
+  rcutils_time_point_value_t start = 0;
+  if (g_rcutils_logging_statistics_enabled) {
+    start = rcutils_logging_statistics_start_timer();
+  }
+  rcutils_ret_t status = rcutils_logging_format_record(
+    &logging_input, output_array, message, message_offset);
+  if (RCUTILS_RET_OK != status) {
+    RCUTILS_SAFE_FWRITE_TO_STDERR_WITH_FORMAT_STRING(
+      "Error: rcutils_logging_format_message failed with: %d\n", status);
+  }
+  if (g_rcutils_logging_statistics_enabled) {
+    rcutils_logging_statistics_add_format_time(start);
+  }
+  return status;
+}
+
+static bool rcutils_logging_is_valid_severity(int severity)
+{
+  switch (severity) {
+    case RCUTILS_LOG_SEVERITY_DEBUG:
+    case RCUTILS_LOG_SEVERITY_INFO:
+    case RCUTILS_LOG_SEVERITY_WARN:
+    case RCUTILS_LOG_SEVERITY_ERROR:
+    case RCUTILS_LOG_SEVERITY_FATAL:
+      return true;
+    default:
+      RCUTILS_SAFE_FWRITE_TO_STDERR_WITH_FORMAT_STRING(
+        "unknown severity level: %d\n", severity);
+      return false;
+  }
+}
+
+rcutils_ret_t rcutils_logging_format_console_record(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * format, va_list * args, rcutils_char_array_t * output_array)
+{
+  rcutils_ret_t status = RCUTILS_RET_OK;
+  bool is_colorized = false;
+
+  if (!rcutils_logging_is_valid_severity(severity)) {
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+
+  // On Windows the color is a property of the console, so it can't be part of the record.
+#ifndef _WIN32
+  is_colorized = g_rcutils_logging_output_colorized;
+#endif
+
+  if (is_colorized) {
+    SET_OUTPUT_COLOR_WITH_SEVERITY(status, severity, (*output_array))
+  }
+
+  if (RCUTILS_RET_OK == status) {
+    status = rcutils_logging_format_console_message(
+      location, severity, name, timestamp, format, args, output_array, NULL, NULL);
+  }
+
+  SET_STANDARD_COLOR_IN_BUFFER(is_colorized, status, (*output_array))
+
+  if (RCUTILS_RET_OK == status) {
+    status = rcutils_logging_append_output(output_array, "\n", 1u);
+  }
+  return status;
+}
+
+rcutils_ret_t rcutils_logging_format_plain_record(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * format, va_list * args, rcutils_char_array_t * output_array)
+{
+  if (!rcutils_logging_is_valid_severity(severity)) {
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  rcutils_ret_t status = rcutils_logging_format_console_message(
+    location, severity, name, timestamp, format, args, output_array, NULL, NULL);
+  if (RCUTILS_RET_OK == status) {
+    status = rcutils_logging_append_output(output_array, "\n", 1u);
+  }
+  return status;
+}
+
+// Flush the output stream if it gathers records and the record just written requires it.
+static void rcutils_logging_flush_batched_stream(
+  int severity, rcutils_time_point_value_t timestamp)
+{
+  int64_t last_flush = rcutils_atomic_load_int64_t(&g_rcutils_logging_stream_last_flush);
+  // A timestamp before the last flush means that the system time jumped back.
+  if (severity >= RCUTILS_LOG_SEVERITY_WARN || timestamp < last_flush ||
+    timestamp - last_flush >= g_rcutils_logging_stream_flush_period)
+  {
+    fflush(g_output_stream);
+    rcutils_atomic_store(&g_rcutils_logging_stream_last_flush, timestamp);
+  }
+}
+
+FILE * rcutils_logging_get_console_output_stream(void)
+{
+  return g_output_stream;
+}
+
+// The size of the buffer each thread formats its console records in.
+// Formatting longer records allocates memory for them.
+#define RCUTILS_LOGGING_THREAD_OUTPUT_BUFFER_SIZE (2048)
+
+static RCUTILS_THREAD_LOCAL char
+  gtls_rcutils_logging_output_buffer[RCUTILS_LOGGING_THREAD_OUTPUT_BUFFER_SIZE];
+// The buffer the message is formatted in when the record is written with writev().
+static RCUTILS_THREAD_LOCAL char
+  gtls_rcutils_logging_message_buffer[RCUTILS_LOGGING_THREAD_OUTPUT_BUFFER_SIZE];
+// Set while a record is formatted in the buffers, in case the output is re-entered on the same
+// thread, e.g. by the allocator logging.
+static RCUTILS_THREAD_LOCAL bool gtls_rcutils_logging_output_buffer_in_use = false;
+
+#ifndef _WIN32
+// Write the record as the output before the message, the message and the rest of the output,
+// with a single system call in the common case, returns the number of bytes written.
+// The message isn't part of the output if message_offset is past its end.
+static size_t rcutils_logging_writev_record(
+  const rcutils_char_array_t * output_array, const rcutils_char_array_t * message_array,
+  size_t message_offset)
+{
+  size_t output_length = output_array->buffer_length - 1u;
+  struct iovec spans[3];
+  struct iovec * next = spans;
+  int count = 1;
+  if (message_offset > output_length) {
+    spans[0].iov_base = output_array->buffer;
+    spans[0].iov_len = output_length;
+  } else {
+    spans[0].iov_base = output_array->buffer;
+    spans[0].iov_len = message_offset;
+    spans[1].iov_base = message_array->buffer;
+    spans[1].iov_len = message_array->buffer_length - 1u;
+    spans[2].iov_base = output_array->buffer + message_offset;
+    spans[2].iov_len = output_length - message_offset;
+    count = 3;
+  }
+  // Whatever was written to the stream by other means comes first.
+  fflush(g_output_stream);
+  int fd = fileno(g_output_stream);
+  size_t written = 0u;
+  while (count > 0) {
+    ssize_t ret = writev(fd, next, count);
+    if (ret < 0) {
+      if (EINTR == errno) {
+        continue;
+      }
+      break;
+    }
+    written += (size_t)ret;
+    // Resume after the bytes written if the write was partial.
+    size_t remaining = (size_t)ret;
+    while (count > 0 && remaining >= next->iov_len) {
+      remaining -= next->iov_len;
+      ++next;
+      --count;
+    }
+    if (count > 0) {
+      next->iov_base = (char *)next->iov_base + remaining;
+      next->iov_len -= remaining;
+    }
+  }
+  return written;
+}
+#endif
+
 void rcutils_logging_console_output_handler(
   const rcutils_log_location_t * location,
   int severity, const char * name, rcutils_time_point_value_t timestamp,
@@ -912,80 +2392,86 @@ void rcutils_logging_console_output_handler(
       "call to rcutils_logging_console_output_handler failed.\n");
     return;
   }
-  switch (severity) {
-    case RCUTILS_LOG_SEVERITY_DEBUG:
-    case RCUTILS_LOG_SEVERITY_INFO:
-    case RCUTILS_LOG_SEVERITY_WARN:
-    case RCUTILS_LOG_SEVERITY_ERROR:
-    case RCUTILS_LOG_SEVERITY_FATAL:
-      break;
-    default:
-      RCUTILS_SAFE_FWRITE_TO_STDERR_WITH_FORMAT_STRING(
-        "unknown severity level: %d\n", severity);
-      return;
+  if (!rcutils_logging_is_valid_severity(severity)) {
+    return;
   }
 
-  IS_OUTPUT_COLORIZED(is_colorized)
+  is_colorized = g_rcutils_logging_output_colorized;
 
-  char msg_buf[1024] = "";
-  rcutils_char_array_t msg_array = {
-    .buffer = msg_buf,
+  // The record is formatted in place: the message is printed directly into it, or into its
+  // own buffer when the record is written with writev(), so that a long message is never
+  // copied.
+  char fallback_buffer[256] = "";
+  char fallback_message_buffer[256] = "";
+  bool uses_thread_buffer = !gtls_rcutils_logging_output_buffer_in_use;
+  rcutils_char_array_t output_array = {
+    .buffer = uses_thread_buffer ? gtls_rcutils_logging_output_buffer : fallback_buffer,
     .owns_buffer = false,
-    .buffer_length = 0u,
-    .buffer_capacity = sizeof(msg_buf),
+    .buffer_length = 1u,
+    .buffer_capacity =
+      uses_thread_buffer ? sizeof(gtls_rcutils_logging_output_buffer) : sizeof(fallback_buffer),
     .allocator = g_rcutils_logging_allocator
   };
-
-  char output_buf[1024] = "";
-  rcutils_char_array_t output_array = {
-    .buffer = output_buf,
+  rcutils_char_array_t message_array = {
+    .buffer = uses_thread_buffer ? gtls_rcutils_logging_message_buffer : fallback_message_buffer,
     .owns_buffer = false,
-    .buffer_length = 0u,
-    .buffer_capacity = sizeof(output_buf),
+    .buffer_length = 1u,
+    .buffer_capacity = uses_thread_buffer ?
+      sizeof(gtls_rcutils_logging_message_buffer) : sizeof(fallback_message_buffer),
     .allocator = g_rcutils_logging_allocator
   };
+  output_array.buffer[0] = '\0';
+  message_array.buffer[0] = '\0';
+  size_t message_offset = SIZE_MAX;
+  bool uses_writev = g_rcutils_logging_stream_writev;
+  gtls_rcutils_logging_output_buffer_in_use = true;
 
   if (is_colorized) {
     SET_OUTPUT_COLOR_WITH_SEVERITY(status, severity, output_array)
   }
 
   if (RCUTILS_RET_OK == status) {
-    va_list args_clone;
-    va_copy(args_clone, *args);
-    status = rcutils_char_array_vsprintf(&msg_array, format, args_clone);
-    if (RCUTILS_RET_OK != status) {
-      RCUTILS_SAFE_FWRITE_TO_STDERR_WITH_FORMAT_STRING(
-        "Error: rcutils_char_array_vsprintf failed with: %d\n", status);
-    }
-    va_end(args_clone);
-  }
-
-  if (RCUTILS_RET_OK == status) {
-    status = rcutils_logging_format_message(
-      location, severity, name, timestamp, msg_array.buffer, &output_array);
-    if (RCUTILS_RET_OK != status) {
-      RCUTILS_SAFE_FWRITE_TO_STDERR_WITH_FORMAT_STRING(
-        "Error: rcutils_logging_format_message failed with: %d\n", status);
-    }
+    status = rcutils_logging_format_console_message(
+      location, severity, name, timestamp, format, args, &output_array,
+      uses_writev ? &message_array : NULL, &message_offset);
   }
 
   // Does nothing in windows
   SET_STANDARD_COLOR_IN_BUFFER(is_colorized, status, output_array)
 
   if (RCUTILS_RET_OK == status) {
-    fprintf(g_output_stream, "%s\n", output_array.buffer);
+    status = rcutils_logging_append_output(&output_array, "\n", 1u);
+  }
+
+  if (RCUTILS_RET_OK == status) {
+    size_t written = 0u;
+#ifndef _WIN32
+    if (uses_writev) {
+      written = rcutils_logging_writev_record(&output_array, &message_array, message_offset);
+    } else
+#endif
+    {
+      written =
+        fwrite(output_array.buffer, 1u, output_array.buffer_length - 1u, g_output_stream);
+    }
+    if (g_rcutils_logging_statistics_enabled) {
+      rcutils_logging_statistics_count_bytes(written);
+    }
+    if (g_rcutils_logging_stream_batched) {
+      rcutils_logging_flush_batched_stream(severity, timestamp);
+    }
   }
 
   // Only does something in windows
   // cppcheck-suppress uninitvar  // suppress cppcheck false positive
   SET_STANDARD_COLOR_IN_STREAM(is_colorized, status)
 
-  status = rcutils_char_array_fini(&msg_array);
-  if (RCUTILS_RET_OK != status) {
-    RCUTILS_SAFE_FWRITE_TO_STDERR("Failed to fini array.\n");
+  if (uses_thread_buffer) {
+    gtls_rcutils_logging_output_buffer_in_use = false;
   }
-  status = rcutils_char_array_fini(&output_array);
-  if (RCUTILS_RET_OK != status) {
+  if (RCUTILS_RET_OK != rcutils_char_array_fini(&output_array) ||
+    RCUTILS_RET_OK != rcutils_char_array_fini(&message_array))
+  {
     RCUTILS_SAFE_FWRITE_TO_STDERR("Failed to fini array.\n");
   }
 }
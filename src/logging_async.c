@@ -0,0 +1,1067 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+// See the comment in logging.c about warning C5105.
+# pragma warning(push)
+# pragma warning(disable : 5105)
+# include <windows.h>
+# pragma warning(pop)
+#else
+# include <pthread.h>
+# include <sched.h>
+# include <time.h>
+#endif
+
+#include "rcutils/allocator.h"
+#include "rcutils/error_handling.h"
+#include "rcutils/logging.h"
+#include "rcutils/logging_async.h"
+#include "rcutils/stdatomic_helper.h"
+#include "rcutils/types/char_array.h"
+
+#include "./logging_internal.h"
+
+// The writer thread gathers records into a buffer of at least this size before writing them
+// to the stream at once.
+#define RCUTILS_LOGGING_ASYNC_BATCH_SIZE (16384u)
+
+// The time the writer thread sleeps for when the queue is empty.
+#define RCUTILS_LOGGING_ASYNC_IDLE_SLEEP_MS (1)
+
+// Records captured with their arguments which don't fit in this size are formatted eagerly.
+#define RCUTILS_LOGGING_ASYNC_MAX_DEFERRED_RECORD_SIZE (1024u)
+
+// Conversion specifications of deferred records longer than this are formatted eagerly.
+#define RCUTILS_LOGGING_ASYNC_MAX_CONVERSION_LENGTH (32u)
+
+// The type of the argument for a conversion specification of a printf format string.
+typedef enum rcutils_logging_async_arg_type_t
+{
+  // The specification is "%%".
+  RCUTILS_LOGGING_ASYNC_ARG_NONE,
+  RCUTILS_LOGGING_ASYNC_ARG_INT,
+  RCUTILS_LOGGING_ASYNC_ARG_LONG,
+  RCUTILS_LOGGING_ASYNC_ARG_LONG_LONG,
+  RCUTILS_LOGGING_ASYNC_ARG_INTMAX,
+  RCUTILS_LOGGING_ASYNC_ARG_SIZE,
+  RCUTILS_LOGGING_ASYNC_ARG_PTRDIFF,
+  RCUTILS_LOGGING_ASYNC_ARG_DOUBLE,
+  RCUTILS_LOGGING_ASYNC_ARG_LONG_DOUBLE,
+  RCUTILS_LOGGING_ASYNC_ARG_POINTER,
+  RCUTILS_LOGGING_ASYNC_ARG_STRING,
+  // Wide characters, %n, positional arguments and invalid specifications.
+  RCUTILS_LOGGING_ASYNC_ARG_UNSUPPORTED,
+} rcutils_logging_async_arg_type_t;
+
+typedef struct rcutils_logging_async_conversion_t
+{
+  // The length of the specification including the '%'.
+  size_t length;
+  // Whether the width and the precision are given as int arguments with '*'.
+  bool width_arg;
+  bool precision_arg;
+  // The precision given in the specification, or -1.
+  int precision;
+  rcutils_logging_async_arg_type_t type;
+} rcutils_logging_async_conversion_t;
+
+// The beginning of a record captured with its arguments, followed by the logger name including
+// the terminating null byte, and the arguments for each conversion specification of the format.
+// Strings are copied including the terminating null byte, other arguments as they are.
+typedef struct rcutils_logging_async_deferred_header_t
+{
+  // Copied, since callers may pass a location on their stack.
+  rcutils_log_location_t location;
+  bool has_location;
+  const char * format;
+  rcutils_time_point_value_t timestamp;
+  int severity;
+  bool has_name;
+} rcutils_logging_async_deferred_header_t;
+
+// A slot of the bounded queue, see
+// https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+// The sequence is equal to the position of the record which may be written into the slot
+// next, and to that position plus one once the record can be read.
+// Besides the writer thread, producers dequeue records too when dropping the oldest ones,
+// which is why the multiple consumers variant of the queue is used.
+typedef struct rcutils_logging_async_slot_t
+{
+  atomic_uint_least64_t sequence;
+  size_t length;
+  // Whether the record was captured with its arguments rather than formatted.
+  bool deferred;
+} rcutils_logging_async_slot_t;
+
+typedef struct rcutils_logging_async_state_t
+{
+  rcutils_logging_async_slot_t * slots;
+  // The records, max_record_size bytes for each slot.
+  char * records;
+  // Buffer of the writer thread to gather records in.
+  char * batch;
+  size_t batch_capacity;
+  // Buffers of the writer thread to format the deferred records.
+  char * deferred_record;
+  rcutils_char_array_t deferred_message;
+  rcutils_char_array_t deferred_output;
+  size_t mask;
+  size_t max_record_size;
+  rcutils_logging_async_overflow_policy_t overflow_policy;
+  bool defer_formatting;
+  FILE * stream;
+  rcutils_allocator_t allocator;
+  atomic_uint_least64_t enqueue_position;
+  atomic_uint_least64_t dequeue_position;
+  // The attributes the writer thread sets when it starts, and the outcome it reports back.
+  const rcutils_thread_attributes_t * writer_thread_attributes;
+  rcutils_ret_t writer_thread_attributes_ret;
+  rcutils_error_string_t writer_thread_attributes_error;
+#ifdef _WIN32
+  HANDLE thread;
+#else
+  pthread_t thread;
+#endif
+} rcutils_logging_async_state_t;
+
+static rcutils_logging_async_state_t g_rcutils_logging_async;
+
+// Whether the output handler puts records into the queue.
+static atomic_bool g_rcutils_logging_async_running = ATOMIC_VAR_INIT(false);
+// Set once no more records can be put into the queue, to let the writer thread exit.
+static atomic_bool g_rcutils_logging_async_exit = ATOMIC_VAR_INIT(false);
+// Set by the writer thread once it has set its attributes, successfully or not.
+static atomic_bool g_rcutils_logging_async_writer_ready = ATOMIC_VAR_INIT(false);
+// The number of threads in the output handler which saw it running, so the queue can't be
+// freed under their feet.
+static atomic_uint_least64_t g_rcutils_logging_async_producers = ATOMIC_VAR_INIT(0);
+
+static atomic_uint_least64_t g_rcutils_logging_async_enqueued = ATOMIC_VAR_INIT(0);
+static atomic_uint_least64_t g_rcutils_logging_async_written = ATOMIC_VAR_INIT(0);
+static atomic_uint_least64_t g_rcutils_logging_async_dropped = ATOMIC_VAR_INIT(0);
+static atomic_uint_least64_t g_rcutils_logging_async_truncated = ATOMIC_VAR_INIT(0);
+// The number of enqueued records which have been written or dropped.
+static atomic_uint_least64_t g_rcutils_logging_async_completed = ATOMIC_VAR_INIT(0);
+
+static void rcutils_logging_async_sleep(void)
+{
+#ifdef _WIN32
+  Sleep(RCUTILS_LOGGING_ASYNC_IDLE_SLEEP_MS);
+#else
+  struct timespec duration = {0, RCUTILS_LOGGING_ASYNC_IDLE_SLEEP_MS * 1000000L};
+  nanosleep(&duration, NULL);
+#endif
+}
+
+static void rcutils_logging_async_yield(void)
+{
+#ifdef _WIN32
+  SwitchToThread();
+#else
+  sched_yield();
+#endif
+}
+
+static bool rcutils_logging_async_try_enqueue(const char * record, size_t length, bool deferred)
+{
+  rcutils_logging_async_state_t * state = &g_rcutils_logging_async;
+  rcutils_logging_async_slot_t * slot = NULL;
+  uint64_t position = rcutils_atomic_load_uint64_t(&state->enqueue_position);
+  for (;;) {
+    slot = &state->slots[position & state->mask];
+    uint64_t sequence = rcutils_atomic_load_uint64_t(&slot->sequence);
+    int64_t difference = (int64_t)(sequence - position);
+    if (0 == difference) {
+      // On failure, position is updated to the current enqueue position.
+      if (rcutils_atomic_compare_exchange_strong_uint_least64_t(
+          &state->enqueue_position, &position, position + 1))
+      {
+        break;
+      }
+    } else if (difference < 0) {
+      // The record of the previous lap hasn't been read yet, the queue is full.
+      return false;
+    } else {
+      position = rcutils_atomic_load_uint64_t(&state->enqueue_position);
+    }
+  }
+  memcpy(
+    state->records + (position & state->mask) * state->max_record_size, record, length);
+  slot->length = length;
+  slot->deferred = deferred;
+  rcutils_atomic_store(&slot->sequence, position + 1);
+  return true;
+}
+
+// Take the oldest record out of the queue, copying it to output if not NULL.
+// Returns the length of the record, or 0 if the queue is empty.
+// The output must have room for max_record_size bytes.
+static size_t rcutils_logging_async_try_dequeue(char * output, bool * deferred)
+{
+  rcutils_logging_async_state_t * state = &g_rcutils_logging_async;
+  rcutils_logging_async_slot_t * slot = NULL;
+  uint64_t position = rcutils_atomic_load_uint64_t(&state->dequeue_position);
+  for (;;) {
+    slot = &state->slots[position & state->mask];
+    uint64_t sequence = rcutils_atomic_load_uint64_t(&slot->sequence);
+    int64_t difference = (int64_t)(sequence - (position + 1));
+    if (0 == difference) {
+      if (rcutils_atomic_compare_exchange_strong_uint_least64_t(
+          &state->dequeue_position, &position, position + 1))
+      {
+        break;
+      }
+    } else if (difference < 0) {
+      return 0u;
+    } else {
+      position = rcutils_atomic_load_uint64_t(&state->dequeue_position);
+    }
+  }
+  size_t length = slot->length;
+  if (NULL != deferred) {
+    *deferred = slot->deferred;
+  }
+  if (NULL != output) {
+    memcpy(
+      output, state->records + (position & state->mask) * state->max_record_size, length);
+  }
+  rcutils_atomic_store(&slot->sequence, position + state->mask + 1);
+  return length;
+}
+
+// Parse the conversion specification starting with the '%' at spec.
+static void rcutils_logging_async_parse_conversion(
+  const char * spec, rcutils_logging_async_conversion_t * conversion)
+{
+  const char * c = spec + 1;
+  conversion->width_arg = false;
+  conversion->precision_arg = false;
+  conversion->precision = -1;
+  conversion->type = RCUTILS_LOGGING_ASYNC_ARG_UNSUPPORTED;
+  if ('%' == *c) {
+    conversion->type = RCUTILS_LOGGING_ASYNC_ARG_NONE;
+    conversion->length = 2u;
+    return;
+  }
+  while ('-' == *c || '+' == *c || ' ' == *c || '#' == *c || '0' == *c || '\'' == *c) {
+    ++c;
+  }
+  if ('*' == *c) {
+    conversion->width_arg = true;
+    ++c;
+  } else {
+    while (isdigit((unsigned char)*c)) {
+      ++c;
+    }
+  }
+  if ('.' == *c) {
+    ++c;
+    if ('*' == *c) {
+      conversion->precision_arg = true;
+      ++c;
+    } else {
+      conversion->precision = 0;
+      while (isdigit((unsigned char)*c)) {
+        if (conversion->precision < INT32_MAX / 10) {
+          conversion->precision = conversion->precision * 10 + (*c - '0');
+        }
+        ++c;
+      }
+    }
+  }
+
+  // The length modifier, 'H' standing for "hh" and 'q' for "ll".
+  char modifier = '\0';
+  if ('h' == *c || 'l' == *c || 'j' == *c || 'z' == *c || 't' == *c || 'L' == *c) {
+    modifier = *c++;
+    if ('h' == modifier && 'h' == *c) {
+      modifier = 'H';
+      ++c;
+    } else if ('l' == modifier && 'l' == *c) {
+      modifier = 'q';
+      ++c;
+    }
+  }
+
+  switch (*c) {
+    case 'd':
+    case 'i':
+    case 'u':
+    case 'o':
+    case 'x':
+    case 'X':
+      if ('\0' == modifier || 'h' == modifier || 'H' == modifier) {
+        conversion->type = RCUTILS_LOGGING_ASYNC_ARG_INT;
+      } else if ('l' == modifier) {
+        conversion->type = RCUTILS_LOGGING_ASYNC_ARG_LONG;
+      } else if ('q' == modifier) {
+        conversion->type = RCUTILS_LOGGING_ASYNC_ARG_LONG_LONG;
+      } else if ('j' == modifier) {
+        conversion->type = RCUTILS_LOGGING_ASYNC_ARG_INTMAX;
+      } else if ('z' == modifier) {
+        conversion->type = RCUTILS_LOGGING_ASYNC_ARG_SIZE;
+      } else if ('t' == modifier) {
+        conversion->type = RCUTILS_LOGGING_ASYNC_ARG_PTRDIFF;
+      }
+      break;
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+      if ('\0' == modifier || 'l' == modifier) {
+        conversion->type = RCUTILS_LOGGING_ASYNC_ARG_DOUBLE;
+      } else if ('L' == modifier) {
+        conversion->type = RCUTILS_LOGGING_ASYNC_ARG_LONG_DOUBLE;
+      }
+      break;
+    case 'c':
+      if ('\0' == modifier) {
+        conversion->type = RCUTILS_LOGGING_ASYNC_ARG_INT;
+      }
+      break;
+    case 's':
+      if ('\0' == modifier) {
+        conversion->type = RCUTILS_LOGGING_ASYNC_ARG_STRING;
+      }
+      break;
+    case 'p':
+      if ('\0' == modifier) {
+        conversion->type = RCUTILS_LOGGING_ASYNC_ARG_POINTER;
+      }
+      break;
+    default:
+      break;
+  }
+  if ('\0' != *c) {
+    ++c;
+  }
+  conversion->length = (size_t)(c - spec);
+}
+
+#define RCUTILS_LOGGING_ASYNC_STORE_ARG(value) \
+  do { \
+    if (sizeof(value) > capacity - length) { \
+      return 0u; \
+    } \
+    memcpy(record + length, &value, sizeof(value)); \
+    length += sizeof(value); \
+  } while (0)
+
+#define RCUTILS_LOGGING_ASYNC_CAPTURE_ARG(type) \
+  do { \
+    type value = va_arg(*args, type); \
+    RCUTILS_LOGGING_ASYNC_STORE_ARG(value); \
+  } while (0)
+
+// Store the record with the arguments of its format string instead of formatting it.
+// Returns the length of the record, or 0 if it doesn't fit in capacity or if the format
+// contains a conversion specification which isn't supported.
+static size_t rcutils_logging_async_capture(
+  char * record, size_t capacity,
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * format, va_list * args)
+{
+  rcutils_logging_async_deferred_header_t header = {
+    .has_location = NULL != location,
+    .format = format,
+    .timestamp = timestamp,
+    .severity = severity,
+    .has_name = NULL != name,
+  };
+  if (NULL != location) {
+    header.location = *location;
+  }
+  size_t name_length = NULL == name ? 0u : strlen(name);
+  size_t length = sizeof(header) + name_length + 1u;
+  if (length > capacity) {
+    return 0u;
+  }
+  memcpy(record, &header, sizeof(header));
+  if (name_length > 0u) {
+    memcpy(record + sizeof(header), name, name_length);
+  }
+  record[sizeof(header) + name_length] = '\0';
+
+  const char * c = format;
+  while ('\0' != *c) {
+    if ('%' != *c) {
+      ++c;
+      continue;
+    }
+    rcutils_logging_async_conversion_t conversion;
+    rcutils_logging_async_parse_conversion(c, &conversion);
+    if (RCUTILS_LOGGING_ASYNC_ARG_UNSUPPORTED == conversion.type ||
+      conversion.length >= RCUTILS_LOGGING_ASYNC_MAX_CONVERSION_LENGTH)
+    {
+      return 0u;
+    }
+    c += conversion.length;
+    if (conversion.width_arg) {
+      RCUTILS_LOGGING_ASYNC_CAPTURE_ARG(int);
+    }
+    if (conversion.precision_arg) {
+      int precision = va_arg(*args, int);
+      RCUTILS_LOGGING_ASYNC_STORE_ARG(precision);
+      // A negative precision is taken as if it was omitted.
+      conversion.precision = precision < 0 ? -1 : precision;
+    }
+    switch (conversion.type) {
+      case RCUTILS_LOGGING_ASYNC_ARG_INT:
+        RCUTILS_LOGGING_ASYNC_CAPTURE_ARG(int);
+        break;
+      case RCUTILS_LOGGING_ASYNC_ARG_LONG:
+        RCUTILS_LOGGING_ASYNC_CAPTURE_ARG(long);  // NOLINT(runtime/int)
+        break;
+      case RCUTILS_LOGGING_ASYNC_ARG_LONG_LONG:
+        RCUTILS_LOGGING_ASYNC_CAPTURE_ARG(long long);  // NOLINT(runtime/int)
+        break;
+      case RCUTILS_LOGGING_ASYNC_ARG_INTMAX:
+        RCUTILS_LOGGING_ASYNC_CAPTURE_ARG(intmax_t);
+        break;
+      case RCUTILS_LOGGING_ASYNC_ARG_SIZE:
+        RCUTILS_LOGGING_ASYNC_CAPTURE_ARG(size_t);
+        break;
+      case RCUTILS_LOGGING_ASYNC_ARG_PTRDIFF:
+        RCUTILS_LOGGING_ASYNC_CAPTURE_ARG(ptrdiff_t);
+        break;
+      case RCUTILS_LOGGING_ASYNC_ARG_DOUBLE:
+        RCUTILS_LOGGING_ASYNC_CAPTURE_ARG(double);
+        break;
+      case RCUTILS_LOGGING_ASYNC_ARG_LONG_DOUBLE:
+        RCUTILS_LOGGING_ASYNC_CAPTURE_ARG(long double);
+        break;
+      case RCUTILS_LOGGING_ASYNC_ARG_POINTER:
+        RCUTILS_LOGGING_ASYNC_CAPTURE_ARG(void *);
+        break;
+      case RCUTILS_LOGGING_ASYNC_ARG_STRING:
+        {
+          const char * value = va_arg(*args, const char *);
+          if (NULL == value) {
+            return 0u;
+          }
+          // With a precision the string doesn't need to be null terminated.
+          size_t value_length = 0u;
+          if (conversion.precision >= 0) {
+            const char * end = memchr(value, '\0', (size_t)conversion.precision);
+            value_length = NULL == end ? (size_t)conversion.precision : (size_t)(end - value);
+          } else {
+            value_length = strlen(value);
+          }
+          if (value_length + 1u > capacity - length) {
+            return 0u;
+          }
+          memcpy(record + length, value, value_length);
+          record[length + value_length] = '\0';
+          length += value_length + 1u;
+        }
+        break;
+      case RCUTILS_LOGGING_ASYNC_ARG_NONE:
+      default:
+        break;
+    }
+  }
+  return length;
+}
+
+static rcutils_ret_t rcutils_logging_async_append_formatted(
+  rcutils_char_array_t * output, const char * format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  rcutils_ret_t ret = rcutils_logging_append_output_vsprintf(output, format, &args);
+  va_end(args);
+  return ret;
+}
+
+#define RCUTILS_LOGGING_ASYNC_RENDER_ARG(type) \
+  do { \
+    type value; \
+    memcpy(&value, cursor, sizeof(value)); \
+    cursor += sizeof(value); \
+    if (conversion.width_arg && conversion.precision_arg) { \
+      ret = rcutils_logging_async_append_formatted(message, spec, width, precision, value); \
+    } else if (conversion.width_arg) { \
+      ret = rcutils_logging_async_append_formatted(message, spec, width, value); \
+    } else if (conversion.precision_arg) { \
+      ret = rcutils_logging_async_append_formatted(message, spec, precision, value); \
+    } else { \
+      ret = rcutils_logging_async_append_formatted(message, spec, value); \
+    } \
+  } while (0)
+
+// Format the message of a record stored by rcutils_logging_async_capture().
+static rcutils_ret_t rcutils_logging_async_render(
+  const char * record, const rcutils_logging_async_deferred_header_t * header,
+  rcutils_char_array_t * message)
+{
+  const char * cursor = record + sizeof(*header);
+  cursor += strlen(cursor) + 1u;
+  message->buffer_length = 1u;
+  message->buffer[0] = '\0';
+
+  rcutils_ret_t ret = RCUTILS_RET_OK;
+  const char * c = header->format;
+  while ('\0' != *c && RCUTILS_RET_OK == ret) {
+    const char * literal_end = strchr(c, '%');
+    if (NULL == literal_end) {
+      literal_end = c + strlen(c);
+    }
+    if (literal_end != c) {
+      ret = rcutils_logging_append_output(message, c, (size_t)(literal_end - c));
+      c = literal_end;
+      continue;
+    }
+
+    rcutils_logging_async_conversion_t conversion;
+    rcutils_logging_async_parse_conversion(c, &conversion);
+    char spec[RCUTILS_LOGGING_ASYNC_MAX_CONVERSION_LENGTH];
+    memcpy(spec, c, conversion.length);
+    spec[conversion.length] = '\0';
+    c += conversion.length;
+    int width = 0;
+    int precision = 0;
+    if (conversion.width_arg) {
+      memcpy(&width, cursor, sizeof(width));
+      cursor += sizeof(width);
+    }
+    if (conversion.precision_arg) {
+      memcpy(&precision, cursor, sizeof(precision));
+      cursor += sizeof(precision);
+    }
+    switch (conversion.type) {
+      case RCUTILS_LOGGING_ASYNC_ARG_NONE:
+        ret = rcutils_logging_append_output(message, "%", 1u);
+        break;
+      case RCUTILS_LOGGING_ASYNC_ARG_INT:
+        RCUTILS_LOGGING_ASYNC_RENDER_ARG(int);
+        break;
+      case RCUTILS_LOGGING_ASYNC_ARG_LONG:
+        RCUTILS_LOGGING_ASYNC_RENDER_ARG(long);  // NOLINT(runtime/int)
+        break;
+      case RCUTILS_LOGGING_ASYNC_ARG_LONG_LONG:
+        RCUTILS_LOGGING_ASYNC_RENDER_ARG(long long);  // NOLINT(runtime/int)
+        break;
+      case RCUTILS_LOGGING_ASYNC_ARG_INTMAX:
+        RCUTILS_LOGGING_ASYNC_RENDER_ARG(intmax_t);
+        break;
+      case RCUTILS_LOGGING_ASYNC_ARG_SIZE:
+        RCUTILS_LOGGING_ASYNC_RENDER_ARG(size_t);
+        break;
+      case RCUTILS_LOGGING_ASYNC_ARG_PTRDIFF:
+        RCUTILS_LOGGING_ASYNC_RENDER_ARG(ptrdiff_t);
+        break;
+      case RCUTILS_LOGGING_ASYNC_ARG_DOUBLE:
+        RCUTILS_LOGGING_ASYNC_RENDER_ARG(double);
+        break;
+      case RCUTILS_LOGGING_ASYNC_ARG_LONG_DOUBLE:
+        RCUTILS_LOGGING_ASYNC_RENDER_ARG(long double);
+        break;
+      case RCUTILS_LOGGING_ASYNC_ARG_POINTER:
+        RCUTILS_LOGGING_ASYNC_RENDER_ARG(void *);
+        break;
+      case RCUTILS_LOGGING_ASYNC_ARG_STRING:
+        {
+          const char * value = cursor;
+          cursor += strlen(cursor) + 1u;
+          if (conversion.width_arg && conversion.precision_arg) {
+            ret = rcutils_logging_async_append_formatted(message, spec, width, precision, value);
+          } else if (conversion.width_arg) {
+            ret = rcutils_logging_async_append_formatted(message, spec, width, value);
+          } else if (conversion.precision_arg) {
+            ret = rcutils_logging_async_append_formatted(message, spec, precision, value);
+          } else {
+            ret = rcutils_logging_async_append_formatted(message, spec, value);
+          }
+        }
+        break;
+      case RCUTILS_LOGGING_ASYNC_ARG_UNSUPPORTED:
+      default:
+        // Records with such specifications are never captured.
+        ret = RCUTILS_RET_ERROR;
+        break;
+    }
+  }
+  return ret;
+}
+
+static rcutils_ret_t rcutils_logging_async_format_deferred(
+  const rcutils_logging_async_deferred_header_t * header, const char * name,
+  rcutils_char_array_t * output, const char * format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  rcutils_ret_t ret = rcutils_logging_format_console_record(
+    header->has_location ? &header->location : NULL, header->severity, name, header->timestamp,
+    format, &args, output);
+  va_end(args);
+  return ret;
+}
+
+// Format a record stored by rcutils_logging_async_capture() into output like the records
+// formatted by the output handler, returns the length of the formatted record or 0 on failure.
+static size_t rcutils_logging_async_format_deferred_record(const char * record, char * output)
+{
+  rcutils_logging_async_state_t * state = &g_rcutils_logging_async;
+  rcutils_logging_async_deferred_header_t header;
+  memcpy(&header, record, sizeof(header));
+  const char * name = header.has_name ? record + sizeof(header) : NULL;
+
+  rcutils_ret_t ret = rcutils_logging_async_render(record, &header, &state->deferred_message);
+  if (RCUTILS_RET_OK == ret) {
+    state->deferred_output.buffer_length = 1u;
+    state->deferred_output.buffer[0] = '\0';
+    ret = rcutils_logging_async_format_deferred(
+      &header, name, &state->deferred_output, "%s", state->deferred_message.buffer);
+  }
+  if (RCUTILS_RET_OK != ret) {
+    RCUTILS_SAFE_FWRITE_TO_STDERR("Failed to format a deferred log message.\n");
+    rcutils_reset_error();
+    return 0u;
+  }
+  size_t length = state->deferred_output.buffer_length - 1u;
+  if (length > state->max_record_size) {
+    rcutils_atomic_fetch_add_uint64_t(&g_rcutils_logging_async_truncated, 1u);
+    length = state->max_record_size;
+    state->deferred_output.buffer[length - 1u] = '\n';
+  }
+  memcpy(output, state->deferred_output.buffer, length);
+  return length;
+}
+
+// Write the queued records in one batch, returns the number of records taken from the queue.
+static uint64_t rcutils_logging_async_write_batch(void)
+{
+  rcutils_logging_async_state_t * state = &g_rcutils_logging_async;
+  size_t batch_length = 0u;
+  uint64_t count = 0u;
+  uint64_t written = 0u;
+  // The batch has room for one more record past RCUTILS_LOGGING_ASYNC_BATCH_SIZE.
+  while (batch_length < RCUTILS_LOGGING_ASYNC_BATCH_SIZE) {
+    bool deferred = false;
+    char * output = state->batch + batch_length;
+    size_t length = rcutils_logging_async_try_dequeue(
+      state->defer_formatting ? state->deferred_record : output, &deferred);
+    if (0u == length) {
+      break;
+    }
+    if (deferred) {
+      length = rcutils_logging_async_format_deferred_record(state->deferred_record, output);
+    } else if (state->defer_formatting) {
+      memcpy(output, state->deferred_record, length);
+    }
+    batch_length += length;
+    written += length > 0u ? 1u : 0u;
+    ++count;
+  }
+  if (0u == count) {
+    return 0u;
+  }
+  size_t written_bytes = fwrite(state->batch, 1u, batch_length, state->stream);
+  if (written_bytes != batch_length) {
+    RCUTILS_SAFE_FWRITE_TO_STDERR("Failed to write queued log messages.\n");
+  }
+  if (g_rcutils_logging_statistics_enabled) {
+    rcutils_logging_statistics_count_bytes(written_bytes);
+  }
+  fflush(state->stream);
+  rcutils_atomic_fetch_add_uint64_t(&g_rcutils_logging_async_written, written);
+  rcutils_atomic_fetch_add_uint64_t(&g_rcutils_logging_async_completed, count);
+  return count;
+}
+
+static void rcutils_logging_async_write_loop(void)
+{
+  for (;;) {
+    if (0u == rcutils_logging_async_write_batch()) {
+      if (rcutils_atomic_load_bool(&g_rcutils_logging_async_exit)) {
+        // Records may have been queued between checking the queue and the exit flag.
+        while (rcutils_logging_async_write_batch() > 0u) {
+        }
+        return;
+      }
+      rcutils_logging_async_sleep();
+    }
+  }
+}
+
+// Sets the attributes of the writer thread, and reports the outcome to
+// rcutils_logging_async_start(), which waits for it.
+static bool rcutils_logging_async_set_writer_attributes(void)
+{
+  rcutils_logging_async_state_t * state = &g_rcutils_logging_async;
+  rcutils_ret_t ret = RCUTILS_RET_OK;
+  if (NULL != state->writer_thread_attributes) {
+    ret = rcutils_thread_set_attributes(state->writer_thread_attributes);
+    if (RCUTILS_RET_OK != ret) {
+      // The error state is per thread, so it's handed over to the starting thread
+      state->writer_thread_attributes_error = rcutils_get_error_string();
+      rcutils_reset_error();
+    }
+  }
+  state->writer_thread_attributes_ret = ret;
+  rcutils_atomic_store(&g_rcutils_logging_async_writer_ready, true);
+  return RCUTILS_RET_OK == ret;
+}
+
+#ifdef _WIN32
+static DWORD WINAPI rcutils_logging_async_writer_main(LPVOID arg)
+{
+  (void)arg;
+  if (rcutils_logging_async_set_writer_attributes()) {
+    rcutils_logging_async_write_loop();
+  }
+  return 0;
+}
+#else
+static void * rcutils_logging_async_writer_main(void * arg)
+{
+  (void)arg;
+  if (rcutils_logging_async_set_writer_attributes()) {
+    rcutils_logging_async_write_loop();
+  }
+  return NULL;
+}
+#endif
+
+static void rcutils_logging_async_free(rcutils_logging_async_state_t * state)
+{
+  rcutils_allocator_t * allocator = &state->allocator;
+  allocator->deallocate(state->slots, allocator->state);
+  allocator->deallocate(state->records, allocator->state);
+  allocator->deallocate(state->batch, allocator->state);
+  allocator->deallocate(state->deferred_record, allocator->state);
+  state->slots = NULL;
+  state->records = NULL;
+  state->batch = NULL;
+  state->deferred_record = NULL;
+  // The arrays are zero initialized unless formatting is deferred.
+  if ((NULL != state->deferred_message.buffer &&
+    RCUTILS_RET_OK != rcutils_char_array_fini(&state->deferred_message)) ||
+    (NULL != state->deferred_output.buffer &&
+    RCUTILS_RET_OK != rcutils_char_array_fini(&state->deferred_output)))
+  {
+    RCUTILS_SAFE_FWRITE_TO_STDERR("Failed to fini array.\n");
+  }
+}
+
+rcutils_logging_async_options_t
+rcutils_logging_async_get_default_options(void)
+{
+  static rcutils_logging_async_options_t default_options = {
+    .queue_capacity = RCUTILS_LOGGING_ASYNC_DEFAULT_QUEUE_CAPACITY,
+    .max_record_size = RCUTILS_LOGGING_ASYNC_DEFAULT_MAX_RECORD_SIZE,
+    .overflow_policy = RCUTILS_LOGGING_ASYNC_OVERFLOW_DROP_NEWEST,
+    .defer_formatting = false,
+    .writer_thread_attributes = NULL,
+  };
+  return default_options;
+}
+
+rcutils_ret_t
+rcutils_logging_async_start(
+  const rcutils_logging_async_options_t * options,
+  rcutils_allocator_t allocator)
+{
+  RCUTILS_CHECK_ALLOCATOR_WITH_MSG(
+    &allocator, "invalid allocator", return RCUTILS_RET_INVALID_ARGUMENT);
+  rcutils_logging_async_options_t actual_options =
+    NULL == options ? rcutils_logging_async_get_default_options() : *options;
+  if (0u == actual_options.queue_capacity || actual_options.queue_capacity > SIZE_MAX / 2u) {
+    RCUTILS_SET_ERROR_MSG("queue capacity is out of range");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  // At least one byte of the record and the newline.
+  if (actual_options.max_record_size < 2u) {
+    RCUTILS_SET_ERROR_MSG("max record size must be at least 2 bytes");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  switch (actual_options.overflow_policy) {
+    case RCUTILS_LOGGING_ASYNC_OVERFLOW_DROP_NEWEST:
+    case RCUTILS_LOGGING_ASYNC_OVERFLOW_DROP_OLDEST:
+    case RCUTILS_LOGGING_ASYNC_OVERFLOW_BLOCK:
+      break;
+    default:
+      RCUTILS_SET_ERROR_MSG("invalid overflow policy");
+      return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  if (!g_rcutils_logging_initialized) {
+    RCUTILS_SET_ERROR_MSG("logging system isn't initialized");
+    return RCUTILS_RET_NOT_INITIALIZED;
+  }
+  if (rcutils_atomic_load_bool(&g_rcutils_logging_async_running)) {
+    RCUTILS_SET_ERROR_MSG("asynchronous logging is already started");
+    return RCUTILS_RET_ERROR;
+  }
+
+  size_t capacity = 1u;
+  while (capacity < actual_options.queue_capacity) {
+    capacity <<= 1u;
+  }
+  if (actual_options.max_record_size > (SIZE_MAX - RCUTILS_LOGGING_ASYNC_BATCH_SIZE) / capacity) {
+    RCUTILS_SET_ERROR_MSG("queue capacity and max record size are too large");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+
+  rcutils_logging_async_state_t * state = &g_rcutils_logging_async;
+  state->allocator = allocator;
+  state->mask = capacity - 1u;
+  state->max_record_size = actual_options.max_record_size;
+  state->overflow_policy = actual_options.overflow_policy;
+  state->defer_formatting = actual_options.defer_formatting;
+  state->stream = rcutils_logging_get_console_output_stream();
+  state->batch_capacity = RCUTILS_LOGGING_ASYNC_BATCH_SIZE + actual_options.max_record_size;
+  state->slots =
+    allocator.allocate(capacity * sizeof(rcutils_logging_async_slot_t), allocator.state);
+  state->records = allocator.allocate(capacity * state->max_record_size, allocator.state);
+  state->batch = allocator.allocate(state->batch_capacity, allocator.state);
+  state->deferred_record = NULL;
+  state->deferred_message = rcutils_get_zero_initialized_char_array();
+  state->deferred_output = rcutils_get_zero_initialized_char_array();
+  bool deferred_buffers_allocated = true;
+  if (state->defer_formatting) {
+    state->deferred_record = allocator.allocate(state->max_record_size, allocator.state);
+    deferred_buffers_allocated = NULL != state->deferred_record &&
+      RCUTILS_RET_OK == rcutils_char_array_init(
+      &state->deferred_message, state->max_record_size, &allocator) &&
+      RCUTILS_RET_OK == rcutils_char_array_init(
+      &state->deferred_output, state->max_record_size, &allocator);
+  }
+  if (NULL == state->slots || NULL == state->records || NULL == state->batch ||
+    !deferred_buffers_allocated)
+  {
+    rcutils_logging_async_free(state);
+    RCUTILS_SET_ERROR_MSG("failed to allocate memory for the log record queue");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  for (size_t i = 0u; i < capacity; ++i) {
+    rcutils_atomic_store(&state->slots[i].sequence, (uint64_t)i);
+    state->slots[i].length = 0u;
+    state->slots[i].deferred = false;
+  }
+  rcutils_atomic_store(&state->enqueue_position, (uint64_t)0u);
+  rcutils_atomic_store(&state->dequeue_position, (uint64_t)0u);
+  rcutils_atomic_store(&g_rcutils_logging_async_enqueued, (uint64_t)0u);
+  rcutils_atomic_store(&g_rcutils_logging_async_written, (uint64_t)0u);
+  rcutils_atomic_store(&g_rcutils_logging_async_dropped, (uint64_t)0u);
+  rcutils_atomic_store(&g_rcutils_logging_async_truncated, (uint64_t)0u);
+  rcutils_atomic_store(&g_rcutils_logging_async_completed, (uint64_t)0u);
+  rcutils_atomic_store(&g_rcutils_logging_async_exit, false);
+  rcutils_atomic_store(&g_rcutils_logging_async_writer_ready, false);
+  state->writer_thread_attributes = actual_options.writer_thread_attributes;
+  state->writer_thread_attributes_ret = RCUTILS_RET_OK;
+
+#ifdef _WIN32
+  state->thread = CreateThread(NULL, 0, rcutils_logging_async_writer_main, NULL, 0, NULL);
+  if (NULL == state->thread) {
+    rcutils_logging_async_free(state);
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "failed to create the log writer thread: %lu", GetLastError());
+    return RCUTILS_RET_ERROR;
+  }
+#else
+  int thread_ret = pthread_create(&state->thread, NULL, rcutils_logging_async_writer_main, NULL);
+  if (0 != thread_ret) {
+    rcutils_logging_async_free(state);
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "failed to create the log writer thread: %d", thread_ret);
+    return RCUTILS_RET_ERROR;
+  }
+#endif
+
+  // The writer thread sets its attributes before it writes, so no record is written by a
+  // thread which isn't placed as asked.
+  while (!rcutils_atomic_load_bool(&g_rcutils_logging_async_writer_ready)) {
+    rcutils_logging_async_yield();
+  }
+  state->writer_thread_attributes = NULL;
+  rcutils_atomic_store(&g_rcutils_logging_async_running, true);
+  if (RCUTILS_RET_OK != state->writer_thread_attributes_ret) {
+    // The writer thread has returned already, stopping joins it and frees the queue
+    rcutils_error_string_t error = state->writer_thread_attributes_error;
+    if (RCUTILS_RET_OK != rcutils_logging_async_stop()) {
+      rcutils_reset_error();
+    }
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "failed to set the attributes of the log writer thread: %s", error.str);
+    return RCUTILS_RET_ERROR;
+  }
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_logging_async_stop(void)
+{
+  if (!rcutils_atomic_exchange_bool(&g_rcutils_logging_async_running, false)) {
+    return RCUTILS_RET_OK;
+  }
+  // Wait for the threads which may still put records into the queue.
+  while (rcutils_atomic_load_uint64_t(&g_rcutils_logging_async_producers) > 0u) {
+    rcutils_logging_async_yield();
+  }
+  rcutils_atomic_store(&g_rcutils_logging_async_exit, true);
+
+  rcutils_ret_t ret = RCUTILS_RET_OK;
+  rcutils_logging_async_state_t * state = &g_rcutils_logging_async;
+#ifdef _WIN32
+  if (WaitForSingleObject(state->thread, INFINITE) != WAIT_OBJECT_0) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "failed to join the log writer thread: %lu", GetLastError());
+    ret = RCUTILS_RET_ERROR;
+  }
+  CloseHandle(state->thread);
+#else
+  int thread_ret = pthread_join(state->thread, NULL);
+  if (0 != thread_ret) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "failed to join the log writer thread: %d", thread_ret);
+    ret = RCUTILS_RET_ERROR;
+  }
+#endif
+  if (RCUTILS_RET_OK == ret) {
+    rcutils_logging_async_free(state);
+  }
+  return ret;
+}
+
+rcutils_ret_t
+rcutils_logging_async_flush(void)
+{
+  uint64_t target = rcutils_atomic_load_uint64_t(&g_rcutils_logging_async_enqueued);
+  while (rcutils_atomic_load_bool(&g_rcutils_logging_async_running) &&
+    rcutils_atomic_load_uint64_t(&g_rcutils_logging_async_completed) < target)
+  {
+    rcutils_logging_async_sleep();
+  }
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_logging_async_get_statistics(rcutils_logging_async_statistics_t * statistics)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(statistics, RCUTILS_RET_INVALID_ARGUMENT);
+  statistics->enqueued = rcutils_atomic_load_uint64_t(&g_rcutils_logging_async_enqueued);
+  statistics->written = rcutils_atomic_load_uint64_t(&g_rcutils_logging_async_written);
+  statistics->dropped = rcutils_atomic_load_uint64_t(&g_rcutils_logging_async_dropped);
+  statistics->truncated = rcutils_atomic_load_uint64_t(&g_rcutils_logging_async_truncated);
+  return RCUTILS_RET_OK;
+}
+
+// The severity is the one of the record, for the counters of the logging system.
+static void rcutils_logging_async_enqueue(
+  const char * record, size_t length, bool deferred, int severity)
+{
+  rcutils_logging_async_state_t * state = &g_rcutils_logging_async;
+  if (length > state->max_record_size) {
+    rcutils_atomic_fetch_add_uint64_t(&g_rcutils_logging_async_truncated, 1u);
+    length = state->max_record_size;
+  }
+  // A truncated record still ends with a newline.
+  while (!rcutils_logging_async_try_enqueue(record, length, deferred)) {
+    switch (state->overflow_policy) {
+      case RCUTILS_LOGGING_ASYNC_OVERFLOW_DROP_OLDEST:
+        if (rcutils_logging_async_try_dequeue(NULL, NULL) > 0u) {
+          rcutils_atomic_fetch_add_uint64_t(&g_rcutils_logging_async_dropped, 1u);
+          // The severity of the oldest record isn't kept, the new one makes up for it.
+          if (g_rcutils_logging_statistics_enabled) {
+            rcutils_logging_statistics_count(RCUTILS_LOGGING_STATISTICS_DROPPED, severity);
+          }
+          rcutils_atomic_fetch_add_uint64_t(&g_rcutils_logging_async_completed, 1u);
+        }
+        break;
+      case RCUTILS_LOGGING_ASYNC_OVERFLOW_BLOCK:
+        rcutils_logging_async_yield();
+        break;
+      case RCUTILS_LOGGING_ASYNC_OVERFLOW_DROP_NEWEST:
+      default:
+        rcutils_atomic_fetch_add_uint64_t(&g_rcutils_logging_async_dropped, 1u);
+        if (g_rcutils_logging_statistics_enabled) {
+          rcutils_logging_statistics_count(RCUTILS_LOGGING_STATISTICS_DROPPED, severity);
+        }
+        return;
+    }
+  }
+  rcutils_atomic_fetch_add_uint64_t(&g_rcutils_logging_async_enqueued, 1u);
+}
+
+void rcutils_logging_async_output_handler(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * format, va_list * args)
+{
+  rcutils_atomic_fetch_add_uint64_t(&g_rcutils_logging_async_producers, 1u);
+  if (!rcutils_atomic_load_bool(&g_rcutils_logging_async_running)) {
+    rcutils_atomic_fetch_add_uint64_t(&g_rcutils_logging_async_producers, UINT64_MAX);
+    rcutils_logging_console_output_handler(location, severity, name, timestamp, format, args);
+    return;
+  }
+
+  // The identity of the thread can only be formatted on it.
+  if (
+    g_rcutils_logging_async.defer_formatting &&
+    !rcutils_logging_output_format_needs(RCUTILS_LOGGING_OUTPUT_FORMAT_NEEDS_THREAD))
+  {
+    char deferred_buf[RCUTILS_LOGGING_ASYNC_MAX_DEFERRED_RECORD_SIZE];
+    size_t capacity = g_rcutils_logging_async.max_record_size < sizeof(deferred_buf) ?
+      g_rcutils_logging_async.max_record_size : sizeof(deferred_buf);
+    // The arguments are still needed to format the record if it can't be captured.
+    va_list args_clone;
+    va_copy(args_clone, *args);
+    size_t length = rcutils_logging_async_capture(
+      deferred_buf, capacity, location, severity, name, timestamp, format, &args_clone);
+    va_end(args_clone);
+    if (length > 0u) {
+      rcutils_logging_async_enqueue(deferred_buf, length, true, severity);
+      rcutils_atomic_fetch_add_uint64_t(&g_rcutils_logging_async_producers, UINT64_MAX);
+      return;
+    }
+  }
+
+  RCUTILS_CHAR_ARRAY_WITH_STACK(record_array, 1024, g_rcutils_logging_async.allocator);
+  rcutils_ret_t status = rcutils_logging_format_console_record(
+    location, severity, name, timestamp, format, args, &record_array);
+  if (RCUTILS_RET_OK == status) {
+    size_t length = record_array.buffer_length - 1u;
+    size_t max_record_size = g_rcutils_logging_async.max_record_size;
+    if (length > max_record_size) {
+      record_array.buffer[max_record_size - 1u] = '\n';
+    }
+    rcutils_logging_async_enqueue(record_array.buffer, length, false, severity);
+  }
+  rcutils_atomic_fetch_add_uint64_t(&g_rcutils_logging_async_producers, UINT64_MAX);
+
+  if (RCUTILS_RET_OK != rcutils_char_array_fini(&record_array)) {
+    RCUTILS_SAFE_FWRITE_TO_STDERR("Failed to fini array.\n");
+  }
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,171 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <limits.h>
+#include <stddef.h>
+
+#include "rcutils/allocator.h"
+#include "rcutils/error_handling.h"
+#include "rcutils/logging.h"
+#include "rcutils/logging_fanout.h"
+#include "rcutils/types/char_array.h"
+
+#include "./logging_internal.h"
+
+typedef struct rcutils_logging_fanout_sink_entry_t
+{
+  // NULL if the entry is free.
+  rcutils_logging_sink_t sink;
+  int severity;
+  void * context;
+} rcutils_logging_fanout_sink_entry_t;
+
+static rcutils_logging_fanout_sink_entry_t g_rcutils_logging_fanout_sinks[
+  RCUTILS_LOGGING_FANOUT_MAX_SINKS];
+// The lowest severity accepted by any sink, to skip formatting messages nobody receives.
+static int g_rcutils_logging_fanout_min_severity = INT_MAX;
+
+static bool rcutils_logging_fanout_is_valid_severity(int severity)
+{
+  return severity >= RCUTILS_LOG_SEVERITY_UNSET && severity <= RCUTILS_LOG_SEVERITY_FATAL;
+}
+
+static void rcutils_logging_fanout_update_min_severity(void)
+{
+  int min_severity = INT_MAX;
+  for (size_t i = 0u; i < RCUTILS_LOGGING_FANOUT_MAX_SINKS; ++i) {
+    const rcutils_logging_fanout_sink_entry_t * entry = &g_rcutils_logging_fanout_sinks[i];
+    if (NULL != entry->sink && entry->severity < min_severity) {
+      min_severity = entry->severity;
+    }
+  }
+  g_rcutils_logging_fanout_min_severity = min_severity;
+}
+
+rcutils_ret_t
+rcutils_logging_fanout_add_sink(
+  rcutils_logging_sink_t sink, int severity, void * context, size_t * sink_id)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(sink, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(sink_id, RCUTILS_RET_INVALID_ARGUMENT);
+  if (!rcutils_logging_fanout_is_valid_severity(severity)) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("invalid severity: %d", severity);
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  for (size_t i = 0u; i < RCUTILS_LOGGING_FANOUT_MAX_SINKS; ++i) {
+    rcutils_logging_fanout_sink_entry_t * entry = &g_rcutils_logging_fanout_sinks[i];
+    if (NULL == entry->sink) {
+      entry->sink = sink;
+      entry->severity = severity;
+      entry->context = context;
+      rcutils_logging_fanout_update_min_severity();
+      *sink_id = i;
+      return RCUTILS_RET_OK;
+    }
+  }
+  RCUTILS_SET_ERROR_MSG("too many logging sinks");
+  return RCUTILS_RET_ERROR;
+}
+
+rcutils_ret_t
+rcutils_logging_fanout_set_sink_severity(size_t sink_id, int severity)
+{
+  if (sink_id >= RCUTILS_LOGGING_FANOUT_MAX_SINKS ||
+    NULL == g_rcutils_logging_fanout_sinks[sink_id].sink)
+  {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("no logging sink with id %zu", sink_id);
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  if (!rcutils_logging_fanout_is_valid_severity(severity)) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("invalid severity: %d", severity);
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  g_rcutils_logging_fanout_sinks[sink_id].severity = severity;
+  rcutils_logging_fanout_update_min_severity();
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_logging_fanout_remove_sink(size_t sink_id)
+{
+  if (sink_id >= RCUTILS_LOGGING_FANOUT_MAX_SINKS ||
+    NULL == g_rcutils_logging_fanout_sinks[sink_id].sink)
+  {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("no logging sink with id %zu", sink_id);
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  g_rcutils_logging_fanout_sinks[sink_id].sink = NULL;
+  g_rcutils_logging_fanout_sinks[sink_id].context = NULL;
+  rcutils_logging_fanout_update_min_severity();
+  return RCUTILS_RET_OK;
+}
+
+void rcutils_logging_fanout_output_handler(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * format, va_list * args)
+{
+  if (severity < g_rcutils_logging_fanout_min_severity) {
+    return;
+  }
+
+  RCUTILS_CHAR_ARRAY_WITH_STACK(message_array, 1024, rcutils_get_default_allocator());
+  if (RCUTILS_RET_OK != rcutils_logging_append_output_vsprintf(&message_array, format, args)) {
+    RCUTILS_SAFE_FWRITE_TO_STDERR("Failed to format log message.\n");
+    rcutils_reset_error();
+  } else {
+    size_t length = message_array.buffer_length - 1u;
+    for (size_t i = 0u; i < RCUTILS_LOGGING_FANOUT_MAX_SINKS; ++i) {
+      const rcutils_logging_fanout_sink_entry_t * entry = &g_rcutils_logging_fanout_sinks[i];
+      if (NULL != entry->sink && severity >= entry->severity) {
+        entry->sink(
+          location, severity, name, timestamp, message_array.buffer, length, entry->context);
+      }
+    }
+  }
+
+  if (RCUTILS_RET_OK != rcutils_char_array_fini(&message_array)) {
+    RCUTILS_SAFE_FWRITE_TO_STDERR("Failed to fini array.\n");
+  }
+}
+
+static void rcutils_logging_console_sink_write(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  rcutils_logging_console_output_handler(location, severity, name, timestamp, format, &args);
+  va_end(args);
+}
+
+void rcutils_logging_console_sink(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * message, size_t length, void * context)
+{
+  (void)length;
+  (void)context;
+  rcutils_logging_console_sink_write(location, severity, name, timestamp, "%s", message);
+}
+
+#ifdef __cplusplus
+}
+#endif
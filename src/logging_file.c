@@ -0,0 +1,466 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+// See the comment in logging.c about warning C5105.
+# pragma warning(push)
+# pragma warning(disable : 5105)
+# include <windows.h>
+# pragma warning(pop)
+#else
+# include <fcntl.h>
+# include <sched.h>
+# include <sys/mman.h>
+# include <sys/types.h>
+# include <unistd.h>
+#endif
+
+#include "rcutils/allocator.h"
+#include "rcutils/error_handling.h"
+#include "rcutils/filesystem.h"
+#include "rcutils/logging.h"
+#include "rcutils/logging_file.h"
+#include "rcutils/snprintf.h"
+#include "rcutils/stdatomic_helper.h"
+#include "rcutils/strdup.h"
+#include "rcutils/strerror.h"
+#include "rcutils/types/char_array.h"
+
+#include "./logging_internal.h"
+
+typedef struct rcutils_logging_file_state_t
+{
+  char * file_path;
+  // Buffers for the names of the rotated files.
+  char * rotated_path;
+  char * next_rotated_path;
+  size_t rotated_path_size;
+  size_t max_file_size;
+  size_t max_rotated_files;
+  // The mapping of the current file, NULL if there is none.
+  char * view;
+  // The number of bytes written into the mapping.
+  size_t offset;
+#ifdef _WIN32
+  HANDLE file;
+  HANDLE mapping;
+#else
+  int fd;
+#endif
+  rcutils_allocator_t allocator;
+} rcutils_logging_file_state_t;
+
+static rcutils_logging_file_state_t g_rcutils_logging_file;
+
+// Whether a log file is open, only changed with the lock held.
+static atomic_bool g_rcutils_logging_file_open = ATOMIC_VAR_INIT(false);
+// Serializes the access to the state, held only to copy a record unless rotating.
+static atomic_bool g_rcutils_logging_file_lock = ATOMIC_VAR_INIT(false);
+
+static void rcutils_logging_file_lock(void)
+{
+  while (rcutils_atomic_exchange_bool(&g_rcutils_logging_file_lock, true)) {
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+  }
+}
+
+static void rcutils_logging_file_unlock(void)
+{
+  rcutils_atomic_store(&g_rcutils_logging_file_lock, false);
+}
+
+static void rcutils_logging_file_set_error(const char * message)
+{
+#ifdef _WIN32
+  RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("%s: %lu", message, GetLastError());
+#else
+  char error_string[1024];
+  rcutils_strerror(error_string, sizeof(error_string));
+  RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("%s: %s", message, error_string);
+#endif
+}
+
+// Create the file, pre-sized to max_file_size, and map it.
+static rcutils_ret_t rcutils_logging_file_map(rcutils_logging_file_state_t * state)
+{
+  state->offset = 0u;
+#ifdef _WIN32
+  state->file = CreateFileA(
+    state->file_path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS,
+    FILE_ATTRIBUTE_NORMAL, NULL);
+  if (INVALID_HANDLE_VALUE == state->file) {
+    rcutils_logging_file_set_error("failed to create the log file");
+    return RCUTILS_RET_ERROR;
+  }
+  ULARGE_INTEGER size;
+  size.QuadPart = state->max_file_size;
+  // Mapping more than the size of the file extends it.
+  state->mapping = CreateFileMappingA(
+    state->file, NULL, PAGE_READWRITE, size.HighPart, size.LowPart, NULL);
+  if (NULL == state->mapping) {
+    rcutils_logging_file_set_error("failed to create the mapping of the log file");
+    CloseHandle(state->file);
+    return RCUTILS_RET_ERROR;
+  }
+  state->view = MapViewOfFile(state->mapping, FILE_MAP_WRITE, 0, 0, state->max_file_size);
+  if (NULL == state->view) {
+    rcutils_logging_file_set_error("failed to map the log file");
+    CloseHandle(state->mapping);
+    CloseHandle(state->file);
+    return RCUTILS_RET_ERROR;
+  }
+#else
+  state->fd = open(state->file_path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (-1 == state->fd) {
+    rcutils_logging_file_set_error("failed to create the log file");
+    return RCUTILS_RET_ERROR;
+  }
+#ifdef __linux__
+  // Reserve the blocks, so running out of space is reported here rather than by a SIGBUS.
+  int resize_ret = posix_fallocate(state->fd, 0, (off_t)state->max_file_size);
+  if (0 != resize_ret) {
+    errno = resize_ret;
+  }
+#else
+  int resize_ret = ftruncate(state->fd, (off_t)state->max_file_size);
+#endif
+  if (0 != resize_ret) {
+    rcutils_logging_file_set_error("failed to resize the log file");
+    close(state->fd);
+    return RCUTILS_RET_ERROR;
+  }
+  void * view = mmap(
+    NULL, state->max_file_size, PROT_READ | PROT_WRITE, MAP_SHARED, state->fd, 0);
+  if (MAP_FAILED == view) {
+    rcutils_logging_file_set_error("failed to map the log file");
+    close(state->fd);
+    return RCUTILS_RET_ERROR;
+  }
+  state->view = view;
+#endif
+  return RCUTILS_RET_OK;
+}
+
+// Unmap the file, truncate it to the records written and close it.
+static rcutils_ret_t rcutils_logging_file_unmap(rcutils_logging_file_state_t * state)
+{
+  if (NULL == state->view) {
+    return RCUTILS_RET_OK;
+  }
+  rcutils_ret_t ret = RCUTILS_RET_OK;
+#ifdef _WIN32
+  UnmapViewOfFile(state->view);
+  CloseHandle(state->mapping);
+  LARGE_INTEGER offset;
+  offset.QuadPart = (LONGLONG)state->offset;
+  if (!SetFilePointerEx(state->file, offset, NULL, FILE_BEGIN) || !SetEndOfFile(state->file)) {
+    rcutils_logging_file_set_error("failed to truncate the log file");
+    ret = RCUTILS_RET_ERROR;
+  }
+  if (!CloseHandle(state->file) && RCUTILS_RET_OK == ret) {
+    rcutils_logging_file_set_error("failed to close the log file");
+    ret = RCUTILS_RET_ERROR;
+  }
+#else
+  munmap(state->view, state->max_file_size);
+  if (ftruncate(state->fd, (off_t)state->offset) != 0) {
+    rcutils_logging_file_set_error("failed to truncate the log file");
+    ret = RCUTILS_RET_ERROR;
+  }
+  if (close(state->fd) != 0 && RCUTILS_RET_OK == ret) {
+    rcutils_logging_file_set_error("failed to close the log file");
+    ret = RCUTILS_RET_ERROR;
+  }
+#endif
+  state->view = NULL;
+  return ret;
+}
+
+static void rcutils_logging_file_format_rotated_path(
+  const rcutils_logging_file_state_t * state, size_t index, char * path)
+{
+  // The buffer is large enough for any index, an empty name just makes the rename fail.
+  if (rcutils_snprintf(path, state->rotated_path_size, "%s.%zu", state->file_path, index) < 0) {
+    path[0] = '\0';
+  }
+}
+
+// Rename the rotated files one index up, and the file to the first index.
+static void rcutils_logging_file_rotate_names(rcutils_logging_file_state_t * state)
+{
+  if (0u == state->max_rotated_files) {
+    // The file is replaced when creating the new one.
+    return;
+  }
+  rcutils_logging_file_format_rotated_path(
+    state, state->max_rotated_files, state->next_rotated_path);
+  remove(state->next_rotated_path);
+  for (size_t index = state->max_rotated_files - 1u; index > 0u; --index) {
+    rcutils_logging_file_format_rotated_path(state, index, state->rotated_path);
+    // Missing rotated files are expected until as many have been written.
+    rename(state->rotated_path, state->next_rotated_path);
+    char * swap = state->next_rotated_path;
+    state->next_rotated_path = state->rotated_path;
+    state->rotated_path = swap;
+  }
+  rename(state->file_path, state->next_rotated_path);
+}
+
+static void rcutils_logging_file_free(rcutils_logging_file_state_t * state)
+{
+  rcutils_allocator_t * allocator = &state->allocator;
+  allocator->deallocate(state->file_path, allocator->state);
+  allocator->deallocate(state->rotated_path, allocator->state);
+  allocator->deallocate(state->next_rotated_path, allocator->state);
+  state->file_path = NULL;
+  state->rotated_path = NULL;
+  state->next_rotated_path = NULL;
+}
+
+rcutils_logging_file_options_t
+rcutils_logging_file_get_default_options(void)
+{
+  static rcutils_logging_file_options_t default_options = {
+    .file_path = NULL,
+    .max_file_size = RCUTILS_LOGGING_FILE_DEFAULT_MAX_FILE_SIZE,
+    .max_rotated_files = RCUTILS_LOGGING_FILE_DEFAULT_MAX_ROTATED_FILES,
+  };
+  return default_options;
+}
+
+rcutils_ret_t
+rcutils_logging_file_open(
+  const rcutils_logging_file_options_t * options,
+  rcutils_allocator_t allocator)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(options, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ALLOCATOR_WITH_MSG(
+    &allocator, "invalid allocator", return RCUTILS_RET_INVALID_ARGUMENT);
+  if (NULL == options->file_path || '\0' == options->file_path[0]) {
+    RCUTILS_SET_ERROR_MSG("log file path must be set");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  // At least one byte of a record and the newline.
+  if (options->max_file_size < 2u) {
+    RCUTILS_SET_ERROR_MSG("max file size must be at least 2 bytes");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  if (!g_rcutils_logging_initialized) {
+    RCUTILS_SET_ERROR_MSG("logging system isn't initialized");
+    return RCUTILS_RET_NOT_INITIALIZED;
+  }
+  if (rcutils_atomic_load_bool(&g_rcutils_logging_file_open)) {
+    RCUTILS_SET_ERROR_MSG("a log file is already open");
+    return RCUTILS_RET_ERROR;
+  }
+
+  rcutils_logging_file_state_t * state = &g_rcutils_logging_file;
+  state->allocator = allocator;
+  state->max_file_size = options->max_file_size;
+  state->max_rotated_files = options->max_rotated_files;
+  state->view = NULL;
+  // The path, a dot and the index.
+  state->rotated_path_size = strlen(options->file_path) + 22u;
+  state->file_path = rcutils_strdup(options->file_path, allocator);
+  state->rotated_path = allocator.allocate(state->rotated_path_size, allocator.state);
+  state->next_rotated_path = allocator.allocate(state->rotated_path_size, allocator.state);
+  if (NULL == state->file_path || NULL == state->rotated_path ||
+    NULL == state->next_rotated_path)
+  {
+    rcutils_logging_file_free(state);
+    RCUTILS_SET_ERROR_MSG("failed to allocate memory for the log file names");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+
+  if (rcutils_exists(state->file_path)) {
+    rcutils_logging_file_rotate_names(state);
+  }
+  rcutils_ret_t ret = rcutils_logging_file_map(state);
+  if (RCUTILS_RET_OK != ret) {
+    rcutils_logging_file_free(state);
+    return ret;
+  }
+
+  rcutils_logging_file_lock();
+  rcutils_atomic_store(&g_rcutils_logging_file_open, true);
+  rcutils_logging_file_unlock();
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_logging_file_close(void)
+{
+  rcutils_logging_file_lock();
+  if (!rcutils_atomic_exchange_bool(&g_rcutils_logging_file_open, false)) {
+    rcutils_logging_file_unlock();
+    return RCUTILS_RET_OK;
+  }
+  rcutils_logging_file_state_t * state = &g_rcutils_logging_file;
+  rcutils_ret_t ret = rcutils_logging_file_unmap(state);
+  rcutils_logging_file_free(state);
+  rcutils_logging_file_unlock();
+  return ret;
+}
+
+static rcutils_ret_t rcutils_logging_file_flush_view(bool wait)
+{
+  rcutils_ret_t ret = RCUTILS_RET_OK;
+  rcutils_logging_file_lock();
+  rcutils_logging_file_state_t * state = &g_rcutils_logging_file;
+  if (rcutils_atomic_load_bool(&g_rcutils_logging_file_open) && NULL != state->view &&
+    state->offset > 0u)
+  {
+#ifdef _WIN32
+    if (!FlushViewOfFile(state->view, state->offset) ||
+      (wait && !FlushFileBuffers(state->file)))
+    {
+      rcutils_logging_file_set_error("failed to flush the log file");
+      ret = RCUTILS_RET_ERROR;
+    }
+#else
+    if (msync(state->view, state->offset, wait ? MS_SYNC : MS_ASYNC) != 0 ||
+      (wait && fsync(state->fd) != 0))
+    {
+      rcutils_logging_file_set_error("failed to flush the log file");
+      ret = RCUTILS_RET_ERROR;
+    }
+#endif
+  }
+  rcutils_logging_file_unlock();
+  return ret;
+}
+
+rcutils_ret_t
+rcutils_logging_file_flush(void)
+{
+  return rcutils_logging_file_flush_view(false);
+}
+
+rcutils_ret_t
+rcutils_logging_file_sync(void)
+{
+  return rcutils_logging_file_flush_view(true);
+}
+
+// Copy the record into the mapping, rotating the file first if it doesn't fit.
+// Must be called with the lock held, returns false if no file is mapped.
+static bool rcutils_logging_file_append(const char * record, size_t length)
+{
+  rcutils_logging_file_state_t * state = &g_rcutils_logging_file;
+  if (NULL == state->view) {
+    return false;
+  }
+  if (length > state->max_file_size - state->offset) {
+    rcutils_ret_t ret = rcutils_logging_file_unmap(state);
+    if (RCUTILS_RET_OK == ret) {
+      rcutils_logging_file_rotate_names(state);
+      ret = rcutils_logging_file_map(state);
+    }
+    if (RCUTILS_RET_OK != ret) {
+      RCUTILS_SAFE_FWRITE_TO_STDERR_WITH_FORMAT_STRING(
+        "Failed to rotate the log file: %s\n", rcutils_get_error_string().str);
+      rcutils_reset_error();
+      return false;
+    }
+  }
+  memcpy(state->view + state->offset, record, length);
+  state->offset += length;
+  if (g_rcutils_logging_statistics_enabled) {
+    rcutils_logging_statistics_count_bytes(length);
+  }
+  return true;
+}
+
+void rcutils_logging_file_output_handler(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * format, va_list * args)
+{
+  if (!rcutils_atomic_load_bool(&g_rcutils_logging_file_open)) {
+    rcutils_logging_console_output_handler(location, severity, name, timestamp, format, args);
+    return;
+  }
+
+  RCUTILS_CHAR_ARRAY_WITH_STACK(record_array, 1024, rcutils_get_default_allocator());
+  rcutils_ret_t status = rcutils_logging_format_plain_record(
+    location, severity, name, timestamp, format, args, &record_array);
+  if (RCUTILS_RET_OK == status) {
+    size_t length = record_array.buffer_length - 1u;
+    bool written = false;
+    rcutils_logging_file_lock();
+    if (rcutils_atomic_load_bool(&g_rcutils_logging_file_open)) {
+      size_t max_file_size = g_rcutils_logging_file.max_file_size;
+      // A truncated record still ends with a newline.
+      if (length > max_file_size) {
+        record_array.buffer[max_file_size - 1u] = '\n';
+        length = max_file_size;
+      }
+      written = rcutils_logging_file_append(record_array.buffer, length);
+    }
+    rcutils_logging_file_unlock();
+    if (!written) {
+      // The file was closed meanwhile or couldn't be rotated.
+      FILE * stream = rcutils_logging_get_console_output_stream();
+      if (NULL != stream) {
+        size_t written_bytes = fwrite(record_array.buffer, 1u, length, stream);
+        if (g_rcutils_logging_statistics_enabled) {
+          rcutils_logging_statistics_count_bytes(written_bytes);
+        }
+      }
+    }
+  }
+
+  if (RCUTILS_RET_OK != rcutils_char_array_fini(&record_array)) {
+    RCUTILS_SAFE_FWRITE_TO_STDERR("Failed to fini array.\n");
+  }
+}
+
+static void rcutils_logging_file_sink_write(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  rcutils_logging_file_output_handler(location, severity, name, timestamp, format, &args);
+  va_end(args);
+}
+
+void rcutils_logging_file_sink(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * message, size_t length, void * context)
+{
+  (void)length;
+  (void)context;
+  rcutils_logging_file_sink_write(location, severity, name, timestamp, "%s", message);
+}
+
+#ifdef __cplusplus
+}
+#endif
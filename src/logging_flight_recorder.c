@@ -0,0 +1,313 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <assert.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "rcutils/error_handling.h"
+#include "rcutils/logging.h"
+#include "rcutils/logging_flight_recorder.h"
+#include "rcutils/mapped_file.h"
+#include "rcutils/process.h"
+#include "rcutils/snprintf.h"
+#include "rcutils/stdatomic_helper.h"
+#include "rcutils/strdup.h"
+#include "rcutils/thread.h"
+
+#include "./logging_internal.h"
+#include "./shared_file.h"
+
+static_assert(
+  sizeof(rcutils_logging_flight_recorder_header_t) == 64u,
+  "the layout of the flight recorder must not change within a version");
+static_assert(
+  sizeof(rcutils_logging_flight_recorder_record_t) == 256u,
+  "the layout of the flight recorder must not change within a version");
+
+// The atomic type has the size and alignment of the counters of the flight recorder.
+#define FLIGHT_RECORDER_ATOMIC(field) ((atomic_uint_least64_t *)(field))
+
+// The sequence of a record being written.
+#define FLIGHT_RECORDER_WRITING UINT64_MAX
+
+typedef struct rcutils_logging_flight_recorder_impl_t
+{
+  rcutils_logging_flight_recorder_header_t * header;
+  rcutils_logging_flight_recorder_record_t * records;
+  size_t size;
+  char * path;
+  rcutils_allocator_t allocator;
+} rcutils_logging_flight_recorder_impl_t;
+
+int g_rcutils_logging_flight_recorder_severity = RCUTILS_LOGGING_FLIGHT_RECORDER_STOPPED;
+// The rcutils_logging_flight_recorder_impl_t of the started recorder, or 0.
+static atomic_uintptr_t g_rcutils_logging_flight_recorder;
+
+rcutils_logging_flight_recorder_t
+rcutils_get_zero_initialized_logging_flight_recorder(void)
+{
+  static rcutils_logging_flight_recorder_t zero_initialized_recorder = {
+    .impl = NULL,
+  };
+  return zero_initialized_recorder;
+}
+
+rcutils_ret_t
+rcutils_logging_flight_recorder_init(
+  rcutils_logging_flight_recorder_t * recorder,
+  const char * path,
+  size_t capacity,
+  const rcutils_allocator_t * allocator)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(recorder, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(path, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ALLOCATOR(allocator, return RCUTILS_RET_INVALID_ARGUMENT);
+  if (NULL != recorder->impl) {
+    RCUTILS_SET_ERROR_MSG("recorder argument is not zero-initialized");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  if (0u == capacity || capacity > UINT32_MAX) {
+    RCUTILS_SET_ERROR_MSG("capacity must be more than 0 and fit in 32 bits");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+
+  rcutils_logging_flight_recorder_impl_t * impl = allocator->zero_allocate(
+    1u, sizeof(rcutils_logging_flight_recorder_impl_t), allocator->state);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    impl, "failed to allocate memory for flight recorder", return RCUTILS_RET_BAD_ALLOC);
+  impl->path = rcutils_strdup(path, *allocator);
+  if (NULL == impl->path) {
+    RCUTILS_SET_ERROR_MSG("failed to allocate memory for flight recorder");
+    allocator->deallocate(impl, allocator->state);
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+
+  impl->size = sizeof(rcutils_logging_flight_recorder_header_t) +
+    capacity * sizeof(rcutils_logging_flight_recorder_record_t);
+  void * data = NULL;
+  rcutils_ret_t ret = rcutils_shared_file_map(path, impl->size, &data);
+  if (RCUTILS_RET_OK != ret) {
+    allocator->deallocate(impl->path, allocator->state);
+    allocator->deallocate(impl, allocator->state);
+    return ret;
+  }
+
+  impl->header = (rcutils_logging_flight_recorder_header_t *)data;
+  impl->records = (rcutils_logging_flight_recorder_record_t *)(impl->header + 1);
+  impl->header->version = RCUTILS_LOGGING_FLIGHT_RECORDER_VERSION;
+  impl->header->record_size = (uint32_t)sizeof(rcutils_logging_flight_recorder_record_t);
+  impl->header->capacity = (uint32_t)capacity;
+  impl->header->pid = (uint64_t)rcutils_get_pid();
+  memcpy(
+    impl->header->magic, RCUTILS_LOGGING_FLIGHT_RECORDER_MAGIC, sizeof(impl->header->magic));
+  impl->allocator = *allocator;
+  recorder->impl = impl;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_logging_flight_recorder_fini(rcutils_logging_flight_recorder_t * recorder)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(recorder, RCUTILS_RET_INVALID_ARGUMENT);
+  rcutils_logging_flight_recorder_impl_t * impl = recorder->impl;
+  if (NULL == impl) {
+    return RCUTILS_RET_OK;
+  }
+
+  rcutils_ret_t ret = rcutils_logging_flight_recorder_stop(recorder);
+  if (RCUTILS_RET_OK == ret) {
+    ret = rcutils_shared_file_unmap(impl->path, impl->header, impl->size);
+  }
+  rcutils_allocator_t allocator = impl->allocator;
+  allocator.deallocate(impl->path, allocator.state);
+  allocator.deallocate(impl, allocator.state);
+  recorder->impl = NULL;
+  return ret;
+}
+
+rcutils_ret_t
+rcutils_logging_flight_recorder_start(
+  rcutils_logging_flight_recorder_t * recorder, int severity)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(recorder, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    recorder->impl, "recorder is not initialized", return RCUTILS_RET_INVALID_ARGUMENT);
+  if (severity < RCUTILS_LOG_SEVERITY_UNSET || severity > RCUTILS_LOG_SEVERITY_FATAL) {
+    RCUTILS_SET_ERROR_MSG("invalid severity");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+
+  // The recorder is published before the severity, so that messages recorded are written to it
+  rcutils_atomic_store_explicit(
+    &g_rcutils_logging_flight_recorder, (uintptr_t)recorder->impl, memory_order_release);
+  rcutils_atomic_store_explicit(
+    (atomic_int *)&g_rcutils_logging_flight_recorder_severity, severity, memory_order_relaxed);
+  rcutils_logging_update_lowest_enabled_severity();
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_logging_flight_recorder_stop(rcutils_logging_flight_recorder_t * recorder)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(recorder, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    recorder->impl, "recorder is not initialized", return RCUTILS_RET_INVALID_ARGUMENT);
+
+  uintptr_t started;
+  rcutils_atomic_load_explicit(&g_rcutils_logging_flight_recorder, started, memory_order_acquire);
+  if ((uintptr_t)recorder->impl == started) {
+    rcutils_atomic_store_explicit(
+      (atomic_int *)&g_rcutils_logging_flight_recorder_severity,
+      RCUTILS_LOGGING_FLIGHT_RECORDER_STOPPED, memory_order_relaxed);
+    rcutils_atomic_store_explicit(
+      &g_rcutils_logging_flight_recorder, (uintptr_t)0u, memory_order_release);
+    rcutils_logging_update_lowest_enabled_severity();
+  }
+  return RCUTILS_RET_OK;
+}
+
+void rcutils_logging_flight_recorder_vrecord(
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * format, va_list * args)
+{
+  uintptr_t started;
+  rcutils_atomic_load_explicit(&g_rcutils_logging_flight_recorder, started, memory_order_acquire);
+  rcutils_logging_flight_recorder_impl_t * impl = (rcutils_logging_flight_recorder_impl_t *)started;
+  if (NULL == impl) {
+    return;
+  }
+
+  uint64_t index;
+  rcutils_atomic_fetch_add_explicit(
+    FLIGHT_RECORDER_ATOMIC(&impl->header->next), index, (uint64_t)1u, memory_order_relaxed);
+  rcutils_logging_flight_recorder_record_t * record =
+    &impl->records[index % impl->header->capacity];
+
+  // Claim the record, unless a thread which lapped the ring is still writing it, in which case
+  // the message is dropped rather than waiting.
+  uint64_t sequence;
+  rcutils_atomic_load_explicit(
+    FLIGHT_RECORDER_ATOMIC(&record->sequence), sequence, memory_order_relaxed);
+  bool claimed = false;
+  if (FLIGHT_RECORDER_WRITING != sequence) {
+    rcutils_atomic_compare_exchange_strong_explicit(
+      FLIGHT_RECORDER_ATOMIC(&record->sequence), claimed, &sequence, FLIGHT_RECORDER_WRITING,
+      memory_order_acquire, memory_order_relaxed);
+  }
+  if (!claimed) {
+    return;
+  }
+
+  record->timestamp = timestamp;
+  record->thread_id = rcutils_thread_get_id();
+  record->severity = (int32_t)severity;
+  size_t name_length = 0u;
+  if (NULL != name) {
+    while (name_length < RCUTILS_LOGGING_FLIGHT_RECORDER_NAME_SIZE - 1u &&
+      '\0' != name[name_length])
+    {
+      record->name[name_length] = name[name_length];
+      ++name_length;
+    }
+  }
+  record->name[name_length] = '\0';
+  int written =
+    rcutils_vsnprintf(record->message, RCUTILS_LOGGING_FLIGHT_RECORDER_MESSAGE_SIZE, format, *args);
+  if (written < 0) {
+    written = 0;
+    record->message[0] = '\0';
+  } else if ((size_t)written >= RCUTILS_LOGGING_FLIGHT_RECORDER_MESSAGE_SIZE) {
+    written = (int)RCUTILS_LOGGING_FLIGHT_RECORDER_MESSAGE_SIZE - 1;
+  }
+  record->message_length = (uint32_t)written;
+  // Publishes the record to the readers
+  rcutils_atomic_store_explicit(
+    FLIGHT_RECORDER_ATOMIC(&record->sequence), index + 1u, memory_order_release);
+}
+
+rcutils_ret_t
+rcutils_logging_flight_recorder_read(
+  const char * path, rcutils_logging_flight_recorder_reader_t reader, void * context)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(path, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(reader, RCUTILS_RET_INVALID_ARGUMENT);
+
+  rcutils_mapped_file_t file = rcutils_get_zero_initialized_mapped_file();
+  rcutils_ret_t ret = rcutils_mapped_file_open(&file, path);
+  if (RCUTILS_RET_OK != ret) {
+    return RCUTILS_RET_ERROR;
+  }
+  const rcutils_logging_flight_recorder_header_t * header =
+    (const rcutils_logging_flight_recorder_header_t *)file.data;
+  if (file.size < sizeof(*header) ||
+    0 != memcmp(header->magic, RCUTILS_LOGGING_FLIGHT_RECORDER_MAGIC, sizeof(header->magic)) ||
+    RCUTILS_LOGGING_FLIGHT_RECORDER_VERSION != header->version ||
+    sizeof(rcutils_logging_flight_recorder_record_t) != header->record_size ||
+    (file.size - sizeof(*header)) / header->record_size < header->capacity ||
+    0u == header->capacity)
+  {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "'%s' isn't a flight recorder file of version %u", path,
+      RCUTILS_LOGGING_FLIGHT_RECORDER_VERSION);
+    ret = rcutils_mapped_file_close(&file);
+    RCUTILS_UNUSED(ret);
+    return RCUTILS_RET_ERROR;
+  }
+
+  const rcutils_logging_flight_recorder_record_t * records =
+    (const rcutils_logging_flight_recorder_record_t *)(header + 1);
+  uint64_t next;
+  rcutils_atomic_load_explicit(
+    FLIGHT_RECORDER_ATOMIC(&header->next), next, memory_order_acquire);
+  uint64_t index = next > header->capacity ? next - header->capacity : 0u;
+  for (; index < next; ++index) {
+    const rcutils_logging_flight_recorder_record_t * record = &records[index % header->capacity];
+    uint64_t sequence;
+    rcutils_atomic_load_explicit(
+      FLIGHT_RECORDER_ATOMIC(&record->sequence), sequence, memory_order_acquire);
+    if (index + 1u != sequence) {
+      // Overwritten, being written, or left half written by a crash
+      continue;
+    }
+    rcutils_logging_flight_recorder_record_t copy;
+    memcpy(&copy, record, sizeof(copy));
+    // The copy is only consistent if the record wasn't claimed again meanwhile
+    rcutils_atomic_thread_fence(memory_order_acquire);
+    rcutils_atomic_load_explicit(
+      FLIGHT_RECORDER_ATOMIC(&record->sequence), sequence, memory_order_relaxed);
+    if (index + 1u != sequence) {
+      continue;
+    }
+    copy.name[RCUTILS_LOGGING_FLIGHT_RECORDER_NAME_SIZE - 1u] = '\0';
+    copy.message[RCUTILS_LOGGING_FLIGHT_RECORDER_MESSAGE_SIZE - 1u] = '\0';
+    if (copy.message_length >= RCUTILS_LOGGING_FLIGHT_RECORDER_MESSAGE_SIZE) {
+      copy.message_length = RCUTILS_LOGGING_FLIGHT_RECORDER_MESSAGE_SIZE - 1u;
+    }
+    reader(&copy, context);
+  }
+  return rcutils_mapped_file_close(&file);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,165 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef LOGGING_INTERNAL_H_
+#define LOGGING_INTERNAL_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <limits.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "rcutils/logging.h"
+#include "rcutils/logging_statistics.h"
+#include "rcutils/time.h"
+#include "rcutils/types/char_array.h"
+#include "rcutils/types/rcutils_ret.h"
+
+// Internal functions shared between the logging implementation files, not to be used externally.
+
+// Append n bytes of src to the output array, keeping it null terminated.
+rcutils_ret_t rcutils_logging_append_output(
+  rcutils_char_array_t * logging_output, const char * src, size_t n);
+
+// Append the formatted arguments to the output array, keeping it null terminated.
+rcutils_ret_t rcutils_logging_append_output_vsprintf(
+  rcutils_char_array_t * logging_output, const char * format, va_list * args);
+
+// Format a log record exactly as rcutils_logging_console_output_handler() writes it, including
+// the trailing newline, appending it to output_array.
+// The color escape sequences are included if the output is colorized, except on Windows where
+// the color is set on the console instead.
+// The buffer_length of output_array must include the terminating null byte, i.e. be 1 when it
+// is empty.
+rcutils_ret_t rcutils_logging_format_console_record(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * format, va_list * args, rcutils_char_array_t * output_array);
+
+// Format a log record like rcutils_logging_format_console_record(), but never colorized.
+rcutils_ret_t rcutils_logging_format_plain_record(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * format, va_list * args, rcutils_char_array_t * output_array);
+
+// What the tokens of the output format compiled at initialization use of a record.
+typedef enum rcutils_logging_output_format_need_t
+{
+  RCUTILS_LOGGING_OUTPUT_FORMAT_NEEDS_TIME = 1 << 0,
+  RCUTILS_LOGGING_OUTPUT_FORMAT_NEEDS_LOCATION = 1 << 1,
+  RCUTILS_LOGGING_OUTPUT_FORMAT_NEEDS_NAME = 1 << 2,
+  // The identity of the thread logging, which must be formatted on it.
+  RCUTILS_LOGGING_OUTPUT_FORMAT_NEEDS_THREAD = 1 << 3,
+} rcutils_logging_output_format_need_t;
+
+// Return whether the output format uses any of the given rcutils_logging_output_format_need_t.
+bool rcutils_logging_output_format_needs(unsigned int needs);
+
+// Return false if the output handler is known not to use the timestamp with the current output
+// format and settings, in which case it may be passed 0 instead.
+bool rcutils_logging_output_handler_needs_timestamp(
+  rcutils_logging_output_handler_t output_handler);
+
+// Decide whether rcutils_log() or rcutils_log_kv() emit a message, checking the level and the
+// limiter of its logger and getting its timestamp.
+// The timestamp is 0 if output_handler, the handler the message will be passed to, doesn't need
+// it; output_handler is NULL if the message goes to another kind of handler.
+// If messages of the logger were suppressed by its limiter before, the output handler first
+// receives a message telling how many.
+bool rcutils_logging_admit_message(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_logging_output_handler_t output_handler,
+  rcutils_time_point_value_t * timestamp);
+
+// Get the stream rcutils_logging_console_output_handler() writes to, NULL if not initialized.
+FILE * rcutils_logging_get_console_output_stream(void);
+
+// Recompute g_rcutils_logging_lowest_enabled_severity after any of the logger levels, whether
+// the logging system is initialized or whether the statistics are enabled changed.
+void rcutils_logging_update_lowest_enabled_severity(void);
+
+// The value of g_rcutils_logging_flight_recorder_severity while no flight recorder is started.
+#define RCUTILS_LOGGING_FLIGHT_RECORDER_STOPPED INT_MAX
+
+// The lowest severity of the messages recorded by the started flight recorder, see
+// rcutils_logging_flight_recorder_start().
+extern int g_rcutils_logging_flight_recorder_severity;
+
+// Record a message in the started flight recorder, if any.
+void rcutils_logging_flight_recorder_vrecord(
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * format, va_list * args);
+
+// The counters of rcutils_logging_statistics_t kept per severity.
+typedef enum rcutils_logging_statistics_counter_t
+{
+  RCUTILS_LOGGING_STATISTICS_EMITTED = 0,
+  RCUTILS_LOGGING_STATISTICS_FILTERED,
+  RCUTILS_LOGGING_STATISTICS_DROPPED,
+  RCUTILS_LOGGING_STATISTICS_COUNTERS
+} rcutils_logging_statistics_counter_t;
+
+// Set by rcutils_logging_set_statistics_enabled(), the functions below must only be called
+// if g_rcutils_logging_statistics_enabled is true.
+extern bool g_rcutils_logging_statistics_enabled;
+extern bool g_rcutils_logging_statistics_timing_enabled;
+
+// Count a message of the given severity.
+void rcutils_logging_statistics_count(rcutils_logging_statistics_counter_t counter, int severity);
+
+// Count a call rejected by the throttle of its call site.
+void rcutils_logging_statistics_count_throttled(void);
+
+// Count bytes written by an output handler.
+void rcutils_logging_statistics_count_bytes(size_t bytes);
+
+// Return the start time to pass to the functions adding the time elapsed since, or 0 if
+// timing is disabled.
+rcutils_time_point_value_t rcutils_logging_statistics_start_timer(void);
+
+// Add the time elapsed since start to the time spent formatting records.
+void rcutils_logging_statistics_add_format_time(rcutils_time_point_value_t start);
+
+// Add the time elapsed since start to the time spent in the output handler.
+void rcutils_logging_statistics_add_output_time(rcutils_time_point_value_t start);
+
+// The values of the shared counters the statistics are mirrored in, see
+// rcutils_shared_counters_export_logging_statistics().
+typedef struct rcutils_logging_statistics_shared_t
+{
+  uint64_t * counters[RCUTILS_LOGGING_STATISTICS_COUNTERS][RCUTILS_LOGGING_STATISTICS_SEVERITIES];
+  uint64_t * throttled;
+  uint64_t * bytes_written;
+  uint64_t * format_time;
+  uint64_t * output_time;
+} rcutils_logging_statistics_shared_t;
+
+// Mirror the statistics in the given shared counters from now on, or stop if shared is NULL.
+void rcutils_logging_statistics_set_shared(const rcutils_logging_statistics_shared_t * shared);
+
+// Stop mirroring the statistics if they are mirrored in the given shared counters.
+void rcutils_logging_statistics_unset_shared(const rcutils_logging_statistics_shared_t * shared);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LOGGING_INTERNAL_H_
@@ -0,0 +1,571 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+// For sendmmsg().
+# define _GNU_SOURCE
+#endif
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+// See the comment in logging.c about warning C5105.
+# pragma warning(push)
+# pragma warning(disable : 5105)
+// winsock2.h must be included before windows.h.
+# include <winsock2.h>
+# include <ws2tcpip.h>
+# include <windows.h>
+# pragma warning(pop)
+#else
+# include <errno.h>
+# include <netdb.h>
+# include <pthread.h>
+# include <sched.h>
+# include <sys/socket.h>
+# include <sys/types.h>
+# include <sys/uio.h>
+# include <time.h>
+# include <unistd.h>
+#endif
+
+#include "rcutils/allocator.h"
+#include "rcutils/error_handling.h"
+#include "rcutils/logging.h"
+#include "rcutils/logging_network.h"
+#include "rcutils/stdatomic_helper.h"
+#include "rcutils/types/char_array.h"
+#include "rcutils/types/concurrent_queue.h"
+
+#include "./logging_internal.h"
+
+// The time the sender thread sleeps for when it has nothing to send yet.
+#define RCUTILS_LOGGING_NETWORK_IDLE_SLEEP_MS (1)
+
+#ifdef _WIN32
+typedef SOCKET rcutils_logging_network_socket_t;
+# define RCUTILS_LOGGING_NETWORK_INVALID_SOCKET INVALID_SOCKET
+# define RCUTILS_LOGGING_NETWORK_CLOSE_SOCKET closesocket
+#else
+typedef int rcutils_logging_network_socket_t;
+# define RCUTILS_LOGGING_NETWORK_INVALID_SOCKET (-1)
+# define RCUTILS_LOGGING_NETWORK_CLOSE_SOCKET close
+#endif
+
+typedef struct rcutils_logging_network_state_t
+{
+  // The records, max_record_size bytes each, null terminated unless they fill them.
+  rcutils_mpsc_queue_t queue;
+  // The records of the batch being sent, batch_size times max_record_size bytes.
+  char * batch;
+#ifdef __linux__
+  struct mmsghdr * messages;
+  struct iovec * iovecs;
+#endif
+  size_t max_record_size;
+  size_t batch_size;
+  rcutils_duration_value_t max_latency;
+  rcutils_logging_network_socket_t socket;
+  rcutils_allocator_t allocator;
+#ifdef _WIN32
+  HANDLE thread;
+#else
+  pthread_t thread;
+#endif
+} rcutils_logging_network_state_t;
+
+static rcutils_logging_network_state_t g_rcutils_logging_network;
+
+// Whether the output handler puts records into the queue.
+static atomic_bool g_rcutils_logging_network_running = ATOMIC_VAR_INIT(false);
+// Set once no more records can be put into the queue, to let the sender thread exit.
+static atomic_bool g_rcutils_logging_network_exit = ATOMIC_VAR_INIT(false);
+// Set by rcutils_logging_network_flush() to have the queued records sent without waiting.
+static atomic_bool g_rcutils_logging_network_flush_requested = ATOMIC_VAR_INIT(false);
+// The number of threads in the output handler which saw it running, so the queue can't be
+// freed under their feet.
+static atomic_uint_least64_t g_rcutils_logging_network_producers = ATOMIC_VAR_INIT(0);
+
+static atomic_uint_least64_t g_rcutils_logging_network_enqueued = ATOMIC_VAR_INIT(0);
+static atomic_uint_least64_t g_rcutils_logging_network_sent = ATOMIC_VAR_INIT(0);
+static atomic_uint_least64_t g_rcutils_logging_network_dropped = ATOMIC_VAR_INIT(0);
+static atomic_uint_least64_t g_rcutils_logging_network_truncated = ATOMIC_VAR_INIT(0);
+static atomic_uint_least64_t g_rcutils_logging_network_failed = ATOMIC_VAR_INIT(0);
+static atomic_uint_least64_t g_rcutils_logging_network_batches = ATOMIC_VAR_INIT(0);
+
+static void rcutils_logging_network_sleep(void)
+{
+#ifdef _WIN32
+  Sleep(RCUTILS_LOGGING_NETWORK_IDLE_SLEEP_MS);
+#else
+  struct timespec duration = {0, RCUTILS_LOGGING_NETWORK_IDLE_SLEEP_MS * 1000000L};
+  nanosleep(&duration, NULL);
+#endif
+}
+
+static void rcutils_logging_network_yield(void)
+{
+#ifdef _WIN32
+  SwitchToThread();
+#else
+  sched_yield();
+#endif
+}
+
+// Send the count records of the batch, returns the number of records sent.
+static size_t rcutils_logging_network_send(const size_t * lengths, size_t count)
+{
+  rcutils_logging_network_state_t * state = &g_rcutils_logging_network;
+  size_t sent = 0u;
+#ifdef __linux__
+  for (size_t i = 0u; i < count; ++i) {
+    state->iovecs[i].iov_base = state->batch + i * state->max_record_size;
+    state->iovecs[i].iov_len = lengths[i];
+  }
+  size_t offset = 0u;
+  while (offset < count) {
+    int ret = sendmmsg(state->socket, state->messages + offset, (unsigned int)(count - offset), 0);
+    if (ret > 0) {
+      sent += (size_t)ret;
+      offset += (size_t)ret;
+    } else if (EINTR != errno) {
+      // The first datagram failed, e.g. because the collector refused the previous ones.
+      ++offset;
+    }
+  }
+#else
+  for (size_t i = 0u; i < count; ++i) {
+    const char * record = state->batch + i * state->max_record_size;
+# ifdef _WIN32
+    if (SOCKET_ERROR != send(state->socket, record, (int)lengths[i], 0)) {
+      ++sent;
+    }
+# else
+    ssize_t ret;
+    do {
+      ret = send(state->socket, record, lengths[i], 0);
+    } while (-1 == ret && EINTR == errno);
+    if (-1 != ret) {
+      ++sent;
+    }
+# endif
+  }
+#endif
+  return sent;
+}
+
+// Send up to batch_size queued records at once, returns the number of records taken from the
+// queue.
+static size_t rcutils_logging_network_send_batch(void)
+{
+  rcutils_logging_network_state_t * state = &g_rcutils_logging_network;
+  size_t lengths[RCUTILS_LOGGING_NETWORK_MAX_BATCH_SIZE];
+  size_t count = 0u;
+  size_t bytes = 0u;
+  while (count < state->batch_size) {
+    char * record = state->batch + count * state->max_record_size;
+    if (RCUTILS_RET_OK != rcutils_mpsc_queue_try_pop(&state->queue, record)) {
+      break;
+    }
+    // The record fills its slot if it isn't null terminated.
+    const char * end = memchr(record, '\0', state->max_record_size);
+    lengths[count] = NULL == end ? state->max_record_size : (size_t)(end - record);
+    bytes += lengths[count];
+    ++count;
+  }
+  if (0u == count) {
+    return 0u;
+  }
+  size_t sent = rcutils_logging_network_send(lengths, count);
+  if (g_rcutils_logging_statistics_enabled) {
+    rcutils_logging_statistics_count_bytes(bytes);
+  }
+  rcutils_atomic_fetch_add_uint64_t(&g_rcutils_logging_network_failed, count - sent);
+  rcutils_atomic_fetch_add_uint64_t(&g_rcutils_logging_network_batches, 1u);
+  // Counted last, as rcutils_logging_network_flush() waits on it.
+  rcutils_atomic_fetch_add_uint64_t(&g_rcutils_logging_network_sent, sent);
+  return count;
+}
+
+static void rcutils_logging_network_send_loop(void)
+{
+  rcutils_logging_network_state_t * state = &g_rcutils_logging_network;
+  rcutils_time_point_value_t last_send = 0;
+  if (RCUTILS_RET_OK != rcutils_steady_time_now(&last_send)) {
+    rcutils_reset_error();
+  }
+  for (;;) {
+    // Read before the size, so that no record queued before the flag is set is left behind.
+    bool exiting = rcutils_atomic_load_bool(&g_rcutils_logging_network_exit);
+    bool flushing = rcutils_atomic_load_bool(&g_rcutils_logging_network_flush_requested);
+    size_t queued = 0u;
+    if (RCUTILS_RET_OK != rcutils_mpsc_queue_get_size(&state->queue, &queued)) {
+      rcutils_reset_error();
+    }
+    rcutils_time_point_value_t now = last_send;
+    if (RCUTILS_RET_OK != rcutils_steady_time_now(&now)) {
+      rcutils_reset_error();
+    }
+    if (queued >= state->batch_size ||
+      (queued > 0u && (exiting || flushing || now - last_send >= state->max_latency)))
+    {
+      rcutils_logging_network_send_batch();
+      last_send = now;
+    } else if (exiting) {
+      return;
+    } else {
+      rcutils_logging_network_sleep();
+    }
+  }
+}
+
+#ifdef _WIN32
+static DWORD WINAPI rcutils_logging_network_sender_main(LPVOID arg)
+{
+  (void)arg;
+  rcutils_logging_network_send_loop();
+  return 0;
+}
+#else
+static void * rcutils_logging_network_sender_main(void * arg)
+{
+  (void)arg;
+  rcutils_logging_network_send_loop();
+  return NULL;
+}
+#endif
+
+static void rcutils_logging_network_free(rcutils_logging_network_state_t * state)
+{
+  rcutils_allocator_t * allocator = &state->allocator;
+  if (NULL != state->queue.impl && RCUTILS_RET_OK != rcutils_mpsc_queue_fini(&state->queue)) {
+    RCUTILS_SAFE_FWRITE_TO_STDERR("Failed to fini queue.\n");
+    rcutils_reset_error();
+  }
+  allocator->deallocate(state->batch, allocator->state);
+  state->batch = NULL;
+#ifdef __linux__
+  allocator->deallocate(state->messages, allocator->state);
+  allocator->deallocate(state->iovecs, allocator->state);
+  state->messages = NULL;
+  state->iovecs = NULL;
+#endif
+  if (RCUTILS_LOGGING_NETWORK_INVALID_SOCKET != state->socket) {
+    RCUTILS_LOGGING_NETWORK_CLOSE_SOCKET(state->socket);
+    state->socket = RCUTILS_LOGGING_NETWORK_INVALID_SOCKET;
+  }
+#ifdef _WIN32
+  WSACleanup();
+#endif
+}
+
+// Resolve the host and connect the socket of the state to the first address which accepts it.
+static rcutils_ret_t rcutils_logging_network_connect(
+  rcutils_logging_network_state_t * state, const char * host, uint16_t port)
+{
+  char service[8];
+  int service_length = snprintf(service, sizeof(service), "%u", (unsigned int)port);
+  if (service_length < 0 || (size_t)service_length >= sizeof(service)) {
+    RCUTILS_SET_ERROR_MSG("failed to format the port");
+    return RCUTILS_RET_ERROR;
+  }
+  struct addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_DGRAM;
+  hints.ai_protocol = IPPROTO_UDP;
+  hints.ai_flags = AI_NUMERICSERV;
+  struct addrinfo * addresses = NULL;
+  int resolve_ret = getaddrinfo(host, service, &hints, &addresses);
+  if (0 != resolve_ret) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "failed to resolve '%s': %s", host, gai_strerror(resolve_ret));
+    return RCUTILS_RET_ERROR;
+  }
+  for (const struct addrinfo * address = addresses; NULL != address; address = address->ai_next) {
+    state->socket = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+    if (RCUTILS_LOGGING_NETWORK_INVALID_SOCKET == state->socket) {
+      continue;
+    }
+    if (0 == connect(state->socket, address->ai_addr, (int)address->ai_addrlen)) {
+      break;
+    }
+    RCUTILS_LOGGING_NETWORK_CLOSE_SOCKET(state->socket);
+    state->socket = RCUTILS_LOGGING_NETWORK_INVALID_SOCKET;
+  }
+  freeaddrinfo(addresses);
+  if (RCUTILS_LOGGING_NETWORK_INVALID_SOCKET == state->socket) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "failed to connect a socket to '%s' port %u", host, (unsigned int)port);
+    return RCUTILS_RET_ERROR;
+  }
+  return RCUTILS_RET_OK;
+}
+
+rcutils_logging_network_options_t
+rcutils_logging_network_get_default_options(void)
+{
+  static rcutils_logging_network_options_t default_options = {
+    .host = NULL,
+    .port = 0u,
+    .queue_capacity = RCUTILS_LOGGING_NETWORK_DEFAULT_QUEUE_CAPACITY,
+    .max_record_size = RCUTILS_LOGGING_NETWORK_DEFAULT_MAX_RECORD_SIZE,
+    .batch_size = RCUTILS_LOGGING_NETWORK_DEFAULT_BATCH_SIZE,
+    .max_latency_ms = RCUTILS_LOGGING_NETWORK_DEFAULT_MAX_LATENCY_MS,
+  };
+  return default_options;
+}
+
+rcutils_ret_t
+rcutils_logging_network_start(
+  const rcutils_logging_network_options_t * options,
+  rcutils_allocator_t allocator)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(options, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ALLOCATOR_WITH_MSG(
+    &allocator, "invalid allocator", return RCUTILS_RET_INVALID_ARGUMENT);
+  if (NULL == options->host || '\0' == options->host[0] || 0u == options->port) {
+    RCUTILS_SET_ERROR_MSG("host and port must be given");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  if (0u == options->queue_capacity || options->queue_capacity > SIZE_MAX / 2u) {
+    RCUTILS_SET_ERROR_MSG("queue capacity is out of range");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  if (0u == options->max_record_size ||
+    options->max_record_size > RCUTILS_LOGGING_NETWORK_MAX_RECORD_SIZE)
+  {
+    RCUTILS_SET_ERROR_MSG("max record size is out of range");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  if (0u == options->batch_size || options->batch_size > RCUTILS_LOGGING_NETWORK_MAX_BATCH_SIZE) {
+    RCUTILS_SET_ERROR_MSG("batch size is out of range");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  if (!g_rcutils_logging_initialized) {
+    RCUTILS_SET_ERROR_MSG("logging system isn't initialized");
+    return RCUTILS_RET_NOT_INITIALIZED;
+  }
+  if (rcutils_atomic_load_bool(&g_rcutils_logging_network_running)) {
+    RCUTILS_SET_ERROR_MSG("network logging is already started");
+    return RCUTILS_RET_ERROR;
+  }
+
+  rcutils_logging_network_state_t * state = &g_rcutils_logging_network;
+  state->allocator = allocator;
+  state->max_record_size = options->max_record_size;
+  state->batch_size = options->batch_size;
+  state->max_latency = RCUTILS_MS_TO_NS((rcutils_duration_value_t)options->max_latency_ms);
+  state->socket = RCUTILS_LOGGING_NETWORK_INVALID_SOCKET;
+  state->queue = rcutils_get_zero_initialized_mpsc_queue();
+  state->batch = NULL;
+#ifdef __linux__
+  state->messages = NULL;
+  state->iovecs = NULL;
+#endif
+
+#ifdef _WIN32
+  WSADATA wsa_data;
+  int startup_ret = WSAStartup(MAKEWORD(2, 2), &wsa_data);
+  if (0 != startup_ret) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "failed to initialize Windows Sockets: %d", startup_ret);
+    return RCUTILS_RET_ERROR;
+  }
+#endif
+  rcutils_ret_t ret = rcutils_logging_network_connect(state, options->host, options->port);
+  if (RCUTILS_RET_OK != ret) {
+    rcutils_logging_network_free(state);
+    return ret;
+  }
+
+  ret = rcutils_mpsc_queue_init(
+    &state->queue, options->queue_capacity, state->max_record_size, &allocator);
+  if (RCUTILS_RET_OK != ret) {
+    rcutils_logging_network_free(state);
+    return ret;
+  }
+  state->batch = allocator.allocate(state->batch_size * state->max_record_size, allocator.state);
+#ifdef __linux__
+  state->messages =
+    allocator.allocate(state->batch_size * sizeof(struct mmsghdr), allocator.state);
+  state->iovecs = allocator.allocate(state->batch_size * sizeof(struct iovec), allocator.state);
+  if (NULL != state->messages && NULL != state->iovecs) {
+    // The socket is connected, so the messages only point at their record.
+    memset(state->messages, 0, state->batch_size * sizeof(struct mmsghdr));
+    for (size_t i = 0u; i < state->batch_size; ++i) {
+      state->messages[i].msg_hdr.msg_iov = &state->iovecs[i];
+      state->messages[i].msg_hdr.msg_iovlen = 1u;
+    }
+  }
+  bool messages_allocated = NULL != state->messages && NULL != state->iovecs;
+#else
+  bool messages_allocated = true;
+#endif
+  if (NULL == state->batch || !messages_allocated) {
+    rcutils_logging_network_free(state);
+    RCUTILS_SET_ERROR_MSG("failed to allocate memory for the log record batch");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+
+  rcutils_atomic_store(&g_rcutils_logging_network_enqueued, (uint64_t)0u);
+  rcutils_atomic_store(&g_rcutils_logging_network_sent, (uint64_t)0u);
+  rcutils_atomic_store(&g_rcutils_logging_network_dropped, (uint64_t)0u);
+  rcutils_atomic_store(&g_rcutils_logging_network_truncated, (uint64_t)0u);
+  rcutils_atomic_store(&g_rcutils_logging_network_failed, (uint64_t)0u);
+  rcutils_atomic_store(&g_rcutils_logging_network_batches, (uint64_t)0u);
+  rcutils_atomic_store(&g_rcutils_logging_network_exit, false);
+  rcutils_atomic_store(&g_rcutils_logging_network_flush_requested, false);
+
+#ifdef _WIN32
+  state->thread = CreateThread(NULL, 0, rcutils_logging_network_sender_main, NULL, 0, NULL);
+  if (NULL == state->thread) {
+    rcutils_logging_network_free(state);
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "failed to create the log sender thread: %lu", GetLastError());
+    return RCUTILS_RET_ERROR;
+  }
+#else
+  int thread_ret = pthread_create(
+    &state->thread, NULL, rcutils_logging_network_sender_main, NULL);
+  if (0 != thread_ret) {
+    rcutils_logging_network_free(state);
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "failed to create the log sender thread: %d", thread_ret);
+    return RCUTILS_RET_ERROR;
+  }
+#endif
+  rcutils_atomic_store(&g_rcutils_logging_network_running, true);
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_logging_network_stop(void)
+{
+  if (!rcutils_atomic_exchange_bool(&g_rcutils_logging_network_running, false)) {
+    return RCUTILS_RET_OK;
+  }
+  // Wait for the threads which may still put records into the queue.
+  while (rcutils_atomic_load_uint64_t(&g_rcutils_logging_network_producers) > 0u) {
+    rcutils_logging_network_yield();
+  }
+  rcutils_atomic_store(&g_rcutils_logging_network_exit, true);
+
+  rcutils_ret_t ret = RCUTILS_RET_OK;
+  rcutils_logging_network_state_t * state = &g_rcutils_logging_network;
+#ifdef _WIN32
+  if (WaitForSingleObject(state->thread, INFINITE) != WAIT_OBJECT_0) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "failed to join the log sender thread: %lu", GetLastError());
+    ret = RCUTILS_RET_ERROR;
+  }
+  CloseHandle(state->thread);
+#else
+  int thread_ret = pthread_join(state->thread, NULL);
+  if (0 != thread_ret) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "failed to join the log sender thread: %d", thread_ret);
+    ret = RCUTILS_RET_ERROR;
+  }
+#endif
+  if (RCUTILS_RET_OK == ret) {
+    rcutils_logging_network_free(state);
+  }
+  return ret;
+}
+
+rcutils_ret_t
+rcutils_logging_network_flush(void)
+{
+  uint64_t target = rcutils_atomic_load_uint64_t(&g_rcutils_logging_network_enqueued);
+  rcutils_atomic_store(&g_rcutils_logging_network_flush_requested, true);
+  while (rcutils_atomic_load_bool(&g_rcutils_logging_network_running) &&
+    rcutils_atomic_load_uint64_t(&g_rcutils_logging_network_sent) +
+    rcutils_atomic_load_uint64_t(&g_rcutils_logging_network_failed) < target)
+  {
+    rcutils_logging_network_sleep();
+  }
+  rcutils_atomic_store(&g_rcutils_logging_network_flush_requested, false);
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_logging_network_get_statistics(rcutils_logging_network_statistics_t * statistics)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(statistics, RCUTILS_RET_INVALID_ARGUMENT);
+  statistics->enqueued = rcutils_atomic_load_uint64_t(&g_rcutils_logging_network_enqueued);
+  statistics->sent = rcutils_atomic_load_uint64_t(&g_rcutils_logging_network_sent);
+  statistics->dropped = rcutils_atomic_load_uint64_t(&g_rcutils_logging_network_dropped);
+  statistics->truncated = rcutils_atomic_load_uint64_t(&g_rcutils_logging_network_truncated);
+  statistics->failed = rcutils_atomic_load_uint64_t(&g_rcutils_logging_network_failed);
+  statistics->batches = rcutils_atomic_load_uint64_t(&g_rcutils_logging_network_batches);
+  return RCUTILS_RET_OK;
+}
+
+void rcutils_logging_network_output_handler(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * format, va_list * args)
+{
+  rcutils_atomic_fetch_add_uint64_t(&g_rcutils_logging_network_producers, 1u);
+  if (!rcutils_atomic_load_bool(&g_rcutils_logging_network_running)) {
+    rcutils_atomic_fetch_add_uint64_t(&g_rcutils_logging_network_producers, UINT64_MAX);
+    rcutils_logging_console_output_handler(location, severity, name, timestamp, format, args);
+    return;
+  }
+
+  rcutils_logging_network_state_t * state = &g_rcutils_logging_network;
+  RCUTILS_CHAR_ARRAY_WITH_STACK(record_array, 1024, state->allocator);
+  rcutils_ret_t status = rcutils_logging_format_plain_record(
+    location, severity, name, timestamp, format, args, &record_array);
+  if (RCUTILS_RET_OK == status) {
+    // The datagram is the record without its newline.
+    size_t length = record_array.buffer_length - 2u;
+    record_array.buffer[length] = '\0';
+    if (length > state->max_record_size) {
+      rcutils_atomic_fetch_add_uint64_t(&g_rcutils_logging_network_truncated, 1u);
+    }
+    // The queue copies max_record_size bytes.
+    status = rcutils_char_array_reserve(&record_array, state->max_record_size);
+  }
+  if (RCUTILS_RET_OK == status) {
+    if (RCUTILS_RET_OK == rcutils_mpsc_queue_try_push(&state->queue, record_array.buffer)) {
+      rcutils_atomic_fetch_add_uint64_t(&g_rcutils_logging_network_enqueued, 1u);
+    } else {
+      rcutils_atomic_fetch_add_uint64_t(&g_rcutils_logging_network_dropped, 1u);
+      if (g_rcutils_logging_statistics_enabled) {
+        rcutils_logging_statistics_count(RCUTILS_LOGGING_STATISTICS_DROPPED, severity);
+      }
+    }
+  } else {
+    rcutils_reset_error();
+  }
+  rcutils_atomic_fetch_add_uint64_t(&g_rcutils_logging_network_producers, UINT64_MAX);
+
+  if (RCUTILS_RET_OK != rcutils_char_array_fini(&record_array)) {
+    RCUTILS_SAFE_FWRITE_TO_STDERR("Failed to fini array.\n");
+  }
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,181 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rcutils/error_handling.h"
+#include "rcutils/logging_statistics.h"
+#include "rcutils/shared_counters.h"
+#include "rcutils/stdatomic_helper.h"
+#include "rcutils/time.h"
+
+#include "./logging_internal.h"
+
+bool g_rcutils_logging_statistics_enabled = false;
+bool g_rcutils_logging_statistics_timing_enabled = false;
+
+static atomic_uint_least64_t g_rcutils_logging_statistics_counters[
+  RCUTILS_LOGGING_STATISTICS_COUNTERS][RCUTILS_LOGGING_STATISTICS_SEVERITIES];
+static atomic_uint_least64_t g_rcutils_logging_statistics_throttled;
+static atomic_uint_least64_t g_rcutils_logging_statistics_bytes_written;
+static atomic_uint_least64_t g_rcutils_logging_statistics_format_time;
+static atomic_uint_least64_t g_rcutils_logging_statistics_output_time;
+// The rcutils_logging_statistics_shared_t the counters are mirrored in, or 0.
+static atomic_uintptr_t g_rcutils_logging_statistics_shared;
+
+static const rcutils_logging_statistics_shared_t * rcutils_logging_statistics_get_shared(void)
+{
+  uintptr_t shared;
+  rcutils_atomic_load_explicit(&g_rcutils_logging_statistics_shared, shared, memory_order_acquire);
+  return (const rcutils_logging_statistics_shared_t *)shared;
+}
+
+void rcutils_logging_statistics_set_shared(const rcutils_logging_statistics_shared_t * shared)
+{
+  rcutils_atomic_store_explicit(
+    &g_rcutils_logging_statistics_shared, (uintptr_t)shared, memory_order_release);
+}
+
+void rcutils_logging_statistics_unset_shared(const rcutils_logging_statistics_shared_t * shared)
+{
+  bool unset = false;
+  uintptr_t expected = (uintptr_t)shared;
+  rcutils_atomic_compare_exchange_strong(
+    &g_rcutils_logging_statistics_shared, unset, &expected, (uintptr_t)0u);
+  RCUTILS_UNUSED(unset);
+}
+
+void
+rcutils_logging_set_statistics_enabled(bool enabled, bool timing_enabled)
+{
+  g_rcutils_logging_statistics_enabled = enabled;
+  g_rcutils_logging_statistics_timing_enabled = enabled && timing_enabled;
+  rcutils_logging_update_lowest_enabled_severity();
+}
+
+rcutils_ret_t
+rcutils_logging_get_statistics(rcutils_logging_statistics_t * statistics)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(statistics, RCUTILS_RET_INVALID_ARGUMENT);
+  for (size_t i = 0u; i < RCUTILS_LOGGING_STATISTICS_SEVERITIES; ++i) {
+    statistics->emitted[i] = rcutils_atomic_load_uint64_t(
+      &g_rcutils_logging_statistics_counters[RCUTILS_LOGGING_STATISTICS_EMITTED][i]);
+    statistics->filtered[i] = rcutils_atomic_load_uint64_t(
+      &g_rcutils_logging_statistics_counters[RCUTILS_LOGGING_STATISTICS_FILTERED][i]);
+    statistics->dropped[i] = rcutils_atomic_load_uint64_t(
+      &g_rcutils_logging_statistics_counters[RCUTILS_LOGGING_STATISTICS_DROPPED][i]);
+  }
+  statistics->throttled = rcutils_atomic_load_uint64_t(&g_rcutils_logging_statistics_throttled);
+  statistics->bytes_written =
+    rcutils_atomic_load_uint64_t(&g_rcutils_logging_statistics_bytes_written);
+  statistics->format_time = rcutils_atomic_load_uint64_t(&g_rcutils_logging_statistics_format_time);
+  statistics->output_time = rcutils_atomic_load_uint64_t(&g_rcutils_logging_statistics_output_time);
+  return RCUTILS_RET_OK;
+}
+
+void
+rcutils_logging_reset_statistics(void)
+{
+  for (size_t counter = 0u; counter < RCUTILS_LOGGING_STATISTICS_COUNTERS; ++counter) {
+    for (size_t i = 0u; i < RCUTILS_LOGGING_STATISTICS_SEVERITIES; ++i) {
+      rcutils_atomic_store(&g_rcutils_logging_statistics_counters[counter][i], (uint64_t)0u);
+    }
+  }
+  rcutils_atomic_store(&g_rcutils_logging_statistics_throttled, (uint64_t)0u);
+  rcutils_atomic_store(&g_rcutils_logging_statistics_bytes_written, (uint64_t)0u);
+  rcutils_atomic_store(&g_rcutils_logging_statistics_format_time, (uint64_t)0u);
+  rcutils_atomic_store(&g_rcutils_logging_statistics_output_time, (uint64_t)0u);
+}
+
+void rcutils_logging_statistics_count(rcutils_logging_statistics_counter_t counter, int severity)
+{
+  const size_t index = RCUTILS_LOGGING_STATISTICS_INDEX(severity);
+  rcutils_atomic_fetch_add_uint64_t(&g_rcutils_logging_statistics_counters[counter][index], 1u);
+  const rcutils_logging_statistics_shared_t * shared = rcutils_logging_statistics_get_shared();
+  if (NULL != shared) {
+    rcutils_shared_counter_add(shared->counters[counter][index], 1u);
+  }
+}
+
+void rcutils_logging_statistics_count_throttled(void)
+{
+  rcutils_atomic_fetch_add_uint64_t(&g_rcutils_logging_statistics_throttled, 1u);
+  const rcutils_logging_statistics_shared_t * shared = rcutils_logging_statistics_get_shared();
+  if (NULL != shared) {
+    rcutils_shared_counter_add(shared->throttled, 1u);
+  }
+}
+
+void rcutils_logging_statistics_count_bytes(size_t bytes)
+{
+  rcutils_atomic_fetch_add_uint64_t(&g_rcutils_logging_statistics_bytes_written, bytes);
+  const rcutils_logging_statistics_shared_t * shared = rcutils_logging_statistics_get_shared();
+  if (NULL != shared) {
+    rcutils_shared_counter_add(shared->bytes_written, bytes);
+  }
+}
+
+rcutils_time_point_value_t rcutils_logging_statistics_start_timer(void)
+{
+  rcutils_time_point_value_t now = 0;
+  if (g_rcutils_logging_statistics_timing_enabled &&
+    RCUTILS_RET_OK != rcutils_steady_time_now(&now))
+  {
+    rcutils_reset_error();
+    now = 0;
+  }
+  return now;
+}
+
+static void rcutils_logging_statistics_add_time(
+  atomic_uint_least64_t * total, bool output, rcutils_time_point_value_t start)
+{
+  rcutils_time_point_value_t now = 0;
+  if (0 == start) {
+    return;
+  }
+  if (RCUTILS_RET_OK != rcutils_steady_time_now(&now)) {
+    rcutils_reset_error();
+    return;
+  }
+  if (now > start) {
+    rcutils_atomic_fetch_add_uint64_t(total, (uint64_t)(now - start));
+    const rcutils_logging_statistics_shared_t * shared = rcutils_logging_statistics_get_shared();
+    if (NULL != shared) {
+      rcutils_shared_counter_add(
+        output ? shared->output_time : shared->format_time, (uint64_t)(now - start));
+    }
+  }
+}
+
+void rcutils_logging_statistics_add_format_time(rcutils_time_point_value_t start)
+{
+  rcutils_logging_statistics_add_time(&g_rcutils_logging_statistics_format_time, false, start);
+}
+
+void rcutils_logging_statistics_add_output_time(rcutils_time_point_value_t start)
+{
+  rcutils_logging_statistics_add_time(&g_rcutils_logging_statistics_output_time, true, start);
+}
+
+#ifdef __cplusplus
+}
+#endif
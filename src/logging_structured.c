@@ -0,0 +1,408 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "rcutils/allocator.h"
+#include "rcutils/error_handling.h"
+#include "rcutils/logging.h"
+#include "rcutils/logging_structured.h"
+#include "rcutils/snprintf.h"
+#include "rcutils/types/char_array.h"
+
+#include "./logging_internal.h"
+
+static rcutils_logging_structured_output_handler_t
+  g_rcutils_logging_structured_output_handler = NULL;
+
+rcutils_logging_structured_output_handler_t rcutils_logging_get_structured_output_handler(void)
+{
+  return g_rcutils_logging_structured_output_handler;
+}
+
+void rcutils_logging_set_structured_output_handler(
+  rcutils_logging_structured_output_handler_t function)
+{
+  g_rcutils_logging_structured_output_handler = function;
+}
+
+// Append a string, escaping it as the contents of a JSON string.
+static rcutils_ret_t rcutils_logging_append_escaped(
+  rcutils_char_array_t * output_array, const char * data, size_t length)
+{
+  static const char hex_digits[] = "0123456789abcdef";
+  size_t span_start = 0u;
+  for (size_t i = 0u; i < length; ++i) {
+    unsigned char c = (unsigned char)data[i];
+    if (c >= 0x20 && '"' != c && '\\' != c) {
+      continue;
+    }
+    // Append the characters which didn't need escaping at once.
+    rcutils_ret_t ret =
+      rcutils_logging_append_output(output_array, data + span_start, i - span_start);
+    if (RCUTILS_RET_OK != ret) {
+      return ret;
+    }
+    char escaped[6] = {'\\', (char)c, '\0', '\0', '\0', '\0'};
+    size_t escaped_length = 2u;
+    switch (c) {
+      case '"':
+      case '\\':
+        break;
+      case '\n':
+        escaped[1] = 'n';
+        break;
+      case '\r':
+        escaped[1] = 'r';
+        break;
+      case '\t':
+        escaped[1] = 't';
+        break;
+      default:
+        escaped[1] = 'u';
+        escaped[2] = '0';
+        escaped[3] = '0';
+        escaped[4] = hex_digits[c >> 4];
+        escaped[5] = hex_digits[c & 0xf];
+        escaped_length = 6u;
+        break;
+    }
+    ret = rcutils_logging_append_output(output_array, escaped, escaped_length);
+    if (RCUTILS_RET_OK != ret) {
+      return ret;
+    }
+    span_start = i + 1u;
+  }
+  return rcutils_logging_append_output(output_array, data + span_start, length - span_start);
+}
+
+// Append the value of a field, strings quoted and escaped.
+// Non-finite floating point numbers are appended as null in JSON, which can't represent them.
+static rcutils_ret_t rcutils_logging_append_field_value(
+  rcutils_char_array_t * output_array, const rcutils_log_field_t * field, bool json)
+{
+  char number[32];
+  int written = 0;
+  switch (field->type) {
+    case RCUTILS_LOG_FIELD_TYPE_INT64:
+      written = rcutils_snprintf(number, sizeof(number), "%" PRId64, field->value.int64_value);
+      break;
+    case RCUTILS_LOG_FIELD_TYPE_DOUBLE:
+      if (json && !isfinite(field->value.double_value)) {
+        return rcutils_logging_append_output(output_array, "null", 4u);
+      }
+      written = rcutils_snprintf(number, sizeof(number), "%g", field->value.double_value);
+      break;
+    case RCUTILS_LOG_FIELD_TYPE_STRING:
+      {
+        rcutils_ret_t ret = rcutils_logging_append_output(output_array, "\"", 1u);
+        if (RCUTILS_RET_OK == ret) {
+          ret = rcutils_logging_append_escaped(
+            output_array, field->value.string_value.data, field->value.string_value.length);
+        }
+        if (RCUTILS_RET_OK == ret) {
+          ret = rcutils_logging_append_output(output_array, "\"", 1u);
+        }
+        return ret;
+      }
+    default:
+      RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+        "invalid type of log field '%s': %d", field->key, (int)field->type);
+      return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  if (written < 0) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("failed to format log field '%s'", field->key);
+    return RCUTILS_RET_ERROR;
+  }
+  return rcutils_logging_append_output(output_array, number, (size_t)written);
+}
+
+static rcutils_ret_t rcutils_logging_check_fields(
+  const rcutils_log_field_t * fields, size_t fields_count)
+{
+  if (0u != fields_count) {
+    RCUTILS_CHECK_ARGUMENT_FOR_NULL(fields, RCUTILS_RET_INVALID_ARGUMENT);
+  }
+  for (size_t i = 0u; i < fields_count; ++i) {
+    if (NULL == fields[i].key ||
+      (RCUTILS_LOG_FIELD_TYPE_STRING == fields[i].type &&
+      NULL == fields[i].value.string_value.data && 0u != fields[i].value.string_value.length))
+    {
+      RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("invalid log field at index %zu", i);
+      return RCUTILS_RET_INVALID_ARGUMENT;
+    }
+  }
+  return RCUTILS_RET_OK;
+}
+
+// Append the fields as space separated key=value pairs, the array must be in the state of the
+// internal append functions.
+static rcutils_ret_t rcutils_logging_append_fields(
+  rcutils_char_array_t * output_array, const rcutils_log_field_t * fields, size_t fields_count)
+{
+  rcutils_ret_t ret = RCUTILS_RET_OK;
+  for (size_t i = 0u; i < fields_count && RCUTILS_RET_OK == ret; ++i) {
+    if (0u != i) {
+      ret = rcutils_logging_append_output(output_array, " ", 1u);
+    }
+    if (RCUTILS_RET_OK == ret) {
+      ret = rcutils_logging_append_output(output_array, fields[i].key, strlen(fields[i].key));
+    }
+    if (RCUTILS_RET_OK == ret) {
+      ret = rcutils_logging_append_output(output_array, "=", 1u);
+    }
+    if (RCUTILS_RET_OK == ret) {
+      ret = rcutils_logging_append_field_value(output_array, &fields[i], false);
+    }
+  }
+  return ret;
+}
+
+rcutils_ret_t rcutils_logging_format_fields(
+  const rcutils_log_field_t * fields, size_t fields_count,
+  rcutils_char_array_t * output_array)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(output_array, RCUTILS_RET_INVALID_ARGUMENT);
+  rcutils_ret_t ret = rcutils_logging_check_fields(fields, fields_count);
+  if (RCUTILS_RET_OK != ret) {
+    return ret;
+  }
+  if (NULL == output_array->buffer || 0u == output_array->buffer_capacity) {
+    ret = rcutils_char_array_expand_as_needed(output_array, 1u);
+    if (RCUTILS_RET_OK != ret) {
+      return ret;
+    }
+    output_array->buffer[0] = '\0';
+  }
+  // The fields are appended to the contents of the array, like rcutils_char_array_strcat().
+  output_array->buffer_length = strlen(output_array->buffer) + 1u;
+  return rcutils_logging_append_fields(output_array, fields, fields_count);
+}
+
+static void rcutils_logging_call_output_handler(
+  rcutils_logging_output_handler_t output_handler, const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  (*output_handler)(location, severity, name, timestamp, format, &args);
+  va_end(args);
+}
+
+// Render the message followed by the fields and pass it to the output handler.
+static void rcutils_logging_output_rendered_fields(
+  rcutils_logging_output_handler_t output_handler, const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const rcutils_log_field_t * fields, size_t fields_count,
+  const char * format, va_list * args)
+{
+  RCUTILS_CHAR_ARRAY_WITH_STACK(message_array, 1024, rcutils_get_default_allocator());
+  rcutils_ret_t ret = rcutils_logging_append_output_vsprintf(&message_array, format, args);
+  if (RCUTILS_RET_OK == ret && 0u != fields_count) {
+    ret = rcutils_logging_append_output(&message_array, " ", 1u);
+    if (RCUTILS_RET_OK == ret) {
+      ret = rcutils_logging_append_fields(&message_array, fields, fields_count);
+    }
+  }
+  if (RCUTILS_RET_OK == ret) {
+    rcutils_logging_call_output_handler(
+      output_handler, location, severity, name, timestamp, "%s", message_array.buffer);
+  } else {
+    RCUTILS_SAFE_FWRITE_TO_STDERR("Failed to format log message.\n");
+    rcutils_reset_error();
+  }
+  if (RCUTILS_RET_OK != rcutils_char_array_fini(&message_array)) {
+    RCUTILS_SAFE_FWRITE_TO_STDERR("Failed to fini array.\n");
+  }
+}
+
+void rcutils_log_kv(
+  const rcutils_log_location_t * location,
+  int severity,
+  const char * name,
+  const rcutils_log_field_t * fields,
+  size_t fields_count,
+  const char * format,
+  ...)
+{
+  rcutils_logging_structured_output_handler_t structured_output_handler =
+    g_rcutils_logging_structured_output_handler;
+  rcutils_logging_output_handler_t output_handler = rcutils_logging_get_output_handler();
+  rcutils_time_point_value_t now;
+  // Structured output handlers always get the timestamp.
+  if (!rcutils_logging_admit_message(
+      location, severity, name, NULL == structured_output_handler ? output_handler : NULL, &now))
+  {
+    return;
+  }
+  if (RCUTILS_RET_OK != rcutils_logging_check_fields(fields, fields_count)) {
+    RCUTILS_SAFE_FWRITE_TO_STDERR("Invalid fields of a structured log message.\n");
+    rcutils_reset_error();
+    return;
+  }
+  if (NULL == structured_output_handler && NULL == output_handler) {
+    return;
+  }
+  rcutils_time_point_value_t start = 0;
+  if (g_rcutils_logging_statistics_enabled) {
+    rcutils_logging_statistics_count(RCUTILS_LOGGING_STATISTICS_EMITTED, severity);
+    start = rcutils_logging_statistics_start_timer();
+  }
+  va_list args;
+  va_start(args, format);
+  if (NULL != structured_output_handler) {
+    (*structured_output_handler)(
+      location, severity, name ? name : "", now, fields, fields_count, format, &args);
+  } else {
+    rcutils_logging_output_rendered_fields(
+      output_handler, location, severity, name ? name : "", now, fields, fields_count,
+      format, &args);
+  }
+  va_end(args);
+  if (g_rcutils_logging_statistics_enabled) {
+    rcutils_logging_statistics_add_output_time(start);
+  }
+}
+
+// Append a member name of a JSON object, with its quotes and the colon.
+static rcutils_ret_t rcutils_logging_append_json_key(
+  rcutils_char_array_t * output_array, const char * key, size_t length)
+{
+  rcutils_ret_t ret = rcutils_logging_append_output(output_array, "\"", 1u);
+  if (RCUTILS_RET_OK == ret) {
+    ret = rcutils_logging_append_escaped(output_array, key, length);
+  }
+  if (RCUTILS_RET_OK == ret) {
+    ret = rcutils_logging_append_output(output_array, "\":", 2u);
+  }
+  return ret;
+}
+
+// Append the record as a line of JSON.
+static rcutils_ret_t rcutils_logging_append_json_record(
+  rcutils_char_array_t * output_array, int severity, const char * name,
+  rcutils_time_point_value_t timestamp, const char * message, size_t message_length,
+  const rcutils_log_field_t * fields, size_t fields_count)
+{
+  // The timestamp is split so that negative timestamps keep a positive fraction.
+  int64_t seconds = timestamp / RCUTILS_S_TO_NS(1);
+  int64_t nanoseconds = timestamp % RCUTILS_S_TO_NS(1);
+  if (nanoseconds < 0) {
+    seconds -= 1;
+    nanoseconds += RCUTILS_S_TO_NS(1);
+  }
+  char time_string[48];
+  int written = rcutils_snprintf(
+    time_string, sizeof(time_string), "{\"time\":%" PRId64 ".%09" PRId64 ",\"severity\":\"%s\"",
+    seconds, nanoseconds, g_rcutils_log_severity_names[severity]);
+  if (written < 0) {
+    RCUTILS_SET_ERROR_MSG("failed to format the time of a log record");
+    return RCUTILS_RET_ERROR;
+  }
+  rcutils_ret_t ret = rcutils_logging_append_output(output_array, time_string, (size_t)written);
+  if (RCUTILS_RET_OK == ret) {
+    ret = rcutils_logging_append_output(output_array, ",\"name\":\"", 9u);
+  }
+  if (RCUTILS_RET_OK == ret) {
+    ret = rcutils_logging_append_escaped(output_array, name, strlen(name));
+  }
+  if (RCUTILS_RET_OK == ret) {
+    ret = rcutils_logging_append_output(output_array, "\",\"message\":\"", 13u);
+  }
+  if (RCUTILS_RET_OK == ret) {
+    ret = rcutils_logging_append_escaped(output_array, message, message_length);
+  }
+  if (RCUTILS_RET_OK == ret) {
+    ret = rcutils_logging_append_output(output_array, "\",\"fields\":{", 12u);
+  }
+  for (size_t i = 0u; i < fields_count && RCUTILS_RET_OK == ret; ++i) {
+    if (0u != i) {
+      ret = rcutils_logging_append_output(output_array, ",", 1u);
+    }
+    if (RCUTILS_RET_OK == ret) {
+      ret = rcutils_logging_append_json_key(output_array, fields[i].key, strlen(fields[i].key));
+    }
+    if (RCUTILS_RET_OK == ret) {
+      ret = rcutils_logging_append_field_value(output_array, &fields[i], true);
+    }
+  }
+  if (RCUTILS_RET_OK == ret) {
+    ret = rcutils_logging_append_output(output_array, "}}\n", 3u);
+  }
+  return ret;
+}
+
+void rcutils_logging_json_output_handler(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const rcutils_log_field_t * fields, size_t fields_count,
+  const char * format, va_list * args)
+{
+  (void)location;
+  FILE * stream = rcutils_logging_get_console_output_stream();
+  if (NULL == stream) {
+    RCUTILS_SAFE_FWRITE_TO_STDERR(
+      "logging system isn't initialized: "
+      "call to rcutils_logging_json_output_handler failed.\n");
+    return;
+  }
+  if (severity < RCUTILS_LOG_SEVERITY_UNSET || severity > RCUTILS_LOG_SEVERITY_FATAL ||
+    NULL == g_rcutils_log_severity_names[severity])
+  {
+    RCUTILS_SAFE_FWRITE_TO_STDERR_WITH_FORMAT_STRING("unknown severity level: %d\n", severity);
+    return;
+  }
+
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  RCUTILS_CHAR_ARRAY_WITH_STACK(message_array, 512, allocator);
+  RCUTILS_CHAR_ARRAY_WITH_STACK(line_array, 1024, allocator);
+  rcutils_ret_t ret = rcutils_logging_append_output_vsprintf(&message_array, format, args);
+  if (RCUTILS_RET_OK == ret) {
+    ret = rcutils_logging_append_json_record(
+      &line_array, severity, name, timestamp, message_array.buffer,
+      message_array.buffer_length - 1u, fields, fields_count);
+  }
+  if (RCUTILS_RET_OK == ret) {
+    size_t written = fwrite(line_array.buffer, 1u, line_array.buffer_length - 1u, stream);
+    if (g_rcutils_logging_statistics_enabled) {
+      rcutils_logging_statistics_count_bytes(written);
+    }
+  } else {
+    RCUTILS_SAFE_FWRITE_TO_STDERR("Failed to format structured log message.\n");
+    rcutils_reset_error();
+  }
+
+  if (RCUTILS_RET_OK != rcutils_char_array_fini(&message_array)) {
+    RCUTILS_SAFE_FWRITE_TO_STDERR("Failed to fini array.\n");
+  }
+  if (RCUTILS_RET_OK != rcutils_char_array_fini(&line_array)) {
+    RCUTILS_SAFE_FWRITE_TO_STDERR("Failed to fini array.\n");
+  }
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,252 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <errno.h>
+#include <stdint.h>
+
+#ifdef _WIN32
+// See the comment in logging.c about warning C5105.
+# pragma warning(push)
+# pragma warning(disable : 5105)
+# include <windows.h>
+# pragma warning(pop)
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+#include "rcutils/error_handling.h"
+#include "rcutils/mapped_file.h"
+
+#if !defined(_WIN32) && !defined(O_CLOEXEC)
+# define O_CLOEXEC 0
+#endif
+
+rcutils_mapped_file_t
+rcutils_get_zero_initialized_mapped_file(void)
+{
+  static rcutils_mapped_file_t zero_initialized_mapped_file = {
+    .data = NULL,
+    .size = 0u,
+  };
+  return zero_initialized_mapped_file;
+}
+
+rcutils_ret_t
+rcutils_mapped_file_open(rcutils_mapped_file_t * file, const char * path)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(file, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(path, RCUTILS_RET_INVALID_ARGUMENT);
+  if (NULL != file->data) {
+    RCUTILS_SET_ERROR_MSG("file argument is not zero-initialized");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+
+#ifdef _WIN32
+  HANDLE handle = CreateFileA(
+    path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL,
+    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (INVALID_HANDLE_VALUE == handle) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "Failed to open '%s'. Error code: %lu", path, GetLastError());
+    return RCUTILS_RET_ERROR;
+  }
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(handle, &file_size)) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "Failed to get the size of '%s'. Error code: %lu", path, GetLastError());
+    CloseHandle(handle);
+    return RCUTILS_RET_ERROR;
+  }
+  if ((uint64_t)file_size.QuadPart > SIZE_MAX) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("'%s' is too large to be mapped", path);
+    CloseHandle(handle);
+    return RCUTILS_RET_ERROR;
+  }
+  if (0 == file_size.QuadPart) {
+    CloseHandle(handle);
+    file->size = 0u;
+    return RCUTILS_RET_OK;
+  }
+  HANDLE mapping = CreateFileMappingA(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+  // The view keeps the mapping and the file open
+  CloseHandle(handle);
+  if (NULL == mapping) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "Failed to map '%s'. Error code: %lu", path, GetLastError());
+    return RCUTILS_RET_ERROR;
+  }
+  void * data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  CloseHandle(mapping);
+  if (NULL == data) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "Failed to map '%s'. Error code: %lu", path, GetLastError());
+    return RCUTILS_RET_ERROR;
+  }
+  file->data = data;
+  file->size = (size_t)file_size.QuadPart;
+  return RCUTILS_RET_OK;
+#else
+  int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (-1 == fd) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("Failed to open '%s'. Error code: %d", path, errno);
+    return RCUTILS_RET_ERROR;
+  }
+  struct stat buf;
+  if (0 != fstat(fd, &buf)) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "Failed to get the size of '%s'. Error code: %d", path, errno);
+    close(fd);
+    return RCUTILS_RET_ERROR;
+  }
+  if (!S_ISREG(buf.st_mode)) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("'%s' is not a regular file", path);
+    close(fd);
+    return RCUTILS_RET_ERROR;
+  }
+  if ((uint64_t)buf.st_size > SIZE_MAX) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("'%s' is too large to be mapped", path);
+    close(fd);
+    return RCUTILS_RET_ERROR;
+  }
+  if (0 == buf.st_size) {
+    close(fd);
+    file->size = 0u;
+    return RCUTILS_RET_OK;
+  }
+  void * data = mmap(NULL, (size_t)buf.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  // The mapping keeps the file open
+  close(fd);
+  if (MAP_FAILED == data) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("Failed to map '%s'. Error code: %d", path, errno);
+    return RCUTILS_RET_ERROR;
+  }
+  file->data = data;
+  file->size = (size_t)buf.st_size;
+  return RCUTILS_RET_OK;
+#endif
+}
+
+size_t
+rcutils_mapped_file_get_size(const rcutils_mapped_file_t * file)
+{
+  if (NULL == file) {
+    return 0u;
+  }
+  return file->size;
+}
+
+rcutils_ret_t
+rcutils_mapped_file_advise(
+  const rcutils_mapped_file_t * file,
+  size_t offset,
+  size_t length,
+  rcutils_mapped_file_advice_t advice)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(file, RCUTILS_RET_INVALID_ARGUMENT);
+  if (
+    advice != RCUTILS_MAPPED_FILE_ADVICE_NORMAL &&
+    advice != RCUTILS_MAPPED_FILE_ADVICE_SEQUENTIAL &&
+    advice != RCUTILS_MAPPED_FILE_ADVICE_RANDOM &&
+    advice != RCUTILS_MAPPED_FILE_ADVICE_WILLNEED)
+  {
+    RCUTILS_SET_ERROR_MSG("unknown advice");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  if (NULL == file->data || offset >= file->size) {
+    return RCUTILS_RET_OK;
+  }
+  if (0u == length || length > file->size - offset) {
+    length = file->size - offset;
+  }
+
+#ifdef _WIN32
+#if defined(_WIN32_WINNT) && _WIN32_WINNT >= 0x0602
+  if (RCUTILS_MAPPED_FILE_ADVICE_WILLNEED == advice) {
+    WIN32_MEMORY_RANGE_ENTRY range;
+    range.VirtualAddress = (PVOID)(file->data + offset);
+    range.NumberOfBytes = length;
+    if (!PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0)) {
+      RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+        "Failed to prefetch the mapped file. Error code: %lu", GetLastError());
+      return RCUTILS_RET_ERROR;
+    }
+  }
+#endif
+  return RCUTILS_RET_OK;
+#else
+  // The start of the range has to be aligned to the pages, which the mapping is
+  long page_size = sysconf(_SC_PAGESIZE);
+  size_t alignment = page_size > 0 ? (size_t)page_size : 4096u;
+  size_t aligned_offset = offset - offset % alignment;
+  int posix_advice = MADV_NORMAL;
+  switch (advice) {
+    case RCUTILS_MAPPED_FILE_ADVICE_SEQUENTIAL:
+      posix_advice = MADV_SEQUENTIAL;
+      break;
+    case RCUTILS_MAPPED_FILE_ADVICE_RANDOM:
+      posix_advice = MADV_RANDOM;
+      break;
+    case RCUTILS_MAPPED_FILE_ADVICE_WILLNEED:
+      posix_advice = MADV_WILLNEED;
+      break;
+    case RCUTILS_MAPPED_FILE_ADVICE_NORMAL:
+    default:
+      break;
+  }
+  if (
+    0 != madvise(
+      (void *)(file->data + aligned_offset), length + (offset - aligned_offset), posix_advice))
+  {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "Failed to advise the mapped file. Error code: %d", errno);
+    return RCUTILS_RET_ERROR;
+  }
+  return RCUTILS_RET_OK;
+#endif
+}
+
+rcutils_ret_t
+rcutils_mapped_file_close(rcutils_mapped_file_t * file)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(file, RCUTILS_RET_INVALID_ARGUMENT);
+  if (NULL != file->data) {
+#ifdef _WIN32
+    if (!UnmapViewOfFile(file->data)) {
+      RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+        "Failed to unmap the mapped file. Error code: %lu", GetLastError());
+      return RCUTILS_RET_ERROR;
+    }
+#else
+    if (0 != munmap((void *)file->data, file->size)) {
+      RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+        "Failed to unmap the mapped file. Error code: %d", errno);
+      return RCUTILS_RET_ERROR;
+    }
+#endif
+  }
+  *file = rcutils_get_zero_initialized_mapped_file();
+  return RCUTILS_RET_OK;
+}
+
+#ifdef __cplusplus
+}
+#endif
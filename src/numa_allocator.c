@@ -0,0 +1,342 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+// See the comment in logging.c about warning C5105.
+# pragma warning(push)
+# pragma warning(disable : 5105)
+# include <windows.h>
+# pragma warning(pop)
+#else
+# include <sys/mman.h>
+# include <unistd.h>
+# ifdef __linux__
+#  include <linux/mempolicy.h>
+#  include <sys/syscall.h>
+# endif
+#endif
+
+#include "rcutils/error_handling.h"
+#include "rcutils/numa_allocator.h"
+
+#if !defined(_WIN32) && !defined(MAP_ANONYMOUS)
+# define MAP_ANONYMOUS MAP_ANON
+#endif
+
+#if defined(__linux__) && defined(SYS_mbind) && defined(SYS_getcpu)
+# define RCUTILS_NUMA_LINUX
+#endif
+
+// Stored right before each allocation.
+typedef struct rcutils_numa_allocation_header_s
+{
+  uint8_t * base;
+  size_t mapping_size;
+  int node;
+  bool bound;
+} rcutils_numa_allocation_header_t;
+
+static_assert(
+  sizeof(rcutils_numa_allocation_header_t) <= RCUTILS_NUMA_ALLOCATOR_HEADER_SIZE,
+  "the header of the NUMA allocations must fit before them");
+
+// The states of the allocators, the first one for the local node and then one per node,
+// only their addresses are used.
+static char g_rcutils_numa_allocator_states[RCUTILS_NUMA_ALLOCATOR_MAX_NODE_COUNT + 1];
+
+static size_t
+_page_size(void)
+{
+#ifdef _WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return (size_t)info.dwPageSize;
+#else
+  long page_size = sysconf(_SC_PAGESIZE);
+  return page_size > 0 ? (size_t)page_size : 4096u;
+#endif
+}
+
+// Rounds the size up to a multiple of the power of two granularity, or returns 0 on overflow.
+static size_t
+_round_up(size_t size, size_t granularity)
+{
+  if (size > SIZE_MAX - (granularity - 1u)) {
+    return 0u;
+  }
+  return (size + granularity - 1u) & ~(granularity - 1u);
+}
+
+static int
+_current_node(void)
+{
+#if defined(RCUTILS_NUMA_LINUX)
+  unsigned int cpu = 0u;
+  unsigned int node = 0u;
+  if (0 != syscall(SYS_getcpu, &cpu, &node, NULL)) {
+    return 0;
+  }
+  return (int)node;
+#elif defined(_WIN32)
+  PROCESSOR_NUMBER processor;
+  GetCurrentProcessorNumberEx(&processor);
+  USHORT node = 0u;
+  if (!GetNumaProcessorNodeEx(&processor, &node)) {
+    return 0;
+  }
+  return (int)node;
+#else
+  return 0;
+#endif
+}
+
+// Maps at least size bytes on the node if possible, and sets the size mapped.
+static uint8_t *
+_map(size_t size, int node, size_t * mapping_size, bool * bound)
+{
+  *bound = false;
+  *mapping_size = _round_up(size, _page_size());
+  if (0u == *mapping_size) {
+    return NULL;
+  }
+#ifdef _WIN32
+  void * base = VirtualAllocExNuma(
+    GetCurrentProcess(), NULL, *mapping_size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE,
+    (DWORD)node);
+  if (NULL != base) {
+    *bound = true;
+    return base;
+  }
+  // The node doesn't exist, fall back to the default policy
+  return VirtualAlloc(NULL, *mapping_size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+  void * base = mmap(
+    NULL, *mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (MAP_FAILED == base) {
+    return NULL;
+  }
+#if defined(RCUTILS_NUMA_LINUX)
+  // Nothing is touched yet, so the policy applies to all the pages of the mapping.
+  // This fails without NUMA support, if the node doesn't exist, or if a seccomp filter
+  // forbids it, and the memory is left to the default policy then.
+  if (node < RCUTILS_NUMA_ALLOCATOR_MAX_NODE_COUNT) {
+    const size_t bits = sizeof(unsigned long) * 8u;
+    unsigned long nodemask[RCUTILS_NUMA_ALLOCATOR_MAX_NODE_COUNT / (sizeof(unsigned long) * 8u)];
+    memset(nodemask, 0, sizeof(nodemask));
+    nodemask[(size_t)node / bits] = 1ul << ((size_t)node % bits);
+    // The kernel takes one bit less than the maximum node given
+    *bound = 0 == syscall(
+      SYS_mbind, base, *mapping_size, MPOL_PREFERRED, nodemask, sizeof(nodemask) * 8u + 1u, 0u);
+  }
+#else
+  RCUTILS_UNUSED(node);
+#endif
+  return base;
+#endif
+}
+
+static void
+_unmap(uint8_t * base, size_t mapping_size)
+{
+#ifdef _WIN32
+  RCUTILS_UNUSED(mapping_size);
+  (void)VirtualFree(base, 0, MEM_RELEASE);
+#else
+  (void)munmap(base, mapping_size);
+#endif
+}
+
+static rcutils_numa_allocation_header_t *
+_header(void * pointer)
+{
+  return (rcutils_numa_allocation_header_t *)((uint8_t *)pointer -
+         RCUTILS_NUMA_ALLOCATOR_HEADER_SIZE);
+}
+
+// Allocates the size bytes at offset bytes from the start of the mapping.
+static void *
+_numa_allocate_at(size_t offset, size_t size, void * state)
+{
+  int node = (int)((char *)state - g_rcutils_numa_allocator_states) - 1;
+  if (RCUTILS_NUMA_NODE_LOCAL == node) {
+    node = _current_node();
+  }
+  if (size > SIZE_MAX - offset) {
+    return NULL;
+  }
+  size_t mapping_size = 0u;
+  bool bound = false;
+  uint8_t * base = _map(offset + size, node, &mapping_size, &bound);
+  if (NULL == base) {
+    return NULL;
+  }
+  uint8_t * pointer = base + offset;
+  rcutils_numa_allocation_header_t * header = _header(pointer);
+  header->base = base;
+  header->mapping_size = mapping_size;
+  header->node = bound ? node : RCUTILS_NUMA_NODE_LOCAL;
+  header->bound = bound;
+  return pointer;
+}
+
+static void *
+_numa_allocate(size_t size, void * state)
+{
+  return _numa_allocate_at(RCUTILS_NUMA_ALLOCATOR_HEADER_SIZE, size, state);
+}
+
+static void
+_numa_deallocate(void * pointer, void * state)
+{
+  RCUTILS_UNUSED(state);
+  if (NULL == pointer) {
+    return;
+  }
+  rcutils_numa_allocation_header_t * header = _header(pointer);
+  _unmap(header->base, header->mapping_size);
+}
+
+static void *
+_numa_reallocate(void * pointer, size_t size, void * state)
+{
+  if (NULL == pointer) {
+    return _numa_allocate(size, state);
+  }
+  rcutils_numa_allocation_header_t * header = _header(pointer);
+  size_t capacity = header->mapping_size - (size_t)((uint8_t *)pointer - header->base);
+  if (size <= capacity) {
+    return pointer;
+  }
+  void * new_pointer = _numa_allocate(size, state);
+  if (NULL == new_pointer) {
+    return NULL;
+  }
+  memcpy(new_pointer, pointer, capacity);
+  _numa_deallocate(pointer, state);
+  return new_pointer;
+}
+
+static void *
+_numa_zero_allocate(size_t number_of_elements, size_t size_of_element, void * state)
+{
+  if (0u != size_of_element && number_of_elements > SIZE_MAX / size_of_element) {
+    return NULL;
+  }
+  // Fresh mappings are zero initialized
+  return _numa_allocate(number_of_elements * size_of_element, state);
+}
+
+static void *
+_numa_aligned_allocate(size_t alignment, size_t size, void * state)
+{
+  // Mappings are aligned to pages, so the allocation is aligned to its offset in its mapping
+  if (alignment > _page_size()) {
+    return NULL;
+  }
+  size_t offset = alignment > RCUTILS_NUMA_ALLOCATOR_HEADER_SIZE ?
+    alignment : RCUTILS_NUMA_ALLOCATOR_HEADER_SIZE;
+  return _numa_allocate_at(offset, size, state);
+}
+
+rcutils_ret_t
+rcutils_numa_get_node_count(size_t * count)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(count, RCUTILS_RET_INVALID_ARGUMENT);
+
+  *count = 1u;
+#if defined(RCUTILS_NUMA_LINUX)
+  // A list of ranges of nodes, like "0-1,3"
+  FILE * file = fopen("/sys/devices/system/node/possible", "r");
+  if (NULL == file) {
+    return RCUTILS_RET_OK;
+  }
+  char list[256];
+  size_t length = fread(list, 1u, sizeof(list) - 1u, file);
+  fclose(file);
+  list[length] = '\0';
+  size_t node = 0u;
+  for (size_t i = 0u; i <= length; ++i) {
+    if (list[i] >= '0' && list[i] <= '9') {
+      node = node * 10u + (size_t)(list[i] - '0');
+    } else {
+      if (i > 0u && list[i - 1u] >= '0' && list[i - 1u] <= '9' && node + 1u > *count) {
+        *count = node + 1u;
+      }
+      node = 0u;
+    }
+  }
+#elif defined(_WIN32)
+  ULONG highest_node = 0u;
+  if (GetNumaHighestNodeNumber(&highest_node)) {
+    *count = (size_t)highest_node + 1u;
+  }
+#endif
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_numa_get_current_node(int * node)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(node, RCUTILS_RET_INVALID_ARGUMENT);
+
+  *node = _current_node();
+  return RCUTILS_RET_OK;
+}
+
+rcutils_allocator_t
+rcutils_get_numa_allocator(int node)
+{
+  if (node < RCUTILS_NUMA_NODE_LOCAL || node >= RCUTILS_NUMA_ALLOCATOR_MAX_NODE_COUNT) {
+    return rcutils_get_zero_initialized_allocator();
+  }
+  rcutils_allocator_t allocator = {
+    .allocate = _numa_allocate,
+    .deallocate = _numa_deallocate,
+    .reallocate = _numa_reallocate,
+    .zero_allocate = _numa_zero_allocate,
+    .state = &g_rcutils_numa_allocator_states[node + 1],
+    .aligned_allocate = _numa_aligned_allocate,
+    .aligned_deallocate = _numa_deallocate,
+  };
+  return allocator;
+}
+
+rcutils_ret_t
+rcutils_numa_allocator_get_memory_info(
+  const void * pointer,
+  rcutils_numa_allocator_memory_info_t * info)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(pointer, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(info, RCUTILS_RET_INVALID_ARGUMENT);
+
+  const rcutils_numa_allocation_header_t * header = _header((void *)pointer);
+  info->mapping_size = header->mapping_size;
+  info->node = header->node;
+  info->bound = header->bound;
+  return RCUTILS_RET_OK;
+}
+
+#ifdef __cplusplus
+}
+#endif
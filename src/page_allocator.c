@@ -0,0 +1,305 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef _WIN32
+// See the comment in logging.c about warning C5105.
+# pragma warning(push)
+# pragma warning(disable : 5105)
+# include <windows.h>
+# pragma warning(pop)
+#else
+# include <sys/mman.h>
+# include <unistd.h>
+#endif
+
+#include "rcutils/error_handling.h"
+#include "rcutils/page_allocator.h"
+
+#if !defined(_WIN32) && !defined(MAP_ANONYMOUS)
+# define MAP_ANONYMOUS MAP_ANON
+#endif
+
+#define _FLAG_HUGE_PAGES 1u
+#define _FLAG_LOCKED 2u
+
+// Stored right before each allocation.
+typedef struct rcutils_page_allocation_header_s
+{
+  uint8_t * base;
+  size_t mapping_size;
+  unsigned int flags;
+} rcutils_page_allocation_header_t;
+
+static_assert(
+  sizeof(rcutils_page_allocation_header_t) <= RCUTILS_PAGE_ALLOCATOR_HEADER_SIZE,
+  "the header of the page allocations must fit before them");
+
+// The states of the allocators, one per combination of options.
+static rcutils_page_allocator_options_t g_rcutils_page_allocator_states[2][2] = {
+  {{.huge_pages = false, .lock_memory = false}, {.huge_pages = false, .lock_memory = true}},
+  {{.huge_pages = true, .lock_memory = false}, {.huge_pages = true, .lock_memory = true}},
+};
+
+static size_t
+_page_size(void)
+{
+#ifdef _WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return (size_t)info.dwPageSize;
+#else
+  long page_size = sysconf(_SC_PAGESIZE);
+  return page_size > 0 ? (size_t)page_size : 4096u;
+#endif
+}
+
+// Rounds the size up to a multiple of the power of two granularity, or returns 0 on overflow.
+static size_t
+_round_up(size_t size, size_t granularity)
+{
+  if (size > SIZE_MAX - (granularity - 1u)) {
+    return 0u;
+  }
+  return (size + granularity - 1u) & ~(granularity - 1u);
+}
+
+// Maps at least size bytes, with huge pages if asked and possible, and sets the size mapped.
+static uint8_t *
+_map(size_t size, bool huge_pages, size_t * mapping_size, unsigned int * flags)
+{
+  *flags = 0u;
+#ifdef _WIN32
+  if (huge_pages) {
+    size_t large_page_size = (size_t)GetLargePageMinimum();
+    size_t huge_size = 0u == large_page_size ? 0u : _round_up(size, large_page_size);
+    if (0u != huge_size) {
+      // This needs the SeLockMemoryPrivilege, fall back to regular pages without it
+      void * base = VirtualAlloc(
+        NULL, huge_size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+      if (NULL != base) {
+        *mapping_size = huge_size;
+        *flags = _FLAG_HUGE_PAGES;
+        return base;
+      }
+    }
+  }
+  *mapping_size = _round_up(size, _page_size());
+  if (0u == *mapping_size) {
+    return NULL;
+  }
+  return VirtualAlloc(NULL, *mapping_size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+#ifdef MAP_HUGETLB
+  if (huge_pages) {
+    size_t huge_size = _round_up(size, RCUTILS_PAGE_ALLOCATOR_HUGE_PAGE_SIZE);
+    if (0u != huge_size) {
+      // This fails if no huge pages are reserved, fall back to regular pages then
+      void * base = mmap(
+        NULL, huge_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+      if (MAP_FAILED != base) {
+        *mapping_size = huge_size;
+        *flags = _FLAG_HUGE_PAGES;
+        return base;
+      }
+    }
+  }
+#endif
+  *mapping_size = _round_up(size, _page_size());
+  if (0u == *mapping_size) {
+    return NULL;
+  }
+  void * base = mmap(
+    NULL, *mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (MAP_FAILED == base) {
+    return NULL;
+  }
+#ifdef MADV_HUGEPAGE
+  if (huge_pages) {
+    // Only a hint for transparent huge pages, which may be disabled
+    (void)madvise(base, *mapping_size, MADV_HUGEPAGE);
+  }
+#endif
+  return base;
+#endif
+}
+
+static void
+_unmap(uint8_t * base, size_t mapping_size)
+{
+#ifdef _WIN32
+  RCUTILS_UNUSED(mapping_size);
+  (void)VirtualFree(base, 0, MEM_RELEASE);
+#else
+  (void)munmap(base, mapping_size);
+#endif
+}
+
+static bool
+_lock(uint8_t * base, size_t mapping_size)
+{
+#ifdef _WIN32
+  return 0 != VirtualLock(base, mapping_size);
+#else
+  return 0 == mlock(base, mapping_size);
+#endif
+}
+
+static rcutils_page_allocation_header_t *
+_header(void * pointer)
+{
+  return (rcutils_page_allocation_header_t *)((uint8_t *)pointer -
+         RCUTILS_PAGE_ALLOCATOR_HEADER_SIZE);
+}
+
+// Allocates the size bytes at offset bytes from the start of the mapping.
+static void *
+_page_allocate_at(size_t offset, size_t size, void * state)
+{
+  const rcutils_page_allocator_options_t * options = state;
+  if (size > SIZE_MAX - offset) {
+    return NULL;
+  }
+  size_t mapping_size = 0u;
+  unsigned int flags = 0u;
+  uint8_t * base = _map(offset + size, options->huge_pages, &mapping_size, &flags);
+  if (NULL == base) {
+    return NULL;
+  }
+  // The memory stays usable if the limit of locked memory is reached
+  if (options->lock_memory && _lock(base, mapping_size)) {
+    flags |= _FLAG_LOCKED;
+  }
+  uint8_t * pointer = base + offset;
+  rcutils_page_allocation_header_t * header = _header(pointer);
+  header->base = base;
+  header->mapping_size = mapping_size;
+  header->flags = flags;
+  return pointer;
+}
+
+static void *
+_page_allocate(size_t size, void * state)
+{
+  return _page_allocate_at(RCUTILS_PAGE_ALLOCATOR_HEADER_SIZE, size, state);
+}
+
+static void
+_page_deallocate(void * pointer, void * state)
+{
+  RCUTILS_UNUSED(state);
+  if (NULL == pointer) {
+    return;
+  }
+  rcutils_page_allocation_header_t * header = _header(pointer);
+  // Unmapping also unlocks the memory
+  _unmap(header->base, header->mapping_size);
+}
+
+static void *
+_page_reallocate(void * pointer, size_t size, void * state)
+{
+  if (NULL == pointer) {
+    return _page_allocate(size, state);
+  }
+  rcutils_page_allocation_header_t * header = _header(pointer);
+  size_t capacity = header->mapping_size - (size_t)((uint8_t *)pointer - header->base);
+  if (size <= capacity) {
+    return pointer;
+  }
+  void * new_pointer = _page_allocate(size, state);
+  if (NULL == new_pointer) {
+    return NULL;
+  }
+  memcpy(new_pointer, pointer, capacity);
+  _page_deallocate(pointer, state);
+  return new_pointer;
+}
+
+static void *
+_page_zero_allocate(size_t number_of_elements, size_t size_of_element, void * state)
+{
+  if (0u != size_of_element && number_of_elements > SIZE_MAX / size_of_element) {
+    return NULL;
+  }
+  // Fresh mappings are zero initialized
+  return _page_allocate(number_of_elements * size_of_element, state);
+}
+
+static void *
+_page_aligned_allocate(size_t alignment, size_t size, void * state)
+{
+  // Mappings are aligned to pages, so the allocation is aligned to its offset in its mapping
+  if (alignment > _page_size()) {
+    return NULL;
+  }
+  size_t offset = alignment > RCUTILS_PAGE_ALLOCATOR_HEADER_SIZE ?
+    alignment : RCUTILS_PAGE_ALLOCATOR_HEADER_SIZE;
+  return _page_allocate_at(offset, size, state);
+}
+
+rcutils_page_allocator_options_t
+rcutils_page_allocator_get_default_options(void)
+{
+  static rcutils_page_allocator_options_t default_options = {
+    .huge_pages = true,
+    .lock_memory = false,
+  };
+  return default_options;
+}
+
+rcutils_allocator_t
+rcutils_get_page_allocator(const rcutils_page_allocator_options_t * options)
+{
+  if (NULL == options) {
+    return rcutils_get_zero_initialized_allocator();
+  }
+  rcutils_allocator_t allocator = {
+    .allocate = _page_allocate,
+    .deallocate = _page_deallocate,
+    .reallocate = _page_reallocate,
+    .zero_allocate = _page_zero_allocate,
+    .state = &g_rcutils_page_allocator_states[options->huge_pages][options->lock_memory],
+    .aligned_allocate = _page_aligned_allocate,
+    .aligned_deallocate = _page_deallocate,
+  };
+  return allocator;
+}
+
+rcutils_ret_t
+rcutils_page_allocator_get_memory_info(
+  const void * pointer,
+  rcutils_page_allocator_memory_info_t * info)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(pointer, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(info, RCUTILS_RET_INVALID_ARGUMENT);
+
+  const rcutils_page_allocation_header_t * header = _header((void *)pointer);
+  info->mapping_size = header->mapping_size;
+  info->huge_pages = 0u != (header->flags & _FLAG_HUGE_PAGES);
+  info->locked = 0u != (header->flags & _FLAG_LOCKED);
+  return RCUTILS_RET_OK;
+}
+
+#ifdef __cplusplus
+}
+#endif
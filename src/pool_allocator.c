@@ -0,0 +1,293 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "rcutils/error_handling.h"
+#include "rcutils/pool_allocator.h"
+
+// The block sizes, multiples of the alignment up to the largest block size
+static const size_t g_size_classes[] = {16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024};
+#define SIZE_CLASS_COUNT (sizeof(g_size_classes) / sizeof(g_size_classes[0]))
+// The size class of the allocations which aren't pooled
+#define LARGE_SIZE_CLASS SIZE_CLASS_COUNT
+
+// Placed before each allocation, and padded to the alignment so the allocation stays aligned.
+typedef struct block_header_s
+{
+  size_t size_class;
+  // The requested size of the allocations which aren't pooled.
+  size_t size;
+} block_header_t;
+
+#define BLOCK_HEADER_SIZE RCUTILS_POOL_ALLOCATOR_ALIGNMENT
+
+// Overlaps the memory of the free blocks.
+typedef struct free_block_s
+{
+  struct free_block_s * next;
+} free_block_t;
+
+typedef struct slab_s
+{
+  struct slab_s * next;
+} slab_t;
+
+typedef struct size_class_s
+{
+  free_block_t * free_list;
+  // The blocks of the last slab of this class which were never allocated.
+  uint8_t * slab_next;
+  size_t slab_remaining;
+} size_class_t;
+
+typedef struct rcutils_pool_allocator_impl_s
+{
+  size_class_t size_classes[SIZE_CLASS_COUNT];
+  slab_t * slabs;
+  size_t slab_size;
+  rcutils_allocator_t allocator;
+} rcutils_pool_allocator_impl_t;
+
+static uint8_t *
+_align_up(uint8_t * pointer)
+{
+  uintptr_t misalignment = (uintptr_t)pointer % RCUTILS_POOL_ALLOCATOR_ALIGNMENT;
+  if (0u != misalignment) {
+    pointer += RCUTILS_POOL_ALLOCATOR_ALIGNMENT - misalignment;
+  }
+  return pointer;
+}
+
+static size_t
+_get_size_class(size_t size)
+{
+  size_t size_class = 0u;
+  while (g_size_classes[size_class] < size) {
+    ++size_class;
+  }
+  return size_class;
+}
+
+static block_header_t *
+_get_header(void * pointer)
+{
+  return (block_header_t *)((uint8_t *)pointer - BLOCK_HEADER_SIZE);
+}
+
+// Large allocations keep the pointer allocated by the other allocator before their header.
+static void **
+_get_large_allocation(block_header_t * header)
+{
+  return (void **)((uint8_t *)header - sizeof(void *));
+}
+
+static void *
+_allocate_large(rcutils_pool_allocator_impl_t * impl, size_t size)
+{
+  size_t prefix = sizeof(void *) + BLOCK_HEADER_SIZE + RCUTILS_POOL_ALLOCATOR_ALIGNMENT - 1u;
+  if (size > SIZE_MAX - prefix) {
+    return NULL;
+  }
+  uint8_t * allocation = impl->allocator.allocate(prefix + size, impl->allocator.state);
+  if (NULL == allocation) {
+    return NULL;
+  }
+  uint8_t * pointer = _align_up(allocation + sizeof(void *) + BLOCK_HEADER_SIZE);
+  block_header_t * header = _get_header(pointer);
+  header->size_class = LARGE_SIZE_CLASS;
+  header->size = size;
+  *_get_large_allocation(header) = allocation;
+  return pointer;
+}
+
+static bool
+_allocate_slab(rcutils_pool_allocator_impl_t * impl, size_class_t * size_class, size_t block_size)
+{
+  size_t stride = BLOCK_HEADER_SIZE + block_size;
+  size_t prefix = sizeof(slab_t) + RCUTILS_POOL_ALLOCATOR_ALIGNMENT - 1u;
+  size_t block_count = impl->slab_size > prefix ? (impl->slab_size - prefix) / stride : 0u;
+  if (0u == block_count) {
+    block_count = 1u;
+  }
+  slab_t * slab = impl->allocator.allocate(prefix + block_count * stride, impl->allocator.state);
+  if (NULL == slab) {
+    return false;
+  }
+  slab->next = impl->slabs;
+  impl->slabs = slab;
+  size_class->slab_next = _align_up((uint8_t *)(slab + 1));
+  size_class->slab_remaining = block_count;
+  return true;
+}
+
+static void *
+_pool_allocate(size_t size, void * state)
+{
+  rcutils_pool_allocator_impl_t * impl = state;
+  if (size > RCUTILS_POOL_ALLOCATOR_MAX_BLOCK_SIZE) {
+    return _allocate_large(impl, size);
+  }
+  size_t index = _get_size_class(size);
+  size_class_t * size_class = &impl->size_classes[index];
+  void * pointer;
+  if (NULL != size_class->free_list) {
+    pointer = size_class->free_list;
+    size_class->free_list = size_class->free_list->next;
+    return pointer;
+  }
+  if (0u == size_class->slab_remaining &&
+    !_allocate_slab(impl, size_class, g_size_classes[index]))
+  {
+    return NULL;
+  }
+  block_header_t * header = (block_header_t *)size_class->slab_next;
+  header->size_class = index;
+  header->size = 0u;
+  size_class->slab_next += BLOCK_HEADER_SIZE + g_size_classes[index];
+  --size_class->slab_remaining;
+  return (uint8_t *)header + BLOCK_HEADER_SIZE;
+}
+
+static void
+_pool_deallocate(void * pointer, void * state)
+{
+  rcutils_pool_allocator_impl_t * impl = state;
+  if (NULL == pointer) {
+    return;
+  }
+  block_header_t * header = _get_header(pointer);
+  if (LARGE_SIZE_CLASS == header->size_class) {
+    impl->allocator.deallocate(*_get_large_allocation(header), impl->allocator.state);
+    return;
+  }
+  // The header is kept, so the block is ready to be allocated again
+  free_block_t * block = pointer;
+  block->next = impl->size_classes[header->size_class].free_list;
+  impl->size_classes[header->size_class].free_list = block;
+}
+
+static void *
+_pool_reallocate(void * pointer, size_t size, void * state)
+{
+  if (NULL == pointer) {
+    return _pool_allocate(size, state);
+  }
+  block_header_t * header = _get_header(pointer);
+  size_t capacity = LARGE_SIZE_CLASS == header->size_class ?
+    header->size : g_size_classes[header->size_class];
+  if (LARGE_SIZE_CLASS != header->size_class && size <= capacity) {
+    return pointer;
+  }
+  void * new_pointer = _pool_allocate(size, state);
+  if (NULL == new_pointer) {
+    return NULL;
+  }
+  memcpy(new_pointer, pointer, size < capacity ? size : capacity);
+  _pool_deallocate(pointer, state);
+  return new_pointer;
+}
+
+static void *
+_pool_zero_allocate(size_t number_of_elements, size_t size_of_element, void * state)
+{
+  if (0u != size_of_element && number_of_elements > SIZE_MAX / size_of_element) {
+    return NULL;
+  }
+  size_t size = number_of_elements * size_of_element;
+  void * pointer = _pool_allocate(size, state);
+  if (NULL != pointer) {
+    memset(pointer, 0, size);
+  }
+  return pointer;
+}
+
+rcutils_pool_allocator_t
+rcutils_get_zero_initialized_pool_allocator(void)
+{
+  static rcutils_pool_allocator_t zero_initialized_pool_allocator = {NULL};
+  return zero_initialized_pool_allocator;
+}
+
+rcutils_ret_t
+rcutils_pool_allocator_init(
+  rcutils_pool_allocator_t * pool,
+  size_t slab_size,
+  const rcutils_allocator_t * allocator)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(pool, RCUTILS_RET_INVALID_ARGUMENT);
+  if (NULL != pool->impl) {
+    RCUTILS_SET_ERROR_MSG("pool allocator is already initialized");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  RCUTILS_CHECK_ALLOCATOR_WITH_MSG(
+    allocator, "invalid allocator", return RCUTILS_RET_INVALID_ARGUMENT);
+
+  rcutils_pool_allocator_impl_t * impl = allocator->zero_allocate(
+    1, sizeof(rcutils_pool_allocator_impl_t), allocator->state);
+  if (NULL == impl) {
+    RCUTILS_SET_ERROR_MSG("failed to allocate memory for pool allocator");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  impl->slab_size = 0u == slab_size ? RCUTILS_POOL_ALLOCATOR_DEFAULT_SLAB_SIZE : slab_size;
+  impl->allocator = *allocator;
+  pool->impl = impl;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_pool_allocator_fini(rcutils_pool_allocator_t * pool)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(pool, RCUTILS_RET_INVALID_ARGUMENT);
+  rcutils_pool_allocator_impl_t * impl = pool->impl;
+  if (NULL == impl) {
+    return RCUTILS_RET_OK;
+  }
+  slab_t * slab = impl->slabs;
+  while (NULL != slab) {
+    slab_t * next = slab->next;
+    impl->allocator.deallocate(slab, impl->allocator.state);
+    slab = next;
+  }
+  impl->allocator.deallocate(impl, impl->allocator.state);
+  pool->impl = NULL;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_allocator_t
+rcutils_pool_allocator_get_allocator(const rcutils_pool_allocator_t * pool)
+{
+  if (NULL == pool || NULL == pool->impl) {
+    return rcutils_get_zero_initialized_allocator();
+  }
+  rcutils_allocator_t allocator = {
+    .allocate = _pool_allocate,
+    .deallocate = _pool_deallocate,
+    .reallocate = _pool_reallocate,
+    .zero_allocate = _pool_zero_allocate,
+    .state = pool->impl,
+  };
+  return allocator;
+}
+
+#ifdef __cplusplus
+}
+#endif
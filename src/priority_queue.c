@@ -0,0 +1,357 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "rcutils/error_handling.h"
+#include "rcutils/types/priority_queue.h"
+
+// The number of children of each node, a wider heap is shallower and its children share
+// cache lines.
+#define PRIORITY_QUEUE_ARITY 4
+#define PRIORITY_QUEUE_MIN_CAPACITY 8
+
+#define PRIORITY_QUEUE_VALIDATE(queue) \
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(queue, RCUTILS_RET_INVALID_ARGUMENT); \
+  if (NULL == queue->impl) { \
+    RCUTILS_SET_ERROR_MSG("priority queue is not initialized"); \
+    return RCUTILS_RET_NOT_INITIALIZED; \
+  }
+
+typedef struct rcutils_priority_queue_impl_s
+{
+  // The elements in heap order.
+  uint8_t * elements;
+  // The handle of the element at each position, the handles at positions from size on
+  // being the free ones, so that the handles are a permutation of [0, capacity).
+  size_t * handles;
+  // The position of the element of each handle, the inverse of handles.
+  size_t * positions;
+  // Room for the element being moved while sifting.
+  uint8_t * hole;
+  size_t size;
+  size_t capacity;
+  size_t element_size;
+  int (* comp)(const void *, const void *);
+  rcutils_allocator_t allocator;
+} rcutils_priority_queue_impl_t;
+
+static uint8_t *
+_element(const rcutils_priority_queue_impl_t * impl, size_t position)
+{
+  return impl->elements + position * impl->element_size;
+}
+
+// Place the element in the hole with the given handle at position.
+static void
+_fill(rcutils_priority_queue_impl_t * impl, size_t position, size_t handle)
+{
+  memcpy(_element(impl, position), impl->hole, impl->element_size);
+  impl->handles[position] = handle;
+  impl->positions[handle] = position;
+}
+
+// Move the element at from to position to.
+static void
+_move(rcutils_priority_queue_impl_t * impl, size_t from, size_t to)
+{
+  memcpy(_element(impl, to), _element(impl, from), impl->element_size);
+  impl->handles[to] = impl->handles[from];
+  impl->positions[impl->handles[to]] = to;
+}
+
+// Restore the heap order around the element at position, moving it up or down.
+static void
+_sift(rcutils_priority_queue_impl_t * impl, size_t position)
+{
+  size_t handle = impl->handles[position];
+  memcpy(impl->hole, _element(impl, position), impl->element_size);
+
+  bool moved_up = false;
+  while (position > 0) {
+    size_t parent = (position - 1) / PRIORITY_QUEUE_ARITY;
+    if (impl->comp(impl->hole, _element(impl, parent)) >= 0) {
+      break;
+    }
+    _move(impl, parent, position);
+    position = parent;
+    moved_up = true;
+  }
+  while (!moved_up) {
+    size_t first_child = position * PRIORITY_QUEUE_ARITY + 1;
+    if (first_child >= impl->size || first_child < position) {
+      break;
+    }
+    size_t last_child = first_child + PRIORITY_QUEUE_ARITY;
+    if (last_child > impl->size) {
+      last_child = impl->size;
+    }
+    size_t smallest = first_child;
+    for (size_t child = first_child + 1; child < last_child; ++child) {
+      if (impl->comp(_element(impl, child), _element(impl, smallest)) < 0) {
+        smallest = child;
+      }
+    }
+    if (impl->comp(_element(impl, smallest), impl->hole) >= 0) {
+      break;
+    }
+    _move(impl, smallest, position);
+    position = smallest;
+  }
+  _fill(impl, position, handle);
+}
+
+// Reallocate the arrays for a capacity larger than the current one.
+static rcutils_ret_t
+_grow(rcutils_priority_queue_impl_t * impl, size_t capacity)
+{
+  if (capacity > SIZE_MAX / impl->element_size || capacity > SIZE_MAX / sizeof(size_t)) {
+    RCUTILS_SET_ERROR_MSG("priority queue capacity is too large");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  rcutils_allocator_t * allocator = &impl->allocator;
+  // On failure the arrays already reallocated are only larger than needed
+  uint8_t * elements = allocator->reallocate(
+    impl->elements, capacity * impl->element_size, allocator->state);
+  if (NULL == elements) {
+    RCUTILS_SET_ERROR_MSG("failed to allocate memory for priority queue elements");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  impl->elements = elements;
+  size_t * handles = allocator->reallocate(
+    impl->handles, capacity * sizeof(size_t), allocator->state);
+  if (NULL == handles) {
+    RCUTILS_SET_ERROR_MSG("failed to allocate memory for priority queue handles");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  impl->handles = handles;
+  size_t * positions = allocator->reallocate(
+    impl->positions, capacity * sizeof(size_t), allocator->state);
+  if (NULL == positions) {
+    RCUTILS_SET_ERROR_MSG("failed to allocate memory for priority queue handles");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  impl->positions = positions;
+  for (size_t i = impl->capacity; i < capacity; ++i) {
+    impl->handles[i] = i;
+    impl->positions[i] = i;
+  }
+  impl->capacity = capacity;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_priority_queue_t
+rcutils_get_zero_initialized_priority_queue(void)
+{
+  static rcutils_priority_queue_t zero_initialized_priority_queue = {NULL};
+  return zero_initialized_priority_queue;
+}
+
+rcutils_ret_t
+rcutils_priority_queue_init(
+  rcutils_priority_queue_t * queue,
+  size_t initial_capacity,
+  size_t element_size,
+  int (* comp)(const void *, const void *),
+  const rcutils_allocator_t * allocator)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(queue, RCUTILS_RET_INVALID_ARGUMENT);
+  if (NULL != queue->impl) {
+    RCUTILS_SET_ERROR_MSG("priority queue is already initialized");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  if (0 == element_size) {
+    RCUTILS_SET_ERROR_MSG("element_size must be more than 0");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    comp, "comp is null", return RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ALLOCATOR_WITH_MSG(
+    allocator, "invalid allocator", return RCUTILS_RET_INVALID_ARGUMENT);
+
+  rcutils_priority_queue_impl_t * impl = allocator->zero_allocate(
+    1, sizeof(rcutils_priority_queue_impl_t), allocator->state);
+  if (NULL == impl) {
+    RCUTILS_SET_ERROR_MSG("failed to allocate memory for priority queue");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  impl->element_size = element_size;
+  impl->comp = comp;
+  impl->allocator = *allocator;
+  impl->hole = allocator->allocate(element_size, allocator->state);
+  rcutils_ret_t ret = RCUTILS_RET_BAD_ALLOC;
+  if (NULL == impl->hole) {
+    RCUTILS_SET_ERROR_MSG("failed to allocate memory for priority queue");
+  } else if (0 == initial_capacity) {
+    ret = RCUTILS_RET_OK;
+  } else {
+    ret = _grow(impl, initial_capacity);
+  }
+  if (RCUTILS_RET_OK != ret) {
+    allocator->deallocate(impl->positions, allocator->state);
+    allocator->deallocate(impl->handles, allocator->state);
+    allocator->deallocate(impl->elements, allocator->state);
+    allocator->deallocate(impl->hole, allocator->state);
+    allocator->deallocate(impl, allocator->state);
+    // error message already set
+    return ret;
+  }
+
+  queue->impl = impl;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_priority_queue_fini(rcutils_priority_queue_t * queue)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(queue, RCUTILS_RET_INVALID_ARGUMENT);
+  rcutils_priority_queue_impl_t * impl = queue->impl;
+  if (NULL == impl) {
+    return RCUTILS_RET_OK;
+  }
+  rcutils_allocator_t allocator = impl->allocator;
+  allocator.deallocate(impl->positions, allocator.state);
+  allocator.deallocate(impl->handles, allocator.state);
+  allocator.deallocate(impl->elements, allocator.state);
+  allocator.deallocate(impl->hole, allocator.state);
+  allocator.deallocate(impl, allocator.state);
+  queue->impl = NULL;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_priority_queue_push(
+  rcutils_priority_queue_t * queue, const void * data, rcutils_priority_queue_handle_t * handle)
+{
+  PRIORITY_QUEUE_VALIDATE(queue);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(data, RCUTILS_RET_INVALID_ARGUMENT);
+  rcutils_priority_queue_impl_t * impl = queue->impl;
+
+  if (impl->size == impl->capacity) {
+    size_t capacity = impl->capacity * 2;
+    if (capacity < PRIORITY_QUEUE_MIN_CAPACITY) {
+      capacity = PRIORITY_QUEUE_MIN_CAPACITY;
+    }
+    rcutils_ret_t ret = _grow(impl, capacity);
+    if (RCUTILS_RET_OK != ret) {
+      // error message already set
+      return ret;
+    }
+  }
+  // The handle at the first free position isn't used by any element
+  size_t position = impl->size++;
+  size_t new_handle = impl->handles[position];
+  memcpy(_element(impl, position), data, impl->element_size);
+  _sift(impl, position);
+  if (NULL != handle) {
+    *handle = new_handle;
+  }
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_priority_queue_peek(
+  const rcutils_priority_queue_t * queue, void * data, rcutils_priority_queue_handle_t * handle)
+{
+  PRIORITY_QUEUE_VALIDATE(queue);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(data, RCUTILS_RET_INVALID_ARGUMENT);
+  const rcutils_priority_queue_impl_t * impl = queue->impl;
+  if (0 == impl->size) {
+    return RCUTILS_RET_QUEUE_EMPTY;
+  }
+  memcpy(data, _element(impl, 0), impl->element_size);
+  if (NULL != handle) {
+    *handle = impl->handles[0];
+  }
+  return RCUTILS_RET_OK;
+}
+
+// Remove the element at position, keeping its handle for a later push.
+static void
+_remove_at(rcutils_priority_queue_impl_t * impl, size_t position, void * data)
+{
+  if (NULL != data) {
+    memcpy(data, _element(impl, position), impl->element_size);
+  }
+  size_t handle = impl->handles[position];
+  size_t last = --impl->size;
+  if (position != last) {
+    _move(impl, last, position);
+    impl->handles[last] = handle;
+    impl->positions[handle] = last;
+    _sift(impl, position);
+  }
+}
+
+rcutils_ret_t
+rcutils_priority_queue_pop(rcutils_priority_queue_t * queue, void * data)
+{
+  PRIORITY_QUEUE_VALIDATE(queue);
+  if (0 == queue->impl->size) {
+    return RCUTILS_RET_QUEUE_EMPTY;
+  }
+  _remove_at(queue->impl, 0, data);
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_priority_queue_update(
+  rcutils_priority_queue_t * queue, rcutils_priority_queue_handle_t handle, const void * data)
+{
+  PRIORITY_QUEUE_VALIDATE(queue);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(data, RCUTILS_RET_INVALID_ARGUMENT);
+  rcutils_priority_queue_impl_t * impl = queue->impl;
+  if (handle >= impl->capacity || impl->positions[handle] >= impl->size) {
+    RCUTILS_SET_ERROR_MSG("no element of the priority queue has the handle");
+    return RCUTILS_RET_NOT_FOUND;
+  }
+  size_t position = impl->positions[handle];
+  memcpy(_element(impl, position), data, impl->element_size);
+  _sift(impl, position);
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_priority_queue_remove(
+  rcutils_priority_queue_t * queue, rcutils_priority_queue_handle_t handle, void * data)
+{
+  PRIORITY_QUEUE_VALIDATE(queue);
+  rcutils_priority_queue_impl_t * impl = queue->impl;
+  if (handle >= impl->capacity || impl->positions[handle] >= impl->size) {
+    RCUTILS_SET_ERROR_MSG("no element of the priority queue has the handle");
+    return RCUTILS_RET_NOT_FOUND;
+  }
+  _remove_at(impl, impl->positions[handle], data);
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_priority_queue_get_size(const rcutils_priority_queue_t * queue, size_t * size)
+{
+  PRIORITY_QUEUE_VALIDATE(queue);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(size, RCUTILS_RET_INVALID_ARGUMENT);
+  *size = queue->impl->size;
+  return RCUTILS_RET_OK;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -36,14 +36,26 @@ extern "C"
 #pragma warning(pop)
 #else
 #include <libgen.h>
+#include <limits.h>
+#include <pthread.h>
 #include <unistd.h>
 #endif
+#if defined __APPLE__
+#include <mach-o/dyld.h>
+#endif
 
 #include "rcutils/allocator.h"
 #include "rcutils/error_handling.h"
 #include "rcutils/process.h"
+#include "rcutils/stdatomic_helper.h"
 #include "rcutils/strdup.h"
 
+// The size of the buffers the executable path and the host name are read into
+#define PROCESS_INFO_BUFFER_SIZE 4096
+
+// The information about the process, allocated once and never deallocated.
+static atomic_uintptr_t g_rcutils_process_info = ATOMIC_VAR_INIT(0);
+
 int rcutils_get_pid(void)
 {
 #if defined _WIN32 || defined __CYGWIN__
@@ -111,6 +123,136 @@ char * rcutils_get_executable_name(rcutils_allocator_t allocator)
   return executable_name;
 }
 
+// Reads the path of the executable into the buffer, returns false if it is unknown.
+static bool
+_get_executable_path(char * buffer, size_t size)
+{
+#if defined _WIN32 || defined __CYGWIN__
+  DWORD length = GetModuleFileNameA(NULL, buffer, (DWORD)size);
+  return 0 != length && length < size;
+#elif defined __linux__
+  ssize_t length = readlink("/proc/self/exe", buffer, size - 1);
+  // A path filling the whole buffer may have been truncated
+  if (length <= 0 || (size_t)length >= size - 1) {
+    return false;
+  }
+  buffer[length] = '\0';
+  return true;
+#elif defined __APPLE__
+  uint32_t buffer_size = (uint32_t)size;
+  return 0 == _NSGetExecutablePath(buffer, &buffer_size);
+#else
+  (void)buffer;
+  (void)size;
+  return false;
+#endif
+}
+
+// Reads the name of the host into the buffer, returns false if it is unknown.
+static bool
+_get_hostname(char * buffer, size_t size)
+{
+#if defined _WIN32 || defined __CYGWIN__
+  DWORD length = (DWORD)size;
+  return 0 != GetComputerNameA(buffer, &length);
+#else
+  if (0 != gethostname(buffer, size)) {
+    return false;
+  }
+  // The name isn't null terminated if it is truncated
+  buffer[size - 1] = '\0';
+  return true;
+#endif
+}
+
+#if !defined _WIN32 && !defined __CYGWIN__
+// The process ID changes in the child of a fork, which only has the thread calling it.
+static void
+_update_process_info_pid(void)
+{
+  rcutils_process_info_t * info =
+    (rcutils_process_info_t *)rcutils_atomic_load_uintptr_t(&g_rcutils_process_info);
+  if (NULL != info) {
+    info->pid = rcutils_get_pid();
+  }
+}
+#endif
+
+static rcutils_process_info_t *
+_create_process_info(rcutils_allocator_t allocator)
+{
+  char * executable_name = rcutils_get_executable_name(allocator);
+  if (NULL == executable_name) {
+    return NULL;
+  }
+  char path[PROCESS_INFO_BUFFER_SIZE];
+  if (!_get_executable_path(path, sizeof(path))) {
+#if defined __APPLE__ || defined __FreeBSD__ || (defined __ANDROID__ && __ANDROID_API__ >= 21)
+    const char * appname = getprogname();
+#elif defined __GNUC__ && !defined(__QNXNTO__)
+    const char * appname = program_invocation_name;
+#else
+    const char * appname = executable_name;
+#endif
+    size_t length = strlen(appname);
+    if (length >= sizeof(path)) {
+      length = sizeof(path) - 1;
+    }
+    memcpy(path, appname, length);
+    path[length] = '\0';
+  }
+  char hostname[PROCESS_INFO_BUFFER_SIZE];
+  if (!_get_hostname(hostname, sizeof(hostname))) {
+    hostname[0] = '\0';
+  }
+
+  // The information and its strings are a single block
+  size_t name_size = strlen(executable_name) + 1;
+  size_t path_size = strlen(path) + 1;
+  size_t hostname_size = strlen(hostname) + 1;
+  char * block = allocator.allocate(
+    sizeof(rcutils_process_info_t) + name_size + path_size + hostname_size, allocator.state);
+  if (NULL == block) {
+    allocator.deallocate(executable_name, allocator.state);
+    return NULL;
+  }
+  rcutils_process_info_t * info = (rcutils_process_info_t *)block;
+  char * strings = block + sizeof(rcutils_process_info_t);
+  info->pid = rcutils_get_pid();
+  info->executable_name = memcpy(strings, executable_name, name_size);
+  info->executable_path = memcpy(strings + name_size, path, path_size);
+  info->hostname = memcpy(strings + name_size + path_size, hostname, hostname_size);
+  allocator.deallocate(executable_name, allocator.state);
+  return info;
+}
+
+const rcutils_process_info_t *
+rcutils_get_process_info(void)
+{
+  uintptr_t info = rcutils_atomic_load_uintptr_t(&g_rcutils_process_info);
+  if (0 != info) {
+    return (const rcutils_process_info_t *)info;
+  }
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  rcutils_process_info_t * new_info = _create_process_info(allocator);
+  if (NULL == new_info) {
+    return NULL;
+  }
+  // Threads calling this function concurrently all compute the information, one publishes it
+  uintptr_t expected = 0;
+  if (
+    !rcutils_atomic_compare_exchange_strong_uintptr_t(
+      &g_rcutils_process_info, &expected, (uintptr_t)new_info))
+  {
+    allocator.deallocate(new_info, allocator.state);
+    return (const rcutils_process_info_t *)expected;
+  }
+#if !defined _WIN32 && !defined __CYGWIN__
+  pthread_atfork(NULL, NULL, _update_process_info_pid);
+#endif
+  return new_info;
+}
+
 #ifdef __cplusplus
 }
 #endif
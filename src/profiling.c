@@ -0,0 +1,324 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "rcutils/allocator.h"
+#include "rcutils/error_handling.h"
+#include "rcutils/lock.h"
+#include "rcutils/macros.h"
+#include "rcutils/profiling.h"
+#include "rcutils/stdatomic_helper.h"
+#include "rcutils/strdup.h"
+#include "rcutils/time.h"
+
+// The number of sets of counters of each probe, shared by the threads beyond that number.
+#define PROFILING_SHARDS 16u
+
+// The counters of a probe updated by some threads.
+typedef struct profiling_shard_t
+{
+  atomic_uint_least64_t count;
+  atomic_uint_least64_t sum;
+  atomic_uint_least64_t min;
+  atomic_uint_least64_t max;
+  atomic_uint_least64_t histogram[RCUTILS_PROFILING_HISTOGRAM_BUCKETS];
+} profiling_shard_t;
+
+struct rcutils_profiling_probe_s
+{
+  // The next probe registered, the probes forming a list protected by the registry lock.
+  struct rcutils_profiling_probe_s * next;
+  char * name;
+  profiling_shard_t shards[PROFILING_SHARDS];
+};
+
+static rcutils_mutex_t g_rcutils_profiling_lock;
+static rcutils_profiling_probe_t * g_rcutils_profiling_probes = NULL;
+static rcutils_profiling_probe_t * g_rcutils_profiling_last_probe = NULL;
+static atomic_uint_least32_t g_rcutils_profiling_next_shard;
+// The index of the shard of the thread plus one, or 0 if it has none yet.
+static RCUTILS_THREAD_LOCAL uint32_t gtls_rcutils_profiling_shard = 0u;
+
+static void
+_reset_shard(profiling_shard_t * shard)
+{
+  rcutils_atomic_store(&shard->count, (uint64_t)0u);
+  rcutils_atomic_store(&shard->sum, (uint64_t)0u);
+  rcutils_atomic_store(&shard->min, UINT64_MAX);
+  rcutils_atomic_store(&shard->max, (uint64_t)0u);
+  for (size_t i = 0u; i < RCUTILS_PROFILING_HISTOGRAM_BUCKETS; ++i) {
+    rcutils_atomic_store(&shard->histogram[i], (uint64_t)0u);
+  }
+}
+
+// Reads a counter, resetting it to the given value if reset is true.
+static uint64_t
+_take_counter(atomic_uint_least64_t * counter, bool reset, uint64_t reset_value)
+{
+  uint64_t value;
+  if (reset) {
+    rcutils_atomic_exchange_explicit(counter, value, reset_value, memory_order_relaxed);
+  } else {
+    rcutils_atomic_load_explicit(counter, value, memory_order_relaxed);
+  }
+  return value;
+}
+
+rcutils_profiling_probe_t *
+rcutils_profiling_get_probe(const char * name)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(name, NULL);
+
+  rcutils_mutex_lock(&g_rcutils_profiling_lock);
+  rcutils_profiling_probe_t * probe = g_rcutils_profiling_probes;
+  while (NULL != probe && 0 != strcmp(probe->name, name)) {
+    probe = probe->next;
+  }
+  if (NULL == probe) {
+    rcutils_allocator_t allocator = rcutils_get_default_allocator();
+    probe = allocator.allocate(sizeof(rcutils_profiling_probe_t), allocator.state);
+    if (NULL == probe) {
+      rcutils_mutex_unlock(&g_rcutils_profiling_lock);
+      RCUTILS_SET_ERROR_MSG("failed to allocate memory for the profiling probe");
+      return NULL;
+    }
+    probe->name = rcutils_strdup(name, allocator);
+    if (NULL == probe->name) {
+      allocator.deallocate(probe, allocator.state);
+      rcutils_mutex_unlock(&g_rcutils_profiling_lock);
+      RCUTILS_SET_ERROR_MSG("failed to allocate memory for the name of the profiling probe");
+      return NULL;
+    }
+    probe->next = NULL;
+    for (size_t i = 0u; i < PROFILING_SHARDS; ++i) {
+      _reset_shard(&probe->shards[i]);
+    }
+    if (NULL == g_rcutils_profiling_last_probe) {
+      g_rcutils_profiling_probes = probe;
+    } else {
+      g_rcutils_profiling_last_probe->next = probe;
+    }
+    g_rcutils_profiling_last_probe = probe;
+  }
+  rcutils_mutex_unlock(&g_rcutils_profiling_lock);
+  return probe;
+}
+
+rcutils_profiling_probe_t *
+rcutils_profiling_get_cached_probe(const char * name, rcutils_profiling_probe_cache_t * cache)
+{
+  atomic_uintptr_t * cached_probe = (atomic_uintptr_t *)&cache->probe;
+  uintptr_t probe;
+  rcutils_atomic_load_explicit(cached_probe, probe, memory_order_acquire);
+  if (0u == probe) {
+    probe = (uintptr_t)rcutils_profiling_get_probe(name);
+    if (0u == probe) {
+      rcutils_reset_error();
+      return NULL;
+    }
+    // Threads racing to cache the probe all get the same one
+    rcutils_atomic_store_explicit(cached_probe, probe, memory_order_release);
+  }
+  return (rcutils_profiling_probe_t *)probe;
+}
+
+const char *
+rcutils_profiling_probe_get_name(const rcutils_profiling_probe_t * probe)
+{
+  return NULL == probe ? NULL : probe->name;
+}
+
+void
+rcutils_profiling_probe_record(rcutils_profiling_probe_t * probe, uint64_t duration)
+{
+  if (NULL == probe) {
+    return;
+  }
+  uint32_t shard_index = gtls_rcutils_profiling_shard;
+  if (0u == shard_index) {
+    uint32_t next_shard;
+    rcutils_atomic_fetch_add_explicit(
+      &g_rcutils_profiling_next_shard, next_shard, 1u, memory_order_relaxed);
+    shard_index = next_shard % PROFILING_SHARDS + 1u;
+    gtls_rcutils_profiling_shard = shard_index;
+  }
+  profiling_shard_t * shard = &probe->shards[shard_index - 1u];
+
+  uint64_t previous;
+  rcutils_atomic_fetch_add_explicit(&shard->count, previous, 1u, memory_order_relaxed);
+  rcutils_atomic_fetch_add_explicit(&shard->sum, previous, duration, memory_order_relaxed);
+  rcutils_atomic_fetch_add_explicit(
+    &shard->histogram[rcutils_profiling_histogram_bucket(duration)], previous, 1u,
+    memory_order_relaxed);
+  RCUTILS_UNUSED(previous);
+
+  bool exchanged = false;
+  rcutils_atomic_load_explicit(&shard->min, previous, memory_order_relaxed);
+  while (duration < previous && !exchanged) {
+    rcutils_atomic_compare_exchange_weak_explicit(
+      &shard->min, exchanged, &previous, duration, memory_order_relaxed, memory_order_relaxed);
+  }
+  exchanged = false;
+  rcutils_atomic_load_explicit(&shard->max, previous, memory_order_relaxed);
+  while (duration > previous && !exchanged) {
+    rcutils_atomic_compare_exchange_weak_explicit(
+      &shard->max, exchanged, &previous, duration, memory_order_relaxed, memory_order_relaxed);
+  }
+}
+
+rcutils_ret_t
+rcutils_profiling_probe_get_statistics(
+  rcutils_profiling_probe_t * probe, bool reset, rcutils_profiling_statistics_t * statistics)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(probe, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(statistics, RCUTILS_RET_INVALID_ARGUMENT);
+
+  memset(statistics, 0, sizeof(*statistics));
+  statistics->min = UINT64_MAX;
+  for (size_t i = 0u; i < PROFILING_SHARDS; ++i) {
+    profiling_shard_t * shard = &probe->shards[i];
+    statistics->count += _take_counter(&shard->count, reset, 0u);
+    statistics->sum += _take_counter(&shard->sum, reset, 0u);
+    uint64_t min = _take_counter(&shard->min, reset, UINT64_MAX);
+    uint64_t max = _take_counter(&shard->max, reset, 0u);
+    statistics->min = min < statistics->min ? min : statistics->min;
+    statistics->max = max > statistics->max ? max : statistics->max;
+    for (size_t bucket = 0u; bucket < RCUTILS_PROFILING_HISTOGRAM_BUCKETS; ++bucket) {
+      statistics->histogram[bucket] += _take_counter(&shard->histogram[bucket], reset, 0u);
+    }
+  }
+  if (UINT64_MAX == statistics->min) {
+    statistics->min = 0u;
+  }
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_profiling_snapshot(
+  rcutils_profiling_snapshot_callback_t callback, bool reset, void * context)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(callback, RCUTILS_RET_INVALID_ARGUMENT);
+
+  rcutils_profiling_statistics_t statistics;
+  rcutils_mutex_lock(&g_rcutils_profiling_lock);
+  for (rcutils_profiling_probe_t * probe = g_rcutils_profiling_probes; NULL != probe;
+    probe = probe->next)
+  {
+    rcutils_ret_t ret = rcutils_profiling_probe_get_statistics(probe, reset, &statistics);
+    RCUTILS_UNUSED(ret);
+    callback(probe->name, &statistics, context);
+  }
+  rcutils_mutex_unlock(&g_rcutils_profiling_lock);
+  return RCUTILS_RET_OK;
+}
+
+size_t
+rcutils_profiling_histogram_bucket(uint64_t duration)
+{
+  if (duration < RCUTILS_PROFILING_HISTOGRAM_SUB_BUCKETS) {
+    return (size_t)duration;
+  }
+  // The power of two of the duration, at least 2 as it's at least 4
+  size_t exponent = 63u;
+  while (0u == (duration >> exponent)) {
+    --exponent;
+  }
+  size_t sub_bucket = (size_t)(duration >> (exponent - 2u)) & 3u;
+  size_t bucket = (exponent - 1u) * RCUTILS_PROFILING_HISTOGRAM_SUB_BUCKETS + sub_bucket;
+  return bucket < RCUTILS_PROFILING_HISTOGRAM_BUCKETS ?
+         bucket : RCUTILS_PROFILING_HISTOGRAM_BUCKETS - 1u;
+}
+
+uint64_t
+rcutils_profiling_histogram_bucket_lower_bound(size_t bucket)
+{
+  if (bucket >= RCUTILS_PROFILING_HISTOGRAM_BUCKETS) {
+    return UINT64_MAX;
+  }
+  if (bucket < RCUTILS_PROFILING_HISTOGRAM_SUB_BUCKETS) {
+    return (uint64_t)bucket;
+  }
+  size_t exponent = bucket / RCUTILS_PROFILING_HISTOGRAM_SUB_BUCKETS + 1u;
+  uint64_t sub_bucket = bucket % RCUTILS_PROFILING_HISTOGRAM_SUB_BUCKETS;
+  return (RCUTILS_PROFILING_HISTOGRAM_SUB_BUCKETS + sub_bucket) << (exponent - 2u);
+}
+
+uint64_t
+rcutils_profiling_statistics_percentile(
+  const rcutils_profiling_statistics_t * statistics, double percentile)
+{
+  if (NULL == statistics || 0u == statistics->count || !(percentile >= 0.0) ||
+    percentile > 100.0)
+  {
+    return 0u;
+  }
+  // The rank of the duration at the percentile, from 1 to count
+  uint64_t rank = (uint64_t)(percentile / 100.0 * (double)statistics->count + 0.5);
+  rank = rank < 1u ? 1u : rank;
+  if (rank >= statistics->count) {
+    return statistics->max;
+  }
+  uint64_t estimate = statistics->max;
+  uint64_t seen = 0u;
+  for (size_t bucket = 0u; bucket < RCUTILS_PROFILING_HISTOGRAM_BUCKETS; ++bucket) {
+    seen += statistics->histogram[bucket];
+    if (seen >= rank) {
+      estimate = rcutils_profiling_histogram_bucket_lower_bound(bucket);
+      break;
+    }
+  }
+  if (estimate < statistics->min) {
+    return statistics->min;
+  }
+  return estimate > statistics->max ? statistics->max : estimate;
+}
+
+rcutils_profiling_scope_t
+rcutils_profiling_scope_begin(rcutils_profiling_probe_t * probe)
+{
+  rcutils_profiling_scope_t scope = {probe, 0};
+  if (NULL != probe && RCUTILS_RET_OK != rcutils_steady_time_now(&scope.start)) {
+    rcutils_reset_error();
+    scope.probe = NULL;
+  }
+  return scope;
+}
+
+void
+rcutils_profiling_scope_end(const rcutils_profiling_scope_t * scope)
+{
+  if (NULL == scope || NULL == scope->probe) {
+    return;
+  }
+  rcutils_time_point_value_t now;
+  if (RCUTILS_RET_OK != rcutils_steady_time_now(&now)) {
+    rcutils_reset_error();
+    return;
+  }
+  rcutils_profiling_probe_record(
+    scope->probe, now > scope->start ? (uint64_t)(now - scope->start) : 0u);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -17,10 +17,168 @@ extern "C"
 {
 #endif
 
-#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
 
 #include "rcutils/error_handling.h"
 #include "rcutils/qsort.h"
+#include "rcutils/thread_pool.h"
+#include "rcutils/types/string_array.h"
+
+// This is a pattern-defeating quicksort, after the one of Orson Peters:
+//
+//   https://github.com/orlp/pdqsort
+//
+// The elements are only ever swapped, never copied out, so that any size can be sorted
+// without memory to hold an element.
+
+// Ranges smaller than this are sorted with an insertion sort.
+#define _INSERTION_SORT_THRESHOLD 24u
+// Ranges larger than this use the pseudomedian of nine as pivot.
+#define _NINTHER_THRESHOLD 128u
+// The number of moves after which a partial insertion sort gives up.
+#define _PARTIAL_INSERTION_SORT_LIMIT 8u
+
+typedef struct _sort_context_t
+{
+  size_t size;
+  int (* comp)(const void *, const void *);
+} _sort_context_t;
+
+static inline bool
+_less_comp(const _sort_context_t * context, const uint8_t * a, const uint8_t * b)
+{
+  return context->comp(a, b) < 0;
+}
+
+static inline bool
+_less_string(const uint8_t * a, const uint8_t * b)
+{
+  const char * left;
+  const char * right;
+  memcpy(&left, a, sizeof(left));
+  memcpy(&right, b, sizeof(right));
+  // The empty entries are placed at the end, as by rcutils_string_array_sort_compare()
+  if (NULL == left || NULL == right) {
+    return NULL == right && NULL != left;
+  }
+  return strcmp(left, right) < 0;
+}
+
+static inline void
+_swap4(uint8_t * a, uint8_t * b)
+{
+  uint32_t x, y;
+  memcpy(&x, a, 4);
+  memcpy(&y, b, 4);
+  memcpy(a, &y, 4);
+  memcpy(b, &x, 4);
+}
+
+static inline void
+_swap8(uint8_t * a, uint8_t * b)
+{
+  uint64_t x, y;
+  memcpy(&x, a, 8);
+  memcpy(&y, b, 8);
+  memcpy(a, &y, 8);
+  memcpy(b, &x, 8);
+}
+
+static inline void
+_swap16(uint8_t * a, uint8_t * b)
+{
+  uint64_t x[2], y[2];
+  memcpy(x, a, 16);
+  memcpy(y, b, 16);
+  memcpy(a, y, 16);
+  memcpy(b, x, 16);
+}
+
+static inline void
+_swap_any(const _sort_context_t * context, uint8_t * a, uint8_t * b)
+{
+  size_t i = 0;
+  for (; i + 8 <= context->size; i += 8) {
+    _swap8(a + i, b + i);
+  }
+  for (; i < context->size; ++i) {
+    uint8_t x = a[i];
+    a[i] = b[i];
+    b[i] = x;
+  }
+}
+
+#define _QSORT_NAME(name) _ ## name ## _4
+#define _QSORT_SIZE(context) ((size_t)4)
+#define _QSORT_LESS(context, a, b) _less_comp(context, a, b)
+#define _QSORT_SWAP(context, a, b) _swap4(a, b)
+#include "./qsort_impl.inc"
+
+#define _QSORT_NAME(name) _ ## name ## _8
+#define _QSORT_SIZE(context) ((size_t)8)
+#define _QSORT_LESS(context, a, b) _less_comp(context, a, b)
+#define _QSORT_SWAP(context, a, b) _swap8(a, b)
+#include "./qsort_impl.inc"
+
+#define _QSORT_NAME(name) _ ## name ## _16
+#define _QSORT_SIZE(context) ((size_t)16)
+#define _QSORT_LESS(context, a, b) _less_comp(context, a, b)
+#define _QSORT_SWAP(context, a, b) _swap16(a, b)
+#include "./qsort_impl.inc"
+
+#define _QSORT_NAME(name) _ ## name ## _strings
+#define _QSORT_SIZE(context) sizeof(char *)
+#define _QSORT_LESS(context, a, b) _less_string(a, b)
+#define _QSORT_SWAP(context, a, b) _swap_any(context, a, b)
+#include "./qsort_impl.inc"
+
+#define _QSORT_NAME(name) _ ## name ## _any
+#define _QSORT_SIZE(context) ((context)->size)
+#define _QSORT_LESS(context, a, b) _less_comp(context, a, b)
+#define _QSORT_SWAP(context, a, b) _swap_any(context, a, b)
+#include "./qsort_impl.inc"
+
+typedef struct _sort_functions_t
+{
+  void (* sort)(const _sort_context_t *, uint8_t *, uint8_t *, int, bool);
+  uint8_t * (* partition_step)(
+    const _sort_context_t *, uint8_t *, uint8_t *, int *, bool, bool *);
+} _sort_functions_t;
+
+static _sort_functions_t
+_select_functions(const _sort_context_t * context)
+{
+  _sort_functions_t functions = {_pdq_sort_any, _partition_step_any};
+  if (
+    context->comp == rcutils_string_array_sort_compare && sizeof(char *) == context->size)
+  {
+    functions.sort = _pdq_sort_strings;
+    functions.partition_step = _partition_step_strings;
+  } else if (4 == context->size) {
+    functions.sort = _pdq_sort_4;
+    functions.partition_step = _partition_step_4;
+  } else if (8 == context->size) {
+    functions.sort = _pdq_sort_8;
+    functions.partition_step = _partition_step_8;
+  } else if (16 == context->size) {
+    functions.sort = _pdq_sort_16;
+    functions.partition_step = _partition_step_16;
+  }
+  return functions;
+}
+
+// Returns the number of bad pivots allowed before falling back to a heap sort.
+static int
+_bad_allowed(size_t count)
+{
+  int bad_allowed = 1;
+  for (size_t n = count; n > 1; n >>= 1) {
+    ++bad_allowed;
+  }
+  return bad_allowed;
+}
 
 rcutils_ret_t
 rcutils_qsort(void * ptr, size_t count, size_t size, int (* comp)(const void *, const void *))
@@ -34,12 +192,154 @@ rcutils_qsort(void * ptr, size_t count, size_t size, int (* comp)(const void *,
 
   RCUTILS_CHECK_FOR_NULL_WITH_MSG(
     ptr, "ptr is null", return RCUTILS_RET_INVALID_ARGUMENT);
+  if (0 == size) {
+    return RCUTILS_RET_OK;
+  }
+  if (count > SIZE_MAX / size) {
+    RCUTILS_SET_ERROR_MSG("array is too large");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
 
-  qsort(ptr, count, size, comp);
+  _sort_context_t context = {
+    .size = size,
+    .comp = comp,
+  };
+  uint8_t * begin = ptr;
+  _select_functions(&context).sort(&context, begin, begin + count * size, _bad_allowed(count), true);
 
   return RCUTILS_RET_OK;
 }
 
+typedef struct _parallel_sort_t
+{
+  _sort_context_t context;
+  _sort_functions_t functions;
+  size_t sequential_threshold;
+} _parallel_sort_t;
+
+// A range to sort, the item of the thread pool.
+typedef struct _parallel_range_t
+{
+  uint8_t * begin;
+  uint8_t * end;
+  int bad_allowed;
+  bool leftmost;
+} _parallel_range_t;
+
+// Partitions the range until it is small enough to be sorted by this thread, pushing the
+// ranges on the right of the pivots for the other threads to sort.
+static void
+_sort_range(rcutils_thread_pool_t * pool, void * context, void * item)
+{
+  const _parallel_sort_t * sort = context;
+  const size_t size = sort->context.size;
+  _parallel_range_t range;
+  memcpy(&range, item, sizeof(range));
+  while (
+    (size_t)(range.end - range.begin) / size > sort->sequential_threshold &&
+    range.bad_allowed > 1)
+  {
+    bool left_sorted = false;
+    uint8_t * pivot = sort->functions.partition_step(
+      &sort->context, range.begin, range.end, &range.bad_allowed, range.leftmost, &left_sorted);
+    if (left_sorted) {
+      range.begin = pivot + size;
+      range.leftmost = false;
+      continue;
+    }
+    _parallel_range_t right = {
+      .begin = pivot + size,
+      .end = range.end,
+      .bad_allowed = range.bad_allowed,
+      .leftmost = false,
+    };
+    range.end = pivot;
+    if (RCUTILS_RET_OK != rcutils_thread_pool_push(pool, &right)) {
+      sort->functions.sort(&sort->context, right.begin, right.end, right.bad_allowed, false);
+    }
+  }
+  sort->functions.sort(
+    &sort->context, range.begin, range.end, range.bad_allowed, range.leftmost);
+}
+
+rcutils_qsort_parallel_options_t
+rcutils_qsort_parallel_get_default_options(void)
+{
+  static rcutils_qsort_parallel_options_t default_options = {
+    .thread_count = 0u,
+    .sequential_threshold = RCUTILS_QSORT_PARALLEL_DEFAULT_SEQUENTIAL_THRESHOLD,
+  };
+  return default_options;
+}
+
+rcutils_ret_t
+rcutils_qsort_parallel(
+  void * ptr,
+  size_t count,
+  size_t size,
+  int (* comp)(const void *, const void *),
+  const rcutils_qsort_parallel_options_t * options,
+  rcutils_allocator_t allocator)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(options, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ALLOCATOR_WITH_MSG(
+    &allocator, "invalid allocator", return RCUTILS_RET_INVALID_ARGUMENT);
+  size_t thread_count = options->thread_count;
+  if (0u == thread_count) {
+    thread_count = rcutils_thread_pool_get_processor_count();
+  }
+  size_t sequential_threshold = options->sequential_threshold;
+  if (sequential_threshold < RCUTILS_QSORT_PARALLEL_MIN_SEQUENTIAL_THRESHOLD) {
+    sequential_threshold = RCUTILS_QSORT_PARALLEL_MIN_SEQUENTIAL_THRESHOLD;
+  }
+  if (thread_count < 2u || count <= sequential_threshold) {
+    return rcutils_qsort(ptr, count, size, comp);
+  }
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    comp, "comp is null", return RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    ptr, "ptr is null", return RCUTILS_RET_INVALID_ARGUMENT);
+  if (0 == size) {
+    return RCUTILS_RET_OK;
+  }
+  if (count > SIZE_MAX / size) {
+    RCUTILS_SET_ERROR_MSG("array is too large");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+
+  _parallel_sort_t sort = {
+    .context = {
+      .size = size,
+      .comp = comp,
+    },
+    .sequential_threshold = sequential_threshold,
+  };
+  sort.functions = _select_functions(&sort.context);
+  // A thread sorts the ranges which do not fit in its deque itself
+  rcutils_thread_pool_options_t pool_options = rcutils_thread_pool_get_default_options();
+  pool_options.thread_count = thread_count;
+  rcutils_thread_pool_t pool = rcutils_get_zero_initialized_thread_pool();
+  rcutils_ret_t ret = rcutils_thread_pool_init(
+    &pool, _sort_range, &sort, sizeof(_parallel_range_t), &pool_options, allocator);
+  if (RCUTILS_RET_OK != ret) {
+    return ret;
+  }
+  uint8_t * begin = ptr;
+  _parallel_range_t range = {
+    .begin = begin,
+    .end = begin + count * size,
+    .bad_allowed = _bad_allowed(count),
+    .leftmost = true,
+  };
+  ret = rcutils_thread_pool_push(&pool, &range);
+  if (RCUTILS_RET_OK == ret) {
+    ret = rcutils_thread_pool_wait(&pool);
+  }
+  rcutils_ret_t fini_ret = rcutils_thread_pool_fini(&pool);
+  RCUTILS_UNUSED(fini_ret);
+  return ret;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -38,6 +38,8 @@ extern "C"
 #include <stdint.h>
 #endif
 
+#include "rcutils/error_handling.h"
+#include "rcutils/find.h"
 #include "rcutils/repl_str.h"
 
 // *INDENT-OFF* (prevent uncrustify from messing with the original style)
@@ -144,6 +146,85 @@ end_repl_str:
 
 // *INDENT-ON*
 
+// Returns the length of prefix if str starts with it, or 0 otherwise.
+static size_t
+_match_length(const char * str, const char * prefix)
+{
+  size_t i = 0;
+  while ('\0' != prefix[i]) {
+    if (str[i] != prefix[i]) {
+      return 0u;
+    }
+    ++i;
+  }
+  return i;
+}
+
+rcutils_ret_t
+rcutils_repl_str_multi(
+  const char * str,
+  const rcutils_repl_str_pair_t * pairs,
+  size_t pair_count,
+  rcutils_char_array_t * output)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(str, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(output, RCUTILS_RET_INVALID_ARGUMENT);
+  if (0u != pair_count) {
+    RCUTILS_CHECK_ARGUMENT_FOR_NULL(pairs, RCUTILS_RET_INVALID_ARGUMENT);
+  }
+  rcutils_char_set_t first_chars = {{0u, 0u, 0u, 0u}};
+  for (size_t i = 0; i < pair_count; ++i) {
+    if (NULL == pairs[i].from || NULL == pairs[i].to || '\0' == pairs[i].from[0]) {
+      RCUTILS_SET_ERROR_MSG("pairs must have a non-empty from string and a to string");
+      return RCUTILS_RET_INVALID_ARGUMENT;
+    }
+    unsigned char c = (unsigned char)pairs[i].from[0];
+    first_chars.bits[c >> 6] |= (uint64_t)1u << (c & 63u);
+  }
+
+  // Reserve for the result without replacements, which is exact when the lengths are equal
+  size_t length = strlen(str);
+  size_t output_length = 0u == output->buffer_length ? 0u : output->buffer_length - 1u;
+  if (length >= SIZE_MAX - output_length) {
+    RCUTILS_SET_ERROR_MSG("char array would overflow");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  rcutils_ret_t ret = rcutils_char_array_expand_as_needed(output, output_length + length + 1u);
+  if (RCUTILS_RET_OK != ret) {
+    return ret;
+  }
+
+  size_t literal_start = 0u;
+  size_t i = 0u;
+  while (i < length) {
+    size_t candidate = rcutils_find_anyn(str + i, &first_chars, length - i);
+    if (SIZE_MAX == candidate) {
+      break;
+    }
+    i += candidate;
+    size_t match_length = 0u;
+    const char * to = NULL;
+    for (size_t p = 0; p < pair_count && 0u == match_length; ++p) {
+      match_length = _match_length(str + i, pairs[p].from);
+      to = pairs[p].to;
+    }
+    if (0u == match_length) {
+      ++i;
+      continue;
+    }
+    ret = rcutils_char_array_append_n(output, str + literal_start, i - literal_start);
+    if (RCUTILS_RET_OK == ret) {
+      ret = rcutils_char_array_append_n(output, to, strlen(to));
+    }
+    if (RCUTILS_RET_OK != ret) {
+      return ret;
+    }
+    i += match_length;
+    literal_start = i;
+  }
+  return rcutils_char_array_append_n(output, str + literal_start, length - literal_start);
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,285 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "rcutils/error_handling.h"
+#include "rcutils/lock.h"
+#include "rcutils/process.h"
+#include "rcutils/shared_counters.h"
+#include "rcutils/stdatomic_helper.h"
+#include "rcutils/strdup.h"
+
+#include "./logging_internal.h"
+#include "./shared_file.h"
+
+static_assert(
+  sizeof(rcutils_shared_counters_header_t) == 64u,
+  "the layout of the shared counters must not change within a version");
+static_assert(
+  sizeof(rcutils_shared_counters_entry_t) == 64u,
+  "the layout of the shared counters must not change within a version");
+
+// The atomic types have the sizes and alignments of the fields of the shared counters.
+#define SHARED_COUNTERS_ATOMIC_32(field) ((atomic_uint_least32_t *)(field))
+#define SHARED_COUNTERS_ATOMIC_64(field) ((atomic_uint_least64_t *)(field))
+
+typedef struct rcutils_shared_counters_impl_t
+{
+  rcutils_shared_counters_header_t * header;
+  rcutils_shared_counters_entry_t * entries;
+  size_t size;
+  char * path;
+  // Serializes the additions of counters
+  rcutils_mutex_t mutex;
+  // The counters of the logging statistics, if they are exported
+  rcutils_logging_statistics_shared_t logging_statistics;
+  rcutils_allocator_t allocator;
+} rcutils_shared_counters_impl_t;
+
+rcutils_shared_counters_t
+rcutils_get_zero_initialized_shared_counters(void)
+{
+  static rcutils_shared_counters_t zero_initialized_shared_counters = {
+    .impl = NULL,
+  };
+  return zero_initialized_shared_counters;
+}
+
+rcutils_ret_t
+rcutils_shared_counters_init(
+  rcutils_shared_counters_t * counters,
+  const char * path,
+  size_t capacity,
+  const rcutils_allocator_t * allocator)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(counters, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(path, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ALLOCATOR(allocator, return RCUTILS_RET_INVALID_ARGUMENT);
+  if (NULL != counters->impl) {
+    RCUTILS_SET_ERROR_MSG("counters argument is not zero-initialized");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  if (0u == capacity || capacity > UINT32_MAX) {
+    RCUTILS_SET_ERROR_MSG("capacity must be more than 0 and fit in 32 bits");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+
+  rcutils_shared_counters_impl_t * impl = allocator->zero_allocate(
+    1u, sizeof(rcutils_shared_counters_impl_t), allocator->state);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    impl, "failed to allocate memory for shared counters", return RCUTILS_RET_BAD_ALLOC);
+  impl->path = rcutils_strdup(path, *allocator);
+  if (NULL == impl->path) {
+    RCUTILS_SET_ERROR_MSG("failed to allocate memory for shared counters");
+    allocator->deallocate(impl, allocator->state);
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+
+  impl->size =
+    sizeof(rcutils_shared_counters_header_t) + capacity * sizeof(rcutils_shared_counters_entry_t);
+  void * data = NULL;
+  rcutils_ret_t ret = rcutils_shared_file_map(path, impl->size, &data);
+  if (RCUTILS_RET_OK != ret) {
+    allocator->deallocate(impl->path, allocator->state);
+    allocator->deallocate(impl, allocator->state);
+    return ret;
+  }
+
+  impl->header = (rcutils_shared_counters_header_t *)data;
+  impl->entries = (rcutils_shared_counters_entry_t *)(impl->header + 1);
+  impl->header->version = RCUTILS_SHARED_COUNTERS_VERSION;
+  impl->header->entry_size = (uint32_t)sizeof(rcutils_shared_counters_entry_t);
+  impl->header->capacity = (uint32_t)capacity;
+  impl->header->pid = (uint64_t)rcutils_get_pid();
+  memcpy(impl->header->magic, RCUTILS_SHARED_COUNTERS_MAGIC, sizeof(impl->header->magic));
+  // Publishes the header to the monitors mapping the file from now on
+  rcutils_atomic_store_explicit(
+    SHARED_COUNTERS_ATOMIC_32(&impl->header->count), (uint32_t)0u, memory_order_release);
+  impl->allocator = *allocator;
+  counters->impl = impl;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_shared_counters_fini(rcutils_shared_counters_t * counters)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(counters, RCUTILS_RET_INVALID_ARGUMENT);
+  rcutils_shared_counters_impl_t * impl = counters->impl;
+  if (NULL == impl) {
+    return RCUTILS_RET_OK;
+  }
+
+  rcutils_logging_statistics_unset_shared(&impl->logging_statistics);
+  rcutils_ret_t ret = rcutils_shared_file_unmap(impl->path, impl->header, impl->size);
+  rcutils_allocator_t allocator = impl->allocator;
+  allocator.deallocate(impl->path, allocator.state);
+  allocator.deallocate(impl, allocator.state);
+  counters->impl = NULL;
+  return ret;
+}
+
+// Find the entry with the given name, or add it, with the mutex held
+static rcutils_ret_t
+get_entry(
+  rcutils_shared_counters_impl_t * impl,
+  const char * name,
+  rcutils_shared_counter_kind_t kind,
+  uint64_t ** value)
+{
+  uint32_t count = impl->header->count;
+  for (uint32_t i = 0u; i < count; ++i) {
+    rcutils_shared_counters_entry_t * entry = &impl->entries[i];
+    if (0 == strcmp(entry->name, name)) {
+      if (entry->kind != (uint32_t)kind) {
+        RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+          "shared counter '%s' was added with another kind", name);
+        return RCUTILS_RET_INVALID_ARGUMENT;
+      }
+      *value = &entry->value;
+      return RCUTILS_RET_OK;
+    }
+  }
+  if (count == impl->header->capacity) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "no room for shared counter '%s', all %u are in use", name, (unsigned int)count);
+    return RCUTILS_RET_NOT_ENOUGH_SPACE;
+  }
+
+  rcutils_shared_counters_entry_t * entry = &impl->entries[count];
+  entry->kind = (uint32_t)kind;
+  strcpy(entry->name, name);  // NOLINT(runtime/printf), the length is checked by the caller
+  // Publishes the entry to the monitors
+  rcutils_atomic_store_explicit(
+    SHARED_COUNTERS_ATOMIC_32(&impl->header->count), count + 1u, memory_order_release);
+  *value = &entry->value;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_shared_counters_get(
+  rcutils_shared_counters_t * counters,
+  const char * name,
+  rcutils_shared_counter_kind_t kind,
+  uint64_t ** value)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(counters, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    counters->impl, "counters is not initialized", return RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(name, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(value, RCUTILS_RET_INVALID_ARGUMENT);
+  size_t length = strlen(name);
+  if (0u == length || length >= RCUTILS_SHARED_COUNTERS_NAME_SIZE) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "the name of a shared counter must have 1 to %u characters",
+      RCUTILS_SHARED_COUNTERS_NAME_SIZE - 1u);
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  if (RCUTILS_SHARED_COUNTER_KIND_COUNTER != kind && RCUTILS_SHARED_COUNTER_KIND_GAUGE != kind) {
+    RCUTILS_SET_ERROR_MSG("invalid kind of shared counter");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+
+  rcutils_mutex_lock(&counters->impl->mutex);
+  rcutils_ret_t ret = get_entry(counters->impl, name, kind, value);
+  rcutils_mutex_unlock(&counters->impl->mutex);
+  return ret;
+}
+
+void
+rcutils_shared_counter_add(uint64_t * value, uint64_t delta)
+{
+  if (NULL != value) {
+    uint64_t previous;
+    rcutils_atomic_fetch_add_explicit(
+      SHARED_COUNTERS_ATOMIC_64(value), previous, delta, memory_order_relaxed);
+    RCUTILS_UNUSED(previous);
+  }
+}
+
+void
+rcutils_shared_counter_set(uint64_t * value, uint64_t new_value)
+{
+  if (NULL != value) {
+    rcutils_atomic_store_explicit(
+      SHARED_COUNTERS_ATOMIC_64(value), new_value, memory_order_relaxed);
+  }
+}
+
+rcutils_ret_t
+rcutils_shared_counters_export_logging_statistics(rcutils_shared_counters_t * counters)
+{
+  static const char * const counter_names[RCUTILS_LOGGING_STATISTICS_COUNTERS] = {
+    "emitted", "filtered", "dropped",
+  };
+  static const char * const severity_names[RCUTILS_LOGGING_STATISTICS_SEVERITIES] = {
+    "debug", "info", "warn", "error", "fatal",
+  };
+
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(counters, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    counters->impl, "counters is not initialized", return RCUTILS_RET_INVALID_ARGUMENT);
+  rcutils_logging_statistics_shared_t * shared = &counters->impl->logging_statistics;
+
+  rcutils_ret_t ret = RCUTILS_RET_OK;
+  char name[RCUTILS_SHARED_COUNTERS_NAME_SIZE];
+  for (size_t counter = 0u; counter < RCUTILS_LOGGING_STATISTICS_COUNTERS; ++counter) {
+    for (size_t i = 0u; i < RCUTILS_LOGGING_STATISTICS_SEVERITIES && RCUTILS_RET_OK == ret; ++i) {
+      snprintf(
+        name, sizeof(name), "rcutils.logging.%s.%s", counter_names[counter], severity_names[i]);
+      ret = rcutils_shared_counters_get(
+        counters, name, RCUTILS_SHARED_COUNTER_KIND_COUNTER, &shared->counters[counter][i]);
+    }
+  }
+  if (RCUTILS_RET_OK == ret) {
+    ret = rcutils_shared_counters_get(
+      counters, "rcutils.logging.throttled", RCUTILS_SHARED_COUNTER_KIND_COUNTER,
+      &shared->throttled);
+  }
+  if (RCUTILS_RET_OK == ret) {
+    ret = rcutils_shared_counters_get(
+      counters, "rcutils.logging.bytes_written", RCUTILS_SHARED_COUNTER_KIND_COUNTER,
+      &shared->bytes_written);
+  }
+  if (RCUTILS_RET_OK == ret) {
+    ret = rcutils_shared_counters_get(
+      counters, "rcutils.logging.format_time", RCUTILS_SHARED_COUNTER_KIND_COUNTER,
+      &shared->format_time);
+  }
+  if (RCUTILS_RET_OK == ret) {
+    ret = rcutils_shared_counters_get(
+      counters, "rcutils.logging.output_time", RCUTILS_SHARED_COUNTER_KIND_COUNTER,
+      &shared->output_time);
+  }
+  if (RCUTILS_RET_OK != ret) {
+    return ret;
+  }
+
+  rcutils_logging_statistics_set_shared(shared);
+  return RCUTILS_RET_OK;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,131 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef _WIN32
+// See the comment in logging.c about warning C5105.
+# pragma warning(push)
+# pragma warning(disable : 5105)
+# include <windows.h>
+# pragma warning(pop)
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+#include "rcutils/error_handling.h"
+#include "rcutils/macros.h"
+
+#include "./shared_file.h"
+
+#if !defined(_WIN32) && !defined(O_CLOEXEC)
+# define O_CLOEXEC 0
+#endif
+
+rcutils_ret_t
+rcutils_shared_file_map(const char * path, size_t size, void ** data)
+{
+#ifdef _WIN32
+  HANDLE handle = CreateFileA(
+    path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+    NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (INVALID_HANDLE_VALUE == handle) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "Failed to create '%s'. Error code: %lu", path, GetLastError());
+    return RCUTILS_RET_ERROR;
+  }
+  // The file is extended to the size of the mapping, with zeros
+  HANDLE mapping = CreateFileMappingA(
+    handle, NULL, PAGE_READWRITE, (DWORD)((uint64_t)size >> 32), (DWORD)size, NULL);
+  // The view keeps the mapping and the file open
+  CloseHandle(handle);
+  if (NULL == mapping) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "Failed to map '%s'. Error code: %lu", path, GetLastError());
+    return RCUTILS_RET_ERROR;
+  }
+  *data = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, 0);
+  CloseHandle(mapping);
+  if (NULL == *data) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "Failed to map '%s'. Error code: %lu", path, GetLastError());
+    return RCUTILS_RET_ERROR;
+  }
+  return RCUTILS_RET_OK;
+#else
+  int fd = open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (-1 == fd) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("Failed to create '%s'. Error code: %d", path, errno);
+    return RCUTILS_RET_ERROR;
+  }
+  // The file is truncated, so it's extended with zeros
+  if (0 != ftruncate(fd, (off_t)size)) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "Failed to set the size of '%s'. Error code: %d", path, errno);
+    close(fd);
+    unlink(path);
+    return RCUTILS_RET_ERROR;
+  }
+  *data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  // The mapping keeps the file open
+  close(fd);
+  if (MAP_FAILED == *data) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("Failed to map '%s'. Error code: %d", path, errno);
+    unlink(path);
+    return RCUTILS_RET_ERROR;
+  }
+  return RCUTILS_RET_OK;
+#endif
+}
+
+rcutils_ret_t
+rcutils_shared_file_unmap(const char * path, void * data, size_t size)
+{
+  rcutils_ret_t ret = RCUTILS_RET_OK;
+#ifdef _WIN32
+  RCUTILS_UNUSED(size);
+  if (!UnmapViewOfFile(data)) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "Failed to unmap '%s'. Error code: %lu", path, GetLastError());
+    ret = RCUTILS_RET_ERROR;
+  } else if (!DeleteFileA(path)) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "Failed to remove '%s'. Error code: %lu", path, GetLastError());
+    ret = RCUTILS_RET_ERROR;
+  }
+#else
+  if (0 != munmap(data, size)) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("Failed to unmap '%s'. Error code: %d", path, errno);
+    ret = RCUTILS_RET_ERROR;
+  } else if (0 != unlink(path)) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("Failed to remove '%s'. Error code: %d", path, errno);
+    ret = RCUTILS_RET_ERROR;
+  }
+#endif
+  return ret;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,40 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SHARED_FILE_H_
+#define SHARED_FILE_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+
+#include "rcutils/types/rcutils_ret.h"
+
+// Create the file, or truncate it if it exists, extend it with zeros to the given size and map
+// it read-write and shared, so that other processes mapping it see the writes, and the writes
+// outlive the process if it crashes.
+// The file is removed if it can't be mapped.
+rcutils_ret_t rcutils_shared_file_map(const char * path, size_t size, void ** data);
+
+// Unmap the file mapped by rcutils_shared_file_map() and remove it.
+rcutils_ret_t rcutils_shared_file_unmap(const char * path, void * data, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // SHARED_FILE_H_
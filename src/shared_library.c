@@ -16,6 +16,7 @@
 extern "C"
 {
 #endif
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -28,6 +29,7 @@ extern "C"
 #include <sys/link.h>
 #endif
 #include <dlfcn.h>
+#include <sched.h>
 #else
 // When building with MSVC 19.28.29333.0 on Windows 10 (as of 2020-11-11),
 // there appears to be a problem with winbase.h (which is included by
@@ -51,7 +53,360 @@ C_ASSERT(sizeof(char) == sizeof(TCHAR));
 #include "rcutils/error_handling.h"
 #include "rcutils/macros.h"
 #include "rcutils/shared_library.h"
+#include "rcutils/stdatomic_helper.h"
 #include "rcutils/strdup.h"
+#include "rcutils/thread_pool.h"
+#include "rcutils/types/hash_map.h"
+
+#include "./tracepoints.h"
+
+
+typedef struct rcutils_shared_library_symbol_t
+{
+  // The copy of the name of the symbol, NULL marking an empty slot.
+  char * name;
+  size_t hash;
+  void * symbol;
+} rcutils_shared_library_symbol_t;
+
+typedef struct rcutils_shared_library_symbol_cache_t
+{
+  atomic_bool lock;
+  // Linear probing table of the symbols found, only accessed with the lock held.
+  rcutils_shared_library_symbol_t * slots;
+  // The size of the table minus one, the size being a power of two.
+  size_t slots_mask;
+  size_t count;
+} rcutils_shared_library_symbol_cache_t;
+
+static rcutils_shared_library_symbol_cache_t *
+symbol_cache_create(const rcutils_allocator_t * allocator)
+{
+  rcutils_shared_library_symbol_cache_t * cache = allocator->zero_allocate(
+    1, sizeof(rcutils_shared_library_symbol_cache_t), allocator->state);
+  if (NULL != cache) {
+    rcutils_atomic_store(&cache->lock, false);
+  }
+  return cache;
+}
+
+static void
+symbol_cache_destroy(
+  rcutils_shared_library_symbol_cache_t * cache, const rcutils_allocator_t * allocator)
+{
+  if (NULL == cache) {
+    return;
+  }
+  if (NULL != cache->slots) {
+    for (size_t i = 0; i <= cache->slots_mask; ++i) {
+      allocator->deallocate(cache->slots[i].name, allocator->state);
+    }
+    allocator->deallocate(cache->slots, allocator->state);
+  }
+  allocator->deallocate(cache, allocator->state);
+}
+
+static void
+spin_lock(atomic_bool * lock)
+{
+  while (rcutils_atomic_exchange_bool(lock, true)) {
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+  }
+}
+
+static void
+spin_unlock(atomic_bool * lock)
+{
+  rcutils_atomic_store(lock, false);
+}
+
+// Finds the slot holding the symbol, or the empty slot where it belongs, with the lock held.
+static rcutils_shared_library_symbol_t *
+symbol_cache_find_slot(
+  const rcutils_shared_library_symbol_cache_t * cache, const char * name, size_t hash)
+{
+  size_t slot = hash & cache->slots_mask;
+  while (NULL != cache->slots[slot].name &&
+    (cache->slots[slot].hash != hash || 0 != strcmp(cache->slots[slot].name, name)))
+  {
+    slot = (slot + 1) & cache->slots_mask;
+  }
+  return &cache->slots[slot];
+}
+
+// Returns the cached symbol, or NULL if it isn't cached, with the lock held.
+static void *
+symbol_cache_find(
+  const rcutils_shared_library_symbol_cache_t * cache, const char * name, size_t hash)
+{
+  if (NULL == cache->slots) {
+    return NULL;
+  }
+  return symbol_cache_find_slot(cache, name, hash)->symbol;
+}
+
+// Caches the symbol with the lock held, doubling the table as it becomes half full.
+// The symbol isn't cached if allocating memory fails, as it can be looked up again.
+static void
+symbol_cache_insert(
+  rcutils_shared_library_symbol_cache_t * cache,
+  const rcutils_allocator_t * allocator,
+  const char * name,
+  size_t hash,
+  void * symbol)
+{
+  if (NULL != symbol_cache_find(cache, name, hash)) {
+    return;
+  }
+  if (NULL == cache->slots || 2 * (cache->count + 1) > cache->slots_mask + 1) {
+    size_t slots_count = NULL == cache->slots ? 16 : 2 * (cache->slots_mask + 1);
+    rcutils_shared_library_symbol_t * slots = allocator->zero_allocate(
+      slots_count, sizeof(rcutils_shared_library_symbol_t), allocator->state);
+    if (NULL == slots) {
+      return;
+    }
+    rcutils_shared_library_symbol_t * old_slots = cache->slots;
+    size_t old_slots_count = NULL == old_slots ? 0 : cache->slots_mask + 1;
+    cache->slots = slots;
+    cache->slots_mask = slots_count - 1;
+    for (size_t i = 0; i < old_slots_count; ++i) {
+      if (NULL != old_slots[i].name) {
+        *symbol_cache_find_slot(cache, old_slots[i].name, old_slots[i].hash) = old_slots[i];
+      }
+    }
+    allocator->deallocate(old_slots, allocator->state);
+  }
+  char * name_copy = rcutils_strdup(name, *allocator);
+  if (NULL == name_copy) {
+    return;
+  }
+  rcutils_shared_library_symbol_t * slot = symbol_cache_find_slot(cache, name, hash);
+  slot->name = name_copy;
+  slot->hash = hash;
+  slot->symbol = symbol;
+  ++cache->count;
+}
+
+static size_t
+symbol_hash(const char * symbol_name)
+{
+  return rcutils_hash_map_bytes_hash(symbol_name, strlen(symbol_name));
+}
+
+// Looks the symbol up in the library, returning NULL without setting an error if it's missing.
+static void *
+lookup_symbol(const rcutils_shared_library_t * lib, const char * symbol_name)
+{
+#ifndef _WIN32
+  // the correct way to test for an error is to call dlerror() to clear any old error conditions,
+  // then call dlsym(), and then call dlerror() again, saving its return value into a variable,
+  // and check whether this saved value is not NULL.
+  dlerror(); /* Clear any existing error */
+  void * lib_symbol = dlsym(lib->lib_pointer, symbol_name);
+  if (dlerror() != NULL) {
+    return NULL;
+  }
+  return lib_symbol;
+#else
+  return GetProcAddress((HINSTANCE)(lib->lib_pointer), symbol_name);
+#endif  // _WIN32
+}
+
+static void *
+cached_lookup_symbol(const rcutils_shared_library_t * lib, const char * symbol_name)
+{
+  rcutils_shared_library_symbol_cache_t * cache = lib->symbol_cache;
+  if (NULL == cache) {
+    return lookup_symbol(lib, symbol_name);
+  }
+  size_t hash = symbol_hash(symbol_name);
+  spin_lock(&cache->lock);
+  void * lib_symbol = symbol_cache_find(cache, symbol_name, hash);
+  spin_unlock(&cache->lock);
+  if (NULL == lib_symbol) {
+    lib_symbol = lookup_symbol(lib, symbol_name);
+    if (NULL != lib_symbol) {
+      spin_lock(&cache->lock);
+      symbol_cache_insert(cache, &lib->allocator, symbol_name, hash, lib_symbol);
+      spin_unlock(&cache->lock);
+    }
+  }
+  return lib_symbol;
+}
+
+// A library loaded through rcutils_load_shared_library_with_options() and not unloaded yet.
+typedef struct shared_library_registry_entry_t
+{
+  // The resolved path of the library, which is also the key of the entry.
+  char * path;
+  void * handle;
+  // The number of handles to the library.
+  size_t references;
+} shared_library_registry_entry_t;
+
+static atomic_bool g_rcutils_shared_library_registry_lock = ATOMIC_VAR_INIT(false);
+// The entries of the loaded libraries by resolved path, only accessed with the lock held.
+static rcutils_hash_map_t g_rcutils_shared_library_registry;
+// The resolved paths by the paths they were loaded with, only accessed with the lock held.
+// They are kept once the libraries are unloaded, as the paths resolve the same way again.
+static rcutils_hash_map_t g_rcutils_shared_library_resolved_paths;
+
+static rcutils_ret_t
+registry_init(void)
+{
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  rcutils_hash_map_options_t options = rcutils_hash_map_get_default_options();
+  options.backend = RCUTILS_HASH_MAP_BACKEND_OPEN_ADDRESSING;
+  if (NULL == g_rcutils_shared_library_registry.impl) {
+    rcutils_ret_t ret = rcutils_hash_map_init_with_options(
+      &g_rcutils_shared_library_registry, 16, sizeof(char *),
+      sizeof(shared_library_registry_entry_t *), rcutils_hash_map_string_hash_func,
+      rcutils_hash_map_string_cmp_func, &options, &allocator);
+    if (RCUTILS_RET_OK != ret) {
+      return ret;
+    }
+  }
+  if (NULL == g_rcutils_shared_library_resolved_paths.impl) {
+    return rcutils_hash_map_init_with_options(
+      &g_rcutils_shared_library_resolved_paths, 16, sizeof(char *), sizeof(char *),
+      rcutils_hash_map_string_hash_func, rcutils_hash_map_string_cmp_func, &options,
+      &allocator);
+  }
+  return RCUTILS_RET_OK;
+}
+
+// Returns the entry of the loaded library with the given resolved path, with the lock held.
+static shared_library_registry_entry_t *
+registry_get_entry(const char * path)
+{
+  shared_library_registry_entry_t * entry = NULL;
+  if (NULL != g_rcutils_shared_library_registry.impl) {
+    (void)rcutils_hash_map_get(&g_rcutils_shared_library_registry, &path, &entry);
+  }
+  return entry;
+}
+
+// Returns the resolved path of a library loaded with the given path, with the lock held.
+static const char *
+registry_get_resolved_path(const char * library_path)
+{
+  const char * resolved_path = NULL;
+  if (NULL != g_rcutils_shared_library_resolved_paths.impl) {
+    (void)rcutils_hash_map_get(
+      &g_rcutils_shared_library_resolved_paths, &library_path, &resolved_path);
+  }
+  return resolved_path;
+}
+
+// Returns a copy of the resolved path of the library loaded from library_path with handle,
+// or NULL if it's not known.
+static char *
+registry_copy_resolved_path(
+  const char * library_path, void * handle, const rcutils_allocator_t * allocator)
+{
+  char * path = NULL;
+  spin_lock(&g_rcutils_shared_library_registry_lock);
+  const char * resolved_path = registry_get_resolved_path(library_path);
+  shared_library_registry_entry_t * entry =
+    NULL != resolved_path ? registry_get_entry(resolved_path) : NULL;
+  // The path could resolve to a different library since, unless it's the one still loaded
+  if (NULL != entry && entry->handle == handle) {
+    path = rcutils_strdup(entry->path, *allocator);
+  }
+  spin_unlock(&g_rcutils_shared_library_registry_lock);
+  return path;
+}
+
+// Remembers how the path resolved with the lock held, which is only an optimization so
+// failing is ignored.
+static void
+registry_set_resolved_path(
+  const char * library_path, const char * resolved_path, const rcutils_allocator_t * allocator)
+{
+  const char * known_path = registry_get_resolved_path(library_path);
+  if (NULL != known_path && 0 == strcmp(known_path, resolved_path)) {
+    return;
+  }
+  char * path = rcutils_strdup(resolved_path, *allocator);
+  if (NULL == path) {
+    return;
+  }
+  if (NULL != known_path) {
+    // Only the value of an existing key is replaced
+    if (RCUTILS_RET_OK == rcutils_hash_map_set(
+        &g_rcutils_shared_library_resolved_paths, &library_path, &path))
+    {
+      allocator->deallocate((char *)known_path, allocator->state);
+    } else {
+      allocator->deallocate(path, allocator->state);
+    }
+    return;
+  }
+  char * key = rcutils_strdup(library_path, *allocator);
+  if (NULL == key || RCUTILS_RET_OK != rcutils_hash_map_set(
+      &g_rcutils_shared_library_resolved_paths, &key, &path))
+  {
+    allocator->deallocate(key, allocator->state);
+    allocator->deallocate(path, allocator->state);
+  }
+}
+
+// Adds a reference to the library loaded from library_path with handle.
+static rcutils_ret_t
+registry_add(const char * library_path, const char * resolved_path, void * handle)
+{
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  spin_lock(&g_rcutils_shared_library_registry_lock);
+  rcutils_ret_t ret = registry_init();
+  shared_library_registry_entry_t * entry =
+    RCUTILS_RET_OK == ret ? registry_get_entry(resolved_path) : NULL;
+  if (NULL != entry) {
+    entry->handle = handle;
+    ++entry->references;
+  } else if (RCUTILS_RET_OK == ret) {
+    entry = allocator.allocate(sizeof(shared_library_registry_entry_t), allocator.state);
+    char * path = rcutils_strdup(resolved_path, allocator);
+    ret = RCUTILS_RET_BAD_ALLOC;
+    if (NULL != entry && NULL != path) {
+      entry->path = path;
+      entry->handle = handle;
+      entry->references = 1;
+      ret = rcutils_hash_map_set(&g_rcutils_shared_library_registry, &entry->path, &entry);
+    }
+    if (RCUTILS_RET_OK != ret) {
+      allocator.deallocate(path, allocator.state);
+      allocator.deallocate(entry, allocator.state);
+    }
+  }
+  if (RCUTILS_RET_OK == ret) {
+    registry_set_resolved_path(library_path, resolved_path, &allocator);
+  }
+  spin_unlock(&g_rcutils_shared_library_registry_lock);
+  if (RCUTILS_RET_OK != ret && !rcutils_error_is_set()) {
+    RCUTILS_SET_ERROR_MSG("unable to register the library");
+  }
+  return ret;
+}
+
+// Removes a reference to the library with the given resolved path.
+static void
+registry_remove(const char * resolved_path)
+{
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  spin_lock(&g_rcutils_shared_library_registry_lock);
+  shared_library_registry_entry_t * entry = registry_get_entry(resolved_path);
+  if (NULL != entry && 0 == --entry->references &&
+    RCUTILS_RET_OK == rcutils_hash_map_unset(&g_rcutils_shared_library_registry, &entry->path))
+  {
+    allocator.deallocate(entry->path, allocator.state);
+    allocator.deallocate(entry, allocator.state);
+  }
+  spin_unlock(&g_rcutils_shared_library_registry_lock);
+}
 
 rcutils_shared_library_t
 rcutils_get_zero_initialized_shared_library(void)
@@ -60,19 +415,36 @@ rcutils_get_zero_initialized_shared_library(void)
   zero_initialized_shared_library.library_path = NULL;
   zero_initialized_shared_library.lib_pointer = NULL;
   zero_initialized_shared_library.allocator = rcutils_get_zero_initialized_allocator();
+  zero_initialized_shared_library.symbol_cache = NULL;
   return zero_initialized_shared_library;
 }
 
+rcutils_shared_library_load_options_t
+rcutils_shared_library_get_default_load_options(void)
+{
+  rcutils_shared_library_load_options_t options;
+  options.resolve_now = false;
+  options.global = false;
+  options.no_delete = false;
+  return options;
+}
+
 rcutils_ret_t
 rcutils_load_shared_library(
   rcutils_shared_library_t * lib,
   const char * library_path,
   rcutils_allocator_t allocator)
 {
-  RCUTILS_CAN_RETURN_WITH_ERROR_OF(RCUTILS_RET_INVALID_ARGUMENT);
-  RCUTILS_CAN_RETURN_WITH_ERROR_OF(RCUTILS_RET_BAD_ALLOC);
-  RCUTILS_CAN_RETURN_WITH_ERROR_OF(RCUTILS_RET_ERROR);
+  return rcutils_load_shared_library_with_options(lib, library_path, NULL, allocator);
+}
 
+static rcutils_ret_t
+load_shared_library(
+  rcutils_shared_library_t * lib,
+  const char * library_path,
+  const rcutils_shared_library_load_options_t * options,
+  rcutils_allocator_t allocator)
+{
   RCUTILS_CHECK_ARGUMENT_FOR_NULL(lib, RCUTILS_RET_INVALID_ARGUMENT);
   RCUTILS_CHECK_ARGUMENT_FOR_NULL(library_path, RCUTILS_RET_INVALID_ARGUMENT);
   RCUTILS_CHECK_ALLOCATOR(&allocator, return RCUTILS_RET_INVALID_ARGUMENT);
@@ -81,6 +453,18 @@ rcutils_load_shared_library(
     return RCUTILS_RET_INVALID_ARGUMENT;
   }
 
+  rcutils_shared_library_load_options_t default_options =
+    rcutils_shared_library_get_default_load_options();
+  if (NULL == options) {
+    options = &default_options;
+  }
+#if !defined(_WIN32) && !defined(RTLD_NODELETE)
+  if (options->no_delete) {
+    RCUTILS_SET_ERROR_MSG("keeping libraries loaded is not supported on this platform");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+#endif
+
   rcutils_ret_t ret = RCUTILS_RET_OK;
   lib->allocator = allocator;
 
@@ -94,55 +478,82 @@ rcutils_load_shared_library(
   // for further reference.
 
 #ifndef _WIN32
-  lib->lib_pointer = dlopen(library_path, RTLD_LAZY);
+  int flags = (options->resolve_now ? RTLD_NOW : RTLD_LAZY) |
+    (options->global ? RTLD_GLOBAL : RTLD_LOCAL);
+#ifdef RTLD_NODELETE
+  if (options->no_delete) {
+    flags |= RTLD_NODELETE;
+  }
+#endif
+  lib->lib_pointer = dlopen(library_path, flags);
   if (NULL == lib->lib_pointer) {
     RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("dlopen error: %s", dlerror());
     return RCUTILS_RET_ERROR;
   }
 
+  // The path is only resolved if the library isn't loaded yet
+  lib->library_path = registry_copy_resolved_path(library_path, lib->lib_pointer, &allocator);
+  if (NULL == lib->library_path) {
 #if defined(__APPLE__)
-  const char * image_name = NULL;
-  uint32_t image_count = _dyld_image_count();
-  for (uint32_t i = 0; NULL == image_name && i < image_count; ++i) {
-    // Iterate in reverse as the library is likely near the end of the list.
-    const char * candidate_name = _dyld_get_image_name(image_count - i - 1);
-    if (NULL == candidate_name) {
-      RCUTILS_SET_ERROR_MSG("dyld image index out of range");
+    const char * image_name = NULL;
+    uint32_t image_count = _dyld_image_count();
+    for (uint32_t i = 0; NULL == image_name && i < image_count; ++i) {
+      // Iterate in reverse as the library is likely near the end of the list.
+      const char * candidate_name = _dyld_get_image_name(image_count - i - 1);
+      if (NULL == candidate_name) {
+        RCUTILS_SET_ERROR_MSG("dyld image index out of range");
+        ret = RCUTILS_RET_ERROR;
+        goto fail;
+      }
+      void * handle = dlopen(candidate_name, RTLD_LAZY | RTLD_NOLOAD);
+      if (handle == lib->lib_pointer) {
+        image_name = candidate_name;
+      }
+      if (dlclose(handle) != 0) {
+        RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("dlclose error: %s", dlerror());
+        ret = RCUTILS_RET_ERROR;
+        goto fail;
+      }
+    }
+    if (NULL == image_name) {
+      RCUTILS_SET_ERROR_MSG("dyld image name could not be found");
       ret = RCUTILS_RET_ERROR;
       goto fail;
     }
-    void * handle = dlopen(candidate_name, RTLD_LAZY | RTLD_NOLOAD);
-    if (handle == lib->lib_pointer) {
-      image_name = candidate_name;
-    }
-    if (dlclose(handle) != 0) {
-      RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("dlclose error: %s", dlerror());
+    lib->library_path = rcutils_strdup(image_name, lib->allocator);
+#elif defined(_GNU_SOURCE) && !defined(__QNXNTO__) && !defined(__ANDROID__)
+    struct link_map * map = NULL;
+    if (dlinfo(lib->lib_pointer, RTLD_DI_LINKMAP, &map) != 0) {
+      RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("dlinfo error: %s", dlerror());
       ret = RCUTILS_RET_ERROR;
       goto fail;
     }
-  }
-  if (NULL == image_name) {
-    RCUTILS_SET_ERROR_MSG("dyld image name could not be found");
-    ret = RCUTILS_RET_ERROR;
-    goto fail;
-  }
-  lib->library_path = rcutils_strdup(image_name, lib->allocator);
-#elif defined(_GNU_SOURCE) && !defined(__QNXNTO__) && !defined(__ANDROID__)
-  struct link_map * map = NULL;
-  if (dlinfo(lib->lib_pointer, RTLD_DI_LINKMAP, &map) != 0) {
-    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("dlinfo error: %s", dlerror());
-    ret = RCUTILS_RET_ERROR;
-    goto fail;
-  }
-  lib->library_path = rcutils_strdup(map->l_name, lib->allocator);
+    lib->library_path = rcutils_strdup(map->l_name, lib->allocator);
 #else
-  lib->library_path = rcutils_strdup(library_path, lib->allocator);
+    lib->library_path = rcutils_strdup(library_path, lib->allocator);
 #endif
+  }
   if (NULL == lib->library_path) {
     RCUTILS_SET_ERROR_MSG("unable to allocate memory");
     ret = RCUTILS_RET_BAD_ALLOC;
     goto fail;
   }
+  lib->symbol_cache = symbol_cache_create(&lib->allocator);
+  if (NULL == lib->symbol_cache) {
+    RCUTILS_SET_ERROR_MSG("unable to allocate memory");
+    lib->allocator.deallocate(lib->library_path, lib->allocator.state);
+    lib->library_path = NULL;
+    ret = RCUTILS_RET_BAD_ALLOC;
+    goto fail;
+  }
+  ret = registry_add(library_path, lib->library_path, lib->lib_pointer);
+  if (RCUTILS_RET_OK != ret) {
+    symbol_cache_destroy(lib->symbol_cache, &lib->allocator);
+    lib->symbol_cache = NULL;
+    lib->allocator.deallocate(lib->library_path, lib->allocator.state);
+    lib->library_path = NULL;
+    goto fail;
+  }
 
   return RCUTILS_RET_OK;
 fail:
@@ -159,8 +570,23 @@ fail:
       "LoadLibrary error: %lu", GetLastError());
     return RCUTILS_RET_ERROR;
   }
+  if (options->no_delete) {
+    // Pinning takes a reference which is never released, so that FreeLibrary keeps the module
+    HMODULE pinned_module = NULL;
+    if (!GetModuleHandleEx(
+        GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_PIN,
+        (LPCSTR)module, &pinned_module))
+    {
+      RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+        "GetModuleHandleEx error: %lu", GetLastError());
+      ret = RCUTILS_RET_ERROR;
+      goto fail;
+    }
+  }
 
-  for (DWORD buffer_capacity = MAX_PATH; ; buffer_capacity *= 2) {
+  // The path is only resolved if the library isn't loaded yet
+  lib->library_path = registry_copy_resolved_path(library_path, (void *)module, &allocator);
+  for (DWORD buffer_capacity = MAX_PATH; NULL == lib->library_path; buffer_capacity *= 2) {
     LPSTR buffer = lib->allocator.allocate(buffer_capacity, lib->allocator.state);
     if (NULL == buffer) {
       RCUTILS_SET_ERROR_MSG("unable to allocate memory");
@@ -185,6 +611,22 @@ fail:
     }
     break;
   }
+  lib->symbol_cache = symbol_cache_create(&lib->allocator);
+  if (NULL == lib->symbol_cache) {
+    RCUTILS_SET_ERROR_MSG("unable to allocate memory");
+    lib->allocator.deallocate(lib->library_path, lib->allocator.state);
+    lib->library_path = NULL;
+    ret = RCUTILS_RET_BAD_ALLOC;
+    goto fail;
+  }
+  ret = registry_add(library_path, lib->library_path, (void *)module);
+  if (RCUTILS_RET_OK != ret) {
+    symbol_cache_destroy(lib->symbol_cache, &lib->allocator);
+    lib->symbol_cache = NULL;
+    lib->allocator.deallocate(lib->library_path, lib->allocator.state);
+    lib->library_path = NULL;
+    goto fail;
+  }
   lib->lib_pointer = (void *)module;
 
   return RCUTILS_RET_OK;
@@ -197,6 +639,23 @@ fail:
 #endif  // _WIN32
 }
 
+rcutils_ret_t
+rcutils_load_shared_library_with_options(
+  rcutils_shared_library_t * lib,
+  const char * library_path,
+  const rcutils_shared_library_load_options_t * options,
+  rcutils_allocator_t allocator)
+{
+  RCUTILS_CAN_RETURN_WITH_ERROR_OF(RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CAN_RETURN_WITH_ERROR_OF(RCUTILS_RET_BAD_ALLOC);
+  RCUTILS_CAN_RETURN_WITH_ERROR_OF(RCUTILS_RET_ERROR);
+
+  RCUTILS_TRACEPOINT(shared_library_load_start, library_path);
+  rcutils_ret_t ret = load_shared_library(lib, library_path, options, allocator);
+  RCUTILS_TRACEPOINT(shared_library_load_end, library_path, ret);
+  return ret;
+}
+
 void *
 rcutils_get_symbol(const rcutils_shared_library_t * lib, const char * symbol_name)
 {
@@ -205,6 +664,17 @@ rcutils_get_symbol(const rcutils_shared_library_t * lib, const char * symbol_nam
     return NULL;
   }
 
+  rcutils_shared_library_symbol_cache_t * cache = lib->symbol_cache;
+  size_t hash = symbol_hash(symbol_name);
+  if (NULL != cache) {
+    spin_lock(&cache->lock);
+    void * cached_symbol = symbol_cache_find(cache, symbol_name, hash);
+    spin_unlock(&cache->lock);
+    if (NULL != cached_symbol) {
+      return cached_symbol;
+    }
+  }
+
 #ifndef _WIN32
   void * lib_symbol = dlsym(lib->lib_pointer, symbol_name);
   char * error = dlerror();
@@ -229,27 +699,88 @@ rcutils_get_symbol(const rcutils_shared_library_t * lib, const char * symbol_nam
       symbol_name, lib->library_path);
     return NULL;
   }
+  if (NULL != cache) {
+    spin_lock(&cache->lock);
+    symbol_cache_insert(cache, &lib->allocator, symbol_name, hash, lib_symbol);
+    spin_unlock(&cache->lock);
+  }
   return lib_symbol;
 }
 
+rcutils_ret_t
+rcutils_get_symbols(
+  const rcutils_shared_library_t * lib,
+  const char * const * symbol_names,
+  size_t count,
+  void ** symbols)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(lib, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(lib->lib_pointer, RCUTILS_RET_INVALID_ARGUMENT);
+  if (0 == count) {
+    return RCUTILS_RET_OK;
+  }
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(symbol_names, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(symbols, RCUTILS_RET_INVALID_ARGUMENT);
+  for (size_t i = 0; i < count; ++i) {
+    if (NULL == symbol_names[i]) {
+      RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("symbol name at index %zu is null", i);
+      return RCUTILS_RET_INVALID_ARGUMENT;
+    }
+  }
+
+  rcutils_shared_library_symbol_cache_t * cache = lib->symbol_cache;
+  if (NULL != cache) {
+    spin_lock(&cache->lock);
+    for (size_t i = 0; i < count; ++i) {
+      symbols[i] = symbol_cache_find(cache, symbol_names[i], symbol_hash(symbol_names[i]));
+    }
+    spin_unlock(&cache->lock);
+  } else {
+    for (size_t i = 0; i < count; ++i) {
+      symbols[i] = NULL;
+    }
+  }
+
+  // Look the symbols which aren't cached up without the lock, then cache them all at once
+  const char * missing_name = NULL;
+  size_t found_count = 0;
+  for (size_t i = 0; i < count; ++i) {
+    if (NULL == symbols[i]) {
+      symbols[i] = lookup_symbol(lib, symbol_names[i]);
+      if (NULL != symbols[i]) {
+        ++found_count;
+      } else if (NULL == missing_name) {
+        missing_name = symbol_names[i];
+      }
+    }
+  }
+  if (NULL != cache && 0 != found_count) {
+    spin_lock(&cache->lock);
+    for (size_t i = 0; i < count; ++i) {
+      if (NULL != symbols[i]) {
+        symbol_cache_insert(
+          cache, &lib->allocator, symbol_names[i], symbol_hash(symbol_names[i]), symbols[i]);
+      }
+    }
+    spin_unlock(&cache->lock);
+  }
+
+  if (NULL != missing_name) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "symbol '%s' does not exist in the library '%s'",
+      missing_name, lib->library_path);
+    return RCUTILS_RET_ERROR;
+  }
+  return RCUTILS_RET_OK;
+}
+
 bool
 rcutils_has_symbol(const rcutils_shared_library_t * lib, const char * symbol_name)
 {
   if (!lib || !lib->lib_pointer || symbol_name == NULL) {
     return false;
   }
-
-#ifndef _WIN32
-  // the correct way to test for an error is to call dlerror() to clear any old error conditions,
-  // then call dlsym(), and then call dlerror() again, saving its return value into a variable,
-  // and check whether this saved value is not NULL.
-  dlerror(); /* Clear any existing error */
-  void * lib_symbol = dlsym(lib->lib_pointer, symbol_name);
-  return dlerror() == NULL && lib_symbol != 0;
-#else
-  void * lib_symbol = GetProcAddress((HINSTANCE)(lib->lib_pointer), symbol_name);
-  return lib_symbol != NULL;
-#endif  // _WIN32
+  return cached_lookup_symbol(lib, symbol_name) != NULL;
 }
 
 rcutils_ret_t
@@ -275,6 +806,9 @@ rcutils_unload_shared_library(rcutils_shared_library_t * lib)
     ret = RCUTILS_RET_ERROR;
   }
 
+  registry_remove(lib->library_path);
+  symbol_cache_destroy(lib->symbol_cache, &lib->allocator);
+  lib->symbol_cache = NULL;
   lib->allocator.deallocate(lib->library_path, lib->allocator.state);
   lib->library_path = NULL;
   lib->lib_pointer = NULL;
@@ -340,12 +874,200 @@ rcutils_get_platform_library_name(
   return RCUTILS_RET_OK;
 }
 
+typedef struct rcutils_shared_library_preload_impl_t
+{
+  rcutils_allocator_t allocator;
+  rcutils_shared_library_load_options_t options;
+  rcutils_shared_library_t * libs;
+  const char * const * library_paths;
+  rcutils_thread_pool_t pool;
+  // The error of the library of lowest index which failed to load, guarded by the lock.
+  atomic_bool error_lock;
+  size_t error_index;
+  rcutils_ret_t error_ret;
+  char error_string[RCUTILS_ERROR_MESSAGE_MAX_LENGTH];
+} rcutils_shared_library_preload_impl_t;
+
+static void
+preload_library(rcutils_thread_pool_t * pool, void * context, void * item)
+{
+  (void)pool;
+  rcutils_shared_library_preload_impl_t * impl = context;
+  size_t index = *(size_t *)item;
+  rcutils_ret_t ret = rcutils_load_shared_library_with_options(
+    &impl->libs[index], impl->library_paths[index], &impl->options, impl->allocator);
+  if (RCUTILS_RET_OK == ret) {
+    return;
+  }
+  // The error is set in this thread, so it's passed on to the one waiting
+  rcutils_error_string_t error_string = rcutils_get_error_string();
+  rcutils_reset_error();
+  spin_lock(&impl->error_lock);
+  if (index < impl->error_index) {
+    impl->error_index = index;
+    impl->error_ret = ret;
+    memcpy(impl->error_string, error_string.str, sizeof(impl->error_string));
+  }
+  spin_unlock(&impl->error_lock);
+}
+
+rcutils_shared_library_preload_t
+rcutils_get_zero_initialized_shared_library_preload(void)
+{
+  static rcutils_shared_library_preload_t zero_initialized_preload = {NULL};
+  return zero_initialized_preload;
+}
+
+// Starts the preload, with pool_thread_count threads including the one waiting.
+static rcutils_ret_t
+preload_start(
+  rcutils_shared_library_preload_t * preload,
+  rcutils_shared_library_t * libs,
+  const char * const * library_paths,
+  size_t count,
+  const rcutils_shared_library_load_options_t * options,
+  size_t pool_thread_count,
+  rcutils_allocator_t allocator)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(preload, RCUTILS_RET_INVALID_ARGUMENT);
+  if (NULL != preload->impl) {
+    RCUTILS_SET_ERROR_MSG("preload is already started");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  if (0 != count) {
+    RCUTILS_CHECK_ARGUMENT_FOR_NULL(libs, RCUTILS_RET_INVALID_ARGUMENT);
+    RCUTILS_CHECK_ARGUMENT_FOR_NULL(library_paths, RCUTILS_RET_INVALID_ARGUMENT);
+  }
+  RCUTILS_CHECK_ALLOCATOR_WITH_MSG(
+    &allocator, "invalid allocator", return RCUTILS_RET_INVALID_ARGUMENT);
+  for (size_t i = 0; i < count; ++i) {
+    if (NULL == library_paths[i] || NULL != libs[i].lib_pointer) {
+      RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+        "library at index %zu has a null path or is not zero-initialized", i);
+      return RCUTILS_RET_INVALID_ARGUMENT;
+    }
+  }
+
+  rcutils_shared_library_preload_impl_t * impl = allocator.zero_allocate(
+    1, sizeof(rcutils_shared_library_preload_impl_t), allocator.state);
+  if (NULL == impl) {
+    RCUTILS_SET_ERROR_MSG("unable to allocate memory");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  impl->allocator = allocator;
+  impl->options = NULL != options ? *options : rcutils_shared_library_get_default_load_options();
+  impl->libs = libs;
+  impl->library_paths = library_paths;
+  rcutils_atomic_store(&impl->error_lock, false);
+  impl->error_index = SIZE_MAX;
+  impl->error_ret = RCUTILS_RET_OK;
+  // There is no use for more threads than libraries
+  if (pool_thread_count > count) {
+    pool_thread_count = 0 != count ? count : 1;
+  }
+  // The shared queue holds all the libraries, so pushing them doesn't fail
+  rcutils_thread_pool_options_t pool_options = rcutils_thread_pool_get_default_options();
+  pool_options.thread_count = pool_thread_count;
+  pool_options.capacity = count;
+  impl->pool = rcutils_get_zero_initialized_thread_pool();
+  rcutils_ret_t ret = rcutils_thread_pool_init(
+    &impl->pool, preload_library, impl, sizeof(size_t), &pool_options, allocator);
+  if (RCUTILS_RET_OK != ret) {
+    allocator.deallocate(impl, allocator.state);
+    return ret;
+  }
+  for (size_t i = 0; i < count; ++i) {
+    ret = rcutils_thread_pool_push(&impl->pool, &i);
+    RCUTILS_UNUSED(ret);
+  }
+  preload->impl = impl;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_shared_library_preload_start(
+  rcutils_shared_library_preload_t * preload,
+  rcutils_shared_library_t * libs,
+  const char * const * library_paths,
+  size_t count,
+  const rcutils_shared_library_load_options_t * options,
+  size_t thread_count,
+  rcutils_allocator_t allocator)
+{
+  if (0 == thread_count) {
+    thread_count = rcutils_thread_pool_get_processor_count();
+  }
+  // The background threads, and the one which eventually waits
+  return preload_start(
+    preload, libs, library_paths, count, options, thread_count + 1, allocator);
+}
+
+rcutils_ret_t
+rcutils_shared_library_preload_wait(rcutils_shared_library_preload_t * preload)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(preload, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(preload->impl, RCUTILS_RET_INVALID_ARGUMENT);
+  rcutils_shared_library_preload_impl_t * impl = preload->impl;
+  rcutils_ret_t ret = rcutils_thread_pool_wait(&impl->pool);
+  RCUTILS_UNUSED(ret);
+  ret = rcutils_thread_pool_fini(&impl->pool);
+  RCUTILS_UNUSED(ret);
+
+  ret = impl->error_ret;
+  if (RCUTILS_RET_OK != ret) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "failed to load library '%s': %s",
+      impl->library_paths[impl->error_index], impl->error_string);
+  }
+  rcutils_allocator_t allocator = impl->allocator;
+  allocator.deallocate(impl, allocator.state);
+  preload->impl = NULL;
+  return ret;
+}
+
+rcutils_ret_t
+rcutils_load_shared_libraries(
+  rcutils_shared_library_t * libs,
+  const char * const * library_paths,
+  size_t count,
+  const rcutils_shared_library_load_options_t * options,
+  size_t thread_count,
+  rcutils_allocator_t allocator)
+{
+  if (0 == thread_count) {
+    thread_count = rcutils_thread_pool_get_processor_count();
+  }
+  rcutils_shared_library_preload_t preload = rcutils_get_zero_initialized_shared_library_preload();
+  rcutils_ret_t ret = preload_start(
+    &preload, libs, library_paths, count, options, thread_count, allocator);
+  if (RCUTILS_RET_OK != ret) {
+    return ret;
+  }
+  return rcutils_shared_library_preload_wait(&preload);
+}
+
 bool
 rcutils_is_shared_library_loaded(rcutils_shared_library_t * lib)
 {
   return lib->lib_pointer != NULL;
 }
 
+bool
+rcutils_is_shared_library_path_loaded(const char * library_path)
+{
+  if (NULL == library_path) {
+    return false;
+  }
+  spin_lock(&g_rcutils_shared_library_registry_lock);
+  bool loaded = NULL != registry_get_entry(library_path);
+  if (!loaded) {
+    const char * resolved_path = registry_get_resolved_path(library_path);
+    loaded = NULL != resolved_path && NULL != registry_get_entry(resolved_path);
+  }
+  spin_unlock(&g_rcutils_shared_library_registry_lock);
+  return loaded;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -20,11 +20,13 @@ extern "C"
 #include "rcutils/snprintf.h"
 
 #include <errno.h>
-#ifdef _WIN32
-#include <string.h>
-#endif
+#include <limits.h>
 #include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 
 int
 rcutils_snprintf(char * buffer, size_t buffer_size, const char * format, ...)
@@ -71,6 +73,474 @@ rcutils_vsnprintf(char * buffer, size_t buffer_size, const char * format, va_lis
   return ret;
 }
 
+int
+rcutils_fast_snprintf(char * buffer, size_t buffer_size, const char * format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  int ret = rcutils_fast_vsnprintf(buffer, buffer_size, format, args);
+  va_end(args);
+  return ret;
+}
+
+// The output of rcutils_fast_vsnprintf(), counting the bytes which don't fit the buffer.
+typedef struct fast_output_t
+{
+  char * buffer;
+  size_t size;
+  size_t length;
+} fast_output_t;
+
+static void
+_fast_output_put(fast_output_t * output, const char * src, size_t n)
+{
+  if (0u == n) {
+    // src may be NULL then, which memcpy() doesn't allow.
+    return;
+  }
+  if (output->length < output->size) {
+    size_t room = output->size - output->length;
+    memcpy(output->buffer + output->length, src, n < room ? n : room);
+  }
+  output->length += n;
+}
+
+static void
+_fast_output_pad(fast_output_t * output, char c, size_t n)
+{
+  if (output->length < output->size) {
+    size_t room = output->size - output->length;
+    memset(output->buffer + output->length, c, n < room ? n : room);
+  }
+  output->length += n;
+}
+
+// A conversion specification, without its argument.
+typedef struct fast_conversion_t
+{
+  bool left;
+  bool plus;
+  bool space;
+  bool alternate;
+  bool zero;
+  size_t width;
+  // -1 when there is no precision
+  int precision;
+  // The length modifier, 'H' standing for "hh" and 'q' for "ll".
+  char modifier;
+  char type;
+} fast_conversion_t;
+
+static const char g_fast_digit_pairs[] =
+  "00010203040506070809"
+  "10111213141516171819"
+  "20212223242526272829"
+  "30313233343536373839"
+  "40414243444546474849"
+  "50515253545556575859"
+  "60616263646566676869"
+  "70717273747576777879"
+  "80818283848586878889"
+  "90919293949596979899";
+
+// Writes the digits of value backwards, ending at end, and returns where they start.
+static char *
+_fast_format_digits(uintmax_t value, unsigned int base, bool upper, char * end)
+{
+  char * digits = end;
+  if (10u == base) {
+    while (value >= 100u) {
+      const char * pair = g_fast_digit_pairs + (value % 100u) * 2u;
+      value /= 100u;
+      *--digits = pair[1];
+      *--digits = pair[0];
+    }
+    if (value >= 10u) {
+      *--digits = g_fast_digit_pairs[value * 2u + 1u];
+      *--digits = g_fast_digit_pairs[value * 2u];
+    } else if (value > 0u) {
+      *--digits = (char)('0' + value);
+    }
+    return digits;
+  }
+  const char * alphabet = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+  const unsigned int shift = 16u == base ? 4u : 3u;
+  while (value > 0u) {
+    *--digits = alphabet[value & (base - 1u)];
+    value >>= shift;
+  }
+  return digits;
+}
+
+// Writes body, preceded by prefix and padded to the width of the conversion.
+// Zeros are padded between the prefix and the body, leading_zeros of them at least.
+static void
+_fast_output_field(
+  fast_output_t * output, const fast_conversion_t * conversion,
+  const char * prefix, size_t prefix_length,
+  size_t leading_zeros, const char * body, size_t body_length)
+{
+  size_t length = prefix_length + leading_zeros + body_length;
+  size_t padding = conversion->width > length ? conversion->width - length : 0u;
+  if (conversion->zero && !conversion->left) {
+    leading_zeros += padding;
+    padding = 0u;
+  }
+  if (!conversion->left) {
+    _fast_output_pad(output, ' ', padding);
+  }
+  _fast_output_put(output, prefix, prefix_length);
+  _fast_output_pad(output, '0', leading_zeros);
+  _fast_output_put(output, body, body_length);
+  if (conversion->left) {
+    _fast_output_pad(output, ' ', padding);
+  }
+}
+
+static void
+_fast_output_integer(
+  fast_output_t * output, const fast_conversion_t * conversion,
+  uintmax_t magnitude, bool negative)
+{
+  char digits_buffer[sizeof(uintmax_t) * 3u];
+  char * end = digits_buffer + sizeof(digits_buffer);
+  unsigned int base = 10u;
+  if ('x' == conversion->type || 'X' == conversion->type) {
+    base = 16u;
+  } else if ('o' == conversion->type) {
+    base = 8u;
+  }
+  char * digits = _fast_format_digits(magnitude, base, 'X' == conversion->type, end);
+  size_t digit_count = (size_t)(end - digits);
+
+  char prefix[2];
+  size_t prefix_length = 0u;
+  if (negative) {
+    prefix[prefix_length++] = '-';
+  } else if ('d' == conversion->type || 'i' == conversion->type) {
+    if (conversion->plus) {
+      prefix[prefix_length++] = '+';
+    } else if (conversion->space) {
+      prefix[prefix_length++] = ' ';
+    }
+  } else if (conversion->alternate && 16u == base && 0u != magnitude) {
+    prefix[prefix_length++] = '0';
+    prefix[prefix_length++] = conversion->type;
+  }
+
+  // Without a precision, at least one digit, and the precision of 0 makes none for 0.
+  size_t min_digits = conversion->precision < 0 ? 1u : (size_t)conversion->precision;
+  if (conversion->alternate && 8u == base && min_digits <= digit_count) {
+    // The alternate form of an octal number starts with a 0, the digits never do.
+    min_digits = digit_count + 1u;
+  }
+  size_t leading_zeros = min_digits > digit_count ? min_digits - digit_count : 0u;
+  _fast_output_field(output, conversion, prefix, prefix_length, leading_zeros, digits, digit_count);
+}
+
+static void
+_fast_output_pointer(fast_output_t * output, const fast_conversion_t * conversion, void * ptr)
+{
+  if (NULL == ptr) {
+    _fast_output_field(output, conversion, NULL, 0u, 0u, "(nil)", 5u);
+    return;
+  }
+  char digits_buffer[sizeof(uintptr_t) * 2u];
+  char * end = digits_buffer + sizeof(digits_buffer);
+  char * digits = _fast_format_digits((uintptr_t)ptr, 16u, false, end);
+  _fast_output_field(output, conversion, "0x", 2u, 0u, digits, (size_t)(end - digits));
+}
+
+// Formats a floating point conversion with snprintf(), directly into the output.
+static bool
+_fast_output_double(fast_output_t * output, const fast_conversion_t * conversion, double value)
+{
+  char spec[16];
+  size_t n = 0u;
+  spec[n++] = '%';
+  if (conversion->left) {spec[n++] = '-';}
+  if (conversion->plus) {spec[n++] = '+';}
+  if (conversion->space) {spec[n++] = ' ';}
+  if (conversion->alternate) {spec[n++] = '#';}
+  if (conversion->zero) {spec[n++] = '0';}
+  spec[n++] = '*';
+  spec[n++] = '.';
+  spec[n++] = '*';
+  spec[n++] = conversion->type;
+  spec[n] = '\0';
+  if (conversion->width > INT_MAX) {
+    return false;
+  }
+  // 6 is the precision of a floating point conversion without one.
+  int precision = conversion->precision < 0 ? 6 : conversion->precision;
+  char * buffer = NULL;
+  size_t size = 0u;
+  if (output->length < output->size) {
+    buffer = output->buffer + output->length;
+    size = output->size - output->length;
+  }
+  int ret = snprintf(buffer, size, spec, (int)conversion->width, precision, value);
+  if (ret < 0) {
+    return false;
+  }
+  output->length += (size_t)ret;
+  return true;
+}
+
+// Parses the conversion specification after a '%', and returns where it ends,
+// or NULL if it isn't supported.
+static const char *
+_fast_parse_conversion(const char * c, fast_conversion_t * conversion, va_list * args)
+{
+  memset(conversion, 0, sizeof(*conversion));
+  conversion->precision = -1;
+  for (;; ++c) {
+    if ('-' == *c) {
+      conversion->left = true;
+    } else if ('+' == *c) {
+      conversion->plus = true;
+    } else if (' ' == *c) {
+      conversion->space = true;
+    } else if ('#' == *c) {
+      conversion->alternate = true;
+    } else if ('0' == *c) {
+      conversion->zero = true;
+    } else {
+      break;
+    }
+  }
+  if ('*' == *c) {
+    int width = va_arg(*args, int);
+    if (width < 0) {
+      // A negative width is taken as the '-' flag and a positive width.
+      conversion->left = true;
+      width = width == INT_MIN ? INT_MAX : -width;
+    }
+    conversion->width = (size_t)width;
+    ++c;
+  } else {
+    while ('0' <= *c && *c <= '9') {
+      if (conversion->width > INT_MAX / 10) {
+        return NULL;
+      }
+      conversion->width = conversion->width * 10u + (size_t)(*c++ - '0');
+    }
+  }
+  if ('.' == *c) {
+    ++c;
+    if ('*' == *c) {
+      // A negative precision is taken as if there was none.
+      int precision = va_arg(*args, int);
+      conversion->precision = precision < 0 ? -1 : precision;
+      ++c;
+    } else {
+      conversion->precision = 0;
+      while ('0' <= *c && *c <= '9') {
+        if (conversion->precision > INT_MAX / 10 - 1) {
+          return NULL;
+        }
+        conversion->precision = conversion->precision * 10 + (*c++ - '0');
+      }
+    }
+  }
+  if ('h' == *c || 'l' == *c || 'j' == *c || 'z' == *c || 't' == *c) {
+    conversion->modifier = *c++;
+    if ('h' == conversion->modifier && 'h' == *c) {
+      conversion->modifier = 'H';
+      ++c;
+    } else if ('l' == conversion->modifier && 'l' == *c) {
+      conversion->modifier = 'q';
+      ++c;
+    }
+  }
+  conversion->type = *c;
+  switch (conversion->type) {
+    case 'd':
+    case 'i':
+    case 'u':
+    case 'o':
+    case 'x':
+    case 'X':
+      break;
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+      if ('\0' != conversion->modifier && 'l' != conversion->modifier) {
+        return NULL;
+      }
+      break;
+    case 'c':
+    case 's':
+    case 'p':
+      if ('\0' != conversion->modifier) {
+        return NULL;
+      }
+      break;
+    default:
+      return NULL;
+  }
+  // The 0 flag is ignored with the - flag, with a precision for integers, and for the
+  // conversions which aren't numbers.
+  if (conversion->left || 'c' == conversion->type || 's' == conversion->type ||
+    'p' == conversion->type ||
+    (conversion->precision >= 0 && NULL == strchr("fFeEgG", conversion->type)))
+  {
+    conversion->zero = false;
+  }
+  return c + 1;
+}
+
+static bool
+_fast_output_conversion(
+  fast_output_t * output, const fast_conversion_t * conversion, va_list * args)
+{
+  switch (conversion->type) {
+    case 'd':
+    case 'i':
+      {
+        intmax_t value;
+        if ('H' == conversion->modifier) {
+          value = (signed char)va_arg(*args, int);
+        } else if ('h' == conversion->modifier) {
+          value = (short)va_arg(*args, int);
+        } else if ('l' == conversion->modifier) {
+          value = va_arg(*args, long);
+        } else if ('q' == conversion->modifier) {
+          value = va_arg(*args, long long);
+        } else if ('j' == conversion->modifier) {
+          value = va_arg(*args, intmax_t);
+        } else if ('z' == conversion->modifier) {
+          value = (intmax_t)va_arg(*args, size_t);
+        } else if ('t' == conversion->modifier) {
+          value = va_arg(*args, ptrdiff_t);
+        } else {
+          value = va_arg(*args, int);
+        }
+        // The magnitude of INTMAX_MIN doesn't fit an intmax_t.
+        uintmax_t magnitude = value < 0 ? (uintmax_t)0 - (uintmax_t)value : (uintmax_t)value;
+        _fast_output_integer(output, conversion, magnitude, value < 0);
+        return true;
+      }
+    case 'u':
+    case 'o':
+    case 'x':
+    case 'X':
+      {
+        uintmax_t value;
+        if ('H' == conversion->modifier) {
+          value = (unsigned char)va_arg(*args, unsigned int);
+        } else if ('h' == conversion->modifier) {
+          value = (unsigned short)va_arg(*args, unsigned int);
+        } else if ('l' == conversion->modifier) {
+          value = va_arg(*args, unsigned long);
+        } else if ('q' == conversion->modifier) {
+          value = va_arg(*args, unsigned long long);
+        } else if ('j' == conversion->modifier) {
+          value = va_arg(*args, uintmax_t);
+        } else if ('z' == conversion->modifier) {
+          value = va_arg(*args, size_t);
+        } else if ('t' == conversion->modifier) {
+          value = (uintmax_t)va_arg(*args, ptrdiff_t);
+        } else {
+          value = va_arg(*args, unsigned int);
+        }
+        _fast_output_integer(output, conversion, value, false);
+        return true;
+      }
+    case 'c':
+      {
+        char c = (char)va_arg(*args, int);
+        _fast_output_field(output, conversion, NULL, 0u, 0u, &c, 1u);
+        return true;
+      }
+    case 's':
+      {
+        const char * str = va_arg(*args, const char *);
+        if (NULL == str) {
+          str = "(null)";
+        }
+        // With a precision, the string doesn't have to be null terminated.
+        size_t length;
+        if (conversion->precision >= 0) {
+          const char * end = memchr(str, '\0', (size_t)conversion->precision);
+          length = NULL == end ? (size_t)conversion->precision : (size_t)(end - str);
+        } else {
+          length = strlen(str);
+        }
+        _fast_output_field(output, conversion, NULL, 0u, 0u, str, length);
+        return true;
+      }
+    case 'p':
+      _fast_output_pointer(output, conversion, va_arg(*args, void *));
+      return true;
+    default:
+      return _fast_output_double(output, conversion, va_arg(*args, double));
+  }
+}
+
+int
+rcutils_fast_vsnprintf(char * buffer, size_t buffer_size, const char * format, va_list args)
+{
+  RCUTILS_CAN_FAIL_WITH({errno = EINVAL; return -1;});
+
+  if (NULL == format) {
+    errno = EINVAL;
+    return -1;
+  }
+  if ((NULL == buffer) != (0 == buffer_size)) {
+    errno = EINVAL;
+    return -1;
+  }
+
+  // Kept to format everything with the C library on an unsupported conversion.
+  va_list args_copy;
+  va_copy(args_copy, args);
+  va_list args_clone;
+  va_copy(args_clone, args);
+
+  fast_output_t output = {buffer, buffer_size, 0u};
+  const char * c = format;
+  bool supported = true;
+  while ('\0' != *c) {
+    const char * percent = strchr(c, '%');
+    if (NULL == percent) {
+      _fast_output_put(&output, c, strlen(c));
+      break;
+    }
+    _fast_output_put(&output, c, (size_t)(percent - c));
+    if ('%' == percent[1]) {
+      _fast_output_put(&output, "%", 1u);
+      c = percent + 2;
+      continue;
+    }
+    fast_conversion_t conversion;
+    c = _fast_parse_conversion(percent + 1, &conversion, &args_clone);
+    if (NULL == c || !_fast_output_conversion(&output, &conversion, &args_clone)) {
+      supported = false;
+      break;
+    }
+  }
+  va_end(args_clone);
+
+  int ret;
+  if (!supported) {
+    ret = rcutils_vsnprintf(buffer, buffer_size, format, args_copy);
+  } else if (output.length > INT_MAX) {
+    errno = EOVERFLOW;
+    ret = -1;
+  } else {
+    if (0u != buffer_size) {
+      buffer[output.length < buffer_size ? output.length : buffer_size - 1u] = '\0';
+    }
+    ret = (int)output.length;
+  }
+  va_end(args_copy);
+  return ret;
+}
+
 #ifdef __cplusplus
 }
 #endif
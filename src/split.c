@@ -43,6 +43,7 @@ rcutils_split(
     return RCUTILS_RET_OK;
   }
   string_array->allocator = allocator;
+  string_array->arena = NULL;
 
   size_t string_size = strlen(str);
 
@@ -214,6 +215,106 @@ fail:
   return result_error;
 }
 
+rcutils_ret_t
+rcutils_split_contiguous(
+  const char * str,
+  char delimiter,
+  rcutils_allocator_t allocator,
+  char *** tokens,
+  size_t * count)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(tokens, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(count, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ALLOCATOR(&allocator, return RCUTILS_RET_INVALID_ARGUMENT);
+  *tokens = NULL;
+  *count = 0;
+
+  size_t token_count = 0;
+  size_t token_bytes = 0;
+  rcutils_string_view_t token = rcutils_get_zero_initialized_string_view();
+  while (rcutils_split_next_view(str, delimiter, &token)) {
+    ++token_count;
+    token_bytes += token.length + 1;
+  }
+  if (0 == token_count) {
+    return RCUTILS_RET_OK;
+  }
+
+  // The pointers first, so that they are aligned, then the null terminated tokens
+  size_t pointer_bytes = (token_count + 1) * sizeof(char *);
+  char ** block = allocator.allocate(pointer_bytes + token_bytes, allocator.state);
+  if (NULL == block) {
+    RCUTILS_SET_ERROR_MSG("unable to allocate memory for the tokens");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  char * chars = (char *)block + pointer_bytes;
+  size_t i = 0;
+  while (rcutils_split_next_view(str, delimiter, &token)) {
+    memcpy(chars, token.data, token.length);
+    chars[token.length] = '\0';
+    block[i++] = chars;
+    chars += token.length + 1;
+  }
+  block[i] = NULL;
+  *tokens = block;
+  *count = token_count;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_split_views(
+  const char * str,
+  char delimiter,
+  rcutils_string_view_t * views,
+  size_t capacity,
+  size_t * count)
+{
+  if (NULL == views && 0 != capacity) {
+    RCUTILS_SET_ERROR_MSG("views is null");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(count, RCUTILS_RET_INVALID_ARGUMENT);
+
+  size_t token_count = 0;
+  rcutils_string_view_t token = rcutils_get_zero_initialized_string_view();
+  while (rcutils_split_next_view(str, delimiter, &token)) {
+    if (token_count < capacity) {
+      views[token_count] = token;
+    }
+    ++token_count;
+  }
+  *count = token_count;
+  if (token_count > capacity) {
+    RCUTILS_SET_ERROR_MSG("not enough space for the views of the tokens");
+    return RCUTILS_RET_NOT_ENOUGH_SPACE;
+  }
+  return RCUTILS_RET_OK;
+}
+
+bool
+rcutils_split_next_view(const char * str, char delimiter, rcutils_string_view_t * token)
+{
+  if (NULL == str || NULL == token) {
+    return false;
+  }
+  const char * begin = NULL == token->data ? str : token->data + token->length;
+  // Skip the delimiters, as rcutils_split() ignores empty tokens
+  while ('\0' != *begin && delimiter == *begin) {
+    ++begin;
+  }
+  if ('\0' == *begin) {
+    *token = rcutils_get_zero_initialized_string_view();
+    return false;
+  }
+  const char * end = begin + 1;
+  while ('\0' != *end && delimiter != *end) {
+    ++end;
+  }
+  token->data = begin;
+  token->length = (size_t)(end - begin);
+  return true;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -17,11 +17,85 @@ extern "C"
 {
 #endif
 
-#include <errno.h>
+#include <stdint.h>
 #include <string.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# include <emmintrin.h>
+# define STRCASECMP_SSE2
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+# include <arm_neon.h>
+# define STRCASECMP_NEON
+#endif
+
 #include "rcutils/strcasecmp.h"
 
+#if defined(STRCASECMP_SSE2) || defined(STRCASECMP_NEON)
+# define STRCASECMP_BLOCK 16u
+
+// Returns whether the blocks at s1 and s2, both before the end of their string, are equal
+// ignoring case
+static int
+_block_equal(const char * s1, const char * s2)
+{
+#if defined(STRCASECMP_SSE2)
+  const __m128i before_a = _mm_set1_epi8('A' - 1);
+  const __m128i after_z = _mm_set1_epi8('Z' + 1);
+  const __m128i case_bit = _mm_set1_epi8(0x20);
+  __m128i a = _mm_loadu_si128((const __m128i *)s1);
+  __m128i b = _mm_loadu_si128((const __m128i *)s2);
+  // Bytes of 0x80 and above are negative, so never upper case
+  __m128i upper_a = _mm_and_si128(_mm_cmpgt_epi8(a, before_a), _mm_cmplt_epi8(a, after_z));
+  __m128i upper_b = _mm_and_si128(_mm_cmpgt_epi8(b, before_a), _mm_cmplt_epi8(b, after_z));
+  a = _mm_or_si128(a, _mm_and_si128(upper_a, case_bit));
+  b = _mm_or_si128(b, _mm_and_si128(upper_b, case_bit));
+  return 0xffff == _mm_movemask_epi8(_mm_cmpeq_epi8(a, b));
+#else
+  const uint8x16_t case_bit = vdupq_n_u8(0x20);
+  uint8x16_t a = vld1q_u8((const uint8_t *)s1);
+  uint8x16_t b = vld1q_u8((const uint8_t *)s2);
+  uint8x16_t upper_a = vandq_u8(vcgeq_u8(a, vdupq_n_u8('A')), vcleq_u8(a, vdupq_n_u8('Z')));
+  uint8x16_t upper_b = vandq_u8(vcgeq_u8(b, vdupq_n_u8('A')), vcleq_u8(b, vdupq_n_u8('Z')));
+  a = vorrq_u8(a, vandq_u8(upper_a, case_bit));
+  b = vorrq_u8(b, vandq_u8(upper_b, case_bit));
+  return 0xff == vminvq_u8(vceqq_u8(a, b));
+#endif
+}
+#endif
+
+// Returns the ASCII character folded to lower case
+static inline int
+_fold(unsigned char c)
+{
+  return (unsigned char)(c - 'A') < 26u ? c | 0x20 : c;
+}
+
+// Compares up to n characters of s1 and s2 ignoring case
+static int
+_casecmp(const char * s1, const char * s2, size_t n)
+{
+#if defined(STRCASECMP_SSE2) || defined(STRCASECMP_NEON)
+  // Blocks are only compared before the end of both strings, so that no byte past it is read,
+  // until one differs, which the loop below then finds
+  size_t length = strnlen(s1, n);
+  length = length < STRCASECMP_BLOCK ? 0u : strnlen(s2, length);
+  while (length >= STRCASECMP_BLOCK && _block_equal(s1, s2)) {
+    s1 += STRCASECMP_BLOCK;
+    s2 += STRCASECMP_BLOCK;
+    n -= STRCASECMP_BLOCK;
+    length -= STRCASECMP_BLOCK;
+  }
+#endif
+  for (; n > 0; --n, ++s1, ++s2) {
+    int c1 = _fold((unsigned char)*s1);
+    int c2 = _fold((unsigned char)*s2);
+    if (c1 != c2 || '\0' == c1) {
+      return c1 - c2;
+    }
+  }
+  return 0;
+}
+
 int
 rcutils_strcasecmp(
   const char * s1,
@@ -31,11 +105,7 @@ rcutils_strcasecmp(
   if (s1 == NULL || s2 == NULL || value == NULL) {
     return -1;
   }
-#ifndef _WIN32
-  *value = strcasecmp(s1, s2);
-#else
-  *value = _stricmp(s1, s2);
-#endif
+  *value = _casecmp(s1, s2, SIZE_MAX);
   return 0;
 }
 
@@ -49,12 +119,67 @@ rcutils_strncasecmp(
   if (s1 == NULL || s2 == NULL || value == NULL) {
     return -1;
   }
-#ifndef _WIN32
-  *value = strncasecmp(s1, s2, n);
+  *value = _casecmp(s1, s2, n);
+  return 0;
+}
+
+// Returns the word with its ASCII upper case letters folded to lower case
+static inline uint64_t
+_fold_word(uint64_t word)
+{
+  const uint64_t ones = 0x0101010101010101ull;
+  const uint64_t high_bits = ones << 7;
+  // The high bit of each byte is set in at_least_a if its low 7 bits are 'A' or above,
+  // and in above_z if they are above 'Z'
+  uint64_t low_bits = word & ~high_bits;
+  uint64_t at_least_a = low_bits + (0x80 - 'A') * ones;
+  uint64_t above_z = low_bits + (0x80 - 'Z' - 1) * ones;
+  uint64_t upper = at_least_a & ~above_z & ~word & high_bits;
+  return word | (upper >> 2);
+}
+
+// Mixes the bits of a and b into a 64 bit value, as in rcutils_hash_map_bytes_hash()
+static inline uint64_t
+_mix(uint64_t a, uint64_t b)
+{
+#if defined(__SIZEOF_INT128__)
+  __uint128_t product = (__uint128_t)a * b;
+  return (uint64_t)product ^ (uint64_t)(product >> 64);
 #else
-  *value = _strnicmp(s1, s2, n);
+  uint64_t product = a * b;
+  return product ^ (product >> 29);
 #endif
-  return 0;
+}
+
+size_t
+rcutils_strcasecmp_hash(const char * str)
+{
+  if (NULL == str) {
+    return 0u;
+  }
+  size_t length = strlen(str);
+  uint64_t hash = 0xa0761d6478bd642full ^ (uint64_t)length;
+  while (length > 0) {
+    uint64_t word = 0u;
+    size_t count = length < sizeof(word) ? length : sizeof(word);
+    memcpy(&word, str, count);
+    hash = _mix(hash ^ _fold_word(word), 0xe7037ed1a0b428dbull);
+    str += count;
+    length -= count;
+  }
+  return (size_t)_mix(hash, 0x8ebc6af09c88c6e3ull);
+}
+
+size_t
+rcutils_strcasecmp_hash_func(const void * key_str)
+{
+  return rcutils_strcasecmp_hash(*(const char **)key_str);
+}
+
+int
+rcutils_strcasecmp_cmp_func(const void * val1, const void * val2)
+{
+  return _casecmp(*(const char **)val1, *(const char **)val2, SIZE_MAX);
 }
 
 #ifdef __cplusplus
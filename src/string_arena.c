@@ -0,0 +1,175 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "./string_arena.h"
+
+#include <stdint.h>
+#include <string.h>
+
+typedef struct rcutils_string_arena_chunk_t
+{
+  struct rcutils_string_arena_chunk_t * next;
+  // The number of bytes of data, and how many of them hold strings
+  size_t size;
+  size_t used;
+  char data[];
+} rcutils_string_arena_chunk_t;
+
+rcutils_string_arena_t *
+rcutils_string_arena_create(size_t chunk_size, const rcutils_allocator_t * allocator)
+{
+  rcutils_string_arena_t * arena =
+    allocator->allocate(sizeof(rcutils_string_arena_t), allocator->state);
+  if (NULL == arena) {
+    return NULL;
+  }
+  arena->chunks = NULL;
+  arena->chunk_size = 0 == chunk_size ? RCUTILS_STRING_ARENA_DEFAULT_CHUNK_SIZE : chunk_size;
+  arena->allocator = *allocator;
+  return arena;
+}
+
+// Deallocates the chunk and the ones after it
+static void
+rcutils_string_arena_deallocate_chunks(
+  rcutils_string_arena_t * arena, rcutils_string_arena_chunk_t * chunk)
+{
+  while (NULL != chunk) {
+    rcutils_string_arena_chunk_t * next = chunk->next;
+    arena->allocator.deallocate(chunk, arena->allocator.state);
+    chunk = next;
+  }
+}
+
+void
+rcutils_string_arena_destroy(rcutils_string_arena_t * arena)
+{
+  if (NULL == arena) {
+    return;
+  }
+  rcutils_string_arena_deallocate_chunks(arena, arena->chunks);
+  arena->allocator.deallocate(arena, arena->allocator.state);
+}
+
+void
+rcutils_string_arena_reset(rcutils_string_arena_t * arena)
+{
+  if (NULL == arena->chunks) {
+    return;
+  }
+  rcutils_string_arena_deallocate_chunks(arena, arena->chunks->next);
+  arena->chunks->next = NULL;
+  arena->chunks->used = 0;
+}
+
+// Allocates a chunk of at least size bytes, or of the chunk size of the arena
+static rcutils_string_arena_chunk_t *
+rcutils_string_arena_allocate_chunk(rcutils_string_arena_t * arena, size_t size)
+{
+  size_t chunk_size = size > arena->chunk_size ? size : arena->chunk_size;
+  if (chunk_size > SIZE_MAX - sizeof(rcutils_string_arena_chunk_t)) {
+    return NULL;
+  }
+  rcutils_string_arena_chunk_t * chunk = arena->allocator.allocate(
+    sizeof(rcutils_string_arena_chunk_t) + chunk_size, arena->allocator.state);
+  if (NULL == chunk) {
+    return NULL;
+  }
+  chunk->size = chunk_size;
+  chunk->used = 0;
+  return chunk;
+}
+
+char *
+rcutils_string_arena_strndup(rcutils_string_arena_t * arena, const char * str, size_t length)
+{
+  if (length >= SIZE_MAX - sizeof(rcutils_string_arena_chunk_t)) {
+    return NULL;
+  }
+  size_t size = length + 1;
+  rcutils_string_arena_chunk_t * chunk = arena->chunks;
+  if (NULL == chunk || chunk->size - chunk->used < size) {
+    // Strings larger than a chunk get a chunk of their own
+    chunk = rcutils_string_arena_allocate_chunk(arena, size);
+    if (NULL == chunk) {
+      return NULL;
+    }
+    if (NULL != arena->chunks && size > arena->chunk_size) {
+      // Keep copying the next strings into the space left in the current chunk
+      chunk->next = arena->chunks->next;
+      arena->chunks->next = chunk;
+    } else {
+      chunk->next = arena->chunks;
+      arena->chunks = chunk;
+    }
+  }
+  char * copy = chunk->data + chunk->used;
+  memcpy(copy, str, length);
+  copy[length] = '\0';
+  chunk->used += size;
+  return copy;
+}
+
+bool
+rcutils_string_arena_owns(const rcutils_string_arena_t * arena, const void * pointer)
+{
+  if (NULL == arena || NULL == pointer) {
+    return false;
+  }
+  uintptr_t address = (uintptr_t)pointer;
+  const rcutils_string_arena_chunk_t * chunk = arena->chunks;
+  for (; NULL != chunk; chunk = chunk->next) {
+    uintptr_t data = (uintptr_t)chunk->data;
+    if (address >= data && address < data + chunk->used) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool
+rcutils_string_arena_reserve(rcutils_string_arena_t * arena, size_t size)
+{
+  if (0 == size || (NULL != arena->chunks && arena->chunks->size - arena->chunks->used >= size)) {
+    return true;
+  }
+  // The strings are copied into the first chunk
+  rcutils_string_arena_chunk_t * chunk = rcutils_string_arena_allocate_chunk(arena, size);
+  if (NULL == chunk) {
+    return false;
+  }
+  chunk->next = arena->chunks;
+  arena->chunks = chunk;
+  return true;
+}
+
+size_t
+rcutils_string_arena_get_memory_usage(const rcutils_string_arena_t * arena)
+{
+  size_t bytes = sizeof(rcutils_string_arena_t);
+  const rcutils_string_arena_chunk_t * chunk = arena->chunks;
+  for (; NULL != chunk; chunk = chunk->next) {
+    bytes += sizeof(rcutils_string_arena_chunk_t) + chunk->size;
+  }
+  return bytes;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,73 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef STRING_ARENA_H_
+#define STRING_ARENA_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "rcutils/allocator.h"
+#include "rcutils/types/rcutils_ret.h"
+
+// The size of the chunks of an arena when none is given.
+#define RCUTILS_STRING_ARENA_DEFAULT_CHUNK_SIZE ((size_t)4096)
+
+struct rcutils_string_arena_chunk_t;
+
+// Storage for strings which are freed all at once, in chunks allocated with the allocator.
+typedef struct rcutils_string_arena_t
+{
+  // The most recently allocated chunk, which strings are copied into, followed by the others.
+  struct rcutils_string_arena_chunk_t * chunks;
+  size_t chunk_size;
+  rcutils_allocator_t allocator;
+} rcutils_string_arena_t;
+
+// Allocates an arena with chunks of chunk_size bytes, or the default size if 0.
+// No chunk is allocated until a string is copied into it.
+rcutils_string_arena_t * rcutils_string_arena_create(
+  size_t chunk_size, const rcutils_allocator_t * allocator);
+
+// Deallocates the arena and every string copied into it, does nothing if arena is NULL.
+void rcutils_string_arena_destroy(rcutils_string_arena_t * arena);
+
+// Deallocates every string copied into the arena, keeping the last chunk for new strings.
+void rcutils_string_arena_reset(rcutils_string_arena_t * arena);
+
+// Copies the first length characters of str into the arena, followed by a null character.
+// Returns NULL if allocating a new chunk fails.
+char * rcutils_string_arena_strndup(
+  rcutils_string_arena_t * arena, const char * str, size_t length);
+
+// Returns true if the pointer points into a string copied into the arena, which may be NULL.
+bool rcutils_string_arena_owns(const rcutils_string_arena_t * arena, const void * pointer);
+
+// Makes room for size bytes of strings in the current chunk, so that copying them doesn't fail.
+// Returns false if allocating a new chunk fails.
+bool rcutils_string_arena_reserve(rcutils_string_arena_t * arena, size_t size);
+
+// Returns the number of bytes allocated for the arena and its chunks.
+size_t rcutils_string_arena_get_memory_usage(const rcutils_string_arena_t * arena);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // STRING_ARENA_H_
@@ -17,11 +17,14 @@ extern "C"
 {
 #endif
 
+#include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include "./string_arena.h"
 #include "rcutils/allocator.h"
 #include "rcutils/error_handling.h"
+#include "rcutils/strdup.h"
 #include "rcutils/types/string_array.h"
 #include "rcutils/types/rcutils_ret.h"
 
@@ -31,6 +34,7 @@ rcutils_get_zero_initialized_string_array(void)
   static rcutils_string_array_t array = {
     .size = 0,
     .data = NULL,
+    .arena = NULL,
   };
   array.allocator = rcutils_get_zero_initialized_allocator();
   return array;
@@ -60,6 +64,66 @@ rcutils_string_array_init(
     return RCUTILS_RET_BAD_ALLOC;
   }
   string_array->allocator = *allocator;
+  string_array->arena = NULL;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_string_array_init_with_arena(
+  rcutils_string_array_t * string_array,
+  size_t size,
+  const rcutils_allocator_t * allocator,
+  size_t arena_chunk_size)
+{
+  RCUTILS_CAN_RETURN_WITH_ERROR_OF(RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CAN_RETURN_WITH_ERROR_OF(RCUTILS_RET_BAD_ALLOC);
+
+  rcutils_ret_t ret = rcutils_string_array_init(string_array, size, allocator);
+  if (RCUTILS_RET_OK != ret) {
+    // rcutils_string_array_init should have already set an error message
+    return ret;
+  }
+  string_array->arena = rcutils_string_arena_create(arena_chunk_size, allocator);
+  if (NULL == string_array->arena) {
+    allocator->deallocate(string_array->data, allocator->state);
+    string_array->data = NULL;
+    string_array->size = 0;
+    RCUTILS_SET_ERROR_MSG("failed to allocate string array arena");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_string_array_set(
+  rcutils_string_array_t * string_array,
+  size_t index,
+  const char * str)
+{
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    string_array, "string_array is null", return RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    str, "str is null", return RCUTILS_RET_INVALID_ARGUMENT);
+  if (index >= string_array->size) {
+    RCUTILS_SET_ERROR_MSG("index is out of bounds");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  rcutils_allocator_t * allocator = &string_array->allocator;
+  RCUTILS_CHECK_ALLOCATOR_WITH_MSG(
+    allocator, "allocator is invalid", return RCUTILS_RET_INVALID_ARGUMENT);
+
+  char * copy = NULL == string_array->arena ?
+    rcutils_strdup(str, *allocator) :
+    rcutils_string_arena_strndup(string_array->arena, str, strlen(str));
+  if (NULL == copy) {
+    RCUTILS_SET_ERROR_MSG("failed to allocate string");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  char * previous = string_array->data[index];
+  if (!rcutils_string_arena_owns(string_array->arena, previous)) {
+    allocator->deallocate(previous, allocator->state);
+  }
+  string_array->data[index] = copy;
   return RCUTILS_RET_OK;
 }
 
@@ -84,12 +148,16 @@ rcutils_string_array_fini(rcutils_string_array_t * string_array)
   }
   size_t i;
   for (i = 0; i < string_array->size; ++i) {
-    allocator->deallocate(string_array->data[i], allocator->state);
+    if (!rcutils_string_arena_owns(string_array->arena, string_array->data[i])) {
+      allocator->deallocate(string_array->data[i], allocator->state);
+    }
     string_array->data[i] = NULL;
   }
   allocator->deallocate(string_array->data, allocator->state);
   string_array->data = NULL;
   string_array->size = 0;
+  rcutils_string_arena_destroy(string_array->arena);
+  string_array->arena = NULL;
 
   return RCUTILS_RET_OK;
 }
@@ -170,6 +238,12 @@ rcutils_string_array_resize(
     memcpy(
       to_reclaim.data, &string_array->data[new_size],
       to_reclaim.size * sizeof(char *));
+    // the strings in the arena are only deallocated with the array
+    for (size_t i = 0; i < to_reclaim.size; ++i) {
+      if (rcutils_string_arena_owns(string_array->arena, to_reclaim.data[i])) {
+        to_reclaim.data[i] = NULL;
+      }
+    }
   }
 
   char ** new_data = allocator->reallocate(
@@ -211,6 +285,152 @@ rcutils_string_array_sort_compare(const void * lhs, const void * rhs)
   return strcmp(left, right);
 }
 
+// Ranges smaller than this are sorted with an insertion sort.
+#define _MULTIKEY_INSERTION_SORT_THRESHOLD 16u
+
+static inline unsigned char
+_char_at(char * const * strings, size_t index, size_t depth)
+{
+  return (unsigned char)strings[index][depth];
+}
+
+static inline void
+_swap_strings(char ** strings, size_t a, size_t b)
+{
+  char * tmp = strings[a];
+  strings[a] = strings[b];
+  strings[b] = tmp;
+}
+
+// Returns the index of the string with the median of the characters at depth of the three.
+static size_t
+_median_of_three(char * const * strings, size_t a, size_t b, size_t c, size_t depth)
+{
+  unsigned char x = _char_at(strings, a, depth);
+  unsigned char y = _char_at(strings, b, depth);
+  unsigned char z = _char_at(strings, c, depth);
+  if (x < y) {
+    return y < z ? b : (x < z ? c : a);
+  }
+  return y > z ? b : (x > z ? c : a);
+}
+
+// Returns the length of the prefix shared by the strings from depth on.
+static size_t
+_common_prefix_length(char * const * strings, size_t count, size_t depth)
+{
+  const char * first = strings[0] + depth;
+  size_t length = strlen(first);
+  for (size_t i = 1; i < count && length > 0u; ++i) {
+    const char * other = strings[i] + depth;
+    size_t j = 0;
+    while (j < length && first[j] == other[j]) {
+      ++j;
+    }
+    length = j;
+  }
+  return length;
+}
+
+// Sorts the strings, which share their first depth characters, with a multikey quicksort.
+// The recursion goes into the two smaller of the three partitions, so its depth is logarithmic.
+static void
+_multikey_sort(char ** strings, size_t count, size_t depth)
+{
+  while (count > 1) {
+    if (count < _MULTIKEY_INSERTION_SORT_THRESHOLD) {
+      for (size_t i = 1; i < count; ++i) {
+        for (size_t j = i; j > 0 && strcmp(strings[j] + depth, strings[j - 1] + depth) < 0; --j) {
+          _swap_strings(strings, j, j - 1);
+        }
+      }
+      return;
+    }
+
+    size_t pivot = _median_of_three(strings, 0, count / 2, count - 1, depth);
+    if (count > 128u) {
+      size_t eighth = count / 8;
+      pivot = _median_of_three(
+        strings,
+        _median_of_three(strings, 0, eighth, 2 * eighth, depth),
+        pivot,
+        _median_of_three(strings, count - 1 - 2 * eighth, count - 1 - eighth, count - 1, depth),
+        depth);
+    }
+    const unsigned char value = _char_at(strings, pivot, depth);
+
+    // [0, less) have a smaller character, [less, greater) the same, [greater, count) a larger
+    size_t less = 0;
+    size_t greater = count;
+    size_t i = 0;
+    while (i < greater) {
+      unsigned char c = _char_at(strings, i, depth);
+      if (c < value) {
+        _swap_strings(strings, less++, i++);
+      } else if (c > value) {
+        _swap_strings(strings, i, --greater);
+      } else {
+        ++i;
+      }
+    }
+
+    if (0u == less && count == greater) {
+      if ('\0' == value) {
+        return;
+      }
+      // Skip all the characters shared by the strings at once, rather than one pass each
+      depth += _common_prefix_length(strings, count, depth);
+      continue;
+    }
+
+    size_t equal_count = greater - less;
+    size_t greater_count = count - greater;
+    // The strings equal at depth are already sorted if they all end there
+    bool equal_done = '\0' == value;
+    if (equal_done || (equal_count <= less && equal_count <= greater_count)) {
+      if (!equal_done) {
+        _multikey_sort(strings + less, equal_count, depth + 1);
+      }
+      if (less < greater_count) {
+        _multikey_sort(strings, less, depth);
+        strings += greater;
+        count = greater_count;
+      } else {
+        _multikey_sort(strings + greater, greater_count, depth);
+        count = less;
+      }
+    } else {
+      _multikey_sort(strings, less, depth);
+      _multikey_sort(strings + greater, greater_count, depth);
+      strings += less;
+      count = equal_count;
+      ++depth;
+    }
+  }
+}
+
+rcutils_ret_t
+rcutils_string_array_sort_multikey(rcutils_string_array_t * string_array)
+{
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    string_array, "string_array is null", return RCUTILS_RET_INVALID_ARGUMENT);
+  if (0 == string_array->size) {
+    return RCUTILS_RET_OK;
+  }
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    string_array->data, "string_array->data is null", return RCUTILS_RET_INVALID_ARGUMENT);
+
+  // Move the empty entries to the end
+  size_t count = 0;
+  for (size_t i = 0; i < string_array->size; ++i) {
+    if (NULL != string_array->data[i]) {
+      _swap_strings(string_array->data, count++, i);
+    }
+  }
+  _multikey_sort(string_array->data, count, 0);
+  return RCUTILS_RET_OK;
+}
+
 #ifdef __cplusplus
 }
 #endif
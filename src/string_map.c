@@ -25,19 +25,87 @@ extern "C"
 #include <string.h>
 
 #include "./common.h"
+#include "./string_arena.h"
 #include "rcutils/strdup.h"
 #include "rcutils/format_string.h"
+#include "rcutils/types/hash_map.h"
 #include "rcutils/types/rcutils_ret.h"
 
 typedef struct rcutils_string_map_impl_t
 {
   char ** keys;
   char ** values;
+  // The hash of each key
+  size_t * key_hashes;
+  // The open addressing hash index over the keys, with linear probing.
+  // Each entry is the index of a key plus one, or 0 if it's empty.
+  size_t * index;
+  // The number of entries of the index minus one, it's a power of two at least twice the
+  // capacity, or 0 with a capacity of 0
+  size_t index_mask;
+  // No key below this index is free
+  size_t free_hint;
+  // The arena the keys and values are copied into, or NULL if they're allocated one by one
+  rcutils_string_arena_t * arena;
   size_t capacity;
   size_t size;
   rcutils_allocator_t allocator;
 } rcutils_string_map_impl_t;
 
+static size_t
+__hash_key(const char * key, size_t key_length)
+{
+  return rcutils_hash_map_bytes_hash(key, key_length);
+}
+
+// Adds the key at key_index to the index
+static void
+__index_insert(rcutils_string_map_impl_t * string_map_impl, size_t key_index)
+{
+  size_t position = string_map_impl->key_hashes[key_index] & string_map_impl->index_mask;
+  while (0 != string_map_impl->index[position]) {
+    position = (position + 1) & string_map_impl->index_mask;
+  }
+  string_map_impl->index[position] = key_index + 1;
+}
+
+// Indexes the keys below key_count again
+static void
+__index_keys(rcutils_string_map_impl_t * string_map_impl, size_t key_count)
+{
+  memset(string_map_impl->index, 0, (string_map_impl->index_mask + 1) * sizeof(size_t));
+  size_t i = 0;
+  for (; i < key_count; ++i) {
+    if (NULL != string_map_impl->keys[i]) {
+      __index_insert(string_map_impl, i);
+    }
+  }
+}
+
+// Removes the entry at position from the index, moving back the entries probed past it
+static void
+__index_remove(rcutils_string_map_impl_t * string_map_impl, size_t position)
+{
+  size_t * index = string_map_impl->index;
+  size_t mask = string_map_impl->index_mask;
+  size_t next = position;
+  while (true) {
+    next = (next + 1) & mask;
+    if (0 == index[next]) {
+      break;
+    }
+    size_t home = string_map_impl->key_hashes[index[next] - 1] & mask;
+    // The entry stays if its home position is cyclically in (position, next]
+    bool stays = position <= next ?
+      (position < home && home <= next) : (position < home || home <= next);
+    if (!stays) {
+      index[position] = index[next];
+      position = next;
+    }
+  }
+  index[position] = 0;
+}
+
 rcutils_string_map_t
 rcutils_get_zero_initialized_string_map(void)
 {
@@ -66,6 +134,11 @@ rcutils_string_map_init(
   }
   string_map->impl->keys = NULL;
   string_map->impl->values = NULL;
+  string_map->impl->key_hashes = NULL;
+  string_map->impl->index = NULL;
+  string_map->impl->index_mask = 0;
+  string_map->impl->free_hint = 0;
+  string_map->impl->arena = NULL;
   string_map->impl->capacity = 0;
   string_map->impl->size = 0;
   string_map->impl->allocator = allocator;
@@ -79,6 +152,29 @@ rcutils_string_map_init(
   return RCUTILS_RET_OK;
 }
 
+rcutils_ret_t
+rcutils_string_map_init_with_arena(
+  rcutils_string_map_t * string_map,
+  size_t initial_capacity,
+  rcutils_allocator_t allocator,
+  size_t arena_chunk_size)
+{
+  rcutils_ret_t ret = rcutils_string_map_init(string_map, initial_capacity, allocator);
+  if (ret != RCUTILS_RET_OK) {
+    // error message is already set
+    return ret;
+  }
+  string_map->impl->arena = rcutils_string_arena_create(arena_chunk_size, &allocator);
+  if (NULL == string_map->impl->arena) {
+    if (rcutils_string_map_fini(string_map) != RCUTILS_RET_OK) {
+      RCUTILS_SAFE_FWRITE_TO_STDERR("failed to finalize string map during error handling\n");
+    }
+    RCUTILS_SET_ERROR_MSG("failed to allocate memory for string map arena");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  return RCUTILS_RET_OK;
+}
+
 rcutils_ret_t
 rcutils_string_map_fini(rcutils_string_map_t * string_map)
 {
@@ -98,6 +194,7 @@ rcutils_string_map_fini(rcutils_string_map_t * string_map)
   }
   rcutils_allocator_t allocator = string_map->impl->allocator;
 
+  rcutils_string_arena_destroy(string_map->impl->arena);
   allocator.deallocate(string_map->impl, allocator.state);
   string_map->impl = NULL;
 
@@ -151,35 +248,93 @@ rcutils_string_map_reserve(rcutils_string_map_t * string_map, size_t capacity)
     string_map->impl->keys = NULL;
     allocator.deallocate(string_map->impl->values, allocator.state);
     string_map->impl->values = NULL;
+    allocator.deallocate(string_map->impl->key_hashes, allocator.state);
+    string_map->impl->key_hashes = NULL;
+    allocator.deallocate(string_map->impl->index, allocator.state);
+    string_map->impl->index = NULL;
+    string_map->impl->index_mask = 0;
+    string_map->impl->free_hint = 0;
     // falls through to normal function end
   } else {
     // if the capacity non-zero and different, use realloc to increase/shrink the size
     // note that realloc when the pointer is NULL is the same as malloc
     // note also that realloc will shrink the space if needed
 
+    // the index has a power of two entries, at least twice the capacity, so probing is short
+    size_t index_size = 2;
+    while (index_size < 2 * capacity && index_size <= SIZE_MAX / sizeof(size_t) / 2) {
+      index_size *= 2;
+    }
+
     // ensure that reallocate won't overflow capacity
-    if (capacity > (SIZE_MAX / sizeof(char *))) {
+    if (capacity > (SIZE_MAX / sizeof(size_t) / 2) || index_size < 2 * capacity) {
       RCUTILS_SET_ERROR_MSG("requested capacity for string_map too large");
       return RCUTILS_RET_BAD_ALLOC;
     }
 
-    // resize the keys, assigning the result only if it succeeds
+    // allocate the new index first, it's rebuilt once the keys are resized
+    size_t * new_index =
+      allocator.zero_allocate(index_size, sizeof(size_t), allocator.state);
+    if (NULL == new_index) {
+      RCUTILS_SET_ERROR_MSG("failed to allocate memory for string_map index");
+      return RCUTILS_RET_BAD_ALLOC;
+    }
+
+    // move the keys and values which wouldn't fit anymore into the free space below,
+    // keeping their order
+    if (capacity < string_map->impl->capacity) {
+      size_t free_index = 0;
+      for (size_t i = 0; i < string_map->impl->capacity; ++i) {
+        if (NULL != string_map->impl->keys[i]) {
+          string_map->impl->keys[free_index] = string_map->impl->keys[i];
+          string_map->impl->values[free_index] = string_map->impl->values[i];
+          string_map->impl->key_hashes[free_index] = string_map->impl->key_hashes[i];
+          if (free_index != i) {
+            string_map->impl->keys[i] = NULL;
+            string_map->impl->values[i] = NULL;
+          }
+          free_index++;
+        }
+      }
+      string_map->impl->free_hint = free_index;
+    }
+
+    // resize the keys, assigning the result only if it succeeds,
+    // if shrinking fails the larger array is kept
     char ** new_keys =
       allocator.reallocate(string_map->impl->keys, capacity * sizeof(char *), allocator.state);
-    if (NULL == new_keys) {
+    if (NULL == new_keys && capacity > string_map->impl->capacity) {
+      allocator.deallocate(new_index, allocator.state);
       RCUTILS_SET_ERROR_MSG("failed to allocate memory for string_map keys");
       return RCUTILS_RET_BAD_ALLOC;
     }
-    string_map->impl->keys = new_keys;
+    if (NULL != new_keys) {
+      string_map->impl->keys = new_keys;
+    }
 
     // resize the values, assigning the result only if it succeeds
     char ** new_values =
       allocator.reallocate(string_map->impl->values, capacity * sizeof(char *), allocator.state);
-    if (NULL == new_values) {
+    if (NULL == new_values && capacity > string_map->impl->capacity) {
+      allocator.deallocate(new_index, allocator.state);
       RCUTILS_SET_ERROR_MSG("failed to allocate memory for string_map values");
       return RCUTILS_RET_BAD_ALLOC;
     }
-    string_map->impl->values = new_values;
+    if (NULL != new_values) {
+      string_map->impl->values = new_values;
+    }
+
+    // resize the hashes of the keys, assigning the result only if it succeeds
+    size_t * new_key_hashes = allocator.reallocate(
+      string_map->impl->key_hashes, capacity * sizeof(size_t), allocator.state);
+    if (NULL == new_key_hashes && capacity > string_map->impl->capacity) {
+      allocator.deallocate(new_index, allocator.state);
+      RCUTILS_SET_ERROR_MSG("failed to allocate memory for string_map key hashes");
+      return RCUTILS_RET_BAD_ALLOC;
+    }
+    if (NULL != new_key_hashes) {
+      string_map->impl->key_hashes = new_key_hashes;
+    }
 
     // zero out the new memory, if there is any (expanded instead of shrunk)
     if (capacity > string_map->impl->capacity) {
@@ -189,19 +344,109 @@ rcutils_string_map_reserve(rcutils_string_map_t * string_map, size_t capacity)
         string_map->impl->values[i] = NULL;
       }
     }
+
+    // index the keys again with the new mask
+    allocator.deallocate(string_map->impl->index, allocator.state);
+    string_map->impl->index = new_index;
+    string_map->impl->index_mask = index_size - 1;
+    __index_keys(
+      string_map->impl,
+      capacity < string_map->impl->capacity ? capacity : string_map->impl->capacity);
     // falls through to normal function end
   }
   string_map->impl->capacity = capacity;
   return RCUTILS_RET_OK;
 }
 
+// Copies the keys and values into a new arena, dropping the strings which were removed
+static rcutils_ret_t
+__compact_arena(rcutils_string_map_impl_t * string_map_impl)
+{
+  size_t bytes = 0;
+  size_t i = 0;
+  for (; i < string_map_impl->capacity; ++i) {
+    if (NULL != string_map_impl->keys[i]) {
+      bytes += strlen(string_map_impl->keys[i]) + strlen(string_map_impl->values[i]) + 2;
+    }
+  }
+  rcutils_string_arena_t * arena = rcutils_string_arena_create(
+    string_map_impl->arena->chunk_size, &string_map_impl->allocator);
+  // With the room for every string reserved, copying them doesn't fail halfway
+  if (NULL == arena || !rcutils_string_arena_reserve(arena, bytes)) {
+    rcutils_string_arena_destroy(arena);
+    RCUTILS_SET_ERROR_MSG("failed to allocate memory for string map arena");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  for (i = 0; i < string_map_impl->capacity; ++i) {
+    if (NULL != string_map_impl->keys[i]) {
+      char * key = string_map_impl->keys[i];
+      char * value = string_map_impl->values[i];
+      string_map_impl->keys[i] = rcutils_string_arena_strndup(arena, key, strlen(key));
+      string_map_impl->values[i] = rcutils_string_arena_strndup(arena, value, strlen(value));
+    }
+  }
+  rcutils_string_arena_destroy(string_map_impl->arena);
+  string_map_impl->arena = arena;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_string_map_shrink_to_fit(rcutils_string_map_t * string_map)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(string_map, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    string_map->impl, "invalid string map", return RCUTILS_RET_STRING_MAP_INVALID);
+  if (NULL != string_map->impl->arena) {
+    rcutils_ret_t ret = __compact_arena(string_map->impl);
+    if (ret != RCUTILS_RET_OK) {
+      // error message already set
+      return ret;
+    }
+  }
+  return rcutils_string_map_reserve(string_map, string_map->impl->size);
+}
+
+rcutils_ret_t
+rcutils_string_map_get_memory_usage(const rcutils_string_map_t * string_map, size_t * bytes)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(string_map, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    string_map->impl, "invalid string map", return RCUTILS_RET_STRING_MAP_INVALID);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(bytes, RCUTILS_RET_INVALID_ARGUMENT);
+  const rcutils_string_map_impl_t * string_map_impl = string_map->impl;
+  // the keys, values and hashes of the keys are in parallel arrays
+  size_t total = sizeof(rcutils_string_map_impl_t) +
+    string_map_impl->capacity * (2 * sizeof(char *) + sizeof(size_t));
+  if (NULL != string_map_impl->index) {
+    total += (string_map_impl->index_mask + 1) * sizeof(size_t);
+  }
+  if (NULL != string_map_impl->arena) {
+    total += rcutils_string_arena_get_memory_usage(string_map_impl->arena);
+  } else {
+    size_t i = 0;
+    for (; i < string_map_impl->capacity; ++i) {
+      if (NULL != string_map_impl->keys[i]) {
+        total += strlen(string_map_impl->keys[i]) + strlen(string_map_impl->values[i]) + 2;
+      }
+    }
+  }
+  *bytes = total;
+  return RCUTILS_RET_OK;
+}
+
 static void
 __remove_key_and_value_at_index(rcutils_string_map_impl_t * string_map_impl, size_t index)
 {
   rcutils_allocator_t allocator = string_map_impl->allocator;
-  allocator.deallocate(string_map_impl->keys[index], allocator.state);
+  if (index < string_map_impl->free_hint) {
+    string_map_impl->free_hint = index;
+  }
+  // the strings in the arena are only deallocated on clear or fini
+  if (NULL == string_map_impl->arena) {
+    allocator.deallocate(string_map_impl->keys[index], allocator.state);
+    allocator.deallocate(string_map_impl->values[index], allocator.state);
+  }
   string_map_impl->keys[index] = NULL;
-  allocator.deallocate(string_map_impl->values[index], allocator.state);
   string_map_impl->values[index] = NULL;
   string_map_impl->size--;
 }
@@ -218,6 +463,12 @@ rcutils_string_map_clear(rcutils_string_map_t * string_map)
       __remove_key_and_value_at_index(string_map->impl, i);
     }
   }
+  if (NULL != string_map->impl->index) {
+    memset(string_map->impl->index, 0, (string_map->impl->index_mask + 1) * sizeof(size_t));
+  }
+  if (NULL != string_map->impl->arena) {
+    rcutils_string_arena_reset(string_map->impl->arena);
+  }
   return RCUTILS_RET_OK;
 }
 
@@ -246,30 +497,52 @@ rcutils_string_map_set(rcutils_string_map_t * string_map, const char * key, cons
   return ret;
 }
 
+// Finds the key among the first key_length characters of key, or its null terminated part,
+// setting index to the index of the key and position to its entry in the hash index
 static bool
-__get_index_of_key_if_exists(
-  rcutils_string_map_impl_t * string_map_impl,
+__find_key(
+  const rcutils_string_map_impl_t * string_map_impl,
   const char * key,
   size_t key_length,
-  size_t * index)
+  size_t key_hash,
+  size_t * index,
+  size_t * position)
 {
-  size_t i = 0;
-  for (; i < string_map_impl->capacity; ++i) {
-    if (NULL == string_map_impl->keys[i]) {
-      continue;
-    }
-    size_t cmp_count = strlen(string_map_impl->keys[i]);
-    if (key_length > cmp_count) {
-      cmp_count = key_length;
-    }
-    if (strncmp(key, string_map_impl->keys[i], cmp_count) == 0) {
-      *index = i;
+  if (0 == string_map_impl->capacity) {
+    return false;
+  }
+  size_t i = key_hash & string_map_impl->index_mask;
+  for (; 0 != string_map_impl->index[i]; i = (i + 1) & string_map_impl->index_mask) {
+    size_t key_index = string_map_impl->index[i] - 1;
+    const char * stored_key = string_map_impl->keys[key_index];
+    if (string_map_impl->key_hashes[key_index] == key_hash &&
+      strncmp(key, stored_key, key_length) == 0 && '\0' == stored_key[key_length])
+    {
+      *index = key_index;
+      *position = i;
       return true;
     }
   }
   return false;
 }
 
+static bool
+__get_index_of_key_if_exists(
+  const rcutils_string_map_impl_t * string_map_impl,
+  const char * key,
+  size_t key_length,
+  size_t * index,
+  size_t * position)
+{
+  // The key ends at its first null character, if any
+  const char * key_end = memchr(key, '\0', key_length);
+  if (NULL != key_end) {
+    key_length = (size_t)(key_end - key);
+  }
+  return __find_key(
+    string_map_impl, key, key_length, __hash_key(key, key_length), index, position);
+}
+
 rcutils_ret_t
 rcutils_string_map_set_no_resize(
   rcutils_string_map_t * string_map,
@@ -282,47 +555,62 @@ rcutils_string_map_set_no_resize(
   RCUTILS_CHECK_ARGUMENT_FOR_NULL(key, RCUTILS_RET_INVALID_ARGUMENT);
   RCUTILS_CHECK_ARGUMENT_FOR_NULL(value, RCUTILS_RET_INVALID_ARGUMENT);
   rcutils_allocator_t allocator = string_map->impl->allocator;
-  size_t key_index;
+  size_t key_index, position;
+  size_t key_length = strlen(key);
+  size_t key_hash = __hash_key(key, key_length);
   bool should_free_key_on_error = false;
-  bool key_exists = __get_index_of_key_if_exists(string_map->impl, key, strlen(key), &key_index);
+  bool key_exists = __find_key(
+    string_map->impl, key, key_length, key_hash, &key_index, &position);
   if (!key_exists) {
     // create space for, and store the key if it doesn't exist yet
     assert(string_map->impl->size <= string_map->impl->capacity);  // defensive, should not happen
     if (string_map->impl->size == string_map->impl->capacity) {
       return RCUTILS_RET_NOT_ENOUGH_SPACE;
     }
-    for (key_index = 0; key_index < string_map->impl->capacity; ++key_index) {
+    for (key_index = string_map->impl->free_hint; key_index < string_map->impl->capacity;
+      ++key_index)
+    {
       if (NULL == string_map->impl->keys[key_index]) {
         break;
       }
     }
     assert(key_index < string_map->impl->capacity);  // defensive, this should not happen
-    string_map->impl->keys[key_index] = rcutils_strdup(key, allocator);
+    string_map->impl->free_hint = key_index;
+    string_map->impl->keys[key_index] = NULL == string_map->impl->arena ?
+      rcutils_strdup(key, allocator) :
+      rcutils_string_arena_strndup(string_map->impl->arena, key, key_length);
     if (NULL == string_map->impl->keys[key_index]) {
       RCUTILS_SET_ERROR_MSG("failed to allocate memory for key");
       return RCUTILS_RET_BAD_ALLOC;
     }
+    string_map->impl->key_hashes[key_index] = key_hash;
     should_free_key_on_error = true;
   }
   // at this point the key is in the map, waiting for the value to set/overwritten
   char * original_value = string_map->impl->values[key_index];
-  char * new_value = rcutils_strdup(value, allocator);
+  char * new_value = NULL == string_map->impl->arena ?
+    rcutils_strdup(value, allocator) :
+    rcutils_string_arena_strndup(string_map->impl->arena, value, strlen(value));
   if (NULL == new_value) {
     RCUTILS_SET_ERROR_MSG("failed to allocate memory for key");
     if (should_free_key_on_error) {
-      allocator.deallocate(string_map->impl->keys[key_index], allocator.state);
+      if (NULL == string_map->impl->arena) {
+        allocator.deallocate(string_map->impl->keys[key_index], allocator.state);
+      }
       string_map->impl->keys[key_index] = NULL;
     }
     return RCUTILS_RET_BAD_ALLOC;
   }
   string_map->impl->values[key_index] = new_value;
-  if (original_value != NULL) {
+  if (original_value != NULL && NULL == string_map->impl->arena) {
     // clean up the old value if not NULL
     allocator.deallocate(original_value, allocator.state);
   }
   if (!key_exists) {
-    // if the key didn't exist, then we had to add it, so increase the size
+    // if the key didn't exist, then we had to add it, so increase the size and index it
     string_map->impl->size++;
+    string_map->impl->free_hint = key_index + 1;
+    __index_insert(string_map->impl, key_index);
   }
   return RCUTILS_RET_OK;
 }
@@ -334,11 +622,12 @@ rcutils_string_map_unset(rcutils_string_map_t * string_map, const char * key)
   RCUTILS_CHECK_FOR_NULL_WITH_MSG(
     string_map->impl, "invalid string map", return RCUTILS_RET_STRING_MAP_INVALID);
   RCUTILS_CHECK_ARGUMENT_FOR_NULL(key, RCUTILS_RET_INVALID_ARGUMENT);
-  size_t key_index;
-  if (!__get_index_of_key_if_exists(string_map->impl, key, strlen(key), &key_index)) {
+  size_t key_index, position;
+  if (!__get_index_of_key_if_exists(string_map->impl, key, strlen(key), &key_index, &position)) {
     RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("key '%s' not found", key);
     return RCUTILS_RET_STRING_KEY_NOT_FOUND;
   }
+  __index_remove(string_map->impl, position);
   __remove_key_and_value_at_index(string_map->impl, key_index);
   return RCUTILS_RET_OK;
 }
@@ -361,8 +650,9 @@ rcutils_string_map_key_existsn(
   if (NULL == string_map || NULL == string_map->impl || NULL == key) {
     return false;
   }
-  size_t key_index;
-  bool key_exists = __get_index_of_key_if_exists(string_map->impl, key, key_length, &key_index);
+  size_t key_index, position;
+  bool key_exists = __get_index_of_key_if_exists(
+    string_map->impl, key, key_length, &key_index, &position);
   return key_exists;
 }
 
@@ -384,8 +674,8 @@ rcutils_string_map_getn(
   if (NULL == string_map || NULL == string_map->impl || NULL == key) {
     return NULL;
   }
-  size_t key_index;
-  if (__get_index_of_key_if_exists(string_map->impl, key, key_length, &key_index)) {
+  size_t key_index, position;
+  if (__get_index_of_key_if_exists(string_map->impl, key, key_length, &key_index, &position)) {
     return string_map->impl->values[key_index];
   }
   return NULL;
@@ -404,20 +694,17 @@ rcutils_string_map_get_next_key(
   }
   size_t start_index = 0;
   if (key != NULL) {
-    // if given a key, try to find it
-    bool given_key_found = false;
-    size_t i = 0;
-    for (; i < string_map->impl->capacity; ++i) {
-      if (string_map->impl->keys[i] == key) {
-        given_key_found = true;
-        // given key found at index i, start there + 1
-        start_index = i + 1;
-      }
-    }
-    if (!given_key_found) {
+    // if given a key, try to find it, it must be the key stored in the map
+    size_t key_index, position;
+    if (!__get_index_of_key_if_exists(
+        string_map->impl, key, strlen(key), &key_index, &position) ||
+      string_map->impl->keys[key_index] != key)
+    {
       // given key not found, cannot return next key with that
       return NULL;
     }
+    // given key found at key_index, start there + 1
+    start_index = key_index + 1;
   }
   // iterate through the storage and look for another non-NULL key to return
   size_t i = start_index;
@@ -0,0 +1,62 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <string.h>
+
+#include "rcutils/types/string_view.h"
+
+rcutils_string_view_t
+rcutils_get_zero_initialized_string_view(void)
+{
+  static rcutils_string_view_t zero_initialized_string_view = {NULL, 0u};
+  return zero_initialized_string_view;
+}
+
+rcutils_string_view_t
+rcutils_string_view_from_cstring(const char * str)
+{
+  rcutils_string_view_t view = {str, NULL == str ? 0u : strlen(str)};
+  return view;
+}
+
+bool
+rcutils_string_view_equal(rcutils_string_view_t lhs, rcutils_string_view_t rhs)
+{
+  return lhs.length == rhs.length &&
+         (0u == lhs.length || 0 == memcmp(lhs.data, rhs.data, lhs.length));
+}
+
+bool
+rcutils_string_view_equal_cstring(rcutils_string_view_t view, const char * str)
+{
+  if (NULL == str) {
+    return 0u == view.length;
+  }
+  for (size_t i = 0u; i < view.length; ++i) {
+    // Stop at the end of the string too, as it may be shorter than the view
+    if ('\0' == str[i] || str[i] != view.data[i]) {
+      return false;
+    }
+  }
+  return '\0' == str[view.length];
+}
+
+#ifdef __cplusplus
+}
+#endif
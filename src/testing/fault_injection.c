@@ -14,9 +14,21 @@
 
 #include "rcutils/testing/fault_injection.h"
 
+#include <stdio.h>
+#include <string.h>
+
 #include "rcutils/stdatomic_helper.h"
 
 static atomic_int_least64_t g_rcutils_fault_injection_count = ATOMIC_VAR_INIT(-1);
+// The filter of the sites counted, a const char * or 0 to count them all.
+static atomic_uintptr_t g_rcutils_fault_injection_site = ATOMIC_VAR_INIT(0);
+static rcutils_fault_injection_reporter_t g_rcutils_fault_injection_reporter =
+  rcutils_fault_injection_print_reporter;
+static void * g_rcutils_fault_injection_reporter_context = NULL;
+static atomic_uint_least64_t g_rcutils_fault_injection_injected_count = ATOMIC_VAR_INIT(0);
+// The count of the calling thread, which takes precedence over the global one unless it's
+// negative.
+static RCUTILS_THREAD_LOCAL int_least64_t gtls_rcutils_fault_injection_count = -1;
 
 void rcutils_fault_injection_set_count(int_least64_t count)
 {
@@ -30,6 +42,54 @@ int_least64_t rcutils_fault_injection_get_count()
   return count;
 }
 
+void rcutils_fault_injection_set_thread_count(int_least64_t count)
+{
+  gtls_rcutils_fault_injection_count = count;
+}
+
+int_least64_t rcutils_fault_injection_get_thread_count()
+{
+  return gtls_rcutils_fault_injection_count;
+}
+
+void rcutils_fault_injection_set_site(const char * site)
+{
+  rcutils_atomic_store(&g_rcutils_fault_injection_site, (uintptr_t)site);
+}
+
+void rcutils_fault_injection_print_reporter(
+  const char * site, const char * action, void * context)
+{
+  RCUTILS_UNUSED(context);
+  printf("%s Injecting fault and %s\n", site, action);
+}
+
+void rcutils_fault_injection_set_reporter(
+  rcutils_fault_injection_reporter_t reporter, void * context)
+{
+  g_rcutils_fault_injection_reporter = reporter;
+  g_rcutils_fault_injection_reporter_context = context;
+}
+
+uint_least64_t rcutils_fault_injection_get_injected_count()
+{
+  uint_least64_t count;
+  rcutils_atomic_load_explicit(
+    &g_rcutils_fault_injection_injected_count, count, memory_order_relaxed);
+  return count;
+}
+
+void _rcutils_fault_injection_report(const char * site, const char * action)
+{
+  uint_least64_t previous;
+  rcutils_atomic_fetch_add_explicit(
+    &g_rcutils_fault_injection_injected_count, previous, 1u, memory_order_relaxed);
+  RCUTILS_UNUSED(previous);
+  if (NULL != g_rcutils_fault_injection_reporter) {
+    g_rcutils_fault_injection_reporter(site, action, g_rcutils_fault_injection_reporter_context);
+  }
+}
+
 bool rcutils_fault_injection_is_test_complete()
 {
 #ifndef RCUTILS_ENABLE_FAULT_INJECTION
@@ -39,10 +99,36 @@ bool rcutils_fault_injection_is_test_complete()
 #endif  // RCUTILS_ENABLE_FAULT_INJECTION
 }
 
-int_least64_t _rcutils_fault_injection_maybe_fail()
+static bool _rcutils_fault_injection_is_site_counted(const char * site)
 {
+  uintptr_t filter;
+  rcutils_atomic_load_explicit(&g_rcutils_fault_injection_site, filter, memory_order_acquire);
+  return 0u == filter || (NULL != site && NULL != strstr(site, (const char *)filter));
+}
+
+int_least64_t _rcutils_fault_injection_maybe_fail_at(const char * site)
+{
+  // The count of the thread is only seen by it, so it needs no synchronization.
+  if (gtls_rcutils_fault_injection_count > RCUTILS_FAULT_INJECTION_NEVER_FAIL) {
+    if (!_rcutils_fault_injection_is_site_counted(site)) {
+      return RCUTILS_FAULT_INJECTION_NEVER_FAIL;
+    }
+    return gtls_rcutils_fault_injection_count--;
+  }
+
+  // Nothing is ordered by the count, so it's read without a barrier, which keeps the common case
+  // of fault injection being disabled as cheap as a plain load.
+  int_least64_t current_count;
+  rcutils_atomic_load_explicit(
+    &g_rcutils_fault_injection_count, current_count, memory_order_relaxed);
+  if (current_count <= RCUTILS_FAULT_INJECTION_NEVER_FAIL) {
+    return current_count;
+  }
+  if (!_rcutils_fault_injection_is_site_counted(site)) {
+    return RCUTILS_FAULT_INJECTION_NEVER_FAIL;
+  }
+
   bool set_atomic_success = false;
-  int_least64_t current_count = rcutils_fault_injection_get_count();
   do {
     // A fault_injection_count less than 0 means that maybe_fail doesn't fail, so just return.
     if (current_count <= RCUTILS_FAULT_INJECTION_NEVER_FAIL) {
@@ -52,8 +138,14 @@ int_least64_t _rcutils_fault_injection_maybe_fail()
     // Otherwise decrement by one, but do so in a thread-safe manner so that exactly one calling
     // thread gets the 0 case.
     int_least64_t desired_count = current_count - 1;
-    rcutils_atomic_compare_exchange_strong(
-      &g_rcutils_fault_injection_count, set_atomic_success, &current_count, desired_count);
+    rcutils_atomic_compare_exchange_weak_explicit(
+      &g_rcutils_fault_injection_count, set_atomic_success, &current_count, desired_count,
+      memory_order_relaxed, memory_order_relaxed);
   } while (!set_atomic_success);
   return current_count;
 }
+
+int_least64_t _rcutils_fault_injection_maybe_fail()
+{
+  return _rcutils_fault_injection_maybe_fail_at(NULL);
+}
@@ -0,0 +1,513 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef _WIN32
+// See the comment in logging.c about warning C5105.
+# pragma warning(push)
+# pragma warning(disable : 5105)
+# include <windows.h>
+# pragma warning(pop)
+#else
+# include <pthread.h>
+# include <sched.h>
+# include <unistd.h>
+#endif
+#ifdef __linux__
+# include <sys/syscall.h>
+#endif
+
+#include "rcutils/error_handling.h"
+#include "rcutils/macros.h"
+#include "rcutils/thread.h"
+
+#if defined(__linux__) && defined(_GNU_SOURCE) && !defined(__ANDROID__)
+// glibc binds and names threads with its GNU extensions.
+# define THREAD_LINUX_EXTENSIONS
+// Including the terminating null character.
+# define THREAD_LINUX_MAX_NAME_LENGTH 16u
+#endif
+
+#ifdef _WIN32
+// SetThreadDescription() and GetThreadDescription() are only in Windows 10 1607 and later.
+typedef HRESULT (WINAPI * _set_thread_description_t)(HANDLE, PCWSTR);
+typedef HRESULT (WINAPI * _get_thread_description_t)(HANDLE, PWSTR *);
+
+static FARPROC
+_get_kernel32_function(const char * name)
+{
+  HMODULE kernel32 = GetModuleHandleW(L"kernel32.dll");
+  return NULL != kernel32 ? GetProcAddress(kernel32, name) : NULL;
+}
+#endif
+
+// The identity of the calling thread, fetched the first time it's asked for.
+typedef struct rcutils_thread_identity_t
+{
+  // 0 until fetched, as no thread has that id.
+  uint64_t id;
+  bool has_name;
+  char name[RCUTILS_THREAD_MAX_NAME_LENGTH];
+} rcutils_thread_identity_t;
+
+static RCUTILS_THREAD_LOCAL rcutils_thread_identity_t gtls_rcutils_thread_identity;
+
+#ifndef _WIN32
+// The thread of the child of a fork has its own id, which is fetched again.
+static void
+_forget_thread_id(void)
+{
+  gtls_rcutils_thread_identity.id = 0u;
+}
+
+static void
+_register_forget_thread_id(void)
+{
+  pthread_atfork(NULL, NULL, _forget_thread_id);
+}
+#endif
+
+rcutils_thread_cpu_set_t
+rcutils_get_zero_initialized_thread_cpu_set(void)
+{
+  static rcutils_thread_cpu_set_t zero_initialized_cpu_set = {{0u}};
+  return zero_initialized_cpu_set;
+}
+
+rcutils_ret_t
+rcutils_thread_cpu_set_add(rcutils_thread_cpu_set_t * cpus, size_t cpu)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(cpus, RCUTILS_RET_INVALID_ARGUMENT);
+  if (cpu >= RCUTILS_THREAD_MAX_CPUS) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "processor %zu is beyond the %u a set can hold", cpu, RCUTILS_THREAD_MAX_CPUS);
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  cpus->bits[cpu / 64u] |= (uint64_t)1u << (cpu % 64u);
+  return RCUTILS_RET_OK;
+}
+
+bool
+rcutils_thread_cpu_set_contains(const rcutils_thread_cpu_set_t * cpus, size_t cpu)
+{
+  if (NULL == cpus || cpu >= RCUTILS_THREAD_MAX_CPUS) {
+    return false;
+  }
+  return 0u != (cpus->bits[cpu / 64u] & ((uint64_t)1u << (cpu % 64u)));
+}
+
+size_t
+rcutils_thread_cpu_set_count(const rcutils_thread_cpu_set_t * cpus)
+{
+  if (NULL == cpus) {
+    return 0u;
+  }
+  size_t count = 0u;
+  for (size_t i = 0; i < RCUTILS_THREAD_MAX_CPUS / 64u; ++i) {
+    for (uint64_t bits = cpus->bits[i]; 0u != bits; bits &= bits - 1u) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+rcutils_ret_t
+rcutils_thread_set_affinity(const rcutils_thread_cpu_set_t * cpus)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(cpus, RCUTILS_RET_INVALID_ARGUMENT);
+  if (0u == rcutils_thread_cpu_set_count(cpus)) {
+    RCUTILS_SET_ERROR_MSG("the set of processors is empty");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+#if defined(_WIN32)
+  for (size_t i = 1; i < RCUTILS_THREAD_MAX_CPUS / 64u; ++i) {
+    if (0u != cpus->bits[i]) {
+      RCUTILS_SET_ERROR_MSG("only the first 64 processors can be bound to");
+      return RCUTILS_RET_INVALID_ARGUMENT;
+    }
+  }
+  if (0 == SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)cpus->bits[0])) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "failed to set the affinity of the thread: %lu", GetLastError());
+    return RCUTILS_RET_ERROR;
+  }
+  return RCUTILS_RET_OK;
+#elif defined(THREAD_LINUX_EXTENSIONS)
+  cpu_set_t native_cpus;
+  CPU_ZERO(&native_cpus);
+  for (size_t cpu = 0; cpu < RCUTILS_THREAD_MAX_CPUS && cpu < CPU_SETSIZE; ++cpu) {
+    if (rcutils_thread_cpu_set_contains(cpus, cpu)) {
+      CPU_SET(cpu, &native_cpus);
+    }
+  }
+  int result = pthread_setaffinity_np(pthread_self(), sizeof(native_cpus), &native_cpus);
+  if (0 != result) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "failed to set the affinity of the thread: %d", result);
+    return EINVAL == result ? RCUTILS_RET_INVALID_ARGUMENT : RCUTILS_RET_ERROR;
+  }
+  return RCUTILS_RET_OK;
+#else
+  RCUTILS_SET_ERROR_MSG("binding threads to processors isn't supported on this platform");
+  return RCUTILS_RET_ERROR;
+#endif
+}
+
+rcutils_ret_t
+rcutils_thread_get_affinity(rcutils_thread_cpu_set_t * cpus)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(cpus, RCUTILS_RET_INVALID_ARGUMENT);
+  *cpus = rcutils_get_zero_initialized_thread_cpu_set();
+#if defined(_WIN32)
+  // The affinity of a thread is only returned by setting it, so set it to itself
+  DWORD_PTR process_mask, system_mask;
+  if (!GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask)) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "failed to get the affinity of the process: %lu", GetLastError());
+    return RCUTILS_RET_ERROR;
+  }
+  DWORD_PTR thread_mask = SetThreadAffinityMask(GetCurrentThread(), process_mask);
+  if (0 == thread_mask) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "failed to get the affinity of the thread: %lu", GetLastError());
+    return RCUTILS_RET_ERROR;
+  }
+  (void)SetThreadAffinityMask(GetCurrentThread(), thread_mask);
+  cpus->bits[0] = (uint64_t)thread_mask;
+  return RCUTILS_RET_OK;
+#elif defined(THREAD_LINUX_EXTENSIONS)
+  cpu_set_t native_cpus;
+  int result = pthread_getaffinity_np(pthread_self(), sizeof(native_cpus), &native_cpus);
+  if (0 != result) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "failed to get the affinity of the thread: %d", result);
+    return RCUTILS_RET_ERROR;
+  }
+  for (size_t cpu = 0; cpu < RCUTILS_THREAD_MAX_CPUS && cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &native_cpus)) {
+      cpus->bits[cpu / 64u] |= (uint64_t)1u << (cpu % 64u);
+    }
+  }
+  return RCUTILS_RET_OK;
+#else
+  long count = sysconf(_SC_NPROCESSORS_ONLN);
+  for (long cpu = 0; cpu < count && cpu < (long)RCUTILS_THREAD_MAX_CPUS; ++cpu) {
+    cpus->bits[cpu / 64] |= (uint64_t)1u << (cpu % 64);
+  }
+  return RCUTILS_RET_OK;
+#endif
+}
+
+rcutils_ret_t
+rcutils_thread_set_scheduling(rcutils_thread_scheduling_policy_t policy, int priority)
+{
+  if (RCUTILS_THREAD_SCHEDULING_POLICY_UNCHANGED == policy) {
+    return RCUTILS_RET_OK;
+  }
+#ifdef _WIN32
+  int native_priority;
+  switch (policy) {
+    case RCUTILS_THREAD_SCHEDULING_POLICY_OTHER:
+      native_priority = THREAD_PRIORITY_NORMAL;
+      break;
+    case RCUTILS_THREAD_SCHEDULING_POLICY_FIFO:
+    case RCUTILS_THREAD_SCHEDULING_POLICY_ROUND_ROBIN:
+      if (priority < 33) {
+        native_priority = THREAD_PRIORITY_ABOVE_NORMAL;
+      } else if (priority < 66) {
+        native_priority = THREAD_PRIORITY_HIGHEST;
+      } else {
+        native_priority = THREAD_PRIORITY_TIME_CRITICAL;
+      }
+      break;
+    default:
+      RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("invalid scheduling policy %d", (int)policy);
+      return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  if (!SetThreadPriority(GetCurrentThread(), native_priority)) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "failed to set the priority of the thread: %lu", GetLastError());
+    return RCUTILS_RET_ERROR;
+  }
+  return RCUTILS_RET_OK;
+#else
+  struct sched_param param;
+  memset(&param, 0, sizeof(param));
+  int native_policy;
+  switch (policy) {
+    case RCUTILS_THREAD_SCHEDULING_POLICY_OTHER:
+      native_policy = SCHED_OTHER;
+      break;
+    case RCUTILS_THREAD_SCHEDULING_POLICY_FIFO:
+      native_policy = SCHED_FIFO;
+      param.sched_priority = priority;
+      break;
+    case RCUTILS_THREAD_SCHEDULING_POLICY_ROUND_ROBIN:
+      native_policy = SCHED_RR;
+      param.sched_priority = priority;
+      break;
+    default:
+      RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("invalid scheduling policy %d", (int)policy);
+      return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  int result = pthread_setschedparam(pthread_self(), native_policy, &param);
+  if (EINVAL == result) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "invalid priority %d for the scheduling policy", priority);
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  if (0 != result) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "failed to set the scheduling of the thread: %d", result);
+    return RCUTILS_RET_ERROR;
+  }
+  return RCUTILS_RET_OK;
+#endif
+}
+
+rcutils_ret_t
+rcutils_thread_get_scheduling(rcutils_thread_scheduling_policy_t * policy, int * priority)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(policy, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(priority, RCUTILS_RET_INVALID_ARGUMENT);
+#ifdef _WIN32
+  int native_priority = GetThreadPriority(GetCurrentThread());
+  if (THREAD_PRIORITY_ERROR_RETURN == native_priority) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "failed to get the priority of the thread: %lu", GetLastError());
+    return RCUTILS_RET_ERROR;
+  }
+  *policy = RCUTILS_THREAD_SCHEDULING_POLICY_ROUND_ROBIN;
+  if (native_priority >= THREAD_PRIORITY_TIME_CRITICAL) {
+    *priority = 99;
+  } else if (native_priority >= THREAD_PRIORITY_HIGHEST) {
+    *priority = 50;
+  } else if (native_priority >= THREAD_PRIORITY_ABOVE_NORMAL) {
+    *priority = 1;
+  } else {
+    *policy = RCUTILS_THREAD_SCHEDULING_POLICY_OTHER;
+    *priority = 0;
+  }
+  return RCUTILS_RET_OK;
+#else
+  struct sched_param param;
+  int native_policy;
+  int result = pthread_getschedparam(pthread_self(), &native_policy, &param);
+  if (0 != result) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING(
+      "failed to get the scheduling of the thread: %d", result);
+    return RCUTILS_RET_ERROR;
+  }
+  if (SCHED_FIFO == native_policy) {
+    *policy = RCUTILS_THREAD_SCHEDULING_POLICY_FIFO;
+    *priority = param.sched_priority;
+  } else if (SCHED_RR == native_policy) {
+    *policy = RCUTILS_THREAD_SCHEDULING_POLICY_ROUND_ROBIN;
+    *priority = param.sched_priority;
+  } else {
+    *policy = RCUTILS_THREAD_SCHEDULING_POLICY_OTHER;
+    *priority = 0;
+  }
+  return RCUTILS_RET_OK;
+#endif
+}
+
+rcutils_ret_t
+rcutils_thread_set_name(const char * name)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(name, RCUTILS_RET_INVALID_ARGUMENT);
+  // Fetched again the next time it's asked for
+  gtls_rcutils_thread_identity.has_name = false;
+#if defined(_WIN32)
+  _set_thread_description_t set_thread_description =
+    (_set_thread_description_t)_get_kernel32_function("SetThreadDescription");
+  if (NULL == set_thread_description) {
+    RCUTILS_SET_ERROR_MSG("naming threads isn't supported by this version of Windows");
+    return RCUTILS_RET_ERROR;
+  }
+  WCHAR wide_name[RCUTILS_THREAD_MAX_NAME_LENGTH];
+  char truncated_name[RCUTILS_THREAD_MAX_NAME_LENGTH];
+  strncpy_s(truncated_name, sizeof(truncated_name), name, _TRUNCATE);
+  if (
+    0 == MultiByteToWideChar(
+      CP_UTF8, 0, truncated_name, -1, wide_name, RCUTILS_THREAD_MAX_NAME_LENGTH))
+  {
+    RCUTILS_SET_ERROR_MSG("the name of the thread isn't valid UTF-8");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  if (FAILED(set_thread_description(GetCurrentThread(), wide_name))) {
+    RCUTILS_SET_ERROR_MSG("failed to set the name of the thread");
+    return RCUTILS_RET_ERROR;
+  }
+  return RCUTILS_RET_OK;
+#elif defined(THREAD_LINUX_EXTENSIONS)
+  char truncated_name[THREAD_LINUX_MAX_NAME_LENGTH];
+  size_t length = strnlen(name, THREAD_LINUX_MAX_NAME_LENGTH - 1u);
+  memcpy(truncated_name, name, length);
+  truncated_name[length] = '\0';
+  int result = pthread_setname_np(pthread_self(), truncated_name);
+  if (0 != result) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("failed to set the name of the thread: %d", result);
+    return RCUTILS_RET_ERROR;
+  }
+  return RCUTILS_RET_OK;
+#elif defined(__APPLE__)
+  char truncated_name[RCUTILS_THREAD_MAX_NAME_LENGTH];
+  size_t length = strnlen(name, RCUTILS_THREAD_MAX_NAME_LENGTH - 1u);
+  memcpy(truncated_name, name, length);
+  truncated_name[length] = '\0';
+  int result = pthread_setname_np(truncated_name);
+  if (0 != result) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("failed to set the name of the thread: %d", result);
+    return RCUTILS_RET_ERROR;
+  }
+  return RCUTILS_RET_OK;
+#else
+  RCUTILS_SET_ERROR_MSG("naming threads isn't supported on this platform");
+  return RCUTILS_RET_ERROR;
+#endif
+}
+
+// Gets the name of the calling thread into native_name, returning 0 if successful or an error
+// number otherwise, without setting the error state.
+static int
+_get_native_name(char native_name[RCUTILS_THREAD_MAX_NAME_LENGTH])
+{
+#if defined(_WIN32)
+  _get_thread_description_t get_thread_description =
+    (_get_thread_description_t)_get_kernel32_function("GetThreadDescription");
+  PWSTR wide_name = NULL;
+  if (NULL == get_thread_description) {
+    return ERROR_CALL_NOT_IMPLEMENTED;
+  }
+  HRESULT hresult = get_thread_description(GetCurrentThread(), &wide_name);
+  if (FAILED(hresult)) {
+    return (int)hresult;
+  }
+  // A name cut in the middle of a character converts to nothing, which is fine for a name
+  int converted = WideCharToMultiByte(
+    CP_UTF8, 0, wide_name, -1, native_name, RCUTILS_THREAD_MAX_NAME_LENGTH, NULL, NULL);
+  LocalFree(wide_name);
+  if (0 == converted) {
+    native_name[0] = '\0';
+  }
+  native_name[RCUTILS_THREAD_MAX_NAME_LENGTH - 1u] = '\0';
+  return 0;
+#elif defined(THREAD_LINUX_EXTENSIONS) || defined(__APPLE__)
+  return pthread_getname_np(pthread_self(), native_name, RCUTILS_THREAD_MAX_NAME_LENGTH);
+#else
+  RCUTILS_UNUSED(native_name);
+  return ENOSYS;
+#endif
+}
+
+rcutils_ret_t
+rcutils_thread_get_name(char * name, size_t size)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(name, RCUTILS_RET_INVALID_ARGUMENT);
+  if (0u == size) {
+    RCUTILS_SET_ERROR_MSG("size is 0");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  char native_name[RCUTILS_THREAD_MAX_NAME_LENGTH];
+  int result = _get_native_name(native_name);
+  if (0 != result) {
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("failed to get the name of the thread: %d", result);
+    return RCUTILS_RET_ERROR;
+  }
+  size_t length = strnlen(native_name, sizeof(native_name));
+  if (length >= size) {
+    length = size - 1u;
+  }
+  memcpy(name, native_name, length);
+  name[length] = '\0';
+  return RCUTILS_RET_OK;
+}
+
+uint64_t
+rcutils_thread_get_id(void)
+{
+  if (0u == gtls_rcutils_thread_identity.id) {
+#ifndef _WIN32
+    static pthread_once_t forget_thread_id_once = PTHREAD_ONCE_INIT;
+    pthread_once(&forget_thread_id_once, _register_forget_thread_id);
+#endif
+#if defined(_WIN32)
+    gtls_rcutils_thread_identity.id = (uint64_t)GetCurrentThreadId();
+#elif defined(__linux__)
+    gtls_rcutils_thread_identity.id = (uint64_t)syscall(SYS_gettid);
+#elif defined(__APPLE__)
+    uint64_t id = 0u;
+    (void)pthread_threadid_np(NULL, &id);
+    gtls_rcutils_thread_identity.id = id;
+#else
+    gtls_rcutils_thread_identity.id = (uint64_t)(uintptr_t)pthread_self();
+#endif
+  }
+  return gtls_rcutils_thread_identity.id;
+}
+
+const char *
+rcutils_thread_get_cached_name(void)
+{
+  if (!gtls_rcutils_thread_identity.has_name) {
+    if (0 != _get_native_name(gtls_rcutils_thread_identity.name)) {
+      gtls_rcutils_thread_identity.name[0] = '\0';
+    }
+    gtls_rcutils_thread_identity.has_name = true;
+  }
+  return gtls_rcutils_thread_identity.name;
+}
+
+rcutils_thread_attributes_t
+rcutils_thread_get_default_attributes(void)
+{
+  static rcutils_thread_attributes_t default_attributes = {
+    .cpus = NULL,
+    .policy = RCUTILS_THREAD_SCHEDULING_POLICY_UNCHANGED,
+    .priority = 0,
+    .name = NULL,
+  };
+  return default_attributes;
+}
+
+rcutils_ret_t
+rcutils_thread_set_attributes(const rcutils_thread_attributes_t * attributes)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(attributes, RCUTILS_RET_INVALID_ARGUMENT);
+  rcutils_ret_t ret = RCUTILS_RET_OK;
+  if (NULL != attributes->cpus) {
+    ret = rcutils_thread_set_affinity(attributes->cpus);
+  }
+  if (RCUTILS_RET_OK == ret) {
+    ret = rcutils_thread_set_scheduling(attributes->policy, attributes->priority);
+  }
+  if (RCUTILS_RET_OK == ret && NULL != attributes->name) {
+    ret = rcutils_thread_set_name(attributes->name);
+  }
+  return ret;
+}
+
+#ifdef __cplusplus
+}
+#endif
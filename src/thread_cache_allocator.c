@@ -0,0 +1,376 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef _WIN32
+// See the comment in logging.c about warning C5105.
+# pragma warning(push)
+# pragma warning(disable : 5105)
+# include <windows.h>
+# pragma warning(pop)
+#else
+# include <sched.h>
+#endif
+
+#include "rcutils/error_handling.h"
+#include "rcutils/macros.h"
+#include "rcutils/stdatomic_helper.h"
+#include "rcutils/thread_cache_allocator.h"
+
+// The block sizes, multiples of 16 up to the largest cached block size
+static const size_t g_size_classes[] = {16, 32, 48, 64, 96, 128, 192, 256};
+#define SIZE_CLASS_COUNT (sizeof(g_size_classes) / sizeof(g_size_classes[0]))
+// The size class of the allocations which aren't cached
+#define LARGE_SIZE_CLASS SIZE_CLASS_COUNT
+
+// Placed before each allocation, and padded to 16 bytes so the allocation stays aligned.
+typedef struct block_header_s
+{
+  size_t size_class;
+  // The requested size of the allocations which aren't cached.
+  size_t size;
+} block_header_t;
+
+#define BLOCK_HEADER_SIZE ((size_t)16)
+
+// Overlaps the memory of the cached blocks.
+typedef struct free_block_s
+{
+  struct free_block_s * next;
+} free_block_t;
+
+typedef struct thread_cache_s
+{
+  // The next cache of the same thread cache allocator.
+  struct thread_cache_s * next;
+  free_block_t * free_lists[SIZE_CLASS_COUNT];
+  size_t counts[SIZE_CLASS_COUNT];
+} thread_cache_t;
+
+typedef struct rcutils_thread_cache_allocator_impl_s
+{
+  // Unique among the thread cache allocators, so a thread never confuses a finalized one with
+  // one allocated at the same address.
+  uint64_t id;
+  rcutils_allocator_t allocator;
+  atomic_bool lock;
+  // The caches of all the threads, only accessed with the lock held.
+  thread_cache_t * caches;
+} rcutils_thread_cache_allocator_impl_t;
+
+typedef struct thread_cache_slot_s
+{
+  uint64_t id;
+  thread_cache_t * cache;
+} thread_cache_slot_t;
+
+static atomic_uint_least64_t g_rcutils_thread_cache_allocator_next_id = ATOMIC_VAR_INIT(1);
+static RCUTILS_THREAD_LOCAL thread_cache_slot_t
+  gtls_rcutils_thread_caches[RCUTILS_THREAD_CACHE_ALLOCATOR_MAX_PER_THREAD];
+
+static void
+_lock(rcutils_thread_cache_allocator_impl_t * impl)
+{
+  while (rcutils_atomic_exchange_bool(&impl->lock, true)) {
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+  }
+}
+
+static void
+_unlock(rcutils_thread_cache_allocator_impl_t * impl)
+{
+  rcutils_atomic_store(&impl->lock, false);
+}
+
+static size_t
+_get_size_class(size_t size)
+{
+  size_t size_class = 0u;
+  while (g_size_classes[size_class] < size) {
+    ++size_class;
+  }
+  return size_class;
+}
+
+static block_header_t *
+_get_header(void * pointer)
+{
+  return (block_header_t *)((uint8_t *)pointer - BLOCK_HEADER_SIZE);
+}
+
+// Returns the cache of the calling thread, creating it if needed, or NULL if it has none.
+static thread_cache_t *
+_get_thread_cache(rcutils_thread_cache_allocator_impl_t * impl, bool create)
+{
+  thread_cache_slot_t * free_slot = NULL;
+  for (size_t i = 0u; i < RCUTILS_THREAD_CACHE_ALLOCATOR_MAX_PER_THREAD; ++i) {
+    thread_cache_slot_t * slot = &gtls_rcutils_thread_caches[i];
+    if (impl->id == slot->id) {
+      return slot->cache;
+    }
+    if (0u == slot->id && NULL == free_slot) {
+      free_slot = slot;
+    }
+  }
+  if (!create || NULL == free_slot) {
+    return NULL;
+  }
+  thread_cache_t * cache = impl->allocator.zero_allocate(
+    1, sizeof(thread_cache_t), impl->allocator.state);
+  if (NULL == cache) {
+    return NULL;
+  }
+  _lock(impl);
+  cache->next = impl->caches;
+  impl->caches = cache;
+  _unlock(impl);
+  free_slot->id = impl->id;
+  free_slot->cache = cache;
+  return cache;
+}
+
+// Deallocates the first count blocks of the free list of a size class
+static void
+_release_blocks(
+  rcutils_thread_cache_allocator_impl_t * impl, thread_cache_t * cache, size_t size_class,
+  size_t count)
+{
+  for (; count > 0u && NULL != cache->free_lists[size_class]; --count) {
+    free_block_t * block = cache->free_lists[size_class];
+    cache->free_lists[size_class] = block->next;
+    --cache->counts[size_class];
+    impl->allocator.deallocate(_get_header(block), impl->allocator.state);
+  }
+}
+
+static void *
+_allocate_block(rcutils_thread_cache_allocator_impl_t * impl, size_t size_class, size_t size)
+{
+  size_t block_size = LARGE_SIZE_CLASS == size_class ? size : g_size_classes[size_class];
+  if (block_size > SIZE_MAX - BLOCK_HEADER_SIZE) {
+    return NULL;
+  }
+  block_header_t * header = impl->allocator.allocate(
+    BLOCK_HEADER_SIZE + block_size, impl->allocator.state);
+  if (NULL == header) {
+    return NULL;
+  }
+  header->size_class = size_class;
+  header->size = size;
+  return (uint8_t *)header + BLOCK_HEADER_SIZE;
+}
+
+static void *
+_thread_cache_allocate(size_t size, void * state)
+{
+  rcutils_thread_cache_allocator_impl_t * impl = state;
+  if (size > RCUTILS_THREAD_CACHE_ALLOCATOR_MAX_BLOCK_SIZE) {
+    return _allocate_block(impl, LARGE_SIZE_CLASS, size);
+  }
+  size_t size_class = _get_size_class(size);
+  thread_cache_t * cache = _get_thread_cache(impl, true);
+  if (NULL != cache && NULL != cache->free_lists[size_class]) {
+    free_block_t * block = cache->free_lists[size_class];
+    cache->free_lists[size_class] = block->next;
+    --cache->counts[size_class];
+    return block;
+  }
+  return _allocate_block(impl, size_class, size);
+}
+
+static void
+_thread_cache_deallocate(void * pointer, void * state)
+{
+  rcutils_thread_cache_allocator_impl_t * impl = state;
+  if (NULL == pointer) {
+    return;
+  }
+  block_header_t * header = _get_header(pointer);
+  size_t size_class = header->size_class;
+  thread_cache_t * cache = NULL;
+  if (LARGE_SIZE_CLASS != size_class) {
+    cache = _get_thread_cache(impl, true);
+  }
+  if (NULL == cache) {
+    impl->allocator.deallocate(header, impl->allocator.state);
+    return;
+  }
+  free_block_t * block = pointer;
+  block->next = cache->free_lists[size_class];
+  cache->free_lists[size_class] = block;
+  if (++cache->counts[size_class] > RCUTILS_THREAD_CACHE_ALLOCATOR_MAX_CACHED_BLOCKS) {
+    _release_blocks(impl, cache, size_class, RCUTILS_THREAD_CACHE_ALLOCATOR_MAX_CACHED_BLOCKS / 2u);
+  }
+}
+
+static void *
+_thread_cache_reallocate(void * pointer, size_t size, void * state)
+{
+  rcutils_thread_cache_allocator_impl_t * impl = state;
+  if (NULL == pointer) {
+    return _thread_cache_allocate(size, state);
+  }
+  block_header_t * header = _get_header(pointer);
+  if (LARGE_SIZE_CLASS == header->size_class) {
+    if (size > RCUTILS_THREAD_CACHE_ALLOCATOR_MAX_BLOCK_SIZE) {
+      if (size > SIZE_MAX - BLOCK_HEADER_SIZE) {
+        return NULL;
+      }
+      header = impl->allocator.reallocate(
+        header, BLOCK_HEADER_SIZE + size, impl->allocator.state);
+      if (NULL == header) {
+        return NULL;
+      }
+      header->size = size;
+      return (uint8_t *)header + BLOCK_HEADER_SIZE;
+    }
+  } else if (size <= g_size_classes[header->size_class]) {
+    return pointer;
+  }
+  size_t capacity = LARGE_SIZE_CLASS == header->size_class ?
+    header->size : g_size_classes[header->size_class];
+  void * new_pointer = _thread_cache_allocate(size, state);
+  if (NULL == new_pointer) {
+    return NULL;
+  }
+  memcpy(new_pointer, pointer, size < capacity ? size : capacity);
+  _thread_cache_deallocate(pointer, state);
+  return new_pointer;
+}
+
+static void *
+_thread_cache_zero_allocate(size_t number_of_elements, size_t size_of_element, void * state)
+{
+  if (0u != size_of_element && number_of_elements > SIZE_MAX / size_of_element) {
+    return NULL;
+  }
+  size_t size = number_of_elements * size_of_element;
+  void * pointer = _thread_cache_allocate(size, state);
+  if (NULL != pointer) {
+    memset(pointer, 0, size);
+  }
+  return pointer;
+}
+
+rcutils_thread_cache_allocator_t
+rcutils_get_zero_initialized_thread_cache_allocator(void)
+{
+  static rcutils_thread_cache_allocator_t zero_initialized_thread_cache_allocator = {NULL};
+  return zero_initialized_thread_cache_allocator;
+}
+
+rcutils_ret_t
+rcutils_thread_cache_allocator_init(
+  rcutils_thread_cache_allocator_t * cache,
+  const rcutils_allocator_t * allocator)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(cache, RCUTILS_RET_INVALID_ARGUMENT);
+  if (NULL != cache->impl) {
+    RCUTILS_SET_ERROR_MSG("thread cache allocator is already initialized");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  RCUTILS_CHECK_ALLOCATOR_WITH_MSG(
+    allocator, "invalid allocator", return RCUTILS_RET_INVALID_ARGUMENT);
+
+  rcutils_thread_cache_allocator_impl_t * impl = allocator->allocate(
+    sizeof(rcutils_thread_cache_allocator_impl_t), allocator->state);
+  if (NULL == impl) {
+    RCUTILS_SET_ERROR_MSG("failed to allocate memory for thread cache allocator");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  impl->id = rcutils_atomic_fetch_add_uint64_t(&g_rcutils_thread_cache_allocator_next_id, 1);
+  impl->allocator = *allocator;
+  rcutils_atomic_store(&impl->lock, false);
+  impl->caches = NULL;
+  cache->impl = impl;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_thread_cache_allocator_fini(rcutils_thread_cache_allocator_t * cache)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(cache, RCUTILS_RET_INVALID_ARGUMENT);
+  rcutils_thread_cache_allocator_impl_t * impl = cache->impl;
+  if (NULL == impl) {
+    return RCUTILS_RET_OK;
+  }
+  thread_cache_t * thread_cache = impl->caches;
+  while (NULL != thread_cache) {
+    thread_cache_t * next = thread_cache->next;
+    for (size_t i = 0u; i < SIZE_CLASS_COUNT; ++i) {
+      _release_blocks(impl, thread_cache, i, SIZE_MAX);
+    }
+    impl->allocator.deallocate(thread_cache, impl->allocator.state);
+    thread_cache = next;
+  }
+  // The other threads can't reuse their slot, as they can't tell the id was finalized
+  for (size_t i = 0u; i < RCUTILS_THREAD_CACHE_ALLOCATOR_MAX_PER_THREAD; ++i) {
+    if (impl->id == gtls_rcutils_thread_caches[i].id) {
+      gtls_rcutils_thread_caches[i].id = 0u;
+      gtls_rcutils_thread_caches[i].cache = NULL;
+    }
+  }
+  impl->allocator.deallocate(impl, impl->allocator.state);
+  cache->impl = NULL;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_thread_cache_allocator_flush(const rcutils_thread_cache_allocator_t * cache)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(cache, RCUTILS_RET_INVALID_ARGUMENT);
+  if (NULL == cache->impl) {
+    RCUTILS_SET_ERROR_MSG("thread cache allocator is not initialized");
+    return RCUTILS_RET_NOT_INITIALIZED;
+  }
+  thread_cache_t * thread_cache = _get_thread_cache(cache->impl, false);
+  if (NULL != thread_cache) {
+    for (size_t i = 0u; i < SIZE_CLASS_COUNT; ++i) {
+      _release_blocks(cache->impl, thread_cache, i, SIZE_MAX);
+    }
+  }
+  return RCUTILS_RET_OK;
+}
+
+rcutils_allocator_t
+rcutils_thread_cache_allocator_get_allocator(const rcutils_thread_cache_allocator_t * cache)
+{
+  if (NULL == cache || NULL == cache->impl) {
+    return rcutils_get_zero_initialized_allocator();
+  }
+  rcutils_allocator_t allocator = {
+    .allocate = _thread_cache_allocate,
+    .deallocate = _thread_cache_deallocate,
+    .reallocate = _thread_cache_reallocate,
+    .zero_allocate = _thread_cache_zero_allocate,
+    .state = cache->impl,
+  };
+  return allocator;
+}
+
+#ifdef __cplusplus
+}
+#endif
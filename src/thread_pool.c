@@ -0,0 +1,719 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef _WIN32
+// See the comment in logging.c about warning C5105.
+# pragma warning(push)
+# pragma warning(disable : 5105)
+# include <windows.h>
+# pragma warning(pop)
+#else
+# include <pthread.h>
+# include <sched.h>
+# include <unistd.h>
+#endif
+
+#include "rcutils/error_handling.h"
+#include "rcutils/macros.h"
+#include "rcutils/stdatomic_helper.h"
+#include "rcutils/thread.h"
+#include "rcutils/thread_pool.h"
+
+#if defined(__linux__) && defined(_GNU_SOURCE) && !defined(__ANDROID__)
+# define THREAD_POOL_HAS_AFFINITY
+#endif
+
+// The number of times a thread looks for an item before it sleeps.
+#define THREAD_POOL_SPIN_COUNT 64u
+
+#ifdef _WIN32
+typedef CRITICAL_SECTION _mutex_t;
+typedef CONDITION_VARIABLE _condition_t;
+typedef HANDLE _thread_t;
+#else
+typedef pthread_mutex_t _mutex_t;
+typedef pthread_cond_t _condition_t;
+typedef pthread_t _thread_t;
+#endif
+
+// A deque of Chase and Lev, with a fixed capacity: its worker pushes and pops items at the
+// bottom, and the other workers steal them from the top.
+typedef struct _deque_t
+{
+  atomic_int_least64_t top;
+  atomic_int_least64_t bottom;
+  uint8_t * items;
+} _deque_t;
+
+typedef struct _worker_t
+{
+  struct rcutils_thread_pool_impl_t * impl;
+  _deque_t deque;
+  // Where the item processed by the worker is copied.
+  uint8_t * item;
+  size_t index;
+  _thread_t thread;
+  // Keeps the deques of neighbouring workers on distinct cache lines.
+  uint8_t padding[64];
+} _worker_t;
+
+typedef struct rcutils_thread_pool_impl_t
+{
+  // The pool passed to the function, whose impl is this.
+  rcutils_thread_pool_t pool;
+  rcutils_thread_pool_function_t function;
+  void * context;
+  rcutils_allocator_t allocator;
+  size_t item_size;
+  // The capacity of each queue, a power of two.
+  size_t capacity;
+  // The items pushed from outside of the pool, a ring of capacity items from head.
+  uint8_t * shared_items;
+  size_t shared_head;
+  size_t shared_count;
+  // The shared count, to look at the shared queue without locking.
+  atomic_size_t shared_queued;
+  // The number of items pushed which aren't processed yet.
+  atomic_size_t pending;
+  // The number of threads going to sleep or sleeping, and the wakeups they sleep until.
+  atomic_size_t sleepers;
+  atomic_size_t epoch;
+  atomic_bool exit;
+  // Guards the shared queue and the sleeps.
+  _mutex_t mutex;
+  _condition_t condition;
+  // The first worker is the thread calling rcutils_thread_pool_wait().
+  _worker_t * workers;
+  size_t thread_count;
+  size_t started_threads;
+  // The attributes of the threads started, which point to the copies below if given.
+  bool has_thread_attributes;
+  rcutils_thread_attributes_t thread_attributes;
+  rcutils_thread_cpu_set_t thread_cpus;
+  char thread_name[RCUTILS_THREAD_MAX_NAME_LENGTH];
+} rcutils_thread_pool_impl_t;
+
+// The worker of the current thread, to push items into its deque.
+static RCUTILS_THREAD_LOCAL _worker_t * gtls_rcutils_thread_pool_worker = NULL;
+
+static void
+_lock(rcutils_thread_pool_impl_t * impl)
+{
+#ifdef _WIN32
+  EnterCriticalSection(&impl->mutex);
+#else
+  pthread_mutex_lock(&impl->mutex);
+#endif
+}
+
+static void
+_unlock(rcutils_thread_pool_impl_t * impl)
+{
+#ifdef _WIN32
+  LeaveCriticalSection(&impl->mutex);
+#else
+  pthread_mutex_unlock(&impl->mutex);
+#endif
+}
+
+static void
+_wait(rcutils_thread_pool_impl_t * impl)
+{
+#ifdef _WIN32
+  SleepConditionVariableCS(&impl->condition, &impl->mutex, INFINITE);
+#else
+  pthread_cond_wait(&impl->condition, &impl->mutex);
+#endif
+}
+
+static void
+_pause(void)
+{
+#if defined(_MSC_VER)
+  YieldProcessor();
+#elif defined(__i386__) || defined(__x86_64__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__) || (defined(__ARM_ARCH) && __ARM_ARCH >= 7)
+  __asm__ __volatile__ ("yield");
+#endif
+}
+
+// Wakes one sleeping thread, or all of them, if any thread may be sleeping.
+static void
+_wake(rcutils_thread_pool_impl_t * impl, bool all)
+{
+  // Pairs with the fence of _sleep(), so that either this sees the sleeper, or the sleeper
+  // sees what was done before calling this
+  rcutils_atomic_thread_fence(memory_order_seq_cst);
+  size_t sleepers;
+  rcutils_atomic_load_explicit(&impl->sleepers, sleepers, memory_order_relaxed);
+  if (0u == sleepers) {
+    return;
+  }
+  _lock(impl);
+  size_t previous;
+  rcutils_atomic_fetch_add_explicit(&impl->epoch, previous, 1u, memory_order_relaxed);
+  RCUTILS_UNUSED(previous);
+#ifdef _WIN32
+  if (all) {
+    WakeAllConditionVariable(&impl->condition);
+  } else {
+    WakeConditionVariable(&impl->condition);
+  }
+#else
+  if (all) {
+    pthread_cond_broadcast(&impl->condition);
+  } else {
+    pthread_cond_signal(&impl->condition);
+  }
+#endif
+  _unlock(impl);
+}
+
+static uint8_t *
+_deque_slot(const rcutils_thread_pool_impl_t * impl, const _deque_t * deque, int_least64_t index)
+{
+  return deque->items + ((size_t)index & (impl->capacity - 1u)) * impl->item_size;
+}
+
+static bool
+_deque_push(rcutils_thread_pool_impl_t * impl, _deque_t * deque, const void * item)
+{
+  int_least64_t bottom, top;
+  rcutils_atomic_load_explicit(&deque->bottom, bottom, memory_order_relaxed);
+  rcutils_atomic_load_explicit(&deque->top, top, memory_order_acquire);
+  if ((size_t)(bottom - top) >= impl->capacity) {
+    return false;
+  }
+  memcpy(_deque_slot(impl, deque, bottom), item, impl->item_size);
+  rcutils_atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_release);
+  return true;
+}
+
+static bool
+_deque_pop(rcutils_thread_pool_impl_t * impl, _deque_t * deque, void * item)
+{
+  int_least64_t bottom, top;
+  rcutils_atomic_load_explicit(&deque->bottom, bottom, memory_order_relaxed);
+  bottom -= 1;
+  rcutils_atomic_store_explicit(&deque->bottom, bottom, memory_order_relaxed);
+  // Taking the item must be visible to the thieves before looking at what they took
+  rcutils_atomic_thread_fence(memory_order_seq_cst);
+  rcutils_atomic_load_explicit(&deque->top, top, memory_order_relaxed);
+  if (top > bottom) {
+    rcutils_atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+    return false;
+  }
+  memcpy(item, _deque_slot(impl, deque, bottom), impl->item_size);
+  if (top < bottom) {
+    return true;
+  }
+  // The last item, which a thief may be taking too
+  bool popped;
+  rcutils_atomic_compare_exchange_strong_explicit(
+    &deque->top, popped, &top, top + 1, memory_order_seq_cst, memory_order_relaxed);
+  rcutils_atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+  return popped;
+}
+
+static bool
+_deque_steal(rcutils_thread_pool_impl_t * impl, _deque_t * deque, void * item)
+{
+  int_least64_t top, bottom;
+  rcutils_atomic_load_explicit(&deque->top, top, memory_order_acquire);
+  rcutils_atomic_thread_fence(memory_order_seq_cst);
+  rcutils_atomic_load_explicit(&deque->bottom, bottom, memory_order_acquire);
+  if (top >= bottom) {
+    return false;
+  }
+  // The slot is only overwritten once the top moved on, in which case the copy is dropped
+  memcpy(item, _deque_slot(impl, deque, top), impl->item_size);
+  bool stolen;
+  rcutils_atomic_compare_exchange_strong_explicit(
+    &deque->top, stolen, &top, top + 1, memory_order_seq_cst, memory_order_relaxed);
+  return stolen;
+}
+
+static bool
+_shared_push(rcutils_thread_pool_impl_t * impl, const void * item)
+{
+  _lock(impl);
+  if (impl->shared_count == impl->capacity) {
+    _unlock(impl);
+    return false;
+  }
+  size_t index = (impl->shared_head + impl->shared_count) & (impl->capacity - 1u);
+  memcpy(impl->shared_items + index * impl->item_size, item, impl->item_size);
+  ++impl->shared_count;
+  rcutils_atomic_store(&impl->shared_queued, impl->shared_count);
+  _unlock(impl);
+  return true;
+}
+
+static bool
+_shared_pop(rcutils_thread_pool_impl_t * impl, void * item)
+{
+  size_t queued;
+  rcutils_atomic_load_explicit(&impl->shared_queued, queued, memory_order_relaxed);
+  if (0u == queued) {
+    return false;
+  }
+  _lock(impl);
+  bool popped = impl->shared_count > 0u;
+  if (popped) {
+    memcpy(item, impl->shared_items + impl->shared_head * impl->item_size, impl->item_size);
+    impl->shared_head = (impl->shared_head + 1u) & (impl->capacity - 1u);
+    --impl->shared_count;
+    rcutils_atomic_store(&impl->shared_queued, impl->shared_count);
+  }
+  _unlock(impl);
+  return popped;
+}
+
+// Copies an item to process into the item of the worker, from its deque first, then from the
+// shared queue, then from the deques of the other workers.
+static bool
+_find_item(_worker_t * worker)
+{
+  rcutils_thread_pool_impl_t * impl = worker->impl;
+  if (_deque_pop(impl, &worker->deque, worker->item) || _shared_pop(impl, worker->item)) {
+    return true;
+  }
+  for (size_t i = 1; i < impl->thread_count; ++i) {
+    _worker_t * victim = &impl->workers[(worker->index + i) % impl->thread_count];
+    if (_deque_steal(impl, &victim->deque, worker->item)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool
+_find_item_spinning(_worker_t * worker)
+{
+  for (size_t i = 0; i < THREAD_POOL_SPIN_COUNT; ++i) {
+    if (_find_item(worker)) {
+      return true;
+    }
+    _pause();
+  }
+  return false;
+}
+
+// An item was done with, wakes the waiting thread if it was the last.
+static void
+_finish_item(rcutils_thread_pool_impl_t * impl)
+{
+  size_t pending;
+  rcutils_atomic_fetch_sub_explicit(&impl->pending, pending, 1u, memory_order_acq_rel);
+  if (1u == pending) {
+    _wake(impl, true);
+  }
+}
+
+static void
+_process_item(_worker_t * worker)
+{
+  rcutils_thread_pool_impl_t * impl = worker->impl;
+  impl->function(&impl->pool, impl->context, worker->item);
+  _finish_item(impl);
+}
+
+static bool
+_should_sleep(rcutils_thread_pool_impl_t * impl, bool waiting)
+{
+  if (rcutils_atomic_load_bool(&impl->exit)) {
+    return false;
+  }
+  if (!waiting) {
+    return true;
+  }
+  size_t pending;
+  rcutils_atomic_load_explicit(&impl->pending, pending, memory_order_acquire);
+  return 0u != pending;
+}
+
+// Sleeps until an item is pushed, or the last one is processed if the worker is waiting,
+// unless it finds an item to process first, in which case it returns true.
+static bool
+_sleep(_worker_t * worker, bool waiting)
+{
+  rcutils_thread_pool_impl_t * impl = worker->impl;
+  size_t epoch, previous;
+  rcutils_atomic_load_explicit(&impl->epoch, epoch, memory_order_acquire);
+  rcutils_atomic_fetch_add_explicit(&impl->sleepers, previous, 1u, memory_order_relaxed);
+  // Pairs with the fence of _wake()
+  rcutils_atomic_thread_fence(memory_order_seq_cst);
+  bool found = _find_item(worker);
+  if (!found && _should_sleep(impl, waiting)) {
+    _lock(impl);
+    size_t current;
+    rcutils_atomic_load_explicit(&impl->epoch, current, memory_order_relaxed);
+    while (current == epoch && !rcutils_atomic_load_bool(&impl->exit)) {
+      _wait(impl);
+      rcutils_atomic_load_explicit(&impl->epoch, current, memory_order_relaxed);
+    }
+    _unlock(impl);
+  }
+  rcutils_atomic_fetch_sub_explicit(&impl->sleepers, previous, 1u, memory_order_relaxed);
+  RCUTILS_UNUSED(previous);
+  return found;
+}
+
+static void
+_work(_worker_t * worker)
+{
+  rcutils_thread_pool_impl_t * impl = worker->impl;
+  if (impl->has_thread_attributes) {
+    // Best effort, the thread runs anyway
+    if (RCUTILS_RET_OK != rcutils_thread_set_attributes(&impl->thread_attributes)) {
+      rcutils_reset_error();
+    }
+  }
+  gtls_rcutils_thread_pool_worker = worker;
+  while (!rcutils_atomic_load_bool(&impl->exit)) {
+    if (_find_item_spinning(worker) || _sleep(worker, false)) {
+      _process_item(worker);
+    }
+  }
+  gtls_rcutils_thread_pool_worker = NULL;
+}
+
+#ifdef _WIN32
+static DWORD WINAPI
+_worker_main(LPVOID arg)
+{
+  _work(arg);
+  return 0;
+}
+#else
+static void *
+_worker_main(void * arg)
+{
+  _work(arg);
+  return NULL;
+}
+#endif
+
+// Starts the thread of a worker, bound to the processor cpu unless it's SIZE_MAX.
+static bool
+_start_thread(_worker_t * worker, size_t cpu)
+{
+#ifdef _WIN32
+  worker->thread = CreateThread(NULL, 0, _worker_main, worker, CREATE_SUSPENDED, NULL);
+  if (NULL == worker->thread) {
+    return false;
+  }
+  if (cpu < sizeof(DWORD_PTR) * 8u) {
+    // Binding is best effort, the thread runs anyway
+    (void)SetThreadAffinityMask(worker->thread, (DWORD_PTR)1 << cpu);
+  }
+  ResumeThread(worker->thread);
+  return true;
+#else
+  pthread_attr_t attributes;
+  if (0 != pthread_attr_init(&attributes)) {
+    return false;
+  }
+# ifdef THREAD_POOL_HAS_AFFINITY
+  if (cpu < CPU_SETSIZE) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    (void)pthread_attr_setaffinity_np(&attributes, sizeof(cpus), &cpus);
+  }
+# else
+  RCUTILS_UNUSED(cpu);
+# endif
+  int result = pthread_create(&worker->thread, &attributes, _worker_main, worker);
+  pthread_attr_destroy(&attributes);
+  return 0 == result;
+#endif
+}
+
+static void
+_deallocate(rcutils_thread_pool_impl_t * impl)
+{
+  rcutils_allocator_t allocator = impl->allocator;
+  if (NULL != impl->workers) {
+    for (size_t i = 0; i < impl->thread_count; ++i) {
+      allocator.deallocate(impl->workers[i].deque.items, allocator.state);
+    }
+  }
+  allocator.deallocate(impl->workers, allocator.state);
+  allocator.deallocate(impl->shared_items, allocator.state);
+  allocator.deallocate(impl, allocator.state);
+}
+
+rcutils_thread_pool_t
+rcutils_get_zero_initialized_thread_pool(void)
+{
+  static rcutils_thread_pool_t zero_initialized_thread_pool = {NULL};
+  return zero_initialized_thread_pool;
+}
+
+rcutils_thread_pool_options_t
+rcutils_thread_pool_get_default_options(void)
+{
+  static rcutils_thread_pool_options_t default_options = {
+    .thread_count = 0u,
+    .capacity = RCUTILS_THREAD_POOL_DEFAULT_CAPACITY,
+    .cpu_affinity = NULL,
+    .cpu_affinity_count = 0u,
+    .thread_attributes = NULL,
+  };
+  return default_options;
+}
+
+size_t
+rcutils_thread_pool_get_processor_count(void)
+{
+#ifdef _WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return info.dwNumberOfProcessors > 0 ? (size_t)info.dwNumberOfProcessors : 1u;
+#else
+  long count = sysconf(_SC_NPROCESSORS_ONLN);
+  return count > 0 ? (size_t)count : 1u;
+#endif
+}
+
+rcutils_ret_t
+rcutils_thread_pool_init(
+  rcutils_thread_pool_t * pool,
+  rcutils_thread_pool_function_t function,
+  void * context,
+  size_t item_size,
+  const rcutils_thread_pool_options_t * options,
+  rcutils_allocator_t allocator)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(pool, RCUTILS_RET_INVALID_ARGUMENT);
+  if (NULL != pool->impl) {
+    RCUTILS_SET_ERROR_MSG("pool is already initialized");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(function, RCUTILS_RET_INVALID_ARGUMENT);
+  if (0u == item_size) {
+    RCUTILS_SET_ERROR_MSG("item_size is 0");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  RCUTILS_CHECK_ALLOCATOR_WITH_MSG(
+    &allocator, "invalid allocator", return RCUTILS_RET_INVALID_ARGUMENT);
+  rcutils_thread_pool_options_t default_options = rcutils_thread_pool_get_default_options();
+  if (NULL == options) {
+    options = &default_options;
+  }
+  if (0u != options->cpu_affinity_count && NULL == options->cpu_affinity) {
+    RCUTILS_SET_ERROR_MSG("cpu_affinity is null");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  size_t thread_count = options->thread_count;
+  if (0u == thread_count) {
+    thread_count = rcutils_thread_pool_get_processor_count();
+  }
+  size_t capacity = 0u != options->capacity ?
+    options->capacity : RCUTILS_THREAD_POOL_DEFAULT_CAPACITY;
+  // The deques wrap around with masks
+  size_t rounded_capacity = 1u;
+  while (rounded_capacity < capacity && rounded_capacity <= SIZE_MAX / 4u) {
+    rounded_capacity *= 2u;
+  }
+  if (
+    rounded_capacity < capacity || SIZE_MAX / item_size < rounded_capacity ||
+    SIZE_MAX / sizeof(_worker_t) < thread_count)
+  {
+    RCUTILS_SET_ERROR_MSG("capacity or thread_count is too large");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+
+  rcutils_thread_pool_impl_t * impl = allocator.zero_allocate(
+    1u, sizeof(rcutils_thread_pool_impl_t), allocator.state);
+  if (NULL == impl) {
+    RCUTILS_SET_ERROR_MSG("failed to allocate the thread pool");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  impl->pool.impl = impl;
+  impl->function = function;
+  impl->context = context;
+  impl->allocator = allocator;
+  impl->item_size = item_size;
+  impl->capacity = rounded_capacity;
+  impl->thread_count = thread_count;
+  if (NULL != options->thread_attributes) {
+    impl->has_thread_attributes = true;
+    impl->thread_attributes = *options->thread_attributes;
+    if (NULL != options->thread_attributes->cpus) {
+      impl->thread_cpus = *options->thread_attributes->cpus;
+      impl->thread_attributes.cpus = &impl->thread_cpus;
+    }
+    if (NULL != options->thread_attributes->name) {
+      // Truncated as the thread would anyway
+      size_t length = strnlen(options->thread_attributes->name, sizeof(impl->thread_name) - 1u);
+      memcpy(impl->thread_name, options->thread_attributes->name, length);
+      impl->thread_attributes.name = impl->thread_name;
+    }
+  }
+  rcutils_atomic_store(&impl->pending, (size_t)0u);
+  rcutils_atomic_store(&impl->sleepers, (size_t)0u);
+  rcutils_atomic_store(&impl->epoch, (size_t)0u);
+  rcutils_atomic_store(&impl->exit, false);
+  rcutils_atomic_store(&impl->shared_queued, (size_t)0u);
+  impl->shared_items = allocator.allocate(rounded_capacity * item_size, allocator.state);
+  impl->workers = allocator.zero_allocate(thread_count, sizeof(_worker_t), allocator.state);
+  if (NULL == impl->shared_items || NULL == impl->workers) {
+    _deallocate(impl);
+    RCUTILS_SET_ERROR_MSG("failed to allocate the thread pool");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  for (size_t i = 0; i < thread_count; ++i) {
+    _worker_t * worker = &impl->workers[i];
+    worker->impl = impl;
+    worker->index = i;
+    rcutils_atomic_store(&worker->deque.top, (int_least64_t)0);
+    rcutils_atomic_store(&worker->deque.bottom, (int_least64_t)0);
+    // The deque, then the item of the worker
+    worker->deque.items = allocator.allocate((rounded_capacity + 1u) * item_size, allocator.state);
+    if (NULL == worker->deque.items) {
+      _deallocate(impl);
+      RCUTILS_SET_ERROR_MSG("failed to allocate the thread pool");
+      return RCUTILS_RET_BAD_ALLOC;
+    }
+    worker->item = worker->deque.items + rounded_capacity * item_size;
+  }
+#ifdef _WIN32
+  InitializeCriticalSection(&impl->mutex);
+  InitializeConditionVariable(&impl->condition);
+#else
+  if (0 != pthread_mutex_init(&impl->mutex, NULL)) {
+    _deallocate(impl);
+    RCUTILS_SET_ERROR_MSG("failed to initialize the mutex of the thread pool");
+    return RCUTILS_RET_ERROR;
+  }
+  if (0 != pthread_cond_init(&impl->condition, NULL)) {
+    pthread_mutex_destroy(&impl->mutex);
+    _deallocate(impl);
+    RCUTILS_SET_ERROR_MSG("failed to initialize the condition of the thread pool");
+    return RCUTILS_RET_ERROR;
+  }
+#endif
+
+  // The threads are started last, as they use the pool right away
+  for (size_t i = 1; i < thread_count; ++i) {
+    size_t cpu = SIZE_MAX;
+    if (0u != options->cpu_affinity_count) {
+      cpu = options->cpu_affinity[impl->started_threads % options->cpu_affinity_count];
+    }
+    if (!_start_thread(&impl->workers[impl->started_threads + 1u], cpu)) {
+      break;
+    }
+    ++impl->started_threads;
+  }
+  pool->impl = impl;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_thread_pool_push(rcutils_thread_pool_t * pool, const void * item)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(pool, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(pool->impl, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(item, RCUTILS_RET_INVALID_ARGUMENT);
+  rcutils_thread_pool_impl_t * impl = pool->impl;
+  // Counted before it's queued, so that it's not processed before
+  size_t pending;
+  rcutils_atomic_fetch_add_explicit(&impl->pending, pending, 1u, memory_order_relaxed);
+  RCUTILS_UNUSED(pending);
+  _worker_t * worker = gtls_rcutils_thread_pool_worker;
+  bool pushed = (NULL != worker && worker->impl == impl) ?
+    _deque_push(impl, &worker->deque, item) : false;
+  if (!pushed && !_shared_push(impl, item)) {
+    // Pending may have been seen by the waiting thread
+    _finish_item(impl);
+    return RCUTILS_RET_NOT_ENOUGH_SPACE;
+  }
+  _wake(impl, false);
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_thread_pool_wait(rcutils_thread_pool_t * pool)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(pool, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(pool->impl, RCUTILS_RET_INVALID_ARGUMENT);
+  rcutils_thread_pool_impl_t * impl = pool->impl;
+  _worker_t * worker = &impl->workers[0];
+  // The thread may be a worker of another pool, processing one of its items
+  _worker_t * previous_worker = gtls_rcutils_thread_pool_worker;
+  gtls_rcutils_thread_pool_worker = worker;
+  for (;;) {
+    size_t pending;
+    rcutils_atomic_load_explicit(&impl->pending, pending, memory_order_acquire);
+    if (0u == pending) {
+      break;
+    }
+    if (_find_item_spinning(worker) || _sleep(worker, true)) {
+      _process_item(worker);
+    }
+  }
+  gtls_rcutils_thread_pool_worker = previous_worker;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_thread_pool_fini(rcutils_thread_pool_t * pool)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(pool, RCUTILS_RET_INVALID_ARGUMENT);
+  rcutils_thread_pool_impl_t * impl = pool->impl;
+  if (NULL == impl) {
+    return RCUTILS_RET_OK;
+  }
+  _lock(impl);
+  rcutils_atomic_store(&impl->exit, true);
+#ifdef _WIN32
+  WakeAllConditionVariable(&impl->condition);
+#else
+  pthread_cond_broadcast(&impl->condition);
+#endif
+  _unlock(impl);
+  for (size_t i = 1; i <= impl->started_threads; ++i) {
+#ifdef _WIN32
+    WaitForSingleObject(impl->workers[i].thread, INFINITE);
+    CloseHandle(impl->workers[i].thread);
+#else
+    pthread_join(impl->workers[i].thread, NULL);
+#endif
+  }
+#ifdef _WIN32
+  DeleteCriticalSection(&impl->mutex);
+#else
+  pthread_cond_destroy(&impl->condition);
+  pthread_mutex_destroy(&impl->mutex);
+#endif
+  _deallocate(impl);
+  pool->impl = NULL;
+  return RCUTILS_RET_OK;
+}
+
+#ifdef __cplusplus
+}
+#endif
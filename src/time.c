@@ -19,14 +19,115 @@ extern "C"
 
 #include "rcutils/time.h"
 
-#include <inttypes.h>
+#include <stdbool.h>
 #include <stdint.h>
-#include <stdio.h>
-#include <stdlib.h>
+#include <string.h>
 
-#include "rcutils/allocator.h"
 #include "rcutils/error_handling.h"
-#include "rcutils/snprintf.h"
+
+// The two digit decimal renderings of 0 to 99, so that digits are rendered two at a time.
+static const char g_rcutils_time_digit_pairs[200] = {
+  '0', '0', '0', '1', '0', '2', '0', '3', '0', '4', '0', '5', '0', '6', '0', '7', '0', '8',
+  '0', '9', '1', '0', '1', '1', '1', '2', '1', '3', '1', '4', '1', '5', '1', '6', '1', '7',
+  '1', '8', '1', '9', '2', '0', '2', '1', '2', '2', '2', '3', '2', '4', '2', '5', '2', '6',
+  '2', '7', '2', '8', '2', '9', '3', '0', '3', '1', '3', '2', '3', '3', '3', '4', '3', '5',
+  '3', '6', '3', '7', '3', '8', '3', '9', '4', '0', '4', '1', '4', '2', '4', '3', '4', '4',
+  '4', '5', '4', '6', '4', '7', '4', '8', '4', '9', '5', '0', '5', '1', '5', '2', '5', '3',
+  '5', '4', '5', '5', '5', '6', '5', '7', '5', '8', '5', '9', '6', '0', '6', '1', '6', '2',
+  '6', '3', '6', '4', '6', '5', '6', '6', '6', '7', '6', '8', '6', '9', '7', '0', '7', '1',
+  '7', '2', '7', '3', '7', '4', '7', '5', '7', '6', '7', '7', '7', '8', '7', '9', '8', '0',
+  '8', '1', '8', '2', '8', '3', '8', '4', '8', '5', '8', '6', '8', '7', '8', '8', '8', '9',
+  '9', '0', '9', '1', '9', '2', '9', '3', '9', '4', '9', '5', '9', '6', '9', '7', '9', '8',
+  '9', '9',
+};
+
+// Render the width lowest decimal digits of value, zero padded, into str.
+static void
+_format_digits(uint64_t value, size_t width, char * str)
+{
+  char * end = str + width;
+  while (width >= 2u) {
+    end -= 2;
+    memcpy(end, &g_rcutils_time_digit_pairs[(value % 100u) * 2u], 2u);
+    value /= 100u;
+    width -= 2u;
+  }
+  if (width > 0u) {
+    *--end = (char)('0' + value % 10u);
+  }
+}
+
+// Write the sign of the time point, returning its absolute value, which also works for
+// INT64_MIN, and setting the length to the number of characters written.
+static uint64_t
+_format_sign(rcutils_time_point_value_t time_point, char * str, size_t * length)
+{
+  *length = 0u;
+  if (time_point >= 0) {
+    return (uint64_t)time_point;
+  }
+  str[(*length)++] = '-';
+  return (uint64_t)(-(time_point + 1)) + 1u;
+}
+
+// Copy the formatted string into str, truncated to fit into str_size characters.
+static void
+_copy_truncated(const char * formatted, size_t length, char * str, size_t str_size)
+{
+  if (length > str_size - 1u) {
+    length = str_size - 1u;
+  }
+  memcpy(str, formatted, length);
+  str[length] = '\0';
+}
+
+size_t
+rcutils_time_point_value_format_nanoseconds(rcutils_time_point_value_t time_point, char * str)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(str, 0u);
+  size_t length;
+  uint64_t abs_time_point = _format_sign(time_point, str, &length);
+  _format_digits(abs_time_point, 19u, str + length);
+  length += 19u;
+  str[length] = '\0';
+  return length;
+}
+
+size_t
+rcutils_time_point_value_format_seconds(
+  rcutils_time_point_value_t time_point,
+  rcutils_time_point_precision_t precision,
+  char * str)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(str, 0u);
+  uint64_t divisor;
+  switch (precision) {
+    case RCUTILS_TIME_POINT_PRECISION_MILLISECONDS:
+      divisor = 1000u * 1000u;
+      break;
+    case RCUTILS_TIME_POINT_PRECISION_MICROSECONDS:
+      divisor = 1000u;
+      break;
+    case RCUTILS_TIME_POINT_PRECISION_NANOSECONDS:
+      divisor = 1u;
+      break;
+    default:
+      RCUTILS_SET_ERROR_MSG("invalid precision");
+      return 0u;
+  }
+  size_t length;
+  uint64_t abs_time_point = _format_sign(time_point, str, &length);
+  // break into two parts to avoid floating point error
+  uint64_t seconds = abs_time_point / (1000u * 1000u * 1000u);
+  uint64_t nanoseconds = abs_time_point % (1000u * 1000u * 1000u);
+  _format_digits(seconds, 10u, str + length);
+  length += 10u;
+  str[length++] = '.';
+  _format_digits(nanoseconds / divisor, (size_t)precision, str + length);
+  length += (size_t)precision;
+  str[length] = '\0';
+  return length;
+}
 
 rcutils_ret_t
 rcutils_time_point_value_as_nanoseconds_string(
@@ -39,10 +140,9 @@ rcutils_time_point_value_as_nanoseconds_string(
   if (0 == str_size) {
     return RCUTILS_RET_OK;
   }
-  if (rcutils_snprintf(str, str_size, "%.19" PRId64, *time_point) < 0) {
-    RCUTILS_SET_ERROR_MSG("failed to format time point into string as nanoseconds");
-    return RCUTILS_RET_ERROR;
-  }
+  char formatted[RCUTILS_TIME_POINT_FORMAT_STRING_SIZE];
+  size_t length = rcutils_time_point_value_format_nanoseconds(*time_point, formatted);
+  _copy_truncated(formatted, length, str, str_size);
   return RCUTILS_RET_OK;
 }
 
@@ -57,20 +157,87 @@ rcutils_time_point_value_as_seconds_string(
   if (0 == str_size) {
     return RCUTILS_RET_OK;
   }
-  // best to abs it to avoid issues with negative values in C89, see:
-  //   https://stackoverflow.com/a/3604984/671658
-  uint64_t abs_time_point = (uint64_t)llabs(*time_point);
-  // break into two parts to avoid floating point error
-  uint64_t seconds = abs_time_point / (1000u * 1000u * 1000u);
-  uint64_t nanoseconds = abs_time_point % (1000u * 1000u * 1000u);
-  if (
-    rcutils_snprintf(
-      str, str_size, "%s%.10" PRId64 ".%.9" PRId64,
-      (*time_point >= 0) ? "" : "-", seconds, nanoseconds) < 0)
-  {
-    RCUTILS_SET_ERROR_MSG("failed to format time point into string as float seconds");
+  char formatted[RCUTILS_TIME_POINT_FORMAT_STRING_SIZE];
+  size_t length = rcutils_time_point_value_format_seconds(
+    *time_point, RCUTILS_TIME_POINT_PRECISION_NANOSECONDS, formatted);
+  _copy_truncated(formatted, length, str, str_size);
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_time_correlate_clocks(size_t samples, rcutils_time_correlation_t * correlation)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(correlation, RCUTILS_RET_INVALID_ARGUMENT);
+  if (0u == samples) {
+    RCUTILS_SET_ERROR_MSG("at least one sample is needed");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  bool sampled = false;
+  for (size_t i = 0; i < samples; ++i) {
+    rcutils_time_point_value_t before, system_time, after;
+    if (
+      RCUTILS_RET_OK != rcutils_steady_time_now(&before) ||
+      RCUTILS_RET_OK != rcutils_system_time_now(&system_time) ||
+      RCUTILS_RET_OK != rcutils_steady_time_now(&after))
+    {
+      return RCUTILS_RET_ERROR;
+    }
+    // A longer interval means the thread was likely preempted between the reads.
+    rcutils_duration_value_t interval = after - before;
+    if (!sampled || interval < correlation->uncertainty) {
+      correlation->system_time = system_time;
+      correlation->steady_time = before + interval / 2;
+      correlation->offset = system_time - correlation->steady_time;
+      correlation->uncertainty = interval;
+      sampled = true;
+    }
+  }
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_time_correlation_steady_to_system(
+  const rcutils_time_correlation_t * correlation,
+  const rcutils_time_point_value_t * steady_times,
+  rcutils_time_point_value_t * system_times,
+  size_t count)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(correlation, RCUTILS_RET_INVALID_ARGUMENT);
+  if (0u == count) {
+    return RCUTILS_RET_OK;
+  }
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(steady_times, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(system_times, RCUTILS_RET_INVALID_ARGUMENT);
+  const rcutils_duration_value_t offset = correlation->offset;
+  for (size_t i = 0; i < count; ++i) {
+    system_times[i] = steady_times[i] + offset;
+  }
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_sleep_spin_until_steady(
+  rcutils_time_point_value_t deadline,
+  rcutils_duration_value_t spin_margin)
+{
+  if (spin_margin < 0) {
+    RCUTILS_SET_ERROR_MSG("spin margin must not be negative");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  rcutils_time_point_value_t now;
+  if (RCUTILS_RET_OK != rcutils_steady_time_now(&now)) {
     return RCUTILS_RET_ERROR;
   }
+  if (deadline - now > spin_margin) {
+    if (RCUTILS_RET_OK != rcutils_sleep_until_steady(deadline - spin_margin)) {
+      return RCUTILS_RET_ERROR;
+    }
+  }
+  do {
+    if (RCUTILS_RET_OK != rcutils_steady_time_now(&now)) {
+      return RCUTILS_RET_ERROR;
+    }
+  } while (now < deadline);
   return RCUTILS_RET_OK;
 }
 
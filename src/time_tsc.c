@@ -0,0 +1,231 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+# define RCUTILS_TSC_X86
+# if defined(_MSC_VER)
+#  include <intrin.h>
+# else
+#  include <cpuid.h>
+#  include <x86intrin.h>
+# endif
+#elif defined(__aarch64__)
+# define RCUTILS_TSC_ARM64
+#endif
+
+#include "rcutils/error_handling.h"
+#include "rcutils/lock.h"
+#include "rcutils/stdatomic_helper.h"
+#include "rcutils/time.h"
+
+// The duration of each of the two measurements of the frequency of the time stamp counter.
+#define RCUTILS_TSC_CALIBRATION_NS RCUTILS_MS_TO_NS(10)
+// How much the two measurements may differ, in parts per million.
+#define RCUTILS_TSC_CALIBRATION_TOLERANCE_PPM 5000u
+// The frequencies considered plausible, the conversion needs less than 2^64 / 10^9 Hz.
+#define RCUTILS_TSC_MIN_FREQUENCY 1000000u
+#define RCUTILS_TSC_MAX_FREQUENCY 10000000000u
+
+#if defined(RCUTILS_TSC_X86) || defined(RCUTILS_TSC_ARM64)
+typedef struct rcutils_tsc_calibration_t
+{
+  uint64_t base_ticks;
+  rcutils_time_point_value_t base_ns;
+  uint64_t frequency;
+  // The nanoseconds per tick, as a fixed point number with 32 fractional bits.
+  uint64_t multiplier;
+} rcutils_tsc_calibration_t;
+
+// The calibration, only read once g_rcutils_tsc_enabled is set, and copied under the seqlock
+// so that calibrating again doesn't tear it for the threads reading the clock.
+static rcutils_tsc_calibration_t g_rcutils_tsc_calibration;
+static rcutils_seqlock_t g_rcutils_tsc_calibration_lock;
+# if defined(__SIZEOF_INT128__)
+__extension__ typedef unsigned __int128 rcutils_tsc_uint128_t;
+# endif
+#endif
+static atomic_bool g_rcutils_tsc_enabled = ATOMIC_VAR_INIT(false);
+
+#if defined(RCUTILS_TSC_X86) || defined(RCUTILS_TSC_ARM64)
+static uint64_t
+_read_ticks(void)
+{
+#if defined(RCUTILS_TSC_X86)
+  return (uint64_t)__rdtsc();
+#else
+  uint64_t ticks;
+  __asm__ __volatile__ ("isb\n\tmrs %0, cntvct_el0" : "=r" (ticks) : : "memory");
+  return ticks;
+#endif
+}
+
+static bool
+_ticks_are_reliable(void)
+{
+#if defined(RCUTILS_TSC_X86)
+  // The invariant TSC flag is bit 8 of edx in the 0x80000007 leaf
+# if defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 0x80000000);
+  if ((unsigned int)info[0] < 0x80000007u) {
+    return false;
+  }
+  __cpuid(info, 0x80000007);
+  if (0 == ((unsigned int)info[3] & (1u << 8))) {
+    return false;
+  }
+# else
+  unsigned int eax, ebx, ecx, edx;
+  if (0 == __get_cpuid(0x80000007u, &eax, &ebx, &ecx, &edx) || 0 == (edx & (1u << 8))) {
+    return false;
+  }
+# endif
+# if defined(__linux__)
+  // The kernel switches to another clocksource when it finds the TSC unstable
+  FILE * file = fopen("/sys/devices/system/clocksource/clocksource0/current_clocksource", "r");
+  if (NULL != file) {
+    char clocksource[32] = {0};
+    bool is_tsc = NULL != fgets(clocksource, sizeof(clocksource), file) &&
+      0 == strncmp(clocksource, "tsc", 3);
+    fclose(file);
+    if (!is_tsc) {
+      return false;
+    }
+  }
+# endif
+  return true;
+#else
+  // The generic timer of ARMv8 has an architecturally constant frequency
+  return true;
+#endif
+}
+
+// Measures the frequency of the time stamp counter, and the ticks at the end time point.
+static rcutils_ret_t
+_measure_frequency(uint64_t * frequency, uint64_t * end_ticks, rcutils_time_point_value_t * end)
+{
+  rcutils_time_point_value_t start;
+  if (RCUTILS_RET_OK != rcutils_steady_time_now(&start)) {
+    return RCUTILS_RET_ERROR;
+  }
+  uint64_t start_ticks = _read_ticks();
+  do {
+    if (RCUTILS_RET_OK != rcutils_steady_time_now(end)) {
+      return RCUTILS_RET_ERROR;
+    }
+  } while (*end - start < RCUTILS_TSC_CALIBRATION_NS);
+  *end_ticks = _read_ticks();
+  if (*end_ticks <= start_ticks) {
+    *frequency = 0;
+    return RCUTILS_RET_OK;
+  }
+  *frequency = (*end_ticks - start_ticks) * 1000000000u / (uint64_t)(*end - start);
+  return RCUTILS_RET_OK;
+}
+#endif
+
+rcutils_ret_t
+rcutils_tsc_steady_time_init(void)
+{
+  rcutils_atomic_store(&g_rcutils_tsc_enabled, false);
+#if defined(RCUTILS_TSC_X86) || defined(RCUTILS_TSC_ARM64)
+  if (!_ticks_are_reliable()) {
+    return RCUTILS_RET_OK;
+  }
+  uint64_t first_frequency, second_frequency, first_ticks, second_ticks;
+  rcutils_time_point_value_t first_end, second_end;
+  if (
+    RCUTILS_RET_OK != _measure_frequency(&first_frequency, &first_ticks, &first_end) ||
+    RCUTILS_RET_OK != _measure_frequency(&second_frequency, &second_ticks, &second_end))
+  {
+    RCUTILS_SET_ERROR_MSG("failed to read the steady clock");
+    return RCUTILS_RET_ERROR;
+  }
+  if (
+    first_frequency < RCUTILS_TSC_MIN_FREQUENCY || first_frequency > RCUTILS_TSC_MAX_FREQUENCY ||
+    second_frequency < RCUTILS_TSC_MIN_FREQUENCY || second_frequency > RCUTILS_TSC_MAX_FREQUENCY)
+  {
+    return RCUTILS_RET_OK;
+  }
+  uint64_t difference = first_frequency > second_frequency ?
+    first_frequency - second_frequency : second_frequency - first_frequency;
+  if (difference > second_frequency / 1000000u * RCUTILS_TSC_CALIBRATION_TOLERANCE_PPM) {
+    return RCUTILS_RET_OK;
+  }
+  rcutils_tsc_calibration_t calibration;
+  calibration.base_ticks = second_ticks;
+  calibration.base_ns = second_end;
+  calibration.frequency = (first_frequency + second_frequency) / 2u;
+  calibration.multiplier = (1000000000ull << 32) / calibration.frequency;
+  rcutils_seqlock_write(
+    &g_rcutils_tsc_calibration_lock, &g_rcutils_tsc_calibration, &calibration,
+    sizeof(calibration));
+  rcutils_atomic_store(&g_rcutils_tsc_enabled, true);
+#endif
+  return RCUTILS_RET_OK;
+}
+
+bool
+rcutils_tsc_steady_time_is_enabled(void)
+{
+  return rcutils_atomic_load_bool(&g_rcutils_tsc_enabled);
+}
+
+rcutils_ret_t
+rcutils_tsc_steady_time_now(rcutils_time_point_value_t * now)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(now, RCUTILS_RET_INVALID_ARGUMENT);
+#if defined(RCUTILS_TSC_X86) || defined(RCUTILS_TSC_ARM64)
+  if (rcutils_atomic_load_bool(&g_rcutils_tsc_enabled)) {
+    rcutils_tsc_calibration_t calibration;
+    rcutils_seqlock_read(
+      &g_rcutils_tsc_calibration_lock, &calibration, &g_rcutils_tsc_calibration,
+      sizeof(calibration));
+    uint64_t ticks = _read_ticks();
+    // Another core may be a few ticks behind the one of the calibration
+    if (ticks < calibration.base_ticks) {
+      *now = calibration.base_ns;
+      return RCUTILS_RET_OK;
+    }
+    uint64_t delta = ticks - calibration.base_ticks;
+#if defined(__SIZEOF_INT128__)
+    // A multiplication rather than divisions, which cost as much as reading the counter
+    *now = calibration.base_ns + (rcutils_time_point_value_t)(
+      ((rcutils_tsc_uint128_t)delta * calibration.multiplier) >> 32);
+#else
+    // Split the conversion to not overflow, the remainder is less than the frequency
+    uint64_t seconds = delta / calibration.frequency;
+    uint64_t remainder = delta % calibration.frequency;
+    *now = calibration.base_ns + (rcutils_time_point_value_t)(
+      seconds * 1000000000u + remainder * 1000000000u / calibration.frequency);
+#endif
+    return RCUTILS_RET_OK;
+  }
+#endif
+  return rcutils_steady_time_now(now);
+}
+
+#ifdef __cplusplus
+}
+#endif
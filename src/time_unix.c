@@ -24,9 +24,10 @@ extern "C"
 #include "rcutils/time.h"
 
 #if defined(__MACH__)
-#include <mach/clock.h>
-#include <mach/mach.h>
+#include <mach/mach_time.h>
+#include <sys/time.h>
 #endif  // defined(__MACH__)
+#include <errno.h>
 #include <math.h>
 #include <time.h>
 #include <unistd.h>
@@ -34,8 +35,9 @@ extern "C"
 #include "./common.h"
 #include "rcutils/allocator.h"
 #include "rcutils/error_handling.h"
+#include "rcutils/stdatomic_helper.h"
 
-#if !defined(__MACH__)  // Assume clock_get_time is available on OS X.
+#if !defined(__MACH__)  // Assume mach_absolute_time is available on OS X.
 // This id an appropriate check for clock_gettime() according to:
 //   http://man7.org/linux/man-pages/man2/clock_gettime.2.html
 # if !defined(_POSIX_TIMERS) || !_POSIX_TIMERS
@@ -45,20 +47,46 @@ extern "C"
 
 #define __WOULD_BE_NEGATIVE(seconds, subseconds) (seconds < 0 || (subseconds < 0 && seconds == 0))
 
+#if defined(__MACH__) && !defined(CLOCK_UPTIME_RAW)
+// The timebase of mach_absolute_time(), its numerator in the high 32 bits and its
+// denominator in the low 32 bits, or 0 until it is first queried.
+static atomic_uint_least64_t g_rcutils_mach_timebase = ATOMIC_VAR_INIT(0);
+
+static rcutils_time_point_value_t
+__mach_absolute_time_to_ns(uint64_t ticks)
+{
+  uint64_t timebase;
+  rcutils_atomic_load(&g_rcutils_mach_timebase, timebase);
+  if (0u == timebase) {
+    mach_timebase_info_data_t info;
+    mach_timebase_info(&info);
+    timebase = ((uint64_t)info.numer << 32) | info.denom;
+    rcutils_atomic_store(&g_rcutils_mach_timebase, timebase);
+  }
+  uint64_t numer = timebase >> 32;
+  uint64_t denom = timebase & 0xFFFFFFFFu;
+  // Split the conversion to not overflow, the remainder is less than the denominator.
+  return (rcutils_time_point_value_t)(
+    (ticks / denom) * numer + (ticks % denom) * numer / denom);
+}
+#endif  // defined(__MACH__) && !defined(CLOCK_UPTIME_RAW)
+
 rcutils_ret_t
 rcutils_system_time_now(rcutils_time_point_value_t * now)
 {
   RCUTILS_CHECK_ARGUMENT_FOR_NULL(now, RCUTILS_RET_INVALID_ARGUMENT);
   struct timespec timespec_now;
 #if defined(__MACH__)
-  // On OS X use clock_get_time.
-  clock_serv_t cclock;
-  mach_timespec_t mts;
-  host_get_clock_service(mach_host_self(), CALENDAR_CLOCK, &cclock);
-  clock_get_time(cclock, &mts);
-  mach_port_deallocate(mach_task_self(), cclock);
-  timespec_now.tv_sec = mts.tv_sec;
-  timespec_now.tv_nsec = mts.tv_nsec;
+  // On OS X avoid the clock services, which take Mach calls for each time point.
+#if defined(CLOCK_REALTIME)
+  *now = (rcutils_time_point_value_t)clock_gettime_nsec_np(CLOCK_REALTIME);
+  return RCUTILS_RET_OK;
+#else  // defined(CLOCK_REALTIME)
+  struct timeval timeval_now;
+  gettimeofday(&timeval_now, NULL);
+  timespec_now.tv_sec = timeval_now.tv_sec;
+  timespec_now.tv_nsec = (long)RCUTILS_US_TO_NS(timeval_now.tv_usec);
+#endif  // defined(CLOCK_REALTIME)
 #else  // defined(__MACH__)
   // Otherwise use clock_gettime.
   clock_gettime(CLOCK_REALTIME, &timespec_now);
@@ -78,14 +106,13 @@ rcutils_steady_time_now(rcutils_time_point_value_t * now)
   // If clock_gettime is available or on OS X, use a timespec.
   struct timespec timespec_now;
 #if defined(__MACH__)
-  // On OS X use clock_get_time.
-  clock_serv_t cclock;
-  mach_timespec_t mts;
-  host_get_clock_service(mach_host_self(), SYSTEM_CLOCK, &cclock);
-  clock_get_time(cclock, &mts);
-  mach_port_deallocate(mach_task_self(), cclock);
-  timespec_now.tv_sec = mts.tv_sec;
-  timespec_now.tv_nsec = mts.tv_nsec;
+  // On OS X use the clock of mach_absolute_time(), read without any Mach call.
+#if defined(CLOCK_UPTIME_RAW)
+  *now = (rcutils_time_point_value_t)clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+#else  // defined(CLOCK_UPTIME_RAW)
+  *now = __mach_absolute_time_to_ns(mach_absolute_time());
+#endif  // defined(CLOCK_UPTIME_RAW)
+  return RCUTILS_RET_OK;
 #else  // defined(__MACH__)
   // Otherwise use clock_gettime.
 #if defined(CLOCK_MONOTONIC_RAW)
@@ -102,6 +129,107 @@ rcutils_steady_time_now(rcutils_time_point_value_t * now)
   return RCUTILS_RET_OK;
 }
 
+rcutils_ret_t
+rcutils_coarse_steady_time_now(rcutils_time_point_value_t * now)
+{
+#if defined(CLOCK_MONOTONIC_COARSE)
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(now, RCUTILS_RET_INVALID_ARGUMENT);
+  struct timespec timespec_now;
+  clock_gettime(CLOCK_MONOTONIC_COARSE, &timespec_now);
+  if (__WOULD_BE_NEGATIVE(timespec_now.tv_sec, timespec_now.tv_nsec)) {
+    RCUTILS_SET_ERROR_MSG("unexpected negative time");
+    return RCUTILS_RET_ERROR;
+  }
+  *now = RCUTILS_S_TO_NS((int64_t)timespec_now.tv_sec) + timespec_now.tv_nsec;
+  return RCUTILS_RET_OK;
+#else  // defined(CLOCK_MONOTONIC_COARSE)
+  return rcutils_steady_time_now(now);
+#endif  // defined(CLOCK_MONOTONIC_COARSE)
+}
+
+rcutils_ret_t
+rcutils_coarse_system_time_now(rcutils_time_point_value_t * now)
+{
+#if defined(CLOCK_REALTIME_COARSE)
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(now, RCUTILS_RET_INVALID_ARGUMENT);
+  struct timespec timespec_now;
+  clock_gettime(CLOCK_REALTIME_COARSE, &timespec_now);
+  if (__WOULD_BE_NEGATIVE(timespec_now.tv_sec, timespec_now.tv_nsec)) {
+    RCUTILS_SET_ERROR_MSG("unexpected negative time");
+    return RCUTILS_RET_ERROR;
+  }
+  *now = RCUTILS_S_TO_NS((int64_t)timespec_now.tv_sec) + timespec_now.tv_nsec;
+  return RCUTILS_RET_OK;
+#else  // defined(CLOCK_REALTIME_COARSE)
+  return rcutils_system_time_now(now);
+#endif  // defined(CLOCK_REALTIME_COARSE)
+}
+
+rcutils_ret_t
+rcutils_coarse_time_resolution(rcutils_duration_value_t * resolution)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(resolution, RCUTILS_RET_INVALID_ARGUMENT);
+#if defined(__MACH__)
+  // The coarse clocks are the precise ones, with a nanosecond resolution.
+  *resolution = 1;
+#else  // defined(__MACH__)
+  struct timespec timespec_resolution;
+#if defined(CLOCK_MONOTONIC_COARSE)
+  const clockid_t clock = CLOCK_MONOTONIC_COARSE;
+#elif defined(CLOCK_MONOTONIC_RAW)
+  const clockid_t clock = CLOCK_MONOTONIC_RAW;
+#else
+  const clockid_t clock = CLOCK_MONOTONIC;
+#endif
+  if (0 != clock_getres(clock, &timespec_resolution)) {
+    RCUTILS_SET_ERROR_MSG("failed to get the resolution of the clock");
+    return RCUTILS_RET_ERROR;
+  }
+  *resolution = RCUTILS_S_TO_NS((int64_t)timespec_resolution.tv_sec) + timespec_resolution.tv_nsec;
+#endif  // defined(__MACH__)
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_sleep_until_steady(rcutils_time_point_value_t deadline)
+{
+  rcutils_time_point_value_t now;
+  if (RCUTILS_RET_OK != rcutils_steady_time_now(&now)) {
+    return RCUTILS_RET_ERROR;
+  }
+  while (now < deadline) {
+    rcutils_duration_value_t remaining = deadline - now;
+#if !defined(__MACH__) && defined(_POSIX_CLOCK_SELECTION) && _POSIX_CLOCK_SELECTION > 0
+    // The steady clock may be CLOCK_MONOTONIC_RAW, which clock_nanosleep() doesn't support,
+    // so sleep until the same duration from now on CLOCK_MONOTONIC instead.
+    struct timespec timespec_deadline;
+    clock_gettime(CLOCK_MONOTONIC, &timespec_deadline);
+    int64_t monotonic_deadline = RCUTILS_S_TO_NS((int64_t)timespec_deadline.tv_sec) +
+      timespec_deadline.tv_nsec + remaining;
+    timespec_deadline.tv_sec = (time_t)RCUTILS_NS_TO_S(monotonic_deadline);
+    timespec_deadline.tv_nsec = (long)(monotonic_deadline % RCUTILS_S_TO_NS(1));
+    int ret = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &timespec_deadline, NULL);
+    if (0 != ret && EINTR != ret) {
+      RCUTILS_SET_ERROR_MSG("failed to sleep");
+      return RCUTILS_RET_ERROR;
+    }
+#else
+    struct timespec duration;
+    duration.tv_sec = (time_t)RCUTILS_NS_TO_S(remaining);
+    duration.tv_nsec = (long)(remaining % RCUTILS_S_TO_NS(1));
+    if (0 != nanosleep(&duration, NULL) && EINTR != errno) {
+      RCUTILS_SET_ERROR_MSG("failed to sleep");
+      return RCUTILS_RET_ERROR;
+    }
+#endif
+    // The clocks may drift apart slightly, or the sleep be interrupted by a signal.
+    if (RCUTILS_RET_OK != rcutils_steady_time_now(&now)) {
+      return RCUTILS_RET_ERROR;
+    }
+  }
+  return RCUTILS_RET_OK;
+}
+
 #ifdef __cplusplus
 }
 #endif
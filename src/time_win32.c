@@ -40,6 +40,11 @@ extern "C"
 #include "rcutils/allocator.h"
 #include "rcutils/error_handling.h"
 
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+// Available since Windows 10 version 1803, older SDKs don't define it.
+# define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
 rcutils_ret_t
 rcutils_system_time_now(rcutils_time_point_value_t * now)
 {
@@ -84,6 +89,89 @@ rcutils_steady_time_now(rcutils_time_point_value_t * now)
   return RCUTILS_RET_OK;
 }
 
+rcutils_ret_t
+rcutils_coarse_steady_time_now(rcutils_time_point_value_t * now)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(now, RCUTILS_RET_INVALID_ARGUMENT);
+  // The tick count has the resolution of the system timer, typically 10 to 16 milliseconds.
+  *now = RCUTILS_MS_TO_NS((rcutils_time_point_value_t)GetTickCount64());
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_coarse_system_time_now(rcutils_time_point_value_t * now)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(now, RCUTILS_RET_INVALID_ARGUMENT);
+  // Unlike GetSystemTimePreciseAsFileTime(), this has the resolution of the system timer.
+  FILETIME ft;
+  GetSystemTimeAsFileTime(&ft);
+  LARGE_INTEGER li;
+  li.LowPart = ft.dwLowDateTime;
+  li.HighPart = ft.dwHighDateTime;
+  // Adjust for January 1st, 1970, see rcutils_system_time_now().
+  li.QuadPart -= 116444736000000000;
+  *now = li.QuadPart * 100;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_coarse_time_resolution(rcutils_duration_value_t * resolution)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(resolution, RCUTILS_RET_INVALID_ARGUMENT);
+  DWORD adjustment, increment;
+  BOOL adjustment_disabled;
+  if (!GetSystemTimeAdjustment(&adjustment, &increment, &adjustment_disabled)) {
+    RCUTILS_SET_ERROR_MSG("failed to get the resolution of the clock");
+    return RCUTILS_RET_ERROR;
+  }
+  // The increment is in 100's of nanoseconds.
+  *resolution = (rcutils_duration_value_t)increment * 100;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_sleep_until_steady(rcutils_time_point_value_t deadline)
+{
+  rcutils_time_point_value_t now;
+  if (RCUTILS_RET_OK != rcutils_steady_time_now(&now)) {
+    return RCUTILS_RET_ERROR;
+  }
+  if (now >= deadline) {
+    return RCUTILS_RET_OK;
+  }
+  // High resolution timers aren't bound to the period of the system timer, typically
+  // 15.6 milliseconds; older versions of Windows fall back to a regular timer.
+  HANDLE timer = CreateWaitableTimerExW(
+    NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+  if (NULL == timer) {
+    timer = CreateWaitableTimerExW(NULL, NULL, 0, TIMER_ALL_ACCESS);
+  }
+  if (NULL == timer) {
+    RCUTILS_SET_ERROR_MSG("failed to create a waitable timer");
+    return RCUTILS_RET_ERROR;
+  }
+  rcutils_ret_t ret = RCUTILS_RET_OK;
+  while (now < deadline) {
+    // A negative due time is relative, in 100's of nanoseconds rounded up.
+    LARGE_INTEGER due_time;
+    due_time.QuadPart = -((deadline - now + 99) / 100);
+    if (
+      !SetWaitableTimer(timer, &due_time, 0, NULL, NULL, FALSE) ||
+      WAIT_OBJECT_0 != WaitForSingleObject(timer, INFINITE))
+    {
+      RCUTILS_SET_ERROR_MSG("failed to wait for a waitable timer");
+      ret = RCUTILS_RET_ERROR;
+      break;
+    }
+    if (RCUTILS_RET_OK != rcutils_steady_time_now(&now)) {
+      ret = RCUTILS_RET_ERROR;
+      break;
+    }
+  }
+  CloseHandle(timer);
+  return ret;
+}
+
 #ifdef __cplusplus
 }
 #endif
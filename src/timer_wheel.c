@@ -0,0 +1,412 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+
+#if defined(_MSC_VER)
+# include <intrin.h>
+#endif
+
+#include "rcutils/error_handling.h"
+#include "rcutils/types/timer_wheel.h"
+
+#define TIMER_WHEEL_LEVELS 6
+#define TIMER_WHEEL_SLOT_BITS 6
+#define TIMER_WHEEL_SLOTS (1u << TIMER_WHEEL_SLOT_BITS)
+#define TIMER_WHEEL_SLOT_MASK ((uint64_t)TIMER_WHEEL_SLOTS - 1)
+// The number of ticks from the current one that the wheels can hold.
+#define TIMER_WHEEL_RANGE ((uint64_t)1 << (TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOT_BITS))
+// The list of the timers which expired before being scheduled, after the slots of the wheels.
+#define TIMER_WHEEL_PENDING_LIST (TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS)
+// The list of the timers whose callbacks are about to be called.
+#define TIMER_WHEEL_EXPIRED_LIST (TIMER_WHEEL_PENDING_LIST + 1)
+#define TIMER_WHEEL_LIST_COUNT (TIMER_WHEEL_EXPIRED_LIST + 1)
+
+#define TIMER_WHEEL_VALIDATE(wheel) \
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(wheel, RCUTILS_RET_INVALID_ARGUMENT); \
+  if (NULL == wheel->impl) { \
+    RCUTILS_SET_ERROR_MSG("timer wheel is not initialized"); \
+    return RCUTILS_RET_NOT_INITIALIZED; \
+  }
+
+typedef struct rcutils_timer_wheel_impl_s
+{
+  // The first timer of each list.
+  rcutils_timer_wheel_timer_t * lists[TIMER_WHEEL_LIST_COUNT];
+  // The last timer of the expired list, so that the callbacks are called in tick order.
+  rcutils_timer_wheel_timer_t * expired_tail;
+  // A bit for each slot of each wheel which isn't empty.
+  uint64_t occupied[TIMER_WHEEL_LEVELS];
+  // The last tick the wheel was advanced to.
+  uint64_t tick;
+  rcutils_duration_value_t tick_duration;
+  rcutils_time_point_value_t start_time;
+  // The number of timers in the wheels, not counting the pending and expired lists.
+  size_t wheel_count;
+  size_t size;
+  rcutils_allocator_t allocator;
+} rcutils_timer_wheel_impl_t;
+
+static void
+_link(rcutils_timer_wheel_impl_t * impl, rcutils_timer_wheel_timer_t * timer, size_t list)
+{
+  if (TIMER_WHEEL_EXPIRED_LIST == list) {
+    timer->next = NULL;
+    timer->prev = impl->expired_tail;
+    if (NULL == impl->expired_tail) {
+      impl->lists[list] = timer;
+    } else {
+      impl->expired_tail->next = timer;
+    }
+    impl->expired_tail = timer;
+  } else {
+    timer->next = impl->lists[list];
+    timer->prev = NULL;
+    if (NULL != timer->next) {
+      timer->next->prev = timer;
+    }
+    impl->lists[list] = timer;
+    if (list < TIMER_WHEEL_PENDING_LIST) {
+      impl->occupied[list / TIMER_WHEEL_SLOTS] |= (uint64_t)1 << (list % TIMER_WHEEL_SLOTS);
+      ++impl->wheel_count;
+    }
+  }
+  timer->slot = list + 1;
+}
+
+static void
+_unlink(rcutils_timer_wheel_impl_t * impl, rcutils_timer_wheel_timer_t * timer)
+{
+  size_t list = timer->slot - 1;
+  if (NULL == timer->prev) {
+    impl->lists[list] = timer->next;
+  } else {
+    timer->prev->next = timer->next;
+  }
+  if (NULL != timer->next) {
+    timer->next->prev = timer->prev;
+  } else if (TIMER_WHEEL_EXPIRED_LIST == list) {
+    impl->expired_tail = timer->prev;
+  }
+  if (list < TIMER_WHEEL_PENDING_LIST) {
+    if (NULL == impl->lists[list]) {
+      impl->occupied[list / TIMER_WHEEL_SLOTS] &= ~((uint64_t)1 << (list % TIMER_WHEEL_SLOTS));
+    }
+    --impl->wheel_count;
+  }
+  timer->next = NULL;
+  timer->prev = NULL;
+  timer->slot = 0;
+}
+
+// Put a timer expiring at or after base in the wheel whose slots span the ticks until then.
+static void
+_place(rcutils_timer_wheel_impl_t * impl, rcutils_timer_wheel_timer_t * timer, uint64_t base)
+{
+  uint64_t expiry = timer->expiry;
+  if (expiry - base >= TIMER_WHEEL_RANGE) {
+    // The timer is placed again when the last wheel reaches its slot
+    expiry = base + TIMER_WHEEL_RANGE - 1;
+  }
+  uint64_t delta = expiry - base;
+  size_t level = 0;
+  while (delta >= ((uint64_t)1 << ((level + 1) * TIMER_WHEEL_SLOT_BITS))) {
+    ++level;
+  }
+  size_t slot = (size_t)((expiry >> (level * TIMER_WHEEL_SLOT_BITS)) & TIMER_WHEEL_SLOT_MASK);
+  _link(impl, timer, level * TIMER_WHEEL_SLOTS + slot);
+}
+
+// Move the timers of a slot of a wheel down the wheels, as the tick reached the slot.
+static void
+_cascade(rcutils_timer_wheel_impl_t * impl, size_t level, uint64_t tick)
+{
+  size_t slot = (size_t)((tick >> (level * TIMER_WHEEL_SLOT_BITS)) & TIMER_WHEEL_SLOT_MASK);
+  size_t list = level * TIMER_WHEEL_SLOTS + slot;
+  while (NULL != impl->lists[list]) {
+    rcutils_timer_wheel_timer_t * timer = impl->lists[list];
+    _unlink(impl, timer);
+    _place(impl, timer, tick);
+  }
+}
+
+// Move the timers of a list to the expired list.
+static void
+_expire(rcutils_timer_wheel_impl_t * impl, size_t list)
+{
+  while (NULL != impl->lists[list]) {
+    rcutils_timer_wheel_timer_t * timer = impl->lists[list];
+    _unlink(impl, timer);
+    _link(impl, timer, TIMER_WHEEL_EXPIRED_LIST);
+  }
+}
+
+// Returns the index of the lowest bit set in a word which isn't 0
+static inline unsigned int
+_lowest_bit(uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return (unsigned int)__builtin_ctzll(word);
+#elif defined(_MSC_VER) && defined(_M_X64)
+  unsigned long index = 0;
+  _BitScanForward64(&index, word);
+  return (unsigned int)index;
+#else
+  unsigned int index = 0;
+  while (0 == (word & 1)) {
+    word >>= 1;
+    ++index;
+  }
+  return index;
+#endif
+}
+
+// Find the first tick after the current one when a slot which isn't empty is reached,
+// either expiring the timers of the first wheel or cascading those of the others.
+static uint64_t
+_next_event(const rcutils_timer_wheel_impl_t * impl)
+{
+  uint64_t next = UINT64_MAX;
+  for (size_t level = 0; level < TIMER_WHEEL_LEVELS; ++level) {
+    uint64_t occupied = impl->occupied[level];
+    if (0u == occupied) {
+      continue;
+    }
+    size_t shift = level * TIMER_WHEEL_SLOT_BITS;
+    // The slots are reached in turn, starting from the one after the current one
+    uint64_t turn = impl->tick >> shift;
+    unsigned int first = (unsigned int)((turn + 1u) & TIMER_WHEEL_SLOT_MASK);
+    uint64_t rotated = occupied;
+    if (0u != first) {
+      rotated = (occupied >> first) | (occupied << (TIMER_WHEEL_SLOTS - first));
+    }
+    uint64_t tick = (turn + 1u + _lowest_bit(rotated)) << shift;
+    if (tick < next) {
+      next = tick;
+    }
+  }
+  return next;
+}
+
+rcutils_timer_wheel_t
+rcutils_get_zero_initialized_timer_wheel(void)
+{
+  static rcutils_timer_wheel_t zero_initialized_timer_wheel = {NULL};
+  return zero_initialized_timer_wheel;
+}
+
+rcutils_timer_wheel_timer_t
+rcutils_get_zero_initialized_timer_wheel_timer(void)
+{
+  static rcutils_timer_wheel_timer_t zero_initialized_timer = {
+    .next = NULL,
+    .prev = NULL,
+    .expiry = 0u,
+    .slot = 0u,
+    .callback = NULL,
+    .data = NULL,
+  };
+  return zero_initialized_timer;
+}
+
+rcutils_ret_t
+rcutils_timer_wheel_init(
+  rcutils_timer_wheel_t * wheel,
+  rcutils_duration_value_t tick_duration,
+  rcutils_time_point_value_t start_time,
+  const rcutils_allocator_t * allocator)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(wheel, RCUTILS_RET_INVALID_ARGUMENT);
+  if (NULL != wheel->impl) {
+    RCUTILS_SET_ERROR_MSG("timer wheel is already initialized");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  if (tick_duration <= 0) {
+    RCUTILS_SET_ERROR_MSG("tick_duration must be more than 0");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  RCUTILS_CHECK_ALLOCATOR_WITH_MSG(
+    allocator, "invalid allocator", return RCUTILS_RET_INVALID_ARGUMENT);
+
+  rcutils_timer_wheel_impl_t * impl = allocator->zero_allocate(
+    1, sizeof(rcutils_timer_wheel_impl_t), allocator->state);
+  if (NULL == impl) {
+    RCUTILS_SET_ERROR_MSG("failed to allocate memory for timer wheel");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  impl->tick_duration = tick_duration;
+  impl->start_time = start_time;
+  impl->allocator = *allocator;
+  wheel->impl = impl;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_timer_wheel_fini(rcutils_timer_wheel_t * wheel)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(wheel, RCUTILS_RET_INVALID_ARGUMENT);
+  rcutils_timer_wheel_impl_t * impl = wheel->impl;
+  if (NULL == impl) {
+    return RCUTILS_RET_OK;
+  }
+  // Leave the timers in a state where they can be scheduled again
+  for (size_t list = 0; list < TIMER_WHEEL_LIST_COUNT; ++list) {
+    while (NULL != impl->lists[list]) {
+      _unlink(impl, impl->lists[list]);
+    }
+  }
+  rcutils_allocator_t allocator = impl->allocator;
+  allocator.deallocate(impl, allocator.state);
+  wheel->impl = NULL;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_timer_wheel_schedule(
+  rcutils_timer_wheel_t * wheel,
+  rcutils_timer_wheel_timer_t * timer,
+  rcutils_time_point_value_t deadline,
+  rcutils_timer_wheel_callback_t callback,
+  void * data)
+{
+  TIMER_WHEEL_VALIDATE(wheel);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(timer, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    callback, "callback is null", return RCUTILS_RET_INVALID_ARGUMENT);
+  if (0u != timer->slot) {
+    RCUTILS_SET_ERROR_MSG("timer is already scheduled");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  rcutils_timer_wheel_impl_t * impl = wheel->impl;
+
+  // Round up, so that a timer never expires before its deadline
+  uint64_t expiry = 0u;
+  if (deadline > impl->start_time) {
+    uint64_t elapsed = (uint64_t)deadline - (uint64_t)impl->start_time;
+    expiry = (elapsed - 1u) / (uint64_t)impl->tick_duration + 1u;
+  }
+  timer->expiry = expiry;
+  timer->callback = callback;
+  timer->data = data;
+  if (expiry <= impl->tick) {
+    _link(impl, timer, TIMER_WHEEL_PENDING_LIST);
+  } else {
+    _place(impl, timer, impl->tick);
+  }
+  ++impl->size;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_timer_wheel_cancel(rcutils_timer_wheel_t * wheel, rcutils_timer_wheel_timer_t * timer)
+{
+  TIMER_WHEEL_VALIDATE(wheel);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(timer, RCUTILS_RET_INVALID_ARGUMENT);
+  if (0u == timer->slot) {
+    RCUTILS_SET_ERROR_MSG("timer is not scheduled");
+    return RCUTILS_RET_NOT_FOUND;
+  }
+  _unlink(wheel->impl, timer);
+  --wheel->impl->size;
+  return RCUTILS_RET_OK;
+}
+
+bool
+rcutils_timer_wheel_timer_is_scheduled(const rcutils_timer_wheel_timer_t * timer)
+{
+  return NULL != timer && 0u != timer->slot;
+}
+
+rcutils_ret_t
+rcutils_timer_wheel_advance(
+  rcutils_timer_wheel_t * wheel, rcutils_time_point_value_t now, size_t * expired_count)
+{
+  TIMER_WHEEL_VALIDATE(wheel);
+  rcutils_timer_wheel_impl_t * impl = wheel->impl;
+
+  uint64_t target = 0u;
+  if (now > impl->start_time) {
+    target = ((uint64_t)now - (uint64_t)impl->start_time) / (uint64_t)impl->tick_duration;
+  }
+  _expire(impl, TIMER_WHEEL_PENDING_LIST);
+  while (impl->tick < target && 0u != impl->wheel_count) {
+    uint64_t tick = _next_event(impl);
+    if (tick > target) {
+      break;
+    }
+    if (0u == (tick & TIMER_WHEEL_SLOT_MASK)) {
+      // Cascade from the highest wheel reaching a new slot, as it may fill the slots below
+      size_t level = 1;
+      while (level < TIMER_WHEEL_LEVELS - 1 &&
+        0u == ((tick >> (level * TIMER_WHEEL_SLOT_BITS)) & TIMER_WHEEL_SLOT_MASK))
+      {
+        ++level;
+      }
+      for (; level > 0; --level) {
+        _cascade(impl, level, tick);
+      }
+    }
+    _expire(impl, (size_t)(tick & TIMER_WHEEL_SLOT_MASK));
+    impl->tick = tick;
+  }
+  // The ticks until the target have no timers
+  if (impl->tick < target) {
+    impl->tick = target;
+  }
+
+  // Call the callbacks once the wheel is consistent, so they may schedule timers
+  size_t count = 0u;
+  while (NULL != impl->lists[TIMER_WHEEL_EXPIRED_LIST]) {
+    rcutils_timer_wheel_timer_t * timer = impl->lists[TIMER_WHEEL_EXPIRED_LIST];
+    _unlink(impl, timer);
+    --impl->size;
+    ++count;
+    timer->callback(timer, timer->data);
+  }
+  if (NULL != expired_count) {
+    *expired_count = count;
+  }
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_timer_wheel_poll(rcutils_timer_wheel_t * wheel, size_t * expired_count)
+{
+  TIMER_WHEEL_VALIDATE(wheel);
+  rcutils_time_point_value_t now;
+  rcutils_ret_t ret = rcutils_steady_time_now(&now);
+  if (RCUTILS_RET_OK != ret) {
+    // error message already set
+    return ret;
+  }
+  return rcutils_timer_wheel_advance(wheel, now, expired_count);
+}
+
+rcutils_ret_t
+rcutils_timer_wheel_get_size(const rcutils_timer_wheel_t * wheel, size_t * size)
+{
+  TIMER_WHEEL_VALIDATE(wheel);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(size, RCUTILS_RET_INVALID_ARGUMENT);
+  *size = wheel->impl->size;
+  return RCUTILS_RET_OK;
+}
+
+#ifdef __cplusplus
+}
+#endif
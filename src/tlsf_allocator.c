@@ -0,0 +1,420 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(_MSC_VER)
+# include <intrin.h>
+#endif
+
+#include "rcutils/error_handling.h"
+#include "rcutils/tlsf_allocator.h"
+
+// Each power of two of the block sizes, the first level, is divided in 2^SL_INDEX_COUNT_LOG2
+// ranges, the second level, and blocks smaller than SMALL_BLOCK_SIZE are in the first list
+#define ALIGNMENT_LOG2 4
+#define SL_INDEX_COUNT_LOG2 4
+#define SL_INDEX_COUNT (1 << SL_INDEX_COUNT_LOG2)
+#define FL_INDEX_SHIFT (SL_INDEX_COUNT_LOG2 + ALIGNMENT_LOG2)
+#define SMALL_BLOCK_SIZE ((size_t)1 << FL_INDEX_SHIFT)
+#if SIZE_MAX > 0xFFFFFFFFu
+# define FL_INDEX_MAX 32
+#else
+# define FL_INDEX_MAX 30
+#endif
+#define FL_INDEX_COUNT (FL_INDEX_MAX - FL_INDEX_SHIFT + 1)
+// Blocks are strictly smaller than this
+#define MAX_BLOCK_SIZE ((size_t)1 << FL_INDEX_MAX)
+
+// The flags stored in the low bits of the block sizes, which are multiples of the alignment
+#define BLOCK_FREE ((size_t)1)
+#define BLOCK_PREV_FREE ((size_t)2)
+#define BLOCK_FLAGS (BLOCK_FREE | BLOCK_PREV_FREE)
+
+typedef struct block_s
+{
+  // The previous block in the region, only valid when it's free.
+  struct block_s * prev_phys;
+  // The size of the block, header included, and its flags.
+  size_t size;
+  // The neighbours in the free list, overlapping the memory of the used blocks.
+  struct block_s * next_free;
+  struct block_s * prev_free;
+} block_t;
+
+// The memory of a used block starts after its prev_phys and size fields
+#define BLOCK_OFFSET RCUTILS_TLSF_ALLOCATOR_ALIGNMENT
+// The smallest block can hold the free list pointers
+#define BLOCK_MIN_SIZE (2 * RCUTILS_TLSF_ALLOCATOR_ALIGNMENT)
+
+typedef struct rcutils_tlsf_allocator_impl_s
+{
+  // The bit of each first level with a non-empty list.
+  uint32_t fl_bitmap;
+  // The bit of each second level with a non-empty list, per first level.
+  uint32_t sl_bitmap[FL_INDEX_COUNT];
+  block_t * blocks[FL_INDEX_COUNT][SL_INDEX_COUNT];
+  size_t free_size;
+} rcutils_tlsf_allocator_impl_t;
+
+// Returns the index of the lowest bit set in a word which isn't 0
+static inline unsigned int tlsf_lowest_bit(uint32_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return (unsigned int)__builtin_ctz(word);
+#elif defined(_MSC_VER)
+  unsigned long index = 0;
+  _BitScanForward(&index, word);
+  return (unsigned int)index;
+#else
+  unsigned int index = 0;
+  while (0 == (word & 1)) {
+    word >>= 1;
+    ++index;
+  }
+  return index;
+#endif
+}
+
+// Returns the index of the highest bit set in a size which isn't 0
+static inline unsigned int tlsf_highest_bit(size_t size)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return 63u - (unsigned int)__builtin_clzll((unsigned long long)size);
+#elif defined(_MSC_VER) && defined(_M_X64)
+  unsigned long index = 0;
+  _BitScanReverse64(&index, size);
+  return (unsigned int)index;
+#else
+  unsigned int index = 0;
+  while (0 != (size >>= 1)) {
+    ++index;
+  }
+  return index;
+#endif
+}
+
+static size_t
+_block_size(const block_t * block)
+{
+  return block->size & ~BLOCK_FLAGS;
+}
+
+static block_t *
+_next_phys(const block_t * block)
+{
+  return (block_t *)((uint8_t *)block + _block_size(block));
+}
+
+// Finds the list whose blocks have the size range containing the size
+static void
+_mapping_insert(size_t size, unsigned int * fl, unsigned int * sl)
+{
+  if (size < SMALL_BLOCK_SIZE) {
+    *fl = 0;
+    *sl = (unsigned int)(size / (SMALL_BLOCK_SIZE / SL_INDEX_COUNT));
+  } else {
+    unsigned int bit = tlsf_highest_bit(size);
+    *sl = (unsigned int)(size >> (bit - SL_INDEX_COUNT_LOG2)) ^ SL_INDEX_COUNT;
+    *fl = bit - FL_INDEX_SHIFT + 1;
+  }
+}
+
+// Finds the first list whose blocks are all at least as large as the size
+static void
+_mapping_search(size_t size, unsigned int * fl, unsigned int * sl)
+{
+  if (size >= SMALL_BLOCK_SIZE) {
+    size += ((size_t)1 << (tlsf_highest_bit(size) - SL_INDEX_COUNT_LOG2)) - 1;
+  }
+  _mapping_insert(size, fl, sl);
+}
+
+static void
+_insert_free_block(rcutils_tlsf_allocator_impl_t * impl, block_t * block)
+{
+  unsigned int fl, sl;
+  _mapping_insert(_block_size(block), &fl, &sl);
+  block_t * head = impl->blocks[fl][sl];
+  block->next_free = head;
+  block->prev_free = NULL;
+  if (NULL != head) {
+    head->prev_free = block;
+  }
+  impl->blocks[fl][sl] = block;
+  impl->fl_bitmap |= 1u << fl;
+  impl->sl_bitmap[fl] |= 1u << sl;
+  impl->free_size += _block_size(block);
+}
+
+static void
+_remove_free_block(rcutils_tlsf_allocator_impl_t * impl, block_t * block)
+{
+  unsigned int fl, sl;
+  _mapping_insert(_block_size(block), &fl, &sl);
+  if (NULL != block->next_free) {
+    block->next_free->prev_free = block->prev_free;
+  }
+  if (NULL != block->prev_free) {
+    block->prev_free->next_free = block->next_free;
+  } else {
+    impl->blocks[fl][sl] = block->next_free;
+    if (NULL == block->next_free) {
+      impl->sl_bitmap[fl] &= ~(1u << sl);
+      if (0u == impl->sl_bitmap[fl]) {
+        impl->fl_bitmap &= ~(1u << fl);
+      }
+    }
+  }
+  impl->free_size -= _block_size(block);
+}
+
+// Returns a free block at least as large as the size, or NULL
+static block_t *
+_find_free_block(rcutils_tlsf_allocator_impl_t * impl, size_t size)
+{
+  unsigned int fl, sl;
+  _mapping_search(size, &fl, &sl);
+  if (fl >= FL_INDEX_COUNT) {
+    return NULL;
+  }
+  uint32_t sl_map = impl->sl_bitmap[fl] & (~0u << sl);
+  if (0u == sl_map) {
+    uint32_t fl_map = fl + 1u < 32u ? impl->fl_bitmap & (~0u << (fl + 1u)) : 0u;
+    if (0u == fl_map) {
+      return NULL;
+    }
+    fl = tlsf_lowest_bit(fl_map);
+    sl_map = impl->sl_bitmap[fl];
+  }
+  return impl->blocks[fl][tlsf_lowest_bit(sl_map)];
+}
+
+// Marks a used block free, merging it with its free neighbours
+static void
+_release_block(rcutils_tlsf_allocator_impl_t * impl, block_t * block)
+{
+  if (0u != (block->size & BLOCK_PREV_FREE)) {
+    block_t * prev = block->prev_phys;
+    _remove_free_block(impl, prev);
+    prev->size += _block_size(block);
+    block = prev;
+  }
+  block_t * next = _next_phys(block);
+  if (0u != (next->size & BLOCK_FREE)) {
+    _remove_free_block(impl, next);
+    block->size += _block_size(next);
+    next = _next_phys(block);
+  }
+  block->size |= BLOCK_FREE;
+  next->prev_phys = block;
+  next->size |= BLOCK_PREV_FREE;
+  _insert_free_block(impl, block);
+}
+
+// Gives back the end of a used block beyond the size, if it's large enough for a block
+static void
+_trim_block(rcutils_tlsf_allocator_impl_t * impl, block_t * block, size_t size)
+{
+  size_t block_size = _block_size(block);
+  if (block_size - size >= BLOCK_MIN_SIZE) {
+    block_t * rest = (block_t *)((uint8_t *)block + size);
+    rest->size = block_size - size;
+    block->size = size | (block->size & BLOCK_FLAGS);
+    _release_block(impl, rest);
+  }
+}
+
+// Returns the size of the block for an allocation, or 0 if it's too large
+static size_t
+_adjust_size(size_t size)
+{
+  if (size > MAX_BLOCK_SIZE - BLOCK_OFFSET - RCUTILS_TLSF_ALLOCATOR_ALIGNMENT) {
+    return 0u;
+  }
+  size_t block_size = (size + BLOCK_OFFSET + RCUTILS_TLSF_ALLOCATOR_ALIGNMENT - 1u) &
+    ~(RCUTILS_TLSF_ALLOCATOR_ALIGNMENT - 1u);
+  return block_size < BLOCK_MIN_SIZE ? BLOCK_MIN_SIZE : block_size;
+}
+
+static void *
+_tlsf_allocate(size_t size, void * state)
+{
+  rcutils_tlsf_allocator_impl_t * impl = state;
+  size_t block_size = _adjust_size(size);
+  if (0u == block_size) {
+    return NULL;
+  }
+  block_t * block = _find_free_block(impl, block_size);
+  if (NULL == block) {
+    return NULL;
+  }
+  _remove_free_block(impl, block);
+  block->size &= ~BLOCK_FREE;
+  _next_phys(block)->size &= ~BLOCK_PREV_FREE;
+  _trim_block(impl, block, block_size);
+  return (uint8_t *)block + BLOCK_OFFSET;
+}
+
+static void
+_tlsf_deallocate(void * pointer, void * state)
+{
+  if (NULL == pointer) {
+    return;
+  }
+  _release_block(state, (block_t *)((uint8_t *)pointer - BLOCK_OFFSET));
+}
+
+static void *
+_tlsf_reallocate(void * pointer, size_t size, void * state)
+{
+  rcutils_tlsf_allocator_impl_t * impl = state;
+  if (NULL == pointer) {
+    return _tlsf_allocate(size, state);
+  }
+  block_t * block = (block_t *)((uint8_t *)pointer - BLOCK_OFFSET);
+  size_t block_size = _adjust_size(size);
+  if (0u == block_size) {
+    return NULL;
+  }
+  size_t current_size = _block_size(block);
+  if (block_size > current_size) {
+    // Grow in place into the next block when it's free and large enough
+    block_t * next = _next_phys(block);
+    if (0u != (next->size & BLOCK_FREE) && current_size + _block_size(next) >= block_size) {
+      _remove_free_block(impl, next);
+      block->size += _block_size(next);
+      _next_phys(block)->size &= ~BLOCK_PREV_FREE;
+    } else {
+      void * new_pointer = _tlsf_allocate(size, state);
+      if (NULL == new_pointer) {
+        return NULL;
+      }
+      memcpy(new_pointer, pointer, current_size - BLOCK_OFFSET);
+      _release_block(impl, block);
+      return new_pointer;
+    }
+  }
+  _trim_block(impl, block, block_size);
+  return pointer;
+}
+
+static void *
+_tlsf_zero_allocate(size_t number_of_elements, size_t size_of_element, void * state)
+{
+  if (0u != size_of_element && number_of_elements > SIZE_MAX / size_of_element) {
+    return NULL;
+  }
+  size_t size = number_of_elements * size_of_element;
+  void * pointer = _tlsf_allocate(size, state);
+  if (NULL != pointer) {
+    memset(pointer, 0, size);
+  }
+  return pointer;
+}
+
+static uintptr_t
+_align_up(uintptr_t address)
+{
+  return (address + RCUTILS_TLSF_ALLOCATOR_ALIGNMENT - 1u) &
+         ~(uintptr_t)(RCUTILS_TLSF_ALLOCATOR_ALIGNMENT - 1u);
+}
+
+rcutils_tlsf_allocator_t
+rcutils_get_zero_initialized_tlsf_allocator(void)
+{
+  static rcutils_tlsf_allocator_t zero_initialized_tlsf_allocator = {NULL};
+  return zero_initialized_tlsf_allocator;
+}
+
+rcutils_ret_t
+rcutils_tlsf_allocator_init(rcutils_tlsf_allocator_t * tlsf, void * memory, size_t size)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(tlsf, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(memory, RCUTILS_RET_INVALID_ARGUMENT);
+  if (NULL != tlsf->impl) {
+    RCUTILS_SET_ERROR_MSG("tlsf allocator is already initialized");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+
+  // The bookkeeping, then one free block and the sentinel ending the region
+  uintptr_t begin = (uintptr_t)memory;
+  uintptr_t control = _align_up(begin);
+  uintptr_t first = _align_up(control + sizeof(rcutils_tlsf_allocator_impl_t));
+  size_t overhead = (size_t)(first - begin) + BLOCK_MIN_SIZE + BLOCK_OFFSET;
+  if (first < begin || size < overhead) {
+    RCUTILS_SET_ERROR_MSG("memory region is too small for the tlsf allocator");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  size_t block_size = (size - (size_t)(first - begin) - BLOCK_OFFSET) &
+    ~(RCUTILS_TLSF_ALLOCATOR_ALIGNMENT - 1u);
+  if (block_size >= MAX_BLOCK_SIZE) {
+    block_size = MAX_BLOCK_SIZE - RCUTILS_TLSF_ALLOCATOR_ALIGNMENT;
+  }
+
+  rcutils_tlsf_allocator_impl_t * impl = (rcutils_tlsf_allocator_impl_t *)control;
+  memset(impl, 0, sizeof(*impl));
+  block_t * block = (block_t *)first;
+  block->prev_phys = NULL;
+  block->size = block_size | BLOCK_FREE;
+  block_t * sentinel = _next_phys(block);
+  sentinel->prev_phys = block;
+  sentinel->size = BLOCK_PREV_FREE;
+  _insert_free_block(impl, block);
+  tlsf->impl = impl;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_tlsf_allocator_fini(rcutils_tlsf_allocator_t * tlsf)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(tlsf, RCUTILS_RET_INVALID_ARGUMENT);
+  tlsf->impl = NULL;
+  return RCUTILS_RET_OK;
+}
+
+size_t
+rcutils_tlsf_allocator_get_free_size(const rcutils_tlsf_allocator_t * tlsf)
+{
+  if (NULL == tlsf || NULL == tlsf->impl) {
+    return 0u;
+  }
+  return tlsf->impl->free_size;
+}
+
+rcutils_allocator_t
+rcutils_tlsf_allocator_get_allocator(const rcutils_tlsf_allocator_t * tlsf)
+{
+  if (NULL == tlsf || NULL == tlsf->impl) {
+    return rcutils_get_zero_initialized_allocator();
+  }
+  rcutils_allocator_t allocator = {
+    .allocate = _tlsf_allocate,
+    .deallocate = _tlsf_deallocate,
+    .reallocate = _tlsf_reallocate,
+    .zero_allocate = _tlsf_zero_allocate,
+    .state = tlsf->impl,
+  };
+  return allocator;
+}
+
+#ifdef __cplusplus
+}
+#endif
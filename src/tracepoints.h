@@ -0,0 +1,45 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TRACEPOINTS_H_
+#define TRACEPOINTS_H_
+
+// Tracepoints in the hot paths of rcutils, not to be used externally.
+//
+// They are compiled out unless the library is built with the RCUTILS_ENABLE_TRACING CMake
+// option, in which case each of them is a USDT probe of the `rcutils` provider: a single nop
+// instruction, which tracers patch into a breakpoint only while they are attached, e.g. with
+// `lttng enable-event -k --userspace-probe=sdt:<path to librcutils>:rcutils:log_start`, perf
+// or bpftrace.
+// The probes have no semaphores, which LTTng doesn't support, so their arguments are always
+// evaluated: only pass values which are already at hand, like pointers, sizes or codes.
+//
+// The tracepoints and their arguments are:
+// - log_start(name, severity) and log_end(name, severity), around rcutils_log()
+// - output_handler_start(output_handler, severity) and output_handler_end(output_handler),
+//   around the call of the output handler by rcutils_log()
+// - hash_map_resize_start(impl, capacity, new_capacity) and hash_map_resize_end(impl, ret),
+//   around growing or reserving a hash map, identified by the pointer to its implementation
+// - shared_library_load_start(library_path) and shared_library_load_end(library_path, ret),
+//   around rcutils_load_shared_library_with_options()
+
+#ifdef RCUTILS_ENABLE_TRACING
+#include <sys/sdt.h>
+
+#define RCUTILS_TRACEPOINT(event, ...) STAP_PROBEV(rcutils, event, __VA_ARGS__)
+#else
+#define RCUTILS_TRACEPOINT(event, ...) ((void)0)
+#endif
+
+#endif  // TRACEPOINTS_H_
@@ -0,0 +1,296 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "rcutils/error_handling.h"
+#include "rcutils/stdatomic_helper.h"
+#include "rcutils/tracking_allocator.h"
+
+// Placed before each allocation, and padded to 16 bytes so the allocation stays aligned.
+typedef struct block_header_s
+{
+  size_t size;
+} block_header_t;
+
+#define BLOCK_HEADER_SIZE ((size_t)16)
+
+typedef struct rcutils_tracking_allocator_impl_s
+{
+  rcutils_allocator_t allocator;
+  bool size_histogram;
+  atomic_uint_least64_t allocation_count;
+  atomic_uint_least64_t deallocation_count;
+  atomic_uint_least64_t reallocation_count;
+  atomic_uint_least64_t failure_count;
+  atomic_uint_least64_t total_bytes;
+  atomic_uint_least64_t current_bytes;
+  atomic_uint_least64_t peak_bytes;
+  atomic_uint_least64_t current_allocation_count;
+  atomic_uint_least64_t size_histogram_buckets[RCUTILS_TRACKING_ALLOCATOR_HISTOGRAM_SIZE];
+} rcutils_tracking_allocator_impl_t;
+
+static block_header_t *
+_get_header(void * pointer)
+{
+  return (block_header_t *)((uint8_t *)pointer - BLOCK_HEADER_SIZE);
+}
+
+static void
+_record_size(rcutils_tracking_allocator_impl_t * impl, size_t size)
+{
+  rcutils_atomic_fetch_add_uint64_t(&impl->total_bytes, size);
+  if (impl->size_histogram) {
+    size_t bucket = 0u;
+    while (bucket + 1u < RCUTILS_TRACKING_ALLOCATOR_HISTOGRAM_SIZE &&
+      size > ((size_t)16 << bucket))
+    {
+      ++bucket;
+    }
+    rcutils_atomic_fetch_add_uint64_t(&impl->size_histogram_buckets[bucket], 1);
+  }
+}
+
+static void
+_increase_current_bytes(rcutils_tracking_allocator_impl_t * impl, size_t size)
+{
+  uint64_t current = rcutils_atomic_fetch_add_uint64_t(&impl->current_bytes, size) + size;
+  uint64_t peak = rcutils_atomic_load_uint64_t(&impl->peak_bytes);
+  // A failed exchange updates the peak, so stop once another thread recorded a larger one
+  while (current > peak &&
+    !rcutils_atomic_compare_exchange_strong_uint_least64_t(&impl->peak_bytes, &peak, current))
+  {
+  }
+}
+
+static void
+_decrease_current_bytes(rcutils_tracking_allocator_impl_t * impl, size_t size)
+{
+  rcutils_atomic_fetch_add_uint64_t(&impl->current_bytes, (uint64_t)0 - (uint64_t)size);
+}
+
+// Resets everything but the current bytes and allocation count
+static void
+_reset_statistics(rcutils_tracking_allocator_impl_t * impl)
+{
+  rcutils_atomic_store(&impl->allocation_count, (uint64_t)0);
+  rcutils_atomic_store(&impl->deallocation_count, (uint64_t)0);
+  rcutils_atomic_store(&impl->reallocation_count, (uint64_t)0);
+  rcutils_atomic_store(&impl->failure_count, (uint64_t)0);
+  rcutils_atomic_store(&impl->total_bytes, (uint64_t)0);
+  rcutils_atomic_store(&impl->peak_bytes, rcutils_atomic_load_uint64_t(&impl->current_bytes));
+  for (size_t i = 0u; i < RCUTILS_TRACKING_ALLOCATOR_HISTOGRAM_SIZE; ++i) {
+    rcutils_atomic_store(&impl->size_histogram_buckets[i], (uint64_t)0);
+  }
+}
+
+static void *
+_tracked_block(rcutils_tracking_allocator_impl_t * impl, block_header_t * header, size_t size)
+{
+  if (NULL == header) {
+    rcutils_atomic_fetch_add_uint64_t(&impl->failure_count, 1);
+    return NULL;
+  }
+  header->size = size;
+  rcutils_atomic_fetch_add_uint64_t(&impl->allocation_count, 1);
+  rcutils_atomic_fetch_add_uint64_t(&impl->current_allocation_count, 1);
+  _record_size(impl, size);
+  _increase_current_bytes(impl, size);
+  return (uint8_t *)header + BLOCK_HEADER_SIZE;
+}
+
+static void *
+_tracking_allocate(size_t size, void * state)
+{
+  rcutils_tracking_allocator_impl_t * impl = state;
+  block_header_t * header = NULL;
+  if (size <= SIZE_MAX - BLOCK_HEADER_SIZE) {
+    header = impl->allocator.allocate(BLOCK_HEADER_SIZE + size, impl->allocator.state);
+  }
+  return _tracked_block(impl, header, size);
+}
+
+static void
+_tracking_deallocate(void * pointer, void * state)
+{
+  rcutils_tracking_allocator_impl_t * impl = state;
+  if (NULL == pointer) {
+    return;
+  }
+  block_header_t * header = _get_header(pointer);
+  rcutils_atomic_fetch_add_uint64_t(&impl->deallocation_count, 1);
+  rcutils_atomic_fetch_add_uint64_t(&impl->current_allocation_count, (uint64_t)0 - 1u);
+  _decrease_current_bytes(impl, header->size);
+  impl->allocator.deallocate(header, impl->allocator.state);
+}
+
+static void *
+_tracking_reallocate(void * pointer, size_t size, void * state)
+{
+  rcutils_tracking_allocator_impl_t * impl = state;
+  if (NULL == pointer) {
+    return _tracking_allocate(size, state);
+  }
+  block_header_t * header = NULL;
+  size_t old_size = _get_header(pointer)->size;
+  if (size <= SIZE_MAX - BLOCK_HEADER_SIZE) {
+    header = impl->allocator.reallocate(
+      _get_header(pointer), BLOCK_HEADER_SIZE + size, impl->allocator.state);
+  }
+  if (NULL == header) {
+    rcutils_atomic_fetch_add_uint64_t(&impl->failure_count, 1);
+    return NULL;
+  }
+  header->size = size;
+  rcutils_atomic_fetch_add_uint64_t(&impl->reallocation_count, 1);
+  _record_size(impl, size);
+  if (size >= old_size) {
+    _increase_current_bytes(impl, size - old_size);
+  } else {
+    _decrease_current_bytes(impl, old_size - size);
+  }
+  return (uint8_t *)header + BLOCK_HEADER_SIZE;
+}
+
+static void *
+_tracking_zero_allocate(size_t number_of_elements, size_t size_of_element, void * state)
+{
+  rcutils_tracking_allocator_impl_t * impl = state;
+  if (0u != size_of_element && number_of_elements > SIZE_MAX / size_of_element) {
+    rcutils_atomic_fetch_add_uint64_t(&impl->failure_count, 1);
+    return NULL;
+  }
+  size_t size = number_of_elements * size_of_element;
+  block_header_t * header = NULL;
+  if (size <= SIZE_MAX - BLOCK_HEADER_SIZE) {
+    header = impl->allocator.zero_allocate(1, BLOCK_HEADER_SIZE + size, impl->allocator.state);
+  }
+  return _tracked_block(impl, header, size);
+}
+
+rcutils_tracking_allocator_t
+rcutils_get_zero_initialized_tracking_allocator(void)
+{
+  static rcutils_tracking_allocator_t zero_initialized_tracking_allocator = {NULL};
+  return zero_initialized_tracking_allocator;
+}
+
+rcutils_ret_t
+rcutils_tracking_allocator_init(
+  rcutils_tracking_allocator_t * tracking,
+  const rcutils_allocator_t * allocator,
+  bool size_histogram)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(tracking, RCUTILS_RET_INVALID_ARGUMENT);
+  if (NULL != tracking->impl) {
+    RCUTILS_SET_ERROR_MSG("tracking allocator is already initialized");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  RCUTILS_CHECK_ALLOCATOR_WITH_MSG(
+    allocator, "invalid allocator", return RCUTILS_RET_INVALID_ARGUMENT);
+
+  rcutils_tracking_allocator_impl_t * impl = allocator->allocate(
+    sizeof(rcutils_tracking_allocator_impl_t), allocator->state);
+  if (NULL == impl) {
+    RCUTILS_SET_ERROR_MSG("failed to allocate memory for tracking allocator");
+    return RCUTILS_RET_BAD_ALLOC;
+  }
+  impl->allocator = *allocator;
+  impl->size_histogram = size_histogram;
+  rcutils_atomic_store(&impl->current_bytes, (uint64_t)0);
+  rcutils_atomic_store(&impl->current_allocation_count, (uint64_t)0);
+  _reset_statistics(impl);
+  tracking->impl = impl;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_tracking_allocator_fini(rcutils_tracking_allocator_t * tracking)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(tracking, RCUTILS_RET_INVALID_ARGUMENT);
+  rcutils_tracking_allocator_impl_t * impl = tracking->impl;
+  if (NULL == impl) {
+    return RCUTILS_RET_OK;
+  }
+  impl->allocator.deallocate(impl, impl->allocator.state);
+  tracking->impl = NULL;
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_tracking_allocator_get_statistics(
+  const rcutils_tracking_allocator_t * tracking,
+  rcutils_tracking_allocator_statistics_t * statistics)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(tracking, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(statistics, RCUTILS_RET_INVALID_ARGUMENT);
+  rcutils_tracking_allocator_impl_t * impl = tracking->impl;
+  if (NULL == impl) {
+    RCUTILS_SET_ERROR_MSG("tracking allocator is not initialized");
+    return RCUTILS_RET_NOT_INITIALIZED;
+  }
+  statistics->allocation_count = rcutils_atomic_load_uint64_t(&impl->allocation_count);
+  statistics->deallocation_count = rcutils_atomic_load_uint64_t(&impl->deallocation_count);
+  statistics->reallocation_count = rcutils_atomic_load_uint64_t(&impl->reallocation_count);
+  statistics->failure_count = rcutils_atomic_load_uint64_t(&impl->failure_count);
+  statistics->total_bytes = rcutils_atomic_load_uint64_t(&impl->total_bytes);
+  statistics->current_bytes = rcutils_atomic_load_uint64_t(&impl->current_bytes);
+  statistics->peak_bytes = rcutils_atomic_load_uint64_t(&impl->peak_bytes);
+  statistics->current_allocation_count =
+    rcutils_atomic_load_uint64_t(&impl->current_allocation_count);
+  for (size_t i = 0u; i < RCUTILS_TRACKING_ALLOCATOR_HISTOGRAM_SIZE; ++i) {
+    statistics->size_histogram[i] = rcutils_atomic_load_uint64_t(&impl->size_histogram_buckets[i]);
+  }
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_tracking_allocator_reset(const rcutils_tracking_allocator_t * tracking)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(tracking, RCUTILS_RET_INVALID_ARGUMENT);
+  rcutils_tracking_allocator_impl_t * impl = tracking->impl;
+  if (NULL == impl) {
+    RCUTILS_SET_ERROR_MSG("tracking allocator is not initialized");
+    return RCUTILS_RET_NOT_INITIALIZED;
+  }
+  _reset_statistics(impl);
+  return RCUTILS_RET_OK;
+}
+
+rcutils_allocator_t
+rcutils_tracking_allocator_get_allocator(const rcutils_tracking_allocator_t * tracking)
+{
+  if (NULL == tracking || NULL == tracking->impl) {
+    return rcutils_get_zero_initialized_allocator();
+  }
+  rcutils_allocator_t allocator = {
+    .allocate = _tracking_allocate,
+    .deallocate = _tracking_deallocate,
+    .reallocate = _tracking_reallocate,
+    .zero_allocate = _tracking_zero_allocate,
+    .state = tracking->impl,
+  };
+  return allocator;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <string.h>
+
 #include "rcutils/error_handling.h"
 #include "rcutils/types/uint8_array.h"
 
@@ -21,7 +23,8 @@ rcutils_get_zero_initialized_uint8_array(void)
   static rcutils_uint8_array_t uint8_array = {
     .buffer = NULL,
     .buffer_length = 0lu,
-    .buffer_capacity = 0lu
+    .buffer_capacity = 0lu,
+    .buffer_alignment = 0lu
   };
   uint8_array.allocator = rcutils_get_zero_initialized_allocator();
   return uint8_array;
@@ -39,6 +42,7 @@ rcutils_uint8_array_init(
   uint8_array->buffer_length = 0lu;
   uint8_array->buffer_capacity = buffer_capacity;
   uint8_array->allocator = *allocator;
+  uint8_array->buffer_alignment = 0lu;
 
   if (buffer_capacity > 0lu) {
     uint8_array->buffer = (uint8_t *)allocator->allocate(
@@ -54,6 +58,40 @@ rcutils_uint8_array_init(
   return RCUTILS_RET_OK;
 }
 
+rcutils_ret_t
+rcutils_uint8_array_init_aligned(
+  rcutils_uint8_array_t * uint8_array,
+  size_t buffer_capacity,
+  size_t buffer_alignment,
+  const rcutils_allocator_t * allocator)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(uint8_array, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ALLOCATOR(allocator, return RCUTILS_RET_INVALID_ARGUMENT);
+  if (0lu == buffer_alignment || 0lu != (buffer_alignment & (buffer_alignment - 1lu))) {
+    RCUTILS_SET_ERROR_MSG("alignment of uint8_array has to be a power of two");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+
+  uint8_array->buffer = NULL;
+  uint8_array->buffer_length = 0lu;
+  uint8_array->buffer_capacity = buffer_capacity;
+  uint8_array->allocator = *allocator;
+  uint8_array->buffer_alignment = buffer_alignment;
+
+  if (buffer_capacity > 0lu) {
+    uint8_array->buffer = (uint8_t *)rcutils_allocator_aligned_allocate(
+      allocator, buffer_alignment, buffer_capacity * sizeof(uint8_t));
+    RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+      uint8_array->buffer,
+      "failed to allocate memory for uint8 array",
+      uint8_array->buffer_capacity = 0lu;
+      uint8_array->buffer_length = 0lu;
+      return RCUTILS_RET_BAD_ALLOC);
+  }
+
+  return RCUTILS_RET_OK;
+}
+
 rcutils_ret_t
 rcutils_uint8_array_fini(rcutils_uint8_array_t * uint8_array)
 {
@@ -62,10 +100,15 @@ rcutils_uint8_array_fini(rcutils_uint8_array_t * uint8_array)
   rcutils_allocator_t * allocator = &uint8_array->allocator;
   RCUTILS_CHECK_ALLOCATOR(allocator, return RCUTILS_RET_INVALID_ARGUMENT);
 
-  allocator->deallocate(uint8_array->buffer, allocator->state);
+  if (0lu != uint8_array->buffer_alignment) {
+    rcutils_allocator_aligned_deallocate(allocator, uint8_array->buffer);
+  } else {
+    allocator->deallocate(uint8_array->buffer, allocator->state);
+  }
   uint8_array->buffer = NULL;
   uint8_array->buffer_length = 0lu;
   uint8_array->buffer_capacity = 0lu;
+  uint8_array->buffer_alignment = 0lu;
 
   return RCUTILS_RET_OK;
 }
@@ -88,8 +131,21 @@ rcutils_uint8_array_resize(rcutils_uint8_array_t * uint8_array, size_t new_size)
     return RCUTILS_RET_OK;
   }
 
-  uint8_array->buffer = rcutils_reallocf(
-    uint8_array->buffer, new_size * sizeof(uint8_t), allocator);
+  if (0lu != uint8_array->buffer_alignment) {
+    // there is no aligned reallocation, so allocate, copy and deallocate like reallocf
+    uint8_t * new_buffer = (uint8_t *)rcutils_allocator_aligned_allocate(
+      allocator, uint8_array->buffer_alignment, new_size * sizeof(uint8_t));
+    if (NULL != new_buffer && NULL != uint8_array->buffer) {
+      size_t copy_size =
+        new_size < uint8_array->buffer_capacity ? new_size : uint8_array->buffer_capacity;
+      memcpy(new_buffer, uint8_array->buffer, copy_size * sizeof(uint8_t));
+    }
+    rcutils_allocator_aligned_deallocate(allocator, uint8_array->buffer);
+    uint8_array->buffer = new_buffer;
+  } else {
+    uint8_array->buffer = rcutils_reallocf(
+      uint8_array->buffer, new_size * sizeof(uint8_t), allocator);
+  }
   RCUTILS_CHECK_FOR_NULL_WITH_MSG(
     uint8_array->buffer,
     "failed to reallocate memory for uint8 array",
@@ -0,0 +1,205 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string.h>
+
+#include "rcutils/error_handling.h"
+#include "rcutils/types/uint8_ring.h"
+
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+
+rcutils_uint8_ring_t
+rcutils_get_zero_initialized_uint8_ring(void)
+{
+  static rcutils_uint8_ring_t uint8_ring = {
+    .buffer = NULL,
+    .buffer_capacity = 0lu,
+    .read_offset = 0lu,
+    .buffer_length = 0lu
+  };
+  uint8_ring.allocator = rcutils_get_zero_initialized_allocator();
+  return uint8_ring;
+}
+
+rcutils_ret_t
+rcutils_uint8_ring_init(
+  rcutils_uint8_ring_t * uint8_ring,
+  size_t buffer_capacity,
+  const rcutils_allocator_t * allocator)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(uint8_ring, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ALLOCATOR(allocator, return RCUTILS_RET_INVALID_ARGUMENT);
+  if (0lu == buffer_capacity) {
+    RCUTILS_SET_ERROR_MSG("capacity of uint8_ring has to be greater than zero");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+
+  uint8_ring->buffer = (uint8_t *)allocator->allocate(
+    buffer_capacity * sizeof(uint8_t), allocator->state);
+  RCUTILS_CHECK_FOR_NULL_WITH_MSG(
+    uint8_ring->buffer,
+    "failed to allocate memory for uint8 ring",
+    return RCUTILS_RET_BAD_ALLOC);
+  uint8_ring->buffer_capacity = buffer_capacity;
+  uint8_ring->read_offset = 0lu;
+  uint8_ring->buffer_length = 0lu;
+  uint8_ring->allocator = *allocator;
+
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_uint8_ring_fini(rcutils_uint8_ring_t * uint8_ring)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(uint8_ring, RCUTILS_RET_INVALID_ARGUMENT);
+
+  rcutils_allocator_t * allocator = &uint8_ring->allocator;
+  RCUTILS_CHECK_ALLOCATOR(allocator, return RCUTILS_RET_INVALID_ARGUMENT);
+
+  allocator->deallocate(uint8_ring->buffer, allocator->state);
+  uint8_ring->buffer = NULL;
+  uint8_ring->buffer_capacity = 0lu;
+  uint8_ring->read_offset = 0lu;
+  uint8_ring->buffer_length = 0lu;
+
+  return RCUTILS_RET_OK;
+}
+
+// The offset in the buffer of the first free byte
+static size_t
+_rcutils_uint8_ring_write_offset(const rcutils_uint8_ring_t * uint8_ring)
+{
+  // read_offset and buffer_length are both at most the capacity, so this doesn't overflow
+  size_t offset = uint8_ring->read_offset + uint8_ring->buffer_length;
+  return offset >= uint8_ring->buffer_capacity ? offset - uint8_ring->buffer_capacity : offset;
+}
+
+rcutils_ret_t
+rcutils_uint8_ring_write(rcutils_uint8_ring_t * uint8_ring, const uint8_t * data, size_t size)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(uint8_ring, RCUTILS_RET_INVALID_ARGUMENT);
+  if (0lu == size) {
+    return RCUTILS_RET_OK;
+  }
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(data, RCUTILS_RET_INVALID_ARGUMENT);
+  if (size > uint8_ring->buffer_capacity - uint8_ring->buffer_length) {
+    RCUTILS_SET_ERROR_CODE(RCUTILS_RET_NOT_ENOUGH_SPACE, "not enough free space in uint8 ring");
+    return RCUTILS_RET_NOT_ENOUGH_SPACE;
+  }
+
+  // copy up to the end of the buffer, then the rest to its start
+  size_t offset = _rcutils_uint8_ring_write_offset(uint8_ring);
+  size_t first = MIN(size, uint8_ring->buffer_capacity - offset);
+  memcpy(uint8_ring->buffer + offset, data, first);
+  memcpy(uint8_ring->buffer, data + first, size - first);
+  uint8_ring->buffer_length += size;
+
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_uint8_ring_read(
+  rcutils_uint8_ring_t * uint8_ring, uint8_t * data, size_t size, size_t * read_size)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(uint8_ring, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(read_size, RCUTILS_RET_INVALID_ARGUMENT);
+  if (0lu != size) {
+    RCUTILS_CHECK_ARGUMENT_FOR_NULL(data, RCUTILS_RET_INVALID_ARGUMENT);
+  }
+
+  size = MIN(size, uint8_ring->buffer_length);
+  size_t first = MIN(size, uint8_ring->buffer_capacity - uint8_ring->read_offset);
+  if (0lu != size) {
+    memcpy(data, uint8_ring->buffer + uint8_ring->read_offset, first);
+    memcpy(data + first, uint8_ring->buffer, size - first);
+  }
+  *read_size = size;
+
+  return rcutils_uint8_ring_consume(uint8_ring, size);
+}
+
+rcutils_ret_t
+rcutils_uint8_ring_get_write_span(
+  const rcutils_uint8_ring_t * uint8_ring, uint8_t ** span, size_t * size)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(uint8_ring, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(span, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(size, RCUTILS_RET_INVALID_ARGUMENT);
+
+  size_t offset = _rcutils_uint8_ring_write_offset(uint8_ring);
+  *span = uint8_ring->buffer + offset;
+  *size = MIN(
+    uint8_ring->buffer_capacity - uint8_ring->buffer_length,
+    uint8_ring->buffer_capacity - offset);
+
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_uint8_ring_commit_write(rcutils_uint8_ring_t * uint8_ring, size_t size)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(uint8_ring, RCUTILS_RET_INVALID_ARGUMENT);
+
+  size_t offset = _rcutils_uint8_ring_write_offset(uint8_ring);
+  size_t span_size = MIN(
+    uint8_ring->buffer_capacity - uint8_ring->buffer_length,
+    uint8_ring->buffer_capacity - offset);
+  if (size > span_size) {
+    RCUTILS_SET_ERROR_CODE(
+      RCUTILS_RET_INVALID_ARGUMENT, "size is larger than the write span of the uint8 ring");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+  uint8_ring->buffer_length += size;
+
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_uint8_ring_get_read_span(
+  const rcutils_uint8_ring_t * uint8_ring, const uint8_t ** span, size_t * size)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(uint8_ring, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(span, RCUTILS_RET_INVALID_ARGUMENT);
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(size, RCUTILS_RET_INVALID_ARGUMENT);
+
+  *span = uint8_ring->buffer + uint8_ring->read_offset;
+  *size = MIN(
+    uint8_ring->buffer_length, uint8_ring->buffer_capacity - uint8_ring->read_offset);
+
+  return RCUTILS_RET_OK;
+}
+
+rcutils_ret_t
+rcutils_uint8_ring_consume(rcutils_uint8_ring_t * uint8_ring, size_t size)
+{
+  RCUTILS_CHECK_ARGUMENT_FOR_NULL(uint8_ring, RCUTILS_RET_INVALID_ARGUMENT);
+  if (size > uint8_ring->buffer_length) {
+    RCUTILS_SET_ERROR_CODE(
+      RCUTILS_RET_INVALID_ARGUMENT, "size is larger than the number of bytes in the uint8 ring");
+    return RCUTILS_RET_INVALID_ARGUMENT;
+  }
+
+  uint8_ring->buffer_length -= size;
+  if (0lu == uint8_ring->buffer_length) {
+    // start over at the beginning, so that the spans are as large as possible
+    uint8_ring->read_offset = 0lu;
+  } else {
+    uint8_ring->read_offset += size;
+    if (uint8_ring->read_offset >= uint8_ring->buffer_capacity) {
+      uint8_ring->read_offset -= uint8_ring->buffer_capacity;
+    }
+  }
+
+  return RCUTILS_RET_OK;
+}
@@ -78,6 +78,8 @@ get_failing_allocator(void)
   failing_allocator.reallocate = failing_realloc;
   failing_allocator.zero_allocate = failing_calloc;
   failing_allocator.state = &state;
+  failing_allocator.aligned_allocate = nullptr;
+  failing_allocator.aligned_deallocate = nullptr;
   return failing_allocator;
 }
 
@@ -0,0 +1,100 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+
+#include "performance_test_fixture/performance_test_fixture.hpp"
+#include "rcutils/allocator.h"
+
+using performance_test_fixture::PerformanceTest;
+
+// Allocates and deallocates a block of range(0) bytes.
+BENCHMARK_DEFINE_F(PerformanceTest, allocate_deallocate)(benchmark::State & st)
+{
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  const size_t size = static_cast<size_t>(st.range(0));
+  reset_heap_counters();
+  for (auto _ : st) {
+    void * pointer = allocator.allocate(size, allocator.state);
+    if (nullptr == pointer) {
+      st.SkipWithError("allocate failed");
+      break;
+    }
+    benchmark::DoNotOptimize(pointer);
+    allocator.deallocate(pointer, allocator.state);
+  }
+}
+BENCHMARK_REGISTER_F(PerformanceTest, allocate_deallocate)->RangeMultiplier(16)->Range(16, 1 << 20);
+
+BENCHMARK_DEFINE_F(PerformanceTest, zero_allocate_deallocate)(benchmark::State & st)
+{
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  const size_t size = static_cast<size_t>(st.range(0));
+  reset_heap_counters();
+  for (auto _ : st) {
+    void * pointer = allocator.zero_allocate(1u, size, allocator.state);
+    if (nullptr == pointer) {
+      st.SkipWithError("zero_allocate failed");
+      break;
+    }
+    benchmark::DoNotOptimize(pointer);
+    allocator.deallocate(pointer, allocator.state);
+  }
+}
+BENCHMARK_REGISTER_F(PerformanceTest, zero_allocate_deallocate)
+->RangeMultiplier(16)->Range(16, 1 << 20);
+
+// Grows a block to range(0) bytes by doubling it, as the containers do.
+BENCHMARK_DEFINE_F(PerformanceTest, reallocate_doubling)(benchmark::State & st)
+{
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  const size_t size = static_cast<size_t>(st.range(0));
+  reset_heap_counters();
+  for (auto _ : st) {
+    void * pointer = nullptr;
+    for (size_t capacity = 16u; capacity <= size; capacity *= 2u) {
+      void * grown = allocator.reallocate(pointer, capacity, allocator.state);
+      if (nullptr == grown) {
+        st.SkipWithError("reallocate failed");
+        break;
+      }
+      pointer = grown;
+    }
+    benchmark::DoNotOptimize(pointer);
+    allocator.deallocate(pointer, allocator.state);
+  }
+}
+BENCHMARK_REGISTER_F(PerformanceTest, reallocate_doubling)
+->RangeMultiplier(16)->Range(256, 1 << 20);
+
+// Allocates and deallocates a cache line aligned block of range(0) bytes.
+BENCHMARK_DEFINE_F(PerformanceTest, aligned_allocate_deallocate)(benchmark::State & st)
+{
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  const size_t size = static_cast<size_t>(st.range(0));
+  reset_heap_counters();
+  for (auto _ : st) {
+    void * pointer = rcutils_allocator_aligned_allocate(&allocator, 64u, size);
+    if (nullptr == pointer) {
+      st.SkipWithError("aligned_allocate failed");
+      break;
+    }
+    benchmark::DoNotOptimize(pointer);
+    rcutils_allocator_aligned_deallocate(&allocator, pointer);
+  }
+}
+BENCHMARK_REGISTER_F(PerformanceTest, aligned_allocate_deallocate)
+->RangeMultiplier(16)->Range(16, 1 << 20);
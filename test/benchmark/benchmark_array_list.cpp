@@ -0,0 +1,155 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "performance_test_fixture/performance_test_fixture.hpp"
+#include "rcutils/allocator.h"
+#include "rcutils/types/array_list.h"
+
+using performance_test_fixture::PerformanceTest;
+
+static bool
+init_array_list(benchmark::State & st, rcutils_array_list_t * array_list)
+{
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  *array_list = rcutils_get_zero_initialized_array_list();
+  if (RCUTILS_RET_OK != rcutils_array_list_init(array_list, 2u, sizeof(uint64_t), &allocator)) {
+    st.SkipWithError("rcutils_array_list_init failed");
+    return false;
+  }
+  return true;
+}
+
+// Adds range(0) entries one at a time, growing the list from its initial capacity.
+BENCHMARK_DEFINE_F(PerformanceTest, array_list_add)(benchmark::State & st)
+{
+  const uint64_t size = static_cast<uint64_t>(st.range(0));
+  reset_heap_counters();
+  for (auto _ : st) {
+    rcutils_array_list_t array_list;
+    if (!init_array_list(st, &array_list)) {
+      break;
+    }
+    for (uint64_t i = 0; i < size; ++i) {
+      if (RCUTILS_RET_OK != rcutils_array_list_add(&array_list, &i)) {
+        st.SkipWithError("rcutils_array_list_add failed");
+        break;
+      }
+    }
+    if (RCUTILS_RET_OK != rcutils_array_list_fini(&array_list)) {
+      st.SkipWithError("rcutils_array_list_fini failed");
+      break;
+    }
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations()) * st.range(0));
+}
+BENCHMARK_REGISTER_F(PerformanceTest, array_list_add)->RangeMultiplier(16)->Range(16, 65536);
+
+// Adds range(0) entries one at a time to a list reserved for all of them.
+BENCHMARK_DEFINE_F(PerformanceTest, array_list_add_reserved)(benchmark::State & st)
+{
+  const uint64_t size = static_cast<uint64_t>(st.range(0));
+  reset_heap_counters();
+  for (auto _ : st) {
+    rcutils_array_list_t array_list;
+    if (!init_array_list(st, &array_list)) {
+      break;
+    }
+    if (RCUTILS_RET_OK != rcutils_array_list_reserve(&array_list, size)) {
+      st.SkipWithError("rcutils_array_list_reserve failed");
+      break;
+    }
+    for (uint64_t i = 0; i < size; ++i) {
+      if (RCUTILS_RET_OK != rcutils_array_list_add(&array_list, &i)) {
+        st.SkipWithError("rcutils_array_list_add failed");
+        break;
+      }
+    }
+    if (RCUTILS_RET_OK != rcutils_array_list_fini(&array_list)) {
+      st.SkipWithError("rcutils_array_list_fini failed");
+      break;
+    }
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations()) * st.range(0));
+}
+BENCHMARK_REGISTER_F(PerformanceTest, array_list_add_reserved)
+->RangeMultiplier(16)->Range(16, 65536);
+
+// Adds range(0) entries at once.
+BENCHMARK_DEFINE_F(PerformanceTest, array_list_add_n)(benchmark::State & st)
+{
+  std::vector<uint64_t> data(static_cast<size_t>(st.range(0)));
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = i;
+  }
+  reset_heap_counters();
+  for (auto _ : st) {
+    rcutils_array_list_t array_list;
+    if (!init_array_list(st, &array_list)) {
+      break;
+    }
+    if (RCUTILS_RET_OK != rcutils_array_list_add_n(&array_list, data.data(), data.size())) {
+      st.SkipWithError("rcutils_array_list_add_n failed");
+      break;
+    }
+    if (RCUTILS_RET_OK != rcutils_array_list_fini(&array_list)) {
+      st.SkipWithError("rcutils_array_list_fini failed");
+      break;
+    }
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations()) * st.range(0));
+}
+BENCHMARK_REGISTER_F(PerformanceTest, array_list_add_n)->RangeMultiplier(16)->Range(16, 65536);
+
+// Gets every entry of a filled list, by copy and by pointer.
+BENCHMARK_DEFINE_F(PerformanceTest, array_list_get)(benchmark::State & st)
+{
+  const uint64_t size = static_cast<uint64_t>(st.range(0));
+  rcutils_array_list_t array_list;
+  if (!init_array_list(st, &array_list)) {
+    return;
+  }
+  for (uint64_t i = 0; i < size; ++i) {
+    if (RCUTILS_RET_OK != rcutils_array_list_add(&array_list, &i)) {
+      st.SkipWithError("rcutils_array_list_add failed");
+      break;
+    }
+  }
+  reset_heap_counters();
+  for (auto _ : st) {
+    uint64_t sum = 0u;
+    for (size_t i = 0; i < size; ++i) {
+      uint64_t data;
+      void * pointer;
+      if (
+        RCUTILS_RET_OK != rcutils_array_list_get(&array_list, i, &data) ||
+        RCUTILS_RET_OK != rcutils_array_list_get_ptr(&array_list, i, &pointer))
+      {
+        st.SkipWithError("rcutils_array_list_get failed");
+        break;
+      }
+      sum += data + *static_cast<uint64_t *>(pointer);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations()) * st.range(0));
+  if (RCUTILS_RET_OK != rcutils_array_list_fini(&array_list)) {
+    st.SkipWithError("rcutils_array_list_fini failed");
+  }
+}
+BENCHMARK_REGISTER_F(PerformanceTest, array_list_get)->RangeMultiplier(16)->Range(16, 65536);
@@ -0,0 +1,190 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <cstdarg>
+#include <cstdint>
+
+#include "performance_test_fixture/performance_test_fixture.hpp"
+#include "rcutils/allocator.h"
+#include "rcutils/types/char_array.h"
+
+using performance_test_fixture::PerformanceTest;
+
+// Each benchmark builds a string of range(0) pieces, the char array being initialized with a
+// capacity of range(1).
+static bool
+init_char_array(benchmark::State & st, rcutils_char_array_t * char_array)
+{
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  *char_array = rcutils_get_zero_initialized_char_array();
+  if (
+    RCUTILS_RET_OK != rcutils_char_array_init(
+      char_array, static_cast<size_t>(st.range(1)), &allocator))
+  {
+    st.SkipWithError("rcutils_char_array_init failed");
+    return false;
+  }
+  return true;
+}
+
+static bool
+fini_char_array(benchmark::State & st, rcutils_char_array_t * char_array)
+{
+  benchmark::DoNotOptimize(char_array->buffer);
+  if (RCUTILS_RET_OK != rcutils_char_array_fini(char_array)) {
+    st.SkipWithError("rcutils_char_array_fini failed");
+    return false;
+  }
+  return true;
+}
+
+static rcutils_ret_t
+sprintf_append(rcutils_char_array_t * char_array, const char * format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  rcutils_ret_t ret = rcutils_char_array_vsprintf_append(char_array, format, args);
+  va_end(args);
+  return ret;
+}
+
+static void
+char_array_arguments(benchmark::internal::Benchmark * benchmark)
+{
+  benchmark->ArgsProduct({{16, 1024}, {0, 256}});
+}
+
+BENCHMARK_DEFINE_F(PerformanceTest, char_array_strcat)(benchmark::State & st)
+{
+  const int64_t count = st.range(0);
+  reset_heap_counters();
+  for (auto _ : st) {
+    rcutils_char_array_t char_array;
+    if (!init_char_array(st, &char_array)) {
+      break;
+    }
+    for (int64_t i = 0; i < count; ++i) {
+      if (RCUTILS_RET_OK != rcutils_char_array_strcat(&char_array, "/topic")) {
+        st.SkipWithError("rcutils_char_array_strcat failed");
+        break;
+      }
+    }
+    if (!fini_char_array(st, &char_array)) {
+      break;
+    }
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations()) * st.range(0));
+}
+BENCHMARK_REGISTER_F(PerformanceTest, char_array_strcat)->Apply(char_array_arguments);
+
+BENCHMARK_DEFINE_F(PerformanceTest, char_array_append_n)(benchmark::State & st)
+{
+  const int64_t count = st.range(0);
+  reset_heap_counters();
+  for (auto _ : st) {
+    rcutils_char_array_t char_array;
+    if (!init_char_array(st, &char_array)) {
+      break;
+    }
+    for (int64_t i = 0; i < count; ++i) {
+      if (RCUTILS_RET_OK != rcutils_char_array_append_n(&char_array, "/topic", 6u)) {
+        st.SkipWithError("rcutils_char_array_append_n failed");
+        break;
+      }
+    }
+    if (!fini_char_array(st, &char_array)) {
+      break;
+    }
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations()) * st.range(0));
+}
+BENCHMARK_REGISTER_F(PerformanceTest, char_array_append_n)->Apply(char_array_arguments);
+
+BENCHMARK_DEFINE_F(PerformanceTest, char_array_append_char)(benchmark::State & st)
+{
+  const int64_t count = st.range(0);
+  reset_heap_counters();
+  for (auto _ : st) {
+    rcutils_char_array_t char_array;
+    if (!init_char_array(st, &char_array)) {
+      break;
+    }
+    for (int64_t i = 0; i < count; ++i) {
+      if (RCUTILS_RET_OK != rcutils_char_array_append_char(&char_array, 'x')) {
+        st.SkipWithError("rcutils_char_array_append_char failed");
+        break;
+      }
+    }
+    if (!fini_char_array(st, &char_array)) {
+      break;
+    }
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations()) * st.range(0));
+}
+BENCHMARK_REGISTER_F(PerformanceTest, char_array_append_char)->Apply(char_array_arguments);
+
+// Appends numbers with the dedicated function, to compare with the formatted append below.
+BENCHMARK_DEFINE_F(PerformanceTest, char_array_append_u64)(benchmark::State & st)
+{
+  const int64_t count = st.range(0);
+  reset_heap_counters();
+  for (auto _ : st) {
+    rcutils_char_array_t char_array;
+    if (!init_char_array(st, &char_array)) {
+      break;
+    }
+    for (int64_t i = 0; i < count; ++i) {
+      if (
+        RCUTILS_RET_OK != rcutils_char_array_append_u64(
+          &char_array, static_cast<uint64_t>(i) * 1000003u))
+      {
+        st.SkipWithError("rcutils_char_array_append_u64 failed");
+        break;
+      }
+    }
+    if (!fini_char_array(st, &char_array)) {
+      break;
+    }
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations()) * st.range(0));
+}
+BENCHMARK_REGISTER_F(PerformanceTest, char_array_append_u64)->Apply(char_array_arguments);
+
+BENCHMARK_DEFINE_F(PerformanceTest, char_array_vsprintf_append)(benchmark::State & st)
+{
+  const int64_t count = st.range(0);
+  reset_heap_counters();
+  for (auto _ : st) {
+    rcutils_char_array_t char_array;
+    if (!init_char_array(st, &char_array)) {
+      break;
+    }
+    for (int64_t i = 0; i < count; ++i) {
+      if (
+        RCUTILS_RET_OK != sprintf_append(
+          &char_array, "%llu", static_cast<unsigned long long>(i) * 1000003u))  // NOLINT
+      {
+        st.SkipWithError("rcutils_char_array_vsprintf_append failed");
+        break;
+      }
+    }
+    if (!fini_char_array(st, &char_array)) {
+      break;
+    }
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations()) * st.range(0));
+}
+BENCHMARK_REGISTER_F(PerformanceTest, char_array_vsprintf_append)->Apply(char_array_arguments);
@@ -14,8 +14,21 @@
 
 #include <benchmark/benchmark.h>
 #include <cassert>
+#include <cstdio>
 #include <string>
 
+#ifdef _WIN32
+#include <io.h>
+#define dup _dup
+#define dup2 _dup2
+#define close _close
+#define fileno _fileno
+#define NULL_DEVICE "NUL"
+#else
+#include <unistd.h>
+#define NULL_DEVICE "/dev/null"
+#endif
+
 #include "rcutils/error_handling.h"
 
 static void benchmark_err_handling(benchmark::State & state)
@@ -32,3 +45,158 @@ static void benchmark_err_handling(benchmark::State & state)
 }
 
 BENCHMARK(benchmark_err_handling);
+
+static void benchmark_set_error_msg_with_format_string(benchmark::State & state)
+{
+  int value = 42;
+  for (auto _ : state) {
+    rcutils_reset_error();
+    RCUTILS_SET_ERROR_MSG_WITH_FORMAT_STRING("invalid value %d for '%s'", value, "parameter");
+  }
+}
+
+BENCHMARK(benchmark_set_error_msg_with_format_string);
+
+static void benchmark_set_error_msg_static(benchmark::State & state)
+{
+  for (auto _ : state) {
+    rcutils_reset_error();
+    RCUTILS_SET_ERROR_MSG_STATIC("test message");
+  }
+}
+
+BENCHMARK(benchmark_set_error_msg_static);
+
+static void benchmark_set_error_code(benchmark::State & state)
+{
+  for (auto _ : state) {
+    rcutils_reset_error();
+    RCUTILS_SET_ERROR_CODE(RCUTILS_RET_NOT_ENOUGH_SPACE, "test message");
+    benchmark::DoNotOptimize(rcutils_get_error_code());
+  }
+}
+
+BENCHMARK(benchmark_set_error_code);
+
+// Redirects stderr to the null device while in scope, so that the reports of overwritten
+// errors are measured without flooding the output.
+class ScopedSilentStderr
+{
+public:
+  ScopedSilentStderr()
+  {
+    fflush(stderr);
+    saved_ = dup(fileno(stderr));
+    FILE * null_device = fopen(NULL_DEVICE, "w");
+    if (null_device) {
+      dup2(fileno(null_device), fileno(stderr));
+      fclose(null_device);
+    }
+  }
+
+  ~ScopedSilentStderr()
+  {
+    fflush(stderr);
+    if (saved_ >= 0) {
+      dup2(saved_, fileno(stderr));
+      close(saved_);
+    }
+  }
+
+private:
+  int saved_;
+};
+
+// Overwrites an error with a different one, which is formatted and reported to stderr.
+static void benchmark_overwrite_error(benchmark::State & state)
+{
+  ScopedSilentStderr silent_stderr;
+  rcutils_reset_error();
+  RCUTILS_SET_ERROR_MSG("first message");
+  for (auto _ : state) {
+    RCUTILS_SET_ERROR_MSG("second message");
+    RCUTILS_SET_ERROR_MSG("first message");
+  }
+  rcutils_reset_error();
+}
+
+BENCHMARK(benchmark_overwrite_error);
+
+// Overwrites an error with the same one, which isn't reported.
+static void benchmark_overwrite_error_same_message(benchmark::State & state)
+{
+  rcutils_reset_error();
+  RCUTILS_SET_ERROR_MSG("test message");
+  for (auto _ : state) {
+    RCUTILS_SET_ERROR_MSG("test message");
+  }
+  rcutils_reset_error();
+}
+
+BENCHMARK(benchmark_overwrite_error_same_message);
+
+// Overwrites an error with a different one, which is recorded in the history instead.
+static void benchmark_overwrite_error_with_history(benchmark::State & state)
+{
+  const bool was_enabled = rcutils_error_history_is_enabled();
+  rcutils_set_error_history_enabled(true);
+  rcutils_reset_error();
+  RCUTILS_SET_ERROR_MSG("first message");
+  for (auto _ : state) {
+    RCUTILS_SET_ERROR_MSG("second message");
+    RCUTILS_SET_ERROR_MSG("first message");
+  }
+  rcutils_reset_error();
+  rcutils_clear_error_history();
+  rcutils_set_error_history_enabled(was_enabled);
+}
+
+BENCHMARK(benchmark_overwrite_error_with_history);
+
+static void benchmark_get_error_string(benchmark::State & state)
+{
+  for (auto _ : state) {
+    rcutils_reset_error();
+    RCUTILS_SET_ERROR_MSG("test message");
+    benchmark::DoNotOptimize(rcutils_get_error_string());
+  }
+}
+
+BENCHMARK(benchmark_get_error_string);
+
+// Formats the deferred error state of a string literal on the first get.
+static void benchmark_get_error_string_static(benchmark::State & state)
+{
+  for (auto _ : state) {
+    rcutils_reset_error();
+    RCUTILS_SET_ERROR_MSG_STATIC("test message");
+    benchmark::DoNotOptimize(rcutils_get_error_string());
+  }
+}
+
+BENCHMARK(benchmark_get_error_string_static);
+
+// Gets the error string again, once it's been formatted.
+static void benchmark_get_error_string_formatted(benchmark::State & state)
+{
+  rcutils_reset_error();
+  RCUTILS_SET_ERROR_MSG("test message");
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(rcutils_get_error_string());
+  }
+  rcutils_reset_error();
+}
+
+BENCHMARK(benchmark_get_error_string_formatted);
+
+// Sets, checks and resets errors from several threads, each with its own error state.
+static void benchmark_err_handling_threads(benchmark::State & state)
+{
+  for (auto _ : state) {
+    RCUTILS_SET_ERROR_MSG("test message");
+    benchmark::DoNotOptimize(rcutils_error_is_set());
+    rcutils_reset_error();
+  }
+}
+
+BENCHMARK(benchmark_err_handling_threads)->ThreadRange(1, 8)->UseRealTime();
@@ -0,0 +1,265 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "performance_test_fixture/performance_test_fixture.hpp"
+#include "rcutils/allocator.h"
+#include "rcutils/types/hash_map.h"
+
+using performance_test_fixture::PerformanceTest;
+
+// The benchmarks take the number of entries as range(0), and the backend as range(1).
+static void
+hash_map_arguments(benchmark::internal::Benchmark * benchmark)
+{
+  const int64_t backends[] = {
+    RCUTILS_HASH_MAP_BACKEND_CHAINING, RCUTILS_HASH_MAP_BACKEND_OPEN_ADDRESSING};
+  for (int64_t backend : backends) {
+    for (int64_t size : {16, 256, 4096, 65536}) {
+      benchmark->Args({size, backend});
+    }
+  }
+}
+
+static bool
+init_hash_map(
+  benchmark::State & st, rcutils_hash_map_t * hash_map, size_t key_size,
+  rcutils_hash_map_key_hasher_t hasher, rcutils_hash_map_key_cmp_t cmp)
+{
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  rcutils_hash_map_options_t options = rcutils_hash_map_get_default_options();
+  options.backend = static_cast<rcutils_hash_map_backend_t>(st.range(1));
+  *hash_map = rcutils_get_zero_initialized_hash_map();
+  if (
+    RCUTILS_RET_OK != rcutils_hash_map_init_with_options(
+      hash_map, 2u, key_size, sizeof(uint64_t), hasher, cmp, &options, &allocator))
+  {
+    st.SkipWithError("rcutils_hash_map_init_with_options failed");
+    return false;
+  }
+  return true;
+}
+
+static bool
+init_uint64_hash_map(benchmark::State & st, rcutils_hash_map_t * hash_map)
+{
+  return init_hash_map(
+    st, hash_map, sizeof(uint64_t), rcutils_hash_map_uint64_hash_func,
+    rcutils_hash_map_uint64_cmp_func);
+}
+
+static bool
+init_string_hash_map(benchmark::State & st, rcutils_hash_map_t * hash_map)
+{
+  return init_hash_map(
+    st, hash_map, sizeof(const char *), rcutils_hash_map_fast_string_hash_func,
+    rcutils_hash_map_string_cmp_func);
+}
+
+// Keys spread like those of ids, rather than consecutive.
+static uint64_t
+uint64_key(uint64_t i)
+{
+  return i * 0x9E3779B97F4A7C15ull;
+}
+
+static std::vector<std::string>
+string_keys(size_t count)
+{
+  std::vector<std::string> keys;
+  keys.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    keys.push_back("/namespace/node_" + std::to_string(i) + "/topic");
+  }
+  return keys;
+}
+
+// Fills an empty hash map, growing it from its initial capacity.
+BENCHMARK_DEFINE_F(PerformanceTest, hash_map_insert_uint64)(benchmark::State & st)
+{
+  const uint64_t size = static_cast<uint64_t>(st.range(0));
+  reset_heap_counters();
+  for (auto _ : st) {
+    rcutils_hash_map_t hash_map;
+    if (!init_uint64_hash_map(st, &hash_map)) {
+      break;
+    }
+    for (uint64_t i = 0; i < size; ++i) {
+      uint64_t key = uint64_key(i);
+      if (RCUTILS_RET_OK != rcutils_hash_map_set(&hash_map, &key, &i)) {
+        st.SkipWithError("rcutils_hash_map_set failed");
+        break;
+      }
+    }
+    if (RCUTILS_RET_OK != rcutils_hash_map_fini(&hash_map)) {
+      st.SkipWithError("rcutils_hash_map_fini failed");
+      break;
+    }
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations()) * st.range(0));
+}
+BENCHMARK_REGISTER_F(PerformanceTest, hash_map_insert_uint64)->Apply(hash_map_arguments);
+
+// Fills a hash map reserved for all the entries, so it never grows.
+BENCHMARK_DEFINE_F(PerformanceTest, hash_map_insert_reserved_uint64)(benchmark::State & st)
+{
+  const uint64_t size = static_cast<uint64_t>(st.range(0));
+  reset_heap_counters();
+  for (auto _ : st) {
+    rcutils_hash_map_t hash_map;
+    if (!init_uint64_hash_map(st, &hash_map)) {
+      break;
+    }
+    if (RCUTILS_RET_OK != rcutils_hash_map_reserve(&hash_map, size)) {
+      st.SkipWithError("rcutils_hash_map_reserve failed");
+      break;
+    }
+    for (uint64_t i = 0; i < size; ++i) {
+      uint64_t key = uint64_key(i);
+      if (RCUTILS_RET_OK != rcutils_hash_map_set(&hash_map, &key, &i)) {
+        st.SkipWithError("rcutils_hash_map_set failed");
+        break;
+      }
+    }
+    if (RCUTILS_RET_OK != rcutils_hash_map_fini(&hash_map)) {
+      st.SkipWithError("rcutils_hash_map_fini failed");
+      break;
+    }
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations()) * st.range(0));
+}
+BENCHMARK_REGISTER_F(PerformanceTest, hash_map_insert_reserved_uint64)
+->Apply(hash_map_arguments);
+
+// Looks up every key of a filled hash map, then as many missing keys.
+BENCHMARK_DEFINE_F(PerformanceTest, hash_map_lookup_uint64)(benchmark::State & st)
+{
+  const uint64_t size = static_cast<uint64_t>(st.range(0));
+  rcutils_hash_map_t hash_map;
+  if (!init_uint64_hash_map(st, &hash_map)) {
+    return;
+  }
+  for (uint64_t i = 0; i < size; ++i) {
+    uint64_t key = uint64_key(i);
+    if (RCUTILS_RET_OK != rcutils_hash_map_set(&hash_map, &key, &i)) {
+      st.SkipWithError("rcutils_hash_map_set failed");
+      break;
+    }
+  }
+  reset_heap_counters();
+  for (auto _ : st) {
+    for (uint64_t i = 0; i < 2u * size; ++i) {
+      uint64_t key = uint64_key(i);
+      uint64_t data;
+      benchmark::DoNotOptimize(rcutils_hash_map_get(&hash_map, &key, &data));
+    }
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations()) * 2 * st.range(0));
+  if (RCUTILS_RET_OK != rcutils_hash_map_fini(&hash_map)) {
+    st.SkipWithError("rcutils_hash_map_fini failed");
+  }
+}
+BENCHMARK_REGISTER_F(PerformanceTest, hash_map_lookup_uint64)->Apply(hash_map_arguments);
+
+// Iterates over all the entries of a filled hash map.
+BENCHMARK_DEFINE_F(PerformanceTest, hash_map_iterate_uint64)(benchmark::State & st)
+{
+  const uint64_t size = static_cast<uint64_t>(st.range(0));
+  rcutils_hash_map_t hash_map;
+  if (!init_uint64_hash_map(st, &hash_map)) {
+    return;
+  }
+  for (uint64_t i = 0; i < size; ++i) {
+    uint64_t key = uint64_key(i);
+    if (RCUTILS_RET_OK != rcutils_hash_map_set(&hash_map, &key, &i)) {
+      st.SkipWithError("rcutils_hash_map_set failed");
+      break;
+    }
+  }
+  reset_heap_counters();
+  for (auto _ : st) {
+    rcutils_hash_map_iterator_t iterator = rcutils_hash_map_get_zero_initialized_iterator();
+    uint64_t key, data, sum = 0u;
+    while (RCUTILS_RET_OK == rcutils_hash_map_iterate(&hash_map, &iterator, &key, &data)) {
+      sum += data;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations()) * st.range(0));
+  if (RCUTILS_RET_OK != rcutils_hash_map_fini(&hash_map)) {
+    st.SkipWithError("rcutils_hash_map_fini failed");
+  }
+}
+BENCHMARK_REGISTER_F(PerformanceTest, hash_map_iterate_uint64)->Apply(hash_map_arguments);
+
+BENCHMARK_DEFINE_F(PerformanceTest, hash_map_insert_string)(benchmark::State & st)
+{
+  const std::vector<std::string> keys = string_keys(static_cast<size_t>(st.range(0)));
+  reset_heap_counters();
+  for (auto _ : st) {
+    rcutils_hash_map_t hash_map;
+    if (!init_string_hash_map(st, &hash_map)) {
+      break;
+    }
+    for (uint64_t i = 0; i < keys.size(); ++i) {
+      const char * key = keys[i].c_str();
+      if (RCUTILS_RET_OK != rcutils_hash_map_set(&hash_map, &key, &i)) {
+        st.SkipWithError("rcutils_hash_map_set failed");
+        break;
+      }
+    }
+    if (RCUTILS_RET_OK != rcutils_hash_map_fini(&hash_map)) {
+      st.SkipWithError("rcutils_hash_map_fini failed");
+      break;
+    }
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations()) * st.range(0));
+}
+BENCHMARK_REGISTER_F(PerformanceTest, hash_map_insert_string)->Apply(hash_map_arguments);
+
+BENCHMARK_DEFINE_F(PerformanceTest, hash_map_lookup_string)(benchmark::State & st)
+{
+  const std::vector<std::string> keys = string_keys(static_cast<size_t>(st.range(0)));
+  rcutils_hash_map_t hash_map;
+  if (!init_string_hash_map(st, &hash_map)) {
+    return;
+  }
+  for (uint64_t i = 0; i < keys.size(); ++i) {
+    const char * key = keys[i].c_str();
+    if (RCUTILS_RET_OK != rcutils_hash_map_set(&hash_map, &key, &i)) {
+      st.SkipWithError("rcutils_hash_map_set failed");
+      break;
+    }
+  }
+  // Copies of the keys, so that they're compared rather than matched by address
+  const std::vector<std::string> lookups(keys);
+  reset_heap_counters();
+  for (auto _ : st) {
+    for (const std::string & lookup : lookups) {
+      const char * key = lookup.c_str();
+      uint64_t data;
+      benchmark::DoNotOptimize(rcutils_hash_map_get(&hash_map, &key, &data));
+    }
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations()) * st.range(0));
+  if (RCUTILS_RET_OK != rcutils_hash_map_fini(&hash_map)) {
+    st.SkipWithError("rcutils_hash_map_fini failed");
+  }
+}
+BENCHMARK_REGISTER_F(PerformanceTest, hash_map_lookup_string)->Apply(hash_map_arguments);
@@ -13,13 +13,18 @@
 // limitations under the License.
 
 #include <benchmark/benchmark.h>
+#include <atomic>
 #include <cassert>
 #include <string>
 #include <vector>
 
 #include "../allocator_testing_utils.h"
 #include "osrf_testing_tools_cpp/scope_exit.hpp"
+#include "rcutils/allocator.h"
+#include "rcutils/env.h"
 #include "rcutils/logging.h"
+#include "rcutils/logging_macros.h"
+#include "rcutils/types/char_array.h"
 
 #ifdef RMW_IMPLEMENTATION
 # define CLASSNAME_(NAME, SUFFIX) NAME ## __ ## SUFFIX
@@ -88,3 +93,222 @@ static void benchmark_logging(benchmark::State & state)
 }
 
 BENCHMARK(benchmark_logging);
+
+// The allocations made through the allocator given to the logging system.
+static std::atomic<size_t> g_allocations(0u);
+
+static void * counting_allocate(size_t size, void * state)
+{
+  (void)state;
+  ++g_allocations;
+  return rcutils_get_default_allocator().allocate(size, rcutils_get_default_allocator().state);
+}
+
+static void * counting_reallocate(void * pointer, size_t size, void * state)
+{
+  (void)state;
+  ++g_allocations;
+  return rcutils_get_default_allocator().reallocate(
+    pointer, size, rcutils_get_default_allocator().state);
+}
+
+static void * counting_zero_allocate(
+  size_t number_of_elements, size_t size_of_element, void * state)
+{
+  (void)state;
+  ++g_allocations;
+  return rcutils_get_default_allocator().zero_allocate(
+    number_of_elements, size_of_element, rcutils_get_default_allocator().state);
+}
+
+static void counting_deallocate(void * pointer, void * state)
+{
+  (void)state;
+  rcutils_get_default_allocator().deallocate(pointer, rcutils_get_default_allocator().state);
+}
+
+static rcutils_allocator_t get_counting_allocator()
+{
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  allocator.allocate = counting_allocate;
+  allocator.reallocate = counting_reallocate;
+  allocator.zero_allocate = counting_zero_allocate;
+  allocator.deallocate = counting_deallocate;
+  allocator.state = NULL;
+  return allocator;
+}
+
+// Does the work of rcutils_logging_console_output_handler() but discards the output, so that
+// the numbers don't depend on the terminal the benchmarks run in.
+static void formatting_output_handler(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * format, va_list * args)
+{
+  rcutils_allocator_t allocator = get_counting_allocator();
+  char msg_buf[1024] = "";
+  rcutils_char_array_t msg_array = {msg_buf, false, 0u, sizeof(msg_buf), allocator};
+  char output_buf[1024] = "";
+  rcutils_char_array_t output_array = {output_buf, false, 0u, sizeof(output_buf), allocator};
+
+  if (rcutils_char_array_vsprintf(&msg_array, format, *args) == RCUTILS_RET_OK) {
+    if (rcutils_logging_format_message(
+        location, severity, name, timestamp, msg_array.buffer, &output_array) == RCUTILS_RET_OK)
+    {
+      benchmark::DoNotOptimize(output_array.buffer);
+    }
+  }
+  rcutils_ret_t ret = rcutils_char_array_fini(&msg_array);
+  assert(ret == RCUTILS_RET_OK);
+  ret = rcutils_char_array_fini(&output_array);
+  assert(ret == RCUTILS_RET_OK);
+  (void)ret;
+}
+
+// Initialize logging with the formatting output handler and the counting allocator.
+// NULL selects the default output format.
+static void initialize_logging(const char * output_format)
+{
+  bool env_set = rcutils_set_env("RCUTILS_CONSOLE_OUTPUT_FORMAT", output_format);
+  assert(env_set);
+  (void)env_set;
+  auto ret_value = rcutils_logging_initialize_with_allocator(get_counting_allocator());
+  assert(ret_value == RCUTILS_RET_OK);
+  (void)ret_value;
+  rcutils_logging_set_output_handler(formatting_output_handler);
+}
+
+static void shutdown_logging()
+{
+  auto ret_value = rcutils_logging_shutdown();
+  assert(ret_value == RCUTILS_RET_OK);
+  (void)ret_value;
+}
+
+// Count the allocations made during the measured iterations, per iteration.
+static void start_counting_allocations()
+{
+  g_allocations = 0u;
+}
+
+static void report_allocations(benchmark::State & state)
+{
+  state.counters["allocations"] = benchmark::Counter(
+    static_cast<double>(g_allocations.load()), benchmark::Counter::kAvgIterations);
+}
+
+static const char * const g_deep_logger_name = "a.b.c.d.e.f.g.h.i.j";
+
+static void benchmark_log_disabled_deep_hierarchy(benchmark::State & state)
+{
+  initialize_logging(NULL);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    shutdown_logging();
+  });
+  // The effective level is inherited from the root of the hierarchy.
+  auto ret_value = rcutils_logging_set_logger_level("a", RCUTILS_LOG_SEVERITY_ERROR);
+  assert(ret_value == RCUTILS_RET_OK);
+  (void)ret_value;
+
+  start_counting_allocations();
+  for (auto _ : state) {
+    rcutils_log(NULL, RCUTILS_LOG_SEVERITY_DEBUG, g_deep_logger_name, "message %d", 42);
+  }
+  report_allocations(state);
+}
+BENCHMARK(benchmark_log_disabled_deep_hierarchy);
+
+static void benchmark_log_macro_disabled_deep_hierarchy(benchmark::State & state)
+{
+  initialize_logging(NULL);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    shutdown_logging();
+  });
+  auto ret_value = rcutils_logging_set_logger_level("a", RCUTILS_LOG_SEVERITY_ERROR);
+  assert(ret_value == RCUTILS_RET_OK);
+  (void)ret_value;
+
+  start_counting_allocations();
+  for (auto _ : state) {
+    RCUTILS_LOG_DEBUG_NAMED(g_deep_logger_name, "message %d", 42);
+  }
+  report_allocations(state);
+}
+BENCHMARK(benchmark_log_macro_disabled_deep_hierarchy);
+
+static void benchmark_log_enabled_default_format(benchmark::State & state)
+{
+  initialize_logging(NULL);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    shutdown_logging();
+  });
+  rcutils_log_location_t location = {"function", "file.cpp", 42u};
+
+  start_counting_allocations();
+  for (auto _ : state) {
+    rcutils_log(&location, RCUTILS_LOG_SEVERITY_INFO, "name", "message %d", 42);
+  }
+  report_allocations(state);
+}
+BENCHMARK(benchmark_log_enabled_default_format);
+
+static void benchmark_log_enabled_all_tokens(benchmark::State & state)
+{
+  initialize_logging(
+    "[{severity}] [{time}] [{time_as_nanoseconds}] [{time_iso8601}] [{name}] "
+    "[{function_name}] [{file_name}:{line_number}]: {message}");
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    shutdown_logging();
+  });
+  rcutils_log_location_t location = {"function", "file.cpp", 42u};
+
+  start_counting_allocations();
+  for (auto _ : state) {
+    rcutils_log(&location, RCUTILS_LOG_SEVERITY_INFO, "name", "message %d", 42);
+  }
+  report_allocations(state);
+}
+BENCHMARK(benchmark_log_enabled_all_tokens);
+
+static void benchmark_log_enabled_long_message(benchmark::State & state)
+{
+  initialize_logging(NULL);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    shutdown_logging();
+  });
+  rcutils_log_location_t location = {"function", "file.cpp", 42u};
+  // Longer than the 1024 bytes buffers on the stack of the output handler.
+  const std::string message(static_cast<size_t>(state.range(0)), 'x');
+
+  start_counting_allocations();
+  for (auto _ : state) {
+    rcutils_log(&location, RCUTILS_LOG_SEVERITY_INFO, "name", "%s", message.c_str());
+  }
+  report_allocations(state);
+}
+BENCHMARK(benchmark_log_enabled_long_message)->Arg(2048)->Arg(16384);
+
+static void benchmark_log_contention(benchmark::State & state)
+{
+  if (state.thread_index() == 0) {
+    initialize_logging(NULL);
+    start_counting_allocations();
+  }
+  rcutils_log_location_t location = {"function", "file.cpp", 42u};
+
+  for (auto _ : state) {
+    rcutils_log(&location, RCUTILS_LOG_SEVERITY_INFO, "name", "message %d", 42);
+    rcutils_log(NULL, RCUTILS_LOG_SEVERITY_DEBUG, g_deep_logger_name, "message %d", 42);
+  }
+
+  if (state.thread_index() == 0) {
+    report_allocations(state);
+    shutdown_logging();
+  }
+}
+BENCHMARK(benchmark_log_contention)->ThreadRange(1, 8)->UseRealTime();
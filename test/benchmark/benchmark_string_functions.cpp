@@ -0,0 +1,142 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+#include "performance_test_fixture/performance_test_fixture.hpp"
+#include "rcutils/allocator.h"
+#include "rcutils/find.h"
+#include "rcutils/repl_str.h"
+#include "rcutils/split.h"
+#include "rcutils/types/string_array.h"
+#include "rcutils/types/string_view.h"
+
+using performance_test_fixture::PerformanceTest;
+
+// A path of range(0) tokens.
+static std::string
+make_path(int64_t tokens)
+{
+  std::string path;
+  for (int64_t i = 0; i < tokens; ++i) {
+    path += "/token_" + std::to_string(i);
+  }
+  return path;
+}
+
+BENCHMARK_DEFINE_F(PerformanceTest, split)(benchmark::State & st)
+{
+  const std::string path = make_path(st.range(0));
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  reset_heap_counters();
+  for (auto _ : st) {
+    rcutils_string_array_t tokens = rcutils_get_zero_initialized_string_array();
+    if (RCUTILS_RET_OK != rcutils_split(path.c_str(), '/', allocator, &tokens)) {
+      st.SkipWithError("rcutils_split failed");
+      break;
+    }
+    if (RCUTILS_RET_OK != rcutils_string_array_fini(&tokens)) {
+      st.SkipWithError("rcutils_string_array_fini failed");
+      break;
+    }
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations()) * st.range(0));
+}
+BENCHMARK_REGISTER_F(PerformanceTest, split)->RangeMultiplier(8)->Range(4, 256);
+
+// Splits without allocating, for comparison with rcutils_split().
+BENCHMARK_DEFINE_F(PerformanceTest, split_next_view)(benchmark::State & st)
+{
+  const std::string path = make_path(st.range(0));
+  reset_heap_counters();
+  for (auto _ : st) {
+    rcutils_string_view_t token = rcutils_get_zero_initialized_string_view();
+    size_t length = 0u;
+    while (rcutils_split_next_view(path.c_str(), '/', &token)) {
+      length += token.length;
+    }
+    benchmark::DoNotOptimize(length);
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations()) * st.range(0));
+}
+BENCHMARK_REGISTER_F(PerformanceTest, split_next_view)->RangeMultiplier(8)->Range(4, 256);
+
+// Replaces every separator of a path, like when converting names.
+BENCHMARK_DEFINE_F(PerformanceTest, repl_str)(benchmark::State & st)
+{
+  const std::string path = make_path(st.range(0));
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  reset_heap_counters();
+  for (auto _ : st) {
+    char * replaced = rcutils_repl_str(path.c_str(), "/", "::", &allocator);
+    if (nullptr == replaced) {
+      st.SkipWithError("rcutils_repl_str failed");
+      break;
+    }
+    allocator.deallocate(replaced, allocator.state);
+  }
+  st.SetBytesProcessed(static_cast<int64_t>(st.iterations() * path.size()));
+}
+BENCHMARK_REGISTER_F(PerformanceTest, repl_str)->RangeMultiplier(8)->Range(4, 256);
+
+// The find benchmarks search for what is at the end of the path, or not in it at all.
+BENCHMARK_DEFINE_F(PerformanceTest, find)(benchmark::State & st)
+{
+  const std::string path = make_path(st.range(0)) + "#";
+  reset_heap_counters();
+  for (auto _ : st) {
+    benchmark::DoNotOptimize(rcutils_find(path.c_str(), '#'));
+    benchmark::DoNotOptimize(rcutils_find(path.c_str(), '?'));
+  }
+  st.SetBytesProcessed(static_cast<int64_t>(st.iterations() * 2u * path.size()));
+}
+BENCHMARK_REGISTER_F(PerformanceTest, find)->RangeMultiplier(8)->Range(4, 256);
+
+BENCHMARK_DEFINE_F(PerformanceTest, find_last)(benchmark::State & st)
+{
+  const std::string path = "#" + make_path(st.range(0));
+  reset_heap_counters();
+  for (auto _ : st) {
+    benchmark::DoNotOptimize(rcutils_find_last(path.c_str(), '#'));
+    benchmark::DoNotOptimize(rcutils_find_last(path.c_str(), '?'));
+  }
+  st.SetBytesProcessed(static_cast<int64_t>(st.iterations() * 2u * path.size()));
+}
+BENCHMARK_REGISTER_F(PerformanceTest, find_last)->RangeMultiplier(8)->Range(4, 256);
+
+BENCHMARK_DEFINE_F(PerformanceTest, find_any)(benchmark::State & st)
+{
+  const std::string path = make_path(st.range(0)) + "#";
+  reset_heap_counters();
+  for (auto _ : st) {
+    benchmark::DoNotOptimize(rcutils_find_any(path.c_str(), "#{}"));
+    benchmark::DoNotOptimize(rcutils_find_any(path.c_str(), "?{}"));
+  }
+  st.SetBytesProcessed(static_cast<int64_t>(st.iterations() * 2u * path.size()));
+}
+BENCHMARK_REGISTER_F(PerformanceTest, find_any)->RangeMultiplier(8)->Range(4, 256);
+
+BENCHMARK_DEFINE_F(PerformanceTest, find_str)(benchmark::State & st)
+{
+  const std::string path = make_path(st.range(0)) + "/needle";
+  reset_heap_counters();
+  for (auto _ : st) {
+    benchmark::DoNotOptimize(rcutils_find_str(path.c_str(), "/needle"));
+    benchmark::DoNotOptimize(rcutils_find_str(path.c_str(), "/missing"));
+  }
+  st.SetBytesProcessed(static_cast<int64_t>(st.iterations() * 2u * path.size()));
+}
+BENCHMARK_REGISTER_F(PerformanceTest, find_str)->RangeMultiplier(8)->Range(4, 256);
@@ -0,0 +1,154 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include "performance_test_fixture/performance_test_fixture.hpp"
+#include "rcutils/allocator.h"
+#include "rcutils/types/string_map.h"
+
+using performance_test_fixture::PerformanceTest;
+
+static std::vector<std::string>
+make_keys(size_t count)
+{
+  std::vector<std::string> keys;
+  keys.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    keys.push_back("parameter_" + std::to_string(i));
+  }
+  return keys;
+}
+
+// Initializes the map with the arena if range(1) is not 0.
+static bool
+init_string_map(benchmark::State & st, rcutils_string_map_t * string_map)
+{
+  *string_map = rcutils_get_zero_initialized_string_map();
+  rcutils_ret_t ret = 0 != st.range(1) ?
+    rcutils_string_map_init_with_arena(string_map, 2u, rcutils_get_default_allocator(), 4096u) :
+    rcutils_string_map_init(string_map, 2u, rcutils_get_default_allocator());
+  if (RCUTILS_RET_OK != ret) {
+    st.SkipWithError("rcutils_string_map_init failed");
+    return false;
+  }
+  return true;
+}
+
+static bool
+fill_string_map(
+  benchmark::State & st, rcutils_string_map_t * string_map, const std::vector<std::string> & keys)
+{
+  for (const std::string & key : keys) {
+    if (RCUTILS_RET_OK != rcutils_string_map_set(string_map, key.c_str(), "value")) {
+      st.SkipWithError("rcutils_string_map_set failed");
+      return false;
+    }
+  }
+  return true;
+}
+
+// Fills an empty map, growing it from its initial capacity.
+BENCHMARK_DEFINE_F(PerformanceTest, string_map_set)(benchmark::State & st)
+{
+  const std::vector<std::string> keys = make_keys(static_cast<size_t>(st.range(0)));
+  reset_heap_counters();
+  for (auto _ : st) {
+    rcutils_string_map_t string_map;
+    if (!init_string_map(st, &string_map) || !fill_string_map(st, &string_map, keys)) {
+      break;
+    }
+    if (RCUTILS_RET_OK != rcutils_string_map_fini(&string_map)) {
+      st.SkipWithError("rcutils_string_map_fini failed");
+      break;
+    }
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations()) * st.range(0));
+}
+BENCHMARK_REGISTER_F(PerformanceTest, string_map_set)
+->ArgsProduct({{16, 256, 4096}, {0, 1}});
+
+// Replaces the values of the keys of a filled map.
+BENCHMARK_DEFINE_F(PerformanceTest, string_map_replace)(benchmark::State & st)
+{
+  const std::vector<std::string> keys = make_keys(static_cast<size_t>(st.range(0)));
+  rcutils_string_map_t string_map;
+  if (!init_string_map(st, &string_map)) {
+    return;
+  }
+  if (fill_string_map(st, &string_map, keys)) {
+    reset_heap_counters();
+    for (auto _ : st) {
+      if (!fill_string_map(st, &string_map, keys)) {
+        break;
+      }
+    }
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations()) * st.range(0));
+  if (RCUTILS_RET_OK != rcutils_string_map_fini(&string_map)) {
+    st.SkipWithError("rcutils_string_map_fini failed");
+  }
+}
+BENCHMARK_REGISTER_F(PerformanceTest, string_map_replace)
+->ArgsProduct({{16, 256, 4096}, {0, 1}});
+
+// Gets the value of every key of a filled map.
+BENCHMARK_DEFINE_F(PerformanceTest, string_map_get)(benchmark::State & st)
+{
+  const std::vector<std::string> keys = make_keys(static_cast<size_t>(st.range(0)));
+  rcutils_string_map_t string_map;
+  if (!init_string_map(st, &string_map)) {
+    return;
+  }
+  if (fill_string_map(st, &string_map, keys)) {
+    reset_heap_counters();
+    for (auto _ : st) {
+      for (const std::string & key : keys) {
+        benchmark::DoNotOptimize(rcutils_string_map_get(&string_map, key.c_str()));
+      }
+    }
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations()) * st.range(0));
+  if (RCUTILS_RET_OK != rcutils_string_map_fini(&string_map)) {
+    st.SkipWithError("rcutils_string_map_fini failed");
+  }
+}
+BENCHMARK_REGISTER_F(PerformanceTest, string_map_get)->ArgsProduct({{16, 256, 4096}, {0}});
+
+// Iterates over all the keys of a filled map.
+BENCHMARK_DEFINE_F(PerformanceTest, string_map_iterate)(benchmark::State & st)
+{
+  const std::vector<std::string> keys = make_keys(static_cast<size_t>(st.range(0)));
+  rcutils_string_map_t string_map;
+  if (!init_string_map(st, &string_map)) {
+    return;
+  }
+  if (fill_string_map(st, &string_map, keys)) {
+    reset_heap_counters();
+    for (auto _ : st) {
+      const char * key = rcutils_string_map_get_next_key(&string_map, NULL);
+      while (NULL != key) {
+        key = rcutils_string_map_get_next_key(&string_map, key);
+      }
+    }
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations()) * st.range(0));
+  if (RCUTILS_RET_OK != rcutils_string_map_fini(&string_map)) {
+    st.SkipWithError("rcutils_string_map_fini failed");
+  }
+}
+BENCHMARK_REGISTER_F(PerformanceTest, string_map_iterate)->ArgsProduct({{16, 256, 4096}, {0}});
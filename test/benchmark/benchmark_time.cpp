@@ -0,0 +1,132 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include "performance_test_fixture/performance_test_fixture.hpp"
+#include "rcutils/time.h"
+
+using performance_test_fixture::PerformanceTest;
+
+BENCHMARK_F(PerformanceTest, system_time_now)(benchmark::State & st)
+{
+  reset_heap_counters();
+  for (auto _ : st) {
+    rcutils_time_point_value_t now;
+    if (RCUTILS_RET_OK != rcutils_system_time_now(&now)) {
+      st.SkipWithError("rcutils_system_time_now failed");
+      break;
+    }
+    benchmark::DoNotOptimize(now);
+  }
+}
+
+BENCHMARK_F(PerformanceTest, steady_time_now)(benchmark::State & st)
+{
+  reset_heap_counters();
+  for (auto _ : st) {
+    rcutils_time_point_value_t now;
+    if (RCUTILS_RET_OK != rcutils_steady_time_now(&now)) {
+      st.SkipWithError("rcutils_steady_time_now failed");
+      break;
+    }
+    benchmark::DoNotOptimize(now);
+  }
+}
+
+BENCHMARK_F(PerformanceTest, coarse_system_time_now)(benchmark::State & st)
+{
+  reset_heap_counters();
+  for (auto _ : st) {
+    rcutils_time_point_value_t now;
+    if (RCUTILS_RET_OK != rcutils_coarse_system_time_now(&now)) {
+      st.SkipWithError("rcutils_coarse_system_time_now failed");
+      break;
+    }
+    benchmark::DoNotOptimize(now);
+  }
+}
+
+BENCHMARK_F(PerformanceTest, coarse_steady_time_now)(benchmark::State & st)
+{
+  reset_heap_counters();
+  for (auto _ : st) {
+    rcutils_time_point_value_t now;
+    if (RCUTILS_RET_OK != rcutils_coarse_steady_time_now(&now)) {
+      st.SkipWithError("rcutils_coarse_steady_time_now failed");
+      break;
+    }
+    benchmark::DoNotOptimize(now);
+  }
+}
+
+// Falls back to rcutils_steady_time_now() if the time stamp counter isn't reliable.
+BENCHMARK_F(PerformanceTest, tsc_steady_time_now)(benchmark::State & st)
+{
+  if (RCUTILS_RET_OK != rcutils_tsc_steady_time_init()) {
+    st.SkipWithError("rcutils_tsc_steady_time_init failed");
+    return;
+  }
+  st.SetLabel(rcutils_tsc_steady_time_is_enabled() ? "tsc" : "fallback");
+  reset_heap_counters();
+  for (auto _ : st) {
+    rcutils_time_point_value_t now;
+    if (RCUTILS_RET_OK != rcutils_tsc_steady_time_now(&now)) {
+      st.SkipWithError("rcutils_tsc_steady_time_now failed");
+      break;
+    }
+    benchmark::DoNotOptimize(now);
+  }
+}
+
+BENCHMARK_F(PerformanceTest, time_point_value_as_seconds_string)(benchmark::State & st)
+{
+  rcutils_time_point_value_t time_point = 1234567890123456789;
+  char str[RCUTILS_TIME_POINT_FORMAT_STRING_SIZE];
+  reset_heap_counters();
+  for (auto _ : st) {
+    if (
+      RCUTILS_RET_OK != rcutils_time_point_value_as_seconds_string(
+        &time_point, str, sizeof(str)))
+    {
+      st.SkipWithError("rcutils_time_point_value_as_seconds_string failed");
+      break;
+    }
+    benchmark::DoNotOptimize(str);
+  }
+}
+
+BENCHMARK_F(PerformanceTest, time_point_value_format_nanoseconds)(benchmark::State & st)
+{
+  rcutils_time_point_value_t time_point = 1234567890123456789;
+  char str[RCUTILS_TIME_POINT_FORMAT_STRING_SIZE];
+  reset_heap_counters();
+  for (auto _ : st) {
+    benchmark::DoNotOptimize(rcutils_time_point_value_format_nanoseconds(time_point, str));
+    benchmark::ClobberMemory();
+  }
+}
+
+BENCHMARK_F(PerformanceTest, time_point_value_format_seconds)(benchmark::State & st)
+{
+  rcutils_time_point_value_t time_point = 1234567890123456789;
+  char str[RCUTILS_TIME_POINT_FORMAT_STRING_SIZE];
+  reset_heap_counters();
+  for (auto _ : st) {
+    benchmark::DoNotOptimize(
+      rcutils_time_point_value_format_seconds(
+        time_point, RCUTILS_TIME_POINT_PRECISION_MICROSECONDS, str));
+    benchmark::ClobberMemory();
+  }
+}
@@ -14,8 +14,14 @@
 
 #include <gtest/gtest.h>
 
+#include <string>
+#include <thread>
+#include <vector>
+
 #include "./allocator_testing_utils.h"
 #include "rcutils/allocator.h"
+#include "rcutils/error_handling.h"
+#include "rcutils/strdup.h"
 #include "rcutils/testing/fault_injection.h"
 
 #include "osrf_testing_tools_cpp/memory_tools/memory_tools.hpp"
@@ -138,3 +144,107 @@ TEST(test_allocator, default_allocator_maybe_fail) {
   EXPECT_EQ(nullptr, allocator.zero_allocate(1u, 1u, allocator.state));
   EXPECT_EQ(RCUTILS_FAULT_INJECTION_NEVER_FAIL, rcutils_fault_injection_get_count());
 }
+
+TEST(test_allocator, default_allocator_maybe_fail_thread) {
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+
+  // The count of a thread only fails that thread
+  rcutils_fault_injection_set_thread_count(1);
+  std::thread other_thread(
+    [&allocator]() {
+      void * pointer = allocator.allocate(1u, allocator.state);
+      EXPECT_NE(nullptr, pointer);
+      allocator.deallocate(pointer, allocator.state);
+    });
+  other_thread.join();
+  EXPECT_EQ(1, rcutils_fault_injection_get_thread_count());
+  void * pointer = allocator.allocate(1u, allocator.state);
+  EXPECT_NE(nullptr, pointer);
+  allocator.deallocate(pointer, allocator.state);
+  EXPECT_EQ(nullptr, allocator.allocate(1u, allocator.state));
+  EXPECT_EQ(RCUTILS_FAULT_INJECTION_NEVER_FAIL, rcutils_fault_injection_get_thread_count());
+  EXPECT_EQ(RCUTILS_FAULT_INJECTION_NEVER_FAIL, rcutils_fault_injection_get_count());
+}
+
+TEST(test_allocator, default_allocator_maybe_fail_site) {
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+
+  // Only the sites of the given file are counted
+  rcutils_fault_injection_set_site("strdup.c");
+  rcutils_fault_injection_set_count(RCUTILS_FAULT_INJECTION_FAIL_NOW);
+  void * pointer = allocator.allocate(1u, allocator.state);
+  EXPECT_NE(nullptr, pointer);
+  allocator.deallocate(pointer, allocator.state);
+  EXPECT_EQ(RCUTILS_FAULT_INJECTION_FAIL_NOW, rcutils_fault_injection_get_count());
+  EXPECT_EQ(nullptr, rcutils_strdup("string", allocator));
+  EXPECT_EQ(RCUTILS_FAULT_INJECTION_NEVER_FAIL, rcutils_fault_injection_get_count());
+
+  rcutils_fault_injection_set_site(nullptr);
+  rcutils_fault_injection_set_count(RCUTILS_FAULT_INJECTION_FAIL_NOW);
+  EXPECT_EQ(nullptr, allocator.allocate(1u, allocator.state));
+  EXPECT_EQ(RCUTILS_FAULT_INJECTION_NEVER_FAIL, rcutils_fault_injection_get_count());
+}
+
+TEST(test_allocator, default_allocator_maybe_fail_reporter) {
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  std::vector<std::string> reports;
+  rcutils_fault_injection_set_reporter(
+    [](const char * site, const char * action, void * context) {
+      static_cast<std::vector<std::string> *>(context)->push_back(
+        std::string(site) + " " + action);
+    }, &reports);
+  uint_least64_t injected_count = rcutils_fault_injection_get_injected_count();
+  rcutils_fault_injection_set_count(RCUTILS_FAULT_INJECTION_FAIL_NOW);
+  EXPECT_EQ(nullptr, allocator.allocate(1u, allocator.state));
+  ASSERT_EQ(1u, reports.size());
+  EXPECT_NE(std::string::npos, reports[0].find("allocator.c:"));
+  EXPECT_NE(std::string::npos, reports[0].find(" returning "));
+  EXPECT_EQ(injected_count + 1u, rcutils_fault_injection_get_injected_count());
+
+  // Silent, but still counted
+  rcutils_fault_injection_set_reporter(nullptr, nullptr);
+  rcutils_fault_injection_set_count(RCUTILS_FAULT_INJECTION_FAIL_NOW);
+  EXPECT_EQ(nullptr, allocator.allocate(1u, allocator.state));
+  EXPECT_EQ(1u, reports.size());
+  EXPECT_EQ(injected_count + 2u, rcutils_fault_injection_get_injected_count());
+  rcutils_fault_injection_set_reporter(rcutils_fault_injection_print_reporter, nullptr);
+}
+
+TEST(test_allocator, aligned_allocate) {
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  EXPECT_EQ(nullptr, rcutils_allocator_aligned_allocate(nullptr, 64u, 1u));
+  rcutils_reset_error();
+  EXPECT_EQ(nullptr, rcutils_allocator_aligned_allocate(&allocator, 0u, 1u));
+  rcutils_reset_error();
+  EXPECT_EQ(nullptr, rcutils_allocator_aligned_allocate(&allocator, 48u, 1u));
+  rcutils_reset_error();
+  rcutils_allocator_aligned_deallocate(&allocator, nullptr);
+
+  // with the default aligned functions, then with the fallback on allocate
+  rcutils_allocator_t allocators[2] = {allocator, allocator};
+  allocators[1].aligned_allocate = nullptr;
+  allocators[1].aligned_deallocate = nullptr;
+  for (const rcutils_allocator_t & a : allocators) {
+    for (size_t alignment = 1u; alignment <= 4096u; alignment *= 2u) {
+      for (size_t size : {0u, 1u, 100u, 4096u}) {
+        void * pointer = rcutils_allocator_aligned_allocate(&a, alignment, size);
+        ASSERT_NE(nullptr, pointer);
+        EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(pointer) % alignment);
+        memset(pointer, 0xAA, size);
+        rcutils_allocator_aligned_deallocate(&a, pointer);
+      }
+    }
+  }
+
+  auto failing_allocator = get_failing_allocator();
+  EXPECT_EQ(nullptr, rcutils_allocator_aligned_allocate(&failing_allocator, 64u, 1u));
+  set_failing_allocator_is_failing(failing_allocator, false);
+  void * pointer = rcutils_allocator_aligned_allocate(&failing_allocator, 64u, 1u);
+  ASSERT_NE(nullptr, pointer);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(pointer) % 64u);
+  rcutils_allocator_aligned_deallocate(&failing_allocator, pointer);
+
+  rcutils_fault_injection_set_count(RCUTILS_FAULT_INJECTION_FAIL_NOW);
+  EXPECT_EQ(nullptr, rcutils_allocator_aligned_allocate(&allocator, 64u, 1u));
+  EXPECT_EQ(RCUTILS_FAULT_INJECTION_NEVER_FAIL, rcutils_fault_injection_get_count());
+}
@@ -0,0 +1,221 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+
+#include "./allocator_testing_utils.h"
+#include "rcutils/allocator.h"
+#include "rcutils/arena_allocator.h"
+#include "rcutils/error_handling.h"
+#include "rcutils/split.h"
+#include "rcutils/types/string_array.h"
+
+class ArenaAllocatorTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    rcutils_allocator_t default_allocator = rcutils_get_default_allocator();
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_arena_allocator_init(&arena, 256, &default_allocator));
+    allocator = rcutils_arena_allocator_get_allocator(&arena);
+    ASSERT_TRUE(rcutils_allocator_is_valid(&allocator));
+  }
+
+  void TearDown() override
+  {
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_arena_allocator_fini(&arena));
+  }
+
+  rcutils_arena_allocator_t arena = rcutils_get_zero_initialized_arena_allocator();
+  rcutils_allocator_t allocator = rcutils_get_zero_initialized_allocator();
+};
+
+static bool is_aligned(const void * pointer)
+{
+  return 0u == reinterpret_cast<uintptr_t>(pointer) % RCUTILS_ARENA_ALLOCATOR_ALIGNMENT;
+}
+
+TEST(test_arena_allocator, init_fini) {
+  rcutils_allocator_t default_allocator = rcutils_get_default_allocator();
+  rcutils_allocator_t failing_allocator = get_failing_allocator();
+  rcutils_allocator_t invalid_allocator = rcutils_get_zero_initialized_allocator();
+  rcutils_arena_allocator_t arena = rcutils_get_zero_initialized_arena_allocator();
+
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_arena_allocator_init(nullptr, 0, &default_allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_arena_allocator_init(&arena, 0, nullptr));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_arena_allocator_init(&arena, 0, &invalid_allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_BAD_ALLOC, rcutils_arena_allocator_init(&arena, 0, &failing_allocator));
+  rcutils_reset_error();
+
+  // Not initialized
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_arena_allocator_reset(nullptr));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_NOT_INITIALIZED, rcutils_arena_allocator_reset(&arena));
+  rcutils_reset_error();
+  rcutils_allocator_t allocator = rcutils_arena_allocator_get_allocator(&arena);
+  EXPECT_FALSE(rcutils_allocator_is_valid(&allocator));
+  allocator = rcutils_arena_allocator_get_allocator(nullptr);
+  EXPECT_FALSE(rcutils_allocator_is_valid(&allocator));
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_arena_allocator_fini(nullptr));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_arena_allocator_fini(&arena));
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_arena_allocator_init(&arena, 0, &default_allocator));
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_arena_allocator_init(&arena, 0, &default_allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_arena_allocator_reset(&arena));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_arena_allocator_fini(&arena));
+  EXPECT_EQ(nullptr, arena.impl);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_arena_allocator_fini(&arena));
+
+  // Blocks failing to be allocated
+  set_failing_allocator_is_failing(failing_allocator, false);
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_arena_allocator_init(&arena, 0, &failing_allocator));
+  set_failing_allocator_is_failing(failing_allocator, true);
+  allocator = rcutils_arena_allocator_get_allocator(&arena);
+  EXPECT_EQ(nullptr, allocator.allocate(16, allocator.state));
+  EXPECT_EQ(nullptr, allocator.zero_allocate(4, 4, allocator.state));
+  set_failing_allocator_is_failing(failing_allocator, false);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_arena_allocator_fini(&arena));
+}
+
+TEST_F(ArenaAllocatorTest, allocate) {
+  void * previous = nullptr;
+  for (size_t size = 0u; size < 100u; ++size) {
+    auto pointer = static_cast<uint8_t *>(allocator.allocate(size, allocator.state));
+    ASSERT_NE(nullptr, pointer);
+    EXPECT_TRUE(is_aligned(pointer));
+    EXPECT_NE(previous, pointer);
+    memset(pointer, static_cast<int>(size), size);
+    previous = pointer;
+  }
+
+  // Larger than the blocks
+  auto large = static_cast<uint8_t *>(allocator.allocate(10000u, allocator.state));
+  ASSERT_NE(nullptr, large);
+  EXPECT_TRUE(is_aligned(large));
+  memset(large, 0xff, 10000u);
+
+  auto zeroed = static_cast<uint8_t *>(allocator.zero_allocate(25, 4, allocator.state));
+  ASSERT_NE(nullptr, zeroed);
+  EXPECT_TRUE(is_aligned(zeroed));
+  for (size_t i = 0u; i < 100u; ++i) {
+    EXPECT_EQ(0u, zeroed[i]);
+  }
+  EXPECT_EQ(nullptr, allocator.zero_allocate(SIZE_MAX, 2, allocator.state));
+  EXPECT_EQ(nullptr, allocator.allocate(SIZE_MAX, allocator.state));
+
+  // Deallocating does nothing, but doesn't break the allocations
+  allocator.deallocate(large, allocator.state);
+  allocator.deallocate(nullptr, allocator.state);
+}
+
+TEST_F(ArenaAllocatorTest, deallocate_last) {
+  void * first = allocator.allocate(32, allocator.state);
+  ASSERT_NE(nullptr, first);
+  void * second = allocator.allocate(32, allocator.state);
+  ASSERT_NE(nullptr, second);
+
+  // The last allocation is given back
+  allocator.deallocate(second, allocator.state);
+  EXPECT_EQ(second, allocator.allocate(32, allocator.state));
+
+  // But not the others
+  allocator.deallocate(first, allocator.state);
+  void * third = allocator.allocate(32, allocator.state);
+  EXPECT_NE(first, third);
+  EXPECT_NE(second, third);
+}
+
+TEST_F(ArenaAllocatorTest, reallocate) {
+  auto str = static_cast<char *>(allocator.reallocate(nullptr, 4, allocator.state));
+  ASSERT_NE(nullptr, str);
+  memcpy(str, "abc", 4);
+
+  // The last allocation grows in place
+  auto grown = static_cast<char *>(allocator.reallocate(str, 64, allocator.state));
+  EXPECT_EQ(str, grown);
+  EXPECT_STREQ("abc", grown);
+  auto shrunk = static_cast<char *>(allocator.reallocate(grown, 8, allocator.state));
+  EXPECT_EQ(str, shrunk);
+  EXPECT_STREQ("abc", shrunk);
+
+  // The others are copied
+  auto other = static_cast<char *>(allocator.allocate(8, allocator.state));
+  ASSERT_NE(nullptr, other);
+  memcpy(other, "def", 4);
+  auto moved = static_cast<char *>(allocator.reallocate(str, 16, allocator.state));
+  ASSERT_NE(nullptr, moved);
+  EXPECT_NE(str, moved);
+  EXPECT_STREQ("abc", moved);
+  EXPECT_STREQ("def", other);
+
+  // Even when growing past the end of the block
+  auto large = static_cast<char *>(allocator.reallocate(moved, 1000, allocator.state));
+  ASSERT_NE(nullptr, large);
+  EXPECT_TRUE(is_aligned(large));
+  EXPECT_STREQ("abc", large);
+  memset(large + 3, 'x', 996);
+  large[999] = '\0';
+  EXPECT_EQ(999u, strlen(large));
+
+  // Memory which isn't from the arena
+  int value = 0;
+  EXPECT_EQ(nullptr, allocator.reallocate(&value, 16, allocator.state));
+}
+
+TEST_F(ArenaAllocatorTest, reset) {
+  void * first = allocator.allocate(64, allocator.state);
+  ASSERT_NE(nullptr, first);
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_arena_allocator_reset(&arena));
+  // The block is reused
+  EXPECT_EQ(first, allocator.allocate(64, allocator.state));
+
+  // Only the largest block is kept
+  for (size_t i = 0u; i < 100u; ++i) {
+    ASSERT_NE(nullptr, allocator.allocate(100, allocator.state));
+  }
+  void * last = allocator.allocate(100, allocator.state);
+  ASSERT_NE(nullptr, last);
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_arena_allocator_reset(&arena));
+  auto pointer = static_cast<uint8_t *>(allocator.allocate(100, allocator.state));
+  ASSERT_NE(nullptr, pointer);
+  EXPECT_LE(pointer, static_cast<uint8_t *>(last));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_arena_allocator_reset(&arena));
+}
+
+TEST_F(ArenaAllocatorTest, split) {
+  for (int i = 0; i < 10; ++i) {
+    rcutils_string_array_t tokens = rcutils_get_zero_initialized_string_array();
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_split("/ns/sub_ns/node", '/', allocator, &tokens));
+    ASSERT_EQ(3u, tokens.size);
+    EXPECT_STREQ("ns", tokens.data[0]);
+    EXPECT_STREQ("sub_ns", tokens.data[1]);
+    EXPECT_STREQ("node", tokens.data[2]);
+    // Finalizing is allowed, but not needed
+    if (0 == i % 2) {
+      EXPECT_EQ(RCUTILS_RET_OK, rcutils_string_array_fini(&tokens));
+    }
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_arena_allocator_reset(&arena));
+  }
+}
@@ -438,3 +438,136 @@ TEST_F(ArrayListTest, list_add_bad_allocator_fails) {
   state.is_failing = false;
   EXPECT_EQ(RCUTILS_RET_OK, rcutils_array_list_fini(&list));
 }
+
+TEST_F(ArrayListPreInitTest, get_ptr_and_emplace) {
+  void * ptr = NULL;
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_array_list_get_ptr(&list, 0, &ptr));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_array_list_emplace(&list, NULL));
+  rcutils_reset_error();
+
+  for (uint32_t i = 0; i < 5; ++i) {
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_array_list_emplace(&list, &ptr));
+    *static_cast<uint32_t *>(ptr) = i * 3;
+  }
+  size_t size = 0;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_array_list_get_size(&list, &size));
+  EXPECT_EQ(5u, size);
+
+  // The pointers refer to the entries in place.
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_array_list_get_ptr(&list, 2, &ptr));
+  EXPECT_EQ(6u, *static_cast<uint32_t *>(ptr));
+  *static_cast<uint32_t *>(ptr) = 42;
+  uint32_t data = 0;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_array_list_get(&list, 2, &data));
+  EXPECT_EQ(42u, data);
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_array_list_get_ptr(&list, 5, &ptr));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_array_list_get_ptr(&list, 0, NULL));
+  rcutils_reset_error();
+}
+
+TEST_F(ArrayListPreInitTest, add_n_and_reserve) {
+  const uint32_t data[] = {1, 2, 3, 4, 5, 6, 7};
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_array_list_add_n(&list, NULL, 0));
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_array_list_add_n(&list, NULL, 1));
+  rcutils_reset_error();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_array_list_add_n(&list, data, 7));
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_array_list_add_n(&list, data, 2));
+  size_t size = 0;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_array_list_get_size(&list, &size));
+  ASSERT_EQ(9u, size);
+  const uint32_t expected[] = {1, 2, 3, 4, 5, 6, 7, 1, 2};
+  for (size_t i = 0; i < size; ++i) {
+    uint32_t value = 0;
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_array_list_get(&list, i, &value));
+    EXPECT_EQ(expected[i], value);
+  }
+
+  // Adding up to the reserved capacity doesn't move the entries.
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_array_list_reserve(&list, 100));
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_array_list_reserve(&list, 10));
+  void * first = NULL;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_array_list_get_ptr(&list, 0, &first));
+  for (size_t i = 0; i < 13; ++i) {
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_array_list_add_n(&list, data, 7));
+  }
+  void * ptr = NULL;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_array_list_get_ptr(&list, 0, &ptr));
+  EXPECT_EQ(first, ptr);
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_array_list_get_size(&list, &size));
+  EXPECT_EQ(100u, size);
+
+  EXPECT_EQ(RCUTILS_RET_BAD_ALLOC, rcutils_array_list_reserve(&list, SIZE_MAX));
+  rcutils_reset_error();
+}
+
+TEST_F(ArrayListPreInitTest, swap_remove) {
+  for (uint32_t i = 0; i < 4; ++i) {
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_array_list_add(&list, &i));
+  }
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_array_list_swap_remove(&list, 4));
+  rcutils_reset_error();
+
+  // The last entry takes the place of the removed one.
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_array_list_swap_remove(&list, 1));
+  uint32_t data = 0;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_array_list_get(&list, 1, &data));
+  EXPECT_EQ(3u, data);
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_array_list_swap_remove(&list, 2));
+  size_t size = 0;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_array_list_get_size(&list, &size));
+  EXPECT_EQ(2u, size);
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_array_list_get(&list, 0, &data));
+  EXPECT_EQ(0u, data);
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_array_list_get(&list, 1, &data));
+  EXPECT_EQ(3u, data);
+}
+
+TEST_F(ArrayListPreInitTest, memory_usage_and_shrink_to_fit) {
+  size_t initial_bytes = 0;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_array_list_get_memory_usage(&list, &initial_bytes));
+  EXPECT_GE(initial_bytes, 2 * sizeof(uint32_t));
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_array_list_get_memory_usage(&list, NULL));
+  rcutils_reset_error();
+
+  for (uint32_t i = 0; i < 100; ++i) {
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_array_list_add(&list, &i));
+  }
+  size_t grown_bytes = 0;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_array_list_get_memory_usage(&list, &grown_bytes));
+  // The capacity doubled from 2 to 128 entries.
+  EXPECT_EQ(initial_bytes + 126 * sizeof(uint32_t), grown_bytes);
+
+  for (size_t i = 0; i < 97; ++i) {
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_array_list_remove(&list, 0));
+  }
+  size_t bytes = 0;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_array_list_get_memory_usage(&list, &bytes));
+  EXPECT_EQ(grown_bytes, bytes);
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_array_list_shrink_to_fit(&list));
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_array_list_get_memory_usage(&list, &bytes));
+  EXPECT_EQ(initial_bytes + sizeof(uint32_t), bytes);
+  for (size_t i = 0; i < 3; ++i) {
+    uint32_t data = 0;
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_array_list_get(&list, i, &data));
+    EXPECT_EQ(97u + i, data);
+  }
+
+  // An empty list keeps room for an entry, and grows again.
+  for (size_t i = 0; i < 3; ++i) {
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_array_list_remove(&list, 0));
+  }
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_array_list_shrink_to_fit(&list));
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_array_list_get_memory_usage(&list, &bytes));
+  EXPECT_EQ(initial_bytes - sizeof(uint32_t), bytes);
+  for (uint32_t i = 0; i < 5; ++i) {
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_array_list_add(&list, &i));
+  }
+  size_t size = 0;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_array_list_get_size(&list, &size));
+  EXPECT_EQ(5u, size);
+
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_array_list_shrink_to_fit(NULL));
+  rcutils_reset_error();
+}
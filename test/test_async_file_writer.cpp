@@ -0,0 +1,207 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "rcutils/allocator.h"
+#include "rcutils/async_file_writer.h"
+#include "rcutils/error_handling.h"
+
+static std::string read_file(const std::string & path)
+{
+  std::ifstream file(path, std::ios::binary);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+class TestAsyncFileWriter : public ::testing::Test
+{
+public:
+  void SetUp()
+  {
+    path = std::string(BUILD_DIR) + "/test_async_file_writer.bin";
+    std::remove(path.c_str());
+    allocator = rcutils_get_default_allocator();
+    writer = rcutils_get_zero_initialized_async_file_writer();
+    options = rcutils_async_file_writer_get_default_options();
+    // Small buffers, so that the writes wrap around the buffers.
+    options.buffer_size = 64u;
+    options.buffer_count = 3u;
+  }
+
+  void TearDown()
+  {
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_async_file_writer_close(&writer));
+    std::remove(path.c_str());
+  }
+
+  // Append chunks of growing sizes, some larger than a buffer, and return what they make.
+  std::string append_chunks(size_t count)
+  {
+    std::string expected;
+    for (size_t i = 0u; i < count; ++i) {
+      std::string chunk(i % 150u, static_cast<char>('a' + i % 26u));
+      chunk += std::to_string(i) + "\n";
+      EXPECT_EQ(
+        RCUTILS_RET_OK, rcutils_async_file_writer_append(&writer, chunk.data(), chunk.size()));
+      expected += chunk;
+    }
+    return expected;
+  }
+
+  std::string path;
+  rcutils_allocator_t allocator;
+  rcutils_async_file_writer_t writer;
+  rcutils_async_file_writer_options_t options;
+};
+
+TEST_F(TestAsyncFileWriter, invalid_arguments) {
+  auto default_options = rcutils_async_file_writer_get_default_options();
+  EXPECT_EQ(RCUTILS_ASYNC_FILE_WRITER_DEFAULT_BUFFER_SIZE, default_options.buffer_size);
+  EXPECT_EQ(RCUTILS_ASYNC_FILE_WRITER_DEFAULT_BUFFER_COUNT, default_options.buffer_count);
+  EXPECT_EQ(RCUTILS_ASYNC_FILE_WRITER_BACKEND_AUTO, default_options.backend);
+
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_async_file_writer_open(nullptr, path.c_str(), &options, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_async_file_writer_open(&writer, nullptr, &options, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_async_file_writer_open(&writer, path.c_str(), &options, nullptr));
+  rcutils_reset_error();
+  options.buffer_count = 1u;
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_async_file_writer_open(&writer, path.c_str(), &options, &allocator));
+  rcutils_reset_error();
+  options.buffer_count = 3u;
+  options.buffer_size = 0u;
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_async_file_writer_open(&writer, path.c_str(), &options, &allocator));
+  rcutils_reset_error();
+  std::string bad_path = std::string(BUILD_DIR) + "/does_not_exist/test_async_file_writer.bin";
+  EXPECT_EQ(
+    RCUTILS_RET_ERROR,
+    rcutils_async_file_writer_open(&writer, bad_path.c_str(), nullptr, &allocator));
+  rcutils_reset_error();
+
+  EXPECT_EQ(RCUTILS_RET_NOT_INITIALIZED, rcutils_async_file_writer_append(&writer, "a", 1u));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_NOT_INITIALIZED, rcutils_async_file_writer_flush(&writer));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_NOT_INITIALIZED, rcutils_async_file_writer_sync(&writer));
+  rcutils_reset_error();
+
+  ASSERT_EQ(
+    RCUTILS_RET_OK, rcutils_async_file_writer_open(&writer, path.c_str(), nullptr, &allocator));
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_async_file_writer_open(&writer, path.c_str(), nullptr, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_async_file_writer_append(&writer, nullptr, 1u));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_async_file_writer_append(&writer, nullptr, 0u));
+}
+
+TEST_F(TestAsyncFileWriter, append_with_each_backend) {
+  for (auto backend : {RCUTILS_ASYNC_FILE_WRITER_BACKEND_AUTO,
+      RCUTILS_ASYNC_FILE_WRITER_BACKEND_THREAD})
+  {
+    std::remove(path.c_str());
+    options.backend = backend;
+    ASSERT_EQ(
+      RCUTILS_RET_OK,
+      rcutils_async_file_writer_open(&writer, path.c_str(), &options, &allocator));
+    rcutils_async_file_writer_backend_t actual_backend = RCUTILS_ASYNC_FILE_WRITER_BACKEND_AUTO;
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_async_file_writer_get_backend(&writer, &actual_backend));
+    EXPECT_NE(RCUTILS_ASYNC_FILE_WRITER_BACKEND_AUTO, actual_backend);
+    if (RCUTILS_ASYNC_FILE_WRITER_BACKEND_THREAD == backend) {
+      EXPECT_EQ(RCUTILS_ASYNC_FILE_WRITER_BACKEND_THREAD, actual_backend);
+    }
+
+    std::string expected = append_chunks(500u);
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_async_file_writer_flush(&writer));
+    uint64_t written_size = 0u;
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_async_file_writer_get_written_size(&writer, &written_size));
+    EXPECT_EQ(expected.size(), written_size);
+    EXPECT_EQ(expected, read_file(path));
+
+    expected += append_chunks(10u);
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_async_file_writer_close(&writer));
+    EXPECT_EQ(nullptr, writer.impl);
+    EXPECT_EQ(expected, read_file(path));
+  }
+}
+
+TEST_F(TestAsyncFileWriter, append_to_existing_file) {
+  {
+    std::ofstream file(path, std::ios::binary);
+    file << "existing\n";
+  }
+  ASSERT_EQ(
+    RCUTILS_RET_OK, rcutils_async_file_writer_open(&writer, path.c_str(), &options, &allocator));
+  uint64_t written_size = 0u;
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_async_file_writer_get_written_size(&writer, &written_size));
+  EXPECT_EQ(9u, written_size);
+
+  std::string expected = "existing\n" + append_chunks(100u);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_async_file_writer_sync(&writer));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_async_file_writer_get_written_size(&writer, &written_size));
+  EXPECT_EQ(expected.size(), written_size);
+  EXPECT_EQ(expected, read_file(path));
+}
+
+TEST_F(TestAsyncFileWriter, sync_with_each_backend) {
+  for (auto backend : {RCUTILS_ASYNC_FILE_WRITER_BACKEND_AUTO,
+      RCUTILS_ASYNC_FILE_WRITER_BACKEND_THREAD})
+  {
+    std::remove(path.c_str());
+    options.backend = backend;
+    ASSERT_EQ(
+      RCUTILS_RET_OK,
+      rcutils_async_file_writer_open(&writer, path.c_str(), &options, &allocator));
+    // Nothing to write.
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_async_file_writer_sync(&writer));
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_async_file_writer_append(&writer, "partial", 7u));
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_async_file_writer_sync(&writer));
+    EXPECT_EQ("partial", read_file(path));
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_async_file_writer_close(&writer));
+  }
+}
+
+TEST_F(TestAsyncFileWriter, io_uring) {
+  options.backend = RCUTILS_ASYNC_FILE_WRITER_BACKEND_IO_URING;
+  rcutils_ret_t ret = rcutils_async_file_writer_open(&writer, path.c_str(), &options, &allocator);
+  if (RCUTILS_RET_OK != ret) {
+    // io_uring isn't supported, or is disabled.
+    EXPECT_EQ(RCUTILS_RET_ERROR, ret);
+    rcutils_reset_error();
+    GTEST_SKIP();
+  }
+  std::string expected = append_chunks(300u);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_async_file_writer_sync(&writer));
+  EXPECT_EQ(expected, read_file(path));
+}
@@ -41,6 +41,56 @@
     } \
   } while (0)
 
+// Checks the operations which only apply to integers, with explicit memory orders.
+#define TEST_ATOMIC_INTEGER_TYPE(BASE_TYPE, ATOMIC_TYPE) \
+  do { \
+    ATOMIC_TYPE uut; \
+    atomic_init(&uut, (BASE_TYPE)12); \
+    BASE_TYPE value; \
+    rcutils_atomic_fetch_add_explicit(&uut, value, (BASE_TYPE)3, memory_order_relaxed); \
+    rcutils_atomic_fetch_sub(&uut, value, (BASE_TYPE)5); \
+    if ((BASE_TYPE)15 != value) { \
+      fprintf(stderr, "fetch_sub test failed " #ATOMIC_TYPE " base " #BASE_TYPE "\n"); \
+      return 1; \
+    } \
+    rcutils_atomic_fetch_and_explicit(&uut, value, (BASE_TYPE)6, memory_order_acq_rel); \
+    rcutils_atomic_fetch_or(&uut, value, (BASE_TYPE)9); \
+    rcutils_atomic_load_explicit(&uut, value, memory_order_acquire); \
+    if ((BASE_TYPE)11 != value) { \
+      fprintf(stderr, "fetch_and/or test failed " #ATOMIC_TYPE " base " #BASE_TYPE "\n"); \
+      return 1; \
+    } \
+    rcutils_atomic_fetch_sub_explicit(&uut, value, (BASE_TYPE)1, memory_order_release); \
+    rcutils_atomic_fetch_or_explicit(&uut, value, (BASE_TYPE)16, memory_order_seq_cst); \
+    if ((BASE_TYPE)10 != value) { \
+      fprintf(stderr, "explicit fetch test failed " #ATOMIC_TYPE " base " #BASE_TYPE "\n"); \
+      return 1; \
+    } \
+    BASE_TYPE expected = (BASE_TYPE)0; \
+    bool exchanged = true; \
+    rcutils_atomic_compare_exchange_strong_explicit( \
+      &uut, exchanged, &expected, (BASE_TYPE)1, memory_order_acq_rel, memory_order_acquire); \
+    if (exchanged || (BASE_TYPE)26 != expected) { \
+      fprintf(stderr, "failed exchange test failed " #ATOMIC_TYPE " base " #BASE_TYPE "\n"); \
+      return 1; \
+    } \
+    do { \
+      rcutils_atomic_compare_exchange_weak_explicit( \
+        &uut, exchanged, &expected, (BASE_TYPE)33, memory_order_release, memory_order_relaxed); \
+    } while (!exchanged); \
+    rcutils_atomic_exchange_explicit(&uut, value, (BASE_TYPE)7, memory_order_acq_rel); \
+    if ((BASE_TYPE)33 != value) { \
+      fprintf(stderr, "weak exchange test failed " #ATOMIC_TYPE " base " #BASE_TYPE "\n"); \
+      return 1; \
+    } \
+    rcutils_atomic_store_explicit(&uut, (BASE_TYPE)8, memory_order_release); \
+    rcutils_atomic_load(&uut, value); \
+    if ((BASE_TYPE)8 != value) { \
+      fprintf(stderr, "explicit store test failed " #ATOMIC_TYPE " base " #BASE_TYPE "\n"); \
+      return 1; \
+    } \
+  } while (0)
+
 int
 main()
 {
@@ -77,5 +127,49 @@ main()
 
   TEST_ATOMIC_TYPE(int *, _Atomic(int *));
   TEST_ATOMIC_TYPE(int **, _Atomic(int **));
+
+  TEST_ATOMIC_INTEGER_TYPE(unsigned char, atomic_uchar);
+  TEST_ATOMIC_INTEGER_TYPE(short, atomic_short);  // NOLINT(runtime/int)
+  TEST_ATOMIC_INTEGER_TYPE(int, atomic_int);
+  TEST_ATOMIC_INTEGER_TYPE(unsigned int, atomic_uint);
+  TEST_ATOMIC_INTEGER_TYPE(long long, atomic_llong);  // NOLINT(runtime/int)
+  TEST_ATOMIC_INTEGER_TYPE(uint_least64_t, atomic_uint_least64_t);
+  TEST_ATOMIC_INTEGER_TYPE(uintptr_t, atomic_uintptr_t);
+  TEST_ATOMIC_INTEGER_TYPE(size_t, atomic_size_t);
+
+  rcutils_atomic_thread_fence(memory_order_acquire);
+  rcutils_atomic_thread_fence(memory_order_release);
+  rcutils_atomic_signal_fence(memory_order_seq_cst);
+
+  atomic_uint_least64_t a_uint64_t;
+  atomic_init(&a_uint64_t, (uint64_t)6);
+  uint64_t expected_uint64_t = 6;
+  while (!rcutils_atomic_compare_exchange_weak_uint_least64_t(
+      &a_uint64_t, &expected_uint64_t, 12))
+  {
+  }
+  if (12 != rcutils_atomic_fetch_sub_uint64_t(&a_uint64_t, 2) ||
+    10 != rcutils_atomic_fetch_and_uint64_t(&a_uint64_t, 3) ||
+    2 != rcutils_atomic_fetch_or_uint64_t(&a_uint64_t, 4) ||
+    6 != rcutils_atomic_load_uint64_t(&a_uint64_t))
+  {
+    fprintf(stderr, "uint64_t helpers test failed\n");
+    return 1;
+  }
+  atomic_uintptr_t a_uintptr_t;
+  atomic_init(&a_uintptr_t, (uintptr_t)1);
+  uintptr_t expected_uintptr_t = 2;
+  if (rcutils_atomic_compare_exchange_strong_uintptr_t(&a_uintptr_t, &expected_uintptr_t, 3) ||
+    1 != expected_uintptr_t)
+  {
+    fprintf(stderr, "uintptr_t helpers test failed\n");
+    return 1;
+  }
+  while (!rcutils_atomic_compare_exchange_weak_uintptr_t(&a_uintptr_t, &expected_uintptr_t, 3)) {
+  }
+  if (3 != rcutils_atomic_load_uintptr_t(&a_uintptr_t)) {
+    fprintf(stderr, "uintptr_t helpers test failed\n");
+    return 1;
+  }
   return 0;
 }
@@ -0,0 +1,156 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "./allocator_testing_utils.h"
+#include "rcutils/allocator.h"
+#include "rcutils/error_handling.h"
+
+#include "rcutils/types/bitset.h"
+
+TEST(test_bitset, init_fini) {
+  auto bitset = rcutils_get_zero_initialized_bitset();
+  auto allocator = rcutils_get_default_allocator();
+
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_bitset_init(nullptr, 10, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_bitset_init(&bitset, 10, nullptr));
+  rcutils_reset_error();
+  rcutils_allocator_t failing_allocator = get_failing_allocator();
+  EXPECT_EQ(RCUTILS_RET_BAD_ALLOC, rcutils_bitset_init(&bitset, 10, &failing_allocator));
+  rcutils_reset_error();
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_bitset_init(&bitset, 0, &allocator));
+  EXPECT_EQ(nullptr, bitset.words);
+  size_t index = 0;
+  EXPECT_EQ(RCUTILS_RET_NOT_FOUND, rcutils_bitset_find_next_clear(&bitset, 0, &index));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_bitset_assign_all(&bitset, true));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_bitset_fini(&bitset));
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_bitset_init(&bitset, 130, &allocator));
+  EXPECT_EQ(130u, bitset.size);
+  EXPECT_EQ(3u, bitset.word_capacity);
+  size_t count = 1;
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_bitset_count(&bitset, &count));
+  EXPECT_EQ(0u, count);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_bitset_fini(&bitset));
+  EXPECT_EQ(nullptr, bitset.words);
+  EXPECT_EQ(0u, bitset.size);
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_bitset_fini(nullptr));
+  rcutils_reset_error();
+}
+
+TEST(test_bitset, set_clear_test) {
+  auto bitset = rcutils_get_zero_initialized_bitset();
+  auto allocator = rcutils_get_default_allocator();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_bitset_init(&bitset, 130, &allocator));
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_bitset_set(&bitset, 0));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_bitset_set(&bitset, 63));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_bitset_set(&bitset, 64));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_bitset_set(&bitset, 129));
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_bitset_set(&bitset, 130));
+  rcutils_reset_error();
+  EXPECT_TRUE(rcutils_bitset_test(&bitset, 0));
+  EXPECT_FALSE(rcutils_bitset_test(&bitset, 1));
+  EXPECT_TRUE(rcutils_bitset_test(&bitset, 63));
+  EXPECT_TRUE(rcutils_bitset_test(&bitset, 64));
+  EXPECT_TRUE(rcutils_bitset_test(&bitset, 129));
+  EXPECT_FALSE(rcutils_bitset_test(&bitset, 130));
+  EXPECT_FALSE(rcutils_bitset_test(nullptr, 0));
+
+  size_t count = 0;
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_bitset_count(&bitset, &count));
+  EXPECT_EQ(4u, count);
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_bitset_clear(&bitset, 63));
+  EXPECT_FALSE(rcutils_bitset_test(&bitset, 63));
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_bitset_clear(&bitset, 200));
+  rcutils_reset_error();
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_bitset_assign_all(&bitset, true));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_bitset_count(&bitset, &count));
+  EXPECT_EQ(130u, count);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_bitset_assign_all(&bitset, false));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_bitset_count(&bitset, &count));
+  EXPECT_EQ(0u, count);
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_bitset_fini(&bitset));
+}
+
+TEST(test_bitset, find_next) {
+  auto bitset = rcutils_get_zero_initialized_bitset();
+  auto allocator = rcutils_get_default_allocator();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_bitset_init(&bitset, 300, &allocator));
+
+  const std::vector<size_t> expected = {3, 64, 65, 127, 200, 299};
+  for (size_t index : expected) {
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_bitset_set(&bitset, index));
+  }
+  std::vector<size_t> found;
+  size_t index = 0;
+  while (RCUTILS_RET_OK == rcutils_bitset_find_next_set(&bitset, index, &index)) {
+    found.push_back(index);
+    ++index;
+  }
+  EXPECT_EQ(expected, found);
+  EXPECT_EQ(RCUTILS_RET_NOT_FOUND, rcutils_bitset_find_next_set(&bitset, 1000, &index));
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_bitset_find_next_set(&bitset, 0, nullptr));
+  rcutils_reset_error();
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_bitset_assign_all(&bitset, true));
+  EXPECT_EQ(RCUTILS_RET_NOT_FOUND, rcutils_bitset_find_next_clear(&bitset, 0, &index));
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_bitset_clear(&bitset, 150));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_bitset_find_next_clear(&bitset, 10, &index));
+  EXPECT_EQ(150u, index);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_bitset_find_next_clear(&bitset, 150, &index));
+  EXPECT_EQ(150u, index);
+  // The bits of the last word beyond the size aren't found
+  EXPECT_EQ(RCUTILS_RET_NOT_FOUND, rcutils_bitset_find_next_clear(&bitset, 151, &index));
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_bitset_fini(&bitset));
+}
+
+TEST(test_bitset, resize) {
+  auto bitset = rcutils_get_zero_initialized_bitset();
+  auto allocator = rcutils_get_default_allocator();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_bitset_init(&bitset, 10, &allocator));
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_bitset_assign_all(&bitset, true));
+
+  // Shrinking clears the bits beyond the new size
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_bitset_resize(&bitset, 5));
+  size_t count = 0;
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_bitset_count(&bitset, &count));
+  EXPECT_EQ(5u, count);
+
+  // Growing adds clear bits, including in reused words
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_bitset_resize(&bitset, 1000));
+  EXPECT_EQ(1000u, bitset.size);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_bitset_count(&bitset, &count));
+  EXPECT_EQ(5u, count);
+  EXPECT_FALSE(rcutils_bitset_test(&bitset, 5));
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_bitset_set(&bitset, 999));
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_bitset_resize(&bitset, 64));
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_bitset_resize(&bitset, 1000));
+  EXPECT_FALSE(rcutils_bitset_test(&bitset, 999));
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_bitset_resize(&bitset, 0));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_bitset_count(&bitset, &count));
+  EXPECT_EQ(0u, count);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_bitset_fini(&bitset));
+}
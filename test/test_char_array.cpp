@@ -15,6 +15,10 @@
 #include <gtest/gtest.h>
 #include <string.h>
 
+#include <cstdio>
+#include <limits>
+#include <string>
+
 #include "./allocator_testing_utils.h"
 #include "rcutils/allocator.h"
 #include "rcutils/error_handling.h"
@@ -51,6 +55,30 @@ static rcutils_ret_t example_logger(
   return status;
 }
 
+static rcutils_ret_t example_appending_logger(
+  rcutils_char_array_t * char_array,
+  const char * format, ...)
+{
+  rcutils_ret_t status;
+  va_list args;
+  va_start(args, format);
+  status = rcutils_char_array_vsprintf_append(char_array, format, args);
+  va_end(args);
+  return status;
+}
+
+static rcutils_ret_t example_fast_appending_logger(
+  rcutils_char_array_t * char_array,
+  const char * format, ...)
+{
+  rcutils_ret_t status;
+  va_list args;
+  va_start(args, format);
+  status = rcutils_char_array_fast_vsprintf_append(char_array, format, args);
+  va_end(args);
+  return status;
+}
+
 TEST_F(ArrayCharTest, default_initialization) {
   EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_init(&char_array, 0, &allocator));
   EXPECT_EQ(0lu, char_array.buffer_capacity);
@@ -169,3 +197,229 @@ TEST_F(ArrayCharTest, strcat) {
   char_array.allocator = allocator;
   EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_fini(&char_array));
 }
+
+TEST_F(ArrayCharTest, geometric_growth) {
+  rcutils_ret_t ret = rcutils_char_array_init(&char_array, 8, &allocator);
+  ASSERT_EQ(RCUTILS_RET_OK, ret);
+  EXPECT_EQ(0lu, char_array.max_capacity);
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_char_array_strcpy(&char_array, ""));
+
+  // The capacity doubles, so appending a character at a time reallocates rarely.
+  size_t reallocations = 0;
+  size_t capacity = char_array.buffer_capacity;
+  for (size_t i = 0; i < 1000; ++i) {
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_char_array_strcat(&char_array, "x"));
+    if (char_array.buffer_capacity != capacity) {
+      EXPECT_EQ(2 * capacity, char_array.buffer_capacity);
+      capacity = char_array.buffer_capacity;
+      ++reallocations;
+    }
+  }
+  EXPECT_EQ(1001lu, char_array.buffer_length);
+  EXPECT_EQ(7u, reallocations);
+  EXPECT_EQ(1024lu, char_array.buffer_capacity);
+
+  // Expanding to more than double the capacity goes to the requested size.
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_expand_as_needed(&char_array, 5000));
+  EXPECT_EQ(5000lu, char_array.buffer_capacity);
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_fini(&char_array));
+}
+
+TEST_F(ArrayCharTest, max_capacity_and_reserve) {
+  rcutils_ret_t ret = rcutils_char_array_init(&char_array, 8, &allocator);
+  ASSERT_EQ(RCUTILS_RET_OK, ret);
+  char_array.max_capacity = 12;
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_char_array_strcpy(&char_array, "1234567"));
+  // The growth stops at the max capacity.
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_char_array_strcat(&char_array, "89"));
+  EXPECT_EQ(12lu, char_array.buffer_capacity);
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_char_array_strcat(&char_array, "ab"));
+  EXPECT_STREQ("123456789ab", char_array.buffer);
+  EXPECT_EQ(RCUTILS_RET_NOT_ENOUGH_SPACE, rcutils_char_array_strcat(&char_array, "c"));
+  rcutils_reset_error();
+  EXPECT_STREQ("123456789ab", char_array.buffer);
+  EXPECT_EQ(RCUTILS_RET_NOT_ENOUGH_SPACE, rcutils_char_array_reserve(&char_array, 13));
+  rcutils_reset_error();
+
+  char_array.max_capacity = 0;
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_reserve(&char_array, 4));
+  EXPECT_EQ(12lu, char_array.buffer_capacity);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_reserve(&char_array, 100));
+  EXPECT_EQ(100lu, char_array.buffer_capacity);
+  EXPECT_STREQ("123456789ab", char_array.buffer);
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_fini(&char_array));
+}
+
+TEST_F(ArrayCharTest, append) {
+  rcutils_ret_t ret = rcutils_char_array_init(&char_array, 0, &allocator);
+  ASSERT_EQ(RCUTILS_RET_OK, ret);
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_append_n(&char_array, NULL, 0));
+  EXPECT_STREQ("", char_array.buffer);
+  EXPECT_EQ(1lu, char_array.buffer_length);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_append_n(&char_array, "line=ignored", 5));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_append_u64(&char_array, 0u));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_append_char(&char_array, ' '));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_append_u64(&char_array, UINT64_MAX));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_append_char(&char_array, ' '));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_append_i64(&char_array, INT64_MIN));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_append_char(&char_array, ' '));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_append_i64(&char_array, 42));
+  EXPECT_STREQ("line=0 18446744073709551615 -9223372036854775808 42", char_array.buffer);
+  EXPECT_EQ(strlen(char_array.buffer) + 1, char_array.buffer_length);
+
+  char_array.allocator = get_failing_allocator();
+  EXPECT_EQ(
+    RCUTILS_RET_BAD_ALLOC,
+    rcutils_char_array_append_n(&char_array, "a long string to append", 23));
+  rcutils_reset_error();
+  EXPECT_STREQ("line=0 18446744073709551615 -9223372036854775808 42", char_array.buffer);
+  char_array.allocator = allocator;
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_fini(&char_array));
+}
+
+TEST_F(ArrayCharTest, append_double) {
+  rcutils_ret_t ret = rcutils_char_array_init(&char_array, 0, &allocator);
+  ASSERT_EQ(RCUTILS_RET_OK, ret);
+
+  struct
+  {
+    double value;
+    unsigned int precision;
+    const char * expected;
+  } cases[] = {
+    {0.0, 0, "0"},
+    {0.0, 3, "0.000"},
+    {-0.0, 1, "-0.0"},
+    {1.5, 0, "2"},
+    {-1.5, 0, "-2"},
+    {3.14159, 2, "3.14"},
+    {2.71828, 4, "2.7183"},
+    {-0.001, 2, "-0.00"},
+    {0.5, 9, "0.500000000"},
+    {123456789.125, 3, "123456789.125"},
+    {1e30, 1, "1000000000000000019884624838656.0"},
+    {-1e300, 0, nullptr},
+    {std::numeric_limits<double>::infinity(), 2, "inf"},
+    {-std::numeric_limits<double>::infinity(), 2, "-inf"},
+    {std::numeric_limits<double>::quiet_NaN(), 2, "nan"},
+  };
+  for (const auto & test_case : cases) {
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_char_array_strcpy(&char_array, "x="));
+    ASSERT_EQ(
+      RCUTILS_RET_OK,
+      rcutils_char_array_append_double(&char_array, test_case.value, test_case.precision));
+    std::string expected = "x=";
+    if (nullptr != test_case.expected) {
+      expected += test_case.expected;
+    } else {
+      char buffer[512];
+      snprintf(buffer, sizeof(buffer), "%.*f", test_case.precision, test_case.value);
+      expected += buffer;
+    }
+    EXPECT_EQ(expected, char_array.buffer);
+    EXPECT_EQ(expected.size() + 1, char_array.buffer_length);
+  }
+
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_char_array_append_double(&char_array, 1.0, 10));
+  rcutils_reset_error();
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_fini(&char_array));
+}
+
+TEST_F(ArrayCharTest, vsprintf_append) {
+  rcutils_ret_t ret = rcutils_char_array_init(&char_array, 0, &allocator);
+  ASSERT_EQ(RCUTILS_RET_OK, ret);
+
+  EXPECT_EQ(RCUTILS_RET_OK, example_appending_logger(&char_array, "[%s] ", "INFO"));
+  EXPECT_STREQ("[INFO] ", char_array.buffer);
+  EXPECT_EQ(8lu, char_array.buffer_length);
+  EXPECT_EQ(RCUTILS_RET_OK, example_appending_logger(&char_array, "%s", ""));
+  EXPECT_EQ(8lu, char_array.buffer_length);
+  // The buffer grows to fit the output after the prefix.
+  EXPECT_EQ(
+    RCUTILS_RET_OK,
+    example_appending_logger(&char_array, "message %d with a longer %s", 42, "text"));
+  EXPECT_STREQ("[INFO] message 42 with a longer text", char_array.buffer);
+  EXPECT_EQ(strlen(char_array.buffer) + 1, char_array.buffer_length);
+
+  char_array.allocator = get_failing_allocator();
+  EXPECT_EQ(
+    RCUTILS_RET_BAD_ALLOC,
+    example_appending_logger(&char_array, "%s", "a string which doesn't fit in the buffer"));
+  rcutils_reset_error();
+  EXPECT_STREQ("[INFO] message 42 with a longer text", char_array.buffer);
+  char_array.allocator = allocator;
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_fini(&char_array));
+}
+
+TEST_F(ArrayCharTest, fast_vsprintf_append) {
+  rcutils_ret_t ret = rcutils_char_array_init(&char_array, 0, &allocator);
+  ASSERT_EQ(RCUTILS_RET_OK, ret);
+
+  EXPECT_EQ(RCUTILS_RET_OK, example_fast_appending_logger(&char_array, "[%-5s] ", "INFO"));
+  EXPECT_STREQ("[INFO ] ", char_array.buffer);
+  EXPECT_EQ(9lu, char_array.buffer_length);
+  // The buffer grows to fit the output after the prefix.
+  EXPECT_EQ(
+    RCUTILS_RET_OK,
+    example_fast_appending_logger(
+      &char_array, "message %zu at %.2f with a longer %s", static_cast<size_t>(42), 1.5, "text"));
+  EXPECT_STREQ("[INFO ] message 42 at 1.50 with a longer text", char_array.buffer);
+  EXPECT_EQ(strlen(char_array.buffer) + 1, char_array.buffer_length);
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_fini(&char_array));
+}
+
+TEST_F(ArrayCharTest, with_stack) {
+  RCUTILS_CHAR_ARRAY_WITH_STACK(stack_array, 16, allocator);
+  const char * stack_buffer = stack_array.buffer;
+  EXPECT_FALSE(stack_array.owns_buffer);
+  EXPECT_STREQ("", stack_array.buffer);
+  EXPECT_EQ(1lu, stack_array.buffer_length);
+  EXPECT_EQ(16lu, stack_array.buffer_capacity);
+
+  // Short strings stay in the stack buffer
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_append_n(&stack_array, "short", 5));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_append_char(&stack_array, ' '));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_append_u64(&stack_array, 42u));
+  EXPECT_STREQ("short 42", stack_array.buffer);
+  EXPECT_EQ(stack_buffer, stack_array.buffer);
+  EXPECT_FALSE(stack_array.owns_buffer);
+
+  // Longer ones grow out to the heap, keeping the content
+  EXPECT_EQ(
+    RCUTILS_RET_OK, rcutils_char_array_append_n(&stack_array, " and a longer tail", 18));
+  EXPECT_STREQ("short 42 and a longer tail", stack_array.buffer);
+  EXPECT_EQ(27lu, stack_array.buffer_length);
+  EXPECT_NE(stack_buffer, stack_array.buffer);
+  EXPECT_TRUE(stack_array.owns_buffer);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_fini(&stack_array));
+
+  // Without allocating, if it fails the stack buffer is left as it was
+  RCUTILS_CHAR_ARRAY_WITH_STACK(failing_array, 8, get_failing_allocator());
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_strcpy(&failing_array, "1234567"));
+  EXPECT_EQ(RCUTILS_RET_BAD_ALLOC, rcutils_char_array_append_char(&failing_array, '8'));
+  rcutils_reset_error();
+  EXPECT_STREQ("1234567", failing_array.buffer);
+  EXPECT_FALSE(failing_array.owns_buffer);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_fini(&failing_array));
+}
+
+TEST_F(ArrayCharTest, resize_not_owned_keeps_content) {
+  // Bytes which fill the buffer, without a terminating null character
+  RCUTILS_CHAR_ARRAY_WITH_STACK(stack_array, 8, allocator);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_memcpy(&stack_array, "01234567", 8));
+  EXPECT_FALSE(stack_array.owns_buffer);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_resize(&stack_array, 16));
+  EXPECT_TRUE(stack_array.owns_buffer);
+  EXPECT_EQ(8lu, stack_array.buffer_length);
+  EXPECT_EQ(0, memcmp("01234567", stack_array.buffer, 8));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_fini(&stack_array));
+}
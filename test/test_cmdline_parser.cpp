@@ -14,7 +14,9 @@
 
 #include <gtest/gtest.h>
 
+#include "./allocator_testing_utils.h"
 #include "rcutils/cmdline_parser.h"
+#include "rcutils/error_handling.h"
 
 
 TEST(CmdLineParser, cli_option_exist) {
@@ -38,3 +40,90 @@ TEST(CmdLineParser, cli_get_option) {
   EXPECT_STREQ(rcutils_cli_get_option(arr, arr + args_count, "NotRelated"), NULL);
   EXPECT_STREQ(rcutils_cli_get_option(arr, arr + args_count, "option2"), NULL);
 }
+
+TEST(CmdLineParser, cli_index) {
+  char const * args[] = {
+    "--ros-args", "-r", "a:=b", "-r", "c:=d", "--param", "x:=1", "-r", "--ros-args"};
+  const size_t args_count = sizeof(args) / sizeof(char *);
+  char ** arr = const_cast<char **>(args);
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+
+  rcutils_cli_index_t index = rcutils_get_zero_initialized_cli_index();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_cli_index_init(nullptr, arr, arr + args_count, allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_cli_index_init(&index, arr + args_count, arr, allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_cli_index_init(
+      &index, arr, arr + args_count, rcutils_get_zero_initialized_allocator()));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_BAD_ALLOC,
+    rcutils_cli_index_init(&index, arr, arr + args_count, get_failing_allocator()));
+  rcutils_reset_error();
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_cli_index_init(&index, arr, arr + args_count, allocator));
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_cli_index_init(&index, arr, arr + args_count, allocator));
+  rcutils_reset_error();
+
+  EXPECT_TRUE(rcutils_cli_index_option_exist(&index, "--ros-args"));
+  EXPECT_TRUE(rcutils_cli_index_option_exist(&index, "x:=1"));
+  EXPECT_FALSE(rcutils_cli_index_option_exist(&index, "--ros"));
+  EXPECT_FALSE(rcutils_cli_index_option_exist(&index, "NotRelated"));
+  EXPECT_FALSE(rcutils_cli_index_option_exist(nullptr, "-r"));
+  EXPECT_FALSE(rcutils_cli_index_option_exist(&index, nullptr));
+
+  EXPECT_STREQ("a:=b", rcutils_cli_index_get_option(&index, "-r"));
+  EXPECT_STREQ("x:=1", rcutils_cli_index_get_option(&index, "--param"));
+  EXPECT_STREQ("-r", rcutils_cli_index_get_option(&index, "--ros-args"));
+  EXPECT_STREQ(NULL, rcutils_cli_index_get_option(&index, "--par"));
+  EXPECT_STREQ("-r", rcutils_cli_index_get_option(&index, "x:=1"));
+
+  size_t count = 42u;
+  const size_t * positions = rcutils_cli_index_get_positions(&index, "-r", &count);
+  ASSERT_NE(nullptr, positions);
+  ASSERT_EQ(3u, count);
+  EXPECT_EQ(1u, positions[0]);
+  EXPECT_EQ(3u, positions[1]);
+  EXPECT_EQ(7u, positions[2]);
+  positions = rcutils_cli_index_get_positions(&index, "--ros-args", &count);
+  ASSERT_NE(nullptr, positions);
+  ASSERT_EQ(2u, count);
+  EXPECT_EQ(0u, positions[0]);
+  EXPECT_EQ(8u, positions[1]);
+  EXPECT_EQ(nullptr, rcutils_cli_index_get_positions(&index, "NotRelated", &count));
+  EXPECT_EQ(0u, count);
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_cli_index_fini(&index));
+  EXPECT_EQ(nullptr, index.impl);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_cli_index_fini(&index));
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_cli_index_fini(nullptr));
+  rcutils_reset_error();
+}
+
+TEST(CmdLineParser, cli_index_last_and_empty) {
+  char const * args[] = {"option1", "sub1", nullptr, "option2"};
+  const size_t args_count = sizeof(args) / sizeof(char *);
+  char ** arr = const_cast<char **>(args);
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+
+  rcutils_cli_index_t index = rcutils_get_zero_initialized_cli_index();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_cli_index_init(&index, arr, arr + args_count, allocator));
+  EXPECT_STREQ("sub1", rcutils_cli_index_get_option(&index, "option1"));
+  // The last argument has no value
+  EXPECT_STREQ(NULL, rcutils_cli_index_get_option(&index, "option2"));
+  EXPECT_TRUE(rcutils_cli_index_option_exist(&index, "option2"));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_cli_index_fini(&index));
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_cli_index_init(&index, arr, arr, allocator));
+  EXPECT_FALSE(rcutils_cli_index_option_exist(&index, "option1"));
+  EXPECT_STREQ(NULL, rcutils_cli_index_get_option(&index, "option1"));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_cli_index_fini(&index));
+}
@@ -0,0 +1,202 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "./allocator_testing_utils.h"
+#include "rcutils/allocator.h"
+#include "rcutils/error_handling.h"
+#include "rcutils/types/concurrent_hash_map.h"
+
+struct value_t
+{
+  uint64_t first;
+  uint64_t second;
+};
+
+class ConcurrentHashMapTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    rcutils_allocator_t allocator = rcutils_get_default_allocator();
+    ASSERT_EQ(
+      RCUTILS_RET_OK, rcutils_concurrent_hash_map_init(
+        &map, 2, sizeof(uint64_t), sizeof(value_t),
+        rcutils_hash_map_uint64_hash_func, rcutils_hash_map_uint64_cmp_func, &allocator));
+  }
+
+  void TearDown() override
+  {
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_concurrent_hash_map_fini(&map));
+  }
+
+  rcutils_concurrent_hash_map_t map = rcutils_get_zero_initialized_concurrent_hash_map();
+};
+
+TEST(test_concurrent_hash_map, init_fini) {
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  rcutils_allocator_t failing_allocator = get_failing_allocator();
+  rcutils_concurrent_hash_map_t map = rcutils_get_zero_initialized_concurrent_hash_map();
+
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_concurrent_hash_map_init(
+      nullptr, 2, 8, 8, rcutils_hash_map_uint64_hash_func, rcutils_hash_map_uint64_cmp_func,
+      &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_concurrent_hash_map_init(
+      &map, 2, 0, 8, rcutils_hash_map_uint64_hash_func, rcutils_hash_map_uint64_cmp_func,
+      &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_concurrent_hash_map_init(
+      &map, 2, 8, 8, nullptr, rcutils_hash_map_uint64_cmp_func, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_concurrent_hash_map_init(
+      &map, 2, 8, 8, rcutils_hash_map_uint64_hash_func, nullptr, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_BAD_ALLOC, rcutils_concurrent_hash_map_init(
+      &map, 2, 8, 8, rcutils_hash_map_uint64_hash_func, rcutils_hash_map_uint64_cmp_func,
+      &failing_allocator));
+  rcutils_reset_error();
+
+  ASSERT_EQ(
+    RCUTILS_RET_OK, rcutils_concurrent_hash_map_init(
+      &map, 100, 8, 8, rcutils_hash_map_uint64_hash_func, rcutils_hash_map_uint64_cmp_func,
+      &allocator));
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_concurrent_hash_map_init(
+      &map, 100, 8, 8, rcutils_hash_map_uint64_hash_func, rcutils_hash_map_uint64_cmp_func,
+      &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_concurrent_hash_map_fini(&map));
+  EXPECT_EQ(nullptr, map.impl);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_concurrent_hash_map_fini(&map));
+
+  size_t size = 0;
+  EXPECT_EQ(RCUTILS_RET_NOT_INITIALIZED, rcutils_concurrent_hash_map_get_size(&map, &size));
+  rcutils_reset_error();
+  uint64_t key = 1;
+  EXPECT_FALSE(rcutils_concurrent_hash_map_key_exists(&map, &key));
+}
+
+TEST_F(ConcurrentHashMapTest, set_get_unset) {
+  uint64_t key = 7;
+  value_t value = {1, 2};
+  value_t read = {0, 0};
+  size_t size = 0;
+
+  EXPECT_EQ(RCUTILS_RET_NOT_FOUND, rcutils_concurrent_hash_map_get(&map, &key, &read));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_concurrent_hash_map_set(&map, &key, &value));
+  EXPECT_TRUE(rcutils_concurrent_hash_map_key_exists(&map, &key));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_concurrent_hash_map_get(&map, &key, &read));
+  EXPECT_EQ(1u, read.first);
+  EXPECT_EQ(2u, read.second);
+
+  value = {3, 4};
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_concurrent_hash_map_set(&map, &key, &value));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_concurrent_hash_map_get(&map, &key, &read));
+  EXPECT_EQ(3u, read.first);
+  EXPECT_EQ(4u, read.second);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_concurrent_hash_map_get_size(&map, &size));
+  EXPECT_EQ(1u, size);
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_concurrent_hash_map_unset(&map, &key));
+  EXPECT_FALSE(rcutils_concurrent_hash_map_key_exists(&map, &key));
+  EXPECT_EQ(RCUTILS_RET_STRING_KEY_NOT_FOUND, rcutils_concurrent_hash_map_unset(&map, &key));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_concurrent_hash_map_get_size(&map, &size));
+  EXPECT_EQ(0u, size);
+
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_concurrent_hash_map_set(&map, nullptr, &value));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_concurrent_hash_map_get(&map, &key, nullptr));
+  rcutils_reset_error();
+}
+
+TEST_F(ConcurrentHashMapTest, grow_and_churn) {
+  // Many more keys than the initial capacity, each set several times
+  for (uint64_t round = 0; round < 3; ++round) {
+    for (uint64_t key = 0; key < 1000; ++key) {
+      value_t value = {key, round};
+      ASSERT_EQ(RCUTILS_RET_OK, rcutils_concurrent_hash_map_set(&map, &key, &value));
+    }
+  }
+  size_t size = 0;
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_concurrent_hash_map_get_size(&map, &size));
+  EXPECT_EQ(1000u, size);
+  for (uint64_t key = 0; key < 1000; ++key) {
+    value_t value = {0, 0};
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_concurrent_hash_map_get(&map, &key, &value));
+    EXPECT_EQ(key, value.first);
+    EXPECT_EQ(2u, value.second);
+  }
+  for (uint64_t key = 0; key < 1000; key += 2) {
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_concurrent_hash_map_unset(&map, &key));
+  }
+  for (uint64_t key = 0; key < 1000; ++key) {
+    EXPECT_EQ(1 == key % 2, rcutils_concurrent_hash_map_key_exists(&map, &key));
+  }
+}
+
+TEST_F(ConcurrentHashMapTest, readers_during_writes) {
+  constexpr uint64_t keys = 256;
+  for (uint64_t key = 0; key < keys; ++key) {
+    value_t value = {key, key};
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_concurrent_hash_map_set(&map, &key, &value));
+  }
+
+  // The writer keeps both halves of each value equal, readers must never see them differ
+  std::atomic<bool> done(false);
+  std::atomic<uint64_t> errors(0);
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 3; ++i) {
+    readers.emplace_back(
+      [this, &done, &errors]() {
+        uint64_t key = 0;
+        while (!done.load()) {
+          value_t value = {0, 0};
+          if (RCUTILS_RET_OK != rcutils_concurrent_hash_map_get(&map, &key, &value) ||
+          value.first != value.second)
+          {
+            ++errors;
+          }
+          key = (key + 1) % keys;
+        }
+      });
+  }
+  for (uint64_t round = 1; round < 200; ++round) {
+    for (uint64_t key = 0; key < keys; ++key) {
+      value_t value = {key + round, key + round};
+      ASSERT_EQ(RCUTILS_RET_OK, rcutils_concurrent_hash_map_set(&map, &key, &value));
+    }
+    // Keys outside of those read, making shards grow while readers are in them
+    uint64_t extra = keys + round;
+    value_t value = {0, 0};
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_concurrent_hash_map_set(&map, &extra, &value));
+  }
+  done.store(true);
+  for (auto & reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(0u, errors.load());
+}
@@ -0,0 +1,241 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "./allocator_testing_utils.h"
+#include "rcutils/allocator.h"
+#include "rcutils/error_handling.h"
+#include "rcutils/types/concurrent_queue.h"
+
+struct element_t
+{
+  uint32_t producer;
+  uint32_t value;
+  char padding[5];
+};
+
+TEST(test_concurrent_queue, spsc_init_fini) {
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  rcutils_allocator_t failing_allocator = get_failing_allocator();
+  rcutils_spsc_queue_t queue = rcutils_get_zero_initialized_spsc_queue();
+
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_spsc_queue_init(nullptr, 4, 4, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_spsc_queue_init(&queue, 0, 4, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_spsc_queue_init(&queue, 4, 0, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_spsc_queue_init(&queue, 4, 4, nullptr));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_spsc_queue_init(&queue, SIZE_MAX, 4, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_BAD_ALLOC, rcutils_spsc_queue_init(&queue, 4, 4, &failing_allocator));
+  rcutils_reset_error();
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_spsc_queue_init(&queue, 5, 4, &allocator));
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_spsc_queue_init(&queue, 5, 4, &allocator));
+  rcutils_reset_error();
+  size_t capacity = 0;
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_spsc_queue_get_capacity(&queue, &capacity));
+  EXPECT_EQ(8u, capacity);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_spsc_queue_fini(&queue));
+  EXPECT_EQ(nullptr, queue.impl);
+  // Finalizing a zero initialized queue is a no-op
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_spsc_queue_fini(&queue));
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_spsc_queue_fini(nullptr));
+  rcutils_reset_error();
+
+  uint32_t value = 0;
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_spsc_queue_try_push(&queue, &value));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_spsc_queue_try_pop(&queue, &value));
+  rcutils_reset_error();
+}
+
+TEST(test_concurrent_queue, spsc_push_pop) {
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  rcutils_spsc_queue_t queue = rcutils_get_zero_initialized_spsc_queue();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_spsc_queue_init(&queue, 4, sizeof(element_t), &allocator));
+
+  element_t element = {0, 0, {0}};
+  EXPECT_EQ(RCUTILS_RET_QUEUE_EMPTY, rcutils_spsc_queue_try_pop(&queue, &element));
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_spsc_queue_try_push(&queue, nullptr));
+  rcutils_reset_error();
+
+  // Go around the slots a few times
+  uint32_t pushed = 0;
+  uint32_t popped = 0;
+  for (int lap = 0; lap < 3; ++lap) {
+    for (int i = 0; i < 4; ++i) {
+      element.value = pushed++;
+      EXPECT_EQ(RCUTILS_RET_OK, rcutils_spsc_queue_try_push(&queue, &element));
+    }
+    EXPECT_EQ(RCUTILS_RET_NOT_ENOUGH_SPACE, rcutils_spsc_queue_try_push(&queue, &element));
+    size_t size = 0;
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_spsc_queue_get_size(&queue, &size));
+    EXPECT_EQ(4u, size);
+    for (int i = 0; i < 3; ++i) {
+      EXPECT_EQ(RCUTILS_RET_OK, rcutils_spsc_queue_try_pop(&queue, &element));
+      EXPECT_EQ(popped++, element.value);
+    }
+    element.value = pushed++;
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_spsc_queue_try_push(&queue, &element));
+    while (RCUTILS_RET_OK == rcutils_spsc_queue_try_pop(&queue, &element)) {
+      EXPECT_EQ(popped++, element.value);
+    }
+    EXPECT_EQ(pushed, popped);
+  }
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_spsc_queue_fini(&queue));
+}
+
+TEST(test_concurrent_queue, spsc_threads) {
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  rcutils_spsc_queue_t queue = rcutils_get_zero_initialized_spsc_queue();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_spsc_queue_init(&queue, 16, sizeof(uint32_t), &allocator));
+
+  constexpr uint32_t count = 100000;
+  std::thread producer(
+    [&queue]() {
+      for (uint32_t value = 0; value < count; ) {
+        if (RCUTILS_RET_OK == rcutils_spsc_queue_try_push(&queue, &value)) {
+          ++value;
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+  uint32_t expected = 0;
+  while (expected < count) {
+    uint32_t value;
+    if (RCUTILS_RET_OK == rcutils_spsc_queue_try_pop(&queue, &value)) {
+      ASSERT_EQ(expected, value);
+      ++expected;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_spsc_queue_fini(&queue));
+}
+
+TEST(test_concurrent_queue, mpsc_init_fini) {
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  rcutils_allocator_t failing_allocator = get_failing_allocator();
+  rcutils_mpsc_queue_t queue = rcutils_get_zero_initialized_mpsc_queue();
+
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_mpsc_queue_init(nullptr, 4, 4, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_mpsc_queue_init(&queue, 0, 4, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_mpsc_queue_init(&queue, 4, 0, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_mpsc_queue_init(&queue, 4, SIZE_MAX, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_BAD_ALLOC, rcutils_mpsc_queue_init(&queue, 4, 4, &failing_allocator));
+  rcutils_reset_error();
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_mpsc_queue_init(&queue, 3, 4, &allocator));
+  size_t capacity = 0;
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_mpsc_queue_get_capacity(&queue, &capacity));
+  EXPECT_EQ(4u, capacity);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_mpsc_queue_fini(&queue));
+  EXPECT_EQ(nullptr, queue.impl);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_mpsc_queue_fini(&queue));
+}
+
+TEST(test_concurrent_queue, mpsc_push_pop) {
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  rcutils_mpsc_queue_t queue = rcutils_get_zero_initialized_mpsc_queue();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_mpsc_queue_init(&queue, 4, sizeof(element_t), &allocator));
+
+  element_t element = {0, 0, {0}};
+  EXPECT_EQ(RCUTILS_RET_QUEUE_EMPTY, rcutils_mpsc_queue_try_pop(&queue, &element));
+
+  uint32_t pushed = 0;
+  uint32_t popped = 0;
+  for (int lap = 0; lap < 3; ++lap) {
+    for (int i = 0; i < 4; ++i) {
+      element.value = pushed++;
+      EXPECT_EQ(RCUTILS_RET_OK, rcutils_mpsc_queue_try_push(&queue, &element));
+    }
+    EXPECT_EQ(RCUTILS_RET_NOT_ENOUGH_SPACE, rcutils_mpsc_queue_try_push(&queue, &element));
+    size_t size = 0;
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_mpsc_queue_get_size(&queue, &size));
+    EXPECT_EQ(4u, size);
+    for (int i = 0; i < 2; ++i) {
+      EXPECT_EQ(RCUTILS_RET_OK, rcutils_mpsc_queue_try_pop(&queue, &element));
+      EXPECT_EQ(popped++, element.value);
+    }
+    element.value = pushed++;
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_mpsc_queue_try_push(&queue, &element));
+    while (RCUTILS_RET_OK == rcutils_mpsc_queue_try_pop(&queue, &element)) {
+      EXPECT_EQ(popped++, element.value);
+    }
+    EXPECT_EQ(pushed, popped);
+  }
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_mpsc_queue_fini(&queue));
+}
+
+TEST(test_concurrent_queue, mpsc_threads) {
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  rcutils_mpsc_queue_t queue = rcutils_get_zero_initialized_mpsc_queue();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_mpsc_queue_init(&queue, 32, sizeof(element_t), &allocator));
+
+  constexpr uint32_t producers = 4;
+  constexpr uint32_t count = 20000;
+  std::vector<std::thread> threads;
+  for (uint32_t producer = 0; producer < producers; ++producer) {
+    threads.emplace_back(
+      [&queue, producer]() {
+        element_t element = {producer, 0, {0}};
+        while (element.value < count) {
+          if (RCUTILS_RET_OK == rcutils_mpsc_queue_try_push(&queue, &element)) {
+            ++element.value;
+          } else {
+            std::this_thread::yield();
+          }
+        }
+      });
+  }
+  // The elements of each producer are popped in the order it pushed them
+  std::vector<uint32_t> expected(producers, 0);
+  for (uint32_t popped = 0; popped < producers * count; ) {
+    element_t element;
+    if (RCUTILS_RET_OK == rcutils_mpsc_queue_try_pop(&queue, &element)) {
+      ASSERT_LT(element.producer, producers);
+      ASSERT_EQ(expected[element.producer], element.value);
+      ++expected[element.producer];
+      ++popped;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+  element_t element;
+  EXPECT_EQ(RCUTILS_RET_QUEUE_EMPTY, rcutils_mpsc_queue_try_pop(&queue, &element));
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_mpsc_queue_fini(&queue));
+}
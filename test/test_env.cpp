@@ -14,6 +14,7 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdlib>
 #include <string>
 
 #include "rcutils/env.h"
@@ -106,3 +107,68 @@ TEST(TestEnv, test_get_home) {
   EXPECT_EQ(NULL, rcutils_get_home_dir());
 #endif
 }
+
+TEST(TestEnv, test_env_snapshot) {
+  EXPECT_FALSE(rcutils_env_snapshot_is_enabled());
+  EXPECT_EQ(nullptr, rcutils_env_snapshot_get(nullptr));
+  EXPECT_STREQ("foo", rcutils_env_snapshot_get("NORMAL_TEST"));
+  EXPECT_EQ(nullptr, rcutils_env_snapshot_get("SHOULD_NOT_EXIST_TEST"));
+
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_env_snapshot_init(rcutils_get_zero_initialized_allocator()));
+  rcutils_reset_error();
+  EXPECT_FALSE(rcutils_env_snapshot_is_enabled());
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_env_snapshot_init(rcutils_get_default_allocator()));
+  EXPECT_TRUE(rcutils_env_snapshot_is_enabled());
+  EXPECT_STREQ("foo", rcutils_env_snapshot_get("NORMAL_TEST"));
+  EXPECT_STREQ("", rcutils_env_snapshot_get("EMPTY_TEST"));
+  EXPECT_EQ(nullptr, rcutils_env_snapshot_get("SHOULD_NOT_EXIST_TEST"));
+  EXPECT_EQ(nullptr, rcutils_env_snapshot_get("NORMAL_TES"));
+  EXPECT_EQ(nullptr, rcutils_env_snapshot_get("NORMAL_TEST_"));
+  EXPECT_EQ(nullptr, rcutils_env_snapshot_get(""));
+  const char * env;
+  EXPECT_EQ(nullptr, rcutils_get_env("NORMAL_TEST", &env));
+  EXPECT_STREQ("foo", env);
+
+  // rcutils_set_env() rebuilds the snapshot
+  ASSERT_TRUE(rcutils_set_env("SNAPSHOT_TEST", "bar"));
+  EXPECT_STREQ("bar", rcutils_env_snapshot_get("SNAPSHOT_TEST"));
+  EXPECT_EQ(nullptr, rcutils_get_env("SNAPSHOT_TEST", &env));
+  EXPECT_STREQ("bar", env);
+  ASSERT_TRUE(rcutils_set_env("SNAPSHOT_TEST", "baz"));
+  EXPECT_STREQ("baz", rcutils_env_snapshot_get("SNAPSHOT_TEST"));
+
+  // Many variables
+  for (int i = 0; i < 200; ++i) {
+    std::string name = "SNAPSHOT_TEST_" + std::to_string(i);
+    ASSERT_TRUE(rcutils_set_env(name.c_str(), std::to_string(i * 2).c_str()));
+  }
+  for (int i = 0; i < 200; ++i) {
+    std::string name = "SNAPSHOT_TEST_" + std::to_string(i);
+    EXPECT_EQ(std::to_string(i * 2), rcutils_env_snapshot_get(name.c_str()));
+  }
+  for (int i = 0; i < 200; ++i) {
+    std::string name = "SNAPSHOT_TEST_" + std::to_string(i);
+    ASSERT_TRUE(rcutils_set_env(name.c_str(), nullptr));
+  }
+
+#ifndef _WIN32
+  // Changes made without rcutils_set_env() are seen once the snapshot is taken again
+  ASSERT_EQ(0, setenv("SNAPSHOT_TEST", "qux", 1));
+  EXPECT_STREQ("baz", rcutils_env_snapshot_get("SNAPSHOT_TEST"));
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_env_snapshot_init(rcutils_get_default_allocator()));
+  EXPECT_STREQ("qux", rcutils_env_snapshot_get("SNAPSHOT_TEST"));
+#endif
+
+  ASSERT_TRUE(rcutils_set_env("SNAPSHOT_TEST", nullptr));
+  EXPECT_EQ(nullptr, rcutils_env_snapshot_get("SNAPSHOT_TEST"));
+  EXPECT_EQ(nullptr, rcutils_get_env("SNAPSHOT_TEST", &env));
+  EXPECT_STREQ("", env);
+
+  rcutils_env_snapshot_fini();
+  EXPECT_FALSE(rcutils_env_snapshot_is_enabled());
+  EXPECT_STREQ("foo", rcutils_env_snapshot_get("NORMAL_TEST"));
+  rcutils_env_snapshot_fini();
+}
@@ -340,3 +340,171 @@ TEST(test_error_handling, overwrite) {
     rcutils_reset_error();
   });
 }
+
+TEST(test_error_handling, set_error_state_static) {
+  osrf_testing_tools_cpp::memory_tools::ScopedQuickstartGtest scoped_quickstart_gtest;
+  rcutils_ret_t ret =
+    rcutils_initialize_error_handling_thread_local_storage(rcutils_get_default_allocator());
+  ASSERT_EQ(ret, RCUTILS_RET_OK);
+  rcutils_reset_error();
+
+  EXPECT_NO_MEMORY_OPERATIONS(
+  {
+    RCUTILS_SET_ERROR_MSG_STATIC("a static error");
+  });
+  EXPECT_TRUE(rcutils_error_is_set());
+  size_t line_number = 0u;
+  // overwriting a deferred error with another one is not reported
+  for (int i = 0; i < 3; ++i) {
+    RCUTILS_SET_ERROR_MSG_STATIC("a static error");
+    line_number = __LINE__ - 1;
+  }
+  EXPECT_NO_MEMORY_OPERATIONS_BEGIN();
+  rcutils_error_string_t error_string = rcutils_get_error_string();
+  EXPECT_NO_MEMORY_OPERATIONS_END();
+  std::string expected = std::string("a static error, at ") + __FILE__ + ":" +
+    std::to_string(line_number);
+  EXPECT_STREQ(expected.c_str(), error_string.str);
+
+  const rcutils_error_state_t * error_state = rcutils_get_error_state();
+  ASSERT_NE(nullptr, error_state);
+  EXPECT_STREQ("a static error", error_state->message);
+  EXPECT_STREQ(__FILE__, error_state->file);
+  EXPECT_EQ(line_number, error_state->line_number);
+
+  // the state is copied on request without formatting the string first
+  rcutils_set_error_state_static("another static error", "file.c", 42);
+  error_state = rcutils_get_error_state();
+  EXPECT_STREQ("another static error", error_state->message);
+  EXPECT_STREQ("file.c", error_state->file);
+  EXPECT_EQ(42u, error_state->line_number);
+  EXPECT_STREQ("another static error, at file.c:42", rcutils_get_error_string().str);
+
+  // an eager error overwrites a deferred one
+  rcutils_set_error_state_static("a deferred error", "file.c", 1);
+  printf("The following warning from error_handling.c is expected...\n");
+  rcutils_set_error_state("an eager error", "other.c", 2);
+  EXPECT_STREQ("an eager error, at other.c:2", rcutils_get_error_string().str);
+  EXPECT_STREQ("an eager error", rcutils_get_error_state()->message);
+
+  // and a deferred error overwrites an eager one
+  rcutils_set_error_state_static("a deferred error", "file.c", 1);
+  EXPECT_STREQ("a deferred error", rcutils_get_error_state()->message);
+  EXPECT_STREQ("a deferred error, at file.c:1", rcutils_get_error_string().str);
+
+  rcutils_reset_error();
+  EXPECT_FALSE(rcutils_error_is_set());
+  EXPECT_STREQ("", rcutils_get_error_state()->message);
+
+  rcutils_set_error_state_static(nullptr, "file.c", 1);
+  EXPECT_FALSE(rcutils_error_is_set());
+  rcutils_set_error_state_static("message", nullptr, 1);
+  EXPECT_FALSE(rcutils_error_is_set());
+}
+
+TEST(test_error_handling, set_error_code) {
+  osrf_testing_tools_cpp::memory_tools::ScopedQuickstartGtest scoped_quickstart_gtest;
+  rcutils_ret_t ret =
+    rcutils_initialize_error_handling_thread_local_storage(rcutils_get_default_allocator());
+  ASSERT_EQ(ret, RCUTILS_RET_OK);
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_get_error_code());
+
+  EXPECT_NO_MEMORY_OPERATIONS(
+  {
+    RCUTILS_SET_ERROR_CODE(RCUTILS_RET_NOT_ENOUGH_SPACE, "no space left");
+  });
+  EXPECT_TRUE(rcutils_error_is_set());
+  EXPECT_EQ(RCUTILS_RET_NOT_ENOUGH_SPACE, rcutils_get_error_code());
+  EXPECT_STREQ("no space left", rcutils_get_error_state()->message);
+
+  RCUTILS_SET_ERROR_MSG_STATIC("no space left");
+  EXPECT_EQ(RCUTILS_RET_ERROR, rcutils_get_error_code());
+
+  RCUTILS_SET_ERROR_CODE(RCUTILS_RET_NOT_FOUND, "not found");
+  printf("The following warning from error_handling.c is expected...\n");
+  RCUTILS_SET_ERROR_MSG("an error without a code");
+  EXPECT_EQ(RCUTILS_RET_ERROR, rcutils_get_error_code());
+
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_get_error_code());
+
+  rcutils_set_error_code_static(RCUTILS_RET_NOT_FOUND, nullptr, "file.c", 1);
+  EXPECT_FALSE(rcutils_error_is_set());
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_get_error_code());
+}
+
+TEST(test_error_handling, error_history) {
+  osrf_testing_tools_cpp::memory_tools::ScopedQuickstartGtest scoped_quickstart_gtest;
+  rcutils_ret_t ret =
+    rcutils_initialize_error_handling_thread_local_storage(rcutils_get_default_allocator());
+  ASSERT_EQ(ret, RCUTILS_RET_OK);
+  rcutils_reset_error();
+  rcutils_clear_error_history();
+  EXPECT_FALSE(rcutils_error_history_is_enabled());
+
+  rcutils_error_string_t history[RCUTILS_ERROR_HISTORY_SIZE + 1];
+  EXPECT_EQ(0u, rcutils_get_error_history(history, RCUTILS_ERROR_HISTORY_SIZE + 1));
+  EXPECT_EQ(0u, rcutils_get_error_history(nullptr, 1));
+
+  // without the history, overwritten errors are only reported to stderr
+  rcutils_set_error_state("first", "file.c", 1);
+  printf("The following warning from error_handling.c is expected...\n");
+  rcutils_set_error_state("second", "file.c", 2);
+  EXPECT_EQ(0u, rcutils_get_error_history(history, RCUTILS_ERROR_HISTORY_SIZE + 1));
+  rcutils_reset_error();
+
+  rcutils_set_error_history_enabled(true);
+  EXPECT_TRUE(rcutils_error_history_is_enabled());
+  testing::internal::CaptureStderr();
+  EXPECT_NO_MEMORY_OPERATIONS(
+  {
+    rcutils_set_error_state("first", "file.c", 1);
+    rcutils_set_error_state("second", "file.c", 2);
+    // the same message again isn't recorded
+    rcutils_set_error_state("second", "file.c", 3);
+    rcutils_set_error_state_static("third", "static.c", 3);
+    rcutils_set_error_state("fourth", "file.c", 4);
+  });
+  EXPECT_EQ("", testing::internal::GetCapturedStderr());
+  EXPECT_STREQ("fourth, at file.c:4", rcutils_get_error_string().str);
+
+  EXPECT_NO_MEMORY_OPERATIONS_BEGIN();
+  size_t count = rcutils_get_error_history(history, RCUTILS_ERROR_HISTORY_SIZE + 1);
+  EXPECT_NO_MEMORY_OPERATIONS_END();
+  ASSERT_EQ(3u, count);
+  EXPECT_STREQ("third, at static.c:3", history[0].str);
+  EXPECT_STREQ("second, at file.c:3", history[1].str);
+  EXPECT_STREQ("first, at file.c:1", history[2].str);
+  ASSERT_EQ(1u, rcutils_get_error_history(history, 1));
+  EXPECT_STREQ("third, at static.c:3", history[0].str);
+
+  // the reset keeps the history, and the ring keeps the most recent errors
+  rcutils_reset_error();
+  for (size_t i = 0; i < RCUTILS_ERROR_HISTORY_SIZE + 1; ++i) {
+    rcutils_set_error_state(("error " + std::to_string(i)).c_str(), "file.c", i);
+  }
+  count = rcutils_get_error_history(history, RCUTILS_ERROR_HISTORY_SIZE + 1);
+  ASSERT_EQ(static_cast<size_t>(RCUTILS_ERROR_HISTORY_SIZE), count);
+  std::string expected = "error " + std::to_string(RCUTILS_ERROR_HISTORY_SIZE - 1);
+  EXPECT_EQ(0, strncmp(expected.c_str(), history[0].str, expected.size()));
+
+  // long messages are truncated
+  std::string long_message(RCUTILS_ERROR_HISTORY_STRING_MAX_LENGTH * 2, 'x');
+  rcutils_set_error_state(long_message.c_str(), "file.c", 1);
+  rcutils_set_error_state("short", "file.c", 2);
+  ASSERT_LE(1u, rcutils_get_error_history(history, 1));
+  EXPECT_EQ(
+    std::string(RCUTILS_ERROR_HISTORY_STRING_MAX_LENGTH - 1, 'x') + ", at file.c:1",
+    history[0].str);
+
+  testing::internal::CaptureStderr();
+  rcutils_print_error_history();
+  std::string printed = testing::internal::GetCapturedStderr();
+  EXPECT_EQ(RCUTILS_ERROR_HISTORY_SIZE, count_substrings(printed, ", at file.c:"));
+
+  rcutils_clear_error_history();
+  EXPECT_EQ(0u, rcutils_get_error_history(history, RCUTILS_ERROR_HISTORY_SIZE + 1));
+  rcutils_set_error_history_enabled(false);
+  rcutils_reset_error();
+}
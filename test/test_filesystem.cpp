@@ -13,8 +13,15 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
 #include <set>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "rcutils/env.h"
 #include "rcutils/error_handling.h"
@@ -104,6 +111,118 @@ TEST_F(TestFilesystemFixture, to_native_path) {
   }
 }
 
+TEST_F(TestFilesystemFixture, join_path_to_buffer) {
+#ifdef _WIN32
+  const char * ref_str = "foo\\bar";
+#else
+  const char * ref_str = "foo/bar";
+#endif  // _WIN32
+  char buffer[8];
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_join_path_to_buffer("foo", "bar", buffer, sizeof(buffer)));
+  EXPECT_STREQ(ref_str, buffer);
+  // In place
+  char in_place[8] = "foo";
+  EXPECT_EQ(
+    RCUTILS_RET_OK, rcutils_join_path_to_buffer(in_place, "bar", in_place, sizeof(in_place)));
+  EXPECT_STREQ(ref_str, in_place);
+
+  EXPECT_EQ(
+    RCUTILS_RET_NOT_ENOUGH_SPACE,
+    rcutils_join_path_to_buffer("foo", "bar", buffer, sizeof(buffer) - 1u));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_join_path_to_buffer(NULL, "bar", buffer, sizeof(buffer)));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_join_path_to_buffer("foo", NULL, buffer, sizeof(buffer)));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_join_path_to_buffer("foo", "bar", NULL, sizeof(buffer)));
+  rcutils_reset_error();
+}
+
+TEST_F(TestFilesystemFixture, to_native_path_in_place) {
+  char path[] = "/foo//bar/baz";
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_to_native_path_in_place(path));
+#ifdef _WIN32
+  EXPECT_STREQ("\\foo\\\\bar\\baz", path);
+#else
+  EXPECT_STREQ("/foo//bar/baz", path);
+#endif  // _WIN32
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_to_native_path_in_place(NULL));
+  rcutils_reset_error();
+}
+
+TEST_F(TestFilesystemFixture, path_push_and_pop) {
+#ifdef _WIN32
+  const std::string delimiter = "\\";
+#else
+  const std::string delimiter = "/";
+#endif  // _WIN32
+  // Small enough to grow past the stack
+  RCUTILS_CHAR_ARRAY_WITH_STACK(path, 8, g_allocator);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_fini(&path));
+  });
+
+  // No delimiter in front of a relative path
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_path_push(&path, "foo"));
+  EXPECT_STREQ("foo", path.buffer);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_path_push(&path, "bar"));
+  EXPECT_EQ("foo" + delimiter + "bar", path.buffer);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_path_push(&path, "a_longer_file_name.txt"));
+  EXPECT_EQ(
+    "foo" + delimiter + "bar" + delimiter + "a_longer_file_name.txt", path.buffer);
+  EXPECT_TRUE(path.owns_buffer);
+  EXPECT_EQ(strlen(path.buffer) + 1u, path.buffer_length);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_path_pop(&path));
+  EXPECT_EQ("foo" + delimiter + "bar", path.buffer);
+  EXPECT_EQ(strlen(path.buffer) + 1u, path.buffer_length);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_path_pop(&path));
+  EXPECT_STREQ("foo", path.buffer);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_path_pop(&path));
+  EXPECT_STREQ("", path.buffer);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_path_pop(&path));
+  EXPECT_STREQ("", path.buffer);
+
+  // The root directory is kept, and no delimiter is doubled after it
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_char_array_strcpy(&path, delimiter.c_str()));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_path_push(&path, "tmp"));
+  EXPECT_EQ(delimiter + "tmp", path.buffer);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_path_pop(&path));
+  EXPECT_EQ(delimiter, path.buffer);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_path_pop(&path));
+  EXPECT_EQ(delimiter, path.buffer);
+
+  // Trailing delimiters are popped with the component
+  ASSERT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_char_array_strcpy(&path, ("foo" + delimiter + "bar" + delimiter).c_str()));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_path_push(&path, "baz"));
+  EXPECT_EQ("foo" + delimiter + "bar" + delimiter + "baz", path.buffer);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_path_pop(&path));
+  EXPECT_EQ("foo" + delimiter + "bar", path.buffer);
+
+  // A zero initialized char array is an empty path
+  rcutils_char_array_t empty_path = rcutils_get_zero_initialized_char_array();
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_path_pop(&empty_path));
+  empty_path.allocator = g_allocator;
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_path_push(&empty_path, "foo"));
+  EXPECT_STREQ("foo", empty_path.buffer);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_fini(&empty_path));
+
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_path_push(NULL, "foo"));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_path_push(&path, NULL));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_path_pop(NULL));
+  rcutils_reset_error();
+}
+
 TEST_F(TestFilesystemFixture, exists) {
   {
     char * path = rcutils_join_path(this->test_path, "dummy_readable_file.txt", g_allocator);
@@ -366,6 +485,38 @@ TEST_F(TestFilesystemFixture, expand_user) {
   }
 }
 
+TEST_F(TestFilesystemFixture, expand_user_to_buffer) {
+  const char * homedir = rcutils_get_home_dir();
+  ASSERT_STRNE(NULL, homedir);
+  const std::string expected = std::string(homedir) + "/my/directory";
+
+  std::vector<char> buffer(expected.size() + 1u);
+  EXPECT_EQ(
+    RCUTILS_RET_OK, rcutils_expand_user_to_buffer("~/my/directory", buffer.data(), buffer.size()));
+  EXPECT_EQ(expected, buffer.data());
+  EXPECT_EQ(
+    RCUTILS_RET_OK, rcutils_expand_user_to_buffer("/no/tilde", buffer.data(), buffer.size()));
+  EXPECT_STREQ("/no/tilde", buffer.data());
+  // In place
+  snprintf(buffer.data(), buffer.size(), "%s", "~/my/directory");
+  EXPECT_EQ(
+    RCUTILS_RET_OK, rcutils_expand_user_to_buffer(buffer.data(), buffer.data(), buffer.size()));
+  EXPECT_EQ(expected, buffer.data());
+
+  EXPECT_EQ(
+    RCUTILS_RET_NOT_ENOUGH_SPACE,
+    rcutils_expand_user_to_buffer("~/my/directory", buffer.data(), buffer.size() - 1u));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_NOT_ENOUGH_SPACE, rcutils_expand_user_to_buffer("/no/tilde", buffer.data(), 9u));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_expand_user_to_buffer(NULL, buffer.data(), 9u));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_expand_user_to_buffer("~", NULL, 9u));
+  rcutils_reset_error();
+}
+
 TEST_F(TestFilesystemFixture, mkdir) {
   {
     // Make a new directory
@@ -414,6 +565,49 @@ TEST_F(TestFilesystemFixture, mkdir) {
   }
 }
 
+TEST_F(TestFilesystemFixture, path_stat) {
+  rcutils_path_status_t status;
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_path_stat(nullptr, &status));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_path_stat(this->test_path, nullptr));
+  rcutils_reset_error();
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_path_stat(this->test_path, &status));
+  EXPECT_TRUE(status.exists);
+  EXPECT_EQ(RCUTILS_DIR_ENTRY_TYPE_DIRECTORY, status.type);
+
+  char * path = rcutils_join_path(this->test_path, "dummy_readable_file.txt", g_allocator);
+  ASSERT_NE(nullptr, path);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    g_allocator.deallocate(path, g_allocator.state);
+  });
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_path_stat(path, &status));
+  EXPECT_TRUE(status.exists);
+  EXPECT_EQ(RCUTILS_DIR_ENTRY_TYPE_FILE, status.type);
+#ifdef WIN32
+  // Due to different line breaks on windows, we have one more byte in the file.
+  // See https://github.com/ros2/rcutils/issues/198
+  EXPECT_EQ(6u, status.size);
+#else
+  EXPECT_EQ(5u, status.size);
+#endif
+  EXPECT_NE(0u, status.permissions & 0400u);
+  EXPECT_GT(status.mtime, 0);
+  EXPECT_GT(status.atime, 0);
+
+  char * non_existing_path = rcutils_join_path(this->test_path, "non_existing_file", g_allocator);
+  ASSERT_NE(nullptr, non_existing_path);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    g_allocator.deallocate(non_existing_path, g_allocator.state);
+  });
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_path_stat(non_existing_path, &status));
+  EXPECT_FALSE(status.exists);
+  EXPECT_EQ(RCUTILS_DIR_ENTRY_TYPE_UNKNOWN, status.type);
+  EXPECT_EQ(0u, status.size);
+}
+
 TEST_F(TestFilesystemFixture, calculate_directory_size) {
   // Check directory without sub-directory
   char * path =
@@ -520,6 +714,48 @@ TEST_F(TestFilesystemFixture, calculate_directory_size_with_recursion) {
   }
 }
 
+TEST_F(TestFilesystemFixture, calculate_directory_size_with_options) {
+  char * path =
+    rcutils_join_path(this->test_path, "dummy_folder_with_subdir", g_allocator);
+  ASSERT_NE(nullptr, path);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    g_allocator.deallocate(path, g_allocator.state);
+  });
+  uint64_t size = 0;
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_calculate_directory_size_with_options(path, nullptr, &size, g_allocator));
+
+  rcutils_directory_size_options_t options = rcutils_directory_size_get_default_options();
+  EXPECT_EQ(0u, options.max_depth);
+  EXPECT_EQ(1u, options.threads);
+  // The results are the same regardless of the number of threads.
+  for (size_t threads : {0u, 1u, 4u}) {
+    options.threads = threads;
+    options.max_depth = 2;
+    ASSERT_EQ(
+      RCUTILS_RET_OK,
+      rcutils_calculate_directory_size_with_options(path, &options, &size, g_allocator));
+#ifdef WIN32
+    // Due to different line breaks on windows, we have one more byte in the file.
+    // See https://github.com/ros2/rcutils/issues/198
+    EXPECT_EQ(12u, size) << threads;
+#else
+    EXPECT_EQ(10u, size) << threads;
+#endif
+    options.max_depth = 0;
+    ASSERT_EQ(
+      RCUTILS_RET_OK,
+      rcutils_calculate_directory_size_with_options(path, &options, &size, g_allocator));
+#ifdef WIN32
+    EXPECT_EQ(18u, size) << threads;
+#else
+    EXPECT_EQ(15u, size) << threads;
+#endif
+  }
+}
+
 TEST_F(TestFilesystemFixture, calculate_file_size) {
   char * path =
     rcutils_join_path(this->test_path, "dummy_readable_file.txt", g_allocator);
@@ -578,6 +814,54 @@ TEST_F(TestFilesystemFixture, directory_iterator) {
   }
 }
 
+TEST_F(TestFilesystemFixture, directory_iterator_with_options) {
+  char * path =
+    rcutils_join_path(this->test_path, "dummy_folder_with_subdir", g_allocator);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    g_allocator.deallocate(path, g_allocator.state);
+  });
+  EXPECT_EQ(nullptr, rcutils_dir_iter_start_with_options(path, nullptr, g_allocator));
+  rcutils_reset_error();
+
+  rcutils_dir_iter_options_t options = rcutils_dir_iter_get_default_options();
+  EXPECT_FALSE(options.stat_entries);
+  for (bool stat_entries : {false, true}) {
+    options.stat_entries = stat_entries;
+    rcutils_dir_iter_t * iter = rcutils_dir_iter_start_with_options(path, &options, g_allocator);
+    ASSERT_NE(nullptr, iter);
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+    {
+      rcutils_dir_iter_end(iter);
+    });
+
+    size_t entries = 0;
+    do {
+      std::string name = iter->entry_name;
+      if (name == "dummy.dummy") {
+        EXPECT_EQ(RCUTILS_DIR_ENTRY_TYPE_FILE, iter->entry_type);
+        if (stat_entries) {
+#ifdef WIN32
+          // Due to different line breaks on windows, we have one more byte in the file.
+          EXPECT_EQ(6u, iter->entry_size);
+#else
+          EXPECT_EQ(5u, iter->entry_size);
+#endif
+          EXPECT_GT(iter->entry_mtime, 0);
+        } else {
+          EXPECT_EQ(0u, iter->entry_size);
+          EXPECT_EQ(0, iter->entry_mtime);
+        }
+      } else {
+        EXPECT_TRUE(name == "." || name == ".." || name == "dummy-subfolder") << name;
+        EXPECT_EQ(RCUTILS_DIR_ENTRY_TYPE_DIRECTORY, iter->entry_type) << name;
+      }
+      ++entries;
+    } while (rcutils_dir_iter_next(iter));
+    EXPECT_EQ(4u, entries);
+  }
+}
+
 TEST_F(TestFilesystemFixture, directory_iterator_non_existing) {
   char * path =
     rcutils_join_path(this->test_path, "non_existing_folder", g_allocator);
@@ -601,3 +885,405 @@ TEST_F(TestFilesystemFixture, directory_iterator_on_file) {
   EXPECT_EQ(nullptr, rcutils_dir_iter_start(path, g_allocator));
   rcutils_reset_error();
 }
+
+typedef std::vector<std::pair<rcutils_file_watch_event_type_t, std::string>> file_watch_events_t;
+
+static void collect_file_watch_event(const rcutils_file_watch_event_t * event, void * user_data)
+{
+  static_cast<file_watch_events_t *>(user_data)->emplace_back(event->type, event->name);
+}
+
+// Read the changes until one of the given type and name is read, for at most 5 seconds.
+static bool read_file_watch_event(
+  rcutils_file_watcher_t * watcher, rcutils_file_watch_event_type_t type, const char * name)
+{
+  for (int i = 0; i < 50; ++i) {
+    file_watch_events_t events;
+    if (RCUTILS_RET_OK != rcutils_file_watcher_read(
+        watcher, RCUTILS_MS_TO_NS(100), collect_file_watch_event, &events, nullptr))
+    {
+      return false;
+    }
+    for (const auto & event : events) {
+      if (type == event.first && name == event.second) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// The entries visited by a walk, by their paths relative to the walked directory.
+struct DirWalkVisits
+{
+  std::string prefix;
+  std::mutex mutex;
+  std::map<std::string, rcutils_dir_walk_entry_t> entries;
+  rcutils_dir_walk_action_t action = RCUTILS_DIR_WALK_CONTINUE;
+  std::string action_name;
+
+  static rcutils_dir_walk_action_t visit(const rcutils_dir_walk_entry_t * entry, void * user_data)
+  {
+    auto visits = static_cast<DirWalkVisits *>(user_data);
+    std::string path = entry->path;
+    EXPECT_EQ(0u, path.find(visits->prefix)) << path;
+    std::string relative_path = path.substr(visits->prefix.size() + 1u);
+    std::replace(relative_path.begin(), relative_path.end(), '\\', '/');
+    EXPECT_EQ(
+      std::string(entry->name), relative_path.substr(relative_path.find_last_of('/') + 1u));
+    std::lock_guard<std::mutex> lock(visits->mutex);
+    EXPECT_TRUE(visits->entries.emplace(relative_path, *entry).second) << relative_path;
+    if (visits->action_name.empty() || visits->action_name == relative_path) {
+      return visits->action;
+    }
+    return RCUTILS_DIR_WALK_CONTINUE;
+  }
+
+  std::set<std::string> paths()
+  {
+    std::set<std::string> paths;
+    for (const auto & entry : entries) {
+      paths.insert(entry.first);
+    }
+    return paths;
+  }
+};
+
+TEST_F(TestFilesystemFixture, dir_walk) {
+  char * path = rcutils_join_path(this->test_path, "dummy_folder_with_subdir", g_allocator);
+  ASSERT_NE(nullptr, path);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    g_allocator.deallocate(path, g_allocator.state);
+  });
+  const std::set<std::string> all_paths = {
+    "dummy.dummy",
+    "dummy-subfolder",
+    "dummy-subfolder/dummy.dummy",
+    "dummy-subfolder/dummy-subfolder",
+    "dummy-subfolder/dummy-subfolder/dummy.dummy",
+  };
+
+  rcutils_dir_walk_options_t options = rcutils_dir_walk_get_default_options();
+  EXPECT_EQ(0u, options.max_depth);
+  EXPECT_EQ(nullptr, options.include_pattern);
+  EXPECT_EQ(nullptr, options.exclude_pattern);
+  EXPECT_FALSE(options.stat_entries);
+  EXPECT_EQ(1u, options.threads);
+  for (size_t threads : {1u, 4u}) {
+    options.threads = threads;
+    DirWalkVisits visits;
+    visits.prefix = path;
+    EXPECT_EQ(
+      RCUTILS_RET_OK,
+      rcutils_dir_walk(path, &options, DirWalkVisits::visit, &visits, g_allocator));
+    EXPECT_EQ(all_paths, visits.paths());
+    EXPECT_EQ(1u, visits.entries["dummy.dummy"].depth);
+    EXPECT_EQ(RCUTILS_DIR_ENTRY_TYPE_FILE, visits.entries["dummy.dummy"].type);
+    EXPECT_EQ(0u, visits.entries["dummy.dummy"].size);
+    EXPECT_EQ(2u, visits.entries["dummy-subfolder/dummy-subfolder"].depth);
+    EXPECT_EQ(
+      RCUTILS_DIR_ENTRY_TYPE_DIRECTORY, visits.entries["dummy-subfolder/dummy-subfolder"].type);
+    EXPECT_EQ(3u, visits.entries["dummy-subfolder/dummy-subfolder/dummy.dummy"].depth);
+  }
+
+  {
+    DirWalkVisits visits;
+    visits.prefix = path;
+    EXPECT_EQ(
+      RCUTILS_RET_OK, rcutils_dir_walk(path, nullptr, DirWalkVisits::visit, &visits, g_allocator));
+    EXPECT_EQ(all_paths, visits.paths());
+  }
+  {
+    // With a trailing delimiter
+    DirWalkVisits visits;
+    visits.prefix = path;
+    std::string path_with_delimiter = std::string(path) + "/";
+    EXPECT_EQ(
+      RCUTILS_RET_OK,
+      rcutils_dir_walk(
+        path_with_delimiter.c_str(), nullptr, DirWalkVisits::visit, &visits, g_allocator));
+    EXPECT_EQ(all_paths, visits.paths());
+  }
+}
+
+TEST_F(TestFilesystemFixture, dir_walk_with_options) {
+  char * path = rcutils_join_path(this->test_path, "dummy_folder_with_subdir", g_allocator);
+  ASSERT_NE(nullptr, path);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    g_allocator.deallocate(path, g_allocator.state);
+  });
+
+  for (size_t threads : {1u, 4u}) {
+    rcutils_dir_walk_options_t options = rcutils_dir_walk_get_default_options();
+    options.threads = threads;
+    {
+      options.max_depth = 2u;
+      DirWalkVisits visits;
+      visits.prefix = path;
+      EXPECT_EQ(
+        RCUTILS_RET_OK,
+        rcutils_dir_walk(path, &options, DirWalkVisits::visit, &visits, g_allocator));
+      std::set<std::string> expected = {
+        "dummy.dummy",
+        "dummy-subfolder",
+        "dummy-subfolder/dummy.dummy",
+        "dummy-subfolder/dummy-subfolder",
+      };
+      EXPECT_EQ(expected, visits.paths());
+      options.max_depth = 0u;
+    }
+    {
+      // The directories are descended into, but not visited
+      options.include_pattern = "*.dum?y";
+      options.stat_entries = true;
+      DirWalkVisits visits;
+      visits.prefix = path;
+      EXPECT_EQ(
+        RCUTILS_RET_OK,
+        rcutils_dir_walk(path, &options, DirWalkVisits::visit, &visits, g_allocator));
+      std::set<std::string> expected = {
+        "dummy.dummy",
+        "dummy-subfolder/dummy.dummy",
+        "dummy-subfolder/dummy-subfolder/dummy.dummy",
+      };
+      EXPECT_EQ(expected, visits.paths());
+      uint64_t size = 0u;
+      for (const auto & entry : visits.entries) {
+        size += entry.second.size;
+        EXPECT_GT(entry.second.mtime, 0);
+      }
+#ifdef WIN32
+      // Due to different line breaks on windows, we have one more byte in the files.
+      EXPECT_EQ(18u, size);
+#else
+      EXPECT_EQ(15u, size);
+#endif
+      options.include_pattern = nullptr;
+      options.stat_entries = false;
+    }
+    {
+      // The directories excluded are pruned
+      options.exclude_pattern = "*-[r-t]ubfolder";
+      DirWalkVisits visits;
+      visits.prefix = path;
+      EXPECT_EQ(
+        RCUTILS_RET_OK,
+        rcutils_dir_walk(path, &options, DirWalkVisits::visit, &visits, g_allocator));
+      EXPECT_EQ(std::set<std::string>({"dummy.dummy"}), visits.paths());
+      options.exclude_pattern = "[!d]*";
+      visits.entries.clear();
+      EXPECT_EQ(
+        RCUTILS_RET_OK,
+        rcutils_dir_walk(path, &options, DirWalkVisits::visit, &visits, g_allocator));
+      EXPECT_EQ(5u, visits.entries.size());
+      options.exclude_pattern = nullptr;
+    }
+    {
+      DirWalkVisits visits;
+      visits.prefix = path;
+      visits.action = RCUTILS_DIR_WALK_PRUNE;
+      visits.action_name = "dummy-subfolder/dummy-subfolder";
+      EXPECT_EQ(
+        RCUTILS_RET_OK,
+        rcutils_dir_walk(path, &options, DirWalkVisits::visit, &visits, g_allocator));
+      std::set<std::string> expected = {
+        "dummy.dummy",
+        "dummy-subfolder",
+        "dummy-subfolder/dummy.dummy",
+        "dummy-subfolder/dummy-subfolder",
+      };
+      EXPECT_EQ(expected, visits.paths());
+    }
+  }
+
+  {
+    DirWalkVisits visits;
+    visits.prefix = path;
+    visits.action = RCUTILS_DIR_WALK_STOP;
+    EXPECT_EQ(
+      RCUTILS_RET_OK, rcutils_dir_walk(path, nullptr, DirWalkVisits::visit, &visits, g_allocator));
+    EXPECT_EQ(1u, visits.entries.size());
+  }
+}
+
+TEST_F(TestFilesystemFixture, dir_walk_in_parallel) {
+  // A tree wide and deep enough for the threads to share it
+  std::string path = std::string(BUILD_DIR) + "/dir_walk_test_dir";
+  ASSERT_TRUE(rcutils_mkdir(path.c_str()));
+  std::set<std::string> expected;
+  for (size_t i = 0u; i < 16u; ++i) {
+    std::string dir = "dir" + std::to_string(i);
+    for (size_t depth = 0u; depth < 3u; ++depth) {
+      ASSERT_TRUE(rcutils_mkdir((path + "/" + dir).c_str()));
+      expected.insert(dir);
+      for (size_t j = 0u; j < 4u; ++j) {
+        std::string file = dir + "/file" + std::to_string(j) + ".txt";
+        FILE * stream = std::fopen((path + "/" + file).c_str(), "w");
+        ASSERT_NE(nullptr, stream);
+        std::fclose(stream);
+        expected.insert(file);
+      }
+      dir += "/sub";
+    }
+  }
+
+  rcutils_dir_walk_options_t options = rcutils_dir_walk_get_default_options();
+  for (size_t threads : {1u, 2u, 8u}) {
+    options.threads = threads;
+    DirWalkVisits visits;
+    visits.prefix = path;
+    EXPECT_EQ(
+      RCUTILS_RET_OK,
+      rcutils_dir_walk(path.c_str(), &options, DirWalkVisits::visit, &visits, g_allocator));
+    EXPECT_EQ(expected, visits.paths());
+  }
+
+  // Stopping doesn't leak the directories left to the threads
+  options.threads = 4u;
+  DirWalkVisits visits;
+  visits.prefix = path;
+  visits.action = RCUTILS_DIR_WALK_STOP;
+  EXPECT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_dir_walk(path.c_str(), &options, DirWalkVisits::visit, &visits, g_allocator));
+  EXPECT_LE(1u, visits.entries.size());
+  EXPECT_GT(expected.size(), visits.entries.size());
+}
+
+TEST_F(TestFilesystemFixture, dir_walk_invalid_arguments) {
+  DirWalkVisits visits;
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_dir_walk(nullptr, nullptr, DirWalkVisits::visit, &visits, g_allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_dir_walk(this->test_path, nullptr, nullptr, &visits, g_allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_dir_walk(
+      this->test_path, nullptr, DirWalkVisits::visit, &visits,
+      rcutils_get_zero_initialized_allocator()));
+  rcutils_reset_error();
+
+  char * non_existing_path = rcutils_join_path(this->test_path, "non_existing_folder", g_allocator);
+  ASSERT_NE(nullptr, non_existing_path);
+  EXPECT_EQ(
+    RCUTILS_RET_ERROR,
+    rcutils_dir_walk(non_existing_path, nullptr, DirWalkVisits::visit, &visits, g_allocator));
+  rcutils_reset_error();
+  g_allocator.deallocate(non_existing_path, g_allocator.state);
+  EXPECT_TRUE(visits.entries.empty());
+}
+
+TEST_F(TestFilesystemFixture, file_watcher) {
+  rcutils_file_watcher_t watcher = rcutils_get_zero_initialized_file_watcher();
+  int32_t watch_id = -1;
+  EXPECT_EQ(
+    RCUTILS_RET_NOT_INITIALIZED,
+    rcutils_file_watcher_add_watch(&watcher, this->test_path, RCUTILS_FILE_WATCH_ALL, &watch_id));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_file_watcher_init(&watcher, nullptr));
+  rcutils_reset_error();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_file_watcher_init(&watcher, &g_allocator));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_file_watcher_fini(&watcher));
+  });
+
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_file_watcher_add_watch(&watcher, this->test_path, 0u, &watch_id));
+  rcutils_reset_error();
+  char * non_existing_path =
+    rcutils_join_path(this->test_path, "non_existing_folder", g_allocator);
+  ASSERT_NE(nullptr, non_existing_path);
+  EXPECT_EQ(
+    RCUTILS_RET_NOT_FOUND,
+    rcutils_file_watcher_add_watch(
+      &watcher, non_existing_path, RCUTILS_FILE_WATCH_ALL, &watch_id));
+  rcutils_reset_error();
+  g_allocator.deallocate(non_existing_path, g_allocator.state);
+
+  char * path = rcutils_join_path(BUILD_DIR, "file_watch_test_dir", g_allocator);
+  ASSERT_NE(nullptr, path);
+  char * file_path = rcutils_join_path(path, "watched.txt", g_allocator);
+  ASSERT_NE(nullptr, file_path);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    std::remove(file_path);
+    g_allocator.deallocate(file_path, g_allocator.state);
+    g_allocator.deallocate(path, g_allocator.state);
+  });
+  ASSERT_TRUE(rcutils_mkdir(path));
+  std::remove(file_path);
+
+  ASSERT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_file_watcher_add_watch(&watcher, path, RCUTILS_FILE_WATCH_ALL, &watch_id));
+
+  // Nothing changed yet.
+  size_t event_count = 1u;
+  file_watch_events_t events;
+  EXPECT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_file_watcher_read(&watcher, 0, collect_file_watch_event, &events, &event_count));
+  EXPECT_EQ(0u, event_count);
+  EXPECT_TRUE(events.empty());
+
+  FILE * file = std::fopen(file_path, "w");
+  ASSERT_NE(nullptr, file);
+  std::fputs("contents", file);
+  std::fclose(file);
+#ifdef __APPLE__
+  // kqueue only reports that the entries of the directory changed.
+  EXPECT_TRUE(read_file_watch_event(&watcher, RCUTILS_FILE_WATCH_MODIFIED, ""));
+#else
+  EXPECT_TRUE(read_file_watch_event(&watcher, RCUTILS_FILE_WATCH_CREATED, "watched.txt"));
+#endif
+
+  // A watched file reports its own changes, without a name.
+  int32_t file_watch_id = -1;
+  ASSERT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_file_watcher_add_watch(
+      &watcher, file_path, RCUTILS_FILE_WATCH_MODIFIED, &file_watch_id));
+  file = std::fopen(file_path, "a");
+  ASSERT_NE(nullptr, file);
+  std::fputs(" appended", file);
+  std::fclose(file);
+  EXPECT_TRUE(read_file_watch_event(&watcher, RCUTILS_FILE_WATCH_MODIFIED, ""));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_file_watcher_remove_watch(&watcher, file_watch_id));
+
+  ASSERT_EQ(0, std::remove(file_path));
+#ifdef __APPLE__
+  EXPECT_TRUE(read_file_watch_event(&watcher, RCUTILS_FILE_WATCH_MODIFIED, ""));
+#else
+  EXPECT_TRUE(read_file_watch_event(&watcher, RCUTILS_FILE_WATCH_DELETED, "watched.txt"));
+#endif
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_file_watcher_remove_watch(&watcher, watch_id));
+  EXPECT_EQ(RCUTILS_RET_NOT_FOUND, rcutils_file_watcher_remove_watch(&watcher, watch_id));
+  rcutils_reset_error();
+}
+
+#ifndef _WIN32
+TEST_F(TestFilesystemFixture, file_watcher_fd) {
+  rcutils_file_watcher_t watcher = rcutils_get_zero_initialized_file_watcher();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_file_watcher_init(&watcher, &g_allocator));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_file_watcher_fini(&watcher));
+  });
+  int fd = -1;
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_file_watcher_get_fd(&watcher, &fd));
+  EXPECT_LE(0, fd);
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_file_watcher_get_fd(&watcher, nullptr));
+  rcutils_reset_error();
+  // Finalizing twice does nothing the second time.
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_file_watcher_fini(&watcher));
+}
+#endif
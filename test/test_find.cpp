@@ -14,8 +14,11 @@
 
 #include <stdint.h>
 
+#include <string>
+
 #include "gtest/gtest.h"
 
+#include "rcutils/error_handling.h"
 #include "rcutils/find.h"
 
 #define ENABLE_LOGGING 1
@@ -153,3 +156,96 @@ TEST(test_find, find_lastn) {
     "hello/world///", '/', strlen("hello/world/"), strlen("hello/world/") - 1);
   LOG((size_t)strlen("hello/world/") - 1, ret5);
 }
+
+TEST(test_find, long_strings) {
+  // Long enough for the searches to go through whole words and vectors
+  std::string str(1000u, 'a');
+  EXPECT_EQ(SIZE_MAX, rcutils_find(str.c_str(), '/'));
+  EXPECT_EQ(SIZE_MAX, rcutils_find_last(str.c_str(), '/'));
+  EXPECT_EQ(SIZE_MAX, rcutils_find(str.c_str(), '\0'));
+  EXPECT_EQ(SIZE_MAX, rcutils_find_last(str.c_str(), '\0'));
+  for (size_t position : {0u, 1u, 7u, 8u, 9u, 63u, 500u, 998u, 999u}) {
+    for (char delimiter : {'/', static_cast<char>(0xFF)}) {
+      std::string found = str;
+      found[position] = delimiter;
+      EXPECT_EQ(position, rcutils_find(found.c_str(), delimiter));
+      EXPECT_EQ(position, rcutils_findn(found.c_str(), delimiter, found.size()));
+      EXPECT_EQ(position, rcutils_find_last(found.c_str(), delimiter));
+      EXPECT_EQ(position, rcutils_find_lastn(found.c_str(), delimiter, found.size()));
+      // Only the first bytes are searched
+      EXPECT_EQ(SIZE_MAX, rcutils_findn(found.c_str(), delimiter, position));
+      EXPECT_EQ(SIZE_MAX, rcutils_find_lastn(found.c_str(), delimiter, position));
+
+      found[999u - position] = delimiter;
+      size_t first = position < 999u - position ? position : 999u - position;
+      EXPECT_EQ(first, rcutils_find(found.c_str(), delimiter));
+      EXPECT_EQ(999u - first, rcutils_find_last(found.c_str(), delimiter));
+      EXPECT_EQ(999u - first, rcutils_find_lastn(found.c_str(), delimiter, found.size()));
+    }
+  }
+}
+
+TEST(test_find, find_any) {
+  EXPECT_EQ(SIZE_MAX, rcutils_find_any(NULL, "{}"));
+  EXPECT_EQ(SIZE_MAX, rcutils_find_any("{a}", NULL));
+  EXPECT_EQ(SIZE_MAX, rcutils_find_any("{a}", ""));
+  EXPECT_EQ(SIZE_MAX, rcutils_find_any("", "{}"));
+  EXPECT_EQ(SIZE_MAX, rcutils_find_any("hello_world", "{}"));
+  EXPECT_EQ(0u, rcutils_find_any("{a}", "{}"));
+  EXPECT_EQ(1u, rcutils_find_any("a:=b", "=:"));
+  EXPECT_EQ(2u, rcutils_find_any("ab=:", "=:"));
+  EXPECT_EQ(5u, rcutils_find_any("hello}{", "{}"));
+
+  rcutils_char_set_t set;
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_char_set_init(NULL, "{}"));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_char_set_init(&set, NULL));
+  rcutils_reset_error();
+
+  const char high[] = {'a', static_cast<char>(0xC3), static_cast<char>(0xFF), '\0'};
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_char_set_init(&set, high + 1));
+  EXPECT_EQ(1u, rcutils_find_anyn(high, &set, 3u));
+  EXPECT_EQ(SIZE_MAX, rcutils_find_anyn(high, &set, 1u));
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_char_set_init(&set, "{}"));
+  EXPECT_EQ(SIZE_MAX, rcutils_find_anyn(NULL, &set, 3u));
+  EXPECT_EQ(SIZE_MAX, rcutils_find_anyn("{a}", NULL, 3u));
+  EXPECT_EQ(SIZE_MAX, rcutils_find_anyn("{a}", &set, 0u));
+  EXPECT_EQ(SIZE_MAX, rcutils_find_anyn("a:=b", &set, 4u));
+  EXPECT_EQ(1u, rcutils_find_anyn("a}{", &set, 3u));
+  // The terminator is not special
+  EXPECT_EQ(2u, rcutils_find_anyn("a\0}", &set, 3u));
+  EXPECT_EQ(SIZE_MAX, rcutils_find_anyn("a}", &set, 1u));
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_char_set_init(&set, ""));
+  EXPECT_EQ(SIZE_MAX, rcutils_find_anyn("a}{", &set, 3u));
+}
+
+TEST(test_find, find_str) {
+  EXPECT_EQ(SIZE_MAX, rcutils_find_str(NULL, "__ns"));
+  EXPECT_EQ(SIZE_MAX, rcutils_find_str("__ns", NULL));
+  EXPECT_EQ(SIZE_MAX, rcutils_find_str("__ns", ""));
+  EXPECT_EQ(SIZE_MAX, rcutils_find_str("", "__ns"));
+  EXPECT_EQ(SIZE_MAX, rcutils_find_str("__n", "__ns"));
+  EXPECT_EQ(0u, rcutils_find_str("__ns:=/foo", "__ns"));
+  EXPECT_EQ(4u, rcutils_find_str("__ns:=/foo", ":="));
+  EXPECT_EQ(5u, rcutils_find_str("__ns __node", "__node"));
+  EXPECT_EQ(2u, rcutils_find_str("aaaab", "aab"));
+
+  EXPECT_EQ(SIZE_MAX, rcutils_find_strn(NULL, ":=", 10u));
+  EXPECT_EQ(SIZE_MAX, rcutils_find_strn("__ns:=/foo", NULL, 10u));
+  EXPECT_EQ(SIZE_MAX, rcutils_find_strn("__ns:=/foo", "", 10u));
+  EXPECT_EQ(4u, rcutils_find_strn("__ns:=/foo", ":=", 10u));
+  EXPECT_EQ(4u, rcutils_find_strn("__ns:=/foo", ":=", 6u));
+  // Only the first characters are searched
+  EXPECT_EQ(SIZE_MAX, rcutils_find_strn("__ns:=/foo", ":=", 5u));
+  EXPECT_EQ(SIZE_MAX, rcutils_find_strn("__ns:=/foo", ":=", 1u));
+  EXPECT_EQ(2u, rcutils_find_strn("aaaab", "aab", 5u));
+  EXPECT_EQ(3u, rcutils_find_strn("a\0a:=", ":=", 5u));
+
+  std::string str(1000u, 'a');
+  str.replace(990u, 3u, "abc");
+  EXPECT_EQ(990u, rcutils_find_str(str.c_str(), "abc"));
+  EXPECT_EQ(990u, rcutils_find_strn(str.c_str(), "abc", str.size()));
+  EXPECT_EQ(SIZE_MAX, rcutils_find_strn(str.c_str(), "abc", 992u));
+}
@@ -14,13 +14,16 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdarg>
 #include <string>
 
 #include "./allocator_testing_utils.h"
 #include "./mocking_utils/patch.hpp"
 
 #include "rcutils/allocator.h"
+#include "rcutils/error_handling.h"
 #include "rcutils/format_string.h"
+#include "rcutils/types/char_array.h"
 
 TEST(test_format_string_limit, nominal) {
   {
@@ -61,3 +64,122 @@ TEST(test_format_string_limit, invalid_arguments) {
   formatted = rcutils_format_string_limit(failing_allocator, 10, "%s", "test");
   EXPECT_STREQ(NULL, formatted);
 }
+
+TEST(test_format_string_limit, longer_than_stack_buffer) {
+  auto allocator = rcutils_get_default_allocator();
+  std::string long_string(1000, 'x');
+  char * formatted = rcutils_format_string_limit(allocator, 2048, "<%s>", long_string.c_str());
+  EXPECT_EQ("<" + long_string + ">", formatted);
+  allocator.deallocate(formatted, allocator.state);
+
+  formatted = rcutils_format_string_limit(allocator, 500, "<%s>", long_string.c_str());
+  EXPECT_EQ("<" + long_string.substr(0, 498), formatted);
+  allocator.deallocate(formatted, allocator.state);
+
+  // Just fitting in the stack buffer, then one character over
+  for (size_t length : {254u, 255u, 256u, 257u}) {
+    formatted = rcutils_format_string_limit(
+      allocator, 2048, "%s", long_string.c_str() + 1000 - length);
+    EXPECT_EQ(long_string.substr(0, length), formatted);
+    allocator.deallocate(formatted, allocator.state);
+  }
+}
+
+static char * vformat(rcutils_allocator_t allocator, size_t limit, const char * format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  char * formatted = rcutils_vformat_string_limit(allocator, limit, format, args);
+  // The arguments can be used again
+  char * again = rcutils_vformat_string_limit(allocator, limit, format, args);
+  va_end(args);
+  EXPECT_STREQ(formatted, again);
+  if (again) {
+    allocator.deallocate(again, allocator.state);
+  }
+  return formatted;
+}
+
+TEST(test_format_string_limit, vformat) {
+  auto allocator = rcutils_get_default_allocator();
+  char * formatted = vformat(allocator, 10, "%s %d", "test", 42);
+  EXPECT_STREQ("test 42", formatted);
+  allocator.deallocate(formatted, allocator.state);
+
+  std::string long_string(300, 'y');
+  formatted = vformat(allocator, 2048, "%s %d", long_string.c_str(), 42);
+  EXPECT_EQ(long_string + " 42", formatted);
+  allocator.deallocate(formatted, allocator.state);
+
+  EXPECT_EQ(nullptr, vformat(allocator, 0, "%s", "test"));
+  EXPECT_EQ(nullptr, vformat(get_failing_allocator(), 10, "%s", "test"));
+}
+
+TEST(test_format_string_limit, char_array) {
+  auto allocator = rcutils_get_default_allocator();
+  rcutils_char_array_t char_array = rcutils_get_zero_initialized_char_array();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_char_array_init(&char_array, 0, &allocator));
+
+  EXPECT_EQ(
+    RCUTILS_RET_OK, rcutils_format_string_limit_char_array(&char_array, 10, "%s", "test"));
+  EXPECT_STREQ("test", char_array.buffer);
+  EXPECT_EQ(5u, char_array.buffer_length);
+
+  EXPECT_EQ(
+    RCUTILS_RET_OK, rcutils_format_string_limit_char_array(&char_array, 3, "%s", "test"));
+  EXPECT_STREQ("te", char_array.buffer);
+  EXPECT_EQ(3u, char_array.buffer_length);
+
+  std::string long_string(300, 'z');
+  EXPECT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_format_string_limit_char_array(&char_array, 2048, "%s!", long_string.c_str()));
+  EXPECT_EQ(long_string + "!", char_array.buffer);
+  EXPECT_EQ(302u, char_array.buffer_length);
+
+  // Shorter strings reuse the buffer
+  char * buffer = char_array.buffer;
+  size_t capacity = char_array.buffer_capacity;
+  EXPECT_EQ(
+    RCUTILS_RET_OK, rcutils_format_string_limit_char_array(&char_array, 2048, "%d", 1234));
+  EXPECT_STREQ("1234", char_array.buffer);
+  EXPECT_EQ(5u, char_array.buffer_length);
+  EXPECT_EQ(buffer, char_array.buffer);
+  EXPECT_EQ(capacity, char_array.buffer_capacity);
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_fini(&char_array));
+}
+
+TEST(test_format_string_limit, char_array_invalid_arguments) {
+  auto allocator = rcutils_get_default_allocator();
+  rcutils_char_array_t char_array = rcutils_get_zero_initialized_char_array();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_char_array_init(&char_array, 0, &allocator));
+
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_format_string_limit_char_array(nullptr, 10, "%d", 1));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_format_string_limit_char_array(&char_array, 10, NULL));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_format_string_limit_char_array(&char_array, 0, "%d", 1));
+  rcutils_reset_error();
+
+  char_array.max_capacity = 4;
+  EXPECT_EQ(
+    RCUTILS_RET_NOT_ENOUGH_SPACE,
+    rcutils_format_string_limit_char_array(&char_array, 10, "%s", "test"));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_OK, rcutils_format_string_limit_char_array(&char_array, 10, "%s", "abc"));
+  EXPECT_STREQ("abc", char_array.buffer);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_fini(&char_array));
+
+  auto failing_allocator = get_failing_allocator();
+  char_array = rcutils_get_zero_initialized_char_array();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_char_array_init(&char_array, 0, &failing_allocator));
+  EXPECT_EQ(
+    RCUTILS_RET_BAD_ALLOC, rcutils_format_string_limit_char_array(&char_array, 10, "%s", "test"));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_fini(&char_array));
+}
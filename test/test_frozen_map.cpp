@@ -0,0 +1,123 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "./allocator_testing_utils.h"
+#include "rcutils/allocator.h"
+#include "rcutils/error_handling.h"
+
+#include "rcutils/types/frozen_map.h"
+
+static const char * const severities[] = {"DEBUG", "INFO", "WARN", "ERROR", "FATAL"};
+
+TEST(test_frozen_map, init_fini) {
+  auto map = rcutils_get_zero_initialized_frozen_map();
+  auto allocator = rcutils_get_default_allocator();
+
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_frozen_map_init(nullptr, severities, 5, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_frozen_map_init(&map, nullptr, 5, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_frozen_map_init(&map, severities, 0, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_frozen_map_init(&map, severities, 5, nullptr));
+  rcutils_reset_error();
+  const char * const repeated[] = {"a", "b", "a"};
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_frozen_map_init(&map, repeated, 3, &allocator));
+  rcutils_reset_error();
+  const char * const with_null[] = {"a", nullptr};
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_frozen_map_init(&map, with_null, 2, &allocator));
+  rcutils_reset_error();
+  rcutils_allocator_t failing_allocator = get_failing_allocator();
+  EXPECT_EQ(
+    RCUTILS_RET_BAD_ALLOC, rcutils_frozen_map_init(&map, severities, 5, &failing_allocator));
+  rcutils_reset_error();
+
+  size_t index = 0;
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_frozen_map_findn(&map, "INFO", 4, &index));
+  rcutils_reset_error();
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_frozen_map_init(&map, severities, 5, &allocator));
+  EXPECT_EQ(5u, map.key_count);
+  EXPECT_EQ(16u, map.slot_count);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_frozen_map_fini(&map));
+  EXPECT_EQ(nullptr, map.slots);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_frozen_map_fini(&map));
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_frozen_map_fini(nullptr));
+  rcutils_reset_error();
+}
+
+TEST(test_frozen_map, findn) {
+  auto map = rcutils_get_zero_initialized_frozen_map();
+  auto allocator = rcutils_get_default_allocator();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_frozen_map_init(&map, severities, 5, &allocator));
+
+  size_t index = 42;
+  for (size_t i = 0; i < 5; ++i) {
+    EXPECT_EQ(
+      RCUTILS_RET_OK,
+      rcutils_frozen_map_findn(&map, severities[i], strlen(severities[i]), &index));
+    EXPECT_EQ(i, index);
+  }
+  // The string needn't be null terminated
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_frozen_map_findn(&map, "WARNING", 4, &index));
+  EXPECT_EQ(2u, index);
+
+  index = 42;
+  EXPECT_EQ(RCUTILS_RET_NOT_FOUND, rcutils_frozen_map_findn(&map, "WARNING", 7, &index));
+  EXPECT_EQ(RCUTILS_RET_NOT_FOUND, rcutils_frozen_map_findn(&map, "info", 4, &index));
+  EXPECT_EQ(RCUTILS_RET_NOT_FOUND, rcutils_frozen_map_findn(&map, "INF", 3, &index));
+  EXPECT_EQ(RCUTILS_RET_NOT_FOUND, rcutils_frozen_map_findn(&map, "", 0, &index));
+  EXPECT_EQ(RCUTILS_RET_NOT_FOUND, rcutils_frozen_map_findn(&map, "IN\0O", 4, &index));
+  EXPECT_EQ(42u, index);
+
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_frozen_map_findn(nullptr, "INFO", 4, &index));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_frozen_map_findn(&map, nullptr, 4, &index));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_frozen_map_findn(&map, "INFO", 4, nullptr));
+  rcutils_reset_error();
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_frozen_map_fini(&map));
+}
+
+TEST(test_frozen_map, many_keys) {
+  std::vector<std::string> names;
+  for (size_t i = 0; i < 200; ++i) {
+    names.push_back("key_" + std::to_string(i));
+  }
+  std::vector<const char *> keys;
+  for (const auto & name : names) {
+    keys.push_back(name.c_str());
+  }
+
+  auto map = rcutils_get_zero_initialized_frozen_map();
+  auto allocator = rcutils_get_default_allocator();
+  ASSERT_EQ(
+    RCUTILS_RET_OK, rcutils_frozen_map_init(&map, keys.data(), keys.size(), &allocator));
+  for (size_t i = 0; i < keys.size(); ++i) {
+    size_t index = 0;
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_frozen_map_findn(&map, keys[i], names[i].size(), &index));
+    EXPECT_EQ(i, index);
+  }
+  size_t index = 0;
+  EXPECT_EQ(RCUTILS_RET_NOT_FOUND, rcutils_frozen_map_findn(&map, "key_200", 7, &index));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_frozen_map_fini(&map));
+}
@@ -14,7 +14,10 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <set>
 #include <string>
+#include <vector>
 
 #include "./time_bomb_allocator_testing_utils.h"
 #include "rcutils/allocator.h"
@@ -33,7 +36,7 @@ int test_uint32_cmp(const void * val1, const void * val2)
   const uint32_t * cval2 = (const uint32_t *)val2;
   if (*cval1 < *cval2) {
     return -1;
-  } else if (*cval2 > *cval1) {
+  } else if (*cval1 > *cval2) {
     return 1;
   } else {
     return 0;
@@ -499,3 +502,762 @@ TEST_F(HashMapBaseTest, string_keys) {
   ret = rcutils_hash_map_fini(&map);
   EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
 }
+
+static rcutils_hash_map_options_t get_open_addressing_options()
+{
+  rcutils_hash_map_options_t options = rcutils_hash_map_get_default_options();
+  options.backend = RCUTILS_HASH_MAP_BACKEND_OPEN_ADDRESSING;
+  return options;
+}
+
+TEST_F(HashMapBaseTest, init_with_options_invalid_options_fails) {
+  rcutils_hash_map_options_t options = rcutils_hash_map_get_default_options();
+  EXPECT_EQ(RCUTILS_HASH_MAP_BACKEND_CHAINING, options.backend);
+  rcutils_ret_t ret = rcutils_hash_map_init_with_options(
+    &map, 2, sizeof(uint32_t), sizeof(uint32_t),
+    test_hash_map_uint32_hash_func, test_uint32_cmp, NULL, &allocator);
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, ret) << rcutils_get_error_string().str;
+  rcutils_reset_error();
+
+  options.backend = static_cast<rcutils_hash_map_backend_t>(42);
+  ret = rcutils_hash_map_init_with_options(
+    &map, 2, sizeof(uint32_t), sizeof(uint32_t),
+    test_hash_map_uint32_hash_func, test_uint32_cmp, &options, &allocator);
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, ret) << rcutils_get_error_string().str;
+  rcutils_reset_error();
+
+  const double invalid_load_factors[] = {0.0, -1.0, NAN};
+  for (double load_factor : invalid_load_factors) {
+    options = rcutils_hash_map_get_default_options();
+    options.max_load_factor = load_factor;
+    ret = rcutils_hash_map_init_with_options(
+      &map, 2, sizeof(uint32_t), sizeof(uint32_t),
+      test_hash_map_uint32_hash_func, test_uint32_cmp, &options, &allocator);
+    EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, ret) << load_factor;
+    rcutils_reset_error();
+  }
+  // Open addressing needs free slots.
+  options = get_open_addressing_options();
+  options.max_load_factor = 1.0;
+  ret = rcutils_hash_map_init_with_options(
+    &map, 2, sizeof(uint32_t), sizeof(uint32_t),
+    test_hash_map_uint32_hash_func, test_uint32_cmp, &options, &allocator);
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, ret) << rcutils_get_error_string().str;
+  rcutils_reset_error();
+
+  const double invalid_growth_factors[] = {1.0, 0.5, NAN};
+  for (double growth_factor : invalid_growth_factors) {
+    options = rcutils_hash_map_get_default_options();
+    options.growth_factor = growth_factor;
+    ret = rcutils_hash_map_init_with_options(
+      &map, 2, sizeof(uint32_t), sizeof(uint32_t),
+      test_hash_map_uint32_hash_func, test_uint32_cmp, &options, &allocator);
+    EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, ret) << growth_factor;
+    rcutils_reset_error();
+  }
+
+  options = get_open_addressing_options();
+  options.rehash_buckets_per_operation = 1;
+  ret = rcutils_hash_map_init_with_options(
+    &map, 2, sizeof(uint32_t), sizeof(uint32_t),
+    test_hash_map_uint32_hash_func, test_uint32_cmp, &options, &allocator);
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, ret) << rcutils_get_error_string().str;
+  rcutils_reset_error();
+
+  // A shrunk map must not be below the minimum load factor.
+  const double invalid_min_load_factors[] = {-0.1, 0.375, 0.5, NAN};
+  for (double min_load_factor : invalid_min_load_factors) {
+    options = rcutils_hash_map_get_default_options();
+    options.min_load_factor = min_load_factor;
+    ret = rcutils_hash_map_init_with_options(
+      &map, 2, sizeof(uint32_t), sizeof(uint32_t),
+      test_hash_map_uint32_hash_func, test_uint32_cmp, &options, &allocator);
+    EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, ret) << min_load_factor;
+    rcutils_reset_error();
+  }
+
+  // A chained map may be fuller than its capacity.
+  options = rcutils_hash_map_get_default_options();
+  options.max_load_factor = 4.0;
+  ret = rcutils_hash_map_init_with_options(
+    &map, 2, sizeof(uint32_t), sizeof(uint32_t),
+    test_hash_map_uint32_hash_func, test_uint32_cmp, &options, &allocator);
+  ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  ret = rcutils_hash_map_fini(&map);
+  EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+}
+
+TEST_F(HashMapBaseTest, open_addressing_failing_allocator) {
+  rcutils_allocator_t failing_allocator = get_time_bomb_allocator();
+  // Check allocating the slots fails
+  set_time_bomb_allocator_malloc_count(failing_allocator, 1);
+  rcutils_hash_map_options_t options = get_open_addressing_options();
+  rcutils_ret_t ret = rcutils_hash_map_init_with_options(
+    &map, 2, sizeof(uint32_t), sizeof(uint32_t),
+    test_hash_map_uint32_hash_func, test_uint32_cmp,
+    &options, &failing_allocator);
+  EXPECT_EQ(RCUTILS_RET_BAD_ALLOC, ret) << rcutils_get_error_string().str;
+  rcutils_reset_error();
+
+  // The map keeps working with its slots when it can't grow.
+  set_time_bomb_allocator_malloc_count(failing_allocator, 2);
+  ret = rcutils_hash_map_init_with_options(
+    &map, 16, sizeof(uint32_t), sizeof(uint32_t),
+    test_hash_map_uint32_hash_func, test_uint32_cmp,
+    &options, &failing_allocator);
+  ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  for (uint32_t i = 0; i < 13; ++i) {
+    ret = rcutils_hash_map_set(&map, &i, &i);
+    EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  }
+  size_t capacity = 0;
+  ret = rcutils_hash_map_get_capacity(&map, &capacity);
+  EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  EXPECT_EQ(16u, capacity);
+  for (uint32_t i = 0; i < 13; ++i) {
+    uint32_t data = 0;
+    ret = rcutils_hash_map_get(&map, &i, &data);
+    EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    EXPECT_EQ(i, data);
+  }
+  uint32_t key = 13;
+  EXPECT_FALSE(rcutils_hash_map_key_exists(&map, &key));
+
+  ret = rcutils_hash_map_fini(&map);
+  EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+}
+
+// Collides a lot, so that entries are probed and shifted across many slots
+size_t test_hash_map_colliding_hash_func(const void * key)
+{
+  return *reinterpret_cast<const uint32_t *>(key) % 5;
+}
+
+TEST_F(HashMapBaseTest, open_addressing_set_get_unset) {
+  rcutils_hash_map_options_t options = get_open_addressing_options();
+  rcutils_ret_t ret = rcutils_hash_map_init_with_options(
+    &map, 3, sizeof(uint32_t), sizeof(uint64_t),
+    test_hash_map_colliding_hash_func, test_uint32_cmp,
+    &options, &allocator);
+  ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+
+  size_t capacity = 0;
+  ret = rcutils_hash_map_get_capacity(&map, &capacity);
+  EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  // There are at least 16 slots.
+  EXPECT_EQ(16u, capacity);
+
+  for (uint32_t i = 0; i < 100; ++i) {
+    uint64_t data = i * 10u;
+    ret = rcutils_hash_map_set(&map, &i, &data);
+    EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  }
+  // Updating an existing key keeps the size
+  uint32_t key = 7;
+  uint64_t data = 42;
+  ret = rcutils_hash_map_set(&map, &key, &data);
+  EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+
+  size_t size = 0;
+  ret = rcutils_hash_map_get_size(&map, &size);
+  EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  EXPECT_EQ(100u, size);
+  ret = rcutils_hash_map_get_capacity(&map, &capacity);
+  EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  EXPECT_EQ(256u, capacity);
+
+  // Remove every third key, the others must still be found
+  for (uint32_t i = 0; i < 100; i += 3) {
+    ret = rcutils_hash_map_unset(&map, &i);
+    EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  }
+  key = 1000;
+  ret = rcutils_hash_map_unset(&map, &key);
+  EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  ret = rcutils_hash_map_get_size(&map, &size);
+  EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  EXPECT_EQ(66u, size);
+
+  for (uint32_t i = 0; i < 100; ++i) {
+    data = 0;
+    ret = rcutils_hash_map_get(&map, &i, &data);
+    if (0 == i % 3) {
+      EXPECT_EQ(RCUTILS_RET_NOT_FOUND, ret) << i;
+      EXPECT_FALSE(rcutils_hash_map_key_exists(&map, &i)) << i;
+    } else {
+      EXPECT_EQ(RCUTILS_RET_OK, ret) << i;
+      EXPECT_EQ(7u == i ? 42u : i * 10u, data) << i;
+    }
+  }
+
+  ret = rcutils_hash_map_fini(&map);
+  EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+}
+
+TEST_F(HashMapBaseTest, open_addressing_get_next_key_and_data) {
+  rcutils_hash_map_options_t options = get_open_addressing_options();
+  rcutils_ret_t ret = rcutils_hash_map_init_with_options(
+    &map, 2, sizeof(uint32_t), sizeof(uint32_t),
+    test_hash_map_colliding_hash_func, test_uint32_cmp,
+    &options, &allocator);
+  ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+
+  uint32_t key = 0, data = 0;
+  ret = rcutils_hash_map_get_next_key_and_data(&map, NULL, &key, &data);
+  EXPECT_EQ(RCUTILS_RET_HASH_MAP_NO_MORE_ENTRIES, ret) << rcutils_get_error_string().str;
+
+  for (uint32_t i = 0; i < 20; ++i) {
+    uint32_t value = i + 100;
+    ret = rcutils_hash_map_set(&map, &i, &value);
+    EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  }
+  key = 1000;
+  ret = rcutils_hash_map_get_next_key_and_data(&map, &key, &key, &data);
+  EXPECT_EQ(RCUTILS_RET_NOT_FOUND, ret) << rcutils_get_error_string().str;
+
+  // Every entry is visited once
+  uint32_t visited = 0;
+  size_t count = 0;
+  ret = rcutils_hash_map_get_next_key_and_data(&map, NULL, &key, &data);
+  while (RCUTILS_RET_OK == ret) {
+    EXPECT_EQ(key + 100, data);
+    EXPECT_EQ(0u, visited & (1u << key)) << key;
+    visited |= 1u << key;
+    ++count;
+    ret = rcutils_hash_map_get_next_key_and_data(&map, &key, &key, &data);
+  }
+  EXPECT_EQ(RCUTILS_RET_HASH_MAP_NO_MORE_ENTRIES, ret) << rcutils_get_error_string().str;
+  EXPECT_EQ(20u, count);
+  EXPECT_EQ((1u << 20) - 1, visited);
+
+  ret = rcutils_hash_map_fini(&map);
+  EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+}
+
+TEST_F(HashMapBaseTest, open_addressing_string_keys) {
+  uint32_t data = 1, ret_data = 0;
+  const char * key1 = "one";
+  const char * key2 = "two";
+  std::string lookup_key_storage = "one";
+  const char * lookup_key = lookup_key_storage.c_str();
+  rcutils_hash_map_options_t options = get_open_addressing_options();
+  rcutils_ret_t ret = rcutils_hash_map_init_with_options(
+    &map, 10, sizeof(char *), sizeof(uint32_t),
+    rcutils_hash_map_string_hash_func, rcutils_hash_map_string_cmp_func,
+    &options, &allocator);
+  ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+
+  ret = rcutils_hash_map_set(&map, &key1, &data);
+  EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  data++;
+  ret = rcutils_hash_map_set(&map, &key2, &data);
+  EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+
+  ret = rcutils_hash_map_get(&map, &lookup_key, &ret_data);
+  EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  EXPECT_EQ((uint32_t)1, ret_data);
+
+  ret = rcutils_hash_map_fini(&map);
+  EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+}
+
+TEST_F(HashMapBaseTest, string_keys_lookup_by_length) {
+  const char * keys[] = {"ns", "node", "remap", ""};
+  // The keys are the tokens of a path, not null terminated
+  const char * path = "/ns/node/remap";
+  const rcutils_hash_map_key_hasher_t hash_funcs[] = {
+    rcutils_hash_map_string_hash_func, rcutils_hash_map_fast_string_hash_func};
+  const rcutils_hash_map_backend_t backends[] = {
+    RCUTILS_HASH_MAP_BACKEND_CHAINING, RCUTILS_HASH_MAP_BACKEND_OPEN_ADDRESSING};
+  for (rcutils_hash_map_key_hasher_t hash_func : hash_funcs) {
+    for (rcutils_hash_map_backend_t backend : backends) {
+      rcutils_hash_map_options_t options = rcutils_hash_map_get_default_options();
+      options.backend = backend;
+      map = rcutils_get_zero_initialized_hash_map();
+      ASSERT_EQ(
+        RCUTILS_RET_OK, rcutils_hash_map_init_with_options(
+          &map, 4, sizeof(char *), sizeof(uint32_t),
+          hash_func, rcutils_hash_map_string_cmp_func, &options, &allocator));
+      for (uint32_t i = 0; i < 4; ++i) {
+        ASSERT_EQ(RCUTILS_RET_OK, rcutils_hash_map_set(&map, &keys[i], &i));
+      }
+
+      uint32_t data = 42;
+      EXPECT_TRUE(rcutils_hash_map_key_existsn(&map, path + 1, 2));
+      EXPECT_EQ(RCUTILS_RET_OK, rcutils_hash_map_getn(&map, path + 4, 4, &data));
+      EXPECT_EQ(1u, data);
+      EXPECT_EQ(RCUTILS_RET_OK, rcutils_hash_map_getn(&map, path + 9, 5, &data));
+      EXPECT_EQ(2u, data);
+      EXPECT_EQ(RCUTILS_RET_OK, rcutils_hash_map_getn(&map, nullptr, 0, &data));
+      EXPECT_EQ(3u, data);
+      // Prefixes and longer ranges of the keys aren't found
+      EXPECT_FALSE(rcutils_hash_map_key_existsn(&map, path + 1, 1));
+      EXPECT_FALSE(rcutils_hash_map_key_existsn(&map, path + 1, 3));
+      EXPECT_EQ(RCUTILS_RET_NOT_FOUND, rcutils_hash_map_getn(&map, path + 4, 3, &data));
+      EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_hash_map_getn(&map, nullptr, 1, &data));
+      rcutils_reset_error();
+      EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_hash_map_getn(&map, path, 1, nullptr));
+      rcutils_reset_error();
+
+      ASSERT_EQ(RCUTILS_RET_OK, rcutils_hash_map_fini(&map));
+    }
+  }
+
+  // Other keys can't be looked up by length
+  ASSERT_EQ(
+    RCUTILS_RET_OK, rcutils_hash_map_init(
+      &map, 2, sizeof(uint32_t), sizeof(uint32_t),
+      test_hash_map_uint32_hash_func, test_uint32_cmp, &allocator));
+  uint32_t data = 0;
+  EXPECT_FALSE(rcutils_hash_map_key_existsn(&map, "ab", 2));
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_hash_map_getn(&map, "ab", 2, &data));
+  rcutils_reset_error();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_hash_map_fini(&map));
+  EXPECT_FALSE(rcutils_hash_map_key_existsn(&map, "ab", 2));
+  EXPECT_EQ(RCUTILS_RET_NOT_INITIALIZED, rcutils_hash_map_getn(&map, "ab", 2, &data));
+  rcutils_reset_error();
+}
+
+TEST_F(HashMapBaseTest, reserve) {
+  const rcutils_hash_map_options_t options[] = {
+    rcutils_hash_map_get_default_options(), get_open_addressing_options()};
+  for (const rcutils_hash_map_options_t & option : options) {
+    rcutils_ret_t ret = rcutils_hash_map_init_with_options(
+      &map, 2, sizeof(uint32_t), sizeof(uint32_t),
+      test_hash_map_uint32_hash_func, test_uint32_cmp, &option, &allocator);
+    ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    uint32_t key = 1000;
+    ret = rcutils_hash_map_set(&map, &key, &key);
+    EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+
+    ret = rcutils_hash_map_reserve(&map, 100);
+    EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    size_t capacity = 0;
+    ret = rcutils_hash_map_get_capacity(&map, &capacity);
+    EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    EXPECT_GE(capacity, 100u / 0.75);
+    // Reserving less doesn't shrink the map.
+    ret = rcutils_hash_map_reserve(&map, 10);
+    EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    size_t reserved_capacity = 0;
+    ret = rcutils_hash_map_get_capacity(&map, &reserved_capacity);
+    EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    EXPECT_EQ(capacity, reserved_capacity);
+
+    // The map doesn't grow until it holds the reserved size.
+    for (uint32_t i = 0; i < 99; ++i) {
+      ret = rcutils_hash_map_set(&map, &i, &i);
+      EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    }
+    ret = rcutils_hash_map_get_capacity(&map, &reserved_capacity);
+    EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    EXPECT_EQ(capacity, reserved_capacity);
+    uint32_t data = 0;
+    ret = rcutils_hash_map_get(&map, &key, &data);
+    EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    EXPECT_EQ(key, data);
+
+    ret = rcutils_hash_map_reserve(&map, SIZE_MAX);
+    EXPECT_EQ(RCUTILS_RET_BAD_ALLOC, ret);
+    rcutils_reset_error();
+    ret = rcutils_hash_map_fini(&map);
+    EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  }
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_hash_map_reserve(NULL, 1));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_NOT_INITIALIZED, rcutils_hash_map_reserve(&map, 1));
+  rcutils_reset_error();
+}
+
+TEST_F(HashMapBaseTest, growth_factor) {
+  rcutils_hash_map_options_t options = get_open_addressing_options();
+  options.growth_factor = 4.0;
+  options.max_load_factor = 0.5;
+  rcutils_ret_t ret = rcutils_hash_map_init_with_options(
+    &map, 16, sizeof(uint32_t), sizeof(uint32_t),
+    test_hash_map_uint32_hash_func, test_uint32_cmp, &options, &allocator);
+  ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  for (uint32_t i = 0; i < 9; ++i) {
+    ret = rcutils_hash_map_set(&map, &i, &i);
+    EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  }
+  size_t capacity = 0;
+  ret = rcutils_hash_map_get_capacity(&map, &capacity);
+  EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  EXPECT_EQ(64u, capacity);
+  ret = rcutils_hash_map_fini(&map);
+  EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+
+  options = rcutils_hash_map_get_default_options();
+  options.growth_factor = 3.0;
+  ret = rcutils_hash_map_init_with_options(
+    &map, 4, sizeof(uint32_t), sizeof(uint32_t),
+    test_hash_map_uint32_hash_func, test_uint32_cmp, &options, &allocator);
+  ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  for (uint32_t i = 0; i < 4; ++i) {
+    ret = rcutils_hash_map_set(&map, &i, &i);
+    EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  }
+  ret = rcutils_hash_map_get_capacity(&map, &capacity);
+  EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  // 4 * 3 rounded up to a power of two
+  EXPECT_EQ(16u, capacity);
+  ret = rcutils_hash_map_fini(&map);
+  EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+}
+
+TEST_F(HashMapBaseTest, incremental_rehash) {
+  rcutils_hash_map_options_t options = rcutils_hash_map_get_default_options();
+  options.rehash_buckets_per_operation = 1;
+  rcutils_ret_t ret = rcutils_hash_map_init_with_options(
+    &map, 4, sizeof(uint32_t), sizeof(uint32_t),
+    test_hash_map_uint32_hash_func, test_uint32_cmp, &options, &allocator);
+  ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+
+  // Every entry is found while the old buckets are moved one per operation.
+  for (uint32_t i = 0; i < 200; ++i) {
+    uint32_t data = i + 1000;
+    ret = rcutils_hash_map_set(&map, &i, &data);
+    ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    for (uint32_t j = 0; j <= i; ++j) {
+      data = 0;
+      ret = rcutils_hash_map_get(&map, &j, &data);
+      ASSERT_EQ(RCUTILS_RET_OK, ret) << i << ' ' << j;
+      EXPECT_EQ(j + 1000, data);
+    }
+  }
+  // Updating keys, wherever they are, keeps the size.
+  for (uint32_t i = 0; i < 200; i += 2) {
+    uint32_t data = i;
+    ret = rcutils_hash_map_set(&map, &i, &data);
+    EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  }
+  size_t size = 0;
+  ret = rcutils_hash_map_get_size(&map, &size);
+  EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  EXPECT_EQ(200u, size);
+
+  // Grow the map again, then unset and iterate before it's done moving the buckets.
+  for (uint32_t i = 200; i < 400; ++i) {
+    ret = rcutils_hash_map_set(&map, &i, &i);
+    EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  }
+  for (uint32_t i = 0; i < 400; i += 3) {
+    ret = rcutils_hash_map_unset(&map, &i);
+    EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  }
+  ret = rcutils_hash_map_get_size(&map, &size);
+  EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  EXPECT_EQ(266u, size);
+
+  std::vector<bool> visited(400, false);
+  size_t count = 0;
+  uint32_t key = 0, data = 0;
+  ret = rcutils_hash_map_get_next_key_and_data(&map, NULL, &key, &data);
+  while (RCUTILS_RET_OK == ret) {
+    ASSERT_LT(key, 400u);
+    EXPECT_NE(0u, key % 3) << key;
+    EXPECT_FALSE(visited[key]) << key;
+    EXPECT_EQ(key < 200 && 0 == key % 2 ? key : key < 200 ? key + 1000 : key, data) << key;
+    visited[key] = true;
+    ++count;
+    ret = rcutils_hash_map_get_next_key_and_data(&map, &key, &key, &data);
+  }
+  EXPECT_EQ(RCUTILS_RET_HASH_MAP_NO_MORE_ENTRIES, ret) << rcutils_get_error_string().str;
+  EXPECT_EQ(266u, count);
+
+  // Finalizing deallocates the old buckets as well.
+  ret = rcutils_hash_map_fini(&map);
+  EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+}
+
+TEST_F(HashMapBaseTest, shrink_to_fit) {
+  rcutils_hash_map_options_t incremental_options = rcutils_hash_map_get_default_options();
+  incremental_options.rehash_buckets_per_operation = 1;
+  const rcutils_hash_map_options_t options[] = {
+    rcutils_hash_map_get_default_options(), get_open_addressing_options(), incremental_options};
+  for (const rcutils_hash_map_options_t & option : options) {
+    rcutils_ret_t ret = rcutils_hash_map_init_with_options(
+      &map, 2, sizeof(uint32_t), sizeof(uint32_t),
+      test_hash_map_uint32_hash_func, test_uint32_cmp, &option, &allocator);
+    ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    size_t initial_bytes = 0;
+    ret = rcutils_hash_map_get_memory_usage(&map, &initial_bytes);
+    EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+
+    for (uint32_t i = 0; i < 1000; ++i) {
+      ret = rcutils_hash_map_set(&map, &i, &i);
+      ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    }
+    size_t peak_bytes = 0;
+    ret = rcutils_hash_map_get_memory_usage(&map, &peak_bytes);
+    EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    EXPECT_GT(peak_bytes, initial_bytes + 1000 * 2 * sizeof(uint32_t));
+
+    // Unsetting keys doesn't shrink the map by default.
+    for (uint32_t i = 10; i < 1000; ++i) {
+      ret = rcutils_hash_map_unset(&map, &i);
+      ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    }
+    size_t capacity = 0;
+    ret = rcutils_hash_map_get_capacity(&map, &capacity);
+    EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    EXPECT_GE(capacity, 1000u / 0.75);
+    size_t bytes = 0;
+    ret = rcutils_hash_map_get_memory_usage(&map, &bytes);
+    EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    EXPECT_LE(bytes, peak_bytes);
+
+    ret = rcutils_hash_map_shrink_to_fit(&map);
+    EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    ret = rcutils_hash_map_get_capacity(&map, &capacity);
+    EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    EXPECT_EQ(16u, capacity);
+    ret = rcutils_hash_map_get_memory_usage(&map, &bytes);
+    EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    EXPECT_LT(bytes, peak_bytes / 10);
+    for (uint32_t i = 0; i < 10; ++i) {
+      uint32_t data = 0;
+      ret = rcutils_hash_map_get(&map, &i, &data);
+      EXPECT_EQ(RCUTILS_RET_OK, ret) << i;
+      EXPECT_EQ(i, data);
+    }
+    // Shrinking again does nothing, and the map still grows.
+    ret = rcutils_hash_map_shrink_to_fit(&map);
+    EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    size_t same_bytes = 0;
+    ret = rcutils_hash_map_get_memory_usage(&map, &same_bytes);
+    EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    EXPECT_EQ(bytes, same_bytes);
+    for (uint32_t i = 10; i < 100; ++i) {
+      ret = rcutils_hash_map_set(&map, &i, &i);
+      ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    }
+    size_t size = 0;
+    ret = rcutils_hash_map_get_size(&map, &size);
+    EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    EXPECT_EQ(100u, size);
+
+    EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_hash_map_get_memory_usage(&map, NULL));
+    rcutils_reset_error();
+    ret = rcutils_hash_map_fini(&map);
+    EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  }
+  size_t bytes = 0;
+  EXPECT_EQ(RCUTILS_RET_NOT_INITIALIZED, rcutils_hash_map_get_memory_usage(&map, &bytes));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_NOT_INITIALIZED, rcutils_hash_map_shrink_to_fit(&map));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_hash_map_shrink_to_fit(NULL));
+  rcutils_reset_error();
+}
+
+TEST_F(HashMapBaseTest, min_load_factor) {
+  rcutils_hash_map_options_t options[] = {
+    rcutils_hash_map_get_default_options(), get_open_addressing_options(),
+    rcutils_hash_map_get_default_options()};
+  options[2].rehash_buckets_per_operation = 1;
+  for (rcutils_hash_map_options_t & option : options) {
+    option.min_load_factor = 0.2;
+    rcutils_ret_t ret = rcutils_hash_map_init_with_options(
+      &map, 2, sizeof(uint32_t), sizeof(uint32_t),
+      test_hash_map_uint32_hash_func, test_uint32_cmp, &option, &allocator);
+    ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    for (uint32_t i = 0; i < 1000; ++i) {
+      ret = rcutils_hash_map_set(&map, &i, &i);
+      ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    }
+
+    // The map shrinks as its entries are unset, keeping the remaining ones.
+    for (uint32_t i = 0; i < 990; ++i) {
+      ret = rcutils_hash_map_unset(&map, &i);
+      ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+      size_t capacity = 0;
+      ret = rcutils_hash_map_get_capacity(&map, &capacity);
+      EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+      EXPECT_GE(0.75 * capacity, 999.0 - i) << i;
+    }
+    size_t capacity = 0;
+    ret = rcutils_hash_map_get_capacity(&map, &capacity);
+    EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    // Rehashing incrementally, the map shrinks again only once the old buckets are moved.
+    EXPECT_LE(capacity, 0 == option.rehash_buckets_per_operation ? 64u : 1024u);
+    for (uint32_t i = 0; i < 1000; ++i) {
+      uint32_t data = 0;
+      ret = rcutils_hash_map_get(&map, &i, &data);
+      if (i < 990) {
+        EXPECT_EQ(RCUTILS_RET_NOT_FOUND, ret) << i;
+        rcutils_reset_error();
+      } else {
+        EXPECT_EQ(RCUTILS_RET_OK, ret) << i;
+        EXPECT_EQ(i, data);
+      }
+    }
+    ret = rcutils_hash_map_fini(&map);
+    EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  }
+}
+
+TEST_F(HashMapBaseTest, capacity_is_a_power_of_two) {
+  rcutils_ret_t ret = rcutils_hash_map_init(
+    &map, 10, sizeof(uint32_t), sizeof(uint32_t),
+    test_hash_map_uint32_hash_func, test_uint32_cmp, &allocator);
+  ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  size_t capacity = 0;
+  ret = rcutils_hash_map_get_capacity(&map, &capacity);
+  EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  EXPECT_EQ(16u, capacity);
+  ret = rcutils_hash_map_reserve(&map, 100);
+  EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  ret = rcutils_hash_map_get_capacity(&map, &capacity);
+  EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  EXPECT_EQ(256u, capacity);
+  ret = rcutils_hash_map_fini(&map);
+  EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+}
+
+TEST(HashMapHashFunctions, bytes_hash) {
+  // Hash every length around the 4, 16 and 48 bytes boundaries of the word reads.
+  std::string text(200, 'a');
+  std::set<size_t> hashes;
+  for (size_t size = 0; size <= text.size(); ++size) {
+    EXPECT_TRUE(hashes.insert(rcutils_hash_map_bytes_hash(text.data(), size)).second) << size;
+  }
+  EXPECT_EQ(rcutils_hash_map_bytes_hash(NULL, 0), rcutils_hash_map_bytes_hash("", 0));
+
+  // Every byte changes the hash.
+  for (size_t size : {3u, 7u, 16u, 17u, 48u, 49u, 100u}) {
+    size_t hash = rcutils_hash_map_bytes_hash(text.data(), size);
+    for (size_t i = 0; i < size; ++i) {
+      std::string changed = text.substr(0, size);
+      changed[i] = 'b';
+      EXPECT_NE(hash, rcutils_hash_map_bytes_hash(changed.data(), size)) << size << ' ' << i;
+    }
+  }
+}
+
+TEST(HashMapHashFunctions, fast_string_hash) {
+  std::string storage1 = "/a/topic/name";
+  std::string storage2 = "/a/topic/name";
+  const char * key1 = storage1.c_str();
+  const char * key2 = storage2.c_str();
+  const char * key3 = "/a/topic/namf";
+  EXPECT_EQ(
+    rcutils_hash_map_fast_string_hash_func(&key1), rcutils_hash_map_fast_string_hash_func(&key2));
+  EXPECT_NE(
+    rcutils_hash_map_fast_string_hash_func(&key1), rcutils_hash_map_fast_string_hash_func(&key3));
+  EXPECT_EQ(
+    rcutils_hash_map_bytes_hash(key1, storage1.size()),
+    rcutils_hash_map_fast_string_hash_func(&key1));
+}
+
+TEST(HashMapHashFunctions, integer_hashes) {
+  // Consecutive keys spread over the low bits used to select the buckets.
+  std::set<size_t> buckets64, buckets32;
+  for (uint64_t key = 0; key < 64; ++key) {
+    buckets64.insert(rcutils_hash_map_uint64_hash_func(&key) & 0xFF);
+    uint32_t key32 = static_cast<uint32_t>(key << 8);
+    buckets32.insert(rcutils_hash_map_uint32_hash_func(&key32) & 0xFF);
+  }
+  EXPECT_LT(48u, buckets64.size());
+  EXPECT_LT(48u, buckets32.size());
+
+  uint64_t a = 1, b = 2;
+  EXPECT_GT(0, rcutils_hash_map_uint64_cmp_func(&a, &b));
+  EXPECT_LT(0, rcutils_hash_map_uint64_cmp_func(&b, &a));
+  EXPECT_EQ(0, rcutils_hash_map_uint64_cmp_func(&a, &a));
+  uint32_t c = 1, d = 2;
+  EXPECT_GT(0, rcutils_hash_map_uint32_cmp_func(&c, &d));
+  EXPECT_LT(0, rcutils_hash_map_uint32_cmp_func(&d, &c));
+  EXPECT_EQ(0, rcutils_hash_map_uint32_cmp_func(&c, &c));
+}
+
+TEST_F(HashMapBaseTest, uint64_keys) {
+  const rcutils_hash_map_options_t options[] = {
+    rcutils_hash_map_get_default_options(), get_open_addressing_options()};
+  for (const rcutils_hash_map_options_t & option : options) {
+    rcutils_ret_t ret = rcutils_hash_map_init_with_options(
+      &map, 2, sizeof(uint64_t), sizeof(uint64_t),
+      rcutils_hash_map_uint64_hash_func, rcutils_hash_map_uint64_cmp_func, &option, &allocator);
+    ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    for (uint64_t key = 0; key < 1000; ++key) {
+      uint64_t data = key << 32;
+      ret = rcutils_hash_map_set(&map, &key, &data);
+      EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    }
+    for (uint64_t key = 0; key < 1000; ++key) {
+      uint64_t data = 0;
+      ret = rcutils_hash_map_get(&map, &key, &data);
+      EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+      EXPECT_EQ(key << 32, data);
+    }
+    ret = rcutils_hash_map_fini(&map);
+    EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  }
+}
+
+TEST_F(HashMapBaseTest, iterate) {
+  rcutils_hash_map_options_t incremental_options = rcutils_hash_map_get_default_options();
+  incremental_options.rehash_buckets_per_operation = 1;
+  const rcutils_hash_map_options_t options[] = {
+    rcutils_hash_map_get_default_options(), get_open_addressing_options(), incremental_options};
+  for (const rcutils_hash_map_options_t & option : options) {
+    rcutils_ret_t ret = rcutils_hash_map_init_with_options(
+      &map, 2, sizeof(uint32_t), sizeof(uint32_t),
+      test_hash_map_colliding_hash_func, test_uint32_cmp, &option, &allocator);
+    ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+
+    uint32_t key = 0, data = 0;
+    rcutils_hash_map_iterator_t iterator = rcutils_hash_map_get_zero_initialized_iterator();
+    ret = rcutils_hash_map_iterate(&map, &iterator, &key, &data);
+    EXPECT_EQ(RCUTILS_RET_HASH_MAP_NO_MORE_ENTRIES, ret) << rcutils_get_error_string().str;
+
+    for (uint32_t i = 0; i < 100; ++i) {
+      uint32_t value = i + 100;
+      ret = rcutils_hash_map_set(&map, &i, &value);
+      EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    }
+
+    // Every entry is visited once, in the order of rcutils_hash_map_get_next_key_and_data().
+    std::vector<bool> visited(100, false);
+    size_t count = 0;
+    uint32_t next_key = 0, next_data = 0;
+    iterator = rcutils_hash_map_get_zero_initialized_iterator();
+    ret = rcutils_hash_map_iterate(&map, &iterator, &key, &data);
+    rcutils_ret_t next_ret = rcutils_hash_map_get_next_key_and_data(
+      &map, NULL, &next_key, &next_data);
+    while (RCUTILS_RET_OK == ret) {
+      ASSERT_EQ(RCUTILS_RET_OK, next_ret);
+      EXPECT_EQ(next_key, key);
+      ASSERT_LT(key, 100u);
+      EXPECT_EQ(key + 100, data);
+      EXPECT_FALSE(visited[key]) << key;
+      visited[key] = true;
+      ++count;
+      ret = rcutils_hash_map_iterate(&map, &iterator, &key, &data);
+      next_ret = rcutils_hash_map_get_next_key_and_data(&map, &next_key, &next_key, &next_data);
+    }
+    EXPECT_EQ(RCUTILS_RET_HASH_MAP_NO_MORE_ENTRIES, ret) << rcutils_get_error_string().str;
+    EXPECT_EQ(RCUTILS_RET_HASH_MAP_NO_MORE_ENTRIES, next_ret);
+    EXPECT_EQ(100u, count);
+    // The iterator stays at the end.
+    ret = rcutils_hash_map_iterate(&map, &iterator, &key, &data);
+    EXPECT_EQ(RCUTILS_RET_HASH_MAP_NO_MORE_ENTRIES, ret) << rcutils_get_error_string().str;
+
+    EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_hash_map_iterate(&map, NULL, &key, &data));
+    rcutils_reset_error();
+    EXPECT_EQ(
+      RCUTILS_RET_INVALID_ARGUMENT, rcutils_hash_map_iterate(&map, &iterator, NULL, &data));
+    rcutils_reset_error();
+    EXPECT_EQ(
+      RCUTILS_RET_INVALID_ARGUMENT, rcutils_hash_map_iterate(&map, &iterator, &key, NULL));
+    rcutils_reset_error();
+
+    ret = rcutils_hash_map_fini(&map);
+    EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  }
+  rcutils_hash_map_iterator_t iterator = rcutils_hash_map_get_zero_initialized_iterator();
+  uint32_t key = 0, data = 0;
+  EXPECT_EQ(RCUTILS_RET_NOT_INITIALIZED, rcutils_hash_map_iterate(&map, &iterator, &key, &data));
+  rcutils_reset_error();
+}
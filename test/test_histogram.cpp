@@ -0,0 +1,243 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "./allocator_testing_utils.h"
+#include "rcutils/allocator.h"
+#include "rcutils/error_handling.h"
+
+#include "rcutils/types/histogram.h"
+
+TEST(test_histogram, init_fini) {
+  auto histogram = rcutils_get_zero_initialized_histogram();
+  auto allocator = rcutils_get_default_allocator();
+
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_histogram_init(nullptr, 1000, 7, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_histogram_init(&histogram, 1000, 7, nullptr));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_histogram_init(&histogram, 1000, 0, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_histogram_init(&histogram, 1000, 17, &allocator));
+  rcutils_reset_error();
+  rcutils_allocator_t failing_allocator = get_failing_allocator();
+  EXPECT_EQ(RCUTILS_RET_BAD_ALLOC, rcutils_histogram_init(&histogram, 1000, 7, &failing_allocator));
+  rcutils_reset_error();
+
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_histogram_record(&histogram, 1));
+  rcutils_reset_error();
+
+  // A minute in nanoseconds with 7 precision bits
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_histogram_init(&histogram, 60000000000u, 7, &allocator));
+  EXPECT_EQ(3808u, histogram.bucket_count);
+  EXPECT_EQ(7u, histogram.precision_bits);
+  EXPECT_EQ(0u, histogram.count);
+  EXPECT_EQ(UINT64_MAX, histogram.min);
+  EXPECT_EQ(0u, histogram.max);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_histogram_fini(&histogram));
+  EXPECT_EQ(nullptr, histogram.buckets);
+  EXPECT_EQ(0u, histogram.bucket_count);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_histogram_fini(&histogram));
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_histogram_fini(nullptr));
+  rcutils_reset_error();
+}
+
+TEST(test_histogram, buckets) {
+  auto histogram = rcutils_get_zero_initialized_histogram();
+  auto allocator = rcutils_get_default_allocator();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_histogram_init(&histogram, 1000000, 3, &allocator));
+
+  size_t index = 0;
+  uint64_t lower_bound = 0;
+  for (uint64_t value = 0; value < 8; ++value) {
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_histogram_get_bucket_index(&histogram, value, &index));
+    EXPECT_EQ(value, index);
+  }
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_histogram_get_bucket_index(&histogram, 8, &index));
+  EXPECT_EQ(8u, index);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_histogram_get_bucket_index(&histogram, 16, &index));
+  EXPECT_EQ(16u, index);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_histogram_get_bucket_index(&histogram, 17, &index));
+  EXPECT_EQ(16u, index);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_histogram_get_bucket_index(&histogram, 18, &index));
+  EXPECT_EQ(17u, index);
+
+  // Every bucket holds the values from its lower bound to the next one, within the precision
+  for (size_t i = 0; i < histogram.bucket_count; ++i) {
+    ASSERT_EQ(
+      RCUTILS_RET_OK, rcutils_histogram_get_bucket_lower_bound(&histogram, i, &lower_bound));
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_histogram_get_bucket_index(&histogram, lower_bound, &index));
+    EXPECT_EQ(i, index);
+    if (i > 0) {
+      EXPECT_EQ(
+        RCUTILS_RET_OK, rcutils_histogram_get_bucket_index(&histogram, lower_bound - 1, &index));
+      EXPECT_EQ(i - 1, index);
+    }
+    if (lower_bound >= 8) {
+      uint64_t next = 0;
+      if (i + 1 < histogram.bucket_count) {
+        ASSERT_EQ(
+          RCUTILS_RET_OK, rcutils_histogram_get_bucket_lower_bound(&histogram, i + 1, &next));
+        EXPECT_LE((next - lower_bound) * 8, lower_bound);
+      }
+    }
+  }
+
+  // Values beyond the highest trackable one are in the last bucket
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_histogram_get_bucket_index(&histogram, UINT64_MAX, &index));
+  EXPECT_EQ(histogram.bucket_count - 1, index);
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_histogram_get_bucket_lower_bound(&histogram, histogram.bucket_count, &lower_bound));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_histogram_get_bucket_index(&histogram, 1, nullptr));
+  rcutils_reset_error();
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_histogram_fini(&histogram));
+}
+
+TEST(test_histogram, record_percentile) {
+  auto histogram = rcutils_get_zero_initialized_histogram();
+  auto allocator = rcutils_get_default_allocator();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_histogram_init(&histogram, 1000000, 7, &allocator));
+
+  uint64_t value = 1;
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_histogram_get_percentile(&histogram, 50.0, &value));
+  EXPECT_EQ(0u, value);
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_histogram_get_percentile(&histogram, -1, &value));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_histogram_get_percentile(&histogram, 100.5, &value));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_histogram_get_percentile(&histogram, 50.0, nullptr));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_histogram_record(nullptr, 1));
+  rcutils_reset_error();
+
+  for (uint64_t i = 1; i <= 10000; ++i) {
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_histogram_record(&histogram, i * 10));
+  }
+  EXPECT_EQ(10000u, histogram.count);
+  EXPECT_EQ(500050000u, histogram.sum);
+  EXPECT_EQ(10u, histogram.min);
+  EXPECT_EQ(100000u, histogram.max);
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_histogram_get_percentile(&histogram, 0.0, &value));
+  EXPECT_EQ(10u, value);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_histogram_get_percentile(&histogram, 100.0, &value));
+  EXPECT_EQ(100000u, value);
+  for (double percentile : {1.0, 25.0, 50.0, 90.0, 99.0, 99.9}) {
+    auto exact = static_cast<uint64_t>(percentile * 1000);
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_histogram_get_percentile(&histogram, percentile, &value));
+    EXPECT_GE(value, exact) << percentile;
+    EXPECT_LE(value, exact + exact / 128) << percentile;
+  }
+
+  // Values beyond the highest trackable one are reported as the largest value
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_histogram_record(&histogram, 5000000));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_histogram_get_percentile(&histogram, 100.0, &value));
+  EXPECT_EQ(5000000u, value);
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_histogram_reset(&histogram));
+  EXPECT_EQ(0u, histogram.count);
+  EXPECT_EQ(0u, histogram.sum);
+  EXPECT_EQ(UINT64_MAX, histogram.min);
+  EXPECT_EQ(0u, histogram.max);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_histogram_get_percentile(&histogram, 50.0, &value));
+  EXPECT_EQ(0u, value);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_histogram_record(&histogram, 42));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_histogram_get_percentile(&histogram, 50.0, &value));
+  EXPECT_EQ(42u, value);
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_histogram_fini(&histogram));
+}
+
+TEST(test_histogram, merge) {
+  auto histogram = rcutils_get_zero_initialized_histogram();
+  auto other = rcutils_get_zero_initialized_histogram();
+  auto different = rcutils_get_zero_initialized_histogram();
+  auto allocator = rcutils_get_default_allocator();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_histogram_init(&histogram, 1000000, 7, &allocator));
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_histogram_init(&other, 1000000, 7, &allocator));
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_histogram_init(&different, 1000000, 6, &allocator));
+
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_histogram_merge(&histogram, &different));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_histogram_merge(&histogram, nullptr));
+  rcutils_reset_error();
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_histogram_record(&histogram, 100));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_histogram_record(&other, 5));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_histogram_record(&other, 1000));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_histogram_merge(&histogram, &other));
+  EXPECT_EQ(3u, histogram.count);
+  EXPECT_EQ(1105u, histogram.sum);
+  EXPECT_EQ(5u, histogram.min);
+  EXPECT_EQ(1000u, histogram.max);
+  uint64_t value = 0;
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_histogram_get_percentile(&histogram, 50.0, &value));
+  EXPECT_EQ(100u, value);
+
+  // Merging an empty histogram changes nothing
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_histogram_reset(&other));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_histogram_merge(&histogram, &other));
+  EXPECT_EQ(3u, histogram.count);
+  EXPECT_EQ(5u, histogram.min);
+  EXPECT_EQ(1000u, histogram.max);
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_histogram_fini(&histogram));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_histogram_fini(&other));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_histogram_fini(&different));
+}
+
+TEST(test_histogram, concurrent_record) {
+  auto histogram = rcutils_get_zero_initialized_histogram();
+  auto allocator = rcutils_get_default_allocator();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_histogram_init(&histogram, 1000000, 7, &allocator));
+
+  constexpr uint64_t kThreads = 4;
+  constexpr uint64_t kValues = 10000;
+  std::vector<std::thread> threads;
+  for (uint64_t t = 0; t < kThreads; ++t) {
+    threads.emplace_back(
+      [&histogram, t]() {
+        for (uint64_t i = 1; i <= kValues; ++i) {
+          EXPECT_EQ(RCUTILS_RET_OK, rcutils_histogram_record(&histogram, t * kValues + i));
+        }
+      });
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(kThreads * kValues, histogram.count);
+  EXPECT_EQ(kThreads * kValues * (kThreads * kValues + 1) / 2, histogram.sum);
+  EXPECT_EQ(1u, histogram.min);
+  EXPECT_EQ(kThreads * kValues, histogram.max);
+  uint64_t total = 0;
+  for (size_t i = 0; i < histogram.bucket_count; ++i) {
+    total += histogram.buckets[i];
+  }
+  EXPECT_EQ(kThreads * kValues, total);
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_histogram_fini(&histogram));
+}
@@ -0,0 +1,166 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "osrf_testing_tools_cpp/scope_exit.hpp"
+#include "rcutils/allocator.h"
+#include "rcutils/error_handling.h"
+#include "rcutils/intern.h"
+#include "rcutils/types/hash_map.h"
+
+class TestIntern : public ::testing::Test
+{
+protected:
+  void SetUp() final
+  {
+    rcutils_reset_error();
+  }
+
+  void TearDown() final
+  {
+    rcutils_intern_shutdown();
+  }
+};
+
+TEST_F(TestIntern, intern_string) {
+  EXPECT_EQ(0u, rcutils_intern_get_count());
+  const char * interned = NULL;
+  size_t id = RCUTILS_INTERN_INVALID_ID;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_intern_string("/rosout", &interned, &id));
+  EXPECT_STREQ("/rosout", interned);
+  EXPECT_EQ(1u, id);
+
+  // Equal strings share the interned copy and the id.
+  std::string copy = "/rosout";
+  const char * second = NULL;
+  size_t second_id = RCUTILS_INTERN_INVALID_ID;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_intern_string(copy.c_str(), &second, &second_id));
+  EXPECT_EQ(interned, second);
+  EXPECT_EQ(id, second_id);
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_intern_stringn("/rosout_agg", 7, &second, &second_id));
+  EXPECT_EQ(interned, second);
+  EXPECT_EQ(id, second_id);
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_intern_string("/parameter_events", &second, &second_id));
+  EXPECT_NE(interned, second);
+  EXPECT_EQ(2u, second_id);
+  EXPECT_EQ(2u, rcutils_intern_get_count());
+  EXPECT_EQ(interned, rcutils_intern_get_string(id));
+  EXPECT_EQ(second, rcutils_intern_get_string(second_id));
+  EXPECT_EQ(NULL, rcutils_intern_get_string(RCUTILS_INTERN_INVALID_ID));
+  EXPECT_EQ(NULL, rcutils_intern_get_string(3u));
+
+  // The empty string may be interned as well.
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_intern_stringn(NULL, 0u, &second, NULL));
+  EXPECT_STREQ("", second);
+  EXPECT_EQ(3u, rcutils_intern_get_count());
+
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_intern_string(NULL, &second, &second_id));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_intern_stringn(NULL, 1u, NULL, NULL));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_intern_stringn("a\0b", 3u, NULL, NULL));
+  rcutils_reset_error();
+}
+
+TEST_F(TestIntern, find) {
+  const char * interned = NULL;
+  size_t id = RCUTILS_INTERN_INVALID_ID;
+  EXPECT_EQ(RCUTILS_RET_NOT_FOUND, rcutils_intern_findn("name", 4u, &interned, &id));
+  EXPECT_EQ(NULL, interned);
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_intern_string("name", NULL, NULL));
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_intern_findn("names", 4u, &interned, &id));
+  EXPECT_STREQ("name", interned);
+  EXPECT_EQ(1u, id);
+  EXPECT_EQ(RCUTILS_RET_NOT_FOUND, rcutils_intern_findn("nam", 3u, &interned, &id));
+  EXPECT_EQ(1u, rcutils_intern_get_count());
+}
+
+TEST_F(TestIntern, many_strings) {
+  std::vector<const char *> interned(5000);
+  for (size_t i = 0; i < interned.size(); ++i) {
+    std::string name = "/node_" + std::to_string(i);
+    size_t id = RCUTILS_INTERN_INVALID_ID;
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_intern_string(name.c_str(), &interned[i], &id));
+    EXPECT_EQ(i + 1, id);
+  }
+  for (size_t i = 0; i < interned.size(); ++i) {
+    std::string name = "/node_" + std::to_string(i);
+    const char * found = NULL;
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_intern_findn(name.c_str(), name.size(), &found, NULL));
+    EXPECT_EQ(interned[i], found);
+    EXPECT_EQ(interned[i], rcutils_intern_get_string(i + 1));
+  }
+}
+
+TEST_F(TestIntern, concurrent) {
+  const size_t names = 1000;
+  // Each thread interns the names in a different order, the strides are coprime with names.
+  const size_t strides[] = {1, 3, 7, 9};
+  std::vector<std::vector<const char *>> results(4, std::vector<const char *>(names));
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < results.size(); ++t) {
+    threads.emplace_back(
+      [&results, &strides, t, names]() {
+        for (size_t i = 0; i < names; ++i) {
+          size_t n = (i * strides[t]) % names;
+          std::string name = "name" + std::to_string(n);
+          EXPECT_EQ(RCUTILS_RET_OK, rcutils_intern_string(name.c_str(), &results[t][n], NULL));
+        }
+      });
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(names, rcutils_intern_get_count());
+  for (size_t i = 0; i < names; ++i) {
+    EXPECT_EQ("name" + std::to_string(i), results[0][i]);
+    for (size_t t = 1; t < results.size(); ++t) {
+      EXPECT_EQ(results[0][i], results[t][i]);
+    }
+  }
+}
+
+TEST_F(TestIntern, hash_map_keys) {
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  rcutils_hash_map_t map = rcutils_get_zero_initialized_hash_map();
+  ASSERT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_hash_map_init(
+      &map, 8, sizeof(const char *), sizeof(int),
+      rcutils_intern_hash_func, rcutils_intern_cmp_func, &allocator));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_hash_map_fini(&map));
+  });
+
+  const char * key = NULL;
+  const char * other_key = NULL;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_intern_string("key", &key, NULL));
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_intern_string("other key", &other_key, NULL));
+  int value = 42;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_hash_map_set(&map, &key, &value));
+
+  const char * same_key = NULL;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_intern_string(std::string("key").c_str(), &same_key, NULL));
+  int found = 0;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_hash_map_get(&map, &same_key, &found));
+  EXPECT_EQ(42, found);
+  EXPECT_FALSE(rcutils_hash_map_key_exists(&map, &other_key));
+}
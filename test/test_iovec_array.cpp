@@ -0,0 +1,203 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "./allocator_testing_utils.h"
+#include "rcutils/allocator.h"
+#include "rcutils/error_handling.h"
+
+#include "rcutils/types/iovec_array.h"
+
+static std::string
+flatten(const rcutils_iovec_array_t * iovec_array)
+{
+  auto allocator = rcutils_get_default_allocator();
+  auto uint8_array = rcutils_get_zero_initialized_uint8_array();
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_uint8_array_init(&uint8_array, 0, &allocator));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_iovec_array_flatten(iovec_array, &uint8_array));
+  std::string result(
+    reinterpret_cast<const char *>(uint8_array.buffer), uint8_array.buffer_length);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_uint8_array_fini(&uint8_array));
+  return result;
+}
+
+TEST(test_iovec_array, init_fini) {
+  auto iovec_array = rcutils_get_zero_initialized_iovec_array();
+  auto allocator = rcutils_get_default_allocator();
+  auto failing_allocator = get_failing_allocator();
+
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_iovec_array_init(nullptr, 1, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_iovec_array_init(&iovec_array, 1, nullptr));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_iovec_array_init(&iovec_array, 0, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_BAD_ALLOC, rcutils_iovec_array_init(&iovec_array, 1, &failing_allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(nullptr, iovec_array.segments);
+
+  // Finalizing a zero initialized array does nothing.
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_iovec_array_fini(&iovec_array));
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_iovec_array_fini(nullptr));
+  rcutils_reset_error();
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_iovec_array_init(&iovec_array, 2, &allocator));
+  EXPECT_EQ(0u, iovec_array.segment_count);
+  EXPECT_EQ(2u, iovec_array.segment_capacity);
+  EXPECT_EQ(0u, iovec_array.total_length);
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_iovec_array_init(&iovec_array, 2, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_iovec_array_fini(&iovec_array));
+  EXPECT_EQ(nullptr, iovec_array.segments);
+  EXPECT_EQ(0u, iovec_array.segment_capacity);
+}
+
+TEST(test_iovec_array, not_initialized) {
+  auto iovec_array = rcutils_get_zero_initialized_iovec_array();
+  auto allocator = rcutils_get_default_allocator();
+  auto uint8_array = rcutils_get_zero_initialized_uint8_array();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_uint8_array_init(&uint8_array, 0, &allocator));
+
+  EXPECT_EQ(
+    RCUTILS_RET_NOT_INITIALIZED, rcutils_iovec_array_append_reference(&iovec_array, "a", 1));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_NOT_INITIALIZED, rcutils_iovec_array_prepend_copy(&iovec_array, "a", 1));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_NOT_INITIALIZED, rcutils_iovec_array_clear(&iovec_array));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_NOT_INITIALIZED, rcutils_iovec_array_flatten(&iovec_array, &uint8_array));
+  rcutils_reset_error();
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_uint8_array_fini(&uint8_array));
+}
+
+TEST(test_iovec_array, references_are_not_copied) {
+  auto iovec_array = rcutils_get_zero_initialized_iovec_array();
+  auto allocator = rcutils_get_default_allocator();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_iovec_array_init(&iovec_array, 1, &allocator));
+
+  char payload[] = "payload";
+  const char header[] = "header:";
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_iovec_array_append_reference(&iovec_array, payload, 7));
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_iovec_array_prepend_reference(&iovec_array, header, 7));
+  // Empty segments are skipped.
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_iovec_array_append_reference(&iovec_array, nullptr, 0));
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_iovec_array_append_reference(
+      &iovec_array, nullptr, 1));
+  rcutils_reset_error();
+
+  ASSERT_EQ(2u, iovec_array.segment_count);
+  EXPECT_EQ(14u, iovec_array.total_length);
+  EXPECT_EQ(reinterpret_cast<const uint8_t *>(header), iovec_array.segments[0].data);
+  EXPECT_EQ(reinterpret_cast<const uint8_t *>(payload), iovec_array.segments[1].data);
+  EXPECT_FALSE(iovec_array.owned[0]);
+  EXPECT_FALSE(iovec_array.owned[1]);
+
+  // The array sees changes to the borrowed memory.
+  payload[0] = 'P';
+  EXPECT_EQ("header:Payload", flatten(&iovec_array));
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_iovec_array_fini(&iovec_array));
+}
+
+TEST(test_iovec_array, copies_are_owned) {
+  auto iovec_array = rcutils_get_zero_initialized_iovec_array();
+  auto allocator = rcutils_get_default_allocator();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_iovec_array_init(&iovec_array, 1, &allocator));
+
+  const char payload[] = "payload";
+  char header[] = "size=7;";
+  char trailer[] = ";end";
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_iovec_array_append_reference(&iovec_array, payload, 7));
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_iovec_array_prepend_copy(&iovec_array, header, 7));
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_iovec_array_append_copy(&iovec_array, trailer, 4));
+  std::memset(header, 'x', 7);
+  std::memset(trailer, 'x', 4);
+
+  ASSERT_EQ(3u, iovec_array.segment_count);
+  EXPECT_LE(3u, iovec_array.segment_capacity);
+  EXPECT_EQ(18u, iovec_array.total_length);
+  EXPECT_TRUE(iovec_array.owned[0]);
+  EXPECT_FALSE(iovec_array.owned[1]);
+  EXPECT_TRUE(iovec_array.owned[2]);
+  EXPECT_EQ("size=7;payload;end", flatten(&iovec_array));
+
+  // Clearing keeps the room for segments, so the array can be reused.
+  size_t capacity = iovec_array.segment_capacity;
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_iovec_array_clear(&iovec_array));
+  EXPECT_EQ(0u, iovec_array.segment_count);
+  EXPECT_EQ(0u, iovec_array.total_length);
+  EXPECT_EQ(capacity, iovec_array.segment_capacity);
+  EXPECT_EQ("", flatten(&iovec_array));
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_iovec_array_append_copy(&iovec_array, "again", 5));
+  EXPECT_EQ("again", flatten(&iovec_array));
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_iovec_array_fini(&iovec_array));
+}
+
+TEST(test_iovec_array, many_segments) {
+  auto iovec_array = rcutils_get_zero_initialized_iovec_array();
+  auto allocator = rcutils_get_default_allocator();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_iovec_array_init(&iovec_array, 1, &allocator));
+
+  const char digits[] = "0123456789";
+  std::string expected;
+  for (size_t i = 0; i < 100; ++i) {
+    if (0 == i % 2) {
+      ASSERT_EQ(
+        RCUTILS_RET_OK, rcutils_iovec_array_append_reference(&iovec_array, &digits[i % 10], 1));
+      expected.push_back(digits[i % 10]);
+    } else {
+      ASSERT_EQ(
+        RCUTILS_RET_OK, rcutils_iovec_array_prepend_copy(&iovec_array, &digits[i % 10], 1));
+      expected.insert(expected.begin(), digits[i % 10]);
+    }
+  }
+  EXPECT_EQ(100u, iovec_array.segment_count);
+  EXPECT_EQ(100u, iovec_array.total_length);
+  EXPECT_EQ(expected, flatten(&iovec_array));
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_iovec_array_fini(&iovec_array));
+}
+
+TEST(test_iovec_array, flatten_reuses_capacity) {
+  auto iovec_array = rcutils_get_zero_initialized_iovec_array();
+  auto allocator = rcutils_get_default_allocator();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_iovec_array_init(&iovec_array, 4, &allocator));
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_iovec_array_append_reference(&iovec_array, "abc", 3));
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_iovec_array_append_reference(&iovec_array, "de", 2));
+
+  auto uint8_array = rcutils_get_zero_initialized_uint8_array();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_uint8_array_init(&uint8_array, 16, &allocator));
+  uint8_t * buffer = uint8_array.buffer;
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_iovec_array_flatten(&iovec_array, &uint8_array));
+  EXPECT_EQ(buffer, uint8_array.buffer);
+  EXPECT_EQ(16u, uint8_array.buffer_capacity);
+  ASSERT_EQ(5u, uint8_array.buffer_length);
+  EXPECT_EQ(0, std::memcmp(uint8_array.buffer, "abcde", 5));
+
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_iovec_array_flatten(&iovec_array, nullptr));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_iovec_array_flatten(nullptr, &uint8_array));
+  rcutils_reset_error();
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_uint8_array_fini(&uint8_array));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_iovec_array_fini(&iovec_array));
+}
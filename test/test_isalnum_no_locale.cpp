@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstdint>
 #include <string>
 
 #include "gtest/gtest.h"
@@ -31,3 +32,88 @@ TEST(test_isalnum_no_locale, invalid_characters_fail) {
     ASSERT_FALSE(rcutils_isalnum_no_locale(c));
   }
 }
+
+TEST(test_isalnum_no_locale, char_class_table) {
+  for (int c = 0; c < 256; ++c) {
+    uint8_t expected = 0u;
+    if (c >= '0' && c <= '9') {
+      expected = RCUTILS_CHAR_CLASS_DIGIT;
+    } else if (c >= 'A' && c <= 'Z') {
+      expected = RCUTILS_CHAR_CLASS_UPPER;
+    } else if (c >= 'a' && c <= 'z') {
+      expected = RCUTILS_CHAR_CLASS_LOWER;
+    } else if ('_' == c) {
+      expected = RCUTILS_CHAR_CLASS_UNDERSCORE;
+    } else if ('/' == c) {
+      expected = RCUTILS_CHAR_CLASS_SLASH;
+    } else if ('~' == c) {
+      expected = RCUTILS_CHAR_CLASS_TILDE;
+    } else if ('{' == c || '}' == c) {
+      expected = RCUTILS_CHAR_CLASS_BRACE;
+    }
+    EXPECT_EQ(expected, rcutils_char_class_table[c]) << "character " << c;
+  }
+}
+
+TEST(test_isalnum_no_locale, validate_chars) {
+  const uint32_t name_mask =
+    RCUTILS_CHAR_CLASS_ALNUM | RCUTILS_CHAR_CLASS_UNDERSCORE | RCUTILS_CHAR_CLASS_SLASH;
+  EXPECT_EQ(0u, rcutils_validate_chars(nullptr, 10u, name_mask));
+  EXPECT_EQ(0u, rcutils_validate_chars("", 0u, name_mask));
+
+  std::string name("/some_namespace/with_a/long_node_name42");
+  EXPECT_EQ(name.size(), rcutils_validate_chars(name.c_str(), name.size(), name_mask));
+  EXPECT_EQ(0u, rcutils_validate_chars(name.c_str(), name.size(), RCUTILS_CHAR_CLASS_ALNUM));
+  EXPECT_EQ(0u, rcutils_validate_chars(name.c_str(), name.size(), 0u));
+  // Only the given length is checked.
+  EXPECT_EQ(5u, rcutils_validate_chars("/a/b/c!", 5u, name_mask));
+
+  std::string relative("~/{node}/topic");
+  EXPECT_EQ(0u, rcutils_validate_chars(relative.c_str(), relative.size(), name_mask));
+  EXPECT_EQ(
+    relative.size(), rcutils_validate_chars(
+      relative.c_str(), relative.size(),
+      name_mask | RCUTILS_CHAR_CLASS_TILDE | RCUTILS_CHAR_CLASS_BRACE));
+  // '|' is between the braces, but isn't one.
+  EXPECT_EQ(1u, rcutils_validate_chars("{|}", 3u, RCUTILS_CHAR_CLASS_BRACE));
+
+  // Null characters and bytes of 0x80 and above are never valid.
+  std::string with_null(40u, 'a');
+  with_null[33] = '\0';
+  EXPECT_EQ(33u, rcutils_validate_chars(with_null.c_str(), with_null.size(), name_mask));
+  std::string utf8("/caf\xc3\xa9");
+  EXPECT_EQ(4u, rcutils_validate_chars(utf8.c_str(), utf8.size(), name_mask));
+}
+
+TEST(test_isalnum_no_locale, validate_chars_matches_table) {
+  // Every character at every position of strings spanning several blocks.
+  const uint32_t masks[] = {
+    RCUTILS_CHAR_CLASS_ALNUM,
+    RCUTILS_CHAR_CLASS_ALNUM | RCUTILS_CHAR_CLASS_UNDERSCORE | RCUTILS_CHAR_CLASS_SLASH,
+    RCUTILS_CHAR_CLASS_LOWER | RCUTILS_CHAR_CLASS_TILDE | RCUTILS_CHAR_CLASS_BRACE,
+    0x7fu,
+  };
+  for (uint32_t mask : masks) {
+    for (size_t length : {1u, 15u, 16u, 17u, 40u}) {
+      std::string valid(length, '\0');
+      for (size_t i = 0u; i < length; ++i) {
+        // Cycle through the valid characters of the mask.
+        int c = static_cast<int>(i * 7u) % 256;
+        while (0u == (rcutils_char_class_table[c] & mask)) {
+          c = (c + 1) % 256;
+        }
+        valid[i] = static_cast<char>(c);
+      }
+      ASSERT_EQ(length, rcutils_validate_chars(valid.c_str(), length, mask));
+      for (size_t position = 0u; position < length; ++position) {
+        for (int c = 0; c < 256; ++c) {
+          std::string str(valid);
+          str[position] = static_cast<char>(c);
+          size_t expected = (rcutils_char_class_table[c] & mask) ? length : position;
+          ASSERT_EQ(expected, rcutils_validate_chars(str.c_str(), length, mask)) <<
+            "mask " << mask << ", character " << c << " at " << position << " of " << length;
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,214 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "rcutils/lock.h"
+
+// Increments a counter from several threads, each holding the lock while it does.
+static void
+test_counter(const std::function<void()> & lock, const std::function<void()> & unlock)
+{
+  constexpr size_t thread_count = 4;
+  constexpr size_t increments = 20000;
+  size_t counter = 0;
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < thread_count; ++i) {
+    threads.emplace_back(
+      [&]() {
+        for (size_t j = 0; j < increments; ++j) {
+          lock();
+          ++counter;
+          unlock();
+        }
+      });
+  }
+  for (std::thread & thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(thread_count * increments, counter);
+}
+
+TEST(TestLock, spinlock) {
+  rcutils_spinlock_t lock = rcutils_get_zero_initialized_spinlock();
+  EXPECT_TRUE(rcutils_spinlock_try_lock(&lock));
+  EXPECT_FALSE(rcutils_spinlock_try_lock(&lock));
+  rcutils_spinlock_unlock(&lock);
+  rcutils_spinlock_lock(&lock);
+  EXPECT_FALSE(rcutils_spinlock_try_lock(&lock));
+  rcutils_spinlock_unlock(&lock);
+
+  test_counter(
+    [&lock]() {rcutils_spinlock_lock(&lock);},
+    [&lock]() {rcutils_spinlock_unlock(&lock);});
+}
+
+TEST(TestLock, ticket_lock) {
+  rcutils_ticket_lock_t lock = rcutils_get_zero_initialized_ticket_lock();
+  EXPECT_TRUE(rcutils_ticket_lock_try_lock(&lock));
+  EXPECT_FALSE(rcutils_ticket_lock_try_lock(&lock));
+  rcutils_ticket_lock_unlock(&lock);
+  rcutils_ticket_lock_lock(&lock);
+  EXPECT_FALSE(rcutils_ticket_lock_try_lock(&lock));
+  rcutils_ticket_lock_unlock(&lock);
+  EXPECT_TRUE(rcutils_ticket_lock_try_lock(&lock));
+  rcutils_ticket_lock_unlock(&lock);
+
+  test_counter(
+    [&lock]() {rcutils_ticket_lock_lock(&lock);},
+    [&lock]() {rcutils_ticket_lock_unlock(&lock);});
+}
+
+TEST(TestLock, ticket_lock_order) {
+  rcutils_ticket_lock_t lock = rcutils_get_zero_initialized_ticket_lock();
+  rcutils_ticket_lock_lock(&lock);
+  // The threads take their tickets one after the other, and get the lock in that order
+  constexpr size_t thread_count = 3;
+  std::vector<size_t> order;
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < thread_count; ++i) {
+    threads.emplace_back(
+      [&lock, &order, i]() {
+        rcutils_ticket_lock_lock(&lock);
+        order.push_back(i);
+        rcutils_ticket_lock_unlock(&lock);
+      });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+  rcutils_ticket_lock_unlock(&lock);
+  for (std::thread & thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(std::vector<size_t>({0, 1, 2}), order);
+}
+
+TEST(TestLock, mutex) {
+  rcutils_mutex_t mutex = rcutils_get_zero_initialized_mutex();
+  EXPECT_TRUE(rcutils_mutex_try_lock(&mutex));
+  EXPECT_FALSE(rcutils_mutex_try_lock(&mutex));
+  rcutils_mutex_unlock(&mutex);
+  rcutils_mutex_lock(&mutex);
+  EXPECT_FALSE(rcutils_mutex_try_lock(&mutex));
+  rcutils_mutex_unlock(&mutex);
+  EXPECT_EQ(0u, mutex.state);
+
+  test_counter(
+    [&mutex]() {rcutils_mutex_lock(&mutex);},
+    [&mutex]() {rcutils_mutex_unlock(&mutex);});
+  EXPECT_EQ(0u, mutex.state);
+}
+
+TEST(TestLock, mutex_sleeping) {
+  rcutils_mutex_t mutex = rcutils_get_zero_initialized_mutex();
+  rcutils_mutex_lock(&mutex);
+  std::atomic_bool locked(false);
+  std::thread thread(
+    [&mutex, &locked]() {
+      rcutils_mutex_lock(&mutex);
+      locked = true;
+      rcutils_mutex_unlock(&mutex);
+    });
+  // The thread gives up spinning and sleeps until the mutex is unlocked
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_FALSE(locked);
+  rcutils_mutex_unlock(&mutex);
+  thread.join();
+  EXPECT_TRUE(locked);
+  EXPECT_EQ(0u, mutex.state);
+}
+
+TEST(TestLock, seqlock) {
+  rcutils_seqlock_t lock = rcutils_get_zero_initialized_seqlock();
+  uint32_t sequence = rcutils_seqlock_read_begin(&lock);
+  EXPECT_FALSE(rcutils_seqlock_read_retry(&lock, sequence));
+  rcutils_seqlock_write_lock(&lock);
+  EXPECT_EQ(1u, lock.sequence);
+  rcutils_seqlock_write_unlock(&lock);
+  EXPECT_TRUE(rcutils_seqlock_read_retry(&lock, sequence));
+  sequence = rcutils_seqlock_read_begin(&lock);
+  EXPECT_EQ(2u, sequence);
+  EXPECT_FALSE(rcutils_seqlock_read_retry(&lock, sequence));
+}
+
+TEST(TestLock, seqlock_unaligned_data) {
+  // The data is copied by words where it can be, and by bytes around them
+  rcutils_seqlock_t lock = rcutils_get_zero_initialized_seqlock();
+  alignas(8) char shared[16] = {};
+  alignas(8) char copy[16] = {};
+  const char * data = "unaligned data";
+  rcutils_seqlock_write(&lock, shared + 1, data, 15u);
+  EXPECT_STREQ(data, shared + 1);
+  rcutils_seqlock_read(&lock, copy + 1, shared + 1, 15u);
+  EXPECT_STREQ(data, copy + 1);
+  rcutils_seqlock_read(&lock, copy, shared + 1, 15u);
+  EXPECT_STREQ(data, copy);
+  EXPECT_EQ(2u, lock.sequence);
+}
+
+TEST(TestLock, seqlock_consistent_reads) {
+  struct data_t
+  {
+    uint64_t values[8];
+  };
+  rcutils_seqlock_t lock = rcutils_get_zero_initialized_seqlock();
+  data_t shared = {};
+  std::atomic_bool done(false);
+
+  // Readers always see all the values written together
+  constexpr size_t reader_count = 2;
+  std::atomic_size_t inconsistent_reads(0);
+  std::vector<std::thread> readers;
+  for (size_t i = 0; i < reader_count; ++i) {
+    readers.emplace_back(
+      [&]() {
+        while (!done) {
+          data_t copy;
+          rcutils_seqlock_read(&lock, &copy, &shared, sizeof(copy));
+          for (uint64_t value : copy.values) {
+            if (value != copy.values[0]) {
+              ++inconsistent_reads;
+            }
+          }
+        }
+      });
+  }
+  std::vector<std::thread> writers;
+  for (size_t i = 0; i < 2; ++i) {
+    writers.emplace_back(
+      [&lock, &shared, i]() {
+        for (uint64_t j = 0; j < 20000; ++j) {
+          data_t update;
+          for (uint64_t & value : update.values) {
+            value = j * 2u + i;
+          }
+          rcutils_seqlock_write(&lock, &shared, &update, sizeof(update));
+        }
+      });
+  }
+  for (std::thread & writer : writers) {
+    writer.join();
+  }
+  done = true;
+  for (std::thread & reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(0u, inconsistent_reads);
+  EXPECT_EQ(80000u, lock.sequence);
+}
@@ -14,12 +14,17 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "./allocator_testing_utils.h"
 #include "osrf_testing_tools_cpp/scope_exit.hpp"
+#include "rcutils/env.h"
 #include "rcutils/logging.h"
+#include "rcutils/logging_statistics.h"
+#include "rcutils/thread.h"
 
 #ifdef RMW_IMPLEMENTATION
 # define CLASSNAME_(NAME, SUFFIX) NAME ## __ ## SUFFIX
@@ -48,10 +53,11 @@ TEST(CLASSNAME(TestLogging, RMW_IMPLEMENTATION), test_logging_initialization) {
     RCUTILS_RET_INVALID_ARGUMENT, rcutils_logging_initialize_with_allocator(empty_allocator));
 
   // Testing with a bad allocator fails when allocating internal memory
-  // for the string map relating severity level values to string
+  // for the map relating logger names to severity levels
   rcutils_allocator_t failing_allocator = get_failing_allocator();
   EXPECT_EQ(
-    RCUTILS_RET_STRING_MAP_INVALID, rcutils_logging_initialize_with_allocator(failing_allocator));
+    RCUTILS_RET_LOGGING_SEVERITY_MAP_INVALID,
+    rcutils_logging_initialize_with_allocator(failing_allocator));
 }
 
 size_t g_log_calls = 0;
@@ -181,10 +187,52 @@ TEST(CLASSNAME(TestLogging, RMW_IMPLEMENTATION), test_log_severity) {
     RCUTILS_RET_LOGGING_SEVERITY_STRING_INVALID,
     rcutils_logging_severity_level_from_string("unknown", allocator, &severity));
 
+  ASSERT_EQ(
+    RCUTILS_RET_LOGGING_SEVERITY_STRING_INVALID,
+    rcutils_logging_severity_level_from_string("", allocator, &severity));
+  ASSERT_EQ(
+    RCUTILS_RET_LOGGING_SEVERITY_STRING_INVALID,
+    rcutils_logging_severity_level_from_string("INFOS", allocator, &severity));
+  ASSERT_EQ(
+    RCUTILS_RET_LOGGING_SEVERITY_STRING_INVALID,
+    rcutils_logging_severity_level_from_string("ERRO", allocator, &severity));
+  ASSERT_EQ(
+    RCUTILS_RET_LOGGING_SEVERITY_STRING_INVALID,
+    rcutils_logging_severity_level_from_string("D3BUG", allocator, &severity));
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_logging_severity_level_from_string(nullptr, allocator, &severity));
+  rcutils_reset_error();
+
+  // No memory is allocated.
   rcutils_allocator_t failing_allocator = get_failing_allocator();
   EXPECT_EQ(
-    RCUTILS_RET_BAD_ALLOC,
+    RCUTILS_RET_OK,
     rcutils_logging_severity_level_from_string("Info", failing_allocator, &severity));
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_INFO, severity);
+
+  // Parts of strings, not null terminated.
+  const char * levels = "warnDebugfatal";
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_severity_level_from_stringn(levels, 4, &severity));
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_WARN, severity);
+  ASSERT_EQ(
+    RCUTILS_RET_OK, rcutils_logging_severity_level_from_stringn(levels + 4, 5, &severity));
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_DEBUG, severity);
+  ASSERT_EQ(
+    RCUTILS_RET_OK, rcutils_logging_severity_level_from_stringn(levels + 9, 5, &severity));
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_FATAL, severity);
+  EXPECT_EQ(
+    RCUTILS_RET_LOGGING_SEVERITY_STRING_INVALID,
+    rcutils_logging_severity_level_from_stringn(levels, 5, &severity));
+  EXPECT_EQ(
+    RCUTILS_RET_LOGGING_SEVERITY_STRING_INVALID,
+    rcutils_logging_severity_level_from_stringn(levels, 0, &severity));
+  EXPECT_EQ(
+    RCUTILS_RET_LOGGING_SEVERITY_STRING_INVALID,
+    rcutils_logging_severity_level_from_stringn("IN\0O", 4, &severity));
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_logging_severity_level_from_stringn(levels, 4, nullptr));
+  rcutils_reset_error();
 }
 
 TEST(CLASSNAME(TestLogging, RMW_IMPLEMENTATION), test_logger_severities) {
@@ -328,3 +376,569 @@ TEST(CLASSNAME(TestLogging, RMW_IMPLEMENTATION), test_logger_severity_hierarchy)
     rcutils_test_logging_cpp_dot_severity,
     rcutils_logging_get_logger_effective_level("rcutils_test_logging_cpp.."));
 }
+
+TEST(CLASSNAME(TestLogging, RMW_IMPLEMENTATION), test_logger_severity_many_loggers) {
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_initialize());
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_shutdown());
+  });
+
+  const int severities[] = {
+    RCUTILS_LOG_SEVERITY_DEBUG, RCUTILS_LOG_SEVERITY_INFO, RCUTILS_LOG_SEVERITY_WARN,
+    RCUTILS_LOG_SEVERITY_ERROR, RCUTILS_LOG_SEVERITY_FATAL};
+  const size_t num_severities = sizeof(severities) / sizeof(severities[0]);
+  const size_t num_loggers = 200u;
+  for (size_t i = 0; i < num_loggers; ++i) {
+    std::string name = "rcutils_test_logging_cpp.logger" + std::to_string(i);
+    ASSERT_EQ(
+      RCUTILS_RET_OK,
+      rcutils_logging_set_logger_level(name.c_str(), severities[i % num_severities]));
+  }
+  for (size_t i = 0; i < num_loggers; ++i) {
+    std::string name = "rcutils_test_logging_cpp.logger" + std::to_string(i);
+    EXPECT_EQ(severities[i % num_severities], rcutils_logging_get_logger_level(name.c_str()));
+  }
+  // A name that is only a prefix of a configured logger name is not configured itself.
+  EXPECT_EQ(
+    RCUTILS_LOG_SEVERITY_UNSET,
+    rcutils_logging_get_logger_leveln("rcutils_test_logging_cpp.logger1", 30u));
+
+  // Overwriting the level of an existing logger keeps a single entry for it.
+  ASSERT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_logging_set_logger_level(
+      "rcutils_test_logging_cpp.logger0", RCUTILS_LOG_SEVERITY_FATAL));
+  EXPECT_EQ(
+    RCUTILS_LOG_SEVERITY_FATAL,
+    rcutils_logging_get_logger_level("rcutils_test_logging_cpp.logger0"));
+  ASSERT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_logging_set_logger_level(
+      "rcutils_test_logging_cpp.logger0", RCUTILS_LOG_SEVERITY_UNSET));
+  EXPECT_EQ(
+    RCUTILS_LOG_SEVERITY_UNSET,
+    rcutils_logging_get_logger_level("rcutils_test_logging_cpp.logger0"));
+  EXPECT_EQ(
+    RCUTILS_LOG_SEVERITY_INFO,
+    rcutils_logging_get_logger_effective_level("rcutils_test_logging_cpp.logger0"));
+}
+
+TEST(CLASSNAME(TestLogging, RMW_IMPLEMENTATION), test_logger_effective_level_changes) {
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_initialize());
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_shutdown());
+  });
+
+  const char * name = "rcutils_test_logging_cpp.testing.x";
+  rcutils_logging_set_default_logger_level(RCUTILS_LOG_SEVERITY_INFO);
+  // Query twice so that the second time the previously resolved level is used.
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_INFO, rcutils_logging_get_logger_effective_level(name));
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_INFO, rcutils_logging_get_logger_effective_level(name));
+  EXPECT_FALSE(rcutils_logging_logger_is_enabled_for(name, RCUTILS_LOG_SEVERITY_DEBUG));
+  // Querying a logger doesn't set its level.
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_UNSET, rcutils_logging_get_logger_level(name));
+
+  // Changes of the default level are honored.
+  rcutils_logging_set_default_logger_level(RCUTILS_LOG_SEVERITY_DEBUG);
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_DEBUG, rcutils_logging_get_logger_effective_level(name));
+  EXPECT_TRUE(rcutils_logging_logger_is_enabled_for(name, RCUTILS_LOG_SEVERITY_DEBUG));
+  g_rcutils_logging_default_logger_level = RCUTILS_LOG_SEVERITY_WARN;
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_WARN, rcutils_logging_get_logger_effective_level(name));
+
+  // Changes of the level of an ancestor are honored.
+  ASSERT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_logging_set_logger_level("rcutils_test_logging_cpp", RCUTILS_LOG_SEVERITY_ERROR));
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_ERROR, rcutils_logging_get_logger_effective_level(name));
+  ASSERT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_logging_set_logger_level(
+      "rcutils_test_logging_cpp.testing", RCUTILS_LOG_SEVERITY_DEBUG));
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_DEBUG, rcutils_logging_get_logger_effective_level(name));
+  EXPECT_EQ(
+    RCUTILS_LOG_SEVERITY_ERROR,
+    rcutils_logging_get_logger_effective_level("rcutils_test_logging_cpp.other"));
+  ASSERT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_logging_set_logger_level(
+      "rcutils_test_logging_cpp.testing", RCUTILS_LOG_SEVERITY_UNSET));
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_ERROR, rcutils_logging_get_logger_effective_level(name));
+
+  // Changes of the level of the logger itself are honored.
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_set_logger_level(name, RCUTILS_LOG_SEVERITY_FATAL));
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_FATAL, rcutils_logging_get_logger_effective_level(name));
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_FATAL, rcutils_logging_get_logger_level(name));
+
+  // A name at the address of another one isn't given the level resolved for the other one.
+  char reused_name[] = "rcutils_test_logging_cpp.testing.y";
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_ERROR, rcutils_logging_get_logger_effective_level(reused_name));
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_ERROR, rcutils_logging_get_logger_effective_level(reused_name));
+  reused_name[sizeof(reused_name) - 2u] = 'x';
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_FATAL, rcutils_logging_get_logger_effective_level(reused_name));
+}
+
+TEST(CLASSNAME(TestLogging, RMW_IMPLEMENTATION), test_lowest_enabled_severity) {
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_initialize());
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_shutdown());
+    EXPECT_EQ(RCUTILS_LOG_SEVERITY_UNSET, g_rcutils_logging_lowest_enabled_severity);
+  });
+
+  rcutils_logging_set_default_logger_level(RCUTILS_LOG_SEVERITY_WARN);
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_WARN, g_rcutils_logging_lowest_enabled_severity);
+
+  // The lowest of the levels set for loggers counts, whatever their depth.
+  const char * name = "rcutils_test_logging_cpp.lowest.x";
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_set_logger_level(name, RCUTILS_LOG_SEVERITY_ERROR));
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_WARN, g_rcutils_logging_lowest_enabled_severity);
+  ASSERT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_logging_set_logger_level("rcutils_test_logging_cpp.lowest", RCUTILS_LOG_SEVERITY_INFO));
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_INFO, g_rcutils_logging_lowest_enabled_severity);
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_set_logger_level(name, RCUTILS_LOG_SEVERITY_DEBUG));
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_DEBUG, g_rcutils_logging_lowest_enabled_severity);
+  // Unset levels are inherited, so they don't count.
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_set_logger_level(name, RCUTILS_LOG_SEVERITY_UNSET));
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_INFO, g_rcutils_logging_lowest_enabled_severity);
+  ASSERT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_logging_set_logger_level(
+      "rcutils_test_logging_cpp.lowest", RCUTILS_LOG_SEVERITY_UNSET));
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_WARN, g_rcutils_logging_lowest_enabled_severity);
+
+  // Setting the level of the empty name sets the default level.
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_set_logger_level("", RCUTILS_LOG_SEVERITY_FATAL));
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_FATAL, g_rcutils_logging_lowest_enabled_severity);
+  rcutils_logging_set_default_logger_level(RCUTILS_LOG_SEVERITY_UNSET);
+  EXPECT_EQ(RCUTILS_DEFAULT_LOGGER_DEFAULT_LEVEL, g_rcutils_logging_lowest_enabled_severity);
+
+  // The filtered messages must reach the logging system to be counted.
+  rcutils_logging_set_statistics_enabled(true, false);
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_UNSET, g_rcutils_logging_lowest_enabled_severity);
+  rcutils_logging_set_statistics_enabled(false, false);
+  EXPECT_EQ(RCUTILS_DEFAULT_LOGGER_DEFAULT_LEVEL, g_rcutils_logging_lowest_enabled_severity);
+}
+
+TEST(CLASSNAME(TestLogging, RMW_IMPLEMENTATION), test_format_message) {
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_initialize());
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_shutdown());
+  });
+
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  rcutils_char_array_t output_buf;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_char_array_init(&output_buf, 1024, &allocator));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_fini(&output_buf));
+  });
+
+  // Formatting executes the output format parsed on initialization, twice in a row here.
+  for (int i = 0; i < 2; ++i) {
+    output_buf.buffer[0] = '\0';
+    ASSERT_EQ(
+      RCUTILS_RET_OK,
+      rcutils_logging_format_message(
+        NULL, RCUTILS_LOG_SEVERITY_FATAL, "name", 1, "message {name}", &output_buf));
+    EXPECT_STREQ("[FATAL] [0000000000.000000001] [name]: message {name}", output_buf.buffer);
+  }
+
+  // The timestamps are rendered like rcutils_time_point_value_as_seconds_string() does,
+  // including when the seconds change or not between messages.
+  const rcutils_time_point_value_t timestamps[] = {
+    0, 999999999, 1000000000, 1000000001, 1596554525123456789, 1596554525987654321,
+    1596554526000000000, -1, -1000000000, -1596554525123456789, INT64_MAX, INT64_MIN + 1,
+  };
+  for (rcutils_time_point_value_t timestamp : timestamps) {
+    char expected_time[32];
+    ASSERT_EQ(
+      RCUTILS_RET_OK,
+      rcutils_time_point_value_as_seconds_string(&timestamp, expected_time, sizeof(expected_time)));
+    output_buf.buffer[0] = '\0';
+    ASSERT_EQ(
+      RCUTILS_RET_OK,
+      rcutils_logging_format_message(
+        NULL, RCUTILS_LOG_SEVERITY_INFO, "name", timestamp, "message", &output_buf));
+    EXPECT_EQ(
+      std::string("[INFO] [") + expected_time + "] [name]: message",
+      std::string(output_buf.buffer)) << timestamp;
+  }
+}
+
+TEST(CLASSNAME(TestLogging, RMW_IMPLEMENTATION), test_format_compact_time) {
+  ASSERT_TRUE(rcutils_set_env("RCUTILS_CONSOLE_OUTPUT_FORMAT", "{time_ms} {time_us}"));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_TRUE(rcutils_set_env("RCUTILS_CONSOLE_OUTPUT_FORMAT", NULL));
+  });
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_initialize());
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_shutdown());
+  });
+
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  rcutils_char_array_t output_buf;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_char_array_init(&output_buf, 1024, &allocator));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_fini(&output_buf));
+  });
+  ASSERT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_logging_format_message(
+      NULL, RCUTILS_LOG_SEVERITY_INFO, "name", 1596554525123456789, "message", &output_buf));
+  EXPECT_STREQ("1596554525.123 1596554525.123456", output_buf.buffer);
+  output_buf.buffer[0] = '\0';
+  ASSERT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_logging_format_message(
+      NULL, RCUTILS_LOG_SEVERITY_INFO, "name", -1, "message", &output_buf));
+  EXPECT_STREQ("-0000000000.000 -0000000000.000000", output_buf.buffer);
+}
+
+TEST(CLASSNAME(TestLogging, RMW_IMPLEMENTATION), test_format_thread) {
+  ASSERT_TRUE(rcutils_set_env("RCUTILS_CONSOLE_OUTPUT_FORMAT", "{thread_id} {thread_name}"));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_TRUE(rcutils_set_env("RCUTILS_CONSOLE_OUTPUT_FORMAT", NULL));
+  });
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_initialize());
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_shutdown());
+  });
+
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  rcutils_char_array_t output_buf;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_char_array_init(&output_buf, 1024, &allocator));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_fini(&output_buf));
+  });
+  ASSERT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_logging_format_message(
+      NULL, RCUTILS_LOG_SEVERITY_INFO, "name", 1, "message", &output_buf));
+  std::string main_output = output_buf.buffer;
+  EXPECT_EQ(
+    std::to_string(rcutils_thread_get_id()) + " " + rcutils_thread_get_cached_name(),
+    main_output);
+
+  // Each thread formats its own identity, and its name once it's changed
+  std::thread thread(
+    [&output_buf, &main_output]() {
+      if (RCUTILS_RET_OK != rcutils_thread_set_name("log_thread")) {
+        rcutils_reset_error();
+      }
+      output_buf.buffer[0] = '\0';
+      ASSERT_EQ(
+        RCUTILS_RET_OK,
+        rcutils_logging_format_message(
+          NULL, RCUTILS_LOG_SEVERITY_INFO, "name", 1, "message", &output_buf));
+      EXPECT_EQ(
+        std::to_string(rcutils_thread_get_id()) + " " + rcutils_thread_get_cached_name(),
+        std::string(output_buf.buffer));
+      EXPECT_NE(main_output, output_buf.buffer);
+    });
+  thread.join();
+}
+
+static rcutils_time_point_value_t g_last_timestamp = 0;
+
+TEST(CLASSNAME(TestLogging, RMW_IMPLEMENTATION), test_output_format_without_time) {
+  // The console output handler isn't passed a timestamp it doesn't use, other handlers are.
+  ASSERT_TRUE(rcutils_set_env("RCUTILS_CONSOLE_OUTPUT_FORMAT", "{severity}:{message}"));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_TRUE(rcutils_set_env("RCUTILS_CONSOLE_OUTPUT_FORMAT", NULL));
+  });
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_initialize());
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_shutdown());
+  });
+  rcutils_logging_output_handler_t original_function = rcutils_logging_get_output_handler();
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    rcutils_logging_set_output_handler(original_function);
+  });
+
+  rcutils_logging_set_output_handler(rcutils_logging_console_output_handler);
+  testing::internal::CaptureStderr();
+  rcutils_log(NULL, RCUTILS_LOG_SEVERITY_INFO, "name", "message %d", 1);
+  EXPECT_EQ("INFO:message 1\n", testing::internal::GetCapturedStderr());
+
+  rcutils_logging_set_output_handler(
+    [](
+      const rcutils_log_location_t *, int, const char *, rcutils_time_point_value_t timestamp,
+      const char *, va_list *) -> void
+    {
+      g_last_timestamp = timestamp;
+    });
+  rcutils_log(NULL, RCUTILS_LOG_SEVERITY_INFO, "name", "message %d", 2);
+  EXPECT_NE(0, g_last_timestamp);
+}
+
+TEST(CLASSNAME(TestLogging, RMW_IMPLEMENTATION), test_console_output_around_message) {
+  // On stderr, the message is written between the output before and after it with writev().
+  ASSERT_TRUE(rcutils_set_env("RCUTILS_CONSOLE_OUTPUT_FORMAT", "<{message}> [{severity}]"));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_TRUE(rcutils_set_env("RCUTILS_CONSOLE_OUTPUT_FORMAT", NULL));
+  });
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_initialize());
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_shutdown());
+  });
+  rcutils_logging_output_handler_t original_function = rcutils_logging_get_output_handler();
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    rcutils_logging_set_output_handler(original_function);
+  });
+  rcutils_logging_set_output_handler(rcutils_logging_console_output_handler);
+
+  std::string long_message(10000u, 'x');
+  testing::internal::CaptureStderr();
+  rcutils_log(NULL, RCUTILS_LOG_SEVERITY_WARN, "name", "message %d", 1);
+  rcutils_log(NULL, RCUTILS_LOG_SEVERITY_INFO, "name", "%s", long_message.c_str());
+  EXPECT_EQ(
+    "<message 1> [WARN]\n<" + long_message + "> [INFO]\n", testing::internal::GetCapturedStderr());
+}
+
+TEST(CLASSNAME(TestLogging, RMW_IMPLEMENTATION), test_logger_rate_limit_and_sampling) {
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_initialize());
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_shutdown());
+  });
+
+  static std::vector<std::string> messages;
+  messages.clear();
+  auto handler = [](
+    const rcutils_log_location_t * location,
+    int level, const char * name, rcutils_time_point_value_t timestamp,
+    const char * format, va_list * args) -> void
+    {
+      (void)location;
+      (void)level;
+      (void)name;
+      (void)timestamp;
+      char buffer[1024];
+      vsnprintf(buffer, sizeof(buffer), format, *args);
+      messages.push_back(buffer);
+    };
+  rcutils_logging_output_handler_t original_function = rcutils_logging_get_output_handler();
+  rcutils_logging_set_output_handler(handler);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    rcutils_logging_set_output_handler(original_function);
+  });
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_set_logger_level("sampled", RCUTILS_LOG_SEVERITY_INFO));
+
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_logging_set_logger_rate_limit(NULL, 1u, 1u));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_logging_set_logger_rate_limit("", 1u, 1u));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_logging_set_logger_rate_limit("limited", 1u, 0u));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_logging_set_logger_sampling(NULL, 2u));
+  rcutils_reset_error();
+
+  // Every third message is logged, each one after the first reporting the ones dropped.
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_set_logger_sampling("sampled", 3u));
+  for (int i = 0; i < 9; ++i) {
+    rcutils_log(NULL, RCUTILS_LOG_SEVERITY_INFO, "sampled", "message %d", i);
+  }
+  std::vector<std::string> expected = {
+    "message 0",
+    "suppressed 2 messages", "message 3",
+    "suppressed 2 messages", "message 6",
+  };
+  EXPECT_EQ(expected, messages);
+  // Messages filtered by severity are not counted.
+  messages.clear();
+  rcutils_log(NULL, RCUTILS_LOG_SEVERITY_DEBUG, "sampled", "debug");
+  rcutils_log(NULL, RCUTILS_LOG_SEVERITY_INFO, "sampled", "message %d", 9);
+  expected = {"suppressed 2 messages", "message 9"};
+  EXPECT_EQ(expected, messages);
+  // Other loggers, including descendants, are not sampled.
+  messages.clear();
+  rcutils_log(NULL, RCUTILS_LOG_SEVERITY_INFO, "sampled.child", "child");
+  rcutils_log(NULL, RCUTILS_LOG_SEVERITY_INFO, "other", "other");
+  expected = {"child", "other"};
+  EXPECT_EQ(expected, messages);
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_set_logger_sampling("sampled", 1u));
+  messages.clear();
+  rcutils_log(NULL, RCUTILS_LOG_SEVERITY_INFO, "sampled", "a");
+  rcutils_log(NULL, RCUTILS_LOG_SEVERITY_INFO, "sampled", "b");
+  expected = {"a", "b"};
+  EXPECT_EQ(expected, messages);
+
+  // A burst of three messages passes, the following ones within the second are dropped.
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_set_logger_rate_limit("limited", 1u, 3u));
+  messages.clear();
+  for (int i = 0; i < 10; ++i) {
+    rcutils_log(NULL, RCUTILS_LOG_SEVERITY_INFO, "limited", "message %d", i);
+  }
+  expected = {"message 0", "message 1", "message 2"};
+  EXPECT_EQ(expected, messages);
+  // Setting the limit again resets it, the next message reports the dropped ones.
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_set_logger_rate_limit("limited", 1000000u, 1u));
+  messages.clear();
+  rcutils_log(NULL, RCUTILS_LOG_SEVERITY_INFO, "limited", "message %d", 10);
+  expected = {"suppressed 7 messages", "message 10"};
+  EXPECT_EQ(expected, messages);
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_set_logger_rate_limit("limited", 0u, 1u));
+  messages.clear();
+  for (int i = 0; i < 3; ++i) {
+    rcutils_log(NULL, RCUTILS_LOG_SEVERITY_INFO, "limited", "message %d", i);
+  }
+  EXPECT_EQ(3u, messages.size());
+
+  // The limits are kept when changing the level of the logger.
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_set_logger_sampling("limited", 2u));
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_set_logger_level("limited", RCUTILS_LOG_SEVERITY_WARN));
+  messages.clear();
+  rcutils_log(NULL, RCUTILS_LOG_SEVERITY_WARN, "limited", "a");
+  rcutils_log(NULL, RCUTILS_LOG_SEVERITY_WARN, "limited", "b");
+  expected = {"a"};
+  EXPECT_EQ(expected, messages);
+}
+
+TEST(CLASSNAME(TestLogging, RMW_IMPLEMENTATION), test_logger_levels_concurrent_updates) {
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_initialize());
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_shutdown());
+  });
+  rcutils_logging_output_handler_t original_function = rcutils_logging_get_output_handler();
+  rcutils_logging_set_output_handler(
+    [](
+      const rcutils_log_location_t *, int, const char *, rcutils_time_point_value_t,
+      const char *, va_list *) -> void {});
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    rcutils_logging_set_output_handler(original_function);
+  });
+
+  // Readers always see either level, never a partially updated state, while a writer keeps
+  // setting the levels of new and existing loggers.
+  ASSERT_EQ(
+    RCUTILS_RET_OK, rcutils_logging_set_logger_level("concurrent", RCUTILS_LOG_SEVERITY_INFO));
+  std::atomic<bool> done(false);
+  std::atomic<size_t> unexpected(0u);
+  // Shared by the readers like the handle of a logging macro call site.
+  rcutils_logger_t shared_handle = rcutils_get_zero_initialized_logger();
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; ++i) {
+    readers.emplace_back(
+      [&done, &unexpected, &shared_handle]() {
+        rcutils_logger_t handle = rcutils_get_zero_initialized_logger();
+        if (RCUTILS_RET_OK != rcutils_logging_get_logger("concurrent.child", &handle)) {
+          ++unexpected;
+        }
+        while (!done) {
+          if (!rcutils_logging_cached_logger_is_enabled_for(
+              &shared_handle, "concurrent.child", RCUTILS_LOG_SEVERITY_FATAL))
+          {
+            ++unexpected;
+          }
+          int level = rcutils_logging_get_logger_effective_level("concurrent.child");
+          if (RCUTILS_LOG_SEVERITY_INFO != level && RCUTILS_LOG_SEVERITY_ERROR != level) {
+            ++unexpected;
+          }
+          rcutils_log(NULL, RCUTILS_LOG_SEVERITY_WARN, "concurrent.child", "message");
+          if (!rcutils_logging_logger_handle_is_enabled_for(&handle, RCUTILS_LOG_SEVERITY_FATAL) ||
+            rcutils_logging_logger_handle_is_enabled_for(&handle, RCUTILS_LOG_SEVERITY_DEBUG))
+          {
+            ++unexpected;
+          }
+        }
+      });
+  }
+  for (int i = 0; i < 200; ++i) {
+    int level = i % 2 ? RCUTILS_LOG_SEVERITY_INFO : RCUTILS_LOG_SEVERITY_ERROR;
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_set_logger_level("concurrent", level));
+    std::string name = "other" + std::to_string(i);
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_set_logger_level(name.c_str(), level));
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_set_logger_sampling("concurrent.child", 2u));
+  }
+  done = true;
+  for (auto & reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(0u, unexpected.load());
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_INFO, rcutils_logging_get_logger_effective_level("concurrent"));
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_ERROR, rcutils_logging_get_logger_level("other198"));
+}
+
+// Count the blocks allocated by the logging system which aren't freed yet.
+static std::atomic<size_t> g_live_allocations(0u);
+
+static void * counting_allocate(size_t size, void *)
+{
+  ++g_live_allocations;
+  return rcutils_get_default_allocator().allocate(size, rcutils_get_default_allocator().state);
+}
+
+static void counting_deallocate(void * pointer, void *)
+{
+  if (nullptr != pointer) {
+    --g_live_allocations;
+  }
+  rcutils_get_default_allocator().deallocate(pointer, rcutils_get_default_allocator().state);
+}
+
+static void * counting_reallocate(void * pointer, size_t size, void *)
+{
+  if (nullptr == pointer) {
+    ++g_live_allocations;
+  }
+  return rcutils_get_default_allocator().reallocate(
+    pointer, size, rcutils_get_default_allocator().state);
+}
+
+static void * counting_zero_allocate(size_t number_of_elements, size_t size_of_element, void *)
+{
+  ++g_live_allocations;
+  return rcutils_get_default_allocator().zero_allocate(
+    number_of_elements, size_of_element, rcutils_get_default_allocator().state);
+}
+
+TEST(CLASSNAME(TestLogging, RMW_IMPLEMENTATION), test_retired_logger_levels_are_freed) {
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  allocator.allocate = counting_allocate;
+  allocator.deallocate = counting_deallocate;
+  allocator.reallocate = counting_reallocate;
+  allocator.zero_allocate = counting_zero_allocate;
+  allocator.state = nullptr;
+  allocator.aligned_allocate = nullptr;
+  allocator.aligned_deallocate = nullptr;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_initialize_with_allocator(allocator));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_shutdown());
+  });
+
+  ASSERT_EQ(
+    RCUTILS_RET_OK, rcutils_logging_set_logger_level("retired", RCUTILS_LOG_SEVERITY_WARN));
+  size_t live_after_first_change = g_live_allocations.load();
+
+  // Each change replaces the snapshot of the logger levels, and the limiter for the sampling,
+  // which are freed by the next changes, as no reader holds them.
+  for (int i = 0; i < 1000; ++i) {
+    int level = i % 2 ? RCUTILS_LOG_SEVERITY_INFO : RCUTILS_LOG_SEVERITY_ERROR;
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_set_logger_level("retired", level));
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_set_logger_sampling("retired", 2u + i % 2));
+  }
+  EXPECT_EQ(
+    RCUTILS_RET_OK, rcutils_logging_set_logger_level("retired", RCUTILS_LOG_SEVERITY_WARN));
+  EXPECT_LE(g_live_allocations.load(), live_after_first_change + 1u);
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_WARN, rcutils_logging_get_logger_level("retired"));
+}
@@ -0,0 +1,330 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "osrf_testing_tools_cpp/scope_exit.hpp"
+#include "rcutils/env.h"
+#include "rcutils/error_handling.h"
+#include "rcutils/logging.h"
+#include "rcutils/logging_async.h"
+
+static void call_handler(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  rcutils_logging_async_output_handler(location, severity, name, timestamp, format, &args);
+  va_end(args);
+}
+
+static void log_messages(size_t count)
+{
+  rcutils_log_location_t log_location = {"test_function", "test_file", 1};
+  for (size_t i = 0; i < count; ++i) {
+    call_handler(&log_location, RCUTILS_LOG_SEVERITY_INFO, "async", 1, "message %zu", i);
+  }
+}
+
+class TestLoggingAsync : public ::testing::Test
+{
+public:
+  void SetUp()
+  {
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_initialize());
+    options = rcutils_logging_async_get_default_options();
+  }
+
+  void TearDown()
+  {
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_async_stop());
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_shutdown());
+  }
+
+  rcutils_logging_async_options_t options;
+};
+
+TEST_F(TestLoggingAsync, start_bad_arguments) {
+  rcutils_allocator_t allocator = rcutils_get_zero_initialized_allocator();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_logging_async_start(&options, allocator));
+  rcutils_reset_error();
+  allocator = rcutils_get_default_allocator();
+
+  options.queue_capacity = 0u;
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_logging_async_start(&options, allocator));
+  rcutils_reset_error();
+  options = rcutils_logging_async_get_default_options();
+
+  options.max_record_size = 1u;
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_logging_async_start(&options, allocator));
+  rcutils_reset_error();
+  options = rcutils_logging_async_get_default_options();
+
+  options.overflow_policy = static_cast<rcutils_logging_async_overflow_policy_t>(42);
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_logging_async_start(&options, allocator));
+  rcutils_reset_error();
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_async_start(NULL, allocator));
+  EXPECT_EQ(RCUTILS_RET_ERROR, rcutils_logging_async_start(NULL, allocator));
+  rcutils_reset_error();
+
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_logging_async_get_statistics(NULL));
+  rcutils_reset_error();
+}
+
+TEST_F(TestLoggingAsync, start_not_initialized) {
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_shutdown());
+  EXPECT_EQ(
+    RCUTILS_RET_NOT_INITIALIZED,
+    rcutils_logging_async_start(&options, rcutils_get_default_allocator()));
+  rcutils_reset_error();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_initialize());
+}
+
+TEST_F(TestLoggingAsync, not_started) {
+  // Falls back to the console output handler.
+  log_messages(1u);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_async_flush());
+  rcutils_logging_async_statistics_t statistics;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_async_get_statistics(&statistics));
+  EXPECT_EQ(0u, statistics.enqueued);
+}
+
+TEST_F(TestLoggingAsync, records_are_written_in_order) {
+  options.overflow_policy = RCUTILS_LOGGING_ASYNC_OVERFLOW_BLOCK;
+  options.queue_capacity = 4u;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_async_start(&options, rcutils_get_default_allocator()));
+
+  testing::internal::CaptureStderr();
+  log_messages(100u);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_async_stop());
+  std::string output = testing::internal::GetCapturedStderr();
+
+  size_t position = 0u;
+  for (size_t i = 0; i < 100u; ++i) {
+    std::string expected = "message " + std::to_string(i) + "\n";
+    size_t found = output.find(expected, position);
+    ASSERT_NE(std::string::npos, found) << expected;
+    position = found + expected.size();
+  }
+
+  rcutils_logging_async_statistics_t statistics;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_async_get_statistics(&statistics));
+  EXPECT_EQ(100u, statistics.enqueued);
+  EXPECT_EQ(100u, statistics.written);
+  EXPECT_EQ(0u, statistics.dropped);
+  EXPECT_EQ(0u, statistics.truncated);
+}
+
+TEST_F(TestLoggingAsync, drop_newest) {
+  options.overflow_policy = RCUTILS_LOGGING_ASYNC_OVERFLOW_DROP_NEWEST;
+  options.queue_capacity = 2u;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_async_start(&options, rcutils_get_default_allocator()));
+
+  log_messages(1000u);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_async_flush());
+
+  rcutils_logging_async_statistics_t statistics;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_async_get_statistics(&statistics));
+  EXPECT_EQ(1000u, statistics.enqueued + statistics.dropped);
+  EXPECT_EQ(statistics.enqueued, statistics.written);
+}
+
+TEST_F(TestLoggingAsync, drop_oldest) {
+  options.overflow_policy = RCUTILS_LOGGING_ASYNC_OVERFLOW_DROP_OLDEST;
+  options.queue_capacity = 2u;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_async_start(&options, rcutils_get_default_allocator()));
+
+  log_messages(1000u);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_async_flush());
+
+  rcutils_logging_async_statistics_t statistics;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_async_get_statistics(&statistics));
+  EXPECT_EQ(1000u, statistics.enqueued);
+  EXPECT_EQ(1000u, statistics.written + statistics.dropped);
+}
+
+TEST_F(TestLoggingAsync, truncated_records) {
+  options.overflow_policy = RCUTILS_LOGGING_ASYNC_OVERFLOW_BLOCK;
+  options.max_record_size = 8u;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_async_start(&options, rcutils_get_default_allocator()));
+
+  testing::internal::CaptureStderr();
+  rcutils_log_location_t log_location = {"test_function", "test_file", 1};
+  call_handler(&log_location, RCUTILS_LOG_SEVERITY_INFO, "async", 1, "long message");
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_async_stop());
+  std::string output = testing::internal::GetCapturedStderr();
+  EXPECT_EQ(8u, output.size());
+  EXPECT_EQ('\n', output.back());
+
+  rcutils_logging_async_statistics_t statistics;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_async_get_statistics(&statistics));
+  EXPECT_EQ(1u, statistics.truncated);
+}
+
+TEST_F(TestLoggingAsync, multiple_producers) {
+  options.overflow_policy = RCUTILS_LOGGING_ASYNC_OVERFLOW_BLOCK;
+  options.queue_capacity = 16u;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_async_start(&options, rcutils_get_default_allocator()));
+
+  testing::internal::CaptureStderr();
+  std::vector<std::thread> producers;
+  for (size_t i = 0; i < 4u; ++i) {
+    producers.emplace_back(log_messages, 250u);
+  }
+  for (std::thread & producer : producers) {
+    producer.join();
+  }
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_async_flush());
+  std::string output = testing::internal::GetCapturedStderr();
+
+  size_t lines = 0u;
+  for (char c : output) {
+    lines += '\n' == c ? 1u : 0u;
+  }
+  EXPECT_EQ(1000u, lines);
+
+  rcutils_logging_async_statistics_t statistics;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_async_get_statistics(&statistics));
+  EXPECT_EQ(1000u, statistics.enqueued);
+  EXPECT_EQ(1000u, statistics.written);
+  EXPECT_EQ(0u, statistics.dropped);
+}
+
+#define LOG_VARIOUS_ARGUMENTS(handler) \
+  do { \
+    rcutils_log_location_t log_location = {"test_function", "test_file", 1}; \
+    handler(&log_location, RCUTILS_LOG_SEVERITY_INFO, "async", 1, "%% no arguments"); \
+    handler( \
+      &log_location, RCUTILS_LOG_SEVERITY_WARN, "async", 2, "%d %hhd %ld %lld %zu %jd %td", \
+      -1, 300, -2L, 3LL, static_cast<size_t>(4u), static_cast<intmax_t>(5), \
+      static_cast<ptrdiff_t>(-6)); \
+    handler( \
+      &log_location, RCUTILS_LOG_SEVERITY_ERROR, NULL, 3, "%5.2f|%-8e|%g|%Lf|%c|%#x|%o|%p", \
+      3.14159, 2.5, 1e-7, 1.5L, 'x', 255u, 8u, reinterpret_cast<void *>(0x1234)); \
+    handler( \
+      &log_location, RCUTILS_LOG_SEVERITY_DEBUG, "async.child", 4, "%s|%10s|%.3s|%*d|%-*.*s", \
+      "string", "right", "truncated", 6, 42, 8, 2, "precision"); \
+    handler(&log_location, RCUTILS_LOG_SEVERITY_INFO, "async", 5, "%ls", L"wide"); \
+  } while (0)
+
+static void call_console_handler(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  rcutils_logging_console_output_handler(location, severity, name, timestamp, format, &args);
+  va_end(args);
+}
+
+TEST_F(TestLoggingAsync, deferred_formatting) {
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_set_logger_level("", RCUTILS_LOG_SEVERITY_DEBUG));
+  testing::internal::CaptureStderr();
+  LOG_VARIOUS_ARGUMENTS(call_console_handler);
+  std::string expected = testing::internal::GetCapturedStderr();
+
+  options.overflow_policy = RCUTILS_LOGGING_ASYNC_OVERFLOW_BLOCK;
+  options.defer_formatting = true;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_async_start(&options, rcutils_get_default_allocator()));
+  testing::internal::CaptureStderr();
+  LOG_VARIOUS_ARGUMENTS(call_handler);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_async_stop());
+  std::string output = testing::internal::GetCapturedStderr();
+  EXPECT_EQ(expected, output);
+
+  rcutils_logging_async_statistics_t statistics;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_async_get_statistics(&statistics));
+  EXPECT_EQ(5u, statistics.enqueued);
+  EXPECT_EQ(5u, statistics.written);
+}
+
+TEST_F(TestLoggingAsync, deferred_formatting_copies_location) {
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_shutdown());
+  ASSERT_TRUE(
+    rcutils_set_env(
+      "RCUTILS_CONSOLE_OUTPUT_FORMAT", "{function_name}:{file_name}:{line_number} {message}"));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_TRUE(rcutils_set_env("RCUTILS_CONSOLE_OUTPUT_FORMAT", NULL));
+  });
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_initialize());
+
+  options.queue_capacity = 4096u;
+  options.overflow_policy = RCUTILS_LOGGING_ASYNC_OVERFLOW_BLOCK;
+  options.defer_formatting = true;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_async_start(&options, rcutils_get_default_allocator()));
+  testing::internal::CaptureStderr();
+  // Keep the writer thread busy while the location is overwritten
+  log_messages(2000u);
+  {
+    // Like the locations of bindings, which live on the stack of the caller
+    rcutils_log_location_t log_location = {"test_function", "test_file", 1};
+    call_handler(&log_location, RCUTILS_LOG_SEVERITY_INFO, "async", 1, "message %d", 2);
+    log_location = {"overwritten", "overwritten", 3};
+    EXPECT_EQ(3u, log_location.line_number);
+  }
+  call_handler(NULL, RCUTILS_LOG_SEVERITY_INFO, NULL, 1, "no location");
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_async_stop());
+  std::string output = testing::internal::GetCapturedStderr();
+  std::string expected = "test_function:test_file:1 message 2\n::0 no location\n";
+  ASSERT_LE(expected.size(), output.size());
+  EXPECT_EQ(expected, output.substr(output.size() - expected.size()));
+}
+
+TEST_F(TestLoggingAsync, deferred_formatting_truncated) {
+  options.overflow_policy = RCUTILS_LOGGING_ASYNC_OVERFLOW_BLOCK;
+  options.defer_formatting = true;
+  options.max_record_size = 8u;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_async_start(&options, rcutils_get_default_allocator()));
+
+  testing::internal::CaptureStderr();
+  rcutils_log_location_t log_location = {"test_function", "test_file", 1};
+  call_handler(&log_location, RCUTILS_LOG_SEVERITY_INFO, "async", 1, "long %s", "message");
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_async_stop());
+  std::string output = testing::internal::GetCapturedStderr();
+  EXPECT_EQ(8u, output.size());
+  EXPECT_EQ('\n', output.back());
+}
+
+TEST_F(TestLoggingAsync, writer_thread_attributes) {
+  rcutils_thread_cpu_set_t cpus = rcutils_get_zero_initialized_thread_cpu_set();
+  rcutils_thread_attributes_t attributes = rcutils_thread_get_default_attributes();
+  options.writer_thread_attributes = &attributes;
+
+  // An empty set of processors can't be bound to, so the writer thread doesn't start
+  attributes.cpus = &cpus;
+  EXPECT_EQ(
+    RCUTILS_RET_ERROR, rcutils_logging_async_start(&options, rcutils_get_default_allocator()));
+  EXPECT_NE(
+    std::string::npos,
+    std::string(rcutils_get_error_string().str).find("attributes of the log writer thread"));
+  rcutils_reset_error();
+
+  attributes.cpus = NULL;
+  attributes.name = "log_writer";
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_async_start(&options, rcutils_get_default_allocator()));
+  testing::internal::CaptureStderr();
+  log_messages(1u);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_async_stop());
+  std::string output = testing::internal::GetCapturedStderr();
+  EXPECT_NE(std::string::npos, output.find("message 0\n"));
+}
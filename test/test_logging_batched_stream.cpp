@@ -0,0 +1,77 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "osrf_testing_tools_cpp/scope_exit.hpp"
+#include "rcutils/logging.h"
+
+static void call_handler(int severity, const char * format, ...)
+{
+  rcutils_log_location_t log_location = {"test_function", "test_file", 1};
+  va_list args;
+  va_start(args, format);
+  rcutils_logging_console_output_handler(
+    &log_location, severity, "batched", 1, format, &args);
+  va_end(args);
+}
+
+static std::string read_available(int fd)
+{
+  std::string output;
+  char buffer[256];
+  ssize_t count = 0;
+  while ((count = read(fd, buffer, sizeof(buffer))) > 0) {
+    output.append(buffer, static_cast<size_t>(count));
+  }
+  return output;
+}
+
+// Run with RCUTILS_LOGGING_STREAM_BUFFER_SIZE set, a flush period long enough for the test to
+// never reach it, and RCUTILS_CONSOLE_OUTPUT_FORMAT set to "{severity}:{message}".
+TEST(TestLoggingBatchedStream, flush_on_severity_and_shutdown) {
+  int pipe_fds[2];
+  ASSERT_EQ(0, pipe(pipe_fds));
+  ASSERT_EQ(0, fcntl(pipe_fds[0], F_SETFL, fcntl(pipe_fds[0], F_GETFL) | O_NONBLOCK));
+  int stderr_fd = dup(fileno(stderr));
+  ASSERT_NE(-1, stderr_fd);
+  ASSERT_NE(-1, dup2(pipe_fds[1], fileno(stderr)));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    fflush(stderr);
+    dup2(stderr_fd, fileno(stderr));
+    close(stderr_fd);
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+  });
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_initialize());
+
+  call_handler(RCUTILS_LOG_SEVERITY_INFO, "first %d", 1);
+  call_handler(RCUTILS_LOG_SEVERITY_DEBUG, "second %d", 2);
+  EXPECT_EQ("", read_available(pipe_fds[0]));
+
+  call_handler(RCUTILS_LOG_SEVERITY_WARN, "third %d", 3);
+  EXPECT_EQ("INFO:first 1\nDEBUG:second 2\nWARN:third 3\n", read_available(pipe_fds[0]));
+
+  call_handler(RCUTILS_LOG_SEVERITY_INFO, "fourth %d", 4);
+  EXPECT_EQ("", read_available(pipe_fds[0]));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_shutdown());
+  EXPECT_EQ("INFO:fourth 4\n", read_available(pipe_fds[0]));
+}
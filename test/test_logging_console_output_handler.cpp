@@ -95,3 +95,32 @@ TEST(TestLoggingConsoleOutputHandler, bad_inputs) {
   call_handler(
     &log_location, RCUTILS_LOG_SEVERITY_INFO, log_name, timestamp, "bad format", "part1", "part2");
 }
+
+// Records longer than the buffer of the calling thread are formatted in allocated memory, and
+// the next ones in the buffer again.
+TEST(TestLoggingConsoleOutputHandler, long_messages) {
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_initialize());
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_shutdown());
+  });
+
+  rcutils_log_location_t log_location = {
+    "test_function",
+    "test_file",
+    1,
+  };
+  const char * log_name = "test_name";
+  rcutils_time_point_value_t timestamp = 1;
+  std::string long_message(4096, 'x');
+
+  testing::internal::CaptureStderr();
+  call_handler(
+    &log_location, RCUTILS_LOG_SEVERITY_WARN, log_name, timestamp, "%s", long_message.c_str());
+  call_handler(
+    &log_location, RCUTILS_LOG_SEVERITY_WARN, log_name, timestamp, "%s", "short message");
+  std::string output = testing::internal::GetCapturedStderr();
+
+  EXPECT_NE(std::string::npos, output.find(long_message + "\n"));
+  EXPECT_NE(std::string::npos, output.find("[test_name]: short message\n"));
+}
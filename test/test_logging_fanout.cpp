@@ -0,0 +1,181 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "rcutils/error_handling.h"
+#include "rcutils/logging.h"
+#include "rcutils/logging_fanout.h"
+
+struct Delivery
+{
+  int severity;
+  std::string name;
+  std::string message;
+  size_t length;
+};
+
+static void recording_sink(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * message, size_t length, void * context)
+{
+  (void)location;
+  (void)timestamp;
+  auto deliveries = static_cast<std::vector<Delivery> *>(context);
+  deliveries->push_back({severity, name, message, length});
+}
+
+static void call_handler(int severity, const char * format, ...)
+{
+  rcutils_log_location_t log_location = {"test_function", "test_file", 1};
+  va_list args;
+  va_start(args, format);
+  rcutils_logging_fanout_output_handler(&log_location, severity, "fanout", 1, format, &args);
+  va_end(args);
+}
+
+class TestLoggingFanout : public ::testing::Test
+{
+public:
+  void SetUp()
+  {
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_initialize());
+  }
+
+  void TearDown()
+  {
+    for (size_t sink_id : sink_ids) {
+      EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_fanout_remove_sink(sink_id));
+    }
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_shutdown());
+  }
+
+  std::vector<size_t> sink_ids;
+};
+
+TEST_F(TestLoggingFanout, bad_arguments) {
+  size_t sink_id = 0u;
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_logging_fanout_add_sink(NULL, RCUTILS_LOG_SEVERITY_INFO, NULL, &sink_id));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_logging_fanout_add_sink(recording_sink, RCUTILS_LOG_SEVERITY_INFO, NULL, NULL));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_logging_fanout_add_sink(recording_sink, -1, NULL, &sink_id));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_logging_fanout_set_sink_severity(0u, RCUTILS_LOG_SEVERITY_INFO));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_logging_fanout_remove_sink(0u));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_logging_fanout_remove_sink(RCUTILS_LOGGING_FANOUT_MAX_SINKS));
+  rcutils_reset_error();
+
+  for (size_t i = 0u; i < RCUTILS_LOGGING_FANOUT_MAX_SINKS; ++i) {
+    ASSERT_EQ(
+      RCUTILS_RET_OK,
+      rcutils_logging_fanout_add_sink(
+        recording_sink, RCUTILS_LOG_SEVERITY_INFO, NULL, &sink_id));
+    sink_ids.push_back(sink_id);
+  }
+  EXPECT_EQ(
+    RCUTILS_RET_ERROR,
+    rcutils_logging_fanout_add_sink(recording_sink, RCUTILS_LOG_SEVERITY_INFO, NULL, &sink_id));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_logging_fanout_set_sink_severity(sink_ids[0], RCUTILS_LOG_SEVERITY_FATAL + 1));
+  rcutils_reset_error();
+}
+
+TEST_F(TestLoggingFanout, severity_filters) {
+  std::vector<Delivery> all;
+  std::vector<Delivery> warnings;
+  size_t sink_id = 0u;
+  ASSERT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_logging_fanout_add_sink(recording_sink, RCUTILS_LOG_SEVERITY_DEBUG, &all, &sink_id));
+  sink_ids.push_back(sink_id);
+  ASSERT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_logging_fanout_add_sink(
+      recording_sink, RCUTILS_LOG_SEVERITY_WARN, &warnings, &sink_id));
+  sink_ids.push_back(sink_id);
+
+  call_handler(RCUTILS_LOG_SEVERITY_DEBUG, "debug %d", 1);
+  call_handler(RCUTILS_LOG_SEVERITY_ERROR, "error %s", "two");
+  ASSERT_EQ(2u, all.size());
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_DEBUG, all[0].severity);
+  EXPECT_EQ("fanout", all[0].name);
+  EXPECT_EQ("debug 1", all[0].message);
+  EXPECT_EQ(7u, all[0].length);
+  EXPECT_EQ("error two", all[1].message);
+  ASSERT_EQ(1u, warnings.size());
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_ERROR, warnings[0].severity);
+  EXPECT_EQ("error two", warnings[0].message);
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_fanout_set_sink_severity(sink_ids[0], 50));
+  call_handler(RCUTILS_LOG_SEVERITY_WARN, "warn");
+  EXPECT_EQ(2u, all.size());
+  EXPECT_EQ(2u, warnings.size());
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_fanout_remove_sink(sink_ids[1]));
+  sink_ids.pop_back();
+  call_handler(RCUTILS_LOG_SEVERITY_FATAL, "fatal");
+  EXPECT_EQ(3u, all.size());
+  EXPECT_EQ(2u, warnings.size());
+}
+
+TEST_F(TestLoggingFanout, long_message) {
+  std::vector<Delivery> deliveries;
+  size_t sink_id = 0u;
+  ASSERT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_logging_fanout_add_sink(
+      recording_sink, RCUTILS_LOG_SEVERITY_UNSET, &deliveries, &sink_id));
+  sink_ids.push_back(sink_id);
+
+  std::string long_string(2000u, 'x');
+  call_handler(RCUTILS_LOG_SEVERITY_INFO, "%s!", long_string.c_str());
+  ASSERT_EQ(1u, deliveries.size());
+  EXPECT_EQ(long_string + "!", deliveries[0].message);
+  EXPECT_EQ(2001u, deliveries[0].length);
+}
+
+TEST_F(TestLoggingFanout, console_sink) {
+  size_t sink_id = 0u;
+  ASSERT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_logging_fanout_add_sink(
+      rcutils_logging_console_sink, RCUTILS_LOG_SEVERITY_INFO, NULL, &sink_id));
+  sink_ids.push_back(sink_id);
+
+  testing::internal::CaptureStderr();
+  call_handler(RCUTILS_LOG_SEVERITY_INFO, "100%% %s", "done");
+  call_handler(RCUTILS_LOG_SEVERITY_DEBUG, "filtered");
+  std::string output = testing::internal::GetCapturedStderr();
+  EXPECT_NE(std::string::npos, output.find("100% done\n"));
+  EXPECT_EQ(std::string::npos, output.find("filtered"));
+}
@@ -0,0 +1,224 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rcutils/error_handling.h"
+#include "rcutils/filesystem.h"
+#include "rcutils/logging.h"
+#include "rcutils/logging_file.h"
+
+static void call_handler(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  rcutils_logging_file_output_handler(location, severity, name, timestamp, format, &args);
+  va_end(args);
+}
+
+static void log_messages(size_t count)
+{
+  rcutils_log_location_t log_location = {"test_function", "test_file", 1};
+  for (size_t i = 0; i < count; ++i) {
+    call_handler(&log_location, RCUTILS_LOG_SEVERITY_INFO, "file", 1, "message %zu", i);
+  }
+}
+
+static std::string read_file(const std::string & path)
+{
+  std::ifstream file(path, std::ios::binary);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+static size_t count_lines(const std::string & contents)
+{
+  size_t lines = 0u;
+  for (char c : contents) {
+    lines += '\n' == c ? 1u : 0u;
+  }
+  return lines;
+}
+
+class TestLoggingFile : public ::testing::Test
+{
+public:
+  void SetUp()
+  {
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_initialize());
+    path = std::string(BUILD_DIR) + "/test_logging_file.log";
+    remove_files();
+    options = rcutils_logging_file_get_default_options();
+    options.file_path = path.c_str();
+  }
+
+  void TearDown()
+  {
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_file_close());
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_shutdown());
+    remove_files();
+  }
+
+  void remove_files()
+  {
+    std::remove(path.c_str());
+    for (size_t i = 1u; i <= 4u; ++i) {
+      std::remove(rotated_path(i).c_str());
+    }
+  }
+
+  std::string rotated_path(size_t index)
+  {
+    return path + "." + std::to_string(index);
+  }
+
+  std::string path;
+  rcutils_logging_file_options_t options;
+};
+
+TEST_F(TestLoggingFile, open_bad_arguments) {
+  rcutils_allocator_t allocator = rcutils_get_zero_initialized_allocator();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_logging_file_open(&options, allocator));
+  rcutils_reset_error();
+  allocator = rcutils_get_default_allocator();
+
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_logging_file_open(NULL, allocator));
+  rcutils_reset_error();
+
+  options.file_path = NULL;
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_logging_file_open(&options, allocator));
+  rcutils_reset_error();
+  options.file_path = "";
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_logging_file_open(&options, allocator));
+  rcutils_reset_error();
+  options.file_path = path.c_str();
+
+  options.max_file_size = 1u;
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_logging_file_open(&options, allocator));
+  rcutils_reset_error();
+  options.max_file_size = RCUTILS_LOGGING_FILE_DEFAULT_MAX_FILE_SIZE;
+
+  std::string bad_path = std::string(BUILD_DIR) + "/does_not_exist/test_logging_file.log";
+  options.file_path = bad_path.c_str();
+  EXPECT_EQ(RCUTILS_RET_ERROR, rcutils_logging_file_open(&options, allocator));
+  rcutils_reset_error();
+  options.file_path = path.c_str();
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_file_open(&options, allocator));
+  EXPECT_EQ(RCUTILS_RET_ERROR, rcutils_logging_file_open(&options, allocator));
+  rcutils_reset_error();
+}
+
+TEST_F(TestLoggingFile, open_not_initialized) {
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_shutdown());
+  EXPECT_EQ(
+    RCUTILS_RET_NOT_INITIALIZED,
+    rcutils_logging_file_open(&options, rcutils_get_default_allocator()));
+  rcutils_reset_error();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_initialize());
+}
+
+TEST_F(TestLoggingFile, not_open) {
+  // Falls back to the console output handler.
+  log_messages(1u);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_file_flush());
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_file_sync());
+  EXPECT_FALSE(rcutils_exists(path.c_str()));
+}
+
+TEST_F(TestLoggingFile, records_are_appended) {
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_file_open(&options, rcutils_get_default_allocator()));
+  log_messages(100u);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_file_flush());
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_file_sync());
+  // The file is pre-sized while it is mapped.
+  EXPECT_EQ(RCUTILS_LOGGING_FILE_DEFAULT_MAX_FILE_SIZE, rcutils_get_file_size(path.c_str()));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_file_close());
+
+  std::string contents = read_file(path);
+  EXPECT_EQ(contents.size(), rcutils_get_file_size(path.c_str()));
+  EXPECT_EQ(100u, count_lines(contents));
+  size_t position = 0u;
+  for (size_t i = 0; i < 100u; ++i) {
+    std::string expected = "message " + std::to_string(i) + "\n";
+    size_t found = contents.find(expected, position);
+    ASSERT_NE(std::string::npos, found) << expected;
+    position = found + expected.size();
+  }
+  // Colors are never written to the file.
+  EXPECT_EQ(std::string::npos, contents.find('\033'));
+}
+
+TEST_F(TestLoggingFile, rotation) {
+  options.max_file_size = 64u;
+  options.max_rotated_files = 2u;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_file_open(&options, rcutils_get_default_allocator()));
+  log_messages(100u);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_file_close());
+
+  EXPECT_TRUE(rcutils_exists(rotated_path(1u).c_str()));
+  EXPECT_TRUE(rcutils_exists(rotated_path(2u).c_str()));
+  EXPECT_FALSE(rcutils_exists(rotated_path(3u).c_str()));
+  std::string contents = read_file(path);
+  std::string rotated_contents = read_file(rotated_path(1u));
+  EXPECT_LE(contents.size(), 64u);
+  EXPECT_LE(rotated_contents.size(), 64u);
+  EXPECT_NE(std::string::npos, contents.find("message 99\n"));
+  EXPECT_EQ(std::string::npos, rotated_contents.find("message 99\n"));
+
+  // An existing file is rotated when opening.
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_file_open(&options, rcutils_get_default_allocator()));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_file_close());
+  EXPECT_EQ(contents, read_file(rotated_path(1u)));
+  EXPECT_EQ(rotated_contents, read_file(rotated_path(2u)));
+  EXPECT_EQ(0u, rcutils_get_file_size(path.c_str()));
+}
+
+TEST_F(TestLoggingFile, truncated_records) {
+  options.max_file_size = 8u;
+  options.max_rotated_files = 0u;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_file_open(&options, rcutils_get_default_allocator()));
+  rcutils_log_location_t log_location = {"test_function", "test_file", 1};
+  call_handler(&log_location, RCUTILS_LOG_SEVERITY_INFO, "file", 1, "long message");
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_file_close());
+
+  std::string contents = read_file(path);
+  EXPECT_EQ(8u, contents.size());
+  EXPECT_EQ('\n', contents.back());
+  EXPECT_FALSE(rcutils_exists(rotated_path(1u).c_str()));
+}
+
+TEST_F(TestLoggingFile, multiple_producers) {
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_file_open(&options, rcutils_get_default_allocator()));
+  std::vector<std::thread> producers;
+  for (size_t i = 0; i < 4u; ++i) {
+    producers.emplace_back(log_messages, 250u);
+  }
+  for (std::thread & producer : producers) {
+    producer.join();
+  }
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_file_close());
+  EXPECT_EQ(1000u, count_lines(read_file(path)));
+}
@@ -0,0 +1,201 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdarg>
+#include <string>
+#include <vector>
+
+#include "./allocator_testing_utils.h"
+#include "rcutils/allocator.h"
+#include "rcutils/error_handling.h"
+#include "rcutils/filesystem.h"
+#include "rcutils/logging.h"
+#include "rcutils/logging_flight_recorder.h"
+#include "rcutils/thread.h"
+
+static const char * const g_path = "test_logging_flight_recorder.flight";
+
+static std::vector<rcutils_logging_flight_recorder_record_t> read_records()
+{
+  std::vector<rcutils_logging_flight_recorder_record_t> records;
+  EXPECT_EQ(
+    RCUTILS_RET_OK, rcutils_logging_flight_recorder_read(
+      g_path, [](const rcutils_logging_flight_recorder_record_t * record, void * context) {
+        static_cast<std::vector<rcutils_logging_flight_recorder_record_t> *>(context)->push_back(
+          *record);
+      }, &records));
+  return records;
+}
+
+static size_t g_output_handler_calls = 0u;
+
+static void count_output_handler(
+  const rcutils_log_location_t *, int, const char *, rcutils_time_point_value_t,
+  const char *, va_list *)
+{
+  ++g_output_handler_calls;
+}
+
+class TestLoggingFlightRecorder : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_initialize());
+    previous_output_handler_ = rcutils_logging_get_output_handler();
+    rcutils_logging_set_output_handler(count_output_handler);
+    rcutils_logging_set_default_logger_level(RCUTILS_LOG_SEVERITY_INFO);
+    g_output_handler_calls = 0u;
+  }
+
+  void TearDown() override
+  {
+    rcutils_logging_set_output_handler(previous_output_handler_);
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_shutdown());
+  }
+
+  rcutils_logging_output_handler_t previous_output_handler_;
+};
+
+TEST_F(TestLoggingFlightRecorder, init_fini) {
+  auto recorder = rcutils_get_zero_initialized_logging_flight_recorder();
+  auto allocator = rcutils_get_default_allocator();
+
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_logging_flight_recorder_init(nullptr, g_path, 8, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_logging_flight_recorder_init(&recorder, nullptr, 8, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_logging_flight_recorder_init(&recorder, g_path, 8, nullptr));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_logging_flight_recorder_init(&recorder, g_path, 0, &allocator));
+  rcutils_reset_error();
+  rcutils_allocator_t failing_allocator = get_failing_allocator();
+  EXPECT_EQ(
+    RCUTILS_RET_BAD_ALLOC,
+    rcutils_logging_flight_recorder_init(&recorder, g_path, 8, &failing_allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_ERROR,
+    rcutils_logging_flight_recorder_init(
+      &recorder, "/nonexistent_directory/recorder.flight", 8, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_logging_flight_recorder_start(&recorder, RCUTILS_LOG_SEVERITY_DEBUG));
+  rcutils_reset_error();
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_flight_recorder_init(&recorder, g_path, 8, &allocator));
+  EXPECT_TRUE(rcutils_exists(g_path));
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_logging_flight_recorder_init(&recorder, g_path, 8, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_logging_flight_recorder_start(&recorder, 100));
+  rcutils_reset_error();
+  EXPECT_TRUE(read_records().empty());
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_flight_recorder_fini(&recorder));
+  EXPECT_FALSE(rcutils_exists(g_path));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_flight_recorder_fini(&recorder));
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_logging_flight_recorder_fini(nullptr));
+  rcutils_reset_error();
+
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_logging_flight_recorder_read(g_path, nullptr, nullptr));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_ERROR, rcutils_logging_flight_recorder_read(
+      g_path, [](const rcutils_logging_flight_recorder_record_t *, void *) {}, nullptr));
+  rcutils_reset_error();
+}
+
+TEST_F(TestLoggingFlightRecorder, records_below_logger_level) {
+  auto recorder = rcutils_get_zero_initialized_logging_flight_recorder();
+  auto allocator = rcutils_get_default_allocator();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_flight_recorder_init(&recorder, g_path, 8, &allocator));
+
+  EXPECT_FALSE(rcutils_logging_logger_is_enabled_for("recorded", RCUTILS_LOG_SEVERITY_DEBUG));
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_INFO, g_rcutils_logging_lowest_enabled_severity);
+  ASSERT_EQ(
+    RCUTILS_RET_OK, rcutils_logging_flight_recorder_start(&recorder, RCUTILS_LOG_SEVERITY_DEBUG));
+  EXPECT_TRUE(rcutils_logging_logger_is_enabled_for("recorded", RCUTILS_LOG_SEVERITY_DEBUG));
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_DEBUG, g_rcutils_logging_lowest_enabled_severity);
+
+  rcutils_log(nullptr, RCUTILS_LOG_SEVERITY_DEBUG, "recorded", "debug %d", 1);
+  EXPECT_EQ(0u, g_output_handler_calls);
+  rcutils_log(nullptr, RCUTILS_LOG_SEVERITY_WARN, "recorded", "warn %s", "two");
+  EXPECT_EQ(1u, g_output_handler_calls);
+  std::string long_message(500, 'x');
+  rcutils_log(nullptr, RCUTILS_LOG_SEVERITY_INFO, nullptr, "%s", long_message.c_str());
+
+  auto records = read_records();
+  ASSERT_EQ(3u, records.size());
+  EXPECT_EQ(1u, records[0].sequence);
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_DEBUG, records[0].severity);
+  EXPECT_STREQ("recorded", records[0].name);
+  EXPECT_STREQ("debug 1", records[0].message);
+  EXPECT_EQ(7u, records[0].message_length);
+  EXPECT_EQ(rcutils_thread_get_id(), records[0].thread_id);
+  EXPECT_LT(0, records[0].timestamp);
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_WARN, records[1].severity);
+  EXPECT_STREQ("warn two", records[1].message);
+  EXPECT_LE(records[0].timestamp, records[1].timestamp);
+  EXPECT_STREQ("", records[2].name);
+  EXPECT_EQ(RCUTILS_LOGGING_FLIGHT_RECORDER_MESSAGE_SIZE - 1u, records[2].message_length);
+  EXPECT_EQ(long_message.substr(0, records[2].message_length), records[2].message);
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_flight_recorder_stop(&recorder));
+  EXPECT_FALSE(rcutils_logging_logger_is_enabled_for("recorded", RCUTILS_LOG_SEVERITY_DEBUG));
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_INFO, g_rcutils_logging_lowest_enabled_severity);
+  rcutils_log(nullptr, RCUTILS_LOG_SEVERITY_WARN, "recorded", "not recorded");
+  EXPECT_EQ(3u, read_records().size());
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_flight_recorder_fini(&recorder));
+}
+
+TEST_F(TestLoggingFlightRecorder, keeps_last_records) {
+  auto recorder = rcutils_get_zero_initialized_logging_flight_recorder();
+  auto allocator = rcutils_get_default_allocator();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_flight_recorder_init(&recorder, g_path, 4, &allocator));
+  ASSERT_EQ(
+    RCUTILS_RET_OK, rcutils_logging_flight_recorder_start(&recorder, RCUTILS_LOG_SEVERITY_WARN));
+
+  for (int i = 0; i < 10; ++i) {
+    rcutils_log(nullptr, RCUTILS_LOG_SEVERITY_INFO, "ring", "info %d", i);
+    rcutils_log(nullptr, RCUTILS_LOG_SEVERITY_ERROR, "ring", "error %d", i);
+  }
+  EXPECT_EQ(20u, g_output_handler_calls);
+
+  auto records = read_records();
+  ASSERT_EQ(4u, records.size());
+  for (size_t i = 0; i < records.size(); ++i) {
+    EXPECT_EQ(7u + i, records[i].sequence);
+    EXPECT_EQ(RCUTILS_LOG_SEVERITY_ERROR, records[i].severity);
+    EXPECT_EQ("error " + std::to_string(6 + i), records[i].message);
+  }
+
+  // Finalizing stops the recorder
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_flight_recorder_fini(&recorder));
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_INFO, g_rcutils_logging_lowest_enabled_severity);
+}
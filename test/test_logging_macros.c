@@ -128,6 +128,20 @@ int main(int argc, char ** argv)
     return 16;
   }
 
+  RCUTILS_LOG_INFO_CACHED_NAMED("cached", "message %s", "bar");
+  if (g_log_calls != 3u) {
+    fprintf(stderr, "unexpected number of log calls\n");
+    return 18;
+  }
+  if (strcmp(g_last_log_event.name, "cached")) {
+    fprintf(stderr, "name unexpectedly not 'cached'\n");
+    return 19;
+  }
+  if (strcmp(g_last_log_event.message, "message bar")) {
+    fprintf(stderr, "message unexpectedly not 'message bar'\n");
+    return 20;
+  }
+
   rcutils_logging_set_output_handler(previous_output_handler);
   if (g_last_log_event.message) {
     rcutils_allocator_t allocator = rcutils_get_default_allocator();
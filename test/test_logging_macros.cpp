@@ -14,6 +14,7 @@
 
 #include <gmock/gmock.h>
 
+#include <atomic>
 #include <chrono>
 #include <string>
 #include <thread>
@@ -207,6 +208,61 @@ TEST_F(TestLoggingMacros, test_logging_skipfirst_throttle) {
   EXPECT_EQ("", g_last_log_event.name);
 }
 
+TEST_F(TestLoggingMacros, test_logging_coarse_throttle) {
+  using namespace std::chrono_literals;
+  const auto start = std::chrono::steady_clock::now();
+  // The margin covers the resolution of the coarse clock.
+  const auto throttle_time = 200ms;
+  const auto margin = 50ms;
+  bool first = true;
+  while (true) {
+    const auto before = std::chrono::steady_clock::now() - start;
+    RCUTILS_LOG_WARN_COARSE_THROTTLE(throttle_time.count(), first ? "first" : "other");
+    first = false;
+    const auto after = std::chrono::steady_clock::now() - start;
+    if (after < throttle_time - margin) {
+      EXPECT_EQ("first", g_last_log_event.message);
+      EXPECT_EQ(g_log_calls, 1u);
+    } else if (before > throttle_time + margin) {
+      break;
+    }
+    std::this_thread::sleep_for(5ms);
+  }
+  EXPECT_EQ("other", g_last_log_event.message);
+  EXPECT_EQ(g_log_calls, 2u);
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_WARN, g_last_log_event.level);
+  EXPECT_EQ("", g_last_log_event.name);
+}
+
+TEST_F(TestLoggingMacros, test_logging_skipfirst_coarse_throttle_named) {
+  for (int i = 0; i < 3; ++i) {
+    RCUTILS_LOG_INFO_SKIPFIRST_COARSE_THROTTLE_NAMED(60000, "name", "message %d", i);
+  }
+  // The first call passes the throttle but is skipped, the others are throttled.
+  EXPECT_EQ(g_log_calls, 0u);
+}
+
+TEST_F(TestLoggingMacros, test_logging_throttle_check_threads) {
+  rcutils_logging_throttle_t throttle = {0u};
+  std::atomic<size_t> accepted(0u);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back(
+      [&throttle, &accepted]() {
+        for (int j = 0; j < 1000; ++j) {
+          if (rcutils_logging_throttle_check(&throttle, RCUTILS_S_TO_NS(60))) {
+            ++accepted;
+          }
+        }
+      });
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(1u, accepted.load());
+  EXPECT_NE(0u, throttle.last_logged);
+}
+
 TEST_F(TestLoggingMacros, test_logger_hierarchy) {
   ASSERT_EQ(
     RCUTILS_RET_OK,
@@ -221,3 +277,84 @@ TEST_F(TestLoggingMacros, test_logger_hierarchy) {
   RCUTILS_LOG_DEBUG("message");
   EXPECT_EQ(0u, g_log_calls);
 }
+
+TEST_F(TestLoggingMacros, test_logging_cached_named) {
+  auto log_debug = []() {
+      RCUTILS_LOG_DEBUG_CACHED_NAMED("rcutils_test_logging_macros_cpp.cached", "message");
+    };
+  log_debug();
+  EXPECT_EQ(1u, g_log_calls);
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_DEBUG, g_last_log_event.level);
+  EXPECT_EQ("rcutils_test_logging_macros_cpp.cached", g_last_log_event.name);
+  EXPECT_EQ("message", g_last_log_event.message);
+
+  // check that the cached logger honors changes of the levels of its ancestors
+  ASSERT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_logging_set_logger_level(
+      "rcutils_test_logging_macros_cpp", RCUTILS_LOG_SEVERITY_WARN));
+  log_debug();
+  EXPECT_EQ(1u, g_log_calls);
+  ASSERT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_logging_set_logger_level(
+      "rcutils_test_logging_macros_cpp", RCUTILS_LOG_SEVERITY_UNSET));
+  log_debug();
+  EXPECT_EQ(2u, g_log_calls);
+
+  // check that the cached logger honors changes of the default level
+  rcutils_logging_set_default_logger_level(RCUTILS_LOG_SEVERITY_INFO);
+  log_debug();
+  EXPECT_EQ(2u, g_log_calls);
+
+  for (int i : {1, 2, 3}) {
+    RCUTILS_LOG_INFO_ONCE_CACHED_NAMED("rcutils_test_logging_macros_cpp", "message %d", i);
+  }
+  EXPECT_EQ(3u, g_log_calls);
+  EXPECT_EQ("message 1", g_last_log_event.message);
+}
+
+TEST(TestLoggerHandle, test_logger_handle) {
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_initialize());
+  rcutils_logging_set_default_logger_level(RCUTILS_LOG_SEVERITY_INFO);
+
+  rcutils_logger_t logger = rcutils_get_zero_initialized_logger();
+  // a zero initialized handle behaves as a nameless logger
+  EXPECT_TRUE(rcutils_logging_logger_handle_is_enabled_for(&logger, RCUTILS_LOG_SEVERITY_INFO));
+  EXPECT_FALSE(rcutils_logging_logger_handle_is_enabled_for(&logger, RCUTILS_LOG_SEVERITY_DEBUG));
+  EXPECT_FALSE(rcutils_logging_logger_handle_is_enabled_for(NULL, RCUTILS_LOG_SEVERITY_DEBUG));
+
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_logging_get_logger(NULL, &logger));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_logging_get_logger("name", NULL));
+  rcutils_reset_error();
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_set_logger_level("a.b", RCUTILS_LOG_SEVERITY_ERROR));
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_get_logger("a.b.c", &logger));
+  EXPECT_STREQ("a.b.c", logger.name);
+  EXPECT_EQ(
+    static_cast<uint32_t>(RCUTILS_LOG_SEVERITY_ERROR), static_cast<uint32_t>(logger.resolved));
+  EXPECT_FALSE(rcutils_logging_logger_handle_is_enabled_for(&logger, RCUTILS_LOG_SEVERITY_WARN));
+  EXPECT_TRUE(rcutils_logging_logger_handle_is_enabled_for(&logger, RCUTILS_LOG_SEVERITY_ERROR));
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_set_logger_level("a.b.c", RCUTILS_LOG_SEVERITY_DEBUG));
+  EXPECT_TRUE(rcutils_logging_logger_handle_is_enabled_for(&logger, RCUTILS_LOG_SEVERITY_DEBUG));
+
+  // a handle bound on first use only caches the level of the name it was bound to
+  rcutils_logger_t cached = rcutils_get_zero_initialized_logger();
+  const char * name = "a.b.c";
+  EXPECT_TRUE(
+    rcutils_logging_cached_logger_is_enabled_for(&cached, name, RCUTILS_LOG_SEVERITY_DEBUG));
+  EXPECT_EQ(name, cached.name);
+  EXPECT_FALSE(
+    rcutils_logging_cached_logger_is_enabled_for(&cached, "a.b", RCUTILS_LOG_SEVERITY_WARN));
+  EXPECT_EQ(name, cached.name);
+  EXPECT_FALSE(rcutils_logging_cached_logger_is_enabled_for(NULL, "a", RCUTILS_LOG_SEVERITY_DEBUG));
+
+  // levels set before a shutdown are not kept by the handle
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_shutdown());
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_initialize());
+  EXPECT_FALSE(rcutils_logging_logger_handle_is_enabled_for(&logger, RCUTILS_LOG_SEVERITY_DEBUG));
+  EXPECT_TRUE(rcutils_logging_logger_handle_is_enabled_for(&logger, RCUTILS_LOG_SEVERITY_INFO));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_shutdown());
+}
@@ -0,0 +1,80 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// The floor of this translation unit overrides the global one, as a package would to keep
+// its INFO messages in a build stripping everything below ERROR.
+#define RCUTILS_LOG_MIN_SEVERITY RCUTILS_LOG_MIN_SEVERITY_ERROR
+#define RCUTILS_LOG_LOCAL_MIN_SEVERITY RCUTILS_LOG_MIN_SEVERITY_INFO
+#define RCUTILS_LOG_NAME_PREFIX "noisy."
+#define RCUTILS_LOG_NAME_PREFIX_MIN_SEVERITY RCUTILS_LOG_MIN_SEVERITY_ERROR
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "rcutils/logging_macros.h"
+
+static std::vector<std::string> g_names;
+
+static void recording_output_handler(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * format, va_list * args)
+{
+  (void)location;
+  (void)severity;
+  (void)timestamp;
+  (void)format;
+  (void)args;
+  g_names.push_back(name);
+}
+
+static int g_evaluations = 0;
+
+static int evaluate()
+{
+  return ++g_evaluations;
+}
+
+TEST(TestLoggingMacrosMinSeverity, compiled_out) {
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_initialize());
+  rcutils_logging_set_default_logger_level(RCUTILS_LOG_SEVERITY_DEBUG);
+  rcutils_logging_output_handler_t original_handler = rcutils_logging_get_output_handler();
+  rcutils_logging_set_output_handler(recording_output_handler);
+
+  // Below the floor of the translation unit, the arguments aren't even evaluated.
+  RCUTILS_LOG_DEBUG_NAMED("name", "debug %d", evaluate());
+  RCUTILS_LOG_DEBUG_ONCE("debug %d", evaluate());
+  EXPECT_EQ(0, g_evaluations);
+
+  // The global floor doesn't apply to this translation unit.
+  RCUTILS_LOG_INFO_NAMED("name", "info %d", evaluate());
+  EXPECT_EQ(1, g_evaluations);
+  RCUTILS_LOG_WARN("warn");
+
+  // The loggers matching the prefix only log from its floor.
+  RCUTILS_LOG_WARN_NAMED("noisy.child", "warn");
+  RCUTILS_LOG_INFO_NAMED("noisy.", "info");
+  RCUTILS_LOG_ERROR_NAMED("noisy.child", "error");
+  RCUTILS_LOG_WARN_NAMED("noisy", "not matching");
+  const char * runtime_name = "noisy.runtime";
+  RCUTILS_LOG_WARN_NAMED(runtime_name, "warn");
+
+  std::vector<std::string> expected = {"name", "", "noisy.child", "noisy"};
+  EXPECT_EQ(expected, g_names);
+
+  rcutils_logging_set_output_handler(original_handler);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_shutdown());
+}
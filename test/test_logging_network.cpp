@@ -0,0 +1,240 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#ifdef _WIN32
+# include <winsock2.h>
+# include <ws2tcpip.h>
+#else
+# include <arpa/inet.h>
+# include <netinet/in.h>
+# include <sys/socket.h>
+# include <sys/time.h>
+# include <unistd.h>
+#endif
+
+#include <string>
+
+#include "rcutils/error_handling.h"
+#include "rcutils/logging.h"
+#include "rcutils/logging_network.h"
+
+static const std::string g_info_prefix = "[INFO] [0000000000.000000001] [network]: message ";
+
+static void call_handler(int severity, const char * format, ...)
+{
+  rcutils_log_location_t log_location = {"test_function", "test_file", 1};
+  va_list args;
+  va_start(args, format);
+  rcutils_logging_network_output_handler(
+    &log_location, severity, "network", 1, format, &args);
+  va_end(args);
+}
+
+// A UDP socket on the loopback interface standing for the collector.
+class Collector
+{
+public:
+  Collector()
+  {
+#ifdef _WIN32
+    WSADATA wsa_data;
+    EXPECT_EQ(0, WSAStartup(MAKEWORD(2, 2), &wsa_data));
+#endif
+    socket_ = socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    EXPECT_EQ(0, bind(socket_, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)));
+    socklen_t address_length = sizeof(address);
+    EXPECT_EQ(
+      0, getsockname(socket_, reinterpret_cast<struct sockaddr *>(&address), &address_length));
+    port = ntohs(address.sin_port);
+#ifdef _WIN32
+    DWORD timeout = 5000;
+#else
+    struct timeval timeout = {5, 0};
+#endif
+    EXPECT_EQ(
+      0, setsockopt(
+        socket_, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char *>(&timeout),
+        sizeof(timeout)));
+  }
+
+  ~Collector()
+  {
+#ifdef _WIN32
+    closesocket(socket_);
+    WSACleanup();
+#else
+    close(socket_);
+#endif
+  }
+
+  // Return the next datagram, or "<timeout>" if none arrives in time.
+  std::string receive()
+  {
+    char buffer[2048];
+    auto length = recv(socket_, buffer, sizeof(buffer), 0);
+    if (length < 0) {
+      return "<timeout>";
+    }
+    return std::string(buffer, static_cast<size_t>(length));
+  }
+
+  uint16_t port;
+
+private:
+#ifdef _WIN32
+  SOCKET socket_;
+#else
+  int socket_;
+#endif
+};
+
+class TestLoggingNetwork : public ::testing::Test
+{
+public:
+  void SetUp()
+  {
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_initialize());
+    options = rcutils_logging_network_get_default_options();
+    options.host = "127.0.0.1";
+    options.port = collector.port;
+  }
+
+  void TearDown()
+  {
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_network_stop());
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_shutdown());
+  }
+
+  Collector collector;
+  rcutils_logging_network_options_t options;
+};
+
+TEST_F(TestLoggingNetwork, start_bad_arguments) {
+  rcutils_allocator_t allocator = rcutils_get_zero_initialized_allocator();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_logging_network_start(&options, allocator));
+  rcutils_reset_error();
+  allocator = rcutils_get_default_allocator();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_logging_network_start(NULL, allocator));
+  rcutils_reset_error();
+
+  auto expect_invalid = [&](rcutils_logging_network_options_t invalid_options) {
+      EXPECT_EQ(
+        RCUTILS_RET_INVALID_ARGUMENT, rcutils_logging_network_start(&invalid_options, allocator));
+      rcutils_reset_error();
+    };
+  rcutils_logging_network_options_t invalid_options = options;
+  invalid_options.host = NULL;
+  expect_invalid(invalid_options);
+  invalid_options.host = "";
+  expect_invalid(invalid_options);
+  invalid_options = options;
+  invalid_options.port = 0u;
+  expect_invalid(invalid_options);
+  invalid_options = options;
+  invalid_options.queue_capacity = 0u;
+  expect_invalid(invalid_options);
+  invalid_options = options;
+  invalid_options.max_record_size = 0u;
+  expect_invalid(invalid_options);
+  invalid_options.max_record_size = RCUTILS_LOGGING_NETWORK_MAX_RECORD_SIZE + 1u;
+  expect_invalid(invalid_options);
+  invalid_options = options;
+  invalid_options.batch_size = 0u;
+  expect_invalid(invalid_options);
+  invalid_options.batch_size = RCUTILS_LOGGING_NETWORK_MAX_BATCH_SIZE + 1u;
+  expect_invalid(invalid_options);
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_network_start(&options, allocator));
+  EXPECT_EQ(RCUTILS_RET_ERROR, rcutils_logging_network_start(&options, allocator));
+  rcutils_reset_error();
+
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_logging_network_get_statistics(NULL));
+  rcutils_reset_error();
+}
+
+TEST_F(TestLoggingNetwork, start_not_initialized) {
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_shutdown());
+  EXPECT_EQ(
+    RCUTILS_RET_NOT_INITIALIZED,
+    rcutils_logging_network_start(&options, rcutils_get_default_allocator()));
+  rcutils_reset_error();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_initialize());
+}
+
+TEST_F(TestLoggingNetwork, not_started) {
+  // Falls back to the console output handler.
+  call_handler(RCUTILS_LOG_SEVERITY_INFO, "message");
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_network_flush());
+  rcutils_logging_network_statistics_t statistics;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_network_get_statistics(&statistics));
+  EXPECT_EQ(0u, statistics.enqueued);
+}
+
+TEST_F(TestLoggingNetwork, records_are_sent_in_batches) {
+  options.batch_size = 16u;
+  // Only full batches are sent until flushing.
+  options.max_latency_ms = 60000u;
+  ASSERT_EQ(
+    RCUTILS_RET_OK, rcutils_logging_network_start(&options, rcutils_get_default_allocator()));
+
+  for (int i = 0; i < 100; ++i) {
+    call_handler(RCUTILS_LOG_SEVERITY_INFO, "message %d", i);
+  }
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_network_flush());
+
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(g_info_prefix + std::to_string(i), collector.receive());
+  }
+  rcutils_logging_network_statistics_t statistics;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_network_get_statistics(&statistics));
+  EXPECT_EQ(100u, statistics.enqueued);
+  EXPECT_EQ(100u, statistics.sent);
+  EXPECT_EQ(0u, statistics.dropped);
+  EXPECT_EQ(0u, statistics.failed);
+  // 6 full batches and the 4 records left.
+  EXPECT_EQ(7u, statistics.batches);
+}
+
+TEST_F(TestLoggingNetwork, full_queue_drops_and_long_records_are_truncated) {
+  options.queue_capacity = 4u;
+  options.max_record_size = 64u;
+  options.max_latency_ms = 60000u;
+  ASSERT_EQ(
+    RCUTILS_RET_OK, rcutils_logging_network_start(&options, rcutils_get_default_allocator()));
+
+  std::string long_message(100u, 'x');
+  call_handler(RCUTILS_LOG_SEVERITY_WARN, "%s", long_message.c_str());
+  for (int i = 0; i < 9; ++i) {
+    call_handler(RCUTILS_LOG_SEVERITY_INFO, "message %d", i);
+  }
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_network_flush());
+
+  std::string truncated = "[WARN] [0000000000.000000001] [network]: " + long_message;
+  EXPECT_EQ(truncated.substr(0u, 64u), collector.receive());
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(g_info_prefix + std::to_string(i), collector.receive());
+  }
+  rcutils_logging_network_statistics_t statistics;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_network_get_statistics(&statistics));
+  EXPECT_EQ(4u, statistics.enqueued);
+  EXPECT_EQ(4u, statistics.sent);
+  EXPECT_EQ(6u, statistics.dropped);
+  EXPECT_EQ(1u, statistics.truncated);
+  EXPECT_EQ(1u, statistics.batches);
+}
@@ -65,7 +65,8 @@ def generate_test_description():
 
     env_time_tokens = dict(os.environ)
     # This custom output is to check that time stamps work correctly
-    env_time_tokens['RCUTILS_CONSOLE_OUTPUT_FORMAT'] = "'{time}' '{time_as_nanoseconds}'"
+    env_time_tokens['RCUTILS_CONSOLE_OUTPUT_FORMAT'] = \
+        "'{time}' '{time_as_nanoseconds}' '{time_iso8601}'"
     name = 'test_logging_output_timestamps'
     launch_description.add_action(ExecuteProcess(
         cmd=[executable], env=env_time_tokens, name=name, output='screen'
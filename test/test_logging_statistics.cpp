@@ -0,0 +1,157 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "osrf_testing_tools_cpp/scope_exit.hpp"
+#include "rcutils/error_handling.h"
+#include "rcutils/logging.h"
+#include "rcutils/logging_statistics.h"
+#include "rcutils/time.h"
+
+static size_t g_log_calls = 0u;
+
+static void counting_handler(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * format, va_list * args)
+{
+  (void)location;
+  (void)severity;
+  (void)name;
+  (void)timestamp;
+  (void)format;
+  (void)args;
+  ++g_log_calls;
+}
+
+class TestLoggingStatistics : public ::testing::Test
+{
+public:
+  void SetUp()
+  {
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_initialize());
+    original_handler_ = rcutils_logging_get_output_handler();
+    rcutils_logging_set_output_handler(counting_handler);
+    rcutils_logging_set_default_logger_level(RCUTILS_LOG_SEVERITY_INFO);
+    rcutils_logging_reset_statistics();
+    g_log_calls = 0u;
+  }
+
+  void TearDown()
+  {
+    rcutils_logging_set_statistics_enabled(false, false);
+    rcutils_logging_reset_statistics();
+    rcutils_logging_set_output_handler(original_handler_);
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_shutdown());
+  }
+
+  rcutils_logging_output_handler_t original_handler_;
+};
+
+TEST_F(TestLoggingStatistics, invalid_arguments) {
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_logging_get_statistics(nullptr));
+  rcutils_reset_error();
+}
+
+TEST_F(TestLoggingStatistics, disabled_by_default) {
+  rcutils_log(nullptr, RCUTILS_LOG_SEVERITY_DEBUG, "name", "filtered");
+  rcutils_log(nullptr, RCUTILS_LOG_SEVERITY_INFO, "name", "emitted");
+  EXPECT_EQ(1u, g_log_calls);
+
+  rcutils_logging_statistics_t statistics;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_get_statistics(&statistics));
+  for (size_t i = 0u; i < RCUTILS_LOGGING_STATISTICS_SEVERITIES; ++i) {
+    EXPECT_EQ(0u, statistics.emitted[i]);
+    EXPECT_EQ(0u, statistics.filtered[i]);
+    EXPECT_EQ(0u, statistics.dropped[i]);
+  }
+  EXPECT_EQ(0u, statistics.throttled);
+  EXPECT_EQ(0u, statistics.bytes_written);
+  EXPECT_EQ(0u, statistics.format_time);
+  EXPECT_EQ(0u, statistics.output_time);
+}
+
+TEST_F(TestLoggingStatistics, counters) {
+  EXPECT_EQ(0u, RCUTILS_LOGGING_STATISTICS_INDEX(RCUTILS_LOG_SEVERITY_DEBUG));
+  EXPECT_EQ(1u, RCUTILS_LOGGING_STATISTICS_INDEX(RCUTILS_LOG_SEVERITY_INFO));
+  EXPECT_EQ(2u, RCUTILS_LOGGING_STATISTICS_INDEX(RCUTILS_LOG_SEVERITY_WARN));
+  EXPECT_EQ(3u, RCUTILS_LOGGING_STATISTICS_INDEX(RCUTILS_LOG_SEVERITY_ERROR));
+  EXPECT_EQ(4u, RCUTILS_LOGGING_STATISTICS_INDEX(RCUTILS_LOG_SEVERITY_FATAL));
+
+  rcutils_logging_set_statistics_enabled(true, false);
+  rcutils_log(nullptr, RCUTILS_LOG_SEVERITY_DEBUG, "name", "filtered");
+  rcutils_log(nullptr, RCUTILS_LOG_SEVERITY_DEBUG, nullptr, "filtered");
+  rcutils_log(nullptr, RCUTILS_LOG_SEVERITY_INFO, "name", "emitted");
+  rcutils_log(nullptr, RCUTILS_LOG_SEVERITY_ERROR, "name", "emitted");
+  rcutils_log(nullptr, RCUTILS_LOG_SEVERITY_ERROR, "name", "emitted");
+
+  // The logger handles count the messages they filter as well.
+  rcutils_logger_t logger = rcutils_get_zero_initialized_logger();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_get_logger("name", &logger));
+  EXPECT_FALSE(rcutils_logging_logger_handle_is_enabled_for(&logger, RCUTILS_LOG_SEVERITY_DEBUG));
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_set_logger_rate_limit("limited", 1u, 1u));
+  rcutils_log(nullptr, RCUTILS_LOG_SEVERITY_WARN, "limited", "emitted");
+  rcutils_log(nullptr, RCUTILS_LOG_SEVERITY_WARN, "limited", "dropped");
+  rcutils_log(nullptr, RCUTILS_LOG_SEVERITY_WARN, "limited", "dropped");
+
+  rcutils_logging_throttle_t throttle = {0u};
+  EXPECT_TRUE(rcutils_logging_throttle_check(&throttle, RCUTILS_S_TO_NS(60)));
+  EXPECT_FALSE(rcutils_logging_throttle_check(&throttle, RCUTILS_S_TO_NS(60)));
+  EXPECT_EQ(4u, g_log_calls);
+
+  rcutils_logging_statistics_t statistics;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_get_statistics(&statistics));
+  EXPECT_EQ(0u, statistics.emitted[0]);
+  EXPECT_EQ(1u, statistics.emitted[1]);
+  EXPECT_EQ(1u, statistics.emitted[2]);
+  EXPECT_EQ(2u, statistics.emitted[3]);
+  EXPECT_EQ(0u, statistics.emitted[4]);
+  EXPECT_EQ(3u, statistics.filtered[0]);
+  EXPECT_EQ(0u, statistics.filtered[1]);
+  EXPECT_EQ(2u, statistics.dropped[2]);
+  EXPECT_EQ(1u, statistics.throttled);
+  // The counting handler doesn't write anything and timing is disabled.
+  EXPECT_EQ(0u, statistics.bytes_written);
+  EXPECT_EQ(0u, statistics.format_time);
+  EXPECT_EQ(0u, statistics.output_time);
+
+  // Disabling keeps the counters.
+  rcutils_logging_set_statistics_enabled(false, false);
+  rcutils_log(nullptr, RCUTILS_LOG_SEVERITY_INFO, "name", "emitted");
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_get_statistics(&statistics));
+  EXPECT_EQ(1u, statistics.emitted[1]);
+
+  rcutils_logging_reset_statistics();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_get_statistics(&statistics));
+  EXPECT_EQ(0u, statistics.emitted[3]);
+  EXPECT_EQ(0u, statistics.filtered[0]);
+  EXPECT_EQ(0u, statistics.dropped[2]);
+  EXPECT_EQ(0u, statistics.throttled);
+}
+
+TEST_F(TestLoggingStatistics, bytes_and_timing) {
+  rcutils_logging_set_output_handler(rcutils_logging_console_output_handler);
+  rcutils_logging_set_statistics_enabled(true, true);
+  rcutils_log(nullptr, RCUTILS_LOG_SEVERITY_INFO, "name", "message %d", 42);
+
+  rcutils_logging_statistics_t statistics;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_get_statistics(&statistics));
+  EXPECT_EQ(1u, statistics.emitted[1]);
+  // At least the message and the newline are written.
+  EXPECT_GE(statistics.bytes_written, sizeof("message 42"));
+  EXPECT_GT(statistics.format_time, 0u);
+  EXPECT_GE(statistics.output_time, statistics.format_time);
+}
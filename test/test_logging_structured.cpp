@@ -0,0 +1,198 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "osrf_testing_tools_cpp/scope_exit.hpp"
+#include "rcutils/allocator.h"
+#include "rcutils/error_handling.h"
+#include "rcutils/logging.h"
+#include "rcutils/logging_structured.h"
+#include "rcutils/types/char_array.h"
+
+static std::vector<std::string> g_messages;
+
+static void recording_output_handler(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const char * format, va_list * args)
+{
+  (void)location;
+  (void)severity;
+  (void)name;
+  (void)timestamp;
+  char buffer[1024];
+  vsnprintf(buffer, sizeof(buffer), format, *args);
+  g_messages.push_back(buffer);
+}
+
+struct StructuredRecord
+{
+  int severity;
+  std::string name;
+  std::string format;
+  std::vector<rcutils_log_field_t> fields;
+};
+
+static std::vector<StructuredRecord> g_records;
+
+static void recording_structured_output_handler(
+  const rcutils_log_location_t * location,
+  int severity, const char * name, rcutils_time_point_value_t timestamp,
+  const rcutils_log_field_t * fields, size_t fields_count,
+  const char * format, va_list * args)
+{
+  (void)location;
+  (void)timestamp;
+  (void)args;
+  g_records.push_back({severity, name, format, {fields, fields + fields_count}});
+}
+
+static void call_json_handler(
+  const rcutils_log_field_t * fields, size_t fields_count, const char * format, ...)
+{
+  rcutils_log_location_t location = {"function", "file", 1u};
+  va_list args;
+  va_start(args, format);
+  rcutils_logging_json_output_handler(
+    &location, RCUTILS_LOG_SEVERITY_ERROR, "name", RCUTILS_S_TO_NS(12) + 34, fields,
+    fields_count, format, &args);
+  va_end(args);
+}
+
+class TestLoggingStructured : public ::testing::Test
+{
+public:
+  void SetUp()
+  {
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_initialize());
+    rcutils_logging_set_default_logger_level(RCUTILS_LOG_SEVERITY_INFO);
+    rcutils_logging_set_output_handler(recording_output_handler);
+    g_messages.clear();
+    g_records.clear();
+  }
+
+  void TearDown()
+  {
+    rcutils_logging_set_structured_output_handler(NULL);
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_shutdown());
+  }
+};
+
+TEST_F(TestLoggingStructured, format_fields) {
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  rcutils_char_array_t output = rcutils_get_zero_initialized_char_array();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_char_array_init(&output, 0u, &allocator));
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_fini(&output));
+  });
+
+  const char text[] = "a \"quoted\"\tvalue\\ and more";
+  const rcutils_log_field_t fields[] = {
+    rcutils_log_field_int64("count", -42),
+    rcutils_log_field_double("ratio", 0.5),
+    // Only the first 17 characters are part of the value.
+    rcutils_log_field_string("text", text, 17u),
+    rcutils_log_field_string("empty", NULL, 0u),
+  };
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_format_fields(fields, 4u, &output));
+  EXPECT_STREQ(
+    "count=-42 ratio=0.5 text=\"a \\\"quoted\\\"\\tvalue\\\\\" empty=\"\"", output.buffer);
+
+  // The fields are appended to what's in the array.
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_format_fields(NULL, 0u, &output));
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_char_array_strcat(&output, " "));
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_format_fields(fields, 1u, &output));
+  EXPECT_STREQ(
+    "count=-42 ratio=0.5 text=\"a \\\"quoted\\\"\\tvalue\\\\\" empty=\"\" count=-42",
+    output.buffer);
+
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_logging_format_fields(fields, 1u, NULL));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_logging_format_fields(NULL, 1u, &output));
+  rcutils_reset_error();
+  rcutils_log_field_t invalid = rcutils_log_field_int64(NULL, 1);
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_logging_format_fields(&invalid, 1u, &output));
+  rcutils_reset_error();
+  invalid = rcutils_log_field_string("key", NULL, 1u);
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_logging_format_fields(&invalid, 1u, &output));
+  rcutils_reset_error();
+}
+
+TEST_F(TestLoggingStructured, rendered_for_output_handler) {
+  EXPECT_EQ(NULL, rcutils_logging_get_structured_output_handler());
+  const rcutils_log_field_t fields[] = {
+    rcutils_log_field_int64("id", 7),
+    rcutils_log_field_string("state", "ready", 5u),
+  };
+  rcutils_log_kv(NULL, RCUTILS_LOG_SEVERITY_INFO, "name", fields, 2u, "message %d", 1);
+  rcutils_log_kv(NULL, RCUTILS_LOG_SEVERITY_INFO, "name", NULL, 0u, "no fields");
+  rcutils_log_kv(NULL, RCUTILS_LOG_SEVERITY_DEBUG, "name", fields, 2u, "filtered");
+  ASSERT_EQ(2u, g_messages.size());
+  EXPECT_EQ("message 1 id=7 state=\"ready\"", g_messages[0]);
+  EXPECT_EQ("no fields", g_messages[1]);
+}
+
+TEST_F(TestLoggingStructured, structured_output_handler) {
+  rcutils_logging_set_structured_output_handler(recording_structured_output_handler);
+  EXPECT_EQ(
+    recording_structured_output_handler, rcutils_logging_get_structured_output_handler());
+
+  const rcutils_log_field_t fields[] = {
+    rcutils_log_field_double("value", 1.25),
+  };
+  rcutils_log_kv(NULL, RCUTILS_LOG_SEVERITY_WARN, "name", fields, 1u, "message %d", 1);
+  rcutils_log_kv(NULL, RCUTILS_LOG_SEVERITY_DEBUG, "name", fields, 1u, "filtered");
+  rcutils_log_kv(NULL, RCUTILS_LOG_SEVERITY_WARN, NULL, fields, 1u, "nameless");
+  // Invalid fields are rejected without calling the handler.
+  rcutils_log_kv(NULL, RCUTILS_LOG_SEVERITY_WARN, "name", NULL, 1u, "invalid");
+
+  EXPECT_TRUE(g_messages.empty());
+  ASSERT_EQ(2u, g_records.size());
+  EXPECT_EQ(RCUTILS_LOG_SEVERITY_WARN, g_records[0].severity);
+  EXPECT_EQ("name", g_records[0].name);
+  EXPECT_EQ("message %d", g_records[0].format);
+  ASSERT_EQ(1u, g_records[0].fields.size());
+  EXPECT_STREQ("value", g_records[0].fields[0].key);
+  EXPECT_EQ(RCUTILS_LOG_FIELD_TYPE_DOUBLE, g_records[0].fields[0].type);
+  EXPECT_EQ(1.25, g_records[0].fields[0].value.double_value);
+  EXPECT_EQ("", g_records[1].name);
+}
+
+TEST_F(TestLoggingStructured, json_output_handler) {
+  rcutils_logging_set_structured_output_handler(rcutils_logging_json_output_handler);
+  const rcutils_log_field_t fields[] = {
+    rcutils_log_field_int64("id", 7),
+    rcutils_log_field_double("nan", std::nan("")),
+    rcutils_log_field_string("quote\"d", "line\nbreak", 10u),
+  };
+
+  testing::internal::CaptureStderr();
+  call_json_handler(fields, 3u, "message \"%s\"", "quoted");
+  std::string output = testing::internal::GetCapturedStderr();
+  EXPECT_EQ(
+    "{\"time\":12.000000034,\"severity\":\"ERROR\",\"name\":\"name\","
+    "\"message\":\"message \\\"quoted\\\"\",\"fields\":"
+    "{\"id\":7,\"nan\":null,\"quote\\\"d\":\"line\\nbreak\"}}\n", output);
+
+  testing::internal::CaptureStderr();
+  rcutils_log_kv(NULL, RCUTILS_LOG_SEVERITY_INFO, "name", NULL, 0u, "%d", 42);
+  output = testing::internal::GetCapturedStderr();
+  EXPECT_NE(std::string::npos, output.find("\"message\":\"42\",\"fields\":{}}\n")) << output;
+}
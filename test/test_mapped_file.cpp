@@ -0,0 +1,122 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "rcutils/error_handling.h"
+#include "rcutils/mapped_file.h"
+
+static void write_file(const std::string & path, const std::string & contents)
+{
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file << contents;
+}
+
+class TestMappedFile : public ::testing::Test
+{
+public:
+  void SetUp()
+  {
+    path = std::string(BUILD_DIR) + "/test_mapped_file.bin";
+  }
+
+  void TearDown()
+  {
+    std::remove(path.c_str());
+  }
+
+  std::string path;
+};
+
+TEST_F(TestMappedFile, invalid_arguments) {
+  rcutils_mapped_file_t file = rcutils_get_zero_initialized_mapped_file();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_mapped_file_open(nullptr, path.c_str()));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_mapped_file_open(&file, nullptr));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_mapped_file_advise(nullptr, 0u, 0u, RCUTILS_MAPPED_FILE_ADVICE_NORMAL));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_mapped_file_advise(&file, 0u, 0u, static_cast<rcutils_mapped_file_advice_t>(42)));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_mapped_file_close(nullptr));
+  rcutils_reset_error();
+  EXPECT_EQ(0u, rcutils_mapped_file_get_size(nullptr));
+
+  EXPECT_EQ(RCUTILS_RET_ERROR, rcutils_mapped_file_open(&file, path.c_str()));
+  rcutils_reset_error();
+  EXPECT_EQ(nullptr, file.data);
+  EXPECT_EQ(RCUTILS_RET_ERROR, rcutils_mapped_file_open(&file, BUILD_DIR));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_mapped_file_close(&file));
+
+  write_file(path, "contents");
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_mapped_file_open(&file, path.c_str()));
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_mapped_file_open(&file, path.c_str()));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_mapped_file_close(&file));
+}
+
+TEST_F(TestMappedFile, map) {
+  std::string contents;
+  for (size_t i = 0; i < 100000u; ++i) {
+    contents += static_cast<char>('a' + i % 26u);
+  }
+  write_file(path, contents);
+
+  rcutils_mapped_file_t file = rcutils_get_zero_initialized_mapped_file();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_mapped_file_open(&file, path.c_str()));
+  ASSERT_NE(nullptr, file.data);
+  ASSERT_EQ(contents.size(), rcutils_mapped_file_get_size(&file));
+  // The mapping stays valid once the file is removed
+  std::remove(path.c_str());
+  EXPECT_EQ(contents, std::string(reinterpret_cast<const char *>(file.data), file.size));
+
+  for (auto advice : {
+      RCUTILS_MAPPED_FILE_ADVICE_SEQUENTIAL, RCUTILS_MAPPED_FILE_ADVICE_RANDOM,
+      RCUTILS_MAPPED_FILE_ADVICE_WILLNEED, RCUTILS_MAPPED_FILE_ADVICE_NORMAL})
+  {
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_mapped_file_advise(&file, 0u, 0u, advice));
+    // Ranges which do not start on a page, or extend beyond the file, are accepted
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_mapped_file_advise(&file, 5000u, 100u, advice));
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_mapped_file_advise(&file, 99999u, 100000u, advice));
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_mapped_file_advise(&file, 200000u, 0u, advice));
+  }
+  EXPECT_EQ(contents, std::string(reinterpret_cast<const char *>(file.data), file.size));
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_mapped_file_close(&file));
+  EXPECT_EQ(nullptr, file.data);
+  EXPECT_EQ(0u, rcutils_mapped_file_get_size(&file));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_mapped_file_close(&file));
+}
+
+TEST_F(TestMappedFile, map_empty) {
+  write_file(path, "");
+
+  rcutils_mapped_file_t file = rcutils_get_zero_initialized_mapped_file();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_mapped_file_open(&file, path.c_str()));
+  EXPECT_EQ(nullptr, file.data);
+  EXPECT_EQ(0u, rcutils_mapped_file_get_size(&file));
+  EXPECT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_mapped_file_advise(&file, 0u, 0u, RCUTILS_MAPPED_FILE_ADVICE_WILLNEED));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_mapped_file_close(&file));
+}
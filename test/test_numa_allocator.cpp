@@ -0,0 +1,153 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+
+#include "rcutils/allocator.h"
+#include "rcutils/error_handling.h"
+#include "rcutils/numa_allocator.h"
+#include "rcutils/pool_allocator.h"
+
+TEST(TestNumaAllocator, invalid_arguments) {
+  rcutils_allocator_t allocator = rcutils_get_numa_allocator(-2);
+  EXPECT_FALSE(rcutils_allocator_is_valid(&allocator));
+  allocator = rcutils_get_numa_allocator(RCUTILS_NUMA_ALLOCATOR_MAX_NODE_COUNT);
+  EXPECT_FALSE(rcutils_allocator_is_valid(&allocator));
+
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_numa_get_node_count(nullptr));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_numa_get_current_node(nullptr));
+  rcutils_reset_error();
+
+  allocator = rcutils_get_numa_allocator(RCUTILS_NUMA_NODE_LOCAL);
+  ASSERT_TRUE(rcutils_allocator_is_valid(&allocator));
+  void * pointer = allocator.allocate(1u, allocator.state);
+  ASSERT_NE(nullptr, pointer);
+  rcutils_numa_allocator_memory_info_t info;
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_numa_allocator_get_memory_info(nullptr, &info));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_numa_allocator_get_memory_info(pointer, nullptr));
+  rcutils_reset_error();
+  allocator.deallocate(pointer, allocator.state);
+  allocator.deallocate(nullptr, allocator.state);
+
+  EXPECT_EQ(nullptr, allocator.zero_allocate(SIZE_MAX, 2u, allocator.state));
+  EXPECT_EQ(nullptr, allocator.allocate(SIZE_MAX, allocator.state));
+}
+
+TEST(TestNumaAllocator, nodes) {
+  size_t node_count = 0u;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_numa_get_node_count(&node_count));
+  EXPECT_LE(1u, node_count);
+  int current_node = -1;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_numa_get_current_node(&current_node));
+  EXPECT_LE(0, current_node);
+  EXPECT_GT(node_count, static_cast<size_t>(current_node));
+}
+
+TEST(TestNumaAllocator, allocate) {
+  size_t node_count = 0u;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_numa_get_node_count(&node_count));
+  for (int node : {RCUTILS_NUMA_NODE_LOCAL, 0, static_cast<int>(node_count) - 1}) {
+    rcutils_allocator_t allocator = rcutils_get_numa_allocator(node);
+    ASSERT_TRUE(rcutils_allocator_is_valid(&allocator));
+
+    for (size_t size : {1u, 4096u, 1024u * 1024u}) {
+      auto pointer = static_cast<uint8_t *>(allocator.zero_allocate(size, 1u, allocator.state));
+      ASSERT_NE(nullptr, pointer);
+      EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(pointer) % RCUTILS_NUMA_ALLOCATOR_HEADER_SIZE);
+      EXPECT_EQ(0u, pointer[0]);
+      EXPECT_EQ(0u, pointer[size - 1u]);
+      memset(pointer, 0xAA, size);
+
+      rcutils_numa_allocator_memory_info_t info;
+      ASSERT_EQ(RCUTILS_RET_OK, rcutils_numa_allocator_get_memory_info(pointer, &info));
+      EXPECT_GE(info.mapping_size, size + RCUTILS_NUMA_ALLOCATOR_HEADER_SIZE);
+      // Without NUMA support, or the permission to set memory policies, this falls back
+      if (info.bound) {
+        EXPECT_LE(0, info.node);
+        EXPECT_GT(node_count, static_cast<size_t>(info.node));
+        if (RCUTILS_NUMA_NODE_LOCAL != node) {
+          EXPECT_EQ(node, info.node);
+        }
+      } else {
+        EXPECT_EQ(RCUTILS_NUMA_NODE_LOCAL, info.node);
+      }
+      allocator.deallocate(pointer, allocator.state);
+    }
+  }
+}
+
+TEST(TestNumaAllocator, nonexistent_node_falls_back) {
+  rcutils_allocator_t allocator =
+    rcutils_get_numa_allocator(RCUTILS_NUMA_ALLOCATOR_MAX_NODE_COUNT - 1);
+  ASSERT_TRUE(rcutils_allocator_is_valid(&allocator));
+  size_t node_count = 0u;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_numa_get_node_count(&node_count));
+  auto pointer = static_cast<uint8_t *>(allocator.allocate(100u, allocator.state));
+  ASSERT_NE(nullptr, pointer);
+  memset(pointer, 0xAA, 100u);
+  rcutils_numa_allocator_memory_info_t info;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_numa_allocator_get_memory_info(pointer, &info));
+  if (node_count < RCUTILS_NUMA_ALLOCATOR_MAX_NODE_COUNT) {
+    EXPECT_FALSE(info.bound);
+  }
+  allocator.deallocate(pointer, allocator.state);
+}
+
+TEST(TestNumaAllocator, reallocate) {
+  rcutils_allocator_t allocator = rcutils_get_numa_allocator(0);
+  auto pointer = static_cast<uint8_t *>(allocator.reallocate(nullptr, 16u, allocator.state));
+  ASSERT_NE(nullptr, pointer);
+  memset(pointer, 0x5A, 16u);
+  // The rest of the page is used before mapping again
+  EXPECT_EQ(pointer, allocator.reallocate(pointer, 64u, allocator.state));
+  auto larger = static_cast<uint8_t *>(allocator.reallocate(pointer, 100000u, allocator.state));
+  ASSERT_NE(nullptr, larger);
+  for (size_t i = 0u; i < 16u; ++i) {
+    EXPECT_EQ(0x5A, larger[i]);
+  }
+  allocator.deallocate(larger, allocator.state);
+}
+
+TEST(TestNumaAllocator, aligned_allocate) {
+  rcutils_allocator_t allocator = rcutils_get_numa_allocator(RCUTILS_NUMA_NODE_LOCAL);
+  for (size_t alignment : {8u, 64u, 256u, 4096u}) {
+    void * pointer = rcutils_allocator_aligned_allocate(&allocator, alignment, 100u);
+    ASSERT_NE(nullptr, pointer);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(pointer) % alignment);
+    memset(pointer, 0, 100u);
+    rcutils_allocator_aligned_deallocate(&allocator, pointer);
+  }
+}
+
+TEST(TestNumaAllocator, pool_of_node_local_slabs) {
+  rcutils_allocator_t numa_allocator = rcutils_get_numa_allocator(RCUTILS_NUMA_NODE_LOCAL);
+  rcutils_pool_allocator_t pool = rcutils_get_zero_initialized_pool_allocator();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_pool_allocator_init(&pool, 0u, &numa_allocator));
+  rcutils_allocator_t allocator = rcutils_pool_allocator_get_allocator(&pool);
+  void * pointers[100];
+  for (void *& pointer : pointers) {
+    pointer = allocator.allocate(24u, allocator.state);
+    ASSERT_NE(nullptr, pointer);
+    memset(pointer, 0xAA, 24u);
+  }
+  for (void * pointer : pointers) {
+    allocator.deallocate(pointer, allocator.state);
+  }
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_pool_allocator_fini(&pool));
+}
@@ -0,0 +1,119 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+
+#include "rcutils/allocator.h"
+#include "rcutils/error_handling.h"
+#include "rcutils/page_allocator.h"
+#include "rcutils/types/uint8_array.h"
+
+TEST(TestPageAllocator, invalid_arguments) {
+  rcutils_allocator_t allocator = rcutils_get_page_allocator(nullptr);
+  EXPECT_FALSE(rcutils_allocator_is_valid(&allocator));
+
+  rcutils_page_allocator_options_t options = rcutils_page_allocator_get_default_options();
+  allocator = rcutils_get_page_allocator(&options);
+  ASSERT_TRUE(rcutils_allocator_is_valid(&allocator));
+  void * pointer = allocator.allocate(1u, allocator.state);
+  ASSERT_NE(nullptr, pointer);
+  rcutils_page_allocator_memory_info_t info;
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_page_allocator_get_memory_info(nullptr, &info));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_page_allocator_get_memory_info(pointer, nullptr));
+  rcutils_reset_error();
+  allocator.deallocate(pointer, allocator.state);
+  allocator.deallocate(nullptr, allocator.state);
+
+  EXPECT_EQ(nullptr, allocator.zero_allocate(SIZE_MAX, 2u, allocator.state));
+  EXPECT_EQ(nullptr, allocator.allocate(SIZE_MAX, allocator.state));
+}
+
+TEST(TestPageAllocator, allocate) {
+  for (bool huge_pages : {false, true}) {
+    for (bool lock_memory : {false, true}) {
+      rcutils_page_allocator_options_t options;
+      options.huge_pages = huge_pages;
+      options.lock_memory = lock_memory;
+      rcutils_allocator_t allocator = rcutils_get_page_allocator(&options);
+
+      for (size_t size : {1u, 4096u, 3u * RCUTILS_PAGE_ALLOCATOR_HUGE_PAGE_SIZE}) {
+        auto pointer = static_cast<uint8_t *>(allocator.zero_allocate(size, 1u, allocator.state));
+        ASSERT_NE(nullptr, pointer);
+        EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(pointer) % RCUTILS_PAGE_ALLOCATOR_HEADER_SIZE);
+        EXPECT_EQ(0u, pointer[0]);
+        EXPECT_EQ(0u, pointer[size - 1u]);
+        memset(pointer, 0xAA, size);
+
+        rcutils_page_allocator_memory_info_t info;
+        ASSERT_EQ(RCUTILS_RET_OK, rcutils_page_allocator_get_memory_info(pointer, &info));
+        EXPECT_GE(info.mapping_size, size + RCUTILS_PAGE_ALLOCATOR_HEADER_SIZE);
+        // Without huge pages reserved or the permission to lock memory, this falls back
+        if (!huge_pages || size < RCUTILS_PAGE_ALLOCATOR_HUGE_PAGE_SIZE) {
+          EXPECT_FALSE(info.huge_pages);
+        }
+        if (!lock_memory) {
+          EXPECT_FALSE(info.locked);
+        }
+        allocator.deallocate(pointer, allocator.state);
+      }
+    }
+  }
+}
+
+TEST(TestPageAllocator, reallocate) {
+  rcutils_page_allocator_options_t options = rcutils_page_allocator_get_default_options();
+  rcutils_allocator_t allocator = rcutils_get_page_allocator(&options);
+
+  auto pointer = static_cast<uint8_t *>(allocator.reallocate(nullptr, 10u, allocator.state));
+  ASSERT_NE(nullptr, pointer);
+  for (uint8_t i = 0; i < 10u; ++i) {
+    pointer[i] = i;
+  }
+  // Growing within the mapping keeps the allocation in place
+  EXPECT_EQ(pointer, allocator.reallocate(pointer, 100u, allocator.state));
+
+  auto new_pointer = static_cast<uint8_t *>(
+    allocator.reallocate(pointer, 1024u * 1024u, allocator.state));
+  ASSERT_NE(nullptr, new_pointer);
+  for (uint8_t i = 0; i < 10u; ++i) {
+    EXPECT_EQ(i, new_pointer[i]);
+  }
+  new_pointer[1024u * 1024u - 1u] = 1u;
+  allocator.deallocate(new_pointer, allocator.state);
+}
+
+TEST(TestPageAllocator, aligned_allocate) {
+  rcutils_page_allocator_options_t options = rcutils_page_allocator_get_default_options();
+  rcutils_allocator_t allocator = rcutils_get_page_allocator(&options);
+
+  for (size_t alignment = 1u; alignment <= 4096u; alignment *= 2u) {
+    void * pointer = rcutils_allocator_aligned_allocate(&allocator, alignment, 100u);
+    ASSERT_NE(nullptr, pointer);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(pointer) % alignment);
+    rcutils_page_allocator_memory_info_t info;
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_page_allocator_get_memory_info(pointer, &info));
+    rcutils_allocator_aligned_deallocate(&allocator, pointer);
+  }
+
+  auto uint8_array = rcutils_get_zero_initialized_uint8_array();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_uint8_array_init_aligned(&uint8_array, 100, 256, &allocator));
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(uint8_array.buffer) % 256u);
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_uint8_array_resize(&uint8_array, 100000));
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(uint8_array.buffer) % 256u);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_uint8_array_fini(&uint8_array));
+}
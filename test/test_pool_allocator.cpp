@@ -0,0 +1,221 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "./allocator_testing_utils.h"
+#include "rcutils/allocator.h"
+#include "rcutils/error_handling.h"
+#include "rcutils/pool_allocator.h"
+#include "rcutils/types/hash_map.h"
+
+class PoolAllocatorTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    rcutils_allocator_t default_allocator = rcutils_get_default_allocator();
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_pool_allocator_init(&pool, 0, &default_allocator));
+    allocator = rcutils_pool_allocator_get_allocator(&pool);
+    ASSERT_TRUE(rcutils_allocator_is_valid(&allocator));
+  }
+
+  void TearDown() override
+  {
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_pool_allocator_fini(&pool));
+  }
+
+  rcutils_pool_allocator_t pool = rcutils_get_zero_initialized_pool_allocator();
+  rcutils_allocator_t allocator = rcutils_get_zero_initialized_allocator();
+};
+
+static bool is_aligned(const void * pointer)
+{
+  return 0u == reinterpret_cast<uintptr_t>(pointer) % RCUTILS_POOL_ALLOCATOR_ALIGNMENT;
+}
+
+TEST(test_pool_allocator, init_fini) {
+  rcutils_allocator_t default_allocator = rcutils_get_default_allocator();
+  rcutils_allocator_t failing_allocator = get_failing_allocator();
+  rcutils_allocator_t invalid_allocator = rcutils_get_zero_initialized_allocator();
+  rcutils_pool_allocator_t pool = rcutils_get_zero_initialized_pool_allocator();
+
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_pool_allocator_init(nullptr, 0, &default_allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_pool_allocator_init(&pool, 0, nullptr));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_pool_allocator_init(&pool, 0, &invalid_allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_BAD_ALLOC, rcutils_pool_allocator_init(&pool, 0, &failing_allocator));
+  rcutils_reset_error();
+
+  rcutils_allocator_t allocator = rcutils_pool_allocator_get_allocator(&pool);
+  EXPECT_FALSE(rcutils_allocator_is_valid(&allocator));
+  allocator = rcutils_pool_allocator_get_allocator(nullptr);
+  EXPECT_FALSE(rcutils_allocator_is_valid(&allocator));
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_pool_allocator_fini(nullptr));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_pool_allocator_fini(&pool));
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_pool_allocator_init(&pool, 0, &default_allocator));
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_pool_allocator_init(&pool, 0, &default_allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_pool_allocator_fini(&pool));
+  EXPECT_EQ(nullptr, pool.impl);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_pool_allocator_fini(&pool));
+
+  // Slabs and large allocations failing to be allocated
+  set_failing_allocator_is_failing(failing_allocator, false);
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_pool_allocator_init(&pool, 0, &failing_allocator));
+  set_failing_allocator_is_failing(failing_allocator, true);
+  allocator = rcutils_pool_allocator_get_allocator(&pool);
+  EXPECT_EQ(nullptr, allocator.allocate(16, allocator.state));
+  EXPECT_EQ(nullptr, allocator.allocate(4096, allocator.state));
+  EXPECT_EQ(nullptr, allocator.zero_allocate(4, 4, allocator.state));
+  set_failing_allocator_is_failing(failing_allocator, false);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_pool_allocator_fini(&pool));
+}
+
+TEST_F(PoolAllocatorTest, allocate_deallocate) {
+  std::vector<uint8_t *> pointers;
+  for (size_t size = 0u; size <= 2048u; size += 7u) {
+    auto pointer = static_cast<uint8_t *>(allocator.allocate(size, allocator.state));
+    ASSERT_NE(nullptr, pointer);
+    EXPECT_TRUE(is_aligned(pointer));
+    memset(pointer, static_cast<int>(size & 0xff), size);
+    pointers.push_back(pointer);
+  }
+  size_t size = 0u;
+  for (uint8_t * pointer : pointers) {
+    for (size_t i = 0u; i < size; ++i) {
+      ASSERT_EQ(size & 0xff, pointer[i]);
+    }
+    allocator.deallocate(pointer, allocator.state);
+    size += 7u;
+  }
+  allocator.deallocate(nullptr, allocator.state);
+
+  EXPECT_EQ(nullptr, allocator.allocate(SIZE_MAX, allocator.state));
+  EXPECT_EQ(nullptr, allocator.zero_allocate(SIZE_MAX, 2, allocator.state));
+  auto zeroed = static_cast<uint8_t *>(allocator.zero_allocate(10, 10, allocator.state));
+  ASSERT_NE(nullptr, zeroed);
+  for (size_t i = 0u; i < 100u; ++i) {
+    EXPECT_EQ(0u, zeroed[i]);
+  }
+  allocator.deallocate(zeroed, allocator.state);
+}
+
+TEST_F(PoolAllocatorTest, reuse) {
+  // A freed block is the next one allocated in its size class
+  void * first = allocator.allocate(40, allocator.state);
+  void * second = allocator.allocate(40, allocator.state);
+  ASSERT_NE(nullptr, first);
+  ASSERT_NE(nullptr, second);
+  allocator.deallocate(first, allocator.state);
+  EXPECT_EQ(first, allocator.allocate(48, allocator.state));
+  // But not in the other ones
+  allocator.deallocate(second, allocator.state);
+  void * other = allocator.allocate(8, allocator.state);
+  EXPECT_NE(second, other);
+  allocator.deallocate(other, allocator.state);
+  allocator.deallocate(first, allocator.state);
+
+  // Blocks of a size class are contiguous in their slab
+  auto a = static_cast<uint8_t *>(allocator.allocate(100, allocator.state));
+  auto b = static_cast<uint8_t *>(allocator.allocate(100, allocator.state));
+  ASSERT_NE(nullptr, a);
+  ASSERT_NE(nullptr, b);
+  EXPECT_LT(b - a, 256);
+  allocator.deallocate(a, allocator.state);
+  allocator.deallocate(b, allocator.state);
+}
+
+TEST_F(PoolAllocatorTest, reallocate) {
+  auto str = static_cast<char *>(allocator.reallocate(nullptr, 4, allocator.state));
+  ASSERT_NE(nullptr, str);
+  memcpy(str, "abc", 4);
+
+  // Reallocating within the size class keeps the block
+  EXPECT_EQ(str, allocator.reallocate(str, 16, allocator.state));
+  auto grown = static_cast<char *>(allocator.reallocate(str, 100, allocator.state));
+  ASSERT_NE(nullptr, grown);
+  EXPECT_STREQ("abc", grown);
+  EXPECT_TRUE(is_aligned(grown));
+
+  auto large = static_cast<char *>(allocator.reallocate(grown, 5000, allocator.state));
+  ASSERT_NE(nullptr, large);
+  EXPECT_STREQ("abc", large);
+  EXPECT_TRUE(is_aligned(large));
+  memset(large + 3, 'x', 4996);
+  large[4999] = '\0';
+  auto larger = static_cast<char *>(allocator.reallocate(large, 10000, allocator.state));
+  ASSERT_NE(nullptr, larger);
+  EXPECT_EQ(4999u, strlen(larger));
+
+  auto small = static_cast<char *>(allocator.reallocate(larger, 8, allocator.state));
+  ASSERT_NE(nullptr, small);
+  EXPECT_EQ(0, memcmp("abcxxxxx", small, 8));
+  allocator.deallocate(small, allocator.state);
+}
+
+TEST_F(PoolAllocatorTest, small_slabs) {
+  rcutils_allocator_t default_allocator = rcutils_get_default_allocator();
+  rcutils_pool_allocator_t small_pool = rcutils_get_zero_initialized_pool_allocator();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_pool_allocator_init(&small_pool, 1, &default_allocator));
+  rcutils_allocator_t small_allocator = rcutils_pool_allocator_get_allocator(&small_pool);
+  // Each slab holds one block, which is still deallocated with the pool
+  for (size_t i = 0u; i < 10u; ++i) {
+    void * pointer = small_allocator.allocate(1024, small_allocator.state);
+    ASSERT_NE(nullptr, pointer);
+    memset(pointer, 0, 1024);
+  }
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_pool_allocator_fini(&small_pool));
+}
+
+TEST_F(PoolAllocatorTest, hash_map) {
+  rcutils_hash_map_t map = rcutils_get_zero_initialized_hash_map();
+  ASSERT_EQ(
+    RCUTILS_RET_OK, rcutils_hash_map_init(
+      &map, 2, sizeof(uint32_t), sizeof(uint64_t), rcutils_hash_map_uint32_hash_func,
+      rcutils_hash_map_uint32_cmp_func, &allocator));
+
+  std::mt19937 generator(42);
+  for (uint32_t round = 0u; round < 4u; ++round) {
+    for (uint32_t key = 0u; key < 1000u; ++key) {
+      uint64_t value = key * 3ull + round;
+      ASSERT_EQ(RCUTILS_RET_OK, rcutils_hash_map_set(&map, &key, &value));
+    }
+    for (uint32_t i = 0u; i < 500u; ++i) {
+      uint32_t key = static_cast<uint32_t>(generator() % 1000u);
+      rcutils_ret_t ret = rcutils_hash_map_unset(&map, &key);
+      ASSERT_TRUE(RCUTILS_RET_OK == ret || RCUTILS_RET_STRING_KEY_NOT_FOUND == ret);
+      rcutils_reset_error();
+    }
+    for (uint32_t key = 0u; key < 1000u; ++key) {
+      uint64_t value = 0u;
+      if (RCUTILS_RET_OK == rcutils_hash_map_get(&map, &key, &value)) {
+        EXPECT_EQ(key * 3ull + round, value);
+      }
+    }
+  }
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_hash_map_fini(&map));
+}
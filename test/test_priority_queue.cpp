@@ -0,0 +1,208 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <map>
+#include <random>
+#include <set>
+#include <utility>
+
+#include "./allocator_testing_utils.h"
+#include "rcutils/allocator.h"
+#include "rcutils/error_handling.h"
+#include "rcutils/types/priority_queue.h"
+
+static int compare_int64(const void * a, const void * b)
+{
+  int64_t lhs = *static_cast<const int64_t *>(a);
+  int64_t rhs = *static_cast<const int64_t *>(b);
+  return lhs < rhs ? -1 : lhs > rhs;
+}
+
+class PriorityQueueTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    rcutils_allocator_t allocator = rcutils_get_default_allocator();
+    ASSERT_EQ(
+      RCUTILS_RET_OK, rcutils_priority_queue_init(
+        &queue, 0, sizeof(int64_t), compare_int64, &allocator));
+  }
+
+  void TearDown() override
+  {
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_priority_queue_fini(&queue));
+  }
+
+  rcutils_priority_queue_t queue = rcutils_get_zero_initialized_priority_queue();
+};
+
+TEST(test_priority_queue, init_fini) {
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  rcutils_allocator_t failing_allocator = get_failing_allocator();
+  rcutils_priority_queue_t queue = rcutils_get_zero_initialized_priority_queue();
+
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_priority_queue_init(nullptr, 4, 8, compare_int64, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_priority_queue_init(&queue, 4, 0, compare_int64, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_priority_queue_init(&queue, 4, 8, nullptr, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_priority_queue_init(&queue, 4, 8, compare_int64, nullptr));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_BAD_ALLOC,
+    rcutils_priority_queue_init(&queue, 4, 8, compare_int64, &failing_allocator));
+  rcutils_reset_error();
+
+  ASSERT_EQ(
+    RCUTILS_RET_OK, rcutils_priority_queue_init(&queue, 4, 8, compare_int64, &allocator));
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_priority_queue_init(&queue, 4, 8, compare_int64, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_priority_queue_fini(&queue));
+  EXPECT_EQ(nullptr, queue.impl);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_priority_queue_fini(&queue));
+
+  int64_t value = 0;
+  size_t size = 0;
+  EXPECT_EQ(RCUTILS_RET_NOT_INITIALIZED, rcutils_priority_queue_push(&queue, &value, nullptr));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_NOT_INITIALIZED, rcutils_priority_queue_get_size(&queue, &size));
+  rcutils_reset_error();
+}
+
+TEST_F(PriorityQueueTest, push_pop_in_order) {
+  int64_t value = 0;
+  EXPECT_EQ(RCUTILS_RET_QUEUE_EMPTY, rcutils_priority_queue_pop(&queue, &value));
+  EXPECT_EQ(RCUTILS_RET_QUEUE_EMPTY, rcutils_priority_queue_peek(&queue, &value, nullptr));
+
+  const int64_t values[] = {5, -3, 9, 9, 0, 42, -100, 7, 7, 1, 2, 3};
+  for (int64_t v : values) {
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_priority_queue_push(&queue, &v, nullptr));
+  }
+  size_t size = 0;
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_priority_queue_get_size(&queue, &size));
+  EXPECT_EQ(12u, size);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_priority_queue_peek(&queue, &value, nullptr));
+  EXPECT_EQ(-100, value);
+
+  std::multiset<int64_t> expected(std::begin(values), std::end(values));
+  for (int64_t e : expected) {
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_priority_queue_pop(&queue, &value));
+    EXPECT_EQ(e, value);
+  }
+  EXPECT_EQ(RCUTILS_RET_QUEUE_EMPTY, rcutils_priority_queue_pop(&queue, nullptr));
+}
+
+TEST_F(PriorityQueueTest, handles) {
+  rcutils_priority_queue_handle_t a, b, c;
+  int64_t value = 10;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_priority_queue_push(&queue, &value, &a));
+  value = 20;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_priority_queue_push(&queue, &value, &b));
+  value = 30;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_priority_queue_push(&queue, &value, &c));
+
+  // Decrease c to the front, then increase it to the back
+  value = 5;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_priority_queue_update(&queue, c, &value));
+  rcutils_priority_queue_handle_t front;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_priority_queue_peek(&queue, &value, &front));
+  EXPECT_EQ(5, value);
+  EXPECT_EQ(c, front);
+  value = 50;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_priority_queue_update(&queue, c, &value));
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_priority_queue_peek(&queue, &value, &front));
+  EXPECT_EQ(a, front);
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_priority_queue_remove(&queue, b, &value));
+  EXPECT_EQ(20, value);
+  EXPECT_EQ(RCUTILS_RET_NOT_FOUND, rcutils_priority_queue_remove(&queue, b, nullptr));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_NOT_FOUND, rcutils_priority_queue_update(&queue, 1000, &value));
+  rcutils_reset_error();
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_priority_queue_pop(&queue, &value));
+  EXPECT_EQ(10, value);
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_priority_queue_pop(&queue, &value));
+  EXPECT_EQ(50, value);
+}
+
+TEST_F(PriorityQueueTest, random_operations) {
+  // Compare with a reference ordered by value, then by handle to make entries unique
+  std::set<std::pair<int64_t, rcutils_priority_queue_handle_t>> reference;
+  std::map<rcutils_priority_queue_handle_t, int64_t> by_handle;
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<int64_t> values(-1000, 1000);
+  std::uniform_int_distribution<int> operations(0, 9);
+
+  for (int i = 0; i < 10000; ++i) {
+    int operation = operations(generator);
+    int64_t value = values(generator);
+    if (operation < 5 || by_handle.empty()) {
+      rcutils_priority_queue_handle_t handle;
+      ASSERT_EQ(RCUTILS_RET_OK, rcutils_priority_queue_push(&queue, &value, &handle));
+      ASSERT_EQ(0u, by_handle.count(handle));
+      by_handle[handle] = value;
+      reference.emplace(value, handle);
+    } else {
+      auto it = by_handle.begin();
+      std::advance(it, static_cast<size_t>(value + 1000) % by_handle.size());
+      rcutils_priority_queue_handle_t handle = it->first;
+      reference.erase({it->second, handle});
+      if (operation < 7) {
+        ASSERT_EQ(RCUTILS_RET_OK, rcutils_priority_queue_update(&queue, handle, &value));
+        it->second = value;
+        reference.emplace(value, handle);
+      } else if (operation < 9) {
+        int64_t removed;
+        ASSERT_EQ(RCUTILS_RET_OK, rcutils_priority_queue_remove(&queue, handle, &removed));
+        ASSERT_EQ(it->second, removed);
+        by_handle.erase(it);
+      } else {
+        // Pop instead, putting back the entry which was taken out of the reference
+        // The front may be any of the elements equal to the smallest one
+        reference.emplace(it->second, handle);
+        int64_t popped;
+        rcutils_priority_queue_handle_t front;
+        ASSERT_EQ(RCUTILS_RET_OK, rcutils_priority_queue_peek(&queue, &popped, &front));
+        ASSERT_EQ(RCUTILS_RET_OK, rcutils_priority_queue_pop(&queue, &popped));
+        ASSERT_EQ(reference.begin()->first, popped);
+        ASSERT_EQ(1u, reference.erase({popped, front}));
+        by_handle.erase(front);
+      }
+    }
+    if (!reference.empty()) {
+      int64_t front;
+      ASSERT_EQ(RCUTILS_RET_OK, rcutils_priority_queue_peek(&queue, &front, nullptr));
+      ASSERT_EQ(reference.begin()->first, front);
+    }
+  }
+  size_t size = 0;
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_priority_queue_get_size(&queue, &size));
+  EXPECT_EQ(reference.size(), size);
+}
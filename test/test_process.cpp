@@ -14,6 +14,15 @@
 
 #include <gtest/gtest.h>
 
+#include <string.h>
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <thread>
+#include <vector>
+
 #include "./allocator_testing_utils.h"
 #include "./time_bomb_allocator_testing_utils.h"
 #include "rcutils/allocator.h"
@@ -42,3 +51,39 @@ TEST(TestProcess, test_get_executable_name) {
   EXPECT_STREQ("test_process", exec_name);
   allocator.deallocate(exec_name, allocator.state);
 }
+
+TEST(TestProcess, test_get_process_info) {
+  const rcutils_process_info_t * info = rcutils_get_process_info();
+  ASSERT_NE(nullptr, info);
+  EXPECT_EQ(rcutils_get_pid(), info->pid);
+  EXPECT_STREQ("test_process", info->executable_name);
+  ASSERT_NE(nullptr, info->executable_path);
+  EXPECT_NE(nullptr, strstr(info->executable_path, "test_process"));
+  ASSERT_NE(nullptr, info->hostname);
+
+  // The same information is returned again
+  EXPECT_EQ(info, rcutils_get_process_info());
+
+  // Concurrent first calls are fine too, but the information is already computed here
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([info]() {EXPECT_EQ(info, rcutils_get_process_info());});
+  }
+  for (std::thread & thread : threads) {
+    thread.join();
+  }
+
+#ifndef _WIN32
+  // The child of a fork has its own process ID
+  pid_t child = fork();
+  ASSERT_NE(-1, child);
+  if (0 == child) {
+    _exit(rcutils_get_process_info()->pid == getpid() ? 0 : 1);
+  }
+  int status = 0;
+  ASSERT_EQ(child, waitpid(child, &status, 0));
+  EXPECT_TRUE(WIFEXITED(status));
+  EXPECT_EQ(0, WEXITSTATUS(status));
+  EXPECT_EQ(getpid(), info->pid);
+#endif
+}
@@ -0,0 +1,166 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rcutils/error_handling.h"
+#include "rcutils/profiling.h"
+
+TEST(TestProfiling, histogram_buckets) {
+  for (uint64_t value = 0u; value < 4u; ++value) {
+    EXPECT_EQ(value, rcutils_profiling_histogram_bucket(value));
+    EXPECT_EQ(value, rcutils_profiling_histogram_bucket_lower_bound(value));
+  }
+  EXPECT_EQ(4u, rcutils_profiling_histogram_bucket(4u));
+  EXPECT_EQ(7u, rcutils_profiling_histogram_bucket(7u));
+  EXPECT_EQ(8u, rcutils_profiling_histogram_bucket(8u));
+  EXPECT_EQ(8u, rcutils_profiling_histogram_bucket(9u));
+  EXPECT_EQ(9u, rcutils_profiling_histogram_bucket(10u));
+  EXPECT_EQ(
+    RCUTILS_PROFILING_HISTOGRAM_BUCKETS - 1u, rcutils_profiling_histogram_bucket(UINT64_MAX));
+  EXPECT_EQ(UINT64_MAX, rcutils_profiling_histogram_bucket_lower_bound(
+      RCUTILS_PROFILING_HISTOGRAM_BUCKETS));
+
+  // Each bucket starts where the previous one ends
+  uint64_t previous = 0u;
+  for (size_t bucket = 1u; bucket < RCUTILS_PROFILING_HISTOGRAM_BUCKETS; ++bucket) {
+    uint64_t lower_bound = rcutils_profiling_histogram_bucket_lower_bound(bucket);
+    EXPECT_LT(previous, lower_bound);
+    EXPECT_EQ(bucket, rcutils_profiling_histogram_bucket(lower_bound));
+    EXPECT_EQ(bucket - 1u, rcutils_profiling_histogram_bucket(lower_bound - 1u));
+    previous = lower_bound;
+  }
+}
+
+TEST(TestProfiling, record) {
+  EXPECT_EQ(nullptr, rcutils_profiling_get_probe(NULL));
+  rcutils_reset_error();
+  rcutils_profiling_probe_t * probe = rcutils_profiling_get_probe("test_profiling.record");
+  ASSERT_NE(nullptr, probe);
+  EXPECT_EQ(probe, rcutils_profiling_get_probe("test_profiling.record"));
+  EXPECT_STREQ("test_profiling.record", rcutils_profiling_probe_get_name(probe));
+  EXPECT_EQ(nullptr, rcutils_profiling_probe_get_name(NULL));
+
+  rcutils_profiling_statistics_t statistics;
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_profiling_probe_get_statistics(NULL, false, &statistics));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_profiling_probe_get_statistics(probe, false, NULL));
+  rcutils_reset_error();
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_profiling_probe_get_statistics(probe, false, &statistics));
+  EXPECT_EQ(0u, statistics.count);
+  EXPECT_EQ(0u, statistics.min);
+  EXPECT_EQ(0u, statistics.max);
+  EXPECT_EQ(0u, rcutils_profiling_statistics_percentile(&statistics, 50.0));
+
+  for (uint64_t duration = 1u; duration <= 100u; ++duration) {
+    rcutils_profiling_probe_record(probe, duration * 1000u);
+  }
+  rcutils_profiling_probe_record(NULL, 1u);
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_profiling_probe_get_statistics(probe, false, &statistics));
+  EXPECT_EQ(100u, statistics.count);
+  EXPECT_EQ(5050000u, statistics.sum);
+  EXPECT_EQ(1000u, statistics.min);
+  EXPECT_EQ(100000u, statistics.max);
+  uint64_t total = 0u;
+  for (size_t bucket = 0u; bucket < RCUTILS_PROFILING_HISTOGRAM_BUCKETS; ++bucket) {
+    total += statistics.histogram[bucket];
+  }
+  EXPECT_EQ(100u, total);
+  EXPECT_EQ(1000u, rcutils_profiling_statistics_percentile(&statistics, 0.0));
+  EXPECT_EQ(100000u, rcutils_profiling_statistics_percentile(&statistics, 100.0));
+  // Within a bucket of the exact value
+  uint64_t median = rcutils_profiling_statistics_percentile(&statistics, 50.0);
+  EXPECT_LE(median, 50000u);
+  EXPECT_GE(median, 40000u);
+  EXPECT_EQ(0u, rcutils_profiling_statistics_percentile(&statistics, 101.0));
+  EXPECT_EQ(0u, rcutils_profiling_statistics_percentile(NULL, 50.0));
+
+  // Resetting returns the statistics once
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_profiling_probe_get_statistics(probe, true, &statistics));
+  EXPECT_EQ(100u, statistics.count);
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_profiling_probe_get_statistics(probe, false, &statistics));
+  EXPECT_EQ(0u, statistics.count);
+  EXPECT_EQ(0u, statistics.sum);
+  EXPECT_EQ(0u, statistics.min);
+  EXPECT_EQ(0u, statistics.max);
+}
+
+TEST(TestProfiling, threads) {
+  rcutils_profiling_probe_t * probe = rcutils_profiling_get_probe("test_profiling.threads");
+  ASSERT_NE(nullptr, probe);
+  std::vector<std::thread> threads;
+  for (uint64_t i = 0u; i < 32u; ++i) {
+    threads.emplace_back(
+      [probe, i]() {
+        for (uint64_t duration = 1u; duration <= 1000u; ++duration) {
+          rcutils_profiling_probe_record(probe, duration + i);
+        }
+      });
+  }
+  for (std::thread & thread : threads) {
+    thread.join();
+  }
+  rcutils_profiling_statistics_t statistics;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_profiling_probe_get_statistics(probe, true, &statistics));
+  EXPECT_EQ(32000u, statistics.count);
+  EXPECT_EQ(32u * 500500u + 1000u * (31u * 32u / 2u), statistics.sum);
+  EXPECT_EQ(1u, statistics.min);
+  EXPECT_EQ(1031u, statistics.max);
+}
+
+static void
+collect(const char * name, const rcutils_profiling_statistics_t * statistics, void * context)
+{
+  (*static_cast<std::map<std::string, uint64_t> *>(context))[name] = statistics->count;
+}
+
+TEST(TestProfiling, scope) {
+  rcutils_profiling_probe_cache_t cache = {0u};
+  rcutils_profiling_probe_t * probe = rcutils_profiling_get_cached_probe(
+    "test_profiling.scope", &cache);
+  ASSERT_NE(nullptr, probe);
+  EXPECT_EQ(probe, rcutils_profiling_get_cached_probe("test_profiling.scope", &cache));
+  EXPECT_EQ(probe, rcutils_profiling_get_probe("test_profiling.scope"));
+
+  for (int i = 0; i < 3; ++i) {
+    RCUTILS_PROFILING_SCOPE_BEGIN("test_profiling.scope");
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    RCUTILS_PROFILING_SCOPE_END();
+  }
+  rcutils_profiling_scope_t scope = rcutils_profiling_scope_begin(NULL);
+  rcutils_profiling_scope_end(&scope);
+  rcutils_profiling_scope_end(NULL);
+
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_profiling_snapshot(NULL, false, NULL));
+  rcutils_reset_error();
+  std::map<std::string, uint64_t> counts;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_profiling_snapshot(collect, false, &counts));
+  ASSERT_EQ(1u, counts.count("test_profiling.scope"));
+  EXPECT_EQ(3u, counts["test_profiling.scope"]);
+
+  rcutils_profiling_statistics_t statistics;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_profiling_probe_get_statistics(probe, true, &statistics));
+  EXPECT_EQ(3u, statistics.count);
+  EXPECT_GE(statistics.min, 1000000u);
+  EXPECT_GE(statistics.sum, 3000000u);
+}
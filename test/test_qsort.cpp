@@ -0,0 +1,267 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "./allocator_testing_utils.h"
+#include "rcutils/error_handling.h"
+#include "rcutils/qsort.h"
+#include "rcutils/types/string_array.h"
+
+template<typename T>
+static int compare(const void * lhs, const void * rhs)
+{
+  const T & left = *static_cast<const T *>(lhs);
+  const T & right = *static_cast<const T *>(rhs);
+  return left < right ? -1 : (right < left ? 1 : 0);
+}
+
+struct Element3
+{
+  uint8_t bytes[3];
+  bool operator<(const Element3 & other) const
+  {
+    return memcmp(bytes, other.bytes, sizeof(bytes)) < 0;
+  }
+};
+
+struct Element16
+{
+  uint64_t key;
+  uint64_t value;
+  bool operator<(const Element16 & other) const
+  {
+    return key < other.key;
+  }
+};
+
+struct Element40
+{
+  uint32_t key;
+  uint8_t padding[36];
+  bool operator<(const Element40 & other) const
+  {
+    return key < other.key;
+  }
+};
+
+// The input patterns which defeat naive quicksorts.
+static std::vector<uint32_t> make_keys(const std::string & pattern, size_t count)
+{
+  std::mt19937 generator(42u);
+  std::vector<uint32_t> keys(count);
+  for (size_t i = 0; i < count; ++i) {
+    if ("random" == pattern) {
+      keys[i] = static_cast<uint32_t>(generator());
+    } else if ("sorted" == pattern) {
+      keys[i] = static_cast<uint32_t>(i);
+    } else if ("reversed" == pattern) {
+      keys[i] = static_cast<uint32_t>(count - i);
+    } else if ("equal" == pattern) {
+      keys[i] = 7u;
+    } else if ("few_values" == pattern) {
+      keys[i] = static_cast<uint32_t>(generator() % 4u);
+    } else if ("organ_pipe" == pattern) {
+      keys[i] = static_cast<uint32_t>(i < count / 2 ? i : count - i);
+    } else {
+      keys[i] = static_cast<uint32_t>(i % 16u == 0 ? generator() : i);
+    }
+  }
+  return keys;
+}
+
+template<typename T, typename MakeElement>
+static void check_sort(const std::vector<uint32_t> & keys, MakeElement make_element)
+{
+  std::vector<T> elements;
+  for (uint32_t key : keys) {
+    elements.push_back(make_element(key));
+  }
+  std::vector<T> expected = elements;
+  std::stable_sort(expected.begin(), expected.end());
+  ASSERT_EQ(
+    RCUTILS_RET_OK, rcutils_qsort(elements.data(), elements.size(), sizeof(T), compare<T>));
+  for (size_t i = 0; i < elements.size(); ++i) {
+    ASSERT_FALSE(elements[i] < expected[i] || expected[i] < elements[i]) << "at " << i;
+  }
+}
+
+TEST(test_qsort, invalid_arguments) {
+  uint32_t array[] = {3u, 2u, 1u};
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_qsort(array, 3u, sizeof(uint32_t), nullptr));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_qsort(nullptr, 3u, sizeof(uint32_t), compare<uint32_t>));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_qsort(array, SIZE_MAX, 2u, compare<uint32_t>));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_qsort(nullptr, 1u, sizeof(uint32_t), compare<uint32_t>));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_qsort(nullptr, 0u, sizeof(uint32_t), compare<uint32_t>));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_qsort(array, 3u, 0u, compare<uint32_t>));
+  EXPECT_EQ(3u, array[0]);
+}
+
+TEST(test_qsort, patterns) {
+  const char * patterns[] = {
+    "random", "sorted", "reversed", "equal", "few_values", "organ_pipe", "mostly_sorted"};
+  for (const char * pattern : patterns) {
+    for (size_t count : {2u, 3u, 23u, 24u, 25u, 128u, 129u, 1000u, 20000u}) {
+      SCOPED_TRACE(std::string(pattern) + " " + std::to_string(count));
+      std::vector<uint32_t> keys = make_keys(pattern, count);
+      check_sort<uint32_t>(keys, [](uint32_t key) {return key;});
+      check_sort<uint64_t>(keys, [](uint32_t key) {return uint64_t{key} << 32;});
+      check_sort<Element3>(
+        keys, [](uint32_t key) {
+          return Element3{{static_cast<uint8_t>(key >> 16), static_cast<uint8_t>(key >> 8),
+              static_cast<uint8_t>(key)}};
+        });
+      check_sort<Element16>(keys, [](uint32_t key) {return Element16{key, ~uint64_t{key}};});
+      check_sort<Element40>(keys, [](uint32_t key) {return Element40{key, {}};});
+    }
+  }
+}
+
+TEST(test_qsort, strings) {
+  std::mt19937 generator(42u);
+  std::vector<std::string> strings;
+  for (size_t i = 0; i < 5000u; ++i) {
+    strings.push_back("/ns" + std::to_string(generator() % 100u) + "/node" + std::to_string(i));
+  }
+  std::vector<const char *> pointers;
+  for (const std::string & str : strings) {
+    pointers.push_back(str.c_str());
+  }
+  for (size_t i = 0; i < pointers.size(); i += 100u) {
+    pointers[i] = nullptr;
+  }
+  ASSERT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_qsort(
+      pointers.data(), pointers.size(), sizeof(pointers[0]), rcutils_string_array_sort_compare));
+  // The empty entries are at the end
+  for (size_t i = 1; i < pointers.size(); ++i) {
+    if (nullptr == pointers[i]) {
+      continue;
+    }
+    ASSERT_NE(nullptr, pointers[i - 1]);
+    EXPECT_LE(strcmp(pointers[i - 1], pointers[i]), 0);
+  }
+  EXPECT_EQ(nullptr, pointers.back());
+  EXPECT_NE(nullptr, pointers[pointers.size() - 51u]);
+  EXPECT_EQ(nullptr, pointers[pointers.size() - 50u]);
+}
+
+TEST(test_qsort, parallel_invalid_arguments) {
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  rcutils_qsort_parallel_options_t options = rcutils_qsort_parallel_get_default_options();
+  EXPECT_EQ(0u, options.thread_count);
+  EXPECT_EQ(RCUTILS_QSORT_PARALLEL_DEFAULT_SEQUENTIAL_THRESHOLD, options.sequential_threshold);
+
+  std::vector<uint32_t> keys = make_keys("random", 100000u);
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_qsort_parallel(
+      keys.data(), keys.size(), sizeof(uint32_t), compare<uint32_t>, nullptr, allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_qsort_parallel(
+      keys.data(), keys.size(), sizeof(uint32_t), compare<uint32_t>, &options,
+      rcutils_get_zero_initialized_allocator()));
+  rcutils_reset_error();
+  options.thread_count = 2u;
+  options.sequential_threshold = 0u;
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_qsort_parallel(
+      keys.data(), keys.size(), sizeof(uint32_t), nullptr, &options, allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_qsort_parallel(
+      nullptr, keys.size(), sizeof(uint32_t), compare<uint32_t>, &options, allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_BAD_ALLOC,
+    rcutils_qsort_parallel(
+      keys.data(), keys.size(), sizeof(uint32_t), compare<uint32_t>, &options,
+      get_failing_allocator()));
+  rcutils_reset_error();
+  // Small arrays are sorted by the calling thread, without allocating
+  EXPECT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_qsort_parallel(
+      keys.data(), 1000u, sizeof(uint32_t), compare<uint32_t>, &options,
+      get_failing_allocator()));
+  EXPECT_TRUE(std::is_sorted(keys.begin(), keys.begin() + 1000));
+}
+
+TEST(test_qsort, parallel) {
+  rcutils_qsort_parallel_options_t options = rcutils_qsort_parallel_get_default_options();
+  options.sequential_threshold = RCUTILS_QSORT_PARALLEL_MIN_SEQUENTIAL_THRESHOLD;
+  const char * patterns[] = {"random", "sorted", "reversed", "few_values", "organ_pipe"};
+  for (const char * pattern : patterns) {
+    for (size_t thread_count : {0u, 1u, 2u, 5u}) {
+      SCOPED_TRACE(std::string(pattern) + " " + std::to_string(thread_count));
+      options.thread_count = thread_count;
+      std::vector<uint32_t> keys = make_keys(pattern, 100000u);
+      std::vector<uint32_t> expected = keys;
+      std::sort(expected.begin(), expected.end());
+      ASSERT_EQ(
+        RCUTILS_RET_OK,
+        rcutils_qsort_parallel(
+          keys.data(), keys.size(), sizeof(uint32_t), compare<uint32_t>, &options,
+          rcutils_get_default_allocator()));
+      EXPECT_EQ(expected, keys);
+
+      std::vector<Element40> elements;
+      for (uint32_t key : make_keys(pattern, 20000u)) {
+        elements.push_back(Element40{key, {}});
+      }
+      ASSERT_EQ(
+        RCUTILS_RET_OK,
+        rcutils_qsort_parallel(
+          elements.data(), elements.size(), sizeof(Element40), compare<Element40>, &options,
+          rcutils_get_default_allocator()));
+      EXPECT_TRUE(std::is_sorted(elements.begin(), elements.end()));
+    }
+  }
+
+  std::mt19937 generator(42u);
+  std::vector<std::string> strings;
+  for (size_t i = 0; i < 20000u; ++i) {
+    strings.push_back("/ns" + std::to_string(generator() % 100u) + "/node" + std::to_string(i));
+  }
+  std::vector<const char *> pointers;
+  for (const std::string & str : strings) {
+    pointers.push_back(str.c_str());
+  }
+  options.thread_count = 4u;
+  ASSERT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_qsort_parallel(
+      pointers.data(), pointers.size(), sizeof(pointers[0]), rcutils_string_array_sort_compare,
+      &options, rcutils_get_default_allocator()));
+  for (size_t i = 1; i < pointers.size(); ++i) {
+    ASSERT_LT(strcmp(pointers[i - 1], pointers[i]), 0);
+  }
+}
@@ -18,6 +18,7 @@
 
 #include "./allocator_testing_utils.h"
 #include "rcutils/allocator.h"
+#include "rcutils/error_handling.h"
 #include "rcutils/repl_str.h"
 
 TEST(test_repl_str, nominal) {
@@ -90,3 +91,66 @@ TEST(test_repl_str, nominal) {
     allocator.deallocate(out, allocator.state);
   }
 }
+
+TEST(test_repl_str, multi) {
+  auto allocator = rcutils_get_default_allocator();
+  rcutils_char_array_t output = rcutils_get_zero_initialized_char_array();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_char_array_init(&output, 0, &allocator));
+
+  const rcutils_repl_str_pair_t pairs[] = {
+    {"$(env HOME)", "/home/user"},
+    {"$(env", "<unknown>"},
+    {"{bar}", ""},
+  };
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_repl_str_multi(nullptr, pairs, 3u, &output));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_repl_str_multi("foo", nullptr, 3u, &output));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_repl_str_multi("foo", pairs, 3u, nullptr));
+  rcutils_reset_error();
+  const rcutils_repl_str_pair_t empty_from[] = {{"", "a"}};
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_repl_str_multi("foo", empty_from, 1u, &output));
+  rcutils_reset_error();
+  const rcutils_repl_str_pair_t null_to[] = {{"a", nullptr}};
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_repl_str_multi("foo", null_to, 1u, &output));
+  rcutils_reset_error();
+
+  // The pairs are tried in order at each position, and the replacements are not scanned again
+  ASSERT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_repl_str_multi("$(env HOME)/{bar}x$(env USER) $(en{bar}", pairs, 3u, &output));
+  EXPECT_STREQ("/home/user/x<unknown> USER) $(en", output.buffer);
+  // The result is appended
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_repl_str_multi("-{bar}", pairs, 3u, &output));
+  EXPECT_STREQ("/home/user/x<unknown> USER) $(en-", output.buffer);
+
+  output.buffer_length = 0;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_repl_str_multi("", pairs, 3u, &output));
+  EXPECT_STREQ("", output.buffer);
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_repl_str_multi("no match", pairs, 3u, &output));
+  EXPECT_STREQ("no match", output.buffer);
+  output.buffer_length = 0;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_repl_str_multi("no pairs", nullptr, 0u, &output));
+  EXPECT_STREQ("no pairs", output.buffer);
+
+  // Same as rcutils_repl_str() with a single pair
+  std::string large;
+  for (size_t i = 0; i < 10000u; ++i) {
+    large += "ab{bar}c";
+  }
+  const rcutils_repl_str_pair_t pair[] = {{"{bar}", "barbar"}};
+  output.buffer_length = 0;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_repl_str_multi(large.c_str(), pair, 1u, &output));
+  char * expected = rcutils_repl_str(large.c_str(), "{bar}", "barbar", &allocator);
+  ASSERT_NE(nullptr, expected);
+  EXPECT_STREQ(expected, output.buffer);
+  allocator.deallocate(expected, allocator.state);
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_fini(&output));
+
+  rcutils_allocator_t failing_allocator = get_failing_allocator();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_char_array_init(&output, 0, &failing_allocator));
+  EXPECT_EQ(RCUTILS_RET_BAD_ALLOC, rcutils_repl_str_multi("foo", pair, 1u, &output));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_fini(&output));
+}
@@ -0,0 +1,270 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdarg>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "./allocator_testing_utils.h"
+#include "rcutils/allocator.h"
+#include "rcutils/error_handling.h"
+#include "rcutils/filesystem.h"
+#include "rcutils/logging.h"
+#include "rcutils/logging_statistics.h"
+#include "rcutils/mapped_file.h"
+#include "rcutils/process.h"
+#include "rcutils/shared_counters.h"
+
+static const char * const g_path = "test_shared_counters.counters";
+
+// Read the counters like a monitor, from the file
+class MonitoredCounters
+{
+public:
+  MonitoredCounters()
+  {
+    file_ = rcutils_get_zero_initialized_mapped_file();
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_mapped_file_open(&file_, g_path));
+  }
+
+  ~MonitoredCounters()
+  {
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_mapped_file_close(&file_));
+  }
+
+  const rcutils_shared_counters_header_t * header() const
+  {
+    return reinterpret_cast<const rcutils_shared_counters_header_t *>(file_.data);
+  }
+
+  // Return the entry with the given name, or nullptr
+  const rcutils_shared_counters_entry_t * find(const char * name) const
+  {
+    auto entries = reinterpret_cast<const rcutils_shared_counters_entry_t *>(header() + 1);
+    for (uint32_t i = 0; i < header()->count; ++i) {
+      if (0 == strcmp(entries[i].name, name)) {
+        return &entries[i];
+      }
+    }
+    return nullptr;
+  }
+
+  rcutils_mapped_file_t file_;
+};
+
+TEST(test_shared_counters, init_fini) {
+  auto counters = rcutils_get_zero_initialized_shared_counters();
+  auto allocator = rcutils_get_default_allocator();
+
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_shared_counters_init(nullptr, g_path, 8, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_shared_counters_init(&counters, nullptr, 8, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_shared_counters_init(&counters, g_path, 8, nullptr));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_shared_counters_init(&counters, g_path, 0, &allocator));
+  rcutils_reset_error();
+  rcutils_allocator_t failing_allocator = get_failing_allocator();
+  EXPECT_EQ(
+    RCUTILS_RET_BAD_ALLOC, rcutils_shared_counters_init(&counters, g_path, 8, &failing_allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_ERROR,
+    rcutils_shared_counters_init(&counters, "/nonexistent/dir/counters", 8, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(nullptr, counters.impl);
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_shared_counters_init(&counters, g_path, 8, &allocator));
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_shared_counters_init(&counters, g_path, 8, &allocator));
+  rcutils_reset_error();
+  EXPECT_TRUE(rcutils_exists(g_path));
+  {
+    MonitoredCounters monitor;
+    ASSERT_EQ(64u + 8u * 64u, monitor.file_.size);
+    EXPECT_EQ(0, memcmp(RCUTILS_SHARED_COUNTERS_MAGIC, monitor.header()->magic, 8));
+    EXPECT_EQ(RCUTILS_SHARED_COUNTERS_VERSION, monitor.header()->version);
+    EXPECT_EQ(64u, monitor.header()->entry_size);
+    EXPECT_EQ(8u, monitor.header()->capacity);
+    EXPECT_EQ(0u, monitor.header()->count);
+    EXPECT_EQ(static_cast<uint64_t>(rcutils_get_pid()), monitor.header()->pid);
+  }
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_shared_counters_fini(&counters));
+  EXPECT_EQ(nullptr, counters.impl);
+  EXPECT_FALSE(rcutils_exists(g_path));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_shared_counters_fini(&counters));
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_shared_counters_fini(nullptr));
+  rcutils_reset_error();
+}
+
+TEST(test_shared_counters, get_add_set) {
+  auto counters = rcutils_get_zero_initialized_shared_counters();
+  auto allocator = rcutils_get_default_allocator();
+  uint64_t * messages = nullptr;
+  uint64_t * depth = nullptr;
+
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_shared_counters_get(&counters, "messages", RCUTILS_SHARED_COUNTER_KIND_COUNTER,
+    &messages));
+  rcutils_reset_error();
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_shared_counters_init(&counters, g_path, 2, &allocator));
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_shared_counters_get(&counters, nullptr, RCUTILS_SHARED_COUNTER_KIND_COUNTER,
+    &messages));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_shared_counters_get(&counters, "", RCUTILS_SHARED_COUNTER_KIND_COUNTER, &messages));
+  rcutils_reset_error();
+  std::string long_name(RCUTILS_SHARED_COUNTERS_NAME_SIZE, 'x');
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_shared_counters_get(
+      &counters, long_name.c_str(), RCUTILS_SHARED_COUNTER_KIND_COUNTER, &messages));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_shared_counters_get(
+      &counters, "messages", static_cast<rcutils_shared_counter_kind_t>(0), &messages));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_shared_counters_get(&counters, "messages", RCUTILS_SHARED_COUNTER_KIND_COUNTER,
+    nullptr));
+  rcutils_reset_error();
+
+  ASSERT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_shared_counters_get(&counters, "messages", RCUTILS_SHARED_COUNTER_KIND_COUNTER,
+    &messages));
+  ASSERT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_shared_counters_get(&counters, "queue.depth", RCUTILS_SHARED_COUNTER_KIND_GAUGE,
+    &depth));
+  uint64_t * again = nullptr;
+  EXPECT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_shared_counters_get(&counters, "messages", RCUTILS_SHARED_COUNTER_KIND_COUNTER,
+    &again));
+  EXPECT_EQ(messages, again);
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_shared_counters_get(&counters, "messages", RCUTILS_SHARED_COUNTER_KIND_GAUGE,
+    &again));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_NOT_ENOUGH_SPACE,
+    rcutils_shared_counters_get(&counters, "bytes", RCUTILS_SHARED_COUNTER_KIND_COUNTER,
+    &again));
+  rcutils_reset_error();
+
+  rcutils_shared_counter_add(messages, 3u);
+  rcutils_shared_counter_add(messages, 2u);
+  rcutils_shared_counter_set(depth, 7u);
+  rcutils_shared_counter_add(nullptr, 1u);
+  rcutils_shared_counter_set(nullptr, 1u);
+  {
+    MonitoredCounters monitor;
+    EXPECT_EQ(2u, monitor.header()->count);
+    const rcutils_shared_counters_entry_t * entry = monitor.find("messages");
+    ASSERT_NE(nullptr, entry);
+    EXPECT_EQ(static_cast<uint32_t>(RCUTILS_SHARED_COUNTER_KIND_COUNTER), entry->kind);
+    EXPECT_EQ(5u, entry->value);
+    entry = monitor.find("queue.depth");
+    ASSERT_NE(nullptr, entry);
+    EXPECT_EQ(static_cast<uint32_t>(RCUTILS_SHARED_COUNTER_KIND_GAUGE), entry->kind);
+    EXPECT_EQ(7u, entry->value);
+
+    // The monitor sees the updates as they happen
+    rcutils_shared_counter_set(depth, 1u);
+    EXPECT_EQ(1u, entry->value);
+  }
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_shared_counters_fini(&counters));
+}
+
+static void null_handler(
+  const rcutils_log_location_t *, int, const char *, rcutils_time_point_value_t, const char *,
+  va_list *)
+{
+}
+
+TEST(test_shared_counters, export_logging_statistics) {
+  auto counters = rcutils_get_zero_initialized_shared_counters();
+  auto allocator = rcutils_get_default_allocator();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_shared_counters_export_logging_statistics(&counters));
+  rcutils_reset_error();
+
+  // There is no room for all the logging statistics
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_shared_counters_init(&counters, g_path, 4, &allocator));
+  EXPECT_EQ(
+    RCUTILS_RET_NOT_ENOUGH_SPACE, rcutils_shared_counters_export_logging_statistics(&counters));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_shared_counters_fini(&counters));
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_logging_initialize());
+  rcutils_logging_output_handler_t original_handler = rcutils_logging_get_output_handler();
+  rcutils_logging_set_output_handler(null_handler);
+  rcutils_logging_set_default_logger_level(RCUTILS_LOG_SEVERITY_INFO);
+  rcutils_logging_set_statistics_enabled(true, false);
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_shared_counters_init(&counters, g_path, 32, &allocator));
+  rcutils_log(nullptr, RCUTILS_LOG_SEVERITY_INFO, "name", "not exported yet");
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_shared_counters_export_logging_statistics(&counters));
+  rcutils_log(nullptr, RCUTILS_LOG_SEVERITY_INFO, "name", "emitted");
+  rcutils_log(nullptr, RCUTILS_LOG_SEVERITY_ERROR, "name", "emitted");
+  rcutils_log(nullptr, RCUTILS_LOG_SEVERITY_DEBUG, "name", "filtered");
+  // Resetting the statistics doesn't reset the shared counters
+  rcutils_logging_reset_statistics();
+  rcutils_log(nullptr, RCUTILS_LOG_SEVERITY_ERROR, "name", "emitted");
+  {
+    MonitoredCounters monitor;
+    EXPECT_EQ(19u, monitor.header()->count);
+    const rcutils_shared_counters_entry_t * entry = monitor.find("rcutils.logging.emitted.info");
+    ASSERT_NE(nullptr, entry);
+    EXPECT_EQ(1u, entry->value);
+    entry = monitor.find("rcutils.logging.emitted.error");
+    ASSERT_NE(nullptr, entry);
+    EXPECT_EQ(2u, entry->value);
+    entry = monitor.find("rcutils.logging.filtered.debug");
+    ASSERT_NE(nullptr, entry);
+    EXPECT_EQ(1u, entry->value);
+    EXPECT_NE(nullptr, monitor.find("rcutils.logging.dropped.fatal"));
+    EXPECT_NE(nullptr, monitor.find("rcutils.logging.throttled"));
+    EXPECT_NE(nullptr, monitor.find("rcutils.logging.bytes_written"));
+    EXPECT_NE(nullptr, monitor.find("rcutils.logging.format_time"));
+    EXPECT_NE(nullptr, monitor.find("rcutils.logging.output_time"));
+  }
+
+  // Finalizing the counters stops the export
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_shared_counters_fini(&counters));
+  rcutils_log(nullptr, RCUTILS_LOG_SEVERITY_INFO, "name", "not exported anymore");
+
+  rcutils_logging_set_statistics_enabled(false, false);
+  rcutils_logging_reset_statistics();
+  rcutils_logging_set_output_handler(original_handler);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_logging_shutdown());
+}
@@ -14,6 +14,7 @@
 
 #include <gtest/gtest.h>
 
+#include <cstring>
 #include <string>
 
 #include "./allocator_testing_utils.h"
@@ -218,3 +219,244 @@ TEST_F(TestSharedLibrary, basic_symbol) {
   ret = rcutils_unload_shared_library(&lib);
   ASSERT_EQ(RCUTILS_RET_OK, ret);
 }
+
+TEST_F(TestSharedLibrary, cached_symbol) {
+  rcutils_ret_t ret = rcutils_get_platform_library_name(
+    RCUTILS_STRINGIFY(SHARED_LIBRARY_UNDER_TEST), library_path, 1024, false);
+  ASSERT_EQ(RCUTILS_RET_OK, ret);
+  ret = rcutils_load_shared_library(&lib, library_path, rcutils_get_default_allocator());
+  ASSERT_EQ(RCUTILS_RET_OK, ret);
+  EXPECT_NE(nullptr, lib.symbol_cache);
+
+  void * symbol = rcutils_get_symbol(&lib, "print_name");
+  ASSERT_NE(nullptr, symbol);
+  EXPECT_EQ(symbol, rcutils_get_symbol(&lib, "print_name"));
+  EXPECT_TRUE(rcutils_has_symbol(&lib, "print_name"));
+  // Missing symbols aren't cached, and still set the error
+  EXPECT_EQ(nullptr, rcutils_get_symbol(&lib, "symbol"));
+  EXPECT_TRUE(rcutils_error_is_set());
+  rcutils_reset_error();
+  EXPECT_FALSE(rcutils_has_symbol(&lib, "symbol"));
+
+  ret = rcutils_unload_shared_library(&lib);
+  ASSERT_EQ(RCUTILS_RET_OK, ret);
+  EXPECT_EQ(nullptr, lib.symbol_cache);
+}
+
+TEST_F(TestSharedLibrary, get_symbols) {
+  const char * symbol_names[] = {"print_name", "symbol", "print_name"};
+  void * symbols[3] = {nullptr, nullptr, nullptr};
+
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_get_symbols(nullptr, symbol_names, 3, symbols));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_get_symbols(&lib, symbol_names, 3, symbols));
+  rcutils_reset_error();
+
+  rcutils_ret_t ret = rcutils_get_platform_library_name(
+    RCUTILS_STRINGIFY(SHARED_LIBRARY_UNDER_TEST), library_path, 1024, false);
+  ASSERT_EQ(RCUTILS_RET_OK, ret);
+  ret = rcutils_load_shared_library(&lib, library_path, rcutils_get_default_allocator());
+  ASSERT_EQ(RCUTILS_RET_OK, ret);
+
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_get_symbols(&lib, nullptr, 3, symbols));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_get_symbols(&lib, symbol_names, 3, nullptr));
+  rcutils_reset_error();
+  const char * null_names[] = {"print_name", nullptr};
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_get_symbols(&lib, null_names, 2, symbols));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_get_symbols(&lib, nullptr, 0, nullptr));
+
+  // All the symbols are looked up, even after a missing one
+  EXPECT_EQ(RCUTILS_RET_ERROR, rcutils_get_symbols(&lib, symbol_names, 3, symbols));
+  EXPECT_TRUE(rcutils_error_is_set());
+  rcutils_reset_error();
+  void * print_name = rcutils_get_symbol(&lib, "print_name");
+  ASSERT_NE(nullptr, print_name);
+  EXPECT_EQ(print_name, symbols[0]);
+  EXPECT_EQ(nullptr, symbols[1]);
+  EXPECT_EQ(print_name, symbols[2]);
+
+  // Cached symbols are found again
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_get_symbols(&lib, symbol_names, 1, symbols));
+  EXPECT_EQ(print_name, symbols[0]);
+
+  ret = rcutils_unload_shared_library(&lib);
+  ASSERT_EQ(RCUTILS_RET_OK, ret);
+}
+
+TEST_F(TestSharedLibrary, load_with_options) {
+  rcutils_ret_t ret = rcutils_get_platform_library_name(
+    RCUTILS_STRINGIFY(SHARED_LIBRARY_UNDER_TEST), library_path, 1024, false);
+  ASSERT_EQ(RCUTILS_RET_OK, ret);
+
+  rcutils_shared_library_load_options_t options =
+    rcutils_shared_library_get_default_load_options();
+  EXPECT_FALSE(options.resolve_now);
+  EXPECT_FALSE(options.global);
+  EXPECT_FALSE(options.no_delete);
+
+  ret = rcutils_load_shared_library_with_options(
+    &lib, library_path, nullptr, rcutils_get_default_allocator());
+  ASSERT_EQ(RCUTILS_RET_OK, ret);
+  EXPECT_TRUE(rcutils_has_symbol(&lib, "print_name"));
+  ret = rcutils_unload_shared_library(&lib);
+  ASSERT_EQ(RCUTILS_RET_OK, ret);
+
+  options.resolve_now = true;
+  options.global = true;
+  options.no_delete = true;
+  ret = rcutils_load_shared_library_with_options(
+    &lib, library_path, &options, rcutils_get_default_allocator());
+  ASSERT_EQ(RCUTILS_RET_OK, ret);
+  EXPECT_TRUE(rcutils_has_symbol(&lib, "print_name"));
+  ret = rcutils_unload_shared_library(&lib);
+  ASSERT_EQ(RCUTILS_RET_OK, ret);
+
+  ret = rcutils_load_shared_library_with_options(
+    &lib, "not_an_existing_library", &options, rcutils_get_default_allocator());
+  EXPECT_EQ(RCUTILS_RET_ERROR, ret);
+  rcutils_reset_error();
+}
+
+TEST_F(TestSharedLibrary, load_shared_libraries) {
+  rcutils_ret_t ret = rcutils_get_platform_library_name(
+    RCUTILS_STRINGIFY(SHARED_LIBRARY_UNDER_TEST), library_path, 1024, false);
+  ASSERT_EQ(RCUTILS_RET_OK, ret);
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+
+  constexpr size_t count = 8;
+  rcutils_shared_library_t libs[count];
+  const char * library_paths[count];
+  for (size_t i = 0; i < count; ++i) {
+    libs[i] = rcutils_get_zero_initialized_shared_library();
+    library_paths[i] = library_path;
+  }
+
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_load_shared_libraries(nullptr, library_paths, count, nullptr, 0, allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_load_shared_libraries(
+      libs, library_paths, count, nullptr, 0, rcutils_get_zero_initialized_allocator()));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_BAD_ALLOC,
+    rcutils_load_shared_libraries(
+      libs, library_paths, count, nullptr, 0, get_failing_allocator()));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_OK, rcutils_load_shared_libraries(nullptr, nullptr, 0, nullptr, 0, allocator));
+
+  ret = rcutils_load_shared_libraries(libs, library_paths, count, nullptr, 3, allocator);
+  ASSERT_EQ(RCUTILS_RET_OK, ret);
+  for (size_t i = 0; i < count; ++i) {
+    EXPECT_TRUE(rcutils_is_shared_library_loaded(&libs[i]));
+    EXPECT_TRUE(rcutils_has_symbol(&libs[i], "print_name"));
+  }
+  // Loaded libraries aren't zero initialized
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_load_shared_libraries(libs, library_paths, count, nullptr, 0, allocator));
+  rcutils_reset_error();
+  for (size_t i = 0; i < count; ++i) {
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_unload_shared_library(&libs[i]));
+  }
+
+  // The libraries which can be loaded are, and the first failure is reported
+  library_paths[2] = "not_an_existing_library";
+  library_paths[5] = "not_an_existing_library_either";
+  ret = rcutils_load_shared_libraries(libs, library_paths, count, nullptr, 1, allocator);
+  EXPECT_EQ(RCUTILS_RET_ERROR, ret);
+  EXPECT_NE(
+    nullptr, strstr(rcutils_get_error_string().str, "'not_an_existing_library'"));
+  rcutils_reset_error();
+  for (size_t i = 0; i < count; ++i) {
+    EXPECT_EQ(i != 2 && i != 5, rcutils_is_shared_library_loaded(&libs[i]));
+    if (rcutils_is_shared_library_loaded(&libs[i])) {
+      EXPECT_EQ(RCUTILS_RET_OK, rcutils_unload_shared_library(&libs[i]));
+    }
+  }
+}
+
+TEST_F(TestSharedLibrary, preload) {
+  rcutils_ret_t ret = rcutils_get_platform_library_name(
+    RCUTILS_STRINGIFY(SHARED_LIBRARY_UNDER_TEST), library_path, 1024, false);
+  ASSERT_EQ(RCUTILS_RET_OK, ret);
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+
+  constexpr size_t count = 4;
+  rcutils_shared_library_t libs[count];
+  const char * library_paths[count];
+  for (size_t i = 0; i < count; ++i) {
+    libs[i] = rcutils_get_zero_initialized_shared_library();
+    library_paths[i] = library_path;
+  }
+  rcutils_shared_library_load_options_t options =
+    rcutils_shared_library_get_default_load_options();
+  options.resolve_now = true;
+
+  rcutils_shared_library_preload_t preload = rcutils_get_zero_initialized_shared_library_preload();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_shared_library_preload_wait(&preload));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_shared_library_preload_start(
+      nullptr, libs, library_paths, count, &options, 2, allocator));
+  rcutils_reset_error();
+
+  ret = rcutils_shared_library_preload_start(
+    &preload, libs, library_paths, count, &options, 2, allocator);
+  ASSERT_EQ(RCUTILS_RET_OK, ret);
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_shared_library_preload_start(
+      &preload, libs, library_paths, count, &options, 2, allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_shared_library_preload_wait(&preload));
+  EXPECT_EQ(nullptr, preload.impl);
+  for (size_t i = 0; i < count; ++i) {
+    EXPECT_NE(nullptr, rcutils_get_symbol(&libs[i], "print_name"));
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_unload_shared_library(&libs[i]));
+  }
+}
+
+TEST_F(TestSharedLibrary, loaded_library_paths) {
+  rcutils_ret_t ret = rcutils_get_platform_library_name(
+    RCUTILS_STRINGIFY(SHARED_LIBRARY_UNDER_TEST), library_path, 1024, false);
+  ASSERT_EQ(RCUTILS_RET_OK, ret);
+  EXPECT_FALSE(rcutils_is_shared_library_path_loaded(nullptr));
+  EXPECT_FALSE(rcutils_is_shared_library_path_loaded(library_path));
+
+  ret = rcutils_load_shared_library(&lib, library_path, rcutils_get_default_allocator());
+  ASSERT_EQ(RCUTILS_RET_OK, ret);
+  EXPECT_TRUE(rcutils_is_shared_library_path_loaded(library_path));
+  EXPECT_TRUE(rcutils_is_shared_library_path_loaded(lib.library_path));
+  EXPECT_FALSE(rcutils_is_shared_library_path_loaded("not_an_existing_library"));
+
+  // The second handle finds the resolved path of the first one
+  rcutils_shared_library_t other_lib = rcutils_get_zero_initialized_shared_library();
+  ret = rcutils_load_shared_library(&other_lib, library_path, rcutils_get_default_allocator());
+  ASSERT_EQ(RCUTILS_RET_OK, ret);
+  EXPECT_STREQ(lib.library_path, other_lib.library_path);
+  std::string resolved_path = lib.library_path;
+
+  ret = rcutils_unload_shared_library(&lib);
+  ASSERT_EQ(RCUTILS_RET_OK, ret);
+  EXPECT_TRUE(rcutils_is_shared_library_path_loaded(library_path));
+  EXPECT_TRUE(rcutils_is_shared_library_path_loaded(resolved_path.c_str()));
+  ret = rcutils_unload_shared_library(&other_lib);
+  ASSERT_EQ(RCUTILS_RET_OK, ret);
+  EXPECT_FALSE(rcutils_is_shared_library_path_loaded(library_path));
+  EXPECT_FALSE(rcutils_is_shared_library_path_loaded(resolved_path.c_str()));
+
+  // Loading again resolves the path the same way
+  ret = rcutils_load_shared_library(&lib, library_path, rcutils_get_default_allocator());
+  ASSERT_EQ(RCUTILS_RET_OK, ret);
+  EXPECT_EQ(resolved_path, lib.library_path);
+  EXPECT_TRUE(rcutils_is_shared_library_path_loaded(library_path));
+  ret = rcutils_unload_shared_library(&lib);
+  ASSERT_EQ(RCUTILS_RET_OK, ret);
+}
@@ -14,6 +14,12 @@
 
 #include <gtest/gtest.h>
 
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
 #include "rcutils/snprintf.h"
 
 // Tests the rcutils_snprintf() function.
@@ -57,3 +63,109 @@ TEST(TestSnprintf, test_snprintf) {
 
   EXPECT_EQ(-1, rcutils_snprintf(buffer, 2, NULL));  // NOLINT(runtime/printf)
 }
+
+// Formats with rcutils_fast_snprintf() and snprintf(), whose output must be the same.
+// The buffers fit the longest output, the 309 integral digits of %f with 1e300.
+#define EXPECT_FAST_SNPRINTF_MATCHES(...) \
+  do { \
+    char expected[512]; \
+    char actual[512]; \
+    int expected_ret = snprintf(expected, sizeof(expected), __VA_ARGS__); \
+    int actual_ret = rcutils_fast_snprintf(actual, sizeof(actual), __VA_ARGS__); \
+    EXPECT_EQ(expected_ret, actual_ret) << #__VA_ARGS__; \
+    EXPECT_STREQ(expected, actual) << #__VA_ARGS__; \
+  } while (0)
+
+TEST(TestSnprintf, test_fast_snprintf_integers) {
+  EXPECT_FAST_SNPRINTF_MATCHES("no conversion");
+  EXPECT_FAST_SNPRINTF_MATCHES("100%%");
+  EXPECT_FAST_SNPRINTF_MATCHES("%d %d %d %d", 0, 7, -42, 1234567890);
+  EXPECT_FAST_SNPRINTF_MATCHES("%d %i", INT_MIN, INT_MAX);
+  EXPECT_FAST_SNPRINTF_MATCHES("%u %u", 0u, UINT_MAX);
+  EXPECT_FAST_SNPRINTF_MATCHES("%ld %lu", LONG_MIN, ULONG_MAX);
+  EXPECT_FAST_SNPRINTF_MATCHES("%lld %llu", LLONG_MIN, ULLONG_MAX);
+  EXPECT_FAST_SNPRINTF_MATCHES("%zu %zd", SIZE_MAX, static_cast<ptrdiff_t>(-3));
+  EXPECT_FAST_SNPRINTF_MATCHES("%jd %ju %td", INTMAX_MIN, UINTMAX_MAX, PTRDIFF_MIN);
+  EXPECT_FAST_SNPRINTF_MATCHES("%hd %hu %hhd %hhu", 70000, 70000, 300, 300);
+  EXPECT_FAST_SNPRINTF_MATCHES("%x %X %#x %#X %#x", 0xdeadbeefu, 0xdeadbeefu, 255u, 255u, 0u);
+  EXPECT_FAST_SNPRINTF_MATCHES("%o %#o %#o %#.0o %.0o", 8u, 8u, 0u, 0u, 0u);
+  EXPECT_FAST_SNPRINTF_MATCHES("%llx %#llX", ULLONG_MAX, 0x123456789abcdefull);
+
+  // Flags, widths and precisions.
+  EXPECT_FAST_SNPRINTF_MATCHES("[%5d] [%-5d] [%05d] [%+d] [% d] [%+5d]", 42, 42, -42, 42, 42, 0);
+  EXPECT_FAST_SNPRINTF_MATCHES("[%.3d] [%8.3d] [%-8.3d] [%.0d]", 7, -7, 7, 0);
+  EXPECT_FAST_SNPRINTF_MATCHES("[%*d] [%-*d] [%*d] [%.*d] [%.*d]", 6, 1, 6, 1, -6, 1, 4, 1, -1, 0);
+  EXPECT_FAST_SNPRINTF_MATCHES("[%#010x] [%#-10x] [%#.6x] [%010u]", 0xabu, 0xabu, 0xabu, 12u);
+  EXPECT_FAST_SNPRINTF_MATCHES("[%- 6d] [%+-6d]", 5, 5);
+
+  // The 0 flag is ignored with a precision or the - flag.
+  char buffer[64];
+  const char * ignored_zero_format = "[%08.3d] [%0-6d]";
+  EXPECT_EQ(19, rcutils_fast_snprintf(buffer, sizeof(buffer), ignored_zero_format, 7, 5));
+  EXPECT_STREQ("[     007] [5     ]", buffer);
+}
+
+TEST(TestSnprintf, test_fast_snprintf_strings) {
+  EXPECT_FAST_SNPRINTF_MATCHES(
+    "[%s] [%10s] [%-10s] [%.3s] [%*.*s]", "abc", "abc", "abc", "abcdef", 6, 2, "abcdef");
+  EXPECT_FAST_SNPRINTF_MATCHES("[%s] [%s]", "", "a longer string with spaces");
+  EXPECT_FAST_SNPRINTF_MATCHES("[%c] [%3c] [%-3c] [%c]", 'a', 'b', 'c', '%');
+
+  // The precision bounds strings which aren't null terminated.
+  const char not_terminated[3] = {'x', 'y', 'z'};
+  EXPECT_FAST_SNPRINTF_MATCHES("[%.3s] [%.2s]", not_terminated, not_terminated);
+
+  char buffer[32];
+  // Volatile, so the compiler doesn't warn about the null argument of the format.
+  const char * volatile null_string = nullptr;
+  EXPECT_EQ(6, rcutils_fast_snprintf(buffer, sizeof(buffer), "%s", null_string));
+  EXPECT_STREQ("(null)", buffer);
+}
+
+TEST(TestSnprintf, test_fast_snprintf_pointers) {
+  char buffer[64];
+  int value = 0;
+  EXPECT_LT(0, rcutils_fast_snprintf(buffer, sizeof(buffer), "%p", static_cast<void *>(&value)));
+  char expected[64];
+  EXPECT_LT(
+    0, snprintf(
+      expected, sizeof(expected), "0x%jx",
+      static_cast<uintmax_t>(reinterpret_cast<uintptr_t>(&value))));
+  EXPECT_STREQ(expected, buffer);
+  EXPECT_EQ(8, rcutils_fast_snprintf(buffer, sizeof(buffer), "[%6p]", static_cast<void *>(NULL)));
+  EXPECT_STREQ("[ (nil)]", buffer);
+}
+
+TEST(TestSnprintf, test_fast_snprintf_floating_point) {
+  EXPECT_FAST_SNPRINTF_MATCHES("%f %f %f", 0.0, 3.14159265358979, -2.5);
+  EXPECT_FAST_SNPRINTF_MATCHES("%.2f %10.3f %-10.1f| %+f %010.4f", 1.005, 2.0, 3.0, 4.0, -5.5);
+  EXPECT_FAST_SNPRINTF_MATCHES("%g %g %g %G %.10g", 100000.0, 1e-5, 1234567.0, 1e-20, 1.0 / 3);
+  EXPECT_FAST_SNPRINTF_MATCHES("%e %E %.0e %#.0f %lf", 12345.678, 0.001, 5.5, 3.0, 2.25);
+  EXPECT_FAST_SNPRINTF_MATCHES("%*.*f|%f", 12, 3, 1.5, 1e300);
+  EXPECT_FAST_SNPRINTF_MATCHES("x=%d y=%.3f name=%s", 3, 0.25, "robot");
+}
+
+TEST(TestSnprintf, test_fast_snprintf_unsupported) {
+  // Formats with other conversions are formatted by the C library.
+  EXPECT_FAST_SNPRINTF_MATCHES("%d %a %s", 1, 1.0, "after");
+  EXPECT_FAST_SNPRINTF_MATCHES("%s %Lf", "long double", 1.5L);
+  EXPECT_FAST_SNPRINTF_MATCHES("%ls", L"wide");
+}
+
+TEST(TestSnprintf, test_fast_snprintf_truncation) {
+  char buffer[256];
+  const std::string expected = "value=-1234 name=abcdef pi=3.14";
+  for (size_t size = 1; size <= expected.size() + 1; ++size) {
+    int ret = rcutils_fast_snprintf(
+      buffer, size, "value=%d name=%s pi=%.2f", -1234, "abcdef", 3.14159);
+    EXPECT_EQ(static_cast<int>(expected.size()), ret);
+    EXPECT_EQ(expected.substr(0, size - 1), std::string(buffer));
+  }
+  EXPECT_EQ(
+    static_cast<int>(expected.size()),
+    rcutils_fast_snprintf(nullptr, 0, "value=%d name=%s pi=%.2f", -1234, "abcdef", 3.14159));
+
+  EXPECT_EQ(-1, rcutils_fast_snprintf(nullptr, sizeof(buffer), "%d", 1));
+  EXPECT_EQ(-1, rcutils_fast_snprintf(buffer, 0, "%d", 1));
+  EXPECT_EQ(-1, rcutils_fast_snprintf(buffer, 2, NULL));  // NOLINT(runtime/printf)
+}
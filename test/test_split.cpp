@@ -18,6 +18,7 @@
 #include "./time_bomb_allocator_testing_utils.h"
 #include "rcutils/error_handling.h"
 #include "rcutils/split.h"
+#include "rcutils/types/string_view.h"
 #include "rcutils/types/string_array.h"
 
 #define ENABLE_LOGGING 1
@@ -252,3 +253,116 @@ TEST(test_split, split_last) {
   ret = rcutils_string_array_fini(&tokens8);
   ASSERT_EQ(RCUTILS_RET_OK, ret);
 }
+
+TEST(test_split, split_views) {
+  const char * str = "//hello//world/foo/";
+  rcutils_string_view_t views[3];
+  size_t count = 0;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_split_views(str, '/', views, 3, &count));
+  ASSERT_EQ(3u, count);
+  // The views refer to the string
+  EXPECT_EQ(str + 2, views[0].data);
+  EXPECT_TRUE(rcutils_string_view_equal_cstring(views[0], "hello"));
+  EXPECT_TRUE(rcutils_string_view_equal_cstring(views[1], "world"));
+  EXPECT_TRUE(rcutils_string_view_equal_cstring(views[2], "foo"));
+  EXPECT_FALSE(rcutils_string_view_equal_cstring(views[2], "fo"));
+  EXPECT_FALSE(rcutils_string_view_equal_cstring(views[2], "fooo"));
+  EXPECT_TRUE(rcutils_string_view_equal(views[1], rcutils_string_view_from_cstring("world")));
+  EXPECT_FALSE(rcutils_string_view_equal(views[0], views[1]));
+
+  // The count is set even when the views don't fit
+  EXPECT_EQ(RCUTILS_RET_NOT_ENOUGH_SPACE, rcutils_split_views(str, '/', nullptr, 0, &count));
+  rcutils_reset_error();
+  EXPECT_EQ(3u, count);
+  EXPECT_EQ(RCUTILS_RET_NOT_ENOUGH_SPACE, rcutils_split_views(str, '/', views, 1, &count));
+  rcutils_reset_error();
+  EXPECT_TRUE(rcutils_string_view_equal_cstring(views[0], "hello"));
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_split_views("", '/', nullptr, 0, &count));
+  EXPECT_EQ(0u, count);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_split_views(nullptr, '/', nullptr, 0, &count));
+  EXPECT_EQ(0u, count);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_split_views("///", '/', views, 3, &count));
+  EXPECT_EQ(0u, count);
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_split_views(str, '/', nullptr, 1, &count));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_split_views(str, '/', views, 3, nullptr));
+  rcutils_reset_error();
+
+  // The views have the same tokens as rcutils_split()
+  const char * strs[] = {"hello", "/hello/world", "hello//world/", "a/b/c/d", "/"};
+  for (const char * s : strs) {
+    rcutils_string_array_t tokens = rcutils_get_zero_initialized_string_array();
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_split(s, '/', rcutils_get_default_allocator(), &tokens));
+    size_t token_count = 0;
+    rcutils_string_view_t token = rcutils_get_zero_initialized_string_view();
+    while (rcutils_split_next_view(s, '/', &token)) {
+      ASSERT_LT(token_count, tokens.size);
+      EXPECT_TRUE(rcutils_string_view_equal_cstring(token, tokens.data[token_count])) << s;
+      ++token_count;
+    }
+    EXPECT_EQ(tokens.size, token_count) << s;
+    EXPECT_EQ(nullptr, token.data);
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_string_array_fini(&tokens));
+  }
+  EXPECT_FALSE(rcutils_split_next_view("a", '/', nullptr));
+}
+
+TEST(test_split, split_contiguous) {
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  char ** tokens = nullptr;
+  size_t count = 42u;
+  ASSERT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_split_contiguous("//hello//world/foo/", '/', allocator, &tokens, &count));
+  ASSERT_EQ(3u, count);
+  ASSERT_NE(nullptr, tokens);
+  EXPECT_STREQ("hello", tokens[0]);
+  EXPECT_STREQ("world", tokens[1]);
+  EXPECT_STREQ("foo", tokens[2]);
+  EXPECT_EQ(nullptr, tokens[3]);
+  // The tokens are in the block of the pointers
+  EXPECT_EQ(reinterpret_cast<char *>(tokens + 4), tokens[0]);
+  allocator.deallocate(tokens, allocator.state);
+
+  char * previous[1] = {nullptr};
+  for (const char * s : {static_cast<const char *>(nullptr), "", "///"}) {
+    tokens = previous;
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_split_contiguous(s, '/', allocator, &tokens, &count));
+    EXPECT_EQ(0u, count);
+    EXPECT_EQ(nullptr, tokens);
+  }
+
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_split_contiguous("a/b", '/', allocator, nullptr, &count));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_split_contiguous("a/b", '/', allocator, &tokens, nullptr));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_split_contiguous(
+      "a/b", '/', rcutils_get_zero_initialized_allocator(), &tokens, &count));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_BAD_ALLOC,
+    rcutils_split_contiguous("a/b", '/', get_failing_allocator(), &tokens, &count));
+  rcutils_reset_error();
+  EXPECT_EQ(nullptr, tokens);
+
+  // The tokens are the same as the ones of rcutils_split()
+  const char * strs[] = {"hello", "/hello/world", "hello//world/", "a/b/c/d", "/"};
+  for (const char * s : strs) {
+    rcutils_string_array_t expected = rcutils_get_zero_initialized_string_array();
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_split(s, '/', allocator, &expected));
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_split_contiguous(s, '/', allocator, &tokens, &count));
+    ASSERT_EQ(expected.size, count);
+    for (size_t i = 0; i < count; ++i) {
+      EXPECT_STREQ(expected.data[i], tokens[i]);
+    }
+    allocator.deallocate(tokens, allocator.state);
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_string_array_fini(&expected));
+  }
+}
@@ -14,6 +14,9 @@
 
 #include <gtest/gtest.h>
 
+#include <string>
+#include <vector>
+
 #include "rcutils/strcasecmp.h"
 
 // Tests the rcutils_strcasecmp() function.
@@ -193,3 +196,70 @@ TEST(TestStrcasecmp, test_strncasecmp) {
   EXPECT_EQ(0, rcutils_strncasecmp("abc", "ab1C", 4, &value));
   EXPECT_GT(value, 0);
 }
+
+// Tests comparing strings longer than the blocks compared at once.
+TEST(TestStrcasecmp, test_strcasecmp_long) {
+  std::string lower = "the quick brown fox jumps over the lazy dog 0123456789 [@`{]";
+  std::string upper = "THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG 0123456789 [@`{]";
+  int value;
+  EXPECT_EQ(0, rcutils_strcasecmp(lower.c_str(), upper.c_str(), &value));
+  EXPECT_EQ(0, value);
+  for (size_t i = 0; i < lower.size(); ++i) {
+    SCOPED_TRACE(i);
+    // Characters around the letters are not folded
+    std::string other = upper;
+    other[i] = '_';
+    EXPECT_EQ(0, rcutils_strcasecmp(lower.c_str(), other.c_str(), &value));
+    EXPECT_NE(0, value);
+    EXPECT_EQ(0, rcutils_strncasecmp(lower.c_str(), other.c_str(), i, &value));
+    EXPECT_EQ(0, value);
+    EXPECT_EQ(0, rcutils_strncasecmp(lower.c_str(), other.c_str(), i + 1u, &value));
+    EXPECT_NE(0, value);
+
+    EXPECT_EQ(0, rcutils_strcasecmp(lower.substr(0, i).c_str(), upper.c_str(), &value));
+    EXPECT_LT(value, 0);
+    EXPECT_EQ(0, rcutils_strcasecmp(lower.c_str(), upper.substr(0, i).c_str(), &value));
+    EXPECT_GT(value, 0);
+  }
+  // No byte is read past the end of the strings, nor past n, even when the strings aren't
+  // null terminated, which AddressSanitizer checks with these allocations of the exact size
+  for (size_t length = 1u; length <= lower.size(); ++length) {
+    SCOPED_TRACE(length);
+    std::vector<char> exact_lower(lower.begin(), lower.begin() + length);
+    std::vector<char> exact_upper(upper.begin(), upper.begin() + length);
+    EXPECT_EQ(0, rcutils_strncasecmp(exact_lower.data(), exact_upper.data(), length, &value));
+    EXPECT_EQ(0, value);
+    exact_lower.push_back('\0');
+    exact_upper.back() = '\0';
+    EXPECT_EQ(0, rcutils_strcasecmp(exact_lower.data(), exact_upper.data(), &value));
+    EXPECT_GT(value, 0);
+  }
+  // Bytes above ASCII are compared as they are, whatever the locale
+  EXPECT_EQ(0, rcutils_strcasecmp("\xc3\xa9t\xc3\xa9", "\xc3\x89T\xc3\x89", &value));
+  EXPECT_NE(0, value);
+  EXPECT_EQ(0, rcutils_strcasecmp("\xc3\xa9t\xc3\xa9", "\xc3\xa9T\xc3\xa9", &value));
+  EXPECT_EQ(0, value);
+}
+
+// Tests the rcutils_strcasecmp_hash() function.
+TEST(TestStrcasecmp, test_strcasecmp_hash) {
+  EXPECT_EQ(0u, rcutils_strcasecmp_hash(NULL));
+  EXPECT_EQ(rcutils_strcasecmp_hash(""), rcutils_strcasecmp_hash(""));
+  EXPECT_EQ(rcutils_strcasecmp_hash("Debug"), rcutils_strcasecmp_hash("DEBUG"));
+  EXPECT_EQ(rcutils_strcasecmp_hash("debug"), rcutils_strcasecmp_hash("DEBUG"));
+  EXPECT_EQ(
+    rcutils_strcasecmp_hash("/Some/Long/Namespace/Node_1"),
+    rcutils_strcasecmp_hash("/some/long/namespace/NODE_1"));
+  EXPECT_NE(rcutils_strcasecmp_hash("debug"), rcutils_strcasecmp_hash("info"));
+  EXPECT_NE(rcutils_strcasecmp_hash("a"), rcutils_strcasecmp_hash("a "));
+  EXPECT_NE(rcutils_strcasecmp_hash("["), rcutils_strcasecmp_hash("{"));
+  EXPECT_NE(rcutils_strcasecmp_hash("@"), rcutils_strcasecmp_hash("`"));
+
+  const char * key1 = "Warn";
+  const char * key2 = "wARN";
+  const char * key3 = "Error";
+  EXPECT_EQ(rcutils_strcasecmp_hash_func(&key1), rcutils_strcasecmp_hash_func(&key2));
+  EXPECT_EQ(0, rcutils_strcasecmp_cmp_func(&key1, &key2));
+  EXPECT_GT(rcutils_strcasecmp_cmp_func(&key1, &key3), 0);
+  EXPECT_LT(rcutils_strcasecmp_cmp_func(&key3, &key1), 0);
+}
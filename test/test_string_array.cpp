@@ -14,9 +14,12 @@
 
 #include "gtest/gtest.h"
 
+#include <string>
+
 #include "./allocator_testing_utils.h"
 #include "./time_bomb_allocator_testing_utils.h"
 #include "rcutils/error_handling.h"
+#include "rcutils/strdup.h"
 #include "rcutils/types/string_array.h"
 
 #ifdef _WIN32
@@ -328,3 +331,95 @@ TEST(test_string_array, string_array_sort) {
 
   ASSERT_EQ(RCUTILS_RET_OK, rcutils_string_array_fini(&sa0));
 }
+
+TEST(test_string_array, string_array_sort_multikey) {
+  auto allocator = rcutils_get_default_allocator();
+
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_string_array_sort_multikey(nullptr));
+  rcutils_reset_error();
+
+  rcutils_string_array_t sa0 = rcutils_get_zero_initialized_string_array();
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_string_array_sort_multikey(&sa0));
+
+  // Names sharing long prefixes, with duplicates, prefixes of others and empty entries
+  const size_t count = 5000u;
+  rcutils_string_array_t sa1 = rcutils_get_zero_initialized_string_array();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_string_array_init(&sa0, count, &allocator));
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_string_array_init(&sa1, count, &allocator));
+  uint32_t state = 42u;
+  for (size_t i = 0; i < count; i++) {
+    state = state * 1664525u + 1013904223u;
+    if (0u == (state >> 8) % 17u) {
+      continue;
+    }
+    std::string name = "/robot_" + std::to_string((state >> 8) % 3u);
+    if (0u != (state >> 12) % 5u) {
+      name += "/sensors/camera_" + std::to_string((state >> 16) % 40u);
+    }
+    if (0u == (state >> 20) % 3u) {
+      name += "/image_raw\xc3\xa9";
+    }
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_string_array_set(&sa0, i, name.c_str()));
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_string_array_set(&sa1, i, name.c_str()));
+  }
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_string_array_sort_multikey(&sa0));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_string_array_sort(&sa1));
+  for (size_t i = 0; i < count; i++) {
+    EXPECT_STREQ(sa1.data[i], sa0.data[i]) << i;
+  }
+
+  // Already in order
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_string_array_sort_multikey(&sa0));
+  for (size_t i = 0; i < count; i++) {
+    EXPECT_STREQ(sa1.data[i], sa0.data[i]) << i;
+  }
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_string_array_fini(&sa0));
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_string_array_fini(&sa1));
+}
+
+TEST(test_string_array, string_array_init_with_arena) {
+  auto allocator = rcutils_get_default_allocator();
+  auto failing_allocator = get_failing_allocator();
+  rcutils_string_array_t sa0 = rcutils_get_zero_initialized_string_array();
+  EXPECT_EQ(
+    RCUTILS_RET_BAD_ALLOC, rcutils_string_array_init_with_arena(&sa0, 2, &failing_allocator, 0));
+  rcutils_reset_error();
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_string_array_init_with_arena(&sa0, 4, &allocator, 16));
+  EXPECT_NE(nullptr, sa0.arena);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_string_array_set(&sa0, 0, "foo"));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_string_array_set(&sa0, 1, "bar"));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_string_array_set(&sa0, 0, "foobar"));
+  // Larger than a chunk.
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_string_array_set(&sa0, 2, "a rather long string"));
+  // Strings from the allocator may be mixed with the ones in the arena.
+  sa0.data[3] = rcutils_strdup("baz", allocator);
+  EXPECT_STREQ("foobar", sa0.data[0]);
+  EXPECT_STREQ("bar", sa0.data[1]);
+  EXPECT_STREQ("a rather long string", sa0.data[2]);
+  EXPECT_STREQ("baz", sa0.data[3]);
+
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_string_array_set(&sa0, 4, "foo"));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_string_array_set(&sa0, 0, NULL));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_string_array_set(NULL, 0, "foo"));
+  rcutils_reset_error();
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_string_array_resize(&sa0, 1));
+  EXPECT_STREQ("foobar", sa0.data[0]);
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_string_array_resize(&sa0, 2));
+  EXPECT_EQ(nullptr, sa0.data[1]);
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_string_array_fini(&sa0));
+  EXPECT_EQ(nullptr, sa0.arena);
+
+  // Without an arena the strings are duplicated with the allocator.
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_string_array_init(&sa0, 1, &allocator));
+  EXPECT_EQ(nullptr, sa0.arena);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_string_array_set(&sa0, 0, "foo"));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_string_array_set(&sa0, 0, "bar"));
+  EXPECT_STREQ("bar", sa0.data[0]);
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_string_array_fini(&sa0));
+}
@@ -15,6 +15,7 @@
 #include <gtest/gtest.h>
 
 #include <string>
+#include <vector>
 
 #include "./allocator_testing_utils.h"
 
@@ -1939,3 +1940,256 @@ TEST(test_string_map, strange_keys) {
     EXPECT_STREQ("value1", rcutils_string_map_get(&string_map, "key with spaces"));
   }
 }
+
+TEST_F(TestStringMap, many_keys) {
+  rcutils_ret_t ret = rcutils_string_map_init(&string_map, 0, allocator);
+  ASSERT_EQ(RCUTILS_RET_OK, ret);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(
+      RCUTILS_RET_OK,
+      rcutils_string_map_fini(&string_map)) << rcutils_get_error_string().str;
+    rcutils_reset_error();
+  });
+
+  const size_t count = 5000;
+  for (size_t i = 0; i < count; ++i) {
+    std::string key = "/node_" + std::to_string(i) + "/parameter";
+    ret = rcutils_string_map_set(&string_map, key.c_str(), std::to_string(i).c_str());
+    ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  }
+  // Remove every other key.
+  for (size_t i = 0; i < count; i += 2) {
+    std::string key = "/node_" + std::to_string(i) + "/parameter";
+    ret = rcutils_string_map_unset(&string_map, key.c_str());
+    ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  }
+  for (size_t i = 0; i < count; ++i) {
+    std::string key = "/node_" + std::to_string(i) + "/parameter";
+    if (0 == i % 2) {
+      EXPECT_FALSE(rcutils_string_map_key_exists(&string_map, key.c_str())) << key;
+      EXPECT_EQ(nullptr, rcutils_string_map_get(&string_map, key.c_str())) << key;
+    } else {
+      EXPECT_STREQ(std::to_string(i).c_str(), rcutils_string_map_get(&string_map, key.c_str()));
+    }
+  }
+
+  // The keys are iterated in the order they were set, removed keys leaving gaps.
+  size_t i = 1;
+  const char * key = rcutils_string_map_get_next_key(&string_map, NULL);
+  for (; NULL != key; i += 2) {
+    EXPECT_EQ("/node_" + std::to_string(i) + "/parameter", key);
+    key = rcutils_string_map_get_next_key(&string_map, key);
+  }
+  EXPECT_EQ(count + 1, i);
+  // Keys which are not the ones stored in the map aren't found.
+  std::string copy = "/node_1/parameter";
+  EXPECT_EQ(nullptr, rcutils_string_map_get_next_key(&string_map, copy.c_str()));
+
+  // New keys reuse the first free entries.
+  ret = rcutils_string_map_set(&string_map, "new", "value");
+  ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  EXPECT_STREQ("new", rcutils_string_map_get_next_key(&string_map, NULL));
+}
+
+TEST_F(TestStringMap, reserve_less_keeps_keys) {
+  rcutils_ret_t ret = rcutils_string_map_init(&string_map, 8, allocator);
+  ASSERT_EQ(RCUTILS_RET_OK, ret);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(
+      RCUTILS_RET_OK,
+      rcutils_string_map_fini(&string_map)) << rcutils_get_error_string().str;
+    rcutils_reset_error();
+  });
+
+  std::vector<std::string> keys;
+  for (size_t i = 0; i < 8; ++i) {
+    keys.push_back("key" + std::to_string(i));
+    ret = rcutils_string_map_set(&string_map, keys.back().c_str(), "value");
+    ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  }
+  for (size_t i = 0; i < 6; ++i) {
+    ret = rcutils_string_map_unset(&string_map, keys[i].c_str());
+    ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  }
+
+  // The remaining keys are moved into the smaller capacity, keeping their order.
+  ret = rcutils_string_map_reserve(&string_map, 0);
+  ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  size_t capacity = 0;
+  ret = rcutils_string_map_get_capacity(&string_map, &capacity);
+  EXPECT_EQ(RCUTILS_RET_OK, ret);
+  EXPECT_EQ(2u, capacity);
+  EXPECT_STREQ("value", rcutils_string_map_get(&string_map, "key6"));
+  EXPECT_STREQ("value", rcutils_string_map_get(&string_map, "key7"));
+  const char * key = rcutils_string_map_get_next_key(&string_map, NULL);
+  EXPECT_STREQ("key6", key);
+  EXPECT_STREQ("key7", rcutils_string_map_get_next_key(&string_map, key));
+}
+
+TEST_F(TestStringMap, getn_stops_at_null_character) {
+  rcutils_ret_t ret = rcutils_string_map_init(&string_map, 2, allocator);
+  ASSERT_EQ(RCUTILS_RET_OK, ret);
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(
+      RCUTILS_RET_OK,
+      rcutils_string_map_fini(&string_map)) << rcutils_get_error_string().str;
+    rcutils_reset_error();
+  });
+
+  ret = rcutils_string_map_set(&string_map, "key", "value");
+  ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  const char key[] = "key\0ignored";
+  EXPECT_STREQ("value", rcutils_string_map_getn(&string_map, key, sizeof(key)));
+  EXPECT_TRUE(rcutils_string_map_key_existsn(&string_map, key, sizeof(key)));
+  EXPECT_FALSE(rcutils_string_map_key_existsn(&string_map, key, 2));
+  EXPECT_FALSE(rcutils_string_map_key_existsn(&string_map, "keys", 4));
+}
+
+static size_t g_allocations = 0u;
+
+static void *
+counting_allocate(size_t size, void * state)
+{
+  ++g_allocations;
+  return rcutils_get_default_allocator().allocate(size, state);
+}
+
+TEST_F(TestStringMap, init_with_arena) {
+  rcutils_allocator_t counting_allocator = rcutils_get_default_allocator();
+  counting_allocator.allocate = counting_allocate;
+  rcutils_ret_t ret =
+    rcutils_string_map_init_with_arena(&string_map, 64, counting_allocator, 0u);
+  ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+  {
+    EXPECT_EQ(
+      RCUTILS_RET_OK,
+      rcutils_string_map_fini(&string_map)) << rcutils_get_error_string().str;
+    rcutils_reset_error();
+  });
+  EXPECT_EQ(
+    RCUTILS_RET_STRING_MAP_ALREADY_INIT,
+    rcutils_string_map_init_with_arena(&string_map, 64, counting_allocator, 0u));
+  rcutils_reset_error();
+
+  // The keys and values of the map fit in a single chunk of the arena.
+  g_allocations = 0u;
+  for (size_t i = 0; i < 64; ++i) {
+    std::string key = "key" + std::to_string(i);
+    ret = rcutils_string_map_set_no_resize(&string_map, key.c_str(), "value");
+    ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  }
+  EXPECT_EQ(1u, g_allocations);
+  EXPECT_STREQ("value", rcutils_string_map_get(&string_map, "key42"));
+
+  ret = rcutils_string_map_set(&string_map, "key42", "other value");
+  ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  EXPECT_STREQ("other value", rcutils_string_map_get(&string_map, "key42"));
+  ret = rcutils_string_map_unset(&string_map, "key0");
+  ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  EXPECT_FALSE(rcutils_string_map_key_exists(&string_map, "key0"));
+
+  // Strings larger than a chunk get one of their own.
+  std::string large_value(8192, 'v');
+  ret = rcutils_string_map_set(&string_map, "large", large_value.c_str());
+  ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  EXPECT_EQ(large_value, rcutils_string_map_get(&string_map, "large"));
+
+  // The map may be reused after being cleared.
+  ret = rcutils_string_map_clear(&string_map);
+  ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  g_allocations = 0u;
+  ret = rcutils_string_map_set(&string_map, "key", "value");
+  ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  EXPECT_EQ(0u, g_allocations);
+  EXPECT_STREQ("value", rcutils_string_map_get(&string_map, "key"));
+  rcutils_string_map_t copy = rcutils_get_zero_initialized_string_map();
+  ret = rcutils_string_map_init(&copy, 0, allocator);
+  ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  ret = rcutils_string_map_copy(&string_map, &copy);
+  EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  EXPECT_STREQ("value", rcutils_string_map_get(&copy, "key"));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_string_map_fini(&copy));
+}
+
+TEST_F(TestStringMap, memory_usage_and_shrink_to_fit) {
+  size_t bytes = 0;
+  EXPECT_EQ(
+    RCUTILS_RET_STRING_MAP_INVALID, rcutils_string_map_get_memory_usage(&string_map, &bytes));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_STRING_MAP_INVALID, rcutils_string_map_shrink_to_fit(&string_map));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_string_map_shrink_to_fit(NULL));
+  rcutils_reset_error();
+
+  for (bool with_arena : {false, true}) {
+    rcutils_ret_t ret = with_arena ?
+      rcutils_string_map_init_with_arena(&string_map, 2, allocator, 256u) :
+      rcutils_string_map_init(&string_map, 2, allocator);
+    ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    OSRF_TESTING_TOOLS_CPP_SCOPE_EXIT(
+    {
+      EXPECT_EQ(
+        RCUTILS_RET_OK,
+        rcutils_string_map_fini(&string_map)) << rcutils_get_error_string().str;
+      rcutils_reset_error();
+    });
+    EXPECT_EQ(
+      RCUTILS_RET_INVALID_ARGUMENT, rcutils_string_map_get_memory_usage(&string_map, NULL));
+    rcutils_reset_error();
+    size_t initial_bytes = 0;
+    ret = rcutils_string_map_get_memory_usage(&string_map, &initial_bytes);
+    ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < 1000; ++i) {
+      keys.push_back("key" + std::to_string(i));
+      ret = rcutils_string_map_set(&string_map, keys.back().c_str(), "some value");
+      ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    }
+    size_t peak_bytes = 0;
+    ret = rcutils_string_map_get_memory_usage(&string_map, &peak_bytes);
+    ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    // The capacity and the copies of the keys and values.
+    EXPECT_GT(peak_bytes, initial_bytes + 1000 * (2 * sizeof(char *) + 6 + 11));
+
+    for (size_t i = 0; i < 990; ++i) {
+      ret = rcutils_string_map_unset(&string_map, keys[i].c_str());
+      ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    }
+    ret = rcutils_string_map_shrink_to_fit(&string_map);
+    ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    size_t capacity = 0;
+    ret = rcutils_string_map_get_capacity(&string_map, &capacity);
+    EXPECT_EQ(RCUTILS_RET_OK, ret);
+    EXPECT_EQ(10u, capacity);
+    ret = rcutils_string_map_get_memory_usage(&string_map, &bytes);
+    ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    EXPECT_LT(bytes, peak_bytes / 10);
+    for (size_t i = 0; i < 1000; ++i) {
+      if (i < 990) {
+        EXPECT_FALSE(rcutils_string_map_key_exists(&string_map, keys[i].c_str())) << i;
+      } else {
+        EXPECT_STREQ("some value", rcutils_string_map_get(&string_map, keys[i].c_str())) << i;
+      }
+    }
+
+    // The map still grows, and shrinks down to nothing once empty.
+    ret = rcutils_string_map_set(&string_map, "key", "value");
+    ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    EXPECT_STREQ("value", rcutils_string_map_get(&string_map, "key"));
+    ret = rcutils_string_map_clear(&string_map);
+    ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    ret = rcutils_string_map_shrink_to_fit(&string_map);
+    ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    ret = rcutils_string_map_get_capacity(&string_map, &capacity);
+    EXPECT_EQ(RCUTILS_RET_OK, ret);
+    EXPECT_EQ(0u, capacity);
+    ret = rcutils_string_map_set(&string_map, "key", "value");
+    ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    EXPECT_STREQ("value", rcutils_string_map_get(&string_map, "key"));
+  }
+}
@@ -0,0 +1,219 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <string>
+#include <thread>
+
+#include "rcutils/error_handling.h"
+#include "rcutils/thread.h"
+
+TEST(TestThread, cpu_set) {
+  rcutils_thread_cpu_set_t cpus = rcutils_get_zero_initialized_thread_cpu_set();
+  EXPECT_EQ(0u, rcutils_thread_cpu_set_count(&cpus));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_thread_cpu_set_add(&cpus, 0u));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_thread_cpu_set_add(&cpus, 65u));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_thread_cpu_set_add(&cpus, RCUTILS_THREAD_MAX_CPUS - 1u));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_thread_cpu_set_add(&cpus, 65u));
+  EXPECT_EQ(3u, rcutils_thread_cpu_set_count(&cpus));
+  EXPECT_TRUE(rcutils_thread_cpu_set_contains(&cpus, 0u));
+  EXPECT_TRUE(rcutils_thread_cpu_set_contains(&cpus, 65u));
+  EXPECT_TRUE(rcutils_thread_cpu_set_contains(&cpus, RCUTILS_THREAD_MAX_CPUS - 1u));
+  EXPECT_FALSE(rcutils_thread_cpu_set_contains(&cpus, 1u));
+  EXPECT_FALSE(rcutils_thread_cpu_set_contains(&cpus, RCUTILS_THREAD_MAX_CPUS));
+  EXPECT_FALSE(rcutils_thread_cpu_set_contains(NULL, 0u));
+  EXPECT_EQ(0u, rcutils_thread_cpu_set_count(NULL));
+
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_thread_cpu_set_add(&cpus, RCUTILS_THREAD_MAX_CPUS));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_thread_cpu_set_add(NULL, 0u));
+  rcutils_reset_error();
+}
+
+TEST(TestThread, affinity) {
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_thread_get_affinity(NULL));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_thread_set_affinity(NULL));
+  rcutils_reset_error();
+  rcutils_thread_cpu_set_t empty = rcutils_get_zero_initialized_thread_cpu_set();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_thread_set_affinity(&empty));
+  rcutils_reset_error();
+
+  rcutils_thread_cpu_set_t cpus;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_thread_get_affinity(&cpus));
+  ASSERT_LT(0u, rcutils_thread_cpu_set_count(&cpus));
+#ifndef __APPLE__
+  // Bind a thread to the first processor it may run on
+  std::thread thread(
+    [&cpus]() {
+      size_t first = 0u;
+      while (!rcutils_thread_cpu_set_contains(&cpus, first)) {
+        ++first;
+      }
+      rcutils_thread_cpu_set_t single = rcutils_get_zero_initialized_thread_cpu_set();
+      ASSERT_EQ(RCUTILS_RET_OK, rcutils_thread_cpu_set_add(&single, first));
+      ASSERT_EQ(RCUTILS_RET_OK, rcutils_thread_set_affinity(&single)) <<
+        rcutils_get_error_string().str;
+      rcutils_thread_cpu_set_t bound;
+      ASSERT_EQ(RCUTILS_RET_OK, rcutils_thread_get_affinity(&bound));
+      EXPECT_EQ(1u, rcutils_thread_cpu_set_count(&bound));
+      EXPECT_TRUE(rcutils_thread_cpu_set_contains(&bound, first));
+    });
+  thread.join();
+#endif
+}
+
+TEST(TestThread, name) {
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_thread_set_name(NULL));
+  rcutils_reset_error();
+  char name[RCUTILS_THREAD_MAX_NAME_LENGTH];
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_thread_get_name(NULL, sizeof(name)));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_thread_get_name(name, 0u));
+  rcutils_reset_error();
+
+  std::thread thread(
+    [&name]() {
+      if (RCUTILS_RET_OK != rcutils_thread_set_name("rcutils_test")) {
+        // Older versions of Windows can't name threads
+        rcutils_reset_error();
+        return;
+      }
+      ASSERT_EQ(RCUTILS_RET_OK, rcutils_thread_get_name(name, sizeof(name)));
+      EXPECT_STREQ("rcutils_test", name);
+      // Truncated to the size given
+      ASSERT_EQ(RCUTILS_RET_OK, rcutils_thread_get_name(name, 5u));
+      EXPECT_STREQ("rcut", name);
+      // Long names are truncated rather than rejected
+      ASSERT_EQ(
+        RCUTILS_RET_OK,
+        rcutils_thread_set_name("a_name_which_is_longer_than_linux_allows"));
+      ASSERT_EQ(RCUTILS_RET_OK, rcutils_thread_get_name(name, sizeof(name)));
+      EXPECT_EQ(0u, std::string("a_name_which_is_longer_than_linux_allows").find(name));
+    });
+  thread.join();
+}
+
+TEST(TestThread, scheduling) {
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_thread_get_scheduling(NULL, NULL));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_thread_set_scheduling(static_cast<rcutils_thread_scheduling_policy_t>(42), 0));
+  rcutils_reset_error();
+
+  std::thread thread(
+    []() {
+      EXPECT_EQ(
+        RCUTILS_RET_OK,
+        rcutils_thread_set_scheduling(RCUTILS_THREAD_SCHEDULING_POLICY_UNCHANGED, 0));
+      EXPECT_EQ(
+        RCUTILS_RET_OK,
+        rcutils_thread_set_scheduling(RCUTILS_THREAD_SCHEDULING_POLICY_OTHER, 0));
+      rcutils_thread_scheduling_policy_t policy;
+      int priority = -1;
+      ASSERT_EQ(RCUTILS_RET_OK, rcutils_thread_get_scheduling(&policy, &priority));
+      EXPECT_EQ(RCUTILS_THREAD_SCHEDULING_POLICY_OTHER, policy);
+      EXPECT_EQ(0, priority);
+
+      // Real-time policies need privileges which tests usually don't have
+      rcutils_ret_t ret = rcutils_thread_set_scheduling(RCUTILS_THREAD_SCHEDULING_POLICY_FIFO, 10);
+      if (RCUTILS_RET_OK == ret) {
+        ASSERT_EQ(RCUTILS_RET_OK, rcutils_thread_get_scheduling(&policy, &priority));
+#ifdef _WIN32
+        EXPECT_EQ(RCUTILS_THREAD_SCHEDULING_POLICY_ROUND_ROBIN, policy);
+#else
+        EXPECT_EQ(RCUTILS_THREAD_SCHEDULING_POLICY_FIFO, policy);
+        EXPECT_EQ(10, priority);
+#endif
+      } else {
+        EXPECT_EQ(RCUTILS_RET_ERROR, ret);
+        rcutils_reset_error();
+      }
+    });
+  thread.join();
+}
+
+TEST(TestThread, attributes) {
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_thread_set_attributes(NULL));
+  rcutils_reset_error();
+
+  rcutils_thread_attributes_t attributes = rcutils_thread_get_default_attributes();
+  EXPECT_EQ(NULL, attributes.cpus);
+  EXPECT_EQ(RCUTILS_THREAD_SCHEDULING_POLICY_UNCHANGED, attributes.policy);
+  EXPECT_EQ(NULL, attributes.name);
+  // Leaves the thread as it is
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_thread_set_attributes(&attributes));
+
+  // Stops at the first attribute which can't be set
+  rcutils_thread_cpu_set_t empty = rcutils_get_zero_initialized_thread_cpu_set();
+  attributes.cpus = &empty;
+  attributes.name = "never_set";
+  std::thread thread(
+    [&attributes]() {
+      EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_thread_set_attributes(&attributes));
+      rcutils_reset_error();
+      char name[RCUTILS_THREAD_MAX_NAME_LENGTH];
+      if (RCUTILS_RET_OK == rcutils_thread_get_name(name, sizeof(name))) {
+        EXPECT_STRNE("never_set", name);
+      } else {
+        rcutils_reset_error();
+      }
+    });
+  thread.join();
+}
+
+TEST(TestThread, identity) {
+  uint64_t id = rcutils_thread_get_id();
+  EXPECT_NE(0u, id);
+  EXPECT_EQ(id, rcutils_thread_get_id());
+  std::thread thread(
+    [id]() {
+      EXPECT_NE(id, rcutils_thread_get_id());
+      if (RCUTILS_RET_OK != rcutils_thread_set_name("first")) {
+        rcutils_reset_error();
+        return;
+      }
+      const char * name = rcutils_thread_get_cached_name();
+      EXPECT_STREQ("first", name);
+      // Naming the thread again refreshes the cache
+      ASSERT_EQ(RCUTILS_RET_OK, rcutils_thread_set_name("second"));
+      EXPECT_STREQ("second", rcutils_thread_get_cached_name());
+    });
+  thread.join();
+
+#ifdef __linux__
+  // The thread of the child of a fork has its own id
+  pid_t child = fork();
+  ASSERT_NE(-1, child);
+  if (0 == child) {
+    _exit(rcutils_thread_get_id() == static_cast<uint64_t>(syscall(SYS_gettid)) ? 0 : 1);
+  }
+  int status = 0;
+  ASSERT_EQ(child, waitpid(child, &status, 0));
+  EXPECT_TRUE(WIFEXITED(status));
+  EXPECT_EQ(0, WEXITSTATUS(status));
+  EXPECT_EQ(id, rcutils_thread_get_id());
+#endif
+}
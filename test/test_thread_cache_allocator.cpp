@@ -0,0 +1,304 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "./allocator_testing_utils.h"
+#include "rcutils/allocator.h"
+#include "rcutils/error_handling.h"
+#include "rcutils/thread_cache_allocator.h"
+
+// Counts the allocations reaching the default allocator
+static std::atomic<int64_t> g_outstanding{0};
+
+static void * counting_allocate(size_t size, void * state)
+{
+  (void)state;
+  ++g_outstanding;
+  return malloc(size);
+}
+
+static void counting_deallocate(void * pointer, void * state)
+{
+  (void)state;
+  if (nullptr != pointer) {
+    --g_outstanding;
+  }
+  free(pointer);
+}
+
+static void * counting_reallocate(void * pointer, size_t size, void * state)
+{
+  (void)state;
+  if (nullptr == pointer) {
+    ++g_outstanding;
+  }
+  return realloc(pointer, size);
+}
+
+static void * counting_zero_allocate(size_t count, size_t size, void * state)
+{
+  (void)state;
+  ++g_outstanding;
+  return calloc(count, size);
+}
+
+static rcutils_allocator_t get_counting_allocator()
+{
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  allocator.allocate = counting_allocate;
+  allocator.deallocate = counting_deallocate;
+  allocator.reallocate = counting_reallocate;
+  allocator.zero_allocate = counting_zero_allocate;
+  return allocator;
+}
+
+class ThreadCacheAllocatorTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    g_outstanding = 0;
+    rcutils_allocator_t counting_allocator = get_counting_allocator();
+    ASSERT_EQ(
+      RCUTILS_RET_OK, rcutils_thread_cache_allocator_init(&cache, &counting_allocator));
+    allocator = rcutils_thread_cache_allocator_get_allocator(&cache);
+    ASSERT_TRUE(rcutils_allocator_is_valid(&allocator));
+  }
+
+  void TearDown() override
+  {
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_thread_cache_allocator_fini(&cache));
+    EXPECT_EQ(0, g_outstanding);
+  }
+
+  rcutils_thread_cache_allocator_t cache = rcutils_get_zero_initialized_thread_cache_allocator();
+  rcutils_allocator_t allocator = rcutils_get_zero_initialized_allocator();
+};
+
+TEST(test_thread_cache_allocator, init_fini) {
+  rcutils_allocator_t default_allocator = rcutils_get_default_allocator();
+  rcutils_allocator_t failing_allocator = get_failing_allocator();
+  rcutils_allocator_t invalid_allocator = rcutils_get_zero_initialized_allocator();
+  rcutils_thread_cache_allocator_t cache = rcutils_get_zero_initialized_thread_cache_allocator();
+
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_thread_cache_allocator_init(nullptr, &default_allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_thread_cache_allocator_init(&cache, nullptr));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_thread_cache_allocator_init(&cache, &invalid_allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_BAD_ALLOC, rcutils_thread_cache_allocator_init(&cache, &failing_allocator));
+  rcutils_reset_error();
+
+  rcutils_allocator_t allocator = rcutils_thread_cache_allocator_get_allocator(&cache);
+  EXPECT_FALSE(rcutils_allocator_is_valid(&allocator));
+  allocator = rcutils_thread_cache_allocator_get_allocator(nullptr);
+  EXPECT_FALSE(rcutils_allocator_is_valid(&allocator));
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_thread_cache_allocator_flush(nullptr));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_NOT_INITIALIZED, rcutils_thread_cache_allocator_flush(&cache));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_thread_cache_allocator_fini(nullptr));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_thread_cache_allocator_fini(&cache));
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_thread_cache_allocator_init(&cache, &default_allocator));
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_thread_cache_allocator_init(&cache, &default_allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_thread_cache_allocator_flush(&cache));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_thread_cache_allocator_fini(&cache));
+  EXPECT_EQ(nullptr, cache.impl);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_thread_cache_allocator_fini(&cache));
+
+  // Blocks failing to be allocated
+  set_failing_allocator_is_failing(failing_allocator, false);
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_thread_cache_allocator_init(&cache, &failing_allocator));
+  set_failing_allocator_is_failing(failing_allocator, true);
+  allocator = rcutils_thread_cache_allocator_get_allocator(&cache);
+  EXPECT_EQ(nullptr, allocator.allocate(16, allocator.state));
+  EXPECT_EQ(nullptr, allocator.allocate(1000, allocator.state));
+  EXPECT_EQ(nullptr, allocator.zero_allocate(4, 4, allocator.state));
+  set_failing_allocator_is_failing(failing_allocator, false);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_thread_cache_allocator_fini(&cache));
+}
+
+TEST_F(ThreadCacheAllocatorTest, cache_reuse) {
+  void * first = allocator.allocate(20, allocator.state);
+  ASSERT_NE(nullptr, first);
+  memset(first, 1, 20);
+  int64_t outstanding = g_outstanding;
+  allocator.deallocate(first, allocator.state);
+  // The block stays in the cache, and is allocated again for the same size class
+  EXPECT_EQ(outstanding, g_outstanding);
+  EXPECT_EQ(first, allocator.allocate(32, allocator.state));
+  EXPECT_EQ(outstanding, g_outstanding);
+  allocator.deallocate(first, allocator.state);
+
+  // Large allocations aren't cached
+  void * large = allocator.allocate(1000, allocator.state);
+  ASSERT_NE(nullptr, large);
+  EXPECT_EQ(outstanding + 1, g_outstanding);
+  allocator.deallocate(large, allocator.state);
+  EXPECT_EQ(outstanding, g_outstanding);
+  allocator.deallocate(nullptr, allocator.state);
+
+  auto zeroed = static_cast<uint8_t *>(allocator.zero_allocate(8, 4, allocator.state));
+  ASSERT_NE(nullptr, zeroed);
+  for (size_t i = 0u; i < 32u; ++i) {
+    EXPECT_EQ(0u, zeroed[i]);
+  }
+  allocator.deallocate(zeroed, allocator.state);
+  EXPECT_EQ(nullptr, allocator.zero_allocate(SIZE_MAX, 2, allocator.state));
+  EXPECT_EQ(nullptr, allocator.allocate(SIZE_MAX, allocator.state));
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_thread_cache_allocator_flush(&cache));
+  // Only the thread cache allocator and the cache of the thread are left
+  EXPECT_EQ(2, g_outstanding);
+}
+
+TEST_F(ThreadCacheAllocatorTest, batch_flush) {
+  std::vector<void *> pointers;
+  for (size_t i = 0u; i < 2u * RCUTILS_THREAD_CACHE_ALLOCATOR_MAX_CACHED_BLOCKS; ++i) {
+    pointers.push_back(allocator.allocate(64, allocator.state));
+    ASSERT_NE(nullptr, pointers.back());
+  }
+  int64_t outstanding = g_outstanding;
+  for (void * pointer : pointers) {
+    allocator.deallocate(pointer, allocator.state);
+  }
+  // The cache is bounded, the blocks beyond it went back in batches
+  int64_t released = outstanding - g_outstanding;
+  EXPECT_GE(released, static_cast<int64_t>(RCUTILS_THREAD_CACHE_ALLOCATOR_MAX_CACHED_BLOCKS));
+  EXPECT_LT(released, static_cast<int64_t>(2u * RCUTILS_THREAD_CACHE_ALLOCATOR_MAX_CACHED_BLOCKS));
+}
+
+TEST_F(ThreadCacheAllocatorTest, reallocate) {
+  auto str = static_cast<char *>(allocator.reallocate(nullptr, 4, allocator.state));
+  ASSERT_NE(nullptr, str);
+  memcpy(str, "abc", 4);
+  EXPECT_EQ(str, allocator.reallocate(str, 16, allocator.state));
+
+  auto grown = static_cast<char *>(allocator.reallocate(str, 200, allocator.state));
+  ASSERT_NE(nullptr, grown);
+  EXPECT_STREQ("abc", grown);
+  auto large = static_cast<char *>(allocator.reallocate(grown, 5000, allocator.state));
+  ASSERT_NE(nullptr, large);
+  EXPECT_STREQ("abc", large);
+  memset(large + 3, 'x', 4996);
+  large[4999] = '\0';
+  auto larger = static_cast<char *>(allocator.reallocate(large, 10000, allocator.state));
+  ASSERT_NE(nullptr, larger);
+  EXPECT_EQ(4999u, strlen(larger));
+  auto small = static_cast<char *>(allocator.reallocate(larger, 8, allocator.state));
+  ASSERT_NE(nullptr, small);
+  EXPECT_EQ(0, memcmp("abcxxxxx", small, 8));
+  allocator.deallocate(small, allocator.state);
+}
+
+TEST_F(ThreadCacheAllocatorTest, threads) {
+  // Each thread frees some of its blocks and hands the others to the next thread
+  constexpr size_t thread_count = 8u;
+  std::vector<std::vector<void *>> handed(thread_count + 1u);
+  std::vector<std::thread> threads;
+  std::atomic<bool> failed{false};
+  for (size_t t = 0u; t < thread_count; ++t) {
+    threads.emplace_back(
+      [&, t]() {
+        std::mt19937 generator(static_cast<uint32_t>(t));
+        std::vector<std::pair<uint8_t *, size_t>> live;
+        for (size_t i = 0u; i < 20000u; ++i) {
+          if (live.empty() || generator() % 2u) {
+            size_t size = generator() % 300u;
+            auto pointer = static_cast<uint8_t *>(allocator.allocate(size, allocator.state));
+            if (nullptr == pointer) {
+              failed = true;
+              return;
+            }
+            memset(pointer, static_cast<int>(t), size);
+            live.emplace_back(pointer, size);
+          } else {
+            size_t index = generator() % live.size();
+            for (size_t j = 0u; j < live[index].second; ++j) {
+              if (live[index].first[j] != t) {
+                failed = true;
+              }
+            }
+            allocator.deallocate(live[index].first, allocator.state);
+            live[index] = live.back();
+            live.pop_back();
+          }
+        }
+        for (auto & allocation : live) {
+          handed[t + 1u].push_back(allocation.first);
+        }
+        EXPECT_EQ(RCUTILS_RET_OK, rcutils_thread_cache_allocator_flush(&cache));
+      });
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+  EXPECT_FALSE(failed);
+  // Blocks allocated by the other threads are deallocated by this one
+  for (auto & pointers : handed) {
+    for (void * pointer : pointers) {
+      allocator.deallocate(pointer, allocator.state);
+    }
+  }
+}
+
+TEST_F(ThreadCacheAllocatorTest, many_allocators) {
+  rcutils_allocator_t counting_allocator = get_counting_allocator();
+  std::vector<rcutils_thread_cache_allocator_t> caches(
+    RCUTILS_THREAD_CACHE_ALLOCATOR_MAX_PER_THREAD + 2,
+    rcutils_get_zero_initialized_thread_cache_allocator());
+  for (size_t i = 0u; i < caches.size(); ++i) {
+    ASSERT_EQ(
+      RCUTILS_RET_OK, rcutils_thread_cache_allocator_init(&caches[i], &counting_allocator));
+    rcutils_allocator_t other_allocator = rcutils_thread_cache_allocator_get_allocator(&caches[i]);
+    void * pointer = other_allocator.allocate(16, other_allocator.state);
+    ASSERT_NE(nullptr, pointer);
+    int64_t outstanding = g_outstanding;
+    other_allocator.deallocate(pointer, other_allocator.state);
+    // The allocators beyond the slots of the thread are used without cache
+    if (i < RCUTILS_THREAD_CACHE_ALLOCATOR_MAX_PER_THREAD) {
+      EXPECT_EQ(outstanding, g_outstanding);
+    } else {
+      EXPECT_EQ(outstanding - 1, g_outstanding);
+    }
+  }
+  for (auto & other : caches) {
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_thread_cache_allocator_fini(&other));
+  }
+  // The slots were given back
+  rcutils_thread_cache_allocator_t last = rcutils_get_zero_initialized_thread_cache_allocator();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_thread_cache_allocator_init(&last, &counting_allocator));
+  rcutils_allocator_t last_allocator = rcutils_thread_cache_allocator_get_allocator(&last);
+  void * pointer = last_allocator.allocate(16, last_allocator.state);
+  int64_t outstanding = g_outstanding;
+  last_allocator.deallocate(pointer, last_allocator.state);
+  EXPECT_EQ(outstanding, g_outstanding);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_thread_cache_allocator_fini(&last));
+}
@@ -0,0 +1,273 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "./allocator_testing_utils.h"
+#include "rcutils/error_handling.h"
+#include "rcutils/thread.h"
+#include "rcutils/thread_pool.h"
+
+// Adds the item to the sum of the context.
+static void
+add(rcutils_thread_pool_t * pool, void * context, void * item)
+{
+  (void)pool;
+  static_cast<std::atomic_size_t *>(context)->fetch_add(*static_cast<size_t *>(item));
+}
+
+// A range of numbers, split until each is processed on its own.
+struct range_t
+{
+  size_t begin;
+  size_t end;
+};
+
+struct split_context_t
+{
+  std::atomic_size_t sum;
+  std::atomic_size_t processed;
+  std::atomic_size_t overflows;
+};
+
+static void
+split(rcutils_thread_pool_t * pool, void * context, void * item)
+{
+  auto * split_context = static_cast<split_context_t *>(context);
+  range_t range = *static_cast<range_t *>(item);
+  while (range.end - range.begin > 1u) {
+    size_t middle = range.begin + (range.end - range.begin) / 2u;
+    range_t right = {middle, range.end};
+    range.end = middle;
+    if (RCUTILS_RET_OK != rcutils_thread_pool_push(pool, &right)) {
+      ++split_context->overflows;
+      split(pool, context, &right);
+    }
+  }
+  split_context->sum += range.begin;
+  ++split_context->processed;
+}
+
+TEST(TestThreadPool, init_fini) {
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  rcutils_thread_pool_t pool = rcutils_get_zero_initialized_thread_pool();
+  std::atomic_size_t sum(0);
+
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_thread_pool_init(nullptr, add, &sum, sizeof(size_t), nullptr, allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_thread_pool_init(&pool, nullptr, &sum, sizeof(size_t), nullptr, allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_thread_pool_init(&pool, add, &sum, 0u, nullptr, allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_thread_pool_init(
+      &pool, add, &sum, sizeof(size_t), nullptr, rcutils_get_zero_initialized_allocator()));
+  rcutils_reset_error();
+  rcutils_thread_pool_options_t options = rcutils_thread_pool_get_default_options();
+  options.cpu_affinity_count = 1u;
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_thread_pool_init(&pool, add, &sum, sizeof(size_t), &options, allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_BAD_ALLOC,
+    rcutils_thread_pool_init(
+      &pool, add, &sum, sizeof(size_t), nullptr, get_failing_allocator()));
+  rcutils_reset_error();
+  EXPECT_EQ(nullptr, pool.impl);
+
+  size_t item = 1u;
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_thread_pool_push(&pool, &item));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_thread_pool_wait(&pool));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_thread_pool_fini(&pool));
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_thread_pool_fini(nullptr));
+  rcutils_reset_error();
+
+  ASSERT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_thread_pool_init(&pool, add, &sum, sizeof(size_t), nullptr, allocator));
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_thread_pool_init(&pool, add, &sum, sizeof(size_t), nullptr, allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_thread_pool_push(&pool, nullptr));
+  rcutils_reset_error();
+  // Waiting with nothing pushed returns right away
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_thread_pool_wait(&pool));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_thread_pool_fini(&pool));
+  EXPECT_EQ(nullptr, pool.impl);
+}
+
+TEST(TestThreadPool, push_from_outside) {
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  rcutils_thread_pool_t pool = rcutils_get_zero_initialized_thread_pool();
+  std::atomic_size_t sum(0);
+  rcutils_thread_pool_options_t options = rcutils_thread_pool_get_default_options();
+  options.thread_count = 4u;
+  options.capacity = 1000u;
+  ASSERT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_thread_pool_init(&pool, add, &sum, sizeof(size_t), &options, allocator));
+
+  // The pool may be used again once waited for
+  for (size_t round = 1; round <= 3; ++round) {
+    for (size_t i = 1; i <= 1000u; ++i) {
+      ASSERT_EQ(RCUTILS_RET_OK, rcutils_thread_pool_push(&pool, &i));
+    }
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_thread_pool_wait(&pool));
+    EXPECT_EQ(round * 500500u, sum);
+  }
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_thread_pool_fini(&pool));
+}
+
+TEST(TestThreadPool, full_queue) {
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  rcutils_thread_pool_t pool = rcutils_get_zero_initialized_thread_pool();
+  std::atomic_size_t sum(0);
+  // Without threads of its own, the pool only processes items when waited for
+  rcutils_thread_pool_options_t options = rcutils_thread_pool_get_default_options();
+  options.thread_count = 1u;
+  options.capacity = 2u;
+  ASSERT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_thread_pool_init(&pool, add, &sum, sizeof(size_t), &options, allocator));
+  size_t item = 1u;
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_thread_pool_push(&pool, &item));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_thread_pool_push(&pool, &item));
+  EXPECT_EQ(RCUTILS_RET_NOT_ENOUGH_SPACE, rcutils_thread_pool_push(&pool, &item));
+  EXPECT_FALSE(rcutils_error_is_set());
+  EXPECT_EQ(0u, sum);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_thread_pool_wait(&pool));
+  EXPECT_EQ(2u, sum);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_thread_pool_fini(&pool));
+}
+
+TEST(TestThreadPool, push_from_items) {
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  for (size_t capacity : {2u, 256u}) {
+    for (size_t thread_count : {1u, 2u, 4u}) {
+      rcutils_thread_pool_t pool = rcutils_get_zero_initialized_thread_pool();
+      split_context_t context;
+      context.sum = 0u;
+      context.processed = 0u;
+      context.overflows = 0u;
+      rcutils_thread_pool_options_t options = rcutils_thread_pool_get_default_options();
+      options.thread_count = thread_count;
+      options.capacity = capacity;
+      ASSERT_EQ(
+        RCUTILS_RET_OK,
+        rcutils_thread_pool_init(&pool, split, &context, sizeof(range_t), &options, allocator));
+      constexpr size_t count = 100000u;
+      range_t range = {0u, count};
+      ASSERT_EQ(RCUTILS_RET_OK, rcutils_thread_pool_push(&pool, &range));
+      EXPECT_EQ(RCUTILS_RET_OK, rcutils_thread_pool_wait(&pool));
+      EXPECT_EQ(count, context.processed);
+      EXPECT_EQ(count * (count - 1u) / 2u, context.sum);
+      if (256u == capacity) {
+        // The depth of the splits is far below the capacity of the deques
+        EXPECT_EQ(0u, context.overflows);
+      }
+      EXPECT_EQ(RCUTILS_RET_OK, rcutils_thread_pool_fini(&pool));
+    }
+  }
+}
+
+TEST(TestThreadPool, cpu_affinity) {
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  rcutils_thread_pool_t pool = rcutils_get_zero_initialized_thread_pool();
+  std::atomic_size_t sum(0);
+  // Binding the threads is best effort, so the pool works with any processors
+  const size_t cpus[] = {0u, 1u};
+  rcutils_thread_pool_options_t options = rcutils_thread_pool_get_default_options();
+  options.thread_count = 3u;
+  options.cpu_affinity = cpus;
+  options.cpu_affinity_count = 2u;
+  ASSERT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_thread_pool_init(&pool, add, &sum, sizeof(size_t), &options, allocator));
+  for (size_t i = 1; i <= 100u; ++i) {
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_thread_pool_push(&pool, &i));
+  }
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_thread_pool_wait(&pool));
+  EXPECT_EQ(5050u, sum);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_thread_pool_fini(&pool));
+}
+
+struct names_t
+{
+  std::mutex mutex;
+  std::set<std::string> names;
+};
+
+// Records the name of the thread processing the item.
+static void
+record_name(rcutils_thread_pool_t * pool, void * context, void * item)
+{
+  (void)pool;
+  (void)item;
+  char name[RCUTILS_THREAD_MAX_NAME_LENGTH] = "";
+  if (RCUTILS_RET_OK != rcutils_thread_get_name(name, sizeof(name))) {
+    rcutils_reset_error();
+  }
+  names_t * names = static_cast<names_t *>(context);
+  std::lock_guard<std::mutex> lock(names->mutex);
+  names->names.insert(name);
+}
+
+TEST(TestThreadPool, thread_attributes) {
+  char main_name[RCUTILS_THREAD_MAX_NAME_LENGTH] = "";
+  if (RCUTILS_RET_OK != rcutils_thread_get_name(main_name, sizeof(main_name))) {
+    rcutils_reset_error();
+  }
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  rcutils_thread_pool_t pool = rcutils_get_zero_initialized_thread_pool();
+  names_t names;
+  rcutils_thread_pool_options_t options = rcutils_thread_pool_get_default_options();
+  options.thread_count = 3u;
+  {
+    // The attributes are copied, so they needn't outlive the initialization
+    std::string name = "pool_worker";
+    rcutils_thread_attributes_t attributes = rcutils_thread_get_default_attributes();
+    attributes.name = name.c_str();
+    options.thread_attributes = &attributes;
+    ASSERT_EQ(
+      RCUTILS_RET_OK,
+      rcutils_thread_pool_init(&pool, record_name, &names, sizeof(size_t), &options, allocator));
+    name = "overwritten";
+  }
+  for (size_t i = 0; i < 100u; ++i) {
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_thread_pool_push(&pool, &i));
+  }
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_thread_pool_wait(&pool));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_thread_pool_fini(&pool));
+  // The thread waiting for the pool keeps its name
+  for (const std::string & name : names.names) {
+    EXPECT_TRUE(name == main_name || name == "pool_worker") << name;
+  }
+}
@@ -191,6 +191,200 @@ TEST_F(TestTimeFixture, test_rcutils_steady_time_now) {
     llabs(steady_diff - sc_diff), RCUTILS_MS_TO_NS(k_tolerance_ms)) << "steady_clock differs";
 }
 
+// Tests the rcutils_coarse_steady_time_now() function.
+TEST_F(TestTimeFixture, test_rcutils_coarse_steady_time_now) {
+  rcutils_ret_t ret;
+  ret = rcutils_coarse_steady_time_now(nullptr);
+  EXPECT_EQ(ret, RCUTILS_RET_INVALID_ARGUMENT) << rcutils_get_error_string().str;
+  rcutils_reset_error();
+  rcutils_time_point_value_t now = 0;
+  EXPECT_NO_MEMORY_OPERATIONS(
+  {
+    ret = rcutils_coarse_steady_time_now(&now);
+  });
+  std::chrono::steady_clock::time_point now_sc = std::chrono::steady_clock::now();
+  EXPECT_EQ(ret, RCUTILS_RET_OK) << rcutils_get_error_string().str;
+  EXPECT_NE(0u, now);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  rcutils_time_point_value_t later;
+  EXPECT_NO_MEMORY_OPERATIONS(
+  {
+    ret = rcutils_coarse_steady_time_now(&later);
+  });
+  std::chrono::steady_clock::time_point later_sc = std::chrono::steady_clock::now();
+  EXPECT_EQ(ret, RCUTILS_RET_OK) << rcutils_get_error_string().str;
+  EXPECT_GE(later, now);
+  int64_t coarse_diff = later - now;
+  int64_t sc_diff =
+    std::chrono::duration_cast<std::chrono::nanoseconds>(later_sc - now_sc).count();
+  // The coarse clock only advances with the system timer.
+  const int k_tolerance_ms = 20;
+  EXPECT_LE(
+    llabs(coarse_diff - sc_diff), RCUTILS_MS_TO_NS(k_tolerance_ms)) << "coarse clock differs";
+}
+
+// Tests the rcutils_coarse_system_time_now() function.
+TEST_F(TestTimeFixture, test_rcutils_coarse_system_time_now) {
+  rcutils_ret_t ret;
+  ret = rcutils_coarse_system_time_now(nullptr);
+  EXPECT_EQ(ret, RCUTILS_RET_INVALID_ARGUMENT) << rcutils_get_error_string().str;
+  rcutils_reset_error();
+  rcutils_duration_value_t resolution = 0;
+  ret = rcutils_coarse_time_resolution(nullptr);
+  EXPECT_EQ(ret, RCUTILS_RET_INVALID_ARGUMENT) << rcutils_get_error_string().str;
+  rcutils_reset_error();
+  ret = rcutils_coarse_time_resolution(&resolution);
+  EXPECT_EQ(ret, RCUTILS_RET_OK) << rcutils_get_error_string().str;
+  EXPECT_GT(resolution, 0);
+  EXPECT_LE(resolution, RCUTILS_MS_TO_NS(100));
+  rcutils_time_point_value_t now = 0;
+  EXPECT_NO_MEMORY_OPERATIONS(
+  {
+    ret = rcutils_coarse_system_time_now(&now);
+  });
+  EXPECT_EQ(ret, RCUTILS_RET_OK) << rcutils_get_error_string().str;
+  rcutils_time_point_value_t precise = 0;
+  ret = rcutils_system_time_now(&precise);
+  EXPECT_EQ(ret, RCUTILS_RET_OK) << rcutils_get_error_string().str;
+  // The coarse clock lags the precise one by less than its resolution.
+  const int k_tolerance_ms = 20;
+  EXPECT_LE(llabs(precise - now), resolution + RCUTILS_MS_TO_NS(k_tolerance_ms));
+}
+
+// Tests the rcutils_time_correlate_clocks() function.
+TEST_F(TestTimeFixture, test_rcutils_time_correlate_clocks) {
+  rcutils_time_correlation_t correlation;
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_time_correlate_clocks(RCUTILS_TIME_CORRELATION_DEFAULT_SAMPLES, nullptr));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_time_correlate_clocks(0u, &correlation));
+  rcutils_reset_error();
+
+  rcutils_time_point_value_t steady_before, system_before;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_steady_time_now(&steady_before));
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_system_time_now(&system_before));
+  rcutils_ret_t ret;
+  EXPECT_NO_MEMORY_OPERATIONS(
+  {
+    ret = rcutils_time_correlate_clocks(RCUTILS_TIME_CORRELATION_DEFAULT_SAMPLES, &correlation);
+  });
+  ASSERT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+  EXPECT_GE(correlation.steady_time, steady_before);
+  EXPECT_GE(correlation.system_time, system_before);
+  EXPECT_EQ(correlation.system_time - correlation.steady_time, correlation.offset);
+  EXPECT_GE(correlation.uncertainty, 0);
+  EXPECT_LT(correlation.uncertainty, RCUTILS_MS_TO_NS(10));
+  // The system time read now is the converted steady time read now, within the tolerance.
+  rcutils_time_point_value_t times[2];
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_steady_time_now(&times[0]));
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_system_time_now(&times[1]));
+  ASSERT_EQ(
+    RCUTILS_RET_OK, rcutils_time_correlation_steady_to_system(&correlation, times, times, 1u));
+  const int k_tolerance_ms = 20;
+  EXPECT_LE(llabs(times[1] - times[0]), RCUTILS_MS_TO_NS(k_tolerance_ms));
+
+  EXPECT_EQ(
+    RCUTILS_RET_OK, rcutils_time_correlation_steady_to_system(&correlation, nullptr, nullptr, 0u));
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_time_correlation_steady_to_system(nullptr, times, times, 1u));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_time_correlation_steady_to_system(&correlation, nullptr, times, 1u));
+  rcutils_reset_error();
+}
+
+// Tests the rcutils_sleep_until_steady() and rcutils_sleep_spin_until_steady() functions.
+TEST_F(TestTimeFixture, test_rcutils_sleep_until_steady) {
+  rcutils_time_point_value_t now;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_steady_time_now(&now));
+  // Deadlines in the past return immediately.
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_sleep_until_steady(now - RCUTILS_S_TO_NS(1)));
+  EXPECT_EQ(
+    RCUTILS_RET_OK, rcutils_sleep_spin_until_steady(
+      now - RCUTILS_S_TO_NS(1), RCUTILS_SLEEP_DEFAULT_SPIN_MARGIN));
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_sleep_spin_until_steady(now, -1));
+  rcutils_reset_error();
+
+  // The sleeps never end before the deadline.
+  rcutils_time_point_value_t deadline = now + RCUTILS_MS_TO_NS(5);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_sleep_until_steady(deadline));
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_steady_time_now(&now));
+  EXPECT_GE(now, deadline);
+  const rcutils_duration_value_t margins[] = {
+    0, RCUTILS_SLEEP_DEFAULT_SPIN_MARGIN, RCUTILS_MS_TO_NS(10)};
+  for (rcutils_duration_value_t margin : margins) {
+    deadline = now + RCUTILS_MS_TO_NS(5);
+    rcutils_ret_t ret;
+    EXPECT_NO_MEMORY_OPERATIONS(
+    {
+      ret = rcutils_sleep_spin_until_steady(deadline, margin);
+    });
+    EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_steady_time_now(&now));
+    EXPECT_GE(now, deadline);
+    // The generous bound only catches sleeps which miss the deadline by far.
+    EXPECT_LT(now - deadline, RCUTILS_MS_TO_NS(50));
+  }
+}
+
+// Tests the rcutils_tsc_steady_time_now() function.
+TEST_F(TestTimeFixture, test_rcutils_tsc_steady_time_now) {
+  rcutils_ret_t ret;
+  ret = rcutils_tsc_steady_time_now(nullptr);
+  EXPECT_EQ(ret, RCUTILS_RET_INVALID_ARGUMENT) << rcutils_get_error_string().str;
+  rcutils_reset_error();
+
+  // Before the calibration, this is the steady clock
+  rcutils_time_point_value_t now = 0;
+  EXPECT_NO_MEMORY_OPERATIONS(
+  {
+    ret = rcutils_tsc_steady_time_now(&now);
+  });
+  EXPECT_EQ(ret, RCUTILS_RET_OK) << rcutils_get_error_string().str;
+  EXPECT_NE(0u, now);
+
+  EXPECT_NO_MEMORY_OPERATIONS(
+  {
+    ret = rcutils_tsc_steady_time_init();
+  });
+  ASSERT_EQ(ret, RCUTILS_RET_OK) << rcutils_get_error_string().str;
+  // Whether it is enabled depends on the machine, the behavior is the same otherwise
+  printf(
+    "the time stamp counter is %s\n", rcutils_tsc_steady_time_is_enabled() ? "used" : "not used");
+
+  rcutils_time_point_value_t steady_now = 0;
+  EXPECT_NO_MEMORY_OPERATIONS(
+  {
+    ret = rcutils_tsc_steady_time_now(&now);
+    EXPECT_EQ(ret, RCUTILS_RET_OK);
+    ret = rcutils_steady_time_now(&steady_now);
+  });
+  EXPECT_EQ(ret, RCUTILS_RET_OK);
+  const int k_tolerance_ms = 5;
+  EXPECT_LE(llabs(steady_now - now), RCUTILS_MS_TO_NS(k_tolerance_ms)) << "tsc clock differs";
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  rcutils_time_point_value_t later = 0;
+  rcutils_time_point_value_t steady_later = 0;
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_tsc_steady_time_now(&later));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_steady_time_now(&steady_later));
+  EXPECT_GT(later, now);
+  EXPECT_LE(
+    llabs((later - now) - (steady_later - steady_now)), RCUTILS_MS_TO_NS(k_tolerance_ms)) <<
+    "tsc clock differs";
+
+  // Successive time points don't go backwards
+  rcutils_time_point_value_t previous = later;
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_tsc_steady_time_now(&now));
+    EXPECT_GE(now, previous);
+    previous = now;
+  }
+}
+
 #if !defined(_WIN32)
 
 // For mocking purposes
@@ -353,3 +547,48 @@ TEST_F(TestTimeFixture, test_rcutils_time_point_value_as_seconds_string) {
   EXPECT_EQ(RCUTILS_RET_OK, ret) << rcutils_get_error_string().str;
   EXPECT_STREQ("-0000000000.000000100", buffer);
 }
+
+// Tests the rcutils_time_point_value_format_nanoseconds() and
+// rcutils_time_point_value_format_seconds() functions.
+TEST_F(TestTimeFixture, test_rcutils_time_point_value_format) {
+  char buffer[RCUTILS_TIME_POINT_FORMAT_STRING_SIZE];
+  EXPECT_EQ(0u, rcutils_time_point_value_format_nanoseconds(100, nullptr));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    0u, rcutils_time_point_value_format_seconds(
+      100, RCUTILS_TIME_POINT_PRECISION_NANOSECONDS, nullptr));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    0u, rcutils_time_point_value_format_seconds(
+      100, static_cast<rcutils_time_point_precision_t>(4), buffer));
+  rcutils_reset_error();
+
+  EXPECT_EQ(19u, rcutils_time_point_value_format_nanoseconds(1596554525123456789, buffer));
+  EXPECT_STREQ("1596554525123456789", buffer);
+  EXPECT_EQ(20u, rcutils_time_point_value_format_nanoseconds(-100, buffer));
+  EXPECT_STREQ("-0000000000000000100", buffer);
+  EXPECT_EQ(20u, rcutils_time_point_value_format_nanoseconds(INT64_MIN, buffer));
+  EXPECT_STREQ("-9223372036854775808", buffer);
+
+  const rcutils_time_point_value_t time_point = 1596554525123456789;
+  EXPECT_EQ(
+    14u, rcutils_time_point_value_format_seconds(
+      time_point, RCUTILS_TIME_POINT_PRECISION_MILLISECONDS, buffer));
+  EXPECT_STREQ("1596554525.123", buffer);
+  EXPECT_EQ(
+    17u, rcutils_time_point_value_format_seconds(
+      time_point, RCUTILS_TIME_POINT_PRECISION_MICROSECONDS, buffer));
+  EXPECT_STREQ("1596554525.123456", buffer);
+  EXPECT_EQ(
+    20u, rcutils_time_point_value_format_seconds(
+      time_point, RCUTILS_TIME_POINT_PRECISION_NANOSECONDS, buffer));
+  EXPECT_STREQ("1596554525.123456789", buffer);
+  EXPECT_EQ(
+    21u, rcutils_time_point_value_format_seconds(
+      INT64_MIN, RCUTILS_TIME_POINT_PRECISION_NANOSECONDS, buffer));
+  EXPECT_STREQ("-9223372036.854775808", buffer);
+  EXPECT_EQ(
+    15u, rcutils_time_point_value_format_seconds(
+      -1, RCUTILS_TIME_POINT_PRECISION_MILLISECONDS, buffer));
+  EXPECT_STREQ("-0000000000.000", buffer);
+}
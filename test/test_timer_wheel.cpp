@@ -0,0 +1,288 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "./allocator_testing_utils.h"
+#include "rcutils/allocator.h"
+#include "rcutils/error_handling.h"
+#include "rcutils/time.h"
+#include "rcutils/types/timer_wheel.h"
+
+namespace
+{
+
+struct Expiration
+{
+  std::vector<rcutils_timer_wheel_timer_t *> timers;
+  rcutils_time_point_value_t now = 0;
+  std::vector<rcutils_time_point_value_t> times;
+};
+
+void record(rcutils_timer_wheel_timer_t * timer, void * data)
+{
+  auto expiration = static_cast<Expiration *>(data);
+  expiration->timers.push_back(timer);
+  expiration->times.push_back(expiration->now);
+}
+
+struct Rescheduling
+{
+  rcutils_timer_wheel_t * wheel;
+  rcutils_timer_wheel_timer_t * other;
+  rcutils_time_point_value_t period;
+  rcutils_time_point_value_t now;
+  int count;
+};
+
+void reschedule(rcutils_timer_wheel_timer_t * timer, void * data)
+{
+  auto rescheduling = static_cast<Rescheduling *>(data);
+  ++rescheduling->count;
+  if (nullptr != rescheduling->other) {
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_timer_wheel_cancel(rescheduling->wheel, rescheduling->other));
+    rescheduling->other = nullptr;
+  }
+  EXPECT_EQ(
+    RCUTILS_RET_OK, rcutils_timer_wheel_schedule(
+      rescheduling->wheel, timer, rescheduling->now + rescheduling->period, reschedule, data));
+}
+
+}  // namespace
+
+TEST(test_timer_wheel, init_fini) {
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  rcutils_allocator_t failing_allocator = get_failing_allocator();
+  rcutils_timer_wheel_t wheel = rcutils_get_zero_initialized_timer_wheel();
+
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_timer_wheel_init(nullptr, 1, 0, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_timer_wheel_init(&wheel, 0, 0, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_timer_wheel_init(&wheel, 1, 0, nullptr));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_BAD_ALLOC, rcutils_timer_wheel_init(&wheel, 1, 0, &failing_allocator));
+  rcutils_reset_error();
+
+  size_t size = 1;
+  EXPECT_EQ(RCUTILS_RET_NOT_INITIALIZED, rcutils_timer_wheel_get_size(&wheel, &size));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_NOT_INITIALIZED, rcutils_timer_wheel_advance(&wheel, 0, nullptr));
+  rcutils_reset_error();
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_timer_wheel_init(&wheel, 1, 0, &allocator));
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_timer_wheel_init(&wheel, 1, 0, &allocator));
+  rcutils_reset_error();
+
+  // Finalizing unschedules the timers left
+  Expiration expiration;
+  rcutils_timer_wheel_timer_t timer = rcutils_get_zero_initialized_timer_wheel_timer();
+  EXPECT_FALSE(rcutils_timer_wheel_timer_is_scheduled(&timer));
+  EXPECT_FALSE(rcutils_timer_wheel_timer_is_scheduled(nullptr));
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_timer_wheel_schedule(&wheel, &timer, 10, nullptr, nullptr));
+  rcutils_reset_error();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_timer_wheel_schedule(&wheel, &timer, 10, record, &expiration));
+  EXPECT_TRUE(rcutils_timer_wheel_timer_is_scheduled(&timer));
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_timer_wheel_schedule(&wheel, &timer, 10, record, nullptr));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_timer_wheel_get_size(&wheel, &size));
+  EXPECT_EQ(1u, size);
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_timer_wheel_fini(&wheel));
+  EXPECT_EQ(nullptr, wheel.impl);
+  EXPECT_FALSE(rcutils_timer_wheel_timer_is_scheduled(&timer));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_timer_wheel_fini(&wheel));
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_timer_wheel_fini(nullptr));
+  rcutils_reset_error();
+  EXPECT_TRUE(expiration.timers.empty());
+}
+
+TEST(test_timer_wheel, expiration) {
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  rcutils_timer_wheel_t wheel = rcutils_get_zero_initialized_timer_wheel();
+  // Ticks of 1ms from 5s
+  const rcutils_time_point_value_t start = RCUTILS_S_TO_NS(5);
+  ASSERT_EQ(
+    RCUTILS_RET_OK, rcutils_timer_wheel_init(&wheel, RCUTILS_MS_TO_NS(1), start, &allocator));
+
+  Expiration expiration;
+  rcutils_timer_wheel_timer_t soon = rcutils_get_zero_initialized_timer_wheel_timer();
+  rcutils_timer_wheel_timer_t later = rcutils_get_zero_initialized_timer_wheel_timer();
+  rcutils_timer_wheel_timer_t cancelled = rcutils_get_zero_initialized_timer_wheel_timer();
+  rcutils_timer_wheel_timer_t past = rcutils_get_zero_initialized_timer_wheel_timer();
+  // A deadline between ticks expires on the next tick
+  ASSERT_EQ(
+    RCUTILS_RET_OK, rcutils_timer_wheel_schedule(
+      &wheel, &soon, start + RCUTILS_MS_TO_NS(10) + 1, record, &expiration));
+  ASSERT_EQ(
+    RCUTILS_RET_OK, rcutils_timer_wheel_schedule(
+      &wheel, &later, start + RCUTILS_S_TO_NS(3600), record, &expiration));
+  ASSERT_EQ(
+    RCUTILS_RET_OK, rcutils_timer_wheel_schedule(
+      &wheel, &cancelled, start + RCUTILS_MS_TO_NS(5), record, &expiration));
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_timer_wheel_schedule(&wheel, &past, 0, record, &expiration));
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_timer_wheel_cancel(&wheel, &cancelled));
+  EXPECT_EQ(RCUTILS_RET_NOT_FOUND, rcutils_timer_wheel_cancel(&wheel, &cancelled));
+  rcutils_reset_error();
+
+  size_t expired_count = 0;
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_timer_wheel_advance(&wheel, start, &expired_count));
+  EXPECT_EQ(1u, expired_count);
+  EXPECT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_timer_wheel_advance(&wheel, start + RCUTILS_MS_TO_NS(10), &expired_count));
+  EXPECT_EQ(0u, expired_count);
+  EXPECT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_timer_wheel_advance(&wheel, start + RCUTILS_MS_TO_NS(11), &expired_count));
+  EXPECT_EQ(1u, expired_count);
+  EXPECT_FALSE(rcutils_timer_wheel_timer_is_scheduled(&soon));
+  // Going back in time does nothing
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_timer_wheel_advance(&wheel, 0, &expired_count));
+  EXPECT_EQ(0u, expired_count);
+  EXPECT_EQ(
+    RCUTILS_RET_OK, rcutils_timer_wheel_advance(
+      &wheel, start + RCUTILS_S_TO_NS(3600) - 1, &expired_count));
+  EXPECT_EQ(0u, expired_count);
+  EXPECT_EQ(
+    RCUTILS_RET_OK, rcutils_timer_wheel_advance(&wheel, start + RCUTILS_S_TO_NS(3600), nullptr));
+  ASSERT_EQ(3u, expiration.timers.size());
+  EXPECT_EQ(&past, expiration.timers[0]);
+  EXPECT_EQ(&soon, expiration.timers[1]);
+  EXPECT_EQ(&later, expiration.timers[2]);
+  size_t size = 1;
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_timer_wheel_get_size(&wheel, &size));
+  EXPECT_EQ(0u, size);
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_timer_wheel_fini(&wheel));
+}
+
+TEST(test_timer_wheel, callbacks_reschedule) {
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  rcutils_timer_wheel_t wheel = rcutils_get_zero_initialized_timer_wheel();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_timer_wheel_init(&wheel, 1, 0, &allocator));
+
+  // Both timers expire on the same tick, the first one cancels the other one
+  rcutils_timer_wheel_timer_t periodic = rcutils_get_zero_initialized_timer_wheel_timer();
+  rcutils_timer_wheel_timer_t other = rcutils_get_zero_initialized_timer_wheel_timer();
+  Rescheduling rescheduling{&wheel, &other, 100, 0, 0};
+  Expiration expiration;
+  ASSERT_EQ(
+    RCUTILS_RET_OK,
+    rcutils_timer_wheel_schedule(&wheel, &periodic, 100, reschedule, &rescheduling));
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_timer_wheel_schedule(&wheel, &other, 100, record, &expiration));
+
+  for (rescheduling.now = 50; rescheduling.now <= 1000; rescheduling.now += 50) {
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_timer_wheel_advance(&wheel, rescheduling.now, nullptr));
+  }
+  EXPECT_EQ(10, rescheduling.count);
+  EXPECT_TRUE(expiration.timers.empty());
+  EXPECT_TRUE(rcutils_timer_wheel_timer_is_scheduled(&periodic));
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_timer_wheel_fini(&wheel));
+}
+
+TEST(test_timer_wheel, random_deadlines) {
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  rcutils_timer_wheel_t wheel = rcutils_get_zero_initialized_timer_wheel();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_timer_wheel_init(&wheel, 1, 0, &allocator));
+
+  const size_t timer_count = 2000;
+  std::vector<rcutils_timer_wheel_timer_t> timers(
+    timer_count, rcutils_get_zero_initialized_timer_wheel_timer());
+  std::vector<rcutils_time_point_value_t> deadlines(timer_count, -1);
+  std::mt19937_64 generator(42);
+  // Deadlines spread over all the wheels, and beyond their range
+  std::uniform_int_distribution<int> magnitudes(0, 40);
+  Expiration expiration;
+  for (size_t i = 0; i < timer_count; ++i) {
+    rcutils_time_point_value_t deadline =
+      static_cast<rcutils_time_point_value_t>(generator() % (1ull << magnitudes(generator)));
+    deadlines[i] = deadline;
+    ASSERT_EQ(
+      RCUTILS_RET_OK,
+      rcutils_timer_wheel_schedule(&wheel, &timers[i], deadline, record, &expiration));
+  }
+  // Cancel some timers
+  for (size_t i = 0; i < timer_count; i += 7) {
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_timer_wheel_cancel(&wheel, &timers[i]));
+    deadlines[i] = -1;
+  }
+
+  // Advance by steps of growing sizes
+  std::vector<rcutils_time_point_value_t> times;
+  size_t expired_total = 0;
+  rcutils_time_point_value_t now = 0;
+  while (now < (1ll << 41)) {
+    size_t expired_count = 0;
+    expiration.now = now;
+    times.push_back(now);
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_timer_wheel_advance(&wheel, now, &expired_count));
+    expired_total += expired_count;
+    now += 1 + static_cast<rcutils_time_point_value_t>(generator() % (1ull + now / 4));
+  }
+  EXPECT_EQ(expiration.timers.size(), expired_total);
+
+  // Each timer expired exactly once, on the first advance at or after its deadline
+  std::vector<rcutils_time_point_value_t> expired_at(timer_count, -1);
+  for (size_t i = 0; i < expiration.timers.size(); ++i) {
+    size_t index = static_cast<size_t>(expiration.timers[i] - timers.data());
+    ASSERT_EQ(-1, expired_at[index]);
+    expired_at[index] = expiration.times[i];
+  }
+  for (size_t i = 0; i < timer_count; ++i) {
+    if (-1 == deadlines[i]) {
+      EXPECT_EQ(-1, expired_at[i]) << i;
+    } else {
+      EXPECT_EQ(*std::lower_bound(times.begin(), times.end(), deadlines[i]), expired_at[i]) << i;
+    }
+  }
+  // The callbacks of each advance are called in the order of the deadlines
+  for (size_t i = 1; i < expiration.timers.size(); ++i) {
+    if (expiration.times[i - 1] == expiration.times[i]) {
+      EXPECT_LE(
+        deadlines[static_cast<size_t>(expiration.timers[i - 1] - timers.data())],
+        deadlines[static_cast<size_t>(expiration.timers[i] - timers.data())]);
+    }
+  }
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_timer_wheel_fini(&wheel));
+}
+
+TEST(test_timer_wheel, poll) {
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  rcutils_timer_wheel_t wheel = rcutils_get_zero_initialized_timer_wheel();
+  rcutils_time_point_value_t now = 0;
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_steady_time_now(&now));
+  ASSERT_EQ(
+    RCUTILS_RET_OK, rcutils_timer_wheel_init(&wheel, RCUTILS_MS_TO_NS(1), now, &allocator));
+
+  Expiration expiration;
+  rcutils_timer_wheel_timer_t timer = rcutils_get_zero_initialized_timer_wheel_timer();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_timer_wheel_schedule(&wheel, &timer, now, record, &expiration));
+  size_t expired_count = 0;
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_timer_wheel_poll(&wheel, &expired_count));
+  EXPECT_EQ(1u, expired_count);
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_timer_wheel_fini(&wheel));
+}
@@ -0,0 +1,244 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "rcutils/allocator.h"
+#include "rcutils/error_handling.h"
+#include "rcutils/tlsf_allocator.h"
+#include "rcutils/types/char_array.h"
+
+class TlsfAllocatorTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    memory.resize(1024 * 1024);
+    ASSERT_EQ(
+      RCUTILS_RET_OK, rcutils_tlsf_allocator_init(&tlsf, memory.data(), memory.size()));
+    allocator = rcutils_tlsf_allocator_get_allocator(&tlsf);
+    ASSERT_TRUE(rcutils_allocator_is_valid(&allocator));
+    initial_free_size = rcutils_tlsf_allocator_get_free_size(&tlsf);
+  }
+
+  void TearDown() override
+  {
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_tlsf_allocator_fini(&tlsf));
+  }
+
+  std::vector<uint8_t> memory;
+  rcutils_tlsf_allocator_t tlsf = rcutils_get_zero_initialized_tlsf_allocator();
+  rcutils_allocator_t allocator = rcutils_get_zero_initialized_allocator();
+  size_t initial_free_size = 0u;
+};
+
+static bool is_aligned(const void * pointer)
+{
+  return 0u == reinterpret_cast<uintptr_t>(pointer) % RCUTILS_TLSF_ALLOCATOR_ALIGNMENT;
+}
+
+TEST(test_tlsf_allocator, init_fini) {
+  std::vector<uint8_t> memory(64 * 1024);
+  rcutils_tlsf_allocator_t tlsf = rcutils_get_zero_initialized_tlsf_allocator();
+
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_tlsf_allocator_init(nullptr, memory.data(), memory.size()));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_tlsf_allocator_init(&tlsf, nullptr, memory.size()));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_tlsf_allocator_init(&tlsf, memory.data(), 64));
+  rcutils_reset_error();
+
+  rcutils_allocator_t allocator = rcutils_tlsf_allocator_get_allocator(&tlsf);
+  EXPECT_FALSE(rcutils_allocator_is_valid(&allocator));
+  allocator = rcutils_tlsf_allocator_get_allocator(nullptr);
+  EXPECT_FALSE(rcutils_allocator_is_valid(&allocator));
+  EXPECT_EQ(0u, rcutils_tlsf_allocator_get_free_size(&tlsf));
+  EXPECT_EQ(0u, rcutils_tlsf_allocator_get_free_size(nullptr));
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_tlsf_allocator_fini(nullptr));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_tlsf_allocator_fini(&tlsf));
+
+  // An unaligned region
+  ASSERT_EQ(
+    RCUTILS_RET_OK, rcutils_tlsf_allocator_init(&tlsf, memory.data() + 3, memory.size() - 3));
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_tlsf_allocator_init(&tlsf, memory.data(), memory.size()));
+  rcutils_reset_error();
+  EXPECT_GT(rcutils_tlsf_allocator_get_free_size(&tlsf), 32u * 1024u);
+  EXPECT_LT(rcutils_tlsf_allocator_get_free_size(&tlsf), memory.size());
+  allocator = rcutils_tlsf_allocator_get_allocator(&tlsf);
+  void * pointer = allocator.allocate(100, allocator.state);
+  EXPECT_NE(nullptr, pointer);
+  EXPECT_TRUE(is_aligned(pointer));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_tlsf_allocator_fini(&tlsf));
+  EXPECT_EQ(nullptr, tlsf.impl);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_tlsf_allocator_fini(&tlsf));
+}
+
+TEST_F(TlsfAllocatorTest, allocate_deallocate) {
+  void * empty = allocator.allocate(0, allocator.state);
+  EXPECT_NE(nullptr, empty);
+  allocator.deallocate(empty, allocator.state);
+  allocator.deallocate(nullptr, allocator.state);
+  EXPECT_EQ(initial_free_size, rcutils_tlsf_allocator_get_free_size(&tlsf));
+
+  std::vector<uint8_t *> pointers;
+  for (size_t size = 1u; size < 20000u; size = size * 3u + 1u) {
+    auto pointer = static_cast<uint8_t *>(allocator.allocate(size, allocator.state));
+    ASSERT_NE(nullptr, pointer);
+    EXPECT_TRUE(is_aligned(pointer));
+    memset(pointer, static_cast<int>(size & 0xff), size);
+    pointers.push_back(pointer);
+  }
+  EXPECT_LT(rcutils_tlsf_allocator_get_free_size(&tlsf), initial_free_size);
+  size_t size = 1u;
+  for (uint8_t * pointer : pointers) {
+    for (size_t i = 0u; i < size; ++i) {
+      ASSERT_EQ(size & 0xff, pointer[i]);
+    }
+    allocator.deallocate(pointer, allocator.state);
+    size = size * 3u + 1u;
+  }
+  // Everything was merged back
+  EXPECT_EQ(initial_free_size, rcutils_tlsf_allocator_get_free_size(&tlsf));
+
+  auto zeroed = static_cast<uint8_t *>(allocator.zero_allocate(100, 10, allocator.state));
+  ASSERT_NE(nullptr, zeroed);
+  for (size_t i = 0u; i < 1000u; ++i) {
+    EXPECT_EQ(0u, zeroed[i]);
+  }
+  allocator.deallocate(zeroed, allocator.state);
+  EXPECT_EQ(nullptr, allocator.zero_allocate(SIZE_MAX, 2, allocator.state));
+}
+
+TEST_F(TlsfAllocatorTest, exhaustion) {
+  // Fails instead of growing
+  EXPECT_EQ(nullptr, allocator.allocate(memory.size(), allocator.state));
+  EXPECT_EQ(nullptr, allocator.allocate(SIZE_MAX, allocator.state));
+
+  std::vector<void *> pointers;
+  void * pointer = nullptr;
+  while (nullptr != (pointer = allocator.allocate(1000, allocator.state))) {
+    pointers.push_back(pointer);
+  }
+  EXPECT_GT(pointers.size(), 900u);
+  EXPECT_LT(rcutils_tlsf_allocator_get_free_size(&tlsf), 2000u);
+
+  // Freeing every other block doesn't leave room for a larger one
+  for (size_t i = 0u; i < pointers.size(); i += 2u) {
+    allocator.deallocate(pointers[i], allocator.state);
+  }
+  EXPECT_EQ(nullptr, allocator.allocate(2000, allocator.state));
+  void * reused = allocator.allocate(1000, allocator.state);
+  EXPECT_NE(nullptr, reused);
+  allocator.deallocate(reused, allocator.state);
+  for (size_t i = 1u; i < pointers.size(); i += 2u) {
+    allocator.deallocate(pointers[i], allocator.state);
+  }
+  EXPECT_EQ(initial_free_size, rcutils_tlsf_allocator_get_free_size(&tlsf));
+  pointer = allocator.allocate(memory.size() / 2u, allocator.state);
+  EXPECT_NE(nullptr, pointer);
+  allocator.deallocate(pointer, allocator.state);
+}
+
+TEST_F(TlsfAllocatorTest, reallocate) {
+  auto str = static_cast<char *>(allocator.reallocate(nullptr, 4, allocator.state));
+  ASSERT_NE(nullptr, str);
+  memcpy(str, "abc", 4);
+
+  // The next block is free, so the block grows in place
+  auto grown = static_cast<char *>(allocator.reallocate(str, 1000, allocator.state));
+  EXPECT_EQ(str, grown);
+  EXPECT_STREQ("abc", grown);
+  auto shrunk = static_cast<char *>(allocator.reallocate(grown, 10, allocator.state));
+  EXPECT_EQ(str, shrunk);
+  EXPECT_STREQ("abc", shrunk);
+
+  // The next block is used, so the block moves
+  void * other = allocator.allocate(10, allocator.state);
+  ASSERT_NE(nullptr, other);
+  auto moved = static_cast<char *>(allocator.reallocate(shrunk, 2000, allocator.state));
+  ASSERT_NE(nullptr, moved);
+  EXPECT_NE(str, moved);
+  EXPECT_STREQ("abc", moved);
+  EXPECT_TRUE(is_aligned(moved));
+
+  // A failing reallocation keeps the memory
+  EXPECT_EQ(nullptr, allocator.reallocate(moved, memory.size(), allocator.state));
+  EXPECT_STREQ("abc", moved);
+
+  allocator.deallocate(moved, allocator.state);
+  allocator.deallocate(other, allocator.state);
+  EXPECT_EQ(initial_free_size, rcutils_tlsf_allocator_get_free_size(&tlsf));
+}
+
+TEST_F(TlsfAllocatorTest, random_operations) {
+  std::mt19937 generator(42);
+  std::vector<std::pair<uint8_t *, size_t>> allocations;
+  for (size_t i = 0u; i < 20000u; ++i) {
+    uint32_t operation = generator() % 3u;
+    if (0u == operation || allocations.empty()) {
+      size_t size = generator() % (0u == generator() % 16u ? 16384u : 256u);
+      auto pointer = static_cast<uint8_t *>(allocator.allocate(size, allocator.state));
+      if (nullptr != pointer) {
+        memset(pointer, static_cast<int>(size & 0xff), size);
+        allocations.emplace_back(pointer, size);
+      }
+    } else {
+      size_t index = generator() % allocations.size();
+      auto & allocation = allocations[index];
+      for (size_t j = 0u; j < allocation.second; ++j) {
+        ASSERT_EQ(allocation.second & 0xff, allocation.first[j]);
+      }
+      if (1u == operation) {
+        allocator.deallocate(allocation.first, allocator.state);
+        allocation = allocations.back();
+        allocations.pop_back();
+      } else {
+        size_t size = generator() % 2048u;
+        auto pointer = static_cast<uint8_t *>(
+          allocator.reallocate(allocation.first, size, allocator.state));
+        if (nullptr != pointer) {
+          memset(pointer, static_cast<int>(size & 0xff), size);
+          allocation = {pointer, size};
+        }
+      }
+    }
+  }
+  for (auto & allocation : allocations) {
+    allocator.deallocate(allocation.first, allocator.state);
+  }
+  EXPECT_EQ(initial_free_size, rcutils_tlsf_allocator_get_free_size(&tlsf));
+}
+
+TEST_F(TlsfAllocatorTest, char_array) {
+  rcutils_char_array_t char_array = rcutils_get_zero_initialized_char_array();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_char_array_init(&char_array, 8, &allocator));
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_EQ(RCUTILS_RET_OK, rcutils_char_array_strcat(&char_array, "0123456789"));
+  }
+  EXPECT_EQ(1000u, strlen(char_array.buffer));
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_char_array_fini(&char_array));
+  EXPECT_EQ(initial_free_size, rcutils_tlsf_allocator_get_free_size(&tlsf));
+}
@@ -0,0 +1,240 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "./allocator_testing_utils.h"
+#include "rcutils/allocator.h"
+#include "rcutils/error_handling.h"
+#include "rcutils/split.h"
+#include "rcutils/tracking_allocator.h"
+#include "rcutils/types/string_array.h"
+
+class TrackingAllocatorTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    rcutils_allocator_t default_allocator = rcutils_get_default_allocator();
+    ASSERT_EQ(
+      RCUTILS_RET_OK, rcutils_tracking_allocator_init(&tracking, &default_allocator, true));
+    allocator = rcutils_tracking_allocator_get_allocator(&tracking);
+    ASSERT_TRUE(rcutils_allocator_is_valid(&allocator));
+  }
+
+  void TearDown() override
+  {
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_tracking_allocator_fini(&tracking));
+  }
+
+  rcutils_tracking_allocator_statistics_t get_statistics()
+  {
+    rcutils_tracking_allocator_statistics_t statistics;
+    EXPECT_EQ(RCUTILS_RET_OK, rcutils_tracking_allocator_get_statistics(&tracking, &statistics));
+    return statistics;
+  }
+
+  rcutils_tracking_allocator_t tracking = rcutils_get_zero_initialized_tracking_allocator();
+  rcutils_allocator_t allocator = rcutils_get_zero_initialized_allocator();
+};
+
+TEST(test_tracking_allocator, init_fini) {
+  rcutils_allocator_t default_allocator = rcutils_get_default_allocator();
+  rcutils_allocator_t failing_allocator = get_failing_allocator();
+  rcutils_allocator_t invalid_allocator = rcutils_get_zero_initialized_allocator();
+  rcutils_tracking_allocator_t tracking = rcutils_get_zero_initialized_tracking_allocator();
+  rcutils_tracking_allocator_statistics_t statistics;
+
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_tracking_allocator_init(nullptr, &default_allocator, false));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_tracking_allocator_init(&tracking, nullptr, false));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_tracking_allocator_init(&tracking, &invalid_allocator, false));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_BAD_ALLOC, rcutils_tracking_allocator_init(&tracking, &failing_allocator, false));
+  rcutils_reset_error();
+
+  rcutils_allocator_t allocator = rcutils_tracking_allocator_get_allocator(&tracking);
+  EXPECT_FALSE(rcutils_allocator_is_valid(&allocator));
+  allocator = rcutils_tracking_allocator_get_allocator(nullptr);
+  EXPECT_FALSE(rcutils_allocator_is_valid(&allocator));
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_tracking_allocator_get_statistics(nullptr, &statistics));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_NOT_INITIALIZED, rcutils_tracking_allocator_get_statistics(&tracking, &statistics));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_tracking_allocator_reset(nullptr));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_NOT_INITIALIZED, rcutils_tracking_allocator_reset(&tracking));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_tracking_allocator_fini(nullptr));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_tracking_allocator_fini(&tracking));
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_tracking_allocator_init(&tracking, &default_allocator, false));
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_tracking_allocator_init(&tracking, &default_allocator, false));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_tracking_allocator_get_statistics(&tracking, nullptr));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_tracking_allocator_get_statistics(&tracking, &statistics));
+  EXPECT_EQ(0u, statistics.allocation_count);
+  EXPECT_EQ(0u, statistics.current_bytes);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_tracking_allocator_fini(&tracking));
+  EXPECT_EQ(nullptr, tracking.impl);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_tracking_allocator_fini(&tracking));
+
+  // Failures are counted
+  set_failing_allocator_is_failing(failing_allocator, false);
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_tracking_allocator_init(&tracking, &failing_allocator, false));
+  allocator = rcutils_tracking_allocator_get_allocator(&tracking);
+  void * pointer = allocator.allocate(10, allocator.state);
+  ASSERT_NE(nullptr, pointer);
+  set_failing_allocator_is_failing(failing_allocator, true);
+  EXPECT_EQ(nullptr, allocator.allocate(10, allocator.state));
+  EXPECT_EQ(nullptr, allocator.zero_allocate(10, 10, allocator.state));
+  EXPECT_EQ(nullptr, allocator.reallocate(pointer, 100, allocator.state));
+  EXPECT_EQ(nullptr, allocator.zero_allocate(SIZE_MAX, 2, allocator.state));
+  set_failing_allocator_is_failing(failing_allocator, false);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_tracking_allocator_get_statistics(&tracking, &statistics));
+  EXPECT_EQ(1u, statistics.allocation_count);
+  EXPECT_EQ(0u, statistics.reallocation_count);
+  EXPECT_EQ(4u, statistics.failure_count);
+  EXPECT_EQ(10u, statistics.current_bytes);
+  allocator.deallocate(pointer, allocator.state);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_tracking_allocator_fini(&tracking));
+}
+
+TEST_F(TrackingAllocatorTest, statistics) {
+  void * a = allocator.allocate(10, allocator.state);
+  auto b = static_cast<uint8_t *>(allocator.zero_allocate(5, 20, allocator.state));
+  ASSERT_NE(nullptr, a);
+  ASSERT_NE(nullptr, b);
+  for (size_t i = 0u; i < 100u; ++i) {
+    EXPECT_EQ(0u, b[i]);
+  }
+  rcutils_tracking_allocator_statistics_t statistics = get_statistics();
+  EXPECT_EQ(2u, statistics.allocation_count);
+  EXPECT_EQ(0u, statistics.deallocation_count);
+  EXPECT_EQ(110u, statistics.total_bytes);
+  EXPECT_EQ(110u, statistics.current_bytes);
+  EXPECT_EQ(110u, statistics.peak_bytes);
+  EXPECT_EQ(2u, statistics.current_allocation_count);
+
+  b = static_cast<uint8_t *>(allocator.reallocate(b, 1000, allocator.state));
+  ASSERT_NE(nullptr, b);
+  a = allocator.reallocate(a, 5, allocator.state);
+  ASSERT_NE(nullptr, a);
+  statistics = get_statistics();
+  EXPECT_EQ(2u, statistics.reallocation_count);
+  EXPECT_EQ(1115u, statistics.total_bytes);
+  EXPECT_EQ(1005u, statistics.current_bytes);
+  EXPECT_EQ(1010u, statistics.peak_bytes);
+
+  allocator.deallocate(b, allocator.state);
+  allocator.deallocate(nullptr, allocator.state);
+  statistics = get_statistics();
+  EXPECT_EQ(1u, statistics.deallocation_count);
+  EXPECT_EQ(5u, statistics.current_bytes);
+  EXPECT_EQ(1010u, statistics.peak_bytes);
+  EXPECT_EQ(1u, statistics.current_allocation_count);
+
+  // The sizes are in their power of two bucket
+  EXPECT_EQ(2u, statistics.size_histogram[0]);  // 10, then 5
+  EXPECT_EQ(1u, statistics.size_histogram[3]);  // 100
+  EXPECT_EQ(1u, statistics.size_histogram[6]);  // 1000
+
+  // Only the current bytes and allocations are kept
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_tracking_allocator_reset(&tracking));
+  statistics = get_statistics();
+  EXPECT_EQ(0u, statistics.allocation_count);
+  EXPECT_EQ(0u, statistics.deallocation_count);
+  EXPECT_EQ(0u, statistics.reallocation_count);
+  EXPECT_EQ(0u, statistics.total_bytes);
+  EXPECT_EQ(5u, statistics.current_bytes);
+  EXPECT_EQ(5u, statistics.peak_bytes);
+  EXPECT_EQ(1u, statistics.current_allocation_count);
+  for (size_t i = 0u; i < RCUTILS_TRACKING_ALLOCATOR_HISTOGRAM_SIZE; ++i) {
+    EXPECT_EQ(0u, statistics.size_histogram[i]);
+  }
+  allocator.deallocate(a, allocator.state);
+
+  // Larger sizes are in the last bucket
+  void * large = allocator.allocate(10 * 1024 * 1024, allocator.state);
+  ASSERT_NE(nullptr, large);
+  allocator.deallocate(large, allocator.state);
+  statistics = get_statistics();
+  EXPECT_EQ(1u, statistics.size_histogram[RCUTILS_TRACKING_ALLOCATOR_HISTOGRAM_SIZE - 1]);
+  EXPECT_EQ(0u, statistics.current_bytes);
+}
+
+TEST_F(TrackingAllocatorTest, allocation_free_path) {
+  rcutils_string_array_t tokens = rcutils_get_zero_initialized_string_array();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_split("/ns/node", '/', allocator, &tokens));
+  rcutils_tracking_allocator_statistics_t statistics = get_statistics();
+  EXPECT_LT(0u, statistics.allocation_count);
+  EXPECT_LT(0u, statistics.current_allocation_count);
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_tracking_allocator_reset(&tracking));
+  // Splitting into views doesn't allocate
+  rcutils_string_view_t views[4];
+  size_t count = 0u;
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_split_views("/ns/node", '/', views, 4u, &count));
+  EXPECT_EQ(2u, count);
+  statistics = get_statistics();
+  EXPECT_EQ(0u, statistics.allocation_count);
+  EXPECT_EQ(0u, statistics.reallocation_count);
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_string_array_fini(&tokens));
+  statistics = get_statistics();
+  EXPECT_EQ(0u, statistics.current_bytes);
+  EXPECT_EQ(0u, statistics.current_allocation_count);
+}
+
+TEST_F(TrackingAllocatorTest, threads) {
+  std::vector<std::thread> threads;
+  for (size_t t = 0u; t < 4u; ++t) {
+    threads.emplace_back(
+      [this]() {
+        for (size_t i = 0u; i < 10000u; ++i) {
+          void * pointer = allocator.allocate(i % 100u, allocator.state);
+          ASSERT_NE(nullptr, pointer);
+          allocator.deallocate(pointer, allocator.state);
+        }
+      });
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+  rcutils_tracking_allocator_statistics_t statistics = get_statistics();
+  EXPECT_EQ(40000u, statistics.allocation_count);
+  EXPECT_EQ(40000u, statistics.deallocation_count);
+  EXPECT_EQ(0u, statistics.current_bytes);
+  EXPECT_EQ(0u, statistics.current_allocation_count);
+  EXPECT_LE(statistics.peak_bytes, 4u * 99u);
+}
@@ -0,0 +1,101 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "./allocator_testing_utils.h"
+#include "rcutils/allocator.h"
+#include "rcutils/error_handling.h"
+
+#include "rcutils/types/typed_array_list.h"
+
+typedef struct point_t
+{
+  int32_t x;
+  int32_t y;
+} point_t;
+
+RCUTILS_DEFINE_ARRAY_LIST(point_list, point_t)
+
+TEST(test_typed_array_list, init_fini) {
+  point_list_t list = point_list_get_zero_initialized();
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, point_list_init(nullptr, 2, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, point_list_init(&list, 0, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, point_list_init(&list, 2, nullptr));
+  rcutils_reset_error();
+  rcutils_allocator_t failing_allocator = get_failing_allocator();
+  EXPECT_EQ(RCUTILS_RET_BAD_ALLOC, point_list_init(&list, 2, &failing_allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_NOT_INITIALIZED, point_list_reserve(&list, 4));
+  rcutils_reset_error();
+
+  ASSERT_EQ(RCUTILS_RET_OK, point_list_init(&list, 2, &allocator));
+  EXPECT_EQ(0u, list.size);
+  EXPECT_EQ(2u, list.capacity);
+  EXPECT_EQ(RCUTILS_RET_OK, point_list_reserve(&list, 8));
+  EXPECT_EQ(8u, list.capacity);
+  EXPECT_EQ(RCUTILS_RET_OK, point_list_reserve(&list, 4));
+  EXPECT_EQ(8u, list.capacity);
+  EXPECT_EQ(RCUTILS_RET_OK, point_list_fini(&list));
+  EXPECT_EQ(nullptr, list.data);
+  EXPECT_EQ(RCUTILS_RET_OK, point_list_fini(&list));
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, point_list_fini(nullptr));
+  rcutils_reset_error();
+}
+
+TEST(test_typed_array_list, add_get_remove) {
+  point_list_t list = point_list_get_zero_initialized();
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  ASSERT_EQ(RCUTILS_RET_OK, point_list_init(&list, 1, &allocator));
+
+  for (int32_t i = 0; i < 10; ++i) {
+    ASSERT_EQ(RCUTILS_RET_OK, point_list_add(&list, point_t{i, -i}));
+  }
+  EXPECT_EQ(10u, list.size);
+  EXPECT_EQ(16u, list.capacity);
+  for (size_t i = 0; i < list.size; ++i) {
+    EXPECT_EQ(static_cast<int32_t>(i), list.data[i].x);
+  }
+  point_t * point = point_list_get_ptr(&list, 3);
+  ASSERT_NE(nullptr, point);
+  EXPECT_EQ(-3, point->y);
+  EXPECT_EQ(nullptr, point_list_get_ptr(&list, 10));
+  EXPECT_EQ(nullptr, point_list_get_ptr(nullptr, 0));
+
+  // Removing keeps the order
+  EXPECT_EQ(RCUTILS_RET_OK, point_list_remove(&list, 0));
+  EXPECT_EQ(9u, list.size);
+  EXPECT_EQ(1, list.data[0].x);
+  EXPECT_EQ(9, list.data[8].x);
+  // Swap removing moves the last value in place
+  EXPECT_EQ(RCUTILS_RET_OK, point_list_swap_remove(&list, 0));
+  EXPECT_EQ(8u, list.size);
+  EXPECT_EQ(9, list.data[0].x);
+  EXPECT_EQ(RCUTILS_RET_OK, point_list_swap_remove(&list, 7));
+  EXPECT_EQ(7u, list.size);
+  EXPECT_EQ(7, list.data[6].x);
+
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, point_list_remove(&list, 7));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, point_list_swap_remove(&list, 7));
+  rcutils_reset_error();
+
+  EXPECT_EQ(RCUTILS_RET_OK, point_list_fini(&list));
+}
@@ -0,0 +1,135 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <map>
+#include <random>
+
+#include "./allocator_testing_utils.h"
+#include "rcutils/allocator.h"
+#include "rcutils/error_handling.h"
+
+#include "rcutils/types/typed_hash_map.h"
+
+RCUTILS_DEFINE_HASH_MAP(
+  id_map, uint64_t, int32_t, rcutils_typed_hash_map_hash_uint64, RCUTILS_TYPED_HASH_MAP_EQUAL)
+
+// Every key has the same hash, of the slot before the last ones, so that every operation goes
+// through collisions wrapping around the end of the slots.
+#define COLLIDING_HASH(key) ((void)(key), (size_t)30u)
+RCUTILS_DEFINE_HASH_MAP(
+  colliding_map, uint32_t, uint32_t, COLLIDING_HASH, RCUTILS_TYPED_HASH_MAP_EQUAL)
+
+TEST(test_typed_hash_map, init_fini) {
+  id_map_t map = id_map_get_zero_initialized();
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, id_map_init(nullptr, 2, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, id_map_init(&map, 2, nullptr));
+  rcutils_reset_error();
+  rcutils_allocator_t failing_allocator = get_failing_allocator();
+  EXPECT_EQ(RCUTILS_RET_BAD_ALLOC, id_map_init(&map, 2, &failing_allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_NOT_INITIALIZED, id_map_set(&map, 1, 1));
+  rcutils_reset_error();
+  EXPECT_EQ(nullptr, id_map_get_ptr(&map, 1));
+
+  ASSERT_EQ(RCUTILS_RET_OK, id_map_init(&map, 2, &allocator));
+  EXPECT_EQ(RCUTILS_TYPED_HASH_MAP_MIN_CAPACITY, map.capacity);
+  EXPECT_EQ(RCUTILS_RET_OK, id_map_fini(&map));
+  ASSERT_EQ(RCUTILS_RET_OK, id_map_init(&map, 100, &allocator));
+  EXPECT_EQ(128u, map.capacity);
+  EXPECT_EQ(RCUTILS_RET_OK, id_map_reserve(&map, 100));
+  EXPECT_EQ(256u, map.capacity);
+  EXPECT_EQ(RCUTILS_RET_OK, id_map_fini(&map));
+  EXPECT_EQ(nullptr, map.entries);
+  EXPECT_EQ(RCUTILS_RET_OK, id_map_fini(&map));
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, id_map_fini(nullptr));
+  rcutils_reset_error();
+}
+
+TEST(test_typed_hash_map, set_get_unset) {
+  id_map_t map = id_map_get_zero_initialized();
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  ASSERT_EQ(RCUTILS_RET_OK, id_map_init(&map, 0, &allocator));
+
+  for (uint64_t key = 0; key < 100; ++key) {
+    ASSERT_EQ(RCUTILS_RET_OK, id_map_set(&map, key << 32, static_cast<int32_t>(key)));
+  }
+  EXPECT_EQ(100u, map.size);
+  EXPECT_LE(map.size * 4, map.capacity * 3);
+  // Setting an existing key replaces its value
+  EXPECT_EQ(RCUTILS_RET_OK, id_map_set(&map, 7ull << 32, -7));
+  EXPECT_EQ(100u, map.size);
+
+  int32_t value = 0;
+  EXPECT_EQ(RCUTILS_RET_OK, id_map_get(&map, 7ull << 32, &value));
+  EXPECT_EQ(-7, value);
+  int32_t * found = id_map_get_ptr(&map, 42ull << 32);
+  ASSERT_NE(nullptr, found);
+  EXPECT_EQ(42, *found);
+  EXPECT_EQ(RCUTILS_RET_NOT_FOUND, id_map_get(&map, 7, &value));
+  EXPECT_EQ(nullptr, id_map_get_ptr(&map, 100ull << 32));
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, id_map_get(&map, 7, nullptr));
+  rcutils_reset_error();
+
+  EXPECT_EQ(RCUTILS_RET_OK, id_map_unset(&map, 42ull << 32));
+  EXPECT_EQ(RCUTILS_RET_NOT_FOUND, id_map_unset(&map, 42ull << 32));
+  EXPECT_EQ(nullptr, id_map_get_ptr(&map, 42ull << 32));
+  EXPECT_EQ(99u, map.size);
+
+  size_t used = 0;
+  for (size_t i = 0; i < map.capacity; ++i) {
+    used += map.used[i] ? 1u : 0u;
+  }
+  EXPECT_EQ(map.size, used);
+
+  EXPECT_EQ(RCUTILS_RET_OK, id_map_fini(&map));
+}
+
+TEST(test_typed_hash_map, collisions) {
+  colliding_map_t map = colliding_map_get_zero_initialized();
+  rcutils_allocator_t allocator = rcutils_get_default_allocator();
+  ASSERT_EQ(RCUTILS_RET_OK, colliding_map_init(&map, 0, &allocator));
+  std::map<uint32_t, uint32_t> expected;
+  std::mt19937 generator(42);
+
+  // Random sets and unsets, checked against a std::map, exercise the shifting back of the
+  // entries following an unset one.
+  for (int i = 0; i < 2000; ++i) {
+    uint32_t key = generator() % 20u;
+    if (generator() % 2u) {
+      ASSERT_EQ(RCUTILS_RET_OK, colliding_map_set(&map, key, key * 10u));
+      expected[key] = key * 10u;
+    } else {
+      EXPECT_EQ(
+        expected.erase(key) ? RCUTILS_RET_OK : RCUTILS_RET_NOT_FOUND,
+        colliding_map_unset(&map, key));
+    }
+    ASSERT_EQ(expected.size(), map.size);
+    for (uint32_t k = 0; k < 20u; ++k) {
+      uint32_t * found = colliding_map_get_ptr(&map, k);
+      if (expected.count(k)) {
+        ASSERT_NE(nullptr, found);
+        EXPECT_EQ(expected[k], *found);
+      } else {
+        EXPECT_EQ(nullptr, found);
+      }
+    }
+  }
+  EXPECT_EQ(RCUTILS_RET_OK, colliding_map_fini(&map));
+}
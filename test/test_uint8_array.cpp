@@ -14,7 +14,12 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdint>
+#include <cstring>
+
+#include "./allocator_testing_utils.h"
 #include "rcutils/allocator.h"
+#include "rcutils/error_handling.h"
 
 #include "rcutils/types/uint8_array.h"
 
@@ -78,3 +83,58 @@ TEST(test_uint8_array, resize) {
   // cleanup only 3 fields
   EXPECT_EQ(RCUTILS_RET_OK, rcutils_uint8_array_fini(&uint8_array));
 }
+
+TEST(test_uint8_array, aligned) {
+  auto uint8_array = rcutils_get_zero_initialized_uint8_array();
+  auto allocator = rcutils_get_default_allocator();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_uint8_array_init_aligned(&uint8_array, 5, 0, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_uint8_array_init_aligned(&uint8_array, 5, 3, &allocator));
+  rcutils_reset_error();
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_uint8_array_init_aligned(&uint8_array, 100, 64, &allocator));
+  EXPECT_EQ(100lu, uint8_array.buffer_capacity);
+  EXPECT_EQ(64lu, uint8_array.buffer_alignment);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(uint8_array.buffer) % 64u);
+  for (uint8_t i = 0; i < 100; ++i) {
+    uint8_array.buffer[i] = i;
+  }
+  uint8_array.buffer_length = 100lu;
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_uint8_array_resize(&uint8_array, 5000));
+  EXPECT_EQ(5000lu, uint8_array.buffer_capacity);
+  EXPECT_EQ(100lu, uint8_array.buffer_length);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(uint8_array.buffer) % 64u);
+  for (uint8_t i = 0; i < 100; ++i) {
+    EXPECT_EQ(i, uint8_array.buffer[i]);
+  }
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_uint8_array_resize(&uint8_array, 10));
+  EXPECT_EQ(10lu, uint8_array.buffer_capacity);
+  EXPECT_EQ(10lu, uint8_array.buffer_length);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(uint8_array.buffer) % 64u);
+  for (uint8_t i = 0; i < 10; ++i) {
+    EXPECT_EQ(i, uint8_array.buffer[i]);
+  }
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_uint8_array_fini(&uint8_array));
+  EXPECT_EQ(nullptr, uint8_array.buffer);
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_uint8_array_init_aligned(&uint8_array, 0, 4096, &allocator));
+  EXPECT_EQ(nullptr, uint8_array.buffer);
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_uint8_array_resize(&uint8_array, 10));
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(uint8_array.buffer) % 4096u);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_uint8_array_fini(&uint8_array));
+
+  auto failing_allocator = get_failing_allocator();
+  EXPECT_EQ(
+    RCUTILS_RET_BAD_ALLOC,
+    rcutils_uint8_array_init_aligned(&uint8_array, 10, 64, &failing_allocator));
+  rcutils_reset_error();
+  set_failing_allocator_is_failing(failing_allocator, false);
+  ASSERT_EQ(
+    RCUTILS_RET_OK, rcutils_uint8_array_init_aligned(&uint8_array, 10, 64, &failing_allocator));
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(uint8_array.buffer) % 64u);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_uint8_array_fini(&uint8_array));
+}
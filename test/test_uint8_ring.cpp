@@ -0,0 +1,159 @@
+// Copyright 2024 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include "./allocator_testing_utils.h"
+#include "rcutils/allocator.h"
+#include "rcutils/error_handling.h"
+
+#include "rcutils/types/uint8_ring.h"
+
+TEST(test_uint8_ring, init_fini) {
+  auto uint8_ring = rcutils_get_zero_initialized_uint8_ring();
+  auto allocator = rcutils_get_default_allocator();
+
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_uint8_ring_init(nullptr, 8, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_uint8_ring_init(&uint8_ring, 0, &allocator));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_uint8_ring_init(&uint8_ring, 8, nullptr));
+  rcutils_reset_error();
+
+  rcutils_allocator_t failing_allocator = get_failing_allocator();
+  EXPECT_EQ(
+    RCUTILS_RET_BAD_ALLOC, rcutils_uint8_ring_init(&uint8_ring, 8, &failing_allocator));
+  rcutils_reset_error();
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_uint8_ring_init(&uint8_ring, 8, &allocator));
+  EXPECT_EQ(8lu, uint8_ring.buffer_capacity);
+  EXPECT_EQ(0lu, uint8_ring.buffer_length);
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_uint8_ring_fini(&uint8_ring));
+  EXPECT_EQ(0lu, uint8_ring.buffer_capacity);
+  EXPECT_FALSE(uint8_ring.buffer);
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_uint8_ring_fini(nullptr));
+  rcutils_reset_error();
+}
+
+TEST(test_uint8_ring, write_read_wrap_around) {
+  auto uint8_ring = rcutils_get_zero_initialized_uint8_ring();
+  auto allocator = rcutils_get_default_allocator();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_uint8_ring_init(&uint8_ring, 8, &allocator));
+
+  const uint8_t data[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+  uint8_t out[10] = {0};
+  size_t read_size = 0;
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_uint8_ring_write(&uint8_ring, nullptr, 0));
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_uint8_ring_write(&uint8_ring, nullptr, 1));
+  rcutils_reset_error();
+  EXPECT_EQ(RCUTILS_RET_NOT_ENOUGH_SPACE, rcutils_uint8_ring_write(&uint8_ring, data, 9));
+  rcutils_reset_error();
+  EXPECT_EQ(0lu, uint8_ring.buffer_length);
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_uint8_ring_write(&uint8_ring, data, 6));
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_uint8_ring_read(&uint8_ring, out, 4, &read_size));
+  EXPECT_EQ(4lu, read_size);
+  EXPECT_EQ(0, memcmp(data, out, 4));
+
+  // 2 bytes left at offset 4, these 5 bytes wrap around the end of the buffer
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_uint8_ring_write(&uint8_ring, data + 6, 4));
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_uint8_ring_write(&uint8_ring, data, 2));
+  EXPECT_EQ(8lu, uint8_ring.buffer_length);
+  EXPECT_EQ(RCUTILS_RET_NOT_ENOUGH_SPACE, rcutils_uint8_ring_write(&uint8_ring, data, 1));
+  rcutils_reset_error();
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_uint8_ring_read(&uint8_ring, out, 10, &read_size));
+  EXPECT_EQ(8lu, read_size);
+  const uint8_t expected[] = {5, 6, 7, 8, 9, 10, 1, 2};
+  EXPECT_EQ(0, memcmp(expected, out, 8));
+  EXPECT_EQ(0lu, uint8_ring.buffer_length);
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_uint8_ring_read(&uint8_ring, out, 10, &read_size));
+  EXPECT_EQ(0lu, read_size);
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_uint8_ring_read(&uint8_ring, out, 1, nullptr));
+  rcutils_reset_error();
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_uint8_ring_fini(&uint8_ring));
+}
+
+TEST(test_uint8_ring, spans) {
+  auto uint8_ring = rcutils_get_zero_initialized_uint8_ring();
+  auto allocator = rcutils_get_default_allocator();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_uint8_ring_init(&uint8_ring, 8, &allocator));
+
+  uint8_t * write_span = nullptr;
+  const uint8_t * read_span = nullptr;
+  size_t size = 0;
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_uint8_ring_get_read_span(&uint8_ring, &read_span, &size));
+  EXPECT_EQ(0lu, size);
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_uint8_ring_get_write_span(&uint8_ring, &write_span, &size));
+  EXPECT_EQ(uint8_ring.buffer, write_span);
+  EXPECT_EQ(8lu, size);
+  memset(write_span, 0xAB, 5);
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_uint8_ring_commit_write(&uint8_ring, 5));
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_uint8_ring_get_read_span(&uint8_ring, &read_span, &size));
+  EXPECT_EQ(uint8_ring.buffer, read_span);
+  EXPECT_EQ(5lu, size);
+  EXPECT_EQ(0xAB, read_span[4]);
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_uint8_ring_consume(&uint8_ring, 6));
+  rcutils_reset_error();
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_uint8_ring_consume(&uint8_ring, 3));
+
+  // The free space wraps around, the span stops at the end of the buffer
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_uint8_ring_get_write_span(&uint8_ring, &write_span, &size));
+  EXPECT_EQ(uint8_ring.buffer + 5, write_span);
+  EXPECT_EQ(3lu, size);
+  EXPECT_EQ(RCUTILS_RET_INVALID_ARGUMENT, rcutils_uint8_ring_commit_write(&uint8_ring, 4));
+  rcutils_reset_error();
+  memset(write_span, 0xCD, 3);
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_uint8_ring_commit_write(&uint8_ring, 3));
+
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_uint8_ring_get_write_span(&uint8_ring, &write_span, &size));
+  EXPECT_EQ(uint8_ring.buffer, write_span);
+  EXPECT_EQ(3lu, size);
+  memset(write_span, 0xEF, 3);
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_uint8_ring_commit_write(&uint8_ring, 3));
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_uint8_ring_get_write_span(&uint8_ring, &write_span, &size));
+  EXPECT_EQ(0lu, size);
+
+  // The stored bytes wrap around, the span stops at the end of the buffer
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_uint8_ring_get_read_span(&uint8_ring, &read_span, &size));
+  EXPECT_EQ(uint8_ring.buffer + 3, read_span);
+  EXPECT_EQ(5lu, size);
+  EXPECT_EQ(0xAB, read_span[1]);
+  EXPECT_EQ(0xCD, read_span[2]);
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_uint8_ring_consume(&uint8_ring, size));
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_uint8_ring_get_read_span(&uint8_ring, &read_span, &size));
+  EXPECT_EQ(uint8_ring.buffer, read_span);
+  EXPECT_EQ(3lu, size);
+  EXPECT_EQ(0xEF, read_span[0]);
+  ASSERT_EQ(RCUTILS_RET_OK, rcutils_uint8_ring_consume(&uint8_ring, size));
+  EXPECT_EQ(0lu, uint8_ring.buffer_length);
+
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT, rcutils_uint8_ring_get_write_span(&uint8_ring, nullptr, &size));
+  rcutils_reset_error();
+  EXPECT_EQ(
+    RCUTILS_RET_INVALID_ARGUMENT,
+    rcutils_uint8_ring_get_read_span(&uint8_ring, &read_span, nullptr));
+  rcutils_reset_error();
+
+  EXPECT_EQ(RCUTILS_RET_OK, rcutils_uint8_ring_fini(&uint8_ring));
+}
@@ -107,6 +107,8 @@ get_time_bomb_allocator(void)
   time_bomb_allocator.reallocate = time_bomb_realloc;
   time_bomb_allocator.zero_allocate = time_bomb_calloc;
   time_bomb_allocator.state = &state;
+  time_bomb_allocator.aligned_allocate = nullptr;
+  time_bomb_allocator.aligned_deallocate = nullptr;
   return time_bomb_allocator;
 }
 